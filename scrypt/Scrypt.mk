@@ -1,5 +1,8 @@
 local_c_flags := -DUSE_OPENSSL_PBKDF2
 
+# Run the p lanes of crypto_scrypt on up to SCRYPT_MAX_THREADS threads.
+local_c_flags += -DSCRYPT_THREADS
+
 local_c_includes := $(log_c_includes)
 
 local_additional_dependencies := $(LOCAL_PATH)/android-config.mk $(LOCAL_PATH)/Scrypt.mk
@@ -39,7 +42,7 @@ LOCAL_SHARED_LIBRARIES := $(log_shared_libraries) libcrypto-host
 LOCAL_SRC_FILES += $(host_src_files)
 LOCAL_CFLAGS += $(host_c_flags)
 LOCAL_C_INCLUDES += $(host_c_includes)
-LOCAL_LDLIBS += -ldl
+LOCAL_LDLIBS += -ldl -lpthread
 LOCAL_MODULE_TAGS := optional
 LOCAL_MODULE:= libscrypt_static
 LOCAL_ADDITIONAL_DEPENDENCIES := $(local_additional_dependencies)
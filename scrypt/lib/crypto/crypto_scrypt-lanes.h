@@ -0,0 +1,152 @@
+/*
+ * Scheduling of the p independent SMix lanes of scrypt.
+ *
+ * Lanes are claimed one at a time, or two at a time when the caller has a
+ * routine which mixes two adjacent lanes together.  With SCRYPT_THREADS
+ * defined, up to SCRYPT_MAX_THREADS threads (the caller included) claim
+ * lanes concurrently; every extra thread allocates its own V and XY, so peak
+ * memory use grows with the number of threads which actually run.  Threads
+ * which cannot be started or cannot allocate their storage simply leave the
+ * work to the others, so the result never depends on how many ran.
+ */
+#ifndef _CRYPTO_SCRYPT_LANES_H_
+#define _CRYPTO_SCRYPT_LANES_H_
+
+#include <sys/types.h>
+#include <sys/mman.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef SCRYPT_THREADS
+#include <pthread.h>
+#include <unistd.h>
+
+#ifndef SCRYPT_MAX_THREADS
+#define SCRYPT_MAX_THREADS 4
+#endif
+#endif
+
+typedef void (* smix_fn)(uint8_t *, size_t, uint64_t, void *, void *);
+
+struct smix_lanes {
+	uint8_t * B;
+	size_t r;
+	uint64_t N;
+	uint32_t p;
+	smix_fn smix1;		/* Mixes one lane. */
+	smix_fn smix2;		/* Mixes two adjacent lanes, or NULL. */
+	uint32_t next;		/* First lane nobody has claimed yet. */
+};
+
+/**
+ * smix_lanes_work(L, V, XY):
+ * Claim lanes of L->B until none are left and compute B_i <-- MF(B_i, N) for
+ * each of them using the temporary storage V and XY, which must be large
+ * enough for L->smix2 if that is set.
+ */
+static void
+smix_lanes_work(struct smix_lanes * L, void * V, void * XY)
+{
+	uint32_t step = (L->smix2 != NULL) ? 2 : 1;
+	uint32_t i;
+
+	for (;;) {
+#ifdef SCRYPT_THREADS
+		i = __sync_fetch_and_add(&L->next, step);
+#else
+		i = L->next;
+		L->next += step;
+#endif
+		if (i >= L->p)
+			break;
+		if ((step == 2) && (i + 1 < L->p))
+			L->smix2(&L->B[i * 128 * L->r], L->r, L->N, V, XY);
+		else
+			L->smix1(&L->B[i * 128 * L->r], L->r, L->N, V, XY);
+	}
+}
+
+#ifdef SCRYPT_THREADS
+/**
+ * smix_lanes_thread(cookie):
+ * Allocate V and XY for one more thread and work on the lanes of cookie.
+ */
+static void *
+smix_lanes_thread(void * cookie)
+{
+	struct smix_lanes * L = cookie;
+	size_t lanes = (L->smix2 != NULL) ? 2 : 1;
+	size_t Vlen = 128 * L->r * L->N * lanes;
+	size_t XYlen = (256 * L->r + 64) * lanes;
+	void * V0, * XY0;
+	void * V, * XY;
+
+	if ((XY0 = malloc(XYlen + 63)) == NULL)
+		goto err0;
+	XY = (void *)(((uintptr_t)(XY0) + 63) & ~ (uintptr_t)(63));
+#ifdef MAP_ANON
+	if ((V0 = mmap(NULL, Vlen, PROT_READ | PROT_WRITE,
+#ifdef MAP_NOCORE
+	    MAP_ANON | MAP_PRIVATE | MAP_NOCORE,
+#else
+	    MAP_ANON | MAP_PRIVATE,
+#endif
+	    -1, 0)) == MAP_FAILED)
+		goto err1;
+	V = V0;
+#else
+	if ((V0 = malloc(Vlen + 63)) == NULL)
+		goto err1;
+	V = (void *)(((uintptr_t)(V0) + 63) & ~ (uintptr_t)(63));
+#endif
+
+	smix_lanes_work(L, V, XY);
+
+#ifdef MAP_ANON
+	munmap(V0, Vlen);
+#else
+	free(V0);
+#endif
+err1:
+	free(XY0);
+err0:
+	return (NULL);
+}
+#endif
+
+/**
+ * smix_lanes(L, V, XY):
+ * Compute B_i <-- MF(B_i, N) for all p lanes of L->B, using V and XY as the
+ * temporary storage of the calling thread.
+ */
+static void
+smix_lanes(struct smix_lanes * L, void * V, void * XY)
+{
+#ifdef SCRYPT_THREADS
+	pthread_t threads[SCRYPT_MAX_THREADS];
+	uint32_t step = (L->smix2 != NULL) ? 2 : 1;
+	uint32_t units = (L->p + step - 1) / step;
+	long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+	long nthreads, n;
+
+	/* Every thread beyond the first costs another V, so be frugal. */
+	n = (ncpus > SCRYPT_MAX_THREADS) ? SCRYPT_MAX_THREADS : ncpus;
+	if (n > (long)(units))
+		n = units;
+	for (nthreads = 0; nthreads < n - 1; nthreads++) {
+		if (pthread_create(&threads[nthreads], NULL,
+		    smix_lanes_thread, L))
+			break;
+	}
+#endif
+
+	smix_lanes_work(L, V, XY);
+
+#ifdef SCRYPT_THREADS
+	while (nthreads > 0)
+		pthread_join(threads[--nthreads], NULL);
+#endif
+}
+
+#endif /* !_CRYPTO_SCRYPT_LANES_H_ */
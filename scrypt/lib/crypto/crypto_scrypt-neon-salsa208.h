@@ -118,3 +118,115 @@ salsa20_8_intrinsic(void * input)
   vst1q_u8(32 + (uint8_t *) input,(uint8x16_t) x8x9x10x11);
   vst1q_u8(48 + (uint8_t *) input,(uint8x16_t) x12x13x14x15);
 }
+
+/*
+ * Helpers for salsa20_8_intrinsic_x2: move a block into and out of the
+ * diagonal layout used by salsa20_8_intrinsic above.
+ */
+static inline void
+salsa20_8_to_diagonals(void * input, uint32x4_t diag[4])
+{
+  const uint32x4_t abab = {-1,0,-1,0};
+
+  uint32x4_t x0x1x2x3 = vreinterpretq_u32_u8(vld1q_u8((uint8_t *) input));
+  uint32x4_t x4x5x6x7 = vreinterpretq_u32_u8(vld1q_u8(16 + (uint8_t *) input));
+  uint32x4_t x8x9x10x11 = vreinterpretq_u32_u8(vld1q_u8(32 + (uint8_t *) input));
+  uint32x4_t x12x13x14x15 = vreinterpretq_u32_u8(vld1q_u8(48 + (uint8_t *) input));
+
+  uint32x4_t x0x1x10x11 = vcombine_u32(vget_low_u32(x0x1x2x3), vget_high_u32(x8x9x10x11));
+  uint32x4_t x4x5x14x15 = vcombine_u32(vget_low_u32(x4x5x6x7), vget_high_u32(x12x13x14x15));
+  uint32x4_t x8x9x2x3 = vcombine_u32(vget_low_u32(x8x9x10x11), vget_high_u32(x0x1x2x3));
+  uint32x4_t x12x13x6x7 = vcombine_u32(vget_low_u32(x12x13x14x15), vget_high_u32(x4x5x6x7));
+
+  diag[0] = vbslq_u32(abab,x0x1x10x11,x4x5x14x15);
+  diag[1] = vbslq_u32(abab,x12x13x6x7,x0x1x10x11);
+  diag[2] = vbslq_u32(abab,x8x9x2x3,x12x13x6x7);
+  diag[3] = vbslq_u32(abab,x4x5x14x15,x8x9x2x3);
+}
+
+static inline void
+salsa20_8_from_diagonals(void * input, const uint32x4_t diag[4])
+{
+  const uint32x4_t abab = {-1,0,-1,0};
+
+  uint32x4_t x0x1x10x11 = vbslq_u32(abab,diag[0],diag[1]);
+  uint32x4_t x12x13x6x7 = vbslq_u32(abab,diag[1],diag[2]);
+  uint32x4_t x8x9x2x3 = vbslq_u32(abab,diag[2],diag[3]);
+  uint32x4_t x4x5x14x15 = vbslq_u32(abab,diag[3],diag[0]);
+
+  uint32x4_t x0x1x2x3 = vcombine_u32(vget_low_u32(x0x1x10x11),vget_high_u32(x8x9x2x3));
+  uint32x4_t x4x5x6x7 = vcombine_u32(vget_low_u32(x4x5x14x15),vget_high_u32(x12x13x6x7));
+  uint32x4_t x8x9x10x11 = vcombine_u32(vget_low_u32(x8x9x2x3),vget_high_u32(x0x1x10x11));
+  uint32x4_t x12x13x14x15 = vcombine_u32(vget_low_u32(x12x13x6x7),vget_high_u32(x4x5x14x15));
+
+  vst1q_u8((uint8_t *) input,vreinterpretq_u8_u32(x0x1x2x3));
+  vst1q_u8(16 + (uint8_t *) input,vreinterpretq_u8_u32(x4x5x6x7));
+  vst1q_u8(32 + (uint8_t *) input,vreinterpretq_u8_u32(x8x9x10x11));
+  vst1q_u8(48 + (uint8_t *) input,vreinterpretq_u8_u32(x12x13x14x15));
+}
+
+/* z ^= (x + y) <<< s, for both blocks at once. */
+#define SALSA20_8_STEP_X2(x, y, z, s) do { \
+    uint32x4_t ta = x##a + y##a; \
+    uint32x4_t tb = x##b + y##b; \
+    z##a ^= vsriq_n_u32(vshlq_n_u32(ta,s),ta,32 - (s)); \
+    z##b ^= vsriq_n_u32(vshlq_n_u32(tb,s),tb,32 - (s)); \
+  } while (0)
+
+/*
+ * Apply salsa20_8_intrinsic to two independent blocks.  Each step of one
+ * block depends on the step before it, so interleaving the two blocks keeps
+ * the NEON pipeline busy while either one waits on its previous result.
+ */
+static void
+salsa20_8_intrinsic_x2(void * input0, void * input1)
+{
+  int i;
+  uint32x4_t start0[4], start1[4];
+
+  salsa20_8_to_diagonals(input0, start0);
+  salsa20_8_to_diagonals(input1, start1);
+
+  uint32x4_t diag0a = start0[0], diag0b = start1[0];
+  uint32x4_t diag1a = start0[1], diag1b = start1[1];
+  uint32x4_t diag2a = start0[2], diag2b = start1[2];
+  uint32x4_t diag3a = start0[3], diag3b = start1[3];
+
+  for (i = ROUNDS;i > 0;i -= 2) {
+    SALSA20_8_STEP_X2(diag1, diag0, diag3, 7);
+    SALSA20_8_STEP_X2(diag0, diag3, diag2, 9);
+    SALSA20_8_STEP_X2(diag3, diag2, diag1, 13);
+    SALSA20_8_STEP_X2(diag2, diag1, diag0, 18);
+
+    diag3a = vextq_u32(diag3a,diag3a,3);
+    diag3b = vextq_u32(diag3b,diag3b,3);
+    diag2a = vextq_u32(diag2a,diag2a,2);
+    diag2b = vextq_u32(diag2b,diag2b,2);
+    diag1a = vextq_u32(diag1a,diag1a,1);
+    diag1b = vextq_u32(diag1b,diag1b,1);
+
+    SALSA20_8_STEP_X2(diag3, diag0, diag1, 7);
+    SALSA20_8_STEP_X2(diag0, diag1, diag2, 9);
+    SALSA20_8_STEP_X2(diag1, diag2, diag3, 13);
+    SALSA20_8_STEP_X2(diag2, diag3, diag0, 18);
+
+    diag1a = vextq_u32(diag1a,diag1a,3);
+    diag1b = vextq_u32(diag1b,diag1b,3);
+    diag2a = vextq_u32(diag2a,diag2a,2);
+    diag2b = vextq_u32(diag2b,diag2b,2);
+    diag3a = vextq_u32(diag3a,diag3a,1);
+    diag3b = vextq_u32(diag3b,diag3b,1);
+  }
+
+  start0[0] += diag0a;
+  start0[1] += diag1a;
+  start0[2] += diag2a;
+  start0[3] += diag3a;
+  start1[0] += diag0b;
+  start1[1] += diag1b;
+  start1[2] += diag2b;
+  start1[3] += diag3b;
+
+  salsa20_8_from_diagonals(input0, start0);
+  salsa20_8_from_diagonals(input1, start1);
+}
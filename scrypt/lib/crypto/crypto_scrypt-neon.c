@@ -46,6 +46,7 @@
 
 #include "crypto_scrypt.h"
 
+#include "crypto_scrypt-lanes.h"
 #include "crypto_scrypt-neon-salsa208.h"
 
 static void blkcpy(void *, void *, size_t);
@@ -54,6 +55,9 @@ void crypto_core_salsa208_armneon2(void *);
 static void blockmix_salsa8(uint8x16_t *, uint8x16_t *, uint8x16_t *, size_t);
 static uint64_t integerify(void *, size_t);
 static void smix(uint8_t *, size_t, uint64_t, void *, void *);
+static void blockmix_salsa8_x2(uint8x16_t *, uint8x16_t *, uint8x16_t *,
+    uint8x16_t *, uint8x16_t *, uint8x16_t *, size_t);
+static void smix2(uint8_t *, size_t, uint64_t, void *, void *);
 
 static void
 blkcpy(void * dest, void * src, size_t len)
@@ -112,6 +116,46 @@ blockmix_salsa8(uint8x16_t * Bin, uint8x16_t * Bout, uint8x16_t * X, size_t r)
 	}
 }
 
+/**
+ * blockmix_salsa8_x2(Bin0, Bout0, X0, Bin1, Bout1, X1, r):
+ * Compute Bout0 = BlockMix_{salsa20/8, r}(Bin0) and likewise for Bin1, with
+ * the two salsa20/8 cores interleaved.  The temporary spaces X0 and X1 must
+ * each be 64 bytes.
+ */
+static void
+blockmix_salsa8_x2(uint8x16_t * Bin0, uint8x16_t * Bout0, uint8x16_t * X0,
+    uint8x16_t * Bin1, uint8x16_t * Bout1, uint8x16_t * X1, size_t r)
+{
+	size_t i;
+
+	/* 1: X <-- B_{2r - 1} */
+	blkcpy(X0, &Bin0[8 * r - 4], 64);
+	blkcpy(X1, &Bin1[8 * r - 4], 64);
+
+	/* 2: for i = 0 to 2r - 1 do */
+	for (i = 0; i < r; i++) {
+		/* 3: X <-- H(X \xor B_i) */
+		blkxor(X0, &Bin0[i * 8], 64);
+		blkxor(X1, &Bin1[i * 8], 64);
+		salsa20_8_intrinsic_x2((void *) X0, (void *) X1);
+
+		/* 4: Y_i <-- X */
+		/* 6: B' <-- (Y_0, Y_2 ... Y_{2r-2}, Y_1, Y_3 ... Y_{2r-1}) */
+		blkcpy(&Bout0[i * 4], X0, 64);
+		blkcpy(&Bout1[i * 4], X1, 64);
+
+		/* 3: X <-- H(X \xor B_i) */
+		blkxor(X0, &Bin0[i * 8 + 4], 64);
+		blkxor(X1, &Bin1[i * 8 + 4], 64);
+		salsa20_8_intrinsic_x2((void *) X0, (void *) X1);
+
+		/* 4: Y_i <-- X */
+		/* 6: B' <-- (Y_0, Y_2 ... Y_{2r-2}, Y_1, Y_3 ... Y_{2r-1}) */
+		blkcpy(&Bout0[(r + i) * 4], X0, 64);
+		blkcpy(&Bout1[(r + i) * 4], X1, 64);
+	}
+}
+
 /**
  * integerify(B, r):
  * Return the result of parsing B_{2r-1} as a little-endian integer.
@@ -180,6 +224,74 @@ smix(uint8_t * B, size_t r, uint64_t N, void * V, void * XY)
 	blkcpy(B, X, 128 * r);
 }
 
+/**
+ * smix2(B, r, N, V, XY):
+ * Compute B = SMix_r(B, N) for the two adjacent lanes of B.  The input B must
+ * be 256r bytes in length; the temporary storage V must be 256rN bytes in
+ * length; the temporary storage XY must be 512r + 128 bytes in length.  The
+ * value N must be a power of 2.
+ */
+static void
+smix2(uint8_t * B, size_t r, uint64_t N, void * V, void * XY)
+{
+	uint8_t * B1 = &B[128 * r];
+	uint8x16_t * X0 = XY;
+	uint8x16_t * Y0 = (void *)((uintptr_t)(XY) + 128 * r);
+	uint8x16_t * Z0 = (void *)((uintptr_t)(XY) + 256 * r);
+	uint8x16_t * X1 = (void *)((uintptr_t)(XY) + 256 * r + 64);
+	uint8x16_t * Y1 = (void *)((uintptr_t)(XY) + 384 * r + 64);
+	uint8x16_t * Z1 = (void *)((uintptr_t)(XY) + 512 * r + 64);
+	uint8_t * V0 = V;
+	uint8_t * V1 = (void *)((uintptr_t)(V) + 128 * r * N);
+	uint64_t i, j0, j1;
+
+	/* 1: X <-- B */
+	blkcpy(X0, B, 128 * r);
+	blkcpy(X1, B1, 128 * r);
+
+	/* 2: for i = 0 to N - 1 do */
+	for (i = 0; i < N; i += 2) {
+		/* 3: V_i <-- X */
+		blkcpy(&V0[i * 128 * r], X0, 128 * r);
+		blkcpy(&V1[i * 128 * r], X1, 128 * r);
+
+		/* 4: X <-- H(X) */
+		blockmix_salsa8_x2(X0, Y0, Z0, X1, Y1, Z1, r);
+
+		/* 3: V_i <-- X */
+		blkcpy(&V0[(i + 1) * 128 * r], Y0, 128 * r);
+		blkcpy(&V1[(i + 1) * 128 * r], Y1, 128 * r);
+
+		/* 4: X <-- H(X) */
+		blockmix_salsa8_x2(Y0, X0, Z0, Y1, X1, Z1, r);
+	}
+
+	/* 6: for i = 0 to N - 1 do */
+	for (i = 0; i < N; i += 2) {
+		/* 7: j <-- Integerify(X) mod N */
+		j0 = integerify(X0, r) & (N - 1);
+		j1 = integerify(X1, r) & (N - 1);
+
+		/* 8: X <-- H(X \xor V_j) */
+		blkxor(X0, &V0[j0 * 128 * r], 128 * r);
+		blkxor(X1, &V1[j1 * 128 * r], 128 * r);
+		blockmix_salsa8_x2(X0, Y0, Z0, X1, Y1, Z1, r);
+
+		/* 7: j <-- Integerify(X) mod N */
+		j0 = integerify(Y0, r) & (N - 1);
+		j1 = integerify(Y1, r) & (N - 1);
+
+		/* 8: X <-- H(X \xor V_j) */
+		blkxor(Y0, &V0[j0 * 128 * r], 128 * r);
+		blkxor(Y1, &V1[j1 * 128 * r], 128 * r);
+		blockmix_salsa8_x2(Y0, X0, Z0, Y1, X1, Z1, r);
+	}
+
+	/* 10: B' <-- X */
+	blkcpy(B, X0, 128 * r);
+	blkcpy(B1, X1, 128 * r);
+}
+
 /**
  * crypto_scrypt(passwd, passwdlen, salt, saltlen, N, r, p, buf, buflen):
  * Compute scrypt(passwd[0 .. passwdlen - 1], salt[0 .. saltlen - 1], N, r,
@@ -198,7 +310,8 @@ crypto_scrypt(const uint8_t * passwd, size_t passwdlen,
 	uint8_t * B;
 	uint32_t * V;
 	uint32_t * XY;
-	uint32_t i;
+	size_t lanes, Vlen, XYlen;
+	struct smix_lanes L;
 
 	/* Sanity-check parameters. */
 #if SIZE_MAX > UINT32_MAX
@@ -224,16 +337,24 @@ crypto_scrypt(const uint8_t * passwd, size_t passwdlen,
 		goto err0;
 	}
 
+	/* Mix pairs of lanes together if there is more than one. */
+	lanes = 1;
+	if ((p > 1) && (N <= SIZE_MAX / 256 / r) &&
+	    (r <= (SIZE_MAX - 128) / 512))
+		lanes = 2;
+	Vlen = 128 * r * N * lanes;
+	XYlen = (256 * r + 64) * lanes;
+
 	/* Allocate memory. */
 #ifdef HAVE_POSIX_MEMALIGN
 	if ((errno = posix_memalign(&B0, 64, 128 * r * p)) != 0)
 		goto err0;
 	B = (uint8_t *)(B0);
-	if ((errno = posix_memalign(&XY0, 64, 256 * r + 64)) != 0)
+	if ((errno = posix_memalign(&XY0, 64, XYlen)) != 0)
 		goto err1;
 	XY = (uint32_t *)(XY0);
 #ifndef MAP_ANON
-	if ((errno = posix_memalign(&V0, 64, 128 * r * N)) != 0)
+	if ((errno = posix_memalign(&V0, 64, Vlen)) != 0)
 		goto err2;
 	V = (uint32_t *)(V0);
 #endif
@@ -241,17 +362,17 @@ crypto_scrypt(const uint8_t * passwd, size_t passwdlen,
 	if ((B0 = malloc(128 * r * p + 63)) == NULL)
 		goto err0;
 	B = (uint8_t *)(((uintptr_t)(B0) + 63) & ~ (uintptr_t)(63));
-	if ((XY0 = malloc(256 * r + 64 + 63)) == NULL)
+	if ((XY0 = malloc(XYlen + 63)) == NULL)
 		goto err1;
 	XY = (uint32_t *)(((uintptr_t)(XY0) + 63) & ~ (uintptr_t)(63));
 #ifndef MAP_ANON
-	if ((V0 = malloc(128 * r * N + 63)) == NULL)
+	if ((V0 = malloc(Vlen + 63)) == NULL)
 		goto err2;
 	V = (uint32_t *)(((uintptr_t)(V0) + 63) & ~ (uintptr_t)(63));
 #endif
 #endif
 #ifdef MAP_ANON
-	if ((V0 = mmap(NULL, 128 * r * N, PROT_READ | PROT_WRITE,
+	if ((V0 = mmap(NULL, Vlen, PROT_READ | PROT_WRITE,
 #ifdef MAP_NOCORE
 	    MAP_ANON | MAP_PRIVATE | MAP_NOCORE,
 #else
@@ -270,10 +391,15 @@ crypto_scrypt(const uint8_t * passwd, size_t passwdlen,
 #endif
 
 	/* 2: for i = 0 to p - 1 do */
-	for (i = 0; i < p; i++) {
-		/* 3: B_i <-- MF(B_i, N) */
-		smix(&B[i * 128 * r], r, N, V, XY);
-	}
+	/* 3: B_i <-- MF(B_i, N) */
+	L.B = B;
+	L.r = r;
+	L.N = N;
+	L.p = p;
+	L.smix1 = smix;
+	L.smix2 = (lanes == 2) ? smix2 : NULL;
+	L.next = 0;
+	smix_lanes(&L, V, XY);
 
 	/* 5: DK <-- PBKDF2(P, B, 1, dkLen) */
 #ifdef USE_OPENSSL_PBKDF2
@@ -284,7 +410,7 @@ crypto_scrypt(const uint8_t * passwd, size_t passwdlen,
 
 	/* Free memory. */
 #ifdef MAP_ANON
-	if (munmap(V0, 128 * r * N))
+	if (munmap(V0, Vlen))
 		goto err2;
 #else
 	free(V0);
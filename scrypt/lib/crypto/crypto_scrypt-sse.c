@@ -46,12 +46,25 @@
 
 #include "crypto_scrypt.h"
 
+#include "crypto_scrypt-lanes.h"
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define SCRYPT_AVX2
+#include <cpuid.h>
+#include <immintrin.h>
+#define AVX2 __attribute__((target("avx2")))
+#endif
+
 static void blkcpy(void *, void *, size_t);
 static void blkxor(void *, void *, size_t);
 static void salsa20_8(__m128i *);
 static void blockmix_salsa8(__m128i *, __m128i *, __m128i *, size_t);
 static uint64_t integerify(void *, size_t);
 static void smix(uint8_t *, size_t, uint64_t, void *, void *);
+#ifdef SCRYPT_AVX2
+static int avx2_supported(void);
+static void smix2(uint8_t *, size_t, uint64_t, void *, void *);
+#endif
 
 static void
 blkcpy(void * dest, void * src, size_t len)
@@ -253,6 +266,290 @@ smix(uint8_t * B, size_t r, uint64_t N, void * V, void * XY)
 	}
 }
 
+#ifdef SCRYPT_AVX2
+/**
+ * avx2_supported():
+ * Return nonzero if the CPU has AVX2 and the OS saves the YMM registers.
+ */
+static int
+avx2_supported(void)
+{
+	unsigned int a, b, c, d;
+	uint32_t xcr0;
+
+	if (!__get_cpuid(1, &a, &b, &c, &d))
+		return (0);
+	if ((c & (bit_OSXSAVE | bit_AVX)) != (bit_OSXSAVE | bit_AVX))
+		return (0);
+	__asm__ ("xgetbv" : "=a" (xcr0) : "c" (0) : "edx");
+	if ((xcr0 & 6) != 6)
+		return (0);
+	if (__get_cpuid_max(0, NULL) < 7)
+		return (0);
+	__cpuid_count(7, 0, a, b, c, d);
+
+	return ((b & bit_AVX2) != 0);
+}
+
+/*
+ * The routines below work on two lanes at once: every __m256i holds the
+ * __m128i which smix() would use for the first lane in its low half and
+ * the one for the second lane in its high half.  The salsa20/8 shuffles
+ * never cross the 128-bit halves, so the two lanes never mix.
+ */
+
+static AVX2 void
+blkcpy2(void * dest, void * src, size_t len)
+{
+	__m256i * D = dest;
+	__m256i * S = src;
+	size_t L = len / 32;
+	size_t i;
+
+	for (i = 0; i < L; i++)
+		D[i] = S[i];
+}
+
+static AVX2 void
+blkxor2(void * dest, void * src, size_t len)
+{
+	__m256i * D = dest;
+	__m256i * S = src;
+	size_t L = len / 32;
+	size_t i;
+
+	for (i = 0; i < L; i++)
+		D[i] = _mm256_xor_si256(D[i], S[i]);
+}
+
+/**
+ * blksplit2(dest0, dest1, src, len):
+ * Store the first and second lane of the len / 16 vectors at src into
+ * dest0 and dest1 respectively.
+ */
+static AVX2 void
+blksplit2(void * dest0, void * dest1, void * src, size_t len)
+{
+	__m128i * D0 = dest0;
+	__m128i * D1 = dest1;
+	__m256i * S = src;
+	size_t L = len / 16;
+	size_t i;
+
+	for (i = 0; i < L; i++) {
+		D0[i] = _mm256_castsi256_si128(S[i]);
+		D1[i] = _mm256_extracti128_si256(S[i], 1);
+	}
+}
+
+/**
+ * blkxorjoin2(dest, src0, src1, len):
+ * XOR src0 into the first lane and src1 into the second lane of the len / 16
+ * vectors at dest.
+ */
+static AVX2 void
+blkxorjoin2(void * dest, void * src0, void * src1, size_t len)
+{
+	__m256i * D = dest;
+	__m128i * S0 = src0;
+	__m128i * S1 = src1;
+	size_t L = len / 16;
+	size_t i;
+
+	for (i = 0; i < L; i++)
+		D[i] = _mm256_xor_si256(D[i], _mm256_inserti128_si256(
+		    _mm256_castsi128_si256(S0[i]), S1[i], 1));
+}
+
+/**
+ * salsa20_8_x2(B):
+ * Apply the salsa20/8 core to both lanes of the provided block.
+ */
+static AVX2 void
+salsa20_8_x2(__m256i B[4])
+{
+	__m256i X0, X1, X2, X3;
+	__m256i T;
+	size_t i;
+
+	X0 = B[0];
+	X1 = B[1];
+	X2 = B[2];
+	X3 = B[3];
+
+	for (i = 0; i < 8; i += 2) {
+		/* Operate on "columns". */
+		T = _mm256_add_epi32(X0, X3);
+		X1 = _mm256_xor_si256(X1, _mm256_slli_epi32(T, 7));
+		X1 = _mm256_xor_si256(X1, _mm256_srli_epi32(T, 25));
+		T = _mm256_add_epi32(X1, X0);
+		X2 = _mm256_xor_si256(X2, _mm256_slli_epi32(T, 9));
+		X2 = _mm256_xor_si256(X2, _mm256_srli_epi32(T, 23));
+		T = _mm256_add_epi32(X2, X1);
+		X3 = _mm256_xor_si256(X3, _mm256_slli_epi32(T, 13));
+		X3 = _mm256_xor_si256(X3, _mm256_srli_epi32(T, 19));
+		T = _mm256_add_epi32(X3, X2);
+		X0 = _mm256_xor_si256(X0, _mm256_slli_epi32(T, 18));
+		X0 = _mm256_xor_si256(X0, _mm256_srli_epi32(T, 14));
+
+		/* Rearrange data. */
+		X1 = _mm256_shuffle_epi32(X1, 0x93);
+		X2 = _mm256_shuffle_epi32(X2, 0x4E);
+		X3 = _mm256_shuffle_epi32(X3, 0x39);
+
+		/* Operate on "rows". */
+		T = _mm256_add_epi32(X0, X1);
+		X3 = _mm256_xor_si256(X3, _mm256_slli_epi32(T, 7));
+		X3 = _mm256_xor_si256(X3, _mm256_srli_epi32(T, 25));
+		T = _mm256_add_epi32(X3, X0);
+		X2 = _mm256_xor_si256(X2, _mm256_slli_epi32(T, 9));
+		X2 = _mm256_xor_si256(X2, _mm256_srli_epi32(T, 23));
+		T = _mm256_add_epi32(X2, X3);
+		X1 = _mm256_xor_si256(X1, _mm256_slli_epi32(T, 13));
+		X1 = _mm256_xor_si256(X1, _mm256_srli_epi32(T, 19));
+		T = _mm256_add_epi32(X1, X2);
+		X0 = _mm256_xor_si256(X0, _mm256_slli_epi32(T, 18));
+		X0 = _mm256_xor_si256(X0, _mm256_srli_epi32(T, 14));
+
+		/* Rearrange data. */
+		X1 = _mm256_shuffle_epi32(X1, 0x39);
+		X2 = _mm256_shuffle_epi32(X2, 0x4E);
+		X3 = _mm256_shuffle_epi32(X3, 0x93);
+	}
+
+	B[0] = _mm256_add_epi32(B[0], X0);
+	B[1] = _mm256_add_epi32(B[1], X1);
+	B[2] = _mm256_add_epi32(B[2], X2);
+	B[3] = _mm256_add_epi32(B[3], X3);
+}
+
+/**
+ * blockmix_salsa8_x2(Bin, Bout, X, r):
+ * Compute Bout = BlockMix_{salsa20/8, r}(Bin) for both lanes.  The input Bin
+ * must be 256r bytes in length; the output Bout must also be the same size.
+ * The temporary space X must be 128 bytes.
+ */
+static AVX2 void
+blockmix_salsa8_x2(__m256i * Bin, __m256i * Bout, __m256i * X, size_t r)
+{
+	size_t i;
+
+	/* 1: X <-- B_{2r - 1} */
+	blkcpy2(X, &Bin[8 * r - 4], 128);
+
+	/* 2: for i = 0 to 2r - 1 do */
+	for (i = 0; i < r; i++) {
+		/* 3: X <-- H(X \xor B_i) */
+		blkxor2(X, &Bin[i * 8], 128);
+		salsa20_8_x2(X);
+
+		/* 4: Y_i <-- X */
+		/* 6: B' <-- (Y_0, Y_2 ... Y_{2r-2}, Y_1, Y_3 ... Y_{2r-1}) */
+		blkcpy2(&Bout[i * 4], X, 128);
+
+		/* 3: X <-- H(X \xor B_i) */
+		blkxor2(X, &Bin[i * 8 + 4], 128);
+		salsa20_8_x2(X);
+
+		/* 4: Y_i <-- X */
+		/* 6: B' <-- (Y_0, Y_2 ... Y_{2r-2}, Y_1, Y_3 ... Y_{2r-1}) */
+		blkcpy2(&Bout[(r + i) * 4], X, 128);
+	}
+}
+
+/**
+ * integerify2(B, r, l):
+ * Return the result of parsing B_{2r-1} of lane l as a little-endian integer.
+ */
+static uint64_t
+integerify2(void * B, size_t r, size_t l)
+{
+	uint32_t * X = (void *)((uintptr_t)(B) + (2 * r - 1) * 128);
+
+	return (((uint64_t)(X[3 * 8 + l * 4 + 1]) << 32) + X[l * 4]);
+}
+
+/**
+ * smix2(B, r, N, V, XY):
+ * Compute B = SMix_r(B, N) for the two adjacent lanes of B.  The input B must
+ * be 256r bytes in length; the temporary storage V must be 256rN bytes in
+ * length; the temporary storage XY must be 512r + 128 bytes in length.  The
+ * value N must be a power of 2 greater than 1.  The arrays B, V, and XY must
+ * be aligned to a multiple of 64 bytes.
+ */
+static AVX2 void
+smix2(uint8_t * B, size_t r, uint64_t N, void * V, void * XY)
+{
+	__m256i * X = XY;
+	__m256i * Y = (void *)((uintptr_t)(XY) + 256 * r);
+	__m256i * Z = (void *)((uintptr_t)(XY) + 512 * r);
+	uint32_t * X32 = (void *)X;
+	uint8_t * V0 = V;
+	uint8_t * V1 = (void *)((uintptr_t)(V) + 128 * r * N);
+	uint64_t i, j0, j1;
+	size_t k, l, w;
+
+	/* 1: X <-- B */
+	for (l = 0; l < 2; l++) {
+		for (k = 0; k < 2 * r; k++) {
+			for (i = 0; i < 16; i++) {
+				w = k * 16 + i;
+				X32[(w & ~3) * 2 + l * 4 + (w & 3)] =
+				    le32dec(&B[l * 128 * r +
+				    (k * 16 + (i * 5 % 16)) * 4]);
+			}
+		}
+	}
+
+	/* 2: for i = 0 to N - 1 do */
+	for (i = 0; i < N; i += 2) {
+		/* 3: V_i <-- X */
+		blksplit2(&V0[i * 128 * r], &V1[i * 128 * r], X, 128 * r);
+
+		/* 4: X <-- H(X) */
+		blockmix_salsa8_x2(X, Y, Z, r);
+
+		/* 3: V_i <-- X */
+		blksplit2(&V0[(i + 1) * 128 * r], &V1[(i + 1) * 128 * r],
+		    Y, 128 * r);
+
+		/* 4: X <-- H(X) */
+		blockmix_salsa8_x2(Y, X, Z, r);
+	}
+
+	/* 6: for i = 0 to N - 1 do */
+	for (i = 0; i < N; i += 2) {
+		/* 7: j <-- Integerify(X) mod N */
+		j0 = integerify2(X, r, 0) & (N - 1);
+		j1 = integerify2(X, r, 1) & (N - 1);
+
+		/* 8: X <-- H(X \xor V_j) */
+		blkxorjoin2(X, &V0[j0 * 128 * r], &V1[j1 * 128 * r], 128 * r);
+		blockmix_salsa8_x2(X, Y, Z, r);
+
+		/* 7: j <-- Integerify(X) mod N */
+		j0 = integerify2(Y, r, 0) & (N - 1);
+		j1 = integerify2(Y, r, 1) & (N - 1);
+
+		/* 8: X <-- H(X \xor V_j) */
+		blkxorjoin2(Y, &V0[j0 * 128 * r], &V1[j1 * 128 * r], 128 * r);
+		blockmix_salsa8_x2(Y, X, Z, r);
+	}
+
+	/* 10: B' <-- X */
+	for (l = 0; l < 2; l++) {
+		for (k = 0; k < 2 * r; k++) {
+			for (i = 0; i < 16; i++) {
+				w = k * 16 + i;
+				le32enc(&B[l * 128 * r +
+				    (k * 16 + (i * 5 % 16)) * 4],
+				    X32[(w & ~3) * 2 + l * 4 + (w & 3)]);
+			}
+		}
+	}
+}
+#endif
+
 /**
  * crypto_scrypt(passwd, passwdlen, salt, saltlen, N, r, p, buf, buflen):
  * Compute scrypt(passwd[0 .. passwdlen - 1], salt[0 .. saltlen - 1], N, r,
@@ -271,7 +568,8 @@ crypto_scrypt(const uint8_t * passwd, size_t passwdlen,
 	uint8_t * B;
 	uint32_t * V;
 	uint32_t * XY;
-	uint32_t i;
+	size_t lanes, Vlen, XYlen;
+	struct smix_lanes L;
 
 	/* Sanity-check parameters. */
 #if SIZE_MAX > UINT32_MAX
@@ -297,16 +595,26 @@ crypto_scrypt(const uint8_t * passwd, size_t passwdlen,
 		goto err0;
 	}
 
+	/* Mix pairs of lanes together with AVX2 if there is more than one. */
+	lanes = 1;
+#ifdef SCRYPT_AVX2
+	if ((p > 1) && (N <= SIZE_MAX / 256 / r) &&
+	    (r <= (SIZE_MAX - 128) / 512) && avx2_supported())
+		lanes = 2;
+#endif
+	Vlen = 128 * r * N * lanes;
+	XYlen = (256 * r + 64) * lanes;
+
 	/* Allocate memory. */
 #ifdef HAVE_POSIX_MEMALIGN
 	if ((errno = posix_memalign(&B0, 64, 128 * r * p)) != 0)
 		goto err0;
 	B = (uint8_t *)(B0);
-	if ((errno = posix_memalign(&XY0, 64, 256 * r + 64)) != 0)
+	if ((errno = posix_memalign(&XY0, 64, XYlen)) != 0)
 		goto err1;
 	XY = (uint32_t *)(XY0);
 #ifndef MAP_ANON
-	if ((errno = posix_memalign(&V0, 64, 128 * r * N)) != 0)
+	if ((errno = posix_memalign(&V0, 64, Vlen)) != 0)
 		goto err2;
 	V = (uint32_t *)(V0);
 #endif
@@ -314,17 +622,17 @@ crypto_scrypt(const uint8_t * passwd, size_t passwdlen,
 	if ((B0 = malloc(128 * r * p + 63)) == NULL)
 		goto err0;
 	B = (uint8_t *)(((uintptr_t)(B0) + 63) & ~ (uintptr_t)(63));
-	if ((XY0 = malloc(256 * r + 64 + 63)) == NULL)
+	if ((XY0 = malloc(XYlen + 63)) == NULL)
 		goto err1;
 	XY = (uint32_t *)(((uintptr_t)(XY0) + 63) & ~ (uintptr_t)(63));
 #ifndef MAP_ANON
-	if ((V0 = malloc(128 * r * N + 63)) == NULL)
+	if ((V0 = malloc(Vlen + 63)) == NULL)
 		goto err2;
 	V = (uint32_t *)(((uintptr_t)(V0) + 63) & ~ (uintptr_t)(63));
 #endif
 #endif
 #ifdef MAP_ANON
-	if ((V0 = mmap(NULL, 128 * r * N, PROT_READ | PROT_WRITE,
+	if ((V0 = mmap(NULL, Vlen, PROT_READ | PROT_WRITE,
 #ifdef MAP_NOCORE
 	    MAP_ANON | MAP_PRIVATE | MAP_NOCORE,
 #else
@@ -343,10 +651,15 @@ crypto_scrypt(const uint8_t * passwd, size_t passwdlen,
 #endif
 
 	/* 2: for i = 0 to p - 1 do */
-	for (i = 0; i < p; i++) {
-		/* 3: B_i <-- MF(B_i, N) */
-		smix(&B[i * 128 * r], r, N, V, XY);
-	}
+	/* 3: B_i <-- MF(B_i, N) */
+	L.B = B;
+	L.r = r;
+	L.N = N;
+	L.p = p;
+	L.smix1 = smix;
+	L.smix2 = (lanes == 2) ? smix2 : NULL;
+	L.next = 0;
+	smix_lanes(&L, V, XY);
 
 	/* 5: DK <-- PBKDF2(P, B, 1, dkLen) */
 #ifdef USE_OPENSSL_PBKDF2
@@ -357,7 +670,7 @@ crypto_scrypt(const uint8_t * passwd, size_t passwdlen,
 
 	/* Free memory. */
 #ifdef MAP_ANON
-	if (munmap(V0, 128 * r * N))
+	if (munmap(V0, Vlen))
 		goto err2;
 #else
 	free(V0);
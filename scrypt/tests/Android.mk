@@ -23,3 +23,40 @@ LOCAL_STATIC_LIBRARIES := \
 LOCAL_MODULE := scrypt_test
 
 include $(BUILD_NATIVE_TEST)
+
+# Build the scrypt benchmark. crypto_scrypt-ref.c is compiled in under
+# another name so that it can be compared with the library's SSE or NEON
+# implementation.
+
+include $(CLEAR_VARS)
+
+LOCAL_ADDITIONAL_DEPENDENCIES := $(LOCAL_PATH)/Android.mk
+
+LOCAL_CLANG := true
+
+LOCAL_SRC_FILES:= \
+    scrypt_benchmark.cpp \
+    ../lib/crypto/crypto_scrypt-ref.c
+
+LOCAL_CFLAGS := \
+    -DHAVE_CONFIG_H \
+    -DUSE_OPENSSL_PBKDF2
+
+LOCAL_CONLYFLAGS := \
+    -Dcrypto_scrypt=crypto_scrypt_ref
+
+LOCAL_C_INCLUDES := \
+    external/scrypt \
+    external/scrypt/lib/crypto \
+    external/scrypt/lib/util
+
+LOCAL_SHARED_LIBRARIES := \
+    libcrypto
+
+LOCAL_STATIC_LIBRARIES := \
+    libscrypt_static \
+
+LOCAL_MODULE := scrypt_benchmark
+LOCAL_MODULE_TAGS := tests
+
+include $(BUILD_EXECUTABLE)
@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2013 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Measures crypto_scrypt throughput and peak memory for a set of N, r, p
+ * parameters, to help pick cost parameters for a class of device.
+ *
+ * Every implementation built for the target is measured: the portable
+ * reference code and, where the library uses one, the SSE or NEON version.
+ * Each measurement runs in a child process of its own so that the peak
+ * resident set size reported for it covers only that measurement.  Running
+ * several hashes concurrently (-j) shows where the device runs out of memory
+ * bandwidth: hashes per second stop growing with the number of jobs.
+ *
+ * usage: scrypt_benchmark [-c] [-i iterations] [-j jobs[,jobs...]] [N:r:p ...]
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <vector>
+
+extern "C" {
+#include <crypto_scrypt.h>
+
+/* crypto_scrypt-ref.c, built into this binary under another name. */
+int crypto_scrypt_ref(const uint8_t *, size_t, const uint8_t *, size_t, uint64_t,
+        uint32_t, uint32_t, uint8_t *, size_t);
+}
+
+typedef int (*scrypt_fn)(const uint8_t *, size_t, const uint8_t *, size_t, uint64_t,
+        uint32_t, uint32_t, uint8_t *, size_t);
+
+struct implementation {
+    const char* name;
+    scrypt_fn fn;
+};
+
+static const implementation implementations[] = {
+    {"ref", crypto_scrypt_ref},
+#if defined(__i386__) || defined(__x86_64__)
+    {"sse", crypto_scrypt},
+#elif defined(__arm__) && defined(__ARM_NEON__)
+    {"neon", crypto_scrypt},
+#endif
+};
+
+struct parameters {
+    uint64_t N;
+    uint32_t r, p;
+};
+
+/* Typical choices, from interactive logins up to file encryption. */
+static const parameters default_parameters[] = {
+    {1024, 8, 1},
+    {4096, 8, 1},
+    {16384, 8, 1},
+    {32768, 8, 1},
+    {16384, 8, 4},
+    {1024, 8, 16},
+};
+
+static const unsigned default_jobs[] = {1, 2, 4};
+
+struct job {
+    scrypt_fn fn;
+    parameters params;
+    unsigned iterations;
+    int failed;
+};
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void* run_job(void* cookie) {
+    job* j = static_cast<job*>(cookie);
+    static const char pw[] = "pleaseletmein";
+    static const char salt[] = "SodiumChloride";
+    uint8_t out[64];
+
+    for (unsigned i = 0; i < j->iterations; i++) {
+        if (j->fn(reinterpret_cast<const uint8_t*>(pw), sizeof(pw) - 1,
+                reinterpret_cast<const uint8_t*>(salt), sizeof(salt) - 1,
+                j->params.N, j->params.r, j->params.p, out, sizeof(out)) != 0) {
+            j->failed = errno;
+            break;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Runs jobs concurrent loops of iterations hashes each in a child process.
+ * Returns the wall time taken, or a negative value on failure, and stores
+ * the peak resident set size of the child in maxrss_kb.
+ */
+static double measure(scrypt_fn fn, const parameters& params, unsigned jobs,
+        unsigned iterations, long* maxrss_kb) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return -1;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        std::vector<job> work(jobs);
+        std::vector<pthread_t> threads(jobs);
+        double elapsed = -1;
+        unsigned started;
+
+        double start = now();
+        for (started = 0; started < jobs; started++) {
+            job j = {fn, params, iterations, 0};
+            work[started] = j;
+            if (pthread_create(&threads[started], NULL, run_job, &work[started]) != 0) {
+                break;
+            }
+        }
+        for (unsigned i = 0; i < started; i++) {
+            pthread_join(threads[i], NULL);
+        }
+        if (started == jobs) {
+            elapsed = now() - start;
+            for (unsigned i = 0; i < jobs; i++) {
+                if (work[i].failed) {
+                    elapsed = -1;
+                }
+            }
+        }
+        write(fds[1], &elapsed, sizeof(elapsed));
+        _exit(0);
+    }
+
+    close(fds[1]);
+    double elapsed = -1;
+    if (read(fds[0], &elapsed, sizeof(elapsed)) != sizeof(elapsed)) {
+        elapsed = -1;
+    }
+    close(fds[0]);
+
+    struct rusage usage;
+    int status;
+    if (wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status)) {
+        return -1;
+    }
+    *maxrss_kb = usage.ru_maxrss;
+    return elapsed;
+}
+
+static bool parse_parameters(const char* arg, parameters* params) {
+    unsigned long long N;
+    unsigned r, p;
+    char extra;
+
+    if (sscanf(arg, "%llu:%u:%u%c", &N, &r, &p, &extra) != 3) {
+        return false;
+    }
+    if (N < 2 || (N & (N - 1)) != 0 || r == 0 || p == 0) {
+        return false;
+    }
+    params->N = N;
+    params->r = r;
+    params->p = p;
+    return true;
+}
+
+static bool parse_jobs(const char* arg, std::vector<unsigned>* jobs) {
+    jobs->clear();
+    while (*arg != '\0') {
+        char* end;
+        unsigned long n = strtoul(arg, &end, 10);
+        if (end == arg || n == 0 || (*end != ',' && *end != '\0')) {
+            return false;
+        }
+        jobs->push_back(n);
+        arg = (*end == ',') ? end + 1 : end;
+    }
+    return !jobs->empty();
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [-c] [-i iterations] [-j jobs[,jobs...]] [N:r:p ...]\n"
+            "  -c  print comma separated values\n"
+            "  -i  hashes per job for each measurement (default 4)\n"
+            "  -j  numbers of concurrent jobs to measure (default 1,2,4)\n",
+            argv0);
+    exit(1);
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<parameters> params;
+    std::vector<unsigned> jobs(default_jobs,
+            default_jobs + sizeof(default_jobs) / sizeof(default_jobs[0]));
+    unsigned iterations = 4;
+    bool csv = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "ci:j:")) != -1) {
+        switch (opt) {
+        case 'c':
+            csv = true;
+            break;
+        case 'i':
+            iterations = strtoul(optarg, NULL, 10);
+            if (iterations == 0) {
+                usage(argv[0]);
+            }
+            break;
+        case 'j':
+            if (!parse_jobs(optarg, &jobs)) {
+                usage(argv[0]);
+            }
+            break;
+        default:
+            usage(argv[0]);
+        }
+    }
+    for (int i = optind; i < argc; i++) {
+        parameters p;
+        if (!parse_parameters(argv[i], &p)) {
+            usage(argv[0]);
+        }
+        params.push_back(p);
+    }
+    if (params.empty()) {
+        params.assign(default_parameters, default_parameters +
+                sizeof(default_parameters) / sizeof(default_parameters[0]));
+    }
+
+    /*
+     * min MiB is what one hash needs at the least (B, V and XY); the library
+     * may use more to mix lanes in pairs or on several threads.  The
+     * MiB*s column is the memory-time product an attacker has to pay.
+     */
+    if (csv) {
+        printf("impl,N,r,p,jobs,hashes,ms_per_hash,hashes_per_s,min_mib,peak_mib,mib_s\n");
+    } else {
+        printf("%-5s %8s %3s %3s %4s %6s %10s %10s %8s %9s %8s\n", "impl", "N", "r", "p",
+                "jobs", "hashes", "ms/hash", "hashes/s", "min MiB", "peak MiB", "MiB*s");
+    }
+
+    for (size_t i = 0; i < sizeof(implementations) / sizeof(implementations[0]); i++) {
+        for (size_t k = 0; k < params.size(); k++) {
+            const parameters& pa = params[k];
+            double min_mib = (128.0 * pa.r * pa.N + 128.0 * pa.r * pa.p + 256.0 * pa.r + 64)
+                    / (1 << 20);
+
+            for (size_t n = 0; n < jobs.size(); n++) {
+                long maxrss_kb = 0;
+                double elapsed = measure(implementations[i].fn, pa, jobs[n], iterations,
+                        &maxrss_kb);
+                if (elapsed < 0) {
+                    fprintf(stderr, "%s N=%llu r=%u p=%u jobs=%u: failed\n",
+                            implementations[i].name, (unsigned long long) pa.N, pa.r, pa.p,
+                            jobs[n]);
+                    continue;
+                }
+
+                unsigned hashes = jobs[n] * iterations;
+                double ms_per_hash = elapsed * 1000 / iterations;
+                double peak_mib = maxrss_kb / 1024.0;
+                printf(csv ? "%s,%llu,%u,%u,%u,%u,%.3f,%.2f,%.2f,%.2f,%.3f\n"
+                           : "%-5s %8llu %3u %3u %4u %6u %10.3f %10.2f %8.2f %9.2f %8.3f\n",
+                        implementations[i].name, (unsigned long long) pa.N, pa.r, pa.p,
+                        jobs[n], hashes, ms_per_hash, hashes / elapsed, min_mib, peak_mib,
+                        min_mib * ms_per_hash / 1000);
+                fflush(stdout);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -38,6 +38,8 @@ static const scrypt_test_setting post_settings[] = {
         {"", "", 16, 1, 1},
         {"password", "NaCl", 1024, 8, 16},
         {"pleaseletmein", "SodiumChloride", 16384, 8, 1},
+        // Odd p: the last lane is mixed on its own rather than in a pair.
+        {"password", "NaCl", 1024, 8, 3},
         {0, 0, 0, 0, 0}
 };
 
@@ -54,6 +56,10 @@ static const uint8_t post_vectors[][64] = {
          0xfd,0xa8,0xfb,0xba,0x90,0x4f,0x8e,0x3e,0xa9,0xb5,0x43,0xf6,0x54,0x5d,0xa1,0xf2,
          0xd5,0x43,0x29,0x55,0x61,0x3f,0x0f,0xcf,0x62,0xd4,0x97,0x05,0x24,0x2a,0x9a,0xf9,
          0xe6,0x1e,0x85,0xdc,0x0d,0x65,0x1e,0x40,0xdf,0xcf,0x01,0x7b,0x45,0x57,0x58,0x87},
+        {0x26,0xa6,0x58,0xb5,0x0d,0xb3,0xd6,0x1d,0x6c,0x21,0xd9,0xe9,0xe7,0x08,0x59,0x3d,
+         0x3a,0xb8,0x5b,0xd1,0x34,0xf4,0xc4,0x9a,0x7c,0x73,0xe9,0x82,0x86,0x0c,0xcc,0x18,
+         0xee,0x18,0xb7,0x21,0x3d,0x4d,0x65,0xea,0x00,0xb1,0x67,0x16,0x02,0x79,0x6c,0x51,
+         0xdc,0xa0,0x0e,0x12,0x4f,0x6e,0xbb,0x62,0xcb,0xad,0x38,0x94,0xde,0xee,0x2a,0x5f},
 };
 
 class ScryptTest : public ::testing::Test {
@@ -168,6 +168,10 @@ struct avc_lock_callback {
 #define AVC_OPT_UNUSED		0
 /* override kernel enforcing mode (boolean value) */
 #define AVC_OPT_SETENFORCE	1
+/* maximum number of cached decisions (integer value, default 410) */
+#define AVC_OPT_CACHE_SIZE	2
+/* remember the last decision on each thread (boolean value) */
+#define AVC_OPT_THREAD_CACHE	3
 
 /*
  * AVC operations
@@ -417,8 +421,9 @@ void avc_cache_stats(struct avc_cache_stats *stats);
  * avc_av_stats - log av table statistics.
  *
  * Log a message with information about the size and
- * distribution of the access vector table.  The audit
- * callback is used to print the message.
+ * distribution of the access vector table, and how many
+ * lookups were answered without taking the AVC lock.  The
+ * audit callback is used to print the message.
  */
 void avc_av_stats(void);
 
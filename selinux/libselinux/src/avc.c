@@ -13,8 +13,10 @@
 #include "avc_sidtab.h"
 #include "avc_internal.h"
 
-#define AVC_CACHE_SLOTS		512
-#define AVC_CACHE_MAXNODES	410
+#define AVC_CACHE_SLOTS		512	/* to start with */
+#define AVC_CACHE_MAXSLOTS	65536
+#define AVC_CACHE_MAXNODES	410	/* default; see AVC_OPT_CACHE_SIZE */
+#define AVC_READ_RETRIES	4
 
 struct avc_entry {
 	security_id_t ssid;
@@ -30,13 +32,53 @@ struct avc_node {
 	struct avc_node *next;
 };
 
+/*
+ * The hash table.  When it grows it is replaced rather than resized, and
+ * the tables it replaced are kept until avc_destroy(), since lookups made
+ * without avc_lock may still be reading them.
+ */
+struct avc_slots {
+	uint32_t mask;		/* number of slots - 1 */
+	struct avc_slots *retired;	/* the table this one replaced */
+	struct avc_node *slot[];
+};
+
+/*
+ * The cache is changed only with avc_lock held, between avc_write_begin()
+ * and avc_write_end(), which make seq odd for the duration.  Lookups read
+ * it without the lock and start again if seq changed meanwhile; nodes are
+ * reused but not freed before avc_destroy(), so a lookup racing with a
+ * change reads a stale node at worst, and throws away what it read.
+ */
 struct avc_cache {
-	struct avc_node *slots[AVC_CACHE_SLOTS];
+	struct avc_slots *slots;
+	uint32_t seq;
+	uint32_t generation;	/* bumped when cached decisions change */
 	uint32_t lru_hint;	/* LRU hint for reclaim scan */
 	uint32_t active_nodes;
+	uint32_t total_nodes;	/* allocated, active or free */
 	uint32_t latest_notif;	/* latest revocation notification */
 };
 
+/* how avc_has_perm_noaudit() found its decisions, for avc_av_stats() */
+struct avc_lookup_stats {
+	unsigned unlocked_hits;
+	unsigned thread_hits;
+	unsigned retries;	/* lookups started again after a change */
+	unsigned locked_lookups;	/* lookups that took avc_lock */
+	unsigned resizes;
+};
+
+/* the last decision made on this thread, with AVC_OPT_THREAD_CACHE */
+struct avc_last_decision {
+	security_id_t ssid;
+	security_id_t tsid;
+	security_class_t tclass;
+	uint32_t generation;
+	struct av_decision avd;
+	struct avc_entry *ae;	/* where it came from, to mark it used */
+};
+
 struct avc_callback_node {
 	int (*callback) (uint32_t event, security_id_t ssid,
 			 security_id_t tsid,
@@ -57,14 +99,54 @@ static struct avc_node *avc_node_freelist = NULL;
 static struct avc_cache avc_cache;
 static char *avc_audit_buf = NULL;
 static struct avc_cache_stats cache_stats;
+static struct avc_lookup_stats lookup_stats;
 static struct avc_callback_node *avc_callbacks = NULL;
 static struct sidtab avc_sidtab;
+static uint32_t avc_max_nodes = AVC_CACHE_MAXNODES;
+static int avc_thread_cache = 0;
+static __thread struct avc_last_decision avc_last;
 
 static inline int avc_hash(security_id_t ssid,
-			   security_id_t tsid, security_class_t tclass)
+			   security_id_t tsid, security_class_t tclass,
+			   uint32_t mask)
+{
+	/* SIDs are pointers, whose low bits vary little; mix in the high ones */
+	uint32_t h = ((uintptr_t) ssid ^ ((uintptr_t) tsid << 2) ^ tclass) *
+	    2654435761U;
+
+	return (h ^ (h >> 16)) & mask;
+}
+
+static inline void avc_write_begin(void)
+{
+	__atomic_store_n(&avc_cache.seq, avc_cache.seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void avc_write_end(void)
+{
+	__atomic_store_n(&avc_cache.seq, avc_cache.seq + 1, __ATOMIC_RELEASE);
+}
+
+static inline int avc_read_retry(uint32_t seq)
 {
-	return ((uintptr_t) ssid ^ ((uintptr_t) tsid << 2) ^ tclass)
-	    & (AVC_CACHE_SLOTS - 1);
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return __atomic_load_n(&avc_cache.seq, __ATOMIC_RELAXED) != seq;
+}
+
+/* Make the per-thread decisions stale. */
+static inline void avc_new_generation(void)
+{
+	__atomic_fetch_add(&avc_cache.generation, 1, __ATOMIC_RELEASE);
+}
+
+/*
+ * Give @ae a second chance in avc_reclaim_node().  Lookups without
+ * avc_lock set it too, so it is only ever accessed atomically.
+ */
+static inline void avc_mark_used(struct avc_entry *ae)
+{
+	__atomic_store_n(&ae->used, 1, __ATOMIC_RELAXED);
 }
 
 int avc_context_to_sid_raw(const char * ctx, security_id_t * sid)
@@ -148,6 +230,8 @@ int avc_get_initial_sid(const char * name, security_id_t * sid)
 int avc_open(struct selinux_opt *opts, unsigned nopts)
 {
 	avc_setenforce = 0;
+	avc_max_nodes = AVC_CACHE_MAXNODES;
+	avc_thread_cache = 0;
 
 	while (nopts--)
 		switch(opts[nopts].type) {
@@ -155,6 +239,13 @@ int avc_open(struct selinux_opt *opts, unsigned nopts)
 			avc_setenforce = 1;
 			avc_enforcing = !!opts[nopts].value;
 			break;
+		case AVC_OPT_CACHE_SIZE:
+			if ((uintptr_t)opts[nopts].value)
+				avc_max_nodes = (uintptr_t)opts[nopts].value;
+			break;
+		case AVC_OPT_THREAD_CACHE:
+			avc_thread_cache = !!opts[nopts].value;
+			break;
 		}
 
 	return avc_init("avc", NULL, NULL, NULL, NULL);
@@ -181,12 +272,26 @@ int avc_init(const char *prefix,
 	avc_log_lock = avc_alloc_lock();
 
 	memset(&cache_stats, 0, sizeof(cache_stats));
+	memset(&lookup_stats, 0, sizeof(lookup_stats));
 
-	for (i = 0; i < AVC_CACHE_SLOTS; i++)
-		avc_cache.slots[i] = 0;
+	avc_cache.slots = avc_malloc(sizeof(*avc_cache.slots) +
+				     AVC_CACHE_SLOTS * sizeof(struct avc_node *));
+	if (!avc_cache.slots) {
+		avc_log(SELINUX_ERROR,
+			"%s:  unable to allocate AV table\n",
+			avc_prefix);
+		rc = -1;
+		goto out;
+	}
+	memset(avc_cache.slots->slot, 0,
+	       AVC_CACHE_SLOTS * sizeof(struct avc_node *));
+	avc_cache.slots->mask = AVC_CACHE_SLOTS - 1;
+	avc_cache.slots->retired = NULL;
 	avc_cache.lru_hint = 0;
 	avc_cache.active_nodes = 0;
+	avc_cache.total_nodes = 0;
 	avc_cache.latest_notif = 0;
+	avc_new_generation();
 
 	rc = sidtab_init(&avc_sidtab);
 	if (rc) {
@@ -205,7 +310,8 @@ int avc_init(const char *prefix,
 		goto out;
 	}
 
-	for (i = 0; i < AVC_CACHE_MAXNODES; i++) {
+	/* any more are allocated as they are needed */
+	for (i = 0; i < AVC_CACHE_MAXNODES && i < (int)avc_max_nodes; i++) {
 		new = avc_malloc(sizeof(*new));
 		if (!new) {
 			avc_log(SELINUX_WARNING,
@@ -216,6 +322,7 @@ int avc_init(const char *prefix,
 		memset(new, 0, sizeof(*new));
 		new->next = avc_node_freelist;
 		avc_node_freelist = new;
+		avc_cache.total_nodes++;
 	}
 
 	if (!avc_setenforce) {
@@ -265,15 +372,16 @@ void avc_sid_stats(void)
 
 void avc_av_stats(void)
 {
-	int i, chain_len, max_chain_len, slots_used;
+	int i, chain_len, max_chain_len, slots_used, nslots;
 	struct avc_node *node;
 
 	avc_get_lock(avc_lock);
 
 	slots_used = 0;
 	max_chain_len = 0;
-	for (i = 0; i < AVC_CACHE_SLOTS; i++) {
-		node = avc_cache.slots[i];
+	nslots = avc_cache.slots->mask + 1;
+	for (i = 0; i < nslots; i++) {
+		node = avc_cache.slots->slot[i];
 		if (node) {
 			slots_used++;
 			chain_len = 0;
@@ -291,7 +399,13 @@ void avc_av_stats(void)
 	avc_log(SELINUX_INFO, "%s:  %u AV entries and %d/%d buckets used, "
 		"longest chain length %d\n", avc_prefix,
 		avc_cache.active_nodes,
-		slots_used, AVC_CACHE_SLOTS, max_chain_len);
+		slots_used, nslots, max_chain_len);
+	avc_log(SELINUX_INFO, "%s:  %u hits without avc_lock (%u on the "
+		"thread's last decision), %u lookups retried, %u took "
+		"avc_lock, %u table resizes\n", avc_prefix,
+		lookup_stats.unlocked_hits, lookup_stats.thread_hits,
+		lookup_stats.retries, lookup_stats.locked_lookups,
+		lookup_stats.resizes);
 }
 
 hidden_def(avc_av_stats)
@@ -306,17 +420,19 @@ static inline struct avc_node *avc_reclaim_node(void)
 	for (try = 0; try < 2; try++) {
 		do {
 			prev = NULL;
-			cur = avc_cache.slots[hvalue];
+			cur = avc_cache.slots->slot[hvalue];
 			while (cur) {
-				if (!cur->ae.used)
+				if (!__atomic_load_n(&cur->ae.used,
+						     __ATOMIC_RELAXED))
 					goto found;
 
-				cur->ae.used = 0;
+				__atomic_store_n(&cur->ae.used, 0,
+						 __ATOMIC_RELAXED);
 
 				prev = cur;
 				cur = cur->next;
 			}
-			hvalue = (hvalue + 1) & (AVC_CACHE_SLOTS - 1);
+			hvalue = (hvalue + 1) & avc_cache.slots->mask;
 		} while (hvalue != avc_cache.lru_hint);
 	}
 
@@ -327,7 +443,7 @@ static inline struct avc_node *avc_reclaim_node(void)
 	avc_cache.lru_hint = hvalue;
 
 	if (prev == NULL)
-		avc_cache.slots[hvalue] = cur->next;
+		avc_cache.slots->slot[hvalue] = cur->next;
 	else
 		prev->next = cur->next;
 
@@ -339,6 +455,37 @@ static inline void avc_clear_avc_entry(struct avc_entry *ae)
 	memset(ae, 0, sizeof(*ae));
 }
 
+/*
+ * Replace the hash table with one twice the size.  Called between
+ * avc_write_begin() and avc_write_end().
+ */
+static void avc_grow_slots(void)
+{
+	struct avc_slots *old = avc_cache.slots, *new;
+	struct avc_node *node, *next;
+	uint32_t i, hvalue, nslots = (old->mask + 1) * 2;
+
+	new = avc_malloc(sizeof(*new) + nslots * sizeof(struct avc_node *));
+	if (!new)
+		return;
+	memset(new->slot, 0, nslots * sizeof(struct avc_node *));
+	new->mask = nslots - 1;
+	for (i = 0; i <= old->mask; i++) {
+		for (node = old->slot[i]; node; node = next) {
+			next = node->next;
+			hvalue = avc_hash(node->ae.ssid, node->ae.tsid,
+					  node->ae.tclass, new->mask);
+			node->next = new->slot[hvalue];
+			new->slot[hvalue] = node;
+		}
+		old->slot[i] = NULL;
+	}
+	new->retired = old;
+	__atomic_store_n(&avc_cache.slots, new, __ATOMIC_RELEASE);
+	avc_cache.lru_hint &= new->mask;
+	avc_lookup_stats_incr(resizes);
+}
+
 static inline struct avc_node *avc_claim_node(security_id_t ssid,
 					      security_id_t tsid,
 					      security_class_t tclass)
@@ -349,6 +496,15 @@ static inline struct avc_node *avc_claim_node(security_id_t ssid,
 	if (!avc_node_freelist)
 		avc_cleanup();
 
+	if (!avc_node_freelist && avc_cache.total_nodes < avc_max_nodes) {
+		new = avc_malloc(sizeof(*new));
+		if (new) {
+			new->next = NULL;
+			avc_node_freelist = new;
+			avc_cache.total_nodes++;
+		}
+	}
+
 	if (avc_node_freelist) {
 		new = avc_node_freelist;
 		avc_node_freelist = avc_node_freelist->next;
@@ -359,14 +515,18 @@ static inline struct avc_node *avc_claim_node(security_id_t ssid,
 			goto out;
 	}
 
-	hvalue = avc_hash(ssid, tsid, tclass);
+	if (avc_cache.active_nodes > avc_cache.slots->mask + 1 &&
+	    avc_cache.slots->mask + 1 < AVC_CACHE_MAXSLOTS)
+		avc_grow_slots();
+
+	hvalue = avc_hash(ssid, tsid, tclass, avc_cache.slots->mask);
 	avc_clear_avc_entry(&new->ae);
-	new->ae.used = 1;
+	avc_mark_used(&new->ae);
 	new->ae.ssid = ssid;
 	new->ae.tsid = tsid;
 	new->ae.tclass = tclass;
-	new->next = avc_cache.slots[hvalue];
-	avc_cache.slots[hvalue] = new;
+	new->next = avc_cache.slots->slot[hvalue];
+	avc_cache.slots->slot[hvalue] = new;
 
       out:
 	return new;
@@ -377,16 +537,25 @@ static inline struct avc_node *avc_search_node(security_id_t ssid,
 					       security_class_t tclass,
 					       int *probes)
 {
+	struct avc_slots *slots;
 	struct avc_node *cur;
 	int hvalue;
-	int tprobes = 1;
+	uint32_t tprobes = 1;
 
-	hvalue = avc_hash(ssid, tsid, tclass);
-	cur = avc_cache.slots[hvalue];
+	slots = __atomic_load_n(&avc_cache.slots, __ATOMIC_ACQUIRE);
+	hvalue = avc_hash(ssid, tsid, tclass, slots->mask);
+	cur = slots->slot[hvalue];
 	while (cur != NULL &&
 	       (ssid != cur->ae.ssid ||
 		tclass != cur->ae.tclass || tsid != cur->ae.tsid)) {
-		tprobes++;
+		/*
+		 * Without avc_lock the nodes can be moved to another
+		 * chain under us; don't follow them round for ever.
+		 */
+		if (++tprobes > avc_cache.total_nodes + 1) {
+			cur = NULL;
+			break;
+		}
 		cur = cur->next;
 	}
 
@@ -399,7 +568,7 @@ static inline struct avc_node *avc_search_node(security_id_t ssid,
 	if (probes)
 		*probes = tprobes;
 
-	cur->ae.used = 1;
+	avc_mark_used(&cur->ae);
 
       out:
 	return cur;
@@ -478,13 +647,16 @@ static int avc_insert(security_id_t ssid, security_id_t tsid,
 		goto out;
 	}
 
+	avc_write_begin();
 	node = avc_claim_node(ssid, tsid, tclass);
 	if (!node) {
+		avc_write_end();
 		rc = -1;
 		goto out;
 	}
 
 	memcpy(&node->ae.avd, &ae->avd, sizeof(ae->avd));
+	avc_write_end();
 	aeref->ae = &node->ae;
       out:
 	return rc;
@@ -507,9 +679,10 @@ int avc_reset(void)
 		return 0;
 
 	avc_get_lock(avc_lock);
+	avc_write_begin();
 
-	for (i = 0; i < AVC_CACHE_SLOTS; i++) {
-		node = avc_cache.slots[i];
+	for (i = 0; i <= (int)avc_cache.slots->mask; i++) {
+		node = avc_cache.slots->slot[i];
 		while (node) {
 			tmp = node;
 			node = node->next;
@@ -518,13 +691,16 @@ int avc_reset(void)
 			avc_node_freelist = tmp;
 			avc_cache.active_nodes--;
 		}
-		avc_cache.slots[i] = 0;
+		avc_cache.slots->slot[i] = 0;
 	}
 	avc_cache.lru_hint = 0;
 
+	avc_write_end();
+	avc_new_generation();
 	avc_release_lock(avc_lock);
 
 	memset(&cache_stats, 0, sizeof(cache_stats));
+	memset(&lookup_stats, 0, sizeof(lookup_stats));
 
 	for (c = avc_callbacks; c; c = c->next) {
 		if (c->events & AVC_CALLBACK_RESET) {
@@ -545,6 +721,7 @@ void avc_destroy(void)
 {
 	struct avc_callback_node *c;
 	struct avc_node *node, *tmp;
+	struct avc_slots *slots;
 	int i;
 	/* avc_init needs to be called before this function */
 	assert(avc_running);
@@ -555,8 +732,8 @@ void avc_destroy(void)
 		avc_stop_thread(avc_netlink_thread);
 	avc_netlink_close();
 
-	for (i = 0; i < AVC_CACHE_SLOTS; i++) {
-		node = avc_cache.slots[i];
+	for (i = 0; i <= (int)avc_cache.slots->mask; i++) {
+		node = avc_cache.slots->slot[i];
 		while (node) {
 			tmp = node;
 			node = node->next;
@@ -568,6 +745,13 @@ void avc_destroy(void)
 		avc_node_freelist = tmp->next;
 		avc_free(tmp);
 	}
+	while (avc_cache.slots) {
+		slots = avc_cache.slots;
+		avc_cache.slots = slots->retired;
+		avc_free(slots);
+	}
+	avc_cache.total_nodes = 0;
+	avc_new_generation();
 	avc_release_lock(avc_lock);
 
 	while (avc_callbacks) {
@@ -731,6 +915,82 @@ void avc_audit(security_id_t ssid, security_id_t tsid,
 
 hidden_def(avc_audit)
 
+/*
+ * Copy the decision for the SID pair (@ssid, @tsid) and class @tclass
+ * into @avd without taking avc_lock, looking at @aeref's entry and then
+ * the hash table.  Return %0 if it covers @requested, or -%1 if it isn't
+ * cached or the cache kept changing, for the caller to take the lock.
+ */
+static int avc_lookup_unlocked(security_id_t ssid, security_id_t tsid,
+			       security_class_t tclass,
+			       access_vector_t requested,
+			       struct avc_entry_ref *aeref,
+			       struct av_decision *avd)
+{
+	struct avc_entry *ae;
+	struct avc_node *node;
+	int try, probes;
+	uint32_t seq;
+
+	for (try = 0; try < AVC_READ_RETRIES; try++) {
+		seq = __atomic_load_n(&avc_cache.seq, __ATOMIC_ACQUIRE);
+		if (seq & 1)
+			break;
+
+		node = NULL;
+		ae = aeref->ae;
+		if (ae && (ae->ssid != ssid || ae->tsid != tsid ||
+			   ae->tclass != tclass))
+			ae = NULL;
+		if (!ae) {
+			node = avc_search_node(ssid, tsid, tclass, &probes);
+			if (!node)
+				return -1;
+			ae = &node->ae;
+		}
+		memcpy(avd, &ae->avd, sizeof(*avd));
+
+		if (avc_read_retry(seq)) {
+			avc_lookup_stats_incr(retries);
+			continue;
+		}
+		if ((avd->decided & requested) != requested)
+			return -1;
+
+		avc_mark_used(ae);
+		if (node) {
+			if (aeref->ae)
+				avc_cache_stats_incr(entry_discards);
+			avc_cache_stats_incr(entry_misses);
+			avc_cache_stats_incr(cav_lookups);
+			avc_cache_stats_incr(cav_hits);
+			avc_cache_stats_add(cav_probes, probes);
+			aeref->ae = ae;
+		} else
+			avc_cache_stats_incr(entry_hits);
+		avc_lookup_stats_incr(unlocked_hits);
+		return 0;
+	}
+	return -1;
+}
+
+/* Stop a permissive denial from being audited again. */
+static void avc_grant_permissive(security_id_t ssid, security_id_t tsid,
+				 security_class_t tclass,
+				 access_vector_t perms)
+{
+	struct avc_node *node;
+
+	avc_get_lock(avc_lock);
+	node = avc_search_node(ssid, tsid, tclass, NULL);
+	if (node) {
+		avc_write_begin();
+		node->ae.avd.allowed |= perms;
+		avc_write_end();
+		avc_new_generation();
+	}
+	avc_release_lock(avc_lock);
+}
 
 static void avd_init(struct av_decision *avd)
 {
@@ -750,8 +1010,10 @@ int avc_has_perm_noaudit(security_id_t ssid,
 	struct avc_entry *ae;
 	int rc = 0;
 	struct avc_entry entry;
+	struct av_decision decision;
 	access_vector_t denied;
 	struct avc_entry_ref ref;
+	uint32_t generation;
 
 	if (avd)
 		avd_init(avd);
@@ -765,8 +1027,32 @@ int avc_has_perm_noaudit(security_id_t ssid,
 		aeref = &ref;
 	}
 
-	avc_get_lock(avc_lock);
+	generation = __atomic_load_n(&avc_cache.generation, __ATOMIC_ACQUIRE);
 	avc_cache_stats_incr(entry_lookups);
+
+	if (avc_thread_cache && avc_last.generation == generation &&
+	    avc_last.ssid == ssid && avc_last.tsid == tsid &&
+	    avc_last.tclass == tclass &&
+	    (avc_last.avd.decided & requested) == requested) {
+		avc_cache_stats_incr(entry_hits);
+		avc_lookup_stats_incr(thread_hits);
+		memcpy(&decision, &avc_last.avd, sizeof(decision));
+		/* the node may have been reclaimed for another entry since */
+		ae = avc_last.ae;
+		if (ae->ssid == ssid && ae->tsid == tsid &&
+		    ae->tclass == tclass)
+			avc_mark_used(ae);
+		goto decided;
+	}
+
+	if (avc_lookup_unlocked(ssid, tsid, tclass, requested, aeref,
+				&decision) == 0) {
+		ae = aeref->ae;
+		goto decided;
+	}
+
+	avc_get_lock(avc_lock);
+	avc_lookup_stats_incr(locked_lookups);
 	ae = aeref->ae;
 	if (ae) {
 		if (ae->ssid == ssid &&
@@ -774,7 +1060,7 @@ int avc_has_perm_noaudit(security_id_t ssid,
 		    ae->tclass == tclass &&
 		    ((ae->avd.decided & requested) == requested)) {
 			avc_cache_stats_incr(entry_hits);
-			ae->used = 1;
+			avc_mark_used(ae);
 		} else {
 			avc_cache_stats_incr(entry_discards);
 			ae = 0;
@@ -800,22 +1086,38 @@ int avc_has_perm_noaudit(security_id_t ssid,
 		}
 		ae = aeref->ae;
 	}
+	memcpy(&decision, &ae->avd, sizeof(decision));
+	avc_release_lock(avc_lock);
 
+      decided:
 	if (avd)
-		memcpy(avd, &ae->avd, sizeof(*avd));
+		memcpy(avd, &decision, sizeof(*avd));
 
-	denied = requested & ~(ae->avd.allowed);
+	denied = requested & ~(decision.allowed);
 
 	if (!requested || denied) {
 		if (!avc_enforcing ||
-		    (ae->avd.flags & SELINUX_AVD_FLAGS_PERMISSIVE))
-			ae->avd.allowed |= requested;
-		else {
+		    (decision.flags & SELINUX_AVD_FLAGS_PERMISSIVE)) {
+			if (denied)
+				avc_grant_permissive(ssid, tsid, tclass,
+						     requested);
+			decision.allowed |= requested;
+		} else {
 			errno = EACCES;
 			rc = -1;
 		}
 	}
 
+	if (avc_thread_cache) {
+		avc_last.ssid = ssid;
+		avc_last.tsid = tsid;
+		avc_last.tclass = tclass;
+		avc_last.generation = generation;
+		memcpy(&avc_last.avd, &decision, sizeof(decision));
+		avc_last.ae = ae;
+	}
+	return rc;
+
       out:
 	avc_release_lock(avc_lock);
 	return rc;
@@ -976,11 +1278,13 @@ static int avc_update_cache(uint32_t event, security_id_t ssid,
 	int i;
 
 	avc_get_lock(avc_lock);
+	avc_write_begin();
 
 	if (ssid == SECSID_WILD || tsid == SECSID_WILD) {
 		/* apply to all matching nodes */
-		for (i = 0; i < AVC_CACHE_SLOTS; i++) {
-			for (node = avc_cache.slots[i]; node; node = node->next) {
+		for (i = 0; i <= (int)avc_cache.slots->mask; i++) {
+			for (node = avc_cache.slots->slot[i]; node;
+			     node = node->next) {
 				if (avc_sidcmp(ssid, node->ae.ssid) &&
 				    avc_sidcmp(tsid, node->ae.tsid) &&
 				    tclass == node->ae.tclass) {
@@ -996,6 +1300,8 @@ static int avc_update_cache(uint32_t event, security_id_t ssid,
 		}
 	}
 
+	avc_write_end();
+	avc_new_generation();
 	avc_release_lock(avc_lock);
 
 	return 0;
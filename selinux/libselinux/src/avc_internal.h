@@ -133,15 +133,22 @@ static inline void avc_free_lock(void *lock)
 /* statistics helper routines */
 #ifdef AVC_CACHE_STATS
 
+/*
+ * Lookups that don't take avc_lock may lose an increment now and then;
+ * an atomic one for every lookup would cost more than the lock did.
+ */
 #define avc_cache_stats_incr(field) \
   cache_stats.field ++;
 #define avc_cache_stats_add(field, num) \
   cache_stats.field += num;
+#define avc_lookup_stats_incr(field) \
+  lookup_stats.field ++;
 
 #else
 
 #define avc_cache_stats_incr(field)
 #define avc_cache_stats_add(field, num)
+#define avc_lookup_stats_incr(field)
 
 #endif
 
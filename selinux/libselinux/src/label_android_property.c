@@ -4,48 +4,70 @@
  */
 
 #include <stdarg.h>
+#include <stdint.h>
 #include <string.h>
 #include <ctype.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
+#include <unistd.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include "callbacks.h"
 #include "label_internal.h"
 
+#define SELINUX_MAGIC_COMPILED_PROPERTY	0xf97cff8b
+#define SELINUX_COMPILED_PROPERTY_VERS	1
+
 /* A property security context specification. */
 typedef struct spec {
 	struct selabel_lookup_rec lr;	/* holds contexts for lookup result */
 	char *property_key;		/* property key string */
 } spec_t;
 
+/*
+ * A node of the prefix trie.  Node 0 is the root, for the empty prefix;
+ * the nodes are laid out breadth first, so the children of a node are
+ * consecutive, sorted by their character.  This is also the layout of
+ * the nodes in a compiled file, which are used where they are mapped.
+ */
+struct prop_node {
+	uint32_t first_child;
+	int32_t spec;		/* whose key ends here, or -1 */
+	uint16_t nchildren;
+	uint8_t c;		/* from the parent */
+	uint8_t unused;
+};
+
 /* Our stored configuration */
 struct saved_data {
-	/*
-	 * The array of specifications is sorted for longest
-	 * prefix match
-	 */
+	/* The array of specifications, sorted by property key. */
 	spec_t *spec_arr;
 	unsigned int nspec;	/* total number of specifications */
+
+	/*
+	 * The keys, less any that start with "*", in a trie; the longest
+	 * that is a prefix of a property is the one that labels it.
+	 */
+	struct prop_node *nodes;
+	uint32_t nnodes;
+	int wildcard;		/* the spec for "*", or -1 */
+
+	void *mmap_addr;	/* the compiled file the nodes are in, or NULL */
+	size_t mmap_len;
 };
 
 static int cmp(const void *A, const void *B)
 {
 	const struct spec *sp1 = A, *sp2 = B;
 
-	if (strncmp(sp1->property_key, "*", 1) == 0)
-		return 1;
-	if (strncmp(sp2->property_key, "*", 1) == 0)
-		return -1;
-
-	size_t L1 = strlen(sp1->property_key);
-	size_t L2 = strlen(sp2->property_key);
-
-	return (L1 < L2) - (L1 > L2);
+	return strcmp(sp1->property_key, sp2->property_key);
 }
 
 /*
- * Warn about duplicate specifications.
+ * Warn about duplicate specifications, which are next to each other
+ * in the sorted array.
  */
 static int nodups_specs(struct saved_data *data, const char *path)
 {
@@ -55,25 +77,24 @@ static int nodups_specs(struct saved_data *data, const char *path)
 
 	for (ii = 0; ii < data->nspec; ii++) {
 		curr_spec = &spec_arr[ii];
-		for (jj = ii + 1; jj < data->nspec; jj++) {
-			if (!strcmp(spec_arr[jj].property_key,
-					    curr_spec->property_key)) {
-				rc = -1;
-				errno = EINVAL;
-				if (strcmp(spec_arr[jj].lr.ctx_raw,
-						    curr_spec->lr.ctx_raw)) {
-					selinux_log
-						(SELINUX_ERROR,
-						 "%s: Multiple different specifications for %s  (%s and %s).\n",
-						 path, curr_spec->property_key,
-						 spec_arr[jj].lr.ctx_raw,
-						 curr_spec->lr.ctx_raw);
-				} else {
-					selinux_log
-						(SELINUX_ERROR,
-						 "%s: Multiple same specifications for %s.\n",
-						 path, curr_spec->property_key);
-				}
+		for (jj = ii + 1; jj < data->nspec &&
+		     !strcmp(spec_arr[jj].property_key,
+			     curr_spec->property_key); jj++) {
+			rc = -1;
+			errno = EINVAL;
+			if (strcmp(spec_arr[jj].lr.ctx_raw,
+					    curr_spec->lr.ctx_raw)) {
+				selinux_log
+					(SELINUX_ERROR,
+					 "%s: Multiple different specifications for %s  (%s and %s).\n",
+					 path, curr_spec->property_key,
+					 spec_arr[jj].lr.ctx_raw,
+					 curr_spec->lr.ctx_raw);
+			} else {
+				selinux_log
+					(SELINUX_ERROR,
+					 "%s: Multiple same specifications for %s.\n",
+					 path, curr_spec->property_key);
 			}
 		}
 	}
@@ -125,6 +146,252 @@ static int process_line(struct selabel_handle *rec,
 	return 0;
 }
 
+/*
+ * Build the trie from the sorted spec array.  Each node is a distinct
+ * prefix of a key, so there are at most as many as there are characters
+ * in the keys, plus the root.
+ */
+static int build_trie(struct saved_data *data)
+{
+	struct range {
+		uint32_t node, lo, hi, depth;
+	} *queue;
+	struct prop_node *nodes, *tmp;
+	uint32_t head, tail, n, i, j, k, depth;
+	size_t max = 1;
+	unsigned char c;
+
+	data->wildcard = -1;
+	for (i = 0; i < data->nspec; i++) {
+		if (data->spec_arr[i].property_key[0] == '*' &&
+		    data->wildcard < 0)
+			data->wildcard = i;
+		max += strlen(data->spec_arr[i].property_key);
+	}
+	if (max > UINT32_MAX)
+		return -1;
+
+	nodes = malloc(max * sizeof(*nodes));
+	queue = malloc(max * sizeof(*queue));
+	if (!nodes || !queue) {
+		free(nodes);
+		free(queue);
+		return -1;
+	}
+
+	memset(&nodes[0], 0, sizeof(nodes[0]));
+	nodes[0].spec = -1;
+	n = 1;
+	queue[0].node = 0;
+	queue[0].lo = 0;
+	queue[0].hi = data->nspec;
+	queue[0].depth = 0;
+	for (head = 0, tail = 1; head < tail; head++) {
+		/* The specs in lo..hi share the node's prefix of depth chars. */
+		i = queue[head].lo;
+		depth = queue[head].depth;
+		if (i < queue[head].hi &&
+		    data->spec_arr[i].property_key[depth] == '\0')
+			nodes[queue[head].node].spec = i++;
+
+		nodes[queue[head].node].first_child = n;
+		for (j = i; j < queue[head].hi; j = k) {
+			c = data->spec_arr[j].property_key[depth];
+			for (k = j + 1; k < queue[head].hi &&
+			     (unsigned char)data->spec_arr[k].property_key[depth] == c;
+			     k++)
+				;
+			if (depth == 0 && c == '*')
+				continue;
+			memset(&nodes[n], 0, sizeof(nodes[n]));
+			nodes[n].spec = -1;
+			nodes[n].c = c;
+			queue[tail].node = n;
+			queue[tail].lo = j;
+			queue[tail].hi = k;
+			queue[tail].depth = depth + 1;
+			tail++;
+			n++;
+			nodes[queue[head].node].nchildren++;
+		}
+	}
+	free(queue);
+
+	tmp = realloc(nodes, n * sizeof(*nodes));
+	data->nodes = tmp ? tmp : nodes;
+	data->nnodes = n;
+	return 0;
+}
+
+/*
+ * Compiled file format
+ *
+ * u32 - magic number
+ * u32 - version
+ * u32 - number of specs
+ * u32 - number of trie nodes
+ * s32 - the spec for "*", or -1
+ * ** Specs, sorted by property key
+ *	u32  - length of the property key INCLUDING nul
+ *	char - the property key
+ *	u32  - length of the context INCLUDING nul
+ *	char - the raw context
+ * ** Padding to a multiple of 4 bytes from the start of the file
+ * ** Trie nodes, as struct prop_node
+ */
+
+struct cursor {
+	char *p;
+	size_t left;
+};
+
+static void *next_entry(struct cursor *cur, size_t bytes)
+{
+	void *p = cur->p;
+
+	if (bytes > cur->left)
+		return NULL;
+	cur->p += bytes;
+	cur->left -= bytes;
+	return p;
+}
+
+static int next_u32(struct cursor *cur, uint32_t *val)
+{
+	void *p = next_entry(cur, sizeof(*val));
+
+	if (!p)
+		return -1;
+	memcpy(val, p, sizeof(*val));
+	return 0;
+}
+
+static char *next_string(struct cursor *cur)
+{
+	uint32_t len;
+	char *str;
+
+	if (next_u32(cur, &len) < 0 || len == 0)
+		return NULL;
+	str = next_entry(cur, len);
+	if (!str || str[len - 1] != '\0')
+		return NULL;
+	return strdup(str);
+}
+
+/*
+ * Use PATH if it is compiled, or else PATH.bin if it isn't older than
+ * PATH, whose stat is SB.  Return 1 if there is no compiled file.
+ */
+static int load_compiled(struct selabel_handle *rec, const char *path,
+			 const struct stat *sb)
+{
+	struct saved_data *data = (struct saved_data *)rec->data;
+	char bin_path[PATH_MAX + 1];
+	struct stat bin_sb = *sb;
+	struct cursor cur;
+	uint32_t magic, version, nspec, nnodes, wildcard, i;
+	struct prop_node *nodes;
+	size_t off;
+	void *addr;
+	int fd;
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return -1;
+	if (read(fd, &magic, sizeof(magic)) != sizeof(magic) ||
+	    magic != SELINUX_MAGIC_COMPILED_PROPERTY) {
+		close(fd);
+		if (snprintf(bin_path, sizeof(bin_path), "%s.bin", path) >=
+		    (int)sizeof(bin_path))
+			return 1;
+		fd = open(bin_path, O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+			return 1;
+		if (fstat(fd, &bin_sb) < 0 || bin_sb.st_mtime < sb->st_mtime) {
+			close(fd);
+			return 1;
+		}
+	}
+
+	if (bin_sb.st_size < 5 * (off_t)sizeof(uint32_t)) {
+		close(fd);
+		return 1;
+	}
+	addr = mmap(NULL, bin_sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED)
+		return -1;
+
+	cur.p = addr;
+	cur.left = bin_sb.st_size;
+	if (next_u32(&cur, &magic) < 0 ||
+	    magic != SELINUX_MAGIC_COMPILED_PROPERTY) {
+		munmap(addr, bin_sb.st_size);
+		return 1;
+	}
+	data->mmap_addr = addr;
+	data->mmap_len = bin_sb.st_size;
+
+	if (next_u32(&cur, &version) < 0 ||
+	    version > SELINUX_COMPILED_PROPERTY_VERS ||
+	    next_u32(&cur, &nspec) < 0 || next_u32(&cur, &nnodes) < 0 ||
+	    next_u32(&cur, &wildcard) < 0)
+		goto bad;
+	if (nspec == 0 || nspec > cur.left / (2 * sizeof(uint32_t)) ||
+	    nnodes == 0 || ((int32_t)wildcard >= 0 && wildcard >= nspec))
+		goto bad;
+
+	data->spec_arr = calloc(nspec, sizeof(spec_t));
+	if (!data->spec_arr)
+		return -1;
+	for (i = 0; i < nspec; i++) {
+		data->nspec = i;
+		data->spec_arr[i].property_key = next_string(&cur);
+		if (!data->spec_arr[i].property_key)
+			goto bad;
+		data->spec_arr[i].lr.ctx_raw = next_string(&cur);
+		if (!data->spec_arr[i].lr.ctx_raw) {
+			data->nspec++;
+			goto bad;
+		}
+		if (rec->validating &&
+		    selabel_validate(rec, &data->spec_arr[i].lr) < 0) {
+			selinux_log(SELINUX_ERROR,
+				    "%s:  spec %u has invalid context %s\n",
+				    path, i, data->spec_arr[i].lr.ctx_raw);
+			data->nspec++;
+			errno = EINVAL;
+			return -1;
+		}
+	}
+	data->nspec = nspec;
+	data->wildcard = wildcard;
+
+	off = (char *)cur.p - (char *)addr;
+	if (next_entry(&cur, (4 - off % 4) % 4) == NULL && off % 4)
+		goto bad;
+	if (nnodes > cur.left / sizeof(*nodes))
+		goto bad;
+	nodes = next_entry(&cur, nnodes * sizeof(*nodes));
+	for (i = 0; i < nnodes; i++)
+		if (nodes[i].first_child > nnodes ||
+		    nodes[i].nchildren > nnodes - nodes[i].first_child ||
+		    (nodes[i].spec >= 0 && (uint32_t)nodes[i].spec >= nspec))
+			goto bad;
+	data->nodes = nodes;
+	data->nnodes = nnodes;
+
+	return digest_add_specfile(rec->digest, NULL, addr, bin_sb.st_size,
+				   path);
+
+bad:
+	selinux_log(SELINUX_ERROR, "%s:  invalid compiled property contexts\n",
+		    path);
+	errno = EINVAL;
+	return -1;
+}
+
 static int init(struct selabel_handle *rec, const struct selinux_opt *opts,
 		unsigned n)
 {
@@ -157,6 +424,14 @@ static int init(struct selabel_handle *rec, const struct selinux_opt *opts,
 	if (!S_ISREG(sb.st_mode))
 		goto finish;
 
+	status = load_compiled(rec, path, &sb);
+	if (status <= 0) {
+		if (status == 0)
+			digest_gen_hash(rec->digest);
+		goto finish;
+	}
+	status = -1;
+
 	/*
 	 * Two passes of the specification file. First is to get the size.
 	 * After the first pass, the spec array is malloced to the appropriate
@@ -176,6 +451,8 @@ static int init(struct selabel_handle *rec, const struct selinux_opt *opts,
 		}
 
 		if (pass == 1) {
+			qsort(data->spec_arr, data->nspec, sizeof(struct spec),
+			      cmp);
 			status = nodups_specs(data, path);
 
 			if (status)
@@ -198,7 +475,9 @@ static int init(struct selabel_handle *rec, const struct selinux_opt *opts,
 		}
 	}
 
-	qsort(data->spec_arr, data->nspec, sizeof(struct spec), cmp);
+	status = build_trie(data);
+	if (status)
+		goto finish;
 
 	status = digest_add_specfile(rec->digest, fp, NULL, sb.st_size, path);
 	if (status)
@@ -230,6 +509,11 @@ static void closef(struct selabel_handle *rec)
 	if (data->spec_arr)
 		free(data->spec_arr);
 
+	if (data->mmap_addr)
+		munmap(data->mmap_addr, data->mmap_len);
+	else
+		free(data->nodes);
+
 	free(data);
 }
 
@@ -239,7 +523,10 @@ static struct selabel_lookup_rec *lookup(struct selabel_handle *rec,
 {
 	struct saved_data *data = (struct saved_data *)rec->data;
 	spec_t *spec_arr = data->spec_arr;
-	unsigned int i;
+	const struct prop_node *node;
+	uint32_t lo, hi, mid;
+	const char *p;
+	int i, best;
 	struct selabel_lookup_rec *ret = NULL;
 
 	if (!data->nspec) {
@@ -247,16 +534,31 @@ static struct selabel_lookup_rec *lookup(struct selabel_handle *rec,
 		goto finish;
 	}
 
-	for (i = 0; i < data->nspec; i++) {
-		if (strncmp(spec_arr[i].property_key, key,
-			    strlen(spec_arr[i].property_key)) == 0) {
+	/* Remember the last node with a spec on the way down. */
+	node = &data->nodes[0];
+	best = -1;
+	for (p = key; ; p++) {
+		if (node->spec >= 0)
+			best = node->spec;
+		if (*p == '\0')
 			break;
+		lo = node->first_child;
+		hi = lo + node->nchildren;
+		while (lo < hi) {
+			mid = lo + (hi - lo) / 2;
+			if (data->nodes[mid].c < (unsigned char)*p)
+				lo = mid + 1;
+			else
+				hi = mid;
 		}
-		if (strncmp(spec_arr[i].property_key, "*", 1) == 0)
+		if (lo == node->first_child + node->nchildren ||
+		    data->nodes[lo].c != (unsigned char)*p)
 			break;
+		node = &data->nodes[lo];
 	}
 
-	if (i >= data->nspec) {
+	i = best >= 0 ? best : data->wildcard;
+	if (i < 0) {
 		/* No matching specification. */
 		errno = ENOENT;
 		goto finish;
@@ -273,6 +575,64 @@ static void stats(struct selabel_handle __attribute__((unused)) *rec)
 	selinux_log(SELINUX_WARNING, "'stats' functionality not implemented.\n");
 }
 
+static int write_string(FILE *fp, const char *str)
+{
+	uint32_t len = strlen(str) + 1;
+
+	if (fwrite(&len, sizeof(len), 1, fp) != 1 ||
+	    fwrite(str, len, 1, fp) != 1)
+		return -1;
+	return 0;
+}
+
+/*
+ * Write the specs and trie of REC, a property handle, to FD in the
+ * compiled format.
+ */
+int selabel_property_write(struct selabel_handle *rec, int fd)
+{
+	struct saved_data *data = (struct saved_data *)rec->data;
+	static const char zeros[4];
+	uint32_t hdr[5];
+	unsigned int i;
+	long off;
+	FILE *fp;
+	int rc;
+
+	fp = fdopen(fd, "w");
+	if (!fp)
+		return -1;
+
+	hdr[0] = SELINUX_MAGIC_COMPILED_PROPERTY;
+	hdr[1] = SELINUX_COMPILED_PROPERTY_VERS;
+	hdr[2] = data->nspec;
+	hdr[3] = data->nnodes;
+	hdr[4] = data->wildcard;
+	if (fwrite(hdr, sizeof(hdr), 1, fp) != 1)
+		goto err;
+
+	for (i = 0; i < data->nspec; i++)
+		if (write_string(fp, data->spec_arr[i].property_key) < 0 ||
+		    write_string(fp, data->spec_arr[i].lr.ctx_raw) < 0)
+			goto err;
+
+	off = ftell(fp);
+	if (off < 0 || fwrite(zeros, 1, (4 - off % 4) % 4, fp) !=
+	    (size_t)((4 - off % 4) % 4))
+		goto err;
+	if (fwrite(data->nodes, sizeof(*data->nodes), data->nnodes, fp) !=
+	    data->nnodes)
+		goto err;
+
+	return fclose(fp);
+
+err:
+	rc = errno;
+	fclose(fp);
+	errno = rc;
+	return -1;
+}
+
 int selabel_property_init(struct selabel_handle *rec,
 			  const struct selinux_opt *opts,
 			  unsigned nopts)
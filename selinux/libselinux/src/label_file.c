@@ -97,6 +97,279 @@ static int nodups_specs(struct saved_data *data, const char *path)
 	return rc;
 }
 
+/*
+ * The prefix index.
+ *
+ * lookup_common() wants the last spec whose regex matches a file name.
+ * A regex can only match names that start with the literal text it
+ * starts with, so the specs are indexed in a trie by that text, and a
+ * lookup only runs the regexes of the specs on the name's path through
+ * the trie, highest first, rather than those of every spec.
+ */
+
+/* Check for a '|' outside any group: only the first alternative of the
+ * regex would then start with its literal prefix. */
+static int has_top_level_alternation(const char *c)
+{
+	int depth = 0;
+
+	for (; *c; c++) {
+		switch (*c) {
+		case '\\':
+			if (c[1])
+				c++;
+			break;
+		case '[':
+			c++;
+			if (*c == '^')
+				c++;
+			if (*c == ']')
+				c++;
+			while (*c && *c != ']') {
+				if (*c == '\\' && c[1])
+					c++;
+				c++;
+			}
+			if (!*c)
+				return 1;
+			break;
+		case '(':
+			depth++;
+			break;
+		case ')':
+			depth--;
+			break;
+		case '|':
+			if (depth == 0)
+				return 1;
+			break;
+		}
+	}
+	return 0;
+}
+
+/* Copy the literal text a regex starts with, unescaped, to buf, which
+ * must be as long as the regex, and return its length. */
+static size_t spec_literal_prefix(const char *regex, char *buf)
+{
+	const char *c;
+	size_t len = 0, last = 0;
+
+	if (has_top_level_alternation(regex))
+		return 0;
+
+	for (c = regex; *c; c++) {
+		switch (*c) {
+		case '?':
+		case '*':
+		case '{':
+			/* the character before is optional */
+			return last;
+		case '.':
+		case '^':
+		case '$':
+		case '+':
+		case '|':
+		case '[':
+		case '(':
+		case ')':
+			return len;
+		case '\\':
+			/* \d, \w and the like are not literal */
+			if (!c[1] || isalnum((unsigned char)c[1]))
+				return len;
+			c++;
+			break;
+		default:
+			break;
+		}
+		last = len;
+		buf[len++] = *c;
+	}
+	return len;
+}
+
+static int prefix_node_new(struct saved_data *data, char c)
+{
+	struct prefix_node *nodes;
+	unsigned int alloc;
+
+	if (data->num_prefix_nodes == data->alloc_prefix_nodes) {
+		alloc = data->alloc_prefix_nodes * 2 + 64;
+		nodes = realloc(data->prefix_nodes, alloc * sizeof(*nodes));
+		if (!nodes)
+			return -1;
+		data->prefix_nodes = nodes;
+		data->alloc_prefix_nodes = alloc;
+	}
+	memset(&data->prefix_nodes[data->num_prefix_nodes], 0,
+	       sizeof(*data->prefix_nodes));
+	data->prefix_nodes[data->num_prefix_nodes].c = c;
+	return data->num_prefix_nodes++;
+}
+
+/* Return the child of node n for c, adding it if add is set, or -1. */
+static int prefix_child(struct saved_data *data, unsigned int n, char c,
+			bool add)
+{
+	struct prefix_node *nodes = data->prefix_nodes;
+	unsigned int *children;
+	unsigned int lo = 0, hi = nodes[n].nchildren, mid;
+	int child;
+
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (nodes[nodes[n].children[mid]].c == c)
+			return nodes[n].children[mid];
+		if ((unsigned char)nodes[nodes[n].children[mid]].c <
+		    (unsigned char)c)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (!add)
+		return -1;
+
+	child = prefix_node_new(data, c);
+	if (child < 0)
+		return -1;
+	nodes = data->prefix_nodes;
+	children = realloc(nodes[n].children,
+			   (nodes[n].nchildren + 1) * sizeof(*children));
+	if (!children)
+		return -1;
+	memmove(&children[lo + 1], &children[lo],
+		(nodes[n].nchildren - lo) * sizeof(*children));
+	children[lo] = child;
+	nodes[n].children = children;
+	nodes[n].nchildren++;
+	return child;
+}
+
+/* The most nodes with specs on a path down from node n. */
+static unsigned int prefix_depth(struct saved_data *data, unsigned int n)
+{
+	struct prefix_node *node = &data->prefix_nodes[n];
+	unsigned int i, d, depth = 0;
+
+	for (i = 0; i < node->nchildren; i++) {
+		d = prefix_depth(data, node->children[i]);
+		if (d > depth)
+			depth = d;
+	}
+	return depth + (node->nspecs ? 1 : 0);
+}
+
+static void free_prefix_index(struct saved_data *data)
+{
+	unsigned int i;
+
+	for (i = 0; i < data->num_prefix_nodes; i++) {
+		free(data->prefix_nodes[i].children);
+		free(data->prefix_nodes[i].specs);
+	}
+	free(data->prefix_nodes);
+	data->prefix_nodes = NULL;
+	data->num_prefix_nodes = 0;
+	data->alloc_prefix_nodes = 0;
+	data->prefix_depth = 0;
+}
+
+/* Build the prefix index of the sorted specs.  If it can't be built,
+ * lookups go through all the specs, as they would without it. */
+static void build_prefix_index(struct saved_data *data)
+{
+	struct prefix_node *node;
+	unsigned int *specs;
+	char *prefix;
+	size_t len, max = 0, j;
+	unsigned int i;
+	int n;
+
+	for (i = 0; i < data->nspec; i++) {
+		len = strlen(data->spec_arr[i].regex_str);
+		if (len > max)
+			max = len;
+	}
+	prefix = malloc(max + 1);
+	if (!prefix)
+		return;
+
+	if (prefix_node_new(data, '\0') < 0)
+		goto err;
+
+	/* Add the specs highest first, so that each list stays in order. */
+	for (i = data->nspec; i-- > 0; ) {
+		len = spec_literal_prefix(data->spec_arr[i].regex_str, prefix);
+		n = 0;
+		for (j = 0; j < len && n >= 0; j++)
+			n = prefix_child(data, n, prefix[j], true);
+		if (n < 0)
+			goto err;
+		node = &data->prefix_nodes[n];
+		specs = realloc(node->specs,
+				(node->nspecs + 1) * sizeof(*specs));
+		if (!specs)
+			goto err;
+		specs[node->nspecs++] = i;
+		node->specs = specs;
+	}
+	data->prefix_depth = prefix_depth(data, 0);
+
+	free(prefix);
+	return;
+
+err:
+	free(prefix);
+	free_prefix_index(data);
+}
+
+/* The specs left to try from one node of the prefix index. */
+struct prefix_cursor {
+	const unsigned int *specs;
+	unsigned int nspecs;
+};
+
+/* Set up a cursor for each node with specs on the path of key through the
+ * prefix index, which is at most data->prefix_depth of them. */
+static unsigned int prefix_candidates(struct saved_data *data,
+				      const char *key,
+				      struct prefix_cursor *cur)
+{
+	struct prefix_node *nodes = data->prefix_nodes;
+	unsigned int ncur = 0;
+	int n = 0;
+
+	for (;;) {
+		if (nodes[n].nspecs) {
+			cur[ncur].specs = nodes[n].specs;
+			cur[ncur].nspecs = nodes[n].nspecs;
+			ncur++;
+		}
+		if (!*key)
+			break;
+		n = prefix_child(data, n, *key++, false);
+		if (n < 0)
+			break;
+	}
+	return ncur;
+}
+
+/* Return the highest spec left in the cursors and move past it, or -1. */
+static int prefix_next(struct prefix_cursor *cur, unsigned int ncur)
+{
+	unsigned int j, best = ncur;
+
+	for (j = 0; j < ncur; j++)
+		if (cur[j].nspecs && (best == ncur ||
+				      cur[j].specs[0] > cur[best].specs[0]))
+			best = j;
+	if (best == ncur)
+		return -1;
+	cur[best].nspecs--;
+	return *cur[best].specs++;
+}
+
 static int load_mmap(struct selabel_handle *rec, const char *path,
 				    struct stat *sb, bool isbinary,
 				    struct selabel_digest *digest)
@@ -507,6 +780,54 @@ out:
 	return rc;
 }
 
+/*
+ * A regex is JIT compiled once it has been run this many times, so that
+ * the cost is only paid for the specs that lookups keep coming back to;
+ * most specs in a file_contexts are tried a handful of times at most.
+ * The study data of a spec loaded from file_contexts.bin stays where it
+ * is mapped, and the JIT data is held beside it.
+ */
+#define JIT_THRESHOLD	64
+
+static void spec_jit(struct saved_data *data, struct spec *spec)
+{
+#ifdef PCRE_STUDY_JIT_COMPILE
+	const char *errbuf;
+	int options = PCRE_STUDY_JIT_COMPILE;
+
+	if (data->jit_supported < 0 &&
+	    pcre_config(PCRE_CONFIG_JIT, &data->jit_supported) != 0)
+		data->jit_supported = 0;
+	if (!data->jit_supported)
+		return;
+
+#ifdef PCRE_STUDY_JIT_PARTIAL_SOFT_COMPILE
+	/* For selabel_partial_match(). */
+	options |= PCRE_STUDY_JIT_PARTIAL_SOFT_COMPILE;
+#endif
+	spec->jit = pcre_study(spec->regex, options, &errbuf);
+	if (!spec->jit)
+		return;
+	if (!(spec->jit->flags & PCRE_EXTRA_EXECUTABLE_JIT)) {
+		pcre_free_study(spec->jit);
+		spec->jit = NULL;
+		return;
+	}
+	data->num_jit++;
+#else
+	(void)data;
+	(void)spec;
+#endif
+}
+
+static void spec_free_jit(struct spec *spec)
+{
+	if (spec->jit) {
+		pcre_free_study(spec->jit);
+		spec->jit = NULL;
+	}
+}
+
 static void closef(struct selabel_handle *rec);
 
 static int init(struct selabel_handle *rec, const struct selinux_opt *opts,
@@ -579,6 +900,10 @@ static int init(struct selabel_handle *rec, const struct selinux_opt *opts,
 	digest_gen_hash(rec->digest);
 
 	status = sort_specs(data);
+	if (status)
+		goto finish;
+
+	build_prefix_index(data);
 
 finish:
 	if (status)
@@ -602,6 +927,7 @@ static void closef(struct selabel_handle *rec)
 		spec = &data->spec_arr[i];
 		free(spec->lr.ctx_trans);
 		free(spec->lr.ctx_raw);
+		spec_free_jit(spec);
 		if (spec->from_mmap)
 			continue;
 		free(spec->regex_str);
@@ -624,6 +950,8 @@ static void closef(struct selabel_handle *rec)
 	if (data->stem_arr)
 		free(data->stem_arr);
 
+	free_prefix_index(data);
+
 	area = data->mmap_areas;
 	while (area) {
 		munmap(area->addr, area->len);
@@ -634,6 +962,53 @@ static void closef(struct selabel_handle *rec)
 	free(data);
 }
 
+/* Check whether a spec matches a file name, whose text after its stem is
+ * buf: returns 1 if it does, 0 if it doesn't and -1 on error. */
+static int spec_match(struct saved_data *data, struct spec *spec,
+		      const char *key, const char *buf, int file_stem,
+		      mode_t mode, int pcre_options, bool partial)
+{
+	int rc;
+
+	/* if the spec in question matches no stem or has the same
+	 * stem as the file AND if the spec in question has no mode
+	 * specified or if the mode matches the file mode then we do
+	 * a regex check        */
+	if ((spec->stem_id != -1 && spec->stem_id != file_stem) ||
+	    (mode && spec->mode && mode != spec->mode))
+		return 0;
+
+	if (compile_regex(data, spec, NULL) < 0)
+		return -1;
+	if (++spec->execs == JIT_THRESHOLD)
+		spec_jit(data, spec);
+	if (spec->stem_id == -1)
+		buf = key;
+	rc = pcre_exec(spec->regex, get_pcre_extra(spec),
+		       buf, strlen(buf), 0, pcre_options, NULL, 0);
+#ifdef PCRE_ERROR_JIT_STACKLIMIT
+	if (rc == PCRE_ERROR_JIT_STACKLIMIT) {
+		/* Too deep for the default JIT stack: interpret it. */
+		spec_free_jit(spec);
+		data->num_jit--;
+		rc = pcre_exec(spec->regex, get_pcre_extra(spec),
+			       buf, strlen(buf), 0, pcre_options, NULL, 0);
+	}
+#endif
+	if (rc == 0) {
+		spec->matches++;
+		return 1;
+	} else if (partial && rc == PCRE_ERROR_PARTIAL)
+		return 1;
+
+	if (rc == PCRE_ERROR_NOMATCH)
+		return 0;
+
+	/* else it's an error */
+	errno = ENOENT;
+	return -1;
+}
+
 static struct spec *lookup_common(struct selabel_handle *rec,
 					     const char *key,
 					     int type,
@@ -648,6 +1023,8 @@ static struct spec *lookup_common(struct selabel_handle *rec,
 	char *clean_key = NULL;
 	const char *prev_slash, *next_slash;
 	unsigned int sofar = 0;
+	struct prefix_cursor *cur = NULL;
+	unsigned int ncur;
 
 	if (!data->nspec) {
 		errno = ENOENT;
@@ -679,40 +1056,31 @@ static struct spec *lookup_common(struct selabel_handle *rec,
 
 	/*
 	 * Check for matching specifications in reverse order, so that
-	 * the last matching specification is used.
+	 * the last matching specification is used.  A partial match can
+	 * be on a spec whose literal prefix is longer than the key, so
+	 * those don't use the prefix index.
 	 */
-	for (i = data->nspec - 1; i >= 0; i--) {
-		struct spec *spec = &spec_arr[i];
-		/* if the spec in question matches no stem or has the same
-		 * stem as the file AND if the spec in question has no mode
-		 * specified or if the mode matches the file mode then we do
-		 * a regex check        */
-		if ((spec->stem_id == -1 || spec->stem_id == file_stem) &&
-		    (!mode || !spec->mode || mode == spec->mode)) {
-			if (compile_regex(data, spec, NULL) < 0)
+	if (data->prefix_nodes && !partial) {
+		cur = malloc(data->prefix_depth * sizeof(*cur));
+		if (!cur)
+			goto finish;
+		ncur = prefix_candidates(data, key, cur);
+		while ((i = prefix_next(cur, ncur)) >= 0) {
+			rc = spec_match(data, &spec_arr[i], key, buf,
+					file_stem, mode, pcre_options, partial);
+			if (rc < 0)
 				goto finish;
-			if (spec->stem_id == -1)
-				rc = pcre_exec(spec->regex,
-						    get_pcre_extra(spec),
-						    key, strlen(key), 0,
-						    pcre_options, NULL, 0);
-			else
-				rc = pcre_exec(spec->regex,
-						    get_pcre_extra(spec),
-						    buf, strlen(buf), 0,
-						    pcre_options, NULL, 0);
-			if (rc == 0) {
-				spec->matches++;
+			if (rc)
 				break;
-			} else if (partial && rc == PCRE_ERROR_PARTIAL)
+		}
+	} else {
+		for (i = data->nspec - 1; i >= 0; i--) {
+			rc = spec_match(data, &spec_arr[i], key, buf,
+					file_stem, mode, pcre_options, partial);
+			if (rc < 0)
+				goto finish;
+			if (rc)
 				break;
-
-			if (rc == PCRE_ERROR_NOMATCH)
-				continue;
-
-			errno = ENOENT;
-			/* else it's an error */
-			goto finish;
 		}
 	}
 
@@ -726,6 +1094,7 @@ static struct spec *lookup_common(struct selabel_handle *rec,
 	ret = &spec_arr[i];
 
 finish:
+	free(cur);
 	free(clean_key);
 	return ret;
 }
@@ -900,6 +1269,12 @@ static void stats(struct selabel_handle *rec)
 	unsigned int i, nspec = data->nspec;
 	struct spec *spec_arr = data->spec_arr;
 
+	if (data->num_jit) {
+		COMPAT_LOG(SELINUX_INFO,
+			   "%u of %u regexes run more than %u times were JIT compiled\n",
+			   data->num_jit, nspec, JIT_THRESHOLD - 1);
+	}
+
 	for (i = 0; i < nspec; i++) {
 		if (spec_arr[i].matches == 0) {
 			if (spec_arr[i].type_str) {
@@ -928,6 +1303,7 @@ int selabel_file_init(struct selabel_handle *rec,
 	if (!data)
 		return -1;
 	memset(data, 0, sizeof(*data));
+	data->jit_supported = -1;
 
 	rec->data = data;
 	rec->func_close = &closef;
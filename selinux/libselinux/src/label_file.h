@@ -31,8 +31,10 @@ struct spec {
 		pcre_extra *sd;	/* pointer to extra compiled stuff */
 		pcre_extra lsd;	/* used to hold the mmap'd version */
 	};
+	pcre_extra *jit;	/* JIT study data, once the regex is hot */
 	mode_t mode;		/* mode format value */
 	int matches;		/* number of matching pathnames */
+	unsigned int execs;	/* number of times regex has been run */
 	int stem_id;		/* indicates which stem-compression item */
 	char hasMetaChars;	/* regular expression has meta-chars */
 	char regcomp;		/* regex_str has been compiled to regex */
@@ -47,6 +49,19 @@ struct stem {
 	char from_mmap;
 };
 
+/*
+ * A node of the index of specs by the literal prefix of their regex:
+ * the node reached from the root by the characters of a prefix lists
+ * the specs with that prefix.
+ */
+struct prefix_node {
+	unsigned int *children;	/* node numbers, sorted by their c */
+	unsigned int nchildren;
+	unsigned int *specs;	/* spec numbers, highest first */
+	unsigned int nspecs;
+	char c;
+};
+
 /* Where we map the file in during selabel_open() */
 struct mmap_area {
 	void *addr;	/* Start addr + len used to release memory at close */
@@ -73,10 +88,24 @@ struct saved_data {
 	int num_stems;
 	int alloc_stems;
 	struct mmap_area *mmap_areas;
+
+	/*
+	 * The prefix index, built once all the specs are loaded and
+	 * sorted; node 0 is the root.  NULL if it couldn't be built.
+	 */
+	struct prefix_node *prefix_nodes;
+	unsigned int num_prefix_nodes;
+	unsigned int alloc_prefix_nodes;
+	unsigned int prefix_depth;	/* most nodes with specs on a path */
+
+	int jit_supported;	/* -1 until pcre_config() has been asked */
+	unsigned int num_jit;	/* specs with JIT study data */
 };
 
 static inline pcre_extra *get_pcre_extra(struct spec *spec)
 {
+	if (spec->jit)
+		return spec->jit;
 	if (spec->from_mmap)
 		return &spec->lsd;
 	else
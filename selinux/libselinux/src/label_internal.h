@@ -34,6 +34,7 @@ int selabel_db_init(struct selabel_handle *rec,
 int selabel_property_init(struct selabel_handle *rec,
 			    const struct selinux_opt *opts,
 			    unsigned nopts) hidden;
+int selabel_property_write(struct selabel_handle *rec, int fd) hidden;
 
 /*
  * Labeling internal structures
@@ -0,0 +1,175 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <getopt.h>
+#include <limits.h>
+#include <selinux/selinux.h>
+#include <selinux/label.h>
+#include <sepol/sepol.h>
+
+#include "../src/label_internal.h"
+
+const char *policy_file;
+
+static int validate_context(char **ctxp)
+{
+	if (policy_file && sepol_check_context(*ctxp) < 0)
+		return -1;
+
+	return 0;
+}
+
+static void usage(const char *progname)
+{
+	fprintf(stderr,
+	    "usage: %s [-o out_file] [-p policy_file] prop_file\n"
+	    "Where:\n\t"
+	    "-o         Optional file name of the binary file to be\n\t"
+	    "           output. If not specified the default will be\n\t"
+	    "           prop_file with the .bin suffix appended.\n\t"
+	    "-p         Optional binary policy file that will be used to\n\t"
+	    "           validate contexts defined in the prop_file.\n\t"
+	    "prop_file  The text based property contexts file to be\n\t"
+	    "           processed.\n",
+	    progname);
+		exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *path = NULL;
+	const char *out_file = NULL;
+	char stack_path[PATH_MAX + 1];
+	char *tmp = NULL;
+	int fd, rc, opt;
+	FILE *policy_fp = NULL;
+	struct stat buf;
+	struct selabel_handle *rec = NULL;
+	struct selinux_opt opts[1];
+
+	if (argc < 2)
+		usage(argv[0]);
+
+	while ((opt = getopt(argc, argv, "o:p:")) > 0) {
+		switch (opt) {
+		case 'o':
+			out_file = optarg;
+			break;
+		case 'p':
+			policy_file = optarg;
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+
+	if (optind >= argc)
+		usage(argv[0]);
+
+	path = argv[optind];
+	if (stat(path, &buf) < 0) {
+		fprintf(stderr, "Can not stat: %s: %m\n", path);
+		exit(EXIT_FAILURE);
+	}
+
+	/* Open binary policy if supplied. */
+	if (policy_file) {
+		policy_fp = fopen(policy_file, "r");
+
+		if (!policy_fp) {
+			fprintf(stderr, "Failed to open policy: %s\n",
+							    policy_file);
+			exit(EXIT_FAILURE);
+		}
+
+		if (sepol_set_policydb_from_file(policy_fp) < 0) {
+			fprintf(stderr, "Failed to load policy: %s\n",
+							    policy_file);
+			fclose(policy_fp);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	/*
+	 * Load the file through the property backend itself, so that the
+	 * trie written out is the one lookups would build.  Contexts are
+	 * only checked against the policy given with -p, as with
+	 * sefcontext_compile.
+	 */
+	rec = (struct selabel_handle *)calloc(1, sizeof(*rec));
+	if (!rec) {
+		fprintf(stderr, "Failed to calloc handle\n");
+		if (policy_fp)
+			fclose(policy_fp);
+		exit(EXIT_FAILURE);
+	}
+	rec->backend = SELABEL_CTX_ANDROID_PROP;
+	rec->validating = 1;
+	selinux_set_callback(SELINUX_CB_VALIDATE,
+			    (union selinux_callback)&validate_context);
+
+	opts[0].type = SELABEL_OPT_PATH;
+	opts[0].value = path;
+	rc = selabel_property_init(rec, opts, 1);
+	if (rc < 0) {
+		fprintf(stderr, "Failed to load %s: %m\n", path);
+		goto err;
+	}
+
+	if (out_file)
+		rc = snprintf(stack_path, sizeof(stack_path), "%s", out_file);
+	else
+		rc = snprintf(stack_path, sizeof(stack_path), "%s.bin", path);
+
+	if (rc < 0 || rc >= (int)sizeof(stack_path))
+		goto err;
+
+	tmp = malloc(strlen(stack_path) + 7);
+	if (!tmp)
+		goto err;
+
+	rc = sprintf(tmp, "%sXXXXXX", stack_path);
+	if (rc < 0)
+		goto err;
+
+	fd  = mkstemp(tmp);
+	if (fd < 0)
+		goto err;
+
+	rc = fchmod(fd, buf.st_mode);
+	if (rc < 0) {
+		perror("fchmod failed to set permission on compiled properties");
+		close(fd);
+		goto err_unlink;
+	}
+
+	/* This closes fd. */
+	rc = selabel_property_write(rec, fd);
+	if (rc < 0)
+		goto err_unlink;
+
+	rc = rename(tmp, stack_path);
+	if (rc < 0)
+		goto err_unlink;
+
+	rc = 0;
+out:
+	if (policy_fp)
+		fclose(policy_fp);
+
+	if (rec->data)
+		rec->func_close(rec);
+	free(rec);
+	free(tmp);
+	return rc;
+
+err_unlink:
+	unlink(tmp);
+err:
+	rc = -1;
+	goto out;
+}
@@ -75,6 +75,44 @@ static inline int ebitmap_node_get_bit(ebitmap_node_t * n, unsigned int bit)
 #define ebitmap_for_each_bit(e, n, bit) \
 	for (bit = ebitmap_start(e, &n); bit < ebitmap_length(e); bit = ebitmap_next(&n, bit)) \
 
+/* The first set bit at or after node *n, or ebitmap_length(e). */
+static inline unsigned int ebitmap_first_positive(const ebitmap_t * e,
+						  ebitmap_node_t ** n)
+{
+	while (*n && !(*n)->map)
+		*n = (*n)->next;
+	if (!*n)
+		return ebitmap_length(e);
+	return (*n)->startbit + __builtin_ctzll((*n)->map);
+}
+
+static inline unsigned int ebitmap_start_positive(const ebitmap_t * e,
+						  ebitmap_node_t ** n)
+{
+	*n = e->node;
+	return ebitmap_first_positive(e, n);
+}
+
+static inline unsigned int ebitmap_next_positive(const ebitmap_t * e,
+						 ebitmap_node_t ** n,
+						 unsigned int bit)
+{
+	unsigned int off = bit - (*n)->startbit + 1;
+	MAPTYPE map = off < MAPSIZE ? (*n)->map & (~(MAPTYPE)0 << off) : 0;
+
+	if (map)
+		return (*n)->startbit + __builtin_ctzll(map);
+	*n = (*n)->next;
+	return ebitmap_first_positive(e, n);
+}
+
+/*
+ * Like ebitmap_for_each_bit(), but only for the bits that are set, going
+ * a word at a time past the ones that are not.
+ */
+#define ebitmap_for_each_positive_bit(e, n, bit) \
+	for (bit = ebitmap_start_positive(e, &n); bit < ebitmap_length(e); bit = ebitmap_next_positive(e, &n, bit)) \
+
 extern int ebitmap_cmp(const ebitmap_t * e1, const ebitmap_t * e2);
 extern int ebitmap_or(ebitmap_t * dst, const ebitmap_t * e1, const ebitmap_t * e2);
 extern int ebitmap_union(ebitmap_t * dst, const ebitmap_t * e1);
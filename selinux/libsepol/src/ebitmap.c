@@ -71,15 +71,54 @@ int ebitmap_union(ebitmap_t * dst, const ebitmap_t * e1)
 	return 0;
 }
 
+/*
+ * Append a node for MAP at STARTBIT to DST, whose last node is *PREV,
+ * unless MAP is empty.  The word-at-a-time operations below build their
+ * result this way, in order, instead of setting one bit at a time.
+ */
+static int ebitmap_append(ebitmap_t * dst, ebitmap_node_t ** prev,
+			  uint32_t startbit, MAPTYPE map)
+{
+	ebitmap_node_t *new;
+
+	if (!map)
+		return 0;
+
+	new = (ebitmap_node_t *) malloc(sizeof(ebitmap_node_t));
+	if (!new) {
+		ebitmap_destroy(dst);
+		return -ENOMEM;
+	}
+	new->startbit = startbit;
+	new->map = map;
+	new->next = 0;
+	if (*prev)
+		(*prev)->next = new;
+	else
+		dst->node = new;
+	*prev = new;
+	dst->highbit = startbit + MAPSIZE;
+	return 0;
+}
+
 int ebitmap_and(ebitmap_t *dst, ebitmap_t *e1, ebitmap_t *e2)
 {
-	unsigned int i, length = min(ebitmap_length(e1), ebitmap_length(e2));
+	ebitmap_node_t *n1 = e1->node, *n2 = e2->node, *prev = 0;
+	int rc;
+
 	ebitmap_init(dst);
-	for (i=0; i < length; i++) {
-		if (ebitmap_get_bit(e1, i) && ebitmap_get_bit(e2, i)) {
-			int rc = ebitmap_set_bit(dst, i, 1);
+	while (n1 && n2) {
+		if (n1->startbit < n2->startbit) {
+			n1 = n1->next;
+		} else if (n2->startbit < n1->startbit) {
+			n2 = n2->next;
+		} else {
+			rc = ebitmap_append(dst, &prev, n1->startbit,
+					    n1->map & n2->map);
 			if (rc < 0)
 				return rc;
+			n1 = n1->next;
+			n2 = n2->next;
 		}
 	}
 	return 0;
@@ -87,50 +126,87 @@ int ebitmap_and(ebitmap_t *dst, ebitmap_t *e1, ebitmap_t *e2)
 
 int ebitmap_xor(ebitmap_t *dst, ebitmap_t *e1, ebitmap_t *e2)
 {
-	unsigned int i, length = max(ebitmap_length(e1), ebitmap_length(e2));
+	ebitmap_node_t *n1 = e1->node, *n2 = e2->node, *prev = 0;
+	int rc;
+
 	ebitmap_init(dst);
-	for (i=0; i < length; i++) {
-		int val = ebitmap_get_bit(e1, i) ^ ebitmap_get_bit(e2, i);
-		int rc = ebitmap_set_bit(dst, i, val);
+	while (n1 || n2) {
+		if (n1 && n2 && n1->startbit == n2->startbit) {
+			rc = ebitmap_append(dst, &prev, n1->startbit,
+					    n1->map ^ n2->map);
+			n1 = n1->next;
+			n2 = n2->next;
+		} else if (!n2 || (n1 && n1->startbit < n2->startbit)) {
+			rc = ebitmap_append(dst, &prev, n1->startbit, n1->map);
+			n1 = n1->next;
+		} else {
+			rc = ebitmap_append(dst, &prev, n2->startbit, n2->map);
+			n2 = n2->next;
+		}
 		if (rc < 0)
 			return rc;
 	}
 	return 0;
 }
 
+/* The bits of the node at STARTBIT below MAXBIT. */
+static inline MAPTYPE ebitmap_maxbit_mask(uint32_t startbit,
+					  unsigned int maxbit)
+{
+	if (maxbit - startbit >= MAPSIZE)
+		return ~(MAPTYPE)0;
+	return (MAPBIT << (maxbit - startbit)) - 1;
+}
+
 int ebitmap_not(ebitmap_t *dst, ebitmap_t *e1, unsigned int maxbit)
 {
-	unsigned int i;
+	ebitmap_node_t *n = e1->node, *prev = 0;
+	MAPTYPE map;
+	uint32_t startbit;
+	int rc;
+
 	ebitmap_init(dst);
-	for (i=0; i < maxbit; i++) {
-		int val = ebitmap_get_bit(e1, i);
-		int rc = ebitmap_set_bit(dst, i, !val);
+	for (startbit = 0; startbit < maxbit; startbit += MAPSIZE) {
+		while (n && n->startbit < startbit)
+			n = n->next;
+		map = (n && n->startbit == startbit) ? ~n->map : ~(MAPTYPE)0;
+		rc = ebitmap_append(dst, &prev, startbit,
+				    map & ebitmap_maxbit_mask(startbit, maxbit));
 		if (rc < 0)
 			return rc;
+		if (startbit + MAPSIZE < startbit)
+			break;
 	}
 	return 0;
 }
 
 int ebitmap_andnot(ebitmap_t *dst, ebitmap_t *e1, ebitmap_t *e2, unsigned int maxbit)
 {
-	ebitmap_t e3;
+	ebitmap_node_t *n1 = e1->node, *n2 = e2->node, *prev = 0;
+	MAPTYPE map;
+	int rc;
+
 	ebitmap_init(dst);
-	int rc = ebitmap_not(&e3, e2, maxbit);
-	if (rc < 0)
-		return rc;
-	rc = ebitmap_and(dst, e1, &e3);
-	ebitmap_destroy(&e3);
-	if (rc < 0)
-		return rc;
+	for (; n1 && n1->startbit < maxbit; n1 = n1->next) {
+		while (n2 && n2->startbit < n1->startbit)
+			n2 = n2->next;
+		map = n1->map & ebitmap_maxbit_mask(n1->startbit, maxbit);
+		if (n2 && n2->startbit == n1->startbit)
+			map &= ~n2->map;
+		rc = ebitmap_append(dst, &prev, n1->startbit, map);
+		if (rc < 0)
+			return rc;
+	}
 	return 0;
 }
 
 unsigned int ebitmap_cardinality(ebitmap_t *e1)
 {
-	unsigned int i, count = 0;
-	for (i=ebitmap_startbit(e1); i < ebitmap_length(e1); i++)
-		if (ebitmap_get_bit(e1, i))
-			count++;
+	ebitmap_node_t *n;
+	unsigned int count = 0;
+
+	for (n = e1->node; n; n = n->next)
+		count += __builtin_popcountll(n->map);
 	return count;
 }
 
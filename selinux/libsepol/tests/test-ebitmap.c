@@ -0,0 +1,166 @@
+/*
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * The word-at-a-time ebitmap operations, checked bit by bit against
+ * ebitmap_get_bit() on random bitmaps.
+ */
+
+#include "test-ebitmap.h"
+
+#include <sepol/policydb/ebitmap.h>
+
+#include <stdlib.h>
+
+#define NBITS	1000
+#define ROUNDS	200
+
+int ebitmap_test_init(void)
+{
+	srandom(1);
+	return 0;
+}
+
+int ebitmap_test_cleanup(void)
+{
+	return 0;
+}
+
+/* Sparse, dense and empty stretches, so that some nodes are missing. */
+static void random_ebitmap(ebitmap_t * e)
+{
+	unsigned int i, density = 0;
+
+	ebitmap_init(e);
+	for (i = 0; i < NBITS; i++) {
+		if (i % 128 == 0)
+			density = random() % 4;
+		if (density && random() % (1 << density) == 0)
+			CU_ASSERT_FATAL(ebitmap_set_bit(e, i, 1) == 0);
+	}
+}
+
+/* The bitmap is well formed: no empty nodes, and highbit is the last one. */
+static void check_ebitmap(const ebitmap_t * e)
+{
+	ebitmap_node_t *n;
+	uint32_t highbit = 0;
+
+	for (n = e->node; n; n = n->next) {
+		CU_ASSERT(n->map != 0);
+		CU_ASSERT(n->startbit % MAPSIZE == 0);
+		if (n->next)
+			CU_ASSERT(n->startbit < n->next->startbit);
+		highbit = n->startbit + MAPSIZE;
+	}
+	CU_ASSERT(e->highbit == highbit);
+}
+
+static void test_ebitmap_ops(void)
+{
+	ebitmap_t e1, e2, dst;
+	unsigned int i, maxbit, count;
+	int round;
+
+	for (round = 0; round < ROUNDS; round++) {
+		random_ebitmap(&e1);
+		random_ebitmap(&e2);
+		maxbit = random() % (NBITS + 64);
+
+		CU_ASSERT_FATAL(ebitmap_and(&dst, &e1, &e2) == 0);
+		check_ebitmap(&dst);
+		for (i = 0; i < NBITS + 64; i++)
+			CU_ASSERT(ebitmap_get_bit(&dst, i) ==
+				  (ebitmap_get_bit(&e1, i) &&
+				   ebitmap_get_bit(&e2, i)));
+		ebitmap_destroy(&dst);
+
+		CU_ASSERT_FATAL(ebitmap_xor(&dst, &e1, &e2) == 0);
+		check_ebitmap(&dst);
+		for (i = 0; i < NBITS + 64; i++)
+			CU_ASSERT(ebitmap_get_bit(&dst, i) ==
+				  (ebitmap_get_bit(&e1, i) ^
+				   ebitmap_get_bit(&e2, i)));
+		ebitmap_destroy(&dst);
+
+		CU_ASSERT_FATAL(ebitmap_not(&dst, &e1, maxbit) == 0);
+		check_ebitmap(&dst);
+		for (i = 0; i < NBITS + 64; i++)
+			CU_ASSERT(ebitmap_get_bit(&dst, i) ==
+				  (i < maxbit && !ebitmap_get_bit(&e1, i)));
+		ebitmap_destroy(&dst);
+
+		CU_ASSERT_FATAL(ebitmap_andnot(&dst, &e1, &e2, maxbit) == 0);
+		check_ebitmap(&dst);
+		for (i = 0; i < NBITS + 64; i++)
+			CU_ASSERT(ebitmap_get_bit(&dst, i) ==
+				  (i < maxbit && ebitmap_get_bit(&e1, i) &&
+				   !ebitmap_get_bit(&e2, i)));
+		ebitmap_destroy(&dst);
+
+		for (count = 0, i = 0; i < NBITS; i++)
+			count += ebitmap_get_bit(&e1, i);
+		CU_ASSERT(ebitmap_cardinality(&e1) == count);
+
+		ebitmap_destroy(&e1);
+		ebitmap_destroy(&e2);
+	}
+}
+
+static void test_ebitmap_for_each_positive_bit(void)
+{
+	ebitmap_t e;
+	ebitmap_node_t *n, *pn;
+	unsigned int i, bit;
+	int round;
+
+	for (round = 0; round < ROUNDS; round++) {
+		random_ebitmap(&e);
+		bit = ebitmap_start_positive(&e, &pn);
+		ebitmap_for_each_bit(&e, n, i) {
+			if (!ebitmap_node_get_bit(n, i))
+				continue;
+			CU_ASSERT(bit == i);
+			bit = ebitmap_next_positive(&e, &pn, bit);
+		}
+		CU_ASSERT(bit == ebitmap_length(&e));
+
+		i = 0;
+		ebitmap_for_each_positive_bit(&e, n, bit) {
+			CU_ASSERT(ebitmap_get_bit(&e, bit));
+			i++;
+		}
+		CU_ASSERT(i == ebitmap_cardinality(&e));
+		ebitmap_destroy(&e);
+	}
+
+	/* An empty bitmap has none. */
+	ebitmap_init(&e);
+	ebitmap_for_each_positive_bit(&e, n, bit)
+		CU_FAIL("bit set in an empty ebitmap");
+}
+
+int ebitmap_add_tests(CU_pSuite suite)
+{
+	if (NULL == CU_add_test(suite, "ebitmap_ops", test_ebitmap_ops)) {
+		return CU_get_error();
+	}
+	if (NULL == CU_add_test(suite, "ebitmap_for_each_positive_bit",
+				test_ebitmap_for_each_positive_bit)) {
+		return CU_get_error();
+	}
+	return 0;
+}
@@ -1,11 +1,32 @@
 #include "restore.h"
 #include <glob.h>
+#include <pthread.h>
+#include <time.h>
+#include <inttypes.h>
+#include <sys/xattr.h>
 #include <selinux/context.h>
 
 #define SKIP -2
 #define ERR -1
 #define MAX_EXCLUDES 1000
 
+/*
+ * With -D, a directory tree relabeled without errors is marked with the
+ * digest of the file contexts it was labeled from, and skipped while the
+ * digest is the same.
+ */
+#define DIGEST_XATTR "security.sehash"
+
+/*
+ * With more than one thread, the walk stays on the main thread and hands
+ * the files it finds to the workers BATCH_SIZE at a time; it waits when
+ * MAX_BATCHES are queued.  selabel_lookup() isn't thread safe, so the
+ * lookups take lookup_lock; the rest of the work on a file, getting and
+ * setting its context, runs in parallel.
+ */
+#define BATCH_SIZE 64
+#define MAX_BATCHES 64
+
 /*
  * The hash table of associations, hashed by inode number.
  * Chaining is used for collisions, with elements ordered
@@ -31,6 +52,28 @@ struct edir {
 	size_t size;
 };
 
+/* Seconds spent in each phase, summed over the threads, for -t. */
+struct restore_stats {
+	double walk;
+	double lookup;
+	double getcon;
+	double setcon;
+	uint64_t files;
+	uint64_t trees_skipped;
+};
+
+struct work {
+	char *path;
+	struct stat sb;
+	int recurse;
+};
+
+struct batch {
+	int n;
+	struct work work[BATCH_SIZE];
+	struct batch *next;
+};
+
 
 static file_spec_t *fl_head;
 static int filespec_add(ino_t ino, const security_context_t con, const char *file);
@@ -40,6 +83,45 @@ static void filespec_eval(void);
 static int excludeCtr = 0;
 static struct edir excludeArray[MAX_EXCLUDES];
 
+static struct restore_stats stats;	/* the main thread's, then the total */
+static double start_time;
+static unsigned char *digest;
+static size_t digest_len;
+static int walk_errors;
+
+static pthread_mutex_t lookup_lock = PTHREAD_MUTEX_INITIALIZER;
+/* for r_opts->count, the associations, walk_errors and the output */
+static pthread_mutex_t output_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queued_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t taken_cond = PTHREAD_COND_INITIALIZER;
+static struct batch *queue_head, **queue_tail = &queue_head;
+static struct batch *filling;
+static int queued, walk_done;
+static int abort_walk;	/* a worker hit an error that ends the walk; atomic */
+static pthread_t *workers;
+static struct restore_stats *worker_stats;
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static inline double phase_start(void)
+{
+	return r_opts->timing ? now() : 0;
+}
+
+static inline void phase_end(double *total, double start)
+{
+	if (r_opts->timing)
+		*total += now() - start;
+}
+
 void remove_exclude(const char *directory)
 {
 	int i = 0;
@@ -60,13 +142,41 @@ void restore_init(struct restore_opts *opts)
 	r_opts = opts;
 	struct selinux_opt selinux_opts[] = {
 		{ SELABEL_OPT_VALIDATE, r_opts->selabel_opt_validate },
-		{ SELABEL_OPT_PATH, r_opts->selabel_opt_path }
+		{ SELABEL_OPT_PATH, r_opts->selabel_opt_path },
+		{ SELABEL_OPT_DIGEST, r_opts->digest ? (char *)1 : NULL }
 	};
-	r_opts->hnd = selabel_open(SELABEL_CTX_FILE, selinux_opts, 2);
+	unsigned char *d;
+	char **specfiles;
+	size_t nspecfiles;
+
+	start_time = now();
+	r_opts->hnd = selabel_open(SELABEL_CTX_FILE, selinux_opts, 3);
 	if (!r_opts->hnd) {
 		perror(r_opts->selabel_opt_path);
 		exit(1);
 	}	
+
+	if (r_opts->digest) {
+		if (selabel_digest(r_opts->hnd, &d, &digest_len, &specfiles,
+				   &nspecfiles) < 0 || digest_len == 0) {
+			fprintf(stderr, "%s:  can't get the file contexts digest: %s\n",
+				r_opts->progname, strerror(errno));
+			exit(1);
+		}
+		digest = malloc(digest_len);
+		if (!digest) {
+			fprintf(stderr, "%s:  Out of memory!\n", r_opts->progname);
+			exit(1);
+		}
+		memcpy(digest, d, digest_len);
+	}
+
+	if (r_opts->nthreads > 1) {
+		/* The workers need the whole path. */
+		r_opts->fts_flags |= FTS_NOCHDIR;
+		/* Load the customizable types before the workers race to. */
+		(void)is_context_customizable("");
+	}
 }
 
 void restore_finish()
@@ -75,10 +185,31 @@ void restore_finish()
 	for (i = 0; i < excludeCtr; i++) {
 		free(excludeArray[i].directory);
 	}
+	free(digest);
+
+	if (r_opts->timing) {
+		fprintf(stderr,
+			"%s:  %" PRIu64 " files in %.2f s on %d thread%s; walk %.2f s, "
+			"lookup %.2f s, getfilecon %.2f s, setfilecon %.2f s "
+			"(summed over threads)",
+			r_opts->progname, stats.files, now() - start_time,
+			r_opts->nthreads > 1 ? r_opts->nthreads : 1,
+			r_opts->nthreads > 1 ? "s" : "", stats.walk,
+			stats.lookup, stats.getcon, stats.setcon);
+		if (r_opts->digest)
+			fprintf(stderr, ", %" PRIu64 " tree%s skipped by digest",
+				stats.trees_skipped,
+				stats.trees_skipped == 1 ? "" : "s");
+		fprintf(stderr, "\n");
+	}
 }
 
-static int match(const char *name, struct stat *sb, char **con)
+static int match(const char *name, struct stat *sb, char **con,
+		 struct restore_stats *st)
 {
+	double t;
+	int ret;
+
 	if (!(r_opts->hard_links) && !S_ISDIR(sb->st_mode) && (sb->st_nlink > 1)) {
 		fprintf(stderr, "Warning! %s refers to a file with more than one hard link, not fixing hard links.\n",
 					name);
@@ -94,27 +225,52 @@ static int match(const char *name, struct stat *sb, char **con)
 		name += r_opts->rootpathlen;
 	}
 
+	t = phase_start();
+	pthread_mutex_lock(&lookup_lock);
 	if (r_opts->rootpath != NULL && name[0] == '\0')
 		/* this is actually the root dir of the alt root */
-		return selabel_lookup_raw(r_opts->hnd, con, "/", sb->st_mode);
+		ret = selabel_lookup_raw(r_opts->hnd, con, "/", sb->st_mode);
 	else
-		return selabel_lookup_raw(r_opts->hnd, con, name, sb->st_mode);
+		ret = selabel_lookup_raw(r_opts->hnd, con, name, sb->st_mode);
+	pthread_mutex_unlock(&lookup_lock);
+	phase_end(&st->lookup, t);
+	return ret;
 }
-static int restore(FTSENT *ftsent, int recurse)
+
+static void count_error(void)
 {
-	char *my_file = strdupa(ftsent->fts_path);
+	pthread_mutex_lock(&output_lock);
+	walk_errors++;
+	pthread_mutex_unlock(&output_lock);
+}
+
+/*
+ * Relabel PATH, whose stat is SB, through ACCPATH, which is the same
+ * or relative to the current directory.
+ */
+static int restore(const char *path, const char *accpath, struct stat *sb,
+		   int recurse, struct restore_stats *st)
+{
+	char *my_file = strdupa(path);
 	int ret = -1;
 	security_context_t curcon = NULL, newcon = NULL;
 	float progress;
-	if (match(my_file, ftsent->fts_statp, &newcon) < 0) {
+	double t;
+
+	st->files++;
+	if (match(my_file, sb, &newcon, st) < 0) {
 		if ((errno == ENOENT) && ((!recurse) || (r_opts->verbose)))
 			fprintf(stderr, "%s:  Warning no default label for %s\n", r_opts->progname, my_file);
 
 		/* Check for no matching specification. */
-		return (errno == ENOENT) ? 0 : -1;
+		if (errno == ENOENT)
+			return 0;
+		count_error();
+		return -1;
 	}
 
 	if (r_opts->progress) {
+		pthread_mutex_lock(&output_lock);
 		r_opts->count++;
 		if (r_opts->count % STAR_COUNT == 0) {
 			if (r_opts->progress == 1) {
@@ -127,6 +283,7 @@ static int restore(FTSENT *ftsent, int recurse)
 			}
 			fflush(stdout);
 		}
+		pthread_mutex_unlock(&output_lock);
 	}
 
 	/*
@@ -136,7 +293,9 @@ static int restore(FTSENT *ftsent, int recurse)
 	 * then use the last matching specification.
 	 */
 	if (r_opts->add_assoc) {
-		ret = filespec_add(ftsent->fts_statp->st_ino, newcon, my_file);
+		pthread_mutex_lock(&output_lock);
+		ret = filespec_add(sb->st_ino, newcon, my_file);
+		pthread_mutex_unlock(&output_lock);
 		if (ret < 0)
 			goto err;
 
@@ -158,7 +317,9 @@ static int restore(FTSENT *ftsent, int recurse)
 	}
 
 	/* Get the current context of the file. */
-	ret = lgetfilecon_raw(ftsent->fts_accpath, &curcon);
+	t = phase_start();
+	ret = lgetfilecon_raw(accpath, &curcon);
+	phase_end(&st->getcon, t);
 	if (ret < 0) {
 		if (errno == ENODATA) {
 			curcon = NULL;
@@ -227,6 +388,7 @@ static int restore(FTSENT *ftsent, int recurse)
 		}
 	}
 
+	pthread_mutex_lock(&output_lock);
 	if (r_opts->verbose) {
 		printf("%s reset %s context %s->%s\n",
 		       r_opts->progname, my_file, curcon ?: "", newcon);
@@ -243,6 +405,7 @@ static int restore(FTSENT *ftsent, int recurse)
 
 	if (r_opts->outfile)
 		fprintf(r_opts->outfile, "%s\n", my_file);
+	pthread_mutex_unlock(&output_lock);
 
 	/*
 	 * Do not relabel the file if -n was used.
@@ -253,7 +416,9 @@ static int restore(FTSENT *ftsent, int recurse)
 	/*
 	 * Relabel the file to the specified context.
 	 */
-	ret = lsetfilecon(ftsent->fts_accpath, newcon);
+	t = phase_start();
+	ret = lsetfilecon(accpath, newcon);
+	phase_end(&st->setcon, t);
 	if (ret) {
 		fprintf(stderr, "%s set context %s->%s failed:'%s'\n",
 			r_opts->progname, my_file, newcon, strerror(errno));
@@ -265,10 +430,12 @@ out:
 	freecon(newcon);
 	return ret;
 skip:
+	count_error();
 	freecon(curcon);
 	freecon(newcon);
 	return SKIP;
 err:
+	count_error();
 	freecon(curcon);
 	freecon(newcon);
 	return ERR;
@@ -283,10 +450,12 @@ static int apply_spec(FTSENT *ftsent, int recurse)
 	if (ftsent->fts_info == FTS_DNR) {
 		fprintf(stderr, "%s:  unable to read directory %s\n",
 			r_opts->progname, ftsent->fts_path);
+		count_error();
 		return SKIP;
 	}
 	
-	int rc = restore(ftsent, recurse);
+	int rc = restore(ftsent->fts_path, ftsent->fts_accpath,
+			 ftsent->fts_statp, recurse, &stats);
 	if (rc == ERR) {
 		if (!r_opts->abort_on_error)
 			return SKIP;
@@ -294,6 +463,167 @@ static int apply_spec(FTSENT *ftsent, int recurse)
 	return rc;
 }
 
+static void *worker(void *arg)
+{
+	struct restore_stats *st = arg;
+	struct batch *b;
+	int i, rc;
+
+	for (;;) {
+		pthread_mutex_lock(&queue_lock);
+		while (!queue_head && !walk_done)
+			pthread_cond_wait(&queued_cond, &queue_lock);
+		b = queue_head;
+		if (!b) {
+			pthread_mutex_unlock(&queue_lock);
+			return NULL;
+		}
+		queue_head = b->next;
+		if (!queue_head)
+			queue_tail = &queue_head;
+		queued--;
+		pthread_cond_signal(&taken_cond);
+		pthread_mutex_unlock(&queue_lock);
+
+		for (i = 0; i < b->n; i++) {
+			if (!__atomic_load_n(&abort_walk, __ATOMIC_RELAXED)) {
+				rc = restore(b->work[i].path, b->work[i].path,
+					     &b->work[i].sb, b->work[i].recurse,
+					     st);
+				if (rc == ERR && r_opts->abort_on_error)
+					__atomic_store_n(&abort_walk, 1,
+							 __ATOMIC_RELAXED);
+			}
+			free(b->work[i].path);
+		}
+		free(b);
+	}
+}
+
+static void queue_batch(void)
+{
+	pthread_mutex_lock(&queue_lock);
+	while (queued >= MAX_BATCHES)
+		pthread_cond_wait(&taken_cond, &queue_lock);
+	filling->next = NULL;
+	*queue_tail = filling;
+	queue_tail = &filling->next;
+	queued++;
+	pthread_cond_signal(&queued_cond);
+	pthread_mutex_unlock(&queue_lock);
+	filling = NULL;
+}
+
+/* Hand a file to the workers; SKIP or ERR as for apply_spec(). */
+static int queue_spec(FTSENT *ftsent, int recurse)
+{
+	struct work *w;
+
+	if (ftsent->fts_info == FTS_DNR)
+		return apply_spec(ftsent, recurse);
+	if (__atomic_load_n(&abort_walk, __ATOMIC_RELAXED))
+		return ERR;
+
+	if (!filling) {
+		filling = malloc(sizeof(*filling));
+		if (!filling)
+			goto oom;
+		filling->n = 0;
+	}
+	w = &filling->work[filling->n];
+	w->path = strdup(ftsent->fts_path);
+	if (!w->path)
+		goto oom;
+	w->sb = *ftsent->fts_statp;
+	w->recurse = recurse;
+	if (++filling->n == BATCH_SIZE)
+		queue_batch();
+	return 0;
+
+oom:
+	fprintf(stderr, "%s:  Out of memory!\n", r_opts->progname);
+	count_error();
+	return ERR;
+}
+
+static int start_workers(void)
+{
+	int i;
+
+	workers = calloc(r_opts->nthreads, sizeof(*workers));
+	worker_stats = calloc(r_opts->nthreads, sizeof(*worker_stats));
+	if (!workers || !worker_stats)
+		goto err;
+	walk_done = 0;
+	abort_walk = 0;
+	for (i = 0; i < r_opts->nthreads; i++) {
+		if (pthread_create(&workers[i], NULL, worker,
+				   &worker_stats[i]) != 0) {
+			fprintf(stderr, "%s:  can't start a labeling thread: %s\n",
+				r_opts->progname, strerror(errno));
+			break;
+		}
+	}
+	if (i > 0) {
+		r_opts->nthreads = i;
+		return 0;
+	}
+err:
+	free(workers);
+	free(worker_stats);
+	workers = NULL;
+	worker_stats = NULL;
+	return -1;
+}
+
+/* Wait for the workers to finish what was queued; -1 if they gave up. */
+static int stop_workers(void)
+{
+	int i;
+
+	if (filling && filling->n > 0)
+		queue_batch();
+	free(filling);
+	filling = NULL;
+
+	pthread_mutex_lock(&queue_lock);
+	walk_done = 1;
+	pthread_cond_broadcast(&queued_cond);
+	pthread_mutex_unlock(&queue_lock);
+
+	for (i = 0; i < r_opts->nthreads; i++) {
+		pthread_join(workers[i], NULL);
+		stats.lookup += worker_stats[i].lookup;
+		stats.getcon += worker_stats[i].getcon;
+		stats.setcon += worker_stats[i].setcon;
+		stats.files += worker_stats[i].files;
+	}
+	free(workers);
+	free(worker_stats);
+	workers = NULL;
+	worker_stats = NULL;
+	return __atomic_load_n(&abort_walk, __ATOMIC_RELAXED) ? -1 : 0;
+}
+
+static FTSENT *walk_next(FTS *fts_handle)
+{
+	double t = phase_start();
+	FTSENT *ftsent = fts_read(fts_handle);
+
+	phase_end(&stats.walk, t);
+	return ftsent;
+}
+
+/* Whether the tree at PATH was labeled from these file contexts. */
+static int digest_matches(const char *path)
+{
+	unsigned char buf[64];
+	ssize_t len;
+
+	len = lgetxattr(path, DIGEST_XATTR, buf, sizeof(buf));
+	return len == (ssize_t)digest_len && memcmp(buf, digest, len) == 0;
+}
+
 #include <sys/statvfs.h>
 
 static int process_one(char *name, int recurse_this_path)
@@ -303,6 +633,8 @@ static int process_one(char *name, int recurse_this_path)
 	dev_t dev_num = 0;
 	FTS *fts_handle = NULL;
 	FTSENT *ftsent = NULL;
+	int tree, threaded = 0, errors_before = walk_errors;
+	int (*apply)(FTSENT *, int) = apply_spec;
 
 	if (r_opts == NULL){
 		fprintf(stderr,
@@ -319,7 +651,7 @@ static int process_one(char *name, int recurse_this_path)
 	}
 
 
-	ftsent = fts_read(fts_handle);
+	ftsent = walk_next(fts_handle);
 	if (ftsent == NULL) {
 		fprintf(stderr,
 			"%s: error while labeling %s:  %s\n",
@@ -330,6 +662,20 @@ static int process_one(char *name, int recurse_this_path)
 	/* Keep the inode of the first one. */
 	dev_num = ftsent->fts_statp->st_dev;
 
+	tree = recurse_this_path && ftsent->fts_info == FTS_D;
+	if (digest && tree && digest_matches(ftsent->fts_accpath)) {
+		if (r_opts->verbose)
+			printf("%s:  %s already labeled from these file contexts, skipping\n",
+			       r_opts->progname, ftsent->fts_path);
+		stats.trees_skipped++;
+		goto out;
+	}
+
+	if (tree && r_opts->nthreads > 1 && start_workers() == 0) {
+		threaded = 1;
+		apply = queue_spec;
+	}
+
 	do {
 		rc = 0;
 		/* Skip the post order nodes. */
@@ -346,16 +692,30 @@ static int process_one(char *name, int recurse_this_path)
 			}
 		}
 
-		rc = apply_spec(ftsent, recurse_this_path);
+		rc = apply(ftsent, recurse_this_path);
 		if (rc == SKIP)
 			fts_set(fts_handle, ftsent, FTS_SKIP);
 		if (rc == ERR)
 			goto err;
 		if (!recurse_this_path)
 			break;
-	} while ((ftsent = fts_read(fts_handle)) != NULL);
+	} while ((ftsent = walk_next(fts_handle)) != NULL);
+
+	if (threaded) {
+		threaded = 0;
+		if (stop_workers() < 0)
+			goto err;
+	}
+
+	if (digest && tree && r_opts->change &&
+	    walk_errors == errors_before &&
+	    lsetxattr(name, DIGEST_XATTR, digest, digest_len, 0) < 0)
+		fprintf(stderr, "%s:  can't store the file contexts digest on %s: %s\n",
+			r_opts->progname, name, strerror(errno));
 
 out:
+	if (threaded)
+		stop_workers();
 	if (r_opts->add_assoc) {
 		if (!r_opts->quiet)
 			filespec_eval();
@@ -42,6 +42,9 @@ struct restore_opts {
 	int fts_flags; /* Flags to fts, e.g. follow links, follow mounts */
 	const char *selabel_opt_validate;
 	const char *selabel_opt_path;
+	int nthreads; /* Label the files of a recursive walk on this many threads. */
+	int digest; /* Skip, and mark, trees labeled from the same file contexts. */
+	int timing; /* Print the time spent in each phase on exit. */
 };
 
 void restore_init(struct restore_opts *opts);
@@ -45,14 +45,14 @@ void usage(const char *const name)
 {
 	if (iamrestorecon) {
 		fprintf(stderr,
-			"usage:  %s [-iFnprRv0] [-e excludedir] pathname...\n"
-			"usage:  %s [-iFnprRv0] [-e excludedir] -f filename\n",
+			"usage:  %s [-iDFnprRtv0] [-e excludedir] [-T nthreads] pathname...\n"
+			"usage:  %s [-iDFnprRtv0] [-e excludedir] [-T nthreads] -f filename\n",
 			name, name);
 	} else {
 		fprintf(stderr,
-			"usage:  %s [-dilnpqvFW] [-e excludedir] [-r alt_root_path] spec_file pathname...\n"
-			"usage:  %s [-dilnpqvFW] [-e excludedir] [-r alt_root_path] spec_file -f filename\n"
-			"usage:  %s -s [-dilnpqvFW] spec_file\n"
+			"usage:  %s [-dilnpqtvDFW] [-e excludedir] [-r alt_root_path] [-T nthreads] spec_file pathname...\n"
+			"usage:  %s [-dilnpqtvDFW] [-e excludedir] [-r alt_root_path] [-T nthreads] spec_file -f filename\n"
+			"usage:  %s -s [-dilnpqtvDFW] spec_file\n"
 			"usage:  %s -c policyfile spec_file\n",
 			name, name, name, name);
 	}
@@ -153,8 +153,8 @@ int main(int argc, char **argv)
 	int recurse; /* Recursive descent. */
 	const char *base;
 	int mass_relabel = 0, errors = 0;
-	const char *ropts = "e:f:hilno:pqrsvFRW0";
-	const char *sopts = "c:de:f:hilno:pqr:svFR:W0";
+	const char *ropts = "e:f:hilno:pqrstvDFRT:W0";
+	const char *sopts = "c:de:f:hilno:pqr:stvDFR:T:W0";
 	const char *opts;
 	
 	memset(&r_opts, 0, sizeof(r_opts));
@@ -352,6 +352,19 @@ int main(int argc, char **argv)
 		case 'W':
 			warn_no_match = 1;
 			break;
+		case 'D':
+			r_opts.digest = 1;
+			break;
+		case 't':
+			r_opts.timing = 1;
+			break;
+		case 'T':
+			r_opts.nthreads = atoi(optarg);
+			if (r_opts.nthreads < 1) {
+				fprintf(stderr, "Bad thread count %s\n", optarg);
+				usage(argv[0]);
+			}
+			break;
 		case '0':
 			null_terminated = 1;
 			break;
@@ -77,17 +77,11 @@ void SubsetUtil::Subset(const char *input_file_path,
   remove_tables.insert(Tag::DSIG);
   subsetter->SetRemoveTables(&remove_tables);
 
-  FontBuilderPtr font_builder;
-  font_builder.Attach(subsetter->Subset());
-
-  FontPtr new_font;
-  new_font.Attach(font_builder->Build());
-
-  // TODO(arthurhsu): glyph renumbering/Loca table
   // TODO(arthurhsu): alter CMaps
 
   MemoryOutputStream output_stream;
-  factory->SerializeFont(new_font, &output_stream);
+  if (!subsetter->Subset(&output_stream))
+    return;
 
   FILE* output_file = fopen(output_file_path, "wb");
   fwrite(output_stream.Get(), 1, output_stream.Size(), output_file);
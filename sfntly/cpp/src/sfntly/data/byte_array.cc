@@ -38,6 +38,13 @@ int32_t ByteArray::Get(int32_t index) {
   return InternalGet(index) & 0xff;
 }
 
+const byte_t* ByteArray::Span(int32_t index, int32_t length) {
+  if (index < 0 || length <= 0 || index > filled_length_ - length) {
+    return NULL;
+  }
+  return Begin() + index;
+}
+
 int32_t ByteArray::Get(int32_t index, ByteVector* b) {
   assert(b);
   return Get(index, &((*b)[0]), 0, b->size());
@@ -107,6 +114,14 @@ int32_t ByteArray::CopyTo(int32_t dst_offset, ByteArray* array,
     return -1;
   }
 
+  // Copy straight from storage unless source and destination may overlap.
+  int32_t available = std::min<int32_t>(length, filled_length_ - src_offset);
+  const byte_t* src = (array != this) ? Span(src_offset, available) : NULL;
+  if (src) {
+    array->Put(dst_offset, const_cast<byte_t*>(src), 0, available);
+    return available;
+  }
+
   ByteVector b(COPY_BUFFER_SIZE);
   int32_t bytes_read = 0;
   int32_t index = 0;
@@ -128,6 +143,13 @@ int32_t ByteArray::CopyTo(OutputStream* os) {
 }
 
 int32_t ByteArray::CopyTo(OutputStream* os, int32_t offset, int32_t length) {
+  int32_t available = std::min<int32_t>(length, filled_length_ - offset);
+  const byte_t* src = Span(offset, available);
+  if (src) {
+    os->Write(const_cast<byte_t*>(src), 0, available);
+    return available;
+  }
+
   ByteVector b(COPY_BUFFER_SIZE);
   int32_t bytes_read = 0;
   int32_t index = 0;
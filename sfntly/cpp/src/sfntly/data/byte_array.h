@@ -136,6 +136,15 @@ class ByteArray : virtual public RefCount {
   // @param is the source
   virtual bool CopyFrom(InputStream* is);
 
+  // C++ port only. Gets a pointer to the storage of the bytes from index to
+  // index + length, which is contiguous in every ByteArray implementation. This
+  // lets callers decode a run of values without a virtual call per byte.
+  // The pointer is invalidated by any write to a growable array.
+  // @param index index into the byte array
+  // @param length the number of bytes needed from index
+  // @return the bytes; NULL if the range is not within the filled length
+  const byte_t* Span(int32_t index, int32_t length);
+
  protected:
   // filledLength the length that is "filled" and readable counting from offset.
   // storageLength the maximum storage size of the underlying data.
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2011 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "sfntly/data/mapped_byte_array.h"
+
+#include <limits.h>
+#include <string.h>
+
+#if !defined (WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sfntly {
+
+MappedByteArray::MappedByteArray()
+    : ByteArray(0, 0),
+      b_(NULL),
+      mapped_length_(0)
+#if defined (WIN32)
+      , mapping_(NULL)
+#endif
+{
+}
+
+MappedByteArray::~MappedByteArray() {
+  Close();
+}
+
+bool MappedByteArray::Open(const char* file_path) {
+  assert(file_path);
+  Close();
+
+#if defined (WIN32)
+  HANDLE file = CreateFileA(file_path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0 ||
+      size.QuadPart > INT_MAX) {
+    CloseHandle(file);
+    return false;
+  }
+  mapping_ = CreateFileMapping(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+  CloseHandle(file);  // The mapping keeps its own reference to the file.
+  if (mapping_ == NULL) {
+    return false;
+  }
+  b_ = static_cast<byte_t*>(MapViewOfFile(mapping_, FILE_MAP_COPY, 0, 0, 0));
+  if (b_ == NULL) {
+    CloseHandle(mapping_);
+    mapping_ = NULL;
+    return false;
+  }
+  mapped_length_ = (size_t)size.QuadPart;
+#else
+  int fd = open(file_path, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0 || st.st_size > INT_MAX) {
+    close(fd);
+    return false;
+  }
+  void* addr = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE, fd, 0);
+  close(fd);  // The mapping keeps its own reference to the file.
+  if (addr == MAP_FAILED) {
+    return false;
+  }
+  b_ = static_cast<byte_t*>(addr);
+  mapped_length_ = (size_t)st.st_size;
+#endif
+
+  Init((int32_t)mapped_length_, (int32_t)mapped_length_, false);
+  return true;
+}
+
+int32_t MappedByteArray::CopyTo(OutputStream* os,
+                                int32_t offset,
+                                int32_t length) {
+  assert(os);
+  os->Write(b_, offset, length);
+  return length;
+}
+
+void MappedByteArray::InternalPut(int32_t index, byte_t b) {
+  b_[index] = b;
+}
+
+int32_t MappedByteArray::InternalPut(int32_t index,
+                                     byte_t* b,
+                                     int32_t offset,
+                                     int32_t length) {
+  assert(b);
+  memcpy(b_ + index, b + offset, length);
+  return length;
+}
+
+byte_t MappedByteArray::InternalGet(int32_t index) {
+  return b_[index];
+}
+
+int32_t MappedByteArray::InternalGet(int32_t index,
+                                     byte_t* b,
+                                     int32_t offset,
+                                     int32_t length) {
+  assert(b);
+  memcpy(b + offset, b_ + index, length);
+  return length;
+}
+
+void MappedByteArray::Close() {
+  if (b_) {
+#if defined (WIN32)
+    UnmapViewOfFile(b_);
+    CloseHandle(mapping_);
+    mapping_ = NULL;
+#else
+    munmap(b_, mapped_length_);
+#endif
+  }
+  b_ = NULL;
+  mapped_length_ = 0;
+  Init(0, 0, false);
+}
+
+byte_t* MappedByteArray::Begin() {
+  return b_;
+}
+
+}  // namespace sfntly
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2011 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SFNTLY_CPP_SRC_SFNTLY_DATA_MAPPED_BYTE_ARRAY_H_
+#define SFNTLY_CPP_SRC_SFNTLY_DATA_MAPPED_BYTE_ARRAY_H_
+
+#if defined (WIN32)
+#include <windows.h>
+#endif
+
+#include "sfntly/data/byte_array.h"
+
+namespace sfntly {
+
+// A fixed size ByteArray backed by a memory mapped file. Nothing is read until
+// the bytes are touched, so loading a large font through a MappedByteArray
+// costs neither the time nor the memory of copying the whole file. The mapping
+// is private copy-on-write: Put() changes this array only, never the file.
+class MappedByteArray : public ByteArray, public RefCounted<MappedByteArray> {
+ public:
+  MappedByteArray();
+  virtual ~MappedByteArray();
+
+  // Map the file at file_path. Any previous mapping is released first.
+  // @return false if the file cannot be opened, is empty, or is too large to
+  //         be addressed by a ByteArray
+  bool Open(const char* file_path);
+
+  virtual int32_t CopyTo(OutputStream* os, int32_t offset, int32_t length);
+
+  // Make gcc -Woverloaded-virtual happy.
+  virtual int32_t CopyTo(ByteArray* array) { return ByteArray::CopyTo(array); }
+  virtual int32_t CopyTo(ByteArray* array, int32_t offset, int32_t length) {
+    return ByteArray::CopyTo(array, offset, length);
+  }
+  virtual int32_t CopyTo(int32_t dst_offset,
+                         ByteArray* array,
+                         int32_t src_offset,
+                         int32_t length) {
+    return ByteArray::CopyTo(dst_offset, array, src_offset, length);
+  }
+  virtual int32_t CopyTo(OutputStream* os) { return ByteArray::CopyTo(os); }
+
+ protected:
+  virtual void InternalPut(int32_t index, byte_t b);
+  virtual int32_t InternalPut(int32_t index,
+                              byte_t* b,
+                              int32_t offset,
+                              int32_t length);
+  virtual byte_t InternalGet(int32_t index);
+  virtual int32_t InternalGet(int32_t index,
+                              byte_t* b,
+                              int32_t offset,
+                              int32_t length);
+  virtual void Close();
+  virtual byte_t* Begin();
+
+ private:
+  byte_t* b_;
+  size_t mapped_length_;
+#if defined (WIN32)
+  HANDLE mapping_;
+#endif
+};
+typedef Ptr<MappedByteArray> MappedByteArrayPtr;
+
+}  // namespace sfntly
+
+#endif  // SFNTLY_CPP_SRC_SFNTLY_DATA_MAPPED_BYTE_ARRAY_H_
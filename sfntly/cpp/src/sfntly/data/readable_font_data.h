@@ -92,6 +92,15 @@ class ReadableFontData : public FontData,
                             int32_t offset,
                             int32_t length);
 
+  // C++ port only. Gets the bytes at the given index in place, without copying.
+  // Parsers reading runs of big-endian values should use this rather than
+  // calling ReadUShort() and friends per value.
+  // @param index index into the font data
+  // @param length the number of bytes needed from index
+  // @return the bytes; NULL if any of them is outside the bounds of the font
+  //         data. Valid until the font data is next written to.
+  const byte_t* ReadSpan(int32_t index, int32_t length);
+
   // Read the CHAR at the given index.
   // @param index index into the font data
   // @return the CHAR
@@ -296,7 +305,14 @@ class ReadableFontData : public FontData,
   // @return the checksum for the total range
   int64_t ComputeCheckSum(int32_t low_bound, int32_t high_bound);
 
-  Lock checksum_lock_;
+  // Sum count big-endian ULongs starting at p. Kept free of reads through the
+  // ByteArray so that the compiler can vectorize it.
+  static int64_t SumULongs(const byte_t* p, int32_t count);
+
+  // Read-locked to return a cached checksum, write-locked to compute it or to
+  // change the ranges, so that tables shared between threads do not serialize
+  // on every checksum lookup.
+  ReadWriteLock checksum_lock_;
   bool checksum_set_;
   int64_t checksum_;
   IntegerList checksum_range_;
@@ -49,24 +49,54 @@ const int32_t SFNTVERSION_MINOR = 0;
 Font::~Font() {}
 
 bool Font::HasTable(int32_t tag) {
+  if (!table_data_.empty()) {
+    return table_data_.find(tag) != table_data_.end();
+  }
   TableMap::const_iterator result = tables_.find(tag);
   TableMap::const_iterator end = tables_.end();
   return (result != end);
 }
 
+int32_t Font::num_tables() {
+  if (!table_data_.empty()) {
+    return (int32_t)table_data_.size();
+  }
+  return (int32_t)tables_.size();
+}
+
 Table* Font::GetTable(int32_t tag) {
-  if (!HasTable(tag)) {
+  if (!table_data_.empty()) {
+    {
+      AutoReadLock lock(lazy_lock_);
+      TableMap::iterator table = tables_.find(tag);
+      if (table != tables_.end()) {
+        return table->second;
+      }
+    }
+    AutoWriteLock lock(lazy_lock_);
+    TableMap::iterator table = tables_.find(tag);
+    if (table != tables_.end()) {
+      return table->second;
+    }
+    return ParseTable(tag);
+  }
+  // Eager fonts never insert into tables_ after Build(), so lookups need no
+  // lock; use find() rather than operator[] to keep it that way.
+  TableMap::iterator table = tables_.find(tag);
+  if (table == tables_.end()) {
     return NULL;
   }
-  return tables_[tag];
+  return table->second;
 }
 
 const TableMap* Font::GetTableMap() {
+  ParseAllTables();
   return &tables_;
 }
 
 void Font::Serialize(OutputStream* os, IntegerList* table_ordering) {
   assert(table_ordering);
+  ParseAllTables();
   IntegerList final_table_ordering;
   GenerateTableOrdering(table_ordering, &final_table_ordering);
   TableHeaderList table_records;
@@ -192,6 +222,67 @@ void Font::GenerateTableOrdering(IntegerList* default_table_ordering,
   }
 }
 
+Table* Font::ParseTable(int32_t tag) {
+  std::map<int32_t, DataBlockEntry>::iterator block = table_data_.find(tag);
+  if (block == table_data_.end()) {
+    return NULL;
+  }
+
+  // loca, hmtx and hdmx can only be read with values taken from head, hhea and
+  // maxp, so those builders go through the relating pass too.  They are never
+  // built here and share the table data, which makes them cheap.
+  TableBuilderMap builders;
+  TableBuilderPtr builder;
+  builder.Attach(Table::Builder::GetBuilder(block->second.first,
+                                            block->second.second));
+  builders.insert(TableBuilderEntry(tag, builder));
+  if (tag == Tag::loca || tag == Tag::hmtx || tag == Tag::hdmx) {
+    static const int32_t related_tags[] = { Tag::head, Tag::hhea, Tag::maxp };
+    for (size_t i = 0; i < sizeof(related_tags) / sizeof(int32_t); ++i) {
+      std::map<int32_t, DataBlockEntry>::iterator related =
+          table_data_.find(related_tags[i]);
+      if (related == table_data_.end()) {
+        continue;
+      }
+      TableBuilderPtr related_builder;
+      related_builder.Attach(Table::Builder::GetBuilder(
+          related->second.first, related->second.second));
+      builders.insert(TableBuilderEntry(related_tags[i], related_builder));
+    }
+  }
+  Builder::InterRelateBuilders(&builders);
+
+  TablePtr table;
+  if (builder->ReadyToBuild()) {
+    table.Attach(down_cast<Table*>(builder->Build()));
+  }
+  if (table == NULL) {
+    return NULL;
+  }
+  tables_.insert(TableMapEntry(tag, table));
+  return table;
+}
+
+void Font::ParseAllTables() {
+  if (table_data_.empty()) {
+    return;
+  }
+  {
+    AutoReadLock lock(lazy_lock_);
+    if (tables_.size() == table_data_.size()) {
+      return;
+    }
+  }
+  AutoWriteLock lock(lazy_lock_);
+  for (std::map<int32_t, DataBlockEntry>::iterator
+           block = table_data_.begin(), blocks_end = table_data_.end();
+           block != blocks_end; ++block) {
+    if (tables_.find(block->first) == tables_.end()) {
+      ParseTable(block->first);
+    }
+  }
+}
+
 void Font::DefaultTableOrdering(IntegerList* default_table_ordering) {
   assert(default_table_ordering);
   default_table_ordering->clear();
@@ -234,6 +325,25 @@ CALLER_ATTACH Font::Builder* Font::Builder::GetOTFBuilder(
   return builder.Detach();
 }
 
+CALLER_ATTACH Font::Builder* Font::Builder::GetLazyOTFBuilder(
+    FontFactory* factory,
+    InputStream* is) {
+  FontBuilderPtr builder = new Builder(factory);
+  builder->lazy_ = true;
+  builder->LoadFont(is);
+  return builder.Detach();
+}
+
+CALLER_ATTACH Font::Builder* Font::Builder::GetLazyOTFBuilder(
+    FontFactory* factory,
+    WritableFontData* wfd,
+    int32_t offset_to_offset_table) {
+  FontBuilderPtr builder = new Builder(factory);
+  builder->lazy_ = true;
+  builder->LoadFont(wfd, offset_to_offset_table);
+  return builder.Detach();
+}
+
 bool Font::Builder::ReadyToBuild() {
   // just read in data with no manipulation
   if (table_builders_.empty() && !data_blocks_.empty()) {
@@ -258,6 +368,14 @@ CALLER_ATTACH Font* Font::Builder::Build() {
     // Note: Different from Java. Directly use font->tables_ here to avoid
     //       STL container copying.
     BuildTablesFromBuilders(font, &table_builders_, &font->tables_);
+  } else if (lazy_) {
+    // Hand the raw table data over; tables get parsed on first use.
+    for (DataBlockMap::iterator block = data_blocks_.begin(),
+                                blocks_end = data_blocks_.end();
+                                block != blocks_end; ++block) {
+      font->table_data_.insert(
+          std::make_pair(block->first->tag(), DataBlockEntry(*block)));
+    }
   }
 
   table_builders_.clear();
@@ -316,7 +434,8 @@ void Font::Builder::RemoveTableBuilder(int32_t tag) {
 
 Font::Builder::Builder(FontFactory* factory)
     : factory_(factory),
-      sfnt_version_(Fixed1616::Fixed(SFNTVERSION_MAJOR, SFNTVERSION_MINOR)) {
+      sfnt_version_(Fixed1616::Fixed(SFNTVERSION_MAJOR, SFNTVERSION_MINOR)),
+      lazy_(false) {
 }
 
 void Font::Builder::LoadFont(InputStream* is) {
@@ -326,7 +445,9 @@ void Font::Builder::LoadFont(InputStream* is) {
   HeaderOffsetSortedSet records;
   ReadHeader(&font_is, &records);
   LoadTableData(&records, &font_is, &data_blocks_);
-  BuildAllTableBuilders(&data_blocks_, &table_builders_);
+  if (!lazy_) {
+    BuildAllTableBuilders(&data_blocks_, &table_builders_);
+  }
   font_is.Close();
 }
 
@@ -337,7 +458,9 @@ void Font::Builder::LoadFont(WritableFontData* wfd,
   HeaderOffsetSortedSet records;
   ReadHeader(wfd, offset_to_offset_table, &records);
   LoadTableData(&records, wfd, &data_blocks_);
-  BuildAllTableBuilders(&data_blocks_, &table_builders_);
+  if (!lazy_) {
+    BuildAllTableBuilders(&data_blocks_, &table_builders_);
+  }
 }
 
 int32_t Font::Builder::SfntWrapperSize() {
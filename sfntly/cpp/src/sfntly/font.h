@@ -19,6 +19,7 @@
 
 #include <vector>
 
+#include "sfntly/port/lock.h"
 #include "sfntly/port/refcount.h"
 #include "sfntly/port/type.h"
 #include "sfntly/port/endian.h"
@@ -121,6 +122,10 @@ class FontFactory;
 
 // An sfnt container font object. This object is immutable and thread safe. To
 // construct one use an instance of Font::Builder.
+// A loaded Font and its tables may be shared by any number of threads, e.g.
+// each subsetting it with its own Subsetter. The lazily filled caches behind
+// it (parsed tables, checksums, bitmap size tables) take a read lock on the
+// common path and only write lock while being filled.
 class Font : public RefCounted<Font> {
  public:
   // A builder for a font object. The builder allows the for the creation of
@@ -139,6 +144,16 @@ class Font : public RefCounted<Font> {
                       int32_t offset_to_offset_table);
     static CALLER_ATTACH Builder* GetOTFBuilder(FontFactory* factory);
 
+    // Get a builder that only reads the table directory. The Font it builds
+    // parses each table the first time it is asked for. No table builders are
+    // created, so the builder is only good for calling Build().
+    static CALLER_ATTACH Builder*
+        GetLazyOTFBuilder(FontFactory* factory, InputStream* is);
+    static CALLER_ATTACH Builder*
+        GetLazyOTFBuilder(FontFactory* factory,
+                          WritableFontData* wfd,
+                          int32_t offset_to_offset_table);
+
     // Get the font factory that created this font builder.
     FontFactory* GetFontFactory() { return factory_; }
 
@@ -189,6 +204,8 @@ class Font : public RefCounted<Font> {
     }
 
    private:
+    friend class Font;  // Lazily loaded fonts relate their own tables.
+
     explicit Builder(FontFactory* factory);
     virtual void LoadFont(InputStream* is);
     virtual void LoadFont(WritableFontData* wfd,
@@ -227,6 +244,7 @@ class Font : public RefCounted<Font> {
     int32_t range_shift_;
     DataBlockMap data_blocks_;
     ByteVector digest_;
+    bool lazy_;
   };
 
   virtual ~Font();
@@ -242,7 +260,7 @@ class Font : public RefCounted<Font> {
   int64_t checksum() { return checksum_; }
 
   // Get the number of tables in this font.
-  int32_t num_tables() { return (int32_t)tables_.size(); }
+  int32_t num_tables();
 
   // Whether the font has a particular table.
   bool HasTable(int32_t tag);
@@ -337,10 +355,22 @@ class Font : public RefCounted<Font> {
   // @param (out) default_table_ordering the default table ordering
   void DefaultTableOrdering(IntegerList* default_table_ordering);
 
+  // Lazily loaded fonts only: parse the table with the given tag from its
+  // raw data and add it to tables_. The caller holds lazy_lock_ for writing.
+  Table* ParseTable(int32_t tag);
+
+  // Lazily loaded fonts only: parse every table not parsed yet.
+  void ParseAllTables();
+
   int32_t sfnt_version_;
   ByteVector digest_;
   int64_t checksum_;
   TableMap tables_;
+
+  // Raw data of every table of a lazily loaded font by tag; empty otherwise.
+  // tables_ caches the tables parsed from it so far.
+  std::map<int32_t, DataBlockEntry> table_data_;
+  ReadWriteLock lazy_lock_;
 };
 typedef Ptr<Font> FontPtr;
 typedef std::vector<FontPtr> FontArray;
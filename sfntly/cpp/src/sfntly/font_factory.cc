@@ -38,6 +38,14 @@ bool FontFactory::FingerprintFont() {
   return fingerprint_;
 }
 
+void FontFactory::LazyTableParsing(bool lazy) {
+  lazy_table_parsing_ = lazy;
+}
+
+bool FontFactory::LazyTableParsing() {
+  return lazy_table_parsing_;
+}
+
 void FontFactory::LoadFonts(InputStream* is, FontArray* output) {
   assert(output);
   PushbackInputStream* pbis = down_cast<PushbackInputStream*>(is);
@@ -66,6 +74,20 @@ void FontFactory::LoadFonts(ByteVector* b, FontArray* output) {
   }
 }
 
+void FontFactory::LoadFonts(ByteArray* ba, FontArray* output) {
+  assert(ba);
+  WritableFontDataPtr wfd = new WritableFontData(ba);
+  if (IsCollection(wfd)) {
+    LoadCollection(wfd, output);
+    return;
+  }
+  FontPtr font;
+  font.Attach(LoadSingleOTF(wfd));
+  if (font) {
+    output->push_back(font);
+  }
+}
+
 void FontFactory::LoadFontsForBuilding(InputStream* is,
                                        FontBuilderArray* output) {
   PushbackInputStream* pbis = down_cast<PushbackInputStream*>(is);
@@ -110,41 +132,53 @@ CALLER_ATTACH Font::Builder* FontFactory::NewFontBuilder() {
 
 CALLER_ATTACH Font* FontFactory::LoadSingleOTF(InputStream* is) {
   FontBuilderPtr builder;
-  builder.Attach(LoadSingleOTFForBuilding(is));
+  if (lazy_table_parsing_) {
+    builder.Attach(Font::Builder::GetLazyOTFBuilder(this, is));
+  } else {
+    builder.Attach(LoadSingleOTFForBuilding(is));
+  }
   return builder->Build();
 }
 
 CALLER_ATTACH Font* FontFactory::LoadSingleOTF(WritableFontData* wfd) {
   FontBuilderPtr builder;
-  builder.Attach(LoadSingleOTFForBuilding(wfd, 0));
+  builder.Attach(LoadSingleOTFForLoading(wfd, 0));
   return builder->Build();
 }
 
 void FontFactory::LoadCollection(InputStream* is, FontArray* output) {
-  FontBuilderArray ba;
-  LoadCollectionForBuilding(is, &ba);
-  output->reserve(ba.size());
-  for (FontBuilderArray::iterator builder = ba.begin(), builders_end = ba.end();
-                                  builder != builders_end; ++builder) {
-      FontPtr font;
-      font.Attach((*builder)->Build());
-      output->push_back(font);
-  }
+  assert(is);
+  WritableFontDataPtr wfd;
+  wfd.Attach(WritableFontData::CreateWritableFontData(is->Available()));
+  wfd->CopyFrom(is);
+  LoadCollection(wfd, output);
 }
 
 void FontFactory::LoadCollection(WritableFontData* wfd, FontArray* output) {
-  FontBuilderArray builders;
-  LoadCollectionForBuilding(wfd, &builders);
-  output->reserve(builders.size());
-  for (FontBuilderArray::iterator builder = builders.begin(),
-                                  builders_end = builders.end();
-                                  builder != builders_end; ++builder) {
+  int32_t num_fonts = wfd->ReadULongAsInt(Offset::kNumFonts);
+  output->reserve(num_fonts);
+  int32_t offset_table_offset = Offset::kOffsetTable;
+  for (int32_t font_number = 0;
+               font_number < num_fonts;
+               font_number++, offset_table_offset += DataSize::kULONG) {
+    int32_t offset = wfd->ReadULongAsInt(offset_table_offset);
+    FontBuilderPtr builder;
+    builder.Attach(LoadSingleOTFForLoading(wfd, offset));
     FontPtr font;
-    font.Attach((*builder)->Build());
+    font.Attach(builder->Build());
     output->push_back(font);
   }
 }
 
+CALLER_ATTACH Font::Builder*
+    FontFactory::LoadSingleOTFForLoading(WritableFontData* wfd,
+                                         int32_t offset_to_offset_table) {
+  if (lazy_table_parsing_) {
+    return Font::Builder::GetLazyOTFBuilder(this, wfd, offset_to_offset_table);
+  }
+  return LoadSingleOTFForBuilding(wfd, offset_to_offset_table);
+}
+
 CALLER_ATTACH
 Font::Builder* FontFactory::LoadSingleOTFForBuilding(InputStream* is) {
   // UNIMPLEMENTED: SHA-1 hash checking via Java DigestStream
@@ -208,7 +242,8 @@ bool FontFactory::IsCollection(ReadableFontData* rfd) {
 }
 
 FontFactory::FontFactory()
-    : fingerprint_(false) {
+    : fingerprint_(false),
+      lazy_table_parsing_(false) {
 }
 
 }  // namespace sfntly
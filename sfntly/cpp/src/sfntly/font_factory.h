@@ -41,6 +41,14 @@ class FontFactory : public RefCounted<FontFactory> {
   void FingerprintFont(bool fingerprint);
   bool FingerprintFont();
 
+  // Toggle whether fonts loaded with LoadFonts() parse their tables up front
+  // or only the first time each table is asked for. Lazy loading skips the
+  // table builders entirely and shares the loaded data with the tables, which
+  // makes loading a large font nearly free when only a few of its tables are
+  // used. It does not affect LoadFontsForBuilding(). By default this is off.
+  void LazyTableParsing(bool lazy);
+  bool LazyTableParsing();
+
   // Load the font(s) from the input stream. The current settings on the factory
   // are used during the loading process. One or more fonts are returned if the
   // stream contains valid font data. Some font container formats may have more
@@ -58,6 +66,11 @@ class FontFactory : public RefCounted<FontFactory> {
   // will be returned.
   void LoadFonts(ByteVector* b, FontArray* output);
 
+  // Load the font(s) from the byte array without copying it. The fonts keep a
+  // reference to the array and read their table data from it directly, so it
+  // pairs well with a MappedByteArray over the font file.
+  void LoadFonts(ByteArray* ba, FontArray* output);
+
   // Load the font(s) from the input stream into font builders. The current
   // settings on the factory are used during the loading process. One or more
   // font builders are returned if the stream contains valid font data. Some
@@ -118,6 +131,11 @@ class FontFactory : public RefCounted<FontFactory> {
   void LoadCollection(InputStream* is, FontArray* output);
   void LoadCollection(WritableFontData* wfd, FontArray* output);
 
+  // Builder used by LoadFonts(), honoring the lazy table parsing setting.
+  CALLER_ATTACH Font::Builder* LoadSingleOTFForLoading(
+      WritableFontData* wfd,
+      int32_t offset_to_offset_table);
+
   CALLER_ATTACH Font::Builder* LoadSingleOTFForBuilding(InputStream* is);
   CALLER_ATTACH Font::Builder*
       LoadSingleOTFForBuilding(WritableFontData* wfd,
@@ -131,6 +149,7 @@ class FontFactory : public RefCounted<FontFactory> {
   static bool IsCollection(ReadableFontData* wfd);
 
   bool fingerprint_;
+  bool lazy_table_parsing_;
   IntegerList table_ordering_;
 };
 typedef Ptr<FontFactory> FontFactoryPtr;
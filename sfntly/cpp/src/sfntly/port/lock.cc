@@ -45,6 +45,30 @@ void Lock::Unlock() {
   ::LeaveCriticalSection(&os_lock_);
 }
 
+ReadWriteLock::ReadWriteLock() {
+  ::InitializeSRWLock(&os_lock_);
+}
+
+ReadWriteLock::~ReadWriteLock() {
+  // Slim reader/writer locks own no resources.
+}
+
+void ReadWriteLock::AcquireRead() {
+  ::AcquireSRWLockShared(&os_lock_);
+}
+
+void ReadWriteLock::UnlockRead() {
+  ::ReleaseSRWLockShared(&os_lock_);
+}
+
+void ReadWriteLock::AcquireWrite() {
+  ::AcquireSRWLockExclusive(&os_lock_);
+}
+
+void ReadWriteLock::UnlockWrite() {
+  ::ReleaseSRWLockExclusive(&os_lock_);
+}
+
 #else  // We assume it's pthread
 
 Lock::Lock() {
@@ -67,6 +91,30 @@ void Lock::Unlock() {
   pthread_mutex_unlock(&os_lock_);
 }
 
+ReadWriteLock::ReadWriteLock() {
+  pthread_rwlock_init(&os_lock_, NULL);
+}
+
+ReadWriteLock::~ReadWriteLock() {
+  pthread_rwlock_destroy(&os_lock_);
+}
+
+void ReadWriteLock::AcquireRead() {
+  pthread_rwlock_rdlock(&os_lock_);
+}
+
+void ReadWriteLock::UnlockRead() {
+  pthread_rwlock_unlock(&os_lock_);
+}
+
+void ReadWriteLock::AcquireWrite() {
+  pthread_rwlock_wrlock(&os_lock_);
+}
+
+void ReadWriteLock::UnlockWrite() {
+  pthread_rwlock_unlock(&os_lock_);
+}
+
 #endif
 
 }  // namespace sfntly
@@ -30,8 +30,10 @@ namespace sfntly {
 
 #if defined (WIN32)
   typedef CRITICAL_SECTION OSLockType;
+  typedef SRWLOCK OSReadWriteLockType;
 #else  // Assume pthread.
   typedef pthread_mutex_t OSLockType;
+  typedef pthread_rwlock_t OSReadWriteLockType;
 #endif
 
 class Lock {
@@ -71,6 +73,54 @@ class AutoLock {
   NO_COPY_AND_ASSIGN(AutoLock);
 };
 
+// A lock that any number of readers may hold at once, for caches that are
+// filled once and then only read. Not recursive: a thread holding the read
+// lock must release it before acquiring the write lock.
+class ReadWriteLock {
+ public:
+  ReadWriteLock();
+  ~ReadWriteLock();
+
+  void AcquireRead();
+  void UnlockRead();
+  void AcquireWrite();
+  void UnlockWrite();
+
+ private:
+  OSReadWriteLockType os_lock_;
+  NO_COPY_AND_ASSIGN(ReadWriteLock);
+};
+
+class AutoReadLock {
+ public:
+  explicit AutoReadLock(ReadWriteLock& lock) : lock_(lock) {
+    lock_.AcquireRead();
+  }
+
+  ~AutoReadLock() {
+    lock_.UnlockRead();
+  }
+
+ private:
+  ReadWriteLock& lock_;
+  NO_COPY_AND_ASSIGN(AutoReadLock);
+};
+
+class AutoWriteLock {
+ public:
+  explicit AutoWriteLock(ReadWriteLock& lock) : lock_(lock) {
+    lock_.AcquireWrite();
+  }
+
+  ~AutoWriteLock() {
+    lock_.UnlockWrite();
+  }
+
+ private:
+  ReadWriteLock& lock_;
+  NO_COPY_AND_ASSIGN(AutoWriteLock);
+};
+
 }  // namespace sfntly
 
 #endif  // SFNTLY_CPP_SRC_SFNTLY_PORT_LOCK_H_
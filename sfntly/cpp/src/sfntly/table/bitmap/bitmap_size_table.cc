@@ -180,7 +180,13 @@ IndexSubTable* BitmapSizeTable::CreateIndexSubTable(int32_t index) {
 }
 
 IndexSubTableList* BitmapSizeTable::GetIndexSubTableList() {
-  AutoLock lock(index_subtables_lock_);
+  {
+    AutoReadLock lock(index_subtables_lock_);
+    if (!index_subtables_.empty()) {
+      return &index_subtables_;
+    }
+  }
+  AutoWriteLock lock(index_subtables_lock_);
   if (index_subtables_.empty()) {
     for (int32_t i = 0; i < NumberOfIndexSubTables(); ++i) {
       IndexSubTablePtr table;
@@ -160,7 +160,7 @@ class BitmapSizeTable : public SubTable,
   CALLER_ATTACH IndexSubTable* CreateIndexSubTable(int32_t index);
   IndexSubTableList* GetIndexSubTableList();
 
-  Lock index_subtables_lock_;
+  ReadWriteLock index_subtables_lock_;
   IndexSubTableList index_subtables_;
 };
 typedef Ptr<BitmapSizeTable> BitmapSizeTablePtr;
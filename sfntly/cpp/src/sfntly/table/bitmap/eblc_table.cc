@@ -53,7 +53,13 @@ EblcTable::EblcTable(Header* header, ReadableFontData* data)
 }
 
 BitmapSizeTableList* EblcTable::GetBitmapSizeTableList() {
-  AutoLock lock(bitmap_size_table_lock_);
+  {
+    AutoReadLock lock(bitmap_size_table_lock_);
+    if (!bitmap_size_table_.empty()) {
+      return &bitmap_size_table_;
+    }
+  }
+  AutoWriteLock lock(bitmap_size_table_lock_);
   if (bitmap_size_table_.empty()) {
     CreateBitmapSizeTable(data_, NumSizes(), &bitmap_size_table_);
   }
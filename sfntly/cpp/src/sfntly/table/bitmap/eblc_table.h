@@ -184,7 +184,7 @@ class EblcTable : public SubTableContainerTable,
                                     int32_t num_sizes,
                                     BitmapSizeTableList* output);
 
-  Lock bitmap_size_table_lock_;
+  ReadWriteLock bitmap_size_table_lock_;
   BitmapSizeTableList bitmap_size_table_;
 };
 typedef Ptr<EblcTable> EblcTablePtr;
@@ -19,10 +19,100 @@
 #include <algorithm>
 #include <iterator>
 
+#include "sfntly/math/font_math.h"
+#include "sfntly/table/core/horizontal_metrics_table.h"
+#include "sfntly/table/truetype/glyph_table.h"
+#include "sfntly/table/truetype/loca_table.h"
+#include "sfntly/tag.h"
 #include "sfntly/tools/subsetter/glyph_table_subsetter.h"
 
 namespace sfntly {
 
+namespace {
+
+// Offsets of the fields Subset(OutputStream*) rewrites.
+const int32_t kGlyphHeaderSize = 10;
+const int32_t kHeadCheckSumAdjustment = 8;
+const int32_t kHeadIndexToLocFormat = 50;
+const int32_t kHheaNumberOfHMetrics = 34;
+const int32_t kMaxpNumGlyphs = 4;
+const int32_t kSfntHeaderSize = 12;
+const int32_t kTableRecordSize = 16;
+const int64_t kChecksumAdjustmentMagic = 0xB1B0AFBA;
+
+void PutUShort(ByteVector* b, size_t index, int32_t value) {
+  (*b)[index] = (byte_t)(value >> 8);
+  (*b)[index + 1] = (byte_t)value;
+}
+
+void PutULong(ByteVector* b, size_t index, int64_t value) {
+  PutUShort(b, index, (int32_t)(value >> 16));
+  PutUShort(b, index + 2, (int32_t)value);
+}
+
+// Offsets of the component glyph id fields of the composite glyph in data.
+void ComponentIdOffsets(ReadableFontData* data, IntegerList* id_offsets) {
+  typedef GlyphTable::CompositeGlyph CompositeGlyph;
+  int32_t index = kGlyphHeaderSize;
+  while (index + 4 <= data->Length()) {
+    int32_t flags = data->ReadUShort(index);
+    id_offsets->push_back(index + 2);
+    index += 4;
+    index += (flags & CompositeGlyph::kFLAG_ARG_1_AND_2_ARE_WORDS) ? 4 : 2;
+    if (flags & CompositeGlyph::kFLAG_WE_HAVE_A_SCALE) {
+      index += 2;
+    } else if (flags & CompositeGlyph::kFLAG_WE_HAVE_AN_X_AND_Y_SCALE) {
+      index += 4;
+    } else if (flags & CompositeGlyph::kFLAG_WE_HAVE_A_TWO_BY_TWO) {
+      index += 8;
+    }
+    if (!(flags & CompositeGlyph::kFLAG_MORE_COMPONENTS)) {
+      break;
+    }
+  }
+}
+
+// The data of the glyph, or NULL for an empty or out of range glyph.
+CALLER_ATTACH ReadableFontData* GlyphData(LocaTable* loca,
+                                          ReadableFontData* glyf,
+                                          int32_t glyph_id) {
+  if (glyph_id < 0 || glyph_id >= loca->num_glyphs()) {
+    return NULL;
+  }
+  int32_t length = loca->GlyphLength(glyph_id);
+  if (length <= 0) {
+    return NULL;
+  }
+  return down_cast<ReadableFontData*>(
+      glyf->Slice(loca->GlyphOffset(glyph_id), length));
+}
+
+bool IsComposite(ReadableFontData* glyph) {
+  return glyph->Length() >= kGlyphHeaderSize && glyph->ReadShort(0) < 0;
+}
+
+int64_t Checksum(ByteVector* b) {
+  int64_t sum = 0;
+  for (size_t i = 0; i < b->size(); i += 4) {
+    int64_t value = 0;
+    for (size_t j = i; j < i + 4; ++j) {
+      value = (value << 8) | (j < b->size() ? (*b)[j] : 0);
+    }
+    sum += value;
+  }
+  return sum & 0xffffffff;
+}
+
+void CopyTableData(Table* table, ByteVector* b) {
+  ReadableFontDataPtr data = table->ReadFontData();
+  b->resize(data->Length());
+  if (!b->empty()) {
+    data->ReadBytes(0, &((*b)[0]), 0, b->size());
+  }
+}
+
+}  // namespace
+
 Subsetter::Subsetter(Font* font, FontFactory* font_factory) {
   font_ = font;
   font_factory_ = font_factory;
@@ -91,6 +181,187 @@ CALLER_ATTACH Font::Builder* Subsetter::Subset() {
   return font_builder.Detach();
 }
 
+bool Subsetter::Subset(OutputStream* os) {
+  assert(os);
+  if (new_to_old_glyphs_.empty()) {
+    return false;
+  }
+  GlyphTablePtr glyph_table = down_cast<GlyphTable*>(font_->GetTable(Tag::glyf));
+  LocaTablePtr loca_table = down_cast<LocaTable*>(font_->GetTable(Tag::loca));
+  if (glyph_table == NULL || loca_table == NULL) {
+    return false;
+  }
+  ReadableFontDataPtr glyf_data = glyph_table->ReadFontData();
+
+  // Close the glyph set over composite glyph components, remembering the new
+  // id of every old glyph on the way.
+  IntegerList new_to_old = new_to_old_glyphs_;
+  std::map<int32_t, int32_t> old_to_new;
+  for (size_t i = 0; i < new_to_old.size(); ++i) {
+    old_to_new.insert(std::make_pair(new_to_old[i], (int32_t)i));
+  }
+  for (size_t i = 0; i < new_to_old.size(); ++i) {
+    int32_t old_id = new_to_old[i];
+    std::map<int32_t, IntegerList>::iterator components =
+        glyph_components_.find(old_id);
+    if (components == glyph_components_.end()) {
+      IntegerList ids;
+      ReadableFontDataPtr glyph;
+      glyph.Attach(GlyphData(loca_table, glyf_data, old_id));
+      if (glyph != NULL && IsComposite(glyph)) {
+        IntegerList id_offsets;
+        ComponentIdOffsets(glyph, &id_offsets);
+        for (size_t j = 0; j < id_offsets.size(); ++j) {
+          ids.push_back(glyph->ReadUShort(id_offsets[j]));
+        }
+      }
+      components = glyph_components_.insert(std::make_pair(old_id, ids)).first;
+    }
+    for (IntegerList::iterator id = components->second.begin(),
+                               id_end = components->second.end();
+                               id != id_end; ++id) {
+      if (old_to_new.find(*id) == old_to_new.end()) {
+        old_to_new.insert(std::make_pair(*id, (int32_t)new_to_old.size()));
+        new_to_old.push_back(*id);
+      }
+    }
+  }
+  int32_t num_glyphs = (int32_t)new_to_old.size();
+
+  // Copy the glyph byte ranges, renumbering composite components.
+  std::map<int32_t, ByteVector> rewritten;
+  ByteVector& glyf = rewritten[Tag::glyf];
+  IntegerList loca;
+  for (int32_t new_id = 0; new_id < num_glyphs; ++new_id) {
+    loca.push_back((int32_t)glyf.size());
+    ReadableFontDataPtr glyph;
+    glyph.Attach(GlyphData(loca_table, glyf_data, new_to_old[new_id]));
+    if (glyph == NULL) {
+      continue;
+    }
+    size_t start = glyf.size();
+    glyf.resize(start + ((glyph->Length() + 3) & ~3));
+    glyph->ReadBytes(0, &(glyf[start]), 0, glyph->Length());
+    if (IsComposite(glyph)) {
+      IntegerList id_offsets;
+      ComponentIdOffsets(glyph, &id_offsets);
+      for (size_t j = 0; j < id_offsets.size(); ++j) {
+        int32_t old_id = glyph->ReadUShort(id_offsets[j]);
+        PutUShort(&glyf, start + id_offsets[j], old_to_new[old_id]);
+      }
+    }
+  }
+  loca.push_back((int32_t)glyf.size());
+
+  int32_t loca_format = (glyf.size() / 2 > 0xffff) ? 1 : 0;
+  ByteVector& loca_bytes = rewritten[Tag::loca];
+  loca_bytes.resize(loca.size() * (loca_format ? 4 : 2));
+  for (size_t i = 0; i < loca.size(); ++i) {
+    if (loca_format) {
+      PutULong(&loca_bytes, i * 4, loca[i]);
+    } else {
+      PutUShort(&loca_bytes, i * 2, loca[i] / 2);
+    }
+  }
+
+  Table* head = font_->GetTable(Tag::head);
+  if (head) {
+    CopyTableData(head, &rewritten[Tag::head]);
+    PutULong(&rewritten[Tag::head], kHeadCheckSumAdjustment, 0);
+    PutUShort(&rewritten[Tag::head], kHeadIndexToLocFormat, loca_format);
+  }
+  Table* maxp = font_->GetTable(Tag::maxp);
+  if (maxp) {
+    CopyTableData(maxp, &rewritten[Tag::maxp]);
+    PutUShort(&rewritten[Tag::maxp], kMaxpNumGlyphs, num_glyphs);
+  }
+  Table* hhea = font_->GetTable(Tag::hhea);
+  HorizontalMetricsTablePtr hmtx =
+      down_cast<HorizontalMetricsTable*>(font_->GetTable(Tag::hmtx));
+  if (hhea && hmtx) {
+    // Every glyph gets a full metric; trailing runs are not worth detecting.
+    CopyTableData(hhea, &rewritten[Tag::hhea]);
+    PutUShort(&rewritten[Tag::hhea], kHheaNumberOfHMetrics, num_glyphs);
+    ByteVector& metrics = rewritten[Tag::hmtx];
+    metrics.resize(num_glyphs * 4);
+    for (int32_t new_id = 0; new_id < num_glyphs; ++new_id) {
+      PutUShort(&metrics, new_id * 4, hmtx->AdvanceWidth(new_to_old[new_id]));
+      PutUShort(&metrics, new_id * 4 + 2,
+                hmtx->LeftSideBearing(new_to_old[new_id]));
+    }
+  }
+
+  // Lay out the table directory. Tables keep their directory order.
+  IntegerSet table_tags;
+  for (TableMap::const_iterator i = font_->GetTableMap()->begin(),
+                                e = font_->GetTableMap()->end(); i != e; ++i) {
+    if (remove_tables_.find(i->first) == remove_tables_.end() &&
+        i->first != Tag::hdmx && i->first != Tag::LTSH) {
+      table_tags.insert(i->first);
+    }
+  }
+  int32_t num_tables = (int32_t)table_tags.size();
+  ByteVector directory(kSfntHeaderSize + num_tables * kTableRecordSize);
+  int32_t log2_of_max_power_of_2 = FontMath::Log2(num_tables);
+  int32_t search_range = 2 << (log2_of_max_power_of_2 - 1 + 4);
+  PutULong(&directory, 0, font_->sfnt_version());
+  PutUShort(&directory, 4, num_tables);
+  PutUShort(&directory, 6, search_range);
+  PutUShort(&directory, 8, log2_of_max_power_of_2);
+  PutUShort(&directory, 10, num_tables * 16 - search_range);
+
+  int64_t font_checksum = 0;
+  int32_t table_offset = (int32_t)directory.size();
+  size_t record = kSfntHeaderSize;
+  for (IntegerSet::iterator tag = table_tags.begin(),
+                            tag_end = table_tags.end();
+                            tag != tag_end; ++tag, record += kTableRecordSize) {
+    std::map<int32_t, ByteVector>::iterator data = rewritten.find(*tag);
+    int64_t checksum;
+    int32_t length;
+    if (data != rewritten.end()) {
+      checksum = Checksum(&data->second);
+      length = (int32_t)data->second.size();
+    } else {
+      Table* table = font_->GetTable(*tag);
+      checksum = table->header()->checksum_valid() ?
+                 table->header()->checksum() : table->CalculatedChecksum();
+      length = table->DataLength();
+    }
+    PutULong(&directory, record, *tag);
+    PutULong(&directory, record + 4, checksum);
+    PutULong(&directory, record + 8, table_offset);
+    PutULong(&directory, record + 12, length);
+    font_checksum += checksum;
+    table_offset += (length + 3) & ~3;
+  }
+  font_checksum += Checksum(&directory);
+  if (head) {
+    PutULong(&rewritten[Tag::head], kHeadCheckSumAdjustment,
+             (kChecksumAdjustmentMagic - font_checksum) & 0xffffffff);
+  }
+
+  // Stream everything out.
+  os->Write(&directory);
+  byte_t padding[3] = { 0, 0, 0 };
+  for (IntegerSet::iterator tag = table_tags.begin(),
+                            tag_end = table_tags.end();
+                            tag != tag_end; ++tag) {
+    std::map<int32_t, ByteVector>::iterator data = rewritten.find(*tag);
+    int32_t length;
+    if (data != rewritten.end()) {
+      length = (int32_t)data->second.size();
+      if (length) {
+        os->Write(&(data->second[0]), 0, length);
+      }
+    } else {
+      length = font_->GetTable(*tag)->ReadFontData()->CopyTo(os);
+    }
+    os->Write(padding, 0, ((length + 3) & ~3) - length);
+  }
+  return true;
+}
+
 IntegerList* Subsetter::GlyphPermutationTable() {
   return &new_to_old_glyphs_;
 }
@@ -17,6 +17,7 @@
 #ifndef SFNTLY_CPP_SRC_SFNTLY_TOOLS_SUBSETTER_SUBSETTER_H_
 #define SFNTLY_CPP_SRC_SFNTLY_TOOLS_SUBSETTER_SUBSETTER_H_
 
+#include <map>
 #include <vector>
 
 #include "sfntly/font.h"
@@ -26,6 +27,9 @@
 
 namespace sfntly {
 
+// A Subsetter holds the state of one subsetting request and is not thread
+// safe. The Font it subsets is only read, so many Subsetters on different
+// threads may share one loaded Font.
 class Subsetter : public RefCounted<Subsetter> {
  public:
   Subsetter(Font* font, FontFactory* font_factory);
@@ -53,6 +57,16 @@ class Subsetter : public RefCounted<Subsetter> {
 
   virtual void SetRemoveTables(IntegerSet* remove_tables);
   virtual CALLER_ATTACH Font::Builder* Subset();
+
+  // Subset the font straight into its serialized form on os, bypassing the
+  // table builders. Composite glyphs pull in the glyphs they are made of; those
+  // are appended after the requested glyphs and the composites are renumbered
+  // to match. glyf, loca, hmtx, hhea, maxp and head are rewritten for the new
+  // glyph set, hdmx and LTSH are dropped, and every other table is copied byte
+  // for byte like Subset() does.
+  // @return false if no glyphs were set or the font has no glyf/loca tables
+  virtual bool Subset(OutputStream* os);
+
   virtual IntegerList* GlyphPermutationTable();
   virtual CMapIdList* CMapId();
 
@@ -65,6 +79,11 @@ class Subsetter : public RefCounted<Subsetter> {
   IntegerSet remove_tables_;
   IntegerList new_to_old_glyphs_;
   CMapIdList cmap_ids_;
+
+  // Component glyph ids of every glyph Subset(OutputStream*) has looked at,
+  // empty for simple glyphs. Kept so that repeated subsets of the same font
+  // parse each composite only once.
+  std::map<int32_t, IntegerList> glyph_components_;
 };
 
 }  // namespace sfntly
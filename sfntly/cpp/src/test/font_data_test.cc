@@ -325,12 +325,69 @@ bool TestWritableFontData() {
   return true;
 }
 
+// Compare the in-place multi-byte readers and the checksum against values
+// assembled a byte at a time, on slices at every alignment.
+bool TestReadableFontDataSpans() {
+  for (size_t i = 0; i < sizeof(BYTE_ARRAY_SIZES) / sizeof(int32_t); ++i) {
+    int32_t size = BYTE_ARRAY_SIZES[i];
+    ByteArrayPtr ba = new MemoryByteArray(size);
+    for (int32_t j = 0; j < size; ++j) {
+      ba->Put(j, (byte_t)(j * 37 + 11));
+    }
+    ReadableFontDataPtr rfd = new ReadableFontData(ba);
+    for (int32_t trim = 0; trim < std::min<int32_t>(size, 4); ++trim) {
+      ReadableFontDataPtr slice;
+      slice.Attach(down_cast<ReadableFontData*>(rfd->Slice(trim)));
+      int32_t length = slice->Length();
+      EXPECT_TRUE(slice->ReadSpan(0, length) != NULL);
+      EXPECT_TRUE(slice->ReadSpan(0, length + 1) == NULL);
+      EXPECT_TRUE(slice->ReadSpan(-1, 1) == NULL);
+
+      int64_t checksum = 0;
+      for (int32_t j = 0; j < length; ++j) {
+        int32_t b0 = slice->ReadUByte(j);
+        int32_t b1 = (j + 1 < length) ? slice->ReadUByte(j + 1) : 0;
+        int32_t b2 = (j + 2 < length) ? slice->ReadUByte(j + 2) : 0;
+        int32_t b3 = (j + 3 < length) ? slice->ReadUByte(j + 3) : 0;
+        if (j % 4 == 0) {
+          checksum += (int64_t)b0 << 24 | b1 << 16 | b2 << 8 | b3;
+        }
+        if (j + 2 <= length) {
+          EXPECT_EQ(b0 << 8 | b1, slice->ReadUShort(j));
+          EXPECT_EQ((int16_t)(b0 << 8 | b1), slice->ReadShort(j));
+        }
+        if (j + 3 <= length) {
+          EXPECT_EQ(b0 << 16 | b1 << 8 | b2, slice->ReadUInt24(j));
+        }
+        if (j + 4 <= length) {
+          EXPECT_EQ((int64_t)b0 << 24 | b1 << 16 | b2 << 8 | b3,
+                    slice->ReadULong(j));
+          EXPECT_EQ((int32_t)((uint32_t)b0 << 24 | b1 << 16 | b2 << 8 | b3),
+                    slice->ReadLong(j));
+        }
+      }
+      EXPECT_EQ(checksum & 0xffffffffL, slice->Checksum());
+
+      ByteArrayPtr copy = new MemoryByteArray(length);
+      EXPECT_EQ(length, slice->CopyTo(copy));
+      for (int32_t j = 0; j < length; ++j) {
+        EXPECT_EQ(slice->ReadUByte(j), copy->Get(j));
+      }
+    }
+  }
+  return true;
+}
+
 }  // namespace sfntly
 
 TEST(FontData, ReadableFontDataSearching) {
   ASSERT_TRUE(sfntly::TestReadableFontDataSearching());
 }
 
+TEST(FontData, ReadableFontDataSpans) {
+  ASSERT_TRUE(sfntly::TestReadableFontDataSpans());
+}
+
 TEST(FontData, All) {
   ASSERT_TRUE(sfntly::TestReadableFontData());
   ASSERT_TRUE(sfntly::TestWritableFontData());
@@ -0,0 +1,178 @@
+/*
+ * Copyright 2011 Google Inc. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+#include "sfntly/data/mapped_byte_array.h"
+#include "sfntly/font.h"
+#include "sfntly/font_factory.h"
+#include "sfntly/port/memory_output_stream.h"
+#include "sfntly/table/core/maximum_profile_table.h"
+#include "sfntly/table/truetype/loca_table.h"
+#include "sfntly/tag.h"
+#include "test/platform_thread.h"
+#include "test/test_data.h"
+#include "test/test_font_utils.h"
+
+namespace sfntly {
+
+bool TestMappedLazyLoading() {
+  FontFactoryPtr factory;
+  factory.Attach(FontFactory::GetInstance());
+  FontArray eager_fonts;
+  LoadFont(SAMPLE_TTF_FILE, factory, &eager_fonts);
+  EXPECT_EQ(eager_fonts.size(), static_cast<size_t>(1));
+  FontPtr eager = eager_fonts[0];
+
+  MappedByteArrayPtr mapped = new MappedByteArray();
+  EXPECT_TRUE(mapped->Open(SAMPLE_TTF_FILE));
+  FontFactoryPtr lazy_factory;
+  lazy_factory.Attach(FontFactory::GetInstance());
+  lazy_factory->LazyTableParsing(true);
+  FontArray lazy_fonts;
+  lazy_factory->LoadFonts(mapped, &lazy_fonts);
+  EXPECT_EQ(lazy_fonts.size(), static_cast<size_t>(1));
+  FontPtr lazy = lazy_fonts[0];
+
+  EXPECT_EQ(lazy->num_tables(), eager->num_tables());
+  EXPECT_FALSE(lazy->HasTable(Tag::CFF));
+  EXPECT_EQ(lazy->GetTable(Tag::CFF), static_cast<Table*>(NULL));
+
+  // loca depends on head and maxp, which are still unparsed at this point.
+  LocaTablePtr lazy_loca = down_cast<LocaTable*>(lazy->GetTable(Tag::loca));
+  LocaTablePtr eager_loca = down_cast<LocaTable*>(eager->GetTable(Tag::loca));
+  EXPECT_TRUE(lazy_loca != NULL);
+  EXPECT_EQ(lazy_loca->num_glyphs(), eager_loca->num_glyphs());
+  EXPECT_EQ(lazy_loca->format_version(), eager_loca->format_version());
+  for (int32_t glyph = 0; glyph < eager_loca->num_glyphs(); ++glyph) {
+    EXPECT_EQ(lazy_loca->GlyphOffset(glyph), eager_loca->GlyphOffset(glyph));
+  }
+  EXPECT_EQ(lazy->GetTable(Tag::loca), static_cast<Table*>(lazy_loca));
+
+  const TableMap* eager_tables = eager->GetTableMap();
+  for (TableMap::const_iterator table = eager_tables->begin(),
+                                end = eager_tables->end();
+                                table != end; ++table) {
+    Table* lazy_table = lazy->GetTable(table->first);
+    EXPECT_TRUE(lazy_table != NULL);
+    if (lazy_table == NULL) {
+      continue;
+    }
+    EXPECT_EQ(lazy_table->DataLength(), table->second->DataLength());
+    EXPECT_EQ(lazy_table->CalculatedChecksum(),
+              table->second->CalculatedChecksum());
+  }
+
+  MemoryOutputStream eager_output;
+  factory->SerializeFont(eager, &eager_output);
+  MemoryOutputStream lazy_output;
+  lazy_factory->SerializeFont(lazy, &lazy_output);
+  EXPECT_EQ(lazy_output.Size(), eager_output.Size());
+  EXPECT_EQ(memcmp(lazy_output.Get(), eager_output.Get(), eager_output.Size()),
+            0);
+
+  return true;
+}
+
+// Reads every table of one shared lazily loaded font, so that the threads race
+// to parse tables and compute their checksums.
+class SharedFontReaderThread : public PlatformThread::Delegate {
+ public:
+  explicit SharedFontReaderThread(Font* font) : font_(font), checksum_(0) {}
+
+  virtual void ThreadMain() {
+    LocaTablePtr loca = down_cast<LocaTable*>(font_->GetTable(Tag::loca));
+    if (loca != NULL) {
+      checksum_ += loca->num_glyphs();
+    }
+    for (IntegerList::const_iterator tag = tags_.begin(), end = tags_.end();
+         tag != end; ++tag) {
+      Table* table = font_->GetTable(*tag);
+      if (table != NULL) {
+        checksum_ += table->CalculatedChecksum();
+      }
+    }
+  }
+
+  int64_t checksum() const { return checksum_; }
+  IntegerList* tags() { return &tags_; }
+
+ private:
+  FontPtr font_;
+  IntegerList tags_;
+  int64_t checksum_;
+
+  NO_COPY_AND_ASSIGN(SharedFontReaderThread);
+};
+
+bool TestConcurrentLazyReads() {
+  FontFactoryPtr factory;
+  factory.Attach(FontFactory::GetInstance());
+  FontArray eager_fonts;
+  LoadFont(SAMPLE_TTF_FILE, factory, &eager_fonts);
+  FontPtr eager = eager_fonts[0];
+  IntegerList tags;
+  int64_t expected = down_cast<LocaTable*>(
+      eager->GetTable(Tag::loca))->num_glyphs();
+  const TableMap* eager_tables = eager->GetTableMap();
+  for (TableMap::const_iterator table = eager_tables->begin(),
+                                end = eager_tables->end();
+                                table != end; ++table) {
+    tags.push_back(table->first);
+    expected += table->second->CalculatedChecksum();
+  }
+
+  MappedByteArrayPtr mapped = new MappedByteArray();
+  EXPECT_TRUE(mapped->Open(SAMPLE_TTF_FILE));
+  FontFactoryPtr lazy_factory;
+  lazy_factory.Attach(FontFactory::GetInstance());
+  lazy_factory->LazyTableParsing(true);
+  FontArray lazy_fonts;
+  lazy_factory->LoadFonts(mapped, &lazy_fonts);
+  FontPtr lazy = lazy_fonts[0];
+
+  const size_t kThreads = 4;
+  SharedFontReaderThread* threads[kThreads];
+  PlatformThreadHandle handles[kThreads];
+  for (size_t i = 0; i < kThreads; ++i) {
+    threads[i] = new SharedFontReaderThread(lazy);
+    // Each thread walks the tables in a different order.
+    threads[i]->tags()->assign(tags.begin(), tags.end());
+    std::rotate(threads[i]->tags()->begin(),
+                threads[i]->tags()->begin() + i * tags.size() / kThreads,
+                threads[i]->tags()->end());
+    handles[i] = kNullThreadHandle;
+    EXPECT_TRUE(PlatformThread::Create(threads[i], &handles[i]));
+  }
+  for (size_t i = 0; i < kThreads; ++i) {
+    PlatformThread::Join(handles[i]);
+    EXPECT_EQ(expected, threads[i]->checksum());
+    delete threads[i];
+  }
+  return true;
+}
+
+}  // namespace sfntly
+
+TEST(LazyFontLoading, All) {
+  ASSERT_TRUE(sfntly::TestMappedLazyLoading());
+}
+
+TEST(LazyFontLoading, ConcurrentReads) {
+  ASSERT_TRUE(sfntly::TestConcurrentLazyReads());
+}
@@ -228,6 +228,74 @@ bool MutexFourThreads() {
   return true;
 }
 
+// Tests that readers share a ReadWriteLock and writers exclude ---------------
+
+class ReadWriteLockTestThread : public PlatformThread::Delegate {
+ public:
+  ReadWriteLockTestThread(ReadWriteLock* lock, int* value)
+      : lock_(lock), value_(value), mismatches_(0) {}
+
+  // Static helper which can also be called from the main thread.
+  static int DoStuff(ReadWriteLock* lock, int* value) {
+    int mismatches = 0;
+    for (int i = 0; i < 40; i++) {
+      if (i % 4 == 0) {
+        AutoWriteLock write(*lock);
+        int v = *value;
+        PlatformThread::Sleep(rand() % 5);
+        *value = v + 1;
+      } else {
+        AutoReadLock read(*lock);
+        int v = *value;
+        PlatformThread::Sleep(rand() % 5);
+        if (*value != v)
+          mismatches++;
+      }
+    }
+    return mismatches;
+  }
+
+  virtual void ThreadMain() {
+    mismatches_ = DoStuff(lock_, value_);
+  }
+
+  int mismatches() const { return mismatches_; }
+
+ private:
+  ReadWriteLock* lock_;
+  int* value_;
+  int mismatches_;
+
+  NO_COPY_AND_ASSIGN(ReadWriteLockTestThread);
+};
+
+bool ReadWriteFourThreads() {
+  ReadWriteLock lock;
+  int value = 0;
+
+  ReadWriteLockTestThread thread1(&lock, &value);
+  ReadWriteLockTestThread thread2(&lock, &value);
+  ReadWriteLockTestThread thread3(&lock, &value);
+  PlatformThreadHandle handle1 = kNullThreadHandle;
+  PlatformThreadHandle handle2 = kNullThreadHandle;
+  PlatformThreadHandle handle3 = kNullThreadHandle;
+
+  EXPECT_TRUE(PlatformThread::Create(&thread1, &handle1));
+  EXPECT_TRUE(PlatformThread::Create(&thread2, &handle2));
+  EXPECT_TRUE(PlatformThread::Create(&thread3, &handle3));
+
+  int mismatches = ReadWriteLockTestThread::DoStuff(&lock, &value);
+
+  PlatformThread::Join(handle1);
+  PlatformThread::Join(handle2);
+  PlatformThread::Join(handle3);
+
+  EXPECT_EQ(4 * 10, value);
+  EXPECT_EQ(0, mismatches + thread1.mismatches() + thread2.mismatches() +
+               thread3.mismatches());
+  return true;
+}
+
 }  // namespace sfntly
 
 TEST(LockTest, Basic) {
@@ -242,3 +310,7 @@ TEST(LockTest, Mutex) {
   ASSERT_TRUE(sfntly::MutexTwoThreads());
   ASSERT_TRUE(sfntly::MutexFourThreads());
 }
+
+TEST(LockTest, ReadWrite) {
+  ASSERT_TRUE(sfntly::ReadWriteFourThreads());
+}
@@ -111,6 +111,12 @@ public:
      */
     virtual bool isVisual() { return false; }
 
+    /*
+     * Non-rendering benches whose draw() may be called from several threads at once advertise
+     * it here, so nanobench --benchThreads can measure how they scale under contention.
+     */
+    virtual bool isThreadSafe() const { return false; }
+
     /*
      * VisualBench frequently resets the canvas.  As a result we need to bulk call all of the hooks
      */
@@ -12,13 +12,15 @@
 
 BitmapRegionDecoderBench::BitmapRegionDecoderBench(const char* baseName, SkData* encoded,
         SkBitmapRegionDecoder::Strategy strategy, SkColorType colorType,
-        uint32_t sampleSize, const SkIRect& subset)
+        uint32_t sampleSize, const SkIRect& subset, int panSteps)
     : fBRD(nullptr)
     , fData(SkRef(encoded))
     , fStrategy(strategy)
     , fColorType(colorType)
     , fSampleSize(sampleSize)
     , fSubset(subset)
+    , fPanSteps(panSteps)
+    , fPanPosition(0)
 {
     // Choose a useful name for the region decoding strategy
     const char* strategyName;
@@ -29,6 +31,9 @@ BitmapRegionDecoderBench::BitmapRegionDecoderBench(const char* baseName, SkData*
         case SkBitmapRegionDecoder::kAndroidCodec_Strategy:
             strategyName = "AndroidCodec";
             break;
+        case SkBitmapRegionDecoder::kTileCache_Strategy:
+            strategyName = "TileCache";
+            break;
         default:
             SkASSERT(false);
             strategyName = "";
@@ -54,11 +59,20 @@ bool BitmapRegionDecoderBench::isSuitableFor(Backend backend) {
 
 void BitmapRegionDecoderBench::onDelayedSetup() {
     fBRD.reset(SkBitmapRegionDecoder::Create(fData, fStrategy));
+    fPanPosition = 0;
 }
 
 void BitmapRegionDecoderBench::onDraw(int n, SkCanvas* canvas) {
     for (int i = 0; i < n; i++) {
+        SkIRect subset = fSubset;
+        if (fPanSteps > 0) {
+            // Pan right until the subset reaches the edge of the image, then start over.
+            const int step = SkTMax(1, fSubset.width() / fPanSteps);
+            const int range = fBRD->width() - fSubset.width() - fSubset.left();
+            subset.offset(range > 0 ? (fPanPosition * step) % range : 0, 0);
+            fPanPosition++;
+        }
         SkBitmap bm;
-        SkAssertResult(fBRD->decodeRegion(&bm, nullptr, fSubset, fSampleSize, fColorType, false));
+        SkAssertResult(fBRD->decodeRegion(&bm, nullptr, subset, fSampleSize, fColorType, false));
     }
 }
@@ -20,6 +20,10 @@
  *
  *  fStrategy determines which of various implementations is to be used.
  *
+ *  If fPanSteps is non-zero, each iteration moves the subset right by 1/fPanSteps of its width,
+ *  wrapping back to the left edge.  This models a user panning across a large image, where an
+ *  implementation that caches decoded tiles only needs to decode the newly exposed columns.
+ *
  *  nanobench.cpp handles creating benchmarks for interesting scaled subsets.  We strive to test
  *  on real use cases.
  */
@@ -28,7 +32,7 @@ public:
     // Calls encoded->ref()
     BitmapRegionDecoderBench(const char* basename, SkData* encoded,
             SkBitmapRegionDecoder::Strategy strategy, SkColorType colorType,
-            uint32_t sampleSize, const SkIRect& subset);
+            uint32_t sampleSize, const SkIRect& subset, int panSteps = 0);
 
 protected:
     const char* onGetName() override;
@@ -44,6 +48,8 @@ private:
     const SkColorType                              fColorType;
     const uint32_t                                 fSampleSize;
     const SkIRect                                  fSubset;
+    const int                                      fPanSteps;
+    int                                            fPanPosition;
     typedef Benchmark INHERITED;
 };
 #endif // BitmapRegionDecoderBench_DEFINED
@@ -10,6 +10,7 @@
 #include "SkBlurMaskFilter.h"
 #include "SkCanvas.h"
 #include "SkPaint.h"
+#include "SkPath.h"
 #include "SkRandom.h"
 #include "SkShader.h"
 #include "SkString.h"
@@ -31,13 +32,18 @@ class BlurBench : public Benchmark {
     SkScalar    fRadius;
     SkBlurStyle fStyle;
     uint32_t    fFlags;
+    bool        fRepeated;
+    SkPath      fPath;
     SkString    fName;
 
 public:
-    BlurBench(SkScalar rad, SkBlurStyle bs, uint32_t flags = 0) {
+    // When repeated is set, every draw is the same path at a different whole-pixel offset, so
+    // all but the first should find their blurred mask in the cache.
+    BlurBench(SkScalar rad, SkBlurStyle bs, uint32_t flags = 0, bool repeated = false) {
         fRadius = rad;
         fStyle = bs;
         fFlags = flags;
+        fRepeated = repeated;
         const char* name = rad > 0 ? gStyleName[bs] : "none";
         const char* quality = flags & SkBlurMaskFilter::kHighQuality_BlurFlag ? "high_quality"
                                                                               : "low_quality";
@@ -46,6 +52,15 @@ public:
         } else {
             fName.printf("blur_%d_%s_%s", SkScalarRoundToInt(rad), name, quality);
         }
+        if (repeated) {
+            fName.append("_repeated");
+            // An oval would take the round rect path, so use a shape that only filterPath handles.
+            fPath.moveTo(50, 0);
+            fPath.quadTo(100, 0, 100, 50);
+            fPath.lineTo(50, 100);
+            fPath.cubicTo(20, 100, 0, 80, 0, 50);
+            fPath.close();
+        }
     }
 
 protected:
@@ -71,7 +86,15 @@ protected:
                                             fFlags);
                 paint.setMaskFilter(mf)->unref();
             }
-            canvas->drawOval(r, paint);
+            if (fRepeated) {
+                canvas->save();
+                canvas->translate(SkIntToScalar(rand.nextULessThan(300)) + fRadius,
+                                  SkIntToScalar(rand.nextULessThan(300)) + fRadius);
+                canvas->drawPath(fPath, paint);
+                canvas->restore();
+            } else {
+                canvas->drawOval(r, paint);
+            }
         }
     }
 
@@ -114,4 +137,9 @@ DEF_BENCH(return new BlurBench(REALBIG, kNormal_SkBlurStyle, SkBlurMaskFilter::k
 
 DEF_BENCH(return new BlurBench(REAL, kNormal_SkBlurStyle, SkBlurMaskFilter::kHighQuality_BlurFlag);)
 
+DEF_BENCH(return new BlurBench(BIG, kNormal_SkBlurStyle, 0, true);)
+DEF_BENCH(return new BlurBench(REALBIG, kNormal_SkBlurStyle, 0, true);)
+DEF_BENCH(return new BlurBench(BIG, kNormal_SkBlurStyle, SkBlurMaskFilter::kHighQuality_BlurFlag,
+                               true);)
+
 DEF_BENCH(return new BlurBench(0, kNormal_SkBlurStyle);)
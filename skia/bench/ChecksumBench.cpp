@@ -35,6 +35,7 @@ public:
     bool isSuitableFor(Backend backend) override {
         return backend == kNonRendering_Backend;
     }
+    bool isThreadSafe() const override { return true; }
 
 protected:
     const char* onGetName() override {
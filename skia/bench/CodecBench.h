@@ -16,11 +16,15 @@
 
 /**
  *  Time SkCodec.
+ *
+ *  If parallel is true, decodes with SkCodec::Options::fParallelDecode.  The speedup is the
+ *  ratio of the time of the matching serial bench to the time of this one.
  */
 class CodecBench : public Benchmark {
 public:
     // Calls encoded->ref()
-    CodecBench(SkString basename, SkData* encoded, SkColorType colorType, SkAlphaType alphaType);
+    CodecBench(SkString basename, SkData* encoded, SkColorType colorType, SkAlphaType alphaType,
+               bool parallel = false);
 
 protected:
     const char* onGetName() override;
@@ -32,6 +36,7 @@ private:
     SkString                fName;
     const SkColorType       fColorType;
     const SkAlphaType       fAlphaType;
+    const bool              fParallel;
     SkAutoTUnref<SkData>    fData;
     SkImageInfo             fInfo;          // Set in onDelayedSetup.
     SkAutoMalloc            fPixelStorage;
@@ -6,11 +6,15 @@
  */
 
 #include "Benchmark.h"
+#include "ProcStats.h"
 #include "Resources.h"
+#include "SkCanvas.h"
 #include "SkData.h"
+#include "SkDocument.h"
 #include "SkImage.h"
 #include "SkPDFBitmap.h"
 #include "SkPixmap.h"
+#include "SkRandom.h"
 
 namespace {
 struct NullWStream : public SkWStream {
@@ -145,7 +149,60 @@ private:
     SkAutoTDelete<SkStreamAsset> fAsset;
 };
 
+/** Writes a many page document, each page with its own image and some
+    text, and reports how far the resident set grew while doing so. */
+class PDFDocumentBench : public Benchmark {
+public:
+    PDFDocumentBench(bool streaming) : fStreaming(streaming), fPeakGrowthMB(0) {
+        fName.printf("PDFDocument_%dpages%s", kPages, streaming ? "_streaming" : "");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setTextSize(12);
+        const char text[] = "The quick brown fox jumps over the lazy dog.";
+        SkRandom rand;
+        while (loops-- > 0) {
+            NullWStream stream;
+            SkAutoTUnref<SkDocument> doc(fStreaming ? SkDocument::CreateStreamingPDF(&stream)
+                                                    : SkDocument::CreatePDF(&stream));
+            const int startMB = sk_tools::getCurrResidentSetSizeMB();
+            for (int i = 0; i < kPages; ++i) {
+                SkBitmap bm;
+                bm.allocN32Pixels(128, 128);
+                bm.eraseColor(rand.nextU() | 0xFF000000);
+                SkCanvas* canvas = doc->beginPage(612, 792);
+                canvas->drawBitmap(bm, 72, 72);
+                for (int line = 0; line < 40; ++line) {
+                    canvas->drawText(text, strlen(text), 72, 240 + 12 * line, paint);
+                }
+                doc->endPage();
+                fPeakGrowthMB = SkTMax(fPeakGrowthMB,
+                                       sk_tools::getCurrResidentSetSizeMB() - startMB);
+            }
+            doc->close();
+        }
+    }
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        SkDebugf("%s: resident set grew by up to %d MB\n", fName.c_str(), fPeakGrowthMB);
+    }
+
+private:
+    enum { kPages = 500 };
+    SkString fName;
+    bool fStreaming;
+    int fPeakGrowthMB;
+};
+
 }  // namespace
 DEF_BENCH(return new PDFImageBench;)
 DEF_BENCH(return new PDFJpegImageBench;)
 DEF_BENCH(return new PDFCompressionBench;)
+DEF_BENCH(return new PDFDocumentBench(false);)
+DEF_BENCH(return new PDFDocumentBench(true);)
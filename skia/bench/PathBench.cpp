@@ -12,19 +12,25 @@
 #include "SkPaint.h"
 #include "SkPath.h"
 #include "SkRandom.h"
+#include "SkScan.h"
 #include "SkShader.h"
 #include "SkString.h"
 #include "SkTArray.h"
 
 enum Flags {
-    kStroke_Flag = 1 << 0,
-    kBig_Flag    = 1 << 1
+    kStroke_Flag     = 1 << 0,
+    kBig_Flag        = 1 << 1,
+    kAnalyticAA_Flag = 1 << 2,  // rasterize with gSkUseAnalyticAA instead of supersampling
 };
 
 #define FLAGS00  Flags(0)
 #define FLAGS01  Flags(kStroke_Flag)
 #define FLAGS10  Flags(kBig_Flag)
 #define FLAGS11  Flags(kStroke_Flag | kBig_Flag)
+#define FLAGSA00 Flags(kAnalyticAA_Flag)
+#define FLAGSA01 Flags(kAnalyticAA_Flag | kStroke_Flag)
+#define FLAGSA10 Flags(kAnalyticAA_Flag | kBig_Flag)
+#define FLAGSA11 Flags(kAnalyticAA_Flag | kStroke_Flag | kBig_Flag)
 
 class PathBench : public Benchmark {
     SkPaint     fPaint;
@@ -44,7 +50,8 @@ public:
 
 protected:
     const char* onGetName() override {
-        fName.printf("path_%s_%s_",
+        fName.printf("path_%s%s_%s_",
+                     fFlags & kAnalyticAA_Flag ? "analytic_" : "",
                      fFlags & kStroke_Flag ? "stroke" : "fill",
                      fFlags & kBig_Flag ? "big" : "small");
         this->appendName(&fName);
@@ -68,9 +75,12 @@ protected:
         }
         count >>= (3 * complexity());
 
+        const bool useAnalyticAA = gSkUseAnalyticAA;
+        gSkUseAnalyticAA = SkToBool(fFlags & kAnalyticAA_Flag);
         for (int i = 0; i < count; i++) {
             canvas->drawPath(path, paint);
         }
+        gSkUseAnalyticAA = useAnalyticAA;
     }
 
 private:
@@ -1021,6 +1031,22 @@ DEF_BENCH( return new LongCurvedPathBench(FLAGS01); )
 DEF_BENCH( return new LongLinePathBench(FLAGS00); )
 DEF_BENCH( return new LongLinePathBench(FLAGS01); )
 
+// The same fills and strokes, rasterized analytically, to compare against supersampling.
+DEF_BENCH( return new TrianglePathBench(FLAGSA00); )
+DEF_BENCH( return new TrianglePathBench(FLAGSA10); )
+DEF_BENCH( return new OvalPathBench(FLAGSA00); )
+DEF_BENCH( return new OvalPathBench(FLAGSA01); )
+DEF_BENCH( return new OvalPathBench(FLAGSA10); )
+DEF_BENCH( return new OvalPathBench(FLAGSA11); )
+DEF_BENCH( return new CirclePathBench(FLAGSA00); )
+DEF_BENCH( return new CirclePathBench(FLAGSA10); )
+DEF_BENCH( return new SawToothPathBench(FLAGSA00); )
+DEF_BENCH( return new SawToothPathBench(FLAGSA01); )
+DEF_BENCH( return new LongCurvedPathBench(FLAGSA00); )
+DEF_BENCH( return new LongCurvedPathBench(FLAGSA01); )
+DEF_BENCH( return new LongLinePathBench(FLAGSA00); )
+DEF_BENCH( return new LongLinePathBench(FLAGSA01); )
+
 DEF_BENCH( return new PathCreateBench(); )
 DEF_BENCH( return new PathCopyBench(); )
 DEF_BENCH( return new PathTransformBench(true); )
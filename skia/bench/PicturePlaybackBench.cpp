@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 #include "Benchmark.h"
+#include "RecordingBench.h"
 #include "SkCanvas.h"
 #include "SkColor.h"
 #include "SkPaint.h"
@@ -12,6 +13,7 @@
 #include "SkPictureRecorder.h"
 #include "SkPoint.h"
 #include "SkRandom.h"
+#include "SkRecordOpts.h"
 #include "SkRect.h"
 #include "SkString.h"
 
@@ -37,6 +39,18 @@ protected:
         return fName.c_str();
     }
 
+    void onDelayedSetup() override {
+        SkPictureRecorder recorder;
+        this->recordCanvas(recorder.beginRecording(PICTURE_WIDTH, PICTURE_HEIGHT, nullptr, 0));
+        SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+        SkDebugf("%s: %d ops, %d after SkRecordOptimize, %d after SkRecordOptimize2\n",
+                 fName.c_str(),
+                 RecordingBench::CountOps(picture, nullptr),
+                 RecordingBench::CountOps(picture, SkRecordOptimize),
+                 RecordingBench::CountOps(picture, SkRecordOptimize2));
+    }
+
     virtual void onDraw(int loops, SkCanvas* canvas) {
 
         SkPictureRecorder recorder;
@@ -135,11 +149,42 @@ private:
 };
 
 
+// Rows of cells, each clipped on its own and drawn with the same paint, all under an opaque
+// footer.  This gives SkRecordOpts something to batch, merge, and cull.
+class RectPlaybackBench : public PicturePlaybackBench {
+public:
+    RectPlaybackBench() : INHERITED("drawRect") { }
+protected:
+    void recordCanvas(SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setColor(SK_ColorBLUE);
+
+        const SkRect clip = SkRect::MakeWH(fPictureWidth, fPictureHeight);
+        for (SkScalar y = 0; y < fPictureHeight; y += fTextSize) {
+            for (SkScalar x = 0; x < fPictureWidth; x += fTextSize) {
+                canvas->save();
+                canvas->clipRect(clip);
+                canvas->drawRect(SkRect::MakeXYWH(x + 1, y + 1, fTextSize - 2, fTextSize - 2),
+                                 paint);
+                canvas->restore();
+            }
+        }
+
+        SkPaint footer;
+        footer.setColor(SK_ColorWHITE);
+        canvas->drawRect(SkRect::MakeXYWH(0, fPictureHeight / 2, fPictureWidth, fPictureHeight),
+                         footer);
+    }
+private:
+    typedef PicturePlaybackBench INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new TextPlaybackBench(); )
 DEF_BENCH( return new PosTextPlaybackBench(true); )
 DEF_BENCH( return new PosTextPlaybackBench(false); )
+DEF_BENCH( return new RectPlaybackBench(); )
 
 // Chrome draws into small tiles with impl-side painting.
 // This benchmark measures the relative performance of our bounding-box hierarchies,
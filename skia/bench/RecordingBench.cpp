@@ -9,12 +9,24 @@
 
 #include "SkBBHFactory.h"
 #include "SkPictureRecorder.h"
+#include "SkRecord.h"
+#include "SkRecorder.h"
 
 RecordingBench::RecordingBench(const char* name, const SkPicture* pic, bool useBBH)
     : fSrc(SkRef(pic))
     , fName(name)
     , fUseBBH(useBBH) {}
 
+int RecordingBench::CountOps(const SkPicture* pic, void (*optimize)(SkRecord*)) {
+    SkRecord record;
+    SkRecorder recorder(&record, pic->cullRect());
+    pic->playback(&recorder);
+    if (optimize) {
+        optimize(&record);
+    }
+    return record.count();
+}
+
 const char* RecordingBench::onGetName() {
     return fName.c_str();
 }
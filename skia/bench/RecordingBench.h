@@ -11,10 +11,16 @@
 #include "Benchmark.h"
 #include "SkPicture.h"
 
+class SkRecord;
+
 class RecordingBench : public Benchmark {
 public:
     RecordingBench(const char* name, const SkPicture*, bool useBBH);
 
+    // Re-records the picture into a bare SkRecord, runs optimize over it (if non-null),
+    // and returns how many ops are left.  Useful to see what an SkRecordOpts pass buys us.
+    static int CountOps(const SkPicture*, void (*optimize)(SkRecord*));
+
 protected:
     const char* onGetName() override;
     bool isSuitableFor(Backend) override;
@@ -21,6 +21,7 @@ public:
     bool isSuitableFor(Backend backend) override {
         return backend == kNonRendering_Backend;
     }
+    bool isThreadSafe() const override { return true; }
 
 protected:
     const char* onGetName() override {
@@ -45,6 +46,7 @@ public:
     bool isSuitableFor(Backend backend) override {
         return backend == kNonRendering_Backend;
     }
+    bool isThreadSafe() const override { return true; }
 
 protected:
     const char* onGetName() override {
@@ -67,6 +69,7 @@ public:
     bool isSuitableFor(Backend backend) override {
         return backend == kNonRendering_Backend;
     }
+    bool isThreadSafe() const override { return true; }
 
 protected:
     const char* onGetName() override {
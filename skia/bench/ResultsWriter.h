@@ -15,6 +15,7 @@
 #include "SkOSFile.h"
 #include "SkStream.h"
 #include "SkString.h"
+#include "SkTArray.h"
 #include "SkTypes.h"
 
 /**
@@ -46,6 +47,9 @@ public:
     // Record a single test metric.
     virtual void metric(const char name[], double ms) {}
 
+    // Record every sample behind a metric, e.g. to recover its full latency distribution.
+    virtual void samples(const char name[], const SkTArray<double>& ms) {}
+
     // Flush to storage now please.
     virtual void flush() {}
 };
@@ -68,6 +72,8 @@ public:
            "8888" : {
                  "median_ms" : 143.188128906250,
                  "min_ms" : 143.835957031250,
+                 "p99_ms" : 151.209960937500,
+                 "samples_ms" : [ 143.835957031250, 151.209960937500, ... ],
                  ...
               },
           ...
@@ -113,6 +119,15 @@ public:
         SkASSERT(fConfig);
         (*fConfig)[name] = ms;
     }
+    void samples(const char name[], const SkTArray<double>& ms) override {
+        SkASSERT(fConfig);
+        Json::Value& array = (*fConfig)[name] = Json::Value(Json::arrayValue);
+        for (int i = 0; i < ms.count(); i++) {
+            if (!sk_double_isnan(ms[i])) {
+                array.append(ms[i]);
+            }
+        }
+    }
 
     // Flush to storage now please.
     void flush() override {
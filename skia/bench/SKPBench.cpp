@@ -22,17 +22,21 @@ DEFINE_int32(GPUbenchTileW, 1600, "Tile width  used for GPU SKP playback.");
 DEFINE_int32(GPUbenchTileH, 512, "Tile height used for GPU SKP playback.");
 
 SKPBench::SKPBench(const char* name, const SkPicture* pic, const SkIRect& clip, SkScalar scale,
-                   bool useMultiPictureDraw, bool doLooping)
+                   bool useMultiPictureDraw, bool doLooping, int tiledRasterTasks)
     : fPic(SkRef(pic))
     , fClip(clip)
     , fScale(scale)
     , fName(name)
     , fUseMultiPictureDraw(useMultiPictureDraw)
-    , fDoLooping(doLooping) {
+    , fDoLooping(doLooping)
+    , fTiledRasterTasks(tiledRasterTasks) {
     fUniqueName.printf("%s_%.2g", name, scale);  // Scale makes this unqiue for perf.skia.org traces.
     if (useMultiPictureDraw) {
         fUniqueName.append("_mpd");
     }
+    if (tiledRasterTasks > 0) {
+        fUniqueName.appendf("_tiled%d", tiledRasterTasks);
+    }
 }
 
 SKPBench::~SKPBench() {
@@ -60,6 +64,17 @@ void SKPBench::onPerCanvasPreDraw(SkCanvas* canvas) {
     tileW = SkTMin(tileW, bounds.width());
     tileH = SkTMin(tileH, bounds.height());
 
+    if (fTiledRasterTasks > 0) {
+        // One bitmap for the whole clip; DrawTiled carves it into tileW x tileH tiles itself.
+        fTiledBitmap.allocPixels(canvas->imageInfo().makeWH(bounds.width(), bounds.height()));
+        fTiledOrigin.set(bounds.fLeft, bounds.fTop);
+        fTiledMatrix = canvas->getTotalMatrix();
+        fTiledMatrix.postTranslate(-SkIntToScalar(bounds.fLeft), -SkIntToScalar(bounds.fTop));
+        fTiledMatrix.preScale(fScale, fScale);
+        fTiledTileSize.set(tileW, tileH);
+        return;
+    }
+
     int xTiles = SkScalarCeilToInt(bounds.width()  / SkIntToScalar(tileW));
     int yTiles = SkScalarCeilToInt(bounds.height() / SkIntToScalar(tileH));
 
@@ -87,6 +102,17 @@ void SKPBench::onPerCanvasPreDraw(SkCanvas* canvas) {
 }
 
 void SKPBench::onPerCanvasPostDraw(SkCanvas* canvas) {
+    if (fTiledRasterTasks > 0) {
+        // Draw the last frame into the master canvas in case we're saving the images.
+        canvas->save();
+        canvas->resetMatrix();
+        canvas->drawBitmap(fTiledBitmap,
+                           SkIntToScalar(fTiledOrigin.fX), SkIntToScalar(fTiledOrigin.fY));
+        canvas->restore();
+        fTiledBitmap.reset();
+        return;
+    }
+
     // Draw the last set of tiles into the master canvas in case we're
     // saving the images
     for (int i = 0; i < fTileRects.count(); ++i) {
@@ -101,6 +127,9 @@ void SKPBench::onPerCanvasPostDraw(SkCanvas* canvas) {
 }
 
 bool SKPBench::isSuitableFor(Backend backend) {
+    if (fTiledRasterTasks > 0) {
+        return backend == kRaster_Backend;
+    }
     return backend != kNonRendering_Backend;
 }
 
@@ -111,7 +140,9 @@ SkIPoint SKPBench::onGetSize() {
 void SKPBench::onDraw(int loops, SkCanvas* canvas) {
     SkASSERT(fDoLooping || 1 == loops);
     while (1) {
-        if (fUseMultiPictureDraw) {
+        if (fTiledRasterTasks > 0) {
+            this->drawTiledPicture();
+        } else if (fUseMultiPictureDraw) {
             this->drawMPDPicture();
         } else {
             this->drawPicture();
@@ -157,6 +188,15 @@ void SKPBench::drawPicture() {
     }
 }
 
+void SKPBench::drawTiledPicture() {
+    SkAutoLockPixels alp(fTiledBitmap);
+    SkPixmap pixmap;
+    if (!fTiledBitmap.peekPixels(&pixmap)) {
+        return;
+    }
+    SkMultiPictureDraw::DrawTiled(pixmap, fPic, &fTiledMatrix, fTiledTileSize, fTiledRasterTasks);
+}
+
 #if SK_SUPPORT_GPU
 #include "GrGpu.h"
 static void draw_pic_for_stats(SkCanvas* canvas, GrContext* context, const SkPicture* picture,
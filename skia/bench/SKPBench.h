@@ -9,6 +9,7 @@
 #define SKPBench_DEFINED
 
 #include "Benchmark.h"
+#include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkPicture.h"
 #include "SkTDArray.h"
@@ -17,11 +18,14 @@ class SkSurface;
 
 /**
  * Runs an SkPicture as a benchmark by repeatedly drawing it scaled inside a device clip.
+ *
+ * If tiledRasterTasks is > 0 the raster backend instead draws all tiles into one shared bitmap
+ * with SkMultiPictureDraw::DrawTiled, spreading them over that many SkTaskGroup tasks.
  */
 class SKPBench : public Benchmark {
 public:
     SKPBench(const char* name, const SkPicture*, const SkIRect& devClip, SkScalar scale,
-             bool useMultiPictureDraw, bool doLooping);
+             bool useMultiPictureDraw, bool doLooping, int tiledRasterTasks = 0);
     ~SKPBench() override;
 
     int calculateLoops(int defaultLoops) const override {
@@ -41,6 +45,7 @@ protected:
 
     virtual void drawMPDPicture();
     virtual void drawPicture();
+    void drawTiledPicture();
 
     const SkPicture* picture() const { return fPic; }
     const SkTDArray<SkSurface*>& surfaces() const { return fSurfaces; }
@@ -59,6 +64,12 @@ private:
 
     const bool fDoLooping;
 
+    const int fTiledRasterTasks;
+    SkBitmap fTiledBitmap;             // for DrawTiled
+    SkIPoint fTiledOrigin;
+    SkISize  fTiledTileSize;
+    SkMatrix fTiledMatrix;
+
     typedef Benchmark INHERITED;
 };
 
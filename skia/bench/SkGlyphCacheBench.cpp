@@ -114,7 +114,55 @@ private:
     SkString fName;
 };
 
+// Every task draws short runs with the same few strikes, so the time goes into finding and
+// reattaching strikes rather than into rasterizing glyphs.
+class SkGlyphCacheContention : public Benchmark {
+public:
+    explicit SkGlyphCacheContention(int strikes) : fStrikes(strikes) { }
+
+protected:
+    const char* onGetName() override {
+        fName.printf("SkGlyphCacheContention%dStrikes%dShards",
+                     fStrikes, SkGlyphCache_Globals::DefaultShardCount());
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        fTypeface.reset(sk_tool_utils::create_portable_typeface("serif", SkTypeface::kNormal));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int work = 0; work < loops; work++) {
+            SkTaskGroup().batch(16, [&](int threadIndex) {
+                SkPaint paint;
+                paint.setAntiAlias(true);
+                paint.setTypeface(fTypeface);
+                for (int run = 0; run < 100; run++) {
+                    paint.setTextSize(SkIntToScalar(12 + (threadIndex + run) % fStrikes));
+                    SkAutoGlyphCacheNoGamma autoCache(paint, nullptr, nullptr);
+                    SkGlyphCache* cache = autoCache.getCache();
+                    for (int c = 'a'; c <= 'z'; c++) {
+                        cache->findImage(cache->getUnicharMetrics(c));
+                    }
+                }
+            });
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+    const int fStrikes;
+    SkAutoTUnref<SkTypeface> fTypeface;
+    SkString fName;
+};
+
 DEF_BENCH( return new SkGlyphCacheBasic(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheBasic(32 * 1024 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(32 * 1024 * 1024); )
+DEF_BENCH( return new SkGlyphCacheContention(1); )
+DEF_BENCH( return new SkGlyphCacheContention(16); )
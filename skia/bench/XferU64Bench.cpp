@@ -106,3 +106,41 @@ DEF_BENCH( return new XferD64Bench(MODE, NAME, false, F00 | USE_AA); )
 DEF_BENCH( return new XferD64Bench(MODE, NAME, false, F01 | USE_AA); )
 DEF_BENCH( return new XferD64Bench(MODE, NAME, false, F00); )
 DEF_BENCH( return new XferD64Bench(MODE, NAME, false, F01); )
+
+// Every other mode, blending a single color and a span of colors with coverage into F16 and U16.
+#define MODE_BENCHES(Mode, name) \
+    DEF_BENCH( return new XferD64Bench(SkXfermode::k##Mode##_Mode, name, false, F10 | USE_AA); ) \
+    DEF_BENCH( return new XferD64Bench(SkXfermode::k##Mode##_Mode, name, true,  F10 | USE_AA); ) \
+    DEF_BENCH( return new XferD64Bench(SkXfermode::k##Mode##_Mode, name, false, F00 | USE_AA); ) \
+    DEF_BENCH( return new XferD64Bench(SkXfermode::k##Mode##_Mode, name, true,  F00 | USE_AA); )
+
+MODE_BENCHES(Clear,      "clear")
+MODE_BENCHES(Src,        "src")
+MODE_BENCHES(Dst,        "dst")
+MODE_BENCHES(DstOver,    "dstover")
+MODE_BENCHES(SrcIn,      "srcin")
+MODE_BENCHES(DstIn,      "dstin")
+MODE_BENCHES(SrcOut,     "srcout")
+MODE_BENCHES(DstOut,     "dstout")
+MODE_BENCHES(SrcATop,    "srcatop")
+MODE_BENCHES(DstATop,    "dstatop")
+MODE_BENCHES(Xor,        "xor")
+MODE_BENCHES(Plus,       "plus")
+MODE_BENCHES(Modulate,   "modulate")
+MODE_BENCHES(Screen,     "screen")
+MODE_BENCHES(Overlay,    "overlay")
+MODE_BENCHES(Darken,     "darken")
+MODE_BENCHES(Lighten,    "lighten")
+MODE_BENCHES(ColorDodge, "colordodge")
+MODE_BENCHES(ColorBurn,  "colorburn")
+MODE_BENCHES(HardLight,  "hardlight")
+MODE_BENCHES(SoftLight,  "softlight")
+MODE_BENCHES(Difference, "difference")
+MODE_BENCHES(Exclusion,  "exclusion")
+MODE_BENCHES(Multiply,   "multiply")
+MODE_BENCHES(Hue,        "hue")
+MODE_BENCHES(Saturation, "saturation")
+MODE_BENCHES(Color,      "color")
+MODE_BENCHES(Luminosity, "luminosity")
+
+#undef MODE_BENCHES
@@ -41,6 +41,9 @@ def usage():
     print '-e <file> file containing expected bench builder values/ranges.'
     print '   Will raise exception if actual bench values are out of range.'
     print '   See bench_expectations_<builder>.txt for data format / examples.'
+    print '-j <file> nanobench --outResultsFile JSON to check instead of -d.'
+    print '   Every scalar metric is checked, including the p90_ms/p99_ms'
+    print '   percentiles and the threads_<N>_* metrics from --benchThreads.'
     print '-r <revision> the git commit hash or svn revision for checking '
     print '   bench values.'
 
@@ -123,6 +126,78 @@ def read_expectations(expectations, filename):
                                      float(elements[UB_IDX]),
                                      float(elements[EXPECTED_IDX]))
 
+def read_nanobench_json(filename):
+    """Reads the scalar metrics out of a nanobench --outResultsFile JSON file.
+
+    Returns:
+      a dictionary mapping <bench>_<config>_<metric> strings, in the same form
+      as the first field of an expectation line, to the metric's value.
+      Per-sample arrays (e.g. samples_ms) and config options are skipped.
+    """
+    results = json.load(open(filename)).get('results', {})
+    bench_dict = {}
+    for bench, configs in results.iteritems():
+        for config, metrics in configs.iteritems():
+            for metric, value in metrics.iteritems():
+                if isinstance(value, (int, float)):
+                    bench_dict['_'.join([bench, config, metric])] = float(value)
+    return bench_dict
+
+def is_higher_better(time_type):
+    """Returns True for metrics where a larger value is an improvement."""
+    return time_type.endswith('speedup')
+
+def record_exception(exceptions, bench_platform_key, value, expectation, url):
+    """Records value in exceptions if it is outside its expected range."""
+    this_min, this_max, this_expected = expectation
+    if this_min <= value <= this_max:
+        return
+    off_ratio = value / this_expected
+    exception = 'Bench %s out of range [%s, %s] (%s vs %s, %s%%).' % (
+        bench_platform_key, this_min, this_max, value,
+        this_expected, (off_ratio - 1) * 100)
+    if url:
+        exception += '\n' + url
+    slower = off_ratio > 1
+    if is_higher_better(bench_platform_key.split(',')[0]):
+        slower = not slower
+    if slower:
+        exceptions[SLOWER].setdefault(off_ratio, []).append(exception)
+    else:
+        exceptions[FASTER].setdefault(off_ratio, []).append(exception)
+
+def report_exceptions(exceptions):
+    """Writes any out-of-range benches to stderr and exits with failure."""
+    outputs = []
+    for i in [SLOWER, FASTER]:
+      if exceptions[i]:
+          ratios = exceptions[i].keys()
+          ratios.sort(reverse=True)
+          li = []
+          for ratio in ratios:
+              li.extend(exceptions[i][ratio])
+          header = '%s benches got slower (sorted by %% difference):' % len(li)
+          if i == FASTER:
+              header = header.replace('slower', 'faster')
+          outputs.extend(['', header] + li)
+
+    if outputs:
+        # Directly raising Exception will have stderr outputs tied to the line
+        # number of the script, so use sys.stderr.write() instead.
+        # Add a trailing newline to supress new line checking errors.
+        sys.stderr.write('\n'.join(['Exception:'] + outputs + ['\n']))
+        exit(1)
+
+def check_json_expectations(bench_dict, expectations, key_suffix):
+    """Like check_expectations(), for the output of read_nanobench_json()."""
+    exceptions = ({}, {})
+    for name, value in bench_dict.iteritems():
+        bench_platform_key = name + ',' + key_suffix
+        if bench_platform_key in expectations:
+            record_exception(exceptions, bench_platform_key, value,
+                             expectations[bench_platform_key], None)
+    report_exceptions(exceptions)
+
 def check_expectations(lines, expectations, key_suffix):
     """Check if any bench results are outside of expected range.
 
@@ -156,45 +231,18 @@ def check_expectations(lines, expectations, key_suffix):
         bench_platform_key = line_str + ',' + key_suffix
         if bench_platform_key not in expectations:
             continue
-        this_bench_value = lines[line]
-        this_min, this_max, this_expected = expectations[bench_platform_key]
-        if this_bench_value < this_min or this_bench_value > this_max:
-            off_ratio = this_bench_value / this_expected
-            exception = 'Bench %s out of range [%s, %s] (%s vs %s, %s%%).' % (
-                bench_platform_key, this_min, this_max, this_bench_value,
-                this_expected, (off_ratio - 1) * 100)
-            exception += '\n' + '~'.join([
-                DASHBOARD_URL_PREFIX, bench, platform, config])
-            if off_ratio > 1:  # Bench is slower.
-                exceptions[SLOWER].setdefault(off_ratio, []).append(exception)
-            else:
-                exceptions[FASTER].setdefault(off_ratio, []).append(exception)
-    outputs = []
-    for i in [SLOWER, FASTER]:
-      if exceptions[i]:
-          ratios = exceptions[i].keys()
-          ratios.sort(reverse=True)
-          li = []
-          for ratio in ratios:
-              li.extend(exceptions[i][ratio])
-          header = '%s benches got slower (sorted by %% difference):' % len(li)
-          if i == FASTER:
-              header = header.replace('slower', 'faster')
-          outputs.extend(['', header] + li)
-
-    if outputs:
-        # Directly raising Exception will have stderr outputs tied to the line
-        # number of the script, so use sys.stderr.write() instead.
-        # Add a trailing newline to supress new line checking errors.
-        sys.stderr.write('\n'.join(['Exception:'] + outputs + ['\n']))
-        exit(1)
+        record_exception(exceptions, bench_platform_key, lines[line],
+                         expectations[bench_platform_key],
+                         '~'.join([DASHBOARD_URL_PREFIX, bench, platform,
+                                   config]))
+    report_exceptions(exceptions)
 
 
 def main():
     """Parses command line and checks bench expectations."""
     try:
         opts, _ = getopt.getopt(sys.argv[1:],
-                                "a:b:d:e:r:",
+                                "a:b:d:e:j:r:",
                                 "default-setting=")
     except getopt.GetoptError, err:
         print str(err)
@@ -202,6 +250,7 @@ def main():
         sys.exit(2)
 
     directory = None
+    json_file = None
     bench_expectations = {}
     rep = '25th'  # bench representation algorithm, default to 25th
     rev = None  # git commit hash or svn revision number
@@ -215,6 +264,8 @@ def main():
                 bot = value
             elif option == "-d":
                 directory = value
+            elif option == "-j":
+                json_file = value
             elif option == "-e":
                 read_expectations(bench_expectations, value)
             elif option == "-r":
@@ -226,6 +277,15 @@ def main():
         usage()
         sys.exit(2)
 
+    if json_file is not None:
+        if bot is None:
+            usage()
+            sys.exit(2)
+        if bench_expectations:
+            check_json_expectations(read_nanobench_json(json_file),
+                                    bench_expectations, bot + '-' + rep)
+        return
+
     if directory is None or bot is None or rev is None:
         usage()
         sys.exit(2)
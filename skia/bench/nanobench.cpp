@@ -36,6 +36,7 @@
 #include "SkOSFile.h"
 #include "SkPictureRecorder.h"
 #include "SkPictureUtils.h"
+#include "SkRecordOpts.h"
 #include "SkString.h"
 #include "SkSurface.h"
 #include "SkTaskGroup.h"
@@ -108,6 +109,11 @@ DEFINE_string(zoom, "1.0,0", "Comma-separated zoomMax,zoomPeriodMs factors for a
                              "function that ping-pongs between 1.0 and zoomMax.");
 DEFINE_bool(bbh, true, "Build a BBH for SKPs?");
 DEFINE_bool(mpd, true, "Use MultiPictureDraw for the SKPs?");
+DEFINE_string(tiledRaster, "", "Space-separated task counts for tiled parallel raster playback of "
+                               "the SKPs into one bitmap, e.g. '1 2 4 8'. 0 means all cores.");
+DEFINE_string(benchThreads, "", "Space-separated thread counts, e.g. '2 4 8'. Thread-safe "
+                                "non-rendering benches are also run concurrently on this many "
+                                "threads, reporting per-thread latency. 0 means all cores.");
 DEFINE_bool(loopSKP, true, "Loop SKPs like we do for micro benches?");
 DEFINE_int32(flushEvery, 10, "Flush --outResultsFile every Nth run.");
 DEFINE_bool(resetGpuContext, true, "Reset the GrContext before running each test.");
@@ -234,6 +240,21 @@ static double time(int loops, Benchmark* bench, Target* target) {
     return elapsed;
 }
 
+// Calls bench->draw() from threads tasks at once, recording each task's per-loop time for each
+// of FLAGS_samples passes.  The tasks share SkTaskGroup's pool, so they only all run concurrently
+// if --threads is at least as large.
+static void time_threaded(int threads, int loops, Benchmark* bench, SkTArray<double>* samples) {
+    const int passes = FLAGS_samples;
+    samples->reset(threads * passes);
+    SkTaskGroup().batch(threads, [&](int t) {
+        for (int s = 0; s < passes; s++) {
+            double start = now_ms();
+            bench->draw(loops, nullptr);
+            (*samples)[t * passes + s] = (now_ms() - start) / loops;
+        }
+    });
+}
+
 static double estimate_timer_overhead() {
     double overhead = 0;
     for (int i = 0; i < FLAGS_overheadLoops; i++) {
@@ -547,6 +568,7 @@ public:
                       , fCurrentScale(0)
                       , fCurrentSKP(0)
                       , fCurrentUseMPD(0)
+                      , fCurrentTiledRaster(0)
                       , fCurrentCodec(0)
                       , fCurrentAndroidCodec(0)
                       , fCurrentBRDImage(0)
@@ -591,6 +613,16 @@ public:
         }
         fUseMPDs.push_back() = false;
 
+        for (int i = 0; i < FLAGS_tiledRaster.count(); i++) {
+            int tasks;
+            if (1 != sscanf(FLAGS_tiledRaster[i], "%d", &tasks) || tasks < 0) {
+                SkDebugf("Can't parse %s from --tiledRaster as a task count.\n",
+                         FLAGS_tiledRaster[i]);
+                exit(1);
+            }
+            fTiledRasterTasks.push_back() = tasks > 0 ? tasks : sk_num_cores();
+        }
+
         // Prepare the images for decoding
         if (!CollectImages(&fImages)) {
             exit(1);
@@ -670,6 +702,9 @@ public:
             fBenchType  = "recording";
             fSKPBytes = static_cast<double>(SkPictureUtils::ApproximateBytesUsed(pic));
             fSKPOps   = pic->approximateOpCount();
+            fSKPOpsUnoptimized = RecordingBench::CountOps(pic, nullptr);
+            fSKPOpsOptimized   = RecordingBench::CountOps(pic, SkRecordOptimize);
+            fSKPOpsOptimized2  = RecordingBench::CountOps(pic, SkRecordOptimize2);
             return new RecordingBench(name.c_str(), pic.get(), FLAGS_bbh);
         }
 
@@ -701,7 +736,32 @@ public:
                     return new SKPBench(name.c_str(), pic.get(), fClip, fScales[fCurrentScale],
                                         fUseMPDs[fCurrentUseMPD++], FLAGS_loopSKP);
                 }
+
+                // Then once per --tiledRaster task count, so runs report scaling by core count.
+                while (fCurrentTiledRaster < fTiledRasterTasks.count()) {
+                    if (!fTiledRasterPic) {
+                        fTiledRasterPic.reset(SkRef(pic.get()));
+                        if (FLAGS_bbh) {
+                            // Tiles are culled through the BBH, so this mode is pointless without
+                            // one. Record it once and share it between all the task counts.
+                            SkRTreeFactory factory;
+                            SkPictureRecorder recorder;
+                            pic->playback(recorder.beginRecording(pic->cullRect().width(),
+                                                                  pic->cullRect().height(),
+                                                                  &factory));
+                            fTiledRasterPic.reset(recorder.endRecording());
+                        }
+                    }
+                    SkString name = SkOSPath::Basename(path.c_str());
+                    fSourceType = "skp";
+                    fBenchType = "playback";
+                    return new SKPBench(name.c_str(), fTiledRasterPic.get(), fClip,
+                                        fScales[fCurrentScale], false, FLAGS_loopSKP,
+                                        fTiledRasterTasks[fCurrentTiledRaster++]);
+                }
+                fTiledRasterPic.reset(nullptr);
                 fCurrentUseMPD = 0;
+                fCurrentTiledRaster = 0;
                 fCurrentSKP++;
             }
             fCurrentSKP = 0;
@@ -727,6 +787,10 @@ public:
             }
         }
 
+        if (fParallelCodecBench) {
+            return fParallelCodecBench.detach();
+        }
+
         for (; fCurrentCodec < fImages.count(); fCurrentCodec++) {
             fSourceType = "image";
             fBenchType = "skcodec";
@@ -786,6 +850,14 @@ public:
                 switch (result) {
                     case SkCodec::kSuccess:
                     case SkCodec::kIncompleteInput:
+                        // Formats that can decode in parallel are also timed that way, right
+                        // after the serial decode, so the two can be compared.
+                        if (kJPEG_SkEncodedFormat == codec->getEncodedFormat() ||
+                                kPNG_SkEncodedFormat == codec->getEncodedFormat()) {
+                            fParallelCodecBench.reset(new CodecBench(
+                                    SkOSPath::Basename(path.c_str()), encoded, colorType,
+                                    alphaType, true));
+                        }
                         return new CodecBench(SkOSPath::Basename(path.c_str()),
                                 encoded, colorType, alphaType);
                     case SkCodec::kInvalidConversion:
@@ -839,6 +911,7 @@ public:
         } strategies[] = {
             { SkBitmapRegionDecoder::kCanvas_Strategy,       "BRD_canvas" },
             { SkBitmapRegionDecoder::kAndroidCodec_Strategy, "BRD_android_codec" },
+            { SkBitmapRegionDecoder::kTileCache_Strategy,    "BRD_tile_cache" },
         };
 
         // We intend to create benchmarks that model the use cases in
@@ -869,7 +942,7 @@ public:
 
                 while (fCurrentColorType < fColorTypes.count()) {
                     while (fCurrentSampleSize < (int) SK_ARRAY_COUNT(brdSampleSizes)) {
-                        while (fCurrentSubsetType <= kLastSingle_SubsetType) {
+                        while (fCurrentSubsetType <= kLastBRD_SubsetType) {
 
                             SkAutoTUnref<SkData> encoded(SkData::NewFromFileName(path.c_str()));
                             const SkColorType colorType = fColorTypes[fCurrentColorType];
@@ -885,6 +958,7 @@ public:
 
                             SkString basename = SkOSPath::Basename(path.c_str());
                             SkIRect subset;
+                            int panSteps = 0;
                             const uint32_t subsetSize = sampleSize * minOutputSize;
                             switch (currentSubsetType) {
                                 case kTopLeft_SubsetType:
@@ -911,12 +985,19 @@ public:
                                     subset = SkIRect::MakeXYWH(width - subsetSize,
                                             height - subsetSize, subsetSize, subsetSize);
                                     break;
+                                case kTranslate_SubsetType:
+                                    // Pan across the middle of the image in eighths of a subset.
+                                    basename.append("_Pan");
+                                    subset = SkIRect::MakeXYWH(0, (height - subsetSize) / 2,
+                                            subsetSize, subsetSize);
+                                    panSteps = 8;
+                                    break;
                                 default:
                                     SkASSERT(false);
                             }
 
                             return new BitmapRegionDecoderBench(basename.c_str(), encoded.get(),
-                                    strategy, colorType, sampleSize, subset);
+                                    strategy, colorType, sampleSize, subset, panSteps);
                         }
                         fCurrentSubsetType = 0;
                         fCurrentSampleSize++;
@@ -946,10 +1027,17 @@ public:
                 SkASSERT(1 == fCurrentUseMPD || 2 == fCurrentUseMPD);
                 log->configOption("multi_picture_draw", fUseMPDs[fCurrentUseMPD-1] ? "true" : "false");
             }
+            if (fCurrentTiledRaster > 0) {
+                log->configOption("tiled_raster_tasks",
+                        SkStringPrintf("%d", fTiledRasterTasks[fCurrentTiledRaster-1]).c_str());
+            }
         }
         if (0 == strcmp(fBenchType, "recording")) {
             log->metric("bytes", fSKPBytes);
             log->metric("ops",   fSKPOps);
+            log->metric("ops_unoptimized", fSKPOpsUnoptimized);
+            log->metric("ops_optimized",   fSKPOpsOptimized);
+            log->metric("ops_optimized2",  fSKPOpsOptimized2);
         }
     }
 
@@ -963,7 +1051,7 @@ private:
         kTranslate_SubsetType   = 5,
         kZoom_SubsetType        = 6,
         kLast_SubsetType        = kZoom_SubsetType,
-        kLastSingle_SubsetType  = kBottomRight_SubsetType,
+        kLastBRD_SubsetType     = kTranslate_SubsetType,
     };
 
     const BenchRegistry* fBenches;
@@ -972,12 +1060,15 @@ private:
     SkTArray<SkScalar> fScales;
     SkTArray<SkString> fSKPs;
     SkTArray<bool>     fUseMPDs;
+    SkTArray<int>      fTiledRasterTasks;
+    SkAutoTUnref<SkPicture> fTiledRasterPic;  // The current SKP for fTiledRasterTasks.
     SkTArray<SkString> fImages;
     SkTArray<SkColorType, true> fColorTypes;
     SkScalar           fZoomMax;
     double             fZoomPeriodMs;
 
     double fSKPBytes, fSKPOps;
+    double fSKPOpsUnoptimized, fSKPOpsOptimized, fSKPOpsOptimized2;
 
     const char* fSourceType;  // What we're benching: bench, GM, SKP, ...
     const char* fBenchType;   // How we bench it: micro, recording, playback, ...
@@ -985,6 +1076,7 @@ private:
     int fCurrentScale;
     int fCurrentSKP;
     int fCurrentUseMPD;
+    int fCurrentTiledRaster;
     int fCurrentCodec;
     int fCurrentAndroidCodec;
     int fCurrentBRDImage;
@@ -994,6 +1086,7 @@ private:
     int fCurrentBRDStrategy;
     int fCurrentSampleSize;
     int fCurrentAnimSKP;
+    SkAutoTDelete<Benchmark> fParallelCodecBench;  // Queued after its serial CodecBench.
 };
 
 // Some runs (mostly, Valgrind) are so slow that the bot framework thinks we've hung.
@@ -1071,6 +1164,17 @@ int nanobench_main() {
         log->key(FLAGS_key[i-1], FLAGS_key[i]);
     }
 
+    SkTArray<int> benchThreads;
+    for (int i = 0; i < FLAGS_benchThreads.count(); i++) {
+        int threads;
+        if (1 != sscanf(FLAGS_benchThreads[i], "%d", &threads) || threads < 0) {
+            SkDebugf("Can't parse %s from --benchThreads as a thread count.\n",
+                     FLAGS_benchThreads[i]);
+            return 1;
+        }
+        benchThreads.push_back() = threads > 0 ? threads : sk_num_cores();
+    }
+
     const double overhead = estimate_timer_overhead();
     SkDebugf("Timer overhead: %s\n", HUMANIZE(overhead));
 
@@ -1195,6 +1299,9 @@ int nanobench_main() {
             target->fillOptions(log.get());
             log->metric("min_ms",    stats.min);
             log->metric("median_ms", stats.median);
+            log->metric("p90_ms",    stats.p90);
+            log->metric("p99_ms",    stats.p99);
+            log->samples("samples_ms", samples);
 #if SK_SUPPORT_GPU
             if (gpuStatsDump) {
                 // dump to json, only SKPBench currently returns valid keys / values
@@ -1252,6 +1359,41 @@ int nanobench_main() {
             }
 #endif
 
+            if (Benchmark::kNonRendering_Backend == target->config.backend &&
+                bench->isThreadSafe()) {
+                SkTArray<double> threadSamples;
+                for (int t = 0; t < benchThreads.count(); t++) {
+                    const int threads = benchThreads[t];
+                    time_threaded(threads, loops, bench.get(), &threadSamples);
+                    Stats threadStats(threadSamples);
+                    // Throughput relative to running on one thread; threads means perfect scaling.
+                    const double speedup = threads * stats.median / threadStats.median;
+
+                    auto name = [threads](const char* metric) {
+                        return SkStringPrintf("threads_%d_%s", threads, metric);
+                    };
+                    log->metric(name("min_ms").c_str(),    threadStats.min);
+                    log->metric(name("median_ms").c_str(), threadStats.median);
+                    log->metric(name("p90_ms").c_str(),    threadStats.p90);
+                    log->metric(name("p99_ms").c_str(),    threadStats.p99);
+                    log->metric(name("speedup").c_str(),   speedup);
+                    log->samples(name("samples_ms").c_str(), threadSamples);
+
+                    if (kAutoTuneLoops == FLAGS_loops && !FLAGS_quiet) {
+                        SkDebugf("\t%d threads\t%s\t%s\t%s\tp99 %s\t%.2fx\t%s\t%s\n"
+                                , threads
+                                , HUMANIZE(threadStats.min)
+                                , HUMANIZE(threadStats.median)
+                                , HUMANIZE(threadStats.mean)
+                                , HUMANIZE(threadStats.p99)
+                                , speedup
+                                , config
+                                , bench->getUniqueName()
+                                );
+                    }
+                }
+            }
+
             if (FLAGS_verbose) {
                 SkDebugf("Samples:  ");
                 for (int i = 0; i < samples.count(); i++) {
@@ -141,11 +141,13 @@ LOCAL_SRC_FILES := \
 	../tests/GLProgramsTest.cpp \
 	../tests/GeometryTest.cpp \
 	../tests/GifTest.cpp \
+	../tests/GlyphCacheTest.cpp \
 	../tests/GpuColorFilterTest.cpp \
 	../tests/GpuDrawPathTest.cpp \
 	../tests/GpuLayerCacheTest.cpp \
 	../tests/GpuRectanizerTest.cpp \
 	../tests/GrAllocatorTest.cpp \
+	../tests/GrBatchAtlasTest.cpp \
 	../tests/GrContextFactoryTest.cpp \
 	../tests/GrDrawTargetTest.cpp \
 	../tests/GrGLSLPrettyPrintTest.cpp \
@@ -483,6 +483,7 @@ static bool brd_color_type_supported(SkBitmapRegionDecoder::Strategy strategy,
             }
             return false;
         case SkBitmapRegionDecoder::kAndroidCodec_Strategy:
+        case SkBitmapRegionDecoder::kTileCache_Strategy:
             switch (dstColorType) {
                 case CodecSrc::kGetFromCanvas_DstColorType:
                 case CodecSrc::kIndex8_Always_DstColorType:
@@ -507,6 +508,9 @@ static void push_brd_src(Path path, SkBitmapRegionDecoder::Strategy strategy,
         case SkBitmapRegionDecoder::kAndroidCodec_Strategy:
             folder.append("brd_android_codec");
             break;
+        case SkBitmapRegionDecoder::kTileCache_Strategy:
+            folder.append("brd_tile_cache");
+            break;
         default:
             SkASSERT(false);
             return;
@@ -550,6 +554,7 @@ static void push_brd_srcs(Path path) {
     const SkBitmapRegionDecoder::Strategy strategies[] = {
             SkBitmapRegionDecoder::kCanvas_Strategy,
             SkBitmapRegionDecoder::kAndroidCodec_Strategy,
+            SkBitmapRegionDecoder::kTileCache_Strategy,
     };
 
     // Test on a variety of sampleSizes, making sure to include:
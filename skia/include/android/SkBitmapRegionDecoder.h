@@ -23,6 +23,7 @@ public:
     enum Strategy {
         kCanvas_Strategy,       // Draw to the canvas, uses SkCodec
         kAndroidCodec_Strategy, // Uses SkAndroidCodec for scaling and subsetting
+        kTileCache_Strategy,    // Uses SkAndroidCodec, keeping decoded tiles in SkResourceCache
     };
 
     /*
@@ -213,6 +213,7 @@ public:
         Options()
             : fZeroInitialized(kNo_ZeroInitialized)
             , fSubset(NULL)
+            , fParallelDecode(false)
         {}
 
         ZeroInitialized fZeroInitialized;
@@ -234,6 +235,20 @@ public:
          *  to getScanlines().
          */
         SkIRect*        fSubset;
+
+        /**
+         *  If true, getPixels() may split the image into bands of rows and
+         *  decode the bands concurrently using SkTaskGroup.  This is only
+         *  honored for full images (no fSubset) by codecs which can start a
+         *  scanline decode part way down the image without decompressing
+         *  every row above it (currently baseline JPEG), and only when the
+         *  stream can be duplicated.  Otherwise the decode happens serially
+         *  as usual.
+         *
+         *  Every band re-parses the stream from the start, so this trades
+         *  total CPU time for latency.  It is ignored by scanline decodes.
+         */
+        bool            fParallelDecode;
     };
 
     /**
@@ -544,6 +559,14 @@ protected:
         return false;
     }
 
+    /**
+     *  Subclasses should override if a scanline decode of the same stream can skip to any row
+     *  and produce exactly the pixels that onGetPixels() would.  See Options::fParallelDecode.
+     */
+    virtual bool onSupportsParallelDecode() const {
+        return false;
+    }
+
     /**
      *  If the stream was previously read, attempt to rewind.
      *
@@ -630,6 +653,15 @@ protected:
     virtual int onOutputScanline(int inputScanline) const;
 
 private:
+    /**
+     *  Attempts a banded, multi-threaded decode for Options::fParallelDecode.  Returns false if
+     *  the decode could not be split or any band failed, in which case getPixels() falls back to
+     *  onGetPixels().  Bands may already have written some rows by then; if the caller promised
+     *  zero-initialized memory, those rows are zeroed again before returning.
+     */
+    bool parallelDecode(const SkImageInfo& info, void* pixels, size_t rowBytes, const Options&,
+                        SkPMColor ctable[], int* ctableCount);
+
     const SkImageInfo       fSrcInfo;
     SkAutoTDelete<SkStream> fStream;
     bool                    fNeedsRewind;
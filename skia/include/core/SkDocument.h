@@ -76,6 +76,18 @@ public:
                                  SkScalar dpi,
                                  SkPixelSerializer* jpegEncoder);
 
+    /**
+     *  Create a PDF-backed document that writes each page, and the
+     *  resources it is the first to use, to the stream as soon as
+     *  endPage() is called.  Only the cross-reference table, fonts and
+     *  resources shared between pages are kept until close(), so memory
+     *  use does not grow with the number of pages.  The stream must
+     *  outlive the document, and if abort() is called, whatever has
+     *  been written to it must be ignored.
+     */
+    static SkDocument* CreateStreamingPDF(SkWStream*,
+                                          SkScalar dpi = SK_ScalarDefaultRasterDPI);
+
     /**
      *  Create a PDF-backed document, writing the results into a file.
      */
@@ -219,16 +219,27 @@ protected:
                                            const SkIRect& clipBounds,
                                            NinePatch*) const;
 
+    /**
+     *  Called by filterPath() to render a path in device space into a mask and filter it. The
+     *  default calls SkDraw::DrawToMask() and then filterMask(). If pathGenID is not 0, it is the
+     *  generation ID of the path that pathMatrix mapped to devPath, so subclasses can cache their
+     *  result for it. The caller frees dst's image.
+     */
+    virtual bool filterPathMask(SkMask* dst, const SkPath& devPath, const SkMatrix& ctm,
+                                const SkIRect& clipBounds, SkPaint::Style,
+                                uint32_t pathGenID, const SkMatrix& pathMatrix) const;
+
 private:
     friend class SkDraw;
 
     /** Helper method that, given a path in device space, will rasterize it into a kA8_Format mask
      and then call filterMask(). If this returns true, the specified blitter will be called
      to render that mask. Returns false if filterMask() returned false.
+     pathGenID and pathMatrix are passed on to filterPathMask().
      This method is not exported to java.
      */
     bool filterPath(const SkPath& devPath, const SkMatrix& ctm, const SkRasterClip&, SkBlitter*,
-                    SkPaint::Style) const;
+                    SkPaint::Style, uint32_t pathGenID, const SkMatrix& pathMatrix) const;
 
     /** Helper method that, given a roundRect in device space, will rasterize it into a kA8_Format
      mask and then call filterMask(). If this returns true, the specified blitter will be called
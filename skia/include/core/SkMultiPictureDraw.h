@@ -10,10 +10,12 @@
 
 #include "../private/SkTDArray.h"
 #include "SkMatrix.h"
+#include "SkSize.h"
 
 class SkCanvas;
 class SkPaint;
 class SkPicture;
+class SkPixmap;
 
 /** \class SkMultiPictureDraw
 
@@ -55,6 +57,26 @@ public:
      */
     void reset();
 
+    /**
+     *  Raster the picture into dst by splitting dst into tiles of tileSize and
+     *  drawing the tiles in parallel on SkTaskGroup workers. Every tile gets its
+     *  own canvas over dst's pixels, clipped to the tile, so a picture recorded
+     *  with a bounding box hierarchy (e.g. SkRTreeFactory) only plays back the
+     *  ops that touch each tile.
+     *
+     *  @param dst       destination pixels, shared by all tiles
+     *  @param picture   the picture to draw
+     *  @param matrix    if non-NULL, applied to the initial identity CTM
+     *  @param tileSize  size of each tile in dst pixels
+     *  @param maxTasks  if > 0, the number of tasks the tiles are spread across;
+     *                   otherwise one task per tile
+     */
+    static void DrawTiled(const SkPixmap& dst,
+                          const SkPicture* picture,
+                          const SkMatrix* matrix,
+                          const SkISize& tileSize,
+                          int maxTasks = 0);
+
 private:
     struct DrawData {
         SkCanvas*        fCanvas;  // reffed
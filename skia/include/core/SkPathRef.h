@@ -280,6 +280,13 @@ public:
      */
     uint32_t genID() const;
 
+    /**
+     * Returns a hash of the verbs, conic weights and points, with the points taken relative to the
+     * top-left of the bounds. Unlike genID(), path refs built separately from the same data hash
+     * equally, as do path refs that differ only by a translation. It is computed once per genID.
+     */
+    uint32_t contentHash() const;
+
     struct GenIDChangeListener {
         virtual ~GenIDChangeListener() {}
         virtual void onChange() = 0;
@@ -305,6 +312,7 @@ private:
         fPoints = NULL;
         fFreeSpace = 0;
         fGenerationID = kEmptyGenID;
+        fContentHashGenID = 0;
         fSegmentMask = 0;
         fIsOval = false;
         fIsRRect = false;
@@ -489,6 +497,8 @@ private:
         kEmptyGenID = 1, // GenID reserved for path ref with zero points and zero verbs.
     };
     mutable uint32_t    fGenerationID;
+    mutable uint32_t    fContentHash;
+    mutable uint32_t    fContentHashGenID;  // fContentHash is valid if this matches genID()
     SkDEBUGCODE(int32_t fEditorsAttached;) // assert that only one editor in use at any time.
 
     SkTDArray<GenIDChangeListener*> fGenIDChangeListeners;  // pointers are owned
@@ -10,6 +10,8 @@
 
 #include "SkTypes.h"
 
+class SkData;
+
 struct GrContextOptions {
     GrContextOptions()
         : fDrawPathToCompressedTexture(false)
@@ -23,7 +25,28 @@ struct GrContextOptions {
         , fClipBatchToBounds(false)
         , fDrawBatchBounds(false)
         , fMaxBatchLookback(-1)
-        , fUseShaderSwizzling(false) {}
+        , fUseShaderSwizzling(false)
+        , fPersistentCache(nullptr) {}
+
+    /**
+     * Abstract class which stores Skia data in a cache that persists between sessions. Currently
+     * the GL backend uses it to store linked program binaries so that subsequent runs can skip
+     * shader compilation. Keys already incorporate the driver's vendor, renderer and version
+     * strings, so entries written by a different driver are never returned. load() and store()
+     * are called on the thread that owns the GrContext; implementations that write to disk are
+     * expected to do so asynchronously from store().
+     */
+    class PersistentCache {
+    public:
+        virtual ~PersistentCache() {}
+
+        /** Returns the data for the key if it exists in the cache, otherwise returns null. The
+            returned data is ref'ed and the caller takes ownership of the ref. */
+        virtual SkData* load(const SkData& key) = 0;
+
+        /** Stores data under key, replacing any previous value. */
+        virtual void store(const SkData& key, const SkData& data) = 0;
+    };
 
     // EXPERIMENTAL
     // May be removed in the future, or may become standard depending
@@ -70,6 +93,10 @@ struct GrContextOptions {
     /** Force us to do all swizzling manually in the shader and don't rely on extensions to do
         swizzling. */
     bool fUseShaderSwizzling;
+
+    /** If non-null, the GrContext will use this cache to load and store backend-specific data,
+        such as program binaries, across runs. The cache must outlive the GrContext. */
+    PersistentCache* fPersistentCache;
 };
 
 #endif
@@ -314,6 +314,11 @@ public:
         GrGLFunction<GrGLVertexAttribPointerProc> fVertexAttribPointer;
         GrGLFunction<GrGLViewportProc> fViewport;
 
+        /* ARB_get_program_binary / OES_get_program_binary */
+        GrGLFunction<GrGLGetProgramBinaryProc> fGetProgramBinary;
+        GrGLFunction<GrGLProgramBinaryProc> fProgramBinary;
+        GrGLFunction<GrGLProgramParameteriProc> fProgramParameteri;
+
         /* GL_NV_path_rendering */
         GrGLFunction<GrGLMatrixLoadfProc> fMatrixLoadf;
         GrGLFunction<GrGLMatrixLoadIdentityProc> fMatrixLoadIdentity;
@@ -47,6 +47,7 @@ namespace SkRecords {
     M(DrawBitmapRect)                                               \
     M(DrawBitmapRectFast)                                           \
     M(DrawBitmapRectFixedSize)                                      \
+    M(DrawBitmapRects)                                              \
     M(DrawDrawable)                                                 \
     M(DrawImage)                                                    \
     M(DrawImageRect)                                                \
@@ -64,6 +65,7 @@ namespace SkRecords {
     M(DrawTextOnPath)                                               \
     M(DrawRRect)                                                    \
     M(DrawRect)                                                     \
+    M(DrawRects)                                                    \
     M(DrawTextBlob)                                                 \
     M(DrawAtlas)                                                    \
     M(DrawVertices)
@@ -258,6 +260,15 @@ RECORD(DrawBitmapRectFixedSize, kDraw_Tag|kHasImage_Tag,
         SkRect src;
         SkRect dst;
         SkCanvas::SrcRectConstraint constraint);
+// Only made by SkRecordBatchDraws(), from runs of DrawBitmapRect{,Fast} sharing a bitmap and paint.
+// srcs is null if none of the batched draws had a src rect.
+RECORD(DrawBitmapRects, kDraw_Tag|kHasImage_Tag,
+        Optional<SkPaint> paint;
+        ImmutableBitmap bitmap;
+        PODArray<SkRect> srcs;
+        PODArray<SkRect> dsts;
+        int count;
+        SkCanvas::SrcRectConstraint constraint);
 RECORD(DrawDRRect, kDraw_Tag,
         SkPaint paint;
         SkRRect outer;
@@ -316,6 +327,11 @@ RECORD(DrawRRect, kDraw_Tag,
 RECORD(DrawRect, kDraw_Tag,
         SkPaint paint;
         SkRect rect);
+// Only made by SkRecordBatchDraws(), from runs of DrawRect sharing a paint.
+RECORD(DrawRects, kDraw_Tag,
+        SkPaint paint;
+        PODArray<SkRect> rects;
+        int count);
 RECORD(DrawText, kDraw_Tag|kHasText_Tag,
         SkPaint paint;
         PODArray<char> text;
@@ -8,6 +8,7 @@
 #include "SkBitmapRegionCanvas.h"
 #include "SkBitmapRegionCodec.h"
 #include "SkBitmapRegionDecoder.h"
+#include "SkBitmapRegionTiled.h"
 #include "SkAndroidCodec.h"
 #include "SkCodec.h"
 #include "SkCodecPriv.h"
@@ -49,7 +50,8 @@ SkBitmapRegionDecoder* SkBitmapRegionDecoder::Create(
 
             return new SkBitmapRegionCanvas(codec.detach());
         }
-        case kAndroidCodec_Strategy: {
+        case kAndroidCodec_Strategy:
+        case kTileCache_Strategy: {
             SkAutoTDelete<SkAndroidCodec> codec =
                     SkAndroidCodec::NewFromStream(streamDeleter.detach());
             if (nullptr == codec) {
@@ -67,6 +69,9 @@ SkBitmapRegionDecoder* SkBitmapRegionDecoder::Create(
                     return nullptr;
             }
 
+            if (kTileCache_Strategy == strategy) {
+                return new SkBitmapRegionTiled(codec.detach());
+            }
             return new SkBitmapRegionCodec(codec.detach());
         }
         default:
@@ -0,0 +1,247 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAndroidCodec.h"
+#include "SkBitmapRegionCodec.h"
+#include "SkBitmapRegionTiled.h"
+#include "SkCodecPriv.h"
+#include "SkNextID.h"
+#include "SkPixelRef.h"
+#include "SkResourceCache.h"
+
+namespace {
+static unsigned gRegionTileKeyNamespaceLabel;
+
+static uint64_t make_shared_id(uint32_t decoderID) {
+    uint64_t sharedID = SkSetFourByteTag('b', 'r', 'd', 't');
+    return (sharedID << 32) | decoderID;
+}
+
+struct RegionTileKey : public SkResourceCache::Key {
+public:
+    RegionTileKey(uint32_t decoderID, int tileX, int tileY, int sampleSize, SkColorType colorType,
+                  bool requireUnpremul)
+        : fDecoderID(decoderID)
+        , fTileX(tileX)
+        , fTileY(tileY)
+        , fSampleSize(sampleSize)
+        , fColorType(colorType)
+        , fRequireUnpremul(requireUnpremul)
+    {
+        this->init(&gRegionTileKeyNamespaceLabel, make_shared_id(fDecoderID),
+                   sizeof(fDecoderID) + sizeof(fTileX) + sizeof(fTileY) + sizeof(fSampleSize) +
+                   sizeof(fColorType) + sizeof(fRequireUnpremul));
+    }
+
+    const uint32_t fDecoderID;
+    const int32_t  fTileX;
+    const int32_t  fTileY;
+    const int32_t  fSampleSize;
+    const int32_t  fColorType;
+    const int32_t  fRequireUnpremul;
+};
+
+struct RegionTileRec : public SkResourceCache::Rec {
+    RegionTileRec(const RegionTileKey& key, const SkBitmap& tile)
+        : fKey(key)
+        , fTile(tile)
+    {}
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(fKey) + fTile.getSize(); }
+    const char* getCategory() const override { return "bitmap-region-tile"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fTile.pixelRef()->diagnostic_only_getDiscardable();
+    }
+    SkResourceCache::PurgePriority getPurgePriority() const override {
+        return SkResourceCache::kDecodedImage_PurgePriority;
+    }
+
+    static bool Finder(const SkResourceCache::Rec& baseRec, void* contextTile) {
+        const RegionTileRec& rec = static_cast<const RegionTileRec&>(baseRec);
+        SkBitmap* result = (SkBitmap*)contextTile;
+
+        *result = rec.fTile;
+        result->lockPixels();
+        return SkToBool(result->getPixels());
+    }
+
+private:
+    RegionTileKey fKey;
+    SkBitmap      fTile;
+};
+} // namespace
+
+// Rounds towards negative infinity, so that subsets starting to the left of or above the image
+// still map onto the sample grid.
+static int floor_div(int numer, int denom) {
+    int quot = numer / denom;
+    return (numer % denom < 0) ? quot - 1 : quot;
+}
+
+SkBitmapRegionTiled::SkBitmapRegionTiled(SkAndroidCodec* codec)
+    : INHERITED(codec->getInfo().width(), codec->getInfo().height())
+    , fDecoder(new SkBitmapRegionCodec(codec))
+    , fUniqueID(SkNextID::ImageID())
+{}
+
+SkBitmapRegionTiled::~SkBitmapRegionTiled() {
+    SkResourceCache::PostPurgeSharedID(make_shared_id(fUniqueID));
+}
+
+bool SkBitmapRegionTiled::conversionSupported(SkColorType colorType) {
+    return fDecoder->conversionSupported(colorType);
+}
+
+SkEncodedFormat SkBitmapRegionTiled::getEncodedFormat() {
+    return fDecoder->getEncodedFormat();
+}
+
+bool SkBitmapRegionTiled::findTile(int tileX, int tileY, int sampleSize, SkColorType colorType,
+                                   bool requireUnpremul, SkBitmap* tile) const {
+    RegionTileKey key(fUniqueID, tileX, tileY, sampleSize, colorType, requireUnpremul);
+    return SkResourceCache::Find(key, RegionTileRec::Finder, tile);
+}
+
+void SkBitmapRegionTiled::addTile(int tileX, int tileY, int sampleSize, SkColorType colorType,
+                                  bool requireUnpremul, const SkBitmap& tile) const {
+    SkASSERT(tile.isImmutable());
+    RegionTileKey key(fUniqueID, tileX, tileY, sampleSize, colorType, requireUnpremul);
+    SkResourceCache::Add(new RegionTileRec(key, tile));
+}
+
+bool SkBitmapRegionTiled::decodeRegion(SkBitmap* bitmap, SkBRDAllocator* allocator,
+        const SkIRect& desiredSubset, int sampleSize, SkColorType prefColorType,
+        bool requireUnpremul) {
+
+    // Fix the input sampleSize if necessary.
+    if (sampleSize < 1) {
+        sampleSize = 1;
+    }
+
+    // Tiles live in the sampled image.  If it is too small to hold a single pixel, there is
+    // nothing worth caching.
+    const int sampledWidth = this->width() / sampleSize;
+    const int sampledHeight = this->height() / sampleSize;
+    if (sampledWidth <= 0 || sampledHeight <= 0 || desiredSubset.isEmpty()) {
+        return fDecoder->decodeRegion(bitmap, allocator, desiredSubset, sampleSize, prefColorType,
+                                      requireUnpremul);
+    }
+
+    // The size of the output bitmap is determined by the size of the requested subset, as it is
+    // for SkBitmapRegionCodec.  Pixels outside of the image are left transparent.
+    const SkIRect outRect = SkIRect::MakeXYWH(floor_div(desiredSubset.left(), sampleSize),
+                                              floor_div(desiredSubset.top(), sampleSize),
+                                              SkTMax(1, desiredSubset.width() / sampleSize),
+                                              SkTMax(1, desiredSubset.height() / sampleSize));
+    SkIRect visible = outRect;
+    if (!visible.intersect(SkIRect::MakeWH(sampledWidth, sampledHeight))) {
+        return false;
+    }
+
+    const int firstTileX = visible.left() / kTileSize;
+    const int firstTileY = visible.top() / kTileSize;
+    const int tileCountX = (visible.right() - 1) / kTileSize - firstTileX + 1;
+    const int tileCountY = (visible.bottom() - 1) / kTileSize - firstTileY + 1;
+    SkAutoTArray<SkBitmap> tiles(tileCountX * tileCountY);
+
+    // Find the bounds, in tiles, of everything that has not been cached yet.
+    SkIRect missing = SkIRect::MakeEmpty();
+    for (int y = 0; y < tileCountY; y++) {
+        for (int x = 0; x < tileCountX; x++) {
+            if (!this->findTile(firstTileX + x, firstTileY + y, sampleSize, prefColorType,
+                                requireUnpremul, &tiles[y * tileCountX + x])) {
+                missing.join(SkIRect::MakeXYWH(x, y, 1, 1));
+            }
+        }
+    }
+
+    // Decode the missing tiles in a single pass, so that the codec scans each row of the encoded
+    // image at most once, and split the result into cacheable tiles.
+    if (!missing.isEmpty()) {
+        const int tileSrcSize = kTileSize * sampleSize;
+        const SkIRect srcRect = SkIRect::MakeLTRB(
+                (firstTileX + missing.left()) * tileSrcSize,
+                (firstTileY + missing.top()) * tileSrcSize,
+                SkTMin(this->width(), (firstTileX + missing.right()) * tileSrcSize),
+                SkTMin(this->height(), (firstTileY + missing.bottom()) * tileSrcSize));
+        SkBitmap decoded;
+        if (!fDecoder->decodeRegion(&decoded, nullptr, srcRect, sampleSize, prefColorType,
+                                    requireUnpremul)) {
+            return false;
+        }
+
+        for (int y = missing.top(); y < missing.bottom(); y++) {
+            for (int x = missing.left(); x < missing.right(); x++) {
+                SkBitmap* tile = &tiles[y * tileCountX + x];
+                if (!tile->isNull()) {
+                    continue;
+                }
+                SkBitmap slice;
+                if (!decoded.extractSubset(&slice,
+                        SkIRect::MakeXYWH((x - missing.left()) * kTileSize,
+                                          (y - missing.top()) * kTileSize,
+                                          kTileSize, kTileSize))) {
+                    SkCodecPrintf("Error: Decoded region is smaller than expected.\n");
+                    return false;
+                }
+                if (!slice.copyTo(tile, SkResourceCache::GetAllocator())) {
+                    SkCodecPrintf("Error: Could not allocate tile.\n");
+                    return false;
+                }
+                tile->setImmutable();
+                this->addTile(firstTileX + x, firstTileY + y, sampleSize, prefColorType,
+                              requireUnpremul, *tile);
+            }
+        }
+    }
+
+    // Initialize the destination bitmap to match the tiles.
+    const SkBitmap& firstTile = tiles[0];
+    SkImageInfo outInfo = firstTile.info().makeWH(outRect.width(), outRect.height());
+    bitmap->setInfo(outInfo);
+    if (!bitmap->tryAllocPixels(allocator, firstTile.getColorTable())) {
+        SkCodecPrintf("Error: Could not allocate pixels.\n");
+        return false;
+    }
+
+    // FIXME: skbug.com/4538
+    // It is important that we use the rowBytes on the pixelRef.  They may not be
+    // set properly on the bitmap.
+    SkPixelRef* pr = SkRef(bitmap->pixelRef());
+    bitmap->setInfo(outInfo, pr->rowBytes());
+    bitmap->setPixelRef(pr)->unref();
+    bitmap->lockPixels();
+
+    // Zero the bitmap if the region is not completely within the image.
+    SkCodec::ZeroInitialized zeroInit = allocator ? allocator->zeroInit() :
+            SkCodec::kNo_ZeroInitialized;
+    if (visible != outRect && SkCodec::kNo_ZeroInitialized == zeroInit) {
+        memset(bitmap->getPixels(), 0, outInfo.getSafeSize(bitmap->rowBytes()));
+    }
+
+    const size_t bytesPerPixel = outInfo.bytesPerPixel();
+    for (int y = 0; y < tileCountY; y++) {
+        for (int x = 0; x < tileCountX; x++) {
+            const SkBitmap& tile = tiles[y * tileCountX + x];
+            const SkIRect tileRect = SkIRect::MakeXYWH((firstTileX + x) * kTileSize,
+                                                       (firstTileY + y) * kTileSize,
+                                                       tile.width(), tile.height());
+            SkIRect copyRect = tileRect;
+            if (!copyRect.intersect(visible)) {
+                continue;
+            }
+            for (int row = copyRect.top(); row < copyRect.bottom(); row++) {
+                memcpy(bitmap->getAddr(copyRect.left() - outRect.left(), row - outRect.top()),
+                       tile.getAddr(copyRect.left() - tileRect.left(), row - tileRect.top()),
+                       copyRect.width() * bytesPerPixel);
+            }
+        }
+    }
+
+    return true;
+}
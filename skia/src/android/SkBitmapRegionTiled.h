@@ -0,0 +1,62 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBitmapRegionTiled_DEFINED
+#define SkBitmapRegionTiled_DEFINED
+
+#include "SkBitmap.h"
+#include "SkBitmapRegionDecoder.h"
+
+class SkAndroidCodec;
+class SkBitmapRegionCodec;
+
+/*
+ * This class implements SkBitmapRegionDecoder by splitting the sampled image into fixed size
+ * tiles and keeping decoded tiles in the SkResourceCache.  Requests for a region only decode
+ * the tiles which are not already cached, so panning across a large image only pays for the
+ * newly exposed rows and columns.  The missing tiles are decoded in a single pass of an
+ * SkBitmapRegionCodec.
+ *
+ * Tiles are aligned to multiples of sampleSize in the original image, so a requested subset
+ * is snapped down to a multiple of sampleSize before sampling.
+ */
+class SkBitmapRegionTiled : public SkBitmapRegionDecoder {
+public:
+
+    /*
+     * Takes ownership of pointer to codec
+     */
+    SkBitmapRegionTiled(SkAndroidCodec* codec);
+
+    ~SkBitmapRegionTiled() override;
+
+    bool decodeRegion(SkBitmap* bitmap, SkBRDAllocator* allocator,
+                      const SkIRect& desiredSubset, int sampleSize,
+                      SkColorType colorType, bool requireUnpremul) override;
+
+    bool conversionSupported(SkColorType colorType) override;
+
+    SkEncodedFormat getEncodedFormat() override;
+
+    // The width and height of a tile, in sampled pixels.
+    static const int kTileSize = 256;
+
+private:
+
+    bool findTile(int tileX, int tileY, int sampleSize, SkColorType colorType,
+                  bool requireUnpremul, SkBitmap* tile) const;
+    void addTile(int tileX, int tileY, int sampleSize, SkColorType colorType,
+                 bool requireUnpremul, const SkBitmap& tile) const;
+
+    SkAutoTDelete<SkBitmapRegionCodec> fDecoder;
+    const uint32_t                     fUniqueID;
+
+    typedef SkBitmapRegionDecoder INHERITED;
+
+};
+
+#endif // SkBitmapRegionTiled_DEFINED
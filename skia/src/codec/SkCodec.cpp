@@ -17,6 +17,7 @@
 #endif
 #include "SkRawCodec.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 #include "SkWbmpCodec.h"
 #include "SkWebpCodec.h"
 
@@ -196,6 +197,11 @@ SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t
         return kInvalidScale;
     }
 
+    if (options->fParallelDecode && !options->fSubset && this->onSupportsParallelDecode() &&
+            this->parallelDecode(info, pixels, rowBytes, *options, ctable, ctableCount)) {
+        return kSuccess;
+    }
+
     // On an incomplete decode, the subclass will specify the number of scanlines that it decoded
     // successfully.
     int rowsDecoded = 0;
@@ -219,6 +225,68 @@ SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t
     return result;
 }
 
+// Bands smaller than this are not worth the cost of parsing the stream again.
+static const int kMinParallelDecodeRows = 128;
+
+bool SkCodec::parallelDecode(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                             const Options& options, SkPMColor ctable[], int* ctableCount) {
+    const int bandCount = SkTMin(sk_num_cores(), info.height() / kMinParallelDecodeRows);
+    if (bandCount < 2 || kTopDown_SkScanlineOrder != this->getScanlineOrder()) {
+        return false;
+    }
+
+    // Each band gets its own codec reading a duplicate of our stream.  Create them up front so
+    // that an unduplicatable stream is detected before any pixels are written.
+    SkAutoTArray<SkAutoTDelete<SkCodec>> codecs(bandCount);
+    for (int i = 0; i < bandCount; i++) {
+        SkStreamRewindable* stream = fStream->duplicate();
+        if (!stream) {
+            return false;
+        }
+        codecs[i].reset(SkCodec::NewFromStream(stream));
+        if (!codecs[i]) {
+            return false;
+        }
+    }
+
+    Options bandOptions;
+    bandOptions.fZeroInitialized = options.fZeroInitialized;
+    SkAutoTArray<bool> succeeded(bandCount);
+    SkTaskGroup().batch(bandCount, [&](int i) {
+        const int top = i * info.height() / bandCount;
+        const int bottom = (i + 1) * info.height() / bandCount;
+
+        // Only the first band reports the color table to the caller.
+        SkPMColor bandColors[256];
+        int bandColorCount = 256;
+        SkPMColor* bandCtable = ctable ? (0 == i ? ctable : bandColors) : nullptr;
+        int* bandCtableCount = ctableCount ? (0 == i ? ctableCount : &bandColorCount) : nullptr;
+
+        SkCodec* codec = codecs[i].get();
+        succeeded[i] = kSuccess == codec->startScanlineDecode(info, &bandOptions, bandCtable,
+                                                              bandCtableCount) &&
+                       (0 == top || codec->skipScanlines(top)) &&
+                       bottom - top == codec->getScanlines(SkTAddOffset<void>(pixels,
+                                                                              top * rowBytes),
+                                                           bottom - top, rowBytes);
+    });
+
+    // An incomplete or failed band is rare enough that it is simplest to decode serially and let
+    // onGetPixels() report the error and fill in the missing rows.
+    for (int i = 0; i < bandCount; i++) {
+        if (!succeeded[i]) {
+            if (kYes_ZeroInitialized == options.fZeroInitialized) {
+                // onGetPixels() will skip filling rows it cannot decode, trusting them to be zero.
+                for (int y = 0; y < info.height(); y++) {
+                    sk_bzero(SkTAddOffset<void>(pixels, y * rowBytes), info.minRowBytes());
+                }
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
 SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t rowBytes) {
     return this->getPixels(info, pixels, rowBytes, nullptr, nullptr, nullptr);
 }
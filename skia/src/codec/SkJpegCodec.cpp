@@ -276,6 +276,12 @@ bool SkJpegCodec::onDimensionsSupported(const SkISize& size) {
     return true;
 }
 
+bool SkJpegCodec::onSupportsParallelDecode() const {
+    // Progressive images must be fully buffered before any row can be output, so only
+    // baseline images gain anything from decoding bands of rows in parallel.
+    return !fDecoderMgr->dinfo()->progressive_mode;
+}
+
 /*
  * Performs the jpeg decode
  */
@@ -57,6 +57,8 @@ protected:
 
     bool onDimensionsSupported(const SkISize&) override;
 
+    bool onSupportsParallelDecode() const override;
+
 private:
 
     /*
@@ -142,6 +142,9 @@ struct BitmapRec : public SkResourceCache::Rec {
     SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
         return fBitmap.pixelRef()->diagnostic_only_getDiscardable();
     }
+    SkResourceCache::PurgePriority getPurgePriority() const override {
+        return SkResourceCache::kDecodedImage_PurgePriority;
+    }
 
     static bool Finder(const SkResourceCache::Rec& baseRec, void* contextBitmap) {
         const BitmapRec& rec = static_cast<const BitmapRec&>(baseRec);
@@ -257,6 +260,9 @@ struct MipMapRec : public SkResourceCache::Rec {
     SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
         return fMipMap->diagnostic_only_getDiscardable();
     }
+    SkResourceCache::PurgePriority getPurgePriority() const override {
+        return SkResourceCache::kMipMap_PurgePriority;
+    }
 
     static bool Finder(const SkResourceCache::Rec& baseRec, void* contextMip) {
         const MipMapRec& rec = static_cast<const MipMapRec&>(baseRec);
@@ -10,6 +10,8 @@
 #include "SkBitmapProvider.h"
 #include "SkColorPriv.h"
 #include "SkErrorInternals.h"
+#include "SkLinearBitmapPipeline.h"
+#include "SkPM4fPriv.h"
 #include "SkPixelRef.h"
 #include "SkReadBuffer.h"
 #include "SkWriteBuffer.h"
@@ -20,10 +22,62 @@
 #include "effects/GrSimpleTextureEffect.h"
 #endif
 
+bool gSkUseLinearBitmapPipeline =
+#ifdef SK_USE_LINEAR_BITMAP_PIPELINE
+        true;
+#else
+        false;
+#endif
+
+// Shades with SkLinearBitmapPipeline. It keeps the SkBitmapProcState of its base class only to
+// hold the locked pixels and the flags.
+class SkBitmapProcShader::LinearPipelineContext : public BitmapProcShaderContext {
+public:
+    LinearPipelineContext(const SkShader& shader, const ContextRec& rec, SkBitmapProcState* state,
+                          const SkMatrix& totalInverse)
+        : INHERITED(shader, rec, state)
+        , fPipeline(totalInverse, (SkFilterQuality)state->fFilterLevel,
+                    (TileMode)state->fTileModeX, (TileMode)state->fTileModeY, state->fPixmap)
+    {}
+
+    void shadeSpan4f(int x, int y, SkPM4f dstC[], int count) override {
+        fPipeline.shadeSpan4f(x, y, dstC, count);
+    }
+
+    void shadeSpan(int x, int y, SkPMColor dstC[], int count) override {
+        const int N = 128;
+        SkPM4f tmp[N];
+        while (count > 0) {
+            const int n = SkTMin(count, N);
+            fPipeline.shadeSpan4f(x, y, tmp, n);
+            for (int i = 0; i < n; ++i) {
+                dstC[i] = Sk4f_toL32(Sk4f::Load(tmp[i].fVec));
+            }
+            x += n;
+            dstC += n;
+            count -= n;
+        }
+    }
+
+    ShadeProc asAShadeProc(void** ctx) override { return nullptr; }
+
+private:
+    SkLinearBitmapPipeline fPipeline;
+
+    typedef BitmapProcShaderContext INHERITED;
+};
+
+// The SkBitmapProcState is stored outside of the context object, with the context holding a
+// pointer to it. Room for the larger pipeline context is only reserved while the pipeline may be
+// used, so that the common case still fits in SkTBlitterAllocator.
+static size_t state_offset(size_t procContextSize, size_t pipelineContextSize) {
+    return gSkUseLinearBitmapPipeline ? SkTMax(procContextSize, pipelineContextSize)
+                                      : procContextSize;
+}
+
 size_t SkBitmapProcShader::ContextSize() {
-    // The SkBitmapProcState is stored outside of the context object, with the context holding
-    // a pointer to it.
-    return sizeof(BitmapProcShaderContext) + sizeof(SkBitmapProcState);
+    return state_offset(sizeof(BitmapProcShaderContext), sizeof(LinearPipelineContext)) +
+           sizeof(SkBitmapProcState);
 }
 
 SkBitmapProcShader::SkBitmapProcShader(const SkBitmap& src, TileMode tmx, TileMode tmy,
@@ -72,6 +126,28 @@ bool SkBitmapProcShader::isOpaque() const {
     return fRawBitmap.isOpaque();
 }
 
+static bool choose_linear_pipeline(const SkShader::ContextRec& rec,
+                                   const SkBitmapProcState& state) {
+    // The pipeline has no paint alpha stage, and for PMColor destinations the procs are faster.
+    if (SkShader::ContextRec::kPM4f_DstType != rec.fPreferredDstType ||
+        0xFF != rec.fPaint->getAlpha()) {
+        return false;
+    }
+    // Checked on the paint: medium quality may have swapped in a mipmap level and its matrix.
+    if (!SkLinearBitmapPipeline::SupportsFilterQuality(rec.fPaint->getFilterQuality())) {
+        return false;
+    }
+    switch (state.fPixmap.colorType()) {
+        case kRGBA_8888_SkColorType:
+        case kBGRA_8888_SkColorType:
+        case kIndex_8_SkColorType:
+        case kGray_8_SkColorType:
+            return true;
+        default:
+            return false;
+    }
+}
+
 SkShader::Context* SkBitmapProcShader::MakeContext(const SkShader& shader,
                                                    TileMode tmx, TileMode tmy,
                                                    const SkBitmapProvider& provider,
@@ -82,7 +158,8 @@ SkShader::Context* SkBitmapProcShader::MakeContext(const SkShader& shader,
         return nullptr;
     }
 
-    void* stateStorage = (char*)storage + sizeof(BitmapProcShaderContext);
+    void* stateStorage = (char*)storage + state_offset(sizeof(BitmapProcShaderContext),
+                                                       sizeof(LinearPipelineContext));
     SkBitmapProcState* state = new (stateStorage) SkBitmapProcState(provider, tmx, tmy);
 
     SkASSERT(state);
@@ -91,6 +168,9 @@ SkShader::Context* SkBitmapProcShader::MakeContext(const SkShader& shader,
         return nullptr;
     }
 
+    if (gSkUseLinearBitmapPipeline && choose_linear_pipeline(rec, *state)) {
+        return new (storage) LinearPipelineContext(shader, rec, state, totalInverse);
+    }
     return new (storage) BitmapProcShaderContext(shader, rec, state);
 }
 
@@ -63,6 +63,8 @@ protected:
 private:
     friend class SkImageShader;
 
+    class LinearPipelineContext;
+
     static size_t ContextSize();
     static Context* MakeContext(const SkShader&, TileMode tmx, TileMode tmy,
                                 const SkBitmapProvider&, const ContextRec&, void* storage);
@@ -70,6 +72,12 @@ private:
     typedef SkShader INHERITED;
 };
 
+/** If true, bitmap shaders shade into PM4f destinations with SkLinearBitmapPipeline instead of
+    the SkBitmapProcState procs, where the pipeline supports the source and paint. Defaults to
+    true when SK_USE_LINEAR_BITMAP_PIPELINE is defined. Only change it between draws.
+*/
+extern bool gSkUseLinearBitmapPipeline;
+
 // Commonly used allocator. It currently is only used to allocate up to 3 objects. The total
 // bytes requested is calculated using one of our large shaders, its context size plus the size of
 // an Sk3DBlitter in SkDraw.cpp
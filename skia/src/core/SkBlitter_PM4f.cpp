@@ -70,9 +70,8 @@ public:
                 if (aa == 255) {
                     fState.fProc1(fState.fXfer, device, &fState.fPM4f, count, nullptr);
                 } else {
-                    for (int i = 0; i < count; ++i) {
-                        fState.fProc1(fState.fXfer, &device[i], &fState.fPM4f, 1, antialias);
-                    }
+                    fState.fProc1(fState.fXfer, device, &fState.fPM4f, count,
+                                  fState.coverage(aa, count));
                 }
             }
             device += count;
@@ -203,9 +202,8 @@ public:
                 if (aa == 255) {
                     fState.fProcN(fState.fXfer, device, fState.fBuffer, count, nullptr);
                 } else {
-                    for (int i = 0; i < count; ++i) {
-                        fState.fProcN(fState.fXfer, &device[i], &fState.fBuffer[i], 1, antialias);
-                    }
+                    fState.fProcN(fState.fXfer, device, fState.fBuffer, count,
+                                  fState.coverage(aa, count));
                 }
             }
             device += count;
@@ -295,12 +293,20 @@ struct State4f {
         } else {
             fPM4f = SkColor4f::FromColor(paint.getColor()).premul();
         }
+        fCoverage.reset(info.width());
         fFlags = 0;
     }
 
+    // Returns count copies of aa, so a partially covered run is a single call to our procs.
+    const SkAlpha* coverage(SkAlpha aa, int count) {
+        memset(fCoverage.get(), aa, count);
+        return fCoverage.get();
+    }
+
     SkXfermode*             fXfer;
     SkPM4f                  fPM4f;
     SkAutoTMalloc<SkPM4f>   fBuffer;
+    SkAutoTMalloc<SkAlpha>  fCoverage;
     uint32_t                fFlags;
 };
 
@@ -85,6 +85,10 @@ void SkCachedData::internalRef(bool fromCache) const {
     AutoMutexWritable(this)->inMutexRef(fromCache);
 }
 
+bool SkCachedData::moveToDiscardable(SkDiscardableMemory* (*factory)(size_t)) {
+    return AutoMutexWritable(this)->inMutexMoveToDiscardable(factory);
+}
+
 void SkCachedData::internalUnref(bool fromCache) const {
     if (AutoMutexWritable(this)->inMutexUnref(fromCache)) {
         // can't delete inside doInternalUnref, since it is locking a mutex (which we own)
@@ -176,6 +180,29 @@ void SkCachedData::inMutexUnlock() {
     this->setData(nullptr);   // signal that we're in an unlocked state
 }
 
+bool SkCachedData::inMutexMoveToDiscardable(SkDiscardableMemory* (*factory)(size_t)) {
+    fMutex.assertHeld();
+
+    // Only the cache may own us, otherwise a client could be reading fStorage.fMalloc.
+    if (kMalloc_StorageType != fStorageType || !fInCache || 1 != fRefCnt) {
+        return false;
+    }
+    SkASSERT(!fIsLocked);
+
+    SkDiscardableMemory* dm = factory(fSize);
+    if (!dm) {
+        return false;
+    }
+    // The factory hands back locked memory; copy into it and leave it unlocked like we are.
+    memcpy(dm->data(), fStorage.fMalloc, fSize);
+    dm->unlock();
+
+    sk_free(fStorage.fMalloc);
+    fStorage.fDM = dm;
+    fStorageType = kDiscardableMemory_StorageType;
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 #ifdef SK_DEBUG
@@ -35,6 +35,13 @@ public:
         return kDiscardableMemory_StorageType == fStorageType ? fStorage.fDM : nullptr;
     }
 
+    /**
+     *  If this data is malloc-backed and only referenced by the cache (so it is unlocked), copy
+     *  it into a fresh (unlocked) SkDiscardableMemory from factory and free the malloc storage.
+     *  Returns true if the data was moved.
+     */
+    bool moveToDiscardable(SkDiscardableMemory* (*factory)(size_t bytes));
+
 protected:
     // called when fData changes. could be nullptr.
     virtual void onDataChange(void* oldData, void* newData) {}
@@ -65,6 +72,7 @@ private:
     bool inMutexUnref(bool fromCache);  // returns true if we should delete "this"
     void inMutexLock();
     void inMutexUnlock();
+    bool inMutexMoveToDiscardable(SkDiscardableMemory* (*factory)(size_t));
 
     // called whenever our fData might change (lock or unlock)
     void setData(void* newData) {
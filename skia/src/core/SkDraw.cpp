@@ -1100,6 +1100,13 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         return;
     }
 
+    // The mask filter may cache its mask for the caller's path, if that is what gets drawn.
+    uint32_t pathGenID = 0;
+    if (paint->getMaskFilter() && pathPtr == &origSrcPath && !pathIsMutable &&
+            !origSrcPath.isVolatile()) {
+        pathGenID = origSrcPath.getGenerationID();
+    }
+
     // avoid possibly allocating a new path in transform if we can
     SkPath* devPathPtr = pathIsMutable ? pathPtr : &tmpPath;
 
@@ -1118,7 +1125,8 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
     if (paint->getMaskFilter()) {
         SkPaint::Style style = doFill ? SkPaint::kFill_Style :
             SkPaint::kStroke_Style;
-        if (paint->getMaskFilter()->filterPath(*devPathPtr, *fMatrix, *fRC, blitter, style)) {
+        if (paint->getMaskFilter()->filterPath(*devPathPtr, *fMatrix, *fRC, blitter, style,
+                                               pathGenID, *matrix)) {
             return; // filterPath() called the blitter, so we're done
         }
     }
@@ -44,6 +44,7 @@ SkGlyphCache::SkGlyphCache(SkTypeface* typeface, const SkDescriptor* desc, SkSca
     SkASSERT(ctx);
 
     fPrev = fNext = nullptr;
+    fLastUse = 0;
 
     fScalerContext->getFontMetrics(&fFontMetrics);
 
@@ -475,11 +476,9 @@ size_t SkGlyphCache_Globals::setCacheSizeLimit(size_t newLimit) {
         newLimit = minLimit;
     }
 
-    Exclusive ac(fLock);
-
-    size_t prevLimit = fCacheSizeLimit;
-    fCacheSizeLimit = newLimit;
-    this->internalPurge();
+    size_t prevLimit = this->getCacheSizeLimit();
+    fCacheSizeLimit.store(newLimit, sk_memory_order_relaxed);
+    this->purge();
     return prevLimit;
 }
 
@@ -488,17 +487,14 @@ int SkGlyphCache_Globals::setCacheCountLimit(int newCount) {
         newCount = 0;
     }
 
-    Exclusive ac(fLock);
-
-    int prevCount = fCacheCountLimit;
-    fCacheCountLimit = newCount;
-    this->internalPurge();
+    int prevCount = this->getCacheCountLimit();
+    fCacheCountLimit.store(newCount, sk_memory_order_relaxed);
+    this->purge();
     return prevCount;
 }
 
 void SkGlyphCache_Globals::purgeAll() {
-    Exclusive ac(fLock);
-    this->internalPurge(fTotalMemoryUsed);
+    this->purge(this->getTotalMemoryUsed());
 }
 
 /*  This guy calls the visitor from within the mutext lock, so the visitor
@@ -517,18 +513,19 @@ SkGlyphCache* SkGlyphCache::VisitCache(SkTypeface* typeface,
     SkASSERT(desc);
 
     SkGlyphCache_Globals& globals = get_globals();
+    SkGlyphCache_Globals::Shard& shard = globals.shardFor(*desc);
     SkGlyphCache*         cache;
 
     {
-        Exclusive ac(globals.fLock);
+        Exclusive ac(shard.fLock);
 
-        globals.validate();
+        globals.validate(shard);
 
-        for (cache = globals.internalGetHead(); cache != nullptr; cache = cache->fNext) {
+        for (cache = shard.fHead; cache != nullptr; cache = cache->fNext) {
             if (cache->fDesc->equals(*desc)) {
-                globals.internalDetachCache(cache);
+                globals.internalDetachCache(&shard, cache);
                 if (!proc(cache, context)) {
-                    globals.internalAttachCacheToHead(cache);
+                    globals.internalAttachCacheToHead(&shard, cache);
                     cache = nullptr;
                 }
                 return cache;
@@ -632,57 +629,69 @@ void SkGlyphCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
 }
 
 void SkGlyphCache::VisitAll(Visitor visitor, void* context) {
-    SkGlyphCache_Globals& globals = get_globals();
-    Exclusive ac(globals.fLock);
-    SkGlyphCache*         cache;
+    get_globals().visitAll(visitor, context);
+}
+
+///////////////////////////////////////////////////////////////////////////////
 
-    globals.validate();
+void SkGlyphCache_Globals::visitAll(SkGlyphCache::Visitor visitor, void* context) {
+    for (int i = 0; i < fShardCount; i++) {
+        Shard& shard = fShards[i];
+        Exclusive ac(shard.fLock);
 
-    for (cache = globals.internalGetHead(); cache != nullptr; cache = cache->fNext) {
-        visitor(*cache, context);
+        this->validate(shard);
+
+        for (SkGlyphCache* cache = shard.fHead; cache != nullptr; cache = cache->fNext) {
+            visitor(*cache, context);
+        }
     }
 }
 
-///////////////////////////////////////////////////////////////////////////////
-
 void SkGlyphCache_Globals::attachCacheToHead(SkGlyphCache* cache) {
-    Exclusive ac(fLock);
+    Shard& shard = this->shardFor(*cache->fDesc);
+    {
+        Exclusive ac(shard.fLock);
 
-    this->validate();
-    cache->validate();
+        this->validate(shard);
+        cache->validate();
 
-    this->internalAttachCacheToHead(cache);
-    this->internalPurge();
+        this->internalAttachCacheToHead(&shard, cache);
+    }
+    this->purge();
 }
 
-SkGlyphCache* SkGlyphCache_Globals::internalGetTail() const {
-    SkGlyphCache* cache = fHead;
-    if (cache) {
-        while (cache->fNext) {
-            cache = cache->fNext;
-        }
+void SkGlyphCache_Globals::countShard(const Shard& shard, int* count, size_t* bytes) const {
+    *count = 0;
+    *bytes = 0;
+    for (const SkGlyphCache* cache = shard.fHead; cache != nullptr; cache = cache->fNext) {
+        SkASSERT(cache->fNext == nullptr || cache->fNext->fPrev == cache);
+        SkASSERT(cache->fNext != nullptr || cache == shard.fTail);
+        *count += 1;
+        *bytes += cache->fMemoryUsed;
     }
-    return cache;
 }
 
-size_t SkGlyphCache_Globals::internalPurge(size_t minBytesNeeded) {
-    this->validate();
+size_t SkGlyphCache_Globals::purge(size_t minBytesNeeded) {
+    const size_t totalMemoryUsed = this->getTotalMemoryUsed();
+    const size_t cacheSizeLimit  = this->getCacheSizeLimit();
+    const int    cacheCount      = this->getCacheCountUsed();
+    const int    cacheCountLimit = this->getCacheCountLimit();
 
     size_t bytesNeeded = 0;
-    if (fTotalMemoryUsed > fCacheSizeLimit) {
-        bytesNeeded = fTotalMemoryUsed - fCacheSizeLimit;
+    if (totalMemoryUsed > cacheSizeLimit) {
+        bytesNeeded = totalMemoryUsed - cacheSizeLimit;
     }
     bytesNeeded = SkTMax(bytesNeeded, minBytesNeeded);
     if (bytesNeeded) {
         // no small purges!
-        bytesNeeded = SkTMax(bytesNeeded, fTotalMemoryUsed >> 2);
+        bytesNeeded = SkTMax(bytesNeeded, totalMemoryUsed >> 2);
     }
 
     int countNeeded = 0;
-    if (fCacheCount > fCacheCountLimit) {
-        countNeeded = fCacheCount - fCacheCountLimit;
+    if (cacheCount > cacheCountLimit) {
+        countNeeded = cacheCount - cacheCountLimit;
         // no small purges!
-        countNeeded = SkMax32(countNeeded, fCacheCount >> 2);
+        countNeeded = SkMax32(countNeeded, cacheCount >> 2);
     }
 
     // early exit
@@ -693,21 +702,41 @@ size_t SkGlyphCache_Globals::internalPurge(size_t minBytesNeeded) {
     size_t  bytesFreed = 0;
     int     countFreed = 0;
 
-    // we start at the tail and proceed backwards, as the linklist is in LRU
-    // order, with unimportant entries at the tail.
-    SkGlyphCache* cache = this->internalGetTail();
-    while (cache != nullptr &&
-           (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
-        SkGlyphCache* prev = cache->fPrev;
-        bytesFreed += cache->fMemoryUsed;
-        countFreed += 1;
+    // Each shard's list is in LRU order, with unimportant entries at the tail, so the least
+    // recently used cache overall is the shard tail with the oldest stamp. The stamps wrap, so
+    // they are compared by their difference.
+    while (bytesFreed < bytesNeeded || countFreed < countNeeded) {
+        int oldest = -1;
+        uint32_t oldestUse = 0;
+        for (int i = 0; i < fShardCount; i++) {
+            Shard& shard = fShards[i];
+            Exclusive ac(shard.fLock);
+            if (shard.fTail && (oldest < 0 || (int32_t)(shard.fTail->fLastUse - oldestUse) < 0)) {
+                oldest = i;
+                oldestUse = shard.fTail->fLastUse;
+            }
+        }
+        if (oldest < 0) {
+            break;
+        }
 
-        this->internalDetachCache(cache);
-        delete cache;
-        cache = prev;
-    }
+        Shard& shard = fShards[oldest];
+        Exclusive ac(shard.fLock);
+
+        this->validate(shard);
 
-    this->validate();
+        // The tail may have changed since we looked; any tail of this shard is still old.
+        SkGlyphCache* cache = shard.fTail;
+        if (cache != nullptr) {
+            bytesFreed += cache->fMemoryUsed;
+            countFreed += 1;
+
+            this->internalDetachCache(&shard, cache);
+            delete cache;
+        }
+
+        this->validate(shard);
+    }
 
 #ifdef SPEW_PURGE_STATUS
     if (countFreed) {
@@ -719,30 +748,35 @@ size_t SkGlyphCache_Globals::internalPurge(size_t minBytesNeeded) {
     return bytesFreed;
 }
 
-void SkGlyphCache_Globals::internalAttachCacheToHead(SkGlyphCache* cache) {
+void SkGlyphCache_Globals::internalAttachCacheToHead(Shard* shard, SkGlyphCache* cache) {
     SkASSERT(nullptr == cache->fPrev && nullptr == cache->fNext);
-    if (fHead) {
-        fHead->fPrev = cache;
-        cache->fNext = fHead;
+    if (shard->fHead) {
+        shard->fHead->fPrev = cache;
+        cache->fNext = shard->fHead;
+    } else {
+        shard->fTail = cache;
     }
-    fHead = cache;
+    shard->fHead = cache;
+    cache->fLastUse = fUseCount.fetch_add(1, sk_memory_order_relaxed);
 
-    fCacheCount += 1;
-    fTotalMemoryUsed += cache->fMemoryUsed;
+    fCacheCount.fetch_add(1, sk_memory_order_relaxed);
+    fTotalMemoryUsed.fetch_add(cache->fMemoryUsed, sk_memory_order_relaxed);
 }
 
-void SkGlyphCache_Globals::internalDetachCache(SkGlyphCache* cache) {
-    SkASSERT(fCacheCount > 0);
-    fCacheCount -= 1;
-    fTotalMemoryUsed -= cache->fMemoryUsed;
+void SkGlyphCache_Globals::internalDetachCache(Shard* shard, SkGlyphCache* cache) {
+    SkASSERT(this->getCacheCountUsed() > 0);
+    fCacheCount.fetch_sub(1, sk_memory_order_relaxed);
+    fTotalMemoryUsed.fetch_sub(cache->fMemoryUsed, sk_memory_order_relaxed);
 
     if (cache->fPrev) {
         cache->fPrev->fNext = cache->fNext;
     } else {
-        fHead = cache->fNext;
+        shard->fHead = cache->fNext;
     }
     if (cache->fNext) {
         cache->fNext->fPrev = cache->fPrev;
+    } else {
+        shard->fTail = cache->fPrev;
     }
     cache->fPrev = cache->fNext = nullptr;
 }
@@ -764,21 +798,19 @@ void SkGlyphCache::validate() const {
 #endif
 }
 
-void SkGlyphCache_Globals::validate() const {
-    size_t computedBytes = 0;
-    int computedCount = 0;
+void SkGlyphCache_Globals::validate(const Shard& shard) const {
+    size_t computedBytes;
+    int computedCount;
+    this->countShard(shard, &computedCount, &computedBytes);
 
-    const SkGlyphCache* head = fHead;
-    while (head != nullptr) {
-        computedBytes += head->fMemoryUsed;
-        computedCount += 1;
-        head = head->fNext;
+    // Other shards change the totals concurrently, so they only add up with a single shard.
+    if (1 == fShardCount) {
+        SkASSERTF(this->getCacheCountUsed() == computedCount,
+                  "fCacheCount: %d, computedCount: %d", this->getCacheCountUsed(), computedCount);
+        SkASSERTF(this->getTotalMemoryUsed() == computedBytes,
+                  "fTotalMemoryUsed: %d, computedBytes: %d",
+                  this->getTotalMemoryUsed(), computedBytes);
     }
-
-    SkASSERTF(fCacheCount == computedCount, "fCacheCount: %d, computedCount: %d", fCacheCount,
-              computedCount);
-    SkASSERTF(fTotalMemoryUsed == computedBytes, "fTotalMemoryUsed: %d, computedBytes: %d",
-              fTotalMemoryUsed, computedBytes);
 }
 
 #endif
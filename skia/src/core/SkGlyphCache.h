@@ -255,6 +255,8 @@ private:
 
     SkGlyphCache*          fNext;
     SkGlyphCache*          fPrev;
+    // when this cache was last attached to the global list, see SkGlyphCache_Globals::purge
+    uint32_t               fLastUse;
     SkDescriptor* const    fDesc;
     SkScalerContext* const fScalerContext;
     SkPaint::FontMetrics   fFontMetrics;
@@ -11,6 +11,7 @@
 #include "SkGlyphCache.h"
 #include "SkMutex.h"
 #include "SkSpinlock.h"
+#include "SkTaskGroup.h"
 #include "SkTLS.h"
 
 #ifndef SK_DEFAULT_FONT_CACHE_COUNT_LIMIT
@@ -21,52 +22,89 @@
     #define SK_DEFAULT_FONT_CACHE_LIMIT     (2 * 1024 * 1024)
 #endif
 
+// Number of independently locked strike lists. Strikes land in a shard picked by their
+// descriptor's checksum, so threads working on different strikes do not serialize on one
+// lock. The budget and the LRU order used for purging stay global. 0 means one shard per
+// core, up to kMaxShardCount.
+#ifndef SK_DEFAULT_FONT_CACHE_SHARD_COUNT
+    #define SK_DEFAULT_FONT_CACHE_SHARD_COUNT   0
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 
 class SkGlyphCache_Globals {
 public:
-    SkGlyphCache_Globals() {
-        fHead = nullptr;
-        fTotalMemoryUsed = 0;
-        fCacheSizeLimit = SK_DEFAULT_FONT_CACHE_LIMIT;
-        fCacheCount = 0;
-        fCacheCountLimit = SK_DEFAULT_FONT_CACHE_COUNT_LIMIT;
+    enum {
+        kMaxShardCount = 16
+    };
+
+    struct Shard {
+        Shard() : fHead(nullptr), fTail(nullptr) {}
+
+        SkSpinlock    fLock;
+        SkGlyphCache* fHead;
+        SkGlyphCache* fTail;
+    };
+
+    static int DefaultShardCount() {
+        return SkTPin(SK_DEFAULT_FONT_CACHE_SHARD_COUNT > 0 ? SK_DEFAULT_FONT_CACHE_SHARD_COUNT
+                                                            : sk_num_cores(),
+                      1, (int)kMaxShardCount);
+    }
+
+    explicit SkGlyphCache_Globals(int shardCount = DefaultShardCount())
+        : fShardCount(shardCount)
+        , fShards(shardCount)
+        , fTotalMemoryUsed(0)
+        , fCacheSizeLimit(SK_DEFAULT_FONT_CACHE_LIMIT)
+        , fCacheCountLimit(SK_DEFAULT_FONT_CACHE_COUNT_LIMIT)
+        , fCacheCount(0)
+        , fUseCount(0) {
+        SkASSERT(shardCount > 0);
     }
 
     ~SkGlyphCache_Globals() {
-        SkGlyphCache* cache = fHead;
-        while (cache) {
-            SkGlyphCache* next = cache->fNext;
-            delete cache;
-            cache = next;
+        for (int i = 0; i < fShardCount; i++) {
+            SkGlyphCache* cache = fShards[i].fHead;
+            while (cache) {
+                SkGlyphCache* next = cache->fNext;
+                delete cache;
+                cache = next;
+            }
         }
     }
 
-    SkSpinlock     fLock;
+    int shardCount() const { return fShardCount; }
+    Shard& shardFor(const SkDescriptor& desc) {
+        return fShards[desc.getChecksum() % fShardCount];
+    }
+    Shard& shardAt(int index) { return fShards[index]; }
+    const Shard& shardAt(int index) const { return fShards[index]; }
 
-    SkGlyphCache* internalGetHead() const { return fHead; }
-    SkGlyphCache* internalGetTail() const;
+    // can only be called when the shard's lock is held
+    void countShard(const Shard&, int* count, size_t* bytes) const;
 
-    size_t getTotalMemoryUsed() const { return fTotalMemoryUsed; }
-    int getCacheCountUsed() const { return fCacheCount; }
+    size_t getTotalMemoryUsed() const { return fTotalMemoryUsed.load(sk_memory_order_relaxed); }
+    int getCacheCountUsed() const { return fCacheCount.load(sk_memory_order_relaxed); }
 
 #ifdef SK_DEBUG
-    void validate() const;
+    // can only be called when the shard's lock is held
+    void validate(const Shard&) const;
 #else
-    void validate() const {}
+    void validate(const Shard&) const {}
 #endif
 
-    int getCacheCountLimit() const { return fCacheCountLimit; }
+    int getCacheCountLimit() const { return fCacheCountLimit.load(sk_memory_order_relaxed); }
     int setCacheCountLimit(int limit);
 
-    size_t  getCacheSizeLimit() const { return fCacheSizeLimit; }
+    size_t  getCacheSizeLimit() const { return fCacheSizeLimit.load(sk_memory_order_relaxed); }
     size_t  setCacheSizeLimit(size_t limit);
 
     // returns true if this cache is over-budget either due to size limit
     // or count limit.
     bool isOverBudget() const {
-        return fCacheCount > fCacheCountLimit ||
-               fTotalMemoryUsed > fCacheSizeLimit;
+        return this->getCacheCountUsed() > this->getCacheCountLimit() ||
+               this->getTotalMemoryUsed() > this->getCacheSizeLimit();
     }
 
     void purgeAll(); // does not change budget
@@ -74,21 +112,29 @@ public:
     // call when a glyphcache is available for caching (i.e. not in use)
     void attachCacheToHead(SkGlyphCache*);
 
-    // can only be called when the mutex is already held
-    void internalDetachCache(SkGlyphCache*);
-    void internalAttachCacheToHead(SkGlyphCache*);
+    // calls visitor on every cached glyphcache, taking each shard's lock in turn
+    void visitAll(SkGlyphCache::Visitor, void* context);
+
+    // can only be called when the shard's lock is already held
+    void internalDetachCache(Shard*, SkGlyphCache*);
+    void internalAttachCacheToHead(Shard*, SkGlyphCache*);
 
 private:
-    SkGlyphCache* fHead;
-    size_t  fTotalMemoryUsed;
-    size_t  fCacheSizeLimit;
-    int32_t fCacheCountLimit;
-    int32_t fCacheCount;
+    const int           fShardCount;
+    SkAutoTArray<Shard> fShards;
+
+    SkAtomic<size_t>  fTotalMemoryUsed;
+    SkAtomic<size_t>  fCacheSizeLimit;
+    SkAtomic<int32_t> fCacheCountLimit;
+    SkAtomic<int32_t> fCacheCount;
+    // Stamps each cache as it is attached, so purging can compare the shards' tails.
+    SkAtomic<uint32_t> fUseCount;
 
     // Checkout budgets, modulated by the specified min-bytes-needed-to-purge,
-    // and attempt to purge caches to match.
+    // and attempt to purge caches to match, least recently used first across all shards.
+    // Takes each shard's lock in turn, so none may be held by the caller.
     // Returns number of bytes freed.
-    size_t internalPurge(size_t minBytesNeeded = 0);
+    size_t purge(size_t minBytesNeeded = 0);
 };
 
 #endif
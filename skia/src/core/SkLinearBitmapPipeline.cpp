@@ -279,12 +279,48 @@ private:
 template <typename Next = SkLinearBitmapPipeline::PointProcessorInterface>
 using AffineMatrix = PointProcessor<AffineMatrixStrategy, Next>;
 
+class PerspectiveMatrixStrategy {
+public:
+    PerspectiveMatrixStrategy(SkVector offset, SkVector scale, SkVector skew,
+                              SkVector zSkew, SkScalar zOffset)
+        : fXOffset{X(offset)}, fYOffset{Y(offset)}, fZOffset{zOffset}
+        , fXScale{X(scale)},   fYScale{Y(scale)}
+        , fXSkew{X(skew)},     fYSkew{Y(skew)}
+        , fZXSkew{X(zSkew)},   fZYSkew{Y(zSkew)} { }
+    void processPoints(Sk4f* xs, Sk4f* ys) {
+        Sk4f newXs = fXScale * *xs +  fXSkew * *ys + fXOffset;
+        Sk4f newYs =  fYSkew * *xs + fYScale * *ys + fYOffset;
+        Sk4f newZs = fZXSkew * *xs + fZYSkew * *ys + fZOffset;
+
+        *xs = newXs / newZs;
+        *ys = newYs / newZs;
+    }
+
+    template <typename Next>
+    bool maybeProcessSpan(SkPoint start, SkScalar length, int count, Next* next) {
+        return false;
+    }
+
+private:
+    const Sk4f fXOffset, fYOffset, fZOffset;
+    const Sk4f fXScale,  fYScale;
+    const Sk4f fXSkew,   fYSkew,  fZXSkew, fZYSkew;
+};
+template <typename Next = SkLinearBitmapPipeline::PointProcessorInterface>
+using PerspectiveMatrix = PointProcessor<PerspectiveMatrixStrategy, Next>;
+
 static SkLinearBitmapPipeline::PointProcessorInterface* choose_matrix(
     SkLinearBitmapPipeline::PointProcessorInterface* next,
     const SkMatrix& inverse,
     SkLinearBitmapPipeline::MatrixStage* matrixProc) {
     if (inverse.hasPerspective()) {
-        SkFAIL("Not implemented.");
+        matrixProc->Initialize<PerspectiveMatrix<>>(
+            next,
+            SkVector{inverse.getTranslateX(), inverse.getTranslateY()},
+            SkVector{inverse.getScaleX(), inverse.getScaleY()},
+            SkVector{inverse.getSkewX(), inverse.getSkewY()},
+            SkVector{inverse.getPerspX(), inverse.getPerspY()},
+            inverse.get(SkMatrix::kMPersp2));
     } else if (inverse.getSkewX() != 0.0f || inverse.getSkewY() != 0.0f) {
         matrixProc->Initialize<AffineMatrix<>>(
             next,
@@ -348,6 +384,7 @@ static SkLinearBitmapPipeline::PointProcessorInterface* choose_filter(
         filterProc->Initialize<SkippedStage>();
         return next;
     } else {
+        SkASSERT(SkFilterQuality::kLow_SkFilterQuality == filterQuailty);
         filterProc->Initialize<ExpandBilerp<>>(next);
         return filterProc->get();
     }
@@ -420,6 +457,60 @@ private:
 template <typename Next = SkLinearBitmapPipeline::BilerpProcessorInterface>
 using Repeat = BilerpProcessor<RepeatStrategy, Next>;
 
+// Mirror tiling has a period of twice the size, with the second half of each period flipped.
+// The flip is done on whole pixels, keeping the fraction, so that pixel p of the flipped half
+// reads pixel 2max - 1 - p and the bilerp weights still come out of the fractional part.
+class MirrorStrategy {
+public:
+    MirrorStrategy(X max)
+        : fXMax{max}, fXInvDoubleMax{0.5f/max}, fXLast{max - 1.0f}, fMirrorY{false} { }
+    MirrorStrategy(Y max)
+        : fYMax{max}, fYInvDoubleMax{0.5f/max}, fYLast{max - 1.0f}, fMirrorX{false} { }
+    MirrorStrategy(SkSize max)
+        : fXMax{X(max)}
+        , fXInvDoubleMax{0.5f / X(max)}
+        , fXLast{X(max) - 1.0f}
+        , fYMax{Y(max)}
+        , fYInvDoubleMax{0.5f / Y(max)}
+        , fYLast{Y(max) - 1.0f} { }
+
+    void processPoints(Sk4f* xs, Sk4f* ys) {
+        if (fMirrorX) {
+            *xs = Mirror(*xs, fXMax, fXInvDoubleMax, fXLast);
+        }
+        if (fMirrorY) {
+            *ys = Mirror(*ys, fYMax, fYInvDoubleMax, fYLast);
+        }
+    }
+
+    template <typename Next>
+    bool maybeProcessSpan(SkPoint start, SkScalar length, int count, Next* next) {
+        return false;
+    }
+
+private:
+    static Sk4f VECTORCALL Mirror(Sk4f vs, Sk4f max, Sk4f invDoubleMax, Sk4f last) {
+        Sk4f doubleMax = max + max;
+        Sk4f inPeriod = vs - (vs * invDoubleMax).floor() * doubleMax;
+        Sk4f pixel = inPeriod.floor();
+        Sk4f flipped = doubleMax - Sk4f{1.0f} - pixel + (inPeriod - pixel);
+        Sk4f result = (inPeriod < max).thenElse(inPeriod, flipped);
+        return Sk4f::Min(Sk4f::Max(result, Sk4f{0.0f}), last);
+    }
+
+    const Sk4f fXMax{0.0f};
+    const Sk4f fXInvDoubleMax{0.0f};
+    const Sk4f fXLast{0.0f};
+    const Sk4f fYMax{0.0f};
+    const Sk4f fYInvDoubleMax{0.0f};
+    const Sk4f fYLast{0.0f};
+    const bool fMirrorX{true};
+    const bool fMirrorY{true};
+};
+
+template <typename Next = SkLinearBitmapPipeline::BilerpProcessorInterface>
+using Mirror = BilerpProcessor<MirrorStrategy, Next>;
+
 static SkLinearBitmapPipeline::BilerpProcessorInterface* choose_tiler(
     SkLinearBitmapPipeline::BilerpProcessorInterface* next,
     SkSize dimensions,
@@ -436,7 +527,7 @@ static SkLinearBitmapPipeline::BilerpProcessorInterface* choose_tiler(
                 tileProcXOrBoth->Initialize<Repeat<>>(next, dimensions);
                 break;
             case SkShader::kMirror_TileMode:
-                SkFAIL("Not implemented.");
+                tileProcXOrBoth->Initialize<Mirror<>>(next, dimensions);
                 break;
         }
         tileProcY->Initialize<SkippedStage>();
@@ -449,7 +540,7 @@ static SkLinearBitmapPipeline::BilerpProcessorInterface* choose_tiler(
                 tileProcY->Initialize<Repeat<>>(next, Y(dimensions));
                 break;
             case SkShader::kMirror_TileMode:
-                SkFAIL("Not implemented.");
+                tileProcY->Initialize<Mirror<>>(next, Y(dimensions));
                 break;
         }
         switch (xMode) {
@@ -460,7 +551,7 @@ static SkLinearBitmapPipeline::BilerpProcessorInterface* choose_tiler(
                 tileProcXOrBoth->Initialize<Repeat<>>(tileProcY->get(), X(dimensions));
                 break;
             case SkShader::kMirror_TileMode:
-                SkFAIL("Not implemented.");
+                tileProcXOrBoth->Initialize<Mirror<>>(tileProcY->get(), X(dimensions));
                 break;
         }
     }
@@ -476,10 +567,69 @@ public:
 };
 
 template <SkColorProfileType colorProfile>
-class Passthrough8888 {
+static Sk4f VECTORCALL apply_profile(Sk4f pixel) {
+    if (colorProfile == kSRGB_SkColorProfileType) {
+        pixel = sRGBFast::sRGBToLinear(pixel);
+    }
+    return pixel;
+}
+
+static Sk4f VECTORCALL pmcolor_to_Sk4f(uint32_t pmcolor) {
+    Sk4b bytePixel = Sk4b::Load((const uint8_t*)&pmcolor);
+    return SkNx_cast<float, uint8_t>(bytePixel) * Sk4f{1.0f/255.0f};
+}
+
+// The pixel converters turn one element of the source into an Sk4f in SkPM4f channel order.
+template <SkColorProfileType colorProfile, SkColorType colorType>
+class Pixel8888 {
+public:
+    using Element = uint32_t;
+    Pixel8888(const SkPixmap&) { }
+    Sk4f VECTORCALL toSk4f(Element pixel) const {
+        Sk4f result = pmcolor_to_Sk4f(pixel);
+        if (colorType != kN32_SkColorType) {
+            // Swap R and B; alpha sits in the same byte for both 8888 orders.
+            result = SkNx_shuffle<2, 1, 0, 3>(result);
+        }
+        return apply_profile<colorProfile>(result);
+    }
+};
+
+template <SkColorProfileType colorProfile>
+class PixelIndex8 {
 public:
-    Passthrough8888(int width, const uint32_t* src)
-        : fSrc{src}, fWidth{width}{ }
+    using Element = uint8_t;
+    PixelIndex8(const SkPixmap& srcPixmap)
+        : fColors{srcPixmap.ctable()->readColors()} { }
+    Sk4f VECTORCALL toSk4f(Element pixel) const {
+        return apply_profile<colorProfile>(pmcolor_to_Sk4f(fColors[pixel]));
+    }
+
+private:
+    const SkPMColor* const fColors;
+};
+
+template <SkColorProfileType colorProfile>
+class PixelGray8 {
+public:
+    using Element = uint8_t;
+    PixelGray8(const SkPixmap&) { }
+    Sk4f VECTORCALL toSk4f(Element pixel) const {
+        float gray = pixel * (1.0f/255.0f);
+        return apply_profile<colorProfile>(Sk4f{gray, gray, gray, 1.0f});
+    }
+};
+
+// PixelAccessor fetches the source pixels at the (already tiled) coordinates requested by the
+// sampler and hands each one to PixelConverter.
+template <typename PixelConverter>
+class PixelAccessor {
+    using Element = typename PixelConverter::Element;
+public:
+    PixelAccessor(const SkPixmap& srcPixmap)
+        : fSrc{static_cast<const Element*>(srcPixmap.addr())}
+        , fWidth{static_cast<int>(srcPixmap.rowBytes() / sizeof(Element))}
+        , fConverter{srcPixmap} { }
 
     void VECTORCALL getFewPixels(int n, Sk4f xs, Sk4f ys, Sk4f* px0, Sk4f* px1, Sk4f* px2) {
         Sk4i XIs = SkNx_cast<int, float>(xs);
@@ -487,11 +637,11 @@ public:
         Sk4i bufferLoc = YIs * fWidth + XIs;
         switch (n) {
             case 3:
-                *px2 = getPixel(fSrc, bufferLoc[2]);
+                *px2 = this->getPixel(bufferLoc[2]);
             case 2:
-                *px1 = getPixel(fSrc, bufferLoc[1]);
+                *px1 = this->getPixel(bufferLoc[1]);
             case 1:
-                *px0 = getPixel(fSrc, bufferLoc[0]);
+                *px0 = this->getPixel(bufferLoc[0]);
             default:
                 break;
         }
@@ -501,26 +651,20 @@ public:
         Sk4i XIs = SkNx_cast<int, float>(xs);
         Sk4i YIs = SkNx_cast<int, float>(ys);
         Sk4i bufferLoc = YIs * fWidth + XIs;
-        *px0 = getPixel(fSrc, bufferLoc[0]);
-        *px1 = getPixel(fSrc, bufferLoc[1]);
-        *px2 = getPixel(fSrc, bufferLoc[2]);
-        *px3 = getPixel(fSrc, bufferLoc[3]);
+        *px0 = this->getPixel(bufferLoc[0]);
+        *px1 = this->getPixel(bufferLoc[1]);
+        *px2 = this->getPixel(bufferLoc[2]);
+        *px3 = this->getPixel(bufferLoc[3]);
     }
 
-    const uint32_t* row(int y) { return fSrc + y * fWidth[0]; }
+    const Element* row(int y) { return fSrc + y * fWidth[0]; }
 
 private:
-    Sk4f getPixel(const uint32_t* src, int index) {
-        Sk4b bytePixel = Sk4b::Load((uint8_t *)(&src[index]));
-        Sk4f pixel = SkNx_cast<float, uint8_t>(bytePixel);
-        pixel = pixel * Sk4f{1.0f/255.0f};
-        if (colorProfile == kSRGB_SkColorProfileType) {
-            pixel = sRGBFast::sRGBToLinear(pixel);
-        }
-        return pixel;
-    }
-    const uint32_t* const fSrc;
+    Sk4f getPixel(int index) { return fConverter.toSk4f(fSrc[index]); }
+
+    const Element* const fSrc;
     const Sk4i fWidth;
+    PixelConverter fConverter;
 };
 
 // Explaination of the math:
@@ -595,33 +739,48 @@ private:
     SourceStrategy fStrategy;
 };
 
-static SkLinearBitmapPipeline::BilerpProcessorInterface* choose_pixel_sampler(
+template <typename PixelConverter>
+static SkLinearBitmapPipeline::BilerpProcessorInterface* make_pixel_sampler(
     SkLinearBitmapPipeline::PixelPlacerInterface* next,
     const SkPixmap& srcPixmap,
     SkLinearBitmapPipeline::SampleStage* sampleStage) {
-    const SkImageInfo& imageInfo = srcPixmap.info();
-    switch (imageInfo.colorType()) {
+    sampleStage->Initialize<Sampler<PixelAccessor<PixelConverter>>>(next, srcPixmap);
+    return sampleStage->get();
+}
+
+template <SkColorProfileType colorProfile>
+static SkLinearBitmapPipeline::BilerpProcessorInterface* choose_pixel_sampler_for_profile(
+    SkLinearBitmapPipeline::PixelPlacerInterface* next,
+    const SkPixmap& srcPixmap,
+    SkLinearBitmapPipeline::SampleStage* sampleStage) {
+    switch (srcPixmap.colorType()) {
         case kRGBA_8888_SkColorType:
+            return make_pixel_sampler<Pixel8888<colorProfile, kRGBA_8888_SkColorType>>(
+                next, srcPixmap, sampleStage);
         case kBGRA_8888_SkColorType:
-            if (kN32_SkColorType == imageInfo.colorType()) {
-                if (imageInfo.profileType() == kSRGB_SkColorProfileType) {
-                    sampleStage->Initialize<Sampler<Passthrough8888<kSRGB_SkColorProfileType>>>(
-                        next, static_cast<int>(srcPixmap.rowBytes() / 4),
-                        srcPixmap.addr32());
-                } else {
-                    sampleStage->Initialize<Sampler<Passthrough8888<kLinear_SkColorProfileType>>>(
-                        next, static_cast<int>(srcPixmap.rowBytes() / 4),
-                        srcPixmap.addr32());
-                }
-            } else {
-                SkFAIL("Not implemented. No 8888 Swizzle");
-            }
-            break;
+            return make_pixel_sampler<Pixel8888<colorProfile, kBGRA_8888_SkColorType>>(
+                next, srcPixmap, sampleStage);
+        case kIndex_8_SkColorType:
+            return make_pixel_sampler<PixelIndex8<colorProfile>>(next, srcPixmap, sampleStage);
+        case kGray_8_SkColorType:
+            return make_pixel_sampler<PixelGray8<colorProfile>>(next, srcPixmap, sampleStage);
         default:
             SkFAIL("Not implemented. Unsupported src");
             break;
     }
-    return sampleStage->get();
+    return nullptr;
+}
+
+static SkLinearBitmapPipeline::BilerpProcessorInterface* choose_pixel_sampler(
+    SkLinearBitmapPipeline::PixelPlacerInterface* next,
+    const SkPixmap& srcPixmap,
+    SkLinearBitmapPipeline::SampleStage* sampleStage) {
+    if (srcPixmap.info().profileType() == kSRGB_SkColorProfileType) {
+        return choose_pixel_sampler_for_profile<kSRGB_SkColorProfileType>(
+            next, srcPixmap, sampleStage);
+    }
+    return choose_pixel_sampler_for_profile<kLinear_SkColorProfileType>(
+        next, srcPixmap, sampleStage);
 }
 
 template <SkAlphaType alphaType>
@@ -681,6 +840,7 @@ SkLinearBitmapPipeline::SkLinearBitmapPipeline(
     SkFilterQuality filterQuality,
     SkShader::TileMode xTile, SkShader::TileMode yTile,
     const SkPixmap& srcPixmap) {
+    SkASSERT(SupportsFilterQuality(filterQuality));
     SkSize size = SkSize::Make(srcPixmap.width(), srcPixmap.height());
     const SkImageInfo& srcImageInfo = srcPixmap.info();
 
@@ -24,6 +24,12 @@ public:
         const SkPixmap& srcPixmap);
     ~SkLinearBitmapPipeline();
 
+    // The pipeline samples the base level only, either nearest or bilerp. Medium quality needs
+    // mipmaps and high quality needs bicubic, so those stay with SkBitmapProcState.
+    static bool SupportsFilterQuality(SkFilterQuality filterQuality) {
+        return filterQuality <= kLow_SkFilterQuality;
+    }
+
     void shadeSpan4f(int x, int y, SkPM4f* dst, int count);
 
     template<typename Base, size_t kSize>
@@ -56,10 +62,10 @@ public:
     class BilerpProcessorInterface;
     class PixelPlacerInterface;
 
-    using MatrixStage = PolymorphicUnion<PointProcessorInterface, 112>;
+    using MatrixStage = PolymorphicUnion<PointProcessorInterface, 176>;
     using FilterStage = PolymorphicUnion<PointProcessorInterface,   8>;
-    using TileStage   = PolymorphicUnion<BilerpProcessorInterface, 96>;
-    using SampleStage = PolymorphicUnion<BilerpProcessorInterface, 80>;
+    using TileStage   = PolymorphicUnion<BilerpProcessorInterface, 128>;
+    using SampleStage = PolymorphicUnion<BilerpProcessorInterface, 96>;
     using PixelStage  = PolymorphicUnion<PixelPlacerInterface,     80>;
 
 private:
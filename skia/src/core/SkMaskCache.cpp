@@ -57,6 +57,12 @@ struct RRectBlurRec : public SkResourceCache::Rec {
     SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
         return fValue.fData->diagnostic_only_getDiscardable();
     }
+    SkResourceCache::PurgePriority getPurgePriority() const override {
+        return SkResourceCache::kBlurMask_PurgePriority;
+    }
+    bool moveToDiscardable(SkResourceCache::DiscardableFactory factory) override {
+        return fValue.fData->moveToDiscardable(factory);
+    }
 
     static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
         const RRectBlurRec& rec = static_cast<const RRectBlurRec&>(baseRec);
@@ -152,6 +158,12 @@ struct RectsBlurRec : public SkResourceCache::Rec {
     SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
         return fValue.fData->diagnostic_only_getDiscardable();
     }
+    SkResourceCache::PurgePriority getPurgePriority() const override {
+        return SkResourceCache::kBlurMask_PurgePriority;
+    }
+    bool moveToDiscardable(SkResourceCache::DiscardableFactory factory) override {
+        return fValue.fData->moveToDiscardable(factory);
+    }
 
     static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
         const RectsBlurRec& rec = static_cast<const RectsBlurRec&>(baseRec);
@@ -189,3 +201,108 @@ void SkMaskCache::Add(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
     RectsBlurKey key(sigma, style, quality, rects, count);
     return CHECK_LOCAL(localCache, add, Add, new RectsBlurRec(key, mask, data));
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+static unsigned gPathBlurKeyNamespaceLabel;
+
+struct PathBlurKey : public SkResourceCache::Key {
+public:
+    PathBlurKey(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality, uint32_t pathGenID,
+                const SkMatrix& pathMatrix, SkPaint::Style paintStyle)
+        : fSigma(sigma)
+        , fStyle(style)
+        , fQuality(quality)
+        , fPaintStyle(paintStyle)
+        , fPathGenID(pathGenID)
+    {
+        pathMatrix.get9(fMatrix);
+        // Without perspective, whole pixels of translation only move the mask, so leave them out.
+        if (!pathMatrix.hasPerspective()) {
+            fMatrix[SkMatrix::kMTransX] -= SkScalarFloorToScalar(fMatrix[SkMatrix::kMTransX]);
+            fMatrix[SkMatrix::kMTransY] -= SkScalarFloorToScalar(fMatrix[SkMatrix::kMTransY]);
+        }
+        this->init(&gPathBlurKeyNamespaceLabel, 0,
+                   sizeof(fSigma) + sizeof(fStyle) + sizeof(fQuality) + sizeof(fPaintStyle) +
+                   sizeof(fPathGenID) + sizeof(fMatrix));
+    }
+
+    SkScalar    fSigma;
+    int32_t     fStyle;
+    int32_t     fQuality;
+    int32_t     fPaintStyle;
+    uint32_t    fPathGenID;
+    SkScalar    fMatrix[9];
+};
+
+struct PathBlurRec : public SkResourceCache::Rec {
+    PathBlurRec(const PathBlurKey& key, const SkMask& mask, SkCachedData* data)
+        : fKey(key)
+    {
+        fValue.fMask = mask;
+        fValue.fData = data;
+        fValue.fData->attachToCacheAndRef();
+    }
+    ~PathBlurRec() {
+        fValue.fData->detachFromCacheAndUnref();
+    }
+
+    PathBlurKey     fKey;
+    MaskValue       fValue;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
+    const char* getCategory() const override { return "path-blur"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fValue.fData->diagnostic_only_getDiscardable();
+    }
+    SkResourceCache::PurgePriority getPurgePriority() const override {
+        return SkResourceCache::kBlurMask_PurgePriority;
+    }
+    bool moveToDiscardable(SkResourceCache::DiscardableFactory factory) override {
+        return fValue.fData->moveToDiscardable(factory);
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const PathBlurRec& rec = static_cast<const PathBlurRec&>(baseRec);
+        MaskValue* result = static_cast<MaskValue*>(contextData);
+
+        SkCachedData* tmpData = rec.fValue.fData;
+        tmpData->ref();
+        if (nullptr == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = rec.fValue;
+        return true;
+    }
+};
+} // namespace
+
+SkCachedData* SkMaskCache::FindAndRef(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
+                                      uint32_t pathGenID, const SkMatrix& pathMatrix,
+                                      SkPaint::Style paintStyle, const SkIRect& srcBounds,
+                                      SkMask* mask, SkResourceCache* localCache) {
+    MaskValue result;
+    PathBlurKey key(sigma, style, quality, pathGenID, pathMatrix, paintStyle);
+    if (!CHECK_LOCAL(localCache, find, Find, key, PathBlurRec::Visitor, &result)) {
+        return nullptr;
+    }
+
+    *mask = result.fMask;
+    mask->fBounds.offset(srcBounds.fLeft, srcBounds.fTop);
+    mask->fImage = (uint8_t*)(result.fData->data());
+    return result.fData;
+}
+
+void SkMaskCache::Add(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
+                      uint32_t pathGenID, const SkMatrix& pathMatrix, SkPaint::Style paintStyle,
+                      const SkIRect& srcBounds, const SkMask& mask, SkCachedData* data,
+                      SkResourceCache* localCache) {
+    PathBlurKey key(sigma, style, quality, pathGenID, pathMatrix, paintStyle);
+    // Store the bounds relative to the source, so any placement of it can use them.
+    SkMask relative = mask;
+    relative.fBounds.offset(-srcBounds.fLeft, -srcBounds.fTop);
+    return CHECK_LOCAL(localCache, add, Add, new PathBlurRec(key, relative, data));
+}
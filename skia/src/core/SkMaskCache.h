@@ -11,6 +11,7 @@
 #include "SkBlurTypes.h"
 #include "SkCachedData.h"
 #include "SkMask.h"
+#include "SkPaint.h"
 #include "SkRect.h"
 #include "SkResourceCache.h"
 #include "SkRRect.h"
@@ -30,6 +31,18 @@ public:
                                     const SkRect rects[], int count, SkMask* mask,
                                     SkResourceCache* localCache = nullptr);
 
+    /**
+     * Blurs of arbitrary paths are keyed by the path's generation ID and the matrix that maps
+     * it to device space. Without perspective, only the fraction of the matrix's translation is
+     * keyed, so the same path drawn at another whole-pixel offset hits. srcBounds is the
+     * unclipped device bounds of the path's mask, and the returned mask is positioned relative
+     * to it.
+     */
+    static SkCachedData* FindAndRef(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
+                                    uint32_t pathGenID, const SkMatrix& pathMatrix,
+                                    SkPaint::Style paintStyle, const SkIRect& srcBounds,
+                                    SkMask* mask, SkResourceCache* localCache = nullptr);
+
     /**
      * Add a mask and its pixel-data to the cache.
      */
@@ -39,6 +52,10 @@ public:
     static void Add(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
                     const SkRect rects[], int count, const SkMask& mask, SkCachedData* data,
                     SkResourceCache* localCache = nullptr);
+    static void Add(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
+                    uint32_t pathGenID, const SkMatrix& pathMatrix, SkPaint::Style paintStyle,
+                    const SkIRect& srcBounds, const SkMask& mask, SkCachedData* data,
+                    SkResourceCache* localCache = nullptr);
 };
 
 #endif
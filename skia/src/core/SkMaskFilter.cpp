@@ -234,7 +234,8 @@ bool SkMaskFilter::filterRRect(const SkRRect& devRRect, const SkMatrix& matrix,
 
 bool SkMaskFilter::filterPath(const SkPath& devPath, const SkMatrix& matrix,
                               const SkRasterClip& clip, SkBlitter* blitter,
-                              SkPaint::Style style) const {
+                              SkPaint::Style style, uint32_t pathGenID,
+                              const SkMatrix& pathMatrix) const {
     SkRect rects[2];
     int rectCount = 0;
     if (SkPaint::kFill_Style == style) {
@@ -260,16 +261,10 @@ bool SkMaskFilter::filterPath(const SkPath& devPath, const SkMatrix& matrix,
         }
     }
 
-    SkMask  srcM, dstM;
-
-    if (!SkDraw::DrawToMask(devPath, &clip.getBounds(), this, &matrix, &srcM,
-                            SkMask::kComputeBoundsAndRenderImage_CreateMode,
-                            style)) {
-        return false;
-    }
-    SkAutoMaskFreeImage autoSrc(srcM.fImage);
+    SkMask  dstM;
 
-    if (!this->filterMask(&dstM, srcM, matrix, nullptr)) {
+    if (!this->filterPathMask(&dstM, devPath, matrix, clip.getBounds(), style, pathGenID,
+                              pathMatrix)) {
         return false;
     }
     SkAutoMaskFreeImage autoDst(dstM.fImage);
@@ -291,6 +286,21 @@ bool SkMaskFilter::filterPath(const SkPath& devPath, const SkMatrix& matrix,
     return true;
 }
 
+bool SkMaskFilter::filterPathMask(SkMask* dst, const SkPath& devPath, const SkMatrix& ctm,
+                                  const SkIRect& clipBounds, SkPaint::Style style,
+                                  uint32_t pathGenID, const SkMatrix& pathMatrix) const {
+    SkMask  srcM;
+
+    if (!SkDraw::DrawToMask(devPath, &clipBounds, this, &ctm, &srcM,
+                            SkMask::kComputeBoundsAndRenderImage_CreateMode,
+                            style)) {
+        return false;
+    }
+    SkAutoMaskFreeImage autoSrc(srcM.fImage);
+
+    return this->filterMask(dst, srcM, ctm, nullptr);
+}
+
 SkMaskFilter::FilterReturn
 SkMaskFilter::filterRRectToNine(const SkRRect&, const SkMatrix&,
                                 const SkIRect& clipBounds, NinePatch*) const {
@@ -12,6 +12,7 @@
 #include "SkCanvasPriv.h"
 #include "SkMultiPictureDraw.h"
 #include "SkPicture.h"
+#include "SkPixmap.h"
 #include "SkTaskGroup.h"
 
 #if SK_SUPPORT_GPU
@@ -205,3 +206,61 @@ void SkMultiPictureDraw::draw(bool flush) {
 #endif
 }
 
+
+void SkMultiPictureDraw::DrawTiled(const SkPixmap& dst,
+                                   const SkPicture* picture,
+                                   const SkMatrix* matrix,
+                                   const SkISize& tileSize,
+                                   int maxTasks) {
+    if (nullptr == picture || nullptr == dst.addr() || dst.bounds().isEmpty() ||
+        tileSize.isEmpty()) {
+        return;
+    }
+
+    const int xTiles = (dst.width()  + tileSize.width()  - 1) / tileSize.width(),
+              yTiles = (dst.height() + tileSize.height() - 1) / tileSize.height(),
+              tiles  = xTiles * yTiles,
+              tasks  = maxTasks > 0 ? SkTMin(maxTasks, tiles) : tiles;
+
+    SkMatrix initialMatrix;
+    if (matrix) {
+        initialMatrix = *matrix;
+    } else {
+        initialMatrix.setIdentity();
+    }
+
+    auto drawTile = [&](int index) {
+        const int x = (index % xTiles) * tileSize.width(),
+                  y = (index / xTiles) * tileSize.height();
+
+        SkPixmap tile;
+        if (!dst.extractSubset(&tile, SkIRect::MakeXYWH(x, y, tileSize.width(),
+                                                          tileSize.height()))) {
+            return;
+        }
+
+        // Each tile canvas owns its device and clip stack but writes straight into dst,
+        // so tiles never touch each other's pixels and need no synchronization.
+        SkAutoTDelete<SkCanvas> canvas(SkCanvas::NewRasterDirect(tile.info(),
+                                                                 tile.writable_addr(),
+                                                                 tile.rowBytes()));
+        if (!canvas) {
+            return;
+        }
+        canvas->translate(-SkIntToScalar(x), -SkIntToScalar(y));
+        canvas->concat(initialMatrix);
+        canvas->drawPicture(picture);
+    };
+
+#ifdef FORCE_SINGLE_THREAD_DRAWING_FOR_TESTING
+    for (int i = 0; i < tiles; ++i) {
+        drawTile(i);
+    }
+#else
+    SkTaskGroup().batch(tasks, [&](int task) {
+        for (int i = task; i < tiles; i += tasks) {
+            drawTile(i);
+        }
+    });
+#endif
+}
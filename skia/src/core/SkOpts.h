@@ -26,7 +26,9 @@ namespace SkOpts {
     // May return nullptr if we haven't specialized the given Mode.
     extern SkXfermode* (*create_xfermode)(const ProcCoeff&, SkXfermode::Mode);
 
-    typedef void (*BoxBlur)(const SkPMColor*, int, const SkIRect& srcBounds, SkPMColor*, int, int, int, int, int);
+    // The last two arguments are the range of rows to blur; see SkBlurImageFilter_opts.h.
+    typedef void (*BoxBlur)(const SkPMColor*, int, const SkIRect& srcBounds, SkPMColor*,
+                            int, int, int, int, int, int, int);
     extern BoxBlur box_blur_xx, box_blur_xy, box_blur_yx;
 
     typedef void (*Morph)(const SkPMColor*, SkPMColor*, int, int, int, int, int);
@@ -83,6 +83,31 @@ public:
     static void AddGenIDChangeListener(const SkPath& path, SkPathRef::GenIDChangeListener* listener) {
         path.fPathRef->addGenIDChangeListener(listener);
     }
+
+    /**
+     * Hash of the path's geometry, invariant to translation. See SkPathRef::contentHash().
+     */
+    static uint32_t ContentHash(const SkPath& path) {
+        return path.fPathRef->contentHash();
+    }
+
+    /**
+     * Returns a pointer to the verb data. Note that the verbs are stored backwards in memory and
+     * thus the returned pointer is the last verb.
+     */
+    static const uint8_t* VerbData(const SkPath& path) {
+        return path.fPathRef->verbsMemBegin();
+    }
+
+    /** Returns a raw pointer to the path conic weights. */
+    static const SkScalar* ConicWeightData(const SkPath& path) {
+        return path.fPathRef->conicWeights();
+    }
+
+    /** Returns the number of conic weights in the path */
+    static int ConicWeightCnt(const SkPath& path) {
+        return path.fPathRef->countWeights();
+    }
 };
 
 #endif
@@ -6,6 +6,7 @@
  */
 
 #include "SkBuffer.h"
+#include "SkChecksum.h"
 #include "SkOncePtr.h"
 #include "SkPath.h"
 #include "SkPathRef.h"
@@ -468,6 +469,28 @@ uint32_t SkPathRef::genID() const {
     return fGenerationID;
 }
 
+uint32_t SkPathRef::contentHash() const {
+    const uint32_t genID = this->genID();
+    if (fContentHashGenID != genID) {
+        uint32_t hash = SkChecksum::Murmur3(this->verbsMemBegin(), fVerbCnt);
+        hash = SkChecksum::Murmur3(fConicWeights.begin(), fConicWeights.bytes(), hash);
+
+        // Hash the points in small batches, translated so the bounds start at the origin.
+        const SkPoint origin = { this->getBounds().fLeft, this->getBounds().fTop };
+        SkPoint relative[32];
+        for (int i = 0; i < fPointCnt; i += SK_ARRAY_COUNT(relative)) {
+            const int n = SkTMin(fPointCnt - i, (int)SK_ARRAY_COUNT(relative));
+            for (int j = 0; j < n; j++) {
+                relative[j] = fPoints[i + j] - origin;
+            }
+            hash = SkChecksum::Murmur3(relative, n * sizeof(SkPoint), hash);
+        }
+        fContentHash = hash;
+        fContentHashGenID = genID;
+    }
+    return fContentHash;
+}
+
 void SkPathRef::addGenIDChangeListener(GenIDChangeListener* listener) {
     if (nullptr == listener || this == (SkPathRef*)empty) {
         delete listener;
@@ -139,6 +139,18 @@ struct SkPathCounter {
         this->checkPaint(AsPtr(op.paint));
     }
 
+    // Batched draws count as many times as the draws they replaced.
+    void operator()(const SkRecords::DrawRects& op) {
+        for (int i = 0; i < op.count; i++) {
+            this->checkPaint(&op.paint);
+        }
+    }
+    void operator()(const SkRecords::DrawBitmapRects& op) {
+        for (int i = 0; i < op.count; i++) {
+            this->checkPaint(AsPtr(op.paint));
+        }
+    }
+
     template <typename T>
     SK_WHEN(T::kTags & SkRecords::kDraw_Tag, void) operator()(const T& op) {
         this->checkPaint(AsPtr(op.paint));
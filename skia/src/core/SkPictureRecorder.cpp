@@ -60,6 +60,11 @@ SkPicture* SkPictureRecorder::endRecordingAsPicture() {
 
     // TODO: delay as much of this work until just before first playback?
     SkRecordOptimize(fRecord);
+    if (!fBBH.get()) {
+        // Without a BBH we play back every op anyway, so fewer, bigger ops can only help.
+        SkRecordBatchDraws(fRecord);
+        fRecord->defrag();
+    }
 
     SkAutoTUnref<SkLayerInfo> saveLayerData;
 
@@ -184,6 +189,11 @@ SkDrawable* SkPictureRecorder::endRecordingAsDrawable() {
 
     // TODO: delay as much of this work until just before first playback?
     SkRecordOptimize(fRecord);
+    if (!fBBH.get()) {
+        // Without a BBH we play back every op anyway, so fewer, bigger ops can only help.
+        SkRecordBatchDraws(fRecord);
+        fRecord->defrag();
+    }
 
     if (fBBH.get()) {
         SkAutoTMalloc<SkRect> bounds(fRecord->count());
@@ -119,6 +119,20 @@ DRAW(DrawVertices, drawVertices(r.vmode, r.vertexCount, r.vertices, r.texs, r.co
                                 r.xmode, r.indices, r.indexCount, r.paint));
 #undef DRAW
 
+template <> void Draw::draw(const DrawBitmapRects& r) {
+    const SkBitmap bitmap = r.bitmap.shallowCopy();
+    for (int i = 0; i < r.count; i++) {
+        fCanvas->legacy_drawBitmapRect(bitmap, r.srcs ? &r.srcs[i] : nullptr, r.dsts[i], r.paint,
+                                       r.constraint);
+    }
+}
+
+template <> void Draw::draw(const DrawRects& r) {
+    for (int i = 0; i < r.count; i++) {
+        fCanvas->drawRect(r.rects[i], r.paint);
+    }
+}
+
 template <> void Draw::draw(const DrawDrawable& r) {
     SkASSERT(r.index >= 0);
     SkASSERT(r.index < fDrawableCount);
@@ -389,6 +403,13 @@ private:
     Bounds bounds(const NoOp&)  const { return Bounds::MakeEmpty(); }    // NoOps don't draw.
 
     Bounds bounds(const DrawRect& op) const { return this->adjustAndMap(op.rect, &op.paint); }
+    Bounds bounds(const DrawRects& op) const {
+        Bounds bounds = Bounds::MakeEmpty();
+        for (int i = 0; i < op.count; i++) {
+            bounds.join(this->adjustAndMap(op.rects[i], &op.paint));
+        }
+        return bounds;
+    }
     Bounds bounds(const DrawOval& op) const { return this->adjustAndMap(op.oval, &op.paint); }
     Bounds bounds(const DrawRRect& op) const {
         return this->adjustAndMap(op.rrect.rect(), &op.paint);
@@ -417,6 +438,13 @@ private:
     Bounds bounds(const DrawBitmapRectFixedSize& op) const {
         return this->adjustAndMap(op.dst, &op.paint);
     }
+    Bounds bounds(const DrawBitmapRects& op) const {
+        Bounds bounds = Bounds::MakeEmpty();
+        for (int i = 0; i < op.count; i++) {
+            bounds.join(this->adjustAndMap(op.dsts[i], op.paint));
+        }
+        return bounds;
+    }
     Bounds bounds(const DrawBitmapNine& op) const {
         return this->adjustAndMap(op.dst, op.paint);
     }
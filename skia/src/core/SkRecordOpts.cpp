@@ -7,9 +7,12 @@
 
 #include "SkRecordOpts.h"
 
+#include "SkRecordDraw.h"
 #include "SkRecordPattern.h"
 #include "SkRecords.h"
+#include "SkShader.h"
 #include "SkTDArray.h"
+#include "SkXfermode.h"
 
 using namespace SkRecords;
 
@@ -271,6 +274,425 @@ void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+static bool same_paint(const SkPaint* a, const SkPaint* b) {
+    return a == b || (a && b && *a == *b);
+}
+
+static bool same_bitmap(const ImmutableBitmap& a, const ImmutableBitmap& b) {
+    const SkBitmap x = a.shallowCopy(),
+                   y = b.shallowCopy();
+    return x.pixelRef()       == y.pixelRef()
+        && x.pixelRefOrigin() == y.pixelRefOrigin()
+        && x.width()          == y.width()
+        && x.height()         == y.height();
+}
+
+static bool can_batch(const DrawRect& a, const DrawRect& b) { return a.paint == b.paint; }
+
+template <typename T>
+static bool can_batch_bitmap_rects(const T& a, const T& b) {
+    return same_paint(a.paint, b.paint)
+        && same_bitmap(a.bitmap, b.bitmap)
+        && SkToBool(a.src) == SkToBool(b.src);
+}
+static bool can_batch(const DrawBitmapRect& a, const DrawBitmapRect& b) {
+    return can_batch_bitmap_rects(a, b);
+}
+static bool can_batch(const DrawBitmapRectFast& a, const DrawBitmapRectFast& b) {
+    return can_batch_bitmap_rects(a, b);
+}
+
+template <typename T>
+static T* get(SkRecord* record, int i) {
+    Is<T> is;
+    record->mutate<bool>(i, is);
+    return is.get();
+}
+
+// Finds runs of T (possibly interrupted by NoOps) that can be batched together,
+// and hands the indices of each run of two or more to makeBatch().
+template <typename T, typename MakeBatch>
+static void batch_runs(SkRecord* record, MakeBatch makeBatch) {
+    SkTDArray<int> run;
+    int i = 0;
+    while (i < record->count()) {
+        const T* first = get<T>(record, i);
+        if (!first) {
+            i++;
+            continue;
+        }
+
+        run.rewind();
+        run.push(i);
+        int next = i + 1;
+        for (; next < record->count(); next++) {
+            if (get<NoOp>(record, next)) {
+                continue;
+            }
+            const T* op = get<T>(record, next);
+            if (!op || !can_batch(*first, *op)) {
+                break;
+            }
+            run.push(next);
+        }
+
+        if (run.count() > 1) {
+            makeBatch(record, run);
+        }
+        i = next;
+    }
+}
+
+static void batch_rects(SkRecord* record, const SkTDArray<int>& run) {
+    SkRect* rects = record->alloc<SkRect>(run.count());
+    for (int i = 0; i < run.count(); i++) {
+        rects[i] = get<DrawRect>(record, run[i])->rect;
+    }
+    const SkPaint paint = get<DrawRect>(record, run[0])->paint;
+
+    for (int i = 0; i < run.count(); i++) {
+        record->replace<NoOp>(run[i]);
+    }
+    new (record->replace<DrawRects>(run[0])) DrawRects{paint, rects, run.count()};
+}
+
+template <typename T>
+static void batch_bitmap_rects(SkRecord* record, const SkTDArray<int>& run,
+                               SkCanvas::SrcRectConstraint constraint) {
+    const T* first = get<T>(record, run[0]);
+    SkRect* srcs = first->src ? record->alloc<SkRect>(run.count()) : nullptr;
+    SkRect* dsts = record->alloc<SkRect>(run.count());
+    for (int i = 0; i < run.count(); i++) {
+        const T* op = get<T>(record, run[i]);
+        if (srcs) {
+            srcs[i] = *op->src;
+        }
+        dsts[i] = op->dst;
+    }
+    SkPaint* paint = nullptr;
+    if (first->paint) {
+        paint = new (record->alloc<SkPaint>()) SkPaint(*first->paint);
+    }
+    const SkBitmap bitmap = first->bitmap.shallowCopy();
+
+    for (int i = 0; i < run.count(); i++) {
+        record->replace<NoOp>(run[i]);
+    }
+    new (record->replace<DrawBitmapRects>(run[0]))
+            DrawBitmapRects{paint, bitmap, srcs, dsts, run.count(), constraint};
+}
+
+void SkRecordBatchDraws(SkRecord* record) {
+    batch_runs<DrawRect>(record, batch_rects);
+    batch_runs<DrawBitmapRect>(record, [](SkRecord* record, const SkTDArray<int>& run) {
+        batch_bitmap_rects<DrawBitmapRect>(record, run, SkCanvas::kStrict_SrcRectConstraint);
+    });
+    batch_runs<DrawBitmapRectFast>(record, [](SkRecord* record, const SkTDArray<int>& run) {
+        batch_bitmap_rects<DrawBitmapRectFast>(record, run, SkCanvas::kFast_SrcRectConstraint);
+    });
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Walks the record tracking the matrix and the intersect-ClipRects currently in effect, and reports
+// SetMatrix, Concat, and ClipRect ops that would not change either.
+class RedundantStateFinder {
+public:
+    RedundantStateFinder() : fDepth(0) { fCTM.reset(); }
+
+    template <typename T> bool operator()(const T&) { return false; }
+
+    bool operator()(const Save&)      { fDepth++; return false; }
+    bool operator()(const SaveLayer&) { fDepth++; return false; }
+    bool operator()(const Restore& op) {
+        while (!fClips.isEmpty() && fClips.top().depth == fDepth) {
+            fClips.pop();
+        }
+        fDepth--;
+        fCTM = op.matrix;
+        return false;
+    }
+
+    bool operator()(const SetMatrix& op) {
+        if (op.matrix == fCTM) {
+            return true;
+        }
+        fCTM = op.matrix;
+        return false;
+    }
+    bool operator()(const Concat& op) {
+        if (op.matrix.isIdentity()) {
+            return true;
+        }
+        fCTM.preConcat(op.matrix);
+        return false;
+    }
+
+    bool operator()(const ClipRect& op) {
+        if (SkRegion::kIntersect_Op != op.opAA.op) {
+            // The clip may grow, so we can't say anything about it anymore.
+            fClips.rewind();
+            return false;
+        }
+        for (int i = 0; i < fClips.count(); i++) {
+            const Clip& clip = fClips[i];
+            if (clip.rect == op.rect && clip.aa == SkToBool(op.opAA.aa) && clip.ctm == fCTM) {
+                return true;
+            }
+        }
+        fClips.push(Clip{op.rect, fCTM, SkToBool(op.opAA.aa), fDepth});
+        return false;
+    }
+    bool operator()(const ClipRRect& op)  { return this->otherClip(op.opAA.op); }
+    bool operator()(const ClipPath& op)   { return this->otherClip(op.opAA.op); }
+    bool operator()(const ClipRegion& op) { return this->otherClip(op.op); }
+
+private:
+    bool otherClip(SkRegion::Op op) {
+        if (SkRegion::kIntersect_Op != op) {
+            fClips.rewind();
+        }
+        return false;
+    }
+
+    struct Clip {
+        SkRect   rect;
+        SkMatrix ctm;
+        bool     aa;
+        int      depth;  // The Save depth the clip was made at; it's gone when that Save is restored.
+    };
+
+    SkMatrix          fCTM;
+    int               fDepth;
+    SkTDArray<Clip>   fClips;
+};
+
+// Merges back-to-back Save-ClipRect-Draw*-Restore blocks that clip to the same rect, turning the
+// middle Restore-Save-ClipRect into NoOps.  The first block only draws, so the matrix is the same
+// at both ClipRects.
+struct SameClipRectBlockMerger {
+    typedef Pattern<Is<Save>,
+                    Is<ClipRect>,
+                    Greedy<Or<Is<NoOp>, IsDraw>>,
+                    Is<Restore>,
+                    Is<Save>,
+                    Is<ClipRect>>
+        Match;
+
+    bool onMatch(SkRecord* record, Match* match, int begin, int end) {
+        const ClipRect* first = match->second<ClipRect>();
+        const ClipRect* last  = get<ClipRect>(record, end-1);
+        if (first->rect != last->rect ||
+            first->opAA.op != last->opAA.op ||
+            first->opAA.aa != last->opAA.aa) {
+            return false;
+        }
+        record->replace<NoOp>(end-3);  // Restore
+        record->replace<NoOp>(end-2);  // Save
+        record->replace<NoOp>(end-1);  // ClipRect
+        return true;
+    }
+};
+
+void SkRecordNoopRedundantState(SkRecord* record) {
+    SameClipRectBlockMerger merger;
+    while (apply(&merger, record));
+
+    RedundantStateFinder finder;
+    for (int i = 0; i < record->count(); i++) {
+        if (record->visit<bool>(i, finder)) {
+            record->replace<NoOp>(i);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Does paint fully overwrite every pixel it touches (away from anti-aliased edges)?
+static bool paint_is_opaque_fill(const SkPaint& paint) {
+    if (SkPaint::kFill_Style != paint.getStyle() ||
+        0xFF != paint.getAlpha() ||
+        paint.getPathEffect()    ||
+        paint.getMaskFilter()    ||
+        paint.getColorFilter()   ||
+        paint.getRasterizer()    ||
+        paint.getLooper()        ||
+        paint.getImageFilter()) {
+        return false;
+    }
+    if (paint.getShader() && !paint.getShader()->isOpaque()) {
+        return false;
+    }
+    SkXfermode::Mode mode;
+    if (!SkXfermode::AsMode(paint.getXfermode(), &mode)) {
+        return false;
+    }
+    return SkXfermode::kSrcOver_Mode == mode || SkXfermode::kSrc_Mode == mode;
+}
+
+// Walks the record tracking the matrix and clip, and computes for each op the identity-space
+// rect it is guaranteed to paint opaquely, or returns an empty rect if there isn't one.
+class OccluderFinder {
+public:
+    OccluderFinder() : fHasBackdrop(false) {
+        State* state = fStates.push();
+        state->ctm.reset();
+        state->clip = SkRect::MakeLargest();
+        state->clipIsRect = true;
+        state->inLayer = false;
+    }
+
+    bool hasBackdrop() const { return fHasBackdrop; }
+
+    template <typename T> SkRect operator()(const T&) { return SkRect::MakeEmpty(); }
+
+    SkRect operator()(const Save&) {
+        State state = fStates.top();
+        fStates.push(state);
+        return SkRect::MakeEmpty();
+    }
+    SkRect operator()(const SaveLayer& op) {
+        if (op.backdrop) {
+            fHasBackdrop = true;
+        }
+        State state = fStates.top();
+        state.inLayer = true;
+        fStates.push(state);
+        return SkRect::MakeEmpty();
+    }
+    SkRect operator()(const Restore& op) {
+        if (fStates.count() > 1) {
+            fStates.pop();
+        }
+        fStates.top().ctm = op.matrix;
+        return SkRect::MakeEmpty();
+    }
+
+    SkRect operator()(const SetMatrix& op) {
+        fStates.top().ctm = op.matrix;
+        return SkRect::MakeEmpty();
+    }
+    SkRect operator()(const Concat& op) {
+        fStates.top().ctm.preConcat(op.matrix);
+        return SkRect::MakeEmpty();
+    }
+
+    SkRect operator()(const ClipRect& op) {
+        State& state = fStates.top();
+        if (SkRegion::kIntersect_Op == op.opAA.op && state.ctm.rectStaysRect()) {
+            SkRect rect;
+            state.ctm.mapRect(&rect, op.rect);
+            if (!state.clip.intersect(rect)) {
+                state.clip.setEmpty();
+            }
+        } else {
+            state.clipIsRect = false;
+        }
+        return SkRect::MakeEmpty();
+    }
+    SkRect operator()(const ClipRRect&)  { return this->complexClip(); }
+    SkRect operator()(const ClipPath&)   { return this->complexClip(); }
+    SkRect operator()(const ClipRegion&) { return this->complexClip(); }
+
+    SkRect operator()(const DrawRect& op) {
+        const State& state = fStates.top();
+        if (!paint_is_opaque_fill(op.paint) || !state.ctm.rectStaysRect()) {
+            return SkRect::MakeEmpty();
+        }
+        SkRect rect;
+        state.ctm.mapRect(&rect, op.rect);
+        return this->occluder(rect);
+    }
+    SkRect operator()(const DrawPaint& op) {
+        if (!paint_is_opaque_fill(op.paint)) {
+            return SkRect::MakeEmpty();
+        }
+        return this->occluder(SkRect::MakeLargest());
+    }
+
+private:
+    SkRect complexClip() {
+        fStates.top().clipIsRect = false;
+        return SkRect::MakeEmpty();
+    }
+
+    SkRect occluder(SkRect rect) const {
+        const State& state = fStates.top();
+        // Inside a layer, the layer's own paint decides how opaque we end up.
+        if (state.inLayer || !state.clipIsRect || !rect.intersect(state.clip)) {
+            return SkRect::MakeEmpty();
+        }
+        // Pull in by a pixel so anti-aliased edges (ours or the clip's) can't leak through.
+        rect.inset(1, 1);
+        return rect.isEmpty() ? SkRect::MakeEmpty() : rect;
+    }
+
+    struct State {
+        SkMatrix ctm;
+        SkRect   clip;        // Identity-space clip, meaningful only if clipIsRect.
+        bool     clipIsRect;
+        bool     inLayer;
+    };
+
+    SkTDArray<State> fStates;
+    bool             fHasBackdrop;
+};
+
+void SkRecordNoopOccludedDraws(SkRecord* record) {
+    const int count = record->count();
+    SkAutoTMalloc<SkRect> occluders(count);
+    OccluderFinder finder;
+    for (int i = 0; i < count; i++) {
+        occluders[i] = record->visit<SkRect>(i, finder);
+    }
+    if (finder.hasBackdrop()) {
+        // A backdrop filter could smear an occluded draw out from under its occluder.
+        return;
+    }
+
+    SkAutoTMalloc<SkRect> bounds(count);
+    SkRecordFillBounds(SkRect::MakeLargest(), *record, bounds);
+
+    // Walk backwards, remembering the biggest few occluders we've seen so far.
+    static const int kMaxOccluders = 8;
+    SkRect later[kMaxOccluders];
+    int laterCount = 0;
+    for (int i = count - 1; i >= 0; i--) {
+        // Drawables may have side effects beyond their pixels, so we always draw them.
+        IsDraw isDraw;
+        if (!get<DrawDrawable>(record, i) && record->mutate<bool>(i, isDraw)) {
+            for (int j = 0; j < laterCount; j++) {
+                if (later[j].contains(bounds[i])) {
+                    record->replace<NoOp>(i);
+                    break;
+                }
+            }
+        }
+
+        const SkRect& occluder = occluders[i];
+        if (occluder.isEmpty()) {
+            continue;
+        }
+        if (laterCount < kMaxOccluders) {
+            later[laterCount++] = occluder;
+            continue;
+        }
+        int smallest = 0;
+        for (int j = 1; j < kMaxOccluders; j++) {
+            if (later[j].width() * later[j].height() <
+                later[smallest].width() * later[smallest].height()) {
+                smallest = j;
+            }
+        }
+        if (occluder.width() * occluder.height() >
+            later[smallest].width() * later[smallest].height()) {
+            later[smallest] = occluder;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 void SkRecordOptimize(SkRecord* record) {
     // This might be useful  as a first pass in the future if we want to weed
     // out junk for other optimization passes.  Right now, nothing needs it,
@@ -280,6 +702,7 @@ void SkRecordOptimize(SkRecord* record) {
 
     SkRecordNoopSaveLayerDrawRestores(record);
     SkRecordMergeSvgOpacityAndFilterLayers(record);
+    SkRecordNoopRedundantState(record);
 
     record->defrag();
 }
@@ -289,6 +712,9 @@ void SkRecordOptimize2(SkRecord* record) {
     SkRecordNoopSaveRestores(record);
     SkRecordNoopSaveLayerDrawRestores(record);
     SkRecordMergeSvgOpacityAndFilterLayers(record);
+    SkRecordNoopRedundantState(record);
+    SkRecordNoopOccludedDraws(record);
+    SkRecordBatchDraws(record);
 
     record->defrag();
 }
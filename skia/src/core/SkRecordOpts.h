@@ -24,6 +24,21 @@ void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 // the alpha of the first SaveLayer to the second SaveLayer.
 void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
 
+// Turns SetMatrix and Concat ops that don't change the matrix, and ClipRects already applied
+// under the same matrix, into no-ops.  Also merges adjacent Save-ClipRect-Draw*-Restore blocks
+// that clip to the same rect.
+void SkRecordNoopRedundantState(SkRecord*);
+
+// Merges runs of DrawRect (or DrawBitmapRect{,Fast} of the same bitmap) that share a paint into
+// a single DrawRects (or DrawBitmapRects).  The batched op has the union of the bounds of the
+// draws it replaces, so this is best saved for pictures played back without a BBH.
+void SkRecordBatchDraws(SkRecord*);
+
+// No-ops draws that are completely covered by a later opaque DrawRect or DrawPaint.  This
+// assumes the picture is not played back shrunk by much, as it only allows one pixel of slack for
+// anti-aliased edges.
+void SkRecordNoopOccludedDraws(SkRecord*);
+
 // Experimental optimizers
 void SkRecordOptimize2(SkRecord*);
 
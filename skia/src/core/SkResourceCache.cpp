@@ -320,6 +320,53 @@ void SkResourceCache::purgeAsNeeded(bool forcePurge) {
     }
 }
 
+size_t SkResourceCache::purgePriority(PurgePriority priority) {
+    size_t before = fTotalBytesUsed;
+    Rec* rec = fTail;
+    while (rec) {
+        Rec* prev = rec->fPrev;
+        if (rec->getPurgePriority() == priority) {
+            this->remove(rec);
+        }
+        rec = prev;
+    }
+    return before - fTotalBytesUsed;
+}
+
+size_t SkResourceCache::purgeForMemoryPressure(MemoryPressure pressure,
+                                               DiscardableFactory factory,
+                                               size_t* bytesMadeDiscardable) {
+    this->checkMessages();
+
+    size_t freed = this->purgePriority(kMipMap_PurgePriority);
+    if (kCritical_MemoryPressure == pressure) {
+        for (int p = kMipMap_PurgePriority + 1; p <= kLast_PurgePriority; ++p) {
+            freed += this->purgePriority((PurgePriority)p);
+        }
+    }
+
+    size_t moved = 0;
+    if (factory && !fDiscardableFactory) {
+        for (Rec* rec = fTail; rec; rec = rec->fPrev) {
+            if (rec->moveToDiscardable(factory)) {
+                moved += rec->bytesUsed();
+            }
+        }
+    }
+    if (bytesMadeDiscardable) {
+        *bytesMadeDiscardable = moved;
+    }
+
+    if (gDumpCacheTransactions) {
+        SkString freedStr, movedStr;
+        make_size_str(freed, &freedStr);
+        make_size_str(moved, &movedStr);
+        SkDebugf("RC: pressure %d freed %5s made discardable %5s, count %d\n",
+                 pressure, freedStr.c_str(), movedStr.c_str(), fCount);
+    }
+    return freed;
+}
+
 //#define SK_TRACK_PURGE_SHAREDID_HITRATE
 
 #ifdef SK_TRACK_PURGE_SHAREDID_HITRATE
@@ -624,6 +671,11 @@ void SkResourceCache::PurgeAll() {
     return get_cache()->purgeAll();
 }
 
+size_t SkResourceCache::PurgeForMemoryPressure(MemoryPressure pressure) {
+    SkAutoMutexAcquire am(gMutex);
+    return get_cache()->purgeForMemoryPressure(pressure, SkDiscardableMemory::Create);
+}
+
 bool SkResourceCache::Find(const Key& key, FindVisitor visitor, void* context) {
     SkAutoMutexAcquire am(gMutex);
     return get_cache()->find(key, visitor, context);
@@ -71,6 +71,33 @@ public:
         const uint32_t* as32() const { return (const uint32_t*)this; }
     };
 
+    /**
+     *  Under memory pressure, recs are purged class by class, in this order: mipmaps can be
+     *  rebuilt cheaply from their source, decoded images need a decode, and blur masks need
+     *  a (slow) blur. Anything else goes last.
+     */
+    enum PurgePriority {
+        kMipMap_PurgePriority,
+        kDecodedImage_PurgePriority,
+        kBlurMask_PurgePriority,
+        kOther_PurgePriority,
+
+        kLast_PurgePriority = kOther_PurgePriority
+    };
+
+    enum MemoryPressure {
+        /** Purge mipmaps and move what we can of the rest onto discardable memory. */
+        kModerate_MemoryPressure,
+        /** Purge everything, in PurgePriority order. */
+        kCritical_MemoryPressure,
+    };
+
+    /**
+     *  Returns a locked/pinned SkDiscardableMemory instance for the specified
+     *  number of bytes, or nullptr on failure.
+     */
+    typedef SkDiscardableMemory* (*DiscardableFactory)(size_t bytes);
+
     struct Rec {
         typedef SkResourceCache::Key Key;
 
@@ -86,6 +113,12 @@ public:
         virtual const char* getCategory() const = 0;
         virtual SkDiscardableMemory* diagnostic_only_getDiscardable() const { return nullptr; }
 
+        // for purgeForMemoryPressure()
+        virtual PurgePriority getPurgePriority() const { return kOther_PurgePriority; }
+        // If our contents are in malloc-ed memory nobody else is using, move them into
+        // discardable memory from factory, returning true if they moved.
+        virtual bool moveToDiscardable(DiscardableFactory) { return false; }
+
         // for SkTDynamicHash::Traits
         static uint32_t Hash(const Key& key) { return key.hash(); }
         static const Key& GetKey(const Rec& rec) { return rec.getKey(); }
@@ -118,12 +151,6 @@ public:
      */
     typedef bool (*FindVisitor)(const Rec&, void* context);
 
-    /**
-     *  Returns a locked/pinned SkDiscardableMemory instance for the specified
-     *  number of bytes, or nullptr on failure.
-     */
-    typedef SkDiscardableMemory* (*DiscardableFactory)(size_t bytes);
-
     /*
      *  The following static methods are thread-safe wrappers around a global
      *  instance of this cache.
@@ -155,6 +182,13 @@ public:
 
     static void PurgeAll();
 
+    /**
+     *  Purge the global cache according to the level of pressure; see MemoryPressure. If the
+     *  cache is malloc-backed, entries are moved onto SkDiscardableMemory::Create() memory.
+     *  Returns the number of bytes freed.
+     */
+    static size_t PurgeForMemoryPressure(MemoryPressure);
+
     static void TestDumpMemoryStatistics();
 
     /** Dump memory usage statistics of every Rec in the cache using the
@@ -242,6 +276,15 @@ public:
         this->purgeAsNeeded(true);
     }
 
+    /**
+     *  Purge according to the level of pressure; see MemoryPressure. Under moderate pressure,
+     *  recs that survive are moved onto memory from factory, if it is not nullptr (and the cache
+     *  isn't already discardable-backed). Returns the number of bytes freed, and optionally the
+     *  number of bytes moved onto discardable memory.
+     */
+    size_t purgeForMemoryPressure(MemoryPressure, DiscardableFactory factory = nullptr,
+                                  size_t* bytesMadeDiscardable = nullptr);
+
     DiscardableFactory discardableFactory() const { return fDiscardableFactory; }
     SkBitmap::Allocator* allocator() const { return fAllocator; };
 
@@ -272,6 +315,7 @@ private:
 
     void checkMessages();
     void purgeAsNeeded(bool forcePurge = false);
+    size_t purgePriority(PurgePriority);
 
     // linklist management
     void moveToHead(Rec*);
@@ -22,6 +22,11 @@ class SkPath;
 */
 typedef SkIRect SkXRect;
 
+/** If true, anti-aliased path fills compute exact per-pixel area coverage instead of 4x
+    supersampling. Defaults to true when SK_USE_ANALYTIC_AA is defined.
+*/
+extern bool gSkUseAnalyticAA;
+
 class SkScan {
 public:
     /*
@@ -33,6 +33,10 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect,
                   SkBlitter* blitter, int start_y, int stop_y, int shiftEdgesUp,
                   const SkRegion& clipRgn);
 
+// Analytic anti-aliased fill of path (see SkScan_AAAPath.cpp). Every row of bounds, which must
+// lie within the clip, is blitted with exact area coverage; inverse fills cover all of bounds.
+void sk_aaa_fill_path(const SkPath& path, const SkIRect& bounds, SkBlitter* blitter);
+
 // blit the rects above and below avoid, clipped to clip
 void sk_blit_above(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
 void sk_blit_below(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
@@ -0,0 +1,322 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkScanPriv.h"
+#include "SkBlitter.h"
+#include "SkGeometry.h"
+#include "SkLineClipper.h"
+#include "SkPath.h"
+#include "SkRegion.h"
+#include "SkTDArray.h"
+#include "SkTSort.h"
+
+/*
+ *  Analytic anti-aliasing.
+ *
+ *  Instead of rasterizing the path at 4x resolution and averaging (see SkScan_AntiPath.cpp), we
+ *  flatten the path into line segments and compute, for every pixel, the exact signed area each
+ *  segment sweeps to its right. Accumulating those areas along a row gives the winding-weighted
+ *  coverage of each pixel. For non-overlapping contours this is exact; where contours overlap
+ *  the accumulated value is folded according to the fill type, which matches supersampling
+ *  except in pixels that contain more than one edge crossing of the same region.
+ *
+ *  The accumulation buffer covers a band of kBandHeight rows at a time, so memory stays
+ *  proportional to the width of the path rather than its area.
+ */
+
+bool gSkUseAnalyticAA =
+#ifdef SK_USE_ANALYTIC_AA
+        true;
+#else
+        false;
+#endif
+
+namespace {
+
+static const int kBandHeight = 16;
+
+// Curves are flattened until the chords are within this distance (in pixels) of the curve.
+static const SkScalar kFlattenTolerance = 0.1f;
+static const int kMaxFlattenSegments = 128;
+
+struct Line {
+    SkPoint fP0;    // fP0.fY < fP1.fY, after construction
+    SkPoint fP1;
+    float   fDir;   // +1 if the original segment pointed down, -1 if it pointed up
+
+    bool operator<(const Line& other) const { return fP0.fY < other.fP0.fY; }
+};
+
+class LineCollector {
+public:
+    LineCollector(const SkRect& clip, const SkIPoint& origin)
+        : fClip(clip), fOrigin(SkPoint::Make(SkIntToScalar(origin.fX),
+                                             SkIntToScalar(origin.fY))) {}
+
+    void addLine(const SkPoint& p0, const SkPoint& p1) {
+        SkPoint pts[2] = { p0, p1 };
+        SkPoint clipped[SkLineClipper::kMaxPoints];
+        int count = SkLineClipper::ClipLine(pts, fClip, clipped, true);
+        for (int i = 0; i < count; i++) {
+            SkPoint a = clipped[i] - fOrigin;
+            SkPoint b = clipped[i + 1] - fOrigin;
+            if (a.fY == b.fY) {
+                continue;   // horizontal lines sweep no area
+            }
+            Line* line = fLines.append();
+            if (a.fY < b.fY) {
+                line->fP0 = a;
+                line->fP1 = b;
+                line->fDir = 1;
+            } else {
+                line->fP0 = b;
+                line->fP1 = a;
+                line->fDir = -1;
+            }
+        }
+    }
+
+    void addQuad(const SkPoint pts[3]) {
+        SkVector dd = pts[0] - pts[1] - pts[1] + pts[2];
+        int n = segment_count(dd.length() / 4);
+        SkPoint prev = pts[0];
+        for (int i = 1; i <= n; i++) {
+            SkPoint next = i == n ? pts[2] : eval_quad(pts, SkIntToScalar(i) / n);
+            this->addLine(prev, next);
+            prev = next;
+        }
+    }
+
+    void addCubic(const SkPoint pts[4]) {
+        SkVector dd0 = pts[0] - pts[1] - pts[1] + pts[2];
+        SkVector dd1 = pts[1] - pts[2] - pts[2] + pts[3];
+        int n = segment_count(SkTMax(dd0.length(), dd1.length()) * 3 / 4);
+        SkPoint prev = pts[0];
+        for (int i = 1; i <= n; i++) {
+            SkPoint next;
+            if (i == n) {
+                next = pts[3];
+            } else {
+                SkEvalCubicAt(pts, SkIntToScalar(i) / n, &next, nullptr, nullptr);
+            }
+            this->addLine(prev, next);
+            prev = next;
+        }
+    }
+
+    SkTDArray<Line>& lines() { return fLines; }
+
+private:
+    // Uniformly subdividing a curve into n pieces divides its deviation from the chord by n^2.
+    static int segment_count(SkScalar deviation) {
+        if (!(deviation > kFlattenTolerance)) {
+            return 1;
+        }
+        SkScalar n = SkScalarCeilToScalar(SkScalarSqrt(deviation / kFlattenTolerance));
+        return SkScalarRoundToInt(SkTMin(n, SkIntToScalar(kMaxFlattenSegments)));
+    }
+
+    static SkPoint eval_quad(const SkPoint pts[3], SkScalar t) {
+        SkPoint p;
+        SkEvalQuadAt(pts, t, &p, nullptr);
+        return p;
+    }
+
+    const SkRect    fClip;
+    const SkPoint   fOrigin;
+    SkTDArray<Line> fLines;
+};
+
+static void collect_lines(const SkPath& path, LineCollector* collector) {
+    SkPath::Iter iter(path, true);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kLine_Verb:
+                collector->addLine(pts[0], pts[1]);
+                break;
+            case SkPath::kQuad_Verb:
+                collector->addQuad(pts);
+                break;
+            case SkPath::kConic_Verb: {
+                SkAutoConicToQuads quadder;
+                const SkPoint* quads = quadder.computeQuads(pts, iter.conicWeight(),
+                                                            kFlattenTolerance);
+                for (int i = 0; i < quadder.countQuads(); i++) {
+                    collector->addQuad(&quads[2 * i]);
+                }
+                break;
+            }
+            case SkPath::kCubic_Verb:
+                collector->addCubic(pts);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/*
+ *  Adds the area swept to the right by the part of line within [0, height) to acc, which holds
+ *  height rows of stride floats each. x is already within [0, stride - 2].
+ */
+static void accumulate_line(const Line& line, float top, float* acc, int stride, int height) {
+    float y0 = line.fP0.fY - top;
+    float y1 = line.fP1.fY - top;
+    const float dxdy = (line.fP1.fX - line.fP0.fX) / (line.fP1.fY - line.fP0.fY);
+    const float maxX = (float)(stride - 2);
+    float x = line.fP0.fX;
+    if (y0 < 0) {
+        x -= y0 * dxdy;
+        y0 = 0;
+    }
+    x = SkTPin(x, 0.0f, maxX);
+    y1 = SkTMin(y1, (float)height);
+
+    for (int y = (int)y0; y < height && (float)y < y1; y++) {
+        float* row = acc + y * stride;
+        const float dy = SkTMin((float)(y + 1), y1) - SkTMax((float)y, y0);
+        const float xnext = SkTPin(x + dxdy * dy, 0.0f, maxX);
+        const float d = dy * line.fDir;
+        const float xl = SkTMin(x, xnext);
+        const float xr = SkTMax(x, xnext);
+        const float xlFloor = floorf(xl);
+        const int xli = (int)xlFloor;
+        const int xri = (int)ceilf(xr);
+
+        if (xri <= xli + 1) {
+            // The segment stays within one pixel column: split d by how far right it passes.
+            const float xmf = 0.5f * (x + xnext) - xlFloor;
+            row[xli] += d - d * xmf;
+            row[xli + 1] += d * xmf;
+        } else {
+            // The swept area is a trapezoid; distribute it across the columns it crosses.
+            const float s = 1 / (xr - xl);
+            const float xlf = xl - xlFloor;
+            const float a0 = 0.5f * s * (1 - xlf) * (1 - xlf);
+            const float xrf = xr - xri + 1;
+            const float am = 0.5f * s * xrf * xrf;
+            row[xli] += d * a0;
+            if (xri == xli + 2) {
+                row[xli + 1] += d * (1 - a0 - am);
+            } else {
+                const float a1 = s * (1.5f - xlf);
+                row[xli + 1] += d * (a1 - a0);
+                for (int xi = xli + 2; xi < xri - 1; xi++) {
+                    row[xi] += d * s;
+                }
+                const float a2 = a1 + (xri - xli - 3) * s;
+                row[xri - 1] += d * (1 - a2 - am);
+            }
+            row[xri] += d * am;
+        }
+        x = xnext;
+    }
+}
+
+static inline SkAlpha coverage_to_alpha(float winding, bool evenOdd, bool inverse) {
+    float c = fabsf(winding);
+    if (evenOdd) {
+        c -= 2 * floorf(c * 0.5f);
+        if (c > 1) {
+            c = 2 - c;
+        }
+    } else if (c > 1) {
+        c = 1;
+    }
+    if (inverse) {
+        c = 1 - c;
+    }
+    return (SkAlpha)(c * 255 + 0.5f);
+}
+
+/*
+ *  Blits one row of accumulated area as runs, skipping transparent runs at either end. Clears
+ *  the row so it can be reused for the next band.
+ */
+static void blit_row(SkBlitter* blitter, int left, int y, float* row, int width, bool evenOdd,
+                     bool inverse, SkAlpha* alpha, int16_t* runs) {
+    float winding = 0;
+    for (int x = 0; x < width; x++) {
+        winding += row[x];
+        alpha[x] = coverage_to_alpha(winding, evenOdd, inverse);
+    }
+    memset(row, 0, (width + 2) * sizeof(float));
+
+    int start = 0;
+    while (start < width && 0 == alpha[start]) {
+        start++;
+    }
+    int stop = width;
+    while (stop > start && 0 == alpha[stop - 1]) {
+        stop--;
+    }
+    if (start == stop) {
+        return;
+    }
+
+    int x = start;
+    while (x < stop) {
+        int runEnd = x + 1;
+        while (runEnd < stop && alpha[runEnd] == alpha[x]) {
+            runEnd++;
+        }
+        runs[x - start] = SkToS16(runEnd - x);
+        alpha[x - start] = alpha[x];
+        x = runEnd;
+    }
+    runs[stop - start] = 0;
+    blitter->blitAntiH(left + start, y, alpha, runs);
+}
+
+}  // namespace
+
+void sk_aaa_fill_path(const SkPath& path, const SkIRect& bounds, SkBlitter* blitter) {
+    SkASSERT(!bounds.isEmpty());
+
+    const int width = bounds.width();
+    const int stride = width + 2;
+    LineCollector collector(SkRect::Make(bounds), SkIPoint::Make(bounds.fLeft, bounds.fTop));
+    collect_lines(path, &collector);
+
+    SkTDArray<Line>& lines = collector.lines();
+    if (lines.count() > 1) {
+        SkTQSort(lines.begin(), lines.end() - 1);
+    }
+
+    const bool evenOdd = SkPath::kEvenOdd_FillType == (path.getFillType() & 1);
+    const bool inverse = path.isInverseFillType();
+
+    SkAutoTMalloc<float> acc(stride * kBandHeight);
+    memset(acc.get(), 0, stride * kBandHeight * sizeof(float));
+    SkAutoTMalloc<SkAlpha> alpha(width + 1);
+    SkAutoTMalloc<int16_t> runs(width + 1);
+
+    int firstLine = 0;
+    for (int bandTop = 0; bandTop < bounds.height(); bandTop += kBandHeight) {
+        const int bandHeight = SkTMin(kBandHeight, bounds.height() - bandTop);
+        const float top = (float)bandTop;
+        const float bottom = (float)(bandTop + bandHeight);
+
+        // Lines are sorted by their top, so we can stop at the first line starting below this
+        // band, and skip the leading lines that have already been finished.
+        while (firstLine < lines.count() && lines[firstLine].fP1.fY <= top) {
+            firstLine++;
+        }
+        for (int i = firstLine; i < lines.count() && lines[i].fP0.fY < bottom; i++) {
+            if (lines[i].fP1.fY > top) {
+                accumulate_line(lines[i], top, acc.get(), stride, bandHeight);
+            }
+        }
+
+        for (int y = 0; y < bandHeight; y++) {
+            blit_row(blitter, bounds.fLeft, bounds.fTop + bandTop + y, acc.get() + y * stride,
+                     width, evenOdd, inverse, alpha.get(), runs.get());
+        }
+    }
+}
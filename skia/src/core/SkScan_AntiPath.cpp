@@ -712,9 +712,21 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
 
     SkASSERT(SkIntToScalar(ir.fTop) <= path.getBounds().fTop);
 
-    // MaskSuperBlitter can't handle drawing outside of ir, so we can't use it
-    // if we're an inverse filltype
-    if (!isInverse && MaskSuperBlitter::CanHandleRect(ir) && !forceRLE) {
+    if (gSkUseAnalyticAA) {
+        // Like SuperBlitter, inverse fills cover the full width of the clip.
+        SkIRect bounds = clipRgn->getBounds();
+        if (!isInverse) {
+            bounds.fLeft = SkTMax(bounds.fLeft, ir.fLeft);
+            bounds.fRight = SkTMin(bounds.fRight, ir.fRight);
+        }
+        bounds.fTop = SkTMax(bounds.fTop, ir.fTop);
+        bounds.fBottom = SkTMin(bounds.fBottom, ir.fBottom);
+        if (!bounds.isEmpty()) {
+            sk_aaa_fill_path(path, bounds, blitter);
+        }
+    } else if (!isInverse && MaskSuperBlitter::CanHandleRect(ir) && !forceRLE) {
+        // MaskSuperBlitter can't handle drawing outside of ir, so we can't use it
+        // if we're an inverse filltype
         MaskSuperBlitter    superBlit(blitter, ir, *clipRgn, isInverse);
         SkASSERT(SkIntToScalar(ir.fTop) <= path.getBounds().fTop);
         sk_fill_path(path, superClipRect, &superBlit, ir.fTop, ir.fBottom, SHIFT, *clipRgn);
@@ -52,6 +52,12 @@ struct YUVPlanesRec : public SkResourceCache::Rec {
     SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
         return fValue.fData->diagnostic_only_getDiscardable();
     }
+    SkResourceCache::PurgePriority getPurgePriority() const override {
+        return SkResourceCache::kDecodedImage_PurgePriority;
+    }
+    bool moveToDiscardable(SkResourceCache::DiscardableFactory factory) override {
+        return fValue.fData->moveToDiscardable(factory);
+    }
 
     static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
         const YUVPlanesRec& rec = static_cast<const YUVPlanesRec&>(baseRec);
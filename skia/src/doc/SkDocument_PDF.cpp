@@ -50,6 +50,18 @@ static void emit_pdf_footer(SkWStream* stream,
     stream->writeText("\n%%EOF");
 }
 
+static void emit_pdf_xref(SkWStream* stream, const SkTDArray<int32_t>& offsets) {
+    // Include the zeroth object in the count.
+    stream->writeText("xref\n0 ");
+    stream->writeDecAsText(offsets.count() + 1);
+    stream->writeText("\n0000000000 65535 f \n");
+    for (int i = 0; i < offsets.count(); i++) {
+        SkASSERT(offsets[i] > 0);
+        stream->writeBigDecAsText(offsets[i], 10);
+        stream->writeText(" 00000 n \n");
+    }
+}
+
 static void perform_font_subsetting(
         const SkTDArray<const SkPDFDevice*>& pageDevices,
         SkPDFSubstituteMap* substituteMap) {
@@ -166,31 +178,11 @@ static void generate_page_tree(const SkTDArray<SkPDFDict*>& pages,
     }
 }
 
-static bool emit_pdf_document(const SkTDArray<const SkPDFDevice*>& pageDevices,
-                              const SkPDFMetadata& metadata,
-                              SkWStream* stream) {
-    if (pageDevices.isEmpty()) {
-        return false;
-    }
-
-    SkTDArray<SkPDFDict*> pages;
-    SkAutoTUnref<SkPDFDict> dests(new SkPDFDict);
-
-    for (int i = 0; i < pageDevices.count(); i++) {
-        SkASSERT(pageDevices[i]);
-        SkASSERT(i == 0 ||
-                 pageDevices[i - 1]->getCanon() == pageDevices[i]->getCanon());
-        SkAutoTUnref<SkPDFDict> page(create_pdf_page(pageDevices[i]));
-        pageDevices[i]->appendDestinations(dests, page.get());
-        pages.push(page.detach());
-    }
-
+// Returns a new catalog, with the document metadata but without "Pages".  Sets *id to the
+// document ID, if any.
+static SkPDFDict* create_document_catalog(const SkPDFMetadata& metadata,
+                                          SkAutoTUnref<SkPDFObject>* id) {
     SkAutoTUnref<SkPDFDict> docCatalog(new SkPDFDict("Catalog"));
-
-    SkAutoTUnref<SkPDFObject> infoDict(
-            metadata.createDocumentInformationDict());
-
-    SkAutoTUnref<SkPDFObject> id, xmp;
 #ifdef SK_PDF_GENERATE_PDFA
     SkPDFMetadata::UUID uuid = metadata.uuid();
     // We use the same UUID for Document ID and Instance ID since this
@@ -198,9 +190,8 @@ static bool emit_pdf_document(const SkTDArray<const SkPDFDevice*>& pageDevices,
     // support revising existing PDF documents).
     // If we are not in PDF/A mode, don't use a UUID since testing
     // works best with reproducible outputs.
-    id.reset(SkPDFMetadata::CreatePdfId(uuid, uuid));
-    xmp.reset(metadata.createXMPObject(uuid, uuid));
-    docCatalog->insertObjRef("Metadata", xmp.detach());
+    id->reset(SkPDFMetadata::CreatePdfId(uuid, uuid));
+    docCatalog->insertObjRef("Metadata", metadata.createXMPObject(uuid, uuid));
 
     // sRGB is specified by HTML, CSS, and SVG.
     SkAutoTUnref<SkPDFDict> outputIntent(new SkPDFDict("OutputIntent"));
@@ -214,6 +205,32 @@ static bool emit_pdf_document(const SkTDArray<const SkPDFDevice*>& pageDevices,
     // no one has ever asked for this feature.
     docCatalog->insertObject("OutputIntents", intentArray.detach());
 #endif
+    return docCatalog.detach();
+}
+
+static bool emit_pdf_document(const SkTDArray<const SkPDFDevice*>& pageDevices,
+                              const SkPDFMetadata& metadata,
+                              SkWStream* stream) {
+    if (pageDevices.isEmpty()) {
+        return false;
+    }
+
+    SkTDArray<SkPDFDict*> pages;
+    SkAutoTUnref<SkPDFDict> dests(new SkPDFDict);
+
+    for (int i = 0; i < pageDevices.count(); i++) {
+        SkASSERT(pageDevices[i]);
+        SkASSERT(i == 0 ||
+                 pageDevices[i - 1]->getCanon() == pageDevices[i]->getCanon());
+        SkAutoTUnref<SkPDFDict> page(create_pdf_page(pageDevices[i]));
+        pageDevices[i]->appendDestinations(dests, page.get());
+        pages.push(page.detach());
+    }
+
+    SkAutoTUnref<SkPDFObject> infoDict(
+            metadata.createDocumentInformationDict());
+    SkAutoTUnref<SkPDFObject> id;
+    SkAutoTUnref<SkPDFDict> docCatalog(create_document_catalog(metadata, &id));
 
     SkTDArray<SkPDFDict*> pageTree;
     SkPDFDict* pageTreeRoot;
@@ -253,14 +270,7 @@ static bool emit_pdf_document(const SkTDArray<const SkPDFDevice*>& pageDevices,
     // Include the zeroth object in the count.
     int32_t objCount = SkToS32(offsets.count() + 1);
 
-    stream->writeText("xref\n0 ");
-    stream->writeDecAsText(objCount);
-    stream->writeText("\n0000000000 65535 f \n");
-    for (int i = 0; i < offsets.count(); i++) {
-        SkASSERT(offsets[i] > 0);
-        stream->writeBigDecAsText(offsets[i], 10);
-        stream->writeText(" 00000 n \n");
-    }
+    emit_pdf_xref(stream, offsets);
     emit_pdf_footer(stream, objNumMap, substitutes, docCatalog.get(), objCount,
                     xRefFileOffset, infoDict.detach(), id.detach());
 
@@ -274,6 +284,178 @@ static bool emit_pdf_document(const SkTDArray<const SkPDFDevice*>& pageDevices,
     return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+/**
+ *  Writes each page, and every object it needs that has not been written yet,
+ *  as soon as the page is finished.  Only the object numbers, the offsets for
+ *  the cross-reference table, the fonts (which can only be subset once every
+ *  page is done) and hollowed-out page dictionaries (which the page tree and
+ *  destinations refer to) stay in memory until finish().
+ */
+class PDFStreamingWriter : SkNoncopyable {
+public:
+    PDFStreamingWriter()
+        : fBaseOffset(0)
+        , fNextObject(0)
+        , fPageTree(new SkPDFDict("Pages"))
+        , fDests(new SkPDFDict) {
+        // Pages need their parent's object number, so it is reserved now and
+        // the page tree is written by finish().
+        fObjNumMap.addObject(fPageTree.get());
+        fDeferred.add(fPageTree.get());
+    }
+
+    ~PDFStreamingWriter() {
+        // Pages point back at the page tree, which creates a reference cycle.
+        fPageTree->clear();
+        fPages.unrefAll();
+        fRetained.unrefAll();
+        fFonts.unrefAll();
+    }
+
+    int pageCount() const { return fPages.count(); }
+
+    void emitPage(const SkPDFDevice* pageDevice /* takes ownership */, SkWStream* stream) {
+        if (fPages.isEmpty()) {
+            fBaseOffset = stream->bytesWritten();
+            emit_pdf_header(stream);
+        }
+
+        // Reserve numbers for the page's fonts without adding their resources.
+        const SkPDFGlyphSetMap& usage = pageDevice->getFontGlyphUsage();
+        SkPDFGlyphSetMap::F2BIter iterator(usage);
+        for (auto entry = iterator.next(); entry; entry = iterator.next()) {
+            if (fObjNumMap.addObject(entry->fFont)) {
+                fDeferred.add(entry->fFont);
+            }
+        }
+        fGlyphUsage.merge(usage);
+
+        SkAutoTUnref<SkPDFDict> page(create_pdf_page(pageDevice));
+        page->insertObjRef("Parent", SkRef(fPageTree.get()));
+        pageDevice->appendDestinations(fDests, page.get());
+        fObjNumMap.addObjectRecursively(page.get(), fSubstitutes);
+
+        SkTDArray<SkPDFObject*> emitted;
+        this->emitNewObjects(stream, &emitted);
+
+        // Drop everything only this page used.  Anything still referenced
+        // elsewhere (e.g. by the canon) keeps its number, but lets go of
+        // what it needed to be written, such as an image's pixels.
+        page->clear();
+        fPages.push(page.detach());
+        pageDevice->unref();
+        for (SkPDFObject* object : emitted) {
+            if (object->unique()) {
+                fObjNumMap.removeObject(object);
+                object->unref();
+            } else {
+                object->drop();
+                fRetained.push(object);
+            }
+        }
+    }
+
+    bool finish(const SkPDFMetadata& metadata, SkWStream* stream) {
+        if (fPages.isEmpty()) {
+            return false;
+        }
+
+        // A single level page tree keeps every page's parent known up front.
+        SkAutoTUnref<SkPDFArray> kids(new SkPDFArray);
+        kids->reserve(fPages.count());
+        for (SkPDFDict* page : fPages) {
+            kids->appendObjRef(SkRef(page));
+        }
+        fPageTree->insertInt("Count", fPages.count());
+        fPageTree->insertObject("Kids", kids.detach());
+
+        SkAutoTUnref<SkPDFObject> infoDict(metadata.createDocumentInformationDict());
+        SkAutoTUnref<SkPDFObject> id;
+        SkAutoTUnref<SkPDFDict> docCatalog(create_document_catalog(metadata, &id));
+        docCatalog->insertObjRef("Pages", SkRef(fPageTree.get()));
+        if (fDests->size() > 0) {
+            docCatalog->insertObjRef("Dests", SkRef(fDests.get()));
+        }
+
+        // Each font is written, subset if possible, under the number pages already use.
+        SkTDArray<int32_t> fontNumbers;
+        SkPDFGlyphSetMap::F2BIter iterator(fGlyphUsage);
+        for (auto entry = iterator.next(); entry; entry = iterator.next()) {
+            if (!fDeferred.contains(entry->fFont)) {
+                continue;  // Already written by a page that used it without glyphs.
+            }
+            SkPDFObject* font = entry->fFont->getFontSubset(entry->fGlyphSet);
+            if (!font) {
+                font = SkRef(entry->fFont);
+            }
+            font->addResources(&fObjNumMap, fSubstitutes);
+            fontNumbers.push(fObjNumMap.getObjectNumber(entry->fFont));
+            fFonts.push(font);
+        }
+        fObjNumMap.addObjectRecursively(infoDict, fSubstitutes);
+        fObjNumMap.addObjectRecursively(docCatalog.get(), fSubstitutes);
+
+        this->emitObject(stream, fObjNumMap.getObjectNumber(fPageTree.get()), fPageTree.get());
+        for (int i = 0; i < fFonts.count(); ++i) {
+            this->emitObject(stream, fontNumbers[i], fFonts[i]);
+        }
+        this->emitNewObjects(stream, nullptr);
+
+        int32_t xRefFileOffset = SkToS32(stream->bytesWritten() - fBaseOffset);
+        emit_pdf_xref(stream, fOffsets);
+        emit_pdf_footer(stream, fObjNumMap, fSubstitutes, docCatalog.get(),
+                        fOffsets.count() + 1, xRefFileOffset,
+                        infoDict.detach(), id.detach());
+        return true;
+    }
+
+private:
+    void emitObject(SkWStream* stream, int32_t objNum, SkPDFObject* object) {
+        while (fOffsets.count() < fObjNumMap.objects().count()) {
+            fOffsets.push(0);
+        }
+        SkASSERT(0 == fOffsets[objNum - 1]);
+        fOffsets[objNum - 1] = SkToS32(stream->bytesWritten() - fBaseOffset);
+        stream->writeDecAsText(objNum);
+        stream->writeText(" 0 obj\n");  // Generation number is always 0.
+        object->emitObject(stream, fObjNumMap, fSubstitutes);
+        stream->writeText("\nendobj\n");
+    }
+
+    // Writes every object added since the last call, except the deferred ones.
+    // If emitted is not null, it takes a ref to each object written.
+    void emitNewObjects(SkWStream* stream, SkTDArray<SkPDFObject*>* emitted) {
+        const SkTDArray<SkPDFObject*>& objects = fObjNumMap.objects();
+        for (; fNextObject < objects.count(); ++fNextObject) {
+            SkPDFObject* object = objects[fNextObject];
+            if (fDeferred.contains(object)) {
+                continue;
+            }
+            this->emitObject(stream, fNextObject + 1, object);
+            if (emitted) {
+                emitted->push(SkRef(object));
+            }
+        }
+    }
+
+    size_t fBaseOffset;
+    int fNextObject;
+    SkPDFObjNumMap fObjNumMap;
+    SkPDFSubstituteMap fSubstitutes;  // Always empty; fonts are subset by finish().
+    SkTDArray<int32_t> fOffsets;
+    SkTHashSet<SkPDFObject*> fDeferred;
+    SkPDFGlyphSetMap fGlyphUsage;
+    SkAutoTUnref<SkPDFDict> fPageTree;
+    SkAutoTUnref<SkPDFDict> fDests;
+    SkTDArray<SkPDFDict*> fPages;
+    SkTDArray<SkPDFObject*> fRetained;
+    SkTDArray<SkPDFObject*> fFonts;
+};
+}  // namespace
+
 #if 0
 // TODO(halcanary): expose notEmbeddableCount in SkDocument
 void GetCountOfFontTypes(
@@ -323,10 +505,14 @@ public:
     SkDocument_PDF(SkWStream* stream,
                    void (*doneProc)(SkWStream*, bool),
                    SkScalar rasterDpi,
-                   SkPixelSerializer* jpegEncoder)
+                   SkPixelSerializer* jpegEncoder,
+                   bool streaming = false)
         : SkDocument(stream, doneProc)
         , fRasterDpi(rasterDpi) {
         fCanon.fPixelSerializer.reset(SkSafeRef(jpegEncoder));
+        if (streaming) {
+            fStreamer.reset(new PDFStreamingWriter);
+        }
     }
 
     virtual ~SkDocument_PDF() {
@@ -354,19 +540,28 @@ protected:
         SkASSERT(fCanvas.get());
         fCanvas->flush();
         fCanvas.reset(nullptr);
+        if (fStreamer) {
+            SkASSERT(1 == fPageDevices.count());
+            const SkPDFDevice* device;
+            fPageDevices.pop(&device);
+            fStreamer->emitPage(device, this->getStream());
+        }
     }
 
     bool onClose(SkWStream* stream) override {
         SkASSERT(!fCanvas.get());
 
-        bool success = emit_pdf_document(fPageDevices, fMetadata, stream);
+        bool success = fStreamer ? fStreamer->finish(fMetadata, stream)
+                                 : emit_pdf_document(fPageDevices, fMetadata, stream);
         fPageDevices.unrefAll();
+        fStreamer.reset(nullptr);
         fCanon.reset();
         return success;
     }
 
     void onAbort() override {
         fPageDevices.unrefAll();
+        fStreamer.reset(nullptr);
         fCanon.reset();
     }
 
@@ -385,6 +580,7 @@ private:
     SkAutoTUnref<SkCanvas> fCanvas;
     SkScalar fRasterDpi;
     SkPDFMetadata fMetadata;
+    SkAutoTDelete<PDFStreamingWriter> fStreamer;
 };
 }  // namespace
 ///////////////////////////////////////////////////////////////////////////////
@@ -401,6 +597,10 @@ SkDocument* SkDocument::CreatePDF(SkWStream* stream,
         : nullptr;
 }
 
+SkDocument* SkDocument::CreateStreamingPDF(SkWStream* stream, SkScalar dpi) {
+    return stream ? new SkDocument_PDF(stream, nullptr, dpi, nullptr, true) : nullptr;
+}
+
 SkDocument* SkDocument::CreatePDF(const char path[], SkScalar dpi) {
     SkFILEWStream* stream = new SkFILEWStream(path);
     if (!stream->isValid()) {
@@ -7,3 +7,4 @@
 #include "SkDocument.h"
 SkDocument* SkDocument::CreatePDF(SkWStream*, SkScalar) { return  nullptr; }
 SkDocument* SkDocument::CreatePDF(const char path[], SkScalar) { return nullptr; }
+SkDocument* SkDocument::CreateStreamingPDF(SkWStream*, SkScalar) { return nullptr; }
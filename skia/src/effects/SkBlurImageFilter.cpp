@@ -12,6 +12,7 @@
 #include "SkGpuBlurUtils.h"
 #include "SkOpts.h"
 #include "SkReadBuffer.h"
+#include "SkTaskGroup.h"
 #include "SkWriteBuffer.h"
 #if SK_SUPPORT_GPU
 #include "GrContext.h"
@@ -25,6 +26,25 @@
 // raster paths.
 #define MAX_SIGMA SkIntToScalar(532)
 
+// Each pass blurs its rows independently, so we split big passes into bands of at least this
+// many rows and blur them on SkTaskGroup threads.
+static const int kMinParallelBlurRows = 64;
+
+static void box_blur(SkOpts::BoxBlur proc, const SkPMColor* src, int srcStride,
+                     const SkIRect& srcBounds, SkPMColor* dst, int kernelSize,
+                     int leftOffset, int rightOffset, int width, int height) {
+    const int bandCount = SkTMin(sk_num_cores(), height / kMinParallelBlurRows);
+    if (bandCount <= 1) {
+        proc(src, srcStride, srcBounds, dst, kernelSize, leftOffset, rightOffset, width, height,
+             0, height);
+        return;
+    }
+    SkTaskGroup().batch(bandCount, [&](int i) {
+        proc(src, srcStride, srcBounds, dst, kernelSize, leftOffset, rightOffset, width, height,
+             height * i / bandCount, height * (i + 1) / bandCount);
+    });
+}
+
 static SkVector map_sigma(const SkSize& localSigma, const SkMatrix& ctm) {
     SkVector sigma = SkVector::Make(localSigma.width(), localSigma.height());
     ctm.mapVectors(&sigma, 1);
@@ -159,21 +179,24 @@ bool SkBlurImageFilter::onFilterImageDeprecated(Proxy* proxy,
      * In this way, two of the y-blurs become x-blurs applied to transposed
      * images, and all memory reads are contiguous.
      */
+    const SkOpts::BoxBlur xx = SkOpts::box_blur_xx,
+                          xy = SkOpts::box_blur_xy,
+                          yx = SkOpts::box_blur_yx;
     if (kernelSizeX > 0 && kernelSizeY > 0) {
-        SkOpts::box_blur_xx(s, sw,  srcBounds,  t, kernelSizeX,  lowOffsetX,  highOffsetX, w, h);
-        SkOpts::box_blur_xx(t,  w,  dstBounds,  d, kernelSizeX,  highOffsetX, lowOffsetX,  w, h);
-        SkOpts::box_blur_xy(d,  w,  dstBounds,  t, kernelSizeX3, highOffsetX, highOffsetX, w, h);
-        SkOpts::box_blur_xx(t,  h,  dstBoundsT, d, kernelSizeY,  lowOffsetY,  highOffsetY, h, w);
-        SkOpts::box_blur_xx(d,  h,  dstBoundsT, t, kernelSizeY,  highOffsetY, lowOffsetY,  h, w);
-        SkOpts::box_blur_xy(t,  h,  dstBoundsT, d, kernelSizeY3, highOffsetY, highOffsetY, h, w);
+        box_blur(xx, s, sw,  srcBounds,  t, kernelSizeX,  lowOffsetX,  highOffsetX, w, h);
+        box_blur(xx, t,  w,  dstBounds,  d, kernelSizeX,  highOffsetX, lowOffsetX,  w, h);
+        box_blur(xy, d,  w,  dstBounds,  t, kernelSizeX3, highOffsetX, highOffsetX, w, h);
+        box_blur(xx, t,  h,  dstBoundsT, d, kernelSizeY,  lowOffsetY,  highOffsetY, h, w);
+        box_blur(xx, d,  h,  dstBoundsT, t, kernelSizeY,  highOffsetY, lowOffsetY,  h, w);
+        box_blur(xy, t,  h,  dstBoundsT, d, kernelSizeY3, highOffsetY, highOffsetY, h, w);
     } else if (kernelSizeX > 0) {
-        SkOpts::box_blur_xx(s, sw,  srcBounds,  d, kernelSizeX,  lowOffsetX,  highOffsetX, w, h);
-        SkOpts::box_blur_xx(d,  w,  dstBounds,  t, kernelSizeX,  highOffsetX, lowOffsetX,  w, h);
-        SkOpts::box_blur_xx(t,  w,  dstBounds,  d, kernelSizeX3, highOffsetX, highOffsetX, w, h);
+        box_blur(xx, s, sw,  srcBounds,  d, kernelSizeX,  lowOffsetX,  highOffsetX, w, h);
+        box_blur(xx, d,  w,  dstBounds,  t, kernelSizeX,  highOffsetX, lowOffsetX,  w, h);
+        box_blur(xx, t,  w,  dstBounds,  d, kernelSizeX3, highOffsetX, highOffsetX, w, h);
     } else if (kernelSizeY > 0) {
-        SkOpts::box_blur_yx(s, sw,  srcBoundsT, d, kernelSizeY,  lowOffsetY,  highOffsetY, h, w);
-        SkOpts::box_blur_xx(d,  h,  dstBoundsT, t, kernelSizeY,  highOffsetY, lowOffsetY,  h, w);
-        SkOpts::box_blur_xy(t,  h,  dstBoundsT, d, kernelSizeY3, highOffsetY, highOffsetY, h, w);
+        box_blur(yx, s, sw,  srcBoundsT, d, kernelSizeY,  lowOffsetY,  highOffsetY, h, w);
+        box_blur(xx, d,  h,  dstBoundsT, t, kernelSizeY,  highOffsetY, lowOffsetY,  h, w);
+        box_blur(xy, t,  h,  dstBoundsT, d, kernelSizeY3, highOffsetY, highOffsetY, h, w);
     }
     return true;
 }
@@ -7,10 +7,12 @@
 
 #include "SkBlurMaskFilter.h"
 #include "SkBlurMask.h"
+#include "SkDraw.h"
 #include "SkGpuBlurUtils.h"
 #include "SkReadBuffer.h"
 #include "SkWriteBuffer.h"
 #include "SkMaskFilter.h"
+#include "SkMaskCache.h"
 #include "SkRRect.h"
 #include "SkRTConf.h"
 #include "SkStringUtils.h"
@@ -23,7 +25,6 @@
 #include "GrTexture.h"
 #include "GrFragmentProcessor.h"
 #include "GrInvariantOutput.h"
-#include "SkDraw.h"
 #include "effects/GrSimpleTextureEffect.h"
 #include "glsl/GrGLSLFragmentProcessor.h"
 #include "glsl/GrGLSLFragmentShaderBuilder.h"
@@ -44,6 +45,9 @@ public:
     SkMask::Format getFormat() const override;
     bool filterMask(SkMask* dst, const SkMask& src, const SkMatrix&,
                     SkIPoint* margin) const override;
+    bool filterPathMask(SkMask* dst, const SkPath& devPath, const SkMatrix& ctm,
+                        const SkIRect& clipBounds, SkPaint::Style, uint32_t pathGenID,
+                        const SkMatrix& pathMatrix) const override;
 
 #if SK_SUPPORT_GPU
     bool canFilterMaskGPU(const SkRRect& devRRect,
@@ -171,6 +175,59 @@ bool SkBlurMaskFilterImpl::filterMask(SkMask* dst, const SkMask& src,
     return SkBlurMask::BoxBlur(dst, src, sigma, fBlurStyle, this->getQuality(), margin);
 }
 
+bool SkBlurMaskFilterImpl::filterPathMask(SkMask* dst, const SkPath& devPath,
+                                          const SkMatrix& ctm, const SkIRect& clipBounds,
+                                          SkPaint::Style style, uint32_t pathGenID,
+                                          const SkMatrix& pathMatrix) const {
+    if (0 == pathGenID) {
+        return this->INHERITED::filterPathMask(dst, devPath, ctm, clipBounds, style, pathGenID,
+                                               pathMatrix);
+    }
+
+    // A mask that the clip trims depends on the clip, so only whole masks are cached.
+    SkMask whole, clipped;
+    if (!SkDraw::DrawToMask(devPath, nullptr, this, &ctm, &whole,
+                            SkMask::kJustComputeBounds_CreateMode, style) ||
+        !SkDraw::DrawToMask(devPath, &clipBounds, this, &ctm, &clipped,
+                            SkMask::kJustComputeBounds_CreateMode, style) ||
+        whole.fBounds != clipped.fBounds) {
+        return this->INHERITED::filterPathMask(dst, devPath, ctm, clipBounds, style, 0,
+                                               pathMatrix);
+    }
+
+    // Repeated paths (e.g. shadows of the same shape) reuse an earlier blur of the path.
+    // Our caller owns dst->fImage, so we always hand back a copy.
+    SkScalar sigma = this->computeXformedSigma(ctm);
+    SkMask cached;
+    SkAutoTUnref<SkCachedData> data(SkMaskCache::FindAndRef(sigma, fBlurStyle,
+                                                            this->getQuality(), pathGenID,
+                                                            pathMatrix, style, whole.fBounds,
+                                                            &cached));
+    if (data) {
+        *dst = cached;
+        dst->fImage = SkMask::AllocImage(cached.computeImageSize());
+        memcpy(dst->fImage, cached.fImage, cached.computeImageSize());
+        return true;
+    }
+
+    if (!this->INHERITED::filterPathMask(dst, devPath, ctm, clipBounds, style, pathGenID,
+                                         pathMatrix)) {
+        return false;
+    }
+    if (dst->fImage) {
+        const size_t size = dst->computeImageSize();
+        data.reset(SkResourceCache::NewCachedData(size));
+        if (data) {
+            memcpy(data->writable_data(), dst->fImage, size);
+            SkMask copy = *dst;
+            copy.fImage = (uint8_t*)data->data();
+            SkMaskCache::Add(sigma, fBlurStyle, this->getQuality(), pathGenID, pathMatrix, style,
+                             whole.fBounds, copy, data);
+        }
+    }
+    return true;
+}
+
 bool SkBlurMaskFilterImpl::filterRectMask(SkMask* dst, const SkRect& r,
                                           const SkMatrix& matrix,
                                           SkIPoint* margin, SkMask::CreateMode createMode) const {
@@ -263,8 +320,6 @@ static bool rect_exceeds(const SkRect& r, SkScalar v) {
            r.width() > v || r.height() > v;
 }
 
-#include "SkMaskCache.h"
-
 static SkCachedData* copy_mask_to_cacheddata(SkMask* mask) {
     const size_t size = mask->computeTotalImageSize();
     SkCachedData* data = SkResourceCache::NewCachedData(size);
@@ -8,6 +8,7 @@
 #include "GrBatchAtlas.h"
 #include "GrBatchFlushState.h"
 #include "GrRectanizer.h"
+#include "GrResourceProvider.h"
 #include "GrTracing.h"
 #include "GrVertexBuffer.h"
 
@@ -137,44 +138,84 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
-GrBatchAtlas::GrBatchAtlas(GrTexture* texture, int numPlotsX, int numPlotsY)
-    : fTexture(texture)
-    , fAtlasGeneration(kInvalidAtlasGeneration + 1) {
-
-    int plotWidth = texture->width() / numPlotsX;
-    int plotHeight = texture->height() / numPlotsY;
+GrBatchAtlas::GrBatchAtlas(GrTexture* texture, int numPlotsX, int numPlotsY, int maxPages)
+    : fNumPlotsX(numPlotsX)
+    , fNumPlotsY(numPlotsY)
+    , fNumPlotsPerPage(numPlotsX * numPlotsY)
+    , fMaxPages(SkTPin(maxPages, 1, kMaxPages))
+    , fNumPages(1)
+    , fAtlasGeneration(kInvalidAtlasGeneration + 1)
+    , fEvictionCount(0)
+    , fFlushCount(0) {
+
+    SkDEBUGCODE(int plotWidth = texture->width() / numPlotsX;)
+    SkDEBUGCODE(int plotHeight = texture->height() / numPlotsY;)
     SkASSERT(numPlotsX * numPlotsY <= BulkUseTokenUpdater::kMaxPlots);
     SkASSERT(plotWidth * numPlotsX == texture->width());
     SkASSERT(plotHeight * numPlotsY == texture->height());
 
-    SkDEBUGCODE(fNumPlots = numPlotsX * numPlotsY;)
-
     // We currently do not support compressed atlases...
     SkASSERT(!GrPixelConfigIsCompressed(texture->desc().fConfig));
 
-    // set up allocated plots
-    fPlotArray = new SkAutoTUnref<BatchPlot>[numPlotsX * numPlotsY];
+    sk_bzero(fTextures, sizeof(fTextures));
+    fTextures[0] = texture;
+
+    // set up allocated plots, leaving room for the pages we may add later
+    fPlotArray = new SkAutoTUnref<BatchPlot>[fNumPlotsPerPage * fMaxPages];
+    this->makePlots(0);
+}
 
-    SkAutoTUnref<BatchPlot>* currPlot = fPlotArray;
-    for (int y = numPlotsY - 1, r = 0; y >= 0; --y, ++r) {
-        for (int x = numPlotsX - 1, c = 0; x >= 0; --x, ++c) {
-            uint32_t index = r * numPlotsX + c;
-            currPlot->reset(new BatchPlot(index, 1, x, y, plotWidth, plotHeight,
-                                          texture->desc().fConfig));
+GrBatchAtlas::~GrBatchAtlas() {
+    for (int i = 0; i < fNumPages; ++i) {
+        SkSafeUnref(fTextures[i]);
+    }
+    delete[] fPlotArray;
+}
 
-            // build LRU list
-            fPlotList.addToHead(currPlot->get());
+void GrBatchAtlas::makePlots(int page) {
+    const GrSurfaceDesc& desc = fTextures[page]->desc();
+    int plotWidth = desc.fWidth / fNumPlotsX;
+    int plotHeight = desc.fHeight / fNumPlotsY;
+
+    SkAutoTUnref<BatchPlot>* currPlot = fPlotArray + page * fNumPlotsPerPage;
+    for (int y = fNumPlotsY - 1, r = 0; y >= 0; --y, ++r) {
+        for (int x = fNumPlotsX - 1, c = 0; x >= 0; --x, ++c) {
+            uint32_t index = page * fNumPlotsPerPage + r * fNumPlotsX + c;
+            currPlot->reset(new BatchPlot(index, 1, x, y, plotWidth, plotHeight, desc.fConfig));
+
+            // build LRU list.  The first page's plots are all unused, but the plots of any later
+            // page go to the tail so that they are the next ones the atlas hands out.
+            if (0 == page) {
+                fPlotList.addToHead(currPlot->get());
+            } else {
+                fPlotList.addToTail(currPlot->get());
+            }
             ++currPlot;
         }
     }
 }
 
-GrBatchAtlas::~GrBatchAtlas() {
-    SkSafeUnref(fTexture);
-    delete[] fPlotArray;
+bool GrBatchAtlas::addPage(GrDrawBatch::Target* target) {
+    if (fNumPages >= fMaxPages) {
+        return false;
+    }
+
+    GrSurfaceDesc desc = fTextures[0]->desc();
+    desc.fFlags = kNone_GrSurfaceFlags;
+    GrTexture* texture = target->resourceProvider()->createApproxTexture(
+            desc, GrResourceProvider::kNoPendingIO_Flag);
+    if (!texture) {
+        return false;
+    }
+
+    fTextures[fNumPages] = texture;
+    this->makePlots(fNumPages);
+    ++fNumPages;
+    return true;
 }
 
 void GrBatchAtlas::processEviction(AtlasID id) {
+    ++fEvictionCount;
     for (int i = 0; i < fEvictionCallbacks.count(); i++) {
         (*fEvictionCallbacks[i].fFunc)(id, fEvictionCallbacks[i].fData);
     }
@@ -188,7 +229,7 @@ inline void GrBatchAtlas::updatePlot(GrDrawBatch::Target* target, AtlasID* id, B
     // This new update will piggy back on that previously scheduled update.
     if (target->hasTokenBeenFlushed(plot->lastUploadToken())) {
         plot->setLastUploadToken(target->asapToken());
-        SkAutoTUnref<GrPlotUploader> uploader(new GrPlotUploader(plot, fTexture));
+        SkAutoTUnref<GrPlotUploader> uploader(new GrPlotUploader(plot, this->pageTexture(plot)));
         target->upload(uploader);
     }
     *id = plot->id();
@@ -197,14 +238,14 @@ inline void GrBatchAtlas::updatePlot(GrDrawBatch::Target* target, AtlasID* id, B
 bool GrBatchAtlas::addToAtlas(AtlasID* id, GrDrawBatch::Target* batchTarget,
                               int width, int height, const void* image, SkIPoint16* loc) {
     // We should already have a texture, TODO clean this up
-    SkASSERT(fTexture);
+    SkASSERT(fTextures[0]);
 
     // now look through all allocated plots for one we can share, in Most Recently Refed order
     GrBatchPlotList::Iter plotIter;
     plotIter.init(fPlotList, GrBatchPlotList::Iter::kHead_IterStart);
     BatchPlot* plot;
     while ((plot = plotIter.get())) {
-        SkASSERT(GrBytesPerPixel(fTexture->desc().fConfig) == plot->bpp());
+        SkASSERT(GrBytesPerPixel(fTextures[0]->desc().fConfig) == plot->bpp());
         if (plot->addSubImage(width, height, image, loc)) {
             this->updatePlot(batchTarget, id, plot);
             return true;
@@ -219,7 +260,7 @@ bool GrBatchAtlas::addToAtlas(AtlasID* id, GrDrawBatch::Target* batchTarget,
     if (batchTarget->hasTokenBeenFlushed(plot->lastUseToken())) {
         this->processEviction(plot->id());
         plot->resetRects();
-        SkASSERT(GrBytesPerPixel(fTexture->desc().fConfig) == plot->bpp());
+        SkASSERT(GrBytesPerPixel(fTextures[0]->desc().fConfig) == plot->bpp());
         SkDEBUGCODE(bool verify = )plot->addSubImage(width, height, image, loc);
         SkASSERT(verify);
         this->updatePlot(batchTarget, id, plot);
@@ -227,6 +268,16 @@ bool GrBatchAtlas::addToAtlas(AtlasID* id, GrDrawBatch::Target* batchTarget,
         return true;
     }
 
+    // Every plot is still in use by draws that haven't been executed yet.  Rather than evict one
+    // of them, grow by a page if the budget allows.  The new page's plots are at the LRU tail.
+    if (this->addPage(batchTarget)) {
+        plot = fPlotList.tail();
+        SkDEBUGCODE(bool verify = )plot->addSubImage(width, height, image, loc);
+        SkASSERT(verify);
+        this->updatePlot(batchTarget, id, plot);
+        return true;
+    }
+
     // The least recently used plot hasn't been flushed to the gpu yet, however, if we have flushed
     // it to the batch target than we can reuse it.  Our last use token is guaranteed to be less
     // than or equal to the current token.  If its 'less than' the current token, than we can spin
@@ -234,6 +285,7 @@ bool GrBatchAtlas::addToAtlas(AtlasID* id, GrDrawBatch::Target* batchTarget,
     // array.  If it is equal to the currentToken, then the caller has to flush draws to the batch
     // target so we can spin off the plot
     if (plot->lastUseToken() == batchTarget->currentToken()) {
+        ++fFlushCount;
         return false;
     }
 
@@ -248,14 +300,14 @@ bool GrBatchAtlas::addToAtlas(AtlasID* id, GrDrawBatch::Target* batchTarget,
     newPlot.reset(plot->clone());
 
     fPlotList.addToHead(newPlot.get());
-    SkASSERT(GrBytesPerPixel(fTexture->desc().fConfig) == newPlot->bpp());
+    SkASSERT(GrBytesPerPixel(fTextures[0]->desc().fConfig) == newPlot->bpp());
     SkDEBUGCODE(bool verify = )newPlot->addSubImage(width, height, image, loc);
     SkASSERT(verify);
 
     // Note that this plot will be uploaded inline with the draws whereas the
     // one it displaced most likely was uploaded asap.
     newPlot->setLastUploadToken(batchTarget->currentToken());
-    SkAutoTUnref<GrPlotUploader> uploader(new GrPlotUploader(newPlot, fTexture));
+    SkAutoTUnref<GrPlotUploader> uploader(new GrPlotUploader(newPlot, this->pageTexture(newPlot)));
     batchTarget->upload(uploader);
     *id = newPlot->id();
 
@@ -26,6 +26,9 @@ struct GrBatchAtlasConfig {
     int fLog2Height;
     int fPlotWidth;
     int fPlotHeight;
+    // The atlas starts out with a single fWidth x fHeight page, and grows by another page (up to
+    // this many) when it would otherwise have to evict plots that are still in use by the flush.
+    int fMaxPages;
 };
 
 class GrBatchAtlas {
@@ -41,7 +44,10 @@ public:
     // the eviction
     typedef void (*EvictionFunc)(GrBatchAtlas::AtlasID, void*);
 
-    GrBatchAtlas(GrTexture*, int numPlotsX, int numPlotsY);
+    static const int kMaxPages = 4;
+
+    // The texture is the first page.  Any further pages are created like it, as they are needed.
+    GrBatchAtlas(GrTexture*, int numPlotsX, int numPlotsY, int maxPages = 1);
     ~GrBatchAtlas();
 
     // Adds a width x height subimage to the atlas. Upon success it returns
@@ -54,13 +60,27 @@ public:
     bool addToAtlas(AtlasID*, GrDrawBatch::Target*, int width, int height, const void* image,
                     SkIPoint16* loc);
 
-    GrTexture* getTexture() const { return fTexture; }
+    GrTexture* getTexture(int page = 0) const {
+        SkASSERT(page >= 0 && page < fNumPages);
+        return fTextures[page];
+    }
+    int numPages() const { return fNumPages; }
+
+    // Which page's texture holds the data for id.
+    int pageIndex(AtlasID id) const {
+        return GetIndexFromID(id) / fNumPlotsPerPage;
+    }
 
     uint64_t atlasGeneration() const { return fAtlasGeneration; }
 
+    // Number of plots evicted so far, and number of times addToAtlas() failed because every plot
+    // was in use by the current draw, forcing the caller to flush.
+    int evictionCount() const { return fEvictionCount; }
+    int flushCount() const { return fFlushCount; }
+
     inline bool hasID(AtlasID id) {
         uint32_t index = GetIndexFromID(id);
-        SkASSERT(index < fNumPlots);
+        SkASSERT(index < (uint32_t)(fNumPages * fNumPlotsPerPage));
         return fPlotArray[index]->genID() == GetGenerationFromID(id);
     }
 
@@ -68,7 +88,6 @@ public:
     inline void setLastUseToken(AtlasID id, GrBatchToken batchToken) {
         SkASSERT(this->hasID(id));
         uint32_t index = GetIndexFromID(id);
-        SkASSERT(index < fNumPlots);
         this->makeMRU(fPlotArray[index]);
         fPlotArray[index]->setLastUseToken(batchToken);
     }
@@ -81,15 +100,14 @@ public:
 
     /*
      * A class which can be handed back to GrBatchAtlas for updating in bulk last use tokens.  The
-     * current max number of plots the GrBatchAtlas can handle is 32, if in the future this is
-     * insufficient then we can move to a 64 bit int
+     * current max number of plots the GrBatchAtlas can handle is 32 per page.
      */
     class BulkUseTokenUpdater {
     public:
-        BulkUseTokenUpdater() : fPlotAlreadyUpdated(0) {}
+        BulkUseTokenUpdater() { sk_bzero(fPlotAlreadyUpdated, sizeof(fPlotAlreadyUpdated)); }
         BulkUseTokenUpdater(const BulkUseTokenUpdater& that)
-            : fPlotsToUpdate(that.fPlotsToUpdate)
-            , fPlotAlreadyUpdated(that.fPlotAlreadyUpdated) {
+            : fPlotsToUpdate(that.fPlotsToUpdate) {
+            memcpy(fPlotAlreadyUpdated, that.fPlotAlreadyUpdated, sizeof(fPlotAlreadyUpdated));
         }
 
         void add(AtlasID id) {
@@ -101,25 +119,25 @@ public:
 
         void reset() {
             fPlotsToUpdate.reset();
-            fPlotAlreadyUpdated = 0;
+            sk_bzero(fPlotAlreadyUpdated, sizeof(fPlotAlreadyUpdated));
         }
 
     private:
         bool find(int index) const {
-            SkASSERT(index < kMaxPlots);
-            return (fPlotAlreadyUpdated >> index) & 1;
+            SkASSERT(index < kMaxPlots * kMaxPages);
+            return (fPlotAlreadyUpdated[index >> 5] >> (index & 31)) & 1;
         }
 
         void set(int index) {
             SkASSERT(!this->find(index));
-            fPlotAlreadyUpdated = fPlotAlreadyUpdated | (1 << index);
+            fPlotAlreadyUpdated[index >> 5] |= 1 << (index & 31);
             fPlotsToUpdate.push_back(index);
         }
 
         static const int kMinItems = 4;
         static const int kMaxPlots = 32;
         SkSTArray<kMinItems, int, true> fPlotsToUpdate;
-        uint32_t fPlotAlreadyUpdated;
+        uint32_t fPlotAlreadyUpdated[kMaxPages];
 
         friend class GrBatchAtlas;
     };
@@ -235,6 +253,16 @@ private:
 
     inline void updatePlot(GrDrawBatch::Target*, AtlasID*, BatchPlot*);
 
+    // Creates the plots for page, adding them at the LRU end of fPlotList.
+    void makePlots(int page);
+
+    // Adds another page if we're under our budget and can get a texture for it.
+    bool addPage(GrDrawBatch::Target*);
+
+    GrTexture* pageTexture(const BatchPlot* plot) const {
+        return fTextures[plot->index() / fNumPlotsPerPage];
+    }
+
     inline void makeMRU(BatchPlot* plot) {
         if (fPlotList.head() == plot) {
             return;
@@ -248,10 +276,16 @@ private:
 
     friend class GrPlotUploader; // to access GrBatchPlot
 
-    GrTexture* fTexture;
-    SkDEBUGCODE(uint32_t fNumPlots;)
+    GrTexture* fTextures[kMaxPages];
+    const int fNumPlotsX;
+    const int fNumPlotsY;
+    const int fNumPlotsPerPage;
+    const int fMaxPages;
+    int fNumPages;
 
     uint64_t fAtlasGeneration;
+    int fEvictionCount;
+    int fFlushCount;
 
     struct EvictionData {
         EvictionFunc fFunc;
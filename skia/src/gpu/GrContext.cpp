@@ -668,4 +668,5 @@ void GrContext::setResourceCacheLimits(int maxTextures, size_t maxTextureBytes)
 void GrContext::dumpMemoryStatistics(SkTraceMemoryDump* traceMemoryDump) const {
     ASSERT_SINGLE_OWNER
     fResourceCache->dumpMemoryStatistics(traceMemoryDump);
+    fBatchFontCache->dumpMemoryStatistics(traceMemoryDump);
 }
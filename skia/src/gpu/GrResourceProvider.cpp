@@ -160,7 +160,8 @@ GrTransferBuffer* GrResourceProvider::createTransferBuffer(size_t size, Transfer
 GrBatchAtlas* GrResourceProvider::createAtlas(GrPixelConfig config,
                                               int width, int height,
                                               int numPlotsX, int numPlotsY,
-                                              GrBatchAtlas::EvictionFunc func, void* data) {
+                                              GrBatchAtlas::EvictionFunc func, void* data,
+                                              int maxPages) {
     GrSurfaceDesc desc;
     desc.fFlags = kNone_GrSurfaceFlags;
     desc.fWidth = width;
@@ -175,7 +176,7 @@ GrBatchAtlas* GrResourceProvider::createAtlas(GrPixelConfig config,
     if (!texture) {
         return nullptr;
     }
-    GrBatchAtlas* atlas = new GrBatchAtlas(texture, numPlotsX, numPlotsY);
+    GrBatchAtlas* atlas = new GrBatchAtlas(texture, numPlotsX, numPlotsY, maxPages);
     atlas->registerEvictionCallback(func, data);
     return atlas;
 }
@@ -33,6 +33,7 @@ void SetupAlwaysEvictAtlas(GrContext* context) {
     configs[kA8_GrMaskFormat].fLog2Height = SkNextLog2(dim);
     configs[kA8_GrMaskFormat].fPlotWidth = dim;
     configs[kA8_GrMaskFormat].fPlotHeight = dim;
+    configs[kA8_GrMaskFormat].fMaxPages = 1;
 
     configs[kA565_GrMaskFormat].fWidth = dim;
     configs[kA565_GrMaskFormat].fHeight = dim;
@@ -40,6 +41,7 @@ void SetupAlwaysEvictAtlas(GrContext* context) {
     configs[kA565_GrMaskFormat].fLog2Height = SkNextLog2(dim);
     configs[kA565_GrMaskFormat].fPlotWidth = dim;
     configs[kA565_GrMaskFormat].fPlotHeight = dim;
+    configs[kA565_GrMaskFormat].fMaxPages = 1;
 
     configs[kARGB_GrMaskFormat].fWidth = dim;
     configs[kARGB_GrMaskFormat].fHeight = dim;
@@ -47,6 +49,7 @@ void SetupAlwaysEvictAtlas(GrContext* context) {
     configs[kARGB_GrMaskFormat].fLog2Height = SkNextLog2(dim);
     configs[kARGB_GrMaskFormat].fPlotWidth = dim;
     configs[kARGB_GrMaskFormat].fPlotHeight = dim;
+    configs[kARGB_GrMaskFormat].fMaxPages = 1;
 
     context->setTextContextAtlasSizes_ForTesting(configs);
 }
@@ -97,19 +97,8 @@ void GrAtlasTextBatch::onPrepareDraws(Target* target) const {
 
     GrMaskFormat maskFormat = this->maskFormat();
 
-    SkAutoTUnref<const GrGeometryProcessor> gp;
-    if (this->usesDistanceFields()) {
-        gp.reset(this->setupDfProcessor(this->viewMatrix(), fFilteredColor, this->color(),
-                                        texture));
-    } else {
-        GrTextureParams params(SkShader::kClamp_TileMode, GrTextureParams::kNone_FilterMode);
-        gp.reset(GrBitmapTextGeoProc::Create(this->color(),
-                                             texture,
-                                             params,
-                                             maskFormat,
-                                             localMatrix,
-                                             this->usesLocalCoords()));
-    }
+    SkAutoTUnref<const GrGeometryProcessor> gp(this->createGeometryProcessor(texture,
+                                                                             localMatrix));
 
     FlushInfo flushInfo;
     flushInfo.fGlyphsToFlush = 0;
@@ -141,7 +130,7 @@ void GrAtlasTextBatch::onPrepareDraws(Target* target) const {
     GrFontScaler* scaler = nullptr;
     SkTypeface* typeface = nullptr;
 
-    GrBlobRegenHelper helper(this, target, &flushInfo, gp);
+    GrBlobRegenHelper helper(this, target, &flushInfo, gp, localMatrix);
 
     for (int i = 0; i < fGeoCount; i++) {
         const Geometry& args = fGeoData[i];
@@ -179,6 +168,20 @@ void GrAtlasTextBatch::onPrepareDraws(Target* target) const {
     this->flush(target, &flushInfo);
 }
 
+GrGeometryProcessor* GrAtlasTextBatch::createGeometryProcessor(GrTexture* texture,
+                                                              const SkMatrix& localMatrix) const {
+    if (this->usesDistanceFields()) {
+        return this->setupDfProcessor(this->viewMatrix(), fFilteredColor, this->color(), texture);
+    }
+    GrTextureParams params(SkShader::kClamp_TileMode, GrTextureParams::kNone_FilterMode);
+    return GrBitmapTextGeoProc::Create(this->color(),
+                                       texture,
+                                       params,
+                                       this->maskFormat(),
+                                       localMatrix,
+                                       this->usesLocalCoords());
+}
+
 void GrAtlasTextBatch::flush(GrVertexBatch::Target* target, FlushInfo* flushInfo) const {
     GrVertices vertices;
     int maxGlyphsPerDraw = flushInfo->fIndexBuffer->maxQuads();
@@ -315,3 +318,17 @@ void GrBlobRegenHelper::flush() {
     fBatch->flush(fTarget, fFlushInfo);
     fTarget->initDraw(fGP, fBatch->pipeline());
 }
+
+void GrBlobRegenHelper::setPage(int page) {
+    SkASSERT(page >= 0);
+    if (page == fPage) {
+        return;
+    }
+    if (fFlushInfo->fGlyphsToFlush) {
+        fBatch->flush(fTarget, fFlushInfo);
+    }
+    fPage = page;
+    GrTexture* texture = fBatch->fFontCache->getTexture(fBatch->maskFormat(), page);
+    fGP.reset(fBatch->createGeometryProcessor(texture, fLocalMatrix));
+    fTarget->initDraw(fGP, fBatch->pipeline());
+}
@@ -153,6 +153,10 @@ private:
     GrGeometryProcessor* setupDfProcessor(const SkMatrix& viewMatrix, SkColor filteredColor,
                                           GrColor color, GrTexture* texture) const;
 
+    // Creates the geometry processor which reads glyphs from texture, one page of our atlas.
+    GrGeometryProcessor* createGeometryProcessor(GrTexture* texture,
+                                                 const SkMatrix& localMatrix) const;
+
     struct BatchTracker {
         GrColor fColor;
         bool fUsesLocalCoords;
@@ -196,14 +200,21 @@ public:
     GrBlobRegenHelper(const GrAtlasTextBatch* batch,
                       GrVertexBatch::Target* target,
                       GrAtlasTextBatch::FlushInfo* flushInfo,
-                      const GrGeometryProcessor* gp)
+                      const GrGeometryProcessor* gp,
+                      const SkMatrix& localMatrix)
         : fBatch(batch)
         , fTarget(target)
         , fFlushInfo(flushInfo)
-        , fGP(gp) {}
+        , fGP(SkRef(gp))
+        , fLocalMatrix(localMatrix)
+        , fPage(0) {}
 
     void flush();
 
+    // Glyphs on different atlas pages need different textures bound.  If page isn't the page
+    // we're currently drawing from, this flushes the glyphs so far and switches to the new page.
+    void setPage(int page);
+
     void incGlyphCount(int glyphCount = 1) {
         fFlushInfo->fGlyphsToFlush += glyphCount;
     }
@@ -212,7 +223,9 @@ private:
     const GrAtlasTextBatch* fBatch;
     GrVertexBatch::Target* fTarget;
     GrAtlasTextBatch::FlushInfo* fFlushInfo;
-    const GrGeometryProcessor* fGP;
+    SkAutoTUnref<const GrGeometryProcessor> fGP;
+    SkMatrix fLocalMatrix;
+    int fPage;
 };
 
 #endif
@@ -16,6 +16,7 @@
 #include "GrResourceProvider.h"
 #include "GrTessellator.h"
 #include "SkGeometry.h"
+#include "SkPathPriv.h"
 
 #include "batches/GrVertexBatch.h"
 
@@ -25,14 +26,43 @@
  * This path renderer tessellates the path into triangles using GrTessellator, uploads the triangles
  * to a vertex buffer, and renders them with a single draw call. It does not currently do 
  * antialiasing, so it must be used in conjunction with multisampling.
+ *
+ * Small non-inverse paths are cached by their contents rather than their genID, so identical paths
+ * built separately (e.g. icons re-created every frame) share one tessellation, as do copies that
+ * differ only by a translation. Those are tessellated relative to the top-left of their bounds
+ * and translated back by the view matrix when drawn.
  */
 namespace {
 
+// Paths with more points than this are cached by genID. Content keys copy the path's geometry.
+static const int kMaxContentKeyPoints = 256;
+
+// The custom data of a cached vertex buffer. For content keys it is followed by the geometry
+// written by write_geometry(), since the key itself only holds a hash of it.
 struct TessInfo {
     SkScalar  fTolerance;
     int       fCount;
 };
 
+size_t geometry_size(const SkPath& path) {
+    return path.countPoints() * sizeof(SkPoint) +
+           SkPathPriv::ConicWeightCnt(path) * sizeof(SkScalar) +
+           path.countVerbs() * sizeof(uint8_t);
+}
+
+// Writes the path's points relative to origin, then its conic weights and verbs.
+void write_geometry(const SkPath& path, const SkPoint& origin, void* dst) {
+    SkPoint* pts = static_cast<SkPoint*>(dst);
+    const int ptCount = path.getPoints(pts, path.countPoints());
+    for (int i = 0; i < ptCount; i++) {
+        pts[i] -= origin;
+    }
+    SkScalar* weights = reinterpret_cast<SkScalar*>(pts + ptCount);
+    const int weightCount = SkPathPriv::ConicWeightCnt(path);
+    memcpy(weights, SkPathPriv::ConicWeightData(path), weightCount * sizeof(SkScalar));
+    memcpy(weights + weightCount, SkPathPriv::VerbData(path), path.countVerbs());
+}
+
 // When the SkPathRef genID changes, invalidate a corresponding GrResource described by key.
 class PathInvalidator : public SkPathRef::GenIDChangeListener {
 public:
@@ -45,12 +75,18 @@ private:
     }
 };
 
-bool cache_match(GrVertexBuffer* vertexBuffer, SkScalar tol, int* actualCount) {
+bool cache_match(GrVertexBuffer* vertexBuffer, SkScalar tol, const void* geometry,
+                 size_t geometrySize, int* actualCount) {
     if (!vertexBuffer) {
         return false;
     }
     const SkData* data = vertexBuffer->getUniqueKey().getCustomData();
     SkASSERT(data);
+    // Content keys can collide, so make sure this is really the same geometry.
+    if (data->size() != sizeof(TessInfo) + geometrySize ||
+        memcmp(data->bytes() + sizeof(TessInfo), geometry, geometrySize)) {
+        return false;
+    }
     const TessInfo* info = static_cast<const TessInfo*>(data->data());
     if (info->fTolerance == 0 || info->fTolerance < 3.0f * tol) {
         *actualCount = info->fCount;
@@ -106,7 +142,10 @@ private:
     int tessellate(GrUniqueKey* key,
                    GrResourceProvider* resourceProvider,
                    SkAutoTUnref<GrVertexBuffer>& vertexBuffer,
-                   bool canMapVB) const {
+                   bool canMapVB,
+                   const SkPoint& origin,
+                   const void* geometry,
+                   size_t geometrySize) const {
         SkPath path;
         GrStrokeInfo stroke(fStroke);
         if (stroke.isDashed()) {
@@ -127,46 +166,78 @@ private:
         SkRect pathBounds = path.getBounds();
         SkScalar tol = GrPathUtils::scaleToleranceToSrc(screenSpaceTol, fViewMatrix, pathBounds);
 
+        SkRect clipBounds = fClipBounds;
+        path.offset(-origin.fX, -origin.fY);
+        clipBounds.offset(-origin.fX, -origin.fY);
+
         bool isLinear;
-        int count = GrTessellator::PathToTriangles(path, tol, fClipBounds, resourceProvider, 
+        int count = GrTessellator::PathToTriangles(path, tol, clipBounds, resourceProvider,
                                                    vertexBuffer, canMapVB, &isLinear);
         if (!fPath.isVolatile()) {
-            TessInfo info;
-            info.fTolerance = isLinear ? 0 : tol;
-            info.fCount = count;
-            SkAutoTUnref<SkData> data(SkData::NewWithCopy(&info, sizeof(info)));
+            SkAutoTUnref<SkData> data(SkData::NewUninitialized(sizeof(TessInfo) + geometrySize));
+            TessInfo* info = static_cast<TessInfo*>(data->writable_data());
+            info->fTolerance = isLinear ? 0 : tol;
+            info->fCount = count;
+            memcpy(info + 1, geometry, geometrySize);
             key->setCustomData(data.get());
             resourceProvider->assignUniqueKeyToResource(*key, vertexBuffer.get());
-            SkPathPriv::AddGenIDChangeListener(fPath, new PathInvalidator(*key));
+            if (!geometrySize) {
+                SkPathPriv::AddGenIDChangeListener(fPath, new PathInvalidator(*key));
+            }
         }
         return count;
     }
 
     void onPrepareDraws(Target* target) const override {
-        // construct a cache key from the path's genID and the view matrix
-        static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
+        // Inverse fills depend on the clip bounds, so they are never keyed on content.
+        const bool contentKey = !fPath.isInverseFillType() &&
+                                fPath.countPoints() <= kMaxContentKeyPoints;
+        SkPoint origin = SkPoint::Make(0, 0);
+        SkAutoSMalloc<1024> geometry;
+        size_t geometrySize = 0;
+        if (contentKey) {
+            origin.set(fPath.getBounds().fLeft, fPath.getBounds().fTop);
+            geometrySize = geometry_size(fPath);
+            write_geometry(fPath, origin, geometry.reset(geometrySize));
+        }
+
         GrUniqueKey key;
-        int clipBoundsSize32 =
-            fPath.isInverseFillType() ? sizeof(fClipBounds) / sizeof(uint32_t) : 0;
         int strokeDataSize32 = fStroke.computeUniqueKeyFragmentData32Cnt();
-        GrUniqueKey::Builder builder(&key, kDomain, 2 + clipBoundsSize32 + strokeDataSize32);
-        builder[0] = fPath.getGenerationID();
-        builder[1] = fPath.getFillType();
-        // For inverse fills, the tessellation is dependent on clip bounds.
-        if (fPath.isInverseFillType()) {
-            memcpy(&builder[2], &fClipBounds, sizeof(fClipBounds));
+        if (contentKey) {
+            // construct a cache key from the path's contents, which are translation invariant
+            static const GrUniqueKey::Domain kContentDomain = GrUniqueKey::GenerateDomain();
+            GrUniqueKey::Builder builder(&key, kContentDomain, 4 + strokeDataSize32);
+            builder[0] = SkPathPriv::ContentHash(fPath);
+            builder[1] = fPath.getFillType();
+            builder[2] = fPath.countPoints();
+            builder[3] = fPath.countVerbs();
+            fStroke.asUniqueKeyFragment(&builder[4]);
+            builder.finish();
+        } else {
+            // construct a cache key from the path's genID and the view matrix
+            static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
+            int clipBoundsSize32 =
+                fPath.isInverseFillType() ? sizeof(fClipBounds) / sizeof(uint32_t) : 0;
+            GrUniqueKey::Builder builder(&key, kDomain, 2 + clipBoundsSize32 + strokeDataSize32);
+            builder[0] = fPath.getGenerationID();
+            builder[1] = fPath.getFillType();
+            // For inverse fills, the tessellation is dependent on clip bounds.
+            if (fPath.isInverseFillType()) {
+                memcpy(&builder[2], &fClipBounds, sizeof(fClipBounds));
+            }
+            fStroke.asUniqueKeyFragment(&builder[2 + clipBoundsSize32]);
+            builder.finish();
         }
-        fStroke.asUniqueKeyFragment(&builder[2 + clipBoundsSize32]);
-        builder.finish();
         GrResourceProvider* rp = target->resourceProvider();
         SkAutoTUnref<GrVertexBuffer> vertexBuffer(rp->findAndRefTByUniqueKey<GrVertexBuffer>(key));
         int actualCount;
         SkScalar screenSpaceTol = GrPathUtils::kDefaultTolerance;
         SkScalar tol = GrPathUtils::scaleToleranceToSrc(
             screenSpaceTol, fViewMatrix, fPath.getBounds());
-        if (!cache_match(vertexBuffer.get(), tol, &actualCount)) {
+        if (!cache_match(vertexBuffer.get(), tol, geometry.get(), geometrySize, &actualCount)) {
             bool canMapVB = GrCaps::kNone_MapFlags != target->caps().mapBufferFlags();
-            actualCount = this->tessellate(&key, rp, vertexBuffer, canMapVB);
+            actualCount = this->tessellate(&key, rp, vertexBuffer, canMapVB, origin,
+                                           geometry.get(), geometrySize);
         }
 
         if (actualCount == 0) {
@@ -177,10 +248,15 @@ private:
         {
             using namespace GrDefaultGeoProcFactory;
 
+            // The vertices are relative to origin, so translate them back into place.
+            SkMatrix viewMatrix = fViewMatrix;
+            viewMatrix.preTranslate(origin.fX, origin.fY);
+            const SkMatrix localMatrix = SkMatrix::MakeTrans(origin.fX, origin.fY);
+
             Color color(fColor);
-            LocalCoords localCoords(fPipelineInfo.readsLocalCoords() ?
-                                    LocalCoords::kUsePosition_Type :
-                                    LocalCoords::kUnused_Type);
+            LocalCoords localCoords = fPipelineInfo.readsLocalCoords() ?
+                                      LocalCoords(LocalCoords::kUsePosition_Type, &localMatrix) :
+                                      LocalCoords(LocalCoords::kUnused_Type);
             Coverage::Type coverageType;
             if (fPipelineInfo.readsCoverage()) {
                 coverageType = Coverage::kSolid_Type;
@@ -189,7 +265,7 @@ private:
             }
             Coverage coverage(coverageType);
             gp.reset(GrDefaultGeoProcFactory::Create(color, coverage, localCoords,
-                                                     fViewMatrix));
+                                                     viewMatrix));
         }
 
         target->initDraw(gp, this->pipeline());
@@ -44,6 +44,7 @@ GrGLCaps::GrGLCaps(const GrContextOptions& contextOptions,
     fDrawIndirectSupport = false;
     fMultiDrawIndirectSupport = false;
     fBaseInstanceSupport = false;
+    fProgramBinarySupport = false;
     fUseNonVBOVertexAndIndexDynamicData = false;
     fIsCoreProfile = false;
     fBindFragDataLocationSupport = false;
@@ -514,6 +515,16 @@ void GrGLCaps::init(const GrContextOptions& contextOptions,
         fBaseInstanceSupport = ctxInfo.hasExtension("GL_EXT_base_instance");
     }
 
+    // Program binaries are useless if the driver advertises no formats to store them in (some
+    // ES drivers expose the entry points anyway). Chromium's command buffer does not forward
+    // binaries to the client.
+    if (gli->fFunctions.fGetProgramBinary && gli->fFunctions.fProgramBinary &&
+        kChromium_GrGLDriver != ctxInfo.driver()) {
+        GrGLint numFormats = 0;
+        GR_GL_GetIntegerv(gli, GR_GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+        fProgramBinarySupport = numFormats > 0;
+    }
+
     this->initShaderPrecisionTable(ctxInfo, gli, glslCaps);
 
     if (contextOptions.fUseShaderSwizzling) {
@@ -1039,6 +1050,7 @@ SkString GrGLCaps::dump() const {
     r.appendf("Draw indirect support: %s\n", (fDrawIndirectSupport ? "YES" : "NO"));
     r.appendf("Multi draw indirect support: %s\n", (fMultiDrawIndirectSupport ? "YES" : "NO"));
     r.appendf("Base instance support: %s\n", (fBaseInstanceSupport ? "YES" : "NO"));
+    r.appendf("Program binary support: %s\n", (fProgramBinarySupport ? "YES" : "NO"));
     r.appendf("Use non-VBO for dynamic data: %s\n",
              (fUseNonVBOVertexAndIndexDynamicData ? "YES" : "NO"));
     r.appendf("SRGB write contol: %s\n", (fSRGBWriteControl ? "YES" : "NO"));
@@ -443,6 +443,10 @@
 #define GR_GL_ACTIVE_UNIFORM_MAX_LENGTH                0x8B87
 #define GR_GL_ACTIVE_ATTRIBUTES                        0x8B89
 #define GR_GL_ACTIVE_ATTRIBUTE_MAX_LENGTH              0x8B8A
+#define GR_GL_PROGRAM_BINARY_RETRIEVABLE_HINT          0x8257
+#define GR_GL_PROGRAM_BINARY_LENGTH                    0x8741
+#define GR_GL_NUM_PROGRAM_BINARY_FORMATS               0x87FE
+#define GR_GL_PROGRAM_BINARY_FORMATS                   0x87FF
 #define GR_GL_SHADING_LANGUAGE_VERSION                 0x8B8C
 #define GR_GL_CURRENT_PROGRAM                          0x8B8D
 #define GR_GL_MAX_FRAGMENT_UNIFORM_COMPONENTS          0x8B49
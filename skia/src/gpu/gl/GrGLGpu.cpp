@@ -175,19 +175,33 @@ GrGpu* GrGLGpu::Create(GrBackendContext backendContext, const GrContextOptions&
     }
     GrGLContext* glContext = GrGLContext::Create(glInterface, options);
     if (glContext) {
-        return new GrGLGpu(glContext, context);
+        return new GrGLGpu(glContext, options, context);
     }
     return nullptr;
 }
 
 static bool gPrintStartupSpew;
 
-GrGLGpu::GrGLGpu(GrGLContext* ctx, GrContext* context)
+GrGLGpu::GrGLGpu(GrGLContext* ctx, const GrContextOptions& options, GrContext* context)
     : GrGpu(context)
-    , fGLContext(ctx) {
+    , fGLContext(ctx)
+    , fPersistentCache(nullptr) {
     SkASSERT(ctx);
     fCaps.reset(SkRef(ctx->caps()));
 
+    if (options.fPersistentCache && this->glCaps().programBinarySupport()) {
+        const GrGLubyte* vendor;
+        const GrGLubyte* renderer;
+        const GrGLubyte* version;
+        GL_CALL_RET(vendor, GetString(GR_GL_VENDOR));
+        GL_CALL_RET(renderer, GetString(GR_GL_RENDERER));
+        GL_CALL_RET(version, GetString(GR_GL_VERSION));
+        if (vendor && renderer && version) {
+            fProgramBinaryDriverKey.printf("%s\n%s\n%s", vendor, renderer, version);
+            fPersistentCache = options.fPersistentCache;
+        }
+    }
+
     fHWBoundTextureUniqueIDs.reset(this->glCaps().maxFragmentTextureUnits());
 
     GrGLClearErr(this->glInterface());
@@ -8,6 +8,7 @@
 #ifndef GrGLGpu_DEFINED
 #define GrGLGpu_DEFINED
 
+#include "GrContextOptions.h"
 #include "GrGLContext.h"
 #include "GrGLIRect.h"
 #include "GrGLIndexBuffer.h"
@@ -49,6 +50,14 @@ public:
     GrGLSLGeneration glslGeneration() const { return fGLContext->glslGeneration(); }
     const GrGLCaps& glCaps() const { return *fGLContext->caps(); }
 
+    /** The cache used to persist linked program binaries, or null if there is none or the driver
+        cannot retrieve binaries. */
+    GrContextOptions::PersistentCache* persistentCache() const { return fPersistentCache; }
+
+    /** Identifies the driver that produced a program binary. Appended to persistent cache keys so
+        that a driver update never feeds a stale binary back to glProgramBinary. */
+    const SkString& programBinaryDriverKey() const { return fProgramBinaryDriverKey; }
+
     GrGLPathRendering* glPathRendering() {
         SkASSERT(glCaps().shaderCaps()->pathRenderingSupport());
         return static_cast<GrGLPathRendering*>(pathRendering());
@@ -137,7 +146,7 @@ public:
     void finishDrawTarget() override;
 
 private:
-    GrGLGpu(GrGLContext* ctx, GrContext* context);
+    GrGLGpu(GrGLContext* ctx, const GrContextOptions& options, GrContext* context);
 
     // GrGpu overrides
     void onResetContext(uint32_t resetBits) override;
@@ -379,6 +388,9 @@ private:
 
     SkAutoTUnref<GrGLContext>  fGLContext;
 
+    GrContextOptions::PersistentCache* fPersistentCache;
+    SkString                           fProgramBinaryDriverKey;
+
     void createCopyPrograms();
     void createWireRectProgram();
     void createUnitRectBuffer();
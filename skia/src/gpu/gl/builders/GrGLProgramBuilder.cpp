@@ -12,6 +12,7 @@
 #include "GrGLProgramBuilder.h"
 #include "GrSwizzle.h"
 #include "GrTexture.h"
+#include "SkData.h"
 #include "SkRTConf.h"
 #include "SkTraceEvent.h"
 #include "gl/GrGLGpu.h"
@@ -132,6 +133,26 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
         return nullptr;
     }
 
+    SkAutoTUnref<SkData> binaryCacheKey;
+    if (fGpu->persistentCache()) {
+        binaryCacheKey.reset(this->createProgramBinaryCacheKey());
+        // The binary retains the attribute, uniform and output bindings it was linked with, but
+        // binding also records builder-side locations (e.g. NVPR varyings) that must be set.
+        this->bindProgramResourceLocations(programID);
+        if (this->loadProgramBinary(programID, *binaryCacheKey)) {
+            this->resolveProgramResourceLocations(programID);
+            return this->createProgram(programID);
+        }
+        // The driver rejected the binary, most likely because it was updated since the binary
+        // was stored. Start over with a fresh program; the rebuilt binary replaces the old one.
+        GL_CALL(DeleteProgram(programID));
+        GL_CALL_RET(programID, CreateProgram());
+        if (0 == programID) {
+            this->cleanupFragmentProcessors();
+            return nullptr;
+        }
+    }
+
     this->finalizeShaders();
 
     // compile shaders and bind attributes / uniforms
@@ -159,6 +180,10 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
 
     this->bindProgramResourceLocations(programID);
 
+    if (binaryCacheKey && this->gpu()->glInterface()->fFunctions.fProgramParameteri) {
+        GL_CALL(ProgramParameteri(programID, GR_GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GR_GL_TRUE));
+    }
+
     GL_CALL(LinkProgram(programID));
 
     // Calling GetProgramiv is expensive in Chromium. Assume success in release builds.
@@ -166,8 +191,12 @@ GrGLProgram* GrGLProgramBuilder::finalize() {
 #ifdef SK_DEBUG
     checkLinked = true;
 #endif
+    bool linked = true;
     if (checkLinked) {
-        checkLinkStatus(programID);
+        linked = checkLinkStatus(programID);
+    }
+    if (binaryCacheKey && linked) {
+        this->storeProgramBinary(programID, *binaryCacheKey);
     }
     this->resolveProgramResourceLocations(programID);
 
@@ -245,6 +274,57 @@ void GrGLProgramBuilder::resolveProgramResourceLocations(GrGLuint programID) {
     }
 }
 
+SkData* GrGLProgramBuilder::createProgramBinaryCacheKey() const {
+    const GrProgramDesc& desc = this->desc();
+    const SkString& driverKey = fGpu->programBinaryDriverKey();
+    size_t descLength = desc.keyLength();
+    SkData* key = SkData::NewUninitialized(descLength + driverKey.size());
+    char* ptr = static_cast<char*>(key->writable_data());
+    memcpy(ptr, desc.asKey(), descLength);
+    memcpy(ptr + descLength, driverKey.c_str(), driverKey.size());
+    return key;
+}
+
+// A stored binary is the GL binary format enum followed by the driver's opaque blob.
+bool GrGLProgramBuilder::loadProgramBinary(GrGLuint programID, const SkData& key) {
+    SkAutoTUnref<SkData> cached(fGpu->persistentCache()->load(key));
+    if (!cached || cached->size() <= sizeof(GrGLenum)) {
+        return false;
+    }
+    GrGLenum binaryFormat;
+    memcpy(&binaryFormat, cached->data(), sizeof(GrGLenum));
+    const uint8_t* binary = cached->bytes() + sizeof(GrGLenum);
+    GrGLsizei length = SkToInt(cached->size() - sizeof(GrGLenum));
+    GL_CALL(ProgramBinary(programID, binaryFormat, binary, length));
+
+    // Unlike a failed link, a rejected binary is expected, so no debug failure here.
+    GrGLint linked = GR_GL_INIT_ZERO;
+    GL_CALL(GetProgramiv(programID, GR_GL_LINK_STATUS, &linked));
+    return SkToBool(linked);
+}
+
+void GrGLProgramBuilder::storeProgramBinary(GrGLuint programID, const SkData& key) {
+    GrGLint length = GR_GL_INIT_ZERO;
+    GL_CALL(GetProgramiv(programID, GR_GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0) {
+        return;
+    }
+    SkAutoTUnref<SkData> data(SkData::NewUninitialized(sizeof(GrGLenum) + length));
+    uint8_t* ptr = static_cast<uint8_t*>(data->writable_data());
+    GrGLenum binaryFormat = 0;
+    GrGLsizei actualLength = GR_GL_INIT_ZERO;
+    GL_CALL(GetProgramBinary(programID, length, &actualLength, &binaryFormat,
+                             ptr + sizeof(GrGLenum)));
+    if (actualLength <= 0 || actualLength > length) {
+        return;
+    }
+    memcpy(ptr, &binaryFormat, sizeof(GrGLenum));
+    if (actualLength < length) {
+        data.reset(SkData::NewWithCopy(ptr, sizeof(GrGLenum) + actualLength));
+    }
+    fGpu->persistentCache()->store(key, *data);
+}
+
 void GrGLProgramBuilder::cleanupProgram(GrGLuint programID, const SkTDArray<GrGLuint>& shaderIDs) {
     GL_CALL(DeleteProgram(programID));
     this->cleanupShaders(shaderIDs);
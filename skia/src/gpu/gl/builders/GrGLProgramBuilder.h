@@ -16,6 +16,7 @@
 #include "glsl/GrGLSLProgramDataManager.h"
 
 class GrFragmentProcessor;
+class SkData;
 class GrGLContextInfo;
 class GrGLSLShaderBuilder;
 class GrGLSLCaps;
@@ -53,6 +54,11 @@ private:
     void cleanupProgram(GrGLuint programID, const SkTDArray<GrGLuint>& shaderIDs);
     void cleanupShaders(const SkTDArray<GrGLuint>& shaderIDs);
 
+    // Program binary persistence. The key is the program desc followed by the driver key.
+    SkData* createProgramBinaryCacheKey() const;
+    bool loadProgramBinary(GrGLuint programID, const SkData& key);
+    void storeProgramBinary(GrGLuint programID, const SkData& key);
+
     // Subclasses create different programs
     GrGLProgram* createProgram(GrGLuint programID);
 
@@ -359,6 +359,7 @@ private:
         struct SubRunInfo {
             SubRunInfo()
                 : fAtlasGeneration(GrBatchAtlas::kInvalidAtlasGeneration)
+                , fAtlasPage(0)
                 , fVertexStartIndex(0)
                 , fVertexEndIndex(0)
                 , fGlyphStartIndex(0)
@@ -375,6 +376,7 @@ private:
                 , fCurrentViewMatrix(that.fCurrentViewMatrix)
                 , fVertexBounds(that.fVertexBounds)
                 , fAtlasGeneration(that.fAtlasGeneration)
+                , fAtlasPage(that.fAtlasPage)
                 , fVertexStartIndex(that.fVertexStartIndex)
                 , fVertexEndIndex(that.fVertexEndIndex)
                 , fGlyphStartIndex(that.fGlyphStartIndex)
@@ -396,6 +398,12 @@ private:
             void setAtlasGeneration(uint64_t atlasGeneration) { fAtlasGeneration = atlasGeneration;}
             uint64_t atlasGeneration() const { return fAtlasGeneration; }
 
+            // The atlas page all of our glyphs are on, or kMixedAtlasPages if they are spread
+            // over several.  Mixed subruns have to regenerate so they can switch pages per glyph.
+            static const int kMixedAtlasPages = -1;
+            void setAtlasPage(int page) { fAtlasPage = page; }
+            int atlasPage() const { return fAtlasPage; }
+
             size_t byteCount() const { return fVertexEndIndex - fVertexStartIndex; }
             size_t vertexStartIndex() const { return fVertexStartIndex; }
             size_t vertexEndIndex() const { return fVertexEndIndex; }
@@ -450,6 +458,7 @@ private:
             SkMatrix fCurrentViewMatrix;
             SkRect fVertexBounds;
             uint64_t fAtlasGeneration;
+            int fAtlasPage;
             size_t fVertexStartIndex;
             size_t fVertexEndIndex;
             uint32_t fGlyphStartIndex;
@@ -178,6 +178,10 @@ void GrAtlasTextBlob::regenInBatch(GrDrawBatch::Target* target,
     }
 
     bool brokenRun = false;
+    int atlasPage = 0;
+    if (!regenTexCoords) {
+        helper->setPage(info->atlasPage());
+    }
     for (int glyphIdx = 0; glyphIdx < glyphCount; glyphIdx++) {
         GrGlyph* glyph = nullptr;
         int log2Width = 0, log2Height = 0;
@@ -205,6 +209,14 @@ void GrAtlasTextBlob::regenInBatch(GrDrawBatch::Target* target,
                                                                     info->maskFormat());
                 SkASSERT(success);
             }
+
+            int glyphPage = fontCache->atlasPage(glyph);
+            helper->setPage(glyphPage);
+            if (0 == glyphIdx) {
+                atlasPage = glyphPage;
+            } else if (atlasPage != glyphPage) {
+                atlasPage = Run::SubRunInfo::kMixedAtlasPages;
+            }
             fontCache->addGlyphToBulkAndSetUseToken(info->bulkUseToken(), glyph,
                                                     target->currentToken());
             log2Width = fontCache->log2Width(info->maskFormat());
@@ -226,6 +238,7 @@ void GrAtlasTextBlob::regenInBatch(GrDrawBatch::Target* target,
         if (regenGlyphs) {
             info->setStrike(strike);
         }
+        info->setAtlasPage(atlasPage);
         info->setAtlasGeneration(brokenRun ? GrBatchAtlas::kInvalidAtlasGeneration :
                                  fontCache->atlasGeneration(info->maskFormat()));
     }
@@ -279,6 +292,7 @@ void GrAtlasTextBlob::regenInBatch(GrDrawBatch::Target* target,
     // updating our cache of the GrGlyph*s, we drop our ref on the old strike
     bool regenerateGlyphs = info.strike()->isAbandoned();
     bool regenerateTextureCoords = info.atlasGeneration() != currentAtlasGen ||
+                                   Run::SubRunInfo::kMixedAtlasPages == info.atlasPage() ||
                                    regenerateGlyphs;
     bool regenerateColors = kARGB_GrMaskFormat != info.maskFormat() &&
                             info.color() != color;
@@ -307,6 +321,7 @@ void GrAtlasTextBlob::regenInBatch(GrDrawBatch::Target* target,
         case kRegenColTex: this->regenInBatch<false, true, true, false>(REGEN_ARGS); break;
         case kRegenColTexGlyph: this->regenInBatch<false, true, true, true>(REGEN_ARGS); break;
         case kNoRegen:
+            helper->setPage(info.atlasPage());
             helper->incGlyphCount(*glyphCount);
 
             // set use tokens for all of the glyphs in our subrun.  This is only valid if we
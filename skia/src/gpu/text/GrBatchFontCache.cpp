@@ -12,6 +12,7 @@
 #include "GrResourceProvider.h"
 #include "GrSurfacePriv.h"
 #include "SkString.h"
+#include "SkTraceMemoryDump.h"
 
 #include "SkDistanceFieldGen.h"
 
@@ -30,7 +31,8 @@ bool GrBatchFontCache::initAtlas(GrMaskFormat format) {
                 fContext->resourceProvider()->createAtlas(config, width, height,
                                                           numPlotsX, numPlotsY,
                                                           &GrBatchFontCache::HandleEviction,
-                                                          (void*)this);
+                                                          (void*)this,
+                                                          fAtlasConfigs[index].fMaxPages);
         if (!fAtlases[index]) {
             return false;
         }
@@ -52,6 +54,7 @@ GrBatchFontCache::GrBatchFontCache(GrContext* context)
     fAtlasConfigs[kA8_GrMaskFormat].fLog2Height = 11;
     fAtlasConfigs[kA8_GrMaskFormat].fPlotWidth = 512;
     fAtlasConfigs[kA8_GrMaskFormat].fPlotHeight = 256;
+    fAtlasConfigs[kA8_GrMaskFormat].fMaxPages = 4;
 
     fAtlasConfigs[kA565_GrMaskFormat].fWidth = 1024;
     fAtlasConfigs[kA565_GrMaskFormat].fHeight = 2048;
@@ -59,6 +62,7 @@ GrBatchFontCache::GrBatchFontCache(GrContext* context)
     fAtlasConfigs[kA565_GrMaskFormat].fLog2Height = 11;
     fAtlasConfigs[kA565_GrMaskFormat].fPlotWidth = 256;
     fAtlasConfigs[kA565_GrMaskFormat].fPlotHeight = 256;
+    fAtlasConfigs[kA565_GrMaskFormat].fMaxPages = 2;
 
     fAtlasConfigs[kARGB_GrMaskFormat].fWidth = 1024;
     fAtlasConfigs[kARGB_GrMaskFormat].fHeight = 2048;
@@ -66,6 +70,7 @@ GrBatchFontCache::GrBatchFontCache(GrContext* context)
     fAtlasConfigs[kARGB_GrMaskFormat].fLog2Height = 11;
     fAtlasConfigs[kARGB_GrMaskFormat].fPlotWidth = 256;
     fAtlasConfigs[kARGB_GrMaskFormat].fPlotHeight = 256;
+    fAtlasConfigs[kARGB_GrMaskFormat].fMaxPages = 2;
 }
 
 GrBatchFontCache::~GrBatchFontCache() {
@@ -116,21 +121,45 @@ void GrBatchFontCache::dump() const {
     static int gDumpCount = 0;
     for (int i = 0; i < kMaskFormatCount; ++i) {
         if (fAtlases[i]) {
-            GrTexture* texture = fAtlases[i]->getTexture();
-            if (texture) {
-                SkString filename;
+            for (int page = 0; page < fAtlases[i]->numPages(); ++page) {
+                GrTexture* texture = fAtlases[i]->getTexture(page);
+                if (texture) {
+                    SkString filename;
 #ifdef SK_BUILD_FOR_ANDROID
-                filename.printf("/sdcard/fontcache_%d%d.png", gDumpCount, i);
+                    filename.printf("/sdcard/fontcache_%d%d_%d.png", gDumpCount, i, page);
 #else
-                filename.printf("fontcache_%d%d.png", gDumpCount, i);
+                    filename.printf("fontcache_%d%d_%d.png", gDumpCount, i, page);
 #endif
-                texture->surfacePriv().savePixels(filename.c_str());
+                    texture->surfacePriv().savePixels(filename.c_str());
+                }
             }
         }
     }
     ++gDumpCount;
 }
 
+void GrBatchFontCache::dumpMemoryStatistics(SkTraceMemoryDump* traceMemoryDump) const {
+    static const char* kFormatNames[] = { "a8", "a565", "argb" };
+    static_assert(SK_ARRAY_COUNT(kFormatNames) == kMaskFormatCount, "array_size_mismatch");
+
+    for (int i = 0; i < kMaskFormatCount; ++i) {
+        const GrBatchAtlas* atlas = fAtlases[i];
+        if (!atlas) {
+            continue;
+        }
+        SkString dumpName("skia/gpu_glyph_atlas/");
+        dumpName.append(kFormatNames[i]);
+        traceMemoryDump->dumpNumericValue(dumpName.c_str(), "pages", "objects",
+                                          atlas->numPages());
+        traceMemoryDump->dumpNumericValue(dumpName.c_str(), "max_pages", "objects",
+                                          fAtlasConfigs[i].fMaxPages);
+        traceMemoryDump->dumpNumericValue(dumpName.c_str(), "evictions", "objects",
+                                          atlas->evictionCount());
+        traceMemoryDump->dumpNumericValue(dumpName.c_str(), "atlas_flushes", "objects",
+                                          atlas->flushCount());
+    }
+}
+
 void GrBatchFontCache::setAtlasSizes_ForTesting(const GrBatchAtlasConfig configs[3]) {
     // delete any old atlases, this should be safe to do as long as we are not in the middle of a
     // flush
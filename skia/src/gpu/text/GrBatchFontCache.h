@@ -17,6 +17,7 @@
 
 class GrBatchFontCache;
 class GrGpu;
+class SkTraceMemoryDump;
 
 /**
  *  The GrBatchTextStrike manages a pool of CPU backing memory for GrGlyphs.  This backing memory
@@ -132,6 +133,18 @@ public:
         return nullptr;
     }
 
+    // The atlas for a format may grow to several textures ('pages') within a flush.  Glyphs on
+    // different pages must be drawn with different texture bindings.  These may only be called
+    // after getTexture(format) has succeeded.
+    GrTexture* getTexture(GrMaskFormat format, int page) const {
+        return this->getAtlas(format)->getTexture(page);
+    }
+
+    int atlasPage(const GrGlyph* glyph) const {
+        SkASSERT(glyph);
+        return this->getAtlas(glyph->fMaskFormat)->pageIndex(glyph->fID);
+    }
+
     bool hasGlyph(GrGlyph* glyph) {
         SkASSERT(glyph);
         return this->getAtlas(glyph->fMaskFormat)->hasID(glyph->fID);
@@ -178,6 +191,9 @@ public:
     // Functions intended debug only
     void dump() const;
 
+    // Reports the number of pages, evictions and atlas-forced flushes of each atlas.
+    void dumpMemoryStatistics(SkTraceMemoryDump*) const;
+
     void setAtlasSizes_ForTesting(const GrBatchAtlasConfig configs[3]);
 
 private:
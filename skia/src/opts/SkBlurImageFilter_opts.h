@@ -184,9 +184,11 @@ static inline uint16x4_t expand(SkPMColor p) {
 
 #define DOUBLE_ROW_OPTIMIZATION \
     if (1 < kernelSize && kernelSize < 128) { \
-        top = box_blur_double<srcDirection, dstDirection>(&src, srcStride, srcBounds, &dst, \
-                                                          kernelSize, leftOffset, rightOffset, \
-                                                          width, height); \
+        top = box_blur_double<srcDirection, dstDirection>(&src, srcStride, \
+                                                          SkIRect::MakeLTRB(left, top, \
+                                                                            right, bottom), \
+                                                          &dst, kernelSize, leftOffset, \
+                                                          rightOffset, width, height); \
     }
 
 #else  // Neither NEON nor >=SSE2.
@@ -218,13 +220,17 @@ static inline uint16x4_t expand(SkPMColor p) {
         SK_PREFETCH(rptr); \
     }
 
+// Blurs rows [startRow, endRow) of the height rows of dst.  Each row only reads the same row of
+// src, so disjoint row ranges may be blurred concurrently.
 template<BlurDirection srcDirection, BlurDirection dstDirection>
 static void box_blur(const SkPMColor* src, int srcStride, const SkIRect& srcBounds, SkPMColor* dst,
-                     int kernelSize, int leftOffset, int rightOffset, int width, int height) {
+                     int kernelSize, int leftOffset, int rightOffset, int width, int height,
+                     int startRow, int endRow) {
+    SkASSERT(0 <= startRow && startRow <= endRow && endRow <= height);
     int left = srcBounds.left();
     int right = srcBounds.right();
-    int top = srcBounds.top();
-    int bottom = srcBounds.bottom();
+    int top = SkTPin(srcBounds.top(), startRow, endRow);
+    int bottom = SkTPin(srcBounds.bottom(), startRow, endRow);
     int incrementStart = SkMax32(left - rightOffset - 1, left - right);
     int incrementEnd = SkMax32(right - rightOffset - 1, 0);
     int decrementStart = SkMin32(left + leftOffset, width);
@@ -236,8 +242,12 @@ static void box_blur(const SkPMColor* src, int srcStride, const SkIRect& srcBoun
     INIT_SCALE
     INIT_HALF
 
+    // src points at the first row of srcBounds, dst at the first row of the whole image.
+    src += (top - srcBounds.top()) * srcStrideY;
+    dst += startRow * dstStrideY;
+
     // Clear to zero when sampling above our domain.
-    for (int y = 0; y < top; y++) {
+    for (int y = startRow; y < top; y++) {
         SkColor* dptr = dst;
         for (int x = 0; x < width; ++x) {
             *dptr = 0;
@@ -299,7 +309,7 @@ static void box_blur(const SkPMColor* src, int srcStride, const SkIRect& srcBoun
         dst += dstStrideY;
     }
     // Clear to zero when sampling below our domain.
-    for (int y = bottom; y < height; ++y) {
+    for (int y = bottom; y < endRow; ++y) {
         SkColor* dptr = dst;
         for (int x = 0; x < width; ++x) {
             *dptr = 0;
@@ -9,8 +9,10 @@
 #define Sk4pxXfermode_DEFINED
 
 #include "Sk4px.h"
+#include "SkHalf.h"
 #include "SkMSAN.h"
 #include "SkNx.h"
+#include "SkPM4fPriv.h"
 #include "SkXfermode_proccoeff.h"
 
 namespace {
@@ -184,6 +186,152 @@ XFERMODE(SoftLight) {
 }
 #undef XFERMODE
 
+// The D32 and D64 procs blend SkPM4f sources in floats, so they need float versions of the
+// Sk4px xfermodes above.  The Sk4f xfermodes are used as-is.
+template <typename Xfermode>
+static Sk4f xfer_4f(const Sk4f& d, const Sk4f& s) {
+    return Xfermode()(d, s);
+}
+
+#define XFERMODE_4F(Xfermode) \
+    template <> Sk4f xfer_4f<Xfermode>(const Sk4f& d, const Sk4f& s)
+
+static inline Sk4f inv_alphas(const Sk4f& f) { return Sk4f(1) - alphas(f); }
+
+static inline Sk4f overlay_4f(const Sk4f& s, const Sk4f& d) {
+    auto sa = alphas(s),
+         da = alphas(d),
+         two = Sk4f(2);
+    auto rc = (two*d <= da).thenElse(two*s*d, sa*da - two*(da-d)*(sa-s));
+    return Sk4f::Min(s + d - s*da + a_rgb(Sk4f(0), rc - d*sa), Sk4f(1));
+}
+
+XFERMODE_4F(Clear)    { return Sk4f(0); }
+XFERMODE_4F(Src)      { return s; }
+XFERMODE_4F(Dst)      { return d; }
+XFERMODE_4F(SrcOver)  { return s + d*inv_alphas(s); }
+XFERMODE_4F(DstOver)  { return d + s*inv_alphas(d); }
+XFERMODE_4F(SrcIn)    { return s*alphas(d); }
+XFERMODE_4F(DstIn)    { return d*alphas(s); }
+XFERMODE_4F(SrcOut)   { return s*inv_alphas(d); }
+XFERMODE_4F(DstOut)   { return d*inv_alphas(s); }
+XFERMODE_4F(SrcATop)  { return s*alphas(d) + d*inv_alphas(s); }
+XFERMODE_4F(DstATop)  { return d*alphas(s) + s*inv_alphas(d); }
+XFERMODE_4F(Xor)      { return s*inv_alphas(d) + d*inv_alphas(s); }
+XFERMODE_4F(Plus)     { return Sk4f::Min(s + d, Sk4f(1)); }
+XFERMODE_4F(Modulate) { return s*d; }
+XFERMODE_4F(Screen)   { return s + d - s*d; }
+XFERMODE_4F(Multiply) { return s*inv_alphas(d) + d*inv_alphas(s) + s*d; }
+XFERMODE_4F(Difference) {
+    auto m = Sk4f::Min(s*alphas(d), d*alphas(s));
+    return s + d - m - a_rgb(Sk4f(0), m);
+}
+XFERMODE_4F(Exclusion) {
+    auto p = s*d;
+    return s + d - p - a_rgb(Sk4f(0), p);
+}
+XFERMODE_4F(HardLight) { return overlay_4f(d, s); }
+XFERMODE_4F(Overlay)   { return overlay_4f(s, d); }
+XFERMODE_4F(Darken)    { return s + d - Sk4f::Max(s*alphas(d), d*alphas(s)); }
+XFERMODE_4F(Lighten)   { return s + d - Sk4f::Min(s*alphas(d), d*alphas(s)); }
+
+#undef XFERMODE_4F
+
+// Each destination type knows how to load and store its pixels as unit floats,
+// and how to load an SkPM4f source into the same channel order.
+struct LinearDst {
+    typedef uint32_t Type;
+    static Sk4f Load(uint32_t dst) { return Sk4f_fromL32(dst); }
+    static uint32_t Store(const Sk4f& x4) { return Sk4f_toL32(x4); }
+    static Sk4f LoadSrc(const SkPM4f& src) { return Sk4f::Load(src.fVec); }
+};
+
+struct SRGBDst {
+    typedef uint32_t Type;
+    static Sk4f Load(uint32_t dst) { return Sk4f_fromS32(dst); }
+    static uint32_t Store(const Sk4f& x4) { return Sk4f_toS32(x4); }
+    static Sk4f LoadSrc(const SkPM4f& src) { return Sk4f::Load(src.fVec); }
+};
+
+// 64-bit destinations are always RGBA, regardless of SkPMColor's order.
+static inline Sk4f pm4f_to_rgba(const SkPM4f& src) {
+    Sk4f x4 = Sk4f::Load(src.fVec);
+    return SkPM4f::R == 0 ? x4 : SkNx_shuffle<2, 1, 0, 3>(x4);
+}
+
+struct U16Dst {
+    typedef uint64_t Type;
+    static Sk4f Load(uint64_t dst) {
+        return SkNx_cast<float>(Sk4h::Load(&dst)) * Sk4f(1.0f/65535);
+    }
+    static uint64_t Store(const Sk4f& x4) {
+        uint64_t dst;
+        SkNx_cast<uint16_t>(x4 * Sk4f(65535) + Sk4f(0.5f)).store(&dst);
+        return dst;
+    }
+    static Sk4f LoadSrc(const SkPM4f& src) { return pm4f_to_rgba(src); }
+};
+
+struct F16Dst {
+    typedef uint64_t Type;
+    static Sk4f Load(uint64_t dst) { return SkHalfToFloat_01(dst); }
+    static uint64_t Store(const Sk4f& x4) { return SkFloatToHalf_01(x4); }
+    static Sk4f LoadSrc(const SkPM4f& src) { return pm4f_to_rgba(src); }
+};
+
+// Blends src (a single color, or one per pixel) into dst, lerping by coverage when we have it.
+// Unlike the generic procs in SkXfermode4f.cpp and SkXfermodeU64.cpp, the blend is inlined and
+// we never round-trip through SkPM4f structs.
+template <typename Xfermode, typename Dst, bool kSrcIsSingle>
+static void xfer_4f_span(const SkXfermode*, typename Dst::Type dst[], const SkPM4f src[],
+                         int count, const SkAlpha aa[]) {
+    if (aa) {
+        for (int i = 0; i < count; ++i) {
+            if (0 == aa[i]) {
+                continue;
+            }
+            const Sk4f s4 = Dst::LoadSrc(src[kSrcIsSingle ? 0 : i]),
+                       d4 = Dst::Load(dst[i]),
+                       r4 = xfer_4f<Xfermode>(d4, s4);
+            dst[i] = Dst::Store(d4 + (r4 - d4) * Sk4f(aa[i] * (1/255.0f)));
+        }
+    } else {
+        for (int i = 0; i < count; ++i) {
+            const Sk4f s4 = Dst::LoadSrc(src[kSrcIsSingle ? 0 : i]);
+            dst[i] = Dst::Store(xfer_4f<Xfermode>(Dst::Load(dst[i]), s4));
+        }
+    }
+}
+
+template <typename Xfermode>
+static SkXfermode::D32Proc d32_proc(uint32_t flags) {
+    const bool single = SkToBool(flags & SkXfermode::kSrcIsSingle_D32Flag);
+    if (flags & SkXfermode::kDstIsSRGB_D32Flag) {
+        return single ? xfer_4f_span<Xfermode, SRGBDst, true>
+                      : xfer_4f_span<Xfermode, SRGBDst, false>;
+    }
+    return single ? xfer_4f_span<Xfermode, LinearDst, true>
+                  : xfer_4f_span<Xfermode, LinearDst, false>;
+}
+
+template <typename Xfermode>
+static SkXfermode::D64Proc d64_proc(uint32_t flags) {
+    const bool single = SkToBool(flags & SkXfermode::kSrcIsSingle_D64Flag);
+    if (flags & SkXfermode::kDstIsFloat16_D64Flag) {
+        return single ? xfer_4f_span<Xfermode, F16Dst, true>
+                      : xfer_4f_span<Xfermode, F16Dst, false>;
+    }
+    return single ? xfer_4f_span<Xfermode, U16Dst, true>
+                  : xfer_4f_span<Xfermode, U16Dst, false>;
+}
+
+// SkXfermode4f.cpp and SkXfermodeU64.cpp already have hand-tuned procs for these modes.
+template <typename Xfermode> static bool use_4f_procs() { return true; }
+template <> bool use_4f_procs<Clear>()   { return false; }
+template <> bool use_4f_procs<Src>()     { return false; }
+template <> bool use_4f_procs<Dst>()     { return false; }
+template <> bool use_4f_procs<SrcOver>() { return false; }
+
 // A reasonable fallback mode for doing AA is to simply apply the transfermode first,
 // then linearly interpolate the AA.
 template <typename Xfermode>
@@ -262,6 +410,17 @@ public:
         }
     }
 
+protected:
+    D32Proc onGetD32Proc(uint32_t flags) const override {
+        return use_4f_procs<Xfermode>() ? d32_proc<Xfermode>(flags)
+                                        : this->INHERITED::onGetD32Proc(flags);
+    }
+
+    D64Proc onGetD64Proc(uint32_t flags) const override {
+        return use_4f_procs<Xfermode>() ? d64_proc<Xfermode>(flags)
+                                        : this->INHERITED::onGetD64Proc(flags);
+    }
+
 private:
     typedef SkProcCoeffXfermode INHERITED;
 };
@@ -286,6 +445,10 @@ public:
         }
     }
 
+protected:
+    D32Proc onGetD32Proc(uint32_t flags) const override { return d32_proc<Xfermode>(flags); }
+    D64Proc onGetD64Proc(uint32_t flags) const override { return d64_proc<Xfermode>(flags); }
+
 private:
     static SkPMColor Xfer32_1(SkPMColor dst, const SkPMColor src, const SkAlpha* aa) {
         Sk4f d = Load(dst),
@@ -387,8 +387,10 @@ public:
     void emitObject(SkWStream*  stream,
                     const SkPDFObjNumMap& objNumMap,
                     const SkPDFSubstituteMap& subs) const override {
+        SkASSERT(fImage);
         emit_image_xobject(stream, fImage, true, nullptr, objNumMap, subs);
     }
+    void drop() override { fImage.reset(nullptr); }
 
 private:
     SkAutoTUnref<const SkImage> fImage;
@@ -404,6 +406,7 @@ public:
     void emitObject(SkWStream* stream,
                     const SkPDFObjNumMap& objNumMap,
                     const SkPDFSubstituteMap& subs) const override {
+        SkASSERT(fImage);
         emit_image_xobject(stream, fImage, false, fSMask, objNumMap, subs);
     }
     void addResources(SkPDFObjNumMap* catalog,
@@ -414,12 +417,16 @@ public:
             catalog->addObjectRecursively(obj, subs);
         }
     }
+    void drop() override {
+        fImage.reset(nullptr);
+        fSMask.reset(nullptr);
+    }
     PDFDefaultBitmap(const SkImage* image, SkPDFObject* smask)
         : fImage(SkRef(image)), fSMask(smask) {}
 
 private:
     SkAutoTUnref<const SkImage> fImage;
-    const SkAutoTUnref<SkPDFObject> fSMask;
+    SkAutoTUnref<SkPDFObject> fSMask;
 };
 }  // namespace
 
@@ -441,11 +448,13 @@ public:
     void emitObject(SkWStream*,
                     const SkPDFObjNumMap&,
                     const SkPDFSubstituteMap&) const override;
+    void drop() override { fData.reset(nullptr); }
 };
 
 void PDFJpegBitmap::emitObject(SkWStream* stream,
                                const SkPDFObjNumMap& objNumMap,
                                const SkPDFSubstituteMap& substituteMap) const {
+    SkASSERT(fData);
     SkPDFDict pdfDict("XObject");
     pdfDict.insertName("Subtype", "Image");
     pdfDict.insertInt("Width", fSize.width());
@@ -115,6 +115,8 @@ private:
     SkTHashSet<WrapGS, WrapGS::Hash> fGraphicStateRecords;
 
     SkTHashMap<SkBitmapKey, const SkImage*> fBitmapToImageMap;
+    // Once a streaming document has written a bitmap, the bitmap drops its
+    // pixels and only stands for its object number.
     SkTHashMap<uint32_t /*ImageUniqueID*/, SkPDFObject*> fPDFBitmapMap;
 };
 #endif  // SkPDFCanon_DEFINED
@@ -493,7 +493,7 @@ bool SkPDFObjNumMap::addObject(SkPDFObject* obj) {
     if (fObjectNumbers.find(obj)) {
         return false;
     }
-    fObjectNumbers.set(obj, fObjectNumbers.count() + 1);
+    fObjectNumbers.set(obj, fObjects.count() + 1);
     fObjects.push(obj);
     return true;
 }
@@ -511,6 +511,13 @@ int32_t SkPDFObjNumMap::getObjectNumber(SkPDFObject* obj) const {
     return *objectNumberFound;
 }
 
+void SkPDFObjNumMap::removeObject(SkPDFObject* obj) {
+    int32_t* objectNumberFound = fObjectNumbers.find(obj);
+    SkASSERT(objectNumberFound);
+    fObjects[*objectNumberFound - 1] = nullptr;
+    fObjectNumbers.remove(obj);
+}
+
 #ifdef SK_PDF_IMAGE_STATS
 SkAtomic<int> gDrawImageCalls(0);
 SkAtomic<int> gJpegImageObjects(0);
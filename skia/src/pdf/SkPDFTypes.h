@@ -52,6 +52,14 @@ public:
     virtual void addResources(SkPDFObjNumMap* catalog,
                               const SkPDFSubstituteMap& substitutes) const {}
 
+    /**
+     *  Release anything only needed by emitObject().  Called by the
+     *  streaming writer once the object has been written; later pages
+     *  refer to it by its object number only, so it is never emitted
+     *  again.
+     */
+    virtual void drop() {}
+
 private:
     typedef SkRefCnt INHERITED;
 };
@@ -357,6 +365,14 @@ public:
      */
     int32_t getObjectNumber(SkPDFObject* obj) const;
 
+    /** Forget the passed object, which must already have been emitted.
+     *  Its object number is not reused, and its entry in objects()
+     *  becomes nullptr, so that a new object allocated at the same
+     *  address gets its own number.
+     *  @param obj         The object to forget.
+     */
+    void removeObject(SkPDFObject* obj);
+
     const SkTDArray<SkPDFObject*>& objects() const { return fObjects; }
 
 private:
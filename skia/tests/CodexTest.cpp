@@ -1000,3 +1000,56 @@ DEF_TEST(Codec_jpeg_rewind, r) {
     SkCodec::Result result = codec->getPixels(codec->getInfo(), pixelStorage.get(), rowBytes);
     REPORTER_ASSERT(r, SkCodec::kSuccess == result);
 }
+
+// Decodes data serially and with Options::fParallelDecode, and checks that both produce the same
+// result and the same bytes.
+static void check_parallel_decode(skiatest::Reporter* r, SkData* data,
+                                  SkCodec::ZeroInitialized zeroInit) {
+    SkAutoTDelete<SkCodec> serialCodec(SkCodec::NewFromData(data));
+    SkAutoTDelete<SkCodec> parallelCodec(SkCodec::NewFromData(data));
+    if (!serialCodec || !parallelCodec) {
+        ERRORF(r, "Unable to create codec.");
+        return;
+    }
+
+    const SkImageInfo info = serialCodec->getInfo().makeColorType(kN32_SkColorType);
+    SkBitmap serial, parallel;
+    serial.allocPixels(info);
+    parallel.allocPixels(info);
+    serial.eraseColor(SK_ColorTRANSPARENT);
+    parallel.eraseColor(SK_ColorTRANSPARENT);
+
+    SkCodec::Options opts;
+    opts.fZeroInitialized = zeroInit;
+    const SkCodec::Result serialResult = serialCodec->getPixels(info, serial.getPixels(),
+            serial.rowBytes(), &opts, nullptr, nullptr);
+    opts.fParallelDecode = true;
+    const SkCodec::Result parallelResult = parallelCodec->getPixels(info, parallel.getPixels(),
+            parallel.rowBytes(), &opts, nullptr, nullptr);
+    REPORTER_ASSERT(r, serialResult == parallelResult);
+
+    for (int y = 0; y < info.height(); y++) {
+        if (memcmp(serial.getAddr(0, y), parallel.getAddr(0, y), info.minRowBytes())) {
+            ERRORF(r, "Parallel decode differs from serial decode at row %d.", y);
+            return;
+        }
+    }
+}
+
+DEF_TEST(Codec_parallelDecode, r) {
+    // Only baseline JPEG decodes in parallel; a PNG band would have to inflate every row above it.
+    const char* path = "mandrill_512_q075.jpg";
+    SkAutoTUnref<SkData> data(SkData::NewFromFileName(GetResourcePath(path).c_str()));
+    if (!data) {
+        SkDebugf("Missing resource '%s'\n", path);
+        return;
+    }
+    check_parallel_decode(r, data, SkCodec::kNo_ZeroInitialized);
+    check_parallel_decode(r, data, SkCodec::kYes_ZeroInitialized);
+
+    // The lower bands run off the end of a truncated stream, which forces getPixels() back
+    // to the serial decode after some rows have already been written.
+    SkAutoTUnref<SkData> truncated(SkData::NewSubset(data, 0, data->size() / 2));
+    check_parallel_decode(r, truncated, SkCodec::kNo_ZeroInitialized);
+    check_parallel_decode(r, truncated, SkCodec::kYes_ZeroInitialized);
+}
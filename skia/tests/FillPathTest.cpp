@@ -5,7 +5,9 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
 #include "SkBlitter.h"
+#include "SkCanvas.h"
 #include "SkPath.h"
 #include "SkRegion.h"
 #include "SkScan.h"
@@ -43,3 +45,76 @@ DEF_TEST(FillPathInverse, reporter) {
 
   REPORTER_ASSERT(reporter, blitter.m_blitCount == expected_lines);
 }
+
+static void draw_aa_path(const SkPath& path, bool analytic, SkBitmap* bm) {
+    bm->allocPixels(SkImageInfo::MakeA8(64, 64));
+    bm->eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(*bm);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+
+    const bool useAnalyticAA = gSkUseAnalyticAA;
+    gSkUseAnalyticAA = analytic;
+    canvas.drawPath(path, paint);
+    gSkUseAnalyticAA = useAnalyticAA;
+}
+
+// The analytic rasterizer should agree with 4x supersampling to within the supersampler's
+// quantization, and should cover exactly the area of the path.
+DEF_TEST(FillPathAnalyticAA, reporter) {
+    SkPath triangle;
+    triangle.moveTo(3.3f, 2.7f);
+    triangle.lineTo(50.6f, 9.2f);
+    triangle.lineTo(21.1f, 58.9f);
+    triangle.close();
+
+    SkPath oval;
+    oval.addOval(SkRect::MakeLTRB(5.25f, 8.5f, 60.75f, 40.1f));
+
+    SkPath cubics;
+    cubics.moveTo(4, 60);
+    cubics.cubicTo(10, -20, 50, 90, 60, 4);
+    cubics.lineTo(30, 30);
+    cubics.close();
+
+    SkPath donut;
+    donut.addCircle(32, 32, 28);
+    donut.addCircle(32, 32, 12.5f);
+    donut.setFillType(SkPath::kEvenOdd_FillType);
+
+    SkPath inverse(triangle);
+    inverse.setFillType(SkPath::kInverseWinding_FillType);
+
+    const SkPath* paths[] = { &triangle, &oval, &cubics, &donut, &inverse };
+    for (const SkPath* path : paths) {
+        SkBitmap analytic, supersampled;
+        draw_aa_path(*path, true, &analytic);
+        draw_aa_path(*path, false, &supersampled);
+
+        int maxDiff = 0;
+        double analyticSum = 0, supersampledSum = 0;
+        for (int y = 0; y < 64; y++) {
+            for (int x = 0; x < 64; x++) {
+                int a = *analytic.getAddr8(x, y);
+                int s = *supersampled.getAddr8(x, y);
+                maxDiff = SkTMax(maxDiff, SkTAbs(a - s));
+                analyticSum += a;
+                supersampledSum += s;
+            }
+        }
+        REPORTER_ASSERT(reporter, maxDiff <= 48);
+        REPORTER_ASSERT(reporter, SkTAbs(analyticSum - supersampledSum) <= 0.01 * supersampledSum);
+    }
+
+    // A triangle well inside the bitmap. Its area is the sum of its coverage.
+    SkBitmap bm;
+    draw_aa_path(triangle, true, &bm);
+    double coverage = 0;
+    for (int y = 0; y < 64; y++) {
+        for (int x = 0; x < 64; x++) {
+            coverage += *bm.getAddr8(x, y) / 255.0;
+        }
+    }
+    const double area = 0.5 * ((50.6 - 3.3) * (58.9 - 2.7) - (21.1 - 3.3) * (9.2 - 2.7));
+    REPORTER_ASSERT(reporter, SkTAbs(coverage - area) < 0.1);
+}
@@ -23,7 +23,9 @@
 #include "GrTest.h"
 #include "GrXferProcessor.h"
 #include "SkChecksum.h"
+#include "SkData.h"
 #include "SkRandom.h"
+#include "SkTHash.h"
 #include "Test.h"
 
 #include "batches/GrDrawBatch.h"
@@ -463,4 +465,80 @@ DEF_GPUTEST(GLPrograms, reporter, /*factory*/) {
                                      skiatest::kOther_GPUTestContexts, reporter, &debugFactory);
 }
 
+namespace {
+
+// Keeps program binaries in memory so that a second GrContext can pick them up.
+class MemoryPersistentCache : public GrContextOptions::PersistentCache {
+public:
+    MemoryPersistentCache() : fLoads(0), fHits(0), fStores(0) {}
+
+    ~MemoryPersistentCache() override {
+        fMap.foreach([](const SkString&, SkData** data) { (*data)->unref(); });
+    }
+
+    SkData* load(const SkData& key) override {
+        ++fLoads;
+        SkData** data = fMap.find(to_string(key));
+        if (!data) {
+            return nullptr;
+        }
+        ++fHits;
+        return SkRef(*data);
+    }
+
+    void store(const SkData& key, const SkData& data) override {
+        ++fStores;
+        SkString k = to_string(key);
+        if (SkData** old = fMap.find(k)) {
+            (*old)->unref();
+        }
+        fMap.set(k, SkData::NewWithCopy(data.data(), data.size()));
+    }
+
+    int fLoads;
+    int fHits;
+    int fStores;
+
+private:
+    static SkString to_string(const SkData& data) {
+        return SkString(static_cast<const char*>(data.data()), data.size());
+    }
+
+    SkTHashMap<SkString, SkData*> fMap;
+};
+
+}  // namespace
+
+static void test_glprograms_binary_cache(skiatest::Reporter* reporter, GrContext* context) {
+    int maxStages = SkTMin(get_glprograms_max_stages(context), 2);
+    if (maxStages == 0) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, GrDrawingManager::ProgramUnitTest(context, maxStages));
+}
+
+DEF_GPUTEST(GLProgramsBinaryCache, reporter, /*factory*/) {
+    MemoryPersistentCache cache;
+
+    GrContextOptions opts;
+    opts.fSuppressPrints = true;
+    opts.fPersistentCache = &cache;
+    {
+        GrContextFactory factory(opts);
+        skiatest::RunWithGPUTestContexts(test_glprograms_binary_cache,
+                                         skiatest::kNative_GPUTestContexts, reporter, &factory);
+    }
+    int firstStores = cache.fStores;
+
+    // A fresh context generates the same programs and should be able to reuse the binaries.
+    {
+        GrContextFactory factory(opts);
+        skiatest::RunWithGPUTestContexts(test_glprograms_binary_cache,
+                                         skiatest::kNative_GPUTestContexts, reporter, &factory);
+    }
+    if (firstStores > 0) {
+        REPORTER_ASSERT(reporter, cache.fHits > 0);
+    }
+}
+
 #endif
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "sk_tool_utils.h"
+
+#include "SkGlyphCache.h"
+#include "SkGlyphCache_Globals.h"
+#include "SkPaint.h"
+#include "SkTDArray.h"
+#include "SkTypeface.h"
+#include "Test.h"
+
+static const int kShardCount = 4;
+static const int kStrikeCount = 32;
+
+// Checks that the global totals are the sum of what the shards hold, and returns the number
+// of shards holding at least one strike.
+static int check_totals(skiatest::Reporter* r, const SkGlyphCache_Globals& globals) {
+    int totalCount = 0;
+    size_t totalBytes = 0;
+    int usedShards = 0;
+    for (int i = 0; i < globals.shardCount(); i++) {
+        int count;
+        size_t bytes;
+        globals.countShard(globals.shardAt(i), &count, &bytes);
+        if (count) {
+            usedShards++;
+        }
+        totalCount += count;
+        totalBytes += bytes;
+    }
+    REPORTER_ASSERT(r, globals.getCacheCountUsed() == totalCount);
+    REPORTER_ASSERT(r, globals.getTotalMemoryUsed() == totalBytes);
+    return usedShards;
+}
+
+static void record_cache(const SkGlyphCache& cache, void* context) {
+    static_cast<SkTDArray<const SkGlyphCache*>*>(context)->push(&cache);
+}
+
+DEF_TEST(GlyphCache_Shards, r) {
+    SkGlyphCache_Globals globals(kShardCount);
+    REPORTER_ASSERT(r, kShardCount == globals.shardCount());
+    globals.setCacheSizeLimit(64 * 1024 * 1024);
+
+    SkAutoTUnref<SkTypeface> typeface(
+            sk_tool_utils::create_portable_typeface("serif", SkTypeface::kNormal));
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setTypeface(typeface);
+
+    // Move strikes of different sizes, each holding some glyph images, out of the global
+    // cache and into ours. Together they need to be well over the 256K minimum byte budget.
+    size_t totalBytes = 0;
+    const SkGlyphCache* strikes[kStrikeCount];
+    for (int i = 0; i < kStrikeCount; i++) {
+        paint.setTextSize(SkIntToScalar(80 + i));
+        SkAutoGlyphCache autoCache(paint, nullptr, nullptr);
+        SkGlyphCache* cache = autoCache.release();
+        for (int c = 'a'; c <= 'z'; c++) {
+            cache->findImage(cache->getUnicharMetrics(c));
+        }
+        totalBytes += cache->getMemoryUsed();
+        strikes[i] = cache;
+        globals.attachCacheToHead(cache);
+    }
+    REPORTER_ASSERT(r, kStrikeCount == globals.getCacheCountUsed());
+    REPORTER_ASSERT(r, totalBytes == globals.getTotalMemoryUsed());
+    REPORTER_ASSERT(r, check_totals(r, globals) > 1);
+
+    // Purging follows the LRU order across shards: dropping a quarter of the strikes removes
+    // exactly the ones attached first, whichever shards they are in.
+    const int kPurged = kStrikeCount / 4;
+    globals.setCacheCountLimit(kStrikeCount - kPurged);
+    SkTDArray<const SkGlyphCache*> remaining;
+    globals.visitAll(record_cache, &remaining);
+    REPORTER_ASSERT(r, kStrikeCount - kPurged == remaining.count());
+    for (int i = 0; i < kStrikeCount; i++) {
+        REPORTER_ASSERT(r, (i >= kPurged) == (remaining.find(strikes[i]) >= 0));
+    }
+    totalBytes = globals.getTotalMemoryUsed();
+    check_totals(r, globals);
+
+    // The byte budget is global: purging has to reach into other shards to meet it.
+    globals.setCacheSizeLimit(totalBytes / 2);
+    REPORTER_ASSERT(r, globals.getTotalMemoryUsed() <= globals.getCacheSizeLimit());
+    REPORTER_ASSERT(r, globals.getCacheCountUsed() < kStrikeCount);
+    check_totals(r, globals);
+
+    // Likewise for the count budget.
+    globals.setCacheCountLimit(2);
+    REPORTER_ASSERT(r, globals.getCacheCountUsed() <= 2);
+    check_totals(r, globals);
+
+    globals.purgeAll();
+    REPORTER_ASSERT(r, 0 == globals.getCacheCountUsed());
+    REPORTER_ASSERT(r, 0 == globals.getTotalMemoryUsed());
+    REPORTER_ASSERT(r, 0 == check_totals(r, globals));
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2016 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTypes.h"
+
+#if SK_SUPPORT_GPU
+
+#include "GrBatchAtlas.h"
+#include "GrBatchFlushState.h"
+#include "GrContext.h"
+#include "GrTextureProvider.h"
+#include "SkTDArray.h"
+#include "SkTemplates.h"
+#include "SkUtils.h"
+#include "Test.h"
+
+static void record_eviction(GrBatchAtlas::AtlasID id, void* data) {
+    reinterpret_cast<SkTDArray<GrBatchAtlas::AtlasID>*>(data)->push(id);
+}
+
+// Fills every plot of the first page while it is in use by the current flush, so the atlas has to
+// grow a second page, then checks that IDs on both pages stay valid and that once the flush is done
+// plots are evicted, least recently used first, from both pages.
+DEF_GPUTEST_FOR_NULL_CONTEXT(GrBatchAtlas_MultiPage, reporter, context) {
+    static const int kPlotDim = 32;
+    static const int kPlotsPerPage = 4;
+
+    GrSurfaceDesc desc;
+    desc.fConfig = kSkia8888_GrPixelConfig;
+    desc.fWidth = 2 * kPlotDim;
+    desc.fHeight = 2 * kPlotDim;
+    GrTexture* texture = context->textureProvider()->createApproxTexture(desc);
+    if (!texture) {
+        ERRORF(reporter, "Could not create atlas texture");
+        return;
+    }
+
+    GrBatchFlushState state(context->getGpu(), context->resourceProvider());
+    // No batch is needed: every upload here is an ASAP upload.
+    GrDrawBatch::Target target(&state, nullptr);
+    GrBatchAtlas atlas(texture, 2, 2, 2);
+    SkTDArray<GrBatchAtlas::AtlasID> evicted;
+    atlas.registerEvictionCallback(record_eviction, &evicted);
+
+    // Each image fills a whole plot.
+    SkAutoTMalloc<uint32_t> image(kPlotDim * kPlotDim);
+    GrBatchAtlas::AtlasID ids[2 * kPlotsPerPage];
+    SkIPoint16 loc;
+
+    // The draws using the atlas are prepared but not flushed yet.
+    state.advanceToken();
+    for (int i = 0; i < 2 * kPlotsPerPage; ++i) {
+        sk_memset32(image.get(), i, kPlotDim * kPlotDim);
+        REPORTER_ASSERT(reporter, atlas.addToAtlas(&ids[i], &target, kPlotDim, kPlotDim,
+                                                   image.get(), &loc));
+        atlas.setLastUseToken(ids[i], state.currentToken());
+        REPORTER_ASSERT(reporter, atlas.pageIndex(ids[i]) == i / kPlotsPerPage);
+        REPORTER_ASSERT(reporter, atlas.numPages() == 1 + i / kPlotsPerPage);
+    }
+    REPORTER_ASSERT(reporter, atlas.getTexture(0) == texture);
+    REPORTER_ASSERT(reporter, atlas.getTexture(1) && atlas.getTexture(1) != texture);
+    REPORTER_ASSERT(reporter, 0 == atlas.evictionCount());
+    for (int i = 0; i < 2 * kPlotsPerPage; ++i) {
+        REPORTER_ASSERT(reporter, atlas.hasID(ids[i]));
+        for (int j = 0; j < i; ++j) {
+            REPORTER_ASSERT(reporter, ids[i] != ids[j]);
+        }
+    }
+
+    // Both pages are full and in use, so the caller must flush.
+    GrBatchAtlas::AtlasID id;
+    REPORTER_ASSERT(reporter, !atlas.addToAtlas(&id, &target, kPlotDim, kPlotDim, image.get(),
+                                                &loc));
+    REPORTER_ASSERT(reporter, 1 == atlas.flushCount());
+    REPORTER_ASSERT(reporter, 0 == evicted.count());
+
+    // After the flush, each new image evicts the least recently used plot, in the order the plots
+    // were filled, and reuses its slot on the same page.
+    state.advanceLastFlushedToken();
+    for (int i = 0; i < 2 * kPlotsPerPage; ++i) {
+        REPORTER_ASSERT(reporter, atlas.addToAtlas(&id, &target, kPlotDim, kPlotDim, image.get(),
+                                                   &loc));
+        REPORTER_ASSERT(reporter, i + 1 == evicted.count() && evicted[i] == ids[i]);
+        REPORTER_ASSERT(reporter, !atlas.hasID(ids[i]));
+        REPORTER_ASSERT(reporter, atlas.hasID(id));
+        REPORTER_ASSERT(reporter, atlas.pageIndex(id) == atlas.pageIndex(ids[i]));
+        for (int j = i + 1; j < 2 * kPlotsPerPage; ++j) {
+            REPORTER_ASSERT(reporter, atlas.hasID(ids[j]));
+        }
+    }
+    REPORTER_ASSERT(reporter, 2 * kPlotsPerPage == atlas.evictionCount());
+    REPORTER_ASSERT(reporter, 2 == atlas.numPages());
+}
+
+#endif
@@ -5,8 +5,11 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmapCache.h"
 #include "SkCachedData.h"
+#include "SkDiscardableMemoryPool.h"
 #include "SkMaskCache.h"
+#include "SkMipMap.h"
 #include "SkResourceCache.h"
 #include "Test.h"
 
@@ -104,3 +107,116 @@ DEF_TEST(RectsMaskCache, reporter) {
     check_data(reporter, data, 1, kNotInCache, kLocked);
     data->unref();
 }
+
+DEF_TEST(PathBlurCache, reporter) {
+    SkResourceCache cache(64 * 1024);
+
+    SkScalar sigma = 0.8f;
+    SkBlurStyle style = kNormal_SkBlurStyle;
+    SkBlurQuality quality = kLow_SkBlurQuality;
+    SkPaint::Style paintStyle = SkPaint::kFill_Style;
+    uint32_t genID = 7;
+    SkMatrix matrix;
+    matrix.setScale(2, 2);
+    matrix.postTranslate(10.25f, 20);
+    SkIRect srcBounds = SkIRect::MakeXYWH(10, 20, 16, 8);
+
+    SkMask mask;
+    SkCachedData* data = SkMaskCache::FindAndRef(sigma, style, quality, genID, matrix,
+                                                 paintStyle, srcBounds, &mask, &cache);
+    REPORTER_ASSERT(reporter, nullptr == data);
+
+    size_t size = 20 * 12;
+    data = cache.newCachedData(size);
+    memset(data->writable_data(), 0xff, size);
+    mask.fBounds.setXYWH(8, 18, 20, 12);
+    mask.fRowBytes = 20;
+    mask.fFormat = SkMask::kA8_Format;
+    SkMaskCache::Add(sigma, style, quality, genID, matrix, paintStyle, srcBounds, mask, data,
+                     &cache);
+    data->unref();
+
+    // The same path moved by whole pixels finds the blur, moved along with it.
+    matrix.postTranslate(-10, 5);
+    srcBounds.offset(-10, 5);
+    sk_bzero(&mask, sizeof(mask));
+    data = SkMaskCache::FindAndRef(sigma, style, quality, genID, matrix, paintStyle, srcBounds,
+                                   &mask, &cache);
+    REPORTER_ASSERT(reporter, data);
+    REPORTER_ASSERT(reporter, mask.fBounds == SkIRect::MakeXYWH(-2, 23, 20, 12));
+    REPORTER_ASSERT(reporter, data->data() == (const void*)mask.fImage);
+    check_data(reporter, data, 2, kInCache, kLocked);
+    data->unref();
+
+    // Another path, a fractional move, another scale or another sigma miss.
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(sigma, style, quality, genID + 1, matrix,
+                                                       paintStyle, srcBounds, &mask, &cache));
+    SkMatrix moved = matrix;
+    moved.postTranslate(0.5f, 0);
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(sigma, style, quality, genID, moved,
+                                                       paintStyle, srcBounds, &mask, &cache));
+    SkMatrix scaled = matrix;
+    scaled.preScale(2, 1);
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(sigma, style, quality, genID, scaled,
+                                                       paintStyle, srcBounds, &mask, &cache));
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(2 * sigma, style, quality, genID, matrix,
+                                                       paintStyle, srcBounds, &mask, &cache));
+}
+
+static SkDiscardableMemoryPool* gPool;
+static SkDiscardableMemory* pool_factory(size_t bytes) {
+    SkASSERT(gPool);
+    return gPool->create(bytes);
+}
+
+DEF_TEST(MaskCache_MemoryPressure, reporter) {
+    SkResourceCache cache(1024 * 1024);
+    SkAutoTUnref<SkDiscardableMemoryPool> pool(SkDiscardableMemoryPool::Create(1024 * 1024));
+    gPool = pool.get();
+
+    SkScalar sigma = 0.8f;
+    SkRRect rrect;
+    rrect.setRectXY(SkRect::MakeWH(100, 100), 30, 30);
+    SkBlurStyle style = kNormal_SkBlurStyle;
+    SkBlurQuality quality = kLow_SkBlurQuality;
+    SkMask mask;
+    mask.fBounds.setXYWH(0, 0, 100, 100);
+    mask.fRowBytes = 100;
+    mask.fFormat = SkMask::kBW_Format;
+
+    size_t size = 256;
+    SkCachedData* data = cache.newCachedData(size);
+    memset(data->writable_data(), 0x5a, size);
+    SkMaskCache::Add(sigma, style, quality, rrect, mask, data, &cache);
+    data->unref();
+
+    SkBitmap src;
+    src.allocN32Pixels(5, 5);
+    src.setImmutable();
+    SkMipMapCache::AddAndRef(src, &cache)->unref();
+
+    // Moderate pressure drops the mipmap and moves the mask onto discardable memory.
+    size_t bytesUsed = cache.getTotalBytesUsed();
+    size_t moved = 0;
+    size_t freed = cache.purgeForMemoryPressure(SkResourceCache::kModerate_MemoryPressure,
+                                                pool_factory, &moved);
+    REPORTER_ASSERT(reporter, freed > 0);
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() == bytesUsed - freed);
+    REPORTER_ASSERT(reporter, moved == cache.getTotalBytesUsed());
+    REPORTER_ASSERT(reporter, nullptr == SkMipMapCache::FindAndRef(SkBitmapCacheDesc::Make(src),
+                                                                   &cache));
+    REPORTER_ASSERT(reporter, pool->getRAMUsed() == size);
+
+    data = SkMaskCache::FindAndRef(sigma, style, quality, rrect, &mask, &cache);
+    REPORTER_ASSERT(reporter, data);
+    REPORTER_ASSERT(reporter, data->diagnostic_only_getDiscardable());
+    REPORTER_ASSERT(reporter, 0x5a == static_cast<const uint8_t*>(data->data())[size - 1]);
+
+    // While we hold a ref, critical pressure still purges it from the cache.
+    bytesUsed = cache.getTotalBytesUsed();
+    freed = cache.purgeForMemoryPressure(SkResourceCache::kCritical_MemoryPressure);
+    REPORTER_ASSERT(reporter, freed == bytesUsed);
+    REPORTER_ASSERT(reporter, 0 == cache.getTotalBytesUsed());
+    check_data(reporter, data, 1, kNotInCache, kLocked);
+    data->unref();
+}
@@ -8,7 +8,9 @@
 
 #include "Resources.h"
 #include "SkCanvas.h"
+#include "SkData.h"
 #include "SkDocument.h"
+#include "SkImage.h"
 #include "SkOSFile.h"
 #include "SkStream.h"
 #include "SkPixelSerializer.h"
@@ -166,3 +168,102 @@ DEF_TEST(document_skbug_4734, r) {
     const char text[] = "HELLO";
     canvas->drawText(text, strlen(text), 0, 0, SkPaint());
 }
+
+// Checks that every entry of the cross-reference table points at its object.
+static bool check_xref(const SkData* pdf) {
+    SkString str(static_cast<const char*>(pdf->data()), pdf->size());
+    const char* data = str.c_str();
+    const char* startxref = strstr(data, "startxref\n");
+    while (startxref && strstr(startxref + 1, "startxref\n")) {
+        startxref = strstr(startxref + 1, "startxref\n");
+    }
+    if (!startxref) {
+        return false;
+    }
+    long xref = atol(startxref + strlen("startxref\n"));
+    int count;
+    if (xref <= 0 || xref >= (long)str.size() ||
+        1 != sscanf(data + xref, "xref\n0 %d\n", &count)) {
+        return false;
+    }
+    // Each entry is exactly 20 bytes; skip the free entry for object 0.
+    const char* entries = strchr(strchr(data + xref, '\n') + 1, '\n') + 1 + 20;
+    for (int i = 1; i < count; ++i) {
+        long offset = atol(entries + 20 * (i - 1));
+        SkString expected;
+        expected.printf("%d 0 obj\n", i);
+        if (offset <= 0 || offset >= (long)str.size() ||
+            0 != strncmp(data + offset, expected.c_str(), expected.size())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static SkData* make_document(bool streaming, skiatest::Reporter* r) {
+    SkBitmap bm;
+    bm.allocN32Pixels(16, 16);
+    bm.eraseColor(SK_ColorBLUE);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    const char text[] = "HELLO";
+
+    SkDynamicMemoryWStream stream;
+    SkAutoTUnref<SkDocument> doc(streaming ? SkDocument::CreateStreamingPDF(&stream)
+                                           : SkDocument::CreatePDF(&stream));
+    size_t previous = 0;
+    for (int i = 0; i < 5; ++i) {
+        SkCanvas* canvas = doc->beginPage(100, 100);
+        canvas->drawBitmap(bm, 0, 0);
+        canvas->drawText(text, strlen(text), 10, 50, paint);
+        doc->endPage();
+        if (streaming) {
+            // Pages should be written as soon as they end.
+            REPORTER_ASSERT(r, stream.bytesWritten() > previous);
+            previous = stream.bytesWritten();
+        }
+    }
+    REPORTER_ASSERT(r, doc->close());
+    return stream.copyToData();
+}
+
+DEF_TEST(document_streaming, r) {
+    REQUIRE_PDF_DOCUMENT(document_streaming, r);
+    for (bool streaming : { false, true }) {
+        SkAutoTUnref<SkData> pdf(make_document(streaming, r));
+        REPORTER_ASSERT(r, pdf->size() > 4 && 0 == memcmp(pdf->data(), "%PDF", 4));
+        REPORTER_ASSERT(r, check_xref(pdf));
+    }
+}
+
+static int count_occurrences(const SkData* pdf, const char* needle) {
+    SkString str(static_cast<const char*>(pdf->data()), pdf->size());
+    int count = 0;
+    for (const char* p = strstr(str.c_str(), needle); p; p = strstr(p + 1, needle)) {
+        count++;
+    }
+    return count;
+}
+
+// A streaming document lets go of an image once it has been written, and
+// later pages still refer to the same image object.
+DEF_TEST(document_streaming_image, r) {
+    REQUIRE_PDF_DOCUMENT(document_streaming_image, r);
+    SkBitmap bm;
+    bm.allocN32Pixels(16, 16);
+    bm.eraseColor(SK_ColorBLUE);
+    bm.setImmutable();
+    SkAutoTUnref<SkImage> image(SkImage::NewFromBitmap(bm));
+
+    SkDynamicMemoryWStream stream;
+    SkAutoTUnref<SkDocument> doc(SkDocument::CreateStreamingPDF(&stream));
+    for (int i = 0; i < 3; ++i) {
+        doc->beginPage(100, 100)->drawImage(image, 0, 0);
+        doc->endPage();
+        REPORTER_ASSERT(r, image->unique());
+    }
+    REPORTER_ASSERT(r, doc->close());
+    SkAutoTUnref<SkData> pdf(stream.copyToData());
+    REPORTER_ASSERT(r, check_xref(pdf));
+    REPORTER_ASSERT(r, 1 == count_occurrences(pdf, "/Subtype /Image"));
+}
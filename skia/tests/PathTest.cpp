@@ -3951,6 +3951,42 @@ DEF_TEST(PathContains, reporter) {
     test_contains(reporter);
 }
 
+static void make_icon(SkPath* path, SkScalar dx, SkScalar dy) {
+    path->moveTo(dx + 2, dy + 1);
+    path->lineTo(dx + 9, dy + 4);
+    path->conicTo(dx + 12, dy + 8, dx + 6, dy + 11, 0.5f);
+    path->quadTo(dx + 1, dy + 9, dx + 3, dy + 6);
+    path->close();
+}
+
+DEF_TEST(PathContentHash, reporter) {
+    SkPath a, b, moved;
+    make_icon(&a, 0, 0);
+    make_icon(&b, 0, 0);
+    make_icon(&moved, 16, 32);
+    REPORTER_ASSERT(reporter, a.getGenerationID() != b.getGenerationID());
+    REPORTER_ASSERT(reporter, SkPathPriv::ContentHash(a) == SkPathPriv::ContentHash(b));
+    REPORTER_ASSERT(reporter, SkPathPriv::ContentHash(a) == SkPathPriv::ContentHash(moved));
+
+    // Offsetting a copy only changes its position.
+    SkPath offset(a);
+    offset.offset(100, 200);
+    REPORTER_ASSERT(reporter, SkPathPriv::ContentHash(a) == SkPathPriv::ContentHash(offset));
+
+    // Editing the path changes its geometry, and the cached hash must follow.
+    const uint32_t hash = SkPathPriv::ContentHash(b);
+    b.lineTo(5, 5);
+    REPORTER_ASSERT(reporter, SkPathPriv::ContentHash(b) != hash);
+
+    SkPath weight;
+    weight.moveTo(2, 1);
+    weight.lineTo(9, 4);
+    weight.conicTo(12, 8, 6, 11, 0.75f);
+    weight.quadTo(1, 9, 3, 6);
+    weight.close();
+    REPORTER_ASSERT(reporter, SkPathPriv::ContentHash(a) != SkPathPriv::ContentHash(weight));
+}
+
 DEF_TEST(Paths, reporter) {
     test_path_crbug364224();
 
@@ -18,6 +18,7 @@
 #include "SkImageGenerator.h"
 #include "SkLayerInfo.h"
 #include "SkMD5.h"
+#include "SkMultiPictureDraw.h"
 #include "SkPaint.h"
 #include "SkPicture.h"
 #include "SkPictureRecorder.h"
@@ -1415,3 +1416,43 @@ DEF_TEST(Picture_preserveCullRect, r) {
     REPORTER_ASSERT(r, deserializedPicture->cullRect().right() == 3);
     REPORTER_ASSERT(r, deserializedPicture->cullRect().bottom() == 4);
 }
+
+DEF_TEST(Picture_DrawTiled, r) {
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    SkCanvas* c = recorder.beginRecording(SkRect::MakeWH(300, 200), &factory);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    SkRandom rand;
+    for (int i = 0; i < 50; ++i) {
+        paint.setColor(rand.nextU() | 0xFF000000);
+        c->drawCircle(rand.nextRangeScalar(0, 300), rand.nextRangeScalar(0, 200),
+                      rand.nextRangeScalar(5, 40), paint);
+    }
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    const SkMatrix matrix = SkMatrix::MakeScale(1.5f);
+
+    SkBitmap expected;
+    expected.allocN32Pixels(450, 300);
+    expected.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(expected);
+    canvas.drawPicture(picture, &matrix, nullptr);
+
+    // Tile sizes that don't evenly divide the destination exercise the edge tiles.
+    const SkISize tileSizes[] = { {64, 64}, {100, 37}, {450, 300}, {1000, 1000} };
+    for (const SkISize& tileSize : tileSizes) {
+        for (int tasks : {0, 1, 3}) {
+            SkBitmap actual;
+            actual.allocN32Pixels(450, 300);
+            actual.eraseColor(SK_ColorWHITE);
+            SkAutoLockPixels alp(actual);
+            SkPixmap pixmap;
+            REPORTER_ASSERT(r, actual.peekPixels(&pixmap));
+            SkMultiPictureDraw::DrawTiled(pixmap, picture, &matrix, tileSize, tasks);
+
+            REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                           expected.getSize()));
+        }
+    }
+}
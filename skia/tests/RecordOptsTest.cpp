@@ -343,3 +343,152 @@ DEF_TEST(RecordOpts_MergeSvgOpacityAndFilterLayers, r) {
     assert_type<SkRecords::Restore>(r, record, index + 3);
     index += 4;
 }
+
+DEF_TEST(RecordOpts_BatchDraws, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint red, blue;
+    red.setColor(SK_ColorRED);
+    blue.setColor(SK_ColorBLUE);
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(16, 16);
+    bitmap.eraseColor(SK_ColorGREEN);
+
+    recorder.drawRect(SkRect::MakeWH(10, 10), red);
+    recorder.drawRect(SkRect::MakeWH(20, 20), red);
+    recorder.drawRect(SkRect::MakeWH(30, 30), red);
+    recorder.drawRect(SkRect::MakeWH(40, 40), blue);
+    recorder.drawBitmapRect(bitmap, SkRect::MakeWH(8, 8), SkRect::MakeWH(50, 50), nullptr);
+    recorder.drawBitmapRect(bitmap, SkRect::MakeWH(4, 4), SkRect::MakeWH(60, 60), nullptr);
+    recorder.drawBitmapRect(bitmap, SkRect::MakeWH(2, 2), SkRect::MakeWH(70, 70), &red);
+
+    SkRecordBatchDraws(&record);
+
+    const SkRecords::DrawRects* rects = assert_type<SkRecords::DrawRects>(r, record, 0);
+    REPORTER_ASSERT(r, 3 == rects->count);
+    REPORTER_ASSERT(r, SkRect::MakeWH(30, 30) == rects->rects[2]);
+    assert_type<SkRecords::NoOp>(r, record, 1);
+    assert_type<SkRecords::NoOp>(r, record, 2);
+    assert_type<SkRecords::DrawRect>(r, record, 3);
+
+    const SkRecords::DrawBitmapRects* bitmapRects =
+            assert_type<SkRecords::DrawBitmapRects>(r, record, 4);
+    REPORTER_ASSERT(r, 2 == bitmapRects->count);
+    REPORTER_ASSERT(r, SkRect::MakeWH(4, 4) == bitmapRects->srcs[1]);
+    REPORTER_ASSERT(r, SkRect::MakeWH(60, 60) == bitmapRects->dsts[1]);
+    REPORTER_ASSERT(r, SkCanvas::kStrict_SrcRectConstraint == bitmapRects->constraint);
+    assert_type<SkRecords::NoOp>(r, record, 5);
+    assert_type<SkRecords::DrawBitmapRect>(r, record, 6);
+}
+
+DEF_TEST(RecordOpts_NoopRedundantState, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    const SkRect clip = SkRect::MakeWH(100, 100);
+
+    recorder.clipRect(clip);
+    recorder.save();
+        recorder.clipRect(clip);                      // Redundant: already clipped to this.
+        recorder.translate(10, 10);
+        recorder.clipRect(clip);                      // Not redundant: different matrix.
+        recorder.drawRect(clip, SkPaint());
+    recorder.restore();
+    recorder.clipRect(clip);                          // Redundant again.
+    recorder.setMatrix(SkMatrix::I());                // Redundant: restore() already did this.
+    recorder.drawRect(clip, SkPaint());
+
+    SkRecordNoopRedundantState(&record);
+
+    assert_type<SkRecords::ClipRect>(r, record, 0);
+    assert_type<SkRecords::Save>(r, record, 1);
+    assert_type<SkRecords::NoOp>(r, record, 2);
+    assert_type<SkRecords::Concat>(r, record, 3);
+    assert_type<SkRecords::ClipRect>(r, record, 4);
+    assert_type<SkRecords::DrawRect>(r, record, 5);
+    assert_type<SkRecords::Restore>(r, record, 6);
+    assert_type<SkRecords::NoOp>(r, record, 7);
+    assert_type<SkRecords::NoOp>(r, record, 8);
+    assert_type<SkRecords::DrawRect>(r, record, 9);
+
+    // Concatenating the identity changes nothing either.
+    new (record.replace<SkRecords::Concat>(8)) SkRecords::Concat{SkMatrix::I()};
+    SkRecordNoopRedundantState(&record);
+    assert_type<SkRecords::NoOp>(r, record, 8);
+}
+
+DEF_TEST(RecordOpts_MergeSameClipRectBlocks, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    const SkRect clip = SkRect::MakeWH(100, 100);
+    for (int i = 0; i < 3; i++) {
+        recorder.save();
+            recorder.clipRect(clip);
+            recorder.drawRect(SkRect::MakeXYWH(10 * i, 0, 5, 5), SkPaint());
+        recorder.restore();
+    }
+
+    SkRecordNoopRedundantState(&record);
+    REPORTER_ASSERT(r, 1 == count_instances_of_type<SkRecords::Save>(record));
+    REPORTER_ASSERT(r, 1 == count_instances_of_type<SkRecords::ClipRect>(record));
+    REPORTER_ASSERT(r, 1 == count_instances_of_type<SkRecords::Restore>(record));
+    REPORTER_ASSERT(r, 3 == count_instances_of_type<SkRecords::DrawRect>(record));
+
+    // Different clips must stay separate.
+    SkRecord record2;
+    SkRecorder recorder2(&record2, W, H);
+    for (int i = 0; i < 2; i++) {
+        recorder2.save();
+            recorder2.clipRect(SkRect::MakeWH(100 + i, 100));
+            recorder2.drawRect(clip, SkPaint());
+        recorder2.restore();
+    }
+    SkRecordNoopRedundantState(&record2);
+    REPORTER_ASSERT(r, 0 == count_instances_of_type<SkRecords::NoOp>(record2));
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDraws, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint opaque;
+    SkPaint translucent;
+    translucent.setAlpha(0x80);
+
+    recorder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20), opaque);         // Occluded.
+    recorder.drawRect(SkRect::MakeLTRB(0, 0, 100, 100), opaque);         // Pokes out the edge.
+    recorder.drawRect(SkRect::MakeLTRB(30, 30, 40, 40), translucent);    // Occluded.
+    recorder.drawRect(SkRect::MakeLTRB(25, 25, 45, 45), translucent);    // Doesn't occlude.
+    recorder.drawRect(SkRect::MakeLTRB(35, 35, 38, 38), opaque);
+    recorder.drawRect(SkRect::MakeLTRB(0, 0, 99, 99), opaque);
+
+    SkRecordNoopOccludedDraws(&record);
+
+    assert_type<SkRecords::NoOp>(r, record, 0);
+    assert_type<SkRecords::DrawRect>(r, record, 1);
+    assert_type<SkRecords::NoOp>(r, record, 2);
+    assert_type<SkRecords::NoOp>(r, record, 3);
+    assert_type<SkRecords::NoOp>(r, record, 4);
+    assert_type<SkRecords::DrawRect>(r, record, 5);
+
+    // Nothing covers the last rect here, so the translucent rect can't hide what's under it.
+    SkRecord record1;
+    SkRecorder recorder1(&record1, W, H);
+    recorder1.drawRect(SkRect::MakeLTRB(30, 30, 40, 40), opaque);
+    recorder1.drawRect(SkRect::MakeLTRB(25, 25, 45, 45), translucent);
+    SkRecordNoopOccludedDraws(&record1);
+    assert_type<SkRecords::DrawRect>(r, record1, 0);
+
+    // An opaque draw inside a layer can't occlude anything.
+    SkRecord record2;
+    SkRecorder recorder2(&record2, W, H);
+    recorder2.drawRect(SkRect::MakeLTRB(10, 10, 20, 20), SkPaint());
+    recorder2.saveLayer(nullptr, nullptr);
+        recorder2.drawRect(SkRect::MakeLTRB(0, 0, 99, 99), opaque);
+    recorder2.restore();
+    SkRecordNoopOccludedDraws(&record2);
+    assert_type<SkRecords::DrawRect>(r, record2, 0);
+}
@@ -242,3 +242,48 @@ DEF_TEST(Color4f_xfermode_proc4f, reporter) {
         REPORTER_ASSERT(reporter, compare_procs(proc32, proc4f));
     }
 }
+
+// Check that our D32Procs (some of which are specialized in SkOpts) agree with Proc4f.
+//
+DEF_TEST(Color4f_xfermode_d32proc, reporter) {
+    const float kTolerance = 2.0f / 255;
+
+    const SkColor colors[] = {
+        0, 0xFF000000, 0xFFFFFFFF, 0x80FF0000, 0x4020C0FF
+    };
+    const SkAlpha coverage[] = { 0, 0x80, 0xFF };
+
+    for (int mode = SkXfermode::kClear_Mode; mode <= SkXfermode::kLastMode; ++mode) {
+        SkAutoTUnref<SkXfermode> xfer(SkXfermode::Create((SkXfermode::Mode)mode));
+        SkXfermodeProc4f proc4f = SkXfermode::GetProc4f((SkXfermode::Mode)mode);
+        SkXfermode::D32Proc proc1 = SkXfermode::GetD32Proc(xfer,
+                                                           SkXfermode::kSrcIsSingle_D32Flag);
+        SkXfermode::D32Proc procN = SkXfermode::GetD32Proc(xfer, 0);
+
+        for (auto s32 : colors) {
+            SkPM4f s_pm4f = SkPM4f::FromPMColor(SkPreMultiplyColor(s32));
+            for (auto d32 : colors) {
+                SkPMColor d_pm32 = SkPreMultiplyColor(d32);
+                SkPM4f    d_pm4f = SkPM4f::FromPMColor(d_pm32);
+                SkPM4f    r_pm4f = proc4f(s_pm4f, d_pm4f);
+
+                for (auto aa : coverage) {
+                    SkPM4f expected;
+                    for (int i = 0; i < 4; ++i) {
+                        expected.fVec[i] = d_pm4f.fVec[i] +
+                                           (r_pm4f.fVec[i] - d_pm4f.fVec[i]) * aa * (1/255.0f);
+                    }
+
+                    SkPMColor dst1 = d_pm32,
+                              dstN = d_pm32;
+                    proc1(xfer, &dst1, &s_pm4f, 1, &aa);
+                    procN(xfer, &dstN, &s_pm4f, 1, &aa);
+                    REPORTER_ASSERT(reporter, nearly_equal(SkPM4f::FromPMColor(dst1), expected,
+                                                           kTolerance));
+                    REPORTER_ASSERT(reporter, nearly_equal(SkPM4f::FromPMColor(dstN), expected,
+                                                           kTolerance));
+                }
+            }
+        }
+    }
+}
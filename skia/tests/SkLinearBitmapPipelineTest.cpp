@@ -6,6 +6,8 @@
  */
 
 #include "SkLinearBitmapPipeline.h"
+#include "SkBitmapProcShader.h"
+#include "SkCanvas.h"
 #include "SkColor.h"
 #include "SkPM4f.h"
 #include "Test.h"
@@ -56,3 +58,137 @@ DEF_TEST(SkBitmapFP, reporter) {
     delete [] FPbuffer;
 }
 
+
+DEF_TEST(SkBitmapFP_Tiling, reporter) {
+    const int width = 10;
+    const int height = 10;
+    uint32_t bitmap[width * height];
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            bitmap[y * width + x] = (y << 8) + x + (255u<<24);
+        }
+    }
+    const SkImageInfo info =
+        SkImageInfo::MakeN32Premul(width, height, kLinear_SkColorProfileType);
+    SkPixmap srcPixmap{info, bitmap, static_cast<size_t>(4 * width)};
+
+    auto expected_x = [](SkShader::TileMode mode, int x) {
+        switch (mode) {
+            case SkShader::kClamp_TileMode:  return SkTPin(x, 0, width - 1);
+            case SkShader::kRepeat_TileMode: return ((x % width) + width) % width;
+            case SkShader::kMirror_TileMode: {
+                int t = ((x % (2 * width)) + 2 * width) % (2 * width);
+                return t < width ? t : 2 * width - 1 - t;
+            }
+            default:                         return 0;
+        }
+    };
+
+    const SkShader::TileMode modes[] = {
+        SkShader::kClamp_TileMode, SkShader::kRepeat_TileMode, SkShader::kMirror_TileMode };
+    for (SkShader::TileMode xMode : modes) {
+        for (SkShader::TileMode yMode : modes) {
+            SkLinearBitmapPipeline pipeline{SkMatrix::I(), kNone_SkFilterQuality, xMode, yMode,
+                                            srcPixmap};
+            const int count = 35;
+            SkPM4f FPbuffer[count];
+            const int y = 13;
+            pipeline.shadeSpan4f(-12, y, FPbuffer, count);
+            for (int i = 0; i < count; i++) {
+                // The low byte holds x and the next one y, whatever the channel order.
+                REPORTER_ASSERT(reporter, SkScalarRoundToInt(FPbuffer[i].fVec[0] * 255.0f)
+                                          == expected_x(xMode, i - 12));
+                REPORTER_ASSERT(reporter, SkScalarRoundToInt(FPbuffer[i].fVec[1] * 255.0f)
+                                          == expected_x(yMode, y));
+            }
+        }
+    }
+}
+
+DEF_TEST(SkBitmapFP_Gray8, reporter) {
+    uint8_t gray[4] = { 0, 51, 102, 255 };
+    const SkImageInfo info = SkImageInfo::Make(4, 1, kGray_8_SkColorType, kOpaque_SkAlphaType);
+    SkPixmap srcPixmap{info, gray, 4};
+
+    SkLinearBitmapPipeline pipeline{SkMatrix::I(), kNone_SkFilterQuality,
+                                    SkShader::kClamp_TileMode, SkShader::kClamp_TileMode,
+                                    srcPixmap};
+    SkPM4f FPbuffer[4];
+    pipeline.shadeSpan4f(0, 0, FPbuffer, 4);
+    for (int i = 0; i < 4; i++) {
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(FPbuffer[i].fVec[0], gray[i] / 255.0f));
+        REPORTER_ASSERT(reporter, FPbuffer[i].a() == 1.0f);
+    }
+}
+
+DEF_TEST(SkBitmapFP_FilterQuality, reporter) {
+    REPORTER_ASSERT(reporter, SkLinearBitmapPipeline::SupportsFilterQuality(kNone_SkFilterQuality));
+    REPORTER_ASSERT(reporter, SkLinearBitmapPipeline::SupportsFilterQuality(kLow_SkFilterQuality));
+    REPORTER_ASSERT(reporter,
+                    !SkLinearBitmapPipeline::SupportsFilterQuality(kMedium_SkFilterQuality));
+    REPORTER_ASSERT(reporter,
+                    !SkLinearBitmapPipeline::SupportsFilterQuality(kHigh_SkFilterQuality));
+}
+
+static void draw_bitmap_shader(const SkBitmap& src, SkShader::TileMode xMode,
+                               SkShader::TileMode yMode, SkFilterQuality quality,
+                               bool usePipeline, SkBitmap* dst) {
+    // An F16 destination makes the blitter ask the shader for PM4f spans.
+    dst->allocPixels(SkImageInfo::Make(40, 40, kRGBA_F16_SkColorType, kPremul_SkAlphaType));
+    dst->eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(*dst);
+    canvas.translate(3, 5);
+    canvas.scale(2, 2);
+
+    SkPaint paint;
+    SkAutoTUnref<SkShader> shader(SkShader::CreateBitmapShader(src, xMode, yMode));
+    paint.setShader(shader);
+    paint.setFilterQuality(quality);
+    const bool useLinearBitmapPipeline = gSkUseLinearBitmapPipeline;
+    gSkUseLinearBitmapPipeline = usePipeline;
+    canvas.drawRect(SkRect::MakeXYWH(-6, -6, 30, 30), paint);
+    gSkUseLinearBitmapPipeline = useLinearBitmapPipeline;
+}
+
+// Drawing a bitmap shader through SkBitmapProcShader gives the same pixels whether it shades
+// with SkLinearBitmapPipeline or with the SkBitmapProcState procs.
+DEF_TEST(SkBitmapFP_BitmapShader, reporter) {
+    SkBitmap src;
+    src.allocPixels(SkImageInfo::MakeN32Premul(7, 5, kLinear_SkColorProfileType));
+    for (int y = 0; y < src.height(); y++) {
+        for (int x = 0; x < src.width(); x++) {
+            *src.getAddr32(x, y) = SkPackARGB32(255, x * 36, y * 60, 128);
+        }
+    }
+    src.setImmutable();
+
+    const SkShader::TileMode modes[] = {
+        SkShader::kClamp_TileMode, SkShader::kRepeat_TileMode, SkShader::kMirror_TileMode };
+    const SkFilterQuality qualities[] = { kNone_SkFilterQuality, kLow_SkFilterQuality };
+    for (SkShader::TileMode xMode : modes) {
+        for (SkShader::TileMode yMode : modes) {
+            for (SkFilterQuality quality : qualities) {
+                SkBitmap procs, pipeline;
+                draw_bitmap_shader(src, xMode, yMode, quality, false, &procs);
+                draw_bitmap_shader(src, xMode, yMode, quality, true, &pipeline);
+                // The procs bilerp with 4 bit weights and 8 bit results, the pipeline in float.
+                const float tolerance = (kNone_SkFilterQuality == quality ? 1 : 3) / 255.0f;
+                int mismatches = 0;
+                for (int y = 0; y < procs.height(); y++) {
+                    for (int x = 0; x < procs.width(); x++) {
+                        SkPM4f a = SkPM4f::FromF16((const uint16_t*)procs.getAddr(x, y));
+                        SkPM4f b = SkPM4f::FromF16((const uint16_t*)pipeline.getAddr(x, y));
+                        for (int i = 0; i < 4; i++) {
+                            if (SkScalarAbs(a.fVec[i] - b.fVec[i]) > tolerance) {
+                                mismatches++;
+                                break;
+                            }
+                        }
+                    }
+                }
+                REPORTER_ASSERT_MESSAGE(reporter, 0 == mismatches,
+                                        "linear pipeline differs from SkBitmapProcState");
+            }
+        }
+    }
+}
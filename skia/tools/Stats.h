@@ -21,7 +21,7 @@ struct Stats {
     Stats(const SkTArray<double>& samples) {
         int n = samples.count();
         if (!n) {
-            min = max = mean = var = median = 0;
+            min = max = mean = var = median = p90 = p99 = 0;
             return;
         }
 
@@ -48,6 +48,8 @@ struct Stats {
         memcpy(sorted.get(), samples.begin(), n * sizeof(double));
         SkTQSort(sorted.get(), sorted.get() + n - 1);
         median = sorted[n/2];
+        p90 = Percentile(sorted.get(), n, 0.90);
+        p99 = Percentile(sorted.get(), n, 0.99);
 
         // Normalize samples to [min, max] in as many quanta as we have distinct bars to print.
         for (int i = 0; i < n; i++) {
@@ -67,11 +69,20 @@ struct Stats {
         }
     }
 
+    // Returns the smallest of the n sorted samples that is >= fraction of them.
+    static double Percentile(const double sorted[], int n, double fraction) {
+        SkASSERT(n > 0);
+        int rank = (int)ceil(fraction * n);
+        return sorted[SkTPin(rank, 1, n) - 1];
+    }
+
     double min;
     double max;
     double mean;    // Estimate of population mean.
     double var;     // Estimate of population variance.
     double median;
+    double p90;     // Nearest-rank percentiles.  With few samples these are just max.
+    double p99;
     SkString plot;  // A single-line bar chart (_not_ histogram) of the samples.
 };
 
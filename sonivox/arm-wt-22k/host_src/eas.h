@@ -168,6 +168,36 @@ EAS_PUBLIC EAS_RESULT EAS_Shutdown (EAS_DATA_HANDLE pEASData);
 */
 EAS_PUBLIC EAS_RESULT EAS_Render (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I32 numRequested, EAS_I32 *pNumGenerated);
 
+/*----------------------------------------------------------------------------
+ * EAS_RenderOffline()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Render a stream as fast as possible, e.g. to convert it to a file.
+ * Mix buffers are rendered back to back into pOut until it is full or
+ * the stream has stopped. The parser workload limit (EAS_SetMaxLoad) and
+ * EAS_HWYield are ignored, so every event is parsed in its own frame.
+ *
+ * With the dynamic memory model every EAS_DATA_HANDLE from EAS_Init is
+ * independent, so several files can be converted in parallel with one
+ * instance per thread. The static memory model supports one instance.
+ *
+ * Inputs:
+ *  pEASData        - handle to data for this instance
+ *  pStream         - stream to render until it stops
+ *  pOut            - output buffer pointer
+ *  numRequested    - room in pOut in samples per channel, only whole
+ *                    mix buffers are rendered
+ *  pNumGenerated   - actual number of samples generated
+ *
+ * Outputs:
+ *  EAS_SUCCESS if PCM data was successfully rendered
+ *
+ * Notes:
+ *  Fewer samples than fit in pOut means the stream has stopped.
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_RenderOffline (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream, EAS_PCM *pOut, EAS_I32 numRequested, EAS_I32 *pNumGenerated);
+
 /*----------------------------------------------------------------------------
  * EAS_SetRepeat()
  *----------------------------------------------------------------------------
@@ -75,12 +75,9 @@ static EAS_RESULT PlayFile (EAS_DATA_HANDLE easData, const char* filename, const
     EAS_HANDLE handle;
     EAS_RESULT result, reportResult;
     EAS_I32 count;
-    EAS_STATE state;
     EAS_I32 playTime;
     char waveFilename[256];
     WAVE_FILE *wFile;
-    EAS_INT i;
-    EAS_PCM *p;
     EAS_FILE file;
 
     /* determine the name of the output file */
@@ -131,56 +128,29 @@ static EAS_RESULT PlayFile (EAS_DATA_HANDLE easData, const char* filename, const
         }
     }
 
-    /* rendering loop */
+    /* rendering loop, no real-time pacing needed when writing a file */
     while (reportResult == EAS_SUCCESS)
     {
 
-        /* we may render several buffers here to fill one host buffer */
-        for (i = 0, p = buffer; i < NUM_BUFFERS; i++, p+= pLibConfig->mixBufferSize * pLibConfig->numChannels)
+        /* render as many buffers as fit in one host buffer */
+        if ((result = EAS_RenderOffline(easData, handle, buffer, pLibConfig->mixBufferSize * NUM_BUFFERS, &count)) != EAS_SUCCESS)
         {
-
-            /* get the current time */
-            if ((result = EAS_GetLocation(easData, handle, &playTime)) != EAS_SUCCESS)
-            {
-                { /* dpp: EAS_ReportEx(_EAS_SEVERITY_ERROR, "EAS_GetLocation returned %d\n",result); */ }
-                if (reportResult == EAS_SUCCESS)
-                    reportResult = result;
-                break;
-            }
-            { /* dpp: EAS_ReportEx(_EAS_SEVERITY_DETAIL, "Parser time: %d.%03d\n", playTime / 1000, playTime % 1000); */ }
-
-            /* render a buffer of audio */
-            if ((result = EAS_Render(easData, p, pLibConfig->mixBufferSize, &count)) != EAS_SUCCESS)
-            {
-                { /* dpp: EAS_ReportEx(_EAS_SEVERITY_ERROR, "EAS_Render returned %d\n",result); */ }
-                if (reportResult == EAS_SUCCESS)
-                    reportResult = result;
-            }
+            { /* dpp: EAS_ReportEx(_EAS_SEVERITY_ERROR, "EAS_RenderOffline returned %d\n",result); */ }
+            reportResult = result;
+            break;
         }
 
-        if (result == EAS_SUCCESS)
+        /* write it to the wave file */
+        bufferSize = count * pLibConfig->numChannels * (EAS_I32) sizeof(EAS_PCM);
+        if (WaveFileWrite(wFile, buffer, bufferSize) != bufferSize)
         {
-            /* write it to the wave file */
-            if (WaveFileWrite(wFile, buffer, bufferSize) != bufferSize)
-            {
-                { /* dpp: EAS_ReportEx(_EAS_SEVERITY_ERROR, "WaveFileWrite failed\n"); */ }
-                reportResult = EAS_FAILURE;
-            }
+            { /* dpp: EAS_ReportEx(_EAS_SEVERITY_ERROR, "WaveFileWrite failed\n"); */ }
+            reportResult = EAS_FAILURE;
         }
 
-        if (reportResult == EAS_SUCCESS)
-        {
-            /* check stream state */
-            if ((result = EAS_State(easData, handle, &state)) != EAS_SUCCESS)
-            {
-                { /* dpp: EAS_ReportEx(_EAS_SEVERITY_ERROR, "EAS_State returned %d\n", result); */ }
-                reportResult = result;
-            }
-
-            /* is playback complete */
-            if ((state == EAS_STATE_STOPPED) || (state == EAS_STATE_ERROR))
-                break;
-        }
+        /* a short buffer means playback is complete */
+        if (count < pLibConfig->mixBufferSize * NUM_BUFFERS)
+            break;
     }
 
     /* close the output file */
@@ -66,6 +66,18 @@ typedef struct s_jet_event_tag
     EAS_U8      value;
 } S_JET_EVENT;
 
+/* latencies are counted in mix buffers (S_EAS_LIB_CONFIG.mixBufferSize) */
+typedef struct s_jet_stats_tag
+{
+    EAS_U32     commandsQueued;     /* clip and mute commands accepted */
+    EAS_U32     commandsDropped;    /* commands refused, command queue full */
+    EAS_U32     clipsDropped;       /* clip triggers lost, clip queue full */
+    EAS_U32     mutesDropped;       /* mute commands lost, no open segment */
+    EAS_U32     maxCommandDelay;    /* worst delay from call to render thread */
+    EAS_U32     lastClipLatency;    /* delay from trigger to clip start */
+    EAS_U32     maxClipLatency;
+} S_JET_STATS;
+
 /*----------------------------------------------------------------------------
  * JET_Init()
  *----------------------------------------------------------------------------
@@ -118,10 +130,21 @@ EAS_PUBLIC EAS_RESULT JET_CloseFile (EAS_DATA_HANDLE easHandle);
 */
 EAS_PUBLIC EAS_RESULT JET_Status (EAS_DATA_HANDLE easHandle, S_JET_STATUS *pStatus);
 
+/*----------------------------------------------------------------------------
+ * JET_GetStats()
+ *----------------------------------------------------------------------------
+ * Returns command queue and clip trigger latency counters. Like
+ * JET_GetEvent, this may be called while another thread renders.
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT JET_GetStats (EAS_DATA_HANDLE easHandle, S_JET_STATS *pStats);
+
 /*----------------------------------------------------------------------------
  * JET_GetEvent()
  *----------------------------------------------------------------------------
- * Checks for application events
+ * Checks for application events. The event queue has a single reader
+ * and a single writer, so one application thread may poll it without
+ * holding the lock that serializes EAS_Render.
  *----------------------------------------------------------------------------
 */
 EAS_PUBLIC EAS_BOOL JET_GetEvent (EAS_DATA_HANDLE easHandle, EAS_U32 *pEventRaw, S_JET_EVENT *pEvent);
@@ -162,6 +185,17 @@ EAS_PUBLIC EAS_RESULT JET_Pause (EAS_DATA_HANDLE easHandle);
  * JET_SetMuteFlags()
  *----------------------------------------------------------------------------
  * Change the state of the mute flags
+ *
+ * JET_SetMuteFlags, JET_SetMuteFlag and JET_TriggerClip only post a
+ * command to a lock-free queue that the render thread drains at the
+ * start of every mix buffer, so one application thread may call them
+ * while another renders. All other JET calls must still be serialized
+ * with EAS_Render.
+ *
+ * They return EAS_SUCCESS once the command is queued, or
+ * EAS_ERROR_QUEUE_IS_FULL. Whether a segment is open to take a mute is
+ * only known on the render thread; if none is, the command is dropped
+ * and counted in S_JET_STATS.mutesDropped.
  *----------------------------------------------------------------------------
 */
 EAS_PUBLIC EAS_RESULT JET_SetMuteFlags (EAS_DATA_HANDLE easHandle, EAS_U32 muteFlags, EAS_BOOL sync);
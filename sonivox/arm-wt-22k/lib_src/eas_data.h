@@ -127,6 +127,7 @@ typedef struct s_eas_data_tag
     EAS_U8                          masterVolume;
     EAS_BOOL8                       staticMemoryModel;
     EAS_BOOL8                       searchHeaderFlag;
+    EAS_BOOL8                       offlineRender;
 } S_EAS_DATA;
 
 #endif
@@ -892,6 +892,11 @@ EAS_PUBLIC EAS_RESULT EAS_Render (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I
     /* save the output buffer pointer */
     pEASData->pOutputAudioBuffer = pOut;
 
+#ifdef JET_INTERFACE
+    /* apply clip and mute commands before parsing this frame */
+    if (pEASData->jetHandle != NULL)
+        JET_ProcessCommands(pEASData);
+#endif
 
 #ifdef _METRICS_ENABLED
         /* start performance counter */
@@ -1095,6 +1100,61 @@ EAS_PUBLIC EAS_RESULT EAS_Render (EAS_DATA_HANDLE pEASData, EAS_PCM *pOut, EAS_I
     return EAS_SUCCESS;
 }
 
+/*----------------------------------------------------------------------------
+ * EAS_RenderOffline()
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Render a stream as fast as possible, e.g. to convert it to a file.
+ * Mix buffers are rendered back to back into pOut until it is full or
+ * the stream has stopped. The parser workload limit (EAS_SetMaxLoad) and
+ * EAS_HWYield are ignored, so every event is parsed in its own frame.
+ *
+ * Inputs:
+ *  pEASData        - handle to data for this instance
+ *  pStream         - stream to render until it stops
+ *  pOut            - output buffer pointer
+ *  numRequested    - room in pOut in samples per channel, only whole
+ *                    mix buffers are rendered
+ *  pNumGenerated   - actual number of samples generated
+ *
+ * Outputs:
+ *  EAS_SUCCESS if PCM data was successfully rendered
+ *
+ * Notes:
+ *  Fewer samples than fit in pOut means the stream has stopped.
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT EAS_RenderOffline (EAS_DATA_HANDLE pEASData, EAS_HANDLE pStream, EAS_PCM *pOut, EAS_I32 numRequested, EAS_I32 *pNumGenerated)
+{
+    EAS_RESULT result;
+    EAS_STATE state;
+    EAS_I32 count;
+
+    *pNumGenerated = 0;
+    if (pStream->pParserModule == NULL)
+        return EAS_ERROR_PARAMETER_RANGE;
+
+    result = EAS_SUCCESS;
+    pEASData->offlineRender = EAS_TRUE;
+    while (numRequested - *pNumGenerated >= BUFFER_SIZE_IN_MONO_SAMPLES)
+    {
+        /* is playback complete */
+        if ((result = EAS_State(pEASData, pStream, &state)) != EAS_SUCCESS)
+            break;
+        if ((state == EAS_STATE_STOPPED) || (state == EAS_STATE_ERROR))
+            break;
+
+        /* render a buffer of audio */
+        if ((result = EAS_Render(pEASData, pOut, BUFFER_SIZE_IN_MONO_SAMPLES, &count)) != EAS_SUCCESS)
+            break;
+        pOut += count * NUM_OUTPUT_CHANNELS;
+        *pNumGenerated += count;
+    }
+    pEASData->offlineRender = EAS_FALSE;
+
+    return result;
+}
+
 /*----------------------------------------------------------------------------
  * EAS_SetRepeat()
  *----------------------------------------------------------------------------
@@ -1305,8 +1365,8 @@ static EAS_RESULT EAS_ParseEvents (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS
             }
         }
 
-        /* check for max workload exceeded */
-        if (VMCheckWorkload(pEASData->pVoiceMgr))
+        /* check for max workload exceeded, offline rendering has no deadline */
+        if (!pEASData->offlineRender && VMCheckWorkload(pEASData->pVoiceMgr))
         {
             /* stop even though we may not have parsed
              * all the events in this frame. The parser will try to
@@ -1316,7 +1376,7 @@ static EAS_RESULT EAS_ParseEvents (S_EAS_DATA *pEASData, EAS_HANDLE pStream, EAS
         }
 
         /* give host a chance for an early abort */
-        if (--yieldCount == 0)
+        if (!pEASData->offlineRender && (--yieldCount == 0))
         {
             if (EAS_HWYield(pEASData->hwInstData))
                 break;
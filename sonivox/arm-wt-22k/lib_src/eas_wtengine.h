@@ -41,6 +41,13 @@
 
 #include "eas_wt_IPC_frame.h"
 
+/* hosts without the ARMv5E assembly use the SSE4.1/NEON interpolators and
+   voice gain in eas_wtengine_simd.c instead of the C versions */
+#if !defined(NATIVE_EAS_KERNEL) && !defined(_OPTIMIZED_MONO) && !defined(EAS_NO_SIMD_KERNEL) && \
+    (defined(__SSE4_1__) || defined(__aarch64__))
+#define EAS_SIMD_KERNEL
+#endif
+
 /*----------------------------------------------------------------------------
  * defines
  *----------------------------------------------------------------------------
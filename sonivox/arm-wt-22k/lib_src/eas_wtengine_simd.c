@@ -0,0 +1,453 @@
+/*----------------------------------------------------------------------------
+ *
+ * File:
+ * eas_wtengine_simd.c
+ *
+ * Contents and purpose:
+ * SSE4.1 and NEON versions of the wavetable interpolators and voice gain
+ * for hosts that cannot use the ARMv5E assembly. Four output samples are
+ * computed at a time and the results match the C versions in
+ * eas_wtengine.c exactly. The voice filter is recursive and stays in C.
+ *
+ * Copyright (C) 2026 The Android Open Source Project
+
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *----------------------------------------------------------------------------
+*/
+
+/*------------------------------------
+ * includes
+ *------------------------------------
+*/
+#include "log/log.h"
+#include <cutils/log.h>
+
+#include "eas_types.h"
+#include "eas_math.h"
+#include "eas_audioconst.h"
+#include "eas_sndlib.h"
+#include "eas_wtengine.h"
+#include "eas_mixer.h"
+
+#ifdef EAS_SIMD_KERNEL
+
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#else
+#include <arm_neon.h>
+#endif
+
+/*----------------------------------------------------------------------------
+ * prototypes
+ *----------------------------------------------------------------------------
+*/
+extern void WT_VoiceGain (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame);
+extern void WT_InterpolateNoLoop (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame);
+extern void WT_Interpolate (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame);
+
+#if defined(_8_BIT_SAMPLES)
+#define WT_SAMPLE(p, n) ((EAS_I32) (p)[n] << 8)
+#else
+#define WT_SAMPLE(p, n) ((EAS_I32) (p)[n])
+#endif
+
+/* number of samples in the 16-byte window the four interpolated samples are gathered from */
+#define WT_WINDOW_SAMPLES   (16 / (EAS_I32) sizeof(EAS_SAMPLE))
+
+/*----------------------------------------------------------------------------
+ * WT_Interpolate4
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Linear interpolation of the next four output samples. All the samples
+ * they need are loaded at once and picked out with a byte shuffle, so
+ * the caller makes sure that the last sample pair starts below
+ * WT_WINDOW_SAMPLES - 1, that the window does not extend past the last
+ * sample and that the loop end is not crossed in between.
+ *
+ * Inputs:
+ * pSamples         - current sample
+ * phaseFrac        - fractional phase of the current sample
+ * phaseInc         - phase increment per output sample
+ *
+ * Outputs:
+ * pOutputBuffer    - four interpolated samples
+ *
+ *----------------------------------------------------------------------------
+*/
+static inline void WT_Interpolate4 (const EAS_SAMPLE *pSamples, EAS_I32 phaseFrac, EAS_I32 phaseInc, EAS_PCM *pOutputBuffer)
+{
+#if defined(__SSE4_1__)
+    __m128i phase = _mm_add_epi32(_mm_set1_epi32((int) phaseFrac), _mm_mullo_epi32(_mm_set1_epi32((int) phaseInc), _mm_setr_epi32(0, 1, 2, 3)));
+    __m128i offset = _mm_srli_epi32(phase, NUM_PHASE_FRAC_BITS);
+    __m128i frac = _mm_and_si128(phase, _mm_set1_epi32(PHASE_FRAC_MASK));
+    __m128i window = _mm_loadu_si128((const __m128i*) pSamples);
+    __m128i index, samp1, samp2, acc;
+
+#if defined(_8_BIT_SAMPLES)
+    /* byte n picks sample offset[n] */
+    index = _mm_shuffle_epi8(offset, _mm_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1));
+    samp1 = _mm_slli_epi32(_mm_cvtepi8_epi32(_mm_shuffle_epi8(window, index)), 8);
+    samp2 = _mm_slli_epi32(_mm_cvtepi8_epi32(_mm_shuffle_epi8(window, _mm_add_epi8(index, _mm_set1_epi8(1)))), 8);
+#else
+    /* bytes 2n and 2n+1 pick sample offset[n] */
+    index = _mm_shuffle_epi8(_mm_add_epi32(offset, offset), _mm_setr_epi8(0, 0, 4, 4, 8, 8, 12, 12, -1, -1, -1, -1, -1, -1, -1, -1));
+    index = _mm_add_epi8(index, _mm_setr_epi8(0, 1, 0, 1, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0));
+    samp1 = _mm_cvtepi16_epi32(_mm_shuffle_epi8(window, index));
+    samp2 = _mm_cvtepi16_epi32(_mm_shuffle_epi8(window, _mm_add_epi8(index, _mm_set1_epi8(2))));
+#endif
+
+    /* linear interpolation */
+    acc = _mm_mullo_epi32(_mm_sub_epi32(samp2, samp1), frac);
+    acc = _mm_add_epi32(samp1, _mm_srai_epi32(acc, NUM_PHASE_FRAC_BITS));
+    acc = _mm_srai_epi32(acc, 2);
+    _mm_storel_epi64((__m128i*) pOutputBuffer, _mm_packs_epi32(acc, acc));
+#else
+    static const uint32_t ramp[4] = { 0, 1, 2, 3 };
+    uint32x4_t phase = vmlaq_u32(vdupq_n_u32((uint32_t) phaseFrac), vdupq_n_u32((uint32_t) phaseInc), vld1q_u32(ramp));
+    uint16x4_t offset = vmovn_u32(vshrq_n_u32(phase, NUM_PHASE_FRAC_BITS));
+    int32x4_t frac = vreinterpretq_s32_u32(vandq_u32(phase, vdupq_n_u32(PHASE_FRAC_MASK)));
+    uint8x16_t window = vld1q_u8((const uint8_t*) pSamples);
+    uint8x8_t index;
+    int32x4_t samp1, samp2, acc;
+
+#if defined(_8_BIT_SAMPLES)
+    /* byte n picks sample offset[n] */
+    index = vmovn_u16(vcombine_u16(offset, offset));
+    samp1 = vshlq_n_s32(vmovl_s16(vget_low_s16(vmovl_s8(vreinterpret_s8_u8(vqtbl1_u8(window, index))))), 8);
+    samp2 = vshlq_n_s32(vmovl_s16(vget_low_s16(vmovl_s8(vreinterpret_s8_u8(vqtbl1_u8(window, vadd_u8(index, vdup_n_u8(1))))))), 8);
+#else
+    /* bytes 2n and 2n+1 pick sample offset[n] */
+    offset = vadd_u16(offset, offset);
+    index = vreinterpret_u8_u16(vorr_u16(offset, vshl_n_u16(vadd_u16(offset, vdup_n_u16(1)), 8)));
+    samp1 = vmovl_s16(vreinterpret_s16_u8(vqtbl1_u8(window, index)));
+    samp2 = vmovl_s16(vreinterpret_s16_u8(vqtbl1_u8(window, vadd_u8(index, vdup_n_u8(2)))));
+#endif
+
+    /* linear interpolation */
+    acc = vmulq_s32(vsubq_s32(samp2, samp1), frac);
+    acc = vaddq_s32(samp1, vshrq_n_s32(acc, NUM_PHASE_FRAC_BITS));
+    vst1_s16(pOutputBuffer, vmovn_s32(vshrq_n_s32(acc, 2)));
+#endif
+}
+
+/*----------------------------------------------------------------------------
+ * WT_VoiceGain
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Output gain for individual voice
+ *
+ * Inputs:
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+/*lint -esym(715, pWTVoice) reserved for future use */
+void WT_VoiceGain (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
+{
+    EAS_I32 *pMixBuffer;
+    EAS_PCM *pInputBuffer;
+    EAS_I32 gain;
+    EAS_I32 gainIncrement;
+    EAS_I32 tmp0;
+    EAS_I32 tmp2;
+    EAS_I32 numSamples;
+    EAS_INT i;
+
+    /* one 32-bit mix contribution per output sample and channel */
+    int32_t mix[4 * NUM_OUTPUT_CHANNELS];
+
+#if (NUM_OUTPUT_CHANNELS == 2)
+    EAS_I32 gainLeft, gainRight;
+#endif
+
+    /* initialize some local variables */
+    numSamples = pWTIntFrame->numSamples;
+    if (numSamples <= 0) {
+        ALOGE("b/26366256");
+        android_errorWriteLog(0x534e4554, "26366256");
+        return;
+    }
+    pMixBuffer = pWTIntFrame->pMixBuffer;
+    pInputBuffer = pWTIntFrame->pAudioBuffer;
+
+    /*lint -e{703} <avoid multiply for performance>*/
+    gainIncrement = (pWTIntFrame->frame.gainTarget - pWTIntFrame->prevGain) << (16 - SYNTH_UPDATE_PERIOD_IN_BITS);
+    if (gainIncrement < 0)
+        gainIncrement++;
+    /*lint -e{703} <avoid multiply for performance>*/
+    gain = pWTIntFrame->prevGain << 16;
+
+#if (NUM_OUTPUT_CHANNELS == 2)
+    gainLeft = pWTVoice->gainLeft;
+    gainRight = pWTVoice->gainRight;
+#endif
+
+    /* four samples at a time, the gain ramp stays within 32 bits */
+    while (numSamples >= 4)
+    {
+#if defined(__SSE4_1__)
+        __m128i g = _mm_add_epi32(_mm_set1_epi32((int) gain), _mm_mullo_epi32(_mm_set1_epi32((int) gainIncrement), _mm_setr_epi32(1, 2, 3, 4)));
+        __m128i x = _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i*) pInputBuffer));
+        x = _mm_mullo_epi32(_mm_srai_epi32(g, 16), x);
+#if (NUM_OUTPUT_CHANNELS == 2)
+        {
+            __m128i left, right;
+            x = _mm_srai_epi32(x, 14);
+            left = _mm_srai_epi32(_mm_mullo_epi32(x, _mm_set1_epi32((int) gainLeft)), NUM_MIXER_GUARD_BITS);
+            right = _mm_srai_epi32(_mm_mullo_epi32(x, _mm_set1_epi32((int) gainRight)), NUM_MIXER_GUARD_BITS);
+            _mm_storeu_si128((__m128i*) &mix[0], _mm_unpacklo_epi32(left, right));
+            _mm_storeu_si128((__m128i*) &mix[4], _mm_unpackhi_epi32(left, right));
+        }
+#else
+        _mm_storeu_si128((__m128i*) mix, _mm_srai_epi32(x, NUM_MIXER_GUARD_BITS - 1));
+#endif
+#else
+        static const int32_t ramp[4] = { 1, 2, 3, 4 };
+        int32x4_t g = vmlaq_s32(vdupq_n_s32((int32_t) gain), vdupq_n_s32((int32_t) gainIncrement), vld1q_s32(ramp));
+        int32x4_t x = vmulq_s32(vshrq_n_s32(g, 16), vmovl_s16(vld1_s16(pInputBuffer)));
+#if (NUM_OUTPUT_CHANNELS == 2)
+        {
+            int32x4x2_t out;
+            x = vshrq_n_s32(x, 14);
+            out.val[0] = vshrq_n_s32(vmulq_n_s32(x, (int32_t) gainLeft), NUM_MIXER_GUARD_BITS);
+            out.val[1] = vshrq_n_s32(vmulq_n_s32(x, (int32_t) gainRight), NUM_MIXER_GUARD_BITS);
+            vst2q_s32(mix, out);
+        }
+#else
+        vst1q_s32(mix, vshrq_n_s32(x, NUM_MIXER_GUARD_BITS - 1));
+#endif
+#endif
+
+        /* accumulate into the final mix buffer, which has 64-bit entries on LP64 hosts */
+        if (sizeof(EAS_I32) == sizeof(int64_t))
+        {
+            for (i = 0; i < 4 * NUM_OUTPUT_CHANNELS; i += 2)
+            {
+#if defined(__SSE4_1__)
+                __m128i m = _mm_cvtepi32_epi64(_mm_loadl_epi64((const __m128i*) &mix[i]));
+                _mm_storeu_si128((__m128i*) &pMixBuffer[i], _mm_add_epi64(_mm_loadu_si128((const __m128i*) &pMixBuffer[i]), m));
+#else
+                vst1q_s64((int64_t*) &pMixBuffer[i], vaddw_s32(vld1q_s64((const int64_t*) &pMixBuffer[i]), vld1_s32(&mix[i])));
+#endif
+            }
+        }
+        else
+        {
+            for (i = 0; i < 4 * NUM_OUTPUT_CHANNELS; i++)
+                pMixBuffer[i] += mix[i];
+        }
+
+        pMixBuffer += 4 * NUM_OUTPUT_CHANNELS;
+        pInputBuffer += 4;
+        gain += 4 * gainIncrement;
+        numSamples -= 4;
+    }
+
+    while (numSamples--) {
+
+        /* incremental gain step to prevent zipper noise */
+        tmp0 = *pInputBuffer++;
+        gain += gainIncrement;
+        /*lint -e{704} <avoid divide>*/
+        tmp2 = (gain >> 16) * tmp0;
+
+#if (NUM_OUTPUT_CHANNELS == 2)
+        /*lint -e{704} <avoid divide>*/
+        tmp2 = tmp2 >> 14;
+        /*lint -e{704} <avoid divide>*/
+        *pMixBuffer++ += (tmp2 * gainLeft) >> NUM_MIXER_GUARD_BITS;
+        /*lint -e{704} <avoid divide>*/
+        *pMixBuffer++ += (tmp2 * gainRight) >> NUM_MIXER_GUARD_BITS;
+#else
+        /*lint -e{704} <avoid divide>*/
+        *pMixBuffer++ += tmp2 >> (NUM_MIXER_GUARD_BITS - 1);
+#endif
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * WT_Interpolate
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Interpolation engine for wavetable synth
+ *
+ * Inputs:
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+void WT_Interpolate (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
+{
+    EAS_PCM *pOutputBuffer;
+    EAS_I32 phaseInc;
+    EAS_I32 phaseFrac;
+    EAS_I32 acc0;
+    const EAS_SAMPLE *pSamples;
+    const EAS_SAMPLE *loopEnd;
+    EAS_I32 samp1;
+    EAS_I32 samp2;
+    EAS_I32 numSamples;
+
+    /* initialize some local variables */
+    numSamples = pWTIntFrame->numSamples;
+    if (numSamples <= 0) {
+        ALOGE("b/26366256");
+        android_errorWriteLog(0x534e4554, "26366256");
+        return;
+    }
+    pOutputBuffer = pWTIntFrame->pAudioBuffer;
+
+    loopEnd = (const EAS_SAMPLE*) pWTVoice->loopEnd + 1;
+    pSamples = (const EAS_SAMPLE*) pWTVoice->phaseAccum;
+    /*lint -e{713} truncation is OK */
+    phaseFrac = pWTVoice->phaseFrac;
+    phaseInc = pWTIntFrame->frame.phaseIncrement;
+
+    while (numSamples > 0) {
+
+        /* four samples at once unless the loop end comes up in between */
+        /*lint -e{704} <avoid divide>*/
+        acc0 = (phaseFrac + 4 * phaseInc) >> NUM_PHASE_FRAC_BITS;
+        if ((numSamples >= 4) && (pSamples + acc0 < loopEnd) &&
+            (((phaseFrac + 3 * phaseInc) >> NUM_PHASE_FRAC_BITS) < WT_WINDOW_SAMPLES - 1) &&
+            (pSamples + WT_WINDOW_SAMPLES <= loopEnd)) {
+            WT_Interpolate4(pSamples, phaseFrac, phaseInc, pOutputBuffer);
+            pOutputBuffer += 4;
+            numSamples -= 4;
+            pSamples += acc0;
+            phaseFrac = (EAS_I32)((EAS_U32)(phaseFrac + 4 * phaseInc) & PHASE_FRAC_MASK);
+            continue;
+        }
+
+        /* linear interpolation */
+        samp1 = WT_SAMPLE(pSamples, 0);
+        samp2 = WT_SAMPLE(pSamples, 1);
+        acc0 = samp2 - samp1;
+        acc0 = acc0 * phaseFrac;
+        /*lint -e{704} <avoid divide>*/
+        acc0 = samp1 + (acc0 >> NUM_PHASE_FRAC_BITS);
+
+        /* save new output sample in buffer */
+        /*lint -e{704} <avoid divide>*/
+        *pOutputBuffer++ = (EAS_I16)(acc0 >> 2);
+        numSamples--;
+
+        /* increment phase */
+        phaseFrac += phaseInc;
+        /*lint -e{704} <avoid divide>*/
+        acc0 = phaseFrac >> NUM_PHASE_FRAC_BITS;
+
+        /* next sample */
+        if (acc0 > 0) {
+
+            /* advance sample pointer */
+            pSamples += acc0;
+            phaseFrac = (EAS_I32)((EAS_U32)phaseFrac & PHASE_FRAC_MASK);
+
+            /* check for loop end */
+            acc0 = (EAS_I32) (pSamples - loopEnd);
+            if (acc0 >= 0)
+                pSamples = (const EAS_SAMPLE*) pWTVoice->loopStart + acc0;
+        }
+    }
+
+    /* save pointer and phase */
+    pWTVoice->phaseAccum = (EAS_U32) pSamples;
+    pWTVoice->phaseFrac = (EAS_U32) phaseFrac;
+}
+
+/*----------------------------------------------------------------------------
+ * WT_InterpolateNoLoop
+ *----------------------------------------------------------------------------
+ * Purpose:
+ * Interpolation engine for wavetable synth
+ *
+ * Inputs:
+ *
+ * Outputs:
+ *
+ *----------------------------------------------------------------------------
+*/
+void WT_InterpolateNoLoop (S_WT_VOICE *pWTVoice, S_WT_INT_FRAME *pWTIntFrame)
+{
+    EAS_PCM *pOutputBuffer;
+    EAS_I32 phaseInc;
+    EAS_I32 phaseFrac;
+    EAS_I32 acc0;
+    const EAS_SAMPLE *pSamples;
+    const EAS_SAMPLE *sampleEnd;
+    EAS_I32 samp1;
+    EAS_I32 samp2;
+    EAS_I32 numSamples;
+
+    /* initialize some local variables */
+    numSamples = pWTIntFrame->numSamples;
+    if (numSamples <= 0) {
+        ALOGE("b/26366256");
+        android_errorWriteLog(0x534e4554, "26366256");
+        return;
+    }
+    pOutputBuffer = pWTIntFrame->pAudioBuffer;
+
+    /* loopEnd holds the last sample of unlooped waves */
+    sampleEnd = (const EAS_SAMPLE*) pWTVoice->loopEnd + 1;
+    phaseInc = pWTIntFrame->frame.phaseIncrement;
+    pSamples = (const EAS_SAMPLE*) pWTVoice->phaseAccum;
+    phaseFrac = (EAS_I32)pWTVoice->phaseFrac;
+
+    while (numSamples > 0) {
+
+        /* four samples at once while the window stays within the sample */
+        /*lint -e{704} <avoid divide>*/
+        if ((numSamples >= 4) &&
+            (((phaseFrac + 3 * phaseInc) >> NUM_PHASE_FRAC_BITS) < WT_WINDOW_SAMPLES - 1) &&
+            (pSamples + WT_WINDOW_SAMPLES <= sampleEnd)) {
+            WT_Interpolate4(pSamples, phaseFrac, phaseInc, pOutputBuffer);
+            pOutputBuffer += 4;
+            numSamples -= 4;
+            phaseFrac += 4 * phaseInc;
+            /*lint -e{704} <avoid divide>*/
+            pSamples += phaseFrac >> NUM_PHASE_FRAC_BITS;
+            phaseFrac = (EAS_I32)((EAS_U32)phaseFrac & PHASE_FRAC_MASK);
+            continue;
+        }
+
+        /* linear interpolation */
+        samp1 = WT_SAMPLE(pSamples, 0);
+        samp2 = WT_SAMPLE(pSamples, 1);
+        acc0 = samp2 - samp1;
+        acc0 = acc0 * phaseFrac;
+        /*lint -e{704} <avoid divide>*/
+        acc0 = samp1 + (acc0 >> NUM_PHASE_FRAC_BITS);
+
+        /* save new output sample in buffer */
+        /*lint -e{704} <avoid divide>*/
+        *pOutputBuffer++ = (EAS_I16)(acc0 >> 2);
+        numSamples--;
+
+        /* increment phase */
+        phaseFrac += phaseInc;
+        /*lint -e{704} <avoid divide>*/
+        pSamples += phaseFrac >> NUM_PHASE_FRAC_BITS;
+        phaseFrac = (EAS_I32)((EAS_U32)phaseFrac & PHASE_FRAC_MASK);
+    }
+
+    /* save pointer and phase */
+    pWTVoice->phaseAccum = (EAS_U32) pSamples;
+    pWTVoice->phaseFrac = (EAS_U32) phaseFrac;
+}
+
+#endif
@@ -37,6 +37,19 @@
 #include "eas_host.h"
 #include "eas_report.h"
 
+/*
+ * The application and JET event queues and the command queue each have
+ * one reader and one writer. Index updates are published with release
+ * ordering so the other side sees the entry before the new index.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define JET_LOAD_ACQUIRE(p)         __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define JET_STORE_RELEASE(p, v)     __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#else
+#define JET_LOAD_ACQUIRE(p)         (*(p))
+#define JET_STORE_RELEASE(p, v)     (*(p) = (v))
+#endif
+
 
 /* default configuration */
 static const S_JET_CONFIG jetDefaultConfig =
@@ -100,13 +113,13 @@ EAS_INLINE EAS_U8 JET_IncQueueIndex (EAS_U8 index, EAS_U8 queueSize)
  * Save event to queue
  *----------------------------------------------------------------------------
 */
-EAS_INLINE void JET_WriteQueue (EAS_U32 *pEventQueue, EAS_U8 *pWriteIndex, EAS_U8 readIndex, EAS_U8 queueSize, EAS_U32 event)
+EAS_INLINE void JET_WriteQueue (EAS_U32 *pEventQueue, EAS_U8 *pWriteIndex, EAS_U8 *pReadIndex, EAS_U8 queueSize, EAS_U32 event)
 {
     EAS_U8 temp;
 
     /* check for queue overflow */
     temp = JET_IncQueueIndex(*pWriteIndex, queueSize);
-    if (temp == readIndex)
+    if (temp == JET_LOAD_ACQUIRE(pReadIndex))
     {
         { /* dpp: EAS_ReportEx(_EAS_SEVERITY_WARNING, "JET_Event: Event queue overflow --- event ignored!\n"); */ }
         return;
@@ -114,7 +127,7 @@ EAS_INLINE void JET_WriteQueue (EAS_U32 *pEventQueue, EAS_U8 *pWriteIndex, EAS_U
 
     /* save in queue and advance write index */
     pEventQueue[*pWriteIndex] = event;
-    *pWriteIndex = temp;
+    JET_STORE_RELEASE(pWriteIndex, temp);
 }
 
 /*----------------------------------------------------------------------------
@@ -123,19 +136,50 @@ EAS_INLINE void JET_WriteQueue (EAS_U32 *pEventQueue, EAS_U8 *pWriteIndex, EAS_U
  * Read event to queue
  *----------------------------------------------------------------------------
 */
-EAS_INLINE EAS_BOOL JET_ReadQueue (EAS_U32 *pEventQueue, EAS_U8 *pReadIndex, EAS_U8 writeIndex, EAS_U8 queueSize, EAS_U32 *pEvent)
+EAS_INLINE EAS_BOOL JET_ReadQueue (EAS_U32 *pEventQueue, EAS_U8 *pReadIndex, EAS_U8 *pWriteIndex, EAS_U8 queueSize, EAS_U32 *pEvent)
 {
 
     /* check for empty queue */
-    if (*pReadIndex == writeIndex)
+    if (*pReadIndex == JET_LOAD_ACQUIRE(pWriteIndex))
         return EAS_FALSE;
 
     /* save in queue and advance write index */
     *pEvent = pEventQueue[*pReadIndex];
-    *pReadIndex = JET_IncQueueIndex(*pReadIndex, queueSize);
+    JET_STORE_RELEASE(pReadIndex, JET_IncQueueIndex(*pReadIndex, queueSize));
     return EAS_TRUE;
 }
 
+/*----------------------------------------------------------------------------
+ * JET_QueueCommand
+ *----------------------------------------------------------------------------
+ * Post a clip or mute command to the render thread
+ *----------------------------------------------------------------------------
+*/
+static EAS_RESULT JET_QueueCommand (S_JET_DATA *pJet, EAS_U8 type, EAS_U8 param, EAS_U8 flags, EAS_U32 muteFlags)
+{
+    S_JET_COMMAND *pCmd;
+    EAS_U8 temp;
+
+    /* check for queue overflow */
+    temp = JET_IncQueueIndex(pJet->cmdQueueWrite, JET_CMD_QUEUE_SIZE);
+    if (temp == JET_LOAD_ACQUIRE(&pJet->cmdQueueRead))
+    {
+        pJet->stats.commandsDropped++;
+        return EAS_ERROR_QUEUE_IS_FULL;
+    }
+
+    /* save in queue and advance write index */
+    pCmd = &pJet->cmdQueue[pJet->cmdQueueWrite];
+    pCmd->type = type;
+    pCmd->param = param;
+    pCmd->flags = flags;
+    pCmd->muteFlags = muteFlags;
+    pCmd->frame = JET_LOAD_ACQUIRE(&pJet->frameCount);
+    JET_STORE_RELEASE(&pJet->cmdQueueWrite, temp);
+    pJet->stats.commandsQueued++;
+    return EAS_SUCCESS;
+}
+
 /*----------------------------------------------------------------------------
  * JET_NextSegment
  *----------------------------------------------------------------------------
@@ -567,6 +611,27 @@ EAS_PUBLIC EAS_RESULT JET_Status (EAS_DATA_HANDLE easHandle, S_JET_STATUS *pStat
     return EAS_SUCCESS;
 }
 
+/*----------------------------------------------------------------------------
+ * JET_GetStats()
+ *----------------------------------------------------------------------------
+ * Returns command queue and clip trigger latency counters
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT JET_GetStats (EAS_DATA_HANDLE easHandle, S_JET_STATS *pStats)
+{
+    S_JET_DATA *pJet;
+
+    pJet = easHandle->jetHandle;
+    pStats->commandsQueued = pJet->stats.commandsQueued;
+    pStats->commandsDropped = pJet->stats.commandsDropped;
+    pStats->clipsDropped = JET_LOAD_ACQUIRE(&pJet->stats.clipsDropped);
+    pStats->mutesDropped = JET_LOAD_ACQUIRE(&pJet->stats.mutesDropped);
+    pStats->maxCommandDelay = JET_LOAD_ACQUIRE(&pJet->stats.maxCommandDelay);
+    pStats->lastClipLatency = JET_LOAD_ACQUIRE(&pJet->stats.lastClipLatency);
+    pStats->maxClipLatency = JET_LOAD_ACQUIRE(&pJet->stats.maxClipLatency);
+    return EAS_SUCCESS;
+}
+
 /*----------------------------------------------------------------------------
  * JET_GetEvent()
  *----------------------------------------------------------------------------
@@ -581,7 +646,7 @@ EAS_PUBLIC EAS_BOOL JET_GetEvent (EAS_DATA_HANDLE easHandle, EAS_U32 *pEventRaw,
     /* process event queue */
     gotEvent = JET_ReadQueue(easHandle->jetHandle->appEventQueue,
         &easHandle->jetHandle->appEventQueueRead,
-        easHandle->jetHandle->appEventQueueWrite,
+        &easHandle->jetHandle->appEventQueueWrite,
         APP_EVENT_QUEUE_SIZE, &jetEvent);
 
     if (gotEvent)
@@ -741,87 +806,99 @@ EAS_PUBLIC EAS_RESULT JET_Pause (EAS_DATA_HANDLE easHandle)
 */
 EAS_PUBLIC EAS_RESULT JET_SetMuteFlags (EAS_DATA_HANDLE easHandle, EAS_U32 muteFlags, EAS_BOOL sync)
 {
-    S_JET_SEGMENT *pSeg;
+    /* the segment state belongs to the render thread, see JET_ApplyMuteFlags */
+    return JET_QueueCommand(easHandle->jetHandle, JET_CMD_SET_MUTE_FLAGS, 0,
+        sync ? JET_CMD_FLAG_SYNC : 0, muteFlags);
+}
 
-    /* get pointer to current segment */
-    pSeg = &easHandle->jetHandle->segQueue[easHandle->jetHandle->playSegment];
+/*----------------------------------------------------------------------------
+ * JET_SetMuteFlag()
+ *----------------------------------------------------------------------------
+ * Change the state of a single mute flag
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT JET_SetMuteFlag (EAS_DATA_HANDLE easHandle, EAS_INT trackNum, EAS_BOOL muteFlag, EAS_BOOL sync)
+{
+    EAS_U8 flags;
 
-    /* unsynchronized mute, set flags and return */
-    if (!sync)
-    {
-        if (pSeg->streamHandle == NULL)
-            return EAS_ERROR_QUEUE_IS_EMPTY;
-        pSeg->muteFlags = muteFlags;
-        return EAS_IntSetStrmParam(easHandle, pSeg->streamHandle, PARSER_DATA_MUTE_FLAGS, (EAS_I32) muteFlags);
-    }
+    /* check track number */
+    if ((trackNum < 0) || (trackNum > 31))
+        return EAS_ERROR_PARAMETER_RANGE;
 
+    /* the segment state belongs to the render thread, see JET_ApplyMuteFlags */
+    flags = sync ? JET_CMD_FLAG_SYNC : 0;
+    if (muteFlag)
+        flags |= JET_CMD_FLAG_MUTE;
+    return JET_QueueCommand(easHandle->jetHandle, JET_CMD_SET_MUTE_FLAG, (EAS_U8) trackNum, flags, 0);
+}
 
-    /* check for valid stream state */
-    if (pSeg->state == JET_STATE_CLOSED)
-        return EAS_ERROR_QUEUE_IS_EMPTY;
+/*----------------------------------------------------------------------------
+ * JET_TriggerClip()
+ *----------------------------------------------------------------------------
+ * Unmute a track and then mute it when it is complete. The clip
+ * is entered in the mute queue by the render thread, see
+ * JET_ApplyTriggerClip.
+ *----------------------------------------------------------------------------
+*/
+EAS_PUBLIC EAS_RESULT JET_TriggerClip (EAS_DATA_HANDLE easHandle, EAS_INT clipID)
+{
 
-    /* save mute flags */
-    pSeg->muteFlags = muteFlags;
+    /* check for valid clipID */
+    if ((clipID < 0) || (clipID > 63))
+        return EAS_ERROR_PARAMETER_RANGE;
 
-    /* if repeating segment, set mute update flag */
-    if (sync)
-        pSeg->flags |= JET_SEG_FLAG_MUTE_UPDATE;
-    return EAS_SUCCESS;
+    return JET_QueueCommand(easHandle->jetHandle, JET_CMD_TRIGGER_CLIP, (EAS_U8) clipID, 0, 0);
 }
 
 /*----------------------------------------------------------------------------
- * JET_SetMuteFlag()
+ * JET_ApplyMuteFlags()
  *----------------------------------------------------------------------------
- * Change the state of a single mute flag
+ * Render thread half of JET_SetMuteFlags and JET_SetMuteFlag. The
+ * command is dropped, and counted, if no segment is open to take it.
  *----------------------------------------------------------------------------
 */
-EAS_PUBLIC EAS_RESULT JET_SetMuteFlag (EAS_DATA_HANDLE easHandle, EAS_INT trackNum, EAS_BOOL muteFlag, EAS_BOOL sync)
+static void JET_ApplyMuteFlags (EAS_DATA_HANDLE easHandle, const S_JET_COMMAND *pCmd)
 {
     S_JET_SEGMENT *pSeg;
-    EAS_U32 trackMuteFlag;
-
-
-    /* setup flag */
-    if ((trackNum < 0) || (trackNum > 31))
-        return EAS_ERROR_PARAMETER_RANGE;
-    trackMuteFlag = (1 << trackNum);
+    EAS_U32 muteFlags;
 
     /* get pointer to current segment */
     pSeg = &easHandle->jetHandle->segQueue[easHandle->jetHandle->playSegment];
 
-    /* unsynchronized mute, set flags and return */
-    if (!sync)
+    /* check for valid stream state */
+    if ((pCmd->flags & JET_CMD_FLAG_SYNC) ? (pSeg->state == JET_STATE_CLOSED) : (pSeg->streamHandle == NULL))
     {
-        if (pSeg->streamHandle == NULL)
-            return EAS_ERROR_QUEUE_IS_EMPTY;
-        if (muteFlag)
-            pSeg->muteFlags |= trackMuteFlag;
-        else
-            pSeg->muteFlags &= ~trackMuteFlag;
-        return EAS_IntSetStrmParam(easHandle, pSeg->streamHandle, PARSER_DATA_MUTE_FLAGS, (EAS_I32) pSeg->muteFlags);
+        JET_STORE_RELEASE(&easHandle->jetHandle->stats.mutesDropped, easHandle->jetHandle->stats.mutesDropped + 1);
+        return;
     }
 
+    /* new flags for the whole segment or a single track */
+    muteFlags = pCmd->muteFlags;
+    if (pCmd->type == JET_CMD_SET_MUTE_FLAG)
+    {
+        if (pCmd->flags & JET_CMD_FLAG_MUTE)
+            muteFlags = pSeg->muteFlags | (1 << pCmd->param);
+        else
+            muteFlags = pSeg->muteFlags & ~(1 << pCmd->param);
+    }
+    pSeg->muteFlags = muteFlags;
 
-    /* check for valid stream state */
-    if (pSeg->state == JET_STATE_CLOSED)
-        return EAS_ERROR_QUEUE_IS_EMPTY;
+    /* unsynchronized mute, set flags now */
+    if ((pCmd->flags & JET_CMD_FLAG_SYNC) == 0)
+        (void) EAS_IntSetStrmParam(easHandle, pSeg->streamHandle, PARSER_DATA_MUTE_FLAGS, (EAS_I32) muteFlags);
 
-    /* save mute flags and set mute update flag */
-    if (muteFlag)
-        pSeg->muteFlags |= trackMuteFlag;
+    /* otherwise update when the segment repeats */
     else
-        pSeg->muteFlags &= ~trackMuteFlag;
-    pSeg->flags |= JET_SEG_FLAG_MUTE_UPDATE;
-    return EAS_SUCCESS;
+        pSeg->flags |= JET_SEG_FLAG_MUTE_UPDATE;
 }
 
 /*----------------------------------------------------------------------------
- * JET_TriggerClip()
+ * JET_ApplyTriggerClip()
  *----------------------------------------------------------------------------
- * Unmute a track and then mute it when it is complete. If a clip
- * is already playing, change mute event to a trigger event. The
- * JET_Event function will not mute the clip, but will allow it
- * to continue playing through the next clip.
+ * Render thread half of JET_TriggerClip. If a clip is already
+ * playing, change mute event to a trigger event. The JET_Event
+ * function will not mute the clip, but will allow it to continue
+ * playing through the next clip.
  *
  * NOTE: We use bit 7 to indicate an entry in the queue. For a
  * small queue, it is cheaper in both memory and CPU cycles to
@@ -829,34 +906,85 @@ EAS_PUBLIC EAS_RESULT JET_SetMuteFlag (EAS_DATA_HANDLE easHandle, EAS_INT trackN
  * and dequeue indices.
  *----------------------------------------------------------------------------
 */
-EAS_PUBLIC EAS_RESULT JET_TriggerClip (EAS_DATA_HANDLE easHandle, EAS_INT clipID)
+static void JET_ApplyTriggerClip (S_JET_DATA *pJet, EAS_INT clipID)
 {
     EAS_INT i;
     EAS_INT index = -1;
 
-    /* check for valid clipID */
-    if ((clipID < 0) || (clipID > 63))
-        return EAS_ERROR_PARAMETER_RANGE;
-
     /* set active flag */
     clipID |= JET_CLIP_ACTIVE_FLAG;
 
     /* Reverse the search so that we get the first empty element */
     for (i = JET_MUTE_QUEUE_SIZE-1; i >= 0 ; i--)
     {
-        if (easHandle->jetHandle->muteQueue[i] == clipID)
+        if (pJet->muteQueue[i] == clipID)
         {
             index = i;
             break;
         }
-        if (easHandle->jetHandle->muteQueue[i] == 0)
+        if (pJet->muteQueue[i] == 0)
             index = i;
     }
     if (index < 0)
-        return EAS_ERROR_QUEUE_IS_FULL;
+    {
+        { /* dpp: EAS_ReportEx(_EAS_SEVERITY_WARNING, "JET_TriggerClip: Mute queue full --- clip ignored!\n"); */ }
+        JET_STORE_RELEASE(&pJet->stats.clipsDropped, pJet->stats.clipsDropped + 1);
+        return;
+    }
 
-    easHandle->jetHandle->muteQueue[index] = (EAS_U8) clipID | JET_CLIP_TRIGGER_FLAG;
-    return EAS_SUCCESS;
+    pJet->muteQueue[index] = (EAS_U8) clipID | JET_CLIP_TRIGGER_FLAG;
+    pJet->clipFrame[index] = pJet->frameCount;
+}
+
+/*----------------------------------------------------------------------------
+ * JET_ProcessCommands()
+ *----------------------------------------------------------------------------
+ * Called at the start of each EAS_Render frame to apply the clip and
+ * mute commands posted since the previous frame, so they reach the
+ * parser without waiting for the host's render loop to finish.
+ *----------------------------------------------------------------------------
+*/
+void JET_ProcessCommands (EAS_DATA_HANDLE easHandle)
+{
+    S_JET_DATA *pJet;
+    S_JET_COMMAND *pCmd;
+    EAS_U32 delay;
+    EAS_U8 request;
+    EAS_U8 flushIndex;
+    EAS_INT pending;
+
+    pJet = easHandle->jetHandle;
+
+    /* JET_Clear_Queue drops the commands queued before it was called, unless they have been applied already */
+    request = JET_LOAD_ACQUIRE(&pJet->cmdFlushRequest);
+    if (request != pJet->cmdFlushDone)
+    {
+        flushIndex = JET_LOAD_ACQUIRE(&pJet->cmdFlushIndex);
+        pending = (flushIndex + JET_CMD_QUEUE_SIZE - pJet->cmdQueueRead) % JET_CMD_QUEUE_SIZE;
+        if (pending <= (JET_LOAD_ACQUIRE(&pJet->cmdQueueWrite) + JET_CMD_QUEUE_SIZE - pJet->cmdQueueRead) % JET_CMD_QUEUE_SIZE)
+            JET_STORE_RELEASE(&pJet->cmdQueueRead, flushIndex);
+        pJet->cmdFlushDone = request;
+    }
+
+    while (pJet->cmdQueueRead != JET_LOAD_ACQUIRE(&pJet->cmdQueueWrite))
+    {
+        pCmd = &pJet->cmdQueue[pJet->cmdQueueRead];
+
+        /* record the worst case delay from the API call */
+        delay = pJet->frameCount - pCmd->frame;
+        if (delay > pJet->stats.maxCommandDelay)
+            JET_STORE_RELEASE(&pJet->stats.maxCommandDelay, delay);
+
+        if (pCmd->type == JET_CMD_TRIGGER_CLIP)
+            JET_ApplyTriggerClip(pJet, pCmd->param);
+        else
+            JET_ApplyMuteFlags(easHandle, pCmd);
+
+        JET_STORE_RELEASE(&pJet->cmdQueueRead, JET_IncQueueIndex(pJet->cmdQueueRead, JET_CMD_QUEUE_SIZE));
+    }
+
+    /* frames are counted here so the first command of a frame reads zero delay */
+    JET_STORE_RELEASE(&pJet->frameCount, pJet->frameCount + 1);
 }
 
 /*----------------------------------------------------------------------------
@@ -880,7 +1008,7 @@ EAS_PUBLIC EAS_RESULT JET_Process (EAS_DATA_HANDLE easHandle)
     /* process event queue */
     while (JET_ReadQueue(easHandle->jetHandle->jetEventQueue,
         &easHandle->jetHandle->jetEventQueueRead,
-        easHandle->jetHandle->jetEventQueueWrite,
+        &easHandle->jetHandle->jetEventQueueWrite,
         JET_EVENT_QUEUE_SIZE, &jetEvent))
     {
         S_JET_EVENT event;
@@ -1032,8 +1160,15 @@ void JET_Event (EAS_DATA_HANDLE easHandle, EAS_U32 segTrack, EAS_U8 channel, EAS
                 /* un-mute the track */
                 if ((easHandle->jetHandle->muteQueue[i] & JET_CLIP_TRIGGER_FLAG) && ((value & 0x40) > 0))
                 {
+                    EAS_U32 latency;
                     pSeg->muteFlags &= ~muteFlag;
                     easHandle->jetHandle->muteQueue[i] &= ~JET_CLIP_TRIGGER_FLAG;
+
+                    /* frames from the trigger to the clip start marker */
+                    latency = easHandle->jetHandle->frameCount - easHandle->jetHandle->clipFrame[i];
+                    JET_STORE_RELEASE(&easHandle->jetHandle->stats.lastClipLatency, latency);
+                    if (latency > easHandle->jetHandle->stats.maxClipLatency)
+                        JET_STORE_RELEASE(&easHandle->jetHandle->stats.maxClipLatency, latency);
                 }
 
                 /* mute the track */
@@ -1065,7 +1200,7 @@ void JET_Event (EAS_DATA_HANDLE easHandle, EAS_U32 segTrack, EAS_U8 channel, EAS
 #endif
         JET_WriteQueue(easHandle->jetHandle->appEventQueue,
             &easHandle->jetHandle->appEventQueueWrite,
-            easHandle->jetHandle->appEventQueueRead,
+            &easHandle->jetHandle->appEventQueueRead,
             APP_EVENT_QUEUE_SIZE,
             event);
     }
@@ -1079,7 +1214,7 @@ void JET_Event (EAS_DATA_HANDLE easHandle, EAS_U32 segTrack, EAS_U8 channel, EAS
 #endif
         JET_WriteQueue(easHandle->jetHandle->jetEventQueue,
             &easHandle->jetHandle->jetEventQueueWrite,
-            easHandle->jetHandle->jetEventQueueRead,
+            &easHandle->jetHandle->jetEventQueueRead,
             JET_EVENT_QUEUE_SIZE,
             event);
     }
@@ -1128,6 +1263,10 @@ EAS_RESULT JET_Clear_Queue(EAS_DATA_HANDLE easHandle)
         easHandle->jetHandle->muteQueue[index] = 0;
     }
 
+    /* the render thread owns cmdQueueRead, so ask it to drop the pending commands at its next frame */
+    JET_STORE_RELEASE(&easHandle->jetHandle->cmdFlushIndex, easHandle->jetHandle->cmdQueueWrite);
+    JET_STORE_RELEASE(&easHandle->jetHandle->cmdFlushRequest, (EAS_U8) (easHandle->jetHandle->cmdFlushRequest + 1));
+
     easHandle->jetHandle->flags &= ~JET_FLAGS_PLAYING;
     easHandle->jetHandle->playSegment = easHandle->jetHandle->queueSegment = 0;
     return result;
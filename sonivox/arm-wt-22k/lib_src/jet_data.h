@@ -57,6 +57,11 @@
 #define JET_MUTE_QUEUE_SIZE         8
 #endif
 
+/* maximum number of application commands waiting for the render thread */
+#ifndef JET_CMD_QUEUE_SIZE
+#define JET_CMD_QUEUE_SIZE          16
+#endif
+
 /*----------------------------------------------------------------------------
  * JET event definitions
  *----------------------------------------------------------------------------
@@ -128,6 +133,30 @@ typedef enum
 /* S_JEG_SEGMENT.flags */
 #define JET_SEG_FLAG_MUTE_UPDATE        0x01
 
+/*----------------------------------------------------------------------------
+ * S_JET_COMMAND
+ *
+ * Clip and mute request posted by the application to the render thread
+ *----------------------------------------------------------------------------
+*/
+typedef struct s_jet_command_tag
+{
+    EAS_U32             muteFlags;
+    EAS_U32             frame;
+    EAS_U8              type;
+    EAS_U8              param;
+    EAS_U8              flags;
+} S_JET_COMMAND;
+
+/* S_JET_COMMAND.type */
+#define JET_CMD_TRIGGER_CLIP            1
+#define JET_CMD_SET_MUTE_FLAGS          2
+#define JET_CMD_SET_MUTE_FLAG           3
+
+/* S_JET_COMMAND.flags */
+#define JET_CMD_FLAG_SYNC               0x01
+#define JET_CMD_FLAG_MUTE               0x02
+
 /*----------------------------------------------------------------------------
  * S_JET_DATA
  *
@@ -145,8 +174,12 @@ typedef struct s_jet_data_tag
     EAS_DLSLIB_HANDLE   libHandles[JET_MAX_DLS_COLLECTIONS];
     EAS_U32             jetEventQueue[JET_EVENT_QUEUE_SIZE];
     EAS_U32             appEventQueue[APP_EVENT_QUEUE_SIZE];
+    S_JET_COMMAND       cmdQueue[JET_CMD_QUEUE_SIZE];
+    S_JET_STATS         stats;
     S_JET_CONFIG        config;
     EAS_U32             segmentTime;
+    EAS_U32             frameCount;
+    EAS_U32             clipFrame[JET_MUTE_QUEUE_SIZE];
     EAS_U8              muteQueue[JET_MUTE_QUEUE_SIZE];
     EAS_U8              numSegments;
     EAS_U8              numLibraries;
@@ -158,6 +191,11 @@ typedef struct s_jet_data_tag
     EAS_U8              jetEventQueueWrite;
     EAS_U8              appEventQueueRead;
     EAS_U8              appEventQueueWrite;
+    EAS_U8              cmdQueueRead;
+    EAS_U8              cmdQueueWrite;
+    EAS_U8              cmdFlushIndex;
+    EAS_U8              cmdFlushRequest;
+    EAS_U8              cmdFlushDone;
 } S_JET_DATA;
 
 /* flags for S_JET_DATA.flags */
@@ -179,5 +217,8 @@ extern void JET_Event (EAS_DATA_HANDLE easHandle, EAS_U32 segTrack, EAS_U8 chann
 /* prototype for JET render function */
 extern EAS_PUBLIC EAS_RESULT JET_Process (EAS_DATA_HANDLE easHandle);
 
+/* prototype for applying application commands at the start of a frame */
+extern void JET_ProcessCommands (EAS_DATA_HANDLE easHandle);
+
 #endif
 
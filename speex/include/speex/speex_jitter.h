@@ -77,6 +77,9 @@ struct _JitterBufferPacket {
 /** Invalid argument */
 #define JITTER_BUFFER_BAD_ARGUMENT -2
 
+/** Maximum number of packets held by the jitter buffer (and number of payloads a packet pool must hold) */
+#define JITTER_BUFFER_MAX_PACKETS 200
+
 
 /** Set minimum amount of extra buffering required (margin) */
 #define JITTER_BUFFER_SET_MARGIN 0
@@ -186,6 +189,16 @@ void jitter_buffer_remaining_span(JitterBuffer *jitter, spx_uint32_t rem);
 */
 int jitter_buffer_ctl(JitterBuffer *jitter, int request, void *ptr);
 
+/** Store packet payloads in caller-provided memory instead of allocating a copy of each one,
+ * so that jitter_buffer_put() never allocates. Not used when a destroy callback is set.
+ * 
+ * @param jitter Jitter buffer state
+ * @param pool Room for JITTER_BUFFER_MAX_PACKETS payloads of packet_size bytes each, or NULL to go back to speex_alloc()
+ * @param packet_size Largest payload the pool can hold (larger packets are dropped)
+ * @return 0 if no error, -1 if the jitter buffer still holds packets
+*/
+int jitter_buffer_set_pool(JitterBuffer *jitter, char *pool, spx_uint32_t packet_size);
+
 int jitter_buffer_update_delay(JitterBuffer *jitter, JitterBufferPacket *packet, spx_int32_t *start_offset);
 
 /* @} */
@@ -93,6 +93,44 @@ void speex_preprocess_estimate_update(SpeexPreprocessState *st, spx_int16_t *x);
 */
 int speex_preprocess_ctl(SpeexPreprocessState *st, int request, void *ptr);
 
+/** State of a batch of preprocessors that are run together. Should never be accessed directly. */
+struct SpeexPreprocessBatch_;
+
+/** State of a batch of preprocessors that are run together. Should never be accessed directly. */
+typedef struct SpeexPreprocessBatch_ SpeexPreprocessBatch;
+
+/** Creates a batch of preprocessors for many independent streams with the same frame size and
+ * sampling rate, e.g. the calls handled by one server thread. Each stream behaves exactly like
+ * its own SpeexPreprocessState, but the streams share their tables and are processed together,
+ * which is much cheaper per stream.
+ * @param nb_streams Number of streams in the batch
+ * @param frame_size Number of samples to process at one time (should correspond to 10-20 ms)
+ * @param sampling_rate Sampling rate used for the input
+ * @return Newly created batch, or NULL if nb_streams is less than 1
+*/
+SpeexPreprocessBatch *speex_preprocess_batch_init(int nb_streams, int frame_size, int sampling_rate);
+
+/** Destroys a batch of preprocessors
+ * @param batch Batch to destroy
+*/
+void speex_preprocess_batch_destroy(SpeexPreprocessBatch *batch);
+
+/** Preprocess one frame of every stream in the batch
+ * @param batch Batch of preprocessors
+ * @param x Audio sample vector (in and out) of each stream, nb_streams pointers
+ * @param vad Voice activity of each stream as returned by speex_preprocess_run() (out, may be NULL)
+*/
+void speex_preprocess_batch_run(SpeexPreprocessBatch *batch, spx_int16_t **x, int *vad);
+
+/** Used like speex_preprocess_ctl() on one stream of a batch
+ * @param batch Batch of preprocessors
+ * @param stream Index of the stream
+ * @param request ioctl-type request (one of the SPEEX_PREPROCESS_* macros)
+ * @param ptr Data exchanged to-from function
+ * @return 0 if no error, -1 if request in unknown or the stream does not exist
+*/
+int speex_preprocess_batch_ctl(SpeexPreprocessBatch *batch, int stream, int request, void *ptr);
+
 
 
 /** Set preprocessor denoiser state */
@@ -81,7 +81,7 @@ static void renorm_range(spx_word16_t *in, spx_word16_t *out, int shift, int len
 #include "smallft.h"
 #include <math.h>
 
-void *spx_fft_init(int size)
+static void *fft_smallft_init(int size)
 {
    struct drft_lookup *table;
    table = speex_alloc(sizeof(struct drft_lookup));
@@ -89,13 +89,13 @@ void *spx_fft_init(int size)
    return (void*)table;
 }
 
-void spx_fft_destroy(void *table)
+static void fft_smallft_destroy(void *table)
 {
    spx_drft_clear(table);
    speex_free(table);
 }
 
-void spx_fft(void *table, float *in, float *out)
+static void fft_smallft_forward(void *table, spx_word16_t *in, spx_word16_t *out)
 {
    if (in==out)
    {
@@ -113,7 +113,7 @@ void spx_fft(void *table, float *in, float *out)
    spx_drft_forward((struct drft_lookup *)table, out);
 }
 
-void spx_ifft(void *table, float *in, float *out)
+static void fft_smallft_backward(void *table, spx_word16_t *in, spx_word16_t *out)
 {
    if (in==out)
    {
@@ -126,7 +126,9 @@ void spx_ifft(void *table, float *in, float *out)
    spx_drft_backward((struct drft_lookup *)table, out);
 }
 
-#elif defined(USE_INTEL_MKL)
+#endif
+
+#ifdef USE_INTEL_MKL
 #include <mkl.h>
 
 struct mkl_config {
@@ -134,38 +136,49 @@ struct mkl_config {
   int N;
 };
 
-void *spx_fft_init(int size)
+static void *fft_mkl_init(int size)
 {
   struct mkl_config *table = (struct mkl_config *) speex_alloc(sizeof(struct mkl_config));
   table->N = size;
-  DftiCreateDescriptor(&table->desc, DFTI_SINGLE, DFTI_REAL, 1, size);
+  if (DftiCreateDescriptor(&table->desc, DFTI_SINGLE, DFTI_REAL, 1, size) != DFTI_NO_ERROR)
+  {
+    speex_free(table);
+    return NULL;
+  }
   DftiSetValue(table->desc, DFTI_PACKED_FORMAT, DFTI_PACK_FORMAT);
   DftiSetValue(table->desc, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
   DftiSetValue(table->desc, DFTI_FORWARD_SCALE, 1.0f / size);
-  DftiCommitDescriptor(table->desc);
+  if (DftiCommitDescriptor(table->desc) != DFTI_NO_ERROR)
+  {
+    DftiFreeDescriptor(&table->desc);
+    speex_free(table);
+    return NULL;
+  }
   return table;
 }
 
-void spx_fft_destroy(void *table)
+static void fft_mkl_destroy(void *table)
 {
   struct mkl_config *t = (struct mkl_config *) table;
-  DftiFreeDescriptor(t->desc);
+  DftiFreeDescriptor(&t->desc);
   speex_free(table);
 }
 
-void spx_fft(void *table, spx_word16_t *in, spx_word16_t *out)
+static void fft_mkl_forward(void *table, spx_word16_t *in, spx_word16_t *out)
 {
   struct mkl_config *t = (struct mkl_config *) table;
   DftiComputeForward(t->desc, in, out);
 }
 
-void spx_ifft(void *table, spx_word16_t *in, spx_word16_t *out)
+static void fft_mkl_backward(void *table, spx_word16_t *in, spx_word16_t *out)
 {
   struct mkl_config *t = (struct mkl_config *) table;
   DftiComputeBackward(t->desc, in, out);
 }
 
-#elif defined(USE_GPL_FFTW3)
+#endif
+
+#ifdef USE_GPL_FFTW3
 
 #include <fftw3.h>
 
@@ -177,7 +190,19 @@ struct fftw_config {
   int N;
 };
 
-void *spx_fft_init(int size)
+static void fft_fftw3_destroy(void *table)
+{
+  struct fftw_config *t = (struct fftw_config *) table;
+  if (t->fft)
+    fftwf_destroy_plan(t->fft);
+  if (t->ifft)
+    fftwf_destroy_plan(t->ifft);
+  fftwf_free(t->in);
+  fftwf_free(t->out);
+  speex_free(table);
+}
+
+static void *fft_fftw3_init(int size)
 {
   struct fftw_config *table = (struct fftw_config *) speex_alloc(sizeof(struct fftw_config));
   table->in = fftwf_malloc(sizeof(float) * (size+2));
@@ -187,21 +212,15 @@ void *spx_fft_init(int size)
   table->ifft = fftwf_plan_dft_c2r_1d(size, (fftwf_complex *) table->in, table->out, FFTW_PATIENT);
 
   table->N = size;
+  if (!table->fft || !table->ifft)
+  {
+    fft_fftw3_destroy(table);
+    return NULL;
+  }
   return table;
 }
 
-void spx_fft_destroy(void *table)
-{
-  struct fftw_config *t = (struct fftw_config *) table;
-  fftwf_destroy_plan(t->fft);
-  fftwf_destroy_plan(t->ifft);
-  fftwf_free(t->in);
-  fftwf_free(t->out);
-  speex_free(table);
-}
-
-
-void spx_fft(void *table, spx_word16_t *in, spx_word16_t *out)
+static void fft_fftw3_forward(void *table, spx_word16_t *in, spx_word16_t *out)
 {
   int i;
   struct fftw_config *t = (struct fftw_config *) table;
@@ -219,7 +238,7 @@ void spx_fft(void *table, spx_word16_t *in, spx_word16_t *out)
     out[i] = optr[i+1];
 }
 
-void spx_ifft(void *table, spx_word16_t *in, spx_word16_t *out) 
+static void fft_fftw3_backward(void *table, spx_word16_t *in, spx_word16_t *out) 
 {
   int i;
   struct fftw_config *t = (struct fftw_config *) table;
@@ -239,7 +258,9 @@ void spx_ifft(void *table, spx_word16_t *in, spx_word16_t *out)
     out[i] = optr[i];
 }
 
-#elif defined(USE_KISS_FFT)
+#endif
+
+#ifdef USE_KISS_FFT
 
 #include "kiss_fftr.h"
 #include "kiss_fft.h"
@@ -250,7 +271,7 @@ struct kiss_config {
    int N;
 };
 
-void *spx_fft_init(int size)
+static void *fft_kiss_init(int size)
 {
    struct kiss_config *table;
    table = (struct kiss_config*)speex_alloc(sizeof(struct kiss_config));
@@ -260,7 +281,7 @@ void *spx_fft_init(int size)
    return table;
 }
 
-void spx_fft_destroy(void *table)
+static void fft_kiss_destroy(void *table)
 {
    struct kiss_config *t = (struct kiss_config *)table;
    kiss_fftr_free(t->forward);
@@ -270,7 +291,7 @@ void spx_fft_destroy(void *table)
 
 #ifdef FIXED_POINT
 
-void spx_fft(void *table, spx_word16_t *in, spx_word16_t *out)
+static void fft_kiss_forward(void *table, spx_word16_t *in, spx_word16_t *out)
 {
    int shift;
    struct kiss_config *t = (struct kiss_config *)table;
@@ -282,7 +303,7 @@ void spx_fft(void *table, spx_word16_t *in, spx_word16_t *out)
 
 #else
 
-void spx_fft(void *table, spx_word16_t *in, spx_word16_t *out)
+static void fft_kiss_forward(void *table, spx_word16_t *in, spx_word16_t *out)
 {
    int i;
    float scale;
@@ -294,18 +315,88 @@ void spx_fft(void *table, spx_word16_t *in, spx_word16_t *out)
 }
 #endif
 
-void spx_ifft(void *table, spx_word16_t *in, spx_word16_t *out)
+static void fft_kiss_backward(void *table, spx_word16_t *in, spx_word16_t *out)
 {
    struct kiss_config *t = (struct kiss_config *)table;
    kiss_fftri2(t->backward, in, out);
 }
 
+#endif
 
-#else
-
+#if !defined(USE_SMALLFT) && !defined(USE_INTEL_MKL) && !defined(USE_GPL_FFTW3) && !defined(USE_KISS_FFT)
 #error No other FFT implemented
+#endif
 
+struct fft_backend {
+   void *(*init)(int size);
+   void (*destroy)(void *table);
+   void (*forward)(void *table, spx_word16_t *in, spx_word16_t *out);
+   void (*backward)(void *table, spx_word16_t *in, spx_word16_t *out);
+};
+
+/* Every FFT enabled at build time is compiled in. spx_fft_init() walks this
+   list in order and keeps the first backend that accepts the requested size,
+   so the optimized libraries come first and a library that refuses a size
+   falls back to the built-in FFTs instead of failing. */
+static const struct fft_backend fft_backends[] = {
+#ifdef USE_INTEL_MKL
+   {fft_mkl_init, fft_mkl_destroy, fft_mkl_forward, fft_mkl_backward},
+#endif
+#ifdef USE_GPL_FFTW3
+   {fft_fftw3_init, fft_fftw3_destroy, fft_fftw3_forward, fft_fftw3_backward},
 #endif
+#ifdef USE_SMALLFT
+   {fft_smallft_init, fft_smallft_destroy, fft_smallft_forward, fft_smallft_backward},
+#endif
+#ifdef USE_KISS_FFT
+   {fft_kiss_init, fft_kiss_destroy, fft_kiss_forward, fft_kiss_backward},
+#endif
+};
+
+struct fft_state {
+   const struct fft_backend *backend;
+   void *table;
+   int N;
+};
+
+void *spx_fft_init(int size)
+{
+   unsigned int i;
+   struct fft_state *st;
+   st = (struct fft_state *)speex_alloc(sizeof(struct fft_state));
+   st->N = size;
+   for (i=0;i<sizeof(fft_backends)/sizeof(fft_backends[0]);i++)
+   {
+      st->table = fft_backends[i].init(size);
+      if (st->table)
+      {
+         st->backend = &fft_backends[i];
+         return st;
+      }
+   }
+   speex_warning("No FFT backend accepted the requested size");
+   speex_free(st);
+   return NULL;
+}
+
+void spx_fft_destroy(void *table)
+{
+   struct fft_state *st = (struct fft_state *)table;
+   st->backend->destroy(st->table);
+   speex_free(st);
+}
+
+void spx_fft(void *table, spx_word16_t *in, spx_word16_t *out)
+{
+   struct fft_state *st = (struct fft_state *)table;
+   st->backend->forward(st->table, in, out);
+}
+
+void spx_ifft(void *table, spx_word16_t *in, spx_word16_t *out)
+{
+   struct fft_state *st = (struct fft_state *)table;
+   st->backend->backward(st->table, in, out);
+}
 
 
 #ifdef FIXED_POINT
@@ -315,12 +406,7 @@ void spx_ifft(void *table, spx_word16_t *in, spx_word16_t *out)
 void spx_fft_float(void *table, float *in, float *out)
 {
    int i;
-#ifdef USE_SMALLFT
-   int N = ((struct drft_lookup *)table)->n;
-#elif defined(USE_KISS_FFT)
-   int N = ((struct kiss_config *)table)->N;
-#else
-#endif
+   int N = ((struct fft_state *)table)->N;
 #ifdef VAR_ARRAYS
    spx_word16_t _in[N];
    spx_word16_t _out[N];
@@ -351,12 +437,7 @@ void spx_fft_float(void *table, float *in, float *out)
 void spx_ifft_float(void *table, float *in, float *out)
 {
    int i;
-#ifdef USE_SMALLFT
-   int N = ((struct drft_lookup *)table)->n;
-#elif defined(USE_KISS_FFT)
-   int N = ((struct kiss_config *)table)->N;
-#else
-#endif
+   int N = ((struct fft_state *)table)->N;
 #ifdef VAR_ARRAYS
    spx_word16_t _in[N];
    spx_word16_t _out[N];
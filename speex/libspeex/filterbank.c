@@ -168,6 +168,46 @@ void filterbank_compute_psd16(FilterBank *bank, spx_word16_t *mel, spx_word16_t
    }
 }
 
+void filterbank_compute_bank32_batch(FilterBank *bank, spx_word32_t *ps, spx_word32_t *mel, int nb_lanes)
+{
+   int i, k;
+   for (i=0;i<bank->nb_banks*nb_lanes;i++)
+      mel[i] = 0;
+
+   /* Lanes are contiguous, so the inner loops have unit stride */
+   for (i=0;i<bank->len;i++)
+   {
+      const spx_word32_t *p = ps + i*nb_lanes;
+      spx_word32_t *left = mel + bank->bank_left[i]*nb_lanes;
+      spx_word32_t *right = mel + bank->bank_right[i]*nb_lanes;
+      spx_word16_t filter_left = bank->filter_left[i];
+      spx_word16_t filter_right = bank->filter_right[i];
+      for (k=0;k<nb_lanes;k++)
+         left[k] += MULT16_32_P15(filter_left,p[k]);
+      for (k=0;k<nb_lanes;k++)
+         right[k] += MULT16_32_P15(filter_right,p[k]);
+   }
+}
+
+void filterbank_compute_psd16_batch(FilterBank *bank, spx_word16_t *mel, spx_word16_t *ps, int nb_lanes)
+{
+   int i, k;
+   for (i=0;i<bank->len;i++)
+   {
+      const spx_word16_t *left = mel + bank->bank_left[i]*nb_lanes;
+      const spx_word16_t *right = mel + bank->bank_right[i]*nb_lanes;
+      spx_word16_t filter_left = bank->filter_left[i];
+      spx_word16_t filter_right = bank->filter_right[i];
+      spx_word16_t *out = ps + i*nb_lanes;
+      for (k=0;k<nb_lanes;k++)
+      {
+         spx_word32_t tmp;
+         tmp = MULT16_16(left[k],filter_left);
+         tmp += MULT16_16(right[k],filter_right);
+         out[k] = EXTRACT16(PSHR32(tmp,15));
+      }
+   }
+}
 
 #ifndef FIXED_POINT
 void filterbank_compute_bank(FilterBank *bank, float *ps, float *mel)
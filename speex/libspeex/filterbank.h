@@ -57,6 +57,12 @@ void filterbank_compute_bank32(FilterBank *bank, spx_word32_t *ps, spx_word32_t
 
 void filterbank_compute_psd16(FilterBank *bank, spx_word16_t *mel, spx_word16_t *psd);
 
+/* Same as above for nb_lanes interleaved spectra, with bin i of lane k at
+   [i*nb_lanes+k]. Each lane gets exactly the result of the single versions. */
+void filterbank_compute_bank32_batch(FilterBank *bank, spx_word32_t *ps, spx_word32_t *mel, int nb_lanes);
+
+void filterbank_compute_psd16_batch(FilterBank *bank, spx_word16_t *mel, spx_word16_t *psd, int nb_lanes);
+
 #ifndef FIXED_POINT
 void filterbank_compute_bank(FilterBank *bank, float *psd, float *mel);
 void filterbank_compute_psd(FilterBank *bank, float *mel, float *psd);
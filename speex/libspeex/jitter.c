@@ -64,7 +64,7 @@ TODO:
 #define NULL 0
 #endif
 
-#define SPEEX_JITTER_MAX_BUFFER_SIZE 200   /**< Maximum number of packets in jitter buffer */
+#define SPEEX_JITTER_MAX_BUFFER_SIZE JITTER_BUFFER_MAX_PACKETS   /**< Maximum number of packets in jitter buffer */
 
 #define TSUB(a,b) ((spx_int32_t)((a)-(b)))
 
@@ -73,6 +73,11 @@ TODO:
 #define LT32(a,b) (((spx_int32_t)((a)-(b)))<0)
 #define LE32(a,b) (((spx_int32_t)((a)-(b)))<=0)
 
+/** Slot holding the k-th oldest packet */
+#define ORDER(jitter, k) ((jitter)->order[((jitter)->order_head+(k))%SPEEX_JITTER_MAX_BUFFER_SIZE])
+/** The k-th oldest packet */
+#define PACKET_AT(jitter, k) (&(jitter)->packets[ORDER(jitter, k)])
+
 #define ROUND_DOWN(x, step) ((x)<0 ? ((x)-(step)+1)/(step)*(step) : (x)/(step)*(step)) 
 
 #define MAX_TIMINGS 40
@@ -144,8 +149,15 @@ struct JitterBuffer_ {
    
    JitterBufferPacket packets[SPEEX_JITTER_MAX_BUFFER_SIZE];   /**< Packets stored in the buffer */
    spx_uint32_t arrival[SPEEX_JITTER_MAX_BUFFER_SIZE];         /**< Packet arrival time (0 means it was late, even though it's a valid timestamp) */
+   int order[SPEEX_JITTER_MAX_BUFFER_SIZE];                    /**< Ring of the occupied slots, sorted by timestamp */
+   int order_head;                                             /**< Position of the oldest packet in the ring */
+   int nb_packets;                                             /**< Number of packets stored in the buffer */
+   int free_slots[SPEEX_JITTER_MAX_BUFFER_SIZE];               /**< Stack of the empty slots */
+   int nb_free;                                                /**< Number of empty slots */
    
    void (*destroy) (void *);                                   /**< Callback for destroying a packet */
+   char *pool;                                                 /**< Caller-provided payload storage (NULL to use speex_alloc) */
+   spx_uint32_t pool_packet_size;                              /**< Size of one payload in the pool */
 
    spx_int32_t delay_step;                                     /**< Size of the steps when adjusting buffering (timestamp units) */
    spx_int32_t concealment_size;                               /**< Size of the packet loss concealment "units" */
@@ -268,6 +280,75 @@ static spx_int16_t compute_opt_delay(JitterBuffer *jitter)
 }
 
 
+/** Position in the timestamp order of the first packet not older than timestamp */
+static int order_lower_bound(JitterBuffer *jitter, spx_uint32_t timestamp)
+{
+   int lo=0, hi=jitter->nb_packets;
+   while (lo < hi)
+   {
+      int mid = (lo+hi)>>1;
+      if (LT32(PACKET_AT(jitter, mid)->timestamp, timestamp))
+         lo = mid+1;
+      else
+         hi = mid;
+   }
+   return lo;
+}
+
+/** Position in the timestamp order of the first packet newer than timestamp */
+static int order_upper_bound(JitterBuffer *jitter, spx_uint32_t timestamp)
+{
+   int lo=0, hi=jitter->nb_packets;
+   while (lo < hi)
+   {
+      int mid = (lo+hi)>>1;
+      if (LE32(PACKET_AT(jitter, mid)->timestamp, timestamp))
+         lo = mid+1;
+      else
+         hi = mid;
+   }
+   return lo;
+}
+
+/** Insert an occupied slot in the timestamp order. Packets usually arrive in order,
+    in which case they go at the end of the ring and nothing has to move. */
+static void order_insert(JitterBuffer *jitter, int slot)
+{
+   int k;
+   int pos = order_upper_bound(jitter, jitter->packets[slot].timestamp);
+   for (k=jitter->nb_packets;k>pos;k--)
+      ORDER(jitter, k) = ORDER(jitter, k-1);
+   ORDER(jitter, pos) = slot;
+   jitter->nb_packets++;
+}
+
+/** Remove the k-th oldest packet and give its slot back. The payload is released unless
+    it has just been handed over to the caller (handed_out) along with a destroy callback. */
+static void remove_packet(JitterBuffer *jitter, int k, int handed_out)
+{
+   int i = ORDER(jitter, k);
+   if (jitter->destroy)
+   {
+      if (!handed_out)
+         jitter->destroy(jitter->packets[i].data);
+   } else if (!jitter->pool)
+   {
+      speex_free(jitter->packets[i].data);
+   }
+   jitter->packets[i].data = NULL;
+   jitter->free_slots[jitter->nb_free++] = i;
+   
+   /* The oldest packet is the usual case and only moves the head of the ring */
+   if (k==0)
+   {
+      jitter->order_head = (jitter->order_head+1)%SPEEX_JITTER_MAX_BUFFER_SIZE;
+   } else {
+      for (;k<jitter->nb_packets-1;k++)
+         ORDER(jitter, k) = ORDER(jitter, k+1);
+   }
+   jitter->nb_packets--;
+}
+
 /** Initialise jitter buffer */
 EXPORT JitterBuffer *jitter_buffer_init(int step_size)
 {
@@ -284,6 +365,9 @@ EXPORT JitterBuffer *jitter_buffer_init(int step_size)
       jitter->buffer_margin = 0;
       jitter->late_cutoff = 50;
       jitter->destroy = NULL;
+      jitter->pool = NULL;
+      jitter->pool_packet_size = 0;
+      jitter->nb_packets = 0;
       jitter->latency_tradeoff = 0;
       jitter->auto_adjust = 1;
       tmp = 4;
@@ -297,17 +381,13 @@ EXPORT JitterBuffer *jitter_buffer_init(int step_size)
 EXPORT void jitter_buffer_reset(JitterBuffer *jitter)
 {
    int i;
+   while (jitter->nb_packets)
+      remove_packet(jitter, 0, 0);
+   /* Hand out the low slots first */
+   jitter->order_head = 0;
    for (i=0;i<SPEEX_JITTER_MAX_BUFFER_SIZE;i++)
-   {
-      if (jitter->packets[i].data)
-      {
-         if (jitter->destroy)
-            jitter->destroy(jitter->packets[i].data);
-         else
-            speex_free(jitter->packets[i].data);
-         jitter->packets[i].data = NULL;
-      }
-   }
+      jitter->free_slots[i] = SPEEX_JITTER_MAX_BUFFER_SIZE-1-i;
+   jitter->nb_free = SPEEX_JITTER_MAX_BUFFER_SIZE;
    /* Timestamp is actually undefined at this point */
    jitter->pointer_timestamp = 0;
    jitter->next_stop = 0;
@@ -367,24 +447,25 @@ static void shift_timings(JitterBuffer *jitter, spx_int16_t amount)
 /** Put one packet into the jitter buffer */
 EXPORT void jitter_buffer_put(JitterBuffer *jitter, const JitterBufferPacket *packet)
 {
-   int i,j;
+   int i,k;
+   spx_uint32_t j;
    int late;
    /*fprintf (stderr, "put packet %d %d\n", timestamp, span);*/
    
-   /* Cleanup buffer (remove old packets that weren't played) */
+   /* Cleanup buffer (remove old packets that weren't played). Only packets
+      starting no later than pointer_timestamp can be over. */
    if (!jitter->reset_state)
    {
-      for (i=0;i<SPEEX_JITTER_MAX_BUFFER_SIZE;i++)
+      k=0;
+      while (k<jitter->nb_packets && LE32(PACKET_AT(jitter, k)->timestamp, jitter->pointer_timestamp))
       {
          /* Make sure we don't discard a "just-late" packet in case we want to play it next (if we interpolate). */
-         if (jitter->packets[i].data && LE32(jitter->packets[i].timestamp + jitter->packets[i].span, jitter->pointer_timestamp))
+         if (LE32(PACKET_AT(jitter, k)->timestamp + PACKET_AT(jitter, k)->span, jitter->pointer_timestamp))
          {
             /*fprintf (stderr, "cleaned (not played)\n");*/
-            if (jitter->destroy)
-               jitter->destroy(jitter->packets[i].data);
-            else
-               speex_free(jitter->packets[i].data);
-            jitter->packets[i].data = NULL;
+            remove_packet(jitter, k, 0);
+         } else {
+            k++;
          }
       }
    }
@@ -409,41 +490,31 @@ EXPORT void jitter_buffer_put(JitterBuffer *jitter, const JitterBufferPacket *pa
    /* Only insert the packet if it's not hopelessly late (i.e. totally useless) */
    if (jitter->reset_state || GE32(packet->timestamp+packet->span+jitter->delay_step, jitter->pointer_timestamp))
    {
-
-      /*Find an empty slot in the buffer*/
-      for (i=0;i<SPEEX_JITTER_MAX_BUFFER_SIZE;i++)
+      if (!jitter->destroy && jitter->pool && packet->len > jitter->pool_packet_size)
       {
-         if (jitter->packets[i].data==NULL)
-            break;
+         speex_warning_int("jitter_buffer_put(): packet too large for the pool. Size is", packet->len);
+         return;
       }
-      
+
       /*No place left in the buffer, need to make room for it by discarding the oldest packet */
-      if (i==SPEEX_JITTER_MAX_BUFFER_SIZE)
+      if (jitter->nb_free==0)
       {
-         int earliest=jitter->packets[0].timestamp;
-         i=0;
-         for (j=1;j<SPEEX_JITTER_MAX_BUFFER_SIZE;j++)
-         {
-            if (!jitter->packets[i].data || LT32(jitter->packets[j].timestamp,earliest))
-            {
-               earliest = jitter->packets[j].timestamp;
-               i=j;
-            }
-         }
-         if (jitter->destroy)
-            jitter->destroy(jitter->packets[i].data);
-         else
-            speex_free(jitter->packets[i].data);
-         jitter->packets[i].data=NULL;
+         remove_packet(jitter, 0, 0);
          /*fprintf (stderr, "Buffer is full, discarding earliest frame %d (currently at %d)\n", timestamp, jitter->pointer_timestamp);*/      
       }
+      
+      /*Take an empty slot in the buffer*/
+      i = jitter->free_slots[--jitter->nb_free];
    
       /* Copy packet in buffer */
       if (jitter->destroy)
       {
          jitter->packets[i].data = packet->data;
       } else {
-         jitter->packets[i].data=(char*)speex_alloc(packet->len);
+         if (jitter->pool)
+            jitter->packets[i].data = jitter->pool + i*jitter->pool_packet_size;
+         else
+            jitter->packets[i].data=(char*)speex_alloc(packet->len);
          for (j=0;j<packet->len;j++)
             jitter->packets[i].data[j]=packet->data[j];
       }
@@ -456,6 +527,7 @@ EXPORT void jitter_buffer_put(JitterBuffer *jitter, const JitterBufferPacket *pa
          jitter->arrival[i] = 0;
       else
          jitter->arrival[i] = jitter->next_stop;
+      order_insert(jitter, i);
    }
    
    
@@ -464,7 +536,7 @@ EXPORT void jitter_buffer_put(JitterBuffer *jitter, const JitterBufferPacket *pa
 /** Get one packet from the jitter buffer */
 EXPORT int jitter_buffer_get(JitterBuffer *jitter, JitterBufferPacket *packet, spx_int32_t desired_span, spx_int32_t *start_offset)
 {
-   int i;
+   int i, k, first, last;
    unsigned int j;
    int incomplete = 0;
    spx_int16_t opt;
@@ -475,19 +547,10 @@ EXPORT int jitter_buffer_get(JitterBuffer *jitter, JitterBufferPacket *packet, s
    /* Syncing on the first call */
    if (jitter->reset_state)
    {
-      int found = 0;
       /* Find the oldest packet */
-      spx_uint32_t oldest=0;
-      for (i=0;i<SPEEX_JITTER_MAX_BUFFER_SIZE;i++)
-      {
-         if (jitter->packets[i].data && (!found || LT32(jitter->packets[i].timestamp,oldest)))
-         {
-            oldest = jitter->packets[i].timestamp;
-            found = 1;
-         }
-      }
-      if (found)
+      if (jitter->nb_packets)
       {
+         spx_uint32_t oldest = PACKET_AT(jitter, 0)->timestamp;
          jitter->reset_state=0;         
          jitter->pointer_timestamp = oldest;
          jitter->next_stop = oldest;
@@ -518,68 +581,66 @@ EXPORT int jitter_buffer_get(JitterBuffer *jitter, JitterBufferPacket *packet, s
       return JITTER_BUFFER_INSERTION;
    }
    
-   /* Searching for the packet that fits best */
+   /* Searching for the packet that fits best. Packets are sorted by timestamp, so
+      [0,first) start before pointer_timestamp, [first,last) start right on it and the
+      cleanup in jitter_buffer_put() keeps the older range short. */
+   first = order_lower_bound(jitter, jitter->pointer_timestamp);
+   last = order_upper_bound(jitter, jitter->pointer_timestamp);
    
    /* Search the buffer for a packet with the right timestamp and spanning the whole current chunk */
-   for (i=0;i<SPEEX_JITTER_MAX_BUFFER_SIZE;i++)
+   for (k=first;k<last;k++)
    {
-      if (jitter->packets[i].data && jitter->packets[i].timestamp==jitter->pointer_timestamp && GE32(jitter->packets[i].timestamp+jitter->packets[i].span,jitter->pointer_timestamp+desired_span))
+      if (GE32(PACKET_AT(jitter, k)->timestamp+PACKET_AT(jitter, k)->span,jitter->pointer_timestamp+desired_span))
          break;
    }
    
    /* If no match, try for an "older" packet that still spans (fully) the current chunk */
-   if (i==SPEEX_JITTER_MAX_BUFFER_SIZE)
+   if (k==last)
    {
-      for (i=0;i<SPEEX_JITTER_MAX_BUFFER_SIZE;i++)
+      for (k=0;k<first;k++)
       {
-         if (jitter->packets[i].data && LE32(jitter->packets[i].timestamp, jitter->pointer_timestamp) && GE32(jitter->packets[i].timestamp+jitter->packets[i].span,jitter->pointer_timestamp+desired_span))
+         if (GE32(PACKET_AT(jitter, k)->timestamp+PACKET_AT(jitter, k)->span,jitter->pointer_timestamp+desired_span))
             break;
       }
+      if (k==first)
+         k = last;
    }
    
    /* If still no match, try for an "older" packet that spans part of the current chunk */
-   if (i==SPEEX_JITTER_MAX_BUFFER_SIZE)
+   if (k==last)
    {
-      for (i=0;i<SPEEX_JITTER_MAX_BUFFER_SIZE;i++)
+      for (k=0;k<last;k++)
       {
-         if (jitter->packets[i].data && LE32(jitter->packets[i].timestamp, jitter->pointer_timestamp) && GT32(jitter->packets[i].timestamp+jitter->packets[i].span,jitter->pointer_timestamp))
+         if (GT32(PACKET_AT(jitter, k)->timestamp+PACKET_AT(jitter, k)->span,jitter->pointer_timestamp))
             break;
       }
    }
    
    /* If still no match, try for earliest packet possible */
-   if (i==SPEEX_JITTER_MAX_BUFFER_SIZE)
+   if (k==last)
    {
-      int found = 0;
-      spx_uint32_t best_time=0;
-      int best_span=0;
-      int besti=0;
-      for (i=0;i<SPEEX_JITTER_MAX_BUFFER_SIZE;i++)
+      /* check if packet starts within current chunk */
+      k = first;
+      if (k<jitter->nb_packets && LT32(PACKET_AT(jitter, k)->timestamp,jitter->pointer_timestamp+desired_span))
       {
-         /* check if packet starts within current chunk */
-         if (jitter->packets[i].data && LT32(jitter->packets[i].timestamp,jitter->pointer_timestamp+desired_span) && GE32(jitter->packets[i].timestamp,jitter->pointer_timestamp))
+         /* Of the packets sharing the earliest timestamp, take the longest */
+         for (j=k+1;j<(unsigned int)jitter->nb_packets && PACKET_AT(jitter, j)->timestamp==PACKET_AT(jitter, k)->timestamp;j++)
          {
-            if (!found || LT32(jitter->packets[i].timestamp,best_time) || (jitter->packets[i].timestamp==best_time && GT32(jitter->packets[i].span,best_span)))
-            {
-               best_time = jitter->packets[i].timestamp;
-               best_span = jitter->packets[i].span;
-               besti = i;
-               found = 1;
-            }
+            if (GT32(PACKET_AT(jitter, j)->span,PACKET_AT(jitter, k)->span))
+               k = j;
          }
-      }
-      if (found)
-      {
-         i=besti;
          incomplete = 1;
-         /*fprintf (stderr, "incomplete: %d %d %d %d\n", jitter->packets[i].timestamp, jitter->pointer_timestamp, chunk_size, jitter->packets[i].span);*/
+         /*fprintf (stderr, "incomplete: %d %d %d %d\n", PACKET_AT(jitter, k)->timestamp, jitter->pointer_timestamp, chunk_size, PACKET_AT(jitter, k)->span);*/
+      } else {
+         k = jitter->nb_packets;
       }
    }
 
    /* If we find something */
-   if (i!=SPEEX_JITTER_MAX_BUFFER_SIZE)
+   if (k<jitter->nb_packets)
    {
       spx_int32_t offset;
+      i = ORDER(jitter, k);
       
       /* We (obviously) haven't lost this packet */
       jitter->lost_count = 0;
@@ -605,10 +666,9 @@ EXPORT int jitter_buffer_get(JitterBuffer *jitter, JitterBufferPacket *packet, s
          }
          for (j=0;j<packet->len;j++)
             packet->data[j] = jitter->packets[i].data[j];
-         /* Remove packet */
-         speex_free(jitter->packets[i].data);
       }
-      jitter->packets[i].data = NULL;
+      /* Remove packet */
+      remove_packet(jitter, k, 1);
       /* Set timestamp and span (if requested) */
       offset = (spx_int32_t)jitter->packets[i].timestamp-(spx_int32_t)jitter->pointer_timestamp;
       if (start_offset != NULL)
@@ -679,14 +739,12 @@ EXPORT int jitter_buffer_get(JitterBuffer *jitter, JitterBufferPacket *packet, s
 
 EXPORT int jitter_buffer_get_another(JitterBuffer *jitter, JitterBufferPacket *packet)
 {
-   int i, j;
-   for (i=0;i<SPEEX_JITTER_MAX_BUFFER_SIZE;i++)
-   {
-      if (jitter->packets[i].data && jitter->packets[i].timestamp==jitter->last_returned_timestamp)
-         break;
-   }
-   if (i!=SPEEX_JITTER_MAX_BUFFER_SIZE)
+   int i, k;
+   spx_uint32_t j;
+   k = order_lower_bound(jitter, jitter->last_returned_timestamp);
+   if (k<jitter->nb_packets && PACKET_AT(jitter, k)->timestamp==jitter->last_returned_timestamp)
    {
+      i = ORDER(jitter, k);
       /* Copy packet */
       packet->len = jitter->packets[i].len;
       if (jitter->destroy)
@@ -695,10 +753,9 @@ EXPORT int jitter_buffer_get_another(JitterBuffer *jitter, JitterBufferPacket *p
       } else {
          for (j=0;j<packet->len;j++)
             packet->data[j] = jitter->packets[i].data[j];
-         /* Remove packet */
-         speex_free(jitter->packets[i].data);
       }
-      jitter->packets[i].data = NULL;
+      /* Remove packet */
+      remove_packet(jitter, k, 1);
       packet->timestamp = jitter->packets[i].timestamp;
       packet->span = jitter->packets[i].span;
       packet->sequence = jitter->packets[i].sequence;
@@ -712,6 +769,16 @@ EXPORT int jitter_buffer_get_another(JitterBuffer *jitter, JitterBufferPacket *p
    }
 }
 
+EXPORT int jitter_buffer_set_pool(JitterBuffer *jitter, char *pool, spx_uint32_t packet_size)
+{
+   /* Buffered payloads belong to the current storage */
+   if (jitter->nb_packets)
+      return -1;
+   jitter->pool = pool;
+   jitter->pool_packet_size = pool ? packet_size : 0;
+   return 0;
+}
+
 /* Let the jitter buffer know it's the right time to adjust the buffering delay to the network conditions */
 static int _jitter_buffer_update_delay(JitterBuffer *jitter, JitterBufferPacket *packet, spx_int32_t *start_offset)
 {
@@ -782,7 +849,6 @@ EXPORT void jitter_buffer_remaining_span(JitterBuffer *jitter, spx_uint32_t rem)
 /* Used like the ioctl function to control the jitter buffer parameters */
 EXPORT int jitter_buffer_ctl(JitterBuffer *jitter, int request, void *ptr)
 {
-   int count, i;
    switch(request)
    {
       case JITTER_BUFFER_SET_MARGIN:
@@ -792,15 +858,7 @@ EXPORT int jitter_buffer_ctl(JitterBuffer *jitter, int request, void *ptr)
          *(spx_int32_t*)ptr = jitter->buffer_margin;
          break;
       case JITTER_BUFFER_GET_AVALIABLE_COUNT:
-         count = 0;
-         for (i=0;i<SPEEX_JITTER_MAX_BUFFER_SIZE;i++)
-         {
-            if (jitter->packets[i].data && LE32(jitter->pointer_timestamp, jitter->packets[i].timestamp))
-            {
-               count++;
-            }
-         }
-         *(spx_int32_t*)ptr = count;
+         *(spx_int32_t*)ptr = jitter->nb_packets - order_lower_bound(jitter, jitter->pointer_timestamp);
          break;
       case JITTER_BUFFER_SET_DESTROY_CALLBACK:
          jitter->destroy = (void (*) (void *))ptr;
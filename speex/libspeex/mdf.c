@@ -76,6 +76,10 @@
 #include "math_approx.h"
 #include "os_support.h"
 
+#if defined(_USE_SSE) || (defined(_USE_AVX2) && !defined(FIXED_POINT))
+#include "mdf_sse.h"
+#endif
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -242,6 +246,7 @@ static inline void power_spectrum(const spx_word16_t *X, spx_word32_t *ps, int N
    ps[j]=MULT16_16(X[i],X[i]);
 }
 
+#ifndef OVERRIDE_POWER_SPECTRUM_ACCUM
 /** Compute power spectrum of a half-complex (packed) vector and accumulate */
 static inline void power_spectrum_accum(const spx_word16_t *X, spx_word32_t *ps, int N)
 {
@@ -253,6 +258,7 @@ static inline void power_spectrum_accum(const spx_word16_t *X, spx_word32_t *ps,
    }
    ps[j]+=MULT16_16(X[i],X[i]);
 }
+#endif /* OVERRIDE_POWER_SPECTRUM_ACCUM */
 
 /** Compute cross-power spectrum of a half-complex (packed) vectors and add to acc */
 #ifdef FIXED_POINT
@@ -312,6 +318,7 @@ static inline void spectral_mul_accum16(const spx_word16_t *X, const spx_word16_
 }
 
 #else
+#ifndef OVERRIDE_SPECTRAL_MUL_ACCUM
 static inline void spectral_mul_accum(const spx_word16_t *X, const spx_word32_t *Y, spx_word16_t *acc, int N, int M)
 {
    int i,j;
@@ -330,9 +337,11 @@ static inline void spectral_mul_accum(const spx_word16_t *X, const spx_word32_t
       Y += N;
    }
 }
+#endif /* OVERRIDE_SPECTRAL_MUL_ACCUM */
 #define spectral_mul_accum16 spectral_mul_accum
 #endif
 
+#ifndef OVERRIDE_WEIGHTED_SPECTRAL_MUL_CONJ
 /** Compute weighted cross-power spectrum of a half-complex (packed) vector with conjugate */
 static inline void weighted_spectral_mul_conj(const spx_float_t *w, const spx_float_t p, const spx_word16_t *X, const spx_word16_t *Y, spx_word32_t *prod, int N)
 {
@@ -349,6 +358,7 @@ static inline void weighted_spectral_mul_conj(const spx_float_t *w, const spx_fl
    W = FLOAT_AMULT(p, w[j]);
    prod[i] = FLOAT_MUL32(W,MULT16_16(X[i],Y[i]));
 }
+#endif /* OVERRIDE_WEIGHTED_SPECTRAL_MUL_CONJ */
 
 static inline void mdf_adjust_prop(const spx_word32_t *W, int N, int M, int P, spx_word16_t *prop)
 {
@@ -0,0 +1,117 @@
+/**
+   @file mdf_sse.h
+   @brief Echo canceller spectral kernels (SSE version)
+*/
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   - Neither the name of the Xiph.org Foundation nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE FOUNDATION OR
+   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/* The spectra are half-complex: X[0] is the DC bin, X[N-1] the Nyquist bin
+   and the pairs in between start at the odd index X[1], so every load is
+   unaligned and each 4-wide vector holds two complex bins. The operations are
+   done in the same order as the generic code, so the output is identical. */
+
+#include <xmmintrin.h>
+
+#define OVERRIDE_POWER_SPECTRUM_ACCUM
+static inline void power_spectrum_accum(const float *X, float *ps, int N)
+{
+   int i, j;
+   ps[0] += X[0]*X[0];
+   for (i=1,j=1;i+8<N;i+=8,j+=4)
+   {
+      __m128 a = _mm_loadu_ps(X+i);
+      __m128 b = _mm_loadu_ps(X+i+4);
+      a = _mm_mul_ps(a, a);
+      b = _mm_mul_ps(b, b);
+      a = _mm_add_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0)), _mm_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1)));
+      _mm_storeu_ps(ps+j, _mm_add_ps(_mm_loadu_ps(ps+j), a));
+   }
+   for (;i<N-1;i+=2,j++)
+   {
+      ps[j] += X[i]*X[i] + X[i+1]*X[i+1];
+   }
+   ps[j] += X[i]*X[i];
+}
+
+#define OVERRIDE_SPECTRAL_MUL_ACCUM
+static inline void spectral_mul_accum(const float *X, const float *Y, float *acc, int N, int M)
+{
+   int i,j;
+   const __m128 sign = _mm_setr_ps(-0.f, 0.f, -0.f, 0.f);
+   for (i=0;i<N;i++)
+      acc[i] = 0;
+   for (j=0;j<M;j++)
+   {
+      acc[0] += X[0]*Y[0];
+      for (i=1;i+4<N;i+=4)
+      {
+         __m128 x = _mm_loadu_ps(X+i);
+         __m128 y = _mm_loadu_ps(Y+i);
+         /* [xr*yr, xi*yr] + [-xi*yi, xr*yi] */
+         __m128 re = _mm_mul_ps(x, _mm_shuffle_ps(y, y, _MM_SHUFFLE(2,2,0,0)));
+         __m128 im = _mm_mul_ps(_mm_shuffle_ps(x, x, _MM_SHUFFLE(2,3,0,1)), _mm_shuffle_ps(y, y, _MM_SHUFFLE(3,3,1,1)));
+         _mm_storeu_ps(acc+i, _mm_add_ps(_mm_loadu_ps(acc+i), _mm_add_ps(re, _mm_xor_ps(im, sign))));
+      }
+      for (;i<N-1;i+=2)
+      {
+         acc[i] += (X[i]*Y[i] - X[i+1]*Y[i+1]);
+         acc[i+1] += (X[i+1]*Y[i] + X[i]*Y[i+1]);
+      }
+      acc[i] += X[i]*Y[i];
+      X += N;
+      Y += N;
+   }
+}
+
+#define OVERRIDE_WEIGHTED_SPECTRAL_MUL_CONJ
+static inline void weighted_spectral_mul_conj(const float *w, const float p, const float *X, const float *Y, float *prod, int N)
+{
+   int i, j;
+   const __m128 sign = _mm_setr_ps(0.f, -0.f, 0.f, -0.f);
+   const __m128 p4 = _mm_set1_ps(p);
+   prod[0] = (p*w[0])*(X[0]*Y[0]);
+   for (i=1,j=1;i+4<N;i+=4,j+=2)
+   {
+      __m128 x = _mm_loadu_ps(X+i);
+      __m128 y = _mm_loadu_ps(Y+i);
+      __m128 W = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(w+j));
+      /* [xr*yr, -xi*yr] + [xi*yi, xr*yi] */
+      __m128 re = _mm_mul_ps(x, _mm_shuffle_ps(y, y, _MM_SHUFFLE(2,2,0,0)));
+      __m128 im = _mm_mul_ps(_mm_shuffle_ps(x, x, _MM_SHUFFLE(2,3,0,1)), _mm_shuffle_ps(y, y, _MM_SHUFFLE(3,3,1,1)));
+      W = _mm_mul_ps(p4, _mm_unpacklo_ps(W, W));
+      _mm_storeu_ps(prod+i, _mm_mul_ps(W, _mm_add_ps(_mm_xor_ps(re, sign), im)));
+   }
+   for (;i<N-1;i+=2,j++)
+   {
+      float W = p*w[j];
+      prod[i] = W*(X[i]*Y[i] + X[i+1]*Y[i+1]);
+      prod[i+1] = W*(-X[i+1]*Y[i] + X[i]*Y[i+1]);
+   }
+   prod[i] = (p*w[j])*(X[i]*Y[i]);
+}
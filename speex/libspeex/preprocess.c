@@ -318,7 +318,7 @@ static inline spx_word16_t qcurve(spx_word16_t x)
 }
 
 /* Compute the gain floor based on different floors for the background noise and residual echo */
-static void compute_gain_floor(int noise_suppress, int effective_echo_suppress, spx_word32_t *noise, spx_word32_t *echo, spx_word16_t *gain_floor, int len)
+static void compute_gain_floor(int noise_suppress, int effective_echo_suppress, spx_word32_t *noise, spx_word32_t *echo, spx_word16_t *gain_floor, int len, int stride)
 {
    int i;
    
@@ -329,7 +329,7 @@ static void compute_gain_floor(int noise_suppress, int effective_echo_suppress,
       gain_ratio = EXTRACT16(MIN32(Q15_ONE,SHR32(spx_exp(MULT16_16(QCONST16(.2302585f,11),effective_echo_suppress-noise_suppress)),1)));
 
       /* gain_floor = sqrt [ (noise*noise_floor + echo*echo_floor) / (noise+echo) ] */
-      for (i=0;i<len;i++)
+      for (i=0;i<len*stride;i+=stride)
          gain_floor[i] = MULT16_16_Q15(noise_gain,
                                        spx_sqrt(SHL32(EXTEND32(DIV32_16_Q15(PSHR32(noise[i],NOISE_SHIFT) + MULT16_32_Q15(gain_ratio,echo[i]),
                                              (1+PSHR32(noise[i],NOISE_SHIFT) + echo[i]) )),15)));
@@ -339,7 +339,7 @@ static void compute_gain_floor(int noise_suppress, int effective_echo_suppress,
       gain_ratio = EXTRACT16(MIN32(Q15_ONE,SHR32(spx_exp(MULT16_16(QCONST16(.2302585f,11),noise_suppress-effective_echo_suppress)),1)));
 
       /* gain_floor = sqrt [ (noise*noise_floor + echo*echo_floor) / (noise+echo) ] */
-      for (i=0;i<len;i++)
+      for (i=0;i<len*stride;i+=stride)
          gain_floor[i] = MULT16_16_Q15(echo_gain,
                                        spx_sqrt(SHL32(EXTEND32(DIV32_16_Q15(MULT16_32_Q15(gain_ratio,PSHR32(noise[i],NOISE_SHIFT)) + echo[i],
                                              (1+PSHR32(noise[i],NOISE_SHIFT) + echo[i]) )),15)));
@@ -377,7 +377,7 @@ static inline spx_word16_t qcurve(spx_word16_t x)
    return 1.f/(1.f+.15f/(SNR_SCALING_1*x));
 }
 
-static void compute_gain_floor(int noise_suppress, int effective_echo_suppress, spx_word32_t *noise, spx_word32_t *echo, spx_word16_t *gain_floor, int len)
+static void compute_gain_floor(int noise_suppress, int effective_echo_suppress, spx_word32_t *noise, spx_word32_t *echo, spx_word16_t *gain_floor, int len, int stride)
 {
    int i;
    float echo_floor;
@@ -387,17 +387,14 @@ static void compute_gain_floor(int noise_suppress, int effective_echo_suppress,
    echo_floor = exp(.2302585f*effective_echo_suppress);
 
    /* Compute the gain floor based on different floors for the background noise and residual echo */
-   for (i=0;i<len;i++)
+   for (i=0;i<len*stride;i+=stride)
       gain_floor[i] = FRAC_SCALING*sqrt(noise_floor*PSHR32(noise[i],NOISE_SHIFT) + echo_floor*echo[i])/sqrt(1+PSHR32(noise[i],NOISE_SHIFT) + echo[i]);
 }
 
 #endif
-EXPORT SpeexPreprocessState *speex_preprocess_state_init(int frame_size, int sampling_rate)
+/* Parameters and per-stream scalars, common to single states and batch streams */
+static void preprocess_init_params(SpeexPreprocessState *st, int frame_size, int sampling_rate)
 {
-   int i;
-   int N, N3, N4, M;
-
-   SpeexPreprocessState *st = (SpeexPreprocessState *)speex_alloc(sizeof(SpeexPreprocessState));
    st->frame_size = frame_size;
 
    /* Round ps_size down to the nearest power of two */
@@ -422,10 +419,6 @@ EXPORT SpeexPreprocessState *speex_preprocess_state_init(int frame_size, int sam
    st->ps_size = st->frame_size;
 #endif
 
-   N = st->ps_size;
-   N3 = 2*N - st->frame_size;
-   N4 = st->frame_size - N3;
-   
    st->sampling_rate = sampling_rate;
    st->denoise_enabled = 1;
    st->vad_enabled = 0;
@@ -442,6 +435,71 @@ EXPORT SpeexPreprocessState *speex_preprocess_state_init(int frame_size, int sam
    st->echo_state = NULL;
    
    st->nbands = NB_BANDS;
+
+#ifndef FIXED_POINT
+   st->agc_enabled = 0;
+   st->agc_level = 8000;
+   /*st->loudness = pow(AMP_SCALE*st->agc_level,LOUDNESS_EXP);*/
+   st->loudness = 1e-15;
+   st->agc_gain = 1;
+   st->max_gain = 30;
+   st->max_increase_step = exp(0.11513f * 12.*st->frame_size / st->sampling_rate);
+   st->max_decrease_step = exp(-0.11513f * 40.*st->frame_size / st->sampling_rate);
+   st->prev_loudness = 1;
+   st->init_max = 1;
+#endif
+   st->was_speech = 0;
+
+   st->nb_adapt=0;
+   st->min_count=0;
+}
+
+static void preprocess_init_window(spx_word16_t *window, int N, int frame_size)
+{
+   int i;
+   int N3 = 2*N - frame_size;
+   int N4 = frame_size - N3;
+
+   conj_window(window, 2*N3);
+   for (i=2*N3;i<2*N;i++)
+      window[i]=Q15_ONE;
+   
+   if (N4>0)
+   {
+      for (i=N3-1;i>=0;i--)
+      {
+         window[i+N3+N4]=window[i+N3];
+         window[i+N3]=1;
+      }
+   }
+}
+
+#ifndef FIXED_POINT
+static void preprocess_init_loudness_weight(float *loudness_weight, int N, int sampling_rate)
+{
+   int i;
+   for (i=0;i<N;i++)
+   {
+      float ff=((float)i)*.5*sampling_rate/((float)N);
+      /*loudness_weight[i] = .5f*(1.f/(1.f+ff/8000.f))+1.f*exp(-.5f*(ff-3800.f)*(ff-3800.f)/9e5f);*/
+      loudness_weight[i] = .35f-.35f*ff/16000.f+.73f*exp(-.5f*(ff-3800)*(ff-3800)/9e5f);
+      if (loudness_weight[i]<.01f)
+         loudness_weight[i]=.01f;
+      loudness_weight[i] *= loudness_weight[i];
+   }
+}
+#endif
+
+EXPORT SpeexPreprocessState *speex_preprocess_state_init(int frame_size, int sampling_rate)
+{
+   int i;
+   int N, N3, M;
+
+   SpeexPreprocessState *st = (SpeexPreprocessState *)speex_alloc(sizeof(SpeexPreprocessState));
+   preprocess_init_params(st, frame_size, sampling_rate);
+
+   N = st->ps_size;
+   N3 = 2*N - st->frame_size;
    M = st->nbands;
    st->bank = filterbank_new(M, sampling_rate, N, 1);
    
@@ -470,18 +528,7 @@ EXPORT SpeexPreprocessState *speex_preprocess_state_init(int frame_size, int sam
    st->inbuf = (spx_word16_t*)speex_alloc(N3*sizeof(spx_word16_t));
    st->outbuf = (spx_word16_t*)speex_alloc(N3*sizeof(spx_word16_t));
 
-   conj_window(st->window, 2*N3);
-   for (i=2*N3;i<2*st->ps_size;i++)
-      st->window[i]=Q15_ONE;
-   
-   if (N4>0)
-   {
-      for (i=N3-1;i>=0;i--)
-      {
-         st->window[i+N3+N4]=st->window[i+N3];
-         st->window[i+N3]=1;
-      }
-   }
+   preprocess_init_window(st->window, N, st->frame_size);
    for (i=0;i<N+M;i++)
    {
       st->noise[i]=QCONST32(1.f,NOISE_SHIFT);
@@ -500,33 +547,11 @@ EXPORT SpeexPreprocessState *speex_preprocess_state_init(int frame_size, int sam
       st->outbuf[i]=0;
    }
 #ifndef FIXED_POINT
-   st->agc_enabled = 0;
-   st->agc_level = 8000;
    st->loudness_weight = (float*)speex_alloc(N*sizeof(float));
-   for (i=0;i<N;i++)
-   {
-      float ff=((float)i)*.5*sampling_rate/((float)N);
-      /*st->loudness_weight[i] = .5f*(1.f/(1.f+ff/8000.f))+1.f*exp(-.5f*(ff-3800.f)*(ff-3800.f)/9e5f);*/
-      st->loudness_weight[i] = .35f-.35f*ff/16000.f+.73f*exp(-.5f*(ff-3800)*(ff-3800)/9e5f);
-      if (st->loudness_weight[i]<.01f)
-         st->loudness_weight[i]=.01f;
-      st->loudness_weight[i] *= st->loudness_weight[i];
-   }
-   /*st->loudness = pow(AMP_SCALE*st->agc_level,LOUDNESS_EXP);*/
-   st->loudness = 1e-15;
-   st->agc_gain = 1;
-   st->max_gain = 30;
-   st->max_increase_step = exp(0.11513f * 12.*st->frame_size / st->sampling_rate);
-   st->max_decrease_step = exp(-0.11513f * 40.*st->frame_size / st->sampling_rate);
-   st->prev_loudness = 1;
-   st->init_max = 1;
+   preprocess_init_loudness_weight(st->loudness_weight, N, sampling_rate);
 #endif
-   st->was_speech = 0;
 
    st->fft_lookup = spx_fft_init(2*N);
-
-   st->nb_adapt=0;
-   st->min_count=0;
    return st;
 }
 
@@ -657,8 +682,6 @@ static void preprocess_analysis(SpeexPreprocessState *st, spx_int16_t *x)
       ps[i]=MULT16_16(st->ft[2*i-1],st->ft[2*i-1]) + MULT16_16(st->ft[2*i],st->ft[2*i]);
    for (i=0;i<N;i++)
       st->ps[i] = PSHR32(st->ps[i], 2*st->frame_shift);
-
-   filterbank_compute_bank32(st->bank, ps, ps+N);
 }
 
 static void update_noise_prob(SpeexPreprocessState *st)
@@ -714,6 +737,88 @@ static void update_noise_prob(SpeexPreprocessState *st)
 
 }
 
+/* Apply the gains in st->gain2 to the spectrum from preprocess_analysis() and
+   overlap-add the result back into x */
+static void preprocess_synthesis(SpeexPreprocessState *st, spx_word16_t Pframe, spx_int16_t *x)
+{
+   int i;
+   int N = st->ps_size;
+   int N3 = 2*N - st->frame_size;
+   int N4 = st->frame_size - N3;
+
+   /* Apply computed gain */
+   for (i=1;i<N;i++)
+   {
+      st->ft[2*i-1] = MULT16_16_P15(st->gain2[i],st->ft[2*i-1]);
+      st->ft[2*i] = MULT16_16_P15(st->gain2[i],st->ft[2*i]);
+   }
+   st->ft[0] = MULT16_16_P15(st->gain2[0],st->ft[0]);
+   st->ft[2*N-1] = MULT16_16_P15(st->gain2[N-1],st->ft[2*N-1]);
+   
+   /*FIXME: This *will* not work for fixed-point */
+#ifndef FIXED_POINT
+   if (st->agc_enabled)
+      speex_compute_agc(st, Pframe, st->ft);
+#endif
+
+   /* Inverse FFT with 1/N scaling */
+   spx_ifft(st->fft_lookup, st->ft, st->frame);
+   /* Scale back to original (lower) amplitude */
+   for (i=0;i<2*N;i++)
+      st->frame[i] = PSHR16(st->frame[i], st->frame_shift);
+
+   /*FIXME: This *will* not work for fixed-point */
+#ifndef FIXED_POINT
+   if (st->agc_enabled)
+   {
+      float max_sample=0;
+      for (i=0;i<2*N;i++)
+         if (fabs(st->frame[i])>max_sample)
+            max_sample = fabs(st->frame[i]);
+      if (max_sample>28000.f)
+      {
+         float damp = 28000.f/max_sample;
+         for (i=0;i<2*N;i++)
+            st->frame[i] *= damp;
+      }
+   }
+#endif
+   
+   /* Synthesis window (for WOLA) */
+   for (i=0;i<2*N;i++)
+      st->frame[i] = MULT16_16_Q15(st->frame[i], st->window[i]);
+
+   /* Perform overlap and add */
+   for (i=0;i<N3;i++)
+      x[i] = st->outbuf[i] + st->frame[i];
+   for (i=0;i<N4;i++)
+      x[N3+i] = st->frame[N3+i];
+   
+   /* Update outbuf */
+   for (i=0;i<N3;i++)
+      st->outbuf[i] = st->frame[st->frame_size+i];
+}
+
+static int preprocess_vad(SpeexPreprocessState *st, spx_word16_t Pframe)
+{
+   /* FIXME: This VAD is a kludge */
+   st->speech_prob = Pframe;
+   if (st->vad_enabled)
+   {
+      if (st->speech_prob > st->speech_prob_start || (st->was_speech && st->speech_prob > st->speech_prob_continue))
+      {
+         st->was_speech=1;
+         return 1;
+      } else
+      {
+         st->was_speech=0;
+         return 0;
+      }
+   } else {
+      return 1;
+   }
+}
+
 #define NOISE_OVERCOMPENS 1.
 
 void speex_echo_get_residual(SpeexEchoState *st, spx_word32_t *Yout, int len);
@@ -728,8 +833,6 @@ EXPORT int speex_preprocess_run(SpeexPreprocessState *st, spx_int16_t *x)
    int i;
    int M;
    int N = st->ps_size;
-   int N3 = 2*N - st->frame_size;
-   int N4 = st->frame_size - N3;
    spx_word32_t *ps=st->ps;
    spx_word32_t Zframe;
    spx_word16_t Pframe;
@@ -764,6 +867,7 @@ EXPORT int speex_preprocess_run(SpeexPreprocessState *st, spx_int16_t *x)
          st->echo_noise[i] = 0;
    }
    preprocess_analysis(st, x);
+   filterbank_compute_bank32(st->bank, ps, ps+N);
 
    update_noise_prob(st);
 
@@ -826,7 +930,7 @@ EXPORT int speex_preprocess_run(SpeexPreprocessState *st, spx_int16_t *x)
    
    effective_echo_suppress = EXTRACT16(PSHR32(ADD32(MULT16_16(SUB16(Q15_ONE,Pframe), st->echo_suppress), MULT16_16(Pframe, st->echo_suppress_active)),15));
    
-   compute_gain_floor(st->noise_suppress, effective_echo_suppress, st->noise+N, st->echo_noise+N, st->gain_floor+N, M);
+   compute_gain_floor(st->noise_suppress, effective_echo_suppress, st->noise+N, st->echo_noise+N, st->gain_floor+N, M, 1);
          
    /* Compute Ephraim & Malah gain speech probability of presence for each critical band (Bark scale) 
       Technically this is actually wrong because the EM gaim assumes a slightly different probability 
@@ -940,74 +1044,9 @@ EXPORT int speex_preprocess_run(SpeexPreprocessState *st, spx_int16_t *x)
          st->gain2[i]=Q15_ONE;
    }
       
-   /* Apply computed gain */
-   for (i=1;i<N;i++)
-   {
-      st->ft[2*i-1] = MULT16_16_P15(st->gain2[i],st->ft[2*i-1]);
-      st->ft[2*i] = MULT16_16_P15(st->gain2[i],st->ft[2*i]);
-   }
-   st->ft[0] = MULT16_16_P15(st->gain2[0],st->ft[0]);
-   st->ft[2*N-1] = MULT16_16_P15(st->gain2[N-1],st->ft[2*N-1]);
-   
-   /*FIXME: This *will* not work for fixed-point */
-#ifndef FIXED_POINT
-   if (st->agc_enabled)
-      speex_compute_agc(st, Pframe, st->ft);
-#endif
+   preprocess_synthesis(st, Pframe, x);
 
-   /* Inverse FFT with 1/N scaling */
-   spx_ifft(st->fft_lookup, st->ft, st->frame);
-   /* Scale back to original (lower) amplitude */
-   for (i=0;i<2*N;i++)
-      st->frame[i] = PSHR16(st->frame[i], st->frame_shift);
-
-   /*FIXME: This *will* not work for fixed-point */
-#ifndef FIXED_POINT
-   if (st->agc_enabled)
-   {
-      float max_sample=0;
-      for (i=0;i<2*N;i++)
-         if (fabs(st->frame[i])>max_sample)
-            max_sample = fabs(st->frame[i]);
-      if (max_sample>28000.f)
-      {
-         float damp = 28000.f/max_sample;
-         for (i=0;i<2*N;i++)
-            st->frame[i] *= damp;
-      }
-   }
-#endif
-   
-   /* Synthesis window (for WOLA) */
-   for (i=0;i<2*N;i++)
-      st->frame[i] = MULT16_16_Q15(st->frame[i], st->window[i]);
-
-   /* Perform overlap and add */
-   for (i=0;i<N3;i++)
-      x[i] = st->outbuf[i] + st->frame[i];
-   for (i=0;i<N4;i++)
-      x[N3+i] = st->frame[N3+i];
-   
-   /* Update outbuf */
-   for (i=0;i<N3;i++)
-      st->outbuf[i] = st->frame[st->frame_size+i];
-
-   /* FIXME: This VAD is a kludge */
-   st->speech_prob = Pframe;
-   if (st->vad_enabled)
-   {
-      if (st->speech_prob > st->speech_prob_start || (st->was_speech && st->speech_prob > st->speech_prob_continue))
-      {
-         st->was_speech=1;
-         return 1;
-      } else
-      {
-         st->was_speech=0;
-         return 0;
-      }
-   } else {
-      return 1;
-   }
+   return preprocess_vad(st, Pframe);
 }
 
 EXPORT void speex_preprocess_estimate_update(SpeexPreprocessState *st, spx_int16_t *x)
@@ -1022,6 +1061,7 @@ EXPORT void speex_preprocess_estimate_update(SpeexPreprocessState *st, spx_int16
    st->min_count++;
    
    preprocess_analysis(st, x);
+   filterbank_compute_bank32(st->bank, ps, ps+N);
 
    update_noise_prob(st);
    
@@ -1214,6 +1254,444 @@ EXPORT int speex_preprocess_ctl(SpeexPreprocessState *state, int request, void *
    return 0;
 }
 
+/** Preprocessors for many streams run together. Tables that only depend on the
+    frame size and sampling rate are shared, and all the spectral estimation
+    state is stored bin-major with the streams interleaved (bin i of stream s at
+    [i*nb_streams+s]), so its loops run across streams with unit stride. */
+struct SpeexPreprocessBatch_ {
+   int    nb_streams;
+   int    frame_size;
+   int    ps_size;
+   int    nbands;
+   SpeexPreprocessState *streams; /**< Parameters and time-domain state of each stream */
+
+   /* Shared tables */
+   FilterBank *bank;
+   spx_word16_t *window;
+   void  *fft_lookup;
+#ifndef FIXED_POINT
+   float *loudness_weight;
+#endif
+
+   /* Per-stream buffers, stream-major */
+   spx_word16_t *frame;      /**< Processing frame (2*ps_size), used by one stream at a time */
+   spx_word16_t *ft;         /**< Frames in freq domain (nb_streams*2*ps_size) */
+   spx_word16_t *inbuf;
+   spx_word16_t *outbuf;
+
+   /* Interleaved spectral state, see SpeexPreprocessState for the meaning */
+   spx_word32_t *ps;
+   spx_word32_t *noise;
+   spx_word32_t *echo_noise;
+   spx_word32_t *old_ps;
+   spx_word16_t *prior;
+   spx_word16_t *post;
+   spx_word16_t *gain;
+   spx_word16_t *gain2;
+   spx_word16_t *gain_floor;
+   spx_word16_t *zeta;
+   spx_word32_t *S;
+   spx_word32_t *Smin;
+   spx_word32_t *Stmp;
+   int *update_prob;
+
+   /* Scratch */
+   spx_word32_t *column;     /**< Power spectrum or residual echo of one stream */
+   spx_word16_t *gain_column; /**< Gains of one stream */
+   spx_word32_t *Zframe;     /**< Per-stream sum of the band a priori SNRs */
+   spx_word16_t *Pframe;     /**< Per-stream speech probability */
+
+   /* All streams advance together, so the adaptation counters are shared */
+   int    nb_adapt;
+   int    min_count;
+};
+
+EXPORT SpeexPreprocessBatch *speex_preprocess_batch_init(int nb_streams, int frame_size, int sampling_rate)
+{
+   int i, s;
+   int N, N3, M, L;
+   SpeexPreprocessBatch *b;
+
+   if (nb_streams < 1)
+      return NULL;
+   b = (SpeexPreprocessBatch *)speex_alloc(sizeof(SpeexPreprocessBatch));
+   b->streams = (SpeexPreprocessState *)speex_alloc(nb_streams*sizeof(SpeexPreprocessState));
+   for (s=0;s<nb_streams;s++)
+      preprocess_init_params(&b->streams[s], frame_size, sampling_rate);
+
+   L = b->nb_streams = nb_streams;
+   b->frame_size = frame_size;
+   N = b->ps_size = b->streams[0].ps_size;
+   M = b->nbands = b->streams[0].nbands;
+   N3 = 2*N - frame_size;
+
+   b->bank = filterbank_new(M, sampling_rate, N, 1);
+   b->window = (spx_word16_t*)speex_alloc(2*N*sizeof(spx_word16_t));
+   preprocess_init_window(b->window, N, frame_size);
+   b->fft_lookup = spx_fft_init(2*N);
+#ifndef FIXED_POINT
+   b->loudness_weight = (float*)speex_alloc(N*sizeof(float));
+   preprocess_init_loudness_weight(b->loudness_weight, N, sampling_rate);
+#endif
+
+   b->frame = (spx_word16_t*)speex_alloc(2*N*sizeof(spx_word16_t));
+   b->ft = (spx_word16_t*)speex_alloc(L*2*N*sizeof(spx_word16_t));
+   b->inbuf = (spx_word16_t*)speex_alloc(L*N3*sizeof(spx_word16_t));
+   b->outbuf = (spx_word16_t*)speex_alloc(L*N3*sizeof(spx_word16_t));
+
+   b->ps = (spx_word32_t*)speex_alloc((N+M)*L*sizeof(spx_word32_t));
+   b->noise = (spx_word32_t*)speex_alloc((N+M)*L*sizeof(spx_word32_t));
+   b->echo_noise = (spx_word32_t*)speex_alloc((N+M)*L*sizeof(spx_word32_t));
+   b->old_ps = (spx_word32_t*)speex_alloc((N+M)*L*sizeof(spx_word32_t));
+   b->prior = (spx_word16_t*)speex_alloc((N+M)*L*sizeof(spx_word16_t));
+   b->post = (spx_word16_t*)speex_alloc((N+M)*L*sizeof(spx_word16_t));
+   b->gain = (spx_word16_t*)speex_alloc((N+M)*L*sizeof(spx_word16_t));
+   b->gain2 = (spx_word16_t*)speex_alloc((N+M)*L*sizeof(spx_word16_t));
+   b->gain_floor = (spx_word16_t*)speex_alloc((N+M)*L*sizeof(spx_word16_t));
+   b->zeta = (spx_word16_t*)speex_alloc((N+M)*L*sizeof(spx_word16_t));
+
+   b->S = (spx_word32_t*)speex_alloc(N*L*sizeof(spx_word32_t));
+   b->Smin = (spx_word32_t*)speex_alloc(N*L*sizeof(spx_word32_t));
+   b->Stmp = (spx_word32_t*)speex_alloc(N*L*sizeof(spx_word32_t));
+   b->update_prob = (int*)speex_alloc(N*L*sizeof(int));
+
+   b->column = (spx_word32_t*)speex_alloc((N+M)*sizeof(spx_word32_t));
+   b->gain_column = (spx_word16_t*)speex_alloc((N+M)*sizeof(spx_word16_t));
+   b->Zframe = (spx_word32_t*)speex_alloc(L*sizeof(spx_word32_t));
+   b->Pframe = (spx_word16_t*)speex_alloc(L*sizeof(spx_word16_t));
+
+   for (i=0;i<(N+M)*L;i++)
+   {
+      b->noise[i]=QCONST32(1.f,NOISE_SHIFT);
+      b->old_ps[i]=1;
+      b->gain[i]=Q15_ONE;
+      b->post[i]=SHL16(1, SNR_SHIFT);
+      b->prior[i]=SHL16(1, SNR_SHIFT);
+   }
+   for (i=0;i<N*L;i++)
+      b->update_prob[i] = 1;
+
+   /* The streams run the single-state analysis and synthesis code on their
+      own slice of the buffers, with the scratch columns as their spectra */
+   for (s=0;s<L;s++)
+   {
+      SpeexPreprocessState *st = &b->streams[s];
+      st->bank = b->bank;
+      st->window = b->window;
+      st->fft_lookup = b->fft_lookup;
+#ifndef FIXED_POINT
+      st->loudness_weight = b->loudness_weight;
+#endif
+      st->frame = b->frame;
+      st->ft = b->ft + s*2*N;
+      st->inbuf = b->inbuf + s*N3;
+      st->outbuf = b->outbuf + s*N3;
+      st->ps = b->column;
+      st->gain2 = b->gain_column;
+   }
+
+   b->nb_adapt = 0;
+   b->min_count = 0;
+   return b;
+}
+
+EXPORT void speex_preprocess_batch_destroy(SpeexPreprocessBatch *b)
+{
+   speex_free(b->frame);
+   speex_free(b->ft);
+   speex_free(b->inbuf);
+   speex_free(b->outbuf);
+   speex_free(b->ps);
+   speex_free(b->noise);
+   speex_free(b->echo_noise);
+   speex_free(b->old_ps);
+   speex_free(b->prior);
+   speex_free(b->post);
+   speex_free(b->gain);
+   speex_free(b->gain2);
+   speex_free(b->gain_floor);
+   speex_free(b->zeta);
+   speex_free(b->S);
+   speex_free(b->Smin);
+   speex_free(b->Stmp);
+   speex_free(b->update_prob);
+   speex_free(b->column);
+   speex_free(b->gain_column);
+   speex_free(b->Zframe);
+   speex_free(b->Pframe);
+#ifndef FIXED_POINT
+   speex_free(b->loudness_weight);
+#endif
+   speex_free(b->window);
+   spx_fft_destroy(b->fft_lookup);
+   filterbank_destroy(b->bank);
+   speex_free(b->streams);
+   speex_free(b);
+}
+
+/* The loops below do, per stream, exactly what speex_preprocess_run() does.
+   Loops over k run over every (bin, stream) pair of a range of bins; the
+   estimator has no dependency between streams, so they vectorize. */
+EXPORT void speex_preprocess_batch_run(SpeexPreprocessBatch *b, spx_int16_t **x, int *vad)
+{
+   int i, k, s;
+   int L = b->nb_streams;
+   int N = b->ps_size;
+   int M = b->nbands;
+   int NL = N*L;
+   int NML = (N+M)*L;
+   int min_range;
+   spx_word32_t *ps = b->ps;
+   spx_word16_t beta, beta_1;
+
+   b->nb_adapt++;
+   if (b->nb_adapt>20000)
+      b->nb_adapt = 20000;
+   b->min_count++;
+
+   beta = MAX16(QCONST16(.03,15),DIV32_16(Q15_ONE,b->nb_adapt));
+   beta_1 = Q15_ONE-beta;
+
+   /* Residual echo and analysis are per stream */
+   for (s=0;s<L;s++)
+   {
+      SpeexPreprocessState *st = &b->streams[s];
+      st->nb_adapt = b->nb_adapt;
+      if (st->echo_state)
+      {
+         speex_echo_get_residual(st->echo_state, b->column, N);
+#ifndef FIXED_POINT
+         if (!(b->column[0] >=0 && b->column[0]<N*1e9f))
+         {
+            for (i=0;i<N;i++)
+               b->column[i] = 0;
+         }
+#endif
+         for (i=0;i<N;i++)
+            b->echo_noise[i*L+s] = MAX32(MULT16_32_Q15(QCONST16(.6f,15),b->echo_noise[i*L+s]), b->column[i]);
+      } else {
+         for (i=0;i<N;i++)
+            b->echo_noise[i*L+s] = 0;
+      }
+      preprocess_analysis(st, x[s]);
+      for (i=0;i<N;i++)
+         ps[i*L+s] = b->column[i];
+   }
+   /* Bands of streams without an echo canceller come out as zero */
+   filterbank_compute_bank32_batch(b->bank, b->echo_noise, b->echo_noise+NL, L);
+   filterbank_compute_bank32_batch(b->bank, ps, ps+NL, L);
+
+   /* Noise probability update, see update_noise_prob() */
+   for (k=L;k<NL-L;k++)
+      b->S[k] =  MULT16_32_Q15(QCONST16(.8f,15),b->S[k]) + MULT16_32_Q15(QCONST16(.05f,15),ps[k-L])
+                      + MULT16_32_Q15(QCONST16(.1f,15),ps[k]) + MULT16_32_Q15(QCONST16(.05f,15),ps[k+L]);
+   for (k=0;k<L;k++)
+      b->S[k] =  MULT16_32_Q15(QCONST16(.8f,15),b->S[k]) + MULT16_32_Q15(QCONST16(.2f,15),ps[k]);
+   for (k=NL-L;k<NL;k++)
+      b->S[k] =  MULT16_32_Q15(QCONST16(.8f,15),b->S[k]) + MULT16_32_Q15(QCONST16(.2f,15),ps[k]);
+
+   if (b->nb_adapt==1)
+   {
+      for (k=0;k<NL;k++)
+         b->Smin[k] = b->Stmp[k] = 0;
+   }
+
+   if (b->nb_adapt < 100)
+      min_range = 15;
+   else if (b->nb_adapt < 1000)
+      min_range = 50;
+   else if (b->nb_adapt < 10000)
+      min_range = 150;
+   else
+      min_range = 300;
+   if (b->min_count > min_range)
+   {
+      b->min_count = 0;
+      for (k=0;k<NL;k++)
+      {
+         b->Smin[k] = MIN32(b->Stmp[k], b->S[k]);
+         b->Stmp[k] = b->S[k];
+      }
+   } else {
+      for (k=0;k<NL;k++)
+      {
+         b->Smin[k] = MIN32(b->Smin[k], b->S[k]);
+         b->Stmp[k] = MIN32(b->Stmp[k], b->S[k]);
+      }
+   }
+   for (k=0;k<NL;k++)
+      b->update_prob[k] = MULT16_32_Q15(QCONST16(.4f,15),b->S[k]) > b->Smin[k];
+
+   /* Update the noise estimate for the frequencies where it can be */
+   for (k=0;k<NL;k++)
+   {
+      spx_word32_t noise = MAX32(EXTEND32(0),MULT16_32_Q15(beta_1,b->noise[k]) + MULT16_32_Q15(beta,SHL32(ps[k],NOISE_SHIFT)));
+      b->noise[k] = (!b->update_prob[k] || ps[k] < PSHR32(b->noise[k], NOISE_SHIFT)) ? noise : b->noise[k];
+   }
+   filterbank_compute_bank32_batch(b->bank, b->noise, b->noise+NL, L);
+
+   if (b->nb_adapt==1)
+      for (k=0;k<NML;k++)
+         b->old_ps[k] = ps[k];
+
+   /* A posteriori and a priori SNR. There is no batch version of
+      speex_preprocess_estimate_update(), so the reverb estimate is zero. */
+   for (k=0;k<NML;k++)
+   {
+      spx_word16_t gamma, post, prior;
+      spx_word32_t old_ps = b->old_ps[k];
+      spx_word32_t tot_noise = ADD32(ADD32(EXTEND32(1), PSHR32(b->noise[k],NOISE_SHIFT)) , b->echo_noise[k]);
+
+      post = SUB16(DIV32_16_Q8(ps[k],tot_noise), QCONST16(1.f,SNR_SHIFT));
+      post = MIN16(post, QCONST16(100.f,SNR_SHIFT));
+
+      gamma = QCONST16(.1f,15)+MULT16_16_Q15(QCONST16(.89f,15),SQR16_Q15(DIV32_16_Q15(old_ps,ADD32(old_ps,tot_noise))));
+
+      prior = EXTRACT16(PSHR32(ADD32(MULT16_16(gamma,MAX16(0,post)), MULT16_16(Q15_ONE-gamma,DIV32_16_Q8(old_ps,tot_noise))), 15));
+      b->post[k] = post;
+      b->prior[k] = MIN16(prior, QCONST16(100.f,SNR_SHIFT));
+   }
+
+   /* Recursive average of the a priori SNR */
+   for (k=0;k<L;k++)
+      b->zeta[k] = PSHR32(ADD32(MULT16_16(QCONST16(.7f,15),b->zeta[k]), MULT16_16(QCONST16(.3f,15),b->prior[k])),15);
+   for (k=L;k<NL-L;k++)
+      b->zeta[k] = PSHR32(ADD32(ADD32(ADD32(MULT16_16(QCONST16(.7f,15),b->zeta[k]), MULT16_16(QCONST16(.15f,15),b->prior[k])),
+                           MULT16_16(QCONST16(.075f,15),b->prior[k-L])), MULT16_16(QCONST16(.075f,15),b->prior[k+L])),15);
+   for (k=NL-L;k<NML;k++)
+      b->zeta[k] = PSHR32(ADD32(MULT16_16(QCONST16(.7f,15),b->zeta[k]), MULT16_16(QCONST16(.3f,15),b->prior[k])),15);
+
+   /* Frame speech probability from the average band a priori SNR */
+   for (s=0;s<L;s++)
+      b->Zframe[s] = 0;
+   for (k=NL;k<NML;k+=L)
+      for (s=0;s<L;s++)
+         b->Zframe[s] = ADD32(b->Zframe[s], EXTEND32(b->zeta[k+s]));
+   for (s=0;s<L;s++)
+   {
+      SpeexPreprocessState *st = &b->streams[s];
+      spx_word16_t effective_echo_suppress;
+      b->Pframe[s] = QCONST16(.1f,15)+MULT16_16_Q15(QCONST16(.899f,15),qcurve(DIV32_16(b->Zframe[s],M)));
+      effective_echo_suppress = EXTRACT16(PSHR32(ADD32(MULT16_16(SUB16(Q15_ONE,b->Pframe[s]), st->echo_suppress), MULT16_16(b->Pframe[s], st->echo_suppress_active)),15));
+      compute_gain_floor(st->noise_suppress, effective_echo_suppress, b->noise+NL+s, b->echo_noise+NL+s, b->gain_floor+NL+s, M, L);
+   }
+
+   /* Ephraim & Malah gain and speech probability of presence per band */
+   for (k=NL;k<NML;k+=L)
+   {
+      for (s=0;s<L;s++)
+      {
+         spx_word32_t theta;
+         spx_word32_t MM;
+         spx_word16_t prior_ratio;
+         spx_word16_t P1;
+         spx_word16_t q;
+#ifdef FIXED_POINT
+         spx_word16_t tmp;
+#endif
+         i = k+s;
+         prior_ratio = PDIV32_16(SHL32(EXTEND32(b->prior[i]), 15), ADD16(b->prior[i], SHL32(1,SNR_SHIFT)));
+         theta = MULT16_32_P15(prior_ratio, QCONST32(1.f,EXPIN_SHIFT)+SHL32(EXTEND32(b->post[i]),EXPIN_SHIFT-SNR_SHIFT));
+
+         MM = hypergeom_gain(theta);
+         b->gain[i] = EXTRACT16(MIN32(Q15_ONE, MULT16_32_Q15(prior_ratio, MM)));
+         b->old_ps[i] = MULT16_32_P15(QCONST16(.2f,15),b->old_ps[i]) + MULT16_32_P15(MULT16_16_P15(QCONST16(.8f,15),SQR16_Q15(b->gain[i])),ps[i]);
+
+         P1 = QCONST16(.199f,15)+MULT16_16_Q15(QCONST16(.8f,15),qcurve (b->zeta[i]));
+         q = Q15_ONE-MULT16_16_Q15(b->Pframe[s],P1);
+#ifdef FIXED_POINT
+         theta = MIN32(theta, EXTEND32(32767));
+         tmp = MULT16_16_Q15((SHL32(1,SNR_SHIFT)+b->prior[i]),EXTRACT16(MIN32(Q15ONE,SHR32(spx_exp(-EXTRACT16(theta)),1))));
+         tmp = MIN16(QCONST16(3.,SNR_SHIFT), tmp);
+         tmp = EXTRACT16(PSHR32(MULT16_16(PDIV32_16(SHL32(EXTEND32(q),8),(Q15_ONE-q)),tmp),8));
+         b->gain2[i]=DIV32_16(SHL32(EXTEND32(32767),SNR_SHIFT), ADD16(256,tmp));
+#else
+         b->gain2[i]=1/(1.f + (q/(1.f-q))*(1+b->prior[i])*exp(-theta));
+#endif
+      }
+   }
+   filterbank_compute_psd16_batch(b->bank, b->gain2+NL, b->gain2, L);
+   filterbank_compute_psd16_batch(b->bank, b->gain+NL, b->gain, L);
+   filterbank_compute_psd16_batch(b->bank, b->gain_floor+NL, b->gain_floor, L);
+
+   /* Ephraim-Malah gain at linear frequency resolution */
+   for (k=0;k<NL;k++)
+   {
+      spx_word32_t MM;
+      spx_word32_t theta;
+      spx_word16_t prior_ratio;
+      spx_word16_t tmp;
+      spx_word16_t p;
+      spx_word16_t g;
+
+      prior_ratio = PDIV32_16(SHL32(EXTEND32(b->prior[k]), 15), ADD16(b->prior[k], SHL32(1,SNR_SHIFT)));
+      theta = MULT16_32_P15(prior_ratio, QCONST32(1.f,EXPIN_SHIFT)+SHL32(EXTEND32(b->post[k]),EXPIN_SHIFT-SNR_SHIFT));
+
+      MM = hypergeom_gain(theta);
+      g = EXTRACT16(MIN32(Q15_ONE, MULT16_32_Q15(prior_ratio, MM)));
+      p = b->gain2[k];
+
+      if (MULT16_16_Q15(QCONST16(.333f,15),g) > b->gain[k])
+         g = MULT16_16(3,b->gain[k]);
+      b->gain[k] = g;
+
+      b->old_ps[k] = MULT16_32_P15(QCONST16(.2f,15),b->old_ps[k]) + MULT16_32_P15(MULT16_16_P15(QCONST16(.8f,15),SQR16_Q15(b->gain[k])),ps[k]);
+
+      if (b->gain[k] < b->gain_floor[k])
+         b->gain[k] = b->gain_floor[k];
+
+      tmp = MULT16_16_P15(p,spx_sqrt(SHL32(EXTEND32(b->gain[k]),15))) + MULT16_16_P15(SUB16(Q15_ONE,p),spx_sqrt(SHL32(EXTEND32(b->gain_floor[k]),15)));
+      b->gain2[k]=SQR16_Q15(tmp);
+   }
+
+   /* Synthesis and VAD are per stream again */
+   for (s=0;s<L;s++)
+   {
+      SpeexPreprocessState *st = &b->streams[s];
+      int speech;
+      for (i=0;i<N;i++)
+      {
+         b->gain_column[i] = st->denoise_enabled ? b->gain2[i*L+s] : Q15_ONE;
+         b->column[i] = ps[i*L+s];
+      }
+      preprocess_synthesis(st, b->Pframe[s], x[s]);
+      speech = preprocess_vad(st, b->Pframe[s]);
+      if (vad)
+         vad[s] = speech;
+   }
+}
+
+EXPORT int speex_preprocess_batch_ctl(SpeexPreprocessBatch *b, int stream, int request, void *ptr)
+{
+   int i;
+   int L = b->nb_streams;
+   SpeexPreprocessState *st;
+   if (stream < 0 || stream >= L)
+   {
+      speex_warning_int("Invalid stream in speex_preprocess_batch_ctl: ", stream);
+      return -1;
+   }
+   st = &b->streams[stream];
+   switch(request)
+   {
+   case SPEEX_PREPROCESS_SET_DEREVERB:
+      st->dereverb_enabled = (*(spx_int32_t*)ptr);
+      break;
+   case SPEEX_PREPROCESS_GET_PSD:
+      for(i=0;i<b->ps_size;i++)
+         ((spx_int32_t *)ptr)[i] = (spx_int32_t) b->ps[i*L+stream];
+      break;
+   case SPEEX_PREPROCESS_GET_NOISE_PSD:
+      for(i=0;i<b->ps_size;i++)
+         ((spx_int32_t *)ptr)[i] = (spx_int32_t) PSHR32(b->noise[i*L+stream], NOISE_SHIFT);
+      break;
+   default:
+      /* Everything else only touches the stream's parameters and scalars */
+      return speex_preprocess_ctl(st, request, ptr);
+   }
+   return 0;
+}
+
 #ifdef FIXED_DEBUG
 long long spx_mips=0;
 #endif
@@ -95,7 +95,9 @@ static void speex_free (void *ptr) {free(ptr);}
 #define NULL 0
 #endif
 
-#ifdef _USE_SSE
+#if defined(_USE_AVX2)
+#include "resample_avx.h"
+#elif defined(_USE_SSE)
 #include "resample_sse.h"
 #endif
 
@@ -110,7 +112,7 @@ static void speex_free (void *ptr) {free(ptr);}
 #define FIXED_STACK_ALLOC 1024
 #endif
 
-typedef int (*resampler_basic_func)(SpeexResamplerState *, spx_uint32_t , const spx_word16_t *, spx_uint32_t *, spx_word16_t *, spx_uint32_t *);
+typedef int (*resampler_basic_func)(SpeexResamplerState *, spx_uint32_t , spx_uint32_t , const spx_word16_t *, spx_uint32_t *, spx_word16_t *, spx_uint32_t *);
 
 struct SpeexResamplerState_ {
    spx_uint32_t in_rate;
@@ -329,7 +331,13 @@ static void cubic_coef(spx_word16_t frac, spx_word16_t interp[4])
 }
 #endif
 
-static int resampler_basic_direct_single(SpeexResamplerState *st, spx_uint32_t channel_index, const spx_word16_t *in, spx_uint32_t *in_len, spx_word16_t *out, spx_uint32_t *out_len)
+/* The basic resamplers produce nb_lanes channels at once: channel_index and the
+   nb_lanes-1 channels after it, whose memory follows at mem_alloc_size intervals
+   from in and whose outputs are interleaved at out[out_stride*n + lane]. Every
+   lane must be at the same filter phase, which lets the filter coefficients for
+   an output sample be looked up (or interpolated) once and reused while they are
+   still in cache. Only channel_index's phase is updated here. */
+static int resampler_basic_direct_single(SpeexResamplerState *st, spx_uint32_t channel_index, spx_uint32_t nb_lanes, const spx_word16_t *in, spx_uint32_t *in_len, spx_word16_t *out, spx_uint32_t *out_len)
 {
    const int N = st->filt_len;
    int out_sample = 0;
@@ -340,30 +348,37 @@ static int resampler_basic_direct_single(SpeexResamplerState *st, spx_uint32_t c
    const int int_advance = st->int_advance;
    const int frac_advance = st->frac_advance;
    const spx_uint32_t den_rate = st->den_rate;
+   const spx_uint32_t mem_stride = st->mem_alloc_size;
    spx_word32_t sum;
+   spx_uint32_t lane;
    int j;
 
    while (!(last_sample >= (spx_int32_t)*in_len || out_sample >= (spx_int32_t)*out_len))
    {
       const spx_word16_t *sinc = & sinc_table[samp_frac_num*N];
-      const spx_word16_t *iptr = & in[last_sample];
+
+      for (lane=0;lane<nb_lanes;lane++)
+      {
+         const spx_word16_t *iptr = & in[lane*mem_stride + last_sample];
 
 #ifndef OVERRIDE_INNER_PRODUCT_SINGLE
-      float accum[4] = {0,0,0,0};
+         float accum[4] = {0,0,0,0};
 
-      for(j=0;j<N;j+=4) {
-        accum[0] += sinc[j]*iptr[j];
-        accum[1] += sinc[j+1]*iptr[j+1];
-        accum[2] += sinc[j+2]*iptr[j+2];
-        accum[3] += sinc[j+3]*iptr[j+3];
-      }
-      sum = accum[0] + accum[1] + accum[2] + accum[3];
-      sum = SATURATE32PSHR(sum, 15, 32767);
+         for(j=0;j<N;j+=4) {
+           accum[0] += sinc[j]*iptr[j];
+           accum[1] += sinc[j+1]*iptr[j+1];
+           accum[2] += sinc[j+2]*iptr[j+2];
+           accum[3] += sinc[j+3]*iptr[j+3];
+         }
+         sum = accum[0] + accum[1] + accum[2] + accum[3];
+         sum = SATURATE32PSHR(sum, 15, 32767);
 #else
-      sum = inner_product_single(sinc, iptr, N);
+         sum = inner_product_single(sinc, iptr, N);
 #endif
 
-      out[out_stride * out_sample++] = sum;
+         out[out_stride * out_sample + lane] = sum;
+      }
+      out_sample++;
       last_sample += int_advance;
       samp_frac_num += frac_advance;
       if (samp_frac_num >= den_rate)
@@ -381,7 +396,7 @@ static int resampler_basic_direct_single(SpeexResamplerState *st, spx_uint32_t c
 #ifdef FIXED_POINT
 #else
 /* This is the same as the previous function, except with a double-precision accumulator */
-static int resampler_basic_direct_double(SpeexResamplerState *st, spx_uint32_t channel_index, const spx_word16_t *in, spx_uint32_t *in_len, spx_word16_t *out, spx_uint32_t *out_len)
+static int resampler_basic_direct_double(SpeexResamplerState *st, spx_uint32_t channel_index, spx_uint32_t nb_lanes, const spx_word16_t *in, spx_uint32_t *in_len, spx_word16_t *out, spx_uint32_t *out_len)
 {
    const int N = st->filt_len;
    int out_sample = 0;
@@ -392,29 +407,36 @@ static int resampler_basic_direct_double(SpeexResamplerState *st, spx_uint32_t c
    const int int_advance = st->int_advance;
    const int frac_advance = st->frac_advance;
    const spx_uint32_t den_rate = st->den_rate;
+   const spx_uint32_t mem_stride = st->mem_alloc_size;
    double sum;
+   spx_uint32_t lane;
    int j;
 
    while (!(last_sample >= (spx_int32_t)*in_len || out_sample >= (spx_int32_t)*out_len))
    {
       const spx_word16_t *sinc = & sinc_table[samp_frac_num*N];
-      const spx_word16_t *iptr = & in[last_sample];
+
+      for (lane=0;lane<nb_lanes;lane++)
+      {
+         const spx_word16_t *iptr = & in[lane*mem_stride + last_sample];
 
 #ifndef OVERRIDE_INNER_PRODUCT_DOUBLE
-      double accum[4] = {0,0,0,0};
+         double accum[4] = {0,0,0,0};
 
-      for(j=0;j<N;j+=4) {
-        accum[0] += sinc[j]*iptr[j];
-        accum[1] += sinc[j+1]*iptr[j+1];
-        accum[2] += sinc[j+2]*iptr[j+2];
-        accum[3] += sinc[j+3]*iptr[j+3];
-      }
-      sum = accum[0] + accum[1] + accum[2] + accum[3];
+         for(j=0;j<N;j+=4) {
+           accum[0] += sinc[j]*iptr[j];
+           accum[1] += sinc[j+1]*iptr[j+1];
+           accum[2] += sinc[j+2]*iptr[j+2];
+           accum[3] += sinc[j+3]*iptr[j+3];
+         }
+         sum = accum[0] + accum[1] + accum[2] + accum[3];
 #else
-      sum = inner_product_double(sinc, iptr, N);
+         sum = inner_product_double(sinc, iptr, N);
 #endif
 
-      out[out_stride * out_sample++] = PSHR32(sum, 15);
+         out[out_stride * out_sample + lane] = PSHR32(sum, 15);
+      }
+      out_sample++;
       last_sample += int_advance;
       samp_frac_num += frac_advance;
       if (samp_frac_num >= den_rate)
@@ -430,7 +452,7 @@ static int resampler_basic_direct_double(SpeexResamplerState *st, spx_uint32_t c
 }
 #endif
 
-static int resampler_basic_interpolate_single(SpeexResamplerState *st, spx_uint32_t channel_index, const spx_word16_t *in, spx_uint32_t *in_len, spx_word16_t *out, spx_uint32_t *out_len)
+static int resampler_basic_interpolate_single(SpeexResamplerState *st, spx_uint32_t channel_index, spx_uint32_t nb_lanes, const spx_word16_t *in, spx_uint32_t *in_len, spx_word16_t *out, spx_uint32_t *out_len)
 {
    const int N = st->filt_len;
    int out_sample = 0;
@@ -440,13 +462,13 @@ static int resampler_basic_interpolate_single(SpeexResamplerState *st, spx_uint3
    const int int_advance = st->int_advance;
    const int frac_advance = st->frac_advance;
    const spx_uint32_t den_rate = st->den_rate;
+   const spx_uint32_t mem_stride = st->mem_alloc_size;
+   spx_uint32_t lane;
    int j;
    spx_word32_t sum;
 
    while (!(last_sample >= (spx_int32_t)*in_len || out_sample >= (spx_int32_t)*out_len))
    {
-      const spx_word16_t *iptr = & in[last_sample];
-
       const int offset = samp_frac_num*st->oversample/st->den_rate;
 #ifdef FIXED_POINT
       const spx_word16_t frac = PDIV32(SHL32((samp_frac_num*st->oversample) % st->den_rate,15),st->den_rate);
@@ -455,27 +477,32 @@ static int resampler_basic_interpolate_single(SpeexResamplerState *st, spx_uint3
 #endif
       spx_word16_t interp[4];
 
+      cubic_coef(frac, interp);
+
+      for (lane=0;lane<nb_lanes;lane++)
+      {
+         const spx_word16_t *iptr = & in[lane*mem_stride + last_sample];
 
 #ifndef OVERRIDE_INTERPOLATE_PRODUCT_SINGLE
-      spx_word32_t accum[4] = {0,0,0,0};
-
-      for(j=0;j<N;j++) {
-        const spx_word16_t curr_in=iptr[j];
-        accum[0] += MULT16_16(curr_in,st->sinc_table[4+(j+1)*st->oversample-offset-2]);
-        accum[1] += MULT16_16(curr_in,st->sinc_table[4+(j+1)*st->oversample-offset-1]);
-        accum[2] += MULT16_16(curr_in,st->sinc_table[4+(j+1)*st->oversample-offset]);
-        accum[3] += MULT16_16(curr_in,st->sinc_table[4+(j+1)*st->oversample-offset+1]);
-      }
+         spx_word32_t accum[4] = {0,0,0,0};
+
+         for(j=0;j<N;j++) {
+           const spx_word16_t curr_in=iptr[j];
+           accum[0] += MULT16_16(curr_in,st->sinc_table[4+(j+1)*st->oversample-offset-2]);
+           accum[1] += MULT16_16(curr_in,st->sinc_table[4+(j+1)*st->oversample-offset-1]);
+           accum[2] += MULT16_16(curr_in,st->sinc_table[4+(j+1)*st->oversample-offset]);
+           accum[3] += MULT16_16(curr_in,st->sinc_table[4+(j+1)*st->oversample-offset+1]);
+         }
 
-      cubic_coef(frac, interp);
-      sum = MULT16_32_Q15(interp[0],accum[0]) + MULT16_32_Q15(interp[1],accum[1]) + MULT16_32_Q15(interp[2],accum[2]) + MULT16_32_Q15(interp[3],accum[3]);
-      sum = SATURATE32PSHR(sum, 15, 32767);
+         sum = MULT16_32_Q15(interp[0],accum[0]) + MULT16_32_Q15(interp[1],accum[1]) + MULT16_32_Q15(interp[2],accum[2]) + MULT16_32_Q15(interp[3],accum[3]);
+         sum = SATURATE32PSHR(sum, 15, 32767);
 #else
-      cubic_coef(frac, interp);
-      sum = interpolate_product_single(iptr, st->sinc_table + st->oversample + 4 - offset - 2, N, st->oversample, interp);
+         sum = interpolate_product_single(iptr, st->sinc_table + st->oversample + 4 - offset - 2, N, st->oversample, interp);
 #endif
-      
-      out[out_stride * out_sample++] = sum;
+
+         out[out_stride * out_sample + lane] = sum;
+      }
+      out_sample++;
       last_sample += int_advance;
       samp_frac_num += frac_advance;
       if (samp_frac_num >= den_rate)
@@ -493,7 +520,7 @@ static int resampler_basic_interpolate_single(SpeexResamplerState *st, spx_uint3
 #ifdef FIXED_POINT
 #else
 /* This is the same as the previous function, except with a double-precision accumulator */
-static int resampler_basic_interpolate_double(SpeexResamplerState *st, spx_uint32_t channel_index, const spx_word16_t *in, spx_uint32_t *in_len, spx_word16_t *out, spx_uint32_t *out_len)
+static int resampler_basic_interpolate_double(SpeexResamplerState *st, spx_uint32_t channel_index, spx_uint32_t nb_lanes, const spx_word16_t *in, spx_uint32_t *in_len, spx_word16_t *out, spx_uint32_t *out_len)
 {
    const int N = st->filt_len;
    int out_sample = 0;
@@ -503,13 +530,13 @@ static int resampler_basic_interpolate_double(SpeexResamplerState *st, spx_uint3
    const int int_advance = st->int_advance;
    const int frac_advance = st->frac_advance;
    const spx_uint32_t den_rate = st->den_rate;
+   const spx_uint32_t mem_stride = st->mem_alloc_size;
+   spx_uint32_t lane;
    int j;
    spx_word32_t sum;
 
    while (!(last_sample >= (spx_int32_t)*in_len || out_sample >= (spx_int32_t)*out_len))
    {
-      const spx_word16_t *iptr = & in[last_sample];
-
       const int offset = samp_frac_num*st->oversample/st->den_rate;
 #ifdef FIXED_POINT
       const spx_word16_t frac = PDIV32(SHL32((samp_frac_num*st->oversample) % st->den_rate,15),st->den_rate);
@@ -518,26 +545,31 @@ static int resampler_basic_interpolate_double(SpeexResamplerState *st, spx_uint3
 #endif
       spx_word16_t interp[4];
 
+      cubic_coef(frac, interp);
+
+      for (lane=0;lane<nb_lanes;lane++)
+      {
+         const spx_word16_t *iptr = & in[lane*mem_stride + last_sample];
 
 #ifndef OVERRIDE_INTERPOLATE_PRODUCT_DOUBLE
-      double accum[4] = {0,0,0,0};
-
-      for(j=0;j<N;j++) {
-        const double curr_in=iptr[j];
-        accum[0] += MULT16_16(curr_in,st->sinc_table[4+(j+1)*st->oversample-offset-2]);
-        accum[1] += MULT16_16(curr_in,st->sinc_table[4+(j+1)*st->oversample-offset-1]);
-        accum[2] += MULT16_16(curr_in,st->sinc_table[4+(j+1)*st->oversample-offset]);
-        accum[3] += MULT16_16(curr_in,st->sinc_table[4+(j+1)*st->oversample-offset+1]);
-      }
+         double accum[4] = {0,0,0,0};
+
+         for(j=0;j<N;j++) {
+           const double curr_in=iptr[j];
+           accum[0] += MULT16_16(curr_in,st->sinc_table[4+(j+1)*st->oversample-offset-2]);
+           accum[1] += MULT16_16(curr_in,st->sinc_table[4+(j+1)*st->oversample-offset-1]);
+           accum[2] += MULT16_16(curr_in,st->sinc_table[4+(j+1)*st->oversample-offset]);
+           accum[3] += MULT16_16(curr_in,st->sinc_table[4+(j+1)*st->oversample-offset+1]);
+         }
 
-      cubic_coef(frac, interp);
-      sum = MULT16_32_Q15(interp[0],accum[0]) + MULT16_32_Q15(interp[1],accum[1]) + MULT16_32_Q15(interp[2],accum[2]) + MULT16_32_Q15(interp[3],accum[3]);
+         sum = MULT16_32_Q15(interp[0],accum[0]) + MULT16_32_Q15(interp[1],accum[1]) + MULT16_32_Q15(interp[2],accum[2]) + MULT16_32_Q15(interp[3],accum[3]);
 #else
-      cubic_coef(frac, interp);
-      sum = interpolate_product_double(iptr, st->sinc_table + st->oversample + 4 - offset - 2, N, st->oversample, interp);
+         sum = interpolate_product_double(iptr, st->sinc_table + st->oversample + 4 - offset - 2, N, st->oversample, interp);
 #endif
-      
-      out[out_stride * out_sample++] = PSHR32(sum,15);
+
+         out[out_stride * out_sample + lane] = PSHR32(sum,15);
+      }
+      out_sample++;
       last_sample += int_advance;
       samp_frac_num += frac_advance;
       if (samp_frac_num >= den_rate)
@@ -799,18 +831,19 @@ EXPORT void speex_resampler_destroy(SpeexResamplerState *st)
    speex_free(st);
 }
 
-static int speex_resampler_process_native(SpeexResamplerState *st, spx_uint32_t channel_index, spx_uint32_t *in_len, spx_word16_t *out, spx_uint32_t *out_len)
+static int speex_resampler_process_native(SpeexResamplerState *st, spx_uint32_t channel_index, spx_uint32_t nb_lanes, spx_uint32_t *in_len, spx_word16_t *out, spx_uint32_t *out_len)
 {
    int j=0;
    const int N = st->filt_len;
    int out_sample = 0;
    spx_word16_t *mem = st->mem + channel_index * st->mem_alloc_size;
    spx_uint32_t ilen;
+   spx_uint32_t lane;
    
    st->started = 1;
    
    /* Call the right resampler through the function ptr */
-   out_sample = st->resampler_ptr(st, channel_index, mem, in_len, out, out_len);
+   out_sample = st->resampler_ptr(st, channel_index, nb_lanes, mem, in_len, out, out_len);
    
    if (st->last_sample[channel_index] < (spx_int32_t)*in_len)
       *in_len = st->last_sample[channel_index];
@@ -819,8 +852,14 @@ static int speex_resampler_process_native(SpeexResamplerState *st, spx_uint32_t
    
    ilen = *in_len;
 
-   for(j=0;j<N-1;++j)
-     mem[j] = mem[j+ilen];
+   for (lane=0;lane<nb_lanes;lane++)
+   {
+      spx_word16_t *lane_mem = mem + lane * st->mem_alloc_size;
+      st->last_sample[channel_index+lane] = st->last_sample[channel_index];
+      st->samp_frac_num[channel_index+lane] = st->samp_frac_num[channel_index];
+      for(j=0;j<N-1;++j)
+        lane_mem[j] = lane_mem[j+ilen];
+   }
 
    return RESAMPLER_ERR_SUCCESS;
 }
@@ -830,7 +869,7 @@ static int speex_resampler_magic(SpeexResamplerState *st, spx_uint32_t channel_i
    spx_word16_t *mem = st->mem + channel_index * st->mem_alloc_size;
    const int N = st->filt_len;
    
-   speex_resampler_process_native(st, channel_index, &tmp_in_len, *out, &out_len);
+   speex_resampler_process_native(st, channel_index, 1, &tmp_in_len, *out, &out_len);
 
    st->magic_samples[channel_index] -= tmp_in_len;
    
@@ -873,7 +912,7 @@ EXPORT int speex_resampler_process_float(SpeexResamplerState *st, spx_uint32_t c
           for(j=0;j<ichunk;++j)
             x[j+filt_offs]=0;
         }
-        speex_resampler_process_native(st, channel_index, &ichunk, out, &ochunk);
+        speex_resampler_process_native(st, channel_index, 1, &ichunk, out, &ochunk);
         ilen -= ichunk;
         olen -= ochunk;
         out += ochunk * st->out_stride;
@@ -934,7 +973,7 @@ EXPORT int speex_resampler_process_int(SpeexResamplerState *st, spx_uint32_t cha
            x[j+st->filt_len-1]=0;
        }
 
-       speex_resampler_process_native(st, channel_index, &ichunk, y, &ochunk);
+       speex_resampler_process_native(st, channel_index, 1, &ichunk, y, &ochunk);
      } else {
        ichunk = 0;
        ochunk = 0;
@@ -960,11 +999,103 @@ EXPORT int speex_resampler_process_int(SpeexResamplerState *st, spx_uint32_t cha
    return RESAMPLER_ERR_SUCCESS;
 }
 
+/* True when every channel is at the same filter phase with no magic samples
+   pending, so that one pass of the basic resampler can produce all of them. */
+static int speex_resampler_lockstep(SpeexResamplerState *st)
+{
+   spx_uint32_t i;
+   for (i=0;i<st->nb_channels;i++)
+   {
+      if (st->magic_samples[i] || st->last_sample[i] != st->last_sample[0] || st->samp_frac_num[i] != st->samp_frac_num[0])
+         return 0;
+   }
+   return 1;
+}
+
+#ifdef FIXED_POINT
+#define FLOAT2WORD(x) WORD2INT(x)
+#define WORD2SHORT(x) (x)
+#else
+#define FLOAT2WORD(x) (x)
+#define WORD2SHORT(x) WORD2INT(x)
+#endif
+
+/* Interleaved processing of channels in lockstep. Exactly one of fout/iout is
+   set, and at most one of fin/iin (neither means zeros). Input is deinterleaved
+   into the per-channel filter memories and all channels are filtered in one
+   pass; output goes through a stack buffer so that both sample formats share
+   this path. */
+static int speex_resampler_process_lockstep(SpeexResamplerState *st, const float *fin, const spx_int16_t *iin, spx_uint32_t *in_len, float *fout, spx_int16_t *iout, spx_uint32_t *out_len)
+{
+   spx_uint32_t i, j;
+   const spx_uint32_t nb_channels = st->nb_channels;
+   const int ostride_save = st->out_stride;
+   const spx_uint32_t filt_offs = st->filt_len - 1;
+   const spx_uint32_t xlen = st->mem_alloc_size - filt_offs;
+   spx_uint32_t ilen = *in_len;
+   spx_uint32_t olen = *out_len;
+#ifdef VAR_ARRAYS
+   const unsigned int ylen = ((olen*nb_channels < FIXED_STACK_ALLOC) ? olen*nb_channels : FIXED_STACK_ALLOC) / nb_channels;
+   VARDECL(spx_word16_t *ystack);
+   ALLOC(ystack, ylen*nb_channels, spx_word16_t);
+#else
+   const unsigned int ylen = FIXED_STACK_ALLOC / nb_channels;
+   spx_word16_t ystack[FIXED_STACK_ALLOC];
+#endif
+
+   st->out_stride = nb_channels;
+
+   while (ilen && olen) {
+      spx_uint32_t ichunk = (ilen > xlen) ? xlen : ilen;
+      spx_uint32_t ochunk = (olen > ylen) ? ylen : olen;
+
+      for (i=0;i<nb_channels;i++)
+      {
+         spx_word16_t *x = st->mem + i * st->mem_alloc_size + filt_offs;
+         if (fin) {
+            for(j=0;j<ichunk;++j)
+               x[j]=FLOAT2WORD(fin[j*nb_channels+i]);
+         } else if (iin) {
+            for(j=0;j<ichunk;++j)
+               x[j]=iin[j*nb_channels+i];
+         } else {
+            for(j=0;j<ichunk;++j)
+               x[j]=0;
+         }
+      }
+
+      speex_resampler_process_native(st, 0, nb_channels, &ichunk, ystack, &ochunk);
+
+      if (fout) {
+         for (j=0;j<ochunk*nb_channels;++j)
+            fout[j] = ystack[j];
+         fout += ochunk*nb_channels;
+      } else {
+         for (j=0;j<ochunk*nb_channels;++j)
+            iout[j] = WORD2SHORT(ystack[j]);
+         iout += ochunk*nb_channels;
+      }
+
+      ilen -= ichunk;
+      olen -= ochunk;
+      if (fin)
+         fin += ichunk*nb_channels;
+      if (iin)
+         iin += ichunk*nb_channels;
+   }
+   st->out_stride = ostride_save;
+   *in_len -= ilen;
+   *out_len -= olen;
+   return RESAMPLER_ERR_SUCCESS;
+}
+
 EXPORT int speex_resampler_process_interleaved_float(SpeexResamplerState *st, const float *in, spx_uint32_t *in_len, float *out, spx_uint32_t *out_len)
 {
    spx_uint32_t i;
    int istride_save, ostride_save;
    spx_uint32_t bak_len = *out_len;
+   if (st->nb_channels > 1 && st->nb_channels <= FIXED_STACK_ALLOC && speex_resampler_lockstep(st))
+      return speex_resampler_process_lockstep(st, in, NULL, in_len, out, NULL, out_len);
    istride_save = st->in_stride;
    ostride_save = st->out_stride;
    st->in_stride = st->out_stride = st->nb_channels;
@@ -986,6 +1117,8 @@ EXPORT int speex_resampler_process_interleaved_int(SpeexResamplerState *st, cons
    spx_uint32_t i;
    int istride_save, ostride_save;
    spx_uint32_t bak_len = *out_len;
+   if (st->nb_channels > 1 && st->nb_channels <= FIXED_STACK_ALLOC && speex_resampler_lockstep(st))
+      return speex_resampler_process_lockstep(st, NULL, in, in_len, NULL, out, out_len);
    istride_save = st->in_stride;
    ostride_save = st->out_stride;
    st->in_stride = st->out_stride = st->nb_channels;
@@ -0,0 +1,165 @@
+/**
+   @file resample_avx.h
+   @brief Resampler functions (AVX2/FMA version)
+*/
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   - Neither the name of the Xiph.org Foundation nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE FOUNDATION OR
+   CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/* Build with -mavx2 -mfma. Filter lengths are only guaranteed to be multiples
+   of 4, so every kernel finishes with a 4-wide tail. */
+
+#include <immintrin.h>
+
+#ifdef FIXED_POINT
+
+#define OVERRIDE_INNER_PRODUCT_SINGLE
+static inline spx_word32_t inner_product_single(const spx_word16_t *a, const spx_word16_t *b, unsigned int len)
+{
+   unsigned int i;
+   spx_word32_t ret;
+   __m256i sum = _mm256_setzero_si256();
+   __m128i sum128;
+   for (i=0;i+16<=len;i+=16)
+      sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_loadu_si256((const __m256i *)(a+i)), _mm256_loadu_si256((const __m256i *)(b+i))));
+   sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+   if (i+8<=len)
+   {
+      sum128 = _mm_add_epi32(sum128, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(a+i)), _mm_loadu_si128((const __m128i *)(b+i))));
+      i += 8;
+   }
+   if (i<len)
+      sum128 = _mm_add_epi32(sum128, _mm_madd_epi16(_mm_loadl_epi64((const __m128i *)(a+i)), _mm_loadl_epi64((const __m128i *)(b+i))));
+   sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(1,0,3,2)));
+   sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(2,3,0,1)));
+   ret = _mm_cvtsi128_si32(sum128);
+   return SATURATE32PSHR(ret, 15, 32767);
+}
+
+#else
+
+static inline float hsum256_ps(__m256 v)
+{
+   __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+   sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+   sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+   return _mm_cvtss_f32(sum);
+}
+
+static inline double hsum256_pd(__m256d v)
+{
+   __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+   sum = _mm_add_sd(sum, _mm_unpackhi_pd(sum, sum));
+   return _mm_cvtsd_f64(sum);
+}
+
+/* Taps i and i+1 of the interpolating filter: a[i] times the four table
+   entries around b+i*oversample in the low half, a[i+1] and b+(i+1)*oversample
+   in the high half. */
+static inline __m256 interpolate_taps(const float *a, const float *b, unsigned int i, const spx_uint32_t oversample)
+{
+   __m256 x = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_load1_ps(a+i)), _mm_load1_ps(a+i+1), 1);
+   __m256 y = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(b+i*oversample)), _mm_loadu_ps(b+(i+1)*oversample), 1);
+   return _mm256_mul_ps(x, y);
+}
+
+#define OVERRIDE_INNER_PRODUCT_SINGLE
+static inline float inner_product_single(const float *a, const float *b, unsigned int len)
+{
+   unsigned int i;
+   __m256 sum0 = _mm256_setzero_ps();
+   __m256 sum1 = _mm256_setzero_ps();
+   for (i=0;i+16<=len;i+=16)
+   {
+      sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a+i), _mm256_loadu_ps(b+i), sum0);
+      sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a+i+8), _mm256_loadu_ps(b+i+8), sum1);
+   }
+   if (i+8<=len)
+   {
+      sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a+i), _mm256_loadu_ps(b+i), sum0);
+      i += 8;
+   }
+   if (i<len)
+      sum1 = _mm256_add_ps(sum1, _mm256_castps128_ps256(_mm_mul_ps(_mm_loadu_ps(a+i), _mm_loadu_ps(b+i))));
+   return hsum256_ps(_mm256_add_ps(sum0, sum1));
+}
+
+#define OVERRIDE_INTERPOLATE_PRODUCT_SINGLE
+static inline float interpolate_product_single(const float *a, const float *b, unsigned int len, const spx_uint32_t oversample, float *frac)
+{
+   /* Only four table entries per tap, so 128-bit FMAs into two independent
+      accumulators beat packing two taps into one 256-bit register. */
+   unsigned int i;
+   __m128 sum0 = _mm_setzero_ps();
+   __m128 sum1 = _mm_setzero_ps();
+   __m128 sum;
+   for (i=0;i<len;i+=2)
+   {
+      sum0 = _mm_fmadd_ps(_mm_load1_ps(a+i), _mm_loadu_ps(b+i*oversample), sum0);
+      sum1 = _mm_fmadd_ps(_mm_load1_ps(a+i+1), _mm_loadu_ps(b+(i+1)*oversample), sum1);
+   }
+   sum = _mm_mul_ps(_mm_loadu_ps(frac), _mm_add_ps(sum0, sum1));
+   sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+   sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+   return _mm_cvtss_f32(sum);
+}
+
+#define OVERRIDE_INNER_PRODUCT_DOUBLE
+static inline double inner_product_double(const float *a, const float *b, unsigned int len)
+{
+   unsigned int i;
+   __m256d sum = _mm256_setzero_pd();
+   __m256 t;
+   for (i=0;i+8<=len;i+=8)
+   {
+      t = _mm256_mul_ps(_mm256_loadu_ps(a+i), _mm256_loadu_ps(b+i));
+      sum = _mm256_add_pd(sum, _mm256_cvtps_pd(_mm256_castps256_ps128(t)));
+      sum = _mm256_add_pd(sum, _mm256_cvtps_pd(_mm256_extractf128_ps(t, 1)));
+   }
+   if (i<len)
+      sum = _mm256_add_pd(sum, _mm256_cvtps_pd(_mm_mul_ps(_mm_loadu_ps(a+i), _mm_loadu_ps(b+i))));
+   return hsum256_pd(sum);
+}
+
+#define OVERRIDE_INTERPOLATE_PRODUCT_DOUBLE
+static inline double interpolate_product_double(const float *a, const float *b, unsigned int len, const spx_uint32_t oversample, float *frac)
+{
+   unsigned int i;
+   __m256d sum = _mm256_setzero_pd();
+   __m256 t;
+   for (i=0;i<len;i+=2)
+   {
+      t = interpolate_taps(a, b, i, oversample);
+      sum = _mm256_add_pd(sum, _mm256_cvtps_pd(_mm256_castps256_ps128(t)));
+      sum = _mm256_add_pd(sum, _mm256_cvtps_pd(_mm256_extractf128_ps(t, 1)));
+   }
+   sum = _mm256_mul_pd(_mm256_cvtps_pd(_mm_loadu_ps(frac)), sum);
+   return hsum256_pd(sum);
+}
+
+#endif
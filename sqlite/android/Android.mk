@@ -50,3 +50,25 @@ LOCAL_SRC_FILES := \
 LOCAL_MODULE_TAGS := optional
 
 include $(BUILD_EXECUTABLE)
+
+# Test for the sort key cache of the LOCALIZED collation
+#
+# Sorts with and without the sorter's worker threads and checks the order. Like the test
+# above, it is not run automatically. On the host it can also be built against an amalgamation
+# compiled with the flags in ../dist/Android.mk, preferably with -fsanitize=thread.
+include $(CLEAR_VARS)
+
+LOCAL_MODULE:= libsqlite3_sort_key_cache_test
+
+LOCAL_CFLAGS += -Wall -Werror
+
+LOCAL_SRC_FILES := \
+	SortKeyCacheTest.cpp
+
+LOCAL_C_INCLUDES += $(libsqlite3_android_c_includes)
+
+LOCAL_SHARED_LIBRARIES := libsqlite libicuuc libicui18n
+
+LOCAL_MODULE_TAGS := optional
+
+include $(BUILD_EXECUTABLE)
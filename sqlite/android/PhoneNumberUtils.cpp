@@ -60,6 +60,10 @@ static bool two_length_country_code_map[100] = {
 
 #define ARRAY_SIZE(a) (sizeof(a)/sizeof((a)[0]))
 
+// Number of trailing dialable characters phone_number_compare_loose() needs
+// to match, the same as MIN_MATCH in OldPhoneNumberUtils.cpp.
+#define MIN_MATCH 7
+
 /**
  * Returns true if "ccc_candidate" expresses (part of ) some country calling
  * code.
@@ -469,4 +473,32 @@ bool phone_number_stripped_reversed_inter(const char* in, char* out, const int l
     return true;
 }
 
+/**
+ * Write the key that phone_number_compare_loose() matches on: the last
+ * MIN_MATCH dialable characters of "in", reversed.
+ *
+ * phone_number_compare_loose() only accepts numbers whose dialable characters
+ * agree for at least MIN_MATCH characters from the right, or agree completely
+ * when there are fewer than that. Either way the two numbers have the same
+ * key, so equality of keys is a necessary condition for a loose match, and an
+ * index on the key can narrow a lookup down to the few rows worth comparing.
+ *
+ * At most len characters are written to out; the key is not terminated.
+ */
+bool phone_number_min_match_key(const char* in, char* out, const int len, int *outlen) {
+    int out_len = 0;
+    int max_len = len < MIN_MATCH ? len : MIN_MATCH;
+
+    if (in != NULL) {
+        for (int i = strlen(in); --i >= 0 && out_len < max_len;) {
+            if (isDialable(in[i])) {
+                out[out_len++] = in[i];
+            }
+        }
+    }
+
+    *outlen = out_len;
+    return true;
+}
+
 }  // namespace android
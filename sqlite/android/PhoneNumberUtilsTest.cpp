@@ -73,6 +73,40 @@ using namespace android;
         }                                                               \
      })
 
+#define ASSERT_MIN_MATCH_KEY(input, expected)                           \
+    ({                                                                  \
+        char out[PHONE_NUMBER_BUFFER_SIZE + 2];                         \
+        int outlen;                                                     \
+        (total)++;                                                      \
+        phone_number_min_match_key((input),                             \
+            out,                                                        \
+            PHONE_NUMBER_BUFFER_SIZE + 2,                               \
+            &outlen);                                                   \
+        out[outlen] = 0;                                                \
+        if (strcmp((expected), (out)) != 0) {                           \
+            printf("Expected: %s actual: %s\n", (expected), (out));     \
+            (error)++;                                                  \
+        }                                                               \
+     })
+
+// Numbers that are loosely equal must have the same min match key.
+#define EXPECT_SAME_MIN_MATCH_KEY(input1, input2)                       \
+    ({                                                                  \
+        char out1[PHONE_NUMBER_BUFFER_SIZE + 2];                        \
+        char out2[PHONE_NUMBER_BUFFER_SIZE + 2];                        \
+        int outlen1, outlen2;                                           \
+        (total)++;                                                      \
+        phone_number_min_match_key((input1), out1,                      \
+            PHONE_NUMBER_BUFFER_SIZE + 2, &outlen1);                    \
+        phone_number_min_match_key((input2), out2,                      \
+            PHONE_NUMBER_BUFFER_SIZE + 2, &outlen2);                    \
+        if (outlen1 != outlen2 || memcmp(out1, out2, outlen1) != 0) {   \
+            printf("%s and %s should have the same key\n",              \
+                   (input1), (input2));                                 \
+            (error)++;                                                  \
+        }                                                               \
+     })
+
 int main() {
     int total = 0;
     int error = 0;
@@ -186,6 +220,16 @@ int main() {
     // Ignoring non-dialable
     ASSERT_STRIPPED_REVERSE("1A2 3?4", "4321");
 
+    ASSERT_MIN_MATCH_KEY("", "");
+    ASSERT_MIN_MATCH_KEY("123", "321");
+    ASSERT_MIN_MATCH_KEY("+1 (650) 555-1234", "4321555");
+    ASSERT_MIN_MATCH_KEY("12*3#", "#3*21");
+
+    EXPECT_SAME_MIN_MATCH_KEY("650-555-1234", "+1 650 555 1234");
+    EXPECT_SAME_MIN_MATCH_KEY("011 44 20 7946 0018", "+442079460018");
+    EXPECT_SAME_MIN_MATCH_KEY("0 20 7946 0018", "+44 20 7946 0018");
+    EXPECT_SAME_MIN_MATCH_KEY("404-04", "40404");
+
     printf("total: %d, error: %d\n\n", total, error);
     if (error == 0) {
         printf("Success!\n");
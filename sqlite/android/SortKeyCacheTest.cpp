@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/*
+ * Sorts a table by the LOCALIZED collation with and without the sorter's
+ * worker threads (PRAGMA threads), so that the collation's sort key cache is
+ * used from several threads at once, and checks every result against a
+ * separate collator. Like PhoneNumberUtilsTest, this is not run by the build
+ * servers; run it after changing the collations in sqlite3_android.cpp, also
+ * under ThreadSanitizer if you can.
+ */
+
+#include "sqlite3_android.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unicode/ucol.h>
+
+#define LOCALE "en_US"
+#define ROWS 50000
+#define PASSES 3
+
+static const char * const kSyllables[] = {
+    "an", "Be", "cé", "Dö", "el", "fa", "Gü", "hi", "ïo", "jo", "Ka", "lü",
+    "må", "Ne", "ñu", "op", "Qi", "rø", "Sa", "tè", "ua", "Vi", "wa", "ßy",
+};
+
+static void make_name(char * buf, unsigned * seed)
+{
+    int count = 1 + rand_r(seed) % 5;
+    buf[0] = '\0';
+    for (int i = 0; i < count; i++) {
+        if (i > 0) {
+            strcat(buf, rand_r(seed) % 3 ? "" : " ");
+        }
+        strcat(buf, kSyllables[rand_r(seed) % (sizeof(kSyllables) / sizeof(kSyllables[0]))]);
+    }
+}
+
+// Returns the number of errors in one ORDER BY ... COLLATE LOCALIZED.
+static int check_sort(sqlite3 * db, UCollator * collator)
+{
+    sqlite3_stmt * statement;
+    if (sqlite3_prepare_v2(db, "SELECT name FROM t ORDER BY name COLLATE LOCALIZED", -1,
+            &statement, NULL) != SQLITE_OK) {
+        printf("prepare failed: %s\n", sqlite3_errmsg(db));
+        return 1;
+    }
+
+    int rows = 0;
+    int errors = 0;
+    char previous[64] = "";
+    while (sqlite3_step(statement) == SQLITE_ROW) {
+        const char * name = (const char *) sqlite3_column_text(statement, 0);
+        UErrorCode status = U_ZERO_ERROR;
+        if (rows > 0 && ucol_strcollUTF8(collator, previous, -1, name, -1, &status) ==
+                UCOL_GREATER) {
+            printf("row %d: \"%s\" sorted before \"%s\"\n", rows, previous, name);
+            errors++;
+        }
+        snprintf(previous, sizeof(previous), "%s", name);
+        rows++;
+    }
+    sqlite3_finalize(statement);
+
+    if (rows != ROWS) {
+        printf("sorted %d rows, expected %d\n", rows, ROWS);
+        errors++;
+    }
+    return errors;
+}
+
+int main()
+{
+    // Small runs make the sorter spill many of them, which the worker threads
+    // then sort and merge in parallel.
+    sqlite3_config(SQLITE_CONFIG_PMASZ, 10);
+
+    sqlite3 * db;
+    if (sqlite3_open(":memory:", &db) != SQLITE_OK ||
+            register_localized_collators(db, LOCALE, 0) != SQLITE_OK) {
+        printf("Failed to set up the database\n");
+        return 1;
+    }
+
+    // The worker threads only work on runs spilled to temporary files.
+    sqlite3_exec(db, "PRAGMA temp_store = FILE; PRAGMA cache_size = 16;"
+            "CREATE TABLE t (name TEXT); BEGIN", NULL, NULL, NULL);
+    sqlite3_stmt * insert;
+    sqlite3_prepare_v2(db, "INSERT INTO t VALUES (?)", -1, &insert, NULL);
+    unsigned seed = 1;
+    for (int i = 0; i < ROWS; i++) {
+        char name[64];
+        make_name(name, &seed);
+        sqlite3_bind_text(insert, 1, name, -1, SQLITE_TRANSIENT);
+        sqlite3_step(insert);
+        sqlite3_reset(insert);
+    }
+    sqlite3_finalize(insert);
+    sqlite3_exec(db, "COMMIT", NULL, NULL, NULL);
+
+    UErrorCode status = U_ZERO_ERROR;
+    UCollator * collator = ucol_open(LOCALE, &status);
+    ucol_setAttribute(collator, UCOL_STRENGTH, UCOL_PRIMARY, &status);
+    if (U_FAILURE(status)) {
+        printf("Failed to open the collator\n");
+        return 1;
+    }
+
+    int total = 0;
+    int error = 0;
+    for (int threads = 0; threads <= 4; threads += 4) {
+        char pragma[32];
+        snprintf(pragma, sizeof(pragma), "PRAGMA threads = %d", threads);
+        sqlite3_exec(db, pragma, NULL, NULL, NULL);
+        for (int i = 0; i < PASSES; i++) {
+            total++;
+            if (check_sort(db, collator) != 0) {
+                printf("threads = %d, pass %d failed\n", threads, i);
+                error++;
+            }
+        }
+    }
+
+    ucol_close(collator);
+    sqlite3_close(db);
+
+    printf("total: %d, error: %d\n\n", total, error);
+    if (error == 0) {
+        printf("Success!\n");
+    } else {
+        printf("Failure... :(\n");
+    }
+    return error != 0;
+}
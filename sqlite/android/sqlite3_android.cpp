@@ -17,8 +17,12 @@
 #define LOG_TAG "sqlite3_android"
 
 #include <ctype.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <unicode/ucol.h>
@@ -34,11 +38,26 @@
 #define SMALL_BUFFER_SIZE 10
 #define PHONE_NUMBER_BUFFER_SIZE 40
 
+// Compare LOCALIZED and UNICODE strings by cached ICU sort keys.
+#define ENABLE_SORT_KEY_CACHE 1
+// Number of entries in each collator's sort key cache, a power of two.
+#define SORT_KEY_CACHE_SIZE 16384
+// Longest string in bytes whose sort key is cached.
+#define SORT_KEY_MAX_TEXT 128
+#define SORT_KEY_BUFFER_SIZE 512
+
+// Defaults for register_wal_checkpointer().
+#define CHECKPOINT_IDLE_MS 500
+#define CHECKPOINT_PASSIVE_PAGES 1000
+#define CHECKPOINT_RESTART_PAGES 4000
+#define CHECKPOINT_BUSY_TIMEOUT_MS 100
+
 static int collate16(void *p, int n1, const void *v1, int n2, const void *v2)
 {
     UCollator *coll = (UCollator *) p;
-    UCollationResult result = ucol_strcoll(coll, (const UChar *) v1, n1,
-                                                 (const UChar *) v2, n2);
+    // n1 and n2 are in bytes, ucol_strcoll() wants lengths in UChars
+    UCollationResult result = ucol_strcoll(coll, (const UChar *) v1, n1 / sizeof(UChar),
+                                                 (const UChar *) v2, n2 / sizeof(UChar));
 
     if (result == UCOL_LESS) {
         return -1;
@@ -73,6 +92,215 @@ static int collate8(void *p, int n1, const void *v1, int n2, const void *v2)
     }
 }
 
+#if ENABLE_SORT_KEY_CACHE
+/**
+ * Sorting a table calls the collator O(n log n) times, comparing each string
+ * with many others, and ucol_strcoll() walks both strings from the start every
+ * time.  Instead the LOCALIZED and UNICODE collations keep a cache of the ICU
+ * sort keys of the strings they have seen, so that most strings are run through
+ * the collator once per sort and most comparisons after that are a memcmp().
+ * Sort keys compare in the same order as the collator itself.
+ *
+ * The cache is direct mapped on a hash of the string's bytes, so an entry is
+ * valid for as long as the collator lives, whatever statement it came from.
+ * Short strings only are cached; anything else falls back to a plain
+ * comparison.
+ *
+ * With PRAGMA threads the sorter calls the collation from its worker threads
+ * as well, so the cache is guarded by a mutex. A comparison that finds the
+ * cache in use by another thread compares the strings directly instead of
+ * waiting for it.
+ */
+struct SortKeyEntry {
+    uint32_t hash;
+    uint16_t textLen;
+    uint16_t keyLen;
+    // textLen bytes of string followed by keyLen bytes of sort key
+    uint8_t * data;
+};
+
+struct SortKeyCollator {
+    UCollator * collator;
+    int utf16;
+    pthread_mutex_t mutex;
+    SortKeyEntry * cache;
+};
+
+static uint32_t sort_key_hash(const void * text, int n)
+{
+    const uint8_t * p = (const uint8_t *) text;
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < n; i++) {
+        hash = (hash ^ p[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Make e hold the sort key of the n byte string text, computing it if the
+// entry holds some other string. Returns false if the key can't be cached.
+static bool sort_key_lookup(SortKeyCollator * c, SortKeyEntry * e, uint32_t hash,
+        const void * text, int n)
+{
+    if (e->keyLen != 0 && e->hash == hash && e->textLen == n &&
+            memcmp(e->data, text, n) == 0) {
+        return true;
+    }
+
+    const UChar * s;
+    int32_t len;
+    UChar buf[SORT_KEY_MAX_TEXT];
+    if (c->utf16) {
+        s = (const UChar *) text;
+        len = n / sizeof(UChar);
+    } else {
+        UErrorCode status = U_ZERO_ERROR;
+        u_strFromUTF8(buf, SORT_KEY_MAX_TEXT, &len, (const char *) text, n, &status);
+        if (U_FAILURE(status)) {
+            return false;
+        }
+        s = buf;
+    }
+
+    uint8_t key[SORT_KEY_BUFFER_SIZE];
+    int32_t keyLen = ucol_getSortKey(c->collator, s, len, key, sizeof(key));
+    if (keyLen <= 0 || keyLen > (int32_t) sizeof(key)) {
+        return false;
+    }
+
+    uint8_t * data = (uint8_t *) realloc(e->data, n + keyLen);
+    if (data == NULL) {
+        return false;
+    }
+    memcpy(data, text, n);
+    memcpy(data + n, key, keyLen);
+    e->data = data;
+    e->hash = hash;
+    e->textLen = n;
+    e->keyLen = keyLen;
+    return true;
+}
+
+// Compare two short strings by their cached sort keys, with c->mutex held.
+// Returns false if either key can't be cached.
+static bool sort_key_compare(SortKeyCollator * c, int n1, const void *v1, int n2,
+        const void *v2, int * result)
+{
+    if (c->cache == NULL) {
+        c->cache = (SortKeyEntry *) calloc(SORT_KEY_CACHE_SIZE, sizeof(SortKeyEntry));
+        if (c->cache == NULL) {
+            return false;
+        }
+    }
+
+    uint32_t h1 = sort_key_hash(v1, n1);
+    uint32_t h2 = sort_key_hash(v2, n2);
+    SortKeyEntry * e1 = &c->cache[h1 & (SORT_KEY_CACHE_SIZE - 1)];
+    SortKeyEntry * e2 = &c->cache[h2 & (SORT_KEY_CACHE_SIZE - 1)];
+
+    // If both strings map to the same entry, filling it for the second
+    // would throw away the key of the first.
+    if (e1 == e2 || !sort_key_lookup(c, e1, h1, v1, n1) ||
+            !sort_key_lookup(c, e2, h2, v2, n2)) {
+        return false;
+    }
+
+    int n = e1->keyLen < e2->keyLen ? e1->keyLen : e2->keyLen;
+    int cmp = memcmp(e1->data + e1->textLen, e2->data + e2->textLen, n);
+    if (cmp == 0) {
+        cmp = e1->keyLen - e2->keyLen;
+    }
+    *result = cmp < 0 ? -1 : (cmp > 0 ? 1 : 0);
+    return true;
+}
+
+static int sort_key_collate(void *p, int n1, const void *v1, int n2, const void *v2)
+{
+    SortKeyCollator * c = (SortKeyCollator *) p;
+
+    if (n1 == n2 && memcmp(v1, v2, n1) == 0) {
+        return 0;
+    }
+
+    if (n1 <= SORT_KEY_MAX_TEXT && n2 <= SORT_KEY_MAX_TEXT &&
+            pthread_mutex_trylock(&c->mutex) == 0) {
+        int result;
+        bool cached = sort_key_compare(c, n1, v1, n2, v2, &result);
+        pthread_mutex_unlock(&c->mutex);
+        if (cached) {
+            return result;
+        }
+    }
+
+    return c->utf16 ? collate16(c->collator, n1, v1, n2, v2)
+                    : collate8(c->collator, n1, v1, n2, v2);
+}
+
+static void sort_key_collator_dtor(void * p)
+{
+    SortKeyCollator * c = (SortKeyCollator *) p;
+    if (c->cache != NULL) {
+        for (int i = 0; i < SORT_KEY_CACHE_SIZE; i++) {
+            free(c->cache[i].data);
+        }
+        free(c->cache);
+    }
+    pthread_mutex_destroy(&c->mutex);
+    ucol_close(c->collator);
+    free(c);
+}
+#endif
+
+/**
+ * This function is invoked as:
+ *
+ *  _LOCALIZED_SORT_KEY(<text>) or _UNICODE_SORT_KEY(<text>)
+ *
+ * It returns the ICU sort key of <text> for the LOCALIZED or UNICODE collator
+ * as a BLOB, or NULL if <text> is NULL. BLOBs compare with memcmp(), and sort
+ * keys compare in the same order as the strings do under the collator, so
+ *
+ *  ORDER BY _LOCALIZED_SORT_KEY(display_name)
+ *
+ * sorts like ORDER BY display_name COLLATE LOCALIZED while computing each key
+ * only once per row. The function is deterministic, so the key can also be kept
+ * in an index on the expression, which then serves the ORDER BY directly. Keys
+ * depend on the locale and ICU version, so such an index has to be rebuilt with
+ * REINDEX when either changes, as for any index using LOCALIZED.
+ */
+static void sort_key(sqlite3_context * context, int argc, sqlite3_value ** argv)
+{
+    if (argc != 1) {
+        sqlite3_result_null(context);
+        return;
+    }
+
+    UCollator * collator = (UCollator *)sqlite3_user_data(context);
+    const UChar * text = (const UChar *)sqlite3_value_text16(argv[0]);
+    if (text == NULL) {
+        sqlite3_result_null(context);
+        return;
+    }
+    int32_t len = sqlite3_value_bytes16(argv[0]) / sizeof(UChar);
+
+    // The key is returned without the terminating zero, which sorts the same.
+    uint8_t keybuf[SORT_KEY_BUFFER_SIZE];
+    int32_t size = ucol_getSortKey(collator, text, len, keybuf, sizeof(keybuf));
+    if (size > (int32_t) sizeof(keybuf)) {
+        uint8_t * key = (uint8_t *)sqlite3_malloc(size);
+        if (key == NULL) {
+            sqlite3_result_error_nomem(context);
+            return;
+        }
+        size = ucol_getSortKey(collator, text, len, key, size);
+        sqlite3_result_blob(context, key, size - 1, sqlite3_free);
+    } else if (size > 0) {
+        sqlite3_result_blob(context, keybuf, size - 1, SQLITE_TRANSIENT);
+    } else {
+        ALOGE("ucol_getSortKey failed");
+        sqlite3_result_null(context);
+    }
+}
+
 static void phone_numbers_equal(sqlite3_context * context, int argc, sqlite3_value ** argv)
 {
     if (argc != 2 && argc != 3) {
@@ -125,6 +353,44 @@ static void phone_number_stripped_reversed(sqlite3_context * context, int argc,
     sqlite3_result_text(context, (const char*)out, outlen, SQLITE_TRANSIENT);
 }
 
+/**
+ * This function is invoked as:
+ *
+ *  _PHONE_NUMBER_MIN_MATCH(<number>)
+ *
+ * It returns the last 7 dialable characters of <number> reversed, the key
+ * that the loose form of PHONE_NUMBERS_EQUAL matches on. Numbers that are
+ * PHONE_NUMBERS_EQUAL always have the same key, so with an index on the
+ * expression a caller ID lookup such as
+ *
+ *  CREATE INDEX phone_min_match ON phones (_PHONE_NUMBER_MIN_MATCH(number));
+ *  SELECT ... FROM phones
+ *      WHERE _PHONE_NUMBER_MIN_MATCH(number) = _PHONE_NUMBER_MIN_MATCH(?1)
+ *        AND PHONE_NUMBERS_EQUAL(number, ?1);
+ *
+ * only runs the full comparison on the rows found through the index, instead
+ * of on every row of the table. The key only narrows the loose comparison;
+ * the strict one (use_strict != 0) also matches some shorter numbers.
+ */
+static void phone_number_min_match(sqlite3_context * context, int argc,
+      sqlite3_value ** argv)
+{
+    if (argc != 1) {
+        sqlite3_result_int(context, 0);
+        return;
+    }
+
+    char const * number = (char const *)sqlite3_value_text(argv[0]);
+    if (number == NULL) {
+        sqlite3_result_null(context);
+        return;
+    }
+
+    char out[PHONE_NUMBER_BUFFER_SIZE];
+    int outlen = 0;
+    android::phone_number_min_match_key(number, out, PHONE_NUMBER_BUFFER_SIZE, &outlen);
+    sqlite3_result_text(context, (const char*)out, outlen, SQLITE_TRANSIENT);
+}
 
 #if ENABLE_ANDROID_LOG
 static void android_log(sqlite3_context * context, int argc, sqlite3_value ** argv)
@@ -205,10 +471,35 @@ static void delete_file(sqlite3_context * context, int argc, sqlite3_value ** ar
     }
 }
 
+// Number of tokens inserted by one statement in tokenize()
+#define TOKENIZE_BATCH_SIZE 8
+
+/**
+ * The state tokenize() keeps between calls with the same token table: the
+ * INSERT statements for 1 to TOKENIZE_BATCH_SIZE rows, with and without the
+ * token_index and tag columns, and the memory the hex keys of the tokens are
+ * built in.
+ */
+struct TokenizeData {
+    sqlite3_stmt * statements[2][2][TOKENIZE_BATCH_SIZE];
+    char * keys;
+    size_t keysSize;
+    uint32_t * tokenEnds;
+    int tokensSize;
+};
+
 static void tokenize_auxdata_delete(void * data)
 {
-    sqlite3_stmt * statement = (sqlite3_stmt *)data;
-    sqlite3_finalize(statement);
+    TokenizeData * tokenizeData = (TokenizeData *)data;
+    for (int i = 0; i < TOKENIZE_BATCH_SIZE; i++) {
+        sqlite3_finalize(tokenizeData->statements[0][0][i]);
+        sqlite3_finalize(tokenizeData->statements[0][1][i]);
+        sqlite3_finalize(tokenizeData->statements[1][0][i]);
+        sqlite3_finalize(tokenizeData->statements[1][1][i]);
+    }
+    free(tokenizeData->keys);
+    free(tokenizeData->tokenEnds);
+    free(tokenizeData);
 }
 
 static void base16Encode(char* dest, const char* src, uint32_t size)
@@ -226,6 +517,109 @@ struct SqliteUserData {
     UCollator* collator;
 };
 
+// Return the statement that inserts count tokens into tokenTable, preparing it
+// the first time. The parameters are ?1 for the source, ?2 for the tag, and
+// then the token and, if useTokenIndex, the token index of each row.
+static sqlite3_stmt * tokenize_statement(sqlite3 * handle, TokenizeData * tokenizeData,
+        char const * tokenTable, int count, int useTokenIndex, int useDataTag)
+{
+    sqlite3_stmt ** cached = &tokenizeData->statements[useTokenIndex != 0][useDataTag][count - 1];
+    sqlite3_stmt * statement = *cached;
+    if (statement != NULL) {
+        return statement;
+    }
+
+    char * sql = sqlite3_mprintf("INSERT INTO %s (token, source%s%s) VALUES",
+            tokenTable, useTokenIndex ? ", token_index" : "", useDataTag ? ", tag" : "");
+    int param = 3;
+    for (int i = 0; i < count && sql != NULL; i++) {
+        if (useTokenIndex) {
+            sql = sqlite3_mprintf("%z%s (?%d, ?1, ?%d%s)", sql, i ? "," : "",
+                    param, param + 1, useDataTag ? ", ?2" : "");
+            param += 2;
+        } else {
+            sql = sqlite3_mprintf("%z%s (?%d, ?1%s)", sql, i ? "," : "",
+                    param, useDataTag ? ", ?2" : "");
+            param += 1;
+        }
+    }
+    if (sql == NULL) {
+        return NULL;
+    }
+    int err = sqlite3_prepare_v2(handle, sql, -1, &statement, NULL);
+    sqlite3_free(sql);
+    if (err != SQLITE_OK) {
+        return NULL;
+    }
+    *cached = statement;
+    return statement;
+}
+
+// Append the hex collation key of token to the keys of tokenizeData as token
+// number index. Returns false if memory ran out or the key couldn't be made.
+static bool tokenize_add_key(TokenizeData * tokenizeData, UCollator * collator,
+        const UChar * token, int index)
+{
+    uint8_t keybuf[1024];
+    uint8_t * key = keybuf;
+    int32_t result = ucol_getSortKey(collator, token, -1, keybuf, sizeof(keybuf));
+    if (result > (int32_t) sizeof(keybuf)) {
+        // A super big string
+        key = (uint8_t *)malloc(result);
+        if (key == NULL) {
+            return false;
+        }
+        result = ucol_getSortKey(collator, token, -1, key, result);
+    }
+    if (result <= 0) {
+        ALOGE("ucol_getSortKey failed");
+        if (key != keybuf) {
+            free(key);
+        }
+        return false;
+    }
+
+    if (index >= tokenizeData->tokensSize) {
+        int size = tokenizeData->tokensSize ? tokenizeData->tokensSize * 2 : 16;
+        uint32_t * tokenEnds = (uint32_t *)realloc(tokenizeData->tokenEnds,
+                size * sizeof(uint32_t));
+        if (tokenEnds == NULL) {
+            if (key != keybuf) {
+                free(key);
+            }
+            return false;
+        }
+        tokenizeData->tokenEnds = tokenEnds;
+        tokenizeData->tokensSize = size;
+    }
+
+    uint32_t keysize = result - 1;
+    size_t start = index ? tokenizeData->tokenEnds[index - 1] : 0;
+    size_t end = start + keysize * 2;
+    if (end > tokenizeData->keysSize) {
+        size_t size = tokenizeData->keysSize ? tokenizeData->keysSize : 1024;
+        while (size < end) {
+            size *= 2;
+        }
+        char * keys = (char *)realloc(tokenizeData->keys, size);
+        if (keys == NULL) {
+            if (key != keybuf) {
+                free(key);
+            }
+            return false;
+        }
+        tokenizeData->keys = keys;
+        tokenizeData->keysSize = size;
+    }
+
+    base16Encode(tokenizeData->keys + start, (const char *)key, keysize);
+    tokenizeData->tokenEnds[index] = end;
+    if (key != keybuf) {
+        free(key);
+    }
+    return true;
+}
+
 /**
  * This function is invoked as:
  *
@@ -253,6 +647,10 @@ struct SqliteUserData {
  * In other words, there will be one row for the entire string,
  * and one row for each token except the first one.
  *
+ * The keys of all the tokens are built first, and then inserted up to
+ * TOKENIZE_BATCH_SIZE rows at a time by a multi-row INSERT, so that a
+ * typical name takes a single statement.
+ *
  * The function returns the number of tokens generated.
  */
 static void tokenize(sqlite3_context * context, int argc, sqlite3_value ** argv)
@@ -285,47 +683,21 @@ static void tokenize(sqlite3_context * context, int argc, sqlite3_value ** argv)
         return;
     }
 
-    // Get or create the prepared statement for the insertions
-    sqlite3_stmt * statement = (sqlite3_stmt *)sqlite3_get_auxdata(context, 0);
-    if (!statement) {
-        char const * tokenIndexCol = useTokenIndex ? ", token_index" : "";
-        char const * tokenIndexParam = useTokenIndex ? ", ?" : "";
-        char const * dataTagCol = useDataTag ? ", tag" : "";
-        char const * dataTagParam = useDataTag ? ", ?" : "";
-        char * sql = sqlite3_mprintf("INSERT INTO %s (token, source%s%s) VALUES (?, ?%s%s);",
-                tokenTable, tokenIndexCol, dataTagCol, tokenIndexParam, dataTagParam);
-        err = sqlite3_prepare_v2(handle, sql, -1, &statement, NULL);
-        sqlite3_free(sql);
-        if (err) {
-            ALOGE("prepare failed");
-            sqlite3_result_null(context);
+    // Get or create the statements and buffers for the insertions
+    TokenizeData * tokenizeData = (TokenizeData *)sqlite3_get_auxdata(context, 0);
+    if (!tokenizeData) {
+        tokenizeData = (TokenizeData *)calloc(1, sizeof(TokenizeData));
+        if (tokenizeData == NULL) {
+            sqlite3_result_error_nomem(context);
             return;
         }
-        // This binds the statement to the table it was compiled against, which is argv[0].
+        // This binds the statements to the table they are compiled against, which is argv[0].
         // If this function is ever called with a different table the finalizer will be called
         // and sqlite3_get_auxdata() will return null above, forcing a recompile for the new table.
-        sqlite3_set_auxdata(context, 0, statement, tokenize_auxdata_delete);
-    } else {
-        // Reset the cached statement so that binding the row ID will work properly
-        sqlite3_reset(statement);
-    }
-
-    // Bind the row ID of the source row
-    int64_t rowID = sqlite3_value_int64(argv[1]);
-    err = sqlite3_bind_int64(statement, 2, rowID);
-    if (err != SQLITE_OK) {
-        ALOGE("bind failed");
-        sqlite3_result_null(context);
-        return;
-    }
-
-    // Bind <data_tag> to the tag column
-    if (useDataTag) {
-        int dataTagParamIndex = useTokenIndex ? 4 : 3;
-        err = sqlite3_bind_value(statement, dataTagParamIndex, argv[5]);
-        if (err != SQLITE_OK) {
-            ALOGE("bind failed");
-            sqlite3_result_null(context);
+        sqlite3_set_auxdata(context, 0, tokenizeData, tokenize_auxdata_delete);
+        if (sqlite3_get_auxdata(context, 0) != tokenizeData) {
+            // sqlite3_set_auxdata() ran out of memory, and freed tokenizeData
+            sqlite3_result_error_nomem(context);
             return;
         }
     }
@@ -347,59 +719,64 @@ static void tokenize(sqlite3_context * context, int argc, sqlite3_value ** argv)
         return;
     }
 
-    UChar * token = NULL;
+    // Build the keys of the whole string and of each token after the first
+    UChar * token = origData;
     UChar *state;
-    int numTokens = 0;
-
+    int keyCount = 0;
     do {
-        if (numTokens == 0) {
-            token = origData;
+        if (!tokenize_add_key(tokenizeData, collator, token, keyCount)) {
+            break;
+        }
+        keyCount++;
+        if (keyCount == 1) {
+            // first call
+            u_strtok_r(origData, delim, &state);
         }
+    } while ((token = u_strtok_r(NULL, delim, &state)) != NULL);
 
-        // Reset the program so we can use it to perform the insert
-        sqlite3_reset(statement);
-        UErrorCode status = U_ZERO_ERROR;
-        char keybuf[1024];
-        uint32_t result = ucol_getSortKey(collator, token, -1, (uint8_t*)keybuf, sizeof(keybuf)-1);
-        if (result > sizeof(keybuf)) {
-            // TODO allocate memory for this super big string
-            ALOGE("ucol_getSortKey needs bigger buffer %d", result);
+    // Insert them
+    int numTokens = 0;
+    while (numTokens < keyCount) {
+        int count = keyCount - numTokens;
+        if (count > TOKENIZE_BATCH_SIZE) {
+            count = TOKENIZE_BATCH_SIZE;
+        }
+        sqlite3_stmt * statement = tokenize_statement(handle, tokenizeData, tokenTable,
+                count, useTokenIndex, useDataTag);
+        if (statement == NULL) {
+            ALOGE("prepare failed");
             break;
         }
-        uint32_t keysize = result-1;
-        uint32_t base16Size = keysize*2;
-        char *base16buf = (char*)malloc(base16Size);
-        base16Encode(base16buf, keybuf, keysize);
-        err = sqlite3_bind_text(statement, 1, base16buf, base16Size, SQLITE_STATIC);
 
-        if (err != SQLITE_OK) {
-            ALOGE(" sqlite3_bind_text16 error %d", err);
-            free(base16buf);
-            break;
+        // Bind the row ID of the source row, and <data_tag> to the tag column
+        err = sqlite3_bind_int64(statement, 1, sqlite3_value_int64(argv[1]));
+        if (err == SQLITE_OK && useDataTag) {
+            err = sqlite3_bind_value(statement, 2, argv[5]);
         }
 
-        if (useTokenIndex) {
-            err = sqlite3_bind_int(statement, 3, numTokens);
-            if (err != SQLITE_OK) {
-                ALOGE(" sqlite3_bind_int error %d", err);
-                free(base16buf);
-                break;
+        int param = 3;
+        for (int i = numTokens; i < numTokens + count && err == SQLITE_OK; i++) {
+            size_t start = i ? tokenizeData->tokenEnds[i - 1] : 0;
+            err = sqlite3_bind_text(statement, param++, tokenizeData->keys + start,
+                    tokenizeData->tokenEnds[i] - start, SQLITE_STATIC);
+            if (err == SQLITE_OK && useTokenIndex) {
+                err = sqlite3_bind_int(statement, param++, i);
             }
         }
+        if (err != SQLITE_OK) {
+            ALOGE("bind failed %d", err);
+            sqlite3_reset(statement);
+            break;
+        }
 
         err = sqlite3_step(statement);
-        free(base16buf);
-
+        sqlite3_reset(statement);
         if (err != SQLITE_DONE) {
             ALOGE(" sqlite3_step error %d", err);
             break;
         }
-        numTokens++;
-        if (numTokens == 1) {
-            // first call
-            u_strtok_r(origData, delim, &state);
-        }
-    } while ((token = u_strtok_r(NULL, delim, &state)) != NULL);
+        numTokens += count;
+    }
     sqlite3_result_int(context, numTokens);
 }
 
@@ -408,6 +785,31 @@ static void localized_collator_dtor(UCollator* collator)
     ucol_close(collator);
 }
 
+// Register collator as the collation name, which then owns the collator.
+static int create_collation(sqlite3* handle, const char* name, UCollator* collator, int utf16Storage)
+{
+#if ENABLE_SORT_KEY_CACHE
+    SortKeyCollator* c = (SortKeyCollator*)calloc(1, sizeof(SortKeyCollator));
+    if (c == NULL) {
+        ucol_close(collator);
+        return SQLITE_NOMEM;
+    }
+    c->collator = collator;
+    c->utf16 = utf16Storage;
+    pthread_mutex_init(&c->mutex, NULL);
+    return sqlite3_create_collation_v2(handle, name, utf16Storage ? SQLITE_UTF16 : SQLITE_UTF8, c,
+            sort_key_collate, sort_key_collator_dtor);
+#else
+    if (utf16Storage) {
+        return sqlite3_create_collation_v2(handle, name, SQLITE_UTF16, collator,
+                collate16, (void(*)(void*))localized_collator_dtor);
+    } else {
+        return sqlite3_create_collation_v2(handle, name, SQLITE_UTF8, collator,
+                collate8, (void(*)(void*))localized_collator_dtor);
+    }
+#endif
+}
+
 #define LOCALIZED_COLLATOR_NAME "LOCALIZED"
 
 // This collator may be removed in the near future, so you MUST not use now.
@@ -433,14 +835,14 @@ extern "C" int register_localized_collators(sqlite3* handle, const char* systemL
     char buf[1024];
     ucol_getShortDefinitionString(collator, NULL, buf, 1024, &status);
 
-    if (utf16Storage) {
-        err = sqlite3_create_collation_v2(handle, LOCALIZED_COLLATOR_NAME, SQLITE_UTF16, collator,
-                collate16, (void(*)(void*))localized_collator_dtor);
-    } else {
-        err = sqlite3_create_collation_v2(handle, LOCALIZED_COLLATOR_NAME, SQLITE_UTF8, collator,
-                collate8, (void(*)(void*))localized_collator_dtor);
+    err = create_collation(handle, LOCALIZED_COLLATOR_NAME, collator, utf16Storage);
+    if (err != SQLITE_OK) {
+        return err;
     }
 
+    // Register the _LOCALIZED_SORT_KEY function
+    err = sqlite3_create_function(handle, "_LOCALIZED_SORT_KEY", 1,
+            SQLITE_UTF16 | SQLITE_DETERMINISTIC, collator, sort_key, NULL, NULL);
     if (err != SQLITE_OK) {
         return err;
     }
@@ -492,6 +894,259 @@ extern "C" int register_localized_collators(sqlite3* handle, const char* systemL
 }
 
 
+/**
+ * Background WAL checkpointing.
+ *
+ * Normally the writer whose commit takes the WAL past wal_autocheckpoint pages
+ * runs the checkpoint itself, inside its commit. register_wal_checkpointer()
+ * turns that off for a connection and instead runs the checkpoints on a thread
+ * of its own, through a second connection to the same database:
+ *
+ * - once the WAL holds passivePages pages and there has been no commit for
+ *   idleMs, it runs a PASSIVE checkpoint, which never waits for anybody;
+ * - once the WAL holds restartPages pages it doesn't wait for the database to
+ *   go idle, and runs a RESTART checkpoint so that the WAL starts over from
+ *   the beginning instead of growing further. A PASSIVE checkpoint can't do
+ *   that while writers keep appending to the WAL, but a RESTART checkpoint
+ *   holds up writers while it runs, so it is left for that case.
+ *
+ * The thread stops when the connection is closed.
+ */
+struct WalCheckpointer {
+    char * path;
+    sqlite3 * checkpointHandle;
+    int idleMs;
+    int passivePages;
+    int restartPages;
+
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool stop;
+
+    // Written by the WAL hook
+    int walPages;
+    int64_t commits;
+    int64_t lastCommitUs;
+    int64_t checkpointedCommits;
+
+    // Statistics
+    int64_t passiveCount;
+    int64_t restartCount;
+    int64_t busyCount;
+    int64_t errorCount;
+    int64_t totalUs;
+    int64_t maxUs;
+    int lastLogPages;
+    int lastCheckpointedPages;
+};
+
+static int64_t checkpoint_now_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int checkpoint_wal_hook(void * data, sqlite3 * handle, const char * dbName, int pages)
+{
+    WalCheckpointer * c = (WalCheckpointer *) data;
+    if (strcmp(dbName, "main") != 0) {
+        return SQLITE_OK;
+    }
+    pthread_mutex_lock(&c->mutex);
+    c->walPages = pages;
+    c->commits++;
+    c->lastCommitUs = checkpoint_now_us();
+    pthread_cond_signal(&c->cond);
+    pthread_mutex_unlock(&c->mutex);
+    return SQLITE_OK;
+}
+
+static void * checkpoint_thread(void * data)
+{
+    WalCheckpointer * c = (WalCheckpointer *) data;
+
+    pthread_mutex_lock(&c->mutex);
+    while (!c->stop) {
+        // Nothing was committed since the last checkpoint, or the WAL is still
+        // small: wait for the next commit.
+        if (c->commits == c->checkpointedCommits || c->walPages < c->passivePages) {
+            pthread_cond_wait(&c->cond, &c->mutex);
+            continue;
+        }
+
+        bool restart = c->walPages >= c->restartPages;
+        int64_t idleUntil = c->lastCommitUs + (int64_t) c->idleMs * 1000;
+        if (!restart && checkpoint_now_us() < idleUntil) {
+            struct timespec ts;
+            ts.tv_sec = idleUntil / 1000000;
+            ts.tv_nsec = (idleUntil % 1000000) * 1000;
+            pthread_cond_timedwait(&c->cond, &c->mutex, &ts);
+            continue;
+        }
+
+        int64_t commits = c->commits;
+        pthread_mutex_unlock(&c->mutex);
+
+        int64_t start = checkpoint_now_us();
+        int mode = restart ? SQLITE_CHECKPOINT_RESTART : SQLITE_CHECKPOINT_PASSIVE;
+        int logPages = 0;
+        int checkpointedPages = 0;
+        int err = sqlite3_wal_checkpoint_v2(c->checkpointHandle, "main", mode,
+                &logPages, &checkpointedPages);
+        if (err == SQLITE_OK && logPages == -1) {
+            // The connection only notices that the database is in WAL mode
+            // once it reads it.
+            err = sqlite3_exec(c->checkpointHandle, "PRAGMA schema_version", NULL, NULL, NULL);
+            if (err == SQLITE_OK) {
+                err = sqlite3_wal_checkpoint_v2(c->checkpointHandle, "main", mode,
+                        &logPages, &checkpointedPages);
+            }
+        }
+        int64_t elapsed = checkpoint_now_us() - start;
+
+        pthread_mutex_lock(&c->mutex);
+        // Don't try again until something else is committed, whatever happened.
+        c->checkpointedCommits = commits;
+        if (err == SQLITE_OK) {
+            if (restart) {
+                c->restartCount++;
+            } else {
+                c->passiveCount++;
+            }
+            c->totalUs += elapsed;
+            if (elapsed > c->maxUs) {
+                c->maxUs = elapsed;
+            }
+            c->lastLogPages = logPages;
+            c->lastCheckpointedPages = checkpointedPages;
+        } else if (err == SQLITE_BUSY) {
+            c->busyCount++;
+        } else {
+            ALOGE("background checkpoint of %s failed: %d", c->path, err);
+            c->errorCount++;
+        }
+    }
+    pthread_mutex_unlock(&c->mutex);
+    return NULL;
+}
+
+static void checkpointer_free(WalCheckpointer * c)
+{
+    sqlite3_close(c->checkpointHandle);
+    pthread_cond_destroy(&c->cond);
+    pthread_mutex_destroy(&c->mutex);
+    free(c->path);
+    free(c);
+}
+
+// Called when the connection the checkpointer serves is closed.
+static void checkpointer_dtor(void * data)
+{
+    WalCheckpointer * c = (WalCheckpointer *) data;
+    pthread_mutex_lock(&c->mutex);
+    c->stop = true;
+    pthread_cond_signal(&c->cond);
+    pthread_mutex_unlock(&c->mutex);
+    pthread_join(c->thread, NULL);
+    checkpointer_free(c);
+}
+
+/**
+ * This function is invoked as:
+ *
+ *  _CHECKPOINT_STATS()
+ *
+ * It returns the statistics of the background checkpointer of the connection
+ * as a string of space separated name=value pairs: the number of PASSIVE and
+ * RESTART checkpoints run, the number of them that found the database busy or
+ * failed, the total and longest time spent checkpointing in microseconds, the
+ * size of the WAL and the number of pages checkpointed in the last one, and
+ * the size of the WAL at the last commit.
+ */
+static void checkpoint_stats(sqlite3_context * context, int argc, sqlite3_value ** argv)
+{
+    WalCheckpointer * c = (WalCheckpointer *)sqlite3_user_data(context);
+
+    pthread_mutex_lock(&c->mutex);
+    char * stats = sqlite3_mprintf("passive=%lld restart=%lld busy=%lld errors=%lld "
+            "total_us=%lld max_us=%lld last_log=%d last_checkpointed=%d wal_pages=%d",
+            (long long) c->passiveCount, (long long) c->restartCount,
+            (long long) c->busyCount, (long long) c->errorCount,
+            (long long) c->totalUs, (long long) c->maxUs,
+            c->lastLogPages, c->lastCheckpointedPages, c->walPages);
+    pthread_mutex_unlock(&c->mutex);
+
+    if (stats == NULL) {
+        sqlite3_result_error_nomem(context);
+        return;
+    }
+    sqlite3_result_text(context, stats, -1, sqlite3_free);
+}
+
+extern "C" int register_wal_checkpointer(sqlite3* handle, int idleMs, int passivePages,
+        int restartPages)
+{
+    int err;
+
+    const char* path = sqlite3_db_filename(handle, "main");
+    if (path == NULL || path[0] == '\0') {
+        // In-memory and temporary databases have no WAL
+        return SQLITE_MISUSE;
+    }
+
+    WalCheckpointer* c = (WalCheckpointer*)calloc(1, sizeof(WalCheckpointer));
+    if (c == NULL) {
+        return SQLITE_NOMEM;
+    }
+    c->path = strdup(path);
+    c->idleMs = idleMs > 0 ? idleMs : CHECKPOINT_IDLE_MS;
+    c->passivePages = passivePages > 0 ? passivePages : CHECKPOINT_PASSIVE_PAGES;
+    c->restartPages = restartPages > 0 ? restartPages : CHECKPOINT_RESTART_PAGES;
+    if (c->restartPages < c->passivePages) {
+        c->restartPages = c->passivePages;
+    }
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&c->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&c->mutex, NULL);
+
+    if (c->path == NULL) {
+        checkpointer_free(c);
+        return SQLITE_NOMEM;
+    }
+
+    err = sqlite3_open_v2(c->path, &c->checkpointHandle, SQLITE_OPEN_READWRITE, NULL);
+    if (err != SQLITE_OK) {
+        checkpointer_free(c);
+        return err;
+    }
+    // A RESTART checkpoint waits this long for readers before giving up
+    sqlite3_busy_timeout(c->checkpointHandle, CHECKPOINT_BUSY_TIMEOUT_MS);
+
+    if (pthread_create(&c->thread, NULL, checkpoint_thread, c) != 0) {
+        checkpointer_free(c);
+        return SQLITE_ERROR;
+    }
+
+    // The function owns the checkpointer, so the thread is stopped when the
+    // connection is closed.
+    err = sqlite3_create_function_v2(handle, "_CHECKPOINT_STATS", 0, SQLITE_UTF8, c,
+            checkpoint_stats, NULL, NULL, checkpointer_dtor);
+    if (err != SQLITE_OK) {
+        checkpointer_dtor(c);
+        return err;
+    }
+
+    // This replaces the hook that runs the automatic checkpoints
+    sqlite3_wal_hook(handle, checkpoint_wal_hook, c);
+    return SQLITE_OK;
+}
+
 extern "C" int register_android_functions(sqlite3 * handle, int utf16Storage)
 {
     int err;
@@ -508,15 +1163,17 @@ extern "C" int register_android_functions(sqlite3 * handle, int utf16Storage)
         if (err != SQLITE_OK) {
             return err;
         }
+    }
 
-        // Register the UNICODE collation
-        err = sqlite3_create_collation_v2(handle, "UNICODE", SQLITE_UTF16, collator, collate16,
-                (void(*)(void*))localized_collator_dtor);
-    } else {
-        err = sqlite3_create_collation_v2(handle, "UNICODE", SQLITE_UTF8, collator, collate8,
-                (void(*)(void*))localized_collator_dtor);
+    // Register the UNICODE collation
+    err = create_collation(handle, "UNICODE", collator, utf16Storage);
+    if (err != SQLITE_OK) {
+        return err;
     }
 
+    // Register the _UNICODE_SORT_KEY function
+    err = sqlite3_create_function(handle, "_UNICODE_SORT_KEY", 1,
+            SQLITE_UTF16 | SQLITE_DETERMINISTIC, collator, sort_key, NULL, NULL);
     if (err != SQLITE_OK) {
         return err;
     }
@@ -537,6 +1194,14 @@ extern "C" int register_android_functions(sqlite3 * handle, int utf16Storage)
         return err;
     }
 
+    // Register the _PHONE_NUMBER_MIN_MATCH function. It is deterministic so that
+    // it can be used in an index, see phone_number_min_match().
+    err = sqlite3_create_function(handle, "_PHONE_NUMBER_MIN_MATCH", 1,
+            SQLITE_UTF8 | SQLITE_DETERMINISTIC, NULL, phone_number_min_match, NULL, NULL);
+    if (err != SQLITE_OK) {
+        return err;
+    }
+
     // Register the _DELETE_FILE function
     err = sqlite3_create_function(handle, "_DELETE_FILE", 1, SQLITE_UTF8, NULL, delete_file, NULL, NULL);
     if (err != SQLITE_OK) {
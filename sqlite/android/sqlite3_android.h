@@ -27,6 +27,18 @@ int register_android_functions(sqlite3 * handle, int uit16Storage);
 
 int register_localized_collators(sqlite3* handle, const char* systemLocale, int utf16Storage);
 
+/*
+ * Run the WAL checkpoints of handle on a background thread instead of in the
+ * committing writer. A PASSIVE checkpoint runs once the WAL holds passivePages
+ * pages and nothing has been committed for idleMs, a RESTART checkpoint runs
+ * as soon as it holds restartPages pages. Zero or negative values select the
+ * defaults of 500ms, 1000 and 4000 pages. Statistics are available from the
+ * SQL function _CHECKPOINT_STATS(). handle should have a busy timeout, as a
+ * RESTART checkpoint locks out writers while it runs. Setting PRAGMA
+ * wal_autocheckpoint later brings back the automatic checkpoints in the writer.
+ */
+int register_wal_checkpointer(sqlite3* handle, int idleMs, int passivePages, int restartPages);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -7,16 +7,28 @@
 LOCAL_PATH:= $(call my-dir)
 
 # NOTE the following flags,
-#   SQLITE_TEMP_STORE=3 causes all TEMP files to go into RAM. and thats the behavior we want
+#   SQLITE_TEMP_STORE=2 causes all TEMP files to go into RAM. and thats the behavior we want,
+#       unless a connection asks for files with "PRAGMA temp_store=FILE".
 #   SQLITE_ENABLE_FTS3   enables usage of FTS3 - NOT FTS1 or 2.
 #   SQLITE_DEFAULT_AUTOVACUUM=1  causes the databases to be subject to auto-vacuum
+#   SQLITE_MAX_WORKER_THREADS=4  lets "PRAGMA threads" give the sorter up to 4 helper
+#       threads for large CREATE INDEX and ORDER BY. The default is still 0 threads. The
+#       helpers sort and merge runs that the sorter spills to temporary files, so they are
+#       only used on a connection that has also run "PRAGMA temp_store=FILE" and can write
+#       to the temporary directory; with temporary data in RAM the sorter runs on one thread.
+#   SQLITE_DEFAULT_MMAP_SIZE  is left at 0. A connection can opt in with "PRAGMA mmap_size=N"
+#       to read database pages through a shared memory mapping of the file instead of copying
+#       them into its page cache, so a pool of connections to one database keeps a single copy
+#       of the clean pages, in the kernel's page cache. Pages with newer versions in the WAL
+#       are still read into the page cache.
 minimal_sqlite_flags := \
 	-DNDEBUG=1 \
 	-DHAVE_USLEEP=1 \
 	-DSQLITE_HAVE_ISNAN \
 	-DSQLITE_DEFAULT_JOURNAL_SIZE_LIMIT=1048576 \
 	-DSQLITE_THREADSAFE=2 \
-	-DSQLITE_TEMP_STORE=3 \
+	-DSQLITE_TEMP_STORE=2 \
+	-DSQLITE_MAX_WORKER_THREADS=4 \
 	-DSQLITE_POWERSAFE_OVERWRITE=1 \
 	-DSQLITE_DEFAULT_FILE_FORMAT=4 \
 	-DSQLITE_DEFAULT_AUTOVACUUM=1 \
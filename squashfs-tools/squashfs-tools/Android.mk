@@ -24,6 +24,7 @@ LOCAL_SRC_FILES := \
     restore.c \
     process_fragments.c \
     caches-queues-lists.c \
+    reuse.c \
     xattr.c \
     read_xattrs.c \
     gzip_wrapper.c \
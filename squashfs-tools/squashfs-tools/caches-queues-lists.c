@@ -36,6 +36,20 @@ extern int multiply_overflow(int, int);
 #define TRUE 1
 #define FALSE 0
 
+
+/*
+ * Lock mutex, counting the times it was already held by another thread.
+ * The count is updated with the mutex held
+ */
+static void lock_counted(pthread_mutex_t *mutex, unsigned int *contended)
+{
+	if(pthread_mutex_trylock(mutex) != 0) {
+		pthread_mutex_lock(mutex);
+		(*contended) ++;
+	}
+}
+
+
 struct queue *queue_init(int size)
 {
 	struct queue *queue = malloc(sizeof(struct queue));
@@ -53,6 +67,7 @@ struct queue *queue_init(int size)
 
 	queue->size = size + 1;
 	queue->readp = queue->writep = 0;
+	queue->contended = queue->empty_waits = queue->full_waits = 0;
 	pthread_mutex_init(&queue->mutex, NULL);
 	pthread_cond_init(&queue->empty, NULL);
 	pthread_cond_init(&queue->full, NULL);
@@ -66,10 +81,12 @@ void queue_put(struct queue *queue, void *data)
 	int nextp;
 
 	pthread_cleanup_push((void *) pthread_mutex_unlock, &queue->mutex);
-	pthread_mutex_lock(&queue->mutex);
+	lock_counted(&queue->mutex, &queue->contended);
 
-	while((nextp = (queue->writep + 1) % queue->size) == queue->readp)
+	while((nextp = (queue->writep + 1) % queue->size) == queue->readp) {
+		queue->full_waits ++;
 		pthread_cond_wait(&queue->full, &queue->mutex);
+	}
 
 	queue->data[queue->writep] = data;
 	queue->writep = nextp;
@@ -83,10 +100,12 @@ void *queue_get(struct queue *queue)
 	void *data;
 
 	pthread_cleanup_push((void *) pthread_mutex_unlock, &queue->mutex);
-	pthread_mutex_lock(&queue->mutex);
+	lock_counted(&queue->mutex, &queue->contended);
 
-	while(queue->readp == queue->writep)
+	while(queue->readp == queue->writep) {
+		queue->empty_waits ++;
 		pthread_cond_wait(&queue->empty, &queue->mutex);
+	}
 
 	data = queue->data[queue->readp];
 	queue->readp = (queue->readp + 1) % queue->size;
@@ -97,6 +116,39 @@ void *queue_get(struct queue *queue)
 }
 
 
+/*
+ * Get up to max entries from the queue in one go, waiting until at least
+ * one is available.  Used by single consumer threads, to take the queue
+ * lock once for many entries
+ */
+int queue_get_batch(struct queue *queue, void **data, int max)
+{
+	int count;
+
+	pthread_cleanup_push((void *) pthread_mutex_unlock, &queue->mutex);
+	lock_counted(&queue->mutex, &queue->contended);
+
+	while(queue->readp == queue->writep) {
+		queue->empty_waits ++;
+		pthread_cond_wait(&queue->empty, &queue->mutex);
+	}
+
+	for(count = 0; count < max && queue->readp != queue->writep;
+								count ++) {
+		data[count] = queue->data[queue->readp];
+		queue->readp = (queue->readp + 1) % queue->size;
+	}
+
+	if(count == 1)
+		pthread_cond_signal(&queue->full);
+	else
+		pthread_cond_broadcast(&queue->full);
+	pthread_cleanup_pop(1);
+
+	return count;
+}
+
+
 int queue_empty(struct queue *queue)
 {
 	int empty;
@@ -134,6 +186,9 @@ void dump_queue(struct queue *queue)
 		queue->readp == queue->writep ? " (EMPTY)" :
 			((queue->writep + 1) % queue->size) == queue->readp ?
 			" (FULL)" : "");
+	printf("\tLock contended %u times, waited %u times when empty, %u "
+		"times when full\n", queue->contended, queue->empty_waits,
+		queue->full_waits);
 
 	pthread_cleanup_pop(1);
 }
@@ -169,7 +224,7 @@ struct seq_queue *seq_queue_init()
 void seq_queue_put(struct seq_queue *queue, struct file_buffer *entry)
 {
 	pthread_cleanup_push((void *) pthread_mutex_unlock, &queue->mutex);
-	pthread_mutex_lock(&queue->mutex);
+	lock_counted(&queue->mutex, &queue->contended);
 
 	insert_seq_hash_table(queue, entry);
 
@@ -195,7 +250,7 @@ struct file_buffer *seq_queue_get(struct seq_queue *queue)
 	struct file_buffer *entry;
 
 	pthread_cleanup_push((void *) pthread_mutex_unlock, &queue->mutex);
-	pthread_mutex_lock(&queue->mutex);
+	lock_counted(&queue->mutex, &queue->contended);
 
 	while(1) {
 		for(entry = queue->hash_table[hash]; entry;
@@ -221,6 +276,7 @@ struct file_buffer *seq_queue_get(struct seq_queue *queue)
 		}
 
 		/* entry not found, wait for it to arrive */	
+		queue->waits ++;
 		pthread_cond_wait(&queue->wait, &queue->mutex);
 	}
 
@@ -257,6 +313,8 @@ void dump_seq_queue(struct seq_queue *queue, int fragment_queue)
 
 	printf("\tMax size unlimited, size %d%s\n", size,
 						size == 0 ? " (EMPTY)" : "");
+	printf("\tLock contended %u times, waited %u times\n",
+		queue->contended, queue->waits);
 
 	pthread_cleanup_pop(1);
 }
@@ -293,6 +351,7 @@ struct cache *cache_init(int buffer_size, int max_buffers, int noshrink_lookup,
 	cache->count = 0;
 	cache->used = 0;
 	cache->free_list = NULL;
+	cache->contended = cache->waits = 0;
 
 	/*
 	 * The cache will grow up to max_buffers in size in response to
@@ -336,7 +395,7 @@ struct file_buffer *cache_lookup(struct cache *cache, long long index)
 	struct file_buffer *entry;
 
 	pthread_cleanup_push((void *) pthread_mutex_unlock, &cache->mutex);
-	pthread_mutex_lock(&cache->mutex);
+	lock_counted(&cache->mutex, &cache->contended);
 
 	for(entry = cache->hash_table[hash]; entry; entry = entry->hash_next)
 		if(entry->index == index)
@@ -394,7 +453,7 @@ static struct file_buffer *_cache_get(struct cache *cache, long long index,
 	struct file_buffer *entry = NULL;
  
 	pthread_cleanup_push((void *) pthread_mutex_unlock, &cache->mutex);
-	pthread_mutex_lock(&cache->mutex);
+	lock_counted(&cache->mutex, &cache->contended);
 
 	while(1) {
 		if(cache->noshrink_lookup) {	
@@ -418,6 +477,7 @@ static struct file_buffer *_cache_get(struct cache *cache, long long index,
 			break;
 
 		/* wait for a block */
+		cache->waits ++;
 		pthread_cond_wait(&cache->wait_for_free, &cache->mutex);
 	}
 
@@ -484,7 +544,7 @@ void cache_block_put(struct file_buffer *entry)
 	cache = entry->cache;
 
 	pthread_cleanup_push((void *) pthread_mutex_unlock, &cache->mutex);
-	pthread_mutex_lock(&cache->mutex);
+	lock_counted(&cache->mutex, &cache->contended);
 
 	entry->used --;
 	if(entry->used == 0) {
@@ -517,6 +577,8 @@ void dump_cache(struct cache *cache)
 		printf("\tMax buffers %d, Current size %d, Maximum historical "
 			"size %d\n", cache->max_buffers, cache->count,
 			cache->max_count);
+	printf("\tLock contended %u times, waited %u times for a free "
+		"buffer\n", cache->contended, cache->waits);
 
 	pthread_cleanup_pop(1);
 }
@@ -117,6 +117,9 @@ struct file_buffer {
 	};
 	int size;
 	int c_byte;
+	/* hash and size of the uncompressed data block, for -reuse-index */
+	unsigned int hash;
+	int uncompressed_size;
 	char used;
 	char fragment;
 	char error;
@@ -136,6 +139,10 @@ struct queue {
 	pthread_cond_t		empty;
 	pthread_cond_t		full;
 	void			**data;
+	/* contention counters, reported by dump_queue() */
+	unsigned int		contended;
+	unsigned int		empty_waits;
+	unsigned int		full_waits;
 };
 
 
@@ -149,6 +156,8 @@ struct seq_queue {
 	struct file_buffer	*hash_table[HASH_SIZE];
 	pthread_mutex_t		mutex;
 	pthread_cond_t		wait;
+	unsigned int		contended;
+	unsigned int		waits;
 };
 
 
@@ -167,6 +176,8 @@ struct cache {
 	pthread_mutex_t	mutex;
 	pthread_cond_t wait_for_free;
 	pthread_cond_t wait_for_unlock;
+	unsigned int contended;
+	unsigned int waits;
 	struct file_buffer *free_list;
 	struct file_buffer *hash_table[HASH_SIZE];
 };
@@ -175,6 +186,7 @@ struct cache {
 extern struct queue *queue_init(int);
 extern void queue_put(struct queue *, void *);
 extern void *queue_get(struct queue *);
+extern int queue_get_batch(struct queue *, void **, int);
 extern int queue_empty(struct queue *);
 extern void queue_flush(struct queue *);
 extern void dump_queue(struct queue *);
@@ -27,4 +27,5 @@
 extern void disable_info();
 extern void update_info(struct dir_ent *);
 extern void init_info();
+extern void dump_state();
 #endif
@@ -80,6 +80,7 @@
 #include "read_fs.h"
 #include "restore.h"
 #include "process_fragments.h"
+#include "reuse.h"
 
 /* ANDROID CHANGES START*/
 #ifdef ANDROID
@@ -110,6 +111,7 @@ int no_fragments = FALSE;
 int always_use_fragments = FALSE;
 int noI = FALSE;
 int noD = FALSE;
+int min_saving = 0;
 int silent = TRUE;
 int exportable = TRUE;
 int sparse_files = TRUE;
@@ -262,6 +264,7 @@ int sorted = FALSE;
 
 /* save destination file name for deleting on error */
 char *destination_file = NULL;
+char *reuse_index = NULL;
 
 /* recovery file for abnormal exit on appending */
 char *recovery_file = NULL;
@@ -286,6 +289,7 @@ pthread_mutex_t	dup_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 /* user options that control parallelisation */
 int processors = -1;
+int prefetchers = -1;
 int bwriter_size;
 
 /* compression operations */
@@ -435,7 +439,14 @@ int mangle2(void *strm, char *d, char *s, int size,
 				"code %d\n", comp->name, error);
 	}
 
-	if(c_byte == 0 || c_byte >= size) {
+	/*
+	 * Store the block uncompressed if compression failed to shrink it,
+	 * or for data blocks if it didn't save at least min_saving percent.
+	 * Such blocks aren't worth the cost of decompressing them on every
+	 * read
+	 */
+	if(c_byte == 0 || c_byte >= size || (data_block && c_byte > size -
+			(long long) size * min_saving / 100)) {
 		memcpy(d, s, size);
 		return size | (data_block ? SQUASHFS_COMPRESSED_BIT_BLOCK :
 			SQUASHFS_COMPRESSED_BIT);
@@ -2326,6 +2337,43 @@ read_err2:
 }
 
 
+/*
+ * The reader reads the files in a fixed order, so that the output is
+ * deterministic, and so it waits for every open and read in turn.  To
+ * overlap that latency, the files are first put in a list in the order the
+ * reader will read them, and a pool of prefetch threads work down the list
+ * ahead of the reader, opening each file and asking the kernel to read it
+ * into the page cache.  The prefetchers are kept within PREFETCH_FILES files
+ * and PREFETCH_BYTES bytes of the reader so they don't evict what they have
+ * prefetched before the reader gets to it.
+ */
+#define PREFETCH_FILES 4096
+#define PREFETCH_BYTES (64 * 1024 * 1024)
+
+static struct dir_ent **read_list = NULL;
+static int read_list_count = 0, read_list_size = 0;
+
+/* protected by prefetch_mutex */
+static int prefetch_next = 0, read_next = 0;
+static long long prefetch_bytes = 0, read_bytes_done = 0;
+static pthread_mutex_t prefetch_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t prefetch_cond = PTHREAD_COND_INITIALIZER;
+
+
+void add_read_list(struct dir_ent *dir_ent)
+{
+	if(read_list_count == read_list_size) {
+		read_list_size = read_list_size ? read_list_size * 2 : 1024;
+		read_list = realloc(read_list, read_list_size *
+			sizeof(struct dir_ent *));
+		if(read_list == NULL)
+			MEM_ERROR();
+	}
+
+	read_list[read_list_count ++] = dir_ent;
+}
+
+
 void reader_scan(struct dir_info *dir) {
 	struct dir_ent *dir_ent = dir->list;
 
@@ -2335,13 +2383,13 @@ void reader_scan(struct dir_info *dir) {
 			continue;
 
 		if(IS_PSEUDO_PROCESS(dir_ent->inode)) {
-			reader_read_process(dir_ent);
+			add_read_list(dir_ent);
 			continue;
 		}
 
 		switch(buf->st_mode & S_IFMT) {
 			case S_IFREG:
-				reader_read_file(dir_ent);
+				add_read_list(dir_ent);
 				break;
 			case S_IFDIR:
 				reader_scan(dir_ent->dir);
@@ -2351,57 +2399,181 @@ void reader_scan(struct dir_info *dir) {
 }
 
 
+void prefetch_file(struct dir_ent *dir_ent, char **pathname, int *size)
+{
+	int file;
+
+	if(dir_ent->nonstandard_pathname)
+		*pathname = dir_ent->nonstandard_pathname;
+	else
+		*pathname = _pathname(dir_ent, *pathname, size);
+
+	file = open(*pathname, O_RDONLY);
+
+	if(dir_ent->nonstandard_pathname)
+		*pathname = NULL;
+
+	if(file == -1)
+		/* the reader will report the error */
+		return;
+
+#ifdef POSIX_FADV_WILLNEED
+	posix_fadvise(file, 0, 0, POSIX_FADV_WILLNEED);
+#else
+	{
+		char buffer[4096];
+
+		while(read(file, buffer, sizeof(buffer)) > 0);
+	}
+#endif
+	close(file);
+}
+
+
+void *prefetcher(void *arg)
+{
+	char *pathname = NULL;
+	int size = ALLOC_SIZE;
+
+	pthread_mutex_lock(&prefetch_mutex);
+	while(prefetch_next < read_list_count) {
+		struct dir_ent *dir_ent = read_list[prefetch_next];
+
+		if(prefetch_next - read_next >= PREFETCH_FILES ||
+				prefetch_bytes - read_bytes_done >=
+				PREFETCH_BYTES) {
+			pthread_cond_wait(&prefetch_cond, &prefetch_mutex);
+			continue;
+		}
+
+		prefetch_next ++;
+		if(IS_PSEUDO_PROCESS(dir_ent->inode))
+			continue;
+		prefetch_bytes += dir_ent->inode->buf.st_size;
+		pthread_mutex_unlock(&prefetch_mutex);
+
+		prefetch_file(dir_ent, &pathname, &size);
+
+		pthread_mutex_lock(&prefetch_mutex);
+	}
+	pthread_mutex_unlock(&prefetch_mutex);
+
+	free(pathname);
+	return NULL;
+}
+
+
 void *reader(void *arg)
 {
+	pthread_t *prefetch_thread = NULL;
+	int i;
+
 	if(!sorted)
 		reader_scan(queue_get(to_reader));
 	else {
-		int i;
 		struct priority_entry *entry;
 
 		queue_get(to_reader);
 		for(i = 65535; i >= 0; i--)
 			for(entry = priority_list[i]; entry;
 							entry = entry->next)
-				reader_read_file(entry->dir);
+				add_read_list(entry->dir);
+	}
+
+	if(prefetchers) {
+		prefetch_thread = malloc(prefetchers * sizeof(pthread_t));
+		if(prefetch_thread == NULL)
+			MEM_ERROR();
+
+		for(i = 0; i < prefetchers; i++)
+			if(pthread_create(&prefetch_thread[i], NULL,
+					prefetcher, NULL) != 0)
+				BAD_ERROR("Failed to create thread\n");
+	}
+
+	for(i = 0; i < read_list_count; i++) {
+		struct dir_ent *dir_ent = read_list[i];
+		/* st_size may be updated by the read */
+		long long size = IS_PSEUDO_PROCESS(dir_ent->inode) ? 0 :
+			dir_ent->inode->buf.st_size;
+
+		if(!sorted && IS_PSEUDO_PROCESS(dir_ent->inode))
+			reader_read_process(dir_ent);
+		else
+			reader_read_file(dir_ent);
+
+		if(prefetchers) {
+			pthread_mutex_lock(&prefetch_mutex);
+			read_next = i + 1;
+			read_bytes_done += size;
+			pthread_cond_broadcast(&prefetch_cond);
+			pthread_mutex_unlock(&prefetch_mutex);
+		}
 	}
 
+	for(i = 0; i < prefetchers; i++)
+		pthread_join(prefetch_thread[i], NULL);
+	free(prefetch_thread);
+	free(read_list);
+	read_list = NULL;
+	read_list_count = read_list_size = 0;
+
 	pthread_exit(NULL);
 }
 
 
+/*
+ * The writer takes up to WRITER_BATCH buffers from the to_writer queue at a
+ * time, so the many deflator threads putting to the queue contend less with
+ * it for the queue lock
+ */
+#define WRITER_BATCH 32
+
 void *writer(void *arg)
 {
+	void *batch[WRITER_BATCH];
+	int count, i;
+
 	while(1) {
-		struct file_buffer *file_buffer = queue_get(to_writer);
-		off_t off;
+		count = queue_get_batch(to_writer, batch, WRITER_BATCH);
 
-		if(file_buffer == NULL) {
-			queue_put(from_writer, NULL);
-			continue;
-		}
+		for(i = 0; i < count; i++) {
+			struct file_buffer *file_buffer = batch[i];
+			off_t off;
 
-		off = file_buffer->block;
+			if(file_buffer == NULL) {
+				queue_put(from_writer, NULL);
+				continue;
+			}
 
-		pthread_cleanup_push((void *) pthread_mutex_unlock, &pos_mutex);
-		pthread_mutex_lock(&pos_mutex);
+			off = file_buffer->block;
 
-		if(lseek(fd, off, SEEK_SET) == -1) {
-			ERROR("writer: Lseek on destination failed because "
-				"%s, offset=0x%llx\n", strerror(errno), off);
-			BAD_ERROR("Probably out of space on output "
-				"%s\n", block_device ? "block device" :
-				"filesystem");
-		}
+			pthread_cleanup_push((void *) pthread_mutex_unlock,
+				&pos_mutex);
+			pthread_mutex_lock(&pos_mutex);
 
-		if(write_bytes(fd, file_buffer->data,
-				file_buffer->size) == -1)
-			BAD_ERROR("Failed to write to output %s\n",
-				block_device ? "block device" : "filesystem");
+			if(lseek(fd, off, SEEK_SET) == -1) {
+				ERROR("writer: Lseek on destination failed "
+					"because %s, offset=0x%llx\n",
+					strerror(errno), off);
+				BAD_ERROR("Probably out of space on output "
+					"%s\n", block_device ? "block device" :
+					"filesystem");
+			}
 
-		pthread_cleanup_pop(1);
+			if(write_bytes(fd, file_buffer->data,
+					file_buffer->size) == -1)
+				BAD_ERROR("Failed to write to output %s\n",
+					block_device ? "block device" :
+					"filesystem");
 
-		cache_block_put(file_buffer);
+			pthread_cleanup_pop(1);
+
+			if(reuse_index && file_buffer->cache == bwriter_buffer)
+				reuse_add(file_buffer);
+
+			cache_block_put(file_buffer);
+		}
 	}
 }
 
@@ -2430,12 +2602,19 @@ void *deflator(void *arg)
 {
 	struct file_buffer *write_buffer = cache_get_nohash(bwriter_buffer);
 	void *stream = NULL;
+	char *tmp = NULL;
 	int res;
 
 	res = compressor_init(comp, &stream, block_size, 1);
 	if(res)
 		BAD_ERROR("deflator:: compressor_init failed\n");
 
+	if(reuse_index) {
+		tmp = malloc(block_size);
+		if(tmp == NULL)
+			MEM_ERROR();
+	}
+
 	while(1) {
 		struct file_buffer *file_buffer = queue_get(to_deflate);
 
@@ -2443,10 +2622,12 @@ void *deflator(void *arg)
 			file_buffer->c_byte = 0;
 			seq_queue_put(to_main, file_buffer);
 		} else {
-			write_buffer->c_byte = mangle2(stream,
-				write_buffer->data, file_buffer->data,
-				file_buffer->size, block_size,
-				file_buffer->noD, 1);
+			if(reuse_index == NULL || reuse_block(file_buffer,
+					write_buffer, tmp) == FALSE)
+				write_buffer->c_byte = mangle2(stream,
+					write_buffer->data, file_buffer->data,
+					file_buffer->size, block_size,
+					file_buffer->noD, 1);
 			write_buffer->sequence = file_buffer->sequence;
 			write_buffer->file_size = file_buffer->file_size;
 			write_buffer->block = file_buffer->block;
@@ -4364,6 +4545,9 @@ void initialise_threads(int readq, int fragq, int bwriteq, int fwriteq,
 	frag_deflator_thread = &deflator_thread[processors];
 	frag_thread = &frag_deflator_thread[processors];
 
+	if(prefetchers == -1)
+		prefetchers = processors;
+
 	to_reader = queue_init(1);
 	to_deflate = queue_init(reader_size);
 	to_process_frag = queue_init(reader_size);
@@ -4958,6 +5142,8 @@ void write_filesystem_tables(struct squashfs_super_block *sBlk, int nopad)
 			dup_files);
 	else
 		printf("No duplicate files removed\n");
+	if(reuse_index)
+		printf("Number of data blocks reused %d\n", reused_blocks);
 	printf("Number of inodes %d\n", inode_count);
 	printf("Number of files %d\n", file_count);
 	if(!no_fragments)
@@ -5509,6 +5695,12 @@ print_compressor_options:
 					argv[0]);
 				exit(1);
 			}
+		} else if(strcmp(argv[i], "-prefetchers") == 0) {
+			if((++i == argc) || !parse_num(argv[i], &prefetchers)) {
+				ERROR("%s: -prefetchers missing or invalid "
+					"thread number\n", argv[0]);
+				exit(1);
+			}
 		} else if(strcmp(argv[i], "-read-queue") == 0) {
 			if((++i == argc) || !parse_num(argv[i], &readq)) {
 				ERROR("%s: -read-queue missing or invalid "
@@ -5606,6 +5798,13 @@ print_compressor_options:
 				ERROR("%s: -sort missing filename\n", argv[0]);
 				exit(1);
 			}
+		} else if(strcmp(argv[i], "-reuse-index") == 0) {
+			if(++i == argc) {
+				ERROR("%s: -reuse-index missing filename\n",
+					argv[0]);
+				exit(1);
+			}
+			reuse_index = argv[i];
 		} else if(strcmp(argv[i], "-all-root") == 0 ||
 				strcmp(argv[i], "-root-owned") == 0)
 			global_uid = global_gid = 0;
@@ -5664,6 +5863,16 @@ print_compressor_options:
 				strcmp(argv[i], "-noDataCompression") == 0)
 			noD = TRUE;
 
+		else if(strcmp(argv[i], "-min-saving") == 0) {
+			if((++i == argc) || !parse_num(argv[i], &min_saving) ||
+					min_saving < 0 || min_saving > 99) {
+				ERROR("%s: -min-saving missing or invalid "
+					"percentage, it should be 0 to 99\n",
+					argv[0]);
+				exit(1);
+			}
+		}
+
 		else if(strcmp(argv[i], "-noF") == 0 ||
 				strcmp(argv[i], "-noFragmentCompression") == 0)
 			noF = TRUE;
@@ -5799,6 +6008,11 @@ printOptions:
 /* ANDROID CHANGES END */
 			ERROR("-noI\t\t\tdo not compress inode table\n");
 			ERROR("-noD\t\t\tdo not compress data blocks\n");
+			ERROR("-min-saving <percent>\tstore data and fragment "
+				"blocks uncompressed unless\n");
+			ERROR("\t\t\tcompression saves at least <percent> of "
+				"their size.\n");
+			ERROR("\t\t\tDefault 0\n");
 			ERROR("-noF\t\t\tdo not compress fragment blocks\n");
 			ERROR("-noX\t\t\tdo not compress extended "
 				"attributes\n");
@@ -5807,6 +6021,11 @@ printOptions:
 				"files larger than block size\n");
 			ERROR("-no-duplicates\t\tdo not perform duplicate "
 				"checking\n");
+			ERROR("-reuse-index <file>\treuse unchanged compressed "
+				"data blocks from the\n");
+			ERROR("\t\t\timage recorded in <file> by the previous "
+				"build, and\n");
+			ERROR("\t\t\trecord this image in <file>\n");
 			ERROR("-all-root\t\tmake all files owned by root\n");
 			ERROR("-force-uid uid\t\tset all file uids to uid\n");
 			ERROR("-force-gid gid\t\tset all file gids to gid\n");
@@ -5874,6 +6093,10 @@ printOptions:
 			ERROR("-processors <number>\tUse <number> processors."
 				"  By default will use number of\n");
 			ERROR("\t\t\tprocessors available\n");
+			ERROR("-prefetchers <number>\tUse <number> threads to "
+				"prefetch files ahead of the\n");
+			ERROR("\t\t\treader.  By default the number of "
+				"processors, 0 disables\n");
 			ERROR("-mem <size>\t\tUse <size> physical memory.  "
 				"Currently set to %dM\n", total_mem);
 			ERROR("\t\t\tOptionally a suffix of K, M or G can be"
@@ -5946,6 +6169,10 @@ printOptions:
 			EXIT_MKSQUASHFS();
 		}
 
+	/* must be done before the destination is truncated */
+	if(reuse_index)
+		reuse_init(reuse_index, argv[source + 1]);
+
 	destination_file = argv[source + 1];
 	if(stat(argv[source + 1], &buf) == -1) {
 		if(errno == ENOENT) { /* Does not exist */
@@ -6269,8 +6496,14 @@ printOptions:
 		EXIT_MKSQUASHFS();
 
 	set_progressbar_state(FALSE);
+	if(!silent)
+		/* report queue and cache sizes and lock contention */
+		dump_state();
 	write_filesystem_tables(&sBlk, nopad);
 
+	if(reuse_index)
+		reuse_write_index(reuse_index, destination_file);
+
 /* ANDROID CHANGES START*/
 #ifdef ANDROID
 	if (block_map_file)
@@ -0,0 +1,355 @@
+/*
+ * Create a squashfs filesystem.  This is a highly compressed read only
+ * filesystem.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * reuse.c
+ */
+
+/*
+ * Reuse of compressed data blocks from a previous image (-reuse-index).
+ *
+ * The index file records, for every data block written to an image, a
+ * hash and the size of the uncompressed block, and where the compressed
+ * block is in the image.  On the next build the deflator threads look
+ * each block they are given up in the index, and if there is an entry
+ * with the same hash and size they read the compressed block from the
+ * previous image, decompress it and compare it with the block.  If it is
+ * the same the compressed block is used as is, and the block doesn't need
+ * compressing again.  Because every block is compared, a stale index or
+ * a changed previous image can only cost time, not correctness.
+ *
+ * Fragments are not indexed, as which file tails share a fragment block
+ * depends on the whole build.
+ *
+ * The index is written in host byte order, it is a cache for the machine
+ * doing the builds, not something to be distributed with the image.
+ */
+
+#include <pthread.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+#include "squashfs_fs.h"
+#include "mksquashfs.h"
+#include "caches-queues-lists.h"
+#include "compressor.h"
+#include "error.h"
+#include "progressbar.h"
+#include "reuse.h"
+
+#define FALSE 0
+#define TRUE 1
+
+#define REUSE_MAGIC "SQFSRIX1"
+#define REUSE_HASH(a) ((a) & 0xffff)
+
+struct reuse_header {
+	char magic[8];
+	int compression;
+	int entries;
+	int name_size;
+};
+
+struct reuse_entry {
+	unsigned int hash;
+	int size;
+	long long start;
+	unsigned int c_byte;
+};
+
+struct reuse_list {
+	struct reuse_entry entry;
+	struct reuse_list *next;
+};
+
+/* previous image, read by the deflator threads */
+static int old_fd = -1;
+static int old_compression;
+static struct reuse_list *old_table[65536];
+
+/* entries for the image being built, added by the writer thread */
+static struct reuse_entry *new_entries = NULL;
+static int new_count = 0, new_size = 0;
+
+int reused_blocks = 0;
+static pthread_mutex_t reuse_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+static unsigned int reuse_hash(char *data, int size)
+{
+	/* FNV-1a, only used to find candidates, which are then compared */
+	unsigned int hash = 2166136261U;
+	int i;
+
+	for(i = 0; i < size; i++)
+		hash = (hash ^ (unsigned char) data[i]) * 16777619U;
+
+	return hash;
+}
+
+
+void reuse_init(char *index_file, char *destination)
+{
+	struct reuse_header header;
+	struct reuse_entry entry;
+	struct stat old_buf, dest_buf;
+	char *name;
+	FILE *fd;
+	int i;
+
+	fd = fopen(index_file, "r");
+	if(fd == NULL) {
+		/* first build, the index will be written at the end */
+		if(errno != ENOENT)
+			ERROR("Could not open reuse index %s, because %s, "
+				"ignoring\n", index_file, strerror(errno));
+		return;
+	}
+
+	if(fread(&header, sizeof(header), 1, fd) != 1 ||
+			memcmp(header.magic, REUSE_MAGIC, 8) != 0 ||
+			header.name_size < 1 || header.name_size > PATH_MAX) {
+		ERROR("Reuse index %s is not valid, ignoring\n", index_file);
+		goto failed;
+	}
+
+	name = malloc(header.name_size + 1);
+	if(name == NULL)
+		MEM_ERROR();
+
+	if(fread(name, header.name_size, 1, fd) != 1) {
+		ERROR("Reuse index %s is truncated, ignoring\n", index_file);
+		free(name);
+		goto failed;
+	}
+	name[header.name_size] = '\0';
+
+	/*
+	 * The previous image can't be the destination, it will be
+	 * overwritten while blocks are still being read from it
+	 */
+	if(stat(name, &old_buf) == -1) {
+		ERROR("Could not stat image %s from reuse index, because %s, "
+			"ignoring\n", name, strerror(errno));
+		free(name);
+		goto failed;
+	}
+
+	if(stat(destination, &dest_buf) == 0 &&
+			old_buf.st_dev == dest_buf.st_dev &&
+			old_buf.st_ino == dest_buf.st_ino) {
+		ERROR("Image %s from reuse index is the destination, "
+			"ignoring.  Build to a new file and rename it to reuse "
+			"blocks\n", name);
+		free(name);
+		goto failed;
+	}
+
+	old_fd = open(name, O_RDONLY);
+	if(old_fd == -1) {
+		ERROR("Could not open image %s from reuse index, because %s, "
+			"ignoring\n", name, strerror(errno));
+		free(name);
+		goto failed;
+	}
+	free(name);
+
+	for(i = 0; i < header.entries; i++) {
+		struct reuse_list *list;
+
+		if(fread(&entry, sizeof(entry), 1, fd) != 1) {
+			ERROR("Reuse index %s is truncated\n", index_file);
+			break;
+		}
+
+		list = malloc(sizeof(struct reuse_list));
+		if(list == NULL)
+			MEM_ERROR();
+
+		list->entry = entry;
+		list->next = old_table[REUSE_HASH(entry.hash)];
+		old_table[REUSE_HASH(entry.hash)] = list;
+	}
+
+	old_compression = header.compression;
+
+failed:
+	fclose(fd);
+}
+
+
+static int read_old(long long start, int bytes, char *buff)
+{
+	int res, count;
+
+	for(count = 0; count < bytes; count += res) {
+		res = pread(old_fd, buff + count, bytes - count, start + count);
+		if(res < 1) {
+			if(res == -1 && errno == EINTR)
+				res = 0;
+			else
+				return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+
+/*
+ * Called by the deflator threads.  Record the hash of file_buffer in
+ * write_buffer, and if the same block is in the previous image, copy the
+ * compressed block to write_buffer and return TRUE.  Tmp is a block_size
+ * buffer to decompress into
+ */
+int reuse_block(struct file_buffer *file_buffer,
+	struct file_buffer *write_buffer, char *tmp)
+{
+	struct reuse_list *list;
+	unsigned int hash = reuse_hash(file_buffer->data, file_buffer->size);
+
+	write_buffer->hash = hash;
+	write_buffer->uncompressed_size = file_buffer->size;
+
+	if(old_fd == -1 || old_compression != comp->id)
+		return FALSE;
+
+	for(list = old_table[REUSE_HASH(hash)]; list; list = list->next) {
+		struct reuse_entry *entry = &list->entry;
+		int compressed = SQUASHFS_COMPRESSED_BLOCK(entry->c_byte);
+		int c_size = SQUASHFS_COMPRESSED_SIZE_BLOCK(entry->c_byte);
+		int res, error;
+
+		if(entry->hash != hash || entry->size != file_buffer->size ||
+				c_size > block_size || c_size == 0)
+			continue;
+
+		/* don't substitute a compressed block for an uncompressed one */
+		if(compressed && file_buffer->noD)
+			continue;
+
+		if(read_old(entry->start, c_size, write_buffer->data) == FALSE)
+			continue;
+
+		if(compressed) {
+			res = compressor_uncompress(comp, tmp,
+				write_buffer->data, c_size, block_size,
+				&error);
+			if(res != file_buffer->size || memcmp(tmp,
+					file_buffer->data, res) != 0)
+				continue;
+		} else if(c_size != file_buffer->size ||
+				memcmp(write_buffer->data, file_buffer->data,
+				c_size) != 0)
+			continue;
+
+		write_buffer->c_byte = entry->c_byte;
+
+		pthread_mutex_lock(&reuse_mutex);
+		reused_blocks ++;
+		pthread_mutex_unlock(&reuse_mutex);
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+
+/*
+ * Called by the writer thread for each data block written to the image
+ */
+void reuse_add(struct file_buffer *write_buffer)
+{
+	struct reuse_entry *entry;
+
+	if(new_count == new_size) {
+		new_size = new_size ? new_size * 2 : 1024;
+		new_entries = realloc(new_entries, new_size *
+			sizeof(struct reuse_entry));
+		if(new_entries == NULL)
+			MEM_ERROR();
+	}
+
+	entry = &new_entries[new_count ++];
+	entry->hash = write_buffer->hash;
+	entry->size = write_buffer->uncompressed_size;
+	entry->start = write_buffer->block;
+	entry->c_byte = write_buffer->c_byte;
+}
+
+
+/*
+ * Write the index for the image just built.  This is written to a
+ * temporary file and renamed, so an interrupted build leaves the old index
+ */
+void reuse_write_index(char *index_file, char *destination)
+{
+	struct reuse_header header;
+	char *name, *tmp_file;
+	FILE *fd;
+
+	name = realpath(destination, NULL);
+	if(name == NULL) {
+		ERROR("Could not get path of %s, because %s, not writing reuse "
+			"index\n", destination, strerror(errno));
+		return;
+	}
+
+	if(asprintf(&tmp_file, "%s.tmp", index_file) == -1)
+		MEM_ERROR();
+
+	fd = fopen(tmp_file, "w");
+	if(fd == NULL) {
+		ERROR("Could not create reuse index %s, because %s\n",
+			tmp_file, strerror(errno));
+		goto failed;
+	}
+
+	memcpy(header.magic, REUSE_MAGIC, 8);
+	header.compression = comp->id;
+	header.entries = new_count;
+	header.name_size = strlen(name);
+
+	if(fwrite(&header, sizeof(header), 1, fd) != 1 ||
+			fwrite(name, header.name_size, 1, fd) != 1 ||
+			(new_count && fwrite(new_entries,
+			sizeof(struct reuse_entry), new_count, fd) !=
+			new_count)) {
+		ERROR("Failed to write reuse index %s\n", tmp_file);
+		fclose(fd);
+		unlink(tmp_file);
+		goto failed;
+	}
+
+	if(fclose(fd) != 0 || rename(tmp_file, index_file) == -1) {
+		ERROR("Failed to write reuse index %s, because %s\n",
+			index_file, strerror(errno));
+		unlink(tmp_file);
+	}
+
+failed:
+	free(tmp_file);
+	free(name);
+}
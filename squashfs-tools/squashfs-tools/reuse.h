@@ -0,0 +1,29 @@
+#ifndef REUSE_H
+#define REUSE_H
+/*
+ * Create a squashfs filesystem.  This is a highly compressed read only
+ * filesystem.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * reuse.h
+ */
+
+extern void reuse_init(char *, char *);
+extern int reuse_block(struct file_buffer *, struct file_buffer *, char *);
+extern void reuse_add(struct file_buffer *);
+extern void reuse_write_index(char *, char *);
+extern int reused_blocks;
+#endif
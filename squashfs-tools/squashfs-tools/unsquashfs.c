@@ -45,11 +45,14 @@
 
 struct cache *fragment_cache, *data_cache;
 struct queue *to_reader, *to_inflate, *to_writer, *from_writer;
-pthread_t *thread, *inflator_thread;
+struct queue **to_file_writer, *from_file_writer;
+pthread_t *thread, *inflator_thread, *writer_thread;
 pthread_mutex_t	fragment_mutex;
 
 /* user options that control parallelisation */
 int processors = -1;
+int writers = -1;
+int preallocate = FALSE, direct_io = FALSE;
 
 struct super_block sBlk;
 squashfs_operations s_ops;
@@ -876,6 +879,7 @@ int write_bytes(int fd, char *buff, int bytes)
 
 int lseek_broken = FALSE;
 char *zero_data = NULL;
+pthread_mutex_t writer_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 int write_block(int file_fd, char *buffer, int size, long long hole, int sparse)
 {
@@ -889,13 +893,6 @@ int write_block(int file_fd, char *buffer, int size, long long hole, int sparse)
 				lseek_broken = TRUE;
 		}
 
-		if((sparse == FALSE || lseek_broken) && zero_data == NULL) {
-			if((zero_data = malloc(block_size)) == NULL)
-				EXIT_UNSQUASH("write_block: failed to alloc "
-					"zero data block\n");
-			memset(zero_data, 0, block_size);
-		}
-
 		if(sparse == FALSE || lseek_broken) {
 			int blocks = (hole + block_size -1) / block_size;
 			int avail_bytes, i;
@@ -919,6 +916,36 @@ failure:
 }
 
 
+/*
+ * Files at least LARGE_FILE_SIZE bytes long and not sparse are preallocated
+ * with -fallocate, and written with O_DIRECT with -direct-io.  O_DIRECT
+ * needs buffers, file offsets and sizes aligned to DIRECT_IO_ALIGN, which
+ * the data blocks are, apart from the tail of the file
+ */
+#define LARGE_FILE_SIZE (1024 * 1024)
+#define DIRECT_IO_ALIGN 4096
+
+#ifndef O_DIRECT
+#define O_DIRECT 0
+#endif
+
+
+int large_file(struct inode *inode)
+{
+	return !inode->sparse && inode->data >= LARGE_FILE_SIZE;
+}
+
+
+void clear_direct(struct squashfs_file *file)
+{
+	int flags = fcntl(file->fd, F_GETFL);
+
+	if(flags != -1)
+		fcntl(file->fd, F_SETFL, flags & ~O_DIRECT);
+	file->direct = FALSE;
+}
+
+
 pthread_mutex_t open_mutex = PTHREAD_MUTEX_INITIALIZER;
 pthread_cond_t open_empty = PTHREAD_COND_INITIALIZER;
 int open_unlimited, open_count;
@@ -959,7 +986,7 @@ void close_wake(int fd)
 }
 
 
-void queue_file(char *pathname, int file_fd, struct inode *inode)
+void queue_file(char *pathname, int file_fd, struct inode *inode, int direct)
 {
 	struct squashfs_file *file = malloc(sizeof(struct squashfs_file));
 	if(file == NULL)
@@ -974,6 +1001,7 @@ void queue_file(char *pathname, int file_fd, struct inode *inode)
 	file->pathname = strdup(pathname);
 	file->blocks = inode->blocks + (inode->frag_bytes > 0);
 	file->sparse = inode->sparse;
+	file->direct = direct;
 	file->xattr = inode->xattr;
 	queue_put(to_writer, file);
 }
@@ -1002,11 +1030,19 @@ int write_file(struct inode *inode, char *pathname)
 	unsigned int *block_list;
 	int file_end = inode->data / block_size;
 	long long start = inode->start;
+	int direct = direct_io && large_file(inode);
 
 	TRACE("write_file: regular file, blocks %d\n", inode->blocks);
 
 	file_fd = open_wait(pathname, O_CREAT | O_WRONLY |
-		(force ? O_TRUNC : 0), (mode_t) inode->mode & 0777);
+		(force ? O_TRUNC : 0) | (direct ? O_DIRECT : 0),
+		(mode_t) inode->mode & 0777);
+	if(file_fd == -1 && direct && errno == EINVAL) {
+		/* the destination filesystem doesn't support O_DIRECT */
+		direct = FALSE;
+		file_fd = open(pathname, O_CREAT | O_WRONLY |
+			(force ? O_TRUNC : 0), (mode_t) inode->mode & 0777);
+	}
 	if(file_fd == -1) {
 		ERROR("write_file: failed to create file %s, because %s\n",
 			pathname, strerror(errno));
@@ -1024,7 +1060,7 @@ int write_file(struct inode *inode, char *pathname)
  	 * file.  If the file has one or more blocks or a fragment they are
  	 * queued separately (references to blocks in the cache).
  	 */
-	queue_file(pathname, file_fd, inode);
+	queue_file(pathname, file_fd, inode, direct);
 
 	for(i = 0; i < inode->blocks; i++) {
 		int c_byte = SQUASHFS_COMPRESSED_SIZE_BLOCK(block_list[i]);
@@ -1994,104 +2030,237 @@ void *reader(void *arg)
 
 
 /*
- * writer thread.  This processes file write requests queued by the
- * write_file() routine.
+ * write the data blocks of file, which follow it on queue, and then set
+ * its attributes.  Buffer is an aligned block used to write files opened
+ * with O_DIRECT
  */
-void *writer(void *arg)
+void write_file_blocks(struct squashfs_file *file, struct queue *queue,
+	char *buffer)
 {
-	int i;
+	int file_fd = file->fd;
+	long long hole = 0;
+	int failed = FALSE;
+	int error, i;
 
-	while(1) {
-		struct squashfs_file *file = queue_get(to_writer);
-		int file_fd;
-		long long hole = 0;
-		int failed = FALSE;
-		int error;
+	TRACE("writer: regular file, blocks %d\n", file->blocks);
 
-		if(file == NULL) {
-			queue_put(from_writer, NULL);
-			continue;
-		} else if(file->fd == -1) {
-			/* write attributes for directory file->pathname */
-			set_attributes(file->pathname, file->mode, file->uid,
-				file->gid, file->time, file->xattr, TRUE);
-			free(file->pathname);
-			free(file);
+#ifdef linux
+	if(preallocate && !file->sparse && file->file_size >= LARGE_FILE_SIZE)
+		/* only a hint, ignore failure */
+		posix_fallocate(file_fd, 0, file->file_size);
+#endif
+
+	for(i = 0; i < file->blocks; i++) {
+		struct file_entry *block = queue_get(queue);
+		char *data;
+
+		pthread_mutex_lock(&writer_mutex);
+		cur_blocks ++;
+		pthread_mutex_unlock(&writer_mutex);
+
+		if(block->buffer == 0) { /* sparse file */
+			hole += block->size;
+			free(block);
 			continue;
 		}
 
-		TRACE("writer: regular file, blocks %d\n", file->blocks);
+		cache_block_wait(block->buffer);
 
-		file_fd = file->fd;
+		if(block->buffer->error)
+			failed = TRUE;
 
-		for(i = 0; i < file->blocks; i++, cur_blocks ++) {
-			struct file_entry *block = queue_get(to_writer);
+		if(failed)
+			continue;
 
-			if(block->buffer == 0) { /* sparse file */
-				hole += block->size;
-				free(block);
-				continue;
+		data = block->buffer->data + block->offset;
+		if(file->direct) {
+			if(block->size % DIRECT_IO_ALIGN ||
+					hole % DIRECT_IO_ALIGN)
+				clear_direct(file);
+			else {
+				memcpy(buffer, data, block->size);
+				data = buffer;
 			}
+		}
 
-			cache_block_wait(block->buffer);
+		error = write_block(file_fd, data, block->size, hole,
+			file->sparse);
 
-			if(block->buffer->error)
-				failed = TRUE;
+		if(error == FALSE) {
+			ERROR("writer: failed to write data block %d\n",
+				i);
+			failed = TRUE;
+		}
 
-			if(failed)
-				continue;
+		hole = 0;
+		cache_block_put(block->buffer);
+		free(block);
+	}
 
-			error = write_block(file_fd, block->buffer->data +
-				block->offset, block->size, hole, file->sparse);
+	if(hole && failed == FALSE) {
+		if(file->direct)
+			clear_direct(file);
 
-			if(error == FALSE) {
-				ERROR("writer: failed to write data block %d\n",
-					i);
+		/*
+		 * corner case for hole extending to end of file
+		 */
+		if(file->sparse == FALSE ||
+				lseek(file_fd, hole, SEEK_CUR) == -1) {
+			/*
+			 * for files which we don't want to write
+			 * sparsely, or for broken lseeks which cannot
+			 * seek beyond end of file, write_block will do
+			 * the right thing
+			 */
+			hole --;
+			if(write_block(file_fd, "\0", 1, hole,
+					file->sparse) == FALSE) {
+				ERROR("writer: failed to write sparse "
+					"data block\n");
 				failed = TRUE;
 			}
-
-			hole = 0;
-			cache_block_put(block->buffer);
-			free(block);
+		} else if(ftruncate(file_fd, file->file_size) == -1) {
+			ERROR("writer: failed to write sparse data "
+				"block\n");
+			failed = TRUE;
 		}
+	}
 
-		if(hole && failed == FALSE) {
-			/*
-			 * corner case for hole extending to end of file
-			 */
-			if(file->sparse == FALSE ||
-					lseek(file_fd, hole, SEEK_CUR) == -1) {
-				/*
-				 * for files which we don't want to write
-				 * sparsely, or for broken lseeks which cannot
-				 * seek beyond end of file, write_block will do
-				 * the right thing
-				 */
-				hole --;
-				if(write_block(file_fd, "\0", 1, hole,
-						file->sparse) == FALSE) {
-					ERROR("writer: failed to write sparse "
-						"data block\n");
-					failed = TRUE;
-				}
-			} else if(ftruncate(file_fd, file->file_size) == -1) {
-				ERROR("writer: failed to write sparse data "
-					"block\n");
-				failed = TRUE;
+	close_wake(file_fd);
+	if(failed == FALSE)
+		set_attributes(file->pathname, file->mode, file->uid,
+			file->gid, file->time, file->xattr, force);
+	else {
+		ERROR("Failed to write %s, skipping\n", file->pathname);
+		unlink(file->pathname);
+	}
+	free(file->pathname);
+	free(file);
+}
+
+
+char *alloc_direct_buffer()
+{
+	void *buffer = NULL;
+
+	if(direct_io && posix_memalign(&buffer, DIRECT_IO_ALIGN,
+							block_size))
+		EXIT_UNSQUASH("Out of memory allocating direct I/O buffer\n");
+
+	return buffer;
+}
+
+
+/*
+ * file writer threads.  With more than one writer, each regular file is
+ * handed in its entirety, file structure followed by its blocks, to one
+ * file writer thread, so files are written in parallel, and the blocks of
+ * any one file in order
+ */
+void *file_writer(void *arg)
+{
+	struct queue *queue = arg;
+	char *buffer = alloc_direct_buffer();
+
+	while(1) {
+		struct squashfs_file *file = queue_get(queue);
+
+		if(file == NULL)
+			queue_put(from_file_writer, NULL);
+		else
+			write_file_blocks(file, queue, buffer);
+	}
+}
+
+
+/*
+ * writer thread.  This processes file write requests queued by the
+ * write_file() routine, either writing the files itself or passing them
+ * to the file writer threads.  Setting the attributes of directories is
+ * deferred to the end, once every file has been written, as
+ * the files may still be being written by the file writer threads.  This
+ * also preserves the original order, where the attributes of a directory
+ * are set after those of its contents
+ */
+void *writer(void *arg)
+{
+	struct squashfs_file **dirs = NULL;
+	int dir_entries = 0, dir_size = 0;
+	int *pending = NULL;
+	char *buffer = NULL;
+	int i;
+
+	if(writers > 1) {
+		pending = calloc(writers, sizeof(int));
+		if(pending == NULL)
+			EXIT_UNSQUASH("Out of memory in writer\n");
+	} else
+		buffer = alloc_direct_buffer();
+
+	while(1) {
+		struct squashfs_file *file = queue_get(to_writer);
+		struct queue *queue;
+		int writer_no = 0, blocks;
+
+		if(file == NULL) {
+			/* wait for the file writers to finish */
+			for(i = 0; i < writers && writers > 1; i++)
+				queue_put(to_file_writer[i], NULL);
+			for(i = 0; i < writers && writers > 1; i++) {
+				queue_get(from_file_writer);
+				pending[i] = 0;
+			}
+
+			for(i = 0; i < dir_entries; i++) {
+				file = dirs[i];
+				/* write attributes for directory file->pathname */
+				set_attributes(file->pathname, file->mode,
+					file->uid, file->gid, file->time,
+					file->xattr, TRUE);
+				free(file->pathname);
+				free(file);
+			}
+			dir_entries = 0;
+
+			queue_put(from_writer, NULL);
+			continue;
+		} else if(file->fd == -1) {
+			if(dir_entries == dir_size) {
+				dir_size = dir_size ? dir_size * 2 : 1024;
+				dirs = realloc(dirs, dir_size *
+					sizeof(struct squashfs_file *));
+				if(dirs == NULL)
+					EXIT_UNSQUASH("Out of memory in "
+						"writer\n");
 			}
+			dirs[dir_entries ++] = file;
+			continue;
 		}
 
-		close_wake(file_fd);
-		if(failed == FALSE)
-			set_attributes(file->pathname, file->mode, file->uid,
-				file->gid, file->time, file->xattr, force);
-		else {
-			ERROR("Failed to write %s, skipping\n", file->pathname);
-			unlink(file->pathname);
+		if(writers == 1) {
+			write_file_blocks(file, to_writer, buffer);
+			continue;
 		}
-		free(file->pathname);
-		free(file);
 
+		/*
+		 * give the file to the file writer with the fewest blocks
+		 * queued.  This is approximate, the count is not decremented
+		 * as the blocks are written, but it stops a large file
+		 * holding up the files behind it
+		 */
+		for(i = 1; i < writers; i++)
+			if(pending[i] < pending[writer_no])
+				writer_no = i;
+		for(i = 0; i < writers; i++)
+			pending[i] -= pending[writer_no];
+		pending[writer_no] += file->blocks + 1;
+
+		/* file is freed by the file writer once written */
+		blocks = file->blocks;
+		queue = to_file_writer[writer_no];
+		queue_put(queue, file);
+		for(i = 0; i < blocks; i++)
+			queue_put(queue, queue_get(to_writer));
 	}
 }
 
@@ -2323,10 +2492,34 @@ void initialise_threads(int fragment_buffer_size, int data_buffer_size)
 
 	from_writer = queue_init(1);
 
+	if(writers == -1)
+		writers = processors;
+
+	if(writers > 1) {
+		to_file_writer = malloc(writers * sizeof(struct queue *));
+		writer_thread = malloc(writers * sizeof(pthread_t));
+		if(to_file_writer == NULL || writer_thread == NULL)
+			EXIT_UNSQUASH("Out of memory allocating writer "
+				"threads\n");
+
+		for(i = 0; i < writers; i++)
+			to_file_writer[i] = queue_init(to_writer->size - 1);
+		from_file_writer = queue_init(writers);
+	}
+
+	if((zero_data = alloc_direct_buffer()) == NULL &&
+			(zero_data = malloc(block_size)) == NULL)
+		EXIT_UNSQUASH("Out of memory allocating zero data block\n");
+	memset(zero_data, 0, block_size);
+
 	fragment_cache = cache_init(block_size, fragment_buffer_size);
 	data_cache = cache_init(block_size, data_buffer_size);
 	pthread_create(&thread[0], NULL, reader, NULL);
 	pthread_create(&thread[1], NULL, writer, NULL);
+	for(i = 0; i < writers && writers > 1; i++)
+		if(pthread_create(&writer_thread[i], NULL, file_writer,
+				to_file_writer[i]) != 0)
+			EXIT_UNSQUASH("Failed to create thread\n");
 	pthread_create(&thread[2], NULL, progress_thread, NULL);
 	init_info();
 	pthread_mutex_init(&fragment_mutex, NULL);
@@ -2337,8 +2530,9 @@ void initialise_threads(int fragment_buffer_size, int data_buffer_size)
 			EXIT_UNSQUASH("Failed to create thread\n");
 	}
 
-	printf("Parallel unsquashfs: Using %d processor%s\n", processors,
-			processors == 1 ? "" : "s");
+	printf("Parallel unsquashfs: Using %d processor%s and %d writer%s\n",
+			processors, processors == 1 ? "" : "s", writers,
+			writers == 1 ? "" : "s");
 
 	if(pthread_sigmask(SIG_SETMASK, &old_mask, NULL) == -1)
 		EXIT_UNSQUASH("Failed to set signal mask in initialise_threads"
@@ -2564,7 +2758,27 @@ int main(int argc, char *argv[])
 					argv[0]);
 				exit(1);
 			}
-		} else if(strcmp(argv[i], "-data-queue") == 0 ||
+		} else if(strcmp(argv[i], "-writers") == 0 ||
+				strcmp(argv[i], "-w") == 0) {
+			if((++i == argc) ||
+					!parse_number(argv[i],
+						&writers)) {
+				ERROR("%s: -writers missing or invalid "
+					"writer number\n", argv[0]);
+				exit(1);
+			}
+			if(writers < 1) {
+				ERROR("%s: -writers should be 1 or larger\n",
+					argv[0]);
+				exit(1);
+			}
+		} else if(strcmp(argv[i], "-fallocate") == 0 ||
+				strcmp(argv[i], "-fa") == 0)
+			preallocate = TRUE;
+		else if(strcmp(argv[i], "-direct-io") == 0 ||
+				strcmp(argv[i], "-di") == 0)
+			direct_io = TRUE;
+		else if(strcmp(argv[i], "-data-queue") == 0 ||
 					 strcmp(argv[i], "-da") == 0) {
 			if((++i == argc) ||
 					!parse_number(argv[i],
@@ -2654,6 +2868,14 @@ options:
 			ERROR("\t-p[rocessors] <number>\tuse <number> "
 				"processors.  By default will use\n");
 			ERROR("\t\t\t\tnumber of processors available\n");
+			ERROR("\t-w[riters] <number>\tuse <number> threads "
+				"to write files.  By\n");
+			ERROR("\t\t\t\tdefault the number of processors\n");
+			ERROR("\t-fa[llocate]\t\tpreallocate large files "
+				"before writing\n");
+			ERROR("\t-di[rect-io]\t\twrite large files with "
+				"O_DIRECT, bypassing\n\t\t\t\tthe page "
+				"cache\n");
 			ERROR("\t-i[nfo]\t\t\tprint files as they are "
 				"unsquashed\n");
 			ERROR("\t-li[nfo]\t\tprint files as they are "
@@ -206,6 +206,7 @@ struct squashfs_file {
 	time_t time;
 	char *pathname;
 	char sparse;
+	char direct;
 	unsigned int xattr;
 };
 
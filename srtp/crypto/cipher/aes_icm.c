@@ -452,6 +452,21 @@ aes_icm_output(aes_icm_ctx_t *c, uint8_t *buffer, int num_octets_to_output) {
   return aes_icm_encrypt(c, buffer, &len);
 }
 
+int
+aes_icm_is_type(const cipher_type_t *ct) {
+  extern cipher_type_t aes_icm;
+
+#ifdef AES_ICM_AESNI
+  if (ct == &aes_icm_aesni)
+    return 1;
+#endif
+#ifdef AES_ICM_ARMV8
+  if (ct == &aes_icm_armv8)
+    return 1;
+#endif
+  return ct == &aes_icm;
+}
+
 
 char 
 aes_icm_description[] = "aes integer counter mode";
@@ -493,6 +508,50 @@ cipher_test_case_t aes_icm_test_case_0 = {
   NULL                                   /* pointer to next testcase */
 };
 
+/*
+ * the keystream of aes_icm_test_case_0 extended to five blocks (the
+ * first four are the RFC 3711 B.2 vectors), truncated so that both
+ * the four-block loops of the hardware implementations and the
+ * partial tail block are exercised
+ */
+
+uint8_t aes_icm_test_case_1_plaintext[75] =  {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00
+};
+
+uint8_t aes_icm_test_case_1_ciphertext[75] = {
+  0xe0, 0x3e, 0xad, 0x09, 0x35, 0xc9, 0x5e, 0x80,
+  0xe1, 0x66, 0xb1, 0x6d, 0xd9, 0x2b, 0x4e, 0xb4,
+  0xd2, 0x35, 0x13, 0x16, 0x2b, 0x02, 0xd0, 0xf7,
+  0x2a, 0x43, 0xa2, 0xfe, 0x4a, 0x5f, 0x97, 0xab,
+  0x41, 0xe9, 0x5b, 0x3b, 0xb0, 0xa2, 0xe8, 0xdd,
+  0x47, 0x79, 0x01, 0xe4, 0xfc, 0xa8, 0x94, 0xc0,
+  0x31, 0xd4, 0xc2, 0x55, 0xba, 0x42, 0x11, 0xee,
+  0xbc, 0x3f, 0xe4, 0x22, 0x54, 0x78, 0xcb, 0xfd,
+  0xee, 0xb1, 0x38, 0x11, 0x5f, 0x30, 0x45, 0x27,
+  0xd4, 0xbf, 0xd9
+};
+
+cipher_test_case_t aes_icm_test_case_1 = {
+  30,                                    /* octets in key            */
+  aes_icm_test_case_0_key,               /* key                      */
+  aes_icm_test_case_0_nonce,             /* packet index             */
+  75,                                    /* octets in plaintext      */
+  aes_icm_test_case_1_plaintext,         /* plaintext                */
+  75,                                    /* octets in ciphertext     */
+  aes_icm_test_case_1_ciphertext,        /* ciphertext               */
+  &aes_icm_test_case_0                   /* pointer to next testcase */
+};
+
 
 /*
  * note: the encrypt function is identical to the decrypt function
@@ -507,6 +566,6 @@ cipher_type_t aes_icm = {
   (cipher_set_iv_func_t)         aes_icm_set_iv,
   (char *)                       aes_icm_description,
   (int)                          0,   /* instance count */
-  (cipher_test_case_t *)        &aes_icm_test_case_0,
+  (cipher_test_case_t *)        &aes_icm_test_case_1,
   (debug_module_t *)            &mod_aes_icm
 };
@@ -0,0 +1,282 @@
+/*
+ * aes_icm_aesni.c
+ *
+ * AES Integer Counter Mode using the x86 AES-NI instructions
+ *
+ */
+
+/*
+ *
+ * Copyright (c) 2001-2006, Cisco Systems, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following
+ *   disclaimer in the documentation and/or other materials provided
+ *   with the distribution.
+ *
+ *   Neither the name of the Cisco Systems, Inc. nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "aes_icm.h"
+#include "alloc.h"
+
+#ifdef AES_ICM_AESNI
+
+#include <cpuid.h>
+#include <emmintrin.h>
+#include <wmmintrin.h>
+
+/*
+ * the functions below are compiled for AES-NI regardless of the flags
+ * used for the rest of the library; aes_icm_aesni is only loaded into
+ * the crypto kernel when aes_icm_aesni_supported() says the cpu has it
+ */
+#define AES_ICM_AESNI_TARGET __attribute__((target("aes,sse2")))
+
+/*
+ * number of counter blocks encrypted per iteration of the main loop;
+ * four independent blocks keep the aesenc pipeline busy
+ */
+#define AES_ICM_AESNI_BLOCKS 4
+
+extern debug_module_t mod_aes_icm;
+extern cipher_test_case_t aes_icm_test_case_1;
+
+cipher_type_t aes_icm_aesni;
+
+int
+aes_icm_aesni_supported(void) {
+  unsigned int eax, ebx, ecx, edx;
+
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return 0;
+  return (ecx & bit_AES) && (edx & bit_SSE2);
+}
+
+err_status_t
+aes_icm_aesni_alloc(cipher_t **c, int key_len, int forIsmacryp) {
+  uint8_t *pointer;
+  int tmp;
+
+  debug_print(mod_aes_icm,
+            "allocating aes-ni cipher with key length %d", key_len);
+
+  if (key_len != 30)
+    return err_status_bad_param;
+
+  /* allocate memory a cipher of type aes_icm_aesni */
+  tmp = (sizeof(aes_icm_ctx_t) + sizeof(cipher_t));
+  pointer = (uint8_t*)crypto_alloc(tmp);
+  if (pointer == NULL)
+    return err_status_alloc_fail;
+
+  /* set pointers */
+  *c = (cipher_t *)pointer;
+  (*c)->type = &aes_icm_aesni;
+  (*c)->state = pointer + sizeof(cipher_t);
+
+  /* increment ref_count */
+  aes_icm_aesni.ref_count++;
+
+  /* set key size        */
+  (*c)->key_len = key_len;
+
+  return err_status_ok;
+}
+
+err_status_t
+aes_icm_aesni_dealloc(cipher_t *c) {
+
+  /* zeroize entire state*/
+  octet_string_set_to_zero((uint8_t *)c,
+			   sizeof(aes_icm_ctx_t) + sizeof(cipher_t));
+
+  /* free memory */
+  crypto_free(c);
+
+  /* decrement ref_count */
+  aes_icm_aesni.ref_count--;
+
+  return err_status_ok;
+}
+
+/*
+ * aes_icm_aesni_block(...) encrypts one counter block with the
+ * expanded key in rk[]
+ */
+
+AES_ICM_AESNI_TARGET
+static inline __m128i
+aes_icm_aesni_block(__m128i block, const __m128i *rk) {
+  int i;
+
+  block = _mm_xor_si128(block, rk[0]);
+  for (i = 1; i < 10; i++)
+    block = _mm_aesenc_si128(block, rk[i]);
+  return _mm_aesenclast_si128(block, rk[10]);
+}
+
+/*
+ * aes_icm_aesni_counter(...) returns the counter block for block
+ * index ctr; only the last (big-endian) 16 bits of the counter change
+ * from block to block, so they are inserted into the constant part
+ */
+
+AES_ICM_AESNI_TARGET
+static inline __m128i
+aes_icm_aesni_counter(__m128i base, uint16_t ctr) {
+  return _mm_insert_epi16(base, (uint16_t)((ctr << 8) | (ctr >> 8)), 7);
+}
+
+/*
+ * aes_icm_aesni_encrypt(...) has the same semantics as
+ * aes_icm_encrypt(), including the keystream_buffer handling, so the
+ * two can be used interchangeably on the same aes_icm_ctx_t
+ */
+
+AES_ICM_AESNI_TARGET
+err_status_t
+aes_icm_aesni_encrypt(aes_icm_ctx_t *c,
+		      unsigned char *buf, unsigned int *enc_len) {
+  unsigned int bytes_to_encr = *enc_len;
+  unsigned int i;
+  __m128i rk[11];
+  __m128i base;
+  uint16_t ctr;
+
+  /* check that there's enough segment left */
+  if ((bytes_to_encr + htons(c->counter.v16[7])) > 0xffff)
+    return err_status_terminus;
+
+  debug_print(mod_aes_icm, "block index: %d",
+           htons(c->counter.v16[7]));
+
+  /* use up any keystream left over from the previous call */
+  if (bytes_to_encr <= (unsigned int)c->bytes_in_buffer) {
+    for (i = (sizeof(v128_t) - c->bytes_in_buffer);
+	 i < (sizeof(v128_t) - c->bytes_in_buffer + bytes_to_encr); i++)
+      *buf++ ^= c->keystream_buffer.v8[i];
+    c->bytes_in_buffer -= bytes_to_encr;
+    return err_status_ok;
+  }
+  for (i = (sizeof(v128_t) - c->bytes_in_buffer); i < sizeof(v128_t); i++)
+    *buf++ ^= c->keystream_buffer.v8[i];
+  bytes_to_encr -= c->bytes_in_buffer;
+  c->bytes_in_buffer = 0;
+
+  /* the expanded key is only guaranteed 8-byte alignment */
+  for (i = 0; i < 11; i++)
+    rk[i] = _mm_loadu_si128((const __m128i *)&c->expanded_key[i]);
+  base = _mm_loadu_si128((const __m128i *)&c->counter);
+  ctr = (uint16_t)((c->counter.v8[14] << 8) | c->counter.v8[15]);
+
+  /* encrypt AES_ICM_AESNI_BLOCKS counter blocks at a time */
+  while (bytes_to_encr >= AES_ICM_AESNI_BLOCKS * sizeof(v128_t)) {
+    __m128i b0 = aes_icm_aesni_counter(base, ctr);
+    __m128i b1 = aes_icm_aesni_counter(base, (uint16_t)(ctr + 1));
+    __m128i b2 = aes_icm_aesni_counter(base, (uint16_t)(ctr + 2));
+    __m128i b3 = aes_icm_aesni_counter(base, (uint16_t)(ctr + 3));
+
+    b0 = _mm_xor_si128(b0, rk[0]);
+    b1 = _mm_xor_si128(b1, rk[0]);
+    b2 = _mm_xor_si128(b2, rk[0]);
+    b3 = _mm_xor_si128(b3, rk[0]);
+    for (i = 1; i < 10; i++) {
+      b0 = _mm_aesenc_si128(b0, rk[i]);
+      b1 = _mm_aesenc_si128(b1, rk[i]);
+      b2 = _mm_aesenc_si128(b2, rk[i]);
+      b3 = _mm_aesenc_si128(b3, rk[i]);
+    }
+    b0 = _mm_aesenclast_si128(b0, rk[10]);
+    b1 = _mm_aesenclast_si128(b1, rk[10]);
+    b2 = _mm_aesenclast_si128(b2, rk[10]);
+    b3 = _mm_aesenclast_si128(b3, rk[10]);
+
+    _mm_storeu_si128((__m128i *)buf,
+		     _mm_xor_si128(b0, _mm_loadu_si128((__m128i *)buf)));
+    _mm_storeu_si128((__m128i *)(buf + 16),
+		     _mm_xor_si128(b1, _mm_loadu_si128((__m128i *)(buf + 16))));
+    _mm_storeu_si128((__m128i *)(buf + 32),
+		     _mm_xor_si128(b2, _mm_loadu_si128((__m128i *)(buf + 32))));
+    _mm_storeu_si128((__m128i *)(buf + 48),
+		     _mm_xor_si128(b3, _mm_loadu_si128((__m128i *)(buf + 48))));
+
+    ctr += AES_ICM_AESNI_BLOCKS;
+    buf += AES_ICM_AESNI_BLOCKS * sizeof(v128_t);
+    bytes_to_encr -= AES_ICM_AESNI_BLOCKS * sizeof(v128_t);
+  }
+
+  /* then whatever whole blocks remain */
+  while (bytes_to_encr >= sizeof(v128_t)) {
+    __m128i ks = aes_icm_aesni_block(aes_icm_aesni_counter(base, ctr), rk);
+
+    _mm_storeu_si128((__m128i *)buf,
+		     _mm_xor_si128(ks, _mm_loadu_si128((__m128i *)buf)));
+    ctr++;
+    buf += sizeof(v128_t);
+    bytes_to_encr -= sizeof(v128_t);
+  }
+
+  /* if there is a tail end of the data, keep its keystream block */
+  if (bytes_to_encr != 0) {
+    _mm_storeu_si128((__m128i *)&c->keystream_buffer,
+		     aes_icm_aesni_block(aes_icm_aesni_counter(base, ctr), rk));
+    ctr++;
+    for (i = 0; i < bytes_to_encr; i++)
+      *buf++ ^= c->keystream_buffer.v8[i];
+    c->bytes_in_buffer = sizeof(v128_t) - bytes_to_encr;
+  }
+
+  /* write the clocked counter back */
+  c->counter.v8[14] = (uint8_t)(ctr >> 8);
+  c->counter.v8[15] = (uint8_t)ctr;
+
+  return err_status_ok;
+}
+
+
+char
+aes_icm_aesni_description[] = "aes integer counter mode (aes-ni)";
+
+/*
+ * note: the encrypt function is identical to the decrypt function
+ */
+
+cipher_type_t aes_icm_aesni = {
+  (cipher_alloc_func_t)          aes_icm_aesni_alloc,
+  (cipher_dealloc_func_t)        aes_icm_aesni_dealloc,
+  (cipher_init_func_t)           aes_icm_context_init,
+  (cipher_encrypt_func_t)        aes_icm_aesni_encrypt,
+  (cipher_decrypt_func_t)        aes_icm_aesni_encrypt,
+  (cipher_set_iv_func_t)         aes_icm_set_iv,
+  (char *)                       aes_icm_aesni_description,
+  (int)                          0,   /* instance count */
+  (cipher_test_case_t *)        &aes_icm_test_case_1,
+  (debug_module_t *)            &mod_aes_icm
+};
+
+#endif /* AES_ICM_AESNI */
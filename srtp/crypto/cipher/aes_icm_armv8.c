@@ -0,0 +1,280 @@
+/*
+ * aes_icm_armv8.c
+ *
+ * AES Integer Counter Mode using the ARMv8 cryptography extensions
+ *
+ */
+
+/*
+ *
+ * Copyright (c) 2001-2006, Cisco Systems, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following
+ *   disclaimer in the documentation and/or other materials provided
+ *   with the distribution.
+ *
+ *   Neither the name of the Cisco Systems, Inc. nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "aes_icm.h"
+#include "alloc.h"
+
+#ifdef AES_ICM_ARMV8
+
+#include <arm_neon.h>
+#ifdef __linux__
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+/*
+ * the crypto extensions have to be enabled for the whole build
+ * (-march=armv8-a+crypto) for AES_ICM_ARMV8 to be defined;
+ * aes_icm_armv8 is still only loaded into the crypto kernel when
+ * aes_icm_armv8_supported() says the cpu has them
+ */
+
+/*
+ * number of counter blocks encrypted per iteration of the main loop;
+ * four independent blocks keep the aese/aesmc pipeline busy
+ */
+#define AES_ICM_ARMV8_BLOCKS 4
+
+extern debug_module_t mod_aes_icm;
+extern cipher_test_case_t aes_icm_test_case_1;
+
+cipher_type_t aes_icm_armv8;
+
+int
+aes_icm_armv8_supported(void) {
+#ifdef __linux__
+  return (getauxval(AT_HWCAP) & HWCAP_AES) != 0;
+#else
+  return 1;
+#endif
+}
+
+err_status_t
+aes_icm_armv8_alloc(cipher_t **c, int key_len, int forIsmacryp) {
+  uint8_t *pointer;
+  int tmp;
+
+  debug_print(mod_aes_icm,
+            "allocating armv8 cipher with key length %d", key_len);
+
+  if (key_len != 30)
+    return err_status_bad_param;
+
+  /* allocate memory a cipher of type aes_icm_armv8 */
+  tmp = (sizeof(aes_icm_ctx_t) + sizeof(cipher_t));
+  pointer = (uint8_t*)crypto_alloc(tmp);
+  if (pointer == NULL)
+    return err_status_alloc_fail;
+
+  /* set pointers */
+  *c = (cipher_t *)pointer;
+  (*c)->type = &aes_icm_armv8;
+  (*c)->state = pointer + sizeof(cipher_t);
+
+  /* increment ref_count */
+  aes_icm_armv8.ref_count++;
+
+  /* set key size        */
+  (*c)->key_len = key_len;
+
+  return err_status_ok;
+}
+
+err_status_t
+aes_icm_armv8_dealloc(cipher_t *c) {
+
+  /* zeroize entire state*/
+  octet_string_set_to_zero((uint8_t *)c,
+			   sizeof(aes_icm_ctx_t) + sizeof(cipher_t));
+
+  /* free memory */
+  crypto_free(c);
+
+  /* decrement ref_count */
+  aes_icm_armv8.ref_count--;
+
+  return err_status_ok;
+}
+
+/*
+ * AES_ICM_ARMV8_ROUND(b, k) is one full round with round key k: aese
+ * adds the key before SubBytes/ShiftRows, so the rounds are shifted by
+ * one key with respect to the usual description and the last key is
+ * added with a plain xor
+ */
+
+#define AES_ICM_ARMV8_ROUND(b, k) b = vaesmcq_u8(vaeseq_u8(b, k))
+
+/*
+ * aes_icm_armv8_block(...) encrypts one counter block with the
+ * expanded key in rk[]
+ */
+
+static inline uint8x16_t
+aes_icm_armv8_block(uint8x16_t block, const uint8x16_t *rk) {
+  int i;
+
+  for (i = 0; i < 9; i++)
+    AES_ICM_ARMV8_ROUND(block, rk[i]);
+  return veorq_u8(vaeseq_u8(block, rk[9]), rk[10]);
+}
+
+/*
+ * aes_icm_armv8_counter(...) returns the counter block for block
+ * index ctr; only the last (big-endian) 16 bits of the counter change
+ * from block to block, so they are inserted into the constant part
+ */
+
+static inline uint8x16_t
+aes_icm_armv8_counter(uint8x16_t base, uint16_t ctr) {
+  return vreinterpretq_u8_u16(vsetq_lane_u16((uint16_t)((ctr << 8) | (ctr >> 8)),
+					     vreinterpretq_u16_u8(base), 7));
+}
+
+/*
+ * aes_icm_armv8_encrypt(...) has the same semantics as
+ * aes_icm_encrypt(), including the keystream_buffer handling, so the
+ * two can be used interchangeably on the same aes_icm_ctx_t
+ */
+
+err_status_t
+aes_icm_armv8_encrypt(aes_icm_ctx_t *c,
+		      unsigned char *buf, unsigned int *enc_len) {
+  unsigned int bytes_to_encr = *enc_len;
+  unsigned int i;
+  uint8x16_t rk[11];
+  uint8x16_t base;
+  uint16_t ctr;
+
+  /* check that there's enough segment left */
+  if ((bytes_to_encr + htons(c->counter.v16[7])) > 0xffff)
+    return err_status_terminus;
+
+  debug_print(mod_aes_icm, "block index: %d",
+           htons(c->counter.v16[7]));
+
+  /* use up any keystream left over from the previous call */
+  if (bytes_to_encr <= (unsigned int)c->bytes_in_buffer) {
+    for (i = (sizeof(v128_t) - c->bytes_in_buffer);
+	 i < (sizeof(v128_t) - c->bytes_in_buffer + bytes_to_encr); i++)
+      *buf++ ^= c->keystream_buffer.v8[i];
+    c->bytes_in_buffer -= bytes_to_encr;
+    return err_status_ok;
+  }
+  for (i = (sizeof(v128_t) - c->bytes_in_buffer); i < sizeof(v128_t); i++)
+    *buf++ ^= c->keystream_buffer.v8[i];
+  bytes_to_encr -= c->bytes_in_buffer;
+  c->bytes_in_buffer = 0;
+
+  for (i = 0; i < 11; i++)
+    rk[i] = vld1q_u8(c->expanded_key[i].v8);
+  base = vld1q_u8(c->counter.v8);
+  ctr = (uint16_t)((c->counter.v8[14] << 8) | c->counter.v8[15]);
+
+  /* encrypt AES_ICM_ARMV8_BLOCKS counter blocks at a time */
+  while (bytes_to_encr >= AES_ICM_ARMV8_BLOCKS * sizeof(v128_t)) {
+    uint8x16_t b0 = aes_icm_armv8_counter(base, ctr);
+    uint8x16_t b1 = aes_icm_armv8_counter(base, (uint16_t)(ctr + 1));
+    uint8x16_t b2 = aes_icm_armv8_counter(base, (uint16_t)(ctr + 2));
+    uint8x16_t b3 = aes_icm_armv8_counter(base, (uint16_t)(ctr + 3));
+
+    for (i = 0; i < 9; i++) {
+      AES_ICM_ARMV8_ROUND(b0, rk[i]);
+      AES_ICM_ARMV8_ROUND(b1, rk[i]);
+      AES_ICM_ARMV8_ROUND(b2, rk[i]);
+      AES_ICM_ARMV8_ROUND(b3, rk[i]);
+    }
+    b0 = veorq_u8(vaeseq_u8(b0, rk[9]), rk[10]);
+    b1 = veorq_u8(vaeseq_u8(b1, rk[9]), rk[10]);
+    b2 = veorq_u8(vaeseq_u8(b2, rk[9]), rk[10]);
+    b3 = veorq_u8(vaeseq_u8(b3, rk[9]), rk[10]);
+
+    vst1q_u8(buf, veorq_u8(b0, vld1q_u8(buf)));
+    vst1q_u8(buf + 16, veorq_u8(b1, vld1q_u8(buf + 16)));
+    vst1q_u8(buf + 32, veorq_u8(b2, vld1q_u8(buf + 32)));
+    vst1q_u8(buf + 48, veorq_u8(b3, vld1q_u8(buf + 48)));
+
+    ctr += AES_ICM_ARMV8_BLOCKS;
+    buf += AES_ICM_ARMV8_BLOCKS * sizeof(v128_t);
+    bytes_to_encr -= AES_ICM_ARMV8_BLOCKS * sizeof(v128_t);
+  }
+
+  /* then whatever whole blocks remain */
+  while (bytes_to_encr >= sizeof(v128_t)) {
+    uint8x16_t ks = aes_icm_armv8_block(aes_icm_armv8_counter(base, ctr), rk);
+
+    vst1q_u8(buf, veorq_u8(ks, vld1q_u8(buf)));
+    ctr++;
+    buf += sizeof(v128_t);
+    bytes_to_encr -= sizeof(v128_t);
+  }
+
+  /* if there is a tail end of the data, keep its keystream block */
+  if (bytes_to_encr != 0) {
+    vst1q_u8(c->keystream_buffer.v8,
+	     aes_icm_armv8_block(aes_icm_armv8_counter(base, ctr), rk));
+    ctr++;
+    for (i = 0; i < bytes_to_encr; i++)
+      *buf++ ^= c->keystream_buffer.v8[i];
+    c->bytes_in_buffer = sizeof(v128_t) - bytes_to_encr;
+  }
+
+  /* write the clocked counter back */
+  c->counter.v8[14] = (uint8_t)(ctr >> 8);
+  c->counter.v8[15] = (uint8_t)ctr;
+
+  return err_status_ok;
+}
+
+
+char
+aes_icm_armv8_description[] = "aes integer counter mode (armv8 crypto extensions)";
+
+/*
+ * note: the encrypt function is identical to the decrypt function
+ */
+
+cipher_type_t aes_icm_armv8 = {
+  (cipher_alloc_func_t)          aes_icm_armv8_alloc,
+  (cipher_dealloc_func_t)        aes_icm_armv8_dealloc,
+  (cipher_init_func_t)           aes_icm_context_init,
+  (cipher_encrypt_func_t)        aes_icm_armv8_encrypt,
+  (cipher_decrypt_func_t)        aes_icm_armv8_encrypt,
+  (cipher_set_iv_func_t)         aes_icm_set_iv,
+  (char *)                       aes_icm_armv8_description,
+  (int)                          0,   /* instance count */
+  (cipher_test_case_t *)        &aes_icm_test_case_1,
+  (debug_module_t *)            &mod_aes_icm
+};
+
+#endif /* AES_ICM_ARMV8 */
@@ -405,3 +405,35 @@ cipher_bits_per_second(cipher_t *c, int octets_in_buffer, int num_trials) {
   
   return (uint64_t)CLOCKS_PER_SEC * num_trials * 8 * octets_in_buffer / timer;
 }
+
+/*
+ * cipher_cycles_per_octet(c, l, t) is the counterpart of
+ * cipher_bits_per_second() that counts cpu cycles instead of clock()
+ * ticks
+ */
+
+double
+cipher_cycles_per_octet(cipher_t *c, int octets_in_buffer, int num_trials) {
+  int i;
+  v128_t nonce;
+  uint64_t cycles;
+  unsigned char *enc_buf;
+  unsigned int len = octets_in_buffer;
+
+  enc_buf = (unsigned char*) crypto_alloc(octets_in_buffer);
+  if (enc_buf == NULL)
+    return 0;  /* indicate bad parameters by returning null */
+
+  /* time repeated trials */
+  v128_set_to_zero(&nonce);
+  cycles = cpu_cycle_count();
+  for(i=0; i < num_trials; i++, nonce.v32[3] = i) {
+    cipher_set_iv(c, &nonce);
+    cipher_encrypt(c, enc_buf, &len);
+  }
+  cycles = cpu_cycle_count() - cycles;
+
+  crypto_free(enc_buf);
+
+  return (double)cycles / ((double)num_trials * octets_in_buffer);
+}
@@ -73,6 +73,21 @@ uint32_t SHA_K1 = 0x6ED9EBA1;   /* Kt for 20 <= t <= 39 */
 uint32_t SHA_K2 = 0x8F1BBCDC;   /* Kt for 40 <= t <= 59 */
 uint32_t SHA_K3 = 0xCA62C1D6;   /* Kt for 60 <= t <= 79 */
 
+/*
+ * sha1_blocks(H, msg, n) is the compression function behind
+ * sha1_core(), sha1_update() and sha1_final(); it starts out as
+ * sha1_blocks_select(), which replaces it with the fastest
+ * implementation that the cpu supports the first time it is called
+ */
+
+typedef void (*sha1_blocks_func_t)(uint32_t hash_value[5],
+				   const uint8_t *msg, int num_blocks);
+
+static void
+sha1_blocks_select(uint32_t hash_value[5], const uint8_t *msg, int num_blocks);
+
+static sha1_blocks_func_t sha1_blocks = sha1_blocks_select;
+
 void
 sha1(const uint8_t *msg,  int octets_in_msg, uint32_t hash_value[5]) {
   sha1_ctx_t ctx;
@@ -97,6 +112,11 @@ sha1(const uint8_t *msg,  int octets_in_msg, uint32_t hash_value[5]) {
 
 void
 sha1_core(const uint32_t M[16], uint32_t hash_value[5]) {
+  sha1_blocks(hash_value, (const uint8_t *)M, 1);
+}
+
+void
+sha1_core_c(const uint32_t M[16], uint32_t hash_value[5]) {
   uint32_t H0;
   uint32_t H1;
   uint32_t H2;
@@ -182,6 +202,41 @@ sha1_core(const uint32_t M[16], uint32_t hash_value[5]) {
   return;
 }
 
+static void
+sha1_blocks_c(uint32_t hash_value[5], const uint8_t *msg, int num_blocks) {
+  uint32_t M[16];
+
+  for (; num_blocks > 0; num_blocks--) {
+    memcpy(M, msg, sizeof(M));
+    sha1_core_c(M, hash_value);
+    msg += sizeof(M);
+  }
+}
+
+const char *
+sha1_implementation(void) {
+#ifdef SHA1_SHANI
+  if (sha1_shani_supported()) {
+    sha1_blocks = sha1_blocks_shani;
+    return "sha-ni";
+  }
+#endif
+#ifdef SHA1_ARMV8
+  if (sha1_armv8_supported()) {
+    sha1_blocks = sha1_blocks_armv8;
+    return "armv8 crypto extensions";
+  }
+#endif
+  sha1_blocks = sha1_blocks_c;
+  return "portable c";
+}
+
+static void
+sha1_blocks_select(uint32_t hash_value[5], const uint8_t *msg, int num_blocks) {
+  sha1_implementation();
+  sha1_blocks(hash_value, msg, num_blocks);
+}
+
 void
 sha1_init(sha1_ctx_t *ctx) {
 
@@ -202,45 +257,46 @@ sha1_init(sha1_ctx_t *ctx) {
 
 void
 sha1_update(sha1_ctx_t *ctx, const uint8_t *msg, int octets_in_msg) {
-  int i;
   uint8_t *buf = (uint8_t *)ctx->M;
+  int n;
 
   /* update message bit-count */
   ctx->num_bits_in_msg += octets_in_msg * 8;
 
-  /* loop over 16-word blocks of M */
-  while (octets_in_msg > 0) {
-
-    if (octets_in_msg + ctx->octets_in_buffer >= 64) {
-
-      /* 
-       * copy words of M into msg buffer until that buffer is full,
-       * converting them into host byte order as needed
-       */
-      octets_in_msg -= (64 - ctx->octets_in_buffer);
-      for (i=ctx->octets_in_buffer; i < 64; i++) 
-	buf[i] = *msg++;
-      ctx->octets_in_buffer = 0;
-
-      /* process a whole block */
+  /* top up a partially filled msg buffer first */
+  if (ctx->octets_in_buffer > 0) {
+    n = 64 - ctx->octets_in_buffer;
+    if (n > octets_in_msg)
+      n = octets_in_msg;
+    memcpy(buf + ctx->octets_in_buffer, msg, n);
+    ctx->octets_in_buffer += n;
+    msg += n;
+    octets_in_msg -= n;
+    if (ctx->octets_in_buffer < 64) {
+      debug_print(mod_sha1, "(update) not running sha1_core()", NULL);
+      return;
+    }
 
-      debug_print(mod_sha1, "(update) running sha1_core()", NULL);
+    debug_print(mod_sha1, "(update) running sha1_core()", NULL);
 
-      sha1_core(ctx->M, ctx->H);
+    sha1_blocks(ctx->H, buf, 1);
+    ctx->octets_in_buffer = 0;
+  }
 
-    } else {
+  /* process whole blocks straight out of msg */
+  if (octets_in_msg >= 64) {
 
-      debug_print(mod_sha1, "(update) not running sha1_core()", NULL);
-
-      for (i=ctx->octets_in_buffer; 
-	   i < (ctx->octets_in_buffer + octets_in_msg); i++)
-	buf[i] = *msg++;
-      ctx->octets_in_buffer += octets_in_msg;
-      octets_in_msg = 0;
-    }
+    debug_print(mod_sha1, "(update) running sha1_core()", NULL);
 
+    sha1_blocks(ctx->H, msg, octets_in_msg / 64);
+    msg += octets_in_msg & ~63;
+    octets_in_msg &= 63;
   }
 
+  /* and keep whatever is left for later */
+  memcpy(buf, msg, octets_in_msg);
+  ctx->octets_in_buffer = octets_in_msg;
+
 }
 
 /*
@@ -250,143 +306,33 @@ sha1_update(sha1_ctx_t *ctx, const uint8_t *msg, int octets_in_msg) {
 
 void
 sha1_final(sha1_ctx_t *ctx, uint32_t *output) {
-  uint32_t A, B, C, D, E, TEMP;
-  uint32_t W[80];  
-  int i, t;
+  uint8_t *buf = (uint8_t *)ctx->M;
+  int n = ctx->octets_in_buffer;
 
   /*
    * process the remaining octets_in_buffer, padding and terminating as
-   * necessary
+   * necessary: the message is followed by a single one bit, zeros, and
+   * the 64-bit big-endian bit-length, which needs a second block if it
+   * doesn't fit behind the message
    */
-  {
-    int tail = ctx->octets_in_buffer % 4;
-
-    /* copy/xor message into array */
-    for (i=0; i < (ctx->octets_in_buffer+3)/4; i++) 
-      W[i]  = be32_to_cpu(ctx->M[i]);
-
-    /* set the high bit of the octet immediately following the message */
-    switch (tail) {
-    case (3):
-      W[i-1] = (be32_to_cpu(ctx->M[i-1]) & 0xffffff00) | 0x80;
-      W[i] = 0x0;
-      break;
-    case (2):      
-      W[i-1] = (be32_to_cpu(ctx->M[i-1]) & 0xffff0000) | 0x8000;
-      W[i] = 0x0;
-      break;
-    case (1):
-      W[i-1] = (be32_to_cpu(ctx->M[i-1]) & 0xff000000) | 0x800000;
-      W[i] = 0x0;
-      break;
-    case (0):
-      W[i] = 0x80000000;
-      break;
-    }
-
-    /* zeroize remaining words */
-    for (i++   ; i < 15; i++)
-      W[i] = 0x0;
-
-    /* 
-     * if there is room at the end of the word array, then set the
-     * last word to the bit-length of the message; otherwise, set that
-     * word to zero and then we need to do one more run of the
-     * compression algo.
-     */
-    if (ctx->octets_in_buffer < 56) 
-      W[15] = ctx->num_bits_in_msg;
-    else if (ctx->octets_in_buffer < 60)
-      W[15] = 0x0;
-
-    /* process the word array */
-    for (t=16; t < 80; t++) {
-      TEMP = W[t-3] ^ W[t-8] ^ W[t-14] ^ W[t-16];
-      W[t] = S1(TEMP);
-    }
-
-    A = ctx->H[0]; 
-    B = ctx->H[1]; 
-    C = ctx->H[2]; 
-    D = ctx->H[3]; 
-    E = ctx->H[4];
-
-    for (t=0; t < 20; t++) {
-      TEMP = S5(A) + f0(B,C,D) + E + W[t] + SHA_K0;
-      E = D; D = C; C = S30(B); B = A; A = TEMP;
-    }
-    for (   ; t < 40; t++) {
-      TEMP = S5(A) + f1(B,C,D) + E + W[t] + SHA_K1;
-      E = D; D = C; C = S30(B); B = A; A = TEMP;
-    }
-    for (   ; t < 60; t++) {
-      TEMP = S5(A) + f2(B,C,D) + E + W[t] + SHA_K2;
-      E = D; D = C; C = S30(B); B = A; A = TEMP;
-    }
-    for (   ; t < 80; t++) {
-      TEMP = S5(A) + f3(B,C,D) + E + W[t] + SHA_K3;
-      E = D; D = C; C = S30(B); B = A; A = TEMP;
-    }
+  buf[n++] = 0x80;
+  if (n > 56) {
 
-    ctx->H[0] += A;
-    ctx->H[1] += B;
-    ctx->H[2] += C;
-    ctx->H[3] += D;
-    ctx->H[4] += E;
+    debug_print(mod_sha1, "(final) running sha1_core()", NULL);
 
+    memset(buf + n, 0, 64 - n);
+    sha1_blocks(ctx->H, buf, 1);
+    n = 0;
   }
+  memset(buf + n, 0, 60 - n);
+  buf[60] = (uint8_t)(ctx->num_bits_in_msg >> 24);
+  buf[61] = (uint8_t)(ctx->num_bits_in_msg >> 16);
+  buf[62] = (uint8_t)(ctx->num_bits_in_msg >> 8);
+  buf[63] = (uint8_t)ctx->num_bits_in_msg;
 
   debug_print(mod_sha1, "(final) running sha1_core()", NULL);
 
-  if (ctx->octets_in_buffer >= 56) {
-
-    debug_print(mod_sha1, "(final) running sha1_core() again", NULL);
-
-    /* we need to do one final run of the compression algo */
-
-    /* 
-     * set initial part of word array to zeros, and set the 
-     * final part to the number of bits in the message
-     */
-    for (i=0; i < 15; i++)
-      W[i] = 0x0;
-    W[15] = ctx->num_bits_in_msg;
-
-    /* process the word array */
-    for (t=16; t < 80; t++) {
-      TEMP = W[t-3] ^ W[t-8] ^ W[t-14] ^ W[t-16];
-      W[t] = S1(TEMP);
-    }
-
-    A = ctx->H[0]; 
-    B = ctx->H[1]; 
-    C = ctx->H[2]; 
-    D = ctx->H[3]; 
-    E = ctx->H[4];
-
-    for (t=0; t < 20; t++) {
-      TEMP = S5(A) + f0(B,C,D) + E + W[t] + SHA_K0;
-      E = D; D = C; C = S30(B); B = A; A = TEMP;
-    }
-    for (   ; t < 40; t++) {
-      TEMP = S5(A) + f1(B,C,D) + E + W[t] + SHA_K1;
-      E = D; D = C; C = S30(B); B = A; A = TEMP;
-    }
-    for (   ; t < 60; t++) {
-      TEMP = S5(A) + f2(B,C,D) + E + W[t] + SHA_K2;
-      E = D; D = C; C = S30(B); B = A; A = TEMP;
-    }
-    for (   ; t < 80; t++) {
-      TEMP = S5(A) + f3(B,C,D) + E + W[t] + SHA_K3;
-      E = D; D = C; C = S30(B); B = A; A = TEMP;
-    }
-
-    ctx->H[0] += A;
-    ctx->H[1] += B;
-    ctx->H[2] += C;
-    ctx->H[3] += D;
-    ctx->H[4] += E;
-  }
+  sha1_blocks(ctx->H, buf, 1);
 
   /* copy result into output buffer */
   output[0] = be32_to_cpu(ctx->H[0]);
@@ -0,0 +1,232 @@
+/*
+ * sha1_armv8.c
+ *
+ * the SHA-1 compression function using the ARMv8 cryptography
+ * extensions
+ *
+ */
+
+/*
+ *
+ * Copyright (c) 2001-2006, Cisco Systems, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following
+ *   disclaimer in the documentation and/or other materials provided
+ *   with the distribution.
+ *
+ *   Neither the name of the Cisco Systems, Inc. nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "aes_icm.h"
+#include "alloc.h"
+
+#include "sha1.h"
+
+#ifdef SHA1_ARMV8
+
+#include <arm_neon.h>
+#ifdef __linux__
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+/*
+ * unlike the x86 version, this file needs the crypto extensions to be
+ * enabled for the whole build (-march=armv8-a+crypto); the hwcap check
+ * is still made so that sha1_core() can fall back to sha1_core_c()
+ */
+
+int
+sha1_armv8_supported(void) {
+#ifdef __linux__
+  return (getauxval(AT_HWCAP) & HWCAP_SHA1) != 0;
+#else
+  return 1;
+#endif
+}
+
+/*
+ * each of sha1c/sha1p/sha1m does four rounds; sha1h gives the E of
+ * the next group of four.  The message schedule for later groups is
+ * computed alongside with sha1su0 and sha1su1, and the round constant
+ * is added two groups ahead.
+ */
+
+#define SHA1_ARMV8_LOAD(m, i)						\
+  m = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(msg + 16 * (i))))
+
+#define SHA1_ARMV8_ROUNDS(op, e_in, e_out, tmp)			\
+  e_out = vsha1h_u32(vgetq_lane_u32(abcd, 0));				\
+  abcd = op(abcd, e_in, tmp)
+
+void
+sha1_blocks_armv8(uint32_t hash_value[5], const uint8_t *msg, int num_blocks) {
+  const uint32x4_t k0 = vdupq_n_u32(0x5A827999);
+  const uint32x4_t k1 = vdupq_n_u32(0x6ED9EBA1);
+  const uint32x4_t k2 = vdupq_n_u32(0x8F1BBCDC);
+  const uint32x4_t k3 = vdupq_n_u32(0xCA62C1D6);
+  uint32x4_t abcd, abcd_save;
+  uint32x4_t t0, t1;
+  uint32x4_t m0, m1, m2, m3;
+  uint32_t e0, e0_save, e1;
+
+  abcd = vld1q_u32(hash_value);
+  e0 = hash_value[4];
+
+  for (; num_blocks > 0; num_blocks--, msg += 64) {
+    abcd_save = abcd;
+    e0_save = e0;
+
+    SHA1_ARMV8_LOAD(m0, 0);
+    SHA1_ARMV8_LOAD(m1, 1);
+    SHA1_ARMV8_LOAD(m2, 2);
+    SHA1_ARMV8_LOAD(m3, 3);
+
+    t0 = vaddq_u32(m0, k0);
+    t1 = vaddq_u32(m1, k0);
+
+    /* rounds 0-3 */
+    SHA1_ARMV8_ROUNDS(vsha1cq_u32, e0, e1, t0);
+    t0 = vaddq_u32(m2, k0);
+    m0 = vsha1su0q_u32(m0, m1, m2);
+
+    /* rounds 4-7 */
+    SHA1_ARMV8_ROUNDS(vsha1cq_u32, e1, e0, t1);
+    t1 = vaddq_u32(m3, k0);
+    m0 = vsha1su1q_u32(m0, m3);
+    m1 = vsha1su0q_u32(m1, m2, m3);
+
+    /* rounds 8-11 */
+    SHA1_ARMV8_ROUNDS(vsha1cq_u32, e0, e1, t0);
+    t0 = vaddq_u32(m0, k0);
+    m1 = vsha1su1q_u32(m1, m0);
+    m2 = vsha1su0q_u32(m2, m3, m0);
+
+    /* rounds 12-15 */
+    SHA1_ARMV8_ROUNDS(vsha1cq_u32, e1, e0, t1);
+    t1 = vaddq_u32(m1, k1);
+    m2 = vsha1su1q_u32(m2, m1);
+    m3 = vsha1su0q_u32(m3, m0, m1);
+
+    /* rounds 16-19 */
+    SHA1_ARMV8_ROUNDS(vsha1cq_u32, e0, e1, t0);
+    t0 = vaddq_u32(m2, k1);
+    m3 = vsha1su1q_u32(m3, m2);
+    m0 = vsha1su0q_u32(m0, m1, m2);
+
+    /* rounds 20-23 */
+    SHA1_ARMV8_ROUNDS(vsha1pq_u32, e1, e0, t1);
+    t1 = vaddq_u32(m3, k1);
+    m0 = vsha1su1q_u32(m0, m3);
+    m1 = vsha1su0q_u32(m1, m2, m3);
+
+    /* rounds 24-27 */
+    SHA1_ARMV8_ROUNDS(vsha1pq_u32, e0, e1, t0);
+    t0 = vaddq_u32(m0, k1);
+    m1 = vsha1su1q_u32(m1, m0);
+    m2 = vsha1su0q_u32(m2, m3, m0);
+
+    /* rounds 28-31 */
+    SHA1_ARMV8_ROUNDS(vsha1pq_u32, e1, e0, t1);
+    t1 = vaddq_u32(m1, k1);
+    m2 = vsha1su1q_u32(m2, m1);
+    m3 = vsha1su0q_u32(m3, m0, m1);
+
+    /* rounds 32-35 */
+    SHA1_ARMV8_ROUNDS(vsha1pq_u32, e0, e1, t0);
+    t0 = vaddq_u32(m2, k2);
+    m3 = vsha1su1q_u32(m3, m2);
+    m0 = vsha1su0q_u32(m0, m1, m2);
+
+    /* rounds 36-39 */
+    SHA1_ARMV8_ROUNDS(vsha1pq_u32, e1, e0, t1);
+    t1 = vaddq_u32(m3, k2);
+    m0 = vsha1su1q_u32(m0, m3);
+    m1 = vsha1su0q_u32(m1, m2, m3);
+
+    /* rounds 40-43 */
+    SHA1_ARMV8_ROUNDS(vsha1mq_u32, e0, e1, t0);
+    t0 = vaddq_u32(m0, k2);
+    m1 = vsha1su1q_u32(m1, m0);
+    m2 = vsha1su0q_u32(m2, m3, m0);
+
+    /* rounds 44-47 */
+    SHA1_ARMV8_ROUNDS(vsha1mq_u32, e1, e0, t1);
+    t1 = vaddq_u32(m1, k2);
+    m2 = vsha1su1q_u32(m2, m1);
+    m3 = vsha1su0q_u32(m3, m0, m1);
+
+    /* rounds 48-51 */
+    SHA1_ARMV8_ROUNDS(vsha1mq_u32, e0, e1, t0);
+    t0 = vaddq_u32(m2, k2);
+    m3 = vsha1su1q_u32(m3, m2);
+    m0 = vsha1su0q_u32(m0, m1, m2);
+
+    /* rounds 52-55 */
+    SHA1_ARMV8_ROUNDS(vsha1mq_u32, e1, e0, t1);
+    t1 = vaddq_u32(m3, k3);
+    m0 = vsha1su1q_u32(m0, m3);
+    m1 = vsha1su0q_u32(m1, m2, m3);
+
+    /* rounds 56-59 */
+    SHA1_ARMV8_ROUNDS(vsha1mq_u32, e0, e1, t0);
+    t0 = vaddq_u32(m0, k3);
+    m1 = vsha1su1q_u32(m1, m0);
+    m2 = vsha1su0q_u32(m2, m3, m0);
+
+    /* rounds 60-63 */
+    SHA1_ARMV8_ROUNDS(vsha1pq_u32, e1, e0, t1);
+    t1 = vaddq_u32(m1, k3);
+    m2 = vsha1su1q_u32(m2, m1);
+    m3 = vsha1su0q_u32(m3, m0, m1);
+
+    /* rounds 64-67 */
+    SHA1_ARMV8_ROUNDS(vsha1pq_u32, e0, e1, t0);
+    t0 = vaddq_u32(m2, k3);
+    m3 = vsha1su1q_u32(m3, m2);
+
+    /* rounds 68-71 */
+    SHA1_ARMV8_ROUNDS(vsha1pq_u32, e1, e0, t1);
+    t1 = vaddq_u32(m3, k3);
+
+    /* rounds 72-75 */
+    SHA1_ARMV8_ROUNDS(vsha1pq_u32, e0, e1, t0);
+
+    /* rounds 76-79 */
+    SHA1_ARMV8_ROUNDS(vsha1pq_u32, e1, e0, t1);
+
+    /* add this block's result to the intermediate state */
+    e0 += e0_save;
+    abcd = vaddq_u32(abcd, abcd_save);
+  }
+
+  vst1q_u32(hash_value, abcd);
+  hash_value[4] = e0;
+}
+
+#endif /* SHA1_ARMV8 */
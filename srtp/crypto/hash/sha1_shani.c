@@ -0,0 +1,231 @@
+/*
+ * sha1_shani.c
+ *
+ * the SHA-1 compression function using the x86 SHA extensions
+ *
+ */
+
+/*
+ *
+ * Copyright (c) 2001-2006, Cisco Systems, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ *
+ *   Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following
+ *   disclaimer in the documentation and/or other materials provided
+ *   with the distribution.
+ *
+ *   Neither the name of the Cisco Systems, Inc. nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "aes_icm.h"
+#include "alloc.h"
+
+#include "sha1.h"
+
+#ifdef SHA1_SHANI
+
+#include <cpuid.h>
+#include <immintrin.h>
+
+/*
+ * as with aes_icm_aesni, the functions below are compiled for the sha
+ * extensions regardless of the flags used for the rest of the library;
+ * sha1_core() only calls them when sha1_shani_supported() says the cpu
+ * has them
+ */
+#define SHA1_SHANI_TARGET __attribute__((target("sha,sse4.1")))
+
+int
+sha1_shani_supported(void) {
+  unsigned int eax, ebx, ecx, edx;
+
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return 0;
+  if (!(ecx & bit_SSE4_1))
+    return 0;
+  if (__get_cpuid_max(0, NULL) < 7)
+    return 0;
+  __cpuid_count(7, 0, eax, ebx, ecx, edx);
+  return (ebx >> 29) & 1;   /* CPUID.(EAX=7,ECX=0):EBX.SHA[bit 29] */
+}
+
+/*
+ * each sha1rnds4 does four rounds; the message schedule for the next
+ * few groups of four rounds is computed alongside with sha1msg1,
+ * sha1msg2 and a plain xor.  E is carried between the groups in the
+ * top lane of e0/e1, where sha1nexte expects it.
+ */
+
+#define SHA1_SHANI_LOAD(m, i)						\
+  m = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(msg + 16 * (i))), \
+		       bswap)
+
+#define SHA1_SHANI_ROUNDS(e_in, e_out, m, f)				\
+  e_in = _mm_sha1nexte_epu32(e_in, m);					\
+  e_out = abcd;								\
+  abcd = _mm_sha1rnds4_epu32(abcd, e_in, f)
+
+SHA1_SHANI_TARGET
+void
+sha1_blocks_shani(uint32_t hash_value[5], const uint8_t *msg, int num_blocks) {
+  const __m128i bswap = _mm_set_epi64x(0x0001020304050607ULL,
+				       0x08090a0b0c0d0e0fULL);
+  __m128i abcd, abcd_save, e0, e0_save, e1;
+  __m128i m0, m1, m2, m3;
+
+  /* H0 goes in the top lane of abcd, H4 in the top lane of e0 */
+  abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)hash_value), 0x1b);
+  e0 = _mm_set_epi32((int)hash_value[4], 0, 0, 0);
+
+  for (; num_blocks > 0; num_blocks--, msg += 64) {
+    abcd_save = abcd;
+    e0_save = e0;
+
+    /* rounds 0-3 */
+    SHA1_SHANI_LOAD(m0, 0);
+    e0 = _mm_add_epi32(e0, m0);
+    e1 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+    /* rounds 4-7 */
+    SHA1_SHANI_LOAD(m1, 1);
+    SHA1_SHANI_ROUNDS(e1, e0, m1, 0);
+    m0 = _mm_sha1msg1_epu32(m0, m1);
+
+    /* rounds 8-11 */
+    SHA1_SHANI_LOAD(m2, 2);
+    SHA1_SHANI_ROUNDS(e0, e1, m2, 0);
+    m1 = _mm_sha1msg1_epu32(m1, m2);
+    m0 = _mm_xor_si128(m0, m2);
+
+    /* rounds 12-15 */
+    SHA1_SHANI_LOAD(m3, 3);
+    m0 = _mm_sha1msg2_epu32(m0, m3);
+    SHA1_SHANI_ROUNDS(e1, e0, m3, 0);
+    m2 = _mm_sha1msg1_epu32(m2, m3);
+    m1 = _mm_xor_si128(m1, m3);
+
+    /* rounds 16-19 */
+    m1 = _mm_sha1msg2_epu32(m1, m0);
+    SHA1_SHANI_ROUNDS(e0, e1, m0, 0);
+    m3 = _mm_sha1msg1_epu32(m3, m0);
+    m2 = _mm_xor_si128(m2, m0);
+
+    /* rounds 20-23 */
+    m2 = _mm_sha1msg2_epu32(m2, m1);
+    SHA1_SHANI_ROUNDS(e1, e0, m1, 1);
+    m0 = _mm_sha1msg1_epu32(m0, m1);
+    m3 = _mm_xor_si128(m3, m1);
+
+    /* rounds 24-27 */
+    m3 = _mm_sha1msg2_epu32(m3, m2);
+    SHA1_SHANI_ROUNDS(e0, e1, m2, 1);
+    m1 = _mm_sha1msg1_epu32(m1, m2);
+    m0 = _mm_xor_si128(m0, m2);
+
+    /* rounds 28-31 */
+    m0 = _mm_sha1msg2_epu32(m0, m3);
+    SHA1_SHANI_ROUNDS(e1, e0, m3, 1);
+    m2 = _mm_sha1msg1_epu32(m2, m3);
+    m1 = _mm_xor_si128(m1, m3);
+
+    /* rounds 32-35 */
+    m1 = _mm_sha1msg2_epu32(m1, m0);
+    SHA1_SHANI_ROUNDS(e0, e1, m0, 1);
+    m3 = _mm_sha1msg1_epu32(m3, m0);
+    m2 = _mm_xor_si128(m2, m0);
+
+    /* rounds 36-39 */
+    m2 = _mm_sha1msg2_epu32(m2, m1);
+    SHA1_SHANI_ROUNDS(e1, e0, m1, 1);
+    m0 = _mm_sha1msg1_epu32(m0, m1);
+    m3 = _mm_xor_si128(m3, m1);
+
+    /* rounds 40-43 */
+    m3 = _mm_sha1msg2_epu32(m3, m2);
+    SHA1_SHANI_ROUNDS(e0, e1, m2, 2);
+    m1 = _mm_sha1msg1_epu32(m1, m2);
+    m0 = _mm_xor_si128(m0, m2);
+
+    /* rounds 44-47 */
+    m0 = _mm_sha1msg2_epu32(m0, m3);
+    SHA1_SHANI_ROUNDS(e1, e0, m3, 2);
+    m2 = _mm_sha1msg1_epu32(m2, m3);
+    m1 = _mm_xor_si128(m1, m3);
+
+    /* rounds 48-51 */
+    m1 = _mm_sha1msg2_epu32(m1, m0);
+    SHA1_SHANI_ROUNDS(e0, e1, m0, 2);
+    m3 = _mm_sha1msg1_epu32(m3, m0);
+    m2 = _mm_xor_si128(m2, m0);
+
+    /* rounds 52-55 */
+    m2 = _mm_sha1msg2_epu32(m2, m1);
+    SHA1_SHANI_ROUNDS(e1, e0, m1, 2);
+    m0 = _mm_sha1msg1_epu32(m0, m1);
+    m3 = _mm_xor_si128(m3, m1);
+
+    /* rounds 56-59 */
+    m3 = _mm_sha1msg2_epu32(m3, m2);
+    SHA1_SHANI_ROUNDS(e0, e1, m2, 2);
+    m1 = _mm_sha1msg1_epu32(m1, m2);
+    m0 = _mm_xor_si128(m0, m2);
+
+    /* rounds 60-63 */
+    m0 = _mm_sha1msg2_epu32(m0, m3);
+    SHA1_SHANI_ROUNDS(e1, e0, m3, 3);
+    m2 = _mm_sha1msg1_epu32(m2, m3);
+    m1 = _mm_xor_si128(m1, m3);
+
+    /* rounds 64-67 */
+    m1 = _mm_sha1msg2_epu32(m1, m0);
+    SHA1_SHANI_ROUNDS(e0, e1, m0, 3);
+    m3 = _mm_sha1msg1_epu32(m3, m0);
+    m2 = _mm_xor_si128(m2, m0);
+
+    /* rounds 68-71 */
+    m2 = _mm_sha1msg2_epu32(m2, m1);
+    SHA1_SHANI_ROUNDS(e1, e0, m1, 3);
+    m3 = _mm_xor_si128(m3, m1);
+
+    /* rounds 72-75 */
+    m3 = _mm_sha1msg2_epu32(m3, m2);
+    SHA1_SHANI_ROUNDS(e0, e1, m2, 3);
+
+    /* rounds 76-79 */
+    SHA1_SHANI_ROUNDS(e1, e0, m3, 3);
+
+    /* add this block's result to the intermediate state */
+    e0 = _mm_sha1nexte_epu32(e0, e0_save);
+    abcd = _mm_add_epi32(abcd, abcd_save);
+  }
+
+  _mm_storeu_si128((__m128i *)hash_value, _mm_shuffle_epi32(abcd, 0x1b));
+  hash_value[4] = (uint32_t)_mm_extract_epi32(e0, 3);
+}
+
+#endif /* SHA1_SHANI */
@@ -52,5 +52,45 @@ aes_icm_alloc_ismacryp(cipher_t **c,
 		       int key_len, 
 		       int forIsmacryp);
 
+/*
+ * aes_icm_is_type(ct) returns nonzero if ct is one of the
+ * implementations of aes integer counter mode, all of which keep their
+ * state in an aes_icm_ctx_t
+ */
+
+int
+aes_icm_is_type(const cipher_type_t *ct);
+
+/*
+ * AES_ICM_AESNI is defined when the AES-NI implementation of aes
+ * integer counter mode (aes_icm_aesni) can be compiled; it is only
+ * used when aes_icm_aesni_supported() returns nonzero at runtime
+ */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AES_ICM_AESNI 1
+
+extern cipher_type_t aes_icm_aesni;
+
+int
+aes_icm_aesni_supported(void);
+
+#endif
+
+/*
+ * AES_ICM_ARMV8 is the same for the ARMv8 cryptography extensions
+ * (aes_icm_armv8), which have to be enabled at compile time
+ */
+
+#if defined(__GNUC__) && defined(__aarch64__) && defined(__ARM_FEATURE_CRYPTO)
+#define AES_ICM_ARMV8 1
+
+extern cipher_type_t aes_icm_armv8;
+
+int
+aes_icm_armv8_supported(void);
+
+#endif
+
 #endif /* AES_ICM_H */
 
@@ -215,4 +215,17 @@ cipher_type_self_test(const cipher_type_t *ct);
 uint64_t
 cipher_bits_per_second(cipher_t *c, int octets_in_buffer, int num_trials);
 
+/*
+ * cipher_cycles_per_octet(c, l, t) computes (an estimate of) the
+ * number of cpu cycles that a cipher implementation spends on each
+ * octet it encrypts, with the same parameters as
+ * cipher_bits_per_second()
+ *
+ * if an error is encountered, or cpu_cycle_count() isn't available,
+ * then the value 0 is returned
+ */
+
+double
+cipher_cycles_per_octet(cipher_t *c, int octets_in_buffer, int num_trials);
+
 #endif /* CIPHER_H */
@@ -424,6 +424,16 @@ static inline uint64_t be64_to_cpu(uint64_t v) {
 
 #endif /* WORDS_BIGENDIAN */
 
+/*
+ * cpu_cycle_count() reads the cpu's cycle counter (the time stamp
+ * counter on x86), for the cycles-per-octet figures reported by the
+ * test drivers; it returns zero where there is no counter that can be
+ * read from user space
+ */
+
+uint64_t
+cpu_cycle_count(void);
+
 /*
  * functions manipulating bitvector_t 
  *
@@ -500,6 +510,14 @@ bitvector_set_to_zero(bitvector_t *x);
 void
 bitvector_left_shift(bitvector_t *x, int index);
 
+/*
+ * bitvector_clear_range(x, start, n) clears the n bits from bit_index
+ * start onwards, whole words at a time where possible
+ */
+
+void
+bitvector_clear_range(bitvector_t *x, int start, int n);
+
 char *
 bitvector_bit_string(bitvector_t *x, char* buf, int len);
 
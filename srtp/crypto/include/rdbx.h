@@ -41,12 +41,16 @@ typedef uint64_t xtd_seq_num_t;
 
 /*
  * An rdbx_t is a replay database with extended range; it uses an
- * xtd_seq_num_t and a bitmask of recently received indices.
+ * xtd_seq_num_t and a bitmask of recently received indices.  The
+ * bitmask is used as a ring: head is the bit that corresponds to
+ * index, and the bits before it (wrapping around) to the indices
+ * before that, so that moving the window never shifts the bitmask.
  */
 
 typedef struct {
   xtd_seq_num_t index;
   bitvector_t bitmask;
+  uint32_t head;
 } rdbx_t;
 
 
@@ -104,5 +104,46 @@ sha1_final(sha1_ctx_t *ctx, uint32_t output[5]);
 
 void
 sha1_core(const uint32_t M[16], uint32_t hash_value[5]);
+
+/*
+ * sha1_core() and sha1_update() use the sha-1 instructions of the cpu
+ * when there are any; sha1_core_c() is the portable implementation
+ * that is used otherwise, and sha1_implementation() returns a
+ * printable name for the one in use
+ */
+
+void
+sha1_core_c(const uint32_t M[16], uint32_t hash_value[5]);
+
+const char *
+sha1_implementation(void);
+
+/*
+ * sha1_blocks_<isa>(H, msg, n) runs the compression function over the
+ * n consecutive 64-octet blocks at msg (which need not be aligned);
+ * each is only used when sha1_<isa>_supported() returns nonzero
+ */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SHA1_SHANI 1
+
+void
+sha1_blocks_shani(uint32_t hash_value[5], const uint8_t *msg, int num_blocks);
+
+int
+sha1_shani_supported(void);
+
+#endif
+
+#if defined(__GNUC__) && defined(__aarch64__) && defined(__ARM_FEATURE_CRYPTO)
+#define SHA1_ARMV8 1
+
+void
+sha1_blocks_armv8(uint32_t hash_value[5], const uint8_t *msg, int num_blocks);
+
+int
+sha1_armv8_supported(void);
+
+#endif
      
 #endif /* SHA1_H */
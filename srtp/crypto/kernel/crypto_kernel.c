@@ -46,6 +46,7 @@
 #include "alloc.h"
 
 #include "crypto_kernel.h"
+#include "aes_icm.h"         /* for the aes_icm_aesni/armv8 checks */
 
 /* the debug module for the crypto_kernel */
 
@@ -151,6 +152,16 @@ crypto_kernel_init() {
   status = crypto_kernel_load_cipher_type(&null_cipher, NULL_CIPHER);
   if (status) 
     return status;
+#ifdef AES_ICM_AESNI
+  if (aes_icm_aesni_supported())
+    status = crypto_kernel_load_cipher_type(&aes_icm_aesni, AES_128_ICM);
+  else
+#endif
+#ifdef AES_ICM_ARMV8
+  if (aes_icm_armv8_supported())
+    status = crypto_kernel_load_cipher_type(&aes_icm_armv8, AES_128_ICM);
+  else
+#endif
   status = crypto_kernel_load_cipher_type(&aes_icm, AES_128_ICM);
   if (status) 
     return status;
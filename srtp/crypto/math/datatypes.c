@@ -505,6 +505,29 @@ bitvector_left_shift(bitvector_t *x, int index) {
 
 }
 
+void
+bitvector_clear_range(bitvector_t *x, int start, int n) {
+  int i, last;
+  uint32_t first_mask, last_mask;
+
+  if (n <= 0)
+    return;
+
+  i = start >> 5;
+  last = (start + n - 1) >> 5;
+  first_mask = 0xffffffff << (start & 31);
+  last_mask = 0xffffffff >> (31 - ((start + n - 1) & 31));
+
+  if (i == last) {
+    x->word[i] &= ~(first_mask & last_mask);
+    return;
+  }
+  x->word[i] &= ~first_mask;
+  for (i++; i < last; i++)
+    x->word[i] = 0;
+  x->word[last] &= ~last_mask;
+}
+
 
 int
 octet_string_is_eq(uint8_t *a, uint8_t *b, int len) {
@@ -525,6 +548,19 @@ octet_string_set_to_zero(uint8_t *s, int len) {
   
 }
 
+uint64_t
+cpu_cycle_count(void) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) \
+    && !defined(NO_64BIT_MATH)
+  uint32_t lo, hi;
+
+  __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+  return ((uint64_t)hi << 32) | lo;
+#else
+  return 0;
+#endif
+}
+
 
 /*
  *  From RFC 1521: The Base64 Alphabet
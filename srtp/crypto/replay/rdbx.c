@@ -81,8 +81,12 @@
  *
  * A rdbx_t consists of a xtd_seq_num_t and a bitmask.  The index is highest
  * sequence number that has been received, and the bitmask indicates
- * which of the recent indicies have been received as well.  The
- * highest bit in the bitmask corresponds to the index in the bitmask.
+ * which of the recent indicies have been received as well.  Bit head
+ * of the bitmask corresponds to the index, and bit head - d (modulo
+ * the window size) to index - d.  Advancing the index by delta moves
+ * head forward and clears the delta bits it passes over, so checks
+ * are constant time and an advance costs at most one pass over the
+ * words of the bitmask, however large the window is.
  */
 
 
@@ -200,6 +204,7 @@ rdbx_init(rdbx_t *rdbx, unsigned long ws) {
     return err_status_alloc_fail;
 
   index_init(&rdbx->index);
+  rdbx->head = 0;
 
   return err_status_ok;
 }
@@ -264,6 +269,20 @@ rdbx_get_window_size(const rdbx_t *rdbx) {
   return bitvector_get_length(&rdbx->bitmask);
 }
 
+/*
+ * rdbx_position(rdbx, delta) returns the bit of the bitmask that
+ * corresponds to rdbx->index + delta, for delta in (-window size, 0]
+ */
+
+static inline int
+rdbx_position(const rdbx_t *rdbx, int delta) {
+  int pos = (int)rdbx->head + delta;
+
+  if (pos < 0)
+    pos += (int)bitvector_get_length(&rdbx->bitmask);
+  return pos;
+}
+
 /*
  * rdbx_check(&r, delta) checks to see if the xtd_seq_num_t
  * which is at rdbx->index + delta is in the rdb
@@ -277,8 +296,8 @@ rdbx_check(const rdbx_t *rdbx, int delta) {
   } else if ((int)(bitvector_get_length(&rdbx->bitmask) - 1) + delta < 0) {   
                          /* if delta is lower than the bitmask, it's bad */
     return err_status_replay_old; 
-  } else if (bitvector_get_bit(&rdbx->bitmask, 
-			  (int)(bitvector_get_length(&rdbx->bitmask) - 1) + delta) == 1) {
+  } else if (bitvector_get_bit(&rdbx->bitmask,
+			       rdbx_position(rdbx, delta)) == 1) {
                          /* delta is within the window, so check the bitmask */
     return err_status_replay_fail;    
   }
@@ -298,18 +317,36 @@ rdbx_check(const rdbx_t *rdbx, int delta) {
 
 err_status_t
 rdbx_add_index(rdbx_t *rdbx, int delta) {
+  int ws = (int)bitvector_get_length(&rdbx->bitmask);
+  int start;
   
   if (delta > 0) {
-    /* shift forward by delta */
+    /* move forward by delta, forgetting the bits that head passes */
     index_advance(&rdbx->index, delta);
-    bitvector_left_shift(&rdbx->bitmask, delta);
-    bitvector_set_bit(&rdbx->bitmask, bitvector_get_length(&rdbx->bitmask) - 1);
-  } else {
+    if (delta >= ws) {
+      bitvector_set_to_zero(&rdbx->bitmask);
+      rdbx->head = (rdbx->head + delta) % ws;
+    } else {
+      start = (int)rdbx->head + 1;
+      if (start == ws)
+	start = 0;
+      if (start + delta <= ws) {
+	bitvector_clear_range(&rdbx->bitmask, start, delta);
+      } else {
+	bitvector_clear_range(&rdbx->bitmask, start, ws - start);
+	bitvector_clear_range(&rdbx->bitmask, 0, delta - (ws - start));
+      }
+      rdbx->head += delta;
+      if ((int)rdbx->head >= ws)
+	rdbx->head -= ws;
+    }
+    bitvector_set_bit(&rdbx->bitmask, rdbx->head);
+  } else if (delta > -ws) {
     /* delta is in window, so flip bit in bitmask */
-    bitvector_set_bit(&rdbx->bitmask, -delta);
+    bitvector_set_bit(&rdbx->bitmask, rdbx_position(rdbx, delta));
+  } else {
+    return err_status_replay_old;
   }
-
-  /* note that we need not consider the case that delta == 0 */
   
   return err_status_ok;
 }
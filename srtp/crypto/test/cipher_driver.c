@@ -216,6 +216,62 @@ main(int argc, char *argv[]) {
     
     status = cipher_dealloc(c);
     check_status(status);
+
+#ifdef AES_ICM_AESNI
+  /* run the same tests on the aes-ni version of aes_icm, if we can */
+  if (aes_icm_aesni_supported()) {
+    if (do_validation)
+      cipher_driver_self_test(&aes_icm_aesni);
+
+    status = cipher_type_alloc(&aes_icm_aesni, &c, 30);
+    if (status) {
+      fprintf(stderr, "error: can't allocate cipher\n");
+      exit(status);
+    }
+
+    status = cipher_init(c, test_key, direction_encrypt);
+    check_status(status);
+
+    if (do_timing_test)
+      cipher_driver_test_throughput(c);
+
+    if (do_validation) {
+      status = cipher_driver_test_buffering(c);
+      check_status(status);
+    }
+
+    status = cipher_dealloc(c);
+    check_status(status);
+  }
+#endif
+
+#ifdef AES_ICM_ARMV8
+  /* run the same tests on the armv8 version of aes_icm, if we can */
+  if (aes_icm_armv8_supported()) {
+    if (do_validation)
+      cipher_driver_self_test(&aes_icm_armv8);
+
+    status = cipher_type_alloc(&aes_icm_armv8, &c, 30);
+    if (status) {
+      fprintf(stderr, "error: can't allocate cipher\n");
+      exit(status);
+    }
+
+    status = cipher_init(c, test_key, direction_encrypt);
+    check_status(status);
+
+    if (do_timing_test)
+      cipher_driver_test_throughput(c);
+
+    if (do_validation) {
+      status = cipher_driver_test_buffering(c);
+      check_status(status);
+    }
+
+    status = cipher_dealloc(c);
+    check_status(status);
+  }
+#endif
   
   return 0;
 }
@@ -229,9 +285,14 @@ cipher_driver_test_throughput(cipher_t *c) {
   
   printf("timing %s throughput:\n", c->type->description);
   fflush(stdout);
-  for (i=min_enc_len; i <= max_enc_len; i = i * 2)
-    printf("msg len: %d\tgigabits per second: %f\n",
+  for (i=min_enc_len; i <= max_enc_len; i = i * 2) {
+    printf("msg len: %d\tgigabits per second: %f",
 	   i, cipher_bits_per_second(c, i, num_trials) / 1e9);
+    if (cpu_cycle_count() != 0)
+      printf("\tcycles per octet: %.2f",
+	     cipher_cycles_per_octet(c, i, num_trials));
+    printf("\n");
+  }
 
 }
 
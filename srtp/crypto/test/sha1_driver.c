@@ -44,6 +44,7 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>   /* for random() */
 #include "sha1.h"
 
 #define SHA_PASS 0
@@ -515,6 +516,34 @@ sha1_validate(void) {
 
 
 
+/*
+ * sha1_core_validate() checks that sha1_core(), which may be using the
+ * sha-1 instructions of the cpu, agrees with the portable sha1_core_c()
+ * on random states and message blocks
+ */
+
+err_status_t
+sha1_core_validate(void) {
+  uint32_t M[16], H[5], H_c[5];
+  int i, j;
+
+  for (i=0; i < 1000; i++) {
+    for (j=0; j < 16; j++)
+      M[j] = (uint32_t) random();
+    for (j=0; j < 5; j++)
+      H[j] = H_c[j] = (uint32_t) random();
+    sha1_core(M, H);
+    sha1_core_c(M, H_c);
+    if (0 != memcmp(H, H_c, sizeof(H))) {
+      printf("sha1_core() using %s differs from sha1_core_c()\n",
+	     sha1_implementation());
+      return err_status_algo_fail;
+    }
+  }
+
+  return err_status_ok;
+}
+
 int
 main (void) {
   err_status_t err;
@@ -528,6 +557,14 @@ main (void) {
   }
   printf("SHA1 passed validation tests\n");
 
+  err = sha1_core_validate();
+  if (err) {
+    printf("SHA1 core function did not pass validation testing\n");
+    return 1;
+  }
+  printf("SHA1 core function (%s) passed validation tests\n",
+	 sha1_implementation());
+
   return 0;
 
 }
@@ -78,6 +78,13 @@ extern "C" {
 
 #define SRTP_MAX_TAG_LEN 12 
 
+/*
+ * SRTP_DEFAULT_WINDOW_SIZE is the replay window, in packets, used for
+ * a policy whose window_size is zero
+ */
+
+#define SRTP_DEFAULT_WINDOW_SIZE 128
+
 /**
  * SRTP_MAX_TRAILER_LEN is the maximum length of the SRTP trailer
  * (authentication tag and MKI) supported by libSRTP.  This value is
@@ -220,7 +227,12 @@ typedef struct srtp_policy_t {
   ekt_policy_t ekt;            /**< Pointer to the EKT policy structure
                                 *   for this stream (if any)             */ 
   unsigned long  window_size;  /**< The window size to use for replay
-				*   protection. */
+				*   protection, from 64 up to 0x7fff
+				*   packets, or 0 for the default of
+				*   SRTP_DEFAULT_WINDOW_SIZE.  Checks cost
+				*   the same for any size, so high
+				*   bitrate streams with heavy reordering
+				*   can use e.g. 1024.                   */
   int        allow_repeat_tx;  /**< Whether retransmissions of
 				*   packets with the same sequence number
 				*   are allowed.  (Note that such repeated
@@ -359,6 +371,64 @@ srtp_protect(srtp_t ctx, void *rtp_hdr, int *len_ptr);
 err_status_t
 srtp_unprotect(srtp_t ctx, void *srtp_hdr, int *len_ptr);
 
+/**
+ * @brief srtp_packet_t describes one packet of a batch passed to
+ * srtp_protect_batch() or srtp_unprotect_batch().
+ *
+ * The fields hdr and len have the same meaning as the rtp_hdr (or
+ * srtp_hdr) and *len_ptr arguments of srtp_protect() (or
+ * srtp_unprotect()); status is set to the value that function
+ * returned for the packet.
+ */
+
+typedef struct srtp_packet_t {
+  void        *hdr;     /**< the packet, processed in place          */
+  int          len;     /**< its length in octets, before and after  */
+  err_status_t status;  /**< the result of processing this packet   */
+} srtp_packet_t;
+
+/**
+ * @brief srtp_protect_batch() applies srtp_protect() to each packet
+ * of an array.
+ *
+ * The function call srtp_protect_batch(ctx, pkts, num_pkts) protects
+ * pkts[0] through pkts[num_pkts-1] in order, exactly as if
+ * srtp_protect() had been called on each of them, and records the
+ * result of each call in the status field of that packet.  A failure
+ * does not stop the processing of the remaining packets.
+ *
+ * @param ctx is the SRTP context to use in processing the packets.
+ *
+ * @param pkts is the array of packets.
+ *
+ * @param num_pkts is the number of elements of pkts.
+ *
+ * @return
+ *    - err_status_ok  if every packet was protected.
+ *    - @e other       the status of the first packet that failed.
+ */
+
+err_status_t
+srtp_protect_batch(srtp_t ctx, srtp_packet_t *pkts, int num_pkts);
+
+/**
+ * @brief srtp_unprotect_batch() applies srtp_unprotect() to each
+ * packet of an array.
+ *
+ * The function call srtp_unprotect_batch(ctx, pkts, num_pkts) is the
+ * receiver-side counterpart of srtp_protect_batch(); see that function
+ * for the meaning of the arguments.  Packets that fail authentication
+ * or replay checks are flagged through their status field and do not
+ * affect the other packets of the batch.
+ *
+ * @return
+ *    - err_status_ok  if every packet was valid.
+ *    - @e other       the status of the first packet that failed.
+ */
+
+err_status_t
+srtp_unprotect_batch(srtp_t ctx, srtp_packet_t *pkts, int num_pkts);
+
 
 /**
  * @brief srtp_create() allocates and initializes an SRTP session.
@@ -228,16 +228,24 @@ typedef struct srtp_stream_ctx_t {
   int        allow_repeat_tx;
   ekt_stream_t ekt; 
   struct srtp_stream_ctx_t *next;   /* linked list of streams */
+  struct srtp_stream_ctx_t *next_in_bucket; /* stream_table chain */
 } srtp_stream_ctx_t;
 
 
 /*
  * an srtp_ctx_t holds a stream list and a service description
+ *
+ * every stream in stream_list is also chained into stream_table, a
+ * hash of the streams keyed by ssrc, so that finding the stream for a
+ * packet does not depend on how many streams the session has
  */
 
 typedef struct srtp_ctx_t {
   srtp_stream_ctx_t *stream_list;     /* linked list of streams            */
   srtp_stream_ctx_t *stream_template; /* act as template for other streams */
+  srtp_stream_ctx_t **stream_table;   /* stream_list hashed by ssrc        */
+  unsigned int stream_table_bits;     /* log2 of the number of buckets     */
+  unsigned int num_streams;           /* number of streams in stream_list  */
 } srtp_ctx_t;
 
 
@@ -73,6 +73,9 @@ debug_module_t mod_srtp = {
 #define octets_in_rtcp_header  8
 #define uint32s_in_rtcp_header 2
 
+static void
+srtp_insert_stream(srtp_t ctx, srtp_stream_ctx_t *stream);
+
 
 err_status_t
 srtp_stream_alloc(srtp_stream_ctx_t **str_ptr,
@@ -276,6 +279,7 @@ srtp_stream_clone(const srtp_stream_ctx_t *stream_template,
 
   /* defensive coding */
   str->next = NULL;
+  str->next_in_bucket = NULL;
 
   return err_status_ok;
 }
@@ -373,7 +377,7 @@ srtp_stream_init_keys(srtp_stream_ctx_t *srtp, const void *key) {
    * if the cipher in the srtp context is aes_icm, then we need
    * to generate the salt value
    */
-  if (srtp->rtp_cipher->type == &aes_icm) {
+  if (aes_icm_is_type(srtp->rtp_cipher->type)) {
     /* FIX!!! this is really the cipher key length; rest is salt */
     int base_key_len = 16;
     int salt_len = cipher_get_key_length(srtp->rtp_cipher) - base_key_len;
@@ -422,7 +426,7 @@ srtp_stream_init_keys(srtp_stream_ctx_t *srtp, const void *key) {
    * if the cipher in the srtp context is aes_icm, then we need
    * to generate the salt value
    */
-  if (srtp->rtcp_cipher->type == &aes_icm) {
+  if (aes_icm_is_type(srtp->rtcp_cipher->type)) {
     /* FIX!!! this is really the cipher key length; rest is salt */
     int base_key_len = 16;
     int salt_len = cipher_get_key_length(srtp->rtcp_cipher) - base_key_len;
@@ -475,8 +479,17 @@ srtp_stream_init(srtp_stream_ctx_t *srtp,
    debug_print(mod_srtp, "initializing stream (SSRC: 0x%08x)", 
 	       p->ssrc.value);
 
+   /*
+    * the replay window has to stay well below seq_num_median for
+    * index_guess() to work; zero selects the default window
+    */
+   if (p->window_size != 0 &&
+       (p->window_size < 64 || p->window_size >= 0x8000))
+     return err_status_bad_param;
+
    /* initialize replay database */
-   err = rdbx_init(&srtp->rtp_rdbx, p->window_size);
+   err = rdbx_init(&srtp->rtp_rdbx,
+		   p->window_size ? p->window_size : SRTP_DEFAULT_WINDOW_SIZE);
    if (err) return err;
 
    /* initialize key limit to maximum value */
@@ -634,8 +647,7 @@ srtp_stream_uninit(srtp_stream_ctx_t *srtp) {
 	 return status;
 
        /* add new stream to the head of the stream_list */
-       new_stream->next = ctx->stream_list;
-       ctx->stream_list = new_stream;
+       srtp_insert_stream(ctx, new_stream);
 
        /* set direction to outbound */
        new_stream->direction = dir_srtp_sender;
@@ -739,7 +751,7 @@ srtp_stream_uninit(srtp_stream_ctx_t *srtp) {
    /* 
     * if we're using rindael counter mode, set nonce and seq 
     */
-   if (stream->rtp_cipher->type == &aes_icm) {
+   if (aes_icm_is_type(stream->rtp_cipher->type)) {
      v128_t iv;
 
      iv.v32[0] = 0;
@@ -916,7 +928,7 @@ srtp_unprotect(srtp_ctx_t *ctx, void *srtp_hdr, int *pkt_octet_len) {
    * set the cipher's IV properly, depending on whatever cipher we
    * happen to be using
    */
-  if (stream->rtp_cipher->type == &aes_icm) {
+  if (aes_icm_is_type(stream->rtp_cipher->type)) {
 
     /* aes counter mode */
     iv.v32[0] = 0;
@@ -1094,8 +1106,7 @@ srtp_unprotect(srtp_ctx_t *ctx, void *srtp_hdr, int *pkt_octet_len) {
       return status;
     
     /* add new stream to the head of the stream_list */
-    new_stream->next = ctx->stream_list;
-    ctx->stream_list = new_stream;
+    srtp_insert_stream(ctx, new_stream);
     
     /* set stream (the pointer used in this function) */
     stream = new_stream;
@@ -1113,6 +1124,33 @@ srtp_unprotect(srtp_ctx_t *ctx, void *srtp_hdr, int *pkt_octet_len) {
   return err_status_ok;  
 }
 
+
+err_status_t
+srtp_protect_batch(srtp_ctx_t *ctx, srtp_packet_t *pkts, int num_pkts) {
+  err_status_t first_error = err_status_ok;
+  int i;
+
+  for (i = 0; i < num_pkts; i++) {
+    pkts[i].status = srtp_protect(ctx, pkts[i].hdr, &pkts[i].len);
+    if (pkts[i].status && !first_error)
+      first_error = pkts[i].status;
+  }
+  return first_error;
+}
+
+err_status_t
+srtp_unprotect_batch(srtp_ctx_t *ctx, srtp_packet_t *pkts, int num_pkts) {
+  err_status_t first_error = err_status_ok;
+  int i;
+
+  for (i = 0; i < num_pkts; i++) {
+    pkts[i].status = srtp_unprotect(ctx, pkts[i].hdr, &pkts[i].len);
+    if (pkts[i].status && !first_error)
+      first_error = pkts[i].status;
+  }
+  return first_error;
+}
+
 err_status_t
 srtp_init() {
   err_status_t status;
@@ -1149,6 +1187,81 @@ srtp_get_trailer_length(const srtp_stream_t s) {
 
 #endif
 
+/*
+ * srtp_stream_hash(ssrc, bits) returns the stream_table bucket of
+ * ssrc for a table of 2^bits buckets (multiplicative hashing, so the
+ * top bits of the product are the well mixed ones)
+ */
+
+#define SRTP_STREAM_TABLE_MIN_BITS 4
+
+static inline unsigned int
+srtp_stream_hash(uint32_t ssrc, unsigned int bits) {
+  return (uint32_t)(ssrc * 0x9e3779b1U) >> (32 - bits);
+}
+
+/*
+ * srtp_stream_table_resize(ctx, bits) replaces the stream_table of ctx
+ * with one of 2^bits buckets and rehashes stream_list into it
+ *
+ * within a bucket, streams keep their stream_list order, so that of
+ * two streams with the same ssrc the one added last is still found
+ */
+
+static err_status_t
+srtp_stream_table_resize(srtp_t ctx, unsigned int bits) {
+  srtp_stream_ctx_t **table, **tail, *stream;
+  unsigned int i;
+
+  table = (srtp_stream_ctx_t **) crypto_alloc(sizeof(*table) << bits);
+  if (table == NULL)
+    return err_status_alloc_fail;
+  for (i = 0; i < (1U << bits); i++)
+    table[i] = NULL;
+
+  for (stream = ctx->stream_list; stream != NULL; stream = stream->next) {
+    tail = &table[srtp_stream_hash(stream->ssrc, bits)];
+    while (*tail != NULL)
+      tail = &(*tail)->next_in_bucket;
+    stream->next_in_bucket = NULL;
+    *tail = stream;
+  }
+
+  if (ctx->stream_table != NULL)
+    crypto_free(ctx->stream_table);
+  ctx->stream_table = table;
+  ctx->stream_table_bits = bits;
+
+  return err_status_ok;
+}
+
+/*
+ * srtp_insert_stream(ctx, stream) adds stream to the head of
+ * stream_list and to its stream_table bucket, doubling the table once
+ * there are more streams than buckets
+ *
+ * this function cannot fail: if the table can't grow, the old one
+ * still works, just with longer chains
+ */
+
+static void
+srtp_insert_stream(srtp_t ctx, srtp_stream_ctx_t *stream) {
+  unsigned int bucket;
+
+  stream->next = ctx->stream_list;
+  ctx->stream_list = stream;
+  ctx->num_streams++;
+
+  if (ctx->num_streams > (1U << ctx->stream_table_bits) &&
+      ctx->stream_table_bits < 24 &&
+      srtp_stream_table_resize(ctx, ctx->stream_table_bits + 1) == err_status_ok)
+    return;  /* the rehash has placed the new stream too */
+
+  bucket = srtp_stream_hash(stream->ssrc, ctx->stream_table_bits);
+  stream->next_in_bucket = ctx->stream_table[bucket];
+  ctx->stream_table[bucket] = stream;
+}
+
 /*
  * srtp_get_stream(ssrc) returns a pointer to the stream corresponding
  * to ssrc, or NULL if no stream exists for that ssrc
@@ -1160,12 +1273,12 @@ srtp_stream_ctx_t *
 srtp_get_stream(srtp_t srtp, uint32_t ssrc) {
   srtp_stream_ctx_t *stream;
 
-  /* walk down list until ssrc is found */
-  stream = srtp->stream_list;
+  /* walk down the ssrc's bucket until ssrc is found */
+  stream = srtp->stream_table[srtp_stream_hash(ssrc, srtp->stream_table_bits)];
   while (stream != NULL) {
     if (stream->ssrc == ssrc)
       return stream;
-    stream = stream->next;
+    stream = stream->next_in_bucket;
   }
   
   /* we haven't found our ssrc, so return a null */
@@ -1200,6 +1313,7 @@ srtp_dealloc(srtp_t session) {
   }
 
   /* deallocate session context */
+  crypto_free(session->stream_table);
   crypto_free(session);
 
   return err_status_ok;
@@ -1253,8 +1367,7 @@ srtp_add_stream(srtp_t session,
     session->stream_template->direction = dir_srtp_receiver;
     break;
   case (ssrc_specific):
-    tmp->next = session->stream_list;
-    session->stream_list = tmp;
+    srtp_insert_stream(session, tmp);
     break;
   case (ssrc_undefined):
   default:
@@ -1287,6 +1400,13 @@ srtp_create(srtp_t *session,               /* handle for session     */
    */
   ctx->stream_template = NULL;
   ctx->stream_list = NULL;
+  ctx->stream_table = NULL;
+  ctx->num_streams = 0;
+  stat = srtp_stream_table_resize(ctx, SRTP_STREAM_TABLE_MIN_BITS);
+  if (stat) {
+    crypto_free(ctx);
+    return stat;
+  }
   while (policy != NULL) {    
 
     stat = srtp_add_stream(ctx, policy);
@@ -1306,23 +1426,27 @@ srtp_create(srtp_t *session,               /* handle for session     */
 
 err_status_t
 srtp_remove_stream(srtp_t session, uint32_t ssrc) {
-  srtp_stream_ctx_t *stream, *last_stream;
+  srtp_stream_ctx_t *stream, **link;
 
   /* sanity check arguments */
   if (session == NULL)
     return err_status_bad_param;
 
-  /* find stream in list; complain if not found */
-  last_stream = stream = session->stream_list;
-  while ((stream != NULL) && (ssrc != stream->ssrc)) {
-    last_stream = stream;
-    stream = stream->next;
-  }
-  if (stream == NULL)
+  /* find stream in its bucket; complain if not found */
+  link = &session->stream_table[srtp_stream_hash(ssrc, session->stream_table_bits)];
+  while ((*link != NULL) && (ssrc != (*link)->ssrc))
+    link = &(*link)->next_in_bucket;
+  if (*link == NULL)
     return err_status_no_ctx;
+  stream = *link;
 
-  /* remove stream from the list */
-  last_stream->next = stream->next;
+  /* remove stream from the bucket and from the list */
+  *link = stream->next_in_bucket;
+  link = &session->stream_list;
+  while (*link != stream)
+    link = &(*link)->next;
+  *link = stream->next;
+  session->num_streams--;
 
   return srtp_stream_uninit_and_dealloc(stream, session->stream_template);
 }
@@ -1476,8 +1600,7 @@ srtp_protect_rtcp(srtp_t ctx, void *rtcp_hdr, int *pkt_octet_len) {
 	return status;
       
       /* add new stream to the head of the stream_list */
-      new_stream->next = ctx->stream_list;
-      ctx->stream_list = new_stream;
+      srtp_insert_stream(ctx, new_stream);
       
       /* set stream (the pointer used in this function) */
       stream = new_stream;
@@ -1553,7 +1676,7 @@ srtp_protect_rtcp(srtp_t ctx, void *rtcp_hdr, int *pkt_octet_len) {
   /* 
    * if we're using rindael counter mode, set nonce and seq 
    */
-  if (stream->rtcp_cipher->type == &aes_icm) {
+  if (aes_icm_is_type(stream->rtcp_cipher->type)) {
     v128_t iv;
     
     iv.v32[0] = 0;
@@ -1750,7 +1873,7 @@ srtp_unprotect_rtcp(srtp_t ctx, void *srtcp_hdr, int *pkt_octet_len) {
   /* 
    * if we're using aes counter mode, set nonce and seq 
    */
-  if (stream->rtcp_cipher->type == &aes_icm) {
+  if (aes_icm_is_type(stream->rtcp_cipher->type)) {
     v128_t iv;
 
     iv.v32[0] = 0;
@@ -1858,8 +1981,7 @@ srtp_unprotect_rtcp(srtp_t ctx, void *srtcp_hdr, int *pkt_octet_len) {
       return status;
     
     /* add new stream to the head of the stream_list */
-    new_stream->next = ctx->stream_list;
-    ctx->stream_list = new_stream;
+    srtp_insert_stream(ctx, new_stream);
     
     /* set stream (the pointer used in this function) */
     stream = new_stream;
@@ -60,6 +60,9 @@ test_replay_dbx(int num_trials, unsigned long ws);
 double
 rdbx_check_adds_per_second(int num_trials, unsigned long ws);
 
+double
+rdbx_check_adds_per_second_reordered(int num_trials, unsigned long ws);
+
 void
 usage(char *prog_name) {
   printf("usage: %s [ -t | -v ]\n", prog_name);
@@ -123,6 +126,10 @@ main (int argc, char *argv[]) {
     printf("rdbx_check/replay_adds per second (ws=128): %e\n", rate);
 	  rate = rdbx_check_adds_per_second(1 << 18, 1024);
     printf("rdbx_check/replay_adds per second (ws=1024): %e\n", rate);
+	  rate = rdbx_check_adds_per_second_reordered(1 << 18, 128);
+    printf("reordered rdbx_check/replay_adds per second (ws=128): %e\n", rate);
+	  rate = rdbx_check_adds_per_second_reordered(1 << 18, 1024);
+    printf("reordered rdbx_check/replay_adds per second (ws=1024): %e\n", rate);
   }
   
   return 0;
@@ -277,6 +284,43 @@ test_replay_dbx(int num_trials, unsigned long ws) {
   }
   printf("passed\n");
 
+  /*
+   * test reordered insertion: each index that is still inside the
+   * window must be accepted once and rejected as a replay right after
+   */
+  rdbx_uninit(&rdbx);
+
+  if (rdbx_init(&rdbx, ws) != err_status_ok) {
+    printf("replay_init failed\n");
+    return err_status_init_fail;
+  }
+
+  ut_init(&utc);
+
+  printf("\ttesting reordered insertion and replays...");
+  for (idx=0; idx < (uint32_t)num_trials; idx++) {
+    int delta;
+    xtd_seq_num_t est;
+
+    ircvd = ut_next_index(&utc);
+    delta = index_guess(&rdbx.index, &est, ircvd);
+    status = rdbx_check(&rdbx, delta);
+    if (status == err_status_replay_old)
+      continue;
+    if (status != err_status_ok) {
+      printf("replay_check failed at index %u\n", ircvd);
+      return err_status_algo_fail;
+    }
+    if (rdbx_add_index(&rdbx, delta) != err_status_ok) {
+      printf("rdbx_add_index failed at index %u\n", ircvd);
+      return err_status_algo_fail;
+    }
+    status = rdbx_check_expect_failure(&rdbx, ircvd);
+    if (status)
+      return status;
+  }
+  printf("passed\n");
+
   /*
    * test a replay condition close to zero.
    */
@@ -343,3 +387,56 @@ rdbx_check_adds_per_second(int num_trials, unsigned long ws) {
 
   return (double) CLOCKS_PER_SEC * num_trials / timer;
 }
+
+/*
+ * rdbx_check_adds_per_second_reordered(...) times the same work on
+ * the indices of a ut_connection, so that the window has to cope
+ * with reordering; the indices are generated before the timer starts
+ */
+
+double
+rdbx_check_adds_per_second_reordered(int num_trials, unsigned long ws) {
+  uint32_t i;
+  int delta;
+  rdbx_t rdbx;
+  xtd_seq_num_t est;
+  clock_t timer;
+  int failures;                    /* count number of failures        */
+  uint32_t *seq;
+  ut_connection utc;
+
+  seq = (uint32_t *) malloc(num_trials * sizeof(uint32_t));
+  if (seq == NULL) {
+    printf("malloc failed\n");
+    exit(1);
+  }
+  ut_init(&utc);
+  for (i=0; i < (uint32_t)num_trials; i++)
+    seq[i] = ut_next_index(&utc);
+
+  if (rdbx_init(&rdbx, ws) != err_status_ok) {
+    printf("replay_init failed\n");
+    exit(1);
+  }
+
+  failures = 0;
+  timer = clock();
+  for(i=0; i < (uint32_t)num_trials; i++) {
+
+    delta = index_guess(&rdbx.index, &est, seq[i]);
+
+    if (rdbx_check(&rdbx, delta) != err_status_ok)
+      ++failures;
+    else
+      if (rdbx_add_index(&rdbx, delta) != err_status_ok)
+	++failures;
+  }
+  timer = clock() - timer;
+
+  printf("number of failures: %d \n", failures);
+
+  rdbx_uninit(&rdbx);
+  free(seq);
+
+  return (double) CLOCKS_PER_SEC * num_trials / timer;
+}
@@ -68,6 +68,12 @@ srtp_create_big_policy(srtp_policy_t **list);
 err_status_t
 srtp_test_remove_stream(void);
 
+err_status_t
+srtp_test_batch(void);
+
+err_status_t
+srtp_test_many_streams(void);
+
 double
 srtp_bits_per_second(int msg_len_octets, const srtp_policy_t *policy);
 
@@ -287,6 +293,28 @@ main (int argc, char *argv[]) {
       printf("failed\n");
       exit(1);
     }
+
+    /*
+     * test the functions srtp_protect_batch() and srtp_unprotect_batch()
+     */
+    printf("testing srtp_protect_batch() and srtp_unprotect_batch()...");
+    if (srtp_test_batch() == err_status_ok)
+      printf("passed\n");
+    else {
+      printf("failed\n");
+      exit(1);
+    }
+
+    /*
+     * test stream lookup and removal in sessions with many streams
+     */
+    printf("testing sessions with many streams...");
+    if (srtp_test_many_streams() == err_status_ok)
+      printf("passed\n");
+    else {
+      printf("failed\n");
+      exit(1);
+    }
   }
   
   if (do_timing_test) {
@@ -1310,6 +1338,204 @@ srtp_test_remove_stream() {
   return err_status_ok;  
 }
 
+/*
+ * srtp_test_batch() checks that srtp_protect_batch() produces the
+ * same packets as calling srtp_protect() on each of them, and that
+ * srtp_unprotect_batch() reports the status of every packet
+ */
+
+#define BATCH_NUM_PACKETS 8
+
+err_status_t
+srtp_test_batch() {
+  srtp_policy_t policy;
+  srtp_t srtp_snd, srtp_batch_snd, srtp_recv;
+  srtp_packet_t pkts[BATCH_NUM_PACKETS];
+  srtp_hdr_t *ref[BATCH_NUM_PACKETS];
+  srtp_hdr_t *batch[BATCH_NUM_PACKETS];
+  int rtp_len = 12 + 160;   /* RTP header and payload */
+  int len;
+  int i;
+  err_status_t status;
+
+  crypto_policy_set_rtp_default(&policy.rtp);
+  crypto_policy_set_rtcp_default(&policy.rtcp);
+  policy.ssrc.type  = ssrc_specific;
+  policy.ssrc.value = 0xcafebabe;
+  policy.key  = test_key;
+  policy.ekt = NULL;
+  policy.window_size = 128;
+  policy.allow_repeat_tx = 0;
+  policy.next = NULL;
+
+  status = srtp_create(&srtp_snd, &policy);
+  if (status)
+    return status;
+  status = srtp_create(&srtp_batch_snd, &policy);
+  if (status)
+    return status;
+  status = srtp_create(&srtp_recv, &policy);
+  if (status)
+    return status;
+
+  /* protect the reference packets one at a time */
+  for (i = 0; i < BATCH_NUM_PACKETS; i++) {
+    ref[i] = srtp_create_test_packet(rtp_len - 12, 0xcafebabe);
+    batch[i] = srtp_create_test_packet(rtp_len - 12, 0xcafebabe);
+    if (ref[i] == NULL || batch[i] == NULL)
+      return err_status_alloc_fail;
+    ref[i]->seq = batch[i]->seq = htons(0x1234 + i);
+
+    len = rtp_len;
+    status = srtp_protect(srtp_snd, ref[i], &len);
+    if (status)
+      return status;
+  }
+
+  /* protect the same packets as a batch and compare */
+  for (i = 0; i < BATCH_NUM_PACKETS; i++) {
+    pkts[i].hdr = batch[i];
+    pkts[i].len = rtp_len;
+  }
+  status = srtp_protect_batch(srtp_batch_snd, pkts, BATCH_NUM_PACKETS);
+  if (status)
+    return status;
+  for (i = 0; i < BATCH_NUM_PACKETS; i++) {
+    if (pkts[i].status || pkts[i].len != len)
+      return err_status_fail;
+    if (octet_string_is_eq((uint8_t *)batch[i], (uint8_t *)ref[i], len))
+      return err_status_fail;
+  }
+
+  /* unprotect the batch */
+  status = srtp_unprotect_batch(srtp_recv, pkts, BATCH_NUM_PACKETS);
+  if (status)
+    return status;
+  for (i = 0; i < BATCH_NUM_PACKETS; i++)
+    if (pkts[i].status || pkts[i].len != rtp_len)
+      return err_status_fail;
+
+  /* the reference packets are replays, so each one must be rejected */
+  for (i = 0; i < BATCH_NUM_PACKETS; i++) {
+    pkts[i].hdr = ref[i];
+    pkts[i].len = len;
+  }
+  status = srtp_unprotect_batch(srtp_recv, pkts, BATCH_NUM_PACKETS);
+  if (status != err_status_replay_fail)
+    return err_status_fail;
+  for (i = 0; i < BATCH_NUM_PACKETS; i++)
+    if (pkts[i].status != err_status_replay_fail)
+      return err_status_fail;
+
+  for (i = 0; i < BATCH_NUM_PACKETS; i++) {
+    free(ref[i]);
+    free(batch[i]);
+  }
+
+  status = srtp_dealloc(srtp_snd);
+  if (status)
+    return status;
+  status = srtp_dealloc(srtp_batch_snd);
+  if (status)
+    return status;
+  return srtp_dealloc(srtp_recv);
+}
+
+/*
+ * srtp_test_many_streams() lets the templates of a sender and a
+ * receiver clone a few hundred streams, which grows the receiver's
+ * stream table several times, and checks that every packet is handled
+ * by the stream for its own ssrc.  it then removes a third of the
+ * streams, including the one added last, and checks that lookups of
+ * the rest are unaffected
+ */
+
+#define MANY_STREAMS_NUM 300
+
+err_status_t
+srtp_test_many_streams() {
+  srtp_policy_t policy;
+  srtp_t srtp_snd, srtp_recv;
+  srtp_hdr_t *hdr;
+  srtp_stream_t stream;
+  int rtp_len = 12 + 160;   /* RTP header and payload */
+  int len;
+  int i, j;
+  uint32_t ssrc;
+  err_status_t status;
+  extern srtp_stream_t srtp_get_stream(srtp_t srtp, uint32_t ssrc);
+
+  crypto_policy_set_rtp_default(&policy.rtp);
+  crypto_policy_set_rtcp_default(&policy.rtcp);
+  policy.ssrc.type  = ssrc_any_outbound;
+  policy.ssrc.value = 0;
+  policy.key  = test_key;
+  policy.ekt = NULL;
+  policy.window_size = 128;
+  policy.allow_repeat_tx = 0;
+  policy.next = NULL;
+
+  status = srtp_create(&srtp_snd, &policy);
+  if (status)
+    return status;
+  policy.ssrc.type = ssrc_any_inbound;
+  status = srtp_create(&srtp_recv, &policy);
+  if (status)
+    return status;
+
+  for (j = 0; j < 2; j++) {
+    for (i = 0; i < MANY_STREAMS_NUM; i++) {
+      /* after the removals below, only send on the remaining streams */
+      if (j && (i % 3 == 0 || i == MANY_STREAMS_NUM - 1))
+        continue;
+      ssrc = 0x1000 + i * 0x10000;
+      hdr = srtp_create_test_packet(rtp_len - 12, ssrc);
+      if (hdr == NULL)
+        return err_status_alloc_fail;
+      hdr->seq = htons(0x1234 + j);
+
+      len = rtp_len;
+      status = srtp_protect(srtp_snd, hdr, &len);
+      if (status)
+        return status;
+      status = srtp_unprotect(srtp_recv, hdr, &len);
+      if (status)
+        return status;
+      if (len != rtp_len || ((uint8_t *)hdr)[len - 1] != 0xab)
+        return err_status_fail;
+      free(hdr);
+    }
+
+    if (j)
+      break;
+
+    for (i = 0; i < MANY_STREAMS_NUM; i++) {
+      ssrc = htonl(0x1000 + i * 0x10000);
+      stream = srtp_get_stream(srtp_recv, ssrc);
+      if (stream == NULL || stream->ssrc != ssrc)
+        return err_status_fail;
+    }
+
+    for (i = 0; i < MANY_STREAMS_NUM; i++)
+      if (i % 3 == 0 || i == MANY_STREAMS_NUM - 1) {
+        status = srtp_remove_stream(srtp_recv, htonl(0x1000 + i * 0x10000));
+        if (status)
+          return status;
+      }
+
+    for (i = 0; i < MANY_STREAMS_NUM; i++) {
+      stream = srtp_get_stream(srtp_recv, htonl(0x1000 + i * 0x10000));
+      if ((stream == NULL) != (i % 3 == 0 || i == MANY_STREAMS_NUM - 1))
+        return err_status_fail;
+    }
+  }
+
+  status = srtp_dealloc(srtp_snd);
+  if (status)
+    return status;
+  return srtp_dealloc(srtp_recv);
+}
+
 /*
  * srtp policy definitions - these definitions are used above
  */
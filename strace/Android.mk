@@ -73,6 +73,7 @@ LOCAL_SRC_FILES := \
     fetch_struct_flock.c \
     file.c \
     file_handle.c \
+    filter_seccomp.c \
     flock.c \
     futex.c \
     getcpu.c \
@@ -108,6 +109,7 @@ LOCAL_SRC_FILES := \
     mtd.c \
     net.c \
     open.c \
+    output_thread.c \
     pathtrace.c \
     perf.c \
     personality.c \
@@ -40,13 +40,36 @@ struct call_counts {
 	/* time may be total latency or system time */
 	struct timeval time;
 	int calls, errors;
+	/* wall clock latencies, see latency_bucket() */
+	unsigned int *histogram;
 };
 
+/*
+ * Bucket 0 counts calls that took less than 1 usec, bucket N > 0 those
+ * that took 2^(N-1) to 2^N - 1 usecs, the last bucket also takes all
+ * the longer ones.
+ */
+#define LATENCY_BUCKETS 32
+
 static struct call_counts *countv[SUPPORTED_PERSONALITIES];
 #define counts (countv[current_personality])
 
 static struct timeval shortest = { 1000000, 0 };
 
+static unsigned int
+latency_bucket(const struct timeval *tv)
+{
+	unsigned long long usecs =
+		(unsigned long long) tv->tv_sec * 1000000 + tv->tv_usec;
+	unsigned int bucket = 0;
+
+	while (usecs && bucket < LATENCY_BUCKETS - 1) {
+		usecs >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
 void
 count_syscall(struct tcb *tcp, const struct timeval *syscall_exiting_tv)
 {
@@ -69,6 +92,13 @@ count_syscall(struct tcb *tcp, const struct timeval *syscall_exiting_tv)
 	/* tv = wall clock time spent while in syscall */
 	tv_sub(tv, syscall_exiting_tv, &tcp->etime);
 
+	if (count_histogram) {
+		if (!cc->histogram)
+			cc->histogram = xcalloc(LATENCY_BUCKETS,
+						sizeof(*cc->histogram));
+		cc->histogram[latency_bucket(tv)]++;
+	}
+
 	/* Spent more wall clock time than spent system time? (usually yes) */
 	if (tv_cmp(tv, &tcp->dtime) > 0) {
 		static struct timeval one_tick = { -1, 0 };
@@ -150,6 +180,36 @@ void set_overhead(int n)
 	overhead.tv_usec = n % 1000000;
 }
 
+static void
+latency_histogram(FILE *outf, const char *name, const unsigned int *histogram)
+{
+	static const char stars[] = "****************************************";
+	unsigned int i, first, last, max = 0;
+
+	for (first = 0; !histogram[first]; first++)
+		;
+	for (last = LATENCY_BUCKETS - 1; !histogram[last]; last--)
+		;
+	for (i = first; i <= last; i++)
+		if (histogram[i] > max)
+			max = histogram[i];
+
+	fprintf(outf, "\n%s:\n%22s %9s\n", name, "usecs", "calls");
+	for (i = first; i <= last; i++) {
+		unsigned long long lo = i ? 1ULL << (i - 1) : 0;
+		int width = (int) ((sizeof(stars) - 1) *
+				   (unsigned long long) histogram[i] / max);
+
+		if (i == LATENCY_BUCKETS - 1)
+			fprintf(outf, "%10llu ->%9s", lo, "");
+		else
+			fprintf(outf, "%10llu ->%9llu",
+				lo, i ? (lo << 1) - 1 : 0);
+		fprintf(outf, " %9u |%-40.*s|\n",
+			histogram[i], width, stars);
+	}
+}
+
 static void
 call_summary_pers(FILE *outf)
 {
@@ -210,7 +270,6 @@ call_summary_pers(FILE *outf)
 				error_str, sysent[idx].sys_name);
 		}
 	}
-	free(sorted_count);
 
 	fprintf(outf, "%6.6s %11.11s %11.11s %9.9s %9.9s %s\n",
 		dashes, dashes, dashes, dashes, dashes, dashes);
@@ -220,6 +279,17 @@ call_summary_pers(FILE *outf)
 	fprintf(outf, "%6.6s %11.6f %11.11s %9u %9.9s %s\n",
 		"100.00", float_tv_cum, "",
 		call_cum, error_str, "total");
+
+	if (count_histogram && counts) {
+		for (i = 0; i < nsyscalls; i++) {
+			int idx = sorted_count[i];
+
+			if (counts[idx].histogram)
+				latency_histogram(outf, sysent[idx].sys_name,
+						  counts[idx].histogram);
+		}
+	}
+	free(sorted_count);
 }
 
 void
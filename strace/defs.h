@@ -439,6 +439,7 @@ extern bool debug_flag;
 extern bool Tflag;
 extern bool iflag;
 extern bool count_wallclock;
+extern bool count_histogram;
 extern unsigned int qflag;
 extern bool not_failing_only;
 extern unsigned int show_fd_path;
@@ -453,6 +454,11 @@ extern unsigned followfork;
 extern bool stack_trace_enabled;
 #endif
 extern unsigned ptrace_setoptions;
+/* write output files from a separate thread, see output_thread.c */
+extern bool async_output;
+/* use a seccomp filter to skip stops for syscalls that are not traced */
+extern bool seccomp_filtering;
+extern bool seccomp_before_sysentry;
 extern unsigned max_strlen;
 extern unsigned os_release;
 #undef KERNEL_VERSION
@@ -488,6 +494,9 @@ int strace_vfprintf(FILE *fp, const char *fmt, va_list args);
 extern void set_sortby(const char *);
 extern void set_overhead(int);
 extern void qualify(const char *);
+extern void check_seccomp_filter(bool);
+extern void init_seccomp_filter(void);
+extern FILE *async_output_wrap(FILE *);
 extern void print_pc(struct tcb *);
 extern int trace_syscall(struct tcb *);
 extern void count_syscall(struct tcb *, const struct timeval *);
@@ -511,6 +520,9 @@ extern int umoven_or_printaddr(struct tcb *, long, unsigned int, void *);
 extern int umove_ulong_or_printaddr(struct tcb *, long, unsigned long *);
 extern int umove_ulong_array_or_printaddr(struct tcb *, long, unsigned long *, size_t);
 extern int umovestr(struct tcb *, long, unsigned int, char *);
+struct iovec;
+extern void umove_prefetch(struct tcb *, const struct iovec *, unsigned int);
+extern void invalidate_umove_cache(void);
 extern int upeek(int pid, long, long *);
 
 #if defined ALPHA || defined IA64 || defined MIPS \
@@ -555,6 +567,13 @@ extern int printllval(struct tcb *, const char *, int)
 extern void printaddr(long);
 extern void printxvals(const unsigned int, const char *, const struct xlat *, ...);
 #define printxval(xlat, val, dflt) printxvals(val, dflt, xlat, NULL)
+extern void printxval_searchn(const struct xlat *, size_t, unsigned int, const char *);
+/*
+ * Wrapper around printxval_searchn that passes ARRAY_SIZE - 1
+ * as the number of elements of the xlat array, skipping XLAT_END.
+ */
+#define printxval_search(xlat__, val__, dflt__) \
+	printxval_searchn(xlat__, ARRAY_SIZE(xlat__) - 1, val__, dflt__)
 extern int printargs(struct tcb *);
 extern int printargs_lu(struct tcb *);
 extern int printargs_ld(struct tcb *);
@@ -170,7 +170,7 @@ keycode_ioctl(struct tcb *tcp, long arg)
 		return 0;
 
 	tprintf(", [%u, ", keycode[0]);
-	printxval(evdev_keycode, keycode[1], "KEY_???");
+	printxval_search(evdev_keycode, keycode[1], "KEY_???");
 	tprints("]");
 	return 1;
 }
@@ -194,7 +194,7 @@ keycode_V2_ioctl(struct tcb *tcp, long arg)
 		unsigned int i;
 
 		tprintf(", index=%" PRIu16 ", keycode=", ike.index);
-		printxval(evdev_keycode, ike.keycode, "KEY_???");
+		printxval_search(evdev_keycode, ike.keycode, "KEY_???");
 		tprints(", scancode=[");
 		for (i = 0; i < ARRAY_SIZE(ike.scancode); i++) {
 			if (i > 0)
@@ -229,8 +229,9 @@ getid_ioctl(struct tcb *tcp, long arg)
 }
 
 static int
-decode_bitset(struct tcb *tcp, long arg, const struct xlat decode_nr[],
-	      const unsigned int max_nr, const char *dflt)
+decode_bitset_(struct tcb *tcp, long arg, const struct xlat decode_nr[],
+	       const unsigned int max_nr, const char *dflt,
+	       size_t decode_nr_size)
 {
 	if (!verbose(tcp))
 		return 0;
@@ -252,7 +253,7 @@ decode_bitset(struct tcb *tcp, long arg, const struct xlat decode_nr[],
 	if (i < 0) {
 		tprints(" 0 ");
 	} else {
-		printxval(decode_nr, i, dflt);
+		printxval_searchn(decode_nr, decode_nr_size, i, dflt);
 
 		while ((i = next_set_bit(decoded_arg, i + 1, size)) > 0) {
 			if (abbrev(tcp) && bit_displayed >= 3) {
@@ -260,7 +261,7 @@ decode_bitset(struct tcb *tcp, long arg, const struct xlat decode_nr[],
 				break;
 			}
 			tprints(", ");
-			printxval(decode_nr, i, dflt);
+			printxval_searchn(decode_nr, decode_nr_size, i, dflt);
 			bit_displayed++;
 		}
 	}
@@ -270,6 +271,11 @@ decode_bitset(struct tcb *tcp, long arg, const struct xlat decode_nr[],
 	return 1;
 }
 
+/* The decode_nr tables are sorted, see xlat/gen.sh */
+#define decode_bitset(tcp_, arg_, decode_nr_, max_nr_, dflt_) \
+	decode_bitset_((tcp_), (arg_), (decode_nr_), (max_nr_), \
+		       (dflt_), ARRAY_SIZE(decode_nr_) - 1)
+
 #ifdef EVIOCGMTSLOTS
 static int
 mtslots_ioctl(struct tcb *tcp, const unsigned int code, long arg)
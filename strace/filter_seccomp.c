@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2016 The strace developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * --seccomp-bpf: let the kernel skip the syscalls we are not interested in.
+ *
+ * Before exec, the tracee installs a seccomp filter that returns
+ * SECCOMP_RET_TRACE for the syscalls selected by -e trace=... and
+ * SECCOMP_RET_ALLOW for the rest.  The tracee is then restarted with
+ * PTRACE_CONT instead of PTRACE_SYSCALL whenever it is not inside a traced
+ * syscall, so it only stops for the syscalls that are going to be printed.
+ *
+ * The filter is inherited across fork and exec and cannot be removed, and a
+ * SECCOMP_RET_TRACE syscall fails with ENOSYS when there is no tracer, so all
+ * children have to be followed and the mode is not usable with -p or -b.
+ */
+
+#include "defs.h"
+#include "syscall.h"
+
+#if defined HAVE_PRCTL && defined HAVE_LINUX_FILTER_H \
+ && defined HAVE_LINUX_SECCOMP_H
+# include <sys/prctl.h>
+# include <linux/audit.h>
+# include <linux/filter.h>
+# include <linux/seccomp.h>
+
+/*
+ * The filter only knows the numbering of the native personality,
+ * syscalls made in other personalities are all traced.  Architectures
+ * with socketcall/ipc subcalls or shuffled syscall numbers are not
+ * supported, their sysent indices are not syscall numbers.
+ */
+# if defined X86_64 && defined AUDIT_ARCH_X86_64
+#  define FILTER_AUDIT_ARCH AUDIT_ARCH_X86_64
+# elif defined AARCH64 && defined AUDIT_ARCH_AARCH64
+#  define FILTER_AUDIT_ARCH AUDIT_ARCH_AARCH64
+# endif
+#endif
+
+bool seccomp_filtering;
+bool seccomp_before_sysentry;
+
+#ifdef FILTER_AUDIT_ARCH
+
+static struct sock_filter *filter;
+static unsigned short filter_len;
+static unsigned short filter_size;
+
+static void
+add_insn(uint16_t code, uint8_t jt, uint8_t jf, uint32_t k)
+{
+	if (filter_len == BPF_MAXINSNS)
+		error_msg_and_die("seccomp filter is too long");
+
+	if (filter_len == filter_size) {
+		filter_size = filter_size ? filter_size * 2 : 64;
+		if (filter_size > BPF_MAXINSNS)
+			filter_size = BPF_MAXINSNS;
+		filter = xreallocarray(filter, filter_size, sizeof(*filter));
+	}
+
+	filter[filter_len].code = code;
+	filter[filter_len].jt = jt;
+	filter[filter_len].jf = jf;
+	filter[filter_len].k = k;
+	filter_len++;
+}
+
+static bool
+traced_by_filter(unsigned int scno)
+{
+	/* hide_log_until_execve is cleared on execve entry */
+	return (qual_flags[scno] & QUAL_TRACE)
+	       || SEN_execve == sysent[scno].sen;
+}
+
+static void
+build_seccomp_filter(void)
+{
+	const unsigned int n = nsyscalls;
+	unsigned int lo, hi;
+
+	add_insn(BPF_LD | BPF_W | BPF_ABS, 0, 0,
+		 offsetof(struct seccomp_data, arch));
+	add_insn(BPF_JMP | BPF_JEQ | BPF_K, 1, 0, FILTER_AUDIT_ARCH);
+	add_insn(BPF_RET | BPF_K, 0, 0, SECCOMP_RET_TRACE);
+	add_insn(BPF_LD | BPF_W | BPF_ABS, 0, 0,
+		 offsetof(struct seccomp_data, nr));
+
+	/*
+	 * Numbers strace has no entry for are always traced,
+	 * as they are without the filter.
+	 */
+	add_insn(BPF_JMP | BPF_JGE | BPF_K, 0, 1, n);
+	add_insn(BPF_RET | BPF_K, 0, 0, SECCOMP_RET_TRACE);
+
+	/* One test per run of consecutive traced syscalls. */
+	for (lo = 0; lo < n; lo = hi) {
+		if (!traced_by_filter(lo)) {
+			hi = lo + 1;
+			continue;
+		}
+		for (hi = lo + 1; hi < n && traced_by_filter(hi); hi++)
+			;
+		if (hi - lo == 1) {
+			add_insn(BPF_JMP | BPF_JEQ | BPF_K, 0, 1, lo);
+		} else {
+			add_insn(BPF_JMP | BPF_JGE | BPF_K, 0, 2, lo);
+			add_insn(BPF_JMP | BPF_JGE | BPF_K, 1, 0, hi);
+		}
+		add_insn(BPF_RET | BPF_K, 0, 0, SECCOMP_RET_TRACE);
+	}
+
+	add_insn(BPF_RET | BPF_K, 0, 0, SECCOMP_RET_ALLOW);
+
+	if (debug_flag)
+		error_msg("seccomp filter has %u instructions", filter_len);
+}
+
+#endif /* FILTER_AUDIT_ARCH */
+
+/*
+ * Called after option parsing.  Turns seccomp_filtering off if it cannot
+ * be used, otherwise builds the filter that init_seccomp_filter()
+ * installs in the tracee.
+ */
+void
+check_seccomp_filter(bool attaching)
+{
+	if (!seccomp_filtering)
+		return;
+
+#ifdef FILTER_AUDIT_ARCH
+	if (attaching) {
+		error_msg("--seccomp-bpf cannot be used with -p, ignored");
+		seccomp_filtering = false;
+		return;
+	}
+	if (os_release < KERNEL_VERSION(3,5,0)) {
+		error_msg("--seccomp-bpf requires Linux 3.5 or later, ignored");
+		seccomp_filtering = false;
+		return;
+	}
+
+	/*
+	 * Since Linux 4.8 the seccomp stop replaces the syscall-entry stop,
+	 * before that it comes first and the syscall-entry stop follows.
+	 */
+	seccomp_before_sysentry = os_release < KERNEL_VERSION(4,8,0);
+
+	build_seccomp_filter();
+#else
+	error_msg("--seccomp-bpf is not supported on this architecture, "
+		  "ignored");
+	seccomp_filtering = false;
+#endif
+}
+
+/*
+ * Called in the tracee just before exec, once the tracer has set
+ * PTRACE_O_TRACESECCOMP: a SECCOMP_RET_TRACE syscall made before that
+ * would fail with ENOSYS.
+ */
+void
+init_seccomp_filter(void)
+{
+#ifdef FILTER_AUDIT_ARCH
+	struct sock_fprog prog = {
+		.len = filter_len,
+		.filter = filter
+	};
+
+	/*
+	 * Without CAP_SYS_ADMIN a filter can only be installed with
+	 * no_new_privs set, which stops exec of set-user-ID programs
+	 * from raising privileges.  Only set it when it is required.
+	 */
+	if (prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &prog) == 0)
+		return;
+	if (errno != EACCES)
+		perror_msg_and_die("prctl(PR_SET_SECCOMP)");
+	if (prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) < 0)
+		perror_msg_and_die("prctl(PR_SET_NO_NEW_PRIVS)");
+	if (prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &prog) < 0)
+		perror_msg_and_die("prctl(PR_SET_SECCOMP)");
+#endif
+}
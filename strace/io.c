@@ -61,6 +61,50 @@ SYS_FUNC(write)
  * data_size limits the cumulative size of printed data.
  * Example: recvmsg returing a short read.
  */
+/*
+ * Fetch the iovec array and the parts of the buffers printstr will show
+ * with one process_vm_readv, rather than two syscalls per element.
+ */
+static void
+prefetch_iov(struct tcb *tcp, unsigned long addr, unsigned long end,
+	     unsigned long data_size)
+{
+	struct iovec ranges[32];
+	const unsigned long sizeof_iov = current_wordsize * 2;
+	unsigned long iov[2];
+	unsigned long cur;
+	unsigned int n = 0;
+
+	ranges[n].iov_base = (void *) addr;
+	ranges[n].iov_len = end - addr;
+	umove_prefetch(tcp, ranges, ++n);
+
+	for (cur = addr; cur < end && data_size && n < ARRAY_SIZE(ranges);
+	     cur += sizeof_iov) {
+		unsigned long len;
+
+		if (current_wordsize < sizeof(iov[0])) {
+			uint32_t iov32[2];
+
+			if (umoven(tcp, cur, sizeof(iov32), iov32) < 0)
+				break;
+			iov[0] = iov32[0];
+			iov[1] = iov32[1];
+		} else if (umoven(tcp, cur, sizeof(iov), iov) < 0)
+			break;
+
+		len = iov[1] < data_size ? iov[1] : data_size;
+		data_size -= len;
+		if (len > max_strlen)
+			len = max_strlen;
+		ranges[n].iov_base = (void *) iov[0];
+		ranges[n].iov_len = len;
+		n++;
+	}
+
+	umove_prefetch(tcp, ranges + 1, n - 1);
+}
+
 void
 tprint_iov_upto(struct tcb *tcp, unsigned long len, unsigned long addr, int decode_iov, unsigned long data_size)
 {
@@ -86,6 +130,9 @@ tprint_iov_upto(struct tcb *tcp, unsigned long len, unsigned long addr, int deco
 	} else {
 		abbrev_end = end;
 	}
+	if (decode_iov)
+		prefetch_iov(tcp, addr, abbrev_end < end ? abbrev_end : end,
+			     data_size);
 	tprints("[");
 	for (cur = addr; cur < end; cur += sizeof_iov) {
 		if (cur > addr)
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2016 The strace developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * --async-output: write the -o output files from a separate thread.
+ *
+ * Every output file is wrapped in a stdio stream whose writes are copied
+ * into one of two large buffers.  When the buffer being filled is full,
+ * or has not been written for a while, the writer thread takes it and
+ * writes it to the file while the tracer fills the other one.  The tracer
+ * only waits for the writer, and keeps the tracees stopped, when both
+ * buffers of a file are full; these waits are counted and reported with -d.
+ */
+
+#include "defs.h"
+
+bool async_output;
+
+#ifdef HAVE_FOPENCOOKIE
+
+# include <pthread.h>
+# include <signal.h>
+
+# define ASYNC_BUF_SIZE		(256 * 1024)
+/* how long a partly filled buffer may wait for the writer, in msecs */
+# define ASYNC_FLUSH_DELAY	100
+
+struct async_stream {
+	FILE *fp;		/* the real output file */
+	FILE *cookie_fp;	/* the stream handed out to the tracer */
+	char *buf[2];
+	size_t len[2];
+	/*
+	 * The tracer appends to buf[active]; a non-empty buf[!active]
+	 * is waiting for, or being written by, the writer thread.
+	 */
+	unsigned int active;
+	struct async_stream *next;
+};
+
+static pthread_mutex_t async_lock = PTHREAD_MUTEX_INITIALIZER;
+/* signalled when a buffer is handed to the writer */
+static pthread_cond_t async_work = PTHREAD_COND_INITIALIZER;
+/* signalled when the writer is done with a buffer */
+static pthread_cond_t async_done = PTHREAD_COND_INITIALIZER;
+
+static struct async_stream *async_streams;
+/* the process that owns the writer thread, 0 before it is started */
+static pid_t async_writer_pid;
+static bool async_stopping;
+
+static unsigned long async_stalls;
+static struct timeval async_stall_time;
+/* errno of the first failed write of the writer thread */
+static int async_errno;
+
+static int
+write_all(FILE *fp, const char *buf, size_t len)
+{
+	int fd = fileno(fp);
+
+	while (len) {
+		ssize_t n = write(fd, buf, len);
+
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		buf += n;
+		len -= n;
+	}
+	return 0;
+}
+
+/*
+ * Messages are printed with fflush(NULL), which comes back here, so
+ * failures are only recorded while async_lock is held, and by the
+ * writer thread.
+ */
+static void
+write_noted(FILE *fp, const char *buf, size_t len)
+{
+	if (write_all(fp, buf, len) < 0 && !async_errno)
+		async_errno = errno;
+}
+
+static void
+report_write_error(void)
+{
+	if (async_errno) {
+		errno = async_errno;
+		async_errno = 0;
+		perror_msg("write to output file");
+	}
+}
+
+/* Called with async_lock held. */
+static void
+wait_for_writer(struct async_stream *s)
+{
+	struct timeval start, end;
+
+	if (!s->len[!s->active])
+		return;
+
+	gettimeofday(&start, NULL);
+	while (s->len[!s->active])
+		pthread_cond_wait(&async_done, &async_lock);
+	gettimeofday(&end, NULL);
+
+	async_stalls++;
+	tv_sub(&end, &end, &start);
+	tv_add(&async_stall_time, &async_stall_time, &end);
+}
+
+static void *
+writer_thread(void *arg)
+{
+	pthread_mutex_lock(&async_lock);
+	for (;;) {
+		struct async_stream *s;
+		struct timespec ts;
+		struct timeval tv;
+		unsigned int idx;
+
+		for (s = async_streams; s; s = s->next)
+			if (s->len[!s->active])
+				break;
+
+		if (!s) {
+			if (async_stopping)
+				break;
+
+			gettimeofday(&tv, NULL);
+			ts.tv_sec = tv.tv_sec;
+			ts.tv_nsec = tv.tv_usec * 1000 +
+				     ASYNC_FLUSH_DELAY * 1000000L;
+			if (ts.tv_nsec >= 1000000000) {
+				ts.tv_sec++;
+				ts.tv_nsec -= 1000000000;
+			}
+			if (pthread_cond_timedwait(&async_work, &async_lock,
+						   &ts) != ETIMEDOUT)
+				continue;
+
+			/* Nothing was handed over for a while, take it. */
+			for (s = async_streams; s; s = s->next)
+				if (s->len[s->active] && !s->len[!s->active])
+					s->active ^= 1;
+			continue;
+		}
+
+		idx = !s->active;
+		pthread_mutex_unlock(&async_lock);
+		write_noted(s->fp, s->buf[idx], s->len[idx]);
+		pthread_mutex_lock(&async_lock);
+
+		s->len[idx] = 0;
+		pthread_cond_broadcast(&async_done);
+	}
+	pthread_mutex_unlock(&async_lock);
+
+	return NULL;
+}
+
+static void
+async_output_exit(void)
+{
+	struct async_stream *s;
+
+	if (async_writer_pid != getpid())
+		return;
+
+	for (s = async_streams; s; s = s->next)
+		fflush(s->cookie_fp);
+
+	pthread_mutex_lock(&async_lock);
+	async_stopping = true;
+	for (s = async_streams; s; s = s->next) {
+		wait_for_writer(s);
+		write_noted(s->fp, s->buf[s->active], s->len[s->active]);
+		s->len[s->active] = 0;
+	}
+	pthread_mutex_unlock(&async_lock);
+
+	report_write_error();
+	if (debug_flag)
+		error_msg("output writer: tracer waited %lu times, %ld.%06lds",
+			  async_stalls, (long) async_stall_time.tv_sec,
+			  (long) async_stall_time.tv_usec);
+}
+
+static void
+start_writer(void)
+{
+	pthread_t thread;
+	sigset_t mask, old_mask;
+	int err;
+
+	async_writer_pid = getpid();
+
+	/* Signals are for the tracer, the writer only writes. */
+	sigfillset(&mask);
+	pthread_sigmask(SIG_SETMASK, &mask, &old_mask);
+	err = pthread_create(&thread, NULL, writer_thread, NULL);
+	pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+	if (err) {
+		errno = err;
+		perror_msg_and_die("pthread_create");
+	}
+	pthread_detach(thread);
+
+	atexit(async_output_exit);
+}
+
+static ssize_t
+async_write(void *cookie, const char *buf, size_t size)
+{
+	struct async_stream *s = cookie;
+	size_t left = size;
+
+	/*
+	 * The writer thread is started on the first write, by the tracer:
+	 * with -D the process that opened the file is not the tracer.
+	 * Anything written by another process goes straight to the file.
+	 */
+	if (!async_writer_pid)
+		start_writer();
+	if (async_writer_pid != getpid()) {
+		if (write_all(s->fp, buf, size) < 0)
+			return -1;
+		return size;
+	}
+
+	pthread_mutex_lock(&async_lock);
+	while (left) {
+		size_t n;
+
+		if (s->len[s->active] == ASYNC_BUF_SIZE) {
+			wait_for_writer(s);
+			s->active ^= 1;
+			if (async_stopping) {
+				/* the writer is gone */
+				write_noted(s->fp, s->buf[!s->active],
+					    s->len[!s->active]);
+				s->len[!s->active] = 0;
+			} else
+				pthread_cond_signal(&async_work);
+		}
+
+		n = ASYNC_BUF_SIZE - s->len[s->active];
+		if (n > left)
+			n = left;
+		memcpy(s->buf[s->active] + s->len[s->active], buf, n);
+		s->len[s->active] += n;
+		buf += n;
+		left -= n;
+	}
+	pthread_mutex_unlock(&async_lock);
+
+	return size;
+}
+
+static int
+async_close(void *cookie)
+{
+	struct async_stream *s = cookie;
+	struct async_stream **p;
+	int rc;
+
+	pthread_mutex_lock(&async_lock);
+	wait_for_writer(s);
+	for (p = &async_streams; *p; p = &(*p)->next)
+		if (*p == s) {
+			*p = s->next;
+			break;
+		}
+	pthread_mutex_unlock(&async_lock);
+
+	write_noted(s->fp, s->buf[s->active], s->len[s->active]);
+	rc = fclose(s->fp);
+	free(s->buf[0]);
+	free(s->buf[1]);
+	free(s);
+	report_write_error();
+
+	return rc;
+}
+
+/*
+ * Return a stream writing to FP through the writer thread.
+ * Closing the returned stream closes FP.
+ */
+FILE *
+async_output_wrap(FILE *fp)
+{
+	static const cookie_io_functions_t funcs = {
+		.write = async_write,
+		.close = async_close
+	};
+	struct async_stream *s = xcalloc(1, sizeof(*s));
+
+	s->fp = fp;
+	s->buf[0] = xmalloc(ASYNC_BUF_SIZE);
+	s->buf[1] = xmalloc(ASYNC_BUF_SIZE);
+	s->cookie_fp = fopencookie(s, "w", funcs);
+	if (!s->cookie_fp)
+		die_out_of_memory();
+
+	pthread_mutex_lock(&async_lock);
+	s->next = async_streams;
+	async_streams = s;
+	pthread_mutex_unlock(&async_lock);
+
+	return s->cookie_fp;
+}
+
+#else /* !HAVE_FOPENCOOKIE */
+
+FILE *
+async_output_wrap(FILE *fp)
+{
+	return fp;
+}
+
+#endif
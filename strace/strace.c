@@ -40,6 +40,7 @@
 #include <grp.h>
 #include <dirent.h>
 #include <sys/utsname.h>
+#include <getopt.h>
 #ifdef HAVE_PRCTL
 # include <sys/prctl.h>
 #endif
@@ -86,6 +87,7 @@ bool debug_flag = 0;
 bool Tflag = 0;
 bool iflag = 0;
 bool count_wallclock = 0;
+bool count_histogram = 0;
 unsigned int qflag = 0;
 static unsigned int tflag = 0;
 static bool rflag = 0;
@@ -209,6 +211,8 @@ Output format:\n\
   -a column      alignment COLUMN for printing syscall results (default %d)\n\
   -i             print instruction pointer at time of syscall\n\
   -o file        send trace output to FILE instead of stderr\n\
+  --async-output write the output FILE from a separate thread, so that\n\
+                 slow output does not hold the tracees stopped\n\
   -q             suppress messages about attaching, detaching, etc.\n\
   -r             print relative timestamp\n\
   -s strsize     limit length of print strings to STRSIZE chars (default %d)\n\
@@ -226,6 +230,8 @@ Statistics:\n\
   -O overhead    set overhead for tracing syscalls to OVERHEAD usecs\n\
   -S sortby      sort syscall counts by: time, calls, name, nothing (default %s)\n\
   -w             summarise syscall latency (default is system time)\n\
+  --latency-histogram\n\
+                 also print a latency histogram for each syscall\n\
 \n\
 Filtering:\n\
   -e expr        a qualifying expression: option=[!]all or option=[!]val1[,val2]...\n\
@@ -237,6 +243,8 @@ Tracing:\n\
   -D             run tracer process as a detached grandchild, not as parent\n\
   -f             follow forks\n\
   -ff            follow forks with output into separate files\n\
+  --seccomp-bpf  enable seccomp-bpf filtering, so that the tracee only\n\
+                 stops for traced syscalls (implies -f, not with -p or -b)\n\
   -I interruptible\n\
      1:          no signals are blocked\n\
      2:          fatal signals are blocked while decoding syscall (default)\n\
@@ -502,7 +510,7 @@ strace_fopen(const char *path)
 		perror_msg_and_die("Can't fopen '%s'", path);
 	swap_uid();
 	set_cloexec_flag(fileno(fp));
-	return fp;
+	return async_output ? async_output_wrap(fp) : fp;
 }
 
 static int popen_pid = 0;
@@ -552,7 +560,7 @@ strace_popen(const char *command)
 	fp = fdopen(fds[1], "w");
 	if (!fp)
 		die_out_of_memory();
-	return fp;
+	return async_output ? async_output_wrap(fp) : fp;
 }
 
 void
@@ -1172,6 +1180,9 @@ exec_or_die(void)
 		alarm(0);
 	}
 
+	if (seccomp_filtering)
+		init_seccomp_filter();
+
 	execv(params->pathname, params->argv);
 	perror_msg_and_die("exec");
 }
@@ -1452,6 +1463,13 @@ init(int argc, char *argv[])
 	int optF = 0;
 	unsigned int tcbi;
 	struct sigaction sa;
+	enum { SECCOMP_OPTION = 0x100, HISTOGRAM_OPTION, ASYNC_OUTPUT_OPTION };
+	static const struct option longopts[] = {
+		{ "seccomp-bpf", no_argument, NULL, SECCOMP_OPTION },
+		{ "latency-histogram", no_argument, NULL, HISTOGRAM_OPTION },
+		{ "async-output", no_argument, NULL, ASYNC_OUTPUT_OPTION },
+		{ NULL, 0, NULL, 0 }
+	};
 
 	progname = argv[0] ? argv[0] : "strace";
 
@@ -1483,13 +1501,13 @@ init(int argc, char *argv[])
 # error Bug in DEFAULT_QUAL_FLAGS
 #endif
 	qualify("signal=all");
-	while ((c = getopt(argc, argv,
+	while ((c = getopt_long(argc, argv,
 		"+b:cCdfFhiqrtTvVwxyz"
 #ifdef USE_LIBUNWIND
 		"k"
 #endif
 		"D"
-		"a:e:o:O:p:s:S:u:E:P:I:")) != EOF) {
+		"a:e:o:O:p:s:S:u:E:P:I:", longopts, NULL)) != EOF) {
 		switch (c) {
 		case 'b':
 			if (strcmp(optarg, "execve") != 0)
@@ -1607,6 +1625,19 @@ init(int argc, char *argv[])
 			if (opt_intr <= 0 || opt_intr >= NUM_INTR_OPTS)
 				error_opt_arg(c, optarg);
 			break;
+		case SECCOMP_OPTION:
+			seccomp_filtering = true;
+			break;
+		case HISTOGRAM_OPTION:
+			count_histogram = 1;
+			break;
+		case ASYNC_OUTPUT_OPTION:
+#ifdef HAVE_FOPENCOOKIE
+			async_output = true;
+#else
+			error_msg("--async-output is not supported, ignored");
+#endif
+			break;
 		default:
 			error_msg_and_help(NULL);
 			break;
@@ -1631,6 +1662,16 @@ init(int argc, char *argv[])
 	if (!followfork)
 		followfork = optF;
 
+	check_seccomp_filter(nprocs != 0);
+	if (seccomp_filtering) {
+		if (detach_on_execve)
+			error_msg_and_help("-b and --seccomp-bpf are mutually exclusive");
+		/* The filter is inherited, untraced children would get ENOSYS */
+		if (!followfork)
+			followfork = 1;
+		ptrace_setoptions |= PTRACE_O_TRACESECCOMP;
+	}
+
 	if (followfork >= 2 && cflag) {
 		error_msg_and_help("(-c or -C) and -ff are mutually exclusive");
 	}
@@ -1639,6 +1680,10 @@ init(int argc, char *argv[])
 		error_msg_and_help("-w must be given with (-c or -C)");
 	}
 
+	if (count_histogram && !cflag) {
+		error_msg_and_help("--latency-histogram must be given with (-c or -C)");
+	}
+
 	if (cflag == CFLAG_ONLY_STATS) {
 		if (iflag)
 			error_msg("-%c has no effect with -c", 'i');
@@ -2053,6 +2098,7 @@ trace(void)
 	bool stopped;
 	unsigned int sig;
 	unsigned int event;
+	int restart_op;
 	struct tcb *tcp;
 	struct rusage ru;
 
@@ -2122,6 +2168,7 @@ trace(void)
 		get_regs(pid);
 	else
 		clear_regs();
+	invalidate_umove_cache();
 
 	event = (unsigned int) status >> 16;
 
@@ -2192,6 +2239,19 @@ trace(void)
 
 	if (event != 0) {
 		/* Ptrace event */
+		if (event == PTRACE_EVENT_SECCOMP && seccomp_filtering) {
+			/*
+			 * The filter selected the syscall being entered.
+			 * On older kernels the syscall-entry stop is still
+			 * to come, otherwise this stop takes its place.
+			 */
+			if (seccomp_before_sysentry) {
+				sig = 0;
+				restart_op = PTRACE_SYSCALL;
+				goto restart_tracee_with_op;
+			}
+			goto syscall_stop;
+		}
 #if USE_SEIZE
 		if (event == PTRACE_EVENT_STOP) {
 			/*
@@ -2262,6 +2322,7 @@ show_stopsig:
 		goto restart_tracee;
 	}
 
+syscall_stop:
 	/* We handled quick cases, we are permitted to interrupt now. */
 	if (interrupted)
 		return false;
@@ -2289,7 +2350,15 @@ restart_tracee_with_sig_0:
 	sig = 0;
 
 restart_tracee:
-	if (ptrace_restart(PTRACE_SYSCALL, tcp, sig) < 0) {
+	/*
+	 * With the seccomp filter, syscall stops are only needed
+	 * to see the exit of a syscall the filter stopped on.
+	 */
+	restart_op = (!seccomp_filtering || exiting(tcp))
+		     ? PTRACE_SYSCALL : PTRACE_CONT;
+
+restart_tracee_with_op:
+	if (ptrace_restart(restart_op, tcp, sig) < 0) {
 		/* Note: ptrace_restart emitted error message */
 		exit_code = 1;
 		return false;
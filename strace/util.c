@@ -137,14 +137,28 @@ xlat_bsearch_compare(const void *a, const void *b)
 	return (val1 > val2) ? 1 : (val1 < val2) ? -1 : 0;
 }
 
+/*
+ * Look VAL up in XLAT, an array of NMEMB elements sorted by value.
+ * Where several elements have the same value, the first one is returned,
+ * as xlookup() would.
+ */
 const char *
 xlat_search(const struct xlat *xlat, const size_t nmemb, const unsigned int val)
 {
-	const struct xlat *e =
-		bsearch((const void*) (const unsigned long) val,
-			xlat, nmemb, sizeof(*xlat), xlat_bsearch_compare);
+	const struct xlat *e;
+
+	/* Tables of dense values are indexed directly. */
+	if (val < nmemb && xlat[val].val == val)
+		e = &xlat[val];
+	else
+		e = bsearch((const void*) (const unsigned long) val,
+			    xlat, nmemb, sizeof(*xlat), xlat_bsearch_compare);
+	if (!e)
+		return NULL;
 
-	return e ? e->str : NULL;
+	while (e > xlat && e[-1].val == val)
+		e--;
+	return e->str;
 }
 
 #if !defined HAVE_STPCPY
@@ -228,6 +242,22 @@ printxvals(const unsigned int val, const char *dflt, const struct xlat *xlat, ..
 	va_end(args);
 }
 
+/*
+ * Like printxval, for an xlat array of NMEMB elements sorted by value,
+ * see the #sorted directive of xlat/gen.sh.
+ */
+void
+printxval_searchn(const struct xlat *xlat, size_t nmemb, unsigned int val,
+		  const char *dflt)
+{
+	const char *str = xlat_search(xlat, nmemb, val);
+
+	if (str)
+		tprints(str);
+	else
+		tprintf("%#x /* %s */", val, dflt);
+}
+
 /*
  * Fetch 64bit argument at position arg_no and
  * return the index of the next argument.
@@ -309,6 +339,8 @@ addflags(const struct xlat *xlat, int flags)
 		if (xlat->val && (flags & xlat->val) == xlat->val) {
 			tprintf("|%s", xlat->str);
 			flags &= ~xlat->val;
+			if (!flags)
+				break;
 		}
 	}
 	if (flags) {
@@ -373,6 +405,8 @@ printflags(const struct xlat *xlat, int flags, const char *dflt)
 			flags &= ~xlat->val;
 			sep = "|";
 			n++;
+			if (!flags)
+				break;
 		}
 	}
 
@@ -1014,6 +1048,210 @@ vm_read_mem(pid_t pid, void *laddr, long raddr, size_t len)
 	return process_vm_readv(pid, &local, 1, &remote, 1, 0);
 }
 
+/*
+ * Cache of whole tracee pages read with process_vm_readv during the current
+ * ptrace stop.  Decoders tend to read many small objects that lie in the
+ * same few pages (a msghdr, its iovec array, the control buffer...), with
+ * the cache each page is fetched once.  Tracee memory can change as soon as
+ * the tracee runs, so trace() calls invalidate_umove_cache() on every stop.
+ */
+#define UMOVE_CACHE_PAGES	64
+/* Larger reads go straight to the tracee. */
+#define UMOVE_CACHE_MAX_PAGES	4
+
+static struct {
+	unsigned long addr;
+	char *data;
+} umove_cache[UMOVE_CACHE_PAGES];
+static unsigned int umove_cache_used;
+static int umove_cache_pid;
+
+void
+invalidate_umove_cache(void)
+{
+	umove_cache_used = 0;
+}
+
+static const char *
+umove_cache_lookup(int pid, unsigned long page)
+{
+	unsigned int i;
+
+	if (pid != umove_cache_pid)
+		return NULL;
+	for (i = 0; i < umove_cache_used; i++)
+		if (umove_cache[i].addr == page)
+			return umove_cache[i].data;
+	return NULL;
+}
+
+/*
+ * Read the n pages at pages[] into the cache, with as few
+ * process_vm_readv calls as possible.  Pages that cannot be read
+ * are left out.
+ */
+static void
+umove_cache_fill(int pid, const unsigned long *pages, unsigned int n)
+{
+	const size_t page_size = get_pagesize();
+	struct iovec local[UMOVE_CACHE_PAGES];
+	struct iovec remote[UMOVE_CACHE_PAGES];
+	unsigned int i, first, base;
+	ssize_t r;
+
+	if (pid != umove_cache_pid) {
+		umove_cache_used = 0;
+		umove_cache_pid = pid;
+	}
+	if (n > UMOVE_CACHE_PAGES)
+		n = UMOVE_CACHE_PAGES;
+	if (umove_cache_used + n > UMOVE_CACHE_PAGES)
+		umove_cache_used = 0;
+
+	/* page i is read into slot base + i */
+	base = umove_cache_used;
+	for (i = 0; i < n; i++) {
+		unsigned int slot = base + i;
+
+		if (!umove_cache[slot].data)
+			umove_cache[slot].data = xmalloc(page_size);
+		local[i].iov_base = umove_cache[slot].data;
+		local[i].iov_len = page_size;
+		remote[i].iov_base = (void *) pages[i];
+		remote[i].iov_len = page_size;
+	}
+
+	/*
+	 * process_vm_readv stops at the first page it cannot read,
+	 * skip that page and carry on with the rest.
+	 */
+	for (first = 0; first < n; ) {
+		r = process_vm_readv(pid, &local[first], n - first,
+				     &remote[first], n - first, 0);
+		if (r < 0) {
+			if (errno == ENOSYS || errno == ESRCH || errno == EPERM)
+				break;
+			r = 0;
+		}
+		for (i = r / page_size; i > 0; i--, first++) {
+			unsigned int slot = base + first;
+
+			/*
+			 * After a failed page, slot is further up than the
+			 * next free one, whose buffer is no longer needed.
+			 */
+			if (slot != umove_cache_used) {
+				char *data = umove_cache[umove_cache_used].data;
+				umove_cache[umove_cache_used].data =
+					umove_cache[slot].data;
+				umove_cache[slot].data = data;
+			}
+			umove_cache[umove_cache_used].addr = pages[first];
+			umove_cache_used++;
+		}
+		/* skip the page that failed */
+		first++;
+	}
+}
+
+/*
+ * Like vm_read_mem, but served from the umove cache when possible.
+ */
+static ssize_t
+vm_read_mem_cached(pid_t pid, void *laddr, long raddr, size_t len)
+{
+	const unsigned long page_size = get_pagesize();
+	const unsigned long page_mask = page_size - 1;
+	const unsigned long start = (unsigned long) raddr;
+	unsigned long first_page, last_page, page;
+	unsigned long missing[UMOVE_CACHE_MAX_PAGES];
+	unsigned int n = 0;
+	char *out = laddr;
+
+	if (!len || start + len < start ||
+	    len > UMOVE_CACHE_MAX_PAGES * page_size - (start & page_mask))
+		return vm_read_mem(pid, laddr, raddr, len);
+
+	first_page = start & ~page_mask;
+	last_page = (start + len - 1) & ~page_mask;
+
+	for (page = first_page; page <= last_page; page += page_size)
+		if (!umove_cache_lookup(pid, page))
+			missing[n++] = page;
+	if (n) {
+		umove_cache_fill(pid, missing, n);
+		/* filling may have evicted pages we found before */
+		for (page = first_page; page <= last_page; page += page_size)
+			if (!umove_cache_lookup(pid, page))
+				return vm_read_mem(pid, laddr, raddr, len);
+	}
+
+	for (page = first_page; page <= last_page; page += page_size) {
+		unsigned long from = page < start ? start : page;
+		unsigned long to = page + page_size;
+
+		if (to > start + len)
+			to = start + len;
+		memcpy(out, umove_cache_lookup(pid, page) + (from - page),
+		       to - from);
+		out += to - from;
+	}
+
+	return len;
+}
+
+/*
+ * Fetch the tracee pages covering the n address ranges of remote[]
+ * into the umove cache in one go, so that the umoven and umovestr calls
+ * a decoder makes for them afterwards do not need a syscall each.
+ * Ranges are clipped to the free room in the cache.
+ */
+void
+umove_prefetch(struct tcb *tcp, const struct iovec *remote, unsigned int n)
+{
+	const unsigned long page_size = get_pagesize();
+	const unsigned long page_mask = page_size - 1;
+	unsigned long pages[UMOVE_CACHE_PAGES];
+	unsigned int i, count = 0, room;
+
+	if (process_vm_readv_not_supported)
+		return;
+
+	/* Use free slots only, what is cached already may be needed too. */
+	room = UMOVE_CACHE_PAGES;
+	if (tcp->pid == umove_cache_pid)
+		room -= umove_cache_used;
+
+	for (i = 0; i < n && count < room; i++) {
+		unsigned long start = (unsigned long) remote[i].iov_base;
+		unsigned long len = remote[i].iov_len;
+		unsigned long page, last;
+		unsigned int j;
+
+#if SUPPORTED_PERSONALITIES > 1 && SIZEOF_LONG > 4
+		if (current_wordsize < sizeof(start))
+			start &= (1ul << 8 * current_wordsize) - 1;
+#endif
+		if (!start || !len || start + len < start)
+			continue;
+		last = (start + len - 1) & ~page_mask;
+		for (page = start & ~page_mask;
+		     page <= last && count < room;
+		     page += page_size) {
+			if (umove_cache_lookup(tcp->pid, page))
+				continue;
+			for (j = 0; j < count; j++)
+				if (pages[j] == page)
+					break;
+			if (j == count)
+				pages[count++] = page;
+		}
+	}
+
+	if (count)
+		umove_cache_fill(tcp->pid, pages, count);
+}
+
 /*
  * move `len' bytes of data from process `pid'
  * at address `addr' to our space at `our_addr'
@@ -1035,7 +1273,7 @@ umoven(struct tcb *tcp, long addr, unsigned int len, void *our_addr)
 #endif
 
 	if (!process_vm_readv_not_supported) {
-		int r = vm_read_mem(pid, laddr, addr, len);
+		int r = vm_read_mem_cached(pid, laddr, addr, len);
 		if ((unsigned int) r == len)
 			return 0;
 		if (r >= 0) {
@@ -1228,7 +1466,7 @@ umovestr(struct tcb *tcp, long addr, unsigned int len, char *laddr)
 			if (chunk_len > end_in_page) /* crosses to the next page */
 				chunk_len -= end_in_page;
 
-			int r = vm_read_mem(pid, laddr, addr, chunk_len);
+			int r = vm_read_mem_cached(pid, laddr, addr, chunk_len);
 			if (r > 0) {
 				if (memchr(laddr, '\0', r))
 					return 1;
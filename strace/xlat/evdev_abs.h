@@ -8,6 +8,7 @@
 
 static
 const struct xlat evdev_abs[] = {
+ /* sorted by value, suitable for printxval_search */
 #if defined(ABS_X) || (defined(HAVE_DECL_ABS_X) && HAVE_DECL_ABS_X)
   XLAT(ABS_X),
 #endif
@@ -8,6 +8,7 @@
 
 static
 const struct xlat evdev_autorepeat[] = {
+ /* sorted by value, suitable for printxval_search */
 #if defined(REP_DELAY) || (defined(HAVE_DECL_REP_DELAY) && HAVE_DECL_REP_DELAY)
   XLAT(REP_DELAY),
 #endif
@@ -8,6 +8,7 @@
 
 static
 const struct xlat evdev_ff_status[] = {
+ /* sorted by value, suitable for printxval_search */
 #if defined(FF_STATUS_STOPPED) || (defined(HAVE_DECL_FF_STATUS_STOPPED) && HAVE_DECL_FF_STATUS_STOPPED)
   XLAT(FF_STATUS_STOPPED),
 #endif
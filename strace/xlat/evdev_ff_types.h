@@ -8,6 +8,7 @@
 
 static
 const struct xlat evdev_ff_types[] = {
+ /* sorted by value, suitable for printxval_search */
 #if defined(FF_RUMBLE) || (defined(HAVE_DECL_FF_RUMBLE) && HAVE_DECL_FF_RUMBLE)
   XLAT(FF_RUMBLE),
 #endif
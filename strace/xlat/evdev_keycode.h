@@ -8,6 +8,7 @@
 
 static
 const struct xlat evdev_keycode[] = {
+ /* sorted by value, suitable for printxval_search */
 #if defined(KEY_RESERVED) || (defined(HAVE_DECL_KEY_RESERVED) && HAVE_DECL_KEY_RESERVED)
   XLAT(KEY_RESERVED),
 #endif
@@ -8,6 +8,7 @@
 
 static
 const struct xlat evdev_leds[] = {
+ /* sorted by value, suitable for printxval_search */
 #if defined(LED_NUML) || (defined(HAVE_DECL_LED_NUML) && HAVE_DECL_LED_NUML)
   XLAT(LED_NUML),
 #endif
@@ -8,6 +8,7 @@
 
 static
 const struct xlat evdev_misc[] = {
+ /* sorted by value, suitable for printxval_search */
 #if defined(MSC_SERIAL) || (defined(HAVE_DECL_MSC_SERIAL) && HAVE_DECL_MSC_SERIAL)
   XLAT(MSC_SERIAL),
 #endif
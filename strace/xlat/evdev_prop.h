@@ -8,6 +8,7 @@
 
 static
 const struct xlat evdev_prop[] = {
+ /* sorted by value, suitable for printxval_search */
 #if defined(INPUT_PROP_POINTER) || (defined(HAVE_DECL_INPUT_PROP_POINTER) && HAVE_DECL_INPUT_PROP_POINTER)
   XLAT(INPUT_PROP_POINTER),
 #endif
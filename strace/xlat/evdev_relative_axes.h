@@ -8,6 +8,7 @@
 
 static
 const struct xlat evdev_relative_axes[] = {
+ /* sorted by value, suitable for printxval_search */
 #if defined(REL_X) || (defined(HAVE_DECL_REL_X) && HAVE_DECL_REL_X)
   XLAT(REL_X),
 #endif
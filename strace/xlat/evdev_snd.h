@@ -8,6 +8,7 @@
 
 static
 const struct xlat evdev_snd[] = {
+ /* sorted by value, suitable for printxval_search */
 #if defined(SND_CLICK) || (defined(HAVE_DECL_SND_CLICK) && HAVE_DECL_SND_CLICK)
   XLAT(SND_CLICK),
 #endif
@@ -8,6 +8,7 @@
 
 static
 const struct xlat evdev_switch[] = {
+ /* sorted by value, suitable for printxval_search */
 #if defined(SW_LID) || (defined(HAVE_DECL_SW_LID) && HAVE_DECL_SW_LID)
   XLAT(SW_LID),
 #endif
@@ -8,6 +8,7 @@
 
 static
 const struct xlat evdev_sync[] = {
+ /* sorted by value, suitable for printxval_search */
 #if defined(SYN_REPORT) || (defined(HAVE_DECL_SYN_REPORT) && HAVE_DECL_SYN_REPORT)
   XLAT(SYN_REPORT),
 #endif
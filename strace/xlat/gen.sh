@@ -105,7 +105,7 @@ gen_header()
 
 	echo "/* Generated by $0 from $1; do not edit. */"
 
-	local unconditional= unterminated= line
+	local unconditional= unterminated= sorted= line
 	# 1st pass: output directives.
 	while read line; do
 		LC_COLLATE=C
@@ -116,6 +116,9 @@ gen_header()
 		'#unterminated')
 			unterminated=1
 			;;
+		'#sorted')
+			sorted=1
+			;;
 		'#'*)
 			echo "${line}"
 			;;
@@ -156,6 +159,9 @@ gen_header()
 		EOF
 	fi
 	echo "const struct xlat ${name}[] = {"
+	if [ -n "${sorted}" ]; then
+		echo " /* sorted by value, suitable for printxval_search */"
+	fi
 
 	unconditional=
 	# 2nd pass: output everything.
@@ -165,7 +171,7 @@ gen_header()
 		'#unconditional')
 			unconditional=1
 			;;
-		'#unterminated')
+		'#unterminated'|'#sorted')
 			# processed during 1st pass
 			;;
 		[A-Z_]*)	# symbolic constants
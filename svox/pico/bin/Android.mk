@@ -0,0 +1,17 @@
+# Build the SVOX Pico synthesis speed benchmark
+
+LOCAL_PATH := $(call my-dir)
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := picobench
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_SRC_FILES := \
+	picobench.c
+
+LOCAL_C_INCLUDES += \
+	external/svox/pico/lib
+
+LOCAL_STATIC_LIBRARIES := libsvoxpico
+
+include $(BUILD_EXECUTABLE)
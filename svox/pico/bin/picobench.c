@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2008-2009 SVOX AG, Baslerstr. 30, 8048 Zuerich, Switzerland
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * @file picobench.c
+ *
+ * Synthesis speed benchmark
+ *
+ * Synthesizes a text with each voice given on the command line and reports
+ * the real-time factor, i.e. the CPU time spent per second of generated
+ * audio. With -n, the given number of engines synthesize at the same time in
+ * separate threads, as with several simultaneous TTS streams; the real-time
+ * factor is then reported per stream and for the wall clock time of all.
+ *
+ * usage: picobench [-n streams] [-r repeats] [-t text] ta.bin sg.bin [ta.bin sg.bin ...]
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "picoapi.h"
+
+#define PICOBENCH_MEM_SIZE      2500000
+#define PICOBENCH_SAMPLE_RATE   16000
+#define PICOBENCH_MAX_STREAMS   64
+#define PICOBENCH_VOICE_NAME    "PicoBench"
+
+static const char * picobench_defaultText =
+    "The quick brown fox jumps over the lazy dog. "
+    "Speech synthesis on small devices has to share the processor with "
+    "everything else that is running, so every cycle spent per sample counts. "
+    "This sentence is here to make the text long enough for a stable measurement.";
+
+typedef struct picobench_stream {
+    pthread_t thread;
+    const char * taFile;
+    const char * sgFile;
+    const char * text;
+    int repeats;
+    int status;
+    unsigned long samples;
+    double cpuTime;
+} picobench_stream_t;
+
+static double picobench_time(clockid_t clock)
+{
+    struct timespec ts;
+
+    clock_gettime(clock, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int picobench_synth(pico_Engine engine, const char * text, unsigned long * samples)
+{
+    pico_Char * inp = (pico_Char *) text;
+    size_t remaining = strlen(text) + 1;
+    pico_Int16 sent, received, dataType;
+    pico_Status ret;
+    short buf[128];
+
+    while (remaining > 0) {
+        ret = pico_putTextUtf8(engine, inp, (pico_Int16) ((remaining > 32767) ? 32767 : remaining), &sent);
+        if (PICO_OK != ret) {
+            return ret;
+        }
+        remaining -= sent;
+        inp += sent;
+        do {
+            ret = pico_getData(engine, buf, sizeof(buf), &received, &dataType);
+            *samples += received / sizeof(short);
+        } while (PICO_STEP_BUSY == ret);
+        if (PICO_STEP_IDLE != ret) {
+            return ret;
+        }
+    }
+    return PICO_OK;
+}
+
+static void * picobench_run(void * arg)
+{
+    picobench_stream_t * stream = (picobench_stream_t *) arg;
+    void * mem = NULL;
+    pico_System system = NULL;
+    pico_Resource ta = NULL, sg = NULL;
+    pico_Char taName[PICO_MAX_RESOURCE_NAME_SIZE];
+    pico_Char sgName[PICO_MAX_RESOURCE_NAME_SIZE];
+    pico_Engine engine = NULL;
+    pico_Status ret;
+    double start;
+    int i;
+
+    mem = malloc(PICOBENCH_MEM_SIZE);
+    ret = (NULL == mem) ? PICO_EXC_OUT_OF_MEM : pico_initialize(mem, PICOBENCH_MEM_SIZE, &system);
+    if (PICO_OK == ret) {
+        ret = pico_loadResource(system, (const pico_Char *) stream->taFile, &ta);
+    }
+    if (PICO_OK == ret) {
+        ret = pico_loadResource(system, (const pico_Char *) stream->sgFile, &sg);
+    }
+    if (PICO_OK == ret) {
+        ret = pico_getResourceName(system, ta, (char *) taName);
+    }
+    if (PICO_OK == ret) {
+        ret = pico_getResourceName(system, sg, (char *) sgName);
+    }
+    if (PICO_OK == ret) {
+        ret = pico_createVoiceDefinition(system, (const pico_Char *) PICOBENCH_VOICE_NAME);
+    }
+    if (PICO_OK == ret) {
+        ret = pico_addResourceToVoiceDefinition(system, (const pico_Char *) PICOBENCH_VOICE_NAME, taName);
+    }
+    if (PICO_OK == ret) {
+        ret = pico_addResourceToVoiceDefinition(system, (const pico_Char *) PICOBENCH_VOICE_NAME, sgName);
+    }
+    if (PICO_OK == ret) {
+        ret = pico_newEngine(system, (const pico_Char *) PICOBENCH_VOICE_NAME, &engine);
+    }
+
+    /* only the synthesis itself is measured, not loading the voice */
+    start = picobench_time(CLOCK_THREAD_CPUTIME_ID);
+    for (i = 0; (PICO_OK == ret) && (i < stream->repeats); i++) {
+        ret = picobench_synth(engine, stream->text, &stream->samples);
+    }
+    stream->cpuTime = picobench_time(CLOCK_THREAD_CPUTIME_ID) - start;
+    stream->status = ret;
+
+    if (NULL != engine) {
+        pico_disposeEngine(system, &engine);
+    }
+    if (NULL != system) {
+        pico_releaseVoiceDefinition(system, (pico_Char *) PICOBENCH_VOICE_NAME);
+        if (NULL != sg) {
+            pico_unloadResource(system, &sg);
+        }
+        if (NULL != ta) {
+            pico_unloadResource(system, &ta);
+        }
+        pico_terminate(&system);
+    }
+    free(mem);
+    return NULL;
+}
+
+static int picobench_voice(const char * taFile, const char * sgFile, const char * text,
+                           int numStreams, int repeats)
+{
+    picobench_stream_t streams[PICOBENCH_MAX_STREAMS];
+    double start, wall, audio, cpu = 0;
+    unsigned long samples = 0;
+    int i, started, failed = 0;
+
+    memset(streams, 0, sizeof(streams));
+    start = picobench_time(CLOCK_MONOTONIC);
+    for (started = 0; started < numStreams; started++) {
+        streams[started].taFile = taFile;
+        streams[started].sgFile = sgFile;
+        streams[started].text = text;
+        streams[started].repeats = repeats;
+        if (pthread_create(&streams[started].thread, NULL, picobench_run, &streams[started]) != 0) {
+            fprintf(stderr, "failed to start stream %d\n", started);
+            failed = 1;
+            break;
+        }
+    }
+    for (i = 0; i < started; i++) {
+        pthread_join(streams[i].thread, NULL);
+    }
+    wall = picobench_time(CLOCK_MONOTONIC) - start;
+
+    for (i = 0; i < started; i++) {
+        if (PICO_OK != streams[i].status) {
+            fprintf(stderr, "stream %d failed [%d]\n", i, streams[i].status);
+            failed = 1;
+        }
+        samples += streams[i].samples;
+        cpu += streams[i].cpuTime;
+    }
+    if (failed || (0 == samples)) {
+        return 1;
+    }
+
+    audio = (double) samples / PICOBENCH_SAMPLE_RATE;
+    printf("%s: %d stream(s), %.1f s audio, cpu %.3f s, RTF %.4f per stream, "
+           "wall %.3f s, RTF %.4f overall\n",
+           sgFile, started, audio, cpu, cpu / audio, wall, wall * started / audio);
+    return 0;
+}
+
+static void picobench_usage(void)
+{
+    fprintf(stderr, "usage: picobench [-n streams] [-r repeats] [-t text] "
+            "ta.bin sg.bin [ta.bin sg.bin ...]\n");
+}
+
+int main(int argc, char * argv[])
+{
+    const char * text = picobench_defaultText;
+    int numStreams = 1;
+    int repeats = 10;
+    int c, i, ret = 0;
+
+    while ((c = getopt(argc, argv, "n:r:t:")) != -1) {
+        switch (c) {
+            case 'n':
+                numStreams = atoi(optarg);
+                break;
+            case 'r':
+                repeats = atoi(optarg);
+                break;
+            case 't':
+                text = optarg;
+                break;
+            default:
+                picobench_usage();
+                return 1;
+        }
+    }
+    if ((numStreams < 1) || (numStreams > PICOBENCH_MAX_STREAMS) || (repeats < 1)
+            || (argc - optind < 2) || ((argc - optind) % 2 != 0)) {
+        picobench_usage();
+        return 1;
+    }
+
+    for (i = optind; i < argc; i += 2) {
+        ret |= picobench_voice(argv[i], argv[i + 1], text, numStreams, repeats);
+    }
+    return ret;
+}
+
+/* end picobench.c */
@@ -13,6 +13,7 @@ LOCAL_SRC_FILES := \
 	picoctrl.c \
 	picodata.c \
 	picodbg.c \
+	picodsp.c \
 	picoextapi.c \
 	picofftsg.c \
 	picokdbg.c \
@@ -39,6 +40,13 @@ LOCAL_SRC_FILES := \
 LOCAL_CFLAGS+= $(TOOL_CFLAGS)
 LOCAL_LDFLAGS+= $(TOOL_LDFLAGS)
 
+# picodsp.c uses NEON where available (always on arm64)
+ifeq ($(TARGET_ARCH),arm)
+ifeq ($(ARCH_ARM_HAVE_NEON),true)
+LOCAL_ARM_NEON := true
+endif
+endif
+
 include $(BUILD_STATIC_LIBRARY)
 
 
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2008-2009 SVOX AG, Baslerstr. 30, 8048 Zuerich, Switzerland
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/**
+ * @file picodsp.c
+ *
+ * Vector kernels of the signal generation
+ *
+ * The per-frame loops of the signal generation (overlap-add of the impulse
+ * responses, scaling, windowing of the inverse FFT) work element by element on
+ * 32 bit fixed point vectors of FFT size. They are implemented here with NEON
+ * (ARM) or SSE2 (x86) intrinsics if the compiler targets these instruction
+ * sets, and in plain C otherwise. The vector code computes exactly the same
+ * values as the C code, including the wrap-around of integer overflows.
+ *
+ */
+
+#include "picoos.h"
+#include "picodsp.h"
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define PICODSP_NEON
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#define PICODSP_SSE2
+#include <emmintrin.h>
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if 0
+}
+#endif
+
+/* shift right, rounding towards zero */
+#define SHR_SYM(x, s) (((x) >= 0) ? ((x) >> (s)) : -((-(x)) >> (s)))
+
+#if defined(PICODSP_SSE2)
+
+/* lower 32 bits of the 32x32 bit products (pmulld of SSE4.1) */
+static __inline __m128i mullo_epi32(__m128i a, __m128i b)
+{
+#if defined(__SSE4_1__)
+    return _mm_mullo_epi32(a, b);
+#else
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+}
+
+static __inline __m128i shr_sym_epi32(__m128i x, picoos_int32 shift)
+{
+    __m128i sign = _mm_srai_epi32(x, 31);
+    __m128i a = _mm_sub_epi32(_mm_xor_si128(x, sign), sign);
+    a = _mm_sra_epi32(a, _mm_cvtsi32_si128(shift));
+    return _mm_sub_epi32(_mm_xor_si128(a, sign), sign);
+}
+
+#elif defined(PICODSP_NEON)
+
+static __inline int32x4_t shr_sym_s32(int32x4_t x, int32x4_t negshift)
+{
+    int32x4_t sign = vshrq_n_s32(x, 31);
+    int32x4_t a = vsubq_s32(veorq_s32(x, sign), sign);
+    a = vshlq_s32(a, negshift);
+    return vsubq_s32(veorq_s32(a, sign), sign);
+}
+
+#endif
+
+void picodsp_mac(picoos_int32 *dst, const picoos_int32 *src, picoos_int32 f, picoos_int32 n)
+{
+    picoos_int32 i = 0;
+#if defined(PICODSP_SSE2)
+    __m128i vf = _mm_set1_epi32(f);
+    for (; i + 4 <= n; i += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+        __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_add_epi32(d, mullo_epi32(s, vf)));
+    }
+#elif defined(PICODSP_NEON)
+    int32x4_t vf = vdupq_n_s32(f);
+    for (; i + 4 <= n; i += 4) {
+        vst1q_s32(dst + i, vmlaq_s32(vld1q_s32(dst + i), vld1q_s32(src + i), vf));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] += src[i] * f;
+    }
+}
+
+void picodsp_mac_rev(picoos_int32 *dst, const picoos_int32 *src, picoos_int32 f, picoos_int32 n)
+{
+    picoos_int32 i = 0;
+#if defined(PICODSP_SSE2)
+    __m128i vf = _mm_set1_epi32(f);
+    for (; i + 4 <= n; i += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i *) (dst - i - 3));
+        __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+        s = _mm_shuffle_epi32(s, _MM_SHUFFLE(0, 1, 2, 3));
+        _mm_storeu_si128((__m128i *) (dst - i - 3), _mm_add_epi32(d, mullo_epi32(s, vf)));
+    }
+#elif defined(PICODSP_NEON)
+    int32x4_t vf = vdupq_n_s32(f);
+    for (; i + 4 <= n; i += 4) {
+        int32x4_t s = vrev64q_s32(vld1q_s32(src + i));
+        s = vcombine_s32(vget_high_s32(s), vget_low_s32(s));
+        vst1q_s32(dst - i - 3, vmlaq_s32(vld1q_s32(dst - i - 3), s, vf));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[-i] += src[i] * f;
+    }
+}
+
+void picodsp_shr_sym(picoos_int32 *x, picoos_int32 shift, picoos_int32 n)
+{
+    picoos_int32 i = 0;
+#if defined(PICODSP_SSE2)
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *) (x + i));
+        _mm_storeu_si128((__m128i *) (x + i), shr_sym_epi32(v, shift));
+    }
+#elif defined(PICODSP_NEON)
+    int32x4_t negshift = vdupq_n_s32(-shift);
+    for (; i + 4 <= n; i += 4) {
+        vst1q_s32(x + i, shr_sym_s32(vld1q_s32(x + i), negshift));
+    }
+#endif
+    for (; i < n; i++) {
+        x[i] = SHR_SYM(x[i], shift);
+    }
+}
+
+void picodsp_add_shl(picoos_int32 *dst, const picoos_int32 *src, picoos_int32 shift, picoos_int32 n)
+{
+    picoos_int32 i = 0;
+#if defined(PICODSP_SSE2)
+    __m128i vs = _mm_cvtsi32_si128(shift);
+    for (; i + 4 <= n; i += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i *) (dst + i));
+        __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_add_epi32(d, _mm_sll_epi32(s, vs)));
+    }
+#elif defined(PICODSP_NEON)
+    int32x4_t vs = vdupq_n_s32(shift);
+    for (; i + 4 <= n; i += 4) {
+        vst1q_s32(dst + i, vaddq_s32(vld1q_s32(dst + i), vshlq_s32(vld1q_s32(src + i), vs)));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] += src[i] << shift;
+    }
+}
+
+picoos_int32 picodsp_window_energy(picoos_int32 *x, const picoos_int32 *w, picoos_int32 n)
+{
+    picoos_int32 i = 0;
+    picoos_uint32 E = 0;
+    picoos_int32 a, b;
+#if defined(PICODSP_SSE2)
+    __m128i acc = _mm_setzero_si128();
+    __m128i va, vb, sign;
+    picoos_int32 part[4];
+    for (; i + 4 <= n; i += 4) {
+        va = mullo_epi32(_mm_srai_epi32(_mm_loadu_si128((const __m128i *) (w + i)), 18),
+                shr_sym_epi32(_mm_loadu_si128((const __m128i *) (x + i)), 11));
+        _mm_storeu_si128((__m128i *) (x + i), va);
+        sign = _mm_srai_epi32(va, 31);
+        vb = _mm_srai_epi32(_mm_sub_epi32(_mm_xor_si128(va, sign), sign), 18);
+        acc = _mm_add_epi32(acc, mullo_epi32(vb, vb));
+    }
+    _mm_storeu_si128((__m128i *) part, acc);
+    E = (picoos_uint32) part[0] + (picoos_uint32) part[1]
+            + (picoos_uint32) part[2] + (picoos_uint32) part[3];
+#elif defined(PICODSP_NEON)
+    int32x4_t acc = vdupq_n_s32(0);
+    int32x4_t negshift = vdupq_n_s32(-11);
+    int32x4_t va, vb;
+    for (; i + 4 <= n; i += 4) {
+        va = vmulq_s32(vshrq_n_s32(vld1q_s32(w + i), 18),
+                shr_sym_s32(vld1q_s32(x + i), negshift));
+        vst1q_s32(x + i, va);
+        vb = vshrq_n_s32(vabsq_s32(va), 18);
+        acc = vmlaq_s32(acc, vb, vb);
+    }
+    E = (picoos_uint32) vgetq_lane_s32(acc, 0) + (picoos_uint32) vgetq_lane_s32(acc, 1)
+            + (picoos_uint32) vgetq_lane_s32(acc, 2) + (picoos_uint32) vgetq_lane_s32(acc, 3);
+#endif
+    for (; i < n; i++) {
+        a = (w[i] >> 18) * SHR_SYM(x[i], 11);
+        x[i] = a;
+        b = (a >= 0 ? a : -a) >> 18;
+        E += (picoos_uint32) (b * b);
+    }
+    return (picoos_int32) E;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/* end picodsp.c */
@@ -29,6 +29,8 @@
 #ifndef PICODSP_H_
 #define PICODSP_H_
 
+#include "picoos.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -105,6 +107,26 @@ extern "C" {
  -----------------------------------------------------------------------------------------*/
 #define EXP(y) picoos_quick_exp(y)
 
+/*------------------------------------------------------------------------------------------
+ Vector kernels of the signal generation (picodsp.c)
+
+ Element-wise loops over a frame, done four samples at a time with NEON or SSE2
+ where the compiler targets it and in plain C otherwise. All variants give
+ bit-identical results; shifts of negative values round towards zero as in the
+ scalar code ("sign-magnitude" shifts).
+ -----------------------------------------------------------------------------------------*/
+/* dst[i] += src[i] * f, i = 0..n-1 */
+void picodsp_mac(picoos_int32 *dst, const picoos_int32 *src, picoos_int32 f, picoos_int32 n);
+/* dst[-i] += src[i] * f, i = 0..n-1 (dst points to the last element written) */
+void picodsp_mac_rev(picoos_int32 *dst, const picoos_int32 *src, picoos_int32 f, picoos_int32 n);
+/* x[i] = x[i] >> shift, rounded towards zero */
+void picodsp_shr_sym(picoos_int32 *x, picoos_int32 shift, picoos_int32 n);
+/* dst[i] += src[i] << shift */
+void picodsp_add_shl(picoos_int32 *dst, const picoos_int32 *src, picoos_int32 shift, picoos_int32 n);
+/* x[i] = (w[i] >> 18) * (x[i] >> 11, rounded towards zero); returns the sum of
+   ((|x[i]| >> 18) ^ 2) over the result, see norm_result() */
+picoos_int32 picodsp_window_energy(picoos_int32 *x, const picoos_int32 *w, picoos_int32 n);
+
 #ifdef __cplusplus
 }
 #endif
@@ -464,16 +464,9 @@ void rdft(picoos_int32 n, picoos_int32 isgn, PICOFFTSG_FFTTYPE *a)
 
 picoos_single norm_result(picoos_int32 m2, PICOFFTSG_FFTTYPE *tmpX, PICOFFTSG_FFTTYPE *norm_window)
 {
-    picoos_int16 nI;
-    PICOFFTSG_FFTTYPE a,b, E;
-
-    E = (picoos_int32)0;
-    for (nI=0; nI<m2; nI++) {
-        a = (norm_window[nI]>>18) * ((tmpX[nI]>0) ? tmpX[nI]>>11 : -((-tmpX[nI])>>11));
-        tmpX[nI] = a;
-        b = (a>=0?a:-a)  >> 18;
-        E += (b*b);
-    }
+    PICOFFTSG_FFTTYPE E;
+
+    E = picodsp_window_energy(tmpX, norm_window, m2);
 
     if (E>0) {
         return (picoos_single)sqrt((double)E/16.0)/m2;
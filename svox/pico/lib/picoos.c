@@ -1267,6 +1267,25 @@ picoos_uint8 picoos_CloseBinary(picoos_Common g, picoos_File * f)
 
 }
 
+picoos_uint8 * picoos_MapBinary(picoos_File f, picoos_uint32 * len)
+{
+    picoos_uint8 * addr = NULL;
+
+    if ((NULL != f) && !f->write) {
+        addr = (picoos_uint8 *) picopal_fmap(f->nf, f->lFileLen);
+    }
+    *len = (NULL == addr) ? 0 : f->lFileLen;
+    return addr;
+}
+
+void picoos_UnmapBinary(picoos_uint8 ** addr, picoos_uint32 len)
+{
+    if (NULL != (*addr)) {
+        picopal_funmap(*addr, len);
+        *addr = NULL;
+    }
+}
+
 /* **************************************************************************************/
 /* *** general routines *****/
 
@@ -299,6 +299,15 @@ picoos_uint8  picoos_WriteBytes(picoos_File f, const picoos_char bytes[],
 /* Close previously opened binary file. */
 picoos_uint8 picoos_CloseBinary(picoos_Common g, picoos_File * f);
 
+/* Map the whole binary file 'f' read-only into memory, outside of any
+ memory manager; 'len' returns the length of the mapping. The mapping
+ remains valid after 'f' is closed, and the pages are shared by all
+ mappings of the file. Returns NULL if the file cannot be mapped. */
+picoos_uint8 * picoos_MapBinary(picoos_File f, picoos_uint32 * len);
+
+/* Release a mapping created by picoos_MapBinary(). */
+void picoos_UnmapBinary(picoos_uint8 ** addr, picoos_uint32 len);
+
 
 
 
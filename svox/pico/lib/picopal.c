@@ -89,6 +89,8 @@ extern "C" {
 #include <time.h>
 #if PICO_PLATFORM == PICO_Windows
 #include <windows.h>
+#else
+#include <sys/mman.h>
 #endif
 
 #if defined(PRAGMA_MESSAGE)
@@ -400,6 +402,34 @@ picopal_objsize_t picopal_fread_bytes (picopal_File f, void * ptr, picopal_objsi
 }
 
 picopal_objsize_t picopal_fwrite_bytes (picopal_File f, void * ptr, picopal_objsize_t objsize, picopal_uint32 nobj){    return (picopal_objsize_t) fwrite(ptr, objsize, nobj, (FILE *)f);}
+
+void * picopal_fmap (picopal_File f, picopal_uint32 length)
+{
+#if PICO_PLATFORM == PICO_Windows
+    /* not yet implemented for Windows */
+    f = f;              /* avoid warning "var not used in this function"*/
+    length = length;    /* avoid warning "var not used in this function"*/
+    return NULL;
+#else
+    void * addr;
+
+    if (0 == length) {
+        return NULL;
+    }
+    addr = mmap(NULL, length, PROT_READ, MAP_SHARED, fileno((FILE *)f), 0);
+    return (MAP_FAILED == addr) ? NULL : addr;
+#endif
+}
+
+void picopal_funmap (void * addr, picopal_uint32 length)
+{
+#if PICO_PLATFORM == PICO_Windows
+    addr = addr;        /* avoid warning "var not used in this function"*/
+    length = length;    /* avoid warning "var not used in this function"*/
+#else
+    munmap(addr, length);
+#endif
+}
 /* *************************************************/
 /* functions for debugging/testing purposes only   */
 /* *************************************************/
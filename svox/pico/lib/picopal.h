@@ -229,6 +229,16 @@ extern picopal_objsize_t picopal_fwrite_bytes (picopal_File f, void * ptr, picop
 
 extern pico_status_t picopal_fflush (picopal_File f);
 
+/* 'fmap' maps the first 'length' bytes of the file 'f' read-only into
+   memory. The mapping stays valid after the file has been closed and is
+   shared with all other mappings of the same file, also across processes.
+   Returns NULL if the file cannot be mapped or if the platform does not
+   support it. */
+extern void * picopal_fmap (picopal_File f, picopal_uint32 length);
+
+/* Releases a mapping created by 'fmap'. */
+extern void picopal_funmap (void * addr, picopal_uint32 length);
+
 /*
 extern pico_status_t picopal_fput_char (picopal_File f, picopal_char ch);
 */
@@ -66,6 +66,8 @@ typedef struct picorsrc_resource {
     picoos_int8 lockCount;  /* count of current subscribers of this resource */
     picoos_File file;
     picoos_uint8 * raw_mem; /* pointer to allocated memory. NULL if preallocated. */
+    picoos_uint8 * map_mem; /* read-only mapping of the file, used instead of raw_mem if available */
+    picoos_uint32 map_len;
     /* picoos_uint32 size; */
     picoos_uint8 * start; /* start of content (after header) */
     picoknow_KnowledgeBase kbList;
@@ -104,6 +106,8 @@ static picorsrc_Resource picorsrc_newResource(picoos_MemoryManager mm)
         this->lockCount = 0;
         this->file = NULL;
         this->raw_mem = NULL;
+        this->map_mem = NULL;
+        this->map_len = 0;
         this->start = NULL;
         this->kbList = NULL;
         /* this->size=0; */
@@ -121,6 +125,7 @@ static void picorsrc_disposeResource(picoos_MemoryManager mm, picorsrc_Resource
         if ((*this)->raw_mem != NULL) {
             picoos_deallocProtMem(mm, (void *) &(*this)->raw_mem);
         }
+        picoos_UnmapBinary(&(*this)->map_mem, (*this)->map_len);
         picoos_deallocate(mm,(void * *)this);
     }
 }
@@ -537,7 +542,7 @@ pico_status_t picorsrc_loadResource(picorsrc_ResourceManager this,
         picoos_char * fileName, picorsrc_Resource * resource)
 {
     picorsrc_Resource res;
-    picoos_uint32 headerlen, len,maxlen;
+    picoos_uint32 headerlen, len,maxlen, pos;
     picoos_file_header_t header;
     picoos_uint8 rem;
     pico_status_t status = PICO_OK;
@@ -594,15 +599,30 @@ pico_status_t picorsrc_loadResource(picorsrc_ResourceManager this,
             /* get data length */
         status = picoos_read_pi_uint32(res->file, &len);
         PICODBG_DEBUG(("found net resource len of %i",len));
+        /* map the file where the platform supports it: the knowledge bases
+         * then don't take up the engine's memory, and all engines and
+         * processes using the same file share its pages */
+        if ((PICO_OK == status) && picoos_GetPos(res->file, &pos)) {
+            res->map_mem = picoos_MapBinary(res->file, &res->map_len);
+            if ((NULL != res->map_mem) && ((res->map_len < pos)
+                    || (res->map_len - pos < len)
+                    || (((uintptr_t) (res->map_mem + pos)) % PICOOS_ALIGN_SIZE))) {
+                picoos_UnmapBinary(&res->map_mem, res->map_len);
+            }
+            if (NULL != res->map_mem) {
+                PICODBG_DEBUG(("mapped resource file %s",fileName));
+                res->start = res->map_mem + pos;
+            }
+        }
         /* allocate memory */
-        if (PICO_OK == status) {
+        if ((PICO_OK == status) && (NULL == res->map_mem)) {
             PICODBG_TRACE((">>> 2"));
             maxlen = len + PICOOS_ALIGN_SIZE; /* once would be sufficient? */
             res->raw_mem = picoos_allocProtMem(this->common->mm, maxlen);
             /* res->size = maxlen; */
             status = (NULL == res->raw_mem) ? PICO_EXC_OUT_OF_MEM : PICO_OK;
         }
-        if (PICO_OK == status) {
+        if ((PICO_OK == status) && (NULL == res->map_mem)) {
             rem = (uintptr_t) res->raw_mem % PICOOS_ALIGN_SIZE;
             if (rem > 0) {
                 res->start = res->raw_mem + (PICOOS_ALIGN_SIZE - rem);
@@ -707,6 +727,7 @@ pico_status_t picorsrc_unloadResource(picorsrc_ResourceManager this, picorsrc_Re
         picoos_deallocProtMem(this->common->mm, (void *) &rsrc->raw_mem);
         PICODBG_DEBUG(("deallocated raw mem"));
     }
+    picoos_UnmapBinary(&rsrc->map_mem, rsrc->map_len);
 
     r1 = NULL;
     r2 = this->resources;
@@ -831,7 +831,7 @@ void td_psola2(sig_innerobj_t *sig_inObj)
     picoos_int32 *t1, *t2;
     picoos_int16 cnt;
     picoos_int32 *fr, *v1, ff, f;
-    picoos_int16 a, i;
+    picoos_int16 a;
     picoos_int32 *window;
     picoos_int16 s = (picoos_int16) 1;
     window = sig_inObj->window_p;
@@ -862,9 +862,7 @@ void td_psola2(sig_innerobj_t *sig_inObj)
             a = 0;
             cnt = PICODSP_FFTSIZE;
             ff = (f * window[sig_inObj->LocV[nI]]) >> PICODSP_SHIFT_FACT1;
-            t1 = &(v1[a + sig_inObj->LocV[nI]]);
-            t2 = &(fr[a]);
-            if (cnt > 0)FAST_DEVICE(cnt,*(t1++)+=*(t2++)*ff;);
+            picodsp_mac(&(v1[a + sig_inObj->LocV[nI]]), &(fr[a]), ff, cnt);
         }
     } else if ((sig_inObj->nV == 0) && (sig_inObj->voiced_p == 0)) {
         /* PURELY UNVOICED*/
@@ -875,16 +873,12 @@ void td_psola2(sig_innerobj_t *sig_inObj)
                 a = 0;
                 cnt = PICODSP_FFTSIZE;
                 ff = (f * window[sig_inObj->LocU[nI]]) >> PICODSP_SHIFT_FACT1;
-                t1 = &(v1[a + sig_inObj->LocU[nI]]);
-                t2 = &(fr[a]);
-                if (cnt > 0)FAST_DEVICE(cnt,*(t1++)+=*(t2++)*ff; );
+                picodsp_mac(&(v1[a + sig_inObj->LocU[nI]]), &(fr[a]), ff, cnt);
             } else { /*s==-1*/
                 a = 0;
                 cnt = PICODSP_FFTSIZE;
                 ff = (f * window[sig_inObj->LocU[nI]]) >> PICODSP_SHIFT_FACT1;
-                t1 = &(v1[(m2 - 1 - a) + sig_inObj->LocU[nI]]);
-                t2 = &(fr[a]);
-                if (cnt > 0)FAST_DEVICE(cnt,*(t1--)+=*(t2++)*ff; );
+                picodsp_mac_rev(&(v1[(m2 - 1 - a) + sig_inObj->LocU[nI]]), &(fr[a]), ff, cnt);
             }
         }
     } else if (sig_inObj->VoicTrans == 0) {
@@ -894,9 +888,7 @@ void td_psola2(sig_innerobj_t *sig_inObj)
             a = 0;
             cnt = PICODSP_FFTSIZE;
             ff = (f * window[sig_inObj->LocV[nI]]) >> PICODSP_SHIFT_FACT1;
-            t1 = &(v1[a + sig_inObj->LocV[nI]]);
-            t2 = &(fr[a]);
-            if (cnt > 0)FAST_DEVICE(cnt,*(t1++)+=*(t2++)*ff;);
+            picodsp_mac(&(v1[a + sig_inObj->LocV[nI]]), &(fr[a]), ff, cnt);
         }
         /*add remaining stuff from unvoiced part*/
         for (nI = 0; nI < sig_inObj->nU; nI++) {
@@ -906,16 +898,12 @@ void td_psola2(sig_innerobj_t *sig_inObj)
                 a = 0;
                 cnt = PICODSP_FFTSIZE;
                 ff = (f * window[sig_inObj->LocU[nI]]) >> PICODSP_SHIFT_FACT1;
-                t1 = &(v1[a + sig_inObj->LocU[nI]]);
-                t2 = &(sig_inObj->ImpResp_p[a]); /*saved impulse response*/
-                if (cnt > 0)FAST_DEVICE(cnt,*(t1++)+=*(t2++)*ff; );
+                picodsp_mac(&(v1[a + sig_inObj->LocU[nI]]), &(sig_inObj->ImpResp_p[a]), ff, cnt); /*saved impulse response*/
             } else {
                 a = 0;
                 cnt = PICODSP_FFTSIZE;
                 ff = (f * window[sig_inObj->LocU[nI]]) >> PICODSP_SHIFT_FACT1;
-                t1 = &(v1[(m2 - 1 - a) + sig_inObj->LocU[nI]]);
-                t2 = &(sig_inObj->ImpResp_p[a]);
-                if (cnt > 0)FAST_DEVICE(cnt,*(t1--)+=*(t2++)*ff; );
+                picodsp_mac_rev(&(v1[(m2 - 1 - a) + sig_inObj->LocU[nI]]), &(sig_inObj->ImpResp_p[a]), ff, cnt);
             }
         }
     } else {
@@ -927,16 +915,12 @@ void td_psola2(sig_innerobj_t *sig_inObj)
                 a = 0;
                 cnt = PICODSP_FFTSIZE;
                 ff = (f * window[sig_inObj->LocU[nI]]) >> PICODSP_SHIFT_FACT1;
-                t1 = &(v1[a + sig_inObj->LocU[nI]]);
-                t2 = &(fr[a]);
-                if (cnt > 0)FAST_DEVICE(cnt,*(t1++)+=*(t2++)*ff; );
+                picodsp_mac(&(v1[a + sig_inObj->LocU[nI]]), &(fr[a]), ff, cnt);
             } else {
                 a = 0;
                 cnt = PICODSP_FFTSIZE;
                 ff = (f * window[sig_inObj->LocU[nI]]) >> PICODSP_SHIFT_FACT1;
-                t1 = &(v1[(m2 - 1 - a) + sig_inObj->LocU[nI]]);
-                t2 = &(fr[a]);
-                if (cnt > 0)FAST_DEVICE(cnt,*(t1--)+=*(t2++)*ff; );
+                picodsp_mac_rev(&(v1[(m2 - 1 - a) + sig_inObj->LocU[nI]]), &(fr[a]), ff, cnt);
             }
         }
         /*add remaining stuff from voiced part*/
@@ -945,19 +929,11 @@ void td_psola2(sig_innerobj_t *sig_inObj)
             a = 0;
             cnt = PICODSP_FFTSIZE;
             ff = (f * window[sig_inObj->LocV[nI]]) >> PICODSP_SHIFT_FACT1;
-            t1 = &(v1[a + sig_inObj->LocV[nI]]);
-            t2 = &(sig_inObj->ImpResp_p[a]);
-            if (cnt > 0)FAST_DEVICE(cnt,*(t1++)+=*(t2++)*ff;);
+            picodsp_mac(&(v1[a + sig_inObj->LocV[nI]]), &(sig_inObj->ImpResp_p[a]), ff, cnt);
         }
     }
 
-    t1 = sig_inObj->sig_vec1;
-    for (i = 0; i < PICODSP_FFTSIZE; i++, t1++) {
-        if (*t1 >= 0)
-            *t1 >>= PICODSP_SHIFT_FACT5;
-        else
-            *t1 = -((-*t1) >> PICODSP_SHIFT_FACT5);
-    }
+    picodsp_shr_sym(sig_inObj->sig_vec1, PICODSP_SHIFT_FACT5, PICODSP_FFTSIZE);
 
 }/*td_psola2*/
 
@@ -986,7 +962,7 @@ void overlap_add(sig_innerobj_t *sig_inObj)
     w = sig_inObj->WavBuff_p;
     v = sig_inObj->sig_vec1;
 
-    FAST_DEVICE(PICODSP_FFTSIZE, *(w++)+=*(v++)<<PICODSP_SHIFT_FACT6;);
+    picodsp_add_shl(w, v, PICODSP_SHIFT_FACT6, PICODSP_FFTSIZE);
 
 }/*overlap_add*/
 
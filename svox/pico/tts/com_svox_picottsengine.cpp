@@ -64,6 +64,11 @@ using namespace android;
 #define PICO_MAX_VOLUME     500
 #define PICO_DEF_VOLUME     100
 
+/* amount of audio passed to the callback first; doubled with every further
+   callback up to the full buffer, so that playback starts early without
+   calling back for every few samples of a long text                        */
+#define PICO_MIN_FLUSH_SIZE  2048
+
 /* string constants */
 #define MAX_OUTBUF_SIZE     128
 const char * PICO_SYSTEM_LINGWARE_PATH      = "/system/tts/lang_pico/";
@@ -1556,6 +1561,7 @@ tts_result TtsEngine::synthesizeText( const char * text, int8_t * buffer, size_t
     inp = (pico_Char *) local_text;
 
     size_t bufused = 0;
+    size_t flushsize = (bufferSize < PICO_MIN_FLUSH_SIZE) ? bufferSize : PICO_MIN_FLUSH_SIZE;
 
     /* synthesis loop   */
     while (text_remaining) {
@@ -1585,11 +1591,9 @@ tts_result TtsEngine::synthesizeText( const char * text, int8_t * buffer, size_t
             ret = pico_getData( picoEngine, (void *) outbuf, MAX_OUTBUF_SIZE, &bytes_recv,
                     &out_data_type );
             if (bytes_recv) {
-                if ((bufused + bytes_recv) <= bufferSize) {
-                    memcpy(buffer+bufused, (int8_t *) outbuf, bytes_recv);
-                    bufused += bytes_recv;
-                } else {
-                    /* The buffer filled; pass this on to the callback function.    */
+                if ((bufused > 0) && ((bufused >= flushsize) || ((bufused + bytes_recv) > bufferSize))) {
+                    /* Enough audio for now, or the buffer filled; pass this on to the
+                       callback function.                                           */
                     cbret = picoSynthDoneCBPtr(userdata, 16000, TTS_AUDIO_FORMAT_PCM_16_BIT, 1, buffer,
                             bufused, TTS_SYNTH_PENDING);
                     if (cbret == TTS_CALLBACK_HALT) {
@@ -1599,9 +1603,14 @@ tts_result TtsEngine::synthesizeText( const char * text, int8_t * buffer, size_t
                         break;
                     }
                     bufused = 0;
-                    memcpy(buffer, (int8_t *) outbuf, bytes_recv);
-                    bufused += bytes_recv;
+                    if (flushsize < bufferSize / 2) {
+                        flushsize *= 2;
+                    } else {
+                        flushsize = bufferSize;
+                    }
                 }
+                memcpy(buffer+bufused, (int8_t *) outbuf, bytes_recv);
+                bufused += bytes_recv;
             }
         } while (PICO_STEP_BUSY == ret);
 
@@ -1610,6 +1619,7 @@ tts_result TtsEngine::synthesizeText( const char * text, int8_t * buffer, size_t
         if (!picoSynthAbort) {
             picoSynthDoneCBPtr( userdata, 16000, TTS_AUDIO_FORMAT_PCM_16_BIT, 1, buffer, bufused,
                     TTS_SYNTH_PENDING);
+            bufused = 0;
         }
         picoSynthAbort = 0;
 
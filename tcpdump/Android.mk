@@ -6,8 +6,10 @@ tcpdump_src_files := \
   bpf_dump.c \
   checksum.c \
   cpack.c \
+  flows.c \
   gmpls.c \
   gmt2local.c \
+  gzdump.c \
   in_cksum.c \
   ipproto.c \
   l2vpn.c \
@@ -153,6 +155,8 @@ tcpdump_src_files := \
   print-wb.c \
   print-zephyr.c \
   print-zeromq.c \
+  readahead.c \
+  resolver.c \
   setsignal.c \
   signature.c \
   smbutil.c \
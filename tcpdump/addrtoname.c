@@ -64,6 +64,7 @@ extern int ether_ntohost(char *, const struct ether_addr *);
 #include "setsignal.h"
 #include "extract.h"
 #include "oui.h"
+#include "resolver.h"
 
 #ifndef ETHER_ADDR_LEN
 #define ETHER_ADDR_LEN	6
@@ -79,6 +80,7 @@ extern int ether_ntohost(char *, const struct ether_addr *);
 
 struct hnamemem {
 	uint32_t addr;
+	int pending;		/* name being looked up by the resolver */
 	const char *name;
 	struct hnamemem *nxt;
 };
@@ -133,6 +135,7 @@ win32_gethostbyaddr(const char *addr, int len, int type)
 #ifdef INET6
 struct h6namemem {
 	struct in6_addr addr;
+	int pending;		/* name being looked up by the resolver */
 	char *name;
 	struct h6namemem *nxt;
 };
@@ -199,6 +202,26 @@ intoa(uint32_t addr)
 static uint32_t f_netmask;
 static uint32_t f_localnet;
 
+/*
+ * Return a copy of a host name, without the domain if -N was given.
+ */
+static char *
+host_name(netdissect_options *ndo, const char *name)
+{
+	char *cp, *dotp;
+
+	cp = strdup(name);
+	if (cp == NULL)
+		error("host_name: strdup");
+	if (ndo->ndo_Nflag) {
+		/* Remove domain qualifications */
+		dotp = strchr(cp, '.');
+		if (dotp)
+			*dotp = '\0';
+	}
+	return (cp);
+}
+
 /*
  * Return a name for the IP address pointed to by ap.  This address
  * is assumed to be in network byte order.
@@ -243,17 +266,25 @@ getname(netdissect_options *ndo, const u_char *ap)
 	 */
 	if (!ndo->ndo_nflag &&
 	    (addr & f_netmask) == f_localnet) {
+#ifdef HAVE_RESOLVER
+		if (ndo->ndo_async_resolve) {
+			const char *name;
+
+			switch (resolver_lookup(AF_INET, &addr, &name)) {
+			case RESOLVER_FOUND:
+				p->name = host_name(ndo, name);
+				return (p->name);
+			case RESOLVER_PENDING:
+				p->pending = 1;
+				break;
+			}
+			p->name = strdup(intoa(addr));
+			return (p->name);
+		}
+#endif
 		hp = gethostbyaddr((char *)&addr, 4, AF_INET);
 		if (hp) {
-			char *dotp;
-
-			p->name = strdup(hp->h_name);
-			if (ndo->ndo_Nflag) {
-				/* Remove domain qualifications */
-				dotp = strchr(p->name, '.');
-				if (dotp)
-					*dotp = '\0';
-			}
+			p->name = host_name(ndo, hp->h_name);
 			return (p->name);
 		}
 	}
@@ -294,18 +325,26 @@ getname6(netdissect_options *ndo, const u_char *ap)
 	 * Do not print names if -n was given.
 	 */
 	if (!ndo->ndo_nflag) {
-		hp = gethostbyaddr((char *)&addr, sizeof(addr), AF_INET6);
-		if (hp) {
-			char *dotp;
-
-			p->name = strdup(hp->h_name);
-			if (ndo->ndo_Nflag) {
-				/* Remove domain qualifications */
-				dotp = strchr(p->name, '.');
-				if (dotp)
-					*dotp = '\0';
+#ifdef HAVE_RESOLVER
+		if (ndo->ndo_async_resolve) {
+			const char *name;
+
+			switch (resolver_lookup(AF_INET6, &addr, &name)) {
+			case RESOLVER_FOUND:
+				p->name = host_name(ndo, name);
+				return (p->name);
+			case RESOLVER_PENDING:
+				p->pending = 1;
+				break;
+			}
+		} else
+#endif
+		{
+			hp = gethostbyaddr((char *)&addr, sizeof(addr), AF_INET6);
+			if (hp) {
+				p->name = host_name(ndo, hp->h_name);
+				return (p->name);
 			}
-			return (p->name);
 		}
 	}
 	cp = inet_ntop(AF_INET6, &addr, ntop_buf, sizeof(ntop_buf));
@@ -314,6 +353,56 @@ getname6(netdissect_options *ndo, const u_char *ap)
 }
 #endif /* INET6 */
 
+#ifdef HAVE_RESOLVER
+/*
+ * Replace the numbers printed for addresses, while the resolver was
+ * looking them up, with the names it has found since the last call.
+ * Called between packets, so nothing still points to the old strings.
+ */
+void
+update_names(netdissect_options *ndo)
+{
+	u_char addr[16];
+	const char *name;
+	struct hnamemem *p;
+#ifdef INET6
+	struct h6namemem *p6;
+	uint16_t d;
+#endif
+	uint32_t addr4;
+	int af, status;
+
+	while ((status = resolver_result(&af, addr, &name)) != 0) {
+		if (status != RESOLVER_FOUND)
+			continue;
+#ifdef INET6
+		if (af == AF_INET6) {
+			memcpy(&d, addr + 14, sizeof(d));
+			for (p6 = &h6nametable[d & (HASHNAMESIZE-1)]; p6->nxt;
+			    p6 = p6->nxt)
+				if (p6->pending &&
+				    memcmp(&p6->addr, addr, sizeof(p6->addr)) == 0) {
+					free(p6->name);
+					p6->name = host_name(ndo, name);
+					p6->pending = 0;
+					break;
+				}
+			continue;
+		}
+#endif
+		memcpy(&addr4, addr, sizeof(addr4));
+		for (p = &hnametable[addr4 & (HASHNAMESIZE-1)]; p->nxt;
+		    p = p->nxt)
+			if (p->pending && p->addr == addr4) {
+				free((char *)p->name);
+				p->name = host_name(ndo, name);
+				p->pending = 0;
+				break;
+			}
+	}
+}
+#endif /* HAVE_RESOLVER */
+
 static const char hex[] = "0123456789abcdef";
 
 
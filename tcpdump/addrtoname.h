@@ -45,6 +45,7 @@ extern const char *getname(netdissect_options *, const u_char *);
 extern const char *getname6(netdissect_options *, const u_char *);
 #endif
 extern const char *intoa(uint32_t);
+extern void update_names(netdissect_options *);	/* with --async-resolve */
 
 extern void init_addrtoname(netdissect_options *, uint32_t, uint32_t);
 extern struct hnamemem *newhnamemem(void);
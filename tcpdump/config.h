@@ -23,9 +23,15 @@
 /* Define to 1 if you have the <fcntl.h> header file. */
 #define HAVE_FCNTL_H 1
 
+/* Define to 1 if you have the `fopencookie' function. */
+/* #undef HAVE_FOPENCOOKIE */
+
 /* Define to 1 if you have the `fork' function. */
 #define HAVE_FORK 1
 
+/* Define to 1 if you have the `funopen' function. */
+#define HAVE_FUNOPEN 1
+
 /* Define to 1 if you have the `getnameinfo' function. */
 #define HAVE_GETNAMEINFO 1
 
@@ -41,12 +47,18 @@
 /* Define to 1 if you have the `crypto' library (-lcrypto). */
 #define HAVE_LIBCRYPTO 1
 
+/* Define to 1 if you have the `pthread' library (-lpthread). */
+#define HAVE_LIBPTHREAD 1
+
 /* Define to 1 if you have the `rpc' library (-lrpc). */
 /* #undef HAVE_LIBRPC */
 
 /* Define to 1 if you have the `smi' library (-lsmi). */
 /* #undef HAVE_LIBSMI */
 
+/* Define to 1 if you have the `z' library (-lz). */
+/* #undef HAVE_LIBZ */
+
 /* Define to 1 if you have the <memory.h> header file. */
 #define HAVE_MEMORY_H 1
 
@@ -92,6 +104,9 @@
 /* Define to 1 if you have the `pcap_dump_flush' function. */
 #define HAVE_PCAP_DUMP_FLUSH 1
 
+/* Define to 1 if you have the `pcap_dump_fopen' function. */
+#define HAVE_PCAP_DUMP_FOPEN 1
+
 /* define if libpcap has pcap_dump_ftell() */
 #define HAVE_PCAP_DUMP_FTELL 1
 
@@ -107,6 +122,9 @@
 /* define if libpcap has pcap_list_datalinks() */
 #define HAVE_PCAP_LIST_DATALINKS 1
 
+/* Define to 1 if you have the `pcap_next_ex' function. */
+#define HAVE_PCAP_NEXT_EX 1
+
 /* Define to 1 if you have the <pcap/nflog.h> header file. */
 #define HAVE_PCAP_NFLOG_H 1
 
@@ -212,6 +230,9 @@
 /* define if libpcap has yydebug */
 /* #undef HAVE_YYDEBUG */
 
+/* Define to 1 if you have the <zlib.h> header file. */
+/* #undef HAVE_ZLIB_H */
+
 /* define if your compiler has __attribute__ */
 #define HAVE___ATTRIBUTE__ 1
 
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2015 The TCPDUMP project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that: (1) source code
+ * distributions retain the above copyright notice and this paragraph
+ * in its entirety, and (2) distributions including binary code include
+ * the above copyright notice and this paragraph in its entirety in
+ * the documentation or other materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND
+ * WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ */
+
+/*
+ * --summary: packet and byte counts per IP protocol and per flow.
+ *
+ * A flow is the addresses, IP protocol and, for the protocols that have
+ * them, ports of a packet.  The flows are kept in an open-addressed hash
+ * table, which doubles when it is three quarters full, up to FLOW_TABLE_MAX
+ * slots; the packets of the flows that don't fit are only counted in the
+ * per-protocol totals.
+ */
+
+#define NETDISSECT_REWORKED
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <tcpdump-stdinc.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "interface.h"
+#include "extract.h"
+#include "ipproto.h"
+#include "flows.h"
+
+#define FLOW_TABLE_MIN	1024		/* slots */
+#define FLOW_TABLE_MAX	(512 * 1024)
+
+struct flow_key {
+	u_char af;		/* AF_INET or AF_INET6 */
+	u_char proto;
+	uint16_t sport;
+	uint16_t dport;
+	u_char src[16];		/* IPv4 addresses are zero-padded */
+	u_char dst[16];
+};
+
+struct flow {
+	struct flow_key key;
+	u_int packets;		/* 0 if the slot is empty */
+	uint64_t bytes;
+};
+
+struct proto_count {
+	u_int packets;
+	uint64_t bytes;
+};
+
+struct flow_table {
+	struct flow *flows;
+	u_int size;		/* a power of 2 */
+	u_int used;
+	u_int dropped;		/* packets of flows that didn't fit */
+	struct proto_count protos[256];
+};
+
+struct flow_table *
+flow_table_new(void)
+{
+	struct flow_table *ft;
+
+	ft = (struct flow_table *)calloc(1, sizeof(*ft));
+	if (ft == NULL)
+		return NULL;
+	ft->flows = (struct flow *)calloc(FLOW_TABLE_MIN, sizeof(*ft->flows));
+	if (ft->flows == NULL) {
+		free(ft);
+		return NULL;
+	}
+	ft->size = FLOW_TABLE_MIN;
+	return ft;
+}
+
+/* FNV-1a */
+static u_int
+flow_hash(const struct flow_key *key)
+{
+	const u_char *p = (const u_char *)key;
+	uint32_t h = 2166136261U;
+	size_t i;
+
+	for (i = 0; i < sizeof(*key); i++) {
+		h ^= p[i];
+		h *= 16777619;
+	}
+	return h;
+}
+
+/* The slot for KEY in FLOWS: its flow, or the empty slot where it goes. */
+static struct flow *
+flow_slot(struct flow *flows, u_int size, const struct flow_key *key)
+{
+	u_int i = flow_hash(key) & (size - 1);
+
+	while (flows[i].packets != 0 &&
+	    memcmp(&flows[i].key, key, sizeof(*key)) != 0)
+		i = (i + 1) & (size - 1);
+	return &flows[i];
+}
+
+/* 0 if the table can't grow */
+static int
+flow_table_grow(struct flow_table *ft)
+{
+	struct flow *flows;
+	u_int i, size = ft->size * 2;
+
+	if (size > FLOW_TABLE_MAX)
+		return 0;
+	flows = (struct flow *)calloc(size, sizeof(*flows));
+	if (flows == NULL)
+		return 0;
+	for (i = 0; i < ft->size; i++)
+		if (ft->flows[i].packets != 0)
+			*flow_slot(flows, size, &ft->flows[i].key) =
+			    ft->flows[i];
+	free(ft->flows);
+	ft->flows = flows;
+	ft->size = size;
+	return 1;
+}
+
+void
+flow_count(netdissect_options *ndo, int af, const void *src, const void *dst,
+    u_int proto, const u_char *cp, u_int len)
+{
+	struct flow_table *ft = ndo->ndo_flows;
+	struct flow_key key;
+	struct flow *f;
+	size_t alen = 4;
+
+#ifdef AF_INET6
+	if (af == AF_INET6)
+		alen = 16;
+#endif
+	memset(&key, 0, sizeof(key));
+	key.af = af;
+	key.proto = proto;
+	memcpy(key.src, src, alen);
+	memcpy(key.dst, dst, alen);
+	switch (proto) {
+
+	case IPPROTO_TCP:
+	case IPPROTO_UDP:
+	case IPPROTO_SCTP:
+	case IPPROTO_DCCP:
+		if (cp != NULL && ND_TTEST2(*cp, 4)) {
+			key.sport = EXTRACT_16BITS(cp);
+			key.dport = EXTRACT_16BITS(cp + 2);
+		}
+		break;
+	}
+
+	ft->protos[proto & 0xff].packets++;
+	ft->protos[proto & 0xff].bytes += len;
+
+	f = flow_slot(ft->flows, ft->size, &key);
+	if (f->packets == 0) {
+		if (ft->used >= ft->size / 4 * 3) {
+			if (!flow_table_grow(ft)) {
+				ft->dropped++;
+				return;
+			}
+			f = flow_slot(ft->flows, ft->size, &key);
+		}
+		f->key = key;
+		ft->used++;
+	}
+	f->packets++;
+	f->bytes += len;
+}
+
+static int
+flow_cmp(const void *a, const void *b)
+{
+	const struct flow *fa = *(const struct flow * const *)a;
+	const struct flow *fb = *(const struct flow * const *)b;
+
+	if (fa->bytes != fb->bytes)
+		return fa->bytes < fb->bytes ? 1 : -1;
+	return 0;
+}
+
+static void
+flow_endpoint(char *buf, size_t len, const struct flow *f, const u_char *addr,
+    uint16_t port)
+{
+	char addrstr[64];
+
+	if (inet_ntop(f->key.af, addr, addrstr, sizeof(addrstr)) == NULL)
+		strcpy(addrstr, "?");
+	if (f->key.sport != 0 || f->key.dport != 0)
+		snprintf(buf, len, "%s.%u", addrstr, port);
+	else
+		snprintf(buf, len, "%s", addrstr);
+}
+
+void
+flow_table_print(struct flow_table *ft, u_int n)
+{
+	struct flow **sorted;
+	char src[80], dst[80];
+	u_int i, nflows = 0;
+
+	(void)printf("%-24s %10s %14s\n", "IP protocol", "packets",
+	    "bytes");
+	for (i = 0; i < 256; i++)
+		if (ft->protos[i].packets != 0)
+			(void)printf("  %-22s %10u %14" PRIu64 "\n",
+			    tok2str(ipproto_values, "%u", i),
+			    ft->protos[i].packets, ft->protos[i].bytes);
+
+	(void)printf("%u flow%s", ft->used, PLURAL_SUFFIX(ft->used));
+	if (ft->dropped != 0)
+		(void)printf(" (%u packet%s of other flows not counted)",
+		    ft->dropped, PLURAL_SUFFIX(ft->dropped));
+	(void)printf("\n");
+	if (ft->used == 0 || n == 0)
+		return;
+
+	sorted = (struct flow **)malloc(ft->used * sizeof(*sorted));
+	if (sorted == NULL)
+		return;
+	for (i = 0; i < ft->size; i++)
+		if (ft->flows[i].packets != 0)
+			sorted[nflows++] = &ft->flows[i];
+	qsort(sorted, nflows, sizeof(*sorted), flow_cmp);
+	if (n > nflows)
+		n = nflows;
+	for (i = 0; i < n; i++) {
+		flow_endpoint(src, sizeof(src), sorted[i], sorted[i]->key.src,
+		    sorted[i]->key.sport);
+		flow_endpoint(dst, sizeof(dst), sorted[i], sorted[i]->key.dst,
+		    sorted[i]->key.dport);
+		(void)printf("  %s %s > %s: %u packet%s, %" PRIu64 " bytes\n",
+		    tok2str(ipproto_values, "ip-proto-%u", sorted[i]->key.proto),
+		    src, dst, sorted[i]->packets,
+		    PLURAL_SUFFIX(sorted[i]->packets), sorted[i]->bytes);
+	}
+	free(sorted);
+}
+
+void
+flow_table_reset(struct flow_table *ft)
+{
+	memset(ft->flows, 0, ft->size * sizeof(*ft->flows));
+	memset(ft->protos, 0, sizeof(ft->protos));
+	ft->used = 0;
+	ft->dropped = 0;
+}
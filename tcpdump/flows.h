@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2015 The TCPDUMP project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that: (1) source code
+ * distributions retain the above copyright notice and this paragraph
+ * in its entirety, and (2) distributions including binary code include
+ * the above copyright notice and this paragraph in its entirety in
+ * the documentation or other materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND
+ * WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ */
+#ifndef flows_h
+#define flows_h
+
+struct flow_table;
+
+/* NULL if it can't be allocated */
+extern struct flow_table *flow_table_new(void);
+
+/*
+ * Count an IP packet of LEN bytes, from SRC to DST, in its flow; the
+ * ports are taken from the transport header at CP, if it isn't NULL.
+ */
+extern void flow_count(netdissect_options *, int, const void *, const void *,
+    u_int, const u_char *, u_int);
+
+/*
+ * Print, to the standard output, the packets per IP protocol and the N
+ * flows with the most bytes.
+ */
+extern void flow_table_print(struct flow_table *, u_int);
+extern void flow_table_reset(struct flow_table *);
+
+#endif
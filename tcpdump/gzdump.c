@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) 2015 The TCPDUMP project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that: (1) source code
+ * distributions retain the above copyright notice and this paragraph
+ * in its entirety, and (2) distributions including binary code include
+ * the above copyright notice and this paragraph in its entirety in
+ * the documentation or other materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND
+ * WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ */
+
+/*
+ * --gzip: compress savefiles as they are written, on a separate thread.
+ *
+ * The savefile is handed to pcap_dump_fopen() as a stdio stream whose
+ * writes are copied into 1MB chunks.  Full chunks are queued for the
+ * writer thread, which deflates them and writes the result to the file,
+ * so the capture only copies packets.  If the writer falls GZ_MAX_BACKLOG
+ * chunks behind, the capture waits for it; how often, and the largest
+ * backlog, are reported on exit.
+ */
+
+#define _GNU_SOURCE		/* for fopencookie() */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <tcpdump-stdinc.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "interface.h"
+#include "gzdump.h"
+
+#ifdef HAVE_GZDUMP
+
+#include <pthread.h>
+#include <signal.h>
+#include <zlib.h>
+
+#define GZ_CHUNK_SIZE	(1024 * 1024)
+#define GZ_MAX_BACKLOG	64		/* chunks */
+#define GZ_OUT_SIZE	(256 * 1024)
+#define GZ_STDIO_SIZE	(64 * 1024)
+
+struct gzchunk;
+
+struct gzdump {
+	FILE *fp;		/* the savefile */
+	FILE *cookie_fp;	/* the stream handed to pcap_dump_fopen() */
+	z_stream zs;
+	struct gzchunk *chunk;	/* being filled by the capture */
+	off_t offset;		/* bytes written, for pcap_dump_ftell() */
+	int finished;		/* the last chunk has been queued */
+	int closed;		/* ... by gz_close(), so the writer frees this */
+	struct gzdump *next;	/* open streams, for gzdump_exit() */
+};
+
+struct gzchunk {
+	struct gzdump *gz;
+	char *buf;
+	size_t len;
+	int last;		/* finish the gzip stream and close the file */
+	struct gzchunk *next;
+};
+
+static pthread_mutex_t gz_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t chunk_queued = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t chunk_written = PTHREAD_COND_INITIALIZER;
+
+static struct gzchunk *queue, **queue_tail = &queue;
+static struct gzchunk *free_chunks;
+static struct gzdump *open_streams;
+static int writer_started;
+static u_char *gz_out;		/* the writer's deflate() output */
+
+/* chunks queued or being written, and statistics for gzdump_exit() */
+static u_int queued, max_queued, stalls;
+static double bytes_in, bytes_out;
+static int write_failed;
+
+static int
+write_all(int fd, const u_char *buf, size_t len)
+{
+	ssize_t n;
+
+	while (len > 0) {
+		n = write(fd, buf, len);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		buf += n;
+		len -= n;
+	}
+	return 0;
+}
+
+static void
+gz_deflate(struct gzdump *gz, struct gzchunk *c, u_char *out)
+{
+	size_t n;
+
+	gz->zs.next_in = (Bytef *)c->buf;
+	gz->zs.avail_in = c->len;
+	do {
+		gz->zs.next_out = out;
+		gz->zs.avail_out = GZ_OUT_SIZE;
+		(void)deflate(&gz->zs, c->last ? Z_FINISH : Z_NO_FLUSH);
+		n = GZ_OUT_SIZE - gz->zs.avail_out;
+		if (write_all(fileno(gz->fp), out, n) < 0 && !write_failed) {
+			warning("can't write savefile: %s", strerror(errno));
+			write_failed = 1;
+		}
+		bytes_out += n;
+	} while (gz->zs.avail_out == 0);
+	bytes_in += c->len;
+}
+
+static void *
+gz_writer(void *arg _U_)
+{
+	struct gzchunk *c;
+	struct gzdump *gz;
+
+	pthread_mutex_lock(&gz_lock);
+	for (;;) {
+		while (queue == NULL)
+			pthread_cond_wait(&chunk_queued, &gz_lock);
+		c = queue;
+		queue = c->next;
+		if (queue == NULL)
+			queue_tail = &queue;
+		pthread_mutex_unlock(&gz_lock);
+
+		gz = c->gz;
+		gz_deflate(gz, c, gz_out);
+		if (c->last) {
+			(void)deflateEnd(&gz->zs);
+			(void)fclose(gz->fp);
+		}
+
+		pthread_mutex_lock(&gz_lock);
+		if (c->last && gz->closed)
+			free(gz);
+		c->next = free_chunks;
+		free_chunks = c;
+		queued--;
+		pthread_cond_broadcast(&chunk_written);
+	}
+	/* NOTREACHED */
+	return NULL;
+}
+
+/* Called with gz_lock held. */
+static struct gzchunk *
+get_chunk(void)
+{
+	struct gzchunk *c;
+
+	c = free_chunks;
+	if (c != NULL)
+		free_chunks = c->next;
+	else {
+		c = (struct gzchunk *)malloc(sizeof(*c));
+		if (c == NULL || (c->buf = (char *)malloc(GZ_CHUNK_SIZE)) == NULL)
+			error("gzdump: malloc");
+	}
+	c->len = 0;
+	return c;
+}
+
+static void
+queue_chunk(struct gzdump *gz, int last)
+{
+	struct gzchunk *c = gz->chunk;
+
+	pthread_mutex_lock(&gz_lock);
+	if (queued >= GZ_MAX_BACKLOG) {
+		stalls++;
+		while (queued >= GZ_MAX_BACKLOG)
+			pthread_cond_wait(&chunk_written, &gz_lock);
+	}
+	c->gz = gz;
+	c->last = last;
+	c->next = NULL;
+	*queue_tail = c;
+	queue_tail = &c->next;
+	if (++queued > max_queued)
+		max_queued = queued;
+	pthread_cond_signal(&chunk_queued);
+	gz->chunk = last ? NULL : get_chunk();
+	pthread_mutex_unlock(&gz_lock);
+}
+
+/* Called with gz_lock held. */
+static void
+unlink_stream(struct gzdump *gz)
+{
+	struct gzdump **p;
+
+	for (p = &open_streams; *p != NULL; p = &(*p)->next)
+		if (*p == gz) {
+			*p = gz->next;
+			break;
+		}
+}
+
+static ssize_t
+gz_write(void *cookie, const char *buf, size_t size)
+{
+	struct gzdump *gz = (struct gzdump *)cookie;
+	size_t left = size, n;
+
+	if (gz->finished)
+		return size;
+
+	while (left > 0) {
+		n = GZ_CHUNK_SIZE - gz->chunk->len;
+		if (n > left)
+			n = left;
+		memcpy(gz->chunk->buf + gz->chunk->len, buf, n);
+		gz->chunk->len += n;
+		buf += n;
+		left -= n;
+		if (gz->chunk->len == GZ_CHUNK_SIZE)
+			queue_chunk(gz, 0);
+	}
+	gz->offset += size;
+	return size;
+}
+
+static int
+gz_close(void *cookie)
+{
+	struct gzdump *gz = (struct gzdump *)cookie;
+
+	if (gz->finished)
+		return 0;
+	pthread_mutex_lock(&gz_lock);
+	unlink_stream(gz);
+	pthread_mutex_unlock(&gz_lock);
+	gz->finished = 1;
+	gz->closed = 1;
+	queue_chunk(gz, 1);
+	return 0;
+}
+
+#ifdef HAVE_FOPENCOOKIE
+/* Only for ftell(), which asks for the current offset. */
+static int
+gz_seek(void *cookie, off64_t *offset, int whence)
+{
+	struct gzdump *gz = (struct gzdump *)cookie;
+
+	if (whence != SEEK_CUR || *offset != 0) {
+		errno = ESPIPE;
+		return -1;
+	}
+	*offset = gz->offset;
+	return 0;
+}
+#else
+static int
+gz_write_bsd(void *cookie, const char *buf, int size)
+{
+	return gz_write(cookie, buf, size);
+}
+
+/* Only for ftell(), which asks for the current offset. */
+static fpos_t
+gz_seek_bsd(void *cookie, fpos_t offset, int whence)
+{
+	struct gzdump *gz = (struct gzdump *)cookie;
+
+	if (whence != SEEK_CUR || offset != 0) {
+		errno = ESPIPE;
+		return -1;
+	}
+	return gz->offset;
+}
+#endif
+
+/*
+ * Finish the files still open on exit, which tcpdump doesn't close,
+ * and wait for the writer to get them to disk.
+ */
+static void
+gzdump_exit(void)
+{
+	struct gzdump *gz, *next;
+
+	for (gz = open_streams; gz != NULL; gz = gz->next)
+		(void)fflush(gz->cookie_fp);
+
+	pthread_mutex_lock(&gz_lock);
+	gz = open_streams;
+	open_streams = NULL;
+	pthread_mutex_unlock(&gz_lock);
+	for (; gz != NULL; gz = next) {
+		next = gz->next;
+		gz->finished = 1;
+		queue_chunk(gz, 1);
+	}
+
+	pthread_mutex_lock(&gz_lock);
+	while (queued > 0)
+		pthread_cond_wait(&chunk_written, &gz_lock);
+	pthread_mutex_unlock(&gz_lock);
+
+	(void)fprintf(stderr,
+	    "gzip: %.1f MB compressed to %.1f MB, writer backlog peaked at %u MB, capture waited %u time%s\n",
+	    bytes_in / (1024 * 1024), bytes_out / (1024 * 1024),
+	    max_queued * (GZ_CHUNK_SIZE / (1024 * 1024)), stalls,
+	    PLURAL_SUFFIX(stalls));
+}
+
+/* Called with gz_lock held. */
+static void
+start_writer(void)
+{
+	pthread_t thread;
+	sigset_t mask, omask;
+	int err;
+
+	gz_out = (u_char *)malloc(GZ_OUT_SIZE);
+	if (gz_out == NULL)
+		error("gzdump: malloc");
+
+	/* Signals are handled on the main thread. */
+	sigfillset(&mask);
+	pthread_sigmask(SIG_SETMASK, &mask, &omask);
+	err = pthread_create(&thread, NULL, gz_writer, NULL);
+	pthread_sigmask(SIG_SETMASK, &omask, NULL);
+	if (err != 0)
+		error("gzdump: can't create the writer thread");
+	pthread_detach(thread);
+	atexit(gzdump_exit);
+	writer_started = 1;
+}
+
+FILE *
+gzdump_wrap(FILE *fp, int level)
+{
+	struct gzdump *gz;
+#ifdef HAVE_FOPENCOOKIE
+	cookie_io_functions_t funcs;
+#endif
+
+	gz = (struct gzdump *)calloc(1, sizeof(*gz));
+	if (gz == NULL)
+		return NULL;
+	/* 15 + 16: the largest window, with a gzip header */
+	if (deflateInit2(&gz->zs, level, Z_DEFLATED, 15 + 16, 8,
+	    Z_DEFAULT_STRATEGY) != Z_OK) {
+		free(gz);
+		return NULL;
+	}
+	gz->fp = fp;
+
+#ifdef HAVE_FOPENCOOKIE
+	funcs.read = NULL;
+	funcs.write = gz_write;
+	funcs.seek = gz_seek;
+	funcs.close = gz_close;
+	gz->cookie_fp = fopencookie(gz, "w", funcs);
+#else
+	gz->cookie_fp = funopen(gz, NULL, gz_write_bsd, gz_seek_bsd, gz_close);
+#endif
+	if (gz->cookie_fp == NULL) {
+		(void)deflateEnd(&gz->zs);
+		free(gz);
+		return NULL;
+	}
+	(void)setvbuf(gz->cookie_fp, NULL, _IOFBF, GZ_STDIO_SIZE);
+
+	pthread_mutex_lock(&gz_lock);
+	if (!writer_started)
+		start_writer();
+	gz->chunk = get_chunk();
+	gz->next = open_streams;
+	open_streams = gz;
+	pthread_mutex_unlock(&gz_lock);
+
+	return gz->cookie_fp;
+}
+
+#endif /* HAVE_GZDUMP */
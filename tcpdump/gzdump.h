@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2015 The TCPDUMP project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that: (1) source code
+ * distributions retain the above copyright notice and this paragraph
+ * in its entirety, and (2) distributions including binary code include
+ * the above copyright notice and this paragraph in its entirety in
+ * the documentation or other materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND
+ * WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ */
+#ifndef gzdump_h
+#define gzdump_h
+
+#if defined(HAVE_LIBZ) && defined(HAVE_ZLIB_H) && \
+    defined(HAVE_LIBPTHREAD) && defined(HAVE_PCAP_DUMP_FOPEN) && \
+    (defined(HAVE_FOPENCOOKIE) || defined(HAVE_FUNOPEN)) && \
+    !defined(HAVE_CAPSICUM)
+#define HAVE_GZDUMP
+
+/*
+ * Return a stream that gzips what is written to it into FP, on a
+ * separate thread; closing it closes FP.  NULL if it can't be made.
+ */
+extern FILE *gzdump_wrap(FILE *, int);
+#endif
+
+#endif
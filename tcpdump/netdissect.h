@@ -88,6 +88,12 @@ extern char *bittok2str_nosep(const struct tok *, const char *, u_int);
 
 typedef struct netdissect_options netdissect_options;
 
+/* packets handed to the printers for a protocol, for --printer-stats */
+struct printer_stats {
+  u_int ps_count;		/* number of packets */
+  struct timeval ps_time;	/* time spent printing them */
+};
+
 struct netdissect_options {
   int ndo_aflag;		/* translate network and broadcast addresses */
   int ndo_bflag;		/* print 4 byte ASes in ASDOT notation */
@@ -128,6 +134,10 @@ struct netdissect_options {
   int ndo_packet_number;	/* print a packet number in the beginning of line */
   int ndo_suppress_default_print; /* don't use default_print() for unknown packet types */
   int ndo_tstamp_precision;   /* requested time stamp precision */
+  int ndo_async_resolve;	/* look up host names on a separate thread */
+  struct printer_stats *ndo_ethertype_stats; /* per ethertype, for --printer-stats */
+  struct printer_stats *ndo_ipproto_stats;   /* per IP protocol, for --printer-stats */
+  struct flow_table *ndo_flows;	/* per-flow counts, for --summary */
   const char *ndo_dltname;
 
   char *ndo_espsecret;
@@ -290,6 +300,9 @@ struct netdissect_options {
 extern void ts_print(netdissect_options *, const struct timeval *);
 extern void relts_print(netdissect_options *, int);
 
+extern void printer_stats_start(struct timeval *);
+extern void printer_stats_add(struct printer_stats *, const struct timeval *);
+
 extern int fn_print(netdissect_options *, const u_char *, const u_char *);
 extern int fn_printn(netdissect_options *, const u_char *, u_int, const u_char *);
 extern int fn_printzp(netdissect_options *, const u_char *, u_int, const u_char *);
@@ -305,17 +305,10 @@ netanalyzer_transparent_if_print(netdissect_options *ndo,
 	return (12 + ETHER_HDRLEN);
 }
 
-/*
- * Prints the packet payload, given an Ethernet type code for the payload's
- * protocol.
- *
- * Returns non-zero if it can do so, zero if the ethertype is unknown.
- */
-
-int
-ethertype_print(netdissect_options *ndo,
-                u_short ether_type, const u_char *p,
-                u_int length, u_int caplen)
+static int
+ethertype_print_internal(netdissect_options *ndo,
+                         u_short ether_type, const u_char *p,
+                         u_int length, u_int caplen)
 {
 	switch (ether_type) {
 
@@ -435,6 +428,29 @@ ethertype_print(netdissect_options *ndo,
 	}
 }
 
+/*
+ * Prints the packet payload, given an Ethernet type code for the payload's
+ * protocol.
+ *
+ * Returns non-zero if it can do so, zero if the ethertype is unknown.
+ */
+
+int
+ethertype_print(netdissect_options *ndo,
+                u_short ether_type, const u_char *p,
+                u_int length, u_int caplen)
+{
+	struct timeval start;
+	int ret;
+
+	if (ndo->ndo_ethertype_stats == NULL)
+		return (ethertype_print_internal(ndo, ether_type, p, length, caplen));
+	printer_stats_start(&start);
+	ret = ethertype_print_internal(ndo, ether_type, p, length, caplen);
+	printer_stats_add(&ndo->ndo_ethertype_stats[ether_type], &start);
+	return (ret);
+}
+
 
 /*
  * Local Variables:
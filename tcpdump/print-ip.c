@@ -34,6 +34,7 @@
 
 #include "ip.h"
 #include "ipproto.h"
+#include "flows.h"
 
 static const char tstr[] = "[|ip]";
 
@@ -320,8 +321,8 @@ struct ip_print_demux_state {
 };
 
 static void
-ip_print_demux(netdissect_options *ndo,
-	       struct ip_print_demux_state *ipds)
+ip_print_demux_internal(netdissect_options *ndo,
+			struct ip_print_demux_state *ipds)
 {
 	struct protoent *proto;
 	struct cksum_vec vec[1];
@@ -491,6 +492,22 @@ again:
 	}
 }
 
+static void
+ip_print_demux(netdissect_options *ndo,
+	       struct ip_print_demux_state *ipds)
+{
+	struct timeval start;
+	u_char nh = ipds->nh;
+
+	if (ndo->ndo_ipproto_stats == NULL) {
+		ip_print_demux_internal(ndo, ipds);
+		return;
+	}
+	printer_stats_start(&start);
+	ip_print_demux_internal(ndo, ipds);
+	printer_stats_add(&ndo->ndo_ipproto_stats[nh], &start);
+}
+
 void
 ip_print_inner(netdissect_options *ndo,
 	       const u_char *bp,
@@ -579,6 +596,12 @@ ip_print(netdissect_options *ndo,
 
 	ipds->off = EXTRACT_16BITS(&ipds->ip->ip_off);
 
+	/* Later fragments have no transport header to take ports from. */
+	if (ndo->ndo_flows != NULL)
+		flow_count(ndo, AF_INET, &ipds->ip->ip_src, &ipds->ip->ip_dst,
+		    ipds->ip->ip_p, (ipds->off & 0x1fff) == 0 ?
+		    (const u_char *)ipds->ip + hlen : NULL, ipds->len + hlen);
+
         if (ndo->ndo_vflag) {
             ND_PRINT((ndo, "(tos 0x%x", (int)ipds->ip->ip_tos));
             /* ECN bits */
@@ -36,6 +36,7 @@
 
 #include "ip6.h"
 #include "ipproto.h"
+#include "flows.h"
 
 /*
  * Compute a V6-style checksum by building a pseudoheader.
@@ -68,6 +69,27 @@ nextproto6_cksum(const struct ip6_hdr *ip6, const uint8_t *data,
         return in_cksum(vec, 2);
 }
 
+/*
+ * The next headers that ip6_print() goes past, to the header of the
+ * protocol the datagram carries.
+ */
+static int
+ip6_extension_header(int nh)
+{
+	switch (nh) {
+
+	case IPPROTO_HOPOPTS:
+	case IPPROTO_DSTOPTS:
+	case IPPROTO_FRAGMENT:
+	case IPPROTO_ROUTING:
+	case IPPROTO_AH:
+	case IPPROTO_ESP:
+	case IPPROTO_IPCOMP:
+		return 1;
+	}
+	return 0;
+}
+
 /*
  * print an IP6 datagram.
  */
@@ -151,6 +173,10 @@ ip6_print(netdissect_options *ndo, const u_char *bp, u_int length)
 				     ip6addr_string(ndo, &ip6->ip6_dst)));
 		}
 
+		if (ndo->ndo_flows != NULL && !ip6_extension_header(nh))
+			flow_count(ndo, AF_INET6, &ip6->ip6_src, &ip6->ip6_dst,
+			    nh, cp, payload_len + sizeof(struct ip6_hdr));
+
 		switch (nh) {
 		case IPPROTO_HOPOPTS:
 			advance = hbhopt_print(ndo, cp);
@@ -261,6 +287,10 @@ ip6_print(netdissect_options *ndo, const u_char *bp, u_int length)
 		}
 	}
 
+	/* A later fragment, or the headers weren't all captured. */
+	if (ndo->ndo_flows != NULL)
+		flow_count(ndo, AF_INET6, &ip6->ip6_src, &ip6->ip6_dst, nh,
+		    NULL, payload_len + sizeof(struct ip6_hdr));
 	return;
 trunc:
 	ND_PRINT((ndo, "[|ip6]"));
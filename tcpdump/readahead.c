@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2015 The TCPDUMP project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that: (1) source code
+ * distributions retain the above copyright notice and this paragraph
+ * in its entirety, and (2) distributions including binary code include
+ * the above copyright notice and this paragraph in its entirety in
+ * the documentation or other materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND
+ * WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ */
+
+/*
+ * --read-ahead: read the packets of a savefile on a separate thread.
+ *
+ * The reader thread calls pcap_next_ex() and copies each packet into a
+ * ring of slots, and the main thread hands them, in order, to the usual
+ * callback.  Reading the file, which for a large capture is mostly
+ * waiting for the disk, then overlaps with dissecting and printing.
+ *
+ * The printers themselves still run on the main thread only: they share
+ * state between packets (TCP sequence numbers, the name caches, and
+ * gndo for the printers that don't take a netdissect_options).
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <tcpdump-stdinc.h>
+
+#include <pcap.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "interface.h"
+#include "readahead.h"
+
+#ifdef HAVE_READAHEAD
+
+#include <pthread.h>
+#include <signal.h>
+
+#define READAHEAD_SLOTS	1024
+
+struct readahead_slot {
+	struct pcap_pkthdr hdr;
+	u_char *data;
+	bpf_u_int32 size;	/* allocated size of data */
+};
+
+static struct readahead_slot slots[READAHEAD_SLOTS];
+
+/*
+ * Slots from tail to head hold packets for the main thread, the others
+ * belong to the reader thread.  Both only ever grow, modulo 2^32.
+ */
+static u_int head, tail;
+/* pcap_next_ex() status the reader stopped on, 1 while it runs */
+static int reader_status;
+static int reader_waiting, main_waiting, stopping;
+
+static pthread_mutex_t readahead_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t slot_filled = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t slot_emptied = PTHREAD_COND_INITIALIZER;
+
+static volatile sig_atomic_t break_requested;
+
+static void *
+reader(void *arg)
+{
+	pcap_t *pd = (pcap_t *)arg;
+	struct readahead_slot *slot;
+	struct pcap_pkthdr *h;
+	const u_char *data;
+	int status;
+
+	for (;;) {
+		pthread_mutex_lock(&readahead_lock);
+		while (head - tail == READAHEAD_SLOTS && !stopping) {
+			reader_waiting = 1;
+			pthread_cond_wait(&slot_emptied, &readahead_lock);
+			reader_waiting = 0;
+		}
+		if (stopping) {
+			pthread_mutex_unlock(&readahead_lock);
+			break;
+		}
+		pthread_mutex_unlock(&readahead_lock);
+
+		status = pcap_next_ex(pd, &h, &data);
+		if (status != 1) {
+			pthread_mutex_lock(&readahead_lock);
+			reader_status = status;
+			pthread_cond_signal(&slot_filled);
+			pthread_mutex_unlock(&readahead_lock);
+			break;
+		}
+
+		slot = &slots[head % READAHEAD_SLOTS];
+		if (h->caplen > slot->size) {
+			free(slot->data);
+			slot->data = (u_char *)malloc(h->caplen);
+			if (slot->data == NULL)
+				error("readahead: malloc");
+			slot->size = h->caplen;
+		}
+		slot->hdr = *h;
+		memcpy(slot->data, data, h->caplen);
+
+		pthread_mutex_lock(&readahead_lock);
+		head++;
+		if (main_waiting)
+			pthread_cond_signal(&slot_filled);
+		pthread_mutex_unlock(&readahead_lock);
+	}
+
+	return NULL;
+}
+
+int
+readahead_loop(pcap_t *pd, int cnt, pcap_handler callback, u_char *user)
+{
+	struct readahead_slot *slot;
+	pthread_t thread;
+	sigset_t mask, omask;
+	int n = 0, status = 0;
+
+	head = tail = 0;
+	reader_status = 1;
+	stopping = 0;
+	break_requested = 0;
+
+	/* Signals are handled on the main thread. */
+	sigfillset(&mask);
+	pthread_sigmask(SIG_SETMASK, &mask, &omask);
+	if (pthread_create(&thread, NULL, reader, pd) != 0)
+		error("readahead: can't create the reader thread");
+	pthread_sigmask(SIG_SETMASK, &omask, NULL);
+
+	for (;;) {
+		pthread_mutex_lock(&readahead_lock);
+		while (head == tail && reader_status == 1) {
+			main_waiting = 1;
+			pthread_cond_wait(&slot_filled, &readahead_lock);
+			main_waiting = 0;
+		}
+		if (head == tail) {
+			/* -2 is the end of the file */
+			status = reader_status == -2 ? 0 : -1;
+			pthread_mutex_unlock(&readahead_lock);
+			break;
+		}
+		pthread_mutex_unlock(&readahead_lock);
+
+		slot = &slots[tail % READAHEAD_SLOTS];
+		(*callback)(user, &slot->hdr, slot->data);
+
+		pthread_mutex_lock(&readahead_lock);
+		tail++;
+		if (reader_waiting)
+			pthread_cond_signal(&slot_emptied);
+		pthread_mutex_unlock(&readahead_lock);
+
+		if (break_requested) {
+			status = -2;
+			break;
+		}
+		if (cnt > 0 && ++n >= cnt)
+			break;
+	}
+
+	pthread_mutex_lock(&readahead_lock);
+	stopping = 1;
+	pthread_cond_signal(&slot_emptied);
+	pthread_mutex_unlock(&readahead_lock);
+	pthread_join(thread, NULL);
+
+	return status;
+}
+
+void
+readahead_breakloop(void)
+{
+	break_requested = 1;
+}
+
+#endif /* HAVE_READAHEAD */
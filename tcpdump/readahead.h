@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2015 The TCPDUMP project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that: (1) source code
+ * distributions retain the above copyright notice and this paragraph
+ * in its entirety, and (2) distributions including binary code include
+ * the above copyright notice and this paragraph in its entirety in
+ * the documentation or other materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND
+ * WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ */
+#ifndef readahead_h
+#define readahead_h
+
+#if defined(HAVE_LIBPTHREAD) && defined(HAVE_PCAP_NEXT_EX)
+#define HAVE_READAHEAD
+
+/*
+ * Like pcap_loop(), for a savefile, with the packets read ahead by a
+ * separate thread.
+ */
+int readahead_loop(pcap_t *, int, pcap_handler, u_char *);
+/* Like pcap_breakloop(), for readahead_loop(); safe in a signal handler. */
+void readahead_breakloop(void);
+#endif
+
+#endif
@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2015 The TCPDUMP project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that: (1) source code
+ * distributions retain the above copyright notice and this paragraph
+ * in its entirety, and (2) distributions including binary code include
+ * the above copyright notice and this paragraph in its entirety in
+ * the documentation or other materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND
+ * WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ */
+
+/*
+ * --async-resolve: look up host names on a separate thread.
+ *
+ * getname() and getname6() hand the addresses they haven't seen to
+ * resolver_lookup() and print them as numbers; the resolver thread looks
+ * them up with getnameinfo(), and the names are picked up, between
+ * packets, with resolver_result().  So a slow name server no longer
+ * stops the capture for a round trip per new address.
+ *
+ * The names found are kept, for NAME_CACHE_TTL seconds, in the file given
+ * with --name-cache, so that the next run starts with them.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <tcpdump-stdinc.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "interface.h"
+#include "resolver.h"
+
+#ifdef HAVE_RESOLVER
+
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+
+#define NAME_HASHSIZE	4096
+#define NAME_CACHE_TTL	(60 * 60)	/* seconds */
+
+struct name_entry {
+	int af;
+	u_char addr[16];
+	int status;			/* RESOLVER_* */
+	char *name;			/* if RESOLVER_FOUND */
+	time_t expires;
+	struct name_entry *nxt;		/* hash chain */
+	struct name_entry *qnxt;	/* request or result queue */
+};
+
+static struct name_entry *name_table[NAME_HASHSIZE];
+
+/* Addresses waiting for the resolver thread, and lookups it has done. */
+static struct name_entry *requests, **requests_tail = &requests;
+static struct name_entry *results, **results_tail = &results;
+
+static pthread_mutex_t resolver_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t request_queued = PTHREAD_COND_INITIALIZER;
+static int resolver_started;
+
+static const char *cache_file;
+
+static size_t
+addr_len(int af)
+{
+#ifdef AF_INET6
+	if (af == AF_INET6)
+		return 16;
+#endif
+	return 4;
+}
+
+static u_int
+addr_hash(int af, const u_char *addr)
+{
+	size_t len = addr_len(af);
+
+	return ((addr[len - 2] << 8) | addr[len - 1]) & (NAME_HASHSIZE - 1);
+}
+
+/* Called with resolver_lock held. */
+static struct name_entry *
+find_entry(int af, const void *addr)
+{
+	struct name_entry *e;
+
+	for (e = name_table[addr_hash(af, addr)]; e != NULL; e = e->nxt)
+		if (e->af == af && memcmp(e->addr, addr, addr_len(af)) == 0)
+			return e;
+	return NULL;
+}
+
+/* Called with resolver_lock held. */
+static struct name_entry *
+new_entry(int af, const void *addr)
+{
+	struct name_entry *e;
+	u_int h = addr_hash(af, addr);
+
+	e = (struct name_entry *)calloc(1, sizeof(*e));
+	if (e == NULL)
+		error("resolver: calloc");
+	e->af = af;
+	memcpy(e->addr, addr, addr_len(af));
+	e->nxt = name_table[h];
+	name_table[h] = e;
+	return e;
+}
+
+static void
+name_lookup(struct name_entry *e, char *host, size_t hostlen)
+{
+	struct sockaddr_storage ss;
+	struct sockaddr_in *sin;
+#ifdef AF_INET6
+	struct sockaddr_in6 *sin6;
+#endif
+	socklen_t sslen;
+
+	memset(&ss, 0, sizeof(ss));
+#ifdef AF_INET6
+	if (e->af == AF_INET6) {
+		sin6 = (struct sockaddr_in6 *)&ss;
+		sin6->sin6_family = AF_INET6;
+		memcpy(&sin6->sin6_addr, e->addr, 16);
+		sslen = sizeof(*sin6);
+	} else
+#endif
+	{
+		sin = (struct sockaddr_in *)&ss;
+		sin->sin_family = AF_INET;
+		memcpy(&sin->sin_addr, e->addr, 4);
+		sslen = sizeof(*sin);
+	}
+	if (getnameinfo((struct sockaddr *)&ss, sslen, host, hostlen,
+	    NULL, 0, NI_NAMEREQD) != 0)
+		host[0] = '\0';
+}
+
+static void *
+resolver_thread(void *arg _U_)
+{
+	struct name_entry *e;
+	char host[NI_MAXHOST];
+	char *name;
+
+	pthread_mutex_lock(&resolver_lock);
+	for (;;) {
+		while (requests == NULL)
+			pthread_cond_wait(&request_queued, &resolver_lock);
+		e = requests;
+		requests = e->qnxt;
+		if (requests == NULL)
+			requests_tail = &requests;
+		pthread_mutex_unlock(&resolver_lock);
+
+		name_lookup(e, host, sizeof(host));
+		name = host[0] != '\0' ? strdup(host) : NULL;
+
+		pthread_mutex_lock(&resolver_lock);
+		e->name = name;
+		e->status = name != NULL ? RESOLVER_FOUND : RESOLVER_NONE;
+		e->expires = time(NULL) + NAME_CACHE_TTL;
+		e->qnxt = NULL;
+		*results_tail = e;
+		results_tail = &e->qnxt;
+	}
+	/* NOTREACHED */
+	return NULL;
+}
+
+/* Called with resolver_lock held. */
+static void
+start_resolver(void)
+{
+	pthread_t thread;
+	sigset_t mask, omask;
+	int err;
+
+	/* Signals are handled on the main thread. */
+	sigfillset(&mask);
+	pthread_sigmask(SIG_SETMASK, &mask, &omask);
+	err = pthread_create(&thread, NULL, resolver_thread, NULL);
+	pthread_sigmask(SIG_SETMASK, &omask, NULL);
+	if (err != 0)
+		error("resolver: can't create the resolver thread");
+	pthread_detach(thread);
+	resolver_started = 1;
+}
+
+int
+resolver_lookup(int af, const void *addr, const char **name)
+{
+	struct name_entry *e;
+	int status;
+
+	pthread_mutex_lock(&resolver_lock);
+	e = find_entry(af, addr);
+	if (e == NULL) {
+		e = new_entry(af, addr);
+		e->status = RESOLVER_PENDING;
+		*requests_tail = e;
+		requests_tail = &e->qnxt;
+		if (!resolver_started)
+			start_resolver();
+		pthread_cond_signal(&request_queued);
+	}
+	status = e->status;
+	*name = e->name;
+	pthread_mutex_unlock(&resolver_lock);
+
+	return status;
+}
+
+int
+resolver_result(int *af, void *addr, const char **name)
+{
+	struct name_entry *e;
+
+	pthread_mutex_lock(&resolver_lock);
+	e = results;
+	if (e != NULL) {
+		results = e->qnxt;
+		if (results == NULL)
+			results_tail = &results;
+	}
+	pthread_mutex_unlock(&resolver_lock);
+
+	if (e == NULL)
+		return 0;
+	/* Nothing changes an entry once it has been looked up. */
+	*af = e->af;
+	memcpy(addr, e->addr, addr_len(e->af));
+	*name = e->name;
+	return e->status;
+}
+
+/*
+ * The cache file has a line for each name:
+ *
+ *	address expiry-time name
+ *
+ * with the expiry time in seconds since the Epoch.  Names that have
+ * expired are left out, and looked up again.
+ */
+int
+resolver_load(const char *fname)
+{
+	FILE *f;
+	char line[64 + NI_MAXHOST], addrstr[64], host[NI_MAXHOST];
+	u_char addr[16];
+	long expires;
+	time_t now = time(NULL);
+	struct name_entry *e;
+	int af;
+
+	cache_file = fname;
+	f = fopen(fname, "r");
+	if (f == NULL)
+		return -1;
+
+	pthread_mutex_lock(&resolver_lock);
+	while (fgets(line, sizeof(line), f) != NULL) {
+		if (line[0] == '#')
+			continue;
+		if (sscanf(line, "%63s %ld %1024s", addrstr, &expires,
+		    host) != 3 || expires <= now)
+			continue;
+		if (inet_pton(AF_INET, addrstr, addr) == 1)
+			af = AF_INET;
+#ifdef AF_INET6
+		else if (inet_pton(AF_INET6, addrstr, addr) == 1)
+			af = AF_INET6;
+#endif
+		else
+			continue;
+		if (find_entry(af, addr) != NULL)
+			continue;
+		e = new_entry(af, addr);
+		e->status = RESOLVER_FOUND;
+		e->name = strdup(host);
+		e->expires = expires;
+		if (e->name == NULL)
+			error("resolver: strdup");
+	}
+	pthread_mutex_unlock(&resolver_lock);
+	fclose(f);
+
+	return 0;
+}
+
+void
+resolver_save(void)
+{
+	FILE *f;
+	char *tmpname;
+	char addrstr[64];
+	struct name_entry *e;
+	time_t now = time(NULL);
+	size_t len;
+	int i;
+
+	if (cache_file == NULL)
+		return;
+
+	/* Write a new file and rename it, so a reader never sees half of it. */
+	len = strlen(cache_file) + sizeof(".tmp");
+	tmpname = (char *)malloc(len);
+	if (tmpname == NULL)
+		error("resolver: malloc");
+	snprintf(tmpname, len, "%s.tmp", cache_file);
+	f = fopen(tmpname, "w");
+	if (f == NULL) {
+		warning("can't write the name cache %s: %s", tmpname,
+		    strerror(errno));
+		free(tmpname);
+		return;
+	}
+
+	fprintf(f, "# tcpdump name cache\n");
+	pthread_mutex_lock(&resolver_lock);
+	for (i = 0; i < NAME_HASHSIZE; i++)
+		for (e = name_table[i]; e != NULL; e = e->nxt) {
+			if (e->status != RESOLVER_FOUND || e->expires <= now)
+				continue;
+			if (inet_ntop(e->af, e->addr, addrstr,
+			    sizeof(addrstr)) == NULL)
+				continue;
+			fprintf(f, "%s %ld %s\n", addrstr, (long)e->expires,
+			    e->name);
+		}
+	pthread_mutex_unlock(&resolver_lock);
+
+	if (fclose(f) != 0 || rename(tmpname, cache_file) != 0) {
+		warning("can't write the name cache %s: %s", cache_file,
+		    strerror(errno));
+		unlink(tmpname);
+	}
+	free(tmpname);
+}
+
+#endif /* HAVE_RESOLVER */
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2015 The TCPDUMP project
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that: (1) source code
+ * distributions retain the above copyright notice and this paragraph
+ * in its entirety, and (2) distributions including binary code include
+ * the above copyright notice and this paragraph in its entirety in
+ * the documentation or other materials provided with the distribution.
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND
+ * WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE.
+ */
+#ifndef resolver_h
+#define resolver_h
+
+#if defined(HAVE_LIBPTHREAD) && defined(HAVE_GETNAMEINFO)
+#define HAVE_RESOLVER
+
+/* resolver_lookup() and resolver_result() status */
+#define RESOLVER_PENDING	0	/* being looked up */
+#define RESOLVER_FOUND		1	/* the address has a name */
+#define RESOLVER_NONE		2	/* the address has no name */
+
+/* Read, and on exit write back, a cache of names; -1 if unreadable */
+extern int resolver_load(const char *);
+extern void resolver_save(void);
+
+/* Look up the name of an AF_INET or AF_INET6 address */
+extern int resolver_lookup(int, const void *, const char **);
+/* Get a lookup that has finished since the last call; 0 if none has */
+extern int resolver_result(int *, void *, const char **);
+#endif
+
+#endif
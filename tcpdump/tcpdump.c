@@ -117,8 +117,14 @@ extern int SIZE_BUF;
 #include "netdissect.h"
 #include "interface.h"
 #include "addrtoname.h"
+#include "ethertype.h"
+#include "ipproto.h"
 #include "machdep.h"
 #include "setsignal.h"
+#include "readahead.h"
+#include "resolver.h"
+#include "gzdump.h"
+#include "flows.h"
 #include "gmt2local.h"
 #include "pcap-missing.h"
 
@@ -145,6 +151,17 @@ static int Jflag;			/* list available time stamp types */
 int Qflag = -1;				/* restrict captured packet by send/receive direction */
 #endif
 static char *zflag = NULL;		/* compress each savefile using a specified command (like gzip or bzip2) */
+#ifdef HAVE_READAHEAD
+static int read_ahead;			/* read savefile packets on a separate thread */
+#endif
+static int printer_stats;		/* report the time spent in each printer */
+#ifdef HAVE_RESOLVER
+static char *name_cache;		/* file to keep host names in */
+#endif
+#ifdef HAVE_GZDUMP
+static int gzip_level;			/* compress savefiles in-process */
+#endif
+static int summary_interval = -1;	/* print counts, not packets, every this many seconds */
 
 static int infodelay;
 static int infoprint;
@@ -161,6 +178,7 @@ static void print_usage(void);
 static void show_dlts_and_exit(const char *device, pcap_t *pd) __attribute__((noreturn));
 
 static void print_packet(u_char *, const struct pcap_pkthdr *, const u_char *);
+static void summary_packet(u_char *, const struct pcap_pkthdr *, const u_char *);
 static void ndo_default_print(netdissect_options *, const u_char *, u_int);
 static void dump_packet_and_trunc(u_char *, const struct pcap_pkthdr *, const u_char *);
 static void dump_packet(u_char *, const struct pcap_pkthdr *, const u_char *);
@@ -190,6 +208,8 @@ RETSIGTYPE requestinfo(int);
 #endif
 
 static void info(int);
+static void print_printer_stats(void);
+static void print_summary(time_t);
 static u_int packets_captured;
 
 struct printer {
@@ -399,27 +419,61 @@ static const struct tok status_flags[] = {
 	{ 0, NULL }
 };
 
-if_printer
-lookup_printer(int type)
+/*
+ * The printers above, indexed by link-layer type.  They're looked up
+ * for every packet by the PPI and PKTAP printers, so the tables are
+ * built the first time a printer is looked up rather than searched.
+ */
+static if_printer *printer_table;
+static if_ndo_printer *ndo_printer_table;
+static int printer_table_size;
+
+/*
+ * With --printer-stats, the time spent in the printer for each link-layer
+ * type; with --summary, the packets handed to it.
+ */
+static struct printer_stats *dlt_stats;
+
+/*
+ * --summary: the packets and bytes counted, the time stamp of the last
+ * one, and the end of the interval being counted.
+ */
+static u_int summary_packets;
+static uint64_t summary_bytes;
+static time_t summary_last;
+static time_t summary_end;
+
+static void
+init_printer_tables(void)
 {
 	const struct printer *p;
+	const struct ndo_printer *ndo_p;
+	int size = 0;
 
 	for (p = printers; p->f; ++p)
-		if (type == p->type)
-			return p->f;
-
-	return NULL;
-	/* NOTREACHED */
-}
+		if (p->type >= size)
+			size = p->type + 1;
+	for (ndo_p = ndo_printers; ndo_p->f; ++ndo_p)
+		if (ndo_p->type >= size)
+			size = ndo_p->type + 1;
+#if defined(DLT_USER2) && defined(DLT_PKTAP)
+	if (DLT_USER2 >= size)
+		size = DLT_USER2 + 1;
+#endif
 
-if_ndo_printer
-lookup_ndo_printer(int type)
-{
-	const struct ndo_printer *p;
+	printer_table = (if_printer *)calloc(size, sizeof(*printer_table));
+	ndo_printer_table = (if_ndo_printer *)calloc(size,
+	    sizeof(*ndo_printer_table));
+	if (printer_table == NULL || ndo_printer_table == NULL)
+		error("init_printer_tables: calloc");
 
-	for (p = ndo_printers; p->f; ++p)
-		if (type == p->type)
-			return p->f;
+	/* The first entry for a type wins, as it did when searching. */
+	for (p = printers; p->f; ++p)
+		if (p->type >= 0 && printer_table[p->type] == NULL)
+			printer_table[p->type] = p->f;
+	for (ndo_p = ndo_printers; ndo_p->f; ++ndo_p)
+		if (ndo_p->type >= 0 && ndo_printer_table[ndo_p->type] == NULL)
+			ndo_printer_table[ndo_p->type] = ndo_p->f;
 
 #if defined(DLT_USER2) && defined(DLT_PKTAP)
 	/*
@@ -434,19 +488,34 @@ lookup_ndo_printer(int type)
 	 *
 	 * However, files written on OS X Mavericks for a DLT_PKTAP
 	 * capture have a link-layer header type of LINKTYPE_USER2.
-	 * If we don't have a printer for DLT_USER2, and type is
-	 * DLT_USER2, we look up the printer for DLT_PKTAP and use
-	 * that.
+	 * If we don't have a printer for DLT_USER2, we use the printer
+	 * for DLT_PKTAP for it.
 	 */
-	if (type == DLT_USER2) {
-		for (p = ndo_printers; p->f; ++p)
-			if (DLT_PKTAP == p->type)
-				return p->f;
-	}
+	if (ndo_printer_table[DLT_USER2] == NULL)
+		ndo_printer_table[DLT_USER2] = ndo_printer_table[DLT_PKTAP];
 #endif
 
-	return NULL;
-	/* NOTREACHED */
+	printer_table_size = size;
+}
+
+if_printer
+lookup_printer(int type)
+{
+	if (printer_table == NULL)
+		init_printer_tables();
+	if (type < 0 || type >= printer_table_size)
+		return NULL;
+	return printer_table[type];
+}
+
+if_ndo_printer
+lookup_ndo_printer(int type)
+{
+	if (ndo_printer_table == NULL)
+		init_printer_tables();
+	if (type < 0 || type >= printer_table_size)
+		return NULL;
+	return ndo_printer_table[type];
 }
 
 static pcap_t *pd;
@@ -464,6 +533,7 @@ struct print_info {
                 if_ndo_printer ndo_printer;
         } p;
         int ndo_type;
+        struct printer_stats *stats;	/* for --printer-stats, or NULL */
 };
 
 struct dump_info {
@@ -689,6 +759,12 @@ show_devices_and_exit (void)
 #define OPTION_VERSION		128
 #define OPTION_TSTAMP_PRECISION	129
 #define OPTION_IMMEDIATE_MODE	130
+#define OPTION_READ_AHEAD	131
+#define OPTION_PRINTER_STATS	132
+#define OPTION_ASYNC_RESOLVE	133
+#define OPTION_NAME_CACHE	134
+#define OPTION_GZIP		135
+#define OPTION_SUMMARY		136
 
 static const struct option longopts[] = {
 #if defined(HAVE_PCAP_CREATE) || defined(WIN32)
@@ -723,6 +799,18 @@ static const struct option longopts[] = {
 #ifdef HAVE_PCAP_SET_IMMEDIATE_MODE
 	{ "immediate-mode", no_argument, NULL, OPTION_IMMEDIATE_MODE },
 #endif
+#ifdef HAVE_READAHEAD
+	{ "read-ahead", no_argument, NULL, OPTION_READ_AHEAD },
+#endif
+	{ "printer-stats", no_argument, NULL, OPTION_PRINTER_STATS },
+	{ "summary", optional_argument, NULL, OPTION_SUMMARY },
+#ifdef HAVE_RESOLVER
+	{ "async-resolve", no_argument, NULL, OPTION_ASYNC_RESOLVE },
+	{ "name-cache", required_argument, NULL, OPTION_NAME_CACHE },
+#endif
+#ifdef HAVE_GZDUMP
+	{ "gzip", optional_argument, NULL, OPTION_GZIP },
+#endif
 #if defined(HAVE_PCAP_DEBUG) || defined(HAVE_YYDEBUG)
 	{ "debug-filter-parser", no_argument, NULL, 'Y' },
 #endif
@@ -841,6 +929,39 @@ MakeFilename(char *buffer, char *orig_name, int cnt, int max_chars)
                   /* Report an error if the filename is too large */
                   error("too many output files or filename is too long (> %d)", PATH_MAX);
         free(filename);
+
+#ifdef HAVE_GZDUMP
+	/* Name compressed files as gzip would. */
+	if (gzip_level != 0 && strcmp(buffer, "-") != 0) {
+		if (strlen(buffer) + sizeof(".gz") > PATH_MAX + 1)
+			error("filename is too long (> %d)", PATH_MAX);
+		strcat(buffer, ".gz");
+	}
+#endif
+}
+
+/*
+ * Open a savefile with pcap_dump_open(), or, with --gzip, through a
+ * stream that compresses it.
+ */
+static pcap_dumper_t *
+dump_open(pcap_t *pd, const char *name)
+{
+#ifdef HAVE_GZDUMP
+	FILE *fp, *gzfp;
+
+	if (gzip_level != 0) {
+		if (strcmp(name, "-") == 0)
+			fp = stdout;
+		else if ((fp = fopen(name, "w")) == NULL)
+			error("%s: %s", name, strerror(errno));
+		gzfp = gzdump_wrap(fp, gzip_level);
+		if (gzfp == NULL)
+			error("%s: can't compress the savefile", name);
+		return pcap_dump_fopen(pd, gzfp);
+	}
+#endif
+	return pcap_dump_open(pd, name);
 }
 
 static int tcpdump_printf(netdissect_options *ndo _U_,
@@ -857,6 +978,13 @@ static int tcpdump_printf(netdissect_options *ndo _U_,
   return ret;
 }
 
+/* For --summary, which runs the printers only to count packets. */
+static int summary_printf(netdissect_options *ndo _U_,
+			  const char *fmt _U_, ...)
+{
+  return 0;
+}
+
 static struct print_info
 get_print_info(int type)
 {
@@ -864,6 +992,7 @@ get_print_info(int type)
 
 	printinfo.ndo_type = 1;
 	printinfo.ndo = gndo;
+	printinfo.stats = NULL;
 	printinfo.p.ndo_printer = lookup_ndo_printer(type);
 	if (printinfo.p.ndo_printer == NULL) {
 		printinfo.p.printer = lookup_printer(type);
@@ -877,6 +1006,9 @@ get_print_info(int type)
 				error("packet printing is not supported for link type %d: use -w", type);
 		}
 	}
+	/* There's a printer, so type is an index into the tables. */
+	if (dlt_stats != NULL)
+		printinfo.stats = &dlt_stats[type];
 	return (printinfo);
 }
 
@@ -1457,6 +1589,49 @@ main(int argc, char **argv)
 			break;
 #endif
 
+#ifdef HAVE_READAHEAD
+		case OPTION_READ_AHEAD:
+			read_ahead = 1;
+			break;
+#endif
+
+		case OPTION_PRINTER_STATS:
+			printer_stats = 1;
+			break;
+
+		case OPTION_SUMMARY:
+			if (optarg == NULL)
+				summary_interval = 10;
+			else {
+				summary_interval = atoi(optarg);
+				if (summary_interval < 0)
+					error("invalid summary interval %s", optarg);
+			}
+			break;
+
+#ifdef HAVE_RESOLVER
+		case OPTION_ASYNC_RESOLVE:
+			gndo->ndo_async_resolve = 1;
+			break;
+
+		case OPTION_NAME_CACHE:
+			name_cache = optarg;
+			gndo->ndo_async_resolve = 1;
+			break;
+#endif
+
+#ifdef HAVE_GZDUMP
+		case OPTION_GZIP:
+			if (optarg == NULL)
+				gzip_level = 1;
+			else {
+				gzip_level = atoi(optarg);
+				if (gzip_level < 1 || gzip_level > 9)
+					error("invalid gzip compression level %s", optarg);
+			}
+			break;
+#endif
+
 		default:
 			print_usage();
 			exit(1);
@@ -1492,6 +1667,26 @@ main(int argc, char **argv)
 	if (VFileName != NULL && RFileName != NULL)
 		error("-V and -r are mutually exclusive.");
 
+#ifdef HAVE_READAHEAD
+	if (read_ahead && VFileName == NULL && RFileName == NULL)
+		error("--read-ahead can only be used with -r or -V");
+#endif
+
+	if (printer_stats && WFileName != NULL)
+		error("--printer-stats can not be used with -w");
+
+	if (summary_interval >= 0 && WFileName != NULL)
+		error("--summary can not be used with -w");
+	if (summary_interval >= 0 && printer_stats)
+		error("--summary and --printer-stats are mutually exclusive.");
+
+#ifdef HAVE_GZDUMP
+	if (gzip_level != 0 && WFileName == NULL)
+		error("--gzip can only be used with -w");
+	if (gzip_level != 0 && zflag != NULL)
+		error("--gzip and -z are mutually exclusive.");
+#endif
+
 #ifdef HAVE_PCAP_SET_IMMEDIATE_MODE
 	/*
 	 * If we're printing dissected packets to the standard output
@@ -1878,7 +2073,7 @@ main(int argc, char **argv)
 		else
 		  MakeFilename(dumpinfo.CurrentFileName, WFileName, 0, 0);
 
-		p = pcap_dump_open(pd, dumpinfo.CurrentFileName);
+		p = dump_open(pd, dumpinfo.CurrentFileName);
 #ifdef HAVE_LIBCAP_NG
 		/* Give up CAP_DAC_OVERRIDE capability.
 		 * Only allow it to be restored if the -C or -G flag have been
@@ -1933,8 +2128,45 @@ main(int argc, char **argv)
 #endif
 	} else {
 		type = pcap_datalink(pd);
+#ifdef HAVE_RESOLVER
+		if (name_cache != NULL && !nflag)
+			(void)resolver_load(name_cache);
+#endif
+		if (printer_stats) {
+			if (printer_table == NULL)
+				init_printer_tables();
+			dlt_stats = (struct printer_stats *)calloc(
+			    printer_table_size, sizeof(*dlt_stats));
+			gndo->ndo_ethertype_stats = (struct printer_stats *)
+			    calloc(65536, sizeof(*gndo->ndo_ethertype_stats));
+			gndo->ndo_ipproto_stats = (struct printer_stats *)
+			    calloc(256, sizeof(*gndo->ndo_ipproto_stats));
+			if (dlt_stats == NULL ||
+			    gndo->ndo_ethertype_stats == NULL ||
+			    gndo->ndo_ipproto_stats == NULL)
+				error("--printer-stats: calloc");
+		}
+		if (summary_interval >= 0) {
+			if (printer_table == NULL)
+				init_printer_tables();
+			dlt_stats = (struct printer_stats *)calloc(
+			    printer_table_size, sizeof(*dlt_stats));
+			gndo->ndo_ethertype_stats = (struct printer_stats *)
+			    calloc(65536, sizeof(*gndo->ndo_ethertype_stats));
+			gndo->ndo_flows = flow_table_new();
+			if (dlt_stats == NULL ||
+			    gndo->ndo_ethertype_stats == NULL ||
+			    gndo->ndo_flows == NULL)
+				error("--summary: calloc");
+			/*
+			 * The printers only count; don't format what they
+			 * print, or look up the names of the addresses in it.
+			 */
+			gndo->ndo_printf = summary_printf;
+			gndo->ndo_nflag = 1;
+		}
 		printinfo = get_print_info(type);
-		callback = print_packet;
+		callback = summary_interval >= 0 ? summary_packet : print_packet;
 		pcap_userdata = (u_char *)&printinfo;
 	}
 
@@ -1999,6 +2231,11 @@ main(int argc, char **argv)
 #endif	/* HAVE_CAPSICUM */
 
 	do {
+#ifdef HAVE_READAHEAD
+		if (read_ahead)
+			status = readahead_loop(pd, cnt, callback, pcap_userdata);
+		else
+#endif
 		status = pcap_loop(pd, cnt, callback, pcap_userdata);
 		if (WFileName == NULL) {
 			/*
@@ -2075,6 +2312,14 @@ main(int argc, char **argv)
 	}
 	while (ret != NULL);
 
+	if (printer_stats)
+		print_printer_stats();
+	if (summary_interval >= 0)
+		print_summary(summary_last != 0 ? summary_last : time(NULL));
+#ifdef HAVE_RESOLVER
+	resolver_save();
+#endif
+
 	free(cmdbuf);
 	exit(status == -1 ? 1 : 0);
 }
@@ -2098,6 +2343,10 @@ cleanup(int signo _U_)
 	 * to do anything with standard I/O streams in a signal handler -
 	 * the ANSI C standard doesn't say it is).
 	 */
+#ifdef HAVE_READAHEAD
+	if (read_ahead)
+		readahead_breakloop();
+#endif
 	pcap_breakloop(pd);
 #else
 	/*
@@ -2177,6 +2426,99 @@ info(register int verbose)
 	infoprint = 0;
 }
 
+static void
+print_printer_stats_line(const char *name, const struct printer_stats *ps)
+{
+	double usecs;
+
+	if (ps->ps_count == 0)
+		return;
+	usecs = ps->ps_time.tv_sec * 1000000.0 + ps->ps_time.tv_usec;
+	(void)fprintf(stderr, "  %-22s %10u %12.0f %10.2f\n", name,
+	    ps->ps_count, usecs, usecs / ps->ps_count);
+}
+
+/*
+ * Report, for --printer-stats, the packets handed to the printer of each
+ * link-layer type, ethertype and IP protocol, and the time spent in it,
+ * including the time spent printing the protocols it carries.
+ */
+static void
+print_printer_stats(void)
+{
+	const char *name;
+	char buf[16];
+	int i;
+
+	(void)fprintf(stderr, "%-24s %10s %12s %10s\n",
+	    "link-layer type", "packets", "usecs", "usecs/pkt");
+	for (i = 0; i < printer_table_size; i++) {
+		name = pcap_datalink_val_to_name(i);
+		if (name == NULL) {
+			(void)snprintf(buf, sizeof(buf), "%d", i);
+			name = buf;
+		}
+		print_printer_stats_line(name, &dlt_stats[i]);
+	}
+	(void)fprintf(stderr, "ethertype\n");
+	for (i = 0; i < 65536; i++)
+		print_printer_stats_line(tok2str(ethertype_values, "0x%04x", i),
+		    &gndo->ndo_ethertype_stats[i]);
+	(void)fprintf(stderr, "IP protocol\n");
+	for (i = 0; i < 256; i++)
+		print_printer_stats_line(tok2str(ipproto_values, "%u", i),
+		    &gndo->ndo_ipproto_stats[i]);
+}
+
+/*
+ * Print, for --summary, the packets counted since the last summary, per
+ * link-layer type, ethertype, IP protocol and flow, and start counting
+ * again.
+ */
+static void
+print_summary(time_t when)
+{
+	const char *name;
+	char buf[32];
+	struct tm *tm;
+	int i;
+
+	tm = localtime(&when);
+	if (tm == NULL || strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S",
+	    tm) == 0)
+		(void)snprintf(buf, sizeof(buf), "%ld", (long)when);
+	(void)printf("%s: %u packet%s, %" PRIu64 " bytes\n", buf,
+	    summary_packets, PLURAL_SUFFIX(summary_packets), summary_bytes);
+
+	(void)printf("%-24s %10s\n", "link-layer type", "packets");
+	for (i = 0; i < printer_table_size; i++) {
+		if (dlt_stats[i].ps_count == 0)
+			continue;
+		name = pcap_datalink_val_to_name(i);
+		if (name == NULL) {
+			(void)snprintf(buf, sizeof(buf), "%d", i);
+			name = buf;
+		}
+		(void)printf("  %-22s %10u\n", name, dlt_stats[i].ps_count);
+	}
+	(void)printf("ethertype\n");
+	for (i = 0; i < 65536; i++)
+		if (gndo->ndo_ethertype_stats[i].ps_count != 0)
+			(void)printf("  %-22s %10u\n",
+			    tok2str(ethertype_values, "0x%04x", i),
+			    gndo->ndo_ethertype_stats[i].ps_count);
+	flow_table_print(gndo->ndo_flows, 10);
+	(void)printf("\n");
+	(void)fflush(stdout);
+
+	summary_packets = 0;
+	summary_bytes = 0;
+	memset(dlt_stats, 0, printer_table_size * sizeof(*dlt_stats));
+	memset(gndo->ndo_ethertype_stats, 0,
+	    65536 * sizeof(*gndo->ndo_ethertype_stats));
+	flow_table_reset(gndo->ndo_flows);
+}
+
 #if defined(HAVE_FORK) || defined(HAVE_VFORK)
 static void
 compress_savefile(const char *filename)
@@ -2321,7 +2663,7 @@ dump_packet_and_trunc(u_char *user, const struct pcap_pkthdr *h, const u_char *s
 			}
 			dump_info->p = pcap_dump_fopen(dump_info->pd, fp);
 #else	/* !HAVE_CAPSICUM */
-			dump_info->p = pcap_dump_open(dump_info->pd, dump_info->CurrentFileName);
+			dump_info->p = dump_open(dump_info->pd, dump_info->CurrentFileName);
 #endif
 #ifdef HAVE_LIBCAP_NG
 			capng_update(CAPNG_DROP, CAPNG_EFFECTIVE, CAP_DAC_OVERRIDE);
@@ -2392,7 +2734,7 @@ dump_packet_and_trunc(u_char *user, const struct pcap_pkthdr *h, const u_char *s
 			}
 			dump_info->p = pcap_dump_fopen(dump_info->pd, fp);
 #else	/* !HAVE_CAPSICUM */
-			dump_info->p = pcap_dump_open(dump_info->pd, dump_info->CurrentFileName);
+			dump_info->p = dump_open(dump_info->pd, dump_info->CurrentFileName);
 #endif
 #ifdef HAVE_LIBCAP_NG
 			capng_update(CAPNG_DROP, CAPNG_EFFECTIVE, CAP_DAC_OVERRIDE);
@@ -2435,12 +2777,58 @@ dump_packet(u_char *user, const struct pcap_pkthdr *h, const u_char *sp)
 		info(0);
 }
 
+/*
+ * For --summary: hand the packet to the printer, which, with printing
+ * turned off, only counts it, and print the counts every summary_interval
+ * seconds of packet time stamps.
+ */
+static void
+summary_packet(u_char *user, const struct pcap_pkthdr *h, const u_char *sp)
+{
+	struct print_info *print_info;
+	netdissect_options *ndo;
+	struct timeval start;
+
+	++packets_captured;
+
+	++infodelay;
+
+	print_info = (struct print_info *)user;
+	ndo = print_info->ndo;
+
+	if (summary_interval > 0) {
+		if (summary_end == 0)
+			summary_end = h->ts.tv_sec + summary_interval;
+		else if (h->ts.tv_sec >= summary_end) {
+			print_summary(summary_end);
+			while (summary_end <= h->ts.tv_sec)
+				summary_end += summary_interval;
+		}
+	}
+	summary_packets++;
+	summary_bytes += h->len;
+	summary_last = h->ts.tv_sec;
+
+	ndo->ndo_snapend = sp + h->caplen;
+	printer_stats_start(&start);
+	if (print_info->ndo_type)
+		(void)(*print_info->p.ndo_printer)(ndo, h, sp);
+	else
+		(void)(*print_info->p.printer)(h, sp);
+	printer_stats_add(print_info->stats, &start);
+
+	--infodelay;
+	if (infoprint)
+		info(0);
+}
+
 static void
 print_packet(u_char *user, const struct pcap_pkthdr *h, const u_char *sp)
 {
 	struct print_info *print_info;
 	u_int hdrlen;
         netdissect_options *ndo;
+	struct timeval start;
 
 	++packets_captured;
 
@@ -2449,6 +2837,11 @@ print_packet(u_char *user, const struct pcap_pkthdr *h, const u_char *sp)
 	print_info = (struct print_info *)user;
         ndo = print_info->ndo;
 
+#ifdef HAVE_RESOLVER
+	if (ndo->ndo_async_resolve)
+		update_names(ndo);
+#endif
+
 	if(ndo->ndo_packet_number)
 		ND_PRINT((ndo, "%5u  ", packets_captured));
 
@@ -2462,12 +2855,18 @@ print_packet(u_char *user, const struct pcap_pkthdr *h, const u_char *sp)
 	 */
 	ndo->ndo_snapend = sp + h->caplen;
 
+	if (print_info->stats != NULL)
+		printer_stats_start(&start);
+
         if(print_info->ndo_type) {
                 hdrlen = (*print_info->p.ndo_printer)(print_info->ndo, h, sp);
         } else {
                 hdrlen = (*print_info->p.printer)(h, sp);
         }
 
+	if (print_info->stats != NULL)
+		printer_stats_add(print_info->stats, &start);
+
 	/*
 	 * Restore the original snapend, as a printer might have
 	 * changed it.
@@ -2676,6 +3075,20 @@ print_usage(void)
 #endif
 #ifdef HAVE_PCAP_SET_IMMEDIATE_MODE
 	(void)fprintf(stderr, "[ --immediate-mode ] ");
+#endif
+#ifdef HAVE_READAHEAD
+	(void)fprintf(stderr, "[ --read-ahead ] ");
+#endif
+	(void)fprintf(stderr, "[ --printer-stats ]\n");
+	(void)fprintf(stderr,
+"\t\t[ --summary[=seconds] ] ");
+#ifdef HAVE_RESOLVER
+	(void)fprintf(stderr, "[ --async-resolve ] [ --name-cache file ]");
+#endif
+	(void)fprintf(stderr,
+"\n\t\t");
+#ifdef HAVE_GZDUMP
+	(void)fprintf(stderr, "[ --gzip[=level] ] ");
 #endif
 	(void)fprintf(stderr, "[ -T type ] [ --version ] [ -V file ]\n");
 	(void)fprintf(stderr,
@@ -286,6 +286,34 @@ relts_print(netdissect_options *ndo,
 	}
 }
 
+/*
+ * Time a printer for --printer-stats: printer_stats_start() before
+ * calling it, printer_stats_add() after it returns.
+ */
+void
+printer_stats_start(struct timeval *start)
+{
+	gettimeofday(start, NULL);
+}
+
+void
+printer_stats_add(struct printer_stats *ps, const struct timeval *start)
+{
+	struct timeval now;
+
+	gettimeofday(&now, NULL);
+	ps->ps_count++;
+	ps->ps_time.tv_sec += now.tv_sec - start->tv_sec;
+	ps->ps_time.tv_usec += now.tv_usec - start->tv_usec;
+	if (ps->ps_time.tv_usec < 0) {
+		ps->ps_time.tv_usec += 1000000;
+		ps->ps_time.tv_sec--;
+	} else if (ps->ps_time.tv_usec >= 1000000) {
+		ps->ps_time.tv_usec -= 1000000;
+		ps->ps_time.tv_sec++;
+	}
+}
+
 /*
  *  this is a generic routine for printing unknown data;
  *  we pass on the linefeed plus indentation string to
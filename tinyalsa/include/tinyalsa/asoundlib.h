@@ -80,6 +80,17 @@ enum pcm_format {
     PCM_FORMAT_MAX,
 };
 
+/* Runtime statistics of a stream, see pcm_get_stats() */
+struct pcm_stats {
+    unsigned int xruns;               /* underruns (playback) or overruns (capture) */
+    unsigned int wakeups;             /* sleeps in pcm_mmap_wait_avail() */
+    unsigned int max_wakeup_delay_us; /* longest a wakeup came later than asked */
+    unsigned int min_headroom;        /* fewest frames seen by pcm_mmap_begin()
+                                       * between the application and hardware
+                                       * pointers while running, i.e. how close
+                                       * the stream came to an xrun */
+};
+
 /* Bitmask has 256 bits (32 bytes) in asound.h */
 struct pcm_mask {
     unsigned int bits[32 / sizeof(unsigned int)];
@@ -232,11 +243,33 @@ int pcm_read(struct pcm *pcm, void *data, unsigned int count);
  */
 int pcm_mmap_write(struct pcm *pcm, const void *data, unsigned int count);
 int pcm_mmap_read(struct pcm *pcm, void *data, unsigned int count);
+
+/* Direct access to the mmap buffer, without the copy made by pcm_mmap_write()
+ * and pcm_mmap_read(). pcm_mmap_begin() returns the buffer in areas, and the
+ * offset and number of contiguous frames (at most *frames) the application
+ * may render into or read from. pcm_mmap_commit() then passes them on to the
+ * hardware. Playback has to be started with pcm_start() once the start
+ * threshold has been committed.
+ */
 int pcm_mmap_begin(struct pcm *pcm, void **areas, unsigned int *offset,
                    unsigned int *frames);
 int pcm_mmap_commit(struct pcm *pcm, unsigned int offset, unsigned int frames);
 int pcm_mmap_avail(struct pcm *pcm);
 
+/* Waits until at least frames frames are available in the mmap buffer of a
+ * running stream, or for timeout_us microseconds (-1 waits without a timeout).
+ * The wait is timed from the stream rate instead of relying on period
+ * interrupts, so with PCM_NOIRQ the application can wake up as often as its
+ * latency target needs, independent of the period size.
+ * Returns the number of frames available, which is less than frames on
+ * timeout or if the stream is not running, or -EPIPE on an xrun.
+ */
+int pcm_mmap_wait_avail(struct pcm *pcm, unsigned int frames, int timeout_us);
+
+/* Get the runtime statistics of a stream, or reset them */
+int pcm_get_stats(struct pcm *pcm, struct pcm_stats *stats);
+void pcm_reset_stats(struct pcm *pcm);
+
 /* Prepare the PCM substream to be triggerable */
 int pcm_prepare(struct pcm *pcm);
 /* Start and stop a PCM channel that doesn't transfer data */
@@ -303,6 +336,24 @@ int mixer_ctl_set_enum_by_string(struct mixer_ctl *ctl, const char *string);
 int mixer_ctl_get_range_min(struct mixer_ctl *ctl);
 int mixer_ctl_get_range_max(struct mixer_ctl *ctl);
 
+/* Batched control updates, e.g. for an audio route change.
+ * Each control set in a batch is read once, when it is first set.
+ * mixer_batch_commit() then writes every changed control with a single
+ * ioctl, in the order the controls were first set, and skips controls
+ * whose value did not change.
+ * The batch is empty again after a commit and can be reused. Commit returns
+ * the first error, after attempting the remaining writes.
+ */
+struct mixer_batch;
+
+struct mixer_batch *mixer_batch_create(struct mixer *mixer);
+void mixer_batch_free(struct mixer_batch *batch);
+int mixer_batch_set_value(struct mixer_batch *batch, struct mixer_ctl *ctl,
+                          unsigned int id, int value);
+int mixer_batch_set_enum_by_string(struct mixer_batch *batch,
+                                   struct mixer_ctl *ctl, const char *string);
+int mixer_batch_commit(struct mixer_batch *batch);
+
 #if defined(__cplusplus)
 }  /* extern "C" */
 #endif
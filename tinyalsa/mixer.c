@@ -57,8 +57,54 @@ struct mixer {
     struct snd_ctl_elem_info *elem_info;
     struct mixer_ctl *ctl;
     unsigned int count;
+    unsigned int *name_hash; /* ctl index + 1 by name, open addressing */
+    unsigned int name_hash_size;
 };
 
+struct mixer_batch_entry {
+    struct mixer_ctl *ctl;
+    struct snd_ctl_elem_value old;
+    struct snd_ctl_elem_value ev;
+};
+
+struct mixer_batch {
+    struct mixer *mixer;
+    struct mixer_batch_entry *entries;
+    unsigned int count;
+    unsigned int size;
+};
+
+static unsigned int mixer_name_hash(const char *name)
+{
+    unsigned int h = 2166136261u;
+
+    while (*name)
+        h = (h ^ (unsigned char)*name++) * 16777619u;
+    return h;
+}
+
+static int mixer_build_name_hash(struct mixer *mixer)
+{
+    unsigned int n, i, mask;
+
+    mixer->name_hash_size = 16;
+    while (mixer->name_hash_size < mixer->count * 2)
+        mixer->name_hash_size *= 2;
+    mixer->name_hash = calloc(mixer->name_hash_size, sizeof(unsigned int));
+    if (!mixer->name_hash)
+        return -ENOMEM;
+    mask = mixer->name_hash_size - 1;
+
+    /* controls sharing a name keep their order, so lookups find the first */
+    for (n = 0; n < mixer->count; n++) {
+        i = mixer_name_hash((char *)mixer->elem_info[n].id.name) & mask;
+        while (mixer->name_hash[i])
+            i = (i + 1) & mask;
+        mixer->name_hash[i] = n + 1;
+    }
+    return 0;
+}
+
 void mixer_close(struct mixer *mixer)
 {
     unsigned int n,m;
@@ -84,6 +130,7 @@ void mixer_close(struct mixer *mixer)
     if (mixer->elem_info)
         free(mixer->elem_info);
 
+    free(mixer->name_hash);
     free(mixer);
 
     /* TODO: verify frees */
@@ -156,6 +203,9 @@ struct mixer *mixer_open(unsigned int card)
         }
     }
 
+    if (mixer_build_name_hash(mixer) < 0)
+        goto fail;
+
     free(eid);
     return mixer;
 
@@ -193,14 +243,18 @@ struct mixer_ctl *mixer_get_ctl(struct mixer *mixer, unsigned int id)
 
 struct mixer_ctl *mixer_get_ctl_by_name(struct mixer *mixer, const char *name)
 {
-    unsigned int n;
+    unsigned int i, n, mask;
 
     if (!mixer)
         return NULL;
 
-    for (n = 0; n < mixer->count; n++)
+    mask = mixer->name_hash_size - 1;
+    for (i = mixer_name_hash(name) & mask; mixer->name_hash[i];
+         i = (i + 1) & mask) {
+        n = mixer->name_hash[i] - 1;
         if (!strcmp(name, (char*) mixer->elem_info[n].id.name))
             return mixer->ctl + n;
+    }
 
     return NULL;
 }
@@ -553,3 +607,149 @@ int mixer_ctl_set_enum_by_string(struct mixer_ctl *ctl, const char *string)
     return -EINVAL;
 }
 
+
+struct mixer_batch *mixer_batch_create(struct mixer *mixer)
+{
+    struct mixer_batch *batch;
+
+    if (!mixer)
+        return NULL;
+
+    batch = calloc(1, sizeof(*batch));
+    if (!batch)
+        return NULL;
+    batch->mixer = mixer;
+    return batch;
+}
+
+void mixer_batch_free(struct mixer_batch *batch)
+{
+    if (!batch)
+        return;
+
+    free(batch->entries);
+    free(batch);
+}
+
+static struct mixer_batch_entry *mixer_batch_get_entry(struct mixer_batch *batch,
+                                                       struct mixer_ctl *ctl)
+{
+    struct mixer_batch_entry *entry;
+    unsigned int n;
+    int ret;
+
+    for (n = 0; n < batch->count; n++)
+        if (batch->entries[n].ctl == ctl)
+            return batch->entries + n;
+
+    if (batch->count == batch->size) {
+        unsigned int size = batch->size ? batch->size * 2 : 16;
+
+        entry = realloc(batch->entries, size * sizeof(*entry));
+        if (!entry)
+            return NULL;
+        batch->entries = entry;
+        batch->size = size;
+    }
+
+    /* the only read of this control; the write in mixer_batch_commit()
+     * merges every value set for it */
+    entry = batch->entries + batch->count;
+    memset(entry, 0, sizeof(*entry));
+    entry->ctl = ctl;
+    entry->old.id.numid = ctl->info->id.numid;
+    ret = ioctl(ctl->mixer->fd, SNDRV_CTL_IOCTL_ELEM_READ, &entry->old);
+    if (ret < 0)
+        return NULL;
+    entry->ev = entry->old;
+    batch->count++;
+
+    return entry;
+}
+
+int mixer_batch_set_value(struct mixer_batch *batch, struct mixer_ctl *ctl,
+                          unsigned int id, int value)
+{
+    struct mixer_batch_entry *entry;
+
+    if (!batch || !ctl || (ctl->mixer != batch->mixer) ||
+        (id >= ctl->info->count))
+        return -EINVAL;
+
+    switch (ctl->info->type) {
+    case SNDRV_CTL_ELEM_TYPE_BOOLEAN:
+    case SNDRV_CTL_ELEM_TYPE_INTEGER:
+    case SNDRV_CTL_ELEM_TYPE_ENUMERATED:
+        break;
+
+    case SNDRV_CTL_ELEM_TYPE_BYTES:
+        if (ctl->info->access & SNDRV_CTL_ELEM_ACCESS_TLV_READWRITE)
+            return -EINVAL;
+        break;
+
+    default:
+        return -EINVAL;
+    }
+
+    entry = mixer_batch_get_entry(batch, ctl);
+    if (!entry)
+        return -errno;
+
+    switch (ctl->info->type) {
+    case SNDRV_CTL_ELEM_TYPE_BOOLEAN:
+        entry->ev.value.integer.value[id] = !!value;
+        break;
+
+    case SNDRV_CTL_ELEM_TYPE_INTEGER:
+        entry->ev.value.integer.value[id] = value;
+        break;
+
+    case SNDRV_CTL_ELEM_TYPE_ENUMERATED:
+        entry->ev.value.enumerated.item[id] = value;
+        break;
+
+    case SNDRV_CTL_ELEM_TYPE_BYTES:
+        entry->ev.value.bytes.data[id] = value;
+        break;
+    }
+
+    return 0;
+}
+
+int mixer_batch_set_enum_by_string(struct mixer_batch *batch,
+                                   struct mixer_ctl *ctl, const char *string)
+{
+    unsigned int i, num_enums;
+
+    if (!ctl || (ctl->info->type != SNDRV_CTL_ELEM_TYPE_ENUMERATED))
+        return -EINVAL;
+
+    num_enums = ctl->info->value.enumerated.items;
+    for (i = 0; i < num_enums; i++)
+        if (!strcmp(string, ctl->ename[i]))
+            return mixer_batch_set_value(batch, ctl, 0, i);
+
+    return -EINVAL;
+}
+
+int mixer_batch_commit(struct mixer_batch *batch)
+{
+    struct mixer_batch_entry *entry;
+    unsigned int n;
+    int ret = 0;
+
+    if (!batch)
+        return -EINVAL;
+
+    for (n = 0; n < batch->count; n++) {
+        entry = batch->entries + n;
+        if (!memcmp(&entry->ev.value, &entry->old.value, sizeof(entry->ev.value)))
+            continue;
+        if (ioctl(batch->mixer->fd, SNDRV_CTL_IOCTL_ELEM_WRITE, &entry->ev) < 0 &&
+            !ret)
+            ret = -errno;
+    }
+    batch->count = 0;
+
+    return ret;
+}
@@ -39,6 +39,7 @@
 #include <sys/mman.h>
 #include <sys/time.h>
 #include <limits.h>
+#include <time.h>
 
 #include <linux/ioctl.h>
 #define __force
@@ -256,6 +257,9 @@ struct pcm {
     void *mmap_buffer;
     unsigned int noirq_frames_per_msec;
     int wait_for_avail_min;
+    unsigned int wakeups;
+    unsigned int max_wakeup_delay_us;
+    unsigned int min_headroom;
 };
 
 unsigned int pcm_get_buffer_size(struct pcm *pcm)
@@ -981,7 +985,7 @@ struct pcm *pcm_open(unsigned int card, unsigned int device,
     }
 #endif
 
-    pcm->underruns = 0;
+    pcm_reset_stats(pcm);
     return pcm;
 
 fail:
@@ -1102,6 +1106,9 @@ int pcm_mmap_begin(struct pcm *pcm, void **areas, unsigned int *offset,
         copy_frames = continuous;
     *frames = copy_frames;
 
+    if (pcm->running && pcm->buffer_size - avail < pcm->min_headroom)
+        pcm->min_headroom = pcm->buffer_size - avail;
+
     return 0;
 }
 
@@ -1184,6 +1191,94 @@ int pcm_get_poll_fd(struct pcm *pcm)
     return pcm->fd;
 }
 
+static long long timespec_diff_ns(const struct timespec *a,
+                                 const struct timespec *b)
+{
+    return (a->tv_sec - b->tv_sec) * 1000000000LL + (a->tv_nsec - b->tv_nsec);
+}
+
+int pcm_mmap_wait_avail(struct pcm *pcm, unsigned int frames, int timeout_us)
+{
+    struct timespec start, before, after, ts;
+    long long elapsed_ns, wait_ns, delay_ns;
+    int avail, err;
+
+    if (!(pcm->flags & PCM_MMAP))
+        return -ENOSYS;
+
+    if (frames > pcm->buffer_size)
+        frames = pcm->buffer_size;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (;;) {
+        avail = pcm_avail_update(pcm);
+        if (pcm->mmap_status->state == PCM_STATE_XRUN) {
+            pcm->underruns++;
+            pcm->prepared = 0;
+            pcm->running = 0;
+            return -EPIPE;
+        }
+
+        /* nothing moves the hardware pointer of a stream that is stopped */
+        if ((unsigned int)avail >= frames || !pcm->running)
+            return avail;
+
+        clock_gettime(CLOCK_MONOTONIC, &before);
+        elapsed_ns = timespec_diff_ns(&before, &start);
+        if (timeout_us >= 0 && elapsed_ns >= timeout_us * 1000LL)
+            return avail;
+
+        /* time for the hardware to process the missing frames */
+        wait_ns = (long long)(frames - avail) * 1000000000LL / pcm->config.rate;
+        if (timeout_us >= 0 && wait_ns > timeout_us * 1000LL - elapsed_ns)
+            wait_ns = timeout_us * 1000LL - elapsed_ns;
+
+        if (!(pcm->flags & PCM_NOIRQ) &&
+            (unsigned int)avail < pcm->config.avail_min) {
+            /* a period interrupt may wake us up before the timer would */
+            err = pcm_wait(pcm, (wait_ns + 999999) / 1000000);
+            if (err < 0) {
+                if (err == -EPIPE)
+                    pcm->underruns++;
+                pcm->prepared = 0;
+                pcm->running = 0;
+                return err;
+            }
+        } else {
+            /* poll() would return at once, so sleep on a timer instead */
+            ts.tv_sec = wait_ns / 1000000000LL;
+            ts.tv_nsec = wait_ns % 1000000000LL;
+            clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL);
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &after);
+        delay_ns = timespec_diff_ns(&after, &before) - wait_ns;
+        if (delay_ns > 0 && delay_ns / 1000 > pcm->max_wakeup_delay_us)
+            pcm->max_wakeup_delay_us = delay_ns / 1000;
+        pcm->wakeups++;
+    }
+}
+
+int pcm_get_stats(struct pcm *pcm, struct pcm_stats *stats)
+{
+    if (!pcm_is_ready(pcm))
+        return -1;
+
+    stats->xruns = pcm->underruns;
+    stats->wakeups = pcm->wakeups;
+    stats->max_wakeup_delay_us = pcm->max_wakeup_delay_us;
+    stats->min_headroom = pcm->min_headroom;
+    return 0;
+}
+
+void pcm_reset_stats(struct pcm *pcm)
+{
+    pcm->underruns = 0;
+    pcm->wakeups = 0;
+    pcm->max_wakeup_delay_us = 0;
+    pcm->min_headroom = pcm->buffer_size;
+}
+
 int pcm_mmap_transfer(struct pcm *pcm, const void *buffer, unsigned int bytes)
 {
     int err = 0, frames, avail;
@@ -1235,6 +1330,8 @@ int pcm_mmap_transfer(struct pcm *pcm, const void *buffer, unsigned int bytes)
 
                 err = pcm_wait(pcm, time);
                 if (err < 0) {
+                    if (err == -EPIPE)
+                        pcm->underruns++;
                     pcm->prepared = 0;
                     pcm->running = 0;
                     oops(pcm, err, "wait error: hw 0x%x app 0x%x avail 0x%x\n",
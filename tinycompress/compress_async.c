@@ -0,0 +1,479 @@
+/*
+ * BSD LICENSE
+ *
+ * tinycompress library for compress audio offload in alsa
+ * Copyright (c) 2011-2012, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * Neither the name of Intel Corporation nor the names of its contributors
+ * may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * LGPL LICENSE
+ *
+ * tinycompress library for compress audio offload in alsa
+ * Copyright (c) 2011-2012, Intel Corporation.
+ *
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU Lesser General Public License,
+ * version 2.1, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to
+ * the Free Software Foundation, Inc.,
+ * 51 Franklin St - Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+/*
+ * Asynchronous writer for compressed playback.
+ *
+ * The application copies data into a ring buffer which a fill thread
+ * writes to the driver whenever the DSP has room, so the application only
+ * has to wake up when the ring runs low rather than for every fragment.
+ * Track boundaries and the end of the stream are queued in the data as
+ * markers: at a track boundary the fill thread sets the gapless metadata of
+ * the next track, signals it to the driver and waits in a partial drain while
+ * the data of the next track keeps accumulating in the ring, so that it is
+ * written as soon as the DSP accepts it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <sys/time.h>
+
+#include <linux/types.h>
+#define __force
+#define __bitwise
+#define __user
+#include "sound/compress_params.h"
+#include "sound/compress_offload.h"
+#include "tinycompress/tinycompress.h"
+
+enum marker_type {
+	MARKER_NEXT_TRACK,
+	MARKER_DRAIN,
+};
+
+struct marker {
+	struct marker *next;
+	unsigned long long pos;		/* ring position the marker follows */
+	enum marker_type type;
+	struct compr_gapless_mdata mdata;
+};
+
+struct compress_async {
+	struct compress *compress;
+	compress_async_callback_t callback;
+	void *cookie;
+
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t work_cond;	/* data, marker, resume or exit */
+	pthread_cond_t space_cond;	/* room in the ring */
+	pthread_cond_t idle_cond;	/* fill thread left the driver */
+
+	char *buf;
+	unsigned int size;
+	unsigned long long head;	/* bytes queued by the application */
+	unsigned long long tail;	/* bytes written to the driver */
+	struct marker *markers;
+	struct marker *last_marker;
+
+	unsigned int generation;	/* bumped by compress_async_stop() */
+	bool started;
+	bool paused;
+	bool busy;
+	bool exit;
+	int error;
+};
+
+static void free_markers(struct compress_async *async)
+{
+	struct marker *m;
+
+	while ((m = async->markers) != NULL) {
+		async->markers = m->next;
+		free(m);
+	}
+	async->last_marker = NULL;
+}
+
+static void notify(struct compress_async *async, enum compress_async_event event)
+{
+	if (async->callback)
+		async->callback(event, async->cookie);
+}
+
+/* runs without the lock held; fails if the stream has been stopped since
+ * the fill thread picked up its work */
+static int start_stream(struct compress_async *async, unsigned int generation)
+{
+	int ret = 0;
+
+	pthread_mutex_lock(&async->lock);
+	if (generation != async->generation) {
+		errno = ECANCELED;
+		ret = -1;
+	} else if (!async->started) {
+		ret = compress_start(async->compress);
+		if (!ret)
+			async->started = true;
+	}
+	pthread_mutex_unlock(&async->lock);
+
+	return ret;
+}
+
+/* runs without the lock held */
+static int handle_marker(struct compress_async *async, struct marker *m,
+		unsigned int generation)
+{
+	struct compress *compress = async->compress;
+
+	if (start_stream(async, generation))
+		return -1;
+
+	if (m->type == MARKER_DRAIN) {
+		if (compress_drain(compress))
+			return -1;
+		notify(async, COMPRESS_ASYNC_DRAIN_READY);
+		return 0;
+	}
+
+	if (compress_set_gapless_metadata(compress, &m->mdata) ||
+	    compress_next_track(compress) ||
+	    compress_partial_drain(compress))
+		return -1;
+	notify(async, COMPRESS_ASYNC_PARTIAL_DRAIN_READY);
+	return 0;
+}
+
+/* runs without the lock held */
+static int fill(struct compress_async *async, const char *src, unsigned int len,
+		unsigned int generation)
+{
+	int written;
+
+	written = compress_write(async->compress, src, len);
+	if (written < 0)
+		return -1;
+	if ((unsigned int)written == len)
+		return written;
+
+	/* the DSP buffer is full: start playback once it has been primed,
+	 * then sleep until the DSP has consumed a fragment */
+	if (start_stream(async, generation))
+		return -1;
+	if (compress_wait(async->compress, -1) && errno != ETIME)
+		return -1;
+	return written;
+}
+
+static bool has_work(struct compress_async *async)
+{
+	if (async->exit)
+		return true;
+	if (async->paused || async->error)
+		return false;
+	return async->head != async->tail || async->markers != NULL;
+}
+
+static void *fill_thread(void *arg)
+{
+	struct compress_async *async = arg;
+	struct marker *m;
+	unsigned long long end;
+	unsigned int generation, offset, len;
+	int ret;
+
+	pthread_mutex_lock(&async->lock);
+	for (;;) {
+		while (!has_work(async))
+			pthread_cond_wait(&async->work_cond, &async->lock);
+		if (async->exit)
+			break;
+
+		generation = async->generation;
+		m = async->markers;
+		if (m && m->pos == async->tail) {
+			async->markers = m->next;
+			if (!async->markers)
+				async->last_marker = NULL;
+
+			async->busy = true;
+			pthread_mutex_unlock(&async->lock);
+			ret = handle_marker(async, m, generation);
+			free(m);
+			pthread_mutex_lock(&async->lock);
+		} else {
+			/* write up to the next marker, and up to the end of
+			 * the ring so that the data is contiguous */
+			end = m ? m->pos : async->head;
+			offset = async->tail % async->size;
+			len = end - async->tail;
+			if (len > async->size - offset)
+				len = async->size - offset;
+
+			async->busy = true;
+			pthread_mutex_unlock(&async->lock);
+			ret = fill(async, async->buf + offset, len, generation);
+			pthread_mutex_lock(&async->lock);
+			if (ret > 0 && generation == async->generation) {
+				async->tail += ret;
+				pthread_cond_broadcast(&async->space_cond);
+			}
+		}
+		async->busy = false;
+		pthread_cond_broadcast(&async->idle_cond);
+
+		/* errors caused by compress_async_stop() or a pause are expected */
+		if (ret < 0 && generation == async->generation && !async->paused) {
+			async->error = errno ? errno : EIO;
+			pthread_cond_broadcast(&async->space_cond);
+			pthread_mutex_unlock(&async->lock);
+			notify(async, COMPRESS_ASYNC_ERROR);
+			pthread_mutex_lock(&async->lock);
+		}
+	}
+	pthread_mutex_unlock(&async->lock);
+
+	return NULL;
+}
+
+struct compress_async *compress_async_open(struct compress *compress,
+		unsigned int buffer_size, compress_async_callback_t callback,
+		void *cookie)
+{
+	struct compress_async *async;
+
+	if (!is_compress_ready(compress) || !buffer_size)
+		return NULL;
+
+	async = calloc(1, sizeof(*async));
+	if (!async)
+		return NULL;
+	async->buf = malloc(buffer_size);
+	if (!async->buf) {
+		free(async);
+		return NULL;
+	}
+	async->size = buffer_size;
+	async->compress = compress;
+	async->callback = callback;
+	async->cookie = cookie;
+	pthread_mutex_init(&async->lock, NULL);
+	pthread_cond_init(&async->work_cond, NULL);
+	pthread_cond_init(&async->space_cond, NULL);
+	pthread_cond_init(&async->idle_cond, NULL);
+
+	/* the fill thread sleeps in compress_wait() when the DSP is full */
+	compress_nonblock(compress, 1);
+
+	if (pthread_create(&async->thread, NULL, fill_thread, async)) {
+		compress_nonblock(compress, 0);
+		pthread_cond_destroy(&async->idle_cond);
+		pthread_cond_destroy(&async->space_cond);
+		pthread_cond_destroy(&async->work_cond);
+		pthread_mutex_destroy(&async->lock);
+		free(async->buf);
+		free(async);
+		return NULL;
+	}
+
+	return async;
+}
+
+void compress_async_close(struct compress_async *async)
+{
+	if (!async)
+		return;
+
+	compress_async_stop(async);
+
+	pthread_mutex_lock(&async->lock);
+	async->exit = true;
+	pthread_cond_signal(&async->work_cond);
+	pthread_mutex_unlock(&async->lock);
+	pthread_join(async->thread, NULL);
+
+	compress_nonblock(async->compress, 0);
+	free_markers(async);
+	pthread_cond_destroy(&async->idle_cond);
+	pthread_cond_destroy(&async->space_cond);
+	pthread_cond_destroy(&async->work_cond);
+	pthread_mutex_destroy(&async->lock);
+	free(async->buf);
+	free(async);
+}
+
+int compress_async_write(struct compress_async *async, const void *buf,
+		unsigned int size)
+{
+	const char *cbuf = buf;
+	unsigned int offset, len, total = 0;
+
+	pthread_mutex_lock(&async->lock);
+	while (size) {
+		if (async->error) {
+			errno = async->error;
+			pthread_mutex_unlock(&async->lock);
+			return -1;
+		}
+
+		len = async->size - (unsigned int)(async->head - async->tail);
+		if (!len) {
+			pthread_cond_wait(&async->space_cond, &async->lock);
+			continue;
+		}
+
+		offset = async->head % async->size;
+		if (len > async->size - offset)
+			len = async->size - offset;
+		if (len > size)
+			len = size;
+
+		memcpy(async->buf + offset, cbuf, len);
+		async->head += len;
+		cbuf += len;
+		size -= len;
+		total += len;
+		pthread_cond_signal(&async->work_cond);
+	}
+	pthread_mutex_unlock(&async->lock);
+
+	return total;
+}
+
+unsigned int compress_async_get_avail(struct compress_async *async)
+{
+	unsigned int avail;
+
+	pthread_mutex_lock(&async->lock);
+	avail = async->size - (unsigned int)(async->head - async->tail);
+	pthread_mutex_unlock(&async->lock);
+
+	return avail;
+}
+
+static int queue_marker(struct compress_async *async, enum marker_type type,
+		struct compr_gapless_mdata *mdata)
+{
+	struct marker *m;
+
+	m = calloc(1, sizeof(*m));
+	if (!m)
+		return -ENOMEM;
+	m->type = type;
+	if (mdata)
+		m->mdata = *mdata;
+
+	pthread_mutex_lock(&async->lock);
+	m->pos = async->head;
+	if (async->last_marker)
+		async->last_marker->next = m;
+	else
+		async->markers = m;
+	async->last_marker = m;
+	pthread_cond_signal(&async->work_cond);
+	pthread_mutex_unlock(&async->lock);
+
+	return 0;
+}
+
+int compress_async_next_track(struct compress_async *async,
+		struct compr_gapless_mdata *mdata)
+{
+	if (!async || !mdata)
+		return -EINVAL;
+
+	return queue_marker(async, MARKER_NEXT_TRACK, mdata);
+}
+
+int compress_async_drain(struct compress_async *async)
+{
+	if (!async)
+		return -EINVAL;
+
+	return queue_marker(async, MARKER_DRAIN, NULL);
+}
+
+int compress_async_pause(struct compress_async *async)
+{
+	int ret = 0;
+
+	pthread_mutex_lock(&async->lock);
+	async->paused = true;
+	if (async->started)
+		ret = compress_pause(async->compress);
+	pthread_mutex_unlock(&async->lock);
+
+	return ret;
+}
+
+int compress_async_resume(struct compress_async *async)
+{
+	int ret = 0;
+
+	pthread_mutex_lock(&async->lock);
+	if (async->started)
+		ret = compress_resume(async->compress);
+	async->paused = false;
+	pthread_cond_signal(&async->work_cond);
+	pthread_mutex_unlock(&async->lock);
+
+	return ret;
+}
+
+int compress_async_stop(struct compress_async *async)
+{
+	int ret = 0;
+
+	pthread_mutex_lock(&async->lock);
+	async->generation++;
+	async->head = async->tail = 0;
+	free_markers(async);
+	async->paused = false;
+
+	/* stopping the stream wakes the fill thread from a wait or drain */
+	if (async->started) {
+		ret = compress_stop(async->compress);
+		async->started = false;
+	}
+	while (async->busy)
+		pthread_cond_wait(&async->idle_cond, &async->lock);
+	async->error = 0;
+	pthread_cond_broadcast(&async->space_cond);
+	pthread_mutex_unlock(&async->lock);
+
+	return ret;
+}
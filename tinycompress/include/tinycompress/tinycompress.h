@@ -269,6 +269,91 @@ int is_compress_ready(struct compress *compress);
 
 /* Returns a human readable reason for the last error */
 const char *compress_get_error(struct compress *compress);
+
+/*
+ * Asynchronous playback writer
+ *
+ * A fill thread writes the data buffered by compress_async_write() to the
+ * driver whenever the DSP has room for it and starts the stream once the DSP
+ * buffer has been primed. The caller only has to top up the buffer, which
+ * can hold many fragments, so it can sleep much longer between writes.
+ * Track transitions and the end of the stream are queued with the data, so
+ * the caller keeps writing the next track without waiting for a drain.
+ * The compress stream is put into non-blocking mode and must not be written,
+ * started, stopped, paused or drained directly while the writer is open.
+ */
+struct compress_async;
+
+enum compress_async_event {
+	COMPRESS_ASYNC_PARTIAL_DRAIN_READY,	/* previous track decoded */
+	COMPRESS_ASYNC_DRAIN_READY,		/* all data played */
+	COMPRESS_ASYNC_ERROR,			/* writer stopped, see errno */
+};
+
+/*
+ * Called from the fill thread, which must not be stopped or closed from
+ * within the callback.
+ */
+typedef void (*compress_async_callback_t)(enum compress_async_event event,
+		void *cookie);
+
+/*
+ * compress_async_open: start an asynchronous writer for a playback stream
+ * returns the writer on success, NULL on failure
+ *
+ * @compress: compress stream opened with COMPRESS_IN
+ * @buffer_size: bytes buffered ahead of the driver
+ * @callback: event callback, may be NULL
+ * @cookie: passed to callback
+ */
+struct compress_async *compress_async_open(struct compress *compress,
+		unsigned int buffer_size, compress_async_callback_t callback,
+		void *cookie);
+
+/*
+ * compress_async_close: stop the writer, discarding buffered data, and stop
+ * the stream. Queue a drain and wait for COMPRESS_ASYNC_DRAIN_READY first to
+ * play all data.
+ */
+void compress_async_close(struct compress_async *async);
+
+/*
+ * compress_async_write: buffer data for playback
+ * return bytes buffered, which is size unless the writer failed, or -1 with
+ * errno set to the error of the writer.
+ * Blocks while the buffer is full.
+ */
+int compress_async_write(struct compress_async *async, const void *buf,
+		unsigned int size);
+
+/* Returns the free space in the buffer, in bytes */
+unsigned int compress_async_get_avail(struct compress_async *async);
+
+/*
+ * compress_async_next_track: mark the end of the current track
+ * return 0 on success, negative on error
+ * Data written after this call belongs to the next track. Once the current
+ * track has been written, the fill thread sets mdata for the next track,
+ * signals the next track to the driver and waits in a partial drain, which
+ * is reported with COMPRESS_ASYNC_PARTIAL_DRAIN_READY.
+ *
+ * @mdata: gapless metadata of the next track
+ */
+int compress_async_next_track(struct compress_async *async,
+		struct compr_gapless_mdata *mdata);
+
+/*
+ * compress_async_drain: mark the end of the stream
+ * return 0 on success, negative on error
+ * Returns at once; COMPRESS_ASYNC_DRAIN_READY is reported once all data
+ * written before this call has been played.
+ */
+int compress_async_drain(struct compress_async *async);
+
+/* Pause, resume or stop playback; stopping discards buffered data */
+int compress_async_pause(struct compress_async *async);
+int compress_async_resume(struct compress_async *async);
+int compress_async_stop(struct compress_async *async);
 /*
  * since the SNDRV_PCM_RATE_* is not availble anywhere in userspace
  * and we have used these to define the sampling rate, we need to define
@@ -18,6 +18,9 @@
 void action_run_tlsdate (evutil_socket_t fd, short what, void *arg)
 {
   struct state *state = arg;
+  struct source *source;
+  time_t stale;
+  int sources;
   verb_debug ("[event:%s] fired", __func__);
   if (state->last_sync_type == SYNC_TYPE_NET)
     {
@@ -56,22 +59,40 @@ void action_run_tlsdate (evutil_socket_t fd, short what, void *arg)
       error ("[event:%s] tlsdate tried and failed to get the time", __func__);
       return;
     }
-  state->running = 1;
-  verb ("[event:%s] attempt %d backoff %d", __func__,
-        state->tries, state->backoff);
+  /* Query as many sources at once as asked for, but each only once. */
+  for (sources = 0, source = state->opts.sources;
+       source && sources < state->opts.parallel_sources;
+       source = source->next)
+    sources++;
+  /* Throw away anything the previous run's stragglers left in the pipe. */
+  while (!read_tlsdate_response (event_get_fd (state->events[E_TLSDATE_STATUS]),
+                                 &stale))
+    ;
+  state->tlsdate_launched = 0;
+  state->tlsdate_answers = 0;
+  state->tlsdate_sane = 0;
+  state->tlsdate_done = 0;
+  verb ("[event:%s] attempt %d backoff %d sources %d", __func__,
+        state->tries, state->backoff, sources);
   /* Setup a timeout before killing tlsdate */
   trigger_event (state, E_TLSDATE_TIMEOUT,
                  state->opts.subprocess_wait_between_tries);
   /* Add the response listener event */
   trigger_event (state, E_TLSDATE_STATUS, -1);
-  /* Fire off the child process now! */
-  if (tlsdate (state))
+  /* Fire off the child processes now! */
+  while (state->tlsdate_launched < sources)
+    if (tlsdate (state))
+      break;
+  state->running = state->tlsdate_launched;
+  if (!state->running)
     {
       /* TODO(wad) Should this be fatal? */
       error ("[event:%s] tlsdate failed to launch!", __func__);
-      state->running = 0;
       state->tries = 0;
       event_del (state->events[E_TLSDATE_TIMEOUT]);
       return;
     }
+  if (state->running < sources)
+    error ("[event:%s] only %d of %d tlsdate processes launched",
+           __func__, state->running, sources);
 }
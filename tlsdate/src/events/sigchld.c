@@ -22,6 +22,7 @@ handle_child_death (struct state *state)
 {
   siginfo_t info;
   int ret;
+  int i;
   info.si_pid = 0;
   ret = waitid (P_ALL, -1, &info, WEXITED|WNOHANG);
   if (ret == -1)
@@ -41,7 +42,10 @@ handle_child_death (struct state *state)
       event_base_loopbreak (state->base);
       return 1;
     }
-  if (info.si_pid != state->tlsdate_pid)
+  for (i = 0; i < state->tlsdate_launched; i++)
+    if (info.si_pid == state->tlsdate_pids[i])
+      break;
+  if (i == state->tlsdate_launched)
     {
       error ("[event:%s] SIGCHLD for an unknown process -- "
              "pid:%d uid:%d status:%d code:%d", __func__,
@@ -51,13 +55,19 @@ handle_child_death (struct state *state)
   verb ("[event:%s] tlsdate reaped => "
         "pid:%d uid:%d status:%d code:%d", __func__,
         info.si_pid, info.si_uid, info.si_status, info.si_code);
+  state->tlsdate_pids[i] = 0;
+  if (--state->running > 0)
+    return 1;
 
   /* If it was still active, remove it. */
   event_del (state->events[E_TLSDATE_TIMEOUT]);
-  state->running = 0;
-  state->tlsdate_pid = 0;
-  /* Clean exit - don't rerun! */
-  if (info.si_status == 0)
+  /* Nothing can be written to the pipe anymore, so whatever the run is going
+   * to answer is there now.
+   */
+  if (!state->tlsdate_done)
+    process_tlsdate_responses (state);
+  /* A time was taken or the sources answered - don't rerun! */
+  if (state->tlsdate_done)
     return 1;
   verb_debug ("[event:%s] scheduling a retry", __func__);
   /* Rerun a failed tlsdate */
@@ -45,53 +45,133 @@ read_tlsdate_response (int fd, time_t *t)
   return 0;
 }
 
+/* Kill whatever is left of the current run. */
+void
+kill_tlsdate (struct state *state)
+{
+  int i;
+  for (i = 0; i < state->tlsdate_launched; i++)
+    if (state->tlsdate_pids[i])
+      kill (state->tlsdate_pids[i], SIGKILL);
+}
+
 void
 action_tlsdate_timeout (evutil_socket_t fd, short what, void *arg)
 {
   struct state *state = arg;
   info ("[event:%s] tlsdate timed out", __func__);
   /* Force kill it and let action_sigchld rerun. */
-  if (state->tlsdate_pid)
-    kill (state->tlsdate_pid, SIGKILL);
+  kill_tlsdate (state);
+}
+
+static int
+compare_time (const void *a, const void *b)
+{
+  time_t ta = *(const time_t *) a;
+  time_t tb = *(const time_t *) b;
+  return ta < tb ? -1 : ta > tb;
+}
+
+/* Looks for |quorum| of the |n| times that agree to within QUORUM_TOLERANCE.
+ * Returns 1 and stores the median of the closest such group in |t| if there
+ * is one, otherwise 0.
+ */
+static int
+find_quorum (const time_t *times, int n, int quorum, time_t *t)
+{
+  time_t sorted[MAX_PARALLEL_SOURCES];
+  int best = -1;
+  int i;
+  if (quorum < 1 || n < quorum)
+    return 0;
+  memcpy (sorted, times, n * sizeof (*sorted));
+  qsort (sorted, n, sizeof (*sorted), compare_time);
+  for (i = 0; i + quorum <= n; i++)
+    {
+      time_t spread = sorted[i + quorum - 1] - sorted[i];
+      if (spread > QUORUM_TOLERANCE)
+        continue;
+      if (best < 0 || spread < sorted[best + quorum - 1] - sorted[best])
+        best = i;
+    }
+  if (best < 0)
+    return 0;
+  *t = sorted[best + quorum / 2];
+  return 1;
+}
+
+/* Reads every response waiting on the monitor pipe and takes the time once
+ * enough of them agree.  The remaining tlsdate processes are killed then.
+ * Returns < 0 on a read error, otherwise 0.
+ */
+int
+process_tlsdate_responses (struct state *state)
+{
+  int fd = event_get_fd (state->events[E_TLSDATE_STATUS]);
+  time_t t = 0;
+  int ret;
+  while (!(ret = read_tlsdate_response (fd, &t)))
+    {
+      if (state->tlsdate_done)
+        {
+          verb_debug ("[event:%s] ignoring late response %ld", __func__, t);
+          continue;
+        }
+      state->tlsdate_answers++;
+      if (is_sane_time (t) && state->tlsdate_sane < MAX_PARALLEL_SOURCES)
+        {
+          state->tlsdate_times[state->tlsdate_sane++] = t;
+        }
+      else
+        {
+          error ("[event:%s] invalid time received from tlsdate: %ld",
+                 __func__, t);
+        }
+      if (find_quorum (state->tlsdate_times, state->tlsdate_sane,
+                       state->opts.quorum, &t))
+        {
+          /* Note that last_time is from an online source */
+          state->last_sync_type = SYNC_TYPE_NET;
+          state->last_time = t;
+          trigger_event (state, E_SAVE, -1);
+          verb ("[event:%s] took the time after %d of %d responses",
+                __func__, state->tlsdate_answers, state->tlsdate_launched);
+          /* Cancel the sources that haven't answered yet. */
+          kill_tlsdate (state);
+        }
+      else if (state->tlsdate_answers < state->tlsdate_launched)
+        {
+          continue;
+        }
+      else if (state->opts.quorum > 1)
+        {
+          error ("[event:%s] no %d of %d sources agreed on the time",
+                 __func__, state->opts.quorum, state->tlsdate_launched);
+        }
+      /* Restore the backoff and tries count on success, insane or not.
+       * On failure, the event handler does it.
+       */
+      state->tlsdate_done = 1;
+      state->tries = 0;
+      state->backoff = state->opts.wait_between_tries;
+    }
+  return ret < 0 ? -1 : 0;
 }
 
 void
 action_tlsdate_status (evutil_socket_t fd, short what, void *arg)
 {
   struct state *state = arg;
-  time_t t = 0;
-  int ret = read_tlsdate_response (fd, &t);
   verb_debug ("[event:%s] fired", __func__);
-  if (ret < 0)
+  if (process_tlsdate_responses (state))
     {
       verb_debug ("[event:%s] forcibly timing out tlsdate", __func__);
       trigger_event (state, E_TLSDATE_TIMEOUT, 0);
       return;
     }
-  if (ret)
-    {
-      /* EAGAIN'd: wait for the rest. */
-      trigger_event (state, E_TLSDATE_STATUS, -1);
-      return;
-    }
-  if (is_sane_time (t))
-    {
-      /* Note that last_time is from an online source */
-      state->last_sync_type = SYNC_TYPE_NET;
-      state->last_time = t;
-      trigger_event (state, E_SAVE, -1);
-    }
-  else
-    {
-      error ("[event:%s] invalid time received from tlsdate: %ld",
-             __func__, t);
-    }
-  /* Restore the backoff and tries count on success, insane or not.
-   * On failure, the event handler does it.
-   */
-  state->tries = 0;
-  state->backoff = state->opts.wait_between_tries;
-  return;
+  /* Wait for the rest. */
+  if (state->running && !state->tlsdate_done)
+    trigger_event (state, E_TLSDATE_STATUS, -1);
 }
 
 /* Returns 0 on success and populates |fds| */
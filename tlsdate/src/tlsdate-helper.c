@@ -1176,6 +1176,18 @@ run_ssl (uint32_t *time_map, int time_is_an_illusion, int http)
     SSL_set_info_callback(ssl, openssl_time_callback);
   }
 
+  // Offer the session of the previous run; if the server doesn't take it,
+  // this is a full handshake as usual.
+  if (session_map && session_map->len)
+  {
+    const unsigned char *p = session_map->data;
+    SSL_SESSION *session = d2i_SSL_SESSION(NULL, &p, session_map->len);
+    if (NULL == session || 1 != SSL_set_session(ssl, session))
+      verb ("V: unable to use the saved TLS session");
+    if (NULL != session)
+      SSL_SESSION_free(session);
+  }
+
   SSL_set_mode(ssl, SSL_MODE_AUTO_RETRY);
   verb("V: opening socket to %s:%s", host, port);
   if ( (1 != BIO_set_conn_hostname(s_bio, host)) ||
@@ -1218,12 +1230,87 @@ run_ssl (uint32_t *time_map, int time_is_an_illusion, int http)
   }
   check_key_length(ssl);
 
+  // A resumed session carries the certificate and verification result of
+  // the handshake it came from, so only keep sessions that were verified.
+  if (session_map && ca_racket)
+  {
+    SSL_SESSION *session = SSL_get_session(ssl);
+    unsigned char *p = session_map->data;
+    int len;
+    verb ("V: TLS session %s", SSL_session_reused(ssl) ? "resumed" : "new");
+    if (NULL != session &&
+        0 < (len = i2d_SSL_SESSION(session, NULL)) &&
+        len <= (int) sizeof (session_map->data))
+    {
+      session_map->len = i2d_SSL_SESSION(session, &p);
+      session_map->updated = 1;
+    }
+  }
+
   memcpy(time_map, &result_time, sizeof (uint32_t));
 
   SSL_free(ssl);
   SSL_CTX_free(ctx);
 }
 #endif /* USE_POLARSSL */
+
+/**
+ * Open the session file and read the TLS session saved in it into the
+ * 'session_map'. This has to happen before we drop privileges; the SSL
+ * child never touches the file itself.
+ *
+ * @param path the session file
+ * @return the open session file, or -1 if no sessions are kept
+ */
+static int
+load_session (const char *path)
+{
+  ssize_t n;
+  int fd;
+
+  session_map = (struct tls_session_map *) mmap (NULL, sizeof (*session_map),
+       PROT_READ | PROT_WRITE,
+       MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (MAP_FAILED == session_map)
+  {
+    verb ("V: mmap for the TLS session failed: %s", strerror (errno));
+    session_map = NULL;
+    return -1;
+  }
+  fd = open (path, O_RDWR | O_CREAT | O_NOFOLLOW | O_CLOEXEC, 0600);
+  if (-1 == fd)
+  {
+    verb ("V: unable to open TLS session file %s: %s", path, strerror (errno));
+    (void) munmap (session_map, sizeof (*session_map));
+    session_map = NULL;
+    return -1;
+  }
+  // A file that fills the whole map is no session we wrote.
+  n = read (fd, session_map->data, sizeof (session_map->data));
+  if (0 < n && n < (ssize_t) sizeof (session_map->data))
+    session_map->len = n;
+  verb ("V: %s TLS session from %s", session_map->len ? "loaded" : "no",
+        path);
+  return fd;
+}
+
+/**
+ * Replace the session saved in the session file with the one the SSL child
+ * handed back, if any.
+ *
+ * @param fd the session file from load_session()
+ */
+static void
+save_session (int fd)
+{
+  if (!session_map->updated)
+    return;
+  if (0 != ftruncate (fd, 0) ||
+      (ssize_t) session_map->len !=
+        pwrite (fd, session_map->data, session_map->len, 0))
+    verb ("V: unable to save the TLS session: %s", strerror (errno));
+}
+
 /** drop root rights and become 'nobody' */
 
 int
@@ -1241,8 +1328,9 @@ main(int argc, char **argv)
   int timewarp;
   int leap;
   int http;
+  int session_fd;
 
-  if (argc != 13)
+  if (argc != 14)
     return 1;
   host = argv[1];
   hostname_to_verify = argv[1];
@@ -1259,6 +1347,9 @@ main(int argc, char **argv)
   leap = (0 == strcmp ("leapaway", argv[10]));
   proxy = (0 == strcmp ("none", argv[11]) ? NULL : argv[11]);
   http = (0 == (strcmp("http", argv[12])));
+  session_fd = -1;
+  if (0 != strcmp ("none", argv[13]))
+    session_fd = load_session (argv[13]);
 
   /* Initalize warp_time with RECENT_COMPILE_DATE */
   clock_init_time(&warp_time, RECENT_COMPILE_DATE, 0);
@@ -1337,6 +1428,8 @@ main(int argc, char **argv)
     die ("fork failed: %s", strerror (errno));
   if (0 == ssl_child)
   {
+    if (-1 != session_fd)
+      (void) close (session_fd);
     drop_privs_to (UNPRIV_USER, UNPRIV_GROUP, NULL);
     run_ssl (time_map, leap, http);
     (void) munmap (time_map, sizeof (uint32_t));
@@ -1365,6 +1458,12 @@ main(int argc, char **argv)
     die ("child process failed to update time map; weird platform issues?");
   munmap (time_map, sizeof (uint32_t));
 
+  if (-1 != session_fd)
+  {
+    save_session (session_fd);
+    (void) close (session_fd);
+  }
+
   verb ("V: server time %u (difference is about %d s) was fetched in %lld ms",
   (unsigned int) server_time_s,
   CLOCK_SEC(&start_time) - server_time_s,
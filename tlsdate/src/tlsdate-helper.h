@@ -19,6 +19,7 @@
 #include <bsd/string.h>
 #endif
 #include <unistd.h>
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/types.h>
@@ -110,6 +111,19 @@ int verbose_debug;
   "Host: %s\r\n"        \
   "\r\n"
 
+// Define a max length for a serialized TLS session
+#define MAX_TLS_SESSION_LEN 16384
+
+// A serialized TLS session, shared with the SSL child so that it can resume
+// the session of the previous run and hand back the one it ends up with.
+// Sessions are only resumed with OpenSSL.
+struct tls_session_map
+{
+  uint32_t len;
+  uint32_t updated;
+  unsigned char data[MAX_TLS_SESSION_LEN];
+};
+
 static int ca_racket;
 
 static const char *host;
@@ -123,6 +137,8 @@ static const char *protocol;
 static char *proxy;
 
 static const char *ca_cert_container;
+
+static struct tls_session_map *session_map;
 #ifndef USE_POLARSSL
 void openssl_time_callback (const SSL* ssl, int where, int ret);
 uint32_t get_certificate_keybits (EVP_PKEY *public_key);
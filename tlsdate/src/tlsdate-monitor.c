@@ -22,37 +22,66 @@
 #include "src/util.h"
 #include "src/tlsdate.h"
 
-static
-char **
-build_argv (struct opts *opts)
+/* Choose the next source in the list; if we're at the end, start over. */
+static struct source *
+next_source (struct opts *opts)
 {
-  int argc;
-  char **new_argv;
   assert (opts->sources);
-  /* choose the next source in the list; if we're at the end, start over. */
   if (!opts->cur_source || !opts->cur_source->next)
     opts->cur_source = opts->sources;
   else
     opts->cur_source = opts->cur_source->next;
+  return opts->cur_source;
+}
+
+/* Returns the file tlsdate keeps the TLS session for |source| in, or NULL
+ * if sessions aren't resumed.  The file lives in the cache directory, so
+ * resumption only happens if that is writable by tlsdated's user.
+ */
+static char *
+session_file (struct opts *opts, struct source *source)
+{
+  char *path;
+  size_t len;
+  if (!opts->should_resume_sessions)
+    return NULL;
+  if (strchr (source->host, '/') || strchr (source->port, '/'))
+    return NULL;
+  len = strlen (opts->base_path) + strlen (source->host) +
+        strlen (source->port) + sizeof ("/session..");
+  if (len > PATH_MAX || !(path = malloc (len)))
+    return NULL;
+  snprintf (path, len, "%s/session.%s.%s", opts->base_path, source->host,
+            source->port);
+  return path;
+}
+
+static
+char **
+build_argv (struct opts *opts, struct source *source)
+{
+  int argc;
+  char **new_argv;
+  char *session;
   for (argc = 0; opts->base_argv[argc]; argc++)
     ;
   /* Put an arbitrary limit on the number of args. */
   if (argc > 1024)
     return NULL;
   argc++; /* uncounted null terminator */
-  argc += 9;  /* -H host -p port -x proxy -Vraw -n -l */
+  argc += 11;  /* -H host -p port -x proxy -Vraw -n -l -S session */
   new_argv = malloc (argc * sizeof (char *));
   if (!new_argv)
     return NULL;
   for (argc = 0; opts->base_argv[argc]; argc++)
     new_argv[argc] = opts->base_argv[argc];
   new_argv[argc++] = "-H";
-  new_argv[argc++] = opts->cur_source->host;
+  new_argv[argc++] = source->host;
   new_argv[argc++] = "-p";
-  new_argv[argc++] = opts->cur_source->port;
-  if (opts->cur_source->proxy || opts->proxy)
+  new_argv[argc++] = source->port;
+  if (source->proxy || opts->proxy)
     {
-      char *proxy = opts->proxy ? opts->proxy : opts->cur_source->proxy;
+      char *proxy = opts->proxy ? opts->proxy : source->proxy;
       if (strcmp (proxy, ""))
         {
           new_argv[argc++] = (char *) "-x";
@@ -63,16 +92,28 @@ build_argv (struct opts *opts)
   new_argv[argc++] = "-n";
   if (opts->leap)
     new_argv[argc++] = "-l";
+  if ((session = session_file (opts, source)))
+    {
+      new_argv[argc++] = "-S";
+      new_argv[argc++] = session;
+    }
   new_argv[argc++] = NULL;
   return new_argv;
 }
 
-/* Run tlsdate and redirects stdout to the monitor_fd */
+/* Run tlsdate against the next source and redirects stdout to the
+ * monitor_fd.  The source is picked before forking so that the rotation
+ * sticks and concurrent runs query different sources.
+ */
 int
 tlsdate (struct state *state)
 {
   char **new_argv;
+  struct source *source;
   pid_t pid;
+  if (state->tlsdate_launched >= MAX_PARALLEL_SOURCES)
+    return -1;
+  source = next_source (&state->opts);
   switch ((pid = fork()))
     {
     case 0: /* child! */
@@ -81,11 +122,12 @@ tlsdate (struct state *state)
       perror ("fork() failed!");
       return -1;
     default:
-      verb_debug ("[tlsdate-monitor] spawned tlsdate: %d", pid);
-      state->tlsdate_pid = pid;
+      verb_debug ("[tlsdate-monitor] spawned tlsdate for %s:%s: %d",
+                  source->host, source->port, pid);
+      state->tlsdate_pids[state->tlsdate_launched++] = pid;
       return 0;
    }
-  if (!(new_argv = build_argv (&state->opts)))
+  if (!(new_argv = build_argv (&state->opts, source)))
     fatal ("out of memory building argv");
   /* Replace stdout with the pipe back to tlsdated */
   if (dup2 (state->tlsdate_monitor_fd, STDOUT_FILENO) < 0)
@@ -95,7 +95,8 @@ usage (void)
            " [-t|--timewarp]\n"
            " [-l|--leap]\n"
            " [-x|--proxy] [url]\n"
-           " [-w|--http]\n");
+           " [-w|--http]\n"
+           " [-S|--session-file] [filename]\n");
 }
 
 
@@ -114,6 +115,7 @@ main (int argc, char **argv)
   int leap;
   const char *proxy;
   int http;
+  const char *session_file;
 
   host = DEFAULT_HOST;
   port = DEFAULT_PORT;
@@ -127,6 +129,7 @@ main (int argc, char **argv)
   leap = 0;
   proxy = NULL;
   http = 0;
+  session_file = NULL;
 
   while (1)
     {
@@ -147,10 +150,11 @@ main (int argc, char **argv)
         {"leap", 0, 0, 'l'},
         {"proxy", 0, 0, 'x'},
         {"http", 0, 0, 'w'},
+        {"session-file", 1, 0, 'S'},
         {0, 0, 0, 0}
       };
 
-      c = getopt_long (argc, argv, "vV::shH:p:P:nC:tlx:w",
+      c = getopt_long (argc, argv, "vV::shH:p:P:nC:tlx:wS:",
                        long_options, &option_index);
       if (c == -1)
         break;
@@ -196,6 +200,9 @@ main (int argc, char **argv)
         case 'w':
           http = 1;
           break;
+        case 'S':
+          session_file = optarg;
+          break;
         case '?':
           break;
         default :
@@ -229,6 +236,7 @@ main (int argc, char **argv)
             (leap ? "leapaway" : "holdfast"),
             (proxy ? proxy : "none"),
             (http ? "http" : "tls"),
+            (session_file ? session_file : "none"),
             NULL);
   perror ("Failed to run tlsdate-helper");
   return 1;
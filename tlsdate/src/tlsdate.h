@@ -52,6 +52,12 @@
 #define DEFAULT_USE_NETLINK 1
 #define DEFAULT_DRY_RUN 0
 #define MAX_SANE_BACKOFF (10*60) /* exponential backoff should only go this far */
+#define DEFAULT_PARALLEL_SOURCES 1
+#define DEFAULT_QUORUM 1
+#define DEFAULT_RESUME_SESSIONS 0
+#define MAX_PARALLEL_SOURCES 8
+/* Times counted towards a quorum may differ by at most this many seconds. */
+#define QUORUM_TOLERANCE 5
 
 #ifndef TLSDATED_MAX_DATE
 #define TLSDATED_MAX_DATE 1999991337L /* this'll be a great bug some day */
@@ -134,6 +140,9 @@ struct opts
   char *proxy;
   int leap;
   int should_dbus;
+  int parallel_sources;
+  int quorum;
+  int should_resume_sessions;
 };
 
 #define MAX_FQDN_LEN 255
@@ -178,14 +187,20 @@ struct state
 
   struct event *events[E_MAX];
   int tlsdate_monitor_fd;
-  pid_t tlsdate_pid;
+  /* One tlsdate process per source queried in the current run. */
+  pid_t tlsdate_pids[MAX_PARALLEL_SOURCES];
+  int tlsdate_launched;
+  int tlsdate_answers;  /* responses read, sane or not */
+  time_t tlsdate_times[MAX_PARALLEL_SOURCES];  /* the sane ones */
+  int tlsdate_sane;
+  int tlsdate_done;  /* the run has a result; ignore the stragglers */
   pid_t setter_pid;
   int setter_save_fd;
   int setter_notify_fd;
   uint32_t backoff;
   int tries;
   int resolving;
-  int running;  /* tlsdate itself */
+  int running;  /* tlsdate processes still alive */
   int exitting;
 };
 
@@ -202,6 +217,8 @@ int save_timestamp_to_fd (int fd, time_t t);
 void set_conf_defaults (struct opts *opts);
 int new_tlsdate_monitor_pipe (int fds[2]);
 int read_tlsdate_response (int fd, time_t *t);
+int process_tlsdate_responses (struct state *state);
+void kill_tlsdate (struct state *state);
 
 void invalidate_time (struct state *state);
 int check_continuity (time_t *delta);
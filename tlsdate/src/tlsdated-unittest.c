@@ -157,10 +157,12 @@ FIXTURE_TEARDOWN (tlsdate)
     }
   /* The other half was closed above. */
   close (self->state.tlsdate_monitor_fd);
-  if (self->state.tlsdate_pid)
+  for (i = 0; i < self->state.tlsdate_launched; ++i)
     {
-      kill (self->state.tlsdate_pid, SIGKILL);
-      waitpid (self->state.tlsdate_pid, NULL, WNOHANG);
+      if (!self->state.tlsdate_pids[i])
+        continue;
+      kill (self->state.tlsdate_pids[i], SIGKILL);
+      waitpid (self->state.tlsdate_pids[i], NULL, WNOHANG);
     }
   if (self->state.base)
     event_base_free (self->state.base);
@@ -305,6 +307,51 @@ TEST_F (tlsdate, proxy_override)
   EXPECT_EQ (RECENT_COMPILE_DATE + 2, self->state.last_time);
 }
 
+TEST_F (tlsdate, parallel_sources)
+{
+  struct source s2 =
+  {
+    .next = NULL,
+    .host = "host1",
+    .port = "port1",
+    .proxy = "proxy1"
+  };
+  struct source s1 =
+  {
+    .next = &s2,
+    .host = "host2",
+    .port = "port2",
+    .proxy = "proxy2"
+  };
+  char *args[] = { "src/test/check-host-1", NULL };
+  extern char **environ;
+  self->state.envp = environ;
+  self->state.opts.sources = &s1;
+  self->state.opts.base_argv = args;
+  self->state.opts.subprocess_tries = 2;
+  self->state.opts.subprocess_wait_between_tries = 1;
+  self->state.opts.max_tries = 5;
+  self->state.backoff = self->state.opts.wait_between_tries;
+  /* Only host1 answers; queried one at a time, host2 goes first and fails. */
+  self->state.opts.parallel_sources = 2;
+  EXPECT_EQ (0, runner (self, NULL));
+  EXPECT_EQ (2, self->state.tlsdate_launched);
+  /* A single answer is no quorum of two. */
+  self->state.opts.quorum = 2;
+  self->state.tries = 0;
+  self->state.last_time = 0;
+  self->state.last_sync_type = SYNC_TYPE_NONE;
+  EXPECT_EQ (1, runner (self, NULL));
+  s1.host = "host1";
+  s1.port = "port1";
+  s1.proxy = "proxy1";
+  self->state.tries = 0;
+  self->state.last_time = 0;
+  self->state.last_sync_type = SYNC_TYPE_NONE;
+  EXPECT_EQ (0, runner (self, NULL));
+  EXPECT_EQ (RECENT_COMPILE_DATE + 1, self->state.last_time);
+}
+
 FIXTURE(mock_platform) {
   struct platform platform;
   struct platform *old_platform;
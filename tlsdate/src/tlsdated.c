@@ -143,6 +143,9 @@ set_conf_defaults (struct opts *opts)
   opts->cur_source = NULL;
   opts->proxy = NULL;
   opts->leap = 0;
+  opts->parallel_sources = DEFAULT_PARALLEL_SOURCES;
+  opts->quorum = DEFAULT_QUORUM;
+  opts->should_resume_sessions = DEFAULT_RESUME_SESSIONS;
 }
 
 void
@@ -388,6 +391,19 @@ load_conf (struct opts *opts)
         {
           opts->leap = e->value ? !strcmp (e->value, "yes") : 1;
         }
+      else if (!strcmp (e->key, "parallel-sources") && e->value)
+        {
+          opts->parallel_sources = atoi (e->value);
+        }
+      else if (!strcmp (e->key, "quorum") && e->value)
+        {
+          opts->quorum = atoi (e->value);
+        }
+      else if (!strcmp (e->key, "should-resume-sessions"))
+        {
+          opts->should_resume_sessions =
+            e->value ? !strcmp (e->value, "yes") : 1;
+        }
    }
 }
 
@@ -395,6 +411,8 @@ void
 check_conf (struct state *state)
 {
   struct opts *opts = &state->opts;
+  struct source *s;
+  int sources = 0;
   if (!opts->max_tries)
     fatal ("-t argument must be nonzero");
   if (!opts->wait_between_tries)
@@ -408,6 +426,18 @@ check_conf (struct state *state)
   if (opts->jitter >= opts->steady_state_interval)
     fatal ("jitter must be less than steady state interval (%d >= %d)",
            opts->jitter, opts->steady_state_interval);
+  if (opts->parallel_sources < 1 ||
+      opts->parallel_sources > MAX_PARALLEL_SOURCES)
+    fatal ("parallel-sources must be between 1 and %d",
+           MAX_PARALLEL_SOURCES);
+  /* Without configured sources the default one is used. */
+  for (s = opts->sources; s; s = s->next)
+    sources++;
+  if (!sources || sources > opts->parallel_sources)
+    sources = sources ? opts->parallel_sources : 1;
+  if (opts->quorum < 1 || opts->quorum > sources)
+    fatal ("quorum must be between 1 and the number of sources queried "
+           "(%d)", sources);
 }
 
 int
@@ -427,10 +457,12 @@ cleanup_main (struct state *state)
     }
   /* The other half was closed above. */
   platform->file_close (state->tlsdate_monitor_fd);
-  if (state->tlsdate_pid)
+  for (i = 0; i < state->tlsdate_launched; ++i)
     {
-      platform->process_signal (state->tlsdate_pid, SIGKILL);
-      platform->process_wait (state->tlsdate_pid, NULL, 0 /* !forever */);
+      if (!state->tlsdate_pids[i])
+        continue;
+      platform->process_signal (state->tlsdate_pids[i], SIGKILL);
+      platform->process_wait (state->tlsdate_pids[i], NULL, 0 /* !forever */);
     }
   /* Best effort to tear it down if it is still alive. */
   close(state->setter_notify_fd);
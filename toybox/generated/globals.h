@@ -53,13 +53,11 @@ struct killall_data {
 // toys/lsb/md5sum.c
 
 struct md5sum_data {
-  unsigned state[5];
-  unsigned oldstate[5];
-  uint64_t count;
-  union {
-    char c[64];
-    unsigned i[16];
-  } buffer;
+  struct md5sum_file *file;
+  void (*transform)(unsigned *state, char *data, long blocks);
+  int count, next;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
 };
 
 // toys/lsb/mknod.c
@@ -928,6 +926,7 @@ struct cp_data {
       char *mode;
     } i;
     struct {
+      char *reflink;
       char *preserve;
     } c;
   };
@@ -938,6 +937,7 @@ struct cp_data {
   uid_t uid;
   gid_t gid;
   int pflags;
+  int reflink;
 };
 
 // toys/posix/cpio.c
@@ -1011,7 +1011,7 @@ struct expand_data {
 struct find_data {
   char **filter;
   struct double_list *argdata;
-  int topdir, xdev, depth;
+  int topdir, xdev, depth, modify;
   time_t now;
 };
 
@@ -1026,6 +1026,7 @@ struct grep_data {
   long c;
 
   char indelim, outdelim;
+  struct grep_ac *lit, *pre;
 };
 
 // toys/posix/head.c
@@ -1182,6 +1183,9 @@ struct ps_data {
   int kcount, forcek, sortpos;
   int (*match_process)(long long *slot);
   void (*show_process)(void *tb);
+
+  struct pidcache *cache, *fresh;
+  int caching, ncache, cachepos, nfresh, fdcount, fdmax;
 };
 
 // toys/posix/renice.c
@@ -1212,11 +1216,15 @@ struct sort_data {
   char *key_separator;
   struct arg_list *raw_keys;
   char *outfile;
-  char *ignore1, ignore2;   // GNU compatability NOPs for -S and -T.
+  char *tmpdir;
+  char *size;
 
   void *key_list;
-  int linecount;
-  char **lines;
+  int linecount, nkeys, jobs, nruns, reaped, merged, memidx;
+  struct sort_line **lines, *last;
+  struct sort_run *runs;
+  long used, limit;
+  FILE *out;
 };
 
 // toys/posix/split.c
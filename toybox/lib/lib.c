@@ -606,6 +606,60 @@ char *get_line(int fd)
   return buf;
 }
 
+// Copy len bytes (or until EOF if len is -1) from in to out, letting the
+// kernel move the data where it can: copy_file_range() between files (which
+// can share extents instead of copying), sendfile() from a file, splice()
+// to or from a pipe. Anything else, or anything those refuse, goes through
+// a 64k buffer. Returns bytes copied, or -1 with errno set.
+long long sendfile_len(int in, int out, long long len)
+{
+  long long total = 0;
+  long n = 0, chunk;
+  int try = 0, progress = 0;
+  char *buf = 0;
+
+  while (len == -1 || total < len) {
+    chunk = (len == -1 || len-total > 1<<30) ? 1<<30 : len-total;
+
+    // 0: copy_file_range, 1: sendfile, 2: splice, 3: read/write
+    if (try == 0) {
+#ifdef __NR_copy_file_range
+      n = syscall(__NR_copy_file_range, in, 0, out, 0, chunk, 0);
+#else
+      n = -1;
+      errno = ENOSYS;
+#endif
+    } else if (try == 1) n = sendfile(out, in, 0, chunk);
+    else if (try == 2) n = syscall(__NR_splice, in, 0, out, 0, chunk, 0);
+    else {
+      if (!buf) buf = xmalloc(65536);
+      if (chunk > 65536) chunk = 65536;
+      if (0 < (n = read(in, buf, chunk)) && writeall(out, buf, n) != n) n = -1;
+    }
+
+    // Fall back to the next way if this one can't handle these files. Some
+    // kernels return 0 from copy_file_range() on files in /proc and /sys
+    // rather than an error, so the first 0 isn't trusted to be EOF either.
+    if (n < 0 && try < 3 && !progress && (errno == EINVAL || errno == ENOSYS
+        || errno == EXDEV || errno == EOPNOTSUPP || errno == EBADF
+        || errno == ESPIPE))
+    {
+      try++;
+      continue;
+    }
+    if (!n && try < 3 && !progress) {
+      try++;
+      continue;
+    }
+    if (n < 1) break;
+    total += n;
+    progress++;
+  }
+  free(buf);
+
+  return n < 0 ? -1 : total;
+}
+
 int wfchmodat(int fd, char *name, mode_t mode)
 {
   int rc = fchmodat(fd, name, mode, 0);
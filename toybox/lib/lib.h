@@ -62,6 +62,10 @@ void get_optflags(void);
 #define DIRTREE_SYMFOLLOW    8
 // Don't warn about failure to stat
 #define DIRTREE_SHUTUP      16
+// Children only need the file type, take it from the directory entry if we can
+#define DIRTREE_STATLESS    32
+// Children may be stat()ed in parallel before their callbacks run
+#define DIRTREE_PARALLEL    64
 // Don't look at any more files in this directory.
 #define DIRTREE_ABORT      256
 
@@ -187,6 +191,7 @@ off_t fdlength(int fd);
 void loopfiles_rw(char **argv, int flags, int permissions, int failok,
   void (*function)(int fd, char *name));
 void loopfiles(char **argv, void (*function)(int fd, char *name));
+long long sendfile_len(int in, int out, long long len);
 void xsendfile(int in, int out);
 int wfchmodat(int rc, char *name, mode_t mode);
 int copy_tempfile(int fdin, char *name, char **tempname);
@@ -253,6 +253,10 @@ static inline void endutxent(void) {;}
 
 // Glibc won't give you linux-kernel constants unless you say "no, a BUD lite"
 // even though linux has nothing to do with the FSF and never has.
+#ifndef FICLONE
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+
 #ifndef F_SETPIPE_SZ
 #define F_SETPIPE_SZ 1031
 #endif
@@ -665,18 +665,12 @@ void xpidfile(char *name)
   close(fd);
 }
 
-// Copy the rest of in to out and close both files.
+// Copy the rest of in to out.
 
 void xsendfile(int in, int out)
 {
-  long len;
-
   if (in<0) return;
-  for (;;) {
-    len = xread(in, libbuf, sizeof(libbuf));
-    if (len<1) break;
-    xwrite(out, libbuf, len);
-  }
+  if (sendfile_len(in, out, -1) < 0) perror_exit("xsendfile");
 }
 
 // parse fractional seconds with optional s/m/h/d suffix
@@ -18,6 +18,7 @@
 #include <inttypes.h>
 #include <limits.h>
 #include <math.h>
+#include <pthread.h>
 #include <pwd.h>
 #include <regex.h>
 #include <sched.h>
@@ -64,8 +65,10 @@
 // LSB 4.1 headers
 #include <pty.h>
 #include <sys/ioctl.h>
+#include <sys/sendfile.h>
 #include <sys/statfs.h>
 #include <sys/sysinfo.h>
+#include <sys/syscall.h>
 
 #include "lib/lib.h"
 #include "lib/lsm.h"
@@ -39,15 +39,35 @@ config SHA1SUM
 #define FOR_md5sum
 #include "toys.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#elif defined(__aarch64__) \
+    && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+#include <arm_neon.h>
+#endif
+
+// One input file, hashed by whichever thread gets to it first
+struct md5sum_file {
+  char *name;
+  int err, done;
+  char hash[41];
+};
+
 GLOBALS(
+  struct md5sum_file *file;
+  void (*transform)(unsigned *state, char *data, long blocks);
+  int count, next;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+)
+
+// Per-file state, so several files can be in flight at once
+struct hash_ctx {
   unsigned state[5];
-  unsigned oldstate[5];
   uint64_t count;
-  union {
-    char c[64];
-    unsigned i[16];
-  } buffer;
-)
+  char buffer[64];
+};
 
 #define rol(value, bits) (((value) << (bits)) | ((value) >> (32 - (bits))))
 
@@ -55,7 +75,7 @@ GLOBALS(
 // that involves not just floating point but pulling in -lm (and arguing with
 // C about whether 1<<32 is a valid thing to do on 32 bit platforms) so:
 
-static uint32_t md5table[64] = {
+static const uint32_t md5table[64] = {
   0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a,
   0xa8304613, 0xfd469501, 0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
   0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821, 0xf61e2562, 0xc040b340,
@@ -76,140 +96,260 @@ static const uint8_t md5rot[64] = {
   6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
 };
 
-// Mix next 64 bytes of data into md5 hash
-
-static void md5_transform(void)
+// The four round functions, and which input word each step of a round uses.
+// Steps go four at a time so the a/b/c/d rotation is just renaming.
+
+#define MD5F(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
+#define MD5G(x, y, z) ((y) ^ ((z) & ((x) ^ (y))))
+#define MD5H(x, y, z) ((x) ^ (y) ^ (z))
+#define MD5I(x, y, z) ((y) ^ ((x) | ~(z)))
+#define MD5IN0(i) (i)
+#define MD5IN1(i) ((1+5*(i))&15)
+#define MD5IN2(i) ((5+3*(i))&15)
+#define MD5IN3(i) ((7*(i))&15)
+#define MD5STEP(f, a, b, c, d, i, in) \
+  a = b + rol(a + f(b, c, d) + x[in] + md5table[i], md5rot[i])
+#define MD5X4(f, in) { \
+  MD5STEP(f, a, b, c, d, i, in(i)); MD5STEP(f, d, a, b, c, i+1, in(i+1)); \
+  MD5STEP(f, c, d, a, b, i+2, in(i+2)); MD5STEP(f, b, c, d, a, i+3, in(i+3)); }
+
+// Mix next 64 byte blocks of data into md5 hash
+
+static void md5_transform(unsigned *state, char *data, long blocks)
 {
-  unsigned x[4], *b = TT.buffer.i;
+  unsigned a, b, c, d, x[16];
   int i;
 
-  memcpy(x, TT.state, sizeof(x));
-
-  for (i=0; i<64; i++) {
-    unsigned int in, temp, swap;
-    if (i<16) {
-      in = i;
-      temp = x[1];
-      temp = (temp & x[2]) | ((~temp) & x[3]);
-    } else if (i<32) {
-      in = (1+(5*i))&15;
-      temp = x[3];
-      temp = (x[1] & temp) | (x[2] & ~temp);
-    } else if (i<48) {
-      in = (3*i+5)&15;
-      temp = x[1] ^ x[2] ^ x[3];
-    } else {
-      in = (7*i)&15;
-      temp = x[2] ^ (x[1] | ~x[3]);
-    }
-    temp += x[0] + b[in] + md5table[i];
-    swap = x[3];
-    x[3] = x[2];
-    x[2] = x[1];
-    x[1] += rol(temp, md5rot[i]);
-    x[0] = swap;
+  for (; blocks--; data += 64) {
+    memcpy(x, data, 64);
+    if (IS_BIG_ENDIAN) for (i=0; i<16; i++) x[i] = SWAP_LE32(x[i]);
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    for (i=0; i<16; i+=4) MD5X4(MD5F, MD5IN0)
+    for (; i<32; i+=4) MD5X4(MD5G, MD5IN1)
+    for (; i<48; i+=4) MD5X4(MD5H, MD5IN2)
+    for (; i<64; i+=4) MD5X4(MD5I, MD5IN3)
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
   }
-  for (i=0; i<4; i++) TT.state[i] += x[i];
 }
 
-// Mix next 64 bytes of data into sha1 hash.
+// Same trick for sha1: five steps at a time, with the expanded message words
+// computed in a 16 entry ring as they're needed.
 
 static const unsigned rconsts[]={0x5A827999,0x6ED9EBA1,0x8F1BBCDC,0xCA62C1D6};
 
-static void sha1_transform(void)
+#define SHA1F0(x, y, z) ((z) ^ ((x) & ((y) ^ (z))))
+#define SHA1F1(x, y, z) ((x) ^ (y) ^ (z))
+#define SHA1F2(x, y, z) (((x) & (y)) | ((z) & ((x) | (y))))
+#define SHA1W(i) (w[(i)&15] = rol(w[((i)+13)&15] ^ w[((i)+8)&15] \
+  ^ w[((i)+2)&15] ^ w[(i)&15], 1))
+#define SHA1W0(i) ((i)<16 ? w[i] : SHA1W(i))
+#define SHA1STEP(f, k, a, b, c, d, e, wi) \
+  e += rol(a, 5) + f(b, c, d) + k + wi, b = rol(b, 30)
+#define SHA1X5(f, k, W) { \
+  SHA1STEP(f, k, a, b, c, d, e, W(i)); SHA1STEP(f, k, e, a, b, c, d, W(i+1)); \
+  SHA1STEP(f, k, d, e, a, b, c, W(i+2)); SHA1STEP(f, k, c, d, e, a, b, W(i+3));\
+  SHA1STEP(f, k, b, c, d, e, a, W(i+4)); }
+
+// Mix next 64 byte blocks of data into sha1 hash.
+
+static void sha1_transform(unsigned *state, char *data, long blocks)
 {
-  int i, j, k, count;
-  unsigned *block = TT.buffer.i;
-  unsigned *rot[5], *temp;
-
-  // Copy context->state[] to working vars
-  for (i=0; i<5; i++) {
-    TT.oldstate[i] = TT.state[i];
-    rot[i] = TT.state + i;
+  unsigned a, b, c, d, e, w[16];
+  int i;
+
+  for (; blocks--; data += 64) {
+    memcpy(w, data, 64);
+    for (i=0; i<16; i++) w[i] = SWAP_BE32(w[i]);
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
+    for (i=0; i<20; i+=5) SHA1X5(SHA1F0, rconsts[0], SHA1W0)
+    for (; i<40; i+=5) SHA1X5(SHA1F1, rconsts[1], SHA1W)
+    for (; i<60; i+=5) SHA1X5(SHA1F2, rconsts[2], SHA1W)
+    for (; i<80; i+=5) SHA1X5(SHA1F1, rconsts[3], SHA1W)
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
   }
-  // 4 rounds of 20 operations each.
-  for (i=count=0; i<4; i++) {
-    for (j=0; j<20; j++) {
-      unsigned work;
-
-      work = *rot[2] ^ *rot[3];
-      if (!i) work = (work & *rot[1]) ^ *rot[3];
-      else {
-        if (i==2) work = ((*rot[1]|*rot[2])&*rot[3])|(*rot[1]&*rot[2]);
-        else work ^= *rot[1];
-      }
-
-      if (!i && j<16)
-        work += block[count] = (rol(block[count],24)&0xFF00FF00)
-                             | (rol(block[count],8)&0x00FF00FF);
-      else
-        work += block[count&15] = rol(block[(count+13)&15]
-              ^ block[(count+8)&15] ^ block[(count+2)&15] ^ block[count&15], 1);
-      *rot[4] += work + rol(*rot[0],5) + rconsts[i];
-      *rot[1] = rol(*rot[1],30);
-
-      // Rotate by one for next time.
-      temp = rot[4];
-      for (k=4; k; k--) rot[k] = rot[k-1];
-      *rot = temp;
-      count++;
-    }
+}
+
+// sha1 instructions do four steps per instruction. Group g is steps 4g-4g+3,
+// and the message schedule for later groups is built up in m0-m3 as we go.
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SHA1_ACCEL 1
+
+static int sha1_accel_ok(void)
+{
+  unsigned a, b, c, d;
+
+  // ssse3 and sse4.1 for the shuffle and extract, then sha itself
+  if (!__get_cpuid(1, &a, &b, &c, &d) || !(c&(1<<9)) || !(c&(1<<19)))
+    return 0;
+
+  return __get_cpuid_count(7, 0, &a, &b, &c, &d) && (b&(1<<29));
+}
+
+#define SHA1NI(g, ein, eout, cur, next, xor, prev) \
+  ein = g ? _mm_sha1nexte_epu32(ein, cur) : _mm_add_epi32(ein, cur); \
+  eout = abcd; \
+  if (g>2 && g<19) next = _mm_sha1msg2_epu32(next, cur); \
+  abcd = _mm_sha1rnds4_epu32(abcd, ein, g/5); \
+  if (g && g<17) prev = _mm_sha1msg1_epu32(prev, cur); \
+  if (g>1 && g<18) xor = _mm_xor_si128(xor, cur)
+
+__attribute__((target("sha,ssse3,sse4.1")))
+static void sha1_accel(unsigned *state, char *data, long blocks)
+{
+  __m128i abcd, abcd_save, e0, e1, e_save, m0, m1, m2, m3,
+    mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+  abcd = _mm_shuffle_epi32(_mm_loadu_si128((void *)state), 0x1b);
+  e0 = _mm_set_epi32(state[4], 0, 0, 0);
+  for (; blocks--; data += 64) {
+    abcd_save = abcd;
+    e_save = e0;
+    m0 = _mm_shuffle_epi8(_mm_loadu_si128((void *)data), mask);
+    m1 = _mm_shuffle_epi8(_mm_loadu_si128((void *)(data+16)), mask);
+    m2 = _mm_shuffle_epi8(_mm_loadu_si128((void *)(data+32)), mask);
+    m3 = _mm_shuffle_epi8(_mm_loadu_si128((void *)(data+48)), mask);
+    SHA1NI(0, e0, e1, m0, m1, m2, m3);
+    SHA1NI(1, e1, e0, m1, m2, m3, m0);
+    SHA1NI(2, e0, e1, m2, m3, m0, m1);
+    SHA1NI(3, e1, e0, m3, m0, m1, m2);
+    SHA1NI(4, e0, e1, m0, m1, m2, m3);
+    SHA1NI(5, e1, e0, m1, m2, m3, m0);
+    SHA1NI(6, e0, e1, m2, m3, m0, m1);
+    SHA1NI(7, e1, e0, m3, m0, m1, m2);
+    SHA1NI(8, e0, e1, m0, m1, m2, m3);
+    SHA1NI(9, e1, e0, m1, m2, m3, m0);
+    SHA1NI(10, e0, e1, m2, m3, m0, m1);
+    SHA1NI(11, e1, e0, m3, m0, m1, m2);
+    SHA1NI(12, e0, e1, m0, m1, m2, m3);
+    SHA1NI(13, e1, e0, m1, m2, m3, m0);
+    SHA1NI(14, e0, e1, m2, m3, m0, m1);
+    SHA1NI(15, e1, e0, m3, m0, m1, m2);
+    SHA1NI(16, e0, e1, m0, m1, m2, m3);
+    SHA1NI(17, e1, e0, m1, m2, m3, m0);
+    SHA1NI(18, e0, e1, m2, m3, m0, m1);
+    SHA1NI(19, e1, e0, m3, m0, m1, m2);
+    e0 = _mm_sha1nexte_epu32(e0, e_save);
+    abcd = _mm_add_epi32(abcd, abcd_save);
   }
-  // Add the previous values of state[]
-  for (i=0; i<5; i++) TT.state[i] += TT.oldstate[i];
+  _mm_storeu_si128((void *)state, _mm_shuffle_epi32(abcd, 0x1b));
+  state[4] = _mm_extract_epi32(e0, 3);
 }
 
-// Fill the 64-byte working buffer and call transform() when full.
+#elif defined(__aarch64__) \
+    && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+#define SHA1_ACCEL 1
 
-static void hash_update(char *data, unsigned int len, void (*transform)(void))
+// Built for a CPU with the crypto extension, so it's there.
+static int sha1_accel_ok(void)
 {
-  unsigned int i, j;
-
-  j = TT.count & 63;
-  TT.count += len;
-
-  for (;;) {
-    // Grab next chunk of data, return if it's not enough to process a frame
-    i = 64 - j;
-    if (i>len) i = len;
-    memcpy(TT.buffer.c+j, data, i);
-    if (j+i != 64) break;
-
-    // Process a frame
-    if (IS_BIG_ENDIAN)
-      for (j=0; j<16; j++) TT.buffer.i[j] = SWAP_LE32(TT.buffer.i[j]);
-    transform();
-    j=0;
-    data += i;
-    len -= i;
+  return 1;
+}
+
+#define SHA1ARM(g, op, ein, eout, cur, next, next2, prev) \
+  eout = vsha1h_u32(vgetq_lane_u32(abcd, 0)); \
+  abcd = op(abcd, ein, t[g&1]); \
+  if (g<18) t[g&1] = vaddq_u32(next2, vdupq_n_u32(rconsts[(g+2)/5])); \
+  if (g && g<17) prev = vsha1su1q_u32(prev, next2); \
+  if (g<16) cur = vsha1su0q_u32(cur, next, next2)
+
+static void sha1_accel(unsigned *state, char *data, long blocks)
+{
+  uint32x4_t abcd, abcd_save, m0, m1, m2, m3, t[2];
+  uint32_t e0, e1, e_save;
+
+  abcd = vld1q_u32(state);
+  e0 = state[4];
+  for (; blocks--; data += 64) {
+    abcd_save = abcd;
+    e_save = e0;
+    m0 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8((void *)data)));
+    m1 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8((void *)(data+16))));
+    m2 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8((void *)(data+32))));
+    m3 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8((void *)(data+48))));
+    t[0] = vaddq_u32(m0, vdupq_n_u32(rconsts[0]));
+    t[1] = vaddq_u32(m1, vdupq_n_u32(rconsts[0]));
+    SHA1ARM(0, vsha1cq_u32, e0, e1, m0, m1, m2, m3);
+    SHA1ARM(1, vsha1cq_u32, e1, e0, m1, m2, m3, m0);
+    SHA1ARM(2, vsha1cq_u32, e0, e1, m2, m3, m0, m1);
+    SHA1ARM(3, vsha1cq_u32, e1, e0, m3, m0, m1, m2);
+    SHA1ARM(4, vsha1cq_u32, e0, e1, m0, m1, m2, m3);
+    SHA1ARM(5, vsha1pq_u32, e1, e0, m1, m2, m3, m0);
+    SHA1ARM(6, vsha1pq_u32, e0, e1, m2, m3, m0, m1);
+    SHA1ARM(7, vsha1pq_u32, e1, e0, m3, m0, m1, m2);
+    SHA1ARM(8, vsha1pq_u32, e0, e1, m0, m1, m2, m3);
+    SHA1ARM(9, vsha1pq_u32, e1, e0, m1, m2, m3, m0);
+    SHA1ARM(10, vsha1mq_u32, e0, e1, m2, m3, m0, m1);
+    SHA1ARM(11, vsha1mq_u32, e1, e0, m3, m0, m1, m2);
+    SHA1ARM(12, vsha1mq_u32, e0, e1, m0, m1, m2, m3);
+    SHA1ARM(13, vsha1mq_u32, e1, e0, m1, m2, m3, m0);
+    SHA1ARM(14, vsha1mq_u32, e0, e1, m2, m3, m0, m1);
+    SHA1ARM(15, vsha1pq_u32, e1, e0, m3, m0, m1, m2);
+    SHA1ARM(16, vsha1pq_u32, e0, e1, m0, m1, m2, m3);
+    SHA1ARM(17, vsha1pq_u32, e1, e0, m1, m2, m3, m0);
+    SHA1ARM(18, vsha1pq_u32, e0, e1, m2, m3, m0, m1);
+    SHA1ARM(19, vsha1pq_u32, e1, e0, m3, m0, m1, m2);
+    e0 += e_save;
+    abcd = vaddq_u32(abcd, abcd_save);
   }
+  vst1q_u32(state, abcd);
+  state[4] = e0;
 }
+#endif
 
-// Callback for loopfiles()
+// Fill the 64-byte working buffer, and hand whole blocks to transform().
 
-static void do_hash(int fd, char *name)
+static void hash_update(struct hash_ctx *ctx, char *data, unsigned long len)
 {
+  unsigned i = ctx->count & 63, j;
+
+  ctx->count += len;
+  if (i) {
+    j = 64-i;
+    if (j>len) j = len;
+    memcpy(ctx->buffer+i, data, j);
+    if (i+j != 64) return;
+    TT.transform(ctx->state, ctx->buffer, 1);
+    data += j;
+    len -= j;
+  }
+  if (len>63) TT.transform(ctx->state, data, len/64);
+  memcpy(ctx->buffer, data+(len&~63), len&63);
+}
+
+// Hash the contents of fd into hex string in out, using buf to read into.
+
+static void hash_fd(int fd, char *out, char *buf, int size)
+{
+  struct hash_ctx ctx;
   uint64_t count;
-  int i, sha1=toys.which->name[0]=='s';;
-  char buf;
-  void (*transform)(void);
+  int i, sha1=toys.which->name[0]=='s';
 
   /* SHA1 initialization constants  (md5sum uses first 4) */
-  TT.state[0] = 0x67452301;
-  TT.state[1] = 0xEFCDAB89;
-  TT.state[2] = 0x98BADCFE;
-  TT.state[3] = 0x10325476;
-  TT.state[4] = 0xC3D2E1F0;
-  TT.count = 0;
-
-  transform = sha1 ? sha1_transform : md5_transform;
-  for (;;) {
-    i = read(fd, toybuf, sizeof(toybuf));
-    if (i<1) break;
-    hash_update(toybuf, i, transform);
-  }
+  ctx.state[0] = 0x67452301;
+  ctx.state[1] = 0xEFCDAB89;
+  ctx.state[2] = 0x98BADCFE;
+  ctx.state[3] = 0x10325476;
+  ctx.state[4] = 0xC3D2E1F0;
+  ctx.count = 0;
+
+  while (0<(i = read(fd, buf, size))) hash_update(&ctx, buf, i);
 
-  count = TT.count << 3;
+  count = ctx.count << 3;
 
   // End the message by appending a "1" bit to the data, ending with the
   // message size (in bits, big endian), and adding enough zero bits in
@@ -218,28 +358,106 @@ static void do_hash(int fd, char *name)
   // Since our input up to now has been in whole bytes, we can deal with
   // bytes here too.
 
-  buf = 0x80;
-  do {
-    hash_update(&buf, 1, transform);
-    buf = 0;
-  } while ((TT.count & 63) != 56);
+  memset(buf, 0, 64);
+  *buf = 0x80;
+  hash_update(&ctx, buf, 1+(119-(ctx.count&63))%64);
   count = sha1 ? SWAP_BE64(count) : SWAP_LE64(count);
-  hash_update((void *)&count, 8, transform);
+  hash_update(&ctx, (void *)&count, 8);
 
   if (sha1)
     for (i = 0; i < 20; i++)
-      printf("%02x", 255&(TT.state[i>>2] >> ((3-(i & 3)) * 8)));
-  else for (i=0; i<4; i++) printf("%08x", bswap_32(TT.state[i]));
+      sprintf(out+2*i, "%02x", 255&(ctx.state[i>>2] >> ((3-(i & 3)) * 8)));
+  else for (i=0; i<4; i++) sprintf(out+8*i, "%08x", bswap_32(ctx.state[i]));
 
   // Wipe variables. Cryptographer paranoia.
-  memset(&TT, 0, sizeof(TT));
+  memset(&ctx, 0, sizeof(ctx));
+}
 
-  printf((toys.optflags & FLAG_b) ? "\n" : "  %s\n", name);
+// Claim the next file nobody's hashed yet and hash it, returning 0 if there
+// weren't any left. The main thread prints them in order as they're done.
+
+static int hash_next(char *buf)
+{
+  struct md5sum_file *mf;
+  int i, fd;
+
+  if ((i = __atomic_fetch_add(&TT.next, 1, __ATOMIC_RELAXED)) >= TT.count)
+    return 0;
+  mf = TT.file+i;
+  if (!strcmp(mf->name, "-")) fd = 0;
+  else if (-1 == (fd = open(mf->name, O_RDONLY|O_CLOEXEC))) mf->err = errno;
+  if (!mf->err) {
+    hash_fd(fd, mf->hash, buf, 65536);
+    if (fd) close(fd);
+  }
+
+  pthread_mutex_lock(&TT.lock);
+  __atomic_store_n(&mf->done, 1, __ATOMIC_RELEASE);
+  pthread_cond_broadcast(&TT.cond);
+  pthread_mutex_unlock(&TT.lock);
+
+  return 1;
+}
+
+static void *hash_thread(void *buf)
+{
+  while (hash_next(buf));
+
+  return 0;
 }
 
 void md5sum_main(void)
 {
-  loopfiles(toys.optargs, do_hash);
+  pthread_t thread;
+  char **args = *toys.optargs ? toys.optargs : (char *[]){"-", 0},
+    *buf = xmalloc(65536);
+  long i, threads;
+
+  TT.transform = md5_transform;
+  if (toys.which->name[0]=='s') {
+    TT.transform = sha1_transform;
+#ifdef SHA1_ACCEL
+    if (sha1_accel_ok()) TT.transform = sha1_accel;
+#endif
+  }
+
+  while (args[TT.count]) TT.count++;
+  TT.file = xzalloc(TT.count*sizeof(*TT.file));
+  for (i = 0; i<TT.count; i++) TT.file[i].name = args[i];
+
+  // Hash several files at once, one per CPU counting this thread. Each
+  // thread hashes whole files, so small files don't need any handoff.
+  pthread_mutex_init(&TT.lock, 0);
+  pthread_cond_init(&TT.cond, 0);
+  threads = sysconf(_SC_NPROCESSORS_ONLN);
+  if (threads>TT.count) threads = TT.count;
+  while (--threads>0) {
+    if (pthread_create(&thread, 0, hash_thread, xmalloc(65536))) break;
+    pthread_detach(thread);
+  }
+
+  for (i = 0; i<TT.count; i++) {
+    struct md5sum_file *mf = TT.file+i;
+
+    // Pitch in while waiting, then wait for whoever has the one we need.
+    while (!__atomic_load_n(&mf->done, __ATOMIC_ACQUIRE) && hash_next(buf));
+    pthread_mutex_lock(&TT.lock);
+    while (!mf->done) pthread_cond_wait(&TT.cond, &TT.lock);
+    pthread_mutex_unlock(&TT.lock);
+
+    if (mf->err) {
+      errno = mf->err;
+      perror_msg_raw(mf->name);
+    } else {
+      printf("%s", mf->hash);
+      printf((toys.optflags & FLAG_b) ? "\n" : "  %s\n", mf->name);
+    }
+  }
+
+  if (CFG_TOYBOX_FREE) {
+    free(TT.file);
+    free(buf);
+  }
 }
 
 void sha1sum_main(void)
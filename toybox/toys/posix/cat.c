@@ -55,6 +55,16 @@ static void do_cat(int fd, char *name)
 {
   int i, len, size=(toys.optflags & FLAG_u) ? 1 : sizeof(toybuf);
 
+  // Without options nothing needs to look at the data, let the kernel move it
+  if (!toys.optflags) {
+    if (sendfile_len(fd, 1, -1) < 0) {
+      toys.exitval = EXIT_FAILURE;
+      perror_msg_raw(name);
+    }
+
+    return;
+  }
+
   for(;;) {
     len = read(fd, toybuf, size);
     if (len < 0) {
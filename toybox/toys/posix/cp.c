@@ -11,8 +11,10 @@
 
 // options shared between mv/cp must be in same order (right to left)
 // for FLAG macros to work out right in shared infrastructure.
+// --preserve and --reflink share one guard so their GLOBALS slots (TT.c)
+// can't shift when one is configured out.
 
-USE_CP(NEWTOY(cp, "<2"USE_CP_PRESERVE("(preserve):;")"RHLPp"USE_CP_MORE("rdaslvnF(remove-destination)")"fi[-HLP"USE_CP_MORE("d")"]"USE_CP_MORE("[-ni]"), TOYFLAG_BIN))
+USE_CP(NEWTOY(cp, "<2"USE_CP_MORE("(preserve):;(reflink):;")"RHLPp"USE_CP_MORE("rdaslvnF(remove-destination)")"fi[-HLP"USE_CP_MORE("d")"]"USE_CP_MORE("[-ni]"), TOYFLAG_BIN))
 USE_MV(NEWTOY(mv, "<2"USE_CP_MORE("vnF")"fi"USE_CP_MORE("[-ni]"), TOYFLAG_BIN))
 USE_INSTALL(NEWTOY(install, "<1cdDpsvm:o:g:", TOYFLAG_USR|TOYFLAG_BIN))
 
@@ -39,7 +41,7 @@ config CP_MORE
   default y
   depends on CP
   help
-    usage: cp [-adlnrsv]
+    usage: cp [-adlnrsv] [--reflink[=auto|always|never]]
 
     -a	same as -dpr
     -d	don't dereference symlinks
@@ -49,6 +51,9 @@ config CP_MORE
     -s	symlink instead of copy
     -v	verbose
 
+    --reflink	share data blocks with SOURCE (copy-on-write) where the
+    		filesystem can, "always" fails instead of copying
+
 config CP_PRESERVE
   bool "cp --preserve support"
   default y
@@ -120,6 +125,7 @@ GLOBALS(
       char *mode;
     } i;
     struct {
+      char *reflink;
       char *preserve;
     } c;
   };
@@ -130,6 +136,7 @@ GLOBALS(
   uid_t uid;
   gid_t gid;
   int pflags;
+  int reflink;
 )
 
 struct cp_preserve {
@@ -278,17 +285,41 @@ int cp_node(struct dirtree *try)
 
       // Copy contents of file.
       } else {
-        int fdin;
+        int fdin, created;
 
         fdin = openat(tfd, try->name, O_RDONLY);
         if (fdin < 0) {
           catch = try->name;
           break;
         }
-        fdout = openat(cfd, catch, O_RDWR|O_CREAT|O_TRUNC, try->st.st_mode);
+        // --reflink doesn't truncate until it knows FICLONE failed, and only
+        // removes a file it created itself.
+        created = 0;
+        if (TT.reflink) {
+          fdout = openat(cfd, catch, O_RDWR|O_CREAT|O_EXCL, try->st.st_mode);
+          if (fdout >= 0) created++;
+          else if (errno == EEXIST) fdout = openat(cfd, catch, O_RDWR);
+        } else
+          fdout = openat(cfd, catch, O_RDWR|O_CREAT|O_TRUNC, try->st.st_mode);
         if (fdout >= 0) {
-          xsendfile(fdin, fdout);
-          err = 0;
+          // --reflink shares extents, falling back to a copy unless "always".
+          // A clone over an existing longer file leaves its tail, so trim it.
+          if (TT.reflink && !ioctl(fdout, FICLONE, fdin)) {
+            if (!ftruncate(fdout, try->st.st_size)) err = 0;
+          } else if (TT.reflink == 2) {
+            int i = errno;
+
+            close(fdout);
+            fdout = -1;
+            if (created) unlinkat(cfd, catch, 0);
+            close(fdin);
+            errno = i;
+            err = "reflink '%s'";
+            break;
+          } else if (!TT.reflink || !ftruncate(fdout, 0)) {
+            xsendfile(fdin, fdout);
+            err = 0;
+          }
         }
 
         // We only copy xattrs for files because there's no flistxattrat()
@@ -378,9 +409,11 @@ void cp_main(void)
     umask(0);
   }
   // Not using comma_args() (yet?) because interpeting as letters.
-  if (CFG_CP_PRESERVE && (toys.optflags & FLAG_preserve)) {
+  if (CFG_CP_MORE && (toys.optflags & FLAG_preserve)) {
     char *pre = xstrdup(TT.c.preserve), *s;
 
+    if (!CFG_CP_PRESERVE) error_exit("no --preserve support");
+
     if (comma_scan(pre, "all", 1)) TT.pflags = ~0;
     for (i=0; i<ARRAY_LEN(cp_preserve); i++)
       if (comma_scan(pre, cp_preserve[i].name, 1)) TT.pflags |= 1<<i;
@@ -400,6 +433,13 @@ void cp_main(void)
     }
     free(pre);
   }
+  if (CFG_CP_MORE && (toys.optflags & FLAG_reflink)) {
+    char *s = TT.c.reflink;
+
+    if (!s || !strcmp(s, "always")) TT.reflink = 2;
+    else if (!strcmp(s, "auto")) TT.reflink = 1;
+    else if (strcmp(s, "never")) error_exit("bad --reflink=%s", s);
+  }
   if (!TT.callback) TT.callback = cp_node;
 
   // Loop through sources
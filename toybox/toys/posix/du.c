@@ -130,7 +130,8 @@ static int do_du(struct dirtree *node)
   if (S_ISDIR(node->st.st_mode)) {
     if (!node->again) {
       TT.depth++;
-      return DIRTREE_COMEAGAIN|(DIRTREE_SYMFOLLOW*!!(toys.optflags&FLAG_L));
+      return DIRTREE_COMEAGAIN|DIRTREE_PARALLEL
+        |(DIRTREE_SYMFOLLOW*!!(toys.optflags&FLAG_L));
     } else TT.depth--;
   }
 
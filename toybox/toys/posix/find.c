@@ -58,7 +58,7 @@ config FIND
 GLOBALS(
   char **filter;
   struct double_list *argdata;
-  int topdir, xdev, depth;
+  int topdir, xdev, depth, modify;
   time_t now;
 )
 
@@ -200,7 +200,9 @@ static int do_find(struct dirtree *new)
   struct double_list *argdata = TT.argdata;
   char *s, **ss;
 
-  recurse = DIRTREE_COMEAGAIN|(DIRTREE_SYMFOLLOW*!!(toys.optflags&FLAG_L));
+  // Commands and -delete could change files we'd already have stat()ed
+  recurse = DIRTREE_COMEAGAIN|(DIRTREE_PARALLEL*!TT.modify)
+    |(DIRTREE_SYMFOLLOW*!!(toys.optflags&FLAG_L));
 
   // skip . and .. below topdir, handle -xdev and -depth
   if (new) {
@@ -280,7 +282,7 @@ static int do_find(struct dirtree *new)
     if (!strcmp(s, "xdev")) TT.xdev = 1;
     else if (!strcmp(s, "delete")) {
       // Delete forces depth first
-      TT.depth = 1;
+      TT.depth = TT.modify = 1;
       if (new && check)
         test = !unlinkat(dirtree_parentfd(new), new->name,
           S_ISDIR(new->st.st_mode) ? AT_REMOVEDIR : 0);
@@ -429,6 +431,7 @@ static int do_find(struct dirtree *new)
         struct exec_range *aa;
 
         print++;
+        TT.modify = 1;
 
         // Initial argument parsing pass
         if (!new) {
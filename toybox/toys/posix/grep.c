@@ -64,8 +64,205 @@ GLOBALS(
   long c;
 
   char indelim, outdelim;
+  struct grep_ac *lit, *pre;
 )
 
+// Aho-Corasick automaton finding any of a set of fixed strings in one pass.
+// Bytes the strings don't use share one column of the transition table (and
+// with -i both cases of a letter share a column), keeping it small for -f.
+// Each row ends with the length of the longest string ending in that state
+// (or -1), and states are stored as offsets of their row.
+struct grep_ac {
+  unsigned char class[256];
+  int width, maxlen, skip, *next;
+  struct arg_list *few;  // or just strstr() for each of a few strings
+};
+
+static struct grep_ac *ac_build(struct arg_list *list)
+{
+  struct grep_ac *ac = xzalloc(sizeof(struct grep_ac));
+  struct arg_list *al;
+  int i, c, w, st, len, states = 1, *fail, *queue, head = 0, tail = 0;
+  unsigned char *s;
+
+  // Give a column to each byte the strings use, plus one for the rest
+  for (w = 1, al = list; al; al = al->next) {
+    for (s = (void *)al->arg; *s; s++) {
+      c = (toys.optflags&FLAG_i) ? tolower(*s) : *s;
+      if (!ac->class[c]) ac->class[c] = w++;
+      if (toys.optflags&FLAG_i) ac->class[toupper(c)] = ac->class[c];
+    }
+    states += len = s-(unsigned char *)al->arg;
+    if (len>ac->maxlen) ac->maxlen = len;
+  }
+  ac->width = ++w;
+  ac->next = xmalloc(states*w*sizeof(int));
+  fail = xmalloc(states*sizeof(int));
+  queue = xmalloc(states*sizeof(int));
+  memset(ac->next, -1, states*w*sizeof(int));
+
+  // Trie of the strings
+  for (states = 1, al = list; al; al = al->next) {
+    for (st = 0, s = (void *)al->arg; *s; s++) {
+      int *n = ac->next+st+ac->class[*s];
+
+      if (*n == -1) *n = w*states++;
+      st = *n;
+    }
+    ac->next[st+w-1] = s-(unsigned char *)al->arg;
+  }
+
+  // Fill in the rest of the transitions breadth first from the failure
+  // links, and have each state report the longest string it ends.
+  for (c = 0; c<w-1; c++) {
+    if (-1 == (st = ac->next[c])) ac->next[c] = 0;
+    else fail[queue[tail++] = st/w] = 0;
+  }
+  while (head<tail) {
+    int *n = ac->next+w*(st = queue[head++]), *f = ac->next+fail[st];
+
+    if (n[w-1] == -1) n[w-1] = f[w-1];
+    for (c = 0; c<w-1; c++) {
+      if (n[c] == -1) n[c] = f[c];
+      else fail[queue[tail++] = n[c]/w] = f[c];
+    }
+  }
+  free(fail);
+  free(queue);
+
+  // libc's strstr() is vectorized, and a handful of passes beats this.
+  for (i = 0, al = list; al; al = al->next, i++) if (!*al->arg) i = 99;
+  if (i<4 && !(toys.optflags&FLAG_i)) ac->few = list;
+
+  // If only one byte leaves the start state, memchr() can find it.
+  ac->skip = -1;
+  for (c = 0; c<256; c++) {
+    if (!ac->next[ac->class[c]]) continue;
+    if (ac->skip != -1) {
+      ac->skip = -1;
+      break;
+    }
+    ac->skip = c;
+  }
+
+  return ac;
+}
+
+// Find leftmost longest string from the automaton in s, like regexec(). If
+// any will do, return the first one to end.
+static int ac_exec(struct grep_ac *ac, char *str, regmatch_t *m, int any)
+{
+  unsigned char *s = (void *)str;
+  long i, len = strlen(str), so = -1, eo = 0;
+  int st = 0, l, w = ac->width;
+
+  if (ac->few) {
+    struct arg_list *al;
+    char *p;
+
+    for (al = ac->few; al; al = al->next) {
+      if (!(p = strstr(str, al->arg))) continue;
+      l = strlen(al->arg);
+      if (so == -1 || p-str < so || (p-str == so && l > eo-so)) {
+        so = p-str;
+        eo = so+l;
+        if (any) break;
+      }
+    }
+  } else {
+
+    // The empty string matches at the start, but something longer might too
+    if (!ac->next[w-1]) {
+      if (any) len = 0;
+      so = 0;
+    }
+    for (i = 0; i<len; i++) {
+      if (so != -1 && i >= so+ac->maxlen) break;
+      if (!st && ac->skip != -1) {
+        unsigned char *p = memchr(s+i, ac->skip, len-i);
+
+        if (!p) break;
+        i = p-s;
+      }
+      st = ac->next[st+ac->class[s[i]]];
+      if (0 >= (l = ac->next[st+w-1])) continue;
+      if (so == -1 || i+1-l < so) {
+        so = i+1-l;
+        eo = i+1;
+        if (any) break;
+      } else if (i+1-l == so) eo = i+1;
+    }
+  }
+  if (so == -1) return 1;
+  m->rm_so = so;
+  m->rm_eo = eo;
+
+  return 0;
+}
+
+// Longest run of characters every match of this regex must contain, or 0.
+// Gives up on alternation and doesn't look inside groups or brackets.
+static char *required_literal(char *re)
+{
+  int ere = toys.optflags&FLAG_E, depth = 0, len = 0, blen = 0, c;
+  char *run = xmalloc(strlen(re)+1), *best = xmalloc(strlen(re)+1);
+
+  for (;;) {
+    c = *(unsigned char *)re++;
+
+    // Backslash escapes a literal, unless it's a BRE operator or extension.
+    if (c == '\\' && *re) {
+      c = *(unsigned char *)re++;
+      if (isalnum(c) || strchr("<>`'", c)) c = -1;
+      else if (!ere && strchr("(){}|?+", c)) c = -c;
+    } else if (c && (strchr(".[*^$", c) || (ere && strchr("(){}|+?", c))))
+      c = -c;
+
+    // Ordinary character (only ASCII case folds the same for -i)
+    if (c>0 && (c<128 || !(toys.optflags&FLAG_i))) {
+      if (!depth) run[len++] = c;
+      continue;
+    }
+
+    // Quantifiers make the preceding character optional ({0,} or ?) or
+    // repeated (+), either way it ends the run.
+    if (c == -'*' || c == -'?' || c == -'{') if (len) len--;
+    if (len>blen) memcpy(best, run, blen = len);
+    len = 0;
+    if (!c) break;
+    if (c == -'{') {
+      char *end = strstr(re, ere ? "}" : "\\}");
+
+      re = end ? end+1+!ere : re+strlen(re);
+    } else if (c == -'(') depth++;
+    else if (c == -')') depth--;
+    else if (c == -'|' && !depth) {
+      blen = 0;
+      break;
+    } else if (c == -'[') {
+      if (*re == '^') re++;
+      if (*re == ']') re++;
+      while (*re && *re != ']') {
+        if (*re == '[' && strchr(":.=", re[1])) {
+          char *end = strstr(re+2, (char []){re[1], ']', 0});
+
+          if (end) re = end+1;
+        }
+        re++;
+      }
+      if (*re) re++;
+    }
+  }
+  free(run);
+  if (blen) best[blen] = 0;
+  else {
+    free(best);
+    best = 0;
+  }
+
+  return best;
+}
+
 // Emit line with various potential prefixes and delimiter
 static void outline(char *line, char dash, char *name, long lcount, long bcount,
   int trim)
@@ -110,35 +307,14 @@ static void do_grep(int fd, char *name)
     do {
       int rc = 0, skip = 0;
 
-      // Handle non-regex matches
-      if (toys.optflags & FLAG_F) {
-        struct arg_list *seek, fseek;
-        char *s = 0;
-
-        for (seek = TT.e; seek; seek = seek->next) {
-          if (toys.optflags & FLAG_x) {
-            int i = (toys.optflags & FLAG_i);
-
-            if ((i ? strcasecmp : strcmp)(seek->arg, line)) s = line;
-          } else if (!*seek->arg) {
-            seek = &fseek;
-            fseek.arg = s = line;
-            break;
-          }
-          if (toys.optflags & FLAG_i) s = strnstr(line, seek->arg);
-          else s = strstr(line, seek->arg);
-          if (s) break;
-        }
-
-        if (s) {
-          matches.rm_so = (s-line);
-          skip = matches.rm_eo = (s-line)+strlen(seek->arg);
-        } else rc = 1;
-      } else {
-        rc = regexec((regex_t *)toybuf, start, 1, &matches,
-                     start==line ? 0 : REG_NOTBOL);
-        skip = matches.rm_eo;
-      }
+      // Fixed strings don't need regexec(), and a regex can't match a line
+      // without the literal text it requires.
+      if (TT.lit) rc = ac_exec(TT.lit, start, &matches,
+                        !(toys.optflags & (FLAG_o|FLAG_w|FLAG_x)));
+      else if (TT.pre && ac_exec(TT.pre, start, &matches, 1)) rc = 1;
+      else rc = regexec((regex_t *)toybuf, start, 1, &matches,
+                        start==line ? 0 : REG_NOTBOL);
+      skip = matches.rm_eo;
 
       if (toys.optflags & FLAG_x)
         if (matches.rm_so || line[matches.rm_eo]) rc = 1;
@@ -286,10 +462,24 @@ static void parse_regex(void)
   }
   TT.e = list;
 
-  if (!(toys.optflags & FLAG_F)) {
+  // Patterns without regex syntax are fixed strings too.
+  s = (toys.optflags & FLAG_E) ? ".[*^$\\(){}|+?" : ".[*^$\\";
+  for (al = TT.e; al; al = al->next) if (strpbrk(al->arg, s)) break;
+  if (!al || (toys.optflags & FLAG_F)) TT.lit = ac_build(TT.e);
+  else {
     char *regstr;
     int i;
 
+    // Collect the literal each pattern needs, if they all have one.
+    for (al = TT.e, list = 0; al; al = al->next) {
+      if (!(s = required_literal(al->arg))) break;
+      new = xmalloc(sizeof(struct arg_list));
+      new->next = list;
+      new->arg = s;
+      list = new;
+    }
+    if (!al) TT.pre = ac_build(list);
+
     // Convert strings to one big regex
     for (al = TT.e; al; al = al->next)
       len += strlen(al->arg)+1+!(toys.optflags & FLAG_E);
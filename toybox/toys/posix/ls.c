@@ -320,7 +320,8 @@ static void listfiles(int dirfd, struct dirtree *indir)
     // Read directory contents. We dup() the fd because this will close it.
     // This reads/saves contents to display later, except for in "ls -1f" mode.
     indir->dirfd = dup(dirfd);
-    dirtree_recurse(indir, filter, DIRTREE_SYMFOLLOW*!!(flags&FLAG_L));
+    dirtree_recurse(indir, filter, DIRTREE_SYMFOLLOW*!!(flags&FLAG_L)
+      |(flags == (FLAG_1|FLAG_f) ? DIRTREE_STATLESS : DIRTREE_PARALLEL));
   }
 
   // Copy linked list to array and sort it. Directories go in array because
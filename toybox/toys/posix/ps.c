@@ -260,6 +260,9 @@ GLOBALS(
   int kcount, forcek, sortpos;
   int (*match_process)(long long *slot);
   void (*show_process)(void *tb);
+
+  struct pidcache *cache, *fresh;
+  int caching, ncache, cachepos, nfresh, fdcount, fdmax;
 )
 
 struct strawberry {
@@ -311,6 +314,16 @@ struct carveup {
   char str[];               // name, tty, command, wchan, attr, cmdline
 };
 
+// What top remembers about a process between refreshes: /proc files kept open
+// to pread() again, and the string fields, which don't change unless the
+// command name does (exec, prctl) or it gets a new tty.
+struct pidcache {
+  long long pid, ttynr, argv0len;
+  int fd[4];                // stat, status, io, statm
+  unsigned short offset[5];
+  char *str;                // copy of carveup str[] from last time
+};
+
 // TODO: Android uses -30 for LABEL, but ideally it would auto-size.
 // 64|slot means compare as string when sorting
 struct typography {
@@ -544,6 +557,80 @@ static void show_ps(struct carveup *tb)
   xputc(TT.time ? '\r' : '\n');
 }
 
+static void pidcache_init(struct pidcache *pc, long long pid)
+{
+  memset(pc, 0, sizeof(*pc));
+  pc->pid = pid;
+  memset(pc->fd, -1, sizeof(pc->fd));
+}
+
+static void pidcache_free(struct pidcache *pc)
+{
+  int i;
+
+  for (i = 0; i<ARRAY_LEN(pc->fd); i++) {
+    if (pc->fd[i] != -1) {
+      close(pc->fd[i]);
+      TT.fdcount--;
+    }
+    pc->fd[i] = -1;
+  }
+  free(pc->str);
+  pc->str = 0;
+}
+
+// Find pid's entry from last pass, or start a new one. /proc lists pids in
+// order, so walk last pass's list alongside it, freeing the ones that exited.
+static struct pidcache *pidcache_get(long long pid)
+{
+  struct pidcache *pc;
+
+  while (TT.cachepos<TT.ncache && TT.cache[TT.cachepos].pid<pid)
+    pidcache_free(TT.cache+TT.cachepos++);
+  if (!(TT.nfresh&63))
+    TT.fresh = xrealloc(TT.fresh, (TT.nfresh+64)*sizeof(struct pidcache));
+  pc = TT.fresh+TT.nfresh++;
+  if (TT.cachepos<TT.ncache && TT.cache[TT.cachepos].pid==pid)
+    *pc = TT.cache[TT.cachepos++];
+  else pidcache_init(pc, pid);
+
+  return pc;
+}
+
+// End of a pass over /proc: whatever wasn't seen this time has exited.
+static void pidcache_done(void)
+{
+  while (TT.cachepos<TT.ncache) pidcache_free(TT.cache+TT.cachepos++);
+  free(TT.cache);
+  TT.cache = TT.fresh;
+  TT.ncache = TT.nfresh;
+  TT.fresh = 0;
+  TT.nfresh = TT.cachepos = 0;
+}
+
+// Read /proc/$PID/$name into buf, NUL terminated, returning length or -1.
+// When caching, keep the filehandle in *fd to pread() next time.
+static int read_pidfile(int dirfd, long long pid, char *name, int *fd,
+  char *buf, int len, struct stat *st)
+{
+  int i;
+
+  if (*fd == -1) {
+    sprintf(buf, "%lld/%s", pid, name);
+    if (-1 == (*fd = openat(dirfd, buf, O_RDONLY|O_CLOEXEC))) return -1;
+    TT.fdcount++;
+  }
+  if (0>(i = pread(*fd, buf, len-1, 0)) || (st && fstat(*fd, st))) i = -1;
+  else buf[i] = 0;
+  if (!TT.caching || i<0 || TT.fdcount>TT.fdmax) {
+    close(*fd);
+    *fd = -1;
+    TT.fdcount--;
+  }
+
+  return i;
+}
+
 // dirtree callback: read data about process to display, store, or discard it.
 // Fills toybuf with struct carveup and either DIRTREE_SAVEs a copy to ->extra
 // (in -k mode) or calls show_ps on toybuf (no malloc/copy/free there).
@@ -557,22 +644,36 @@ static int get_ps(struct dirtree *new)
     {"exe", _PS_COMMAND}, {"cmdline", _PS_CMDLINE|_PS_ARGS|_PS_NAME}
   };
   struct carveup *tb = (void *)toybuf;
+  struct pidcache *pc, nocache;
+  struct stat st;
   long long *slot = tb->slot;
-  char *name, *s, *buf = tb->str, *end = 0;
-  int i, j, fd;
+  char *name, *s, *ss, *buf = tb->str, *end = 0;
+  int i, j, fd, reuse;
   off_t len;
 
-  // Recurse one level into /proc children, skip non-numeric entries
+  // Recurse one level into /proc children, skip non-numeric entries. We get
+  // uid/gid from the stat file's filehandle, so dirtree needn't stat().
   if (!new->parent)
-    return DIRTREE_RECURSE|DIRTREE_SHUTUP|(DIRTREE_SAVE*!TT.show_process);
+    return DIRTREE_RECURSE|DIRTREE_SHUTUP|DIRTREE_STATLESS
+      |(DIRTREE_SAVE*!TT.show_process);
 
   memset(slot, 0, sizeof(tb->slot));
   if (!(*slot = atol(new->name))) return 0;
   fd = dirtree_parentfd(new);
 
-  len = 2048;
-  sprintf(buf, "%lld/stat", *slot);
-  if (!readfileat(fd, buf, buf, &len)) return 0;
+  if (TT.caching) pc = pidcache_get(*slot);
+  else pidcache_init(pc = &nocache, *slot);
+
+  // A cached filehandle for a pid that got reused reads nothing (the process
+  // it refers to is gone), so retry once with a fresh one.
+  for (i = 0; 0>read_pidfile(fd, *slot, "stat", pc->fd, buf, 2048, &st); i++){
+    pidcache_free(pc);
+    if (!TT.caching || i) {
+      if (TT.caching) TT.nfresh--;
+
+      return 0;
+    }
+  }
 
   // parse oddball fields (name and state). Name can have embedded ')' so match
   // _last_ ')' in stat (although VFS limits filenames to 255 bytes max).
@@ -583,7 +684,8 @@ static int get_ps(struct dirtree *new)
 
   // Parse numeric fields (starting at 4th field in slot[SLOT_ppid])
   if (1>sscanf(s = end, ") %c%n", &tb->state, &i)) return 0;
-  for (j = 1; j<50; j++) if (1>sscanf(s += i, " %lld%n", slot+j, &i)) break;
+  for (s += i, j = 1; j<50; j++, s = ss)
+    if (slot[j] = strtoll(s, &ss, 10), ss == s) break;
 
   // Now we've read the data, move status and name right after slot[] array,
   // and convert low chars to ? for non-tty display while we're at it.
@@ -593,12 +695,13 @@ static int get_ps(struct dirtree *new)
   buf = tb->str+i;
   *buf++ = 0;
   len = sizeof(toybuf)-(buf-toybuf);
+  reuse = pc->str && !strcmp(pc->str, tb->str) && pc->ttynr==slot[SLOT_ttynr];
 
   // save uid, ruid, gid, gid, and rgid int slots 31-34 (we don't use sigcatch
   // or numeric wchan, and the remaining two are always zero), and vmlck into
   // 18 (which is "obsolete, always 0" from stat)
-  slot[SLOT_uid] = new->st.st_uid;
-  slot[SLOT_gid] = new->st.st_gid;
+  slot[SLOT_uid] = st.st_uid;
+  slot[SLOT_gid] = st.st_gid;
 
   // TIME and TIME+ use combined value, ksort needs 'em added.
   slot[SLOT_utime] += slot[SLOT_stime];
@@ -609,24 +712,18 @@ static int get_ps(struct dirtree *new)
   if ((TT.bits&(_PS_RGROUP|_PS_RUSER|_PS_STAT|_PS_RUID|_PS_RGID|_PS_SWAP
                |_PS_IO|_PS_DIO)) || TT.GG.len || TT.UU.len)
   {
-    off_t temp = len;
-
-    sprintf(buf, "%lld/status", *slot);
-    if (!readfileat(fd, buf, buf, &temp)) *buf = 0;
+    if (0>read_pidfile(fd, *slot, "status", pc->fd+1, buf, len, 0)) *buf = 0;
     s = strafter(buf, "\nUid:");
-    slot[SLOT_ruid] = s ? atol(s) : new->st.st_uid;
+    slot[SLOT_ruid] = s ? atol(s) : st.st_uid;
     s = strafter(buf, "\nGid:");
-    slot[SLOT_rgid] = s ? atol(s) : new->st.st_gid;
+    slot[SLOT_rgid] = s ? atol(s) : st.st_gid;
     if ((s = strafter(buf, "\nVmLck:"))) slot[SLOT_vmlck] = atoll(s);
     if ((s = strafter(buf, "\nVmSwap:"))) slot[SLOT_swap] = atoll(s);
   }
 
   // Do we need to read "io"?
   if (TT.bits&(_PS_READ|_PS_WRITE|_PS_DREAD|_PS_DWRITE|_PS_IO|_PS_DIO)) {
-    off_t temp = len;
-
-    sprintf(buf, "%lld/io", *slot);
-    if (!readfileat(fd, buf, buf, &temp)) *buf = 0;
+    if (0>read_pidfile(fd, *slot, "io", pc->fd+2, buf, len, 0)) *buf = 0;
     if ((s = strafter(buf, "rchar:"))) slot[SLOT_rchar] = atoll(s);
     if ((s = strafter(buf, "wchar:"))) slot[SLOT_wchar] = atoll(s);
     if ((s = strafter(buf, "read_bytes:"))) slot[SLOT_rbytes] = atoll(s);
@@ -646,11 +743,7 @@ static int get_ps(struct dirtree *new)
 
   // Do we need to read "statm"?
   if (TT.bits&(_PS_VIRT|_PS_RES|_PS_SHR)) {
-    off_t temp = len;
-
-    sprintf(buf, "%lld/statm", *slot);
-    if (!readfileat(fd, buf, buf, &temp)) *buf = 0;
-    
+    if (0>read_pidfile(fd, *slot, "statm", pc->fd+3, buf, len, 0)) *buf = 0;
     for (s = buf, i=0; i<3; i++)
       if (!sscanf(s, " %lld%n", slot+SLOT_vsz+i, &j)) slot[SLOT_vsz+i] = 0;
       else s += j;
@@ -671,6 +764,18 @@ static int get_ps(struct dirtree *new)
     // Determine remaining space, reserving minimum of 256 bytes/field and
     // 260 bytes scratch space at the end (for output conversion later).
     len = sizeof(toybuf)-(buf-toybuf)-260-256*(ARRAY_LEN(fetch)-j);
+
+    // wchan is the only one that changes while the command stays the same
+    if (reuse && j!=1) {
+      s = pc->str+pc->offset[j];
+      if ((i = strlen(s))>len) i = len;
+      memcpy(buf, s, i);
+      buf[i] = 0;
+      if (j==4) slot[SLOT_argv0len] = pc->argv0len;
+      buf += i+1;
+
+      continue;
+    }
     sprintf(buf, "%lld/%s", *slot, fetch[j].name);
 
     // For cmdline we readlink instead of read contents
@@ -753,6 +858,15 @@ static int get_ps(struct dirtree *new)
     buf += strlen(buf)+1;
   }
 
+  if (TT.caching && !reuse) {
+    free(pc->str);
+    pc->str = xmalloc(buf-tb->str);
+    memcpy(pc->str, tb->str, buf-tb->str);
+    memcpy(pc->offset, tb->offset, sizeof(pc->offset));
+    pc->ttynr = slot[SLOT_ttynr];
+    pc->argv0len = slot[SLOT_argv0len];
+  }
+
   TT.kcount++;
   if (TT.show_process) {
     TT.show_process(tb);
@@ -1188,6 +1302,7 @@ static void top_common(
     plnew = plist+(tock&1);
     plnew->whence = militime();
     dt= dirtree_read("/proc", get_ps);
+    pidcache_done();
     plnew->tb = collate(plnew->count = TT.kcount, dt, ksort);
     TT.kcount = 0;
 
@@ -1399,8 +1514,17 @@ static void top_common(
 
 static void top_setup(char *defo, char *defk)
 {
+  struct rlimit rl;
   int len;
 
+  // Keep /proc files open between refreshes, leaving fds for everything else.
+  TT.caching++;
+  getrlimit(RLIMIT_NOFILE, &rl);
+  rl.rlim_cur = rl.rlim_max;
+  setrlimit(RLIMIT_NOFILE, &rl);
+  getrlimit(RLIMIT_NOFILE, &rl);
+  TT.fdmax = (rl.rlim_cur>65536 ? 65536 : rl.rlim_cur)-64;
+
   TT.time = militime();
   TT.top.d *= 1000;
   if (toys.optflags&FLAG_b) TT.width = TT.height = 99999;
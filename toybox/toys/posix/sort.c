@@ -26,7 +26,7 @@ config SORT_BIG
   default y
   depends on SORT
   help
-    usage: sort [-bcdfiMsz] [-k#[,#[x]] [-t X]] [-o FILE]
+    usage: sort [-bcdfiMsz] [-k#[,#[x]] [-t X]] [-o FILE] [-S SIZE] [-T DIR]
 
     -b	ignore leading blanks (or trailing blanks in second part of key)
     -c	check whether input is sorted
@@ -40,6 +40,8 @@ config SORT_BIG
     -k	sort by "key" (see below)
     -t	use a key separator other than whitespace
     -o	output to FILE instead of stdout
+    -S	memory to use before sorting via temporary files (k/m/g or % of RAM)
+    -T	directory for temporary files (default $TMPDIR, else /tmp)
 
     Sorting by key looks at a subset of the words on each line.  -k2
     uses the second word to the end of the line, -k2,2 looks at only
@@ -65,11 +67,15 @@ GLOBALS(
   char *key_separator;
   struct arg_list *raw_keys;
   char *outfile;
-  char *ignore1, ignore2;   // GNU compatability NOPs for -S and -T.
+  char *tmpdir;
+  char *size;
 
   void *key_list;
-  int linecount;
-  char **lines;
+  int linecount, nkeys, jobs, nruns, reaped, merged, memidx;
+  struct sort_line **lines, *last;
+  struct sort_run *runs;
+  long used, limit;
+  FILE *out;
 )
 
 // The sort types are n, g, and M.
@@ -86,6 +92,23 @@ struct sort_key
   int flags;
 };
 
+// An input line, with get_key_data() for each sort key done once up front
+// instead of twice per comparison.
+struct sort_line
+{
+  char *line;
+  char *key[];
+};
+
+// A sorted run of lines being merged: a temporary file, a pipe from a child
+// sorting part of the input, or (fp == 0) the rest of TT.lines in memory.
+struct sort_run
+{
+  FILE *fp;
+  struct sort_line *line;     // next line out of this run
+  pid_t pid;                  // child writing this run
+};
+
 // Copy of the part of this string corresponding to a key/flags.
 
 static char *get_key_data(char *str, struct sort_key *key, int flags)
@@ -169,6 +192,7 @@ static struct sort_key *add_key(void)
   struct sort_key **pkey = (struct sort_key **)stupid_compiler;
 
   while (*pkey) pkey = &((*pkey)->next_key);
+  TT.nkeys++;
   return *pkey = xzalloc(sizeof(struct sort_key));
 }
 
@@ -233,77 +257,289 @@ static int compare_values(int flags, char *x, char *y)
 // Callback from qsort(): Iterate through key_list and perform comparisons.
 static int compare_keys(const void *xarg, const void *yarg)
 {
-  int flags = toys.optflags, retval = 0;
-  char *x, *y, *xx = *(char **)xarg, *yy = *(char **)yarg;
+  int flags = toys.optflags, retval = 0, i = 0;
+  struct sort_line *x = *(struct sort_line **)xarg,
+    *y = *(struct sort_line **)yarg;
   struct sort_key *key;
 
   if (CFG_SORT_BIG) {
     for (key=(struct sort_key *)TT.key_list; !retval && key;
-       key = key->next_key)
+       key = key->next_key, i++)
     {
       flags = key->flags ? key->flags : toys.optflags;
+      retval = compare_values(flags, x->key[i], y->key[i]);
+    }
+  } else retval = compare_values(flags, x->line, y->line);
+
+  // Perform fallback sort if necessary (always case insensitive, no -f,
+  // the point is to get a stable order even for -f sorts)
+  if (!retval && !(CFG_SORT_BIG && (toys.optflags&FLAG_s))) {
+    flags = toys.optflags;
+    retval = strcmp(x->line, y->line);
+  }
+
+  return retval * ((flags&FLAG_r) ? -1 : 1);
+}
 
-      // Chop out and modify key chunks, handling -dfib
+// Wrap a line (which we take ownership of) with its sort keys.
+static struct sort_line *new_line(char *str)
+{
+  struct sort_line *sl = xmalloc(sizeof(*sl)+TT.nkeys*sizeof(char *));
+  struct sort_key *key;
+  int i = 0;
 
-      x = get_key_data(xx, key, flags);
-      y = get_key_data(yy, key, flags);
+  sl->line = str;
+  TT.used += sizeof(*sl)+TT.nkeys*sizeof(char *)+strlen(str)+33;
+  for (key = TT.key_list; key; key = key->next_key, i++) {
+    sl->key[i] = get_key_data(str, key, key->flags ? key->flags:toys.optflags);
+    if (sl->key[i] != str) TT.used += strlen(sl->key[i])+17;
+  }
 
-      retval = compare_values(flags, x, y);
+  return sl;
+}
 
-      // Free the copies get_key_data() made.
+static void free_line(struct sort_line *sl)
+{
+  int i;
 
-      if (x != xx) free(x);
-      if (y != yy) free(y);
+  if (!sl) return;
+  for (i = 0; i<TT.nkeys; i++) if (sl->key[i] != sl->line) free(sl->key[i]);
+  free(sl->line);
+  free(sl);
+}
 
-      if (retval) break;
+static char sort_eol(void)
+{
+  return (CFG_SORT_BIG && (toys.optflags&FLAG_z)) ? 0 : '\n';
+}
+
+// Read a line from a run, or return 0 at the end of it.
+static struct sort_line *sort_next(struct sort_run *run)
+{
+  char *line = 0;
+  size_t size = 0;
+  long len;
+
+  if (!run->fp) return TT.memidx<TT.linecount ? TT.lines[TT.memidx++] : 0;
+  if (1 > (len = getdelim(&line, &size, sort_eol(), run->fp))) {
+    free(line);
+
+    return 0;
+  }
+  if (line[len-1] == sort_eol()) line[len-1] = 0;
+
+  return new_line(line);
+}
+
+// Write out a line and free it, dropping it instead if -u and it's the same
+// as the last one.
+static void sort_out(struct sort_line *sl, FILE *fp)
+{
+  if (toys.optflags&FLAG_u) {
+    if (TT.last && !compare_keys(&TT.last, &sl)) {
+      free_line(sl);
+
+      return;
     }
-  } else retval = compare_values(flags, xx, yy);
+    free_line(TT.last);
+    TT.last = sl;
+  }
+  fputs(sl->line, fp);
+  fputc(sort_eol(), fp);
+  if (!(toys.optflags&FLAG_u)) free_line(sl);
+}
 
-  // Perform fallback sort if necessary (always case insensitive, no -f,
-  // the point is to get a stable order even for -f sorts)
-  if (!retval && !(CFG_SORT_BIG && (toys.optflags&FLAG_s))) {
-    flags = toys.optflags;
-    retval = strcmp(xx, yy);
+static struct sort_run *add_run(void)
+{
+  if (!(TT.nruns&15))
+    TT.runs = xrealloc(TT.runs, sizeof(struct sort_run)*(TT.nruns+16));
+
+  return memset(TT.runs+TT.nruns++, 0, sizeof(struct sort_run));
+}
+
+// Anonymous file in -T dir, for a run too big to keep in memory.
+static int sort_tempfile(void)
+{
+  char *name = xmprintf("%s/sortXXXXXX", TT.tmpdir);
+  int fd = mkstemp(name);
+
+  if (fd == -1) perror_exit("%s", name);
+  unlink(name);
+  free(name);
+
+  return fd;
+}
+
+// Wait for a child writing a run. (It already complained if it failed.)
+static void sort_reap(struct sort_run *run)
+{
+  int status;
+
+  if (run->pid>0 && (waitpid(run->pid, &status, 0) != run->pid || status))
+    error_exit("sort child %d failed", run->pid);
+  run->pid = 0;
+}
+
+// Sort count lines and write them to fd, in a child process if we have
+// cores to spare so this process can get on with the rest of the input.
+// Either way the caller's copy of the lines is freed.
+static pid_t sort_write(int fd, struct sort_line **lines, int count)
+{
+  pid_t pid = (CFG_TOYBOX_FORK && TT.jobs>1) ? xfork() : 0;
+  FILE *fp;
+  int i;
+
+  if (!pid) {
+    qsort(lines, count, sizeof(*lines), compare_keys);
+    fp = xfdopen(xdup(fd), "w");
+    for (i = 0; i<count; i++) {
+      fputs(lines[i]->line, fp);
+      fputc(sort_eol(), fp);
+    }
+    if (fclose(fp)) {
+      perror_msg("sort temp");
+      if (TT.jobs>1) _exit(1);
+      xexit();
+    }
+    if (TT.jobs>1) _exit(0);
   }
+  for (i = 0; i<count; i++) free_line(lines[i]);
 
-  return retval * ((flags&FLAG_r) ? -1 : 1);
+  return pid;
+}
+
+static void sift_down(int *heap, int len, int i)
+{
+  for (;;) {
+    int min = i, j, rc;
+
+    for (j = 2*i+1; j<len && j<2*i+3; j++) {
+      rc = compare_keys(&TT.runs[heap[j]].line, &TT.runs[heap[min]].line);
+      if (rc<0 || (!rc && heap[j]<heap[min])) min = j;
+    }
+    if (min == i) return;
+    j = heap[i];
+    heap[i] = heap[min];
+    heap[min] = j;
+    i = min;
+  }
+}
+
+// Merge count runs starting at first into fp, smallest line first. (Ties go
+// to the earlier run, which has the earlier input.)
+static void sort_merge(int first, int count, FILE *fp)
+{
+  int *heap = xmalloc(count*sizeof(int)), len = 0, i;
+  struct sort_run *run;
+
+  for (i = first; i<first+count; i++)
+    if ((TT.runs[i].line = sort_next(TT.runs+i))) heap[len++] = i;
+  for (i = len/2; i--;) sift_down(heap, len, i);
+  while (len) {
+    run = TT.runs+*heap;
+    sort_out(run->line, fp);
+    if (!(run->line = sort_next(run))) *heap = heap[--len];
+    sift_down(heap, len, 0);
+  }
+  for (i = first; i<first+count; i++) {
+    if (TT.runs[i].fp) fclose(TT.runs[i].fp);
+    TT.runs[i].fp = 0;
+  }
+  free_line(TT.last);
+  TT.last = 0;
+  free(heap);
+}
+
+// Merge the oldest runs a few hundred at a time if there are too many to keep
+// open at once. The merged run takes the place of the last one that went into
+// it, so runs stay in input order.
+static void sort_compact(void)
+{
+  FILE *fp;
+  int fd, i;
+
+  while (TT.nruns-TT.merged > 256) {
+    while (TT.reaped<TT.merged+256) sort_reap(TT.runs+TT.reaped++);
+    for (i = TT.merged; i<TT.merged+256; i++)
+      fseek(TT.runs[i].fp, 0, SEEK_SET);
+    fd = sort_tempfile();
+    fp = xfdopen(xdup(fd), "w");
+    sort_merge(TT.merged, 256, fp);
+    if (fclose(fp)) perror_exit("sort temp");
+    TT.merged += 255;
+    TT.runs[TT.merged].fp = xfdopen(fd, "r");
+    fseek(TT.runs[TT.merged].fp, 0, SEEK_SET);
+  }
+}
+
+// Write the lines read so far to a sorted run in a temporary file. Each run
+// gets 1/jobs of the -S memory, so children sorting earlier runs and this
+// process reading the next one stay within it between them.
+static void sort_spill(void)
+{
+  struct sort_run *run;
+  int fd;
+
+  while (TT.nruns-TT.reaped >= TT.jobs-1 && TT.reaped<TT.nruns)
+    sort_reap(TT.runs+TT.reaped++);
+  fd = sort_tempfile();
+  run = add_run();
+  run->fp = xfdopen(fd, "r");
+  run->pid = sort_write(fd, TT.lines, TT.linecount);
+  TT.linecount = TT.used = 0;
+  sort_compact();
 }
 
 // Callback from loopfiles to handle input files.
 static void sort_read(int fd, char *name)
 {
+  FILE *fp = fdopen(fd, "r");
+  char *line = 0;
+  size_t size = 0;
+  long len;
+
+  if (!fp) {
+    perror_msg_raw(name);
+    return;
+  }
+
   // Read each line from file, appending to a big array.
 
-  for (;;) {
-    char * line = (CFG_SORT_BIG && (toys.optflags&FLAG_z))
-             ? get_rawline(fd, NULL, 0) : get_line(fd);
+  while (0 < (len = getdelim(&line, &size, sort_eol(), fp))) {
+    struct sort_line *sl;
 
-    if (!line) break;
+    if (line[len-1] == sort_eol()) line[--len] = 0;
+    sl = new_line(xstrndup(line, len));
 
     // handle -c here so we don't allocate more memory than necessary.
     if (CFG_SORT_BIG && (toys.optflags&FLAG_c)) {
       int j = (toys.optflags&FLAG_u) ? -1 : 0;
 
-      if (TT.lines && compare_keys((void *)&TT.lines, &line)>j)
+      if (TT.last && compare_keys(&TT.last, &sl)>j)
         error_exit("%s: Check line %d\n", name, TT.linecount);
-      free(TT.lines);
-      TT.lines = (char **)line;
+      free_line(TT.last);
+      TT.last = sl;
     } else {
       if (!(TT.linecount&63))
-        TT.lines = xrealloc(TT.lines, sizeof(char *)*(TT.linecount+64));
-      TT.lines[TT.linecount] = line;
+        TT.lines = xrealloc(TT.lines, sizeof(*TT.lines)*(TT.linecount+64));
+      TT.lines[TT.linecount] = sl;
+      if (TT.limit && TT.used>TT.limit) {
+        TT.linecount++;
+        sort_spill();
+        continue;
+      }
     }
     TT.linecount++;
   }
+  free(line);
+
+  // loopfiles will also close the fd, but this frees an (opaque) struct.
+  fclose(fp);
 }
 
 void sort_main(void)
 {
-  int idx, fd = 1;
-
-  // Open output file if necessary.
-  if (CFG_SORT_BIG && TT.outfile)
-    fd = xcreate(TT.outfile, O_CREAT|O_TRUNC|O_WRONLY, 0666);
+  int idx, count;
 
   // Parse -k sort keys.
   if (CFG_SORT_BIG && TT.raw_keys) {
@@ -360,41 +596,72 @@ void sort_main(void)
   // If no keys, perform alphabetic sort over the whole line.
   if (CFG_SORT_BIG && !TT.key_list) add_key()->range[0] = 1;
 
+  // -S is KiB without a suffix, like GNU. Sort in memory if not set.
+  TT.jobs = CFG_TOYBOX_FORK ? sysconf(_SC_NPROCESSORS_ONLN) : 1;
+  if (TT.jobs<1) TT.jobs = 1;
+  if (CFG_SORT_BIG && TT.size && *TT.size) {
+    char c = TT.size[strlen(TT.size)-1];
+    unsigned long long limit;
+
+    if (c == '%') {
+      struct sysinfo si;
+      int pct = atoi(TT.size);
+
+      if (pct<1 || pct>100) error_exit("bad -S %s", TT.size);
+      sysinfo(&si);
+      limit = (unsigned long long)si.totalram*si.mem_unit/100*pct;
+    } else limit = atolx_range(TT.size, 1, LONG_MAX)*(isdigit(c) ? 1024ULL : 1);
+    // A 32 bit long can't count gigabytes of RAM.
+    TT.limit = (limit>LONG_MAX ? LONG_MAX : limit)/TT.jobs;
+  }
+  if (!TT.tmpdir && !(TT.tmpdir = getenv("TMPDIR"))) TT.tmpdir = "/tmp";
+
   // Open input files and read data, populating TT.lines[TT.linecount]
+  // and spilling sorted runs to TT.runs[] past -S.
   loopfiles(toys.optargs, sort_read);
 
   // The compare (-c) logic was handled in sort_read(),
   // so if we got here, we're done.
   if (CFG_SORT_BIG && (toys.optflags&FLAG_c)) goto exit_now;
 
-  // Perform the actual sort
-  qsort(TT.lines, TT.linecount, sizeof(char *), compare_keys);
-
-  // handle unique (-u)
-  if (toys.optflags&FLAG_u) {
-    int jdx;
-
-    for (jdx=0, idx=1; idx<TT.linecount; idx++) {
-      if (!compare_keys(&TT.lines[jdx], &TT.lines[idx]))
-        free(TT.lines[idx]);
-      else TT.lines[++jdx] = TT.lines[idx];
-    }
-    if (TT.linecount) TT.linecount = jdx+1;
+  // Rewind the runs in temporary files.
+  while (TT.reaped<TT.nruns) sort_reap(TT.runs+TT.reaped++);
+  for (idx = TT.merged; idx<TT.nruns; idx++)
+    fseek(TT.runs[idx].fp, 0, SEEK_SET);
+
+  // Sort what's still in memory, big chunks of it in parallel children
+  // that hand their sorted lines back through pipes, the rest here.
+  count = TT.linecount>>14;
+  if (count>TT.jobs) count = TT.jobs;
+  for (idx = 1; idx<count; idx++) {
+    struct sort_run *run = add_run();
+    int pipes[2], len = TT.linecount/count;
+
+    xpipe(pipes);
+    run->pid = sort_write(pipes[1], TT.lines+TT.memidx, len);
+    close(pipes[1]);
+    run->fp = xfdopen(pipes[0], "r");
+    TT.memidx += len;
   }
+  qsort(TT.lines+TT.memidx, TT.linecount-TT.memidx, sizeof(*TT.lines),
+    compare_keys);
+  add_run();
 
-  // Output result
-  for (idx = 0; idx<TT.linecount; idx++) {
-    char *s = TT.lines[idx];
-    unsigned i = strlen(s);
+  // Open output file (after reading input, so it can be one of the inputs)
+  TT.out = stdout;
+  if (CFG_SORT_BIG && TT.outfile)
+    TT.out = xfdopen(xcreate(TT.outfile, O_CREAT|O_TRUNC|O_WRONLY, 0666), "w");
 
-    if (!(toys.optflags&FLAG_z)) s[i] = '\n';
-    xwrite(fd, s, i+1);
-    if (CFG_TOYBOX_FREE) free(s);
-  }
+  // Output result
+  sort_merge(TT.merged, TT.nruns-TT.merged, TT.out);
+  if (fflush(TT.out) || ferror(TT.out)) perror_exit("write");
+  for (idx = TT.merged; idx<TT.nruns; idx++) sort_reap(TT.runs+idx);
 
 exit_now:
   if (CFG_TOYBOX_FREE) {
-    if (fd != 1) close(fd);
+    if (TT.out && TT.out != stdout) fclose(TT.out);
+    free_line(TT.last);
     free(TT.lines);
+    free(TT.runs);
   }
 }
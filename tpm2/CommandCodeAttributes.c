@@ -78,7 +78,8 @@ CommandIsImplemented(
 //
 //          CommandGetAttribute()
 //
-//     return a TPMA_CC structure for the given command code
+//     return a TPMA_CC structure for the given command code. s_ccAttr has one entry for every code from
+//     TPM_CC_FIRST to TPM_CC_LAST, so the entry is found by indexing rather than by searching.
 //
 TPMA_CC
 CommandGetAttribute(
@@ -86,11 +87,11 @@ CommandGetAttribute(
     )
 {
     UINT32      size = sizeof(s_ccAttr) / sizeof(s_ccAttr[0]);
-    UINT32      i;
-    for(i = 0; i < size; i++) {
-        if(s_ccAttr[i].commandIndex == (UINT16) commandCode)
-            return s_ccAttr[i];
-    }
+    UINT32      i = commandCode - TPM_CC_FIRST;
+    if(   commandCode >= TPM_CC_FIRST
+       && i < size
+       && s_ccAttr[i].commandIndex == (UINT16) commandCode)
+        return s_ccAttr[i];
     // This function should be called in the way that the command code
     // attribute is available.
     FAIL(FATAL_ERROR_INTERNAL);
@@ -115,772 +115,357 @@
 #include "Implementation.h"
 #include "CommandDispatcher_fp.h"
 
-TPM_RC CommandDispatcher(TPMI_ST_COMMAND_TAG tag,
-                         TPM_CC command_code,
-                         INT32* request_parameter_buffer_size,
-                         BYTE* request_parameter_buffer_start,
-                         TPM_HANDLE request_handles[],
-                         UINT32* response_handle_buffer_size,
-                         UINT32* response_parameter_buffer_size) {
-  BYTE* request_parameter_buffer = request_parameter_buffer_start;
-  switch (command_code) {
+typedef TPM_RC (*EXEC_FUNCTION)(TPMI_ST_COMMAND_TAG tag,
+                               BYTE** request_parameter_buffer,
+                               INT32* request_parameter_buffer_size,
+                               TPM_HANDLE request_handles[],
+                               UINT32* response_handle_buffer_size,
+                               UINT32* response_parameter_buffer_size);
+
+// Indexed by command code, so dispatch is a single bounds check and an
+// indirect call. Entries of commands not built in are NULL.
+static const EXEC_FUNCTION s_execFunctions[TPM_CC_LAST - TPM_CC_FIRST + 1] = {
 #ifdef TPM_CC_ActivateCredential
-    case TPM_CC_ActivateCredential:
-      return Exec_ActivateCredential(
-          tag, &request_parameter_buffer, request_parameter_buffer_size,
-          request_handles, response_handle_buffer_size,
-          response_parameter_buffer_size);
+    [TPM_CC_ActivateCredential - TPM_CC_FIRST] = Exec_ActivateCredential,
 #endif
 #ifdef TPM_CC_Certify
-    case TPM_CC_Certify:
-      return Exec_Certify(tag, &request_parameter_buffer,
-                          request_parameter_buffer_size, request_handles,
-                          response_handle_buffer_size,
-                          response_parameter_buffer_size);
+    [TPM_CC_Certify - TPM_CC_FIRST] = Exec_Certify,
 #endif
 #ifdef TPM_CC_CertifyCreation
-    case TPM_CC_CertifyCreation:
-      return Exec_CertifyCreation(tag, &request_parameter_buffer,
-                                  request_parameter_buffer_size,
-                                  request_handles, response_handle_buffer_size,
-                                  response_parameter_buffer_size);
+    [TPM_CC_CertifyCreation - TPM_CC_FIRST] = Exec_CertifyCreation,
 #endif
 #ifdef TPM_CC_ChangeEPS
-    case TPM_CC_ChangeEPS:
-      return Exec_ChangeEPS(tag, &request_parameter_buffer,
-                            request_parameter_buffer_size, request_handles,
-                            response_handle_buffer_size,
-                            response_parameter_buffer_size);
+    [TPM_CC_ChangeEPS - TPM_CC_FIRST] = Exec_ChangeEPS,
 #endif
 #ifdef TPM_CC_ChangePPS
-    case TPM_CC_ChangePPS:
-      return Exec_ChangePPS(tag, &request_parameter_buffer,
-                            request_parameter_buffer_size, request_handles,
-                            response_handle_buffer_size,
-                            response_parameter_buffer_size);
+    [TPM_CC_ChangePPS - TPM_CC_FIRST] = Exec_ChangePPS,
 #endif
 #ifdef TPM_CC_Clear
-    case TPM_CC_Clear:
-      return Exec_Clear(tag, &request_parameter_buffer,
-                        request_parameter_buffer_size, request_handles,
-                        response_handle_buffer_size,
-                        response_parameter_buffer_size);
+    [TPM_CC_Clear - TPM_CC_FIRST] = Exec_Clear,
 #endif
 #ifdef TPM_CC_ClearControl
-    case TPM_CC_ClearControl:
-      return Exec_ClearControl(tag, &request_parameter_buffer,
-                               request_parameter_buffer_size, request_handles,
-                               response_handle_buffer_size,
-                               response_parameter_buffer_size);
+    [TPM_CC_ClearControl - TPM_CC_FIRST] = Exec_ClearControl,
 #endif
 #ifdef TPM_CC_ClockRateAdjust
-    case TPM_CC_ClockRateAdjust:
-      return Exec_ClockRateAdjust(tag, &request_parameter_buffer,
-                                  request_parameter_buffer_size,
-                                  request_handles, response_handle_buffer_size,
-                                  response_parameter_buffer_size);
+    [TPM_CC_ClockRateAdjust - TPM_CC_FIRST] = Exec_ClockRateAdjust,
 #endif
 #ifdef TPM_CC_ClockSet
-    case TPM_CC_ClockSet:
-      return Exec_ClockSet(tag, &request_parameter_buffer,
-                           request_parameter_buffer_size, request_handles,
-                           response_handle_buffer_size,
-                           response_parameter_buffer_size);
+    [TPM_CC_ClockSet - TPM_CC_FIRST] = Exec_ClockSet,
 #endif
 #ifdef TPM_CC_Commit
-    case TPM_CC_Commit:
-      return Exec_Commit(tag, &request_parameter_buffer,
-                         request_parameter_buffer_size, request_handles,
-                         response_handle_buffer_size,
-                         response_parameter_buffer_size);
+    [TPM_CC_Commit - TPM_CC_FIRST] = Exec_Commit,
 #endif
 #ifdef TPM_CC_ContextLoad
-    case TPM_CC_ContextLoad:
-      return Exec_ContextLoad(tag, &request_parameter_buffer,
-                              request_parameter_buffer_size, request_handles,
-                              response_handle_buffer_size,
-                              response_parameter_buffer_size);
+    [TPM_CC_ContextLoad - TPM_CC_FIRST] = Exec_ContextLoad,
 #endif
 #ifdef TPM_CC_ContextSave
-    case TPM_CC_ContextSave:
-      return Exec_ContextSave(tag, &request_parameter_buffer,
-                              request_parameter_buffer_size, request_handles,
-                              response_handle_buffer_size,
-                              response_parameter_buffer_size);
+    [TPM_CC_ContextSave - TPM_CC_FIRST] = Exec_ContextSave,
 #endif
 #ifdef TPM_CC_Create
-    case TPM_CC_Create:
-      return Exec_Create(tag, &request_parameter_buffer,
-                         request_parameter_buffer_size, request_handles,
-                         response_handle_buffer_size,
-                         response_parameter_buffer_size);
+    [TPM_CC_Create - TPM_CC_FIRST] = Exec_Create,
 #endif
 #ifdef TPM_CC_CreatePrimary
-    case TPM_CC_CreatePrimary:
-      return Exec_CreatePrimary(tag, &request_parameter_buffer,
-                                request_parameter_buffer_size, request_handles,
-                                response_handle_buffer_size,
-                                response_parameter_buffer_size);
+    [TPM_CC_CreatePrimary - TPM_CC_FIRST] = Exec_CreatePrimary,
 #endif
 #ifdef TPM_CC_DictionaryAttackLockReset
-    case TPM_CC_DictionaryAttackLockReset:
-      return Exec_DictionaryAttackLockReset(
-          tag, &request_parameter_buffer, request_parameter_buffer_size,
-          request_handles, response_handle_buffer_size,
-          response_parameter_buffer_size);
+    [TPM_CC_DictionaryAttackLockReset - TPM_CC_FIRST] = Exec_DictionaryAttackLockReset,
 #endif
 #ifdef TPM_CC_DictionaryAttackParameters
-    case TPM_CC_DictionaryAttackParameters:
-      return Exec_DictionaryAttackParameters(
-          tag, &request_parameter_buffer, request_parameter_buffer_size,
-          request_handles, response_handle_buffer_size,
-          response_parameter_buffer_size);
+    [TPM_CC_DictionaryAttackParameters - TPM_CC_FIRST] = Exec_DictionaryAttackParameters,
 #endif
 #ifdef TPM_CC_Duplicate
-    case TPM_CC_Duplicate:
-      return Exec_Duplicate(tag, &request_parameter_buffer,
-                            request_parameter_buffer_size, request_handles,
-                            response_handle_buffer_size,
-                            response_parameter_buffer_size);
+    [TPM_CC_Duplicate - TPM_CC_FIRST] = Exec_Duplicate,
 #endif
 #ifdef TPM_CC_ECC_Parameters
-    case TPM_CC_ECC_Parameters:
-      return Exec_ECC_Parameters(tag, &request_parameter_buffer,
-                                 request_parameter_buffer_size, request_handles,
-                                 response_handle_buffer_size,
-                                 response_parameter_buffer_size);
+    [TPM_CC_ECC_Parameters - TPM_CC_FIRST] = Exec_ECC_Parameters,
 #endif
 #ifdef TPM_CC_ECDH_KeyGen
-    case TPM_CC_ECDH_KeyGen:
-      return Exec_ECDH_KeyGen(tag, &request_parameter_buffer,
-                              request_parameter_buffer_size, request_handles,
-                              response_handle_buffer_size,
-                              response_parameter_buffer_size);
+    [TPM_CC_ECDH_KeyGen - TPM_CC_FIRST] = Exec_ECDH_KeyGen,
 #endif
 #ifdef TPM_CC_ECDH_ZGen
-    case TPM_CC_ECDH_ZGen:
-      return Exec_ECDH_ZGen(tag, &request_parameter_buffer,
-                            request_parameter_buffer_size, request_handles,
-                            response_handle_buffer_size,
-                            response_parameter_buffer_size);
+    [TPM_CC_ECDH_ZGen - TPM_CC_FIRST] = Exec_ECDH_ZGen,
 #endif
 #ifdef TPM_CC_EC_Ephemeral
-    case TPM_CC_EC_Ephemeral:
-      return Exec_EC_Ephemeral(tag, &request_parameter_buffer,
-                               request_parameter_buffer_size, request_handles,
-                               response_handle_buffer_size,
-                               response_parameter_buffer_size);
+    [TPM_CC_EC_Ephemeral - TPM_CC_FIRST] = Exec_EC_Ephemeral,
 #endif
 #ifdef TPM_CC_EncryptDecrypt
-    case TPM_CC_EncryptDecrypt:
-      return Exec_EncryptDecrypt(tag, &request_parameter_buffer,
-                                 request_parameter_buffer_size, request_handles,
-                                 response_handle_buffer_size,
-                                 response_parameter_buffer_size);
+    [TPM_CC_EncryptDecrypt - TPM_CC_FIRST] = Exec_EncryptDecrypt,
 #endif
 #ifdef TPM_CC_EventSequenceComplete
-    case TPM_CC_EventSequenceComplete:
-      return Exec_EventSequenceComplete(
-          tag, &request_parameter_buffer, request_parameter_buffer_size,
-          request_handles, response_handle_buffer_size,
-          response_parameter_buffer_size);
+    [TPM_CC_EventSequenceComplete - TPM_CC_FIRST] = Exec_EventSequenceComplete,
 #endif
 #ifdef TPM_CC_EvictControl
-    case TPM_CC_EvictControl:
-      return Exec_EvictControl(tag, &request_parameter_buffer,
-                               request_parameter_buffer_size, request_handles,
-                               response_handle_buffer_size,
-                               response_parameter_buffer_size);
+    [TPM_CC_EvictControl - TPM_CC_FIRST] = Exec_EvictControl,
 #endif
 #ifdef TPM_CC_FieldUpgradeData
-    case TPM_CC_FieldUpgradeData:
-      return Exec_FieldUpgradeData(tag, &request_parameter_buffer,
-                                   request_parameter_buffer_size,
-                                   request_handles, response_handle_buffer_size,
-                                   response_parameter_buffer_size);
+    [TPM_CC_FieldUpgradeData - TPM_CC_FIRST] = Exec_FieldUpgradeData,
 #endif
 #ifdef TPM_CC_FieldUpgradeStart
-    case TPM_CC_FieldUpgradeStart:
-      return Exec_FieldUpgradeStart(
-          tag, &request_parameter_buffer, request_parameter_buffer_size,
-          request_handles, response_handle_buffer_size,
-          response_parameter_buffer_size);
+    [TPM_CC_FieldUpgradeStart - TPM_CC_FIRST] = Exec_FieldUpgradeStart,
 #endif
 #ifdef TPM_CC_FirmwareRead
-    case TPM_CC_FirmwareRead:
-      return Exec_FirmwareRead(tag, &request_parameter_buffer,
-                               request_parameter_buffer_size, request_handles,
-                               response_handle_buffer_size,
-                               response_parameter_buffer_size);
+    [TPM_CC_FirmwareRead - TPM_CC_FIRST] = Exec_FirmwareRead,
 #endif
 #ifdef TPM_CC_FlushContext
-    case TPM_CC_FlushContext:
-      return Exec_FlushContext(tag, &request_parameter_buffer,
-                               request_parameter_buffer_size, request_handles,
-                               response_handle_buffer_size,
-                               response_parameter_buffer_size);
+    [TPM_CC_FlushContext - TPM_CC_FIRST] = Exec_FlushContext,
 #endif
 #ifdef TPM_CC_GetCapability
-    case TPM_CC_GetCapability:
-      return Exec_GetCapability(tag, &request_parameter_buffer,
-                                request_parameter_buffer_size, request_handles,
-                                response_handle_buffer_size,
-                                response_parameter_buffer_size);
+    [TPM_CC_GetCapability - TPM_CC_FIRST] = Exec_GetCapability,
 #endif
 #ifdef TPM_CC_GetCommandAuditDigest
-    case TPM_CC_GetCommandAuditDigest:
-      return Exec_GetCommandAuditDigest(
-          tag, &request_parameter_buffer, request_parameter_buffer_size,
-          request_handles, response_handle_buffer_size,
-          response_parameter_buffer_size);
+    [TPM_CC_GetCommandAuditDigest - TPM_CC_FIRST] = Exec_GetCommandAuditDigest,
 #endif
 #ifdef TPM_CC_GetRandom
-    case TPM_CC_GetRandom:
-      return Exec_GetRandom(tag, &request_parameter_buffer,
-                            request_parameter_buffer_size, request_handles,
-                            response_handle_buffer_size,
-                            response_parameter_buffer_size);
+    [TPM_CC_GetRandom - TPM_CC_FIRST] = Exec_GetRandom,
 #endif
 #ifdef TPM_CC_GetSessionAuditDigest
-    case TPM_CC_GetSessionAuditDigest:
-      return Exec_GetSessionAuditDigest(
-          tag, &request_parameter_buffer, request_parameter_buffer_size,
-          request_handles, response_handle_buffer_size,
-          response_parameter_buffer_size);
+    [TPM_CC_GetSessionAuditDigest - TPM_CC_FIRST] = Exec_GetSessionAuditDigest,
 #endif
 #ifdef TPM_CC_GetTestResult
-    case TPM_CC_GetTestResult:
-      return Exec_GetTestResult(tag, &request_parameter_buffer,
-                                request_parameter_buffer_size, request_handles,
-                                response_handle_buffer_size,
-                                response_parameter_buffer_size);
+    [TPM_CC_GetTestResult - TPM_CC_FIRST] = Exec_GetTestResult,
 #endif
 #ifdef TPM_CC_GetTime
-    case TPM_CC_GetTime:
-      return Exec_GetTime(tag, &request_parameter_buffer,
-                          request_parameter_buffer_size, request_handles,
-                          response_handle_buffer_size,
-                          response_parameter_buffer_size);
+    [TPM_CC_GetTime - TPM_CC_FIRST] = Exec_GetTime,
 #endif
 #ifdef TPM_CC_HMAC
-    case TPM_CC_HMAC:
-      return Exec_HMAC(tag, &request_parameter_buffer,
-                       request_parameter_buffer_size, request_handles,
-                       response_handle_buffer_size,
-                       response_parameter_buffer_size);
+    [TPM_CC_HMAC - TPM_CC_FIRST] = Exec_HMAC,
 #endif
 #ifdef TPM_CC_HMAC_Start
-    case TPM_CC_HMAC_Start:
-      return Exec_HMAC_Start(tag, &request_parameter_buffer,
-                             request_parameter_buffer_size, request_handles,
-                             response_handle_buffer_size,
-                             response_parameter_buffer_size);
+    [TPM_CC_HMAC_Start - TPM_CC_FIRST] = Exec_HMAC_Start,
 #endif
 #ifdef TPM_CC_Hash
-    case TPM_CC_Hash:
-      return Exec_Hash(tag, &request_parameter_buffer,
-                       request_parameter_buffer_size, request_handles,
-                       response_handle_buffer_size,
-                       response_parameter_buffer_size);
+    [TPM_CC_Hash - TPM_CC_FIRST] = Exec_Hash,
 #endif
 #ifdef TPM_CC_HashSequenceStart
-    case TPM_CC_HashSequenceStart:
-      return Exec_HashSequenceStart(
-          tag, &request_parameter_buffer, request_parameter_buffer_size,
-          request_handles, response_handle_buffer_size,
-          response_parameter_buffer_size);
+    [TPM_CC_HashSequenceStart - TPM_CC_FIRST] = Exec_HashSequenceStart,
 #endif
 #ifdef TPM_CC_HierarchyChangeAuth
-    case TPM_CC_HierarchyChangeAuth:
-      return Exec_HierarchyChangeAuth(
-          tag, &request_parameter_buffer, request_parameter_buffer_size,
-          request_handles, response_handle_buffer_size,
-          response_parameter_buffer_size);
+    [TPM_CC_HierarchyChangeAuth - TPM_CC_FIRST] = Exec_HierarchyChangeAuth,
 #endif
 #ifdef TPM_CC_HierarchyControl
-    case TPM_CC_HierarchyControl:
-      return Exec_HierarchyControl(tag, &request_parameter_buffer,
-                                   request_parameter_buffer_size,
-                                   request_handles, response_handle_buffer_size,
-                                   response_parameter_buffer_size);
+    [TPM_CC_HierarchyControl - TPM_CC_FIRST] = Exec_HierarchyControl,
 #endif
 #ifdef TPM_CC_Import
-    case TPM_CC_Import:
-      return Exec_Import(tag, &request_parameter_buffer,
-                         request_parameter_buffer_size, request_handles,
-                         response_handle_buffer_size,
-                         response_parameter_buffer_size);
+    [TPM_CC_Import - TPM_CC_FIRST] = Exec_Import,
 #endif
 #ifdef TPM_CC_IncrementalSelfTest
-    case TPM_CC_IncrementalSelfTest:
-      return Exec_IncrementalSelfTest(
-          tag, &request_parameter_buffer, request_parameter_buffer_size,
-          request_handles, response_handle_buffer_size,
-          response_parameter_buffer_size);
+    [TPM_CC_IncrementalSelfTest - TPM_CC_FIRST] = Exec_IncrementalSelfTest,
 #endif
 #ifdef TPM_CC_Load
-    case TPM_CC_Load:
-      return Exec_Load(tag, &request_parameter_buffer,
-                       request_parameter_buffer_size, request_handles,
-                       response_handle_buffer_size,
-                       response_parameter_buffer_size);
+    [TPM_CC_Load - TPM_CC_FIRST] = Exec_Load,
 #endif
 #ifdef TPM_CC_LoadExternal
-    case TPM_CC_LoadExternal:
-      return Exec_LoadExternal(tag, &request_parameter_buffer,
-                               request_parameter_buffer_size, request_handles,
-                               response_handle_buffer_size,
-                               response_parameter_buffer_size);
+    [TPM_CC_LoadExternal - TPM_CC_FIRST] = Exec_LoadExternal,
 #endif
 #ifdef TPM_CC_MakeCredential
-    case TPM_CC_MakeCredential:
-      return Exec_MakeCredential(tag, &request_parameter_buffer,
-                                 request_parameter_buffer_size, request_handles,
-                                 response_handle_buffer_size,
-                                 response_parameter_buffer_size);
+    [TPM_CC_MakeCredential - TPM_CC_FIRST] = Exec_MakeCredential,
 #endif
 #ifdef TPM_CC_NV_Certify
-    case TPM_CC_NV_Certify:
-      return Exec_NV_Certify(tag, &request_parameter_buffer,
-                             request_parameter_buffer_size, request_handles,
-                             response_handle_buffer_size,
-                             response_parameter_buffer_size);
+    [TPM_CC_NV_Certify - TPM_CC_FIRST] = Exec_NV_Certify,
 #endif
 #ifdef TPM_CC_NV_ChangeAuth
-    case TPM_CC_NV_ChangeAuth:
-      return Exec_NV_ChangeAuth(tag, &request_parameter_buffer,
-                                request_parameter_buffer_size, request_handles,
-                                response_handle_buffer_size,
-                                response_parameter_buffer_size);
+    [TPM_CC_NV_ChangeAuth - TPM_CC_FIRST] = Exec_NV_ChangeAuth,
 #endif
 #ifdef TPM_CC_NV_DefineSpace
-    case TPM_CC_NV_DefineSpace:
-      return Exec_NV_DefineSpace(tag, &request_parameter_buffer,
-                                 request_parameter_buffer_size, request_handles,
-                                 response_handle_buffer_size,
-                                 response_parameter_buffer_size);
+    [TPM_CC_NV_DefineSpace - TPM_CC_FIRST] = Exec_NV_DefineSpace,
 #endif
 #ifdef TPM_CC_NV_Extend
-    case TPM_CC_NV_Extend:
-      return Exec_NV_Extend(tag, &request_parameter_buffer,
-                            request_parameter_buffer_size, request_handles,
-                            response_handle_buffer_size,
-                            response_parameter_buffer_size);
+    [TPM_CC_NV_Extend - TPM_CC_FIRST] = Exec_NV_Extend,
 #endif
 #ifdef TPM_CC_NV_GlobalWriteLock
-    case TPM_CC_NV_GlobalWriteLock:
-      return Exec_NV_GlobalWriteLock(
-          tag, &request_parameter_buffer, request_parameter_buffer_size,
-          request_handles, response_handle_buffer_size,
-          response_parameter_buffer_size);
+    [TPM_CC_NV_GlobalWriteLock - TPM_CC_FIRST] = Exec_NV_GlobalWriteLock,
 #endif
 #ifdef TPM_CC_NV_Increment
-    case TPM_CC_NV_Increment:
-      return Exec_NV_Increment(tag, &request_parameter_buffer,
-                               request_parameter_buffer_size, request_handles,
-                               response_handle_buffer_size,
-                               response_parameter_buffer_size);
+    [TPM_CC_NV_Increment - TPM_CC_FIRST] = Exec_NV_Increment,
 #endif
 #ifdef TPM_CC_NV_Read
-    case TPM_CC_NV_Read:
-      return Exec_NV_Read(tag, &request_parameter_buffer,
-                          request_parameter_buffer_size, request_handles,
-                          response_handle_buffer_size,
-                          response_parameter_buffer_size);
+    [TPM_CC_NV_Read - TPM_CC_FIRST] = Exec_NV_Read,
 #endif
 #ifdef TPM_CC_NV_ReadLock
-    case TPM_CC_NV_ReadLock:
-      return Exec_NV_ReadLock(tag, &request_parameter_buffer,
-                              request_parameter_buffer_size, request_handles,
-                              response_handle_buffer_size,
-                              response_parameter_buffer_size);
+    [TPM_CC_NV_ReadLock - TPM_CC_FIRST] = Exec_NV_ReadLock,
 #endif
 #ifdef TPM_CC_NV_ReadPublic
-    case TPM_CC_NV_ReadPublic:
-      return Exec_NV_ReadPublic(tag, &request_parameter_buffer,
-                                request_parameter_buffer_size, request_handles,
-                                response_handle_buffer_size,
-                                response_parameter_buffer_size);
+    [TPM_CC_NV_ReadPublic - TPM_CC_FIRST] = Exec_NV_ReadPublic,
 #endif
 #ifdef TPM_CC_NV_SetBits
-    case TPM_CC_NV_SetBits:
-      return Exec_NV_SetBits(tag, &request_parameter_buffer,
-                             request_parameter_buffer_size, request_handles,
-                             response_handle_buffer_size,
-                             response_parameter_buffer_size);
+    [TPM_CC_NV_SetBits - TPM_CC_FIRST] = Exec_NV_SetBits,
 #endif
 #ifdef TPM_CC_NV_UndefineSpace
-    case TPM_CC_NV_UndefineSpace:
-      return Exec_NV_UndefineSpace(tag, &request_parameter_buffer,
-                                   request_parameter_buffer_size,
-                                   request_handles, response_handle_buffer_size,
-                                   response_parameter_buffer_size);
+    [TPM_CC_NV_UndefineSpace - TPM_CC_FIRST] = Exec_NV_UndefineSpace,
 #endif
 #ifdef TPM_CC_NV_UndefineSpaceSpecial
-    case TPM_CC_NV_UndefineSpaceSpecial:
-      return Exec_NV_UndefineSpaceSpecial(
-          tag, &request_parameter_buffer, request_parameter_buffer_size,
-          request_handles, response_handle_buffer_size,
-          response_parameter_buffer_size);
+    [TPM_CC_NV_UndefineSpaceSpecial - TPM_CC_FIRST] = Exec_NV_UndefineSpaceSpecial,
 #endif
 #ifdef TPM_CC_NV_Write
-    case TPM_CC_NV_Write:
-      return Exec_NV_Write(tag, &request_parameter_buffer,
-                           request_parameter_buffer_size, request_handles,
-                           response_handle_buffer_size,
-                           response_parameter_buffer_size);
+    [TPM_CC_NV_Write - TPM_CC_FIRST] = Exec_NV_Write,
 #endif
 #ifdef TPM_CC_NV_WriteLock
-    case TPM_CC_NV_WriteLock:
-      return Exec_NV_WriteLock(tag, &request_parameter_buffer,
-                               request_parameter_buffer_size, request_handles,
-                               response_handle_buffer_size,
-                               response_parameter_buffer_size);
+    [TPM_CC_NV_WriteLock - TPM_CC_FIRST] = Exec_NV_WriteLock,
 #endif
 #ifdef TPM_CC_ObjectChangeAuth
-    case TPM_CC_ObjectChangeAuth:
-      return Exec_ObjectChangeAuth(tag, &request_parameter_buffer,
-                                   request_parameter_buffer_size,
-                                   request_handles, response_handle_buffer_size,
-                                   response_parameter_buffer_size);
+    [TPM_CC_ObjectChangeAuth - TPM_CC_FIRST] = Exec_ObjectChangeAuth,
 #endif
 #ifdef TPM_CC_PCR_Allocate
-    case TPM_CC_PCR_Allocate:
-      return Exec_PCR_Allocate(tag, &request_parameter_buffer,
-                               request_parameter_buffer_size, request_handles,
-                               response_handle_buffer_size,
-                               response_parameter_buffer_size);
+    [TPM_CC_PCR_Allocate - TPM_CC_FIRST] = Exec_PCR_Allocate,
 #endif
 #ifdef TPM_CC_PCR_Event
-    case TPM_CC_PCR_Event:
-      return Exec_PCR_Event(tag, &request_parameter_buffer,
-                            request_parameter_buffer_size, request_handles,
-                            response_handle_buffer_size,
-                            response_parameter_buffer_size);
+    [TPM_CC_PCR_Event - TPM_CC_FIRST] = Exec_PCR_Event,
 #endif
 #ifdef TPM_CC_PCR_Extend
-    case TPM_CC_PCR_Extend:
-      return Exec_PCR_Extend(tag, &request_parameter_buffer,
-                             request_parameter_buffer_size, request_handles,
-                             response_handle_buffer_size,
-                             response_parameter_buffer_size);
+    [TPM_CC_PCR_Extend - TPM_CC_FIRST] = Exec_PCR_Extend,
 #endif
 #ifdef TPM_CC_PCR_Read
-    case TPM_CC_PCR_Read:
-      return Exec_PCR_Read(tag, &request_parameter_buffer,
-                           request_parameter_buffer_size, request_handles,
-                           response_handle_buffer_size,
-                           response_parameter_buffer_size);
+    [TPM_CC_PCR_Read - TPM_CC_FIRST] = Exec_PCR_Read,
 #endif
 #ifdef TPM_CC_PCR_Reset
-    case TPM_CC_PCR_Reset:
-      return Exec_PCR_Reset(tag, &request_parameter_buffer,
-                            request_parameter_buffer_size, request_handles,
-                            response_handle_buffer_size,
-                            response_parameter_buffer_size);
+    [TPM_CC_PCR_Reset - TPM_CC_FIRST] = Exec_PCR_Reset,
 #endif
 #ifdef TPM_CC_PCR_SetAuthPolicy
-    case TPM_CC_PCR_SetAuthPolicy:
-      return Exec_PCR_SetAuthPolicy(
-          tag, &request_parameter_buffer, request_parameter_buffer_size,
-          request_handles, response_handle_buffer_size,
-          response_parameter_buffer_size);
+    [TPM_CC_PCR_SetAuthPolicy - TPM_CC_FIRST] = Exec_PCR_SetAuthPolicy,
 #endif
 #ifdef TPM_CC_PCR_SetAuthValue
-    case TPM_CC_PCR_SetAuthValue:
-      return Exec_PCR_SetAuthValue(tag, &request_parameter_buffer,
-                                   request_parameter_buffer_size,
-                                   request_handles, response_handle_buffer_size,
-                                   response_parameter_buffer_size);
+    [TPM_CC_PCR_SetAuthValue - TPM_CC_FIRST] = Exec_PCR_SetAuthValue,
 #endif
 #ifdef TPM_CC_PP_Commands
-    case TPM_CC_PP_Commands:
-      return Exec_PP_Commands(tag, &request_parameter_buffer,
-                              request_parameter_buffer_size, request_handles,
-                              response_handle_buffer_size,
-                              response_parameter_buffer_size);
+    [TPM_CC_PP_Commands - TPM_CC_FIRST] = Exec_PP_Commands,
 #endif
 #ifdef TPM_CC_PolicyAuthValue
-    case TPM_CC_PolicyAuthValue:
-      return Exec_PolicyAuthValue(tag, &request_parameter_buffer,
-                                  request_parameter_buffer_size,
-                                  request_handles, response_handle_buffer_size,
-                                  response_parameter_buffer_size);
+    [TPM_CC_PolicyAuthValue - TPM_CC_FIRST] = Exec_PolicyAuthValue,
 #endif
 #ifdef TPM_CC_PolicyAuthorize
-    case TPM_CC_PolicyAuthorize:
-      return Exec_PolicyAuthorize(tag, &request_parameter_buffer,
-                                  request_parameter_buffer_size,
-                                  request_handles, response_handle_buffer_size,
-                                  response_parameter_buffer_size);
+    [TPM_CC_PolicyAuthorize - TPM_CC_FIRST] = Exec_PolicyAuthorize,
 #endif
 #ifdef TPM_CC_PolicyCommandCode
-    case TPM_CC_PolicyCommandCode:
-      return Exec_PolicyCommandCode(
-          tag, &request_parameter_buffer, request_parameter_buffer_size,
-          request_handles, response_handle_buffer_size,
-          response_parameter_buffer_size);
+    [TPM_CC_PolicyCommandCode - TPM_CC_FIRST] = Exec_PolicyCommandCode,
 #endif
 #ifdef TPM_CC_PolicyCounterTimer
-    case TPM_CC_PolicyCounterTimer:
-      return Exec_PolicyCounterTimer(
-          tag, &request_parameter_buffer, request_parameter_buffer_size,
-          request_handles, response_handle_buffer_size,
-          response_parameter_buffer_size);
+    [TPM_CC_PolicyCounterTimer - TPM_CC_FIRST] = Exec_PolicyCounterTimer,
 #endif
 #ifdef TPM_CC_PolicyCpHash
-    case TPM_CC_PolicyCpHash:
-      return Exec_PolicyCpHash(tag, &request_parameter_buffer,
-                               request_parameter_buffer_size, request_handles,
-                               response_handle_buffer_size,
-                               response_parameter_buffer_size);
+    [TPM_CC_PolicyCpHash - TPM_CC_FIRST] = Exec_PolicyCpHash,
 #endif
 #ifdef TPM_CC_PolicyDuplicationSelect
-    case TPM_CC_PolicyDuplicationSelect:
-      return Exec_PolicyDuplicationSelect(
-          tag, &request_parameter_buffer, request_parameter_buffer_size,
-          request_handles, response_handle_buffer_size,
-          response_parameter_buffer_size);
+    [TPM_CC_PolicyDuplicationSelect - TPM_CC_FIRST] = Exec_PolicyDuplicationSelect,
 #endif
 #ifdef TPM_CC_PolicyGetDigest
-    case TPM_CC_PolicyGetDigest:
-      return Exec_PolicyGetDigest(tag, &request_parameter_buffer,
-                                  request_parameter_buffer_size,
-                                  request_handles, response_handle_buffer_size,
-                                  response_parameter_buffer_size);
+    [TPM_CC_PolicyGetDigest - TPM_CC_FIRST] = Exec_PolicyGetDigest,
 #endif
 #ifdef TPM_CC_PolicyLocality
-    case TPM_CC_PolicyLocality:
-      return Exec_PolicyLocality(tag, &request_parameter_buffer,
-                                 request_parameter_buffer_size, request_handles,
-                                 response_handle_buffer_size,
-                                 response_parameter_buffer_size);
+    [TPM_CC_PolicyLocality - TPM_CC_FIRST] = Exec_PolicyLocality,
 #endif
 #ifdef TPM_CC_PolicyNV
-    case TPM_CC_PolicyNV:
-      return Exec_PolicyNV(tag, &request_parameter_buffer,
-                           request_parameter_buffer_size, request_handles,
-                           response_handle_buffer_size,
-                           response_parameter_buffer_size);
+    [TPM_CC_PolicyNV - TPM_CC_FIRST] = Exec_PolicyNV,
 #endif
 #ifdef TPM_CC_PolicyNameHash
-    case TPM_CC_PolicyNameHash:
-      return Exec_PolicyNameHash(tag, &request_parameter_buffer,
-                                 request_parameter_buffer_size, request_handles,
-                                 response_handle_buffer_size,
-                                 response_parameter_buffer_size);
+    [TPM_CC_PolicyNameHash - TPM_CC_FIRST] = Exec_PolicyNameHash,
 #endif
 #ifdef TPM_CC_PolicyNvWritten
-    case TPM_CC_PolicyNvWritten:
-      return Exec_PolicyNvWritten(tag, &request_parameter_buffer,
-                                  request_parameter_buffer_size,
-                                  request_handles, response_handle_buffer_size,
-                                  response_parameter_buffer_size);
+    [TPM_CC_PolicyNvWritten - TPM_CC_FIRST] = Exec_PolicyNvWritten,
 #endif
 #ifdef TPM_CC_PolicyOR
-    case TPM_CC_PolicyOR:
-      return Exec_PolicyOR(tag, &request_parameter_buffer,
-                           request_parameter_buffer_size, request_handles,
-                           response_handle_buffer_size,
-                           response_parameter_buffer_size);
+    [TPM_CC_PolicyOR - TPM_CC_FIRST] = Exec_PolicyOR,
 #endif
 #ifdef TPM_CC_PolicyPCR
-    case TPM_CC_PolicyPCR:
-      return Exec_PolicyPCR(tag, &request_parameter_buffer,
-                            request_parameter_buffer_size, request_handles,
-                            response_handle_buffer_size,
-                            response_parameter_buffer_size);
+    [TPM_CC_PolicyPCR - TPM_CC_FIRST] = Exec_PolicyPCR,
 #endif
 #ifdef TPM_CC_PolicyPassword
-    case TPM_CC_PolicyPassword:
-      return Exec_PolicyPassword(tag, &request_parameter_buffer,
-                                 request_parameter_buffer_size, request_handles,
-                                 response_handle_buffer_size,
-                                 response_parameter_buffer_size);
+    [TPM_CC_PolicyPassword - TPM_CC_FIRST] = Exec_PolicyPassword,
 #endif
 #ifdef TPM_CC_PolicyPhysicalPresence
-    case TPM_CC_PolicyPhysicalPresence:
-      return Exec_PolicyPhysicalPresence(
-          tag, &request_parameter_buffer, request_parameter_buffer_size,
-          request_handles, response_handle_buffer_size,
-          response_parameter_buffer_size);
+    [TPM_CC_PolicyPhysicalPresence - TPM_CC_FIRST] = Exec_PolicyPhysicalPresence,
 #endif
 #ifdef TPM_CC_PolicyRestart
-    case TPM_CC_PolicyRestart:
-      return Exec_PolicyRestart(tag, &request_parameter_buffer,
-                                request_parameter_buffer_size, request_handles,
-                                response_handle_buffer_size,
-                                response_parameter_buffer_size);
+    [TPM_CC_PolicyRestart - TPM_CC_FIRST] = Exec_PolicyRestart,
 #endif
 #ifdef TPM_CC_PolicySecret
-    case TPM_CC_PolicySecret:
-      return Exec_PolicySecret(tag, &request_parameter_buffer,
-                               request_parameter_buffer_size, request_handles,
-                               response_handle_buffer_size,
-                               response_parameter_buffer_size);
+    [TPM_CC_PolicySecret - TPM_CC_FIRST] = Exec_PolicySecret,
 #endif
 #ifdef TPM_CC_PolicySigned
-    case TPM_CC_PolicySigned:
-      return Exec_PolicySigned(tag, &request_parameter_buffer,
-                               request_parameter_buffer_size, request_handles,
-                               response_handle_buffer_size,
-                               response_parameter_buffer_size);
+    [TPM_CC_PolicySigned - TPM_CC_FIRST] = Exec_PolicySigned,
 #endif
 #ifdef TPM_CC_PolicyTicket
-    case TPM_CC_PolicyTicket:
-      return Exec_PolicyTicket(tag, &request_parameter_buffer,
-                               request_parameter_buffer_size, request_handles,
-                               response_handle_buffer_size,
-                               response_parameter_buffer_size);
+    [TPM_CC_PolicyTicket - TPM_CC_FIRST] = Exec_PolicyTicket,
 #endif
 #ifdef TPM_CC_Quote
-    case TPM_CC_Quote:
-      return Exec_Quote(tag, &request_parameter_buffer,
-                        request_parameter_buffer_size, request_handles,
-                        response_handle_buffer_size,
-                        response_parameter_buffer_size);
+    [TPM_CC_Quote - TPM_CC_FIRST] = Exec_Quote,
 #endif
 #ifdef TPM_CC_RSA_Decrypt
-    case TPM_CC_RSA_Decrypt:
-      return Exec_RSA_Decrypt(tag, &request_parameter_buffer,
-                              request_parameter_buffer_size, request_handles,
-                              response_handle_buffer_size,
-                              response_parameter_buffer_size);
+    [TPM_CC_RSA_Decrypt - TPM_CC_FIRST] = Exec_RSA_Decrypt,
 #endif
 #ifdef TPM_CC_RSA_Encrypt
-    case TPM_CC_RSA_Encrypt:
-      return Exec_RSA_Encrypt(tag, &request_parameter_buffer,
-                              request_parameter_buffer_size, request_handles,
-                              response_handle_buffer_size,
-                              response_parameter_buffer_size);
+    [TPM_CC_RSA_Encrypt - TPM_CC_FIRST] = Exec_RSA_Encrypt,
 #endif
 #ifdef TPM_CC_ReadClock
-    case TPM_CC_ReadClock:
-      return Exec_ReadClock(tag, &request_parameter_buffer,
-                            request_parameter_buffer_size, request_handles,
-                            response_handle_buffer_size,
-                            response_parameter_buffer_size);
+    [TPM_CC_ReadClock - TPM_CC_FIRST] = Exec_ReadClock,
 #endif
 #ifdef TPM_CC_ReadPublic
-    case TPM_CC_ReadPublic:
-      return Exec_ReadPublic(tag, &request_parameter_buffer,
-                             request_parameter_buffer_size, request_handles,
-                             response_handle_buffer_size,
-                             response_parameter_buffer_size);
+    [TPM_CC_ReadPublic - TPM_CC_FIRST] = Exec_ReadPublic,
 #endif
 #ifdef TPM_CC_Rewrap
-    case TPM_CC_Rewrap:
-      return Exec_Rewrap(tag, &request_parameter_buffer,
-                         request_parameter_buffer_size, request_handles,
-                         response_handle_buffer_size,
-                         response_parameter_buffer_size);
+    [TPM_CC_Rewrap - TPM_CC_FIRST] = Exec_Rewrap,
 #endif
 #ifdef TPM_CC_SelfTest
-    case TPM_CC_SelfTest:
-      return Exec_SelfTest(tag, &request_parameter_buffer,
-                           request_parameter_buffer_size, request_handles,
-                           response_handle_buffer_size,
-                           response_parameter_buffer_size);
+    [TPM_CC_SelfTest - TPM_CC_FIRST] = Exec_SelfTest,
 #endif
 #ifdef TPM_CC_SequenceComplete
-    case TPM_CC_SequenceComplete:
-      return Exec_SequenceComplete(tag, &request_parameter_buffer,
-                                   request_parameter_buffer_size,
-                                   request_handles, response_handle_buffer_size,
-                                   response_parameter_buffer_size);
+    [TPM_CC_SequenceComplete - TPM_CC_FIRST] = Exec_SequenceComplete,
 #endif
 #ifdef TPM_CC_SequenceUpdate
-    case TPM_CC_SequenceUpdate:
-      return Exec_SequenceUpdate(tag, &request_parameter_buffer,
-                                 request_parameter_buffer_size, request_handles,
-                                 response_handle_buffer_size,
-                                 response_parameter_buffer_size);
+    [TPM_CC_SequenceUpdate - TPM_CC_FIRST] = Exec_SequenceUpdate,
 #endif
 #ifdef TPM_CC_SetAlgorithmSet
-    case TPM_CC_SetAlgorithmSet:
-      return Exec_SetAlgorithmSet(tag, &request_parameter_buffer,
-                                  request_parameter_buffer_size,
-                                  request_handles, response_handle_buffer_size,
-                                  response_parameter_buffer_size);
+    [TPM_CC_SetAlgorithmSet - TPM_CC_FIRST] = Exec_SetAlgorithmSet,
 #endif
 #ifdef TPM_CC_SetCommandCodeAuditStatus
-    case TPM_CC_SetCommandCodeAuditStatus:
-      return Exec_SetCommandCodeAuditStatus(
-          tag, &request_parameter_buffer, request_parameter_buffer_size,
-          request_handles, response_handle_buffer_size,
-          response_parameter_buffer_size);
+    [TPM_CC_SetCommandCodeAuditStatus - TPM_CC_FIRST] = Exec_SetCommandCodeAuditStatus,
 #endif
 #ifdef TPM_CC_SetPrimaryPolicy
-    case TPM_CC_SetPrimaryPolicy:
-      return Exec_SetPrimaryPolicy(tag, &request_parameter_buffer,
-                                   request_parameter_buffer_size,
-                                   request_handles, response_handle_buffer_size,
-                                   response_parameter_buffer_size);
+    [TPM_CC_SetPrimaryPolicy - TPM_CC_FIRST] = Exec_SetPrimaryPolicy,
 #endif
 #ifdef TPM_CC_Shutdown
-    case TPM_CC_Shutdown:
-      return Exec_Shutdown(tag, &request_parameter_buffer,
-                           request_parameter_buffer_size, request_handles,
-                           response_handle_buffer_size,
-                           response_parameter_buffer_size);
+    [TPM_CC_Shutdown - TPM_CC_FIRST] = Exec_Shutdown,
 #endif
 #ifdef TPM_CC_Sign
-    case TPM_CC_Sign:
-      return Exec_Sign(tag, &request_parameter_buffer,
-                       request_parameter_buffer_size, request_handles,
-                       response_handle_buffer_size,
-                       response_parameter_buffer_size);
+    [TPM_CC_Sign - TPM_CC_FIRST] = Exec_Sign,
 #endif
 #ifdef TPM_CC_StartAuthSession
-    case TPM_CC_StartAuthSession:
-      return Exec_StartAuthSession(tag, &request_parameter_buffer,
-                                   request_parameter_buffer_size,
-                                   request_handles, response_handle_buffer_size,
-                                   response_parameter_buffer_size);
+    [TPM_CC_StartAuthSession - TPM_CC_FIRST] = Exec_StartAuthSession,
 #endif
 #ifdef TPM_CC_Startup
-    case TPM_CC_Startup:
-      return Exec_Startup(tag, &request_parameter_buffer,
-                          request_parameter_buffer_size, request_handles,
-                          response_handle_buffer_size,
-                          response_parameter_buffer_size);
+    [TPM_CC_Startup - TPM_CC_FIRST] = Exec_Startup,
 #endif
 #ifdef TPM_CC_StirRandom
-    case TPM_CC_StirRandom:
-      return Exec_StirRandom(tag, &request_parameter_buffer,
-                             request_parameter_buffer_size, request_handles,
-                             response_handle_buffer_size,
-                             response_parameter_buffer_size);
+    [TPM_CC_StirRandom - TPM_CC_FIRST] = Exec_StirRandom,
 #endif
 #ifdef TPM_CC_TestParms
-    case TPM_CC_TestParms:
-      return Exec_TestParms(tag, &request_parameter_buffer,
-                            request_parameter_buffer_size, request_handles,
-                            response_handle_buffer_size,
-                            response_parameter_buffer_size);
+    [TPM_CC_TestParms - TPM_CC_FIRST] = Exec_TestParms,
 #endif
 #ifdef TPM_CC_Unseal
-    case TPM_CC_Unseal:
-      return Exec_Unseal(tag, &request_parameter_buffer,
-                         request_parameter_buffer_size, request_handles,
-                         response_handle_buffer_size,
-                         response_parameter_buffer_size);
+    [TPM_CC_Unseal - TPM_CC_FIRST] = Exec_Unseal,
 #endif
 #ifdef TPM_CC_VerifySignature
-    case TPM_CC_VerifySignature:
-      return Exec_VerifySignature(tag, &request_parameter_buffer,
-                                  request_parameter_buffer_size,
-                                  request_handles, response_handle_buffer_size,
-                                  response_parameter_buffer_size);
+    [TPM_CC_VerifySignature - TPM_CC_FIRST] = Exec_VerifySignature,
 #endif
 #ifdef TPM_CC_ZGen_2Phase
-    case TPM_CC_ZGen_2Phase:
-      return Exec_ZGen_2Phase(tag, &request_parameter_buffer,
-                              request_parameter_buffer_size, request_handles,
-                              response_handle_buffer_size,
-                              response_parameter_buffer_size);
-#endif
-    default:
-      return TPM_RC_COMMAND_CODE;
-  }
-}
\ No newline at end of file
+    [TPM_CC_ZGen_2Phase - TPM_CC_FIRST] = Exec_ZGen_2Phase,
+#endif
+};
+
+TPM_RC CommandDispatcher(TPMI_ST_COMMAND_TAG tag,
+                         TPM_CC command_code,
+                         INT32* request_parameter_buffer_size,
+                         BYTE* request_parameter_buffer_start,
+                         TPM_HANDLE request_handles[],
+                         UINT32* response_handle_buffer_size,
+                         UINT32* response_parameter_buffer_size) {
+  BYTE* request_parameter_buffer = request_parameter_buffer_start;
+  EXEC_FUNCTION exec;
+  if (command_code < TPM_CC_FIRST || command_code > TPM_CC_LAST)
+    return TPM_RC_COMMAND_CODE;
+  exec = s_execFunctions[command_code - TPM_CC_FIRST];
+  if (exec == NULL)
+    return TPM_RC_COMMAND_CODE;
+  return exec(tag, &request_parameter_buffer, request_parameter_buffer_size,
+              request_handles, response_handle_buffer_size,
+              response_parameter_buffer_size);
+}
@@ -260,6 +260,7 @@
 #else
 #define NV_MEMORY_SIZE                    16384
 #endif
+#define NV_PAGE_SIZE                      256
 #define NUM_STATIC_PCR                    16
 #define MAX_ALG_LIST_SIZE                 64
 #define TIMER_PRESCALE                    100000
@@ -15,6 +15,27 @@ typedef        UINT32              NV_ITER;              // type of a NV iterato
 #define        NV_ITER_INIT        0xFFFFFFFF            // initial value to start an
                                                         // iterator
 //
+//      Handle lookup index
+//
+//      The dynamic area is a linked list, so finding an entity by handle, or the end of the list, means walking it.
+//      The index below caches the address of every entity, sorted by handle, together with the end of the list.
+//      It is derived from NV memory only and is rebuilt on first use after anything adds, deletes or moves an
+//      entity. If there are more entities than fit in the index, lookups fall back to walking the list.
+//
+#ifndef NV_HANDLE_INDEX_SIZE
+#define        NV_HANDLE_INDEX_SIZE 64
+#endif
+typedef struct
+{
+    TPM_HANDLE          handle;
+    UINT32              addr;
+} NV_HANDLE_ENTRY;
+static NV_HANDLE_ENTRY     s_nvHandleIndex[NV_HANDLE_INDEX_SIZE];
+static UINT32              s_nvHandleCount;
+static UINT32              s_nvListEnd;
+static BOOL                s_nvHandleIndexValid;
+static BOOL                s_nvHandleIndexFull;
+//
 //
 //           NV Utility Functions
 //
@@ -152,12 +173,12 @@ NvNext(
 }
 //
 //
-//           NvGetEnd()
+//           NvWalkToEnd()
 //
-//      Function to find the end of the NV dynamic data list
+//      Function to find the end of the NV dynamic data list by walking it
 //
 static UINT32
-NvGetEnd(
+NvWalkToEnd(
    void
    )
 {
@@ -176,6 +197,57 @@ NvGetEnd(
 }
 //
 //
+//           NvBuildHandleIndex()
+//
+//      This function walks the dynamic area once to fill the handle index and find the end of the list.
+//
+static void
+NvBuildHandleIndex(
+   void
+   )
+{
+   NV_ITER             iter = NV_ITER_INIT;
+   UINT32              addr;
+   s_nvHandleCount = 0;
+   s_nvHandleIndexFull = FALSE;
+   while((addr = NvNext(&iter)) != 0)
+   {
+       TPM_HANDLE          handle;
+       UINT32              i;
+       if(s_nvHandleCount == NV_HANDLE_INDEX_SIZE)
+       {
+           s_nvHandleIndexFull = TRUE;
+           continue;
+       }
+       _plat__NvMemoryRead(addr, sizeof(TPM_HANDLE), &handle);
+       // Insert in handle order
+       for(i = s_nvHandleCount; i > 0 && s_nvHandleIndex[i - 1].handle > handle; i--)
+           s_nvHandleIndex[i] = s_nvHandleIndex[i - 1];
+       s_nvHandleIndex[i].handle = handle;
+       s_nvHandleIndex[i].addr = addr;
+       s_nvHandleCount++;
+   }
+   s_nvListEnd = NvWalkToEnd();
+   s_nvHandleIndexValid = TRUE;
+   return;
+}
+//
+//
+//           NvGetEnd()
+//
+//      Function to find the end of the NV dynamic data list
+//
+static UINT32
+NvGetEnd(
+   void
+   )
+{
+   if(!s_nvHandleIndexValid)
+       NvBuildHandleIndex();
+   return s_nvListEnd;
+}
+//
+//
 //           NvGetFreeByte
 //
 //      This function returns the number of free octets in NV space.
@@ -294,6 +366,7 @@ NvAdd(
    // Write the end of list if it is not going to exceed the NV space
    if(nextAddr + sizeof(UINT32) <= s_evictNvEnd)
        _plat__NvMemoryWrite(nextAddr, sizeof(UINT32), &listEnd);
+   s_nvHandleIndexValid = FALSE;
    // Set the flag so that NV changes are committed before the command completes.
    g_updateNV = TRUE;
 }
@@ -340,6 +413,7 @@ NvDelete(
    }
    // Mark the end of list
    _plat__NvMemoryWrite(next - entrySize, sizeof(UINT32), &listEnd);
+   s_nvHandleIndexValid = FALSE;
    // Set the flag so that NV changes are committed before the command completes.
    g_updateNV = TRUE;
 }
@@ -538,6 +612,8 @@ NvInitStatic(
     s_evictNvStart = s_maxCountAddr + sizeof(UINT64);
     // dynamic memory ends at the end of NV memory
     s_evictNvEnd = NV_MEMORY_SIZE;
+    // NV memory may have been reloaded; rebuild the handle index on first use
+    s_nvHandleIndexValid = FALSE;
     return;
 }
 //
@@ -563,6 +639,7 @@ NvInit(
     _plat__NvMemoryWrite(s_maxCountAddr, sizeof(UINT64), &zeroCounter);
     // Initialize the next offset of the first entry in evict/index list to 0
     _plat__NvMemoryWrite(s_evictNvStart, sizeof(TPM_HANDLE), &nullPointer);
+    s_nvHandleIndexValid = FALSE;
     return;
 }
 //
@@ -760,6 +837,25 @@ NvFindHandle(
 {
    UINT32              addr;
    NV_ITER             iter = NV_ITER_INIT;
+   if(!s_nvHandleIndexValid)
+       NvBuildHandleIndex();
+   if(!s_nvHandleIndexFull)
+   {
+       // Binary search of the handle index
+       UINT32          low = 0;
+       UINT32          high = s_nvHandleCount;
+       while(low < high)
+       {
+           UINT32      mid = low + (high - low) / 2;
+           if(s_nvHandleIndex[mid].handle < handle)
+               low = mid + 1;
+           else
+               high = mid;
+       }
+       if(low < s_nvHandleCount && s_nvHandleIndex[low].handle == handle)
+           return s_nvHandleIndex[low].addr;
+       return 0;
+   }
    while((addr = NvNext(&iter)) != 0)
    {
        TPM_HANDLE          entityHandle;
@@ -10,13 +10,17 @@
 #include     <string.h>
 
 #include     "PlatformData.h"
+#include     "Platform.h"
 #include     "TpmError.h"
 #include     "assert.h"
 
 #ifndef EMBEDDED_MODE
 #define FILE_BACKED_NV
+#include     <sys/time.h>
 #endif
 
+#define NV_PAGES         ((NV_MEMORY_SIZE + NV_PAGE_SIZE - 1) / NV_PAGE_SIZE)
+
 #if defined FILE_BACKED_NV
 static   FILE*                  s_NVFile;
 #endif
@@ -25,9 +29,47 @@ static   BOOL                   s_NvIsAvailable;
 static   BOOL                   s_NV_unrecoverable;
 static   BOOL                   s_NV_recoverable;
 //
+//     Pages of s_NV changed since the last commit, and how often each page has been written to the
+//     backing store.
+//
+static   unsigned char          s_NvDirty[(NV_PAGES + 7) / 8];
+static   uint32_t               s_NvPageWrites[NV_PAGES];
+static   NV_STATISTICS          s_NvStats;
+//
 //
 //          Functions
 //
+//          NvMarkDirty()
+//
+//     Record that size bytes starting at startOffset must be written on the next commit.
+//
+static void
+NvMarkDirty(
+     unsigned int         startOffset,
+     unsigned int         size
+     )
+{
+     unsigned int         page;
+     if(size == 0)
+         return;
+     for(page = startOffset / NV_PAGE_SIZE;
+         page <= (startOffset + size - 1) / NV_PAGE_SIZE;
+         page++)
+         s_NvDirty[page / 8] |= 1 << (page % 8);
+}
+//
+//
+//          NvIsDirty()
+//
+static BOOL
+NvIsDirty(
+     unsigned int         page
+     )
+{
+     return (s_NvDirty[page / 8] & (1 << (page % 8))) != 0;
+}
+//
+//
 //          _plat__NvErrors()
 //
 //     This function is used by the simulator to set the error flags in the NV subsystem to simulate an error in the
@@ -100,6 +142,10 @@ _plat__NVEnable(
        assert(1 == fread(s_NV, NV_MEMORY_SIZE, 1, s_NVFile));
    }
 #endif
+   // The backing store and s_NV now agree.
+   memset(s_NvDirty, 0, sizeof(s_NvDirty));
+   memset(s_NvPageWrites, 0, sizeof(s_NvPageWrites));
+   memset(&s_NvStats, 0, sizeof(s_NvStats));
    // NV contents have been read and the error checks have been performed. For
    // simulation purposes, use the signaling interface to indicate if an error is
    // to be simulated and the type of the error.
@@ -210,9 +256,20 @@ _plat__NvMemoryWrite(
    void               *data               // OUT: data buffer
    )
 {
+   unsigned char      *src = data;
    assert(startOffset + size <= NV_MEMORY_SIZE);
+   // Only the bytes that actually change need to reach the backing store
+   while(size > 0 && s_NV[startOffset] == src[0])
+   {
+       startOffset++;
+       src++;
+       size--;
+   }
+   while(size > 0 && s_NV[startOffset + size - 1] == src[size - 1])
+       size--;
    // Copy the data to the NV image
-   memcpy(&s_NV[startOffset], data, size);
+   memcpy(&s_NV[startOffset], src, size);
+   NvMarkDirty(startOffset, size);
 }
 //
 //
@@ -232,6 +289,7 @@ _plat__NvMemoryMove(
    assert(destOffset + size <= NV_MEMORY_SIZE);
    // Move data in RAM
    memmove(&s_NV[destOffset], &s_NV[sourceOffset], size);
+   NvMarkDirty(destOffset, size);
    return;
 }
 //
@@ -252,17 +310,71 @@ _plat__NvCommit(
    void
    )
 {
+   unsigned int        page, first;
+   unsigned int        pages = 0;
 #ifdef FILE_BACKED_NV
+   struct timeval      start, end;
+   uint32_t            elapsed;
    // If NV file is not available, return failure
    if(s_NVFile == NULL)
        return 1;
-   // Write RAM data to NV
-   fseek(s_NVFile, 0, SEEK_SET);
-   fwrite(s_NV, 1, NV_MEMORY_SIZE, s_NVFile);
-   return 0;
-#else
-   return 0;
+   gettimeofday(&start, NULL);
 #endif
+   s_NvStats.commits++;
+   // Write each run of dirty pages with one write
+   for(page = 0; page < NV_PAGES; page++)
+   {
+       unsigned int    offset, size;
+       if(!NvIsDirty(page))
+           continue;
+       for(first = page; page < NV_PAGES && NvIsDirty(page); page++)
+       {
+           if(++s_NvPageWrites[page] > s_NvStats.maxPageWrites)
+               s_NvStats.maxPageWrites = s_NvPageWrites[page];
+       }
+       offset = first * NV_PAGE_SIZE;
+       size = page * NV_PAGE_SIZE;
+       if(size > NV_MEMORY_SIZE)
+           size = NV_MEMORY_SIZE;
+       size -= offset;
+#ifdef FILE_BACKED_NV
+       // Write RAM data to NV
+       if(fseek(s_NVFile, offset, SEEK_SET) != 0
+          || fwrite(&s_NV[offset], 1, size, s_NVFile) != size)
+           return 1;
+#endif
+       pages += page - first;
+       s_NvStats.bytesWritten += size;
+   }
+   if(pages == 0)
+       s_NvStats.emptyCommits++;
+   s_NvStats.pagesWritten += pages;
+   memset(s_NvDirty, 0, sizeof(s_NvDirty));
+#ifdef FILE_BACKED_NV
+   if(pages != 0 && fflush(s_NVFile) != 0)
+       return 1;
+   gettimeofday(&end, NULL);
+   elapsed = (end.tv_sec - start.tv_sec) * 1000000
+             + end.tv_usec - start.tv_usec;
+   s_NvStats.commitMicroseconds += elapsed;
+   if(elapsed > s_NvStats.maxCommitMicroseconds)
+       s_NvStats.maxCommitMicroseconds = elapsed;
+#endif
+   return 0;
+}
+//
+//
+//       _plat__NvGetStatistics()
+//
+//      Report the write statistics of the NV backing store since it was enabled
+//
+LIB_EXPORT void
+_plat__NvGetStatistics(
+   NV_STATISTICS       *stats             // OUT: statistics
+   )
+{
+   *stats = s_NvStats;
+   return;
 }
 //
 //
@@ -242,6 +242,28 @@ _plat__NvMemoryMove(
 );
 //
 //
+//         _plat__NvGetStatistics()
+//
+//     Report how often and how much NV memory has been written to the backing store since it was enabled.
+//     Writes are made in pages of NV_PAGE_SIZE bytes and only pages changed since the previous commit
+//     are written.
+//
+typedef struct
+{
+    uint32_t    commits;             // calls to _plat__NvCommit()
+    uint32_t    emptyCommits;        // commits that found nothing to write
+    uint32_t    pagesWritten;        // pages written to the backing store
+    uint32_t    maxPageWrites;       // writes of the most written page
+    uint64_t    bytesWritten;        // bytes written to the backing store
+    uint64_t    commitMicroseconds;  // time spent writing, if it can be measured
+    uint32_t    maxCommitMicroseconds;
+} NV_STATISTICS;
+LIB_EXPORT void
+_plat__NvGetStatistics(
+    NV_STATISTICS            *stats                        // OUT: statistics
+);
+//
+//
 //      _plat__SetNvAvail()
 //
 //     Set the current NV state to available. This function is for testing purposes only. It is not part of the
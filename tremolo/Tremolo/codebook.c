@@ -818,7 +818,17 @@ static int decode_map(codebook *s, oggpack_buffer *b, ogg_int32_t *v, int point)
     }
     add <<= shiftM;
 
-    for(i=0;i<s->dim;i++)
+    i=0;
+#ifdef _ARM64_NEON_
+    {
+      int32x4_t vadd   = vdupq_n_s32(add);
+      int32x4_t vmul   = vdupq_n_s32(mul);
+      int32x4_t vshift = vdupq_n_s32(-shiftM);
+      for(;i+4<=s->dim;i+=4)
+        vst1q_s32(v+i, vshlq_s32(vmlaq_s32(vadd, vld1q_s32(v+i), vmul), vshift));
+    }
+#endif
+    for(;i<s->dim;i++)
       v[i]= ((add + v[i] * mul) >> shiftM);
 
     if(s->q_seq)
@@ -857,7 +867,12 @@ long vorbis_book_decodev_add(codebook *book,ogg_int32_t *a,
     if (!v) return -1;
     for(i=0;i<n;){
       if(decode_map(book,b,v,point))return -1;
-      for (j=0;j<book->dim;j++)
+      j=0;
+#ifdef _ARM64_NEON_
+      for (;j+4<=book->dim;j+=4,i+=4)
+        vst1q_s32(a+i, vaddq_s32(vld1q_s32(a+i), vld1q_s32(v+j)));
+#endif
+      for (;j<book->dim;j++)
 	a[i++]+=v[j];
     }
   }
@@ -903,6 +918,22 @@ long vorbis_book_decodevv_add(codebook *book,ogg_int32_t **a,
     int chptr=0;
 
     if (!v) return -1;
+#ifdef _ARM64_NEON_
+    /* stereo, dim a multiple of four: every vector holds whole L/R pairs */
+    if(ch==2 && !(book->dim&3)){
+      ogg_int32_t *l=a[0];
+      ogg_int32_t *r=a[1];
+      for(i=offset;i<offset+n;){
+        if(decode_map(book,b,v,point))return -1;
+        for (j=0;j<book->dim;j+=4,i+=2){
+          int32x2x2_t lr = vld2_s32(v+j);
+          vst1_s32(l+i, vadd_s32(vld1_s32(l+i), lr.val[0]));
+          vst1_s32(r+i, vadd_s32(vld1_s32(r+i), lr.val[1]));
+        }
+      }
+      return 0;
+    }
+#endif
     for(i=offset;i<offset+n;){
       if(decode_map(book,b,v,point))return -1;
       for (j=0;j<book->dim;j++){
@@ -227,6 +227,8 @@ extern int      vorbis_dsp_synthesis(vorbis_dsp_state *vd,
 				     ogg_packet *op,int decodep);
 extern int      vorbis_dsp_pcmout(vorbis_dsp_state *v,
 				  ogg_int16_t *pcm,int samples);
+extern int      vorbis_dsp_pcmout_float(vorbis_dsp_state *v,
+					float *pcm,int samples);
 extern int      vorbis_dsp_read(vorbis_dsp_state *v,int samples);
 extern long     vorbis_packet_blocksize(vorbis_info *vi,ogg_packet *op);
 
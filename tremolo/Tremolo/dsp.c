@@ -162,6 +162,28 @@ int vorbis_dsp_pcmout(vorbis_dsp_state *v,ogg_int16_t *pcm,int samples){
   return(0);
 }
 
+/* as vorbis_dsp_pcmout, interleaved float scaled to +-1.0 */
+int vorbis_dsp_pcmout_float(vorbis_dsp_state *v,float *pcm,int samples){
+  vorbis_info *vi=v->vi;
+  codec_setup_info *ci=(codec_setup_info *)vi->codec_setup;
+  if(v->out_begin>-1 && v->out_begin<v->out_end){
+    int n=v->out_end-v->out_begin;
+    if(pcm){
+      int i;
+      if(n>samples)n=samples;
+      for(i=0;i<vi->channels;i++)
+	mdct_unroll_lap_float(ci->blocksizes[0],ci->blocksizes[1],
+			      v->lW,v->W,v->work[i],v->mdctright[i],
+			      _vorbis_window(ci->blocksizes[0]>>1),
+			      _vorbis_window(ci->blocksizes[1]>>1),
+			      pcm+i,vi->channels,
+			      v->out_begin,v->out_begin+n);
+    }
+    return(n);
+  }
+  return(0);
+}
+
 int vorbis_dsp_read(vorbis_dsp_state *v,int s){
   if(s && v->out_begin+s>v->out_end)return(OV_EINVAL);
   v->out_begin+=s;
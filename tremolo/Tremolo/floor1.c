@@ -262,7 +262,40 @@ static void render_line(int n,int x0,int x1,int y0,int y1,ogg_int32_t *d){
   //if(x<n)
   //  d[x]= MULT31_SHIFT15(d[x],FLOOR_fromdB_LOOKUP[y]);
 
-#if defined(ONLY_C)
+#if defined(_ARM64_NEON_)
+  /* the line walk stays scalar, the products are done four at a time */
+  while(n>=4){
+    ogg_int32_t f[4];
+    int32x4_t   dv;
+    int         k;
+    for(k=0;k<4;k++){
+      f[k] = *floor;
+      floor+=base;
+      err-=ady;
+      if(err<0){
+        err+=adx;
+        floor+=1;
+      }
+    }
+    dv = vld1q_s32(d);
+    vst1q_s32(d, vcombine_s32(
+      vshrn_n_s64(vmull_s32(vget_low_s32(dv), vld1_s32(f)), 15),
+      vshrn_n_s64(vmull_high_s32(dv, vld1q_s32(f)), 15)));
+    d+=4;
+    n-=4;
+  }
+  while(n>0){
+    *d = MULT31_SHIFT15(*d,*floor);
+    d++;
+    floor+=base;
+    err-=ady;
+    if(err<0){
+      err+=adx;
+      floor+=1;
+    }
+    n--;
+  }
+#elif defined(ONLY_C)
   do{
     *d = MULT31_SHIFT15(*d,*floor);
     d++;
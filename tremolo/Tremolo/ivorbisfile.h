@@ -95,6 +95,13 @@ typedef struct OggVorbis_File {
 
   ov_callbacks callbacks;
 
+  /* Optional page index; see ov_index_enable().  One entry per page
+     carrying a granulepos, sorted by raw offset */
+  struct ov_index_entry *index;
+  long             index_count;
+  long             index_storage;
+  long             index_prev; /* last entry read in sequence, or -1 */
+
 } OggVorbis_File;
 
 extern int ov_clear(OggVorbis_File *vf);
@@ -123,6 +130,21 @@ extern int ov_pcm_seek_page(OggVorbis_File *vf,ogg_int64_t pos);
 extern int ov_time_seek(OggVorbis_File *vf,ogg_int64_t pos);
 extern int ov_time_seek_page(OggVorbis_File *vf,ogg_int64_t pos);
 
+/* The page index maps granule positions to raw page offsets so that
+ * ov_pcm_seek(), ov_time_seek() and friends can go straight to the right
+ * page instead of bisecting the file.  ov_index_enable() records every
+ * page the decoder happens to read (playback, seeks); ov_index_build()
+ * reads the whole file once and leaves the decode position alone.
+ * ov_index_export() returns the size of the serialized index and copies
+ * it out if the buffer is big enough; ov_index_import() loads one back
+ * and fails with OV_EINVAL if it does not describe this file.  All four
+ * require a seekable, fully opened file.
+ */
+extern int ov_index_enable(OggVorbis_File *vf);
+extern int ov_index_build(OggVorbis_File *vf);
+extern long ov_index_export(OggVorbis_File *vf,void *buffer,long bytes);
+extern int ov_index_import(OggVorbis_File *vf,const void *buffer,long bytes);
+
 extern ogg_int64_t ov_raw_tell(OggVorbis_File *vf);
 extern ogg_int64_t ov_pcm_tell(OggVorbis_File *vf);
 extern ogg_int64_t ov_time_tell(OggVorbis_File *vf);
@@ -132,6 +154,10 @@ extern vorbis_comment *ov_comment(OggVorbis_File *vf,int link);
 
 extern long ov_read(OggVorbis_File *vf,void *buffer,int length,
 		    int *bitstream);
+/* Interleaved like ov_read (unlike libvorbisfile's ov_read_float);
+ * length is in bytes, full scale is +-1.0 and samples are not clipped. */
+extern long ov_read_float(OggVorbis_File *vf,float *buffer,int length,
+			  int *bitstream);
 
 #ifdef __cplusplus
 }
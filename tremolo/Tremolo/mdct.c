@@ -193,6 +193,71 @@ STIN void mdct_butterfly_32(DATA_TYPE *x){
 	   mdct_butterfly_16(x+16);
 }
 
+#ifdef _ARM64_NEON_
+/* sin/cos pairs T[0..1], T[step..], T[2*step..], T[3*step..] as lanes
+   3..0, matching the lane order vld4q_s32 gives four butterflies going
+   down in memory. */
+STIN int32x4x2_t mdct_load_T4(LOOKUP_T *T,int step){
+  int32x4_t hi = vcombine_s32(vld1_s32(T+3*step), vld1_s32(T+2*step));
+  int32x4_t lo = vcombine_s32(vld1_s32(T+step),   vld1_s32(T));
+  return vuzpq_s32(hi, lo);
+}
+
+/* mdct_butterfly_generic four butterflies at a time. Each half runs
+   1024/step times and step is at most 256, so there is no remainder. */
+STIN void mdct_butterfly_generic(DATA_TYPE *x,int points,int step){
+  LOOKUP_T   *T  = sincos_lookup0;
+  DATA_TYPE *x1  = x + points - 16;
+  DATA_TYPE *x2  = x + (points>>1) - 16;
+  int32x4x4_t a, b;
+  int32x4x2_t t;
+  int32x4_t   s0, s1, s2, s3;
+
+  do{
+    a = vld4q_s32(x1);
+    b = vld4q_s32(x2);
+    t = mdct_load_T4(T, step);
+
+    s0 = vsubq_s32(a.val[0], a.val[1]); a.val[0] = vaddq_s32(a.val[0], a.val[1]);
+    s1 = vsubq_s32(a.val[3], a.val[2]); a.val[2] = vaddq_s32(a.val[2], a.val[3]);
+    s2 = vsubq_s32(b.val[1], b.val[0]); a.val[1] = vaddq_s32(b.val[1], b.val[0]);
+    s3 = vsubq_s32(b.val[3], b.val[2]); a.val[3] = vaddq_s32(b.val[3], b.val[2]);
+    b.val[0] = vaddq_s32(MULT31_X4(s1, t.val[0]), MULT31_X4(s0, t.val[1]));
+    b.val[2] = vsubq_s32(MULT31_X4(s0, t.val[0]), MULT31_X4(s1, t.val[1]));
+    b.val[1] = vaddq_s32(MULT31_X4(s2, t.val[0]), MULT31_X4(s3, t.val[1]));
+    b.val[3] = vsubq_s32(MULT31_X4(s3, t.val[0]), MULT31_X4(s2, t.val[1]));
+    vst4q_s32(x1, a);
+    vst4q_s32(x2, b);
+
+    T+=4*step;
+    x1-=16;
+    x2-=16;
+  }while(T<sincos_lookup0+1024);
+  x1 = x + (points>>1) + (points>>2) - 16;
+  x2 = x +               (points>>2) - 16;
+  T = sincos_lookup0+1024;
+  do{
+    a = vld4q_s32(x1);
+    b = vld4q_s32(x2);
+    t = mdct_load_T4(T, -step);
+
+    s0 = vsubq_s32(a.val[0], a.val[1]); a.val[0] = vaddq_s32(a.val[0], a.val[1]);
+    s1 = vsubq_s32(a.val[2], a.val[3]); a.val[2] = vaddq_s32(a.val[2], a.val[3]);
+    s2 = vsubq_s32(b.val[0], b.val[1]); a.val[1] = vaddq_s32(b.val[1], b.val[0]);
+    s3 = vsubq_s32(b.val[3], b.val[2]); a.val[3] = vaddq_s32(b.val[3], b.val[2]);
+    b.val[0] = vsubq_s32(MULT31_X4(s0, t.val[0]), MULT31_X4(s1, t.val[1]));
+    b.val[2] = vaddq_s32(MULT31_X4(s1, t.val[0]), MULT31_X4(s0, t.val[1]));
+    b.val[1] = vsubq_s32(MULT31_X4(s3, t.val[0]), MULT31_X4(s2, t.val[1]));
+    b.val[3] = vaddq_s32(MULT31_X4(s2, t.val[0]), MULT31_X4(s3, t.val[1]));
+    vst4q_s32(x1, a);
+    vst4q_s32(x2, b);
+
+    T-=4*step;
+    x1-=16;
+    x2-=16;
+  }while(T>sincos_lookup0);
+}
+#else
 /* N/stage point generic N stage butterfly (in place, 2 register) */
 STIN void mdct_butterfly_generic(DATA_TYPE *x,int points,int step){
   LOOKUP_T   *T  = sincos_lookup0;
@@ -224,6 +289,7 @@ STIN void mdct_butterfly_generic(DATA_TYPE *x,int points,int step){
     x2-=4;
   }while(T>sincos_lookup0);
 }
+#endif
 
 STIN void mdct_butterflies(DATA_TYPE *x,int points,int shift){
 
@@ -465,6 +531,63 @@ extern ogg_int16_t *mdct_unroll_postlap(ogg_int16_t *out,
                                         DATA_TYPE   *l,
                                         int          step);
 
+#ifdef _ARM64_NEON_
+/* Four output samples of each lapping loop below, lanes in output
+   order. r, l, wR and wL point at the lowest address read. */
+STIN int32x4_t mdct_rev_X4(int32x4_t x){
+  x=vrev64q_s32(x);
+  return vextq_s32(x,x,2);
+}
+
+STIN int32x4_t mdct_prelap_X4(DATA_TYPE *r){
+  return mdct_rev_X4(vld1q_s32(r));
+}
+
+STIN int32x4_t mdct_part2_X4(DATA_TYPE *r,DATA_TYPE *l,
+			     LOOKUP_T *wR,LOOKUP_T *wL){
+  int32x4_t x=vaddq_s32(MULT31_X4(vld1q_s32(r),vld1q_s32(wR)),
+			MULT31_X4(vld2q_s32(l).val[0],
+				  mdct_rev_X4(vld1q_s32(wL))));
+  return mdct_rev_X4(x);
+}
+
+STIN int32x4_t mdct_part3_X4(DATA_TYPE *r,DATA_TYPE *l,
+			     LOOKUP_T *wR,LOOKUP_T *wL){
+  return vsubq_s32(MULT31_X4(vld1q_s32(r),mdct_rev_X4(vld1q_s32(wR))),
+		   MULT31_X4(vld2q_s32(l).val[0],vld1q_s32(wL)));
+}
+
+STIN int32x4_t mdct_postlap_X4(DATA_TYPE *l){
+  return vnegq_s32(vld2q_s32(l).val[0]);
+}
+
+/* CLIP_TO_15(x>>9) is a saturating narrow; mono output is contiguous,
+   anything else is written a lane at a time into its channel slot */
+STIN void mdct_store_X4(ogg_int16_t *out,int step,int32x4_t x){
+  int16x4_t s=vqmovn_s32(vshrq_n_s32(x,9));
+  if(step==1){
+    vst1_s16(out,s);
+  }else{
+    vst1_lane_s16(out,       s,0);
+    vst1_lane_s16(out+step,  s,1);
+    vst1_lane_s16(out+step*2,s,2);
+    vst1_lane_s16(out+step*3,s,3);
+  }
+}
+
+STIN void mdct_store_float_X4(float *out,int step,int32x4_t x){
+  float32x4_t f=vcvtq_n_f32_s32(x,24);
+  if(step==1){
+    vst1q_f32(out,f);
+  }else{
+    vst1q_lane_f32(out,       f,0);
+    vst1q_lane_f32(out+step,  f,1);
+    vst1q_lane_f32(out+step*2,f,2);
+    vst1q_lane_f32(out+step*3,f,3);
+  }
+}
+#endif
+
 void mdct_unroll_lap(int n0,int n1,
 		     int lW,int W,
 		     DATA_TYPE *in,
@@ -496,6 +619,13 @@ void mdct_unroll_lap(int n0,int n1,
     start -= off;
     end   -= n;
 #if defined(ONLY_C)
+#ifdef _ARM64_NEON_
+    while(r-post>=4){
+      r-=4;
+      mdct_store_X4(out,step,mdct_prelap_X4(r));
+      out+=step*4;
+    }
+#endif
     while(r>post){
       *out = CLIP_TO_15((*--r)>>9);
       out+=step;
@@ -520,6 +650,14 @@ void mdct_unroll_lap(int n0,int n1,
   wL    += off;
   end   -= n;
 #if defined(ONLY_C)
+#ifdef _ARM64_NEON_
+  while(r-post>=4){
+    r-=4; l-=8; wR-=4;
+    mdct_store_X4(out,step,mdct_part2_X4(r,l,wR,wL));
+    wL+=4;
+    out+=step*4;
+  }
+#endif
   while(r>post){
     l-=2;
     *out = CLIP_TO_15((MULT31(*--r,*--wR) + MULT31(*l,*wL++))>>9);
@@ -546,6 +684,14 @@ void mdct_unroll_lap(int n0,int n1,
   wR    -= off;
   wL    += off;
 #if defined(ONLY_C)
+#ifdef _ARM64_NEON_
+  while(post-r>=4){
+    wR-=4;
+    mdct_store_X4(out,step,mdct_part3_X4(r,l,wR,wL));
+    r+=4; l+=8; wL+=4;
+    out+=step*4;
+  }
+#endif
   while(r<post){
     *out = CLIP_TO_15((MULT31(*r++,*--wR) - MULT31(*l,*wL++))>>9);
     out+=step;
@@ -569,6 +715,13 @@ void mdct_unroll_lap(int n0,int n1,
     post   = l+n*2;
     l     += off*2;
 #if defined(ONLY_C)
+#ifdef _ARM64_NEON_
+    while(post-l>=8){
+      mdct_store_X4(out,step,mdct_postlap_X4(l));
+      l+=8;
+      out+=step*4;
+    }
+#endif
     while(l<post){
       *out = CLIP_TO_15((-*l)>>9);
       out+=step;
@@ -580,3 +733,116 @@ void mdct_unroll_lap(int n0,int n1,
   }
 }
 
+
+/* mdct_unroll_lap for float output: the same lapping with the 16 bit
+   clip left out, scaled so that full scale is +-1.0.  There is no
+   assembly version; the C loops serve every build. */
+#define PCM_FLOAT(x) ((float)(x)*(1.f/16777216.f))
+
+void mdct_unroll_lap_float(int n0,int n1,
+			   int lW,int W,
+			   DATA_TYPE *in,
+			   DATA_TYPE *right,
+			   LOOKUP_T *w0,
+			   LOOKUP_T *w1,
+			   float *out,
+			   int step,
+			   int start, /* samples, this frame */
+			   int end    /* samples, this frame */){
+
+  DATA_TYPE *l=in+(W&&lW ? n1>>1 : n0>>1);
+  DATA_TYPE *r=right+(lW ? n1>>2 : n0>>2);
+  DATA_TYPE *post;
+  LOOKUP_T *wR=(W && lW ? w1+(n1>>1) : w0+(n0>>1));
+  LOOKUP_T *wL=(W && lW ? w1         : w0        );
+
+  int preLap=(lW && !W ? (n1>>2)-(n0>>2) : 0 );
+  int halfLap=(lW && W ? (n1>>2) : (n0>>2) );
+  int postLap=(!lW && W ? (n1>>2)-(n0>>2) : 0 );
+  int n,off;
+
+  if(preLap){
+    n      = (end<preLap?end:preLap);
+    off    = (start<preLap?start:preLap);
+    post   = r-n;
+    r     -= off;
+    start -= off;
+    end   -= n;
+#ifdef _ARM64_NEON_
+    while(r-post>=4){
+      r-=4;
+      mdct_store_float_X4(out,step,mdct_prelap_X4(r));
+      out+=step*4;
+    }
+#endif
+    while(r>post){
+      *out = PCM_FLOAT(*--r);
+      out+=step;
+    }
+  }
+
+  n      = (end<halfLap?end:halfLap);
+  off    = (start<halfLap?start:halfLap);
+  post   = r-n;
+  r     -= off;
+  l     -= off*2;
+  start -= off;
+  wR    -= off;
+  wL    += off;
+  end   -= n;
+#ifdef _ARM64_NEON_
+  while(r-post>=4){
+    r-=4; l-=8; wR-=4;
+    mdct_store_float_X4(out,step,mdct_part2_X4(r,l,wR,wL));
+    wL+=4;
+    out+=step*4;
+  }
+#endif
+  while(r>post){
+    l-=2;
+    *out = PCM_FLOAT(MULT31(*--r,*--wR) + MULT31(*l,*wL++));
+    out+=step;
+  }
+
+  n      = (end<halfLap?end:halfLap);
+  off    = (start<halfLap?start:halfLap);
+  post   = r+n;
+  r     += off;
+  l     += off*2;
+  start -= off;
+  end   -= n;
+  wR    -= off;
+  wL    += off;
+#ifdef _ARM64_NEON_
+  while(post-r>=4){
+    wR-=4;
+    mdct_store_float_X4(out,step,mdct_part3_X4(r,l,wR,wL));
+    r+=4; l+=8; wL+=4;
+    out+=step*4;
+  }
+#endif
+  while(r<post){
+    *out = PCM_FLOAT(MULT31(*r++,*--wR) - MULT31(*l,*wL++));
+    out+=step;
+    l+=2;
+  }
+
+  if(postLap){
+    n      = (end<postLap?end:postLap);
+    off    = (start<postLap?start:postLap);
+    post   = l+n*2;
+    l     += off*2;
+#ifdef _ARM64_NEON_
+    while(post-l>=8){
+      mdct_store_float_X4(out,step,mdct_postlap_X4(l));
+      l+=8;
+      out+=step*4;
+    }
+#endif
+    while(l<post){
+      *out = PCM_FLOAT(-*l);
+      out+=step;
+      l+=2;
+    }
+  }
+}
@@ -63,6 +63,13 @@ extern void mdct_unroll_lap(int n0,int n1,
 			    ogg_int16_t *out,
 			    int step,
 			    int start,int end /* samples, this frame */);
+extern void mdct_unroll_lap_float(int n0,int n1,
+				  int lW,int W,
+				  DATA_TYPE *in,DATA_TYPE *right,
+				  LOOKUP_T *w0,LOOKUP_T *w1,
+				  float *out,
+				  int step,
+				  int start,int end /* samples, this frame */);
 
 #endif
 
@@ -60,6 +60,14 @@ extern void _VDBG_free(void *ptr);
 
 #include "asm_arm.h"
 
+/* The ARM assembly is 32 bit only, so AArch64 builds with ONLY_C. The
+   hottest C loops have NEON versions there instead. */
+#if defined(ONLY_C) && defined(__aarch64__) && defined(__ARM_NEON) && \
+    !defined(_LOW_ACCURACY_)
+#define _ARM64_NEON_
+#include <arm_neon.h>
+#endif
+
 #ifndef _V_WIDE_MATH
 #define _V_WIDE_MATH
 
@@ -192,6 +200,14 @@ static inline void XNPROD31(ogg_int32_t  a, ogg_int32_t  b,
 
 #endif
 
+#ifdef _ARM64_NEON_
+/* MULT31 on four lanes. vqdmulh returns the product >>31 while MULT31 is
+   the product >>32 <<1; they only differ in bit 0. */
+static inline int32x4_t MULT31_X4(int32x4_t x, int32x4_t y) {
+  return vbicq_s32(vqdmulhq_s32(x, y), vdupq_n_s32(1));
+}
+#endif
+
 #endif
 
 #ifndef _V_CLIP_MATH
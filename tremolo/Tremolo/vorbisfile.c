@@ -105,6 +105,7 @@ static void _seek_helper(OggVorbis_File *vf,ogg_int64_t offset){
   if(vf->datasource){
     (vf->callbacks.seek_func)(vf->datasource, offset, SEEK_SET);
     vf->offset=offset;
+    vf->index_prev=-1;
     ogg_sync_reset(vf->oy);
   }else{
     /* shouldn't happen unless someone writes a broken callback */
@@ -112,6 +113,100 @@ static void _seek_helper(OggVorbis_File *vf,ogg_int64_t offset){
   }
 }
 
+/* The optional page index.  Every page carrying a granulepos that
+   _get_next_page() hands out while the index is enabled is recorded by
+   raw offset.  Pages read back to back (no seek, no lost sync in
+   between) are chained with 'next', so a seek target falling between
+   two chained entries needs no search at all; anything else still
+   narrows the bisection to the gap between the nearest entries. */
+
+struct ov_index_entry{
+  ogg_int64_t offset;     /* raw offset of the page */
+  ogg_int64_t granulepos;
+  int         next;       /* the following entry is the very next page
+			     with a granulepos in the stream */
+};
+
+#define OV_INDEX_VERSION  1
+#define OV_INDEX_HEADER  24 /* magic, version, end, links, count */
+#define OV_INDEX_ENTRY   17
+
+static void _index_clear(OggVorbis_File *vf){
+  vf->index_count=0;
+  vf->index_prev=-1;
+}
+
+/* first entry at or past a raw offset */
+static long _index_search(OggVorbis_File *vf,ogg_int64_t offset){
+  long lo=0,hi=vf->index_count;
+  while(lo<hi){
+    long mid=(lo+hi)>>1;
+    if(vf->index[mid].offset<offset)
+      lo=mid+1;
+    else
+      hi=mid;
+  }
+  return lo;
+}
+
+static void _index_record(OggVorbis_File *vf,ogg_int64_t offset,
+			  ogg_int64_t granulepos){
+  long i=_index_search(vf,offset);
+
+  if(i<vf->index_count && vf->index[i].offset==offset){
+    if(vf->index[i].granulepos!=granulepos){
+      /* doesn't describe this file (stale import); start over */
+      _index_clear(vf);
+      i=0;
+    }
+  }
+
+  if(i==vf->index_count || vf->index[i].offset!=offset){
+    if(vf->index_count==vf->index_storage){
+      long storage=vf->index_storage*2;
+      struct ov_index_entry *index=
+	_ogg_realloc(vf->index,storage*sizeof(*index));
+      if(!index){
+	vf->index_prev=-1;
+	return;
+      }
+      vf->index=index;
+      vf->index_storage=storage;
+    }
+    memmove(vf->index+i+1,vf->index+i,
+	    (vf->index_count-i)*sizeof(*vf->index));
+    vf->index[i].offset=offset;
+    vf->index[i].granulepos=granulepos;
+    vf->index[i].next=0;
+    vf->index_count++;
+  }
+
+  /* reading forward, the previous page is always the entry right
+     before this one; anything else means we can't vouch for the gap */
+  if(vf->index_prev>=0 && vf->index_prev==i-1)
+    vf->index[i-1].next=1;
+  vf->index_prev=i;
+}
+
+/* the indexed pages of a link either side of a target granulepos: the
+   last one before it and the first one at or after it, -1 if none */
+static void _index_lookup(OggVorbis_File *vf,int link,ogg_int64_t target,
+			  long *before,long *after){
+  long first=_index_search(vf,vf->offsets[link]);
+  long last=_index_search(vf,vf->offsets[link+1]);
+  long lo=first,hi=last;
+
+  while(lo<hi){
+    long mid=(lo+hi)>>1;
+    if(vf->index[mid].granulepos<target)
+      lo=mid+1;
+    else
+      hi=mid;
+  }
+  *before=(lo>first?lo-1:-1);
+  *after=(lo<last?lo:-1);
+}
+
 /* The read/seek functions track absolute position within the stream */
 
 /* from the head of the stream, get the next page.  boundary specifies
@@ -139,6 +234,7 @@ static ogg_int64_t _get_next_page(OggVorbis_File *vf,ogg_page *og,
     if(more<0){
       /* skipped n bytes */
       vf->offset-=more;
+      vf->index_prev=-1;
     }else{
       if(more==0){
 	/* send more paramedics */
@@ -153,6 +249,8 @@ static ogg_int64_t _get_next_page(OggVorbis_File *vf,ogg_page *og,
            advance the internal offset past the page end */
 	ogg_int64_t ret=vf->offset;
 	vf->offset+=more;
+	if(vf->index && ogg_page_granulepos(og)!=-1)
+	  _index_record(vf,ret,ogg_page_granulepos(og));
 	return ret;
 
       }
@@ -788,6 +886,7 @@ int ov_clear(OggVorbis_File *vf){
     if(vf->pcmlengths)_ogg_free(vf->pcmlengths);
     if(vf->serialnos)_ogg_free(vf->serialnos);
     if(vf->offsets)_ogg_free(vf->offsets);
+    if(vf->index)_ogg_free(vf->index);
     ogg_sync_destroy(vf->oy);
 
     if(vf->datasource)(vf->callbacks.close_func)(vf->datasource);
@@ -1191,6 +1290,27 @@ int ov_pcm_seek_page(OggVorbis_File *vf,ogg_int64_t pos){
     ogg_int64_t endtime = vf->pcmlengths[link*2+1]+begintime;
     ogg_int64_t target=pos-total+begintime;
     ogg_int64_t best=begin;
+    ogg_int64_t indexed=-1;
+
+    /* start from whatever the page index already knows.  If the pages
+       either side of the target were read back to back, the one before
+       it is our answer and there is nothing left to search */
+    if(vf->index){
+      long before,after;
+      _index_lookup(vf,link,target,&before,&after);
+      if(before>=0){
+	best=begin=vf->index[before].offset;
+	begintime=vf->index[before].granulepos;
+	if(vf->index[before].next && after==before+1){
+	  indexed=begintime;
+	  begin=end;
+	}
+      }
+      if(after>=0 && vf->index[after].granulepos>begintime){
+	if(indexed==-1)end=vf->index[after].offset;
+	endtime=vf->index[after].granulepos;
+      }
+    }
 
     while(begin<end){
       ogg_int64_t bisect;
@@ -1257,11 +1377,20 @@ int ov_pcm_seek_page(OggVorbis_File *vf,ogg_int64_t pos){
       _seek_helper(vf,best);
       vf->pcm_offset=-1;
 
-      if(_get_next_page(vf,&og,-1)<0){
+      result=_get_next_page(vf,&og,-1);
+      if(result<0){
 	ogg_page_release(&og);
 	return OV_EOF; /* shouldn't happen */
       }
 
+      if(indexed!=-1 &&
+	 (result!=best || ogg_page_granulepos(&og)!=indexed)){
+	/* the index doesn't match the file; drop it and search */
+	ogg_page_release(&og);
+	_index_clear(vf);
+	return ov_pcm_seek_page(vf,pos);
+      }
+
       ogg_stream_pagein(vf->os,&og);
 
       /* pull out all but last packet; the one with granulepos */
@@ -1484,6 +1613,141 @@ int ov_time_seek_page(OggVorbis_File *vf,ogg_int64_t milliseconds){
   }
 }
 
+/* start recording the pages decoding and seeking read into the page
+   index; later seeks landing near them get cheaper */
+int ov_index_enable(OggVorbis_File *vf){
+  if(vf->ready_state<OPENED)return OV_EINVAL;
+  if(!vf->seekable)return OV_ENOSEEK;
+
+  if(!vf->index){
+    vf->index=_ogg_malloc(64*sizeof(*vf->index));
+    if(!vf->index)return OV_EFAULT;
+    vf->index_storage=64;
+    _index_clear(vf);
+  }
+  return 0;
+}
+
+/* read the whole file once so that every seek afterwards is a direct
+   jump.  The raw cursor is put back, so decoding carries on unaware */
+int ov_index_build(OggVorbis_File *vf){
+  ogg_page og={0,0,0,0};
+  ogg_int64_t pos=vf->offset;
+  ogg_int64_t ret;
+
+  ret=ov_index_enable(vf);
+  if(ret)return (int)ret;
+
+  _seek_helper(vf,0);
+  while((ret=_get_next_page(vf,&og,-1))>=0);
+  ogg_page_release(&og);
+
+  _seek_helper(vf,pos);
+  return (ret==OV_EREAD?OV_EREAD:0);
+}
+
+static void _index_put(unsigned char *p,ogg_int64_t v,int bytes){
+  int i;
+  for(i=0;i<bytes;i++,v>>=8)
+    p[i]=(unsigned char)v;
+}
+
+static ogg_int64_t _index_get(const unsigned char *p,int bytes){
+  ogg_int64_t v=0;
+  int i;
+  for(i=bytes-1;i>=0;i--)
+    v=v*256+p[i];
+  return v;
+}
+
+/* serialized little endian: "OVIX", version, file length, link
+   count, serial numbers, entry count, then offset, granulepos and
+   next flag per entry.  Returns the size needed; the index is only
+   copied out if bytes is at least that */
+long ov_index_export(OggVorbis_File *vf,void *buffer,long bytes){
+  unsigned char *p=buffer;
+  long size,i;
+
+  if(vf->ready_state<OPENED)return OV_EINVAL;
+  if(!vf->seekable)return OV_ENOSEEK;
+  if(!vf->index)return OV_EINVAL;
+
+  size=OV_INDEX_HEADER+vf->links*4+vf->index_count*OV_INDEX_ENTRY;
+  if(!p || bytes<size)return size;
+
+  memcpy(p,"OVIX",4);
+  _index_put(p+4,OV_INDEX_VERSION,4);
+  _index_put(p+8,vf->end,8);
+  _index_put(p+16,vf->links,4);
+  p+=20;
+  for(i=0;i<vf->links;i++,p+=4)
+    _index_put(p,vf->serialnos[i],4);
+  _index_put(p,vf->index_count,4);
+  p+=4;
+  for(i=0;i<vf->index_count;i++,p+=OV_INDEX_ENTRY){
+    _index_put(p,vf->index[i].offset,8);
+    _index_put(p+8,vf->index[i].granulepos,8);
+    p[16]=(unsigned char)vf->index[i].next;
+  }
+  return size;
+}
+
+/* load an index saved by ov_index_export.  It has to describe this
+   very file (same length and links) and be well formed, else the
+   current index is left as it was */
+int ov_index_import(OggVorbis_File *vf,const void *buffer,long bytes){
+  const unsigned char *p=buffer;
+  struct ov_index_entry *index;
+  long count,storage,i;
+  int link=0,lastlink=-1;
+
+  if(vf->ready_state<OPENED)return OV_EINVAL;
+  if(!vf->seekable)return OV_ENOSEEK;
+  if(!p || bytes<OV_INDEX_HEADER+vf->links*4)return OV_EINVAL;
+
+  if(memcmp(p,"OVIX",4))return OV_EINVAL;
+  if(_index_get(p+4,4)!=OV_INDEX_VERSION)return OV_EVERSION;
+  if(p[15]&0x80 || _index_get(p+8,8)!=vf->end)return OV_EINVAL;
+  if(_index_get(p+16,4)!=vf->links)return OV_EINVAL;
+  p+=20;
+  for(i=0;i<vf->links;i++,p+=4)
+    if(_index_get(p,4)!=vf->serialnos[i])return OV_EINVAL;
+  count=(long)_index_get(p,4);
+  p+=4;
+  if(count<0 || (bytes-OV_INDEX_HEADER-vf->links*4)/OV_INDEX_ENTRY!=count ||
+     (bytes-OV_INDEX_HEADER-vf->links*4)%OV_INDEX_ENTRY)
+    return OV_EINVAL;
+
+  storage=(count<64?64:count);
+  index=_ogg_malloc(storage*sizeof(*index));
+  if(!index)return OV_EFAULT;
+
+  for(i=0;i<count;i++,p+=OV_INDEX_ENTRY){
+    if(p[7]&0x80 || p[15]&0x80 || p[16]>1)break;
+    index[i].offset=_index_get(p,8);
+    index[i].granulepos=_index_get(p+8,8);
+    index[i].next=p[16];
+    if(index[i].offset>=vf->end)break;
+    if(i>0 && index[i].offset<=index[i-1].offset)break;
+
+    /* granulepos only has to grow within a link */
+    while(link<vf->links-1 && index[i].offset>=vf->offsets[link+1])link++;
+    if(link==lastlink && index[i].granulepos<index[i-1].granulepos)break;
+    lastlink=link;
+  }
+  if(i<count){
+    _ogg_free(index);
+    return OV_EINVAL;
+  }
+
+  if(vf->index)_ogg_free(vf->index);
+  vf->index=index;
+  vf->index_storage=storage;
+  vf->index_count=count;
+  vf->index_prev=-1;
+  return 0;
+}
+
 /* tell the current stream offset cursor.  Note that seek followed by
    tell will likely not give the set offset due to caching */
 ogg_int64_t ov_raw_tell(OggVorbis_File *vf){
@@ -1577,23 +1841,29 @@ vorbis_comment *ov_comment(OggVorbis_File *vf,int link){
 
 	    *section) set to the logical bitstream number */
 
-long ov_read(OggVorbis_File *vf,void *buffer,int bytes_req,int *bitstream){
+static long _ov_read(OggVorbis_File *vf,void *buffer,int bytes_req,
+		     int *bitstream,int floatp){
 
   long samples;
   long channels;
+  long bytes=(floatp?sizeof(float):sizeof(ogg_int16_t));
 
   if(vf->ready_state<OPENED)return OV_EINVAL;
 
   while(1){
     if(vf->ready_state==INITSET){
       channels=vf->vi.channels;
-      samples=vorbis_dsp_pcmout(vf->vd,buffer,(bytes_req>>1)/channels);
+      if(floatp)
+	samples=vorbis_dsp_pcmout_float(vf->vd,buffer,
+					(bytes_req/bytes)/channels);
+      else
+	samples=vorbis_dsp_pcmout(vf->vd,buffer,(bytes_req/bytes)/channels);
       if(samples){
 	if(samples>0){
 	  vorbis_dsp_read(vf->vd,samples);
 	  vf->pcm_offset+=samples;
 	  if(bitstream)*bitstream=vf->current_link;
-	  return samples*2*channels;
+	  return samples*bytes*channels;
 	}
 	return samples;
       }
@@ -1610,3 +1880,14 @@ long ov_read(OggVorbis_File *vf,void *buffer,int bytes_req,int *bitstream){
 
   }
 }
+
+long ov_read(OggVorbis_File *vf,void *buffer,int bytes_req,int *bitstream){
+  return _ov_read(vf,buffer,bytes_req,bitstream,0);
+}
+
+/* as ov_read, but interleaved native float.  Full scale is +-1.0 and
+   nothing is clipped, so the low bits ov_read drops are kept */
+long ov_read_float(OggVorbis_File *vf,float *buffer,int bytes_req,
+		   int *bitstream){
+  return _ov_read(vf,buffer,bytes_req,bitstream,1);
+}
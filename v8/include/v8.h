@@ -3480,6 +3480,12 @@ class V8_EXPORT ArrayBuffer : public Object {
   };
 
 
+  /**
+   * Releases a memory block that was passed to |ArrayBuffer::New| together
+   * with this callback, once the ArrayBuffer is no longer used.
+   */
+  typedef void (*FreeCallback)(void* data, size_t byte_length, void* info);
+
   /**
    * Data length in bytes.
    */
@@ -3503,6 +3509,20 @@ class V8_EXPORT ArrayBuffer : public Object {
       Isolate* isolate, void* data, size_t byte_length,
       ArrayBufferCreationMode mode = ArrayBufferCreationMode::kExternalized);
 
+  /**
+   * Create a new ArrayBuffer over an existing memory block that is owned by
+   * the embedder, e.g. a memory-mapped file, without copying it. The created
+   * array buffer is not externalized. Instead of freeing the memory block
+   * with the ArrayBuffer::Allocator, V8 calls |callback| with |data|,
+   * |byte_length| and |info| once the array buffer has been garbage-collected
+   * or when the isolate is disposed. The callback is called during garbage
+   * collection and must not call into V8. It is not called if the array
+   * buffer gets externalized.
+   */
+  static Local<ArrayBuffer> New(Isolate* isolate, void* data,
+                                size_t byte_length, FreeCallback callback,
+                                void* info);
+
   /**
    * Returns true if ArrayBuffer is externalized, that is, does not
    * own its memory block.
@@ -5150,6 +5170,42 @@ class V8_EXPORT HeapObjectStatistics {
 };
 
 
+/**
+ * Statistics about the inline caches of an isolate. The counts are totals
+ * since the isolate was created.
+ */
+class V8_EXPORT ICStatistics {
+ public:
+  ICStatistics();
+  size_t monomorphic_transitions() { return monomorphic_transitions_; }
+  size_t polymorphic_transitions() { return polymorphic_transitions_; }
+  size_t megamorphic_transitions() { return megamorphic_transitions_; }
+  /**
+   * Number of megamorphic accesses that missed the stub cache and had their
+   * handler entered into it. Hits are served by generated code and are not
+   * counted.
+   */
+  size_t stub_cache_misses() { return stub_cache_misses_; }
+  /**
+   * Number of stub cache entries that were overwritten while still in use.
+   */
+  size_t stub_cache_evictions() { return stub_cache_evictions_; }
+  size_t stub_cache_primary_size() { return stub_cache_primary_size_; }
+  size_t stub_cache_secondary_size() { return stub_cache_secondary_size_; }
+
+ private:
+  size_t monomorphic_transitions_;
+  size_t polymorphic_transitions_;
+  size_t megamorphic_transitions_;
+  size_t stub_cache_misses_;
+  size_t stub_cache_evictions_;
+  size_t stub_cache_primary_size_;
+  size_t stub_cache_secondary_size_;
+
+  friend class Isolate;
+};
+
+
 class RetainedObjectInfo;
 
 
@@ -5587,6 +5643,11 @@ class V8_EXPORT Isolate {
   bool GetHeapObjectStatisticsAtLastGC(HeapObjectStatistics* object_statistics,
                                        size_t type_index);
 
+  /**
+   * Get statistics about the inline caches and the megamorphic stub cache.
+   */
+  void GetICStatistics(ICStatistics* ic_statistics);
+
   /**
    * Get a call stack sample from the isolate.
    * \param state Execution state.
@@ -6145,6 +6206,18 @@ class V8_EXPORT V8 {
    */
   static StartupData CreateSnapshotDataBlob(const char* custom_source = NULL);
 
+  /**
+   * Create a new isolate from the given snapshot blob, run the warm-up script
+   * in a throw-away context, and capture a fresh context in a new snapshot
+   * blob. The functions compiled by the warm-up script are kept in the new
+   * blob, so that isolates and contexts created from it do not need to
+   * compile them again.
+   * Returns { NULL, 0 } on failure.
+   * The caller owns the data array in the return value.
+   */
+  static StartupData WarmUpSnapshotDataBlob(StartupData cold_startup_blob,
+                                            const char* warmup_source);
+
   /**
    * Adds a message listener.
    *
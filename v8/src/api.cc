@@ -35,6 +35,8 @@
 #include "src/deoptimizer.h"
 #include "src/execution.h"
 #include "src/global-handles.h"
+#include "src/heap/array-buffer-tracker.h"
+#include "src/ic/stub-cache.h"
 #include "src/icu_util.h"
 #include "src/isolate-inl.h"
 #include "src/messages.h"
@@ -324,7 +326,7 @@ void V8::SetSnapshotDataBlob(StartupData* snapshot_blob) {
 
 
 bool RunExtraCode(Isolate* isolate, Local<Context> context,
-                  const char* utf8_source) {
+                  const char* utf8_source, const char* name) {
   // Run custom script if provided.
   base::ElapsedTimer timer;
   timer.Start();
@@ -335,7 +337,7 @@ bool RunExtraCode(Isolate* isolate, Local<Context> context,
     return false;
   }
   Local<String> resource_name =
-      String::NewFromUtf8(isolate, "<embedded script>", NewStringType::kNormal)
+      String::NewFromUtf8(isolate, name, NewStringType::kNormal)
           .ToLocalChecked();
   ScriptOrigin origin(resource_name);
   ScriptCompiler::Source source(source_string, origin);
@@ -364,6 +366,67 @@ class ArrayBufferAllocator : public v8::ArrayBuffer::Allocator {
   virtual void Free(void* data, size_t) { free(data); }
 };
 
+
+// Serializes the isolate together with the given context, which is reset.
+StartupData SerializeIsolateAndContext(
+    Isolate* isolate, Persistent<Context>* context,
+    i::Snapshot::Metadata metadata,
+    i::StartupSerializer::FunctionCodeHandling function_code_handling) {
+  i::Isolate* internal_isolate = reinterpret_cast<i::Isolate*>(isolate);
+
+  // If we don't do this then we end up with a stray root pointing at the
+  // context even after we have disposed of the context.
+  internal_isolate->heap()->CollectAllAvailableGarbage("mksnapshot");
+
+  // GC may have cleared weak cells, so compact any WeakFixedArrays
+  // found on the heap.
+  i::HeapIterator iterator(internal_isolate->heap(),
+                           i::HeapIterator::kFilterUnreachable);
+  for (i::HeapObject* o = iterator.next(); o != NULL; o = iterator.next()) {
+    if (o->IsPrototypeInfo()) {
+      i::Object* prototype_users =
+          i::PrototypeInfo::cast(o)->prototype_users();
+      if (prototype_users->IsWeakFixedArray()) {
+        i::WeakFixedArray* array = i::WeakFixedArray::cast(prototype_users);
+        array->Compact<i::JSObject::PrototypeRegistryCompactionCallback>();
+      }
+    } else if (o->IsScript()) {
+      i::Object* shared_list = i::Script::cast(o)->shared_function_infos();
+      if (shared_list->IsWeakFixedArray()) {
+        i::WeakFixedArray* array = i::WeakFixedArray::cast(shared_list);
+        array->Compact<i::WeakFixedArray::NullCallback>();
+      }
+    } else if (function_code_handling ==
+                   i::StartupSerializer::KEEP_FUNCTION_CODE &&
+               o->IsSharedFunctionInfo()) {
+      // Type feedback, inline caches and profiler ticks of the kept code
+      // refer to the state of the contexts the code has run in.
+      i::SharedFunctionInfo* shared = i::SharedFunctionInfo::cast(o);
+      shared->ClearTypeFeedbackInfo();
+      shared->set_profiler_ticks(0);
+      if (shared->code()->kind() == i::Code::FUNCTION) {
+        shared->code()->ClearInlineCaches();
+        shared->code()->set_profiler_ticks(0);
+      }
+    }
+  }
+
+  i::Object* raw_context = *v8::Utils::OpenPersistent(*context);
+  context->Reset();
+
+  i::SnapshotByteSink snapshot_sink;
+  i::StartupSerializer ser(internal_isolate, &snapshot_sink,
+                           function_code_handling);
+  ser.SerializeStrongReferences();
+
+  i::SnapshotByteSink context_sink;
+  i::PartialSerializer context_ser(internal_isolate, &ser, &context_sink);
+  context_ser.Serialize(&raw_context);
+  ser.SerializeWeakReferencesAndDeferred();
+
+  return i::Snapshot::CreateSnapshotBlob(ser, context_ser, metadata);
+}
+
 }  // namespace
 
 
@@ -387,51 +450,66 @@ StartupData V8::CreateSnapshotDataBlob(const char* custom_source) {
       if (custom_source != NULL) {
         metadata.set_embeds_script(true);
         Context::Scope context_scope(new_context);
-        if (!RunExtraCode(isolate, new_context, custom_source)) context.Reset();
+        if (!RunExtraCode(isolate, new_context, custom_source,
+                          "<embedded script>")) {
+          context.Reset();
+        }
       }
     }
     if (!context.IsEmpty()) {
-      // If we don't do this then we end up with a stray root pointing at the
-      // context even after we have disposed of the context.
-      internal_isolate->heap()->CollectAllAvailableGarbage("mksnapshot");
-
-      // GC may have cleared weak cells, so compact any WeakFixedArrays
-      // found on the heap.
-      i::HeapIterator iterator(internal_isolate->heap(),
-                               i::HeapIterator::kFilterUnreachable);
-      for (i::HeapObject* o = iterator.next(); o != NULL; o = iterator.next()) {
-        if (o->IsPrototypeInfo()) {
-          i::Object* prototype_users =
-              i::PrototypeInfo::cast(o)->prototype_users();
-          if (prototype_users->IsWeakFixedArray()) {
-            i::WeakFixedArray* array = i::WeakFixedArray::cast(prototype_users);
-            array->Compact<i::JSObject::PrototypeRegistryCompactionCallback>();
-          }
-        } else if (o->IsScript()) {
-          i::Object* shared_list = i::Script::cast(o)->shared_function_infos();
-          if (shared_list->IsWeakFixedArray()) {
-            i::WeakFixedArray* array = i::WeakFixedArray::cast(shared_list);
-            array->Compact<i::WeakFixedArray::NullCallback>();
-          }
-        }
-      }
-
-      i::Object* raw_context = *v8::Utils::OpenPersistent(context);
-      context.Reset();
-
-      i::SnapshotByteSink snapshot_sink;
-      i::StartupSerializer ser(internal_isolate, &snapshot_sink);
-      ser.SerializeStrongReferences();
+      result = SerializeIsolateAndContext(
+          isolate, &context, metadata,
+          i::StartupSerializer::CLEAR_FUNCTION_CODE);
+    }
+    if (i::FLAG_profile_deserialization) {
+      i::PrintF("Creating snapshot took %0.3f ms\n",
+                timer.Elapsed().InMillisecondsF());
+    }
+    timer.Stop();
+  }
+  isolate->Dispose();
+  return result;
+}
 
-      i::SnapshotByteSink context_sink;
-      i::PartialSerializer context_ser(internal_isolate, &ser, &context_sink);
-      context_ser.Serialize(&raw_context);
-      ser.SerializeWeakReferencesAndDeferred();
 
-      result = i::Snapshot::CreateSnapshotBlob(ser, context_ser, metadata);
+StartupData V8::WarmUpSnapshotDataBlob(StartupData cold_snapshot_blob,
+                                       const char* warmup_source) {
+  CHECK(cold_snapshot_blob.raw_size > 0 && cold_snapshot_blob.data != NULL);
+  CHECK(warmup_source != NULL);
+  // The warm-up script runs in a context of its own, so that the captured
+  // context is in the same state as the one of the cold snapshot, while the
+  // code of the functions it compiled is kept in the isolate.
+  i::Isolate* internal_isolate = new i::Isolate(true);
+  ArrayBufferAllocator allocator;
+  internal_isolate->set_array_buffer_allocator(&allocator);
+  internal_isolate->set_snapshot_blob(&cold_snapshot_blob);
+  Isolate* isolate = reinterpret_cast<Isolate*>(internal_isolate);
+  StartupData result = {NULL, 0};
+  {
+    base::ElapsedTimer timer;
+    timer.Start();
+    Isolate::Scope isolate_scope(isolate);
+    if (i::Snapshot::Initialize(internal_isolate)) {
+      Persistent<Context> context;
+      i::Snapshot::Metadata metadata;
+      metadata.set_embeds_script(i::Snapshot::EmbedsScript(internal_isolate));
+      {
+        HandleScope handle_scope(isolate);
+        Local<Context> warmup_context = Context::New(isolate);
+        Context::Scope context_scope(warmup_context);
+        if (RunExtraCode(isolate, warmup_context, warmup_source,
+                         "<warm-up>")) {
+          context.Reset(isolate, Context::New(isolate));
+        }
+      }
+      if (!context.IsEmpty()) {
+        result = SerializeIsolateAndContext(
+            isolate, &context, metadata,
+            i::StartupSerializer::KEEP_FUNCTION_CODE);
+      }
     }
     if (i::FLAG_profile_deserialization) {
-      i::PrintF("Creating snapshot took %0.3f ms\n",
+      i::PrintF("Warming up snapshot took %0.3f ms\n",
                 timer.Elapsed().InMillisecondsF());
     }
     timer.Stop();
@@ -5419,6 +5497,16 @@ HeapObjectStatistics::HeapObjectStatistics()
       object_size_(0) {}
 
 
+ICStatistics::ICStatistics()
+    : monomorphic_transitions_(0),
+      polymorphic_transitions_(0),
+      megamorphic_transitions_(0),
+      stub_cache_misses_(0),
+      stub_cache_evictions_(0),
+      stub_cache_primary_size_(0),
+      stub_cache_secondary_size_(0) {}
+
+
 bool v8::V8::InitializeICU(const char* icu_data_file) {
   return i::InitializeICU(icu_data_file);
 }
@@ -6620,6 +6708,23 @@ Local<ArrayBuffer> v8::ArrayBuffer::New(Isolate* isolate, void* data,
 }
 
 
+Local<ArrayBuffer> v8::ArrayBuffer::New(Isolate* isolate, void* data,
+                                        size_t byte_length,
+                                        FreeCallback callback, void* info) {
+  CHECK(data != NULL);
+  CHECK(callback != NULL);
+  i::Isolate* i_isolate = reinterpret_cast<i::Isolate*>(isolate);
+  LOG_API(i_isolate, "v8::ArrayBuffer::New(void*, size_t, FreeCallback)");
+  ENTER_V8(i_isolate);
+  i::Handle<i::JSArrayBuffer> obj =
+      i_isolate->factory()->NewJSArrayBuffer(i::SharedFlag::kNotShared);
+  i::JSArrayBuffer::Setup(obj, i_isolate, false, data, byte_length);
+  i_isolate->heap()->array_buffer_tracker()->RegisterFreeCallback(
+      data, callback, info);
+  return Utils::ToLocal(obj);
+}
+
+
 Local<ArrayBuffer> v8::ArrayBufferView::Buffer() {
   i::Handle<i::JSArrayBufferView> obj = Utils::OpenHandle(this);
   i::Handle<i::JSArrayBuffer> buffer;
@@ -7355,6 +7460,22 @@ bool Isolate::GetHeapObjectStatisticsAtLastGC(
 }
 
 
+void Isolate::GetICStatistics(ICStatistics* ic_statistics) {
+  i::Isolate* isolate = reinterpret_cast<i::Isolate*>(this);
+  i::StubCache* stub_cache = isolate->stub_cache();
+  ic_statistics->monomorphic_transitions_ =
+      isolate->ic_monomorphic_transitions();
+  ic_statistics->polymorphic_transitions_ =
+      isolate->ic_polymorphic_transitions();
+  ic_statistics->megamorphic_transitions_ =
+      isolate->ic_megamorphic_transitions();
+  ic_statistics->stub_cache_misses_ = stub_cache->updates();
+  ic_statistics->stub_cache_evictions_ = stub_cache->evictions();
+  ic_statistics->stub_cache_primary_size_ = stub_cache->primary_size();
+  ic_statistics->stub_cache_secondary_size_ = stub_cache->secondary_size();
+}
+
+
 void Isolate::GetStackSample(const RegisterState& state, void** frames,
                              size_t frames_limit, SampleInfo* sample_info) {
   i::Isolate* isolate = reinterpret_cast<i::Isolate*>(this);
@@ -7478,6 +7599,7 @@ void Isolate::LowMemoryNotification() {
         isolate->counters()->gc_low_memory_notification());
     isolate->heap()->CollectAllAvailableGarbage("low memory notification");
   }
+  i::ZoneSegmentPool::ReleaseMemory();
 }
 
 
@@ -8278,6 +8400,23 @@ SnapshotObjectId HeapProfiler::GetHeapStats(OutputStream* stream,
 }
 
 
+bool HeapProfiler::StartSamplingHeapProfiler(uint64_t sample_interval,
+                                             int stack_depth) {
+  return reinterpret_cast<i::HeapProfiler*>(this)
+      ->StartSamplingHeapProfiler(sample_interval, stack_depth);
+}
+
+
+void HeapProfiler::StopSamplingHeapProfiler() {
+  reinterpret_cast<i::HeapProfiler*>(this)->StopSamplingHeapProfiler();
+}
+
+
+AllocationProfile* HeapProfiler::GetAllocationProfile() {
+  return reinterpret_cast<i::HeapProfiler*>(this)->GetAllocationProfile();
+}
+
+
 void HeapProfiler::DeleteAllHeapSnapshots() {
   reinterpret_cast<i::HeapProfiler*>(this)->DeleteAllSnapshots();
 }
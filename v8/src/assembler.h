@@ -986,6 +986,10 @@ class ExternalReference BASE_EMBEDDED {
 
   static ExternalReference runtime_function_table_address(Isolate* isolate);
 
+  // Table of dispatch counters for pairs of bytecodes, maintained by the
+  // interpreter handlers when --trace-bytecode-pairs is enabled.
+  static ExternalReference interpreter_dispatch_counters(Isolate* isolate);
+
   Address address() const { return reinterpret_cast<Address>(address_); }
 
   // Used to check if single stepping is enabled in generated code.
@@ -13,9 +13,6 @@ namespace v8 {
 namespace internal {
 
 
-// The number of generations for each sub cache.
-static const int kRegExpGenerations = 2;
-
 // Initial size of each compilation cache table allocated.
 static const int kInitialCacheSize = 64;
 
@@ -25,7 +22,9 @@ CompilationCache::CompilationCache(Isolate* isolate)
       script_(isolate, 1),
       eval_global_(isolate, 1),
       eval_contextual_(isolate, 1),
-      reg_exp_(isolate, kRegExpGenerations),
+      // Single-generation caches age their entries individually, which only
+      // works for entries holding shared function infos.
+      reg_exp_(isolate, Max(2, FLAG_regexp_cache_generations)),
       enabled_(true) {
   CompilationSubCache* subcaches[kSubCacheCount] =
     {&script_, &eval_global_, &eval_contextual_, &reg_exp_};
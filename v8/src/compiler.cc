@@ -24,6 +24,7 @@
 #include "src/gdb-jit.h"
 #include "src/interpreter/interpreter.h"
 #include "src/isolate-inl.h"
+#include "src/lazy-compile-dispatcher.h"
 #include "src/log-inl.h"
 #include "src/messages.h"
 #include "src/parsing/parser.h"
@@ -830,8 +831,20 @@ MUST_USE_RESULT static MaybeHandle<Code> GetUnoptimizedCodeCommon(
   VMState<COMPILER> state(info->isolate());
   PostponeInterruptsScope postpone(info->isolate());
 
-  // Parse and update CompilationInfo with the results.
-  if (!Parser::ParseStatic(info->parse_info())) return MaybeHandle<Code>();
+  // Parse and update CompilationInfo with the results. The function may
+  // already have been parsed on a background thread, in which case the job
+  // owns the AST and has to outlive the compilation.
+  base::SmartPointer<LazyParseJob> parse_job;
+  if (info->isolate()->lazy_compile_dispatcher_enabled() && !info->is_debug()) {
+    parse_job.Reset(
+        info->isolate()->lazy_compile_dispatcher()->TakeParsedJob(
+            info->shared_info()));
+  }
+  if (!parse_job.is_empty()) {
+    if (!parse_job->Finalize(info->parse_info())) return MaybeHandle<Code>();
+  } else if (!Parser::ParseStatic(info->parse_info())) {
+    return MaybeHandle<Code>();
+  }
   Handle<SharedFunctionInfo> shared = info->shared_info();
   FunctionLiteral* lit = info->literal();
   DCHECK_EQ(shared->language_mode(), lit->language_mode());
@@ -1424,6 +1437,52 @@ MaybeHandle<JSFunction> Compiler::GetFunctionFromEval(
 }
 
 
+// Produces a code cache for a script that has already been compiled and may
+// have run. The script is compiled once more, this time eagerly compiling the
+// inner functions that have been compiled since, so that they are included in
+// the cache and are not compiled lazily again after deserialization.
+static ScriptData* SerializeWithCompiledFunctions(
+    Handle<SharedFunctionInfo> cached, Handle<String> source,
+    Handle<Context> context, LanguageMode language_mode) {
+  Isolate* isolate = source->GetIsolate();
+  Handle<Script> cached_script(Script::cast(cached->script()), isolate);
+  List<int> positions;
+  {
+    WeakFixedArray::Iterator iterator(cached_script->shared_function_infos());
+    SharedFunctionInfo* shared;
+    while ((shared = iterator.Next<SharedFunctionInfo>())) {
+      if (shared->is_toplevel() || !shared->is_compiled()) continue;
+      positions.Add(shared->start_position());
+    }
+  }
+  positions.Sort();
+
+  Handle<Script> script = isolate->factory()->NewScript(source);
+  script->set_name(cached_script->name());
+  script->set_line_offset(cached_script->line_offset());
+  script->set_column_offset(cached_script->column_offset());
+  script->set_origin_options(cached_script->origin_options());
+  script->set_source_mapping_url(cached_script->source_mapping_url());
+
+  Zone zone;
+  ParseInfo parse_info(&zone, script);
+  CompilationInfo info(&parse_info);
+  parse_info.set_global();
+  parse_info.set_context(context);
+  parse_info.set_eager_compile_positions(&positions);
+  info.PrepareForSerializing();
+  parse_info.set_language_mode(
+      static_cast<LanguageMode>(info.language_mode() | language_mode));
+  Handle<SharedFunctionInfo> result = CompileToplevel(&info);
+  if (result.is_null()) {
+    // The script compiled before, so this can only fail on stack overflow.
+    isolate->clear_pending_exception();
+    return NULL;
+  }
+  return CodeSerializer::Serialize(isolate, result, source);
+}
+
+
 Handle<SharedFunctionInfo> Compiler::CompileScript(
     Handle<String> source, Handle<Object> script_name, int line_offset,
     int column_offset, ScriptOriginOptions resource_options,
@@ -1548,8 +1607,21 @@ Handle<SharedFunctionInfo> Compiler::CompileScript(
     } else {
       isolate->debug()->OnAfterCompile(script);
     }
-  } else if (result->ic_age() != isolate->heap()->global_ic_age()) {
-    result->ResetForNewContext(isolate->heap()->global_ic_age());
+  } else {
+    if (result->ic_age() != isolate->heap()->global_ic_age()) {
+      result->ResetForNewContext(isolate->heap()->global_ic_age());
+    }
+    if (FLAG_serialize_toplevel && FLAG_serialize_eager &&
+        compile_options == ScriptCompiler::kProduceCodeCache && !is_module) {
+      HistogramTimerScope histogram_timer(
+          isolate->counters()->compile_serialize());
+      *cached_data = SerializeWithCompiledFunctions(result, source, context,
+                                                    language_mode);
+      if (FLAG_profile_deserialization) {
+        PrintF("[Compiling and serializing took %0.3f ms]\n",
+               timer.Elapsed().InMillisecondsF());
+      }
+    }
   }
   return result;
 }
@@ -623,6 +623,28 @@ void BytecodeGraphBuilder::VisitStar(
 }
 
 
+void BytecodeGraphBuilder::VisitLdaSmi8Star(
+    const interpreter::BytecodeArrayIterator& iterator) {
+  Node* node = jsgraph()->Constant(iterator.GetImmediateOperand(0));
+  environment()->BindAccumulator(node);
+  environment()->BindRegister(iterator.GetRegisterOperand(1), node);
+}
+
+
+void BytecodeGraphBuilder::VisitLdarAdd(
+    const interpreter::BytecodeArrayIterator& iterator) {
+  Node* right = environment()->LookupRegister(iterator.GetRegisterOperand(0));
+  environment()->BindAccumulator(right);
+  // The frame state before the addition already has the loaded accumulator,
+  // so that a deopt can resume at this bytecode.
+  FrameStateBeforeAndAfter states(this, iterator);
+  Node* left = environment()->LookupRegister(iterator.GetRegisterOperand(1));
+  BinaryOperationHints hints = BinaryOperationHints::Any();
+  Node* node = NewNode(javascript()->Add(language_mode(), hints), left, right);
+  environment()->BindAccumulator(node, &states);
+}
+
+
 void BytecodeGraphBuilder::VisitMov(
     const interpreter::BytecodeArrayIterator& iterator) {
   Node* value = environment()->LookupRegister(iterator.GetRegisterOperand(0));
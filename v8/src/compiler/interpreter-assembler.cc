@@ -16,6 +16,7 @@
 #include "src/frames.h"
 #include "src/interface-descriptors.h"
 #include "src/interpreter/bytecodes.h"
+#include "src/interpreter/interpreter.h"
 #include "src/machine-type.h"
 #include "src/macro-assembler.h"
 #include "src/zone.h"
@@ -674,6 +675,10 @@ void InterpreterAssembler::DispatchTo(Node* new_bytecode_offset) {
   Node* target_bytecode = raw_assembler_->Load(
       MachineType::Uint8(), BytecodeArrayTaggedPointer(), new_bytecode_offset);
 
+  if (isolate()->interpreter()->bytecode_dispatch_counters_table() != NULL) {
+    TraceBytecodeDispatch(target_bytecode);
+  }
+
   // TODO(rmcilroy): Create a code target dispatch table to avoid conversion
   // from code object on every dispatch.
   Node* target_code_object = raw_assembler_->Load(
@@ -698,6 +703,24 @@ void InterpreterAssembler::DispatchTo(Node* new_bytecode_offset) {
 }
 
 
+void InterpreterAssembler::TraceBytecodeDispatch(Node* target_bytecode) {
+  Node* counters_table = raw_assembler_->ExternalConstant(
+      ExternalReference::interpreter_dispatch_counters(isolate()));
+  int source_bytecode_table_index =
+      static_cast<int>(bytecode_) *
+      (static_cast<int>(interpreter::Bytecode::kLast) + 1);
+  Node* counter_offset = raw_assembler_->Word32Shl(
+      raw_assembler_->Int32Add(target_bytecode,
+                               Int32Constant(source_bytecode_table_index)),
+      Int32Constant(kPointerSizeLog2));
+  Node* old_counter = raw_assembler_->Load(MachineType::Pointer(),
+                                           counters_table, counter_offset);
+  Node* new_counter = IntPtrAdd(old_counter, IntPtrConstant(1));
+  raw_assembler_->Store(MachineType::PointerRepresentation(), counters_table,
+                        counter_offset, new_counter, kNoWriteBarrier);
+}
+
+
 void InterpreterAssembler::Abort(BailoutReason bailout_reason) {
   Node* abort_id = SmiTag(Int32Constant(bailout_reason));
   Node* ret_value = CallRuntime(Runtime::kAbort, abort_id);
@@ -198,6 +198,10 @@ class InterpreterAssembler {
   // Starts next instruction dispatch at |new_bytecode_offset|.
   void DispatchTo(Node* new_bytecode_offset);
 
+  // Increments the dispatch counter for the pair of the current bytecode and
+  // |target_bytecode|.
+  void TraceBytecodeDispatch(Node* target_bytecode);
+
   // Abort operations for debug code.
   void AbortIfWordNotEqual(Node* lhs, Node* rhs, BailoutReason bailout_reason);
 
@@ -234,6 +234,18 @@ class PipelineData {
     return register_allocation_data_;
   }
 
+  BasicBlockProfiler::Data* profiler_data() const { return profiler_data_; }
+  void set_profiler_data(BasicBlockProfiler::Data* profiler_data) {
+    profiler_data_ = profiler_data;
+  }
+
+  std::string const& source_position_output() const {
+    return source_position_output_;
+  }
+  void set_source_position_output(std::string const& source_position_output) {
+    source_position_output_ = source_position_output;
+  }
+
   void DeleteGraphZone() {
     // Destroy objects with destructors first.
     source_positions_.Reset(nullptr);
@@ -335,6 +347,10 @@ class PipelineData {
   Zone* register_allocation_zone_;
   RegisterAllocationData* register_allocation_data_;
 
+  // Carried over from instruction selection to code generation.
+  BasicBlockProfiler::Data* profiler_data_ = nullptr;
+  std::string source_position_output_;
+
   DISALLOW_COPY_AND_ASSIGN(PipelineData);
 };
 
@@ -1278,6 +1294,37 @@ Handle<Code> Pipeline::GenerateCodeForTesting(CompilationInfo* info,
 }
 
 
+MachineGraphPipelineJob::MachineGraphPipelineJob(
+    CompilationInfo* info, CallDescriptor* call_descriptor, Graph* graph)
+    : info_(info),
+      linkage_(new (info->zone()) Linkage(call_descriptor)),
+      zone_pool_(new ZonePool()),
+      data_(new PipelineData(zone_pool_.get(), info, graph, nullptr)),
+      succeeded_(false) {}
+
+
+MachineGraphPipelineJob::~MachineGraphPipelineJob() {
+  // The pipeline data holds zones of the zone pool.
+  data_.Reset(nullptr);
+}
+
+
+void MachineGraphPipelineJob::Execute() {
+  Pipeline pipeline(info_);
+  pipeline.data_ = data_.get();
+  pipeline.RunPrintAndVerify("Machine", true);
+  succeeded_ = pipeline.ScheduleAndSelectInstructions(linkage_);
+}
+
+
+Handle<Code> MachineGraphPipelineJob::Finalize() {
+  if (!succeeded_) return Handle<Code>();
+  Pipeline pipeline(info_);
+  pipeline.data_ = data_.get();
+  return pipeline.GenerateFinalCode(linkage_);
+}
+
+
 bool Pipeline::AllocateRegistersForTesting(const RegisterConfiguration* config,
                                            InstructionSequence* sequence,
                                            bool run_verifier) {
@@ -1293,6 +1340,14 @@ bool Pipeline::AllocateRegistersForTesting(const RegisterConfiguration* config,
 
 Handle<Code> Pipeline::ScheduleAndGenerateCode(
     CallDescriptor* call_descriptor) {
+  Linkage linkage(call_descriptor);
+  if (!ScheduleAndSelectInstructions(&linkage)) return Handle<Code>();
+  return GenerateFinalCode(&linkage);
+}
+
+
+bool Pipeline::ScheduleAndSelectInstructions(Linkage* linkage) {
+  CallDescriptor* call_descriptor = linkage->GetIncomingDescriptor();
   PipelineData* data = this->data_;
 
   DCHECK_NOT_NULL(data->graph());
@@ -1300,17 +1355,15 @@ Handle<Code> Pipeline::ScheduleAndGenerateCode(
   if (data->schedule() == nullptr) Run<ComputeSchedulePhase>();
   TraceSchedule(data->info(), data->schedule());
 
-  BasicBlockProfiler::Data* profiler_data = nullptr;
   if (FLAG_turbo_profiling) {
-    profiler_data = BasicBlockInstrumentor::Instrument(info(), data->graph(),
-                                                       data->schedule());
+    data->set_profiler_data(BasicBlockInstrumentor::Instrument(
+        info(), data->graph(), data->schedule()));
   }
 
   data->InitializeInstructionSequence();
 
   // Select and schedule instructions covering the scheduled graph.
-  Linkage linkage(call_descriptor);
-  Run<InstructionSelectionPhase>(&linkage);
+  Run<InstructionSelectionPhase>(linkage);
 
   if (FLAG_trace_turbo && !data->MayHaveUnverifiableGraph()) {
     TurboCfgFile tcf(isolate());
@@ -1318,10 +1371,11 @@ Handle<Code> Pipeline::ScheduleAndGenerateCode(
                  data->sequence());
   }
 
-  std::ostringstream source_position_output;
   if (FLAG_trace_turbo) {
     // Output source position information before the graph is deleted.
+    std::ostringstream source_position_output;
     data_->source_positions()->Print(source_position_output);
+    data->set_source_position_output(source_position_output.str());
   }
 
   data->DeleteGraphZone();
@@ -1335,7 +1389,7 @@ Handle<Code> Pipeline::ScheduleAndGenerateCode(
       call_descriptor, run_verifier);
   if (data->compilation_failed()) {
     info()->AbortOptimization(kNotEnoughVirtualRegistersRegalloc);
-    return Handle<Code>();
+    return false;
   }
 
   BeginPhaseKind("code generation");
@@ -1344,16 +1398,22 @@ Handle<Code> Pipeline::ScheduleAndGenerateCode(
   if (FLAG_turbo_jt) {
     Run<JumpThreadingPhase>();
   }
+  return true;
+}
+
+
+Handle<Code> Pipeline::GenerateFinalCode(Linkage* linkage) {
+  PipelineData* data = this->data_;
 
   // Generate final machine code.
-  Run<GenerateCodePhase>(&linkage);
+  Run<GenerateCodePhase>(linkage);
 
   Handle<Code> code = data->code();
-  if (profiler_data != nullptr) {
+  if (data->profiler_data() != nullptr) {
 #if ENABLE_DISASSEMBLER
     std::ostringstream os;
     code->Disassemble(nullptr, os);
-    profiler_data->SetCode(&os);
+    data->profiler_data()->SetCode(&os);
 #endif
   }
 
@@ -1376,7 +1436,7 @@ Handle<Code> Pipeline::ScheduleAndGenerateCode(
 #endif  // ENABLE_DISASSEMBLER
       json_of << "\"}\n],\n";
       json_of << "\"nodePositions\":";
-      json_of << source_position_output.str();
+      json_of << data->source_position_output();
       json_of << "}";
       fclose(json_file);
     }
@@ -22,6 +22,7 @@ class InstructionSequence;
 class Linkage;
 class PipelineData;
 class Schedule;
+class ZonePool;
 
 class Pipeline {
  public:
@@ -72,8 +73,45 @@ class Pipeline {
   void BeginPhaseKind(const char* phase_kind);
   void RunPrintAndVerify(const char* phase, bool untyped = false);
   Handle<Code> ScheduleAndGenerateCode(CallDescriptor* call_descriptor);
+  // The two halves of ScheduleAndGenerateCode. The first one schedules the
+  // graph, selects instructions and allocates registers, and returns false if
+  // that failed. Only the second one allocates on the heap.
+  bool ScheduleAndSelectInstructions(Linkage* linkage);
+  Handle<Code> GenerateFinalCode(Linkage* linkage);
   void AllocateRegisters(const RegisterConfiguration* config,
                          CallDescriptor* descriptor, bool run_verifier);
+
+  friend class MachineGraphPipelineJob;
+};
+
+
+// Runs the pipeline on a machine graph like GenerateCodeForTesting, but in two
+// steps, so that the first one can run on a background thread. Used to
+// compile wasm functions in parallel.
+class MachineGraphPipelineJob {
+ public:
+  // The {info} and {graph} have to outlive the job.
+  MachineGraphPipelineJob(CompilationInfo* info,
+                          CallDescriptor* call_descriptor, Graph* graph);
+  ~MachineGraphPipelineJob();
+
+  // Schedules the graph, selects instructions and allocates registers. Neither
+  // allocates on the heap nor creates handles, so it can run on any thread,
+  // provided that the main thread does not allocate on the heap meanwhile.
+  void Execute();
+
+  // Generates the code object. Has to be called on the main thread after
+  // Execute(). Returns a null handle if compilation failed.
+  Handle<Code> Finalize();
+
+ private:
+  CompilationInfo* info_;
+  Linkage* linkage_;
+  base::SmartPointer<ZonePool> zone_pool_;
+  base::SmartPointer<PipelineData> data_;
+  bool succeeded_;
+
+  DISALLOW_COPY_AND_ASSIGN(MachineGraphPipelineJob);
 };
 
 }  // namespace compiler
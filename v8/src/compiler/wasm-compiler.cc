@@ -1949,43 +1949,60 @@ Handle<Code> CompileWasmToJSWrapper(Isolate* isolate, wasm::ModuleEnv* module,
 
 
 // Helper function to compile a single function.
-Handle<Code> CompileWasmFunction(wasm::ErrorThrower& thrower, Isolate* isolate,
-                                 wasm::ModuleEnv* module_env,
-                                 const wasm::WasmFunction& function,
-                                 int index) {
+WasmCompilationUnit::WasmCompilationUnit(wasm::ErrorThrower* thrower,
+                                         Isolate* isolate,
+                                         wasm::ModuleEnv* module_env,
+                                         const wasm::WasmFunction* function,
+                                         int index)
+    : thrower_(thrower),
+      isolate_(isolate),
+      module_env_(module_env),
+      function_(function),
+      index_(index) {}
+
+
+WasmCompilationUnit::~WasmCompilationUnit() {
+  // The job refers to the compilation info.
+  job_.Reset(nullptr);
+}
+
+
+bool WasmCompilationUnit::BuildGraph() {
   if (FLAG_trace_wasm_compiler || FLAG_trace_wasm_decode_time) {
     // TODO(titzer): clean me up a bit.
     OFStream os(stdout);
-    os << "Compiling WASM function #" << index << ":";
-    if (function.name_offset > 0) {
-      os << module_env->module->GetName(function.name_offset);
+    os << "Compiling WASM function #" << index_ << ":";
+    if (function_->name_offset > 0) {
+      os << module_env_->module->GetName(function_->name_offset);
     }
     os << std::endl;
   }
   // Initialize the function environment for decoding.
   wasm::FunctionEnv env;
-  env.module = module_env;
-  env.sig = function.sig;
-  env.local_int32_count = function.local_int32_count;
-  env.local_int64_count = function.local_int64_count;
-  env.local_float32_count = function.local_float32_count;
-  env.local_float64_count = function.local_float64_count;
+  env.module = module_env_;
+  env.sig = function_->sig;
+  env.local_int32_count = function_->local_int32_count;
+  env.local_int64_count = function_->local_int64_count;
+  env.local_float32_count = function_->local_float32_count;
+  env.local_float64_count = function_->local_float64_count;
   env.SumLocals();
 
-  // Create a TF graph during decoding.
-  Zone zone;
-  Graph graph(&zone);
-  CommonOperatorBuilder common(&zone);
-  MachineOperatorBuilder machine(
-      &zone, MachineType::PointerRepresentation(),
+  // Create a TF graph during decoding. The graph and its operators live in
+  // the zone of the unit until the code has been generated.
+  Graph* graph = new (&zone_) Graph(&zone_);
+  CommonOperatorBuilder* common = new (&zone_) CommonOperatorBuilder(&zone_);
+  MachineOperatorBuilder* machine = new (&zone_) MachineOperatorBuilder(
+      &zone_, MachineType::PointerRepresentation(),
       InstructionSelector::SupportedMachineOperatorFlags());
-  JSGraph jsgraph(isolate, &graph, &common, nullptr, nullptr, &machine);
-  WasmGraphBuilder builder(&zone, &jsgraph, function.sig);
+  JSGraph* jsgraph = new (&zone_)
+      JSGraph(isolate_, graph, common, nullptr, nullptr, machine);
+  WasmGraphBuilder builder(&zone_, jsgraph, function_->sig);
+  const byte* module_start = module_env_->module->module_start;
   wasm::TreeResult result = wasm::BuildTFGraph(
-      &builder, &env,                                                 // --
-      module_env->module->module_start,                               // --
-      module_env->module->module_start + function.code_start_offset,  // --
-      module_env->module->module_start + function.code_end_offset);   // --
+      &builder, &env,                               // --
+      module_start,                                 // --
+      module_start + function_->code_start_offset,  // --
+      module_start + function_->code_end_offset);   // --
 
   if (result.failed()) {
     if (FLAG_trace_wasm_compiler) {
@@ -1994,30 +2011,42 @@ Handle<Code> CompileWasmFunction(wasm::ErrorThrower& thrower, Isolate* isolate,
     }
     // Add the function as another context for the exception
     Vector<char> buffer;
-    SNPrintF(buffer, "Compiling WASM function #%d:%s failed:", index,
-             module_env->module->GetName(function.name_offset));
-    thrower.Failed(buffer.start(), result);
-    return Handle<Code>::null();
+    SNPrintF(buffer, "Compiling WASM function #%d:%s failed:", index_,
+             module_env_->module->GetName(function_->name_offset));
+    thrower_->Failed(buffer.start(), result);
+    return false;
   }
 
-  // Run the compiler pipeline to generate machine code.
   CallDescriptor* descriptor = const_cast<CallDescriptor*>(
-      module_env->GetWasmCallDescriptor(&zone, function.sig));
-  CompilationInfo info("wasm", isolate, &zone);
-  info.set_output_code_kind(Code::WASM_FUNCTION);
-  Handle<Code> code =
-      Pipeline::GenerateCodeForTesting(&info, descriptor, &graph);
+      module_env_->GetWasmCallDescriptor(&zone_, function_->sig));
+  info_.Reset(new CompilationInfo("wasm", isolate_, &zone_));
+  info_->set_output_code_kind(Code::WASM_FUNCTION);
+  job_.Reset(new MachineGraphPipelineJob(info_.get(), descriptor, graph));
+  return true;
+}
+
+
+void WasmCompilationUnit::ExecuteCompilation() {
+  DCHECK(!job_.is_empty());
+  job_->Execute();
+}
+
+
+Handle<Code> WasmCompilationUnit::FinishCompilation() {
+  DCHECK(!job_.is_empty());
+  Handle<Code> code = job_->Finalize();
 
 #ifdef ENABLE_DISASSEMBLER
   // Disassemble the code for debugging.
   if (!code.is_null() && FLAG_print_opt_code) {
     Vector<char> buffer;
     const char* name = "";
-    if (function.name_offset > 0) {
-      const byte* ptr = module_env->module->module_start + function.name_offset;
+    if (function_->name_offset > 0) {
+      const byte* ptr =
+          module_env_->module->module_start + function_->name_offset;
       name = reinterpret_cast<const char*>(ptr);
     }
-    SNPrintF(buffer, "WASM function #%d:%s", index, name);
+    SNPrintF(buffer, "WASM function #%d:%s", index_, name);
     OFStream os(stdout);
     code->Disassemble(buffer.start(), os);
   }
@@ -2026,6 +2055,17 @@ Handle<Code> CompileWasmFunction(wasm::ErrorThrower& thrower, Isolate* isolate,
 }
 
 
+Handle<Code> CompileWasmFunction(wasm::ErrorThrower& thrower, Isolate* isolate,
+                                 wasm::ModuleEnv* module_env,
+                                 const wasm::WasmFunction& function,
+                                 int index) {
+  WasmCompilationUnit unit(&thrower, isolate, module_env, &function, index);
+  if (!unit.BuildGraph()) return Handle<Code>::null();
+  unit.ExecuteCompilation();
+  return unit.FinishCompilation();
+}
+
+
 }  // namespace compiler
 }  // namespace internal
 }  // namespace v8
@@ -7,17 +7,21 @@
 
 // Clients of this interface shouldn't depend on lots of compiler internals.
 // Do not include anything from src/compiler here!
+#include "src/base/smart-pointers.h"
 #include "src/wasm/wasm-opcodes.h"
 #include "src/zone.h"
 
 namespace v8 {
 namespace internal {
 
+class CompilationInfo;
+
 namespace compiler {
 // Forward declarations for some compiler data structures.
 class Node;
 class JSGraph;
 class Graph;
+class MachineGraphPipelineJob;
 }
 
 namespace wasm {
@@ -32,6 +36,42 @@ typedef compiler::JSGraph TFGraph;
 }
 
 namespace compiler {
+// Compiles a single function in three steps, so that the one doing most of
+// the work can run on a background thread:
+// 1) BuildGraph() decodes the function and builds its TurboFan graph on the
+//    main thread, since building the graph allocates on the heap.
+// 2) ExecuteCompilation() schedules the graph, selects instructions and
+//    allocates registers on any thread, without accessing the heap.
+// 3) FinishCompilation() generates the code object on the main thread.
+class WasmCompilationUnit {
+ public:
+  WasmCompilationUnit(wasm::ErrorThrower* thrower, Isolate* isolate,
+                      wasm::ModuleEnv* module_env,
+                      const wasm::WasmFunction* function, int index);
+  ~WasmCompilationUnit();
+
+  // Returns false and reports the error to the thrower if decoding failed.
+  bool BuildGraph();
+  void ExecuteCompilation();
+  // Returns a null handle if code generation failed.
+  Handle<Code> FinishCompilation();
+
+  const wasm::WasmFunction* function() const { return function_; }
+  int index() const { return index_; }
+
+ private:
+  wasm::ErrorThrower* thrower_;
+  Isolate* isolate_;
+  wasm::ModuleEnv* module_env_;
+  const wasm::WasmFunction* function_;
+  int index_;
+  Zone zone_;
+  base::SmartPointer<CompilationInfo> info_;
+  base::SmartPointer<MachineGraphPipelineJob> job_;
+
+  DISALLOW_COPY_AND_ASSIGN(WasmCompilationUnit);
+};
+
 // Compiles a single function, producing a code object.
 Handle<Code> CompileWasmFunction(wasm::ErrorThrower& thrower, Isolate* isolate,
                                  wasm::ModuleEnv* module_env,
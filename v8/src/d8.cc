@@ -37,6 +37,7 @@
 #include "src/d8.h"
 
 #include "include/libplatform/libplatform.h"
+#include "include/v8-profiler.h"
 #ifndef V8_SHARED
 #include "src/api.h"
 #include "src/base/cpu.h"
@@ -383,13 +384,22 @@ bool Shell::ExecuteString(Isolate* isolate, Local<String> source,
         Local<Context>::New(isolate, data->realms_[data->realm_current_]);
     Context::Scope context_scope(realm);
     Local<Script> script;
-    if (!Shell::CompileString(isolate, source, name, options.compile_options,
-                              source_type).ToLocal(&script)) {
+    bool store_code_cache = false;
+    MaybeLocal<Script> maybe_script =
+        options.code_cache_dir != NULL && source_type == SCRIPT
+            ? Shell::CompileWithCodeCacheDir(isolate, source, name,
+                                             &store_code_cache)
+            : Shell::CompileString(isolate, source, name,
+                                   options.compile_options, source_type);
+    if (!maybe_script.ToLocal(&script)) {
       // Print errors that happened during compilation.
       if (report_exceptions) ReportException(isolate, &try_catch);
       return false;
     }
     maybe_result = script->Run(realm);
+    if (store_code_cache && !maybe_result.IsEmpty()) {
+      StoreCodeCache(isolate, source, name);
+    }
     EmptyMessageQueues(isolate);
     data->realm_current_ = data->realm_switch_;
   }
@@ -1463,6 +1473,89 @@ Local<String> Shell::ReadFile(Isolate* isolate, const char* name) {
 }
 
 
+// Builds the path of the file in --code-cache-dir that holds the code cache
+// for the given source. The name combines a hash of the source with the tag
+// that V8 checks cached data against, which covers the V8 version and the
+// flags, so that caches from other builds or configurations are not loaded.
+static bool CodeCachePath(Local<String> source, char* buffer, int length) {
+  int source_length = source->Length();
+  uint16_t* source_buffer = new uint16_t[source_length];
+  source->Write(source_buffer, 0, source_length);
+  // 64-bit FNV-1a.
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (int i = 0; i < source_length; i++) {
+    hash = (hash ^ source_buffer[i]) * 0x100000001b3ULL;
+  }
+  delete[] source_buffer;
+  int written = snprintf(buffer, length, "%s/%08x%08x-%08x.cache",
+                         Shell::options.code_cache_dir,
+                         static_cast<uint32_t>(hash >> 32),
+                         static_cast<uint32_t>(hash),
+                         ScriptCompiler::CachedDataVersionTag());
+  return written > 0 && written < length;
+}
+
+
+// Compiles the script, consuming the code cache stored in --code-cache-dir if
+// there is a usable one. Otherwise store_code_cache is set, and the cache is
+// to be produced with StoreCodeCache once the script has run.
+MaybeLocal<Script> Shell::CompileWithCodeCacheDir(Isolate* isolate,
+                                                  Local<String> source,
+                                                  Local<Value> name,
+                                                  bool* store_code_cache) {
+  Local<Context> context(isolate->GetCurrentContext());
+  ScriptOrigin origin(name);
+  char path[1024];
+  int size = 0;
+  char* chars = NULL;
+  if (CodeCachePath(source, path, sizeof(path))) {
+    chars = ReadChars(isolate, path, &size);
+  }
+  if (chars == NULL) {
+    *store_code_cache = true;
+    ScriptCompiler::Source script_source(source, origin);
+    return ScriptCompiler::Compile(context, &script_source);
+  }
+  uint8_t* cache = new uint8_t[size];
+  memcpy(cache, chars, size);
+  delete[] chars;
+  ScriptCompiler::Source cached_source(
+      source, origin,
+      new ScriptCompiler::CachedData(cache, size,
+                                     ScriptCompiler::CachedData::BufferOwned));
+  MaybeLocal<Script> result = ScriptCompiler::Compile(
+      context, &cached_source, ScriptCompiler::kConsumeCodeCache);
+  // A rejected cache is replaced, the script has been compiled regardless.
+  *store_code_cache = cached_source.GetCachedData()->rejected;
+  return result;
+}
+
+
+// Produces the code cache for a script that has run and writes it to
+// --code-cache-dir. The script is still in the compilation cache, so the code
+// cache includes the functions that have been compiled while it ran.
+void Shell::StoreCodeCache(Isolate* isolate, Local<String> source,
+                           Local<Value> name) {
+  char path[1024];
+  if (!CodeCachePath(source, path, sizeof(path))) return;
+  ScriptCompiler::Source script_source(source, ScriptOrigin(name));
+  if (ScriptCompiler::CompileUnboundScript(isolate, &script_source,
+                                           ScriptCompiler::kProduceCodeCache)
+          .IsEmpty()) {
+    return;
+  }
+  const ScriptCompiler::CachedData* data = script_source.GetCachedData();
+  if (data == NULL) return;
+  FILE* file = FOpen(path, "wb");
+  if (file == NULL) {
+    printf("Could not write code cache %s.\n", path);
+    return;
+  }
+  fwrite(data->data, 1, data->length, file);
+  fclose(file);
+}
+
+
 void Shell::RunShell(Isolate* isolate) {
   HandleScope outer_scope(isolate);
   v8::Local<v8::Context> context =
@@ -1955,6 +2048,16 @@ bool Shell::SetOptions(int argc, char* argv[]) {
       options.dump_heap_constants = true;
       argv[i] = NULL;
 #endif  // V8_SHARED
+    } else if (strcmp(argv[i], "--sampling-heap-profiler") == 0) {
+      options.sampling_heap_profiler_interval = 512 * 1024;
+      argv[i] = NULL;
+    } else if (strncmp(argv[i], "--sampling-heap-profiler=", 25) == 0) {
+      options.sampling_heap_profiler_interval = atoi(argv[i] + 25);
+      if (options.sampling_heap_profiler_interval <= 0) {
+        printf("Invalid sampling heap profiler interval: %s\n", argv[i] + 25);
+        return false;
+      }
+      argv[i] = NULL;
     } else if (strcmp(argv[i], "--throws") == 0) {
       options.expected_to_throw = true;
       argv[i] = NULL;
@@ -1988,11 +2091,17 @@ bool Shell::SetOptions(int argc, char* argv[]) {
         return false;
       }
       argv[i] = NULL;
+    } else if (strncmp(argv[i], "--code-cache-dir=", 17) == 0) {
+      options.code_cache_dir = argv[i] + 17;
+      argv[i] = NULL;
     }
   }
 
   v8::V8::SetFlagsFromCommandLine(&argc, argv, true);
 
+  // Code caches written to disk include the functions that ran.
+  if (options.code_cache_dir != NULL) SetFlagsFromString("--serialize-eager");
+
   bool enable_harmony_modules = false;
 
   // Set up isolated source groups.
@@ -2039,7 +2148,17 @@ int Shell::RunMain(Isolate* isolate, int argc, char* argv[], bool last_run) {
 #endif  // !V8_SHARED
   {
     HandleScope scope(isolate);
+#ifndef V8_SHARED
+    base::ElapsedTimer timer;
+    if (i::FLAG_profile_deserialization) timer.Start();
+#endif  // !V8_SHARED
     Local<Context> context = CreateEvaluationContext(isolate);
+#ifndef V8_SHARED
+    if (i::FLAG_profile_deserialization) {
+      printf("[Creating context took %0.3f ms]\n",
+             timer.Elapsed().InMillisecondsF());
+    }
+#endif  // !V8_SHARED
     if (last_run && options.use_interactive_shell()) {
       // Keep using the same context in the interactive shell.
       evaluation_context_.Reset(isolate, context);
@@ -2065,6 +2184,40 @@ int Shell::RunMain(Isolate* isolate, int argc, char* argv[], bool last_run) {
 }
 
 
+static void PrintAllocationProfileNode(AllocationProfile::Node* node,
+                                       int depth) {
+  size_t self_size = 0;
+  for (size_t i = 0; i < node->allocations.size(); i++) {
+    self_size += node->allocations[i].size * node->allocations[i].count;
+  }
+  String::Utf8Value name(node->name);
+  String::Utf8Value script_name(node->script_name);
+  printf("%*s%zu %s", depth * 2, "", self_size,
+         name.length() > 0 ? *name : "(anonymous)");
+  if (node->line_number != AllocationProfile::kNoLineNumberInfo) {
+    printf(" %s:%d:%d", *script_name, node->line_number, node->column_number);
+  }
+  printf("\n");
+  for (size_t i = 0; i < node->children.size(); i++) {
+    PrintAllocationProfileNode(node->children[i], depth + 1);
+  }
+}
+
+
+// Prints the call tree of the sampled allocations that are still alive, with
+// the estimated number of bytes allocated by each function itself.
+void Shell::PrintAllocationProfile(Isolate* isolate) {
+  HandleScope handle_scope(isolate);
+  HeapProfiler* heap_profiler = isolate->GetHeapProfiler();
+  AllocationProfile* profile = heap_profiler->GetAllocationProfile();
+  if (profile == NULL) return;
+  printf("Sampled allocations (bytes, function):\n");
+  PrintAllocationProfileNode(profile->GetRootNode(), 0);
+  delete profile;
+  heap_profiler->StopSamplingHeapProfiler();
+}
+
+
 void Shell::CollectGarbage(Isolate* isolate) {
   if (options.send_idle_notification) {
     const double kLongIdlePauseInSeconds = 1.0;
@@ -2478,8 +2631,17 @@ int Shell::Main(int argc, char* argv[]) {
     create_params.create_histogram_callback = CreateHistogram;
     create_params.add_histogram_sample_callback = AddHistogramSample;
   }
+
+  base::ElapsedTimer timer;
+  if (i::FLAG_profile_deserialization) timer.Start();
 #endif
   Isolate* isolate = Isolate::New(create_params);
+#ifndef V8_SHARED
+  if (i::FLAG_profile_deserialization) {
+    printf("[Creating isolate took %0.3f ms]\n",
+           timer.Elapsed().InMillisecondsF());
+  }
+#endif  // !V8_SHARED
   {
     Isolate::Scope scope(isolate);
     Initialize(isolate);
@@ -2492,6 +2654,11 @@ int Shell::Main(int argc, char* argv[]) {
     }
 #endif
 
+    if (options.sampling_heap_profiler_interval > 0) {
+      isolate->GetHeapProfiler()->StartSamplingHeapProfiler(
+          options.sampling_heap_profiler_interval);
+    }
+
     if (options.stress_opt || options.stress_deopt) {
       Testing::SetStressRunType(options.stress_opt
                                 ? Testing::kStressTypeOpt
@@ -2530,6 +2697,10 @@ int Shell::Main(int argc, char* argv[]) {
       RunShell(isolate);
     }
 
+    if (options.sampling_heap_profiler_interval > 0) {
+      PrintAllocationProfile(isolate);
+    }
+
     // Shut down contexts and collect garbage.
     evaluation_context_.Reset();
 #ifndef V8_SHARED
@@ -285,8 +285,10 @@ class ShellOptions {
         dump_heap_constants(false),
         expected_to_throw(false),
         mock_arraybuffer_allocator(false),
+        sampling_heap_profiler_interval(0),
         num_isolates(1),
         compile_options(v8::ScriptCompiler::kNoCompileOptions),
+        code_cache_dir(NULL),
         isolate_sources(NULL),
         icu_data_file(NULL),
         natives_blob(NULL),
@@ -312,8 +314,10 @@ class ShellOptions {
   bool dump_heap_constants;
   bool expected_to_throw;
   bool mock_arraybuffer_allocator;
+  int sampling_heap_profiler_interval;
   int num_isolates;
   v8::ScriptCompiler::CompileOptions compile_options;
+  const char* code_cache_dir;
   SourceGroup* isolate_sources;
   const char* icu_data_file;
   const char* natives_blob;
@@ -333,6 +337,12 @@ class Shell : public i::AllStatic {
       Isolate* isolate, Local<String> source, Local<Value> name,
       v8::ScriptCompiler::CompileOptions compile_options,
       SourceType source_type);
+  static MaybeLocal<Script> CompileWithCodeCacheDir(Isolate* isolate,
+                                                    Local<String> source,
+                                                    Local<Value> name,
+                                                    bool* store_code_cache);
+  static void StoreCodeCache(Isolate* isolate, Local<String> source,
+                             Local<Value> name);
   static bool ExecuteString(Isolate* isolate, Local<String> source,
                             Local<Value> name, bool print_result,
                             bool report_exceptions,
@@ -345,6 +355,7 @@ class Shell : public i::AllStatic {
   static int Main(int argc, char* argv[]);
   static void Exit(int exit_code);
   static void OnExit(Isolate* isolate);
+  static void PrintAllocationProfile(Isolate* isolate);
   static void CollectGarbage(Isolate* isolate);
   static void EmptyMessageQueues(Isolate* isolate);
 
@@ -9,7 +9,9 @@
 #include "src/bootstrapper.h"
 #include "src/conversions.h"
 #include "src/isolate-inl.h"
+#include "src/lazy-compile-dispatcher.h"
 #include "src/macro-assembler.h"
+#include "src/regexp/jsregexp.h"
 
 namespace v8 {
 namespace internal {
@@ -1385,6 +1387,10 @@ Handle<JSFunction> Factory::NewFunctionFromSharedFunctionInfo(
                                                       literals);
   }
 
+  if (isolate()->lazy_compile_dispatcher_enabled()) {
+    isolate()->lazy_compile_dispatcher()->QueueForParsing(result);
+  }
+
   return result;
 }
 
@@ -2386,6 +2392,12 @@ void Factory::SetRegExpIrregexpData(Handle<JSRegExp> regexp,
   store->set(JSRegExp::kIrregexpMaxRegisterCountIndex, Smi::FromInt(0));
   store->set(JSRegExp::kIrregexpCaptureCountIndex,
              Smi::FromInt(capture_count));
+  store->set(JSRegExp::kIrregexpLatin1BytecodeIndex, uninitialized);
+  store->set(JSRegExp::kIrregexpUC16BytecodeIndex, uninitialized);
+  int ticks = RegExpImpl::UsesNativeRegExp() && FLAG_regexp_tier_up
+                  ? FLAG_regexp_tier_up_ticks
+                  : 0;
+  store->set(JSRegExp::kIrregexpTicksUntilTierUpIndex, Smi::FromInt(ticks));
   regexp->set_data(*store);
 }
 
@@ -304,6 +304,10 @@ DEFINE_BOOL(ignition_fallback_on_eval_and_catch, false,
             "and es6 blocks")
 DEFINE_BOOL(print_bytecode, false,
             "print bytecode generated by ignition interpreter")
+DEFINE_BOOL(ignition_fuse_bytecodes, true,
+            "fuse common bytecode sequences into a single bytecode")
+DEFINE_BOOL(trace_bytecode_pairs, false,
+            "count and print the dispatches between pairs of bytecodes")
 DEFINE_BOOL(trace_ignition_codegen, false,
             "trace the codegen of ignition interpreter bytecode handlers")
 
@@ -409,6 +413,11 @@ DEFINE_BOOL(block_concurrent_recompilation, false,
             "block queued jobs until released")
 DEFINE_BOOL(concurrent_osr, false, "concurrent on-stack replacement")
 DEFINE_IMPLICATION(concurrent_osr, concurrent_recompilation)
+DEFINE_BOOL(lazy_compile_dispatcher, false,
+            "parse lazily compiled top-level functions on background threads "
+            "before they are first called")
+DEFINE_INT(lazy_compile_dispatcher_queue_length, 64,
+           "the maximum number of functions parsed ahead of their first call")
 
 DEFINE_BOOL(omit_map_checks_for_leaf_maps, true,
             "do not emit check maps for constant values that have a leaf map, "
@@ -476,11 +485,15 @@ DEFINE_BOOL(expose_wasm, false, "expose WASM interface to JavaScript")
 DEFINE_BOOL(trace_wasm_decoder, false, "trace decoding of wasm code")
 DEFINE_BOOL(trace_wasm_decode_time, false, "trace decoding time of wasm code")
 DEFINE_BOOL(trace_wasm_compiler, false, "trace compiling of wasm code")
+DEFINE_BOOL(wasm_parallel_compilation, true,
+            "compile wasm functions on background threads")
 DEFINE_BOOL(wasm_break_on_decoder_error, false,
             "debug break when wasm decoder encounters an error")
 
 DEFINE_INT(typed_array_max_size_in_heap, 64,
            "threshold for in-heap typed array")
+DEFINE_BOOL(pool_array_buffers, true,
+            "reuse the backing stores of small dead array buffers")
 
 // Profiler flags.
 DEFINE_INT(frame_count, 1, "number of stack frames inspected by the profiler")
@@ -581,6 +594,9 @@ DEFINE_BOOL(trace_stub_failures, false,
             "trace deoptimization of generated code stubs")
 
 DEFINE_BOOL(serialize_toplevel, true, "enable caching of toplevel scripts")
+DEFINE_BOOL(serialize_eager, false,
+            "include the functions compiled so far in code caches produced "
+            "for scripts that have already been compiled")
 DEFINE_BOOL(trace_serializer, false, "print code serializer trace")
 
 // compiler.cc
@@ -689,6 +705,20 @@ DEFINE_INT(max_incremental_marking_finalization_rounds, 3,
            "at most try this many times to finalize incremental marking")
 DEFINE_BOOL(concurrent_sweeping, true, "use concurrent sweeping")
 DEFINE_BOOL(parallel_compaction, true, "use parallel compaction")
+DEFINE_BOOL(idle_time_bounded_compaction, true,
+            "evacuate only as many pages as fit into the idle time of a "
+            "mark-compact finalized in an idle task")
+DEFINE_BOOL(parallel_pointer_update, true,
+            "use parallel pointer update after compaction")
+DEFINE_BOOL(parallel_scavenge, false,
+            "scavenge roots and old-to-new pointers in parallel")
+DEFINE_INT(parallel_scavenge_tasks, 0,
+           "number of parallel scavenge tasks (0 = one per core)")
+DEFINE_BOOL(concurrent_marking, false,
+            "scan large arrays on background threads during incremental "
+            "marking")
+DEFINE_INT(concurrent_marking_tasks, 0,
+           "number of concurrent marking tasks (0 = one per core)")
 DEFINE_BOOL(trace_incremental_marking, false,
             "trace progress of the incremental marking")
 DEFINE_BOOL(track_gc_object_stats, false,
@@ -721,6 +751,11 @@ DEFINE_BOOL(heap_profiler_trace_objects, false,
             "Dump heap object allocations/movements/size_updates")
 
 
+// sampling-heap-profiler.cc
+DEFINE_BOOL(sampling_heap_profiler_suppress_randomness, false,
+            "Use constant sample intervals to eliminate test flakiness")
+
+
 // v8.cc
 DEFINE_BOOL(use_idle_notification, true,
             "Use idle notification to reduce memory footprint.")
@@ -728,6 +763,15 @@ DEFINE_BOOL(use_idle_notification, true,
 DEFINE_BOOL(use_ic, true, "use inline caching")
 DEFINE_BOOL(trace_ic, false, "trace inline cache state transitions")
 
+// stub-cache.cc
+DEFINE_INT(stub_cache_primary_bits, 11,
+           "log2 of the initial number of entries of the primary stub cache")
+DEFINE_INT(stub_cache_secondary_bits, 9,
+           "log2 of the initial number of entries of the secondary stub cache")
+DEFINE_BOOL(grow_stub_cache, true,
+            "grow the stub cache when megamorphic accesses keep evicting "
+            "its entries")
+
 // macro-assembler-ia32.cc
 DEFINE_BOOL(native_code_counters, false,
             "generate extra code for manipulating stats counters")
@@ -805,6 +849,11 @@ DEFINE_INT(hash_seed, 0,
            "Fixed seed to use to hash property keys (0 means random)"
            "(with snapshots this option cannot override the baked-in seed)")
 
+// zone.cc
+DEFINE_INT(zone_segment_pool_size, 4,
+           "maximum size of the process-wide pool of free zone segments "
+           "(in Mbytes)")
+
 // snapshot-common.cc
 DEFINE_BOOL(profile_deserialization, false,
             "Print the time it takes to deserialize the snapshot.")
@@ -813,6 +862,15 @@ DEFINE_BOOL(serialization_statistics, false,
 
 // Regexp
 DEFINE_BOOL(regexp_optimization, true, "generate optimized regexp code")
+DEFINE_BOOL(regexp_tier_up, true,
+            "interpret regexps until they have been executed a couple of "
+            "times before generating native code")
+DEFINE_INT(regexp_tier_up_ticks, 10,
+           "number of regexp executions before tiering up to native code")
+DEFINE_BOOL(trace_regexp_tier_up, false, "trace regexp tiering up")
+DEFINE_INT(regexp_cache_generations, 2,
+           "number of full GCs a compiled regexp survives in the isolate-wide "
+           "regexp cache without being used (at least 2)")
 
 // Testing flags test/cctest/test-{flags,api,serialization}.cc
 DEFINE_BOOL(testing_bool_flag, true, "testing_bool_flag")
@@ -842,8 +900,12 @@ DEFINE_BOOL(profile_hydrogen_code_stub_compilation, false,
 DEFINE_BOOL(predictable, false, "enable predictable mode")
 DEFINE_NEG_IMPLICATION(predictable, concurrent_recompilation)
 DEFINE_NEG_IMPLICATION(predictable, concurrent_osr)
+DEFINE_NEG_IMPLICATION(predictable, lazy_compile_dispatcher)
 DEFINE_NEG_IMPLICATION(predictable, concurrent_sweeping)
 DEFINE_NEG_IMPLICATION(predictable, parallel_compaction)
+DEFINE_NEG_IMPLICATION(predictable, parallel_pointer_update)
+DEFINE_NEG_IMPLICATION(predictable, parallel_scavenge)
+DEFINE_NEG_IMPLICATION(predictable, concurrent_marking)
 DEFINE_NEG_IMPLICATION(predictable, memory_reducer)
 
 // mark-compact.cc
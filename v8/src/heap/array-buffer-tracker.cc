@@ -13,20 +13,21 @@ namespace v8 {
 namespace internal {
 
 ArrayBufferTracker::~ArrayBufferTracker() {
-  Isolate* isolate = heap()->isolate();
   size_t freed_memory = 0;
   for (auto& buffer : live_array_buffers_) {
-    isolate->array_buffer_allocator()->Free(buffer.first, buffer.second);
+    FreeBackingStore(buffer.first, buffer.second);
     freed_memory += buffer.second;
   }
   for (auto& buffer : live_array_buffers_for_scavenge_) {
-    isolate->array_buffer_allocator()->Free(buffer.first, buffer.second);
+    FreeBackingStore(buffer.first, buffer.second);
     freed_memory += buffer.second;
   }
   live_array_buffers_.clear();
   live_array_buffers_for_scavenge_.clear();
   not_yet_discovered_array_buffers_.clear();
   not_yet_discovered_array_buffers_for_scavenge_.clear();
+  FlushPool();
+  DCHECK(free_callbacks_.empty());
 
   if (freed_memory > 0) {
     heap()->update_amount_of_external_allocated_memory(
@@ -35,6 +36,26 @@ ArrayBufferTracker::~ArrayBufferTracker() {
 }
 
 
+void* ArrayBufferTracker::Allocate(size_t length, bool initialize) {
+  if (FLAG_pool_array_buffers && length <= kMaxPooledLength) {
+    auto it = pool_.find(length);
+    if (it != pool_.end() && !it->second.empty()) {
+      void* data = it->second.back();
+      it->second.pop_back();
+      pool_size_ -= length;
+      // Dead backing stores are not cleared when they are pooled, but only
+      // when they are reused by an allocation that needs zeroed memory.
+      if (initialize) memset(data, 0, length);
+      return data;
+    }
+  }
+  v8::ArrayBuffer::Allocator* allocator =
+      heap()->isolate()->array_buffer_allocator();
+  return initialize ? allocator->Allocate(length)
+                    : allocator->AllocateUninitialized(length);
+}
+
+
 void ArrayBufferTracker::RegisterNew(JSArrayBuffer* buffer) {
   void* data = buffer->backing_store();
   if (!data) return;
@@ -54,6 +75,15 @@ void ArrayBufferTracker::RegisterNew(JSArrayBuffer* buffer) {
 }
 
 
+void ArrayBufferTracker::RegisterFreeCallback(
+    void* data, v8::ArrayBuffer::FreeCallback callback, void* info) {
+  DCHECK(live_array_buffers_.count(data) > 0 ||
+         live_array_buffers_for_scavenge_.count(data) > 0);
+  FreeCallbackInfo callback_info = {callback, info};
+  free_callbacks_[data] = callback_info;
+}
+
+
 void ArrayBufferTracker::Unregister(JSArrayBuffer* buffer) {
   void* data = buffer->backing_store();
   if (!data) return;
@@ -70,6 +100,31 @@ void ArrayBufferTracker::Unregister(JSArrayBuffer* buffer) {
   size_t length = (*live_buffers)[data];
   live_buffers->erase(data);
   not_yet_discovered_buffers->erase(data);
+  // The embedder owns the backing store from now on.
+  free_callbacks_.erase(data);
+
+  heap()->update_amount_of_external_allocated_memory(
+      -static_cast<int64_t>(length));
+}
+
+
+void ArrayBufferTracker::Free(JSArrayBuffer* buffer) {
+  void* data = buffer->backing_store();
+  if (!data) return;
+
+  bool in_new_space = heap()->InNewSpace(buffer);
+  std::map<void*, size_t>* live_buffers =
+      in_new_space ? &live_array_buffers_for_scavenge_ : &live_array_buffers_;
+  std::map<void*, size_t>* not_yet_discovered_buffers =
+      in_new_space ? &not_yet_discovered_array_buffers_for_scavenge_
+                   : &not_yet_discovered_array_buffers_;
+
+  DCHECK(live_buffers->count(data) > 0);
+
+  size_t length = (*live_buffers)[data];
+  live_buffers->erase(data);
+  not_yet_discovered_buffers->erase(data);
+  FreeBackingStore(data, length);
 
   heap()->update_amount_of_external_allocated_memory(
       -static_cast<int64_t>(length));
@@ -91,16 +146,15 @@ void ArrayBufferTracker::MarkLive(JSArrayBuffer* buffer) {
 
 void ArrayBufferTracker::FreeDead(bool from_scavenge) {
   size_t freed_memory = 0;
-  Isolate* isolate = heap()->isolate();
   for (auto& buffer : not_yet_discovered_array_buffers_for_scavenge_) {
-    isolate->array_buffer_allocator()->Free(buffer.first, buffer.second);
+    FreeBackingStore(buffer.first, buffer.second);
     freed_memory += buffer.second;
     live_array_buffers_for_scavenge_.erase(buffer.first);
   }
 
   if (!from_scavenge) {
     for (auto& buffer : not_yet_discovered_array_buffers_) {
-      isolate->array_buffer_allocator()->Free(buffer.first, buffer.second);
+      FreeBackingStore(buffer.first, buffer.second);
       freed_memory += buffer.second;
       live_array_buffers_.erase(buffer.first);
     }
@@ -134,5 +188,38 @@ void ArrayBufferTracker::Promote(JSArrayBuffer* buffer) {
   not_yet_discovered_array_buffers_for_scavenge_.erase(data);
 }
 
+
+void ArrayBufferTracker::FlushPool() {
+  v8::ArrayBuffer::Allocator* allocator =
+      heap()->isolate()->array_buffer_allocator();
+  for (auto& size_class : pool_) {
+    for (void* data : size_class.second) {
+      allocator->Free(data, size_class.first);
+    }
+  }
+  pool_.clear();
+  pool_size_ = 0;
+}
+
+
+void ArrayBufferTracker::FreeBackingStore(void* data, size_t length) {
+  if (!free_callbacks_.empty()) {
+    auto it = free_callbacks_.find(data);
+    if (it != free_callbacks_.end()) {
+      FreeCallbackInfo callback_info = it->second;
+      free_callbacks_.erase(it);
+      callback_info.callback(data, length, callback_info.info);
+      return;
+    }
+  }
+  if (FLAG_pool_array_buffers && length > 0 && length <= kMaxPooledLength &&
+      pool_size_ + length <= kMaxPoolSize) {
+    pool_[length].push_back(data);
+    pool_size_ += length;
+    return;
+  }
+  heap()->isolate()->array_buffer_allocator()->Free(data, length);
+}
+
 }  // namespace internal
 }  // namespace v8
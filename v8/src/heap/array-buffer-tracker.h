@@ -6,7 +6,9 @@
 #define V8_HEAP_ARRAY_BUFFER_TRACKER_H_
 
 #include <map>
+#include <vector>
 
+#include "include/v8.h"
 #include "src/globals.h"
 
 namespace v8 {
@@ -18,7 +20,7 @@ class JSArrayBuffer;
 
 class ArrayBufferTracker {
  public:
-  explicit ArrayBufferTracker(Heap* heap) : heap_(heap) {}
+  explicit ArrayBufferTracker(Heap* heap) : heap_(heap), pool_size_(0) {}
   ~ArrayBufferTracker();
 
   inline Heap* heap() { return heap_; }
@@ -26,12 +28,25 @@ class ArrayBufferTracker {
   // The following methods are used to track raw C++ pointers to externally
   // allocated memory used as backing store in live array buffers.
 
+  // Allocates a backing store of |length| bytes, reusing a pooled one if
+  // possible. Pooled backing stores are only cleared if |initialize| is set.
+  // Returns NULL if the allocation failed.
+  void* Allocate(size_t length, bool initialize);
+
   // A new ArrayBuffer was created with |data| as backing store.
   void RegisterNew(JSArrayBuffer* buffer);
 
+  // The embedder-owned backing store |data| of a newly registered
+  // ArrayBuffer is released by calling |callback| instead of being freed.
+  void RegisterFreeCallback(void* data, v8::ArrayBuffer::FreeCallback callback,
+                            void* info);
+
   // The backing store |data| is no longer owned by V8.
   void Unregister(JSArrayBuffer* buffer);
 
+  // The backing store of |buffer| is no longer used and is freed right away.
+  void Free(JSArrayBuffer* buffer);
+
   // A live ArrayBuffer was discovered during marking/scavenge.
   void MarkLive(JSArrayBuffer* buffer);
 
@@ -46,7 +61,22 @@ class ArrayBufferTracker {
   // An ArrayBuffer moved from new space to old space.
   void Promote(JSArrayBuffer* buffer);
 
+  // Returns all pooled backing stores to the array buffer allocator.
+  void FlushPool();
+
  private:
+  struct FreeCallbackInfo {
+    v8::ArrayBuffer::FreeCallback callback;
+    void* info;
+  };
+
+  // Backing stores up to this length are pooled when they die.
+  static const size_t kMaxPooledLength = 4 * KB;
+  // Upper bound for the total length of the pooled backing stores.
+  static const size_t kMaxPoolSize = 1 * MB;
+
+  void FreeBackingStore(void* data, size_t length);
+
   Heap* heap_;
 
   // |live_array_buffers_| maps externally allocated memory used as backing
@@ -67,6 +97,14 @@ class ArrayBufferTracker {
   // |live_array_buffers_| list.
   std::map<void*, size_t> live_array_buffers_for_scavenge_;
   std::map<void*, size_t> not_yet_discovered_array_buffers_for_scavenge_;
+
+  // Dead backing stores that can be reused, keyed by their length. Reused
+  // backing stores keep their exact length, so that they can be externalized
+  // and freed by the embedder like any other backing store.
+  std::map<size_t, std::vector<void*> > pool_;
+  size_t pool_size_;
+
+  std::map<void*, FreeCallbackInfo> free_callbacks_;
 };
 }  // namespace internal
 }  // namespace v8
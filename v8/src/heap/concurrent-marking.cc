@@ -0,0 +1,241 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/heap/concurrent-marking.h"
+
+#include "src/base/atomicops.h"
+#include "src/base/sys-info.h"
+#include "src/cancelable-task.h"
+#include "src/heap/heap.h"
+#include "src/heap/incremental-marking.h"
+#include "src/heap/mark-compact-inl.h"
+#include "src/isolate.h"
+#include "src/v8.h"
+
+namespace v8 {
+namespace internal {
+
+class ConcurrentMarking::Task : public CancelableTask {
+ public:
+  explicit Task(ConcurrentMarking* concurrent_marking)
+      : CancelableTask(concurrent_marking->heap_->isolate()),
+        concurrent_marking_(concurrent_marking) {}
+
+  virtual ~Task() {}
+
+ private:
+  // v8::internal::CancelableTask overrides.
+  void RunInternal() override {
+    concurrent_marking_->Run();
+    concurrent_marking_->pending_tasks_semaphore_.Signal();
+  }
+
+  ConcurrentMarking* concurrent_marking_;
+
+  DISALLOW_COPY_AND_ASSIGN(Task);
+};
+
+
+ConcurrentMarking::ConcurrentMarking(Heap* heap)
+    : heap_(heap),
+      enabled_(false),
+      paused_(false),
+      running_tasks_(0),
+      pending_tasks_semaphore_(0) {}
+
+
+ConcurrentMarking::~ConcurrentMarking() {
+  DCHECK_EQ(0, running_tasks_);
+  DCHECK(task_ids_.is_empty());
+}
+
+
+void ConcurrentMarking::Start() {
+  DCHECK(chunks_.is_empty());
+  DCHECK(objects_.is_empty());
+  DCHECK(slots_.is_empty());
+  enabled_ = true;
+}
+
+
+bool ConcurrentMarking::ShouldSchedule(HeapObject* object, int object_size) {
+  if (!enabled_ || object_size < kMinArraySize) return false;
+  if (heap_->InNewSpace(object)) return false;
+  // Leave arrays that are already partially scanned to the progress bar.
+  MemoryChunk* chunk = MemoryChunk::FromAddress(object->address());
+  return !chunk->IsFlagSet(MemoryChunk::HAS_PROGRESS_BAR) ||
+         chunk->progress_bar() == 0;
+}
+
+
+void ConcurrentMarking::Schedule(FixedArray* array) {
+  DCHECK(enabled_);
+  int length = array->length();
+  base::LockGuard<base::Mutex> guard(&mutex_);
+  for (int start = 0; start < length; start += kElementsPerChunk) {
+    Chunk chunk = {array, start, Min(length, start + kElementsPerChunk)};
+    chunks_.Add(chunk);
+  }
+  if (!paused_) StartTasksLocked();
+}
+
+
+int ConcurrentMarking::NumberOfTasks() {
+  // The main thread is busy running the mutator.
+  int tasks = FLAG_concurrent_marking_tasks > 0
+                  ? FLAG_concurrent_marking_tasks
+                  : base::SysInfo::NumberOfProcessors() - 1;
+  return Max(1, Min(tasks, kMaxTasks));
+}
+
+
+void ConcurrentMarking::StartTasksLocked() {
+  int tasks = Min(NumberOfTasks(), chunks_.length());
+  while (running_tasks_ < tasks) {
+    Task* task = new Task(this);
+    task_ids_.Add(task->id());
+    running_tasks_++;
+    V8::GetCurrentPlatform()->CallOnBackgroundThread(
+        task, v8::Platform::kShortRunningTask);
+  }
+}
+
+
+void ConcurrentMarking::Run() {
+  List<HeapObject*> objects;
+  List<RecordedSlot> slots;
+  while (true) {
+    Chunk chunk;
+    {
+      base::LockGuard<base::Mutex> guard(&mutex_);
+      objects_.AddAll(objects);
+      slots_.AddAll(slots);
+      objects.Rewind(0);
+      slots.Rewind(0);
+      if (paused_ || chunks_.is_empty()) {
+        running_tasks_--;
+        return;
+      }
+      chunk = chunks_.RemoveLast();
+    }
+    ScanChunk(chunk, &objects, &slots);
+  }
+}
+
+
+void ConcurrentMarking::ScanChunk(const Chunk& chunk,
+                                  List<HeapObject*>* objects,
+                                  List<RecordedSlot>* slots) {
+  // The mutator may store into the array while it is being scanned.  The
+  // stored values are covered by the write barrier, we only have to make sure
+  // to read every element as a whole.
+  for (int i = chunk.start; i < chunk.end; i++) {
+    Object** slot = HeapObject::RawField(chunk.array,
+                                         FixedArray::OffsetOfElementAt(i));
+    Object* value = reinterpret_cast<Object*>(base::NoBarrier_Load(
+        reinterpret_cast<base::AtomicWord*>(slot)));
+    if (!value->IsHeapObject()) continue;
+    HeapObject* heap_object = HeapObject::cast(value);
+    if (MarkCompactCollector::IsOnEvacuationCandidate(heap_object)) {
+      RecordedSlot recorded_slot = {chunk.array, slot};
+      slots->Add(recorded_slot);
+    }
+    if (Marking::IsWhite(Marking::MarkBitFrom(heap_object))) {
+      objects->Add(heap_object);
+    }
+  }
+}
+
+
+void ConcurrentMarking::ProcessResults() {
+  List<HeapObject*> objects;
+  List<RecordedSlot> slots;
+  {
+    base::LockGuard<base::Mutex> guard(&mutex_);
+    objects.Swap(&objects_);
+    slots.Swap(&slots_);
+  }
+  IncrementalMarking* incremental_marking = heap_->incremental_marking();
+  for (int i = 0; i < objects.length(); i++) {
+    HeapObject* object = objects[i];
+    MarkBit mark_bit = Marking::MarkBitFrom(object);
+    if (Marking::IsWhite(mark_bit)) {
+      incremental_marking->WhiteToGreyAndPush(object, mark_bit);
+    }
+  }
+  MarkCompactCollector* collector = heap_->mark_compact_collector();
+  for (int i = 0; i < slots.length(); i++) {
+    Object* target = *slots[i].slot;
+    if (target->IsHeapObject()) {
+      collector->RecordSlot(slots[i].host, slots[i].slot, target);
+    }
+  }
+}
+
+
+bool ConcurrentMarking::HasPendingWork() {
+  base::LockGuard<base::Mutex> guard(&mutex_);
+  return running_tasks_ > 0 || !chunks_.is_empty() || !objects_.is_empty() ||
+         !slots_.is_empty();
+}
+
+
+void ConcurrentMarking::StopTasks() {
+  {
+    base::LockGuard<base::Mutex> guard(&mutex_);
+    paused_ = true;
+  }
+  for (int i = 0; i < task_ids_.length(); i++) {
+    if (heap_->isolate()->cancelable_task_manager()->TryAbort(task_ids_[i])) {
+      base::LockGuard<base::Mutex> guard(&mutex_);
+      running_tasks_--;
+    } else {
+      pending_tasks_semaphore_.Wait();
+    }
+  }
+  task_ids_.Clear();
+  DCHECK_EQ(0, running_tasks_);
+}
+
+
+void ConcurrentMarking::Pause() {
+  if (!enabled_) return;
+  StopTasks();
+  ProcessResults();
+}
+
+
+void ConcurrentMarking::Resume() {
+  if (!enabled_) return;
+  base::LockGuard<base::Mutex> guard(&mutex_);
+  paused_ = false;
+  StartTasksLocked();
+}
+
+
+void ConcurrentMarking::Finish() {
+  if (!enabled_) return;
+  StopTasks();
+  enabled_ = false;
+  paused_ = false;
+  for (int i = 0; i < chunks_.length(); i++) {
+    ScanChunk(chunks_[i], &objects_, &slots_);
+  }
+  chunks_.Clear();
+  ProcessResults();
+}
+
+
+void ConcurrentMarking::Abort() {
+  if (!enabled_) return;
+  StopTasks();
+  enabled_ = false;
+  paused_ = false;
+  chunks_.Clear();
+  objects_.Clear();
+  slots_.Clear();
+}
+
+}  // namespace internal
+}  // namespace v8
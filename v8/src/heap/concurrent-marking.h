@@ -0,0 +1,146 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_HEAP_CONCURRENT_MARKING_H_
+#define V8_HEAP_CONCURRENT_MARKING_H_
+
+#include "src/base/platform/mutex.h"
+#include "src/base/platform/semaphore.h"
+#include "src/list.h"
+
+namespace v8 {
+namespace internal {
+
+class FixedArray;
+class Heap;
+class HeapObject;
+class Object;
+
+// Scans the bodies of large old-generation fixed arrays on background threads
+// while incremental marking is running.  Scanning such an array dominates the
+// marking steps it falls into, but it only needs the mark bits of the
+// elements, so it can be done off the main thread.
+//
+// The main thread stays the only writer of mark bits, live bytes, recorded
+// slots and the marking deque.  It marks a scheduled array black right away,
+// which makes the incremental write barrier cover every store into the array
+// from then on.  The tasks only read the elements and collect the ones that
+// are still white, together with the slots pointing to evacuation candidates.
+// These results are handed back to the main thread, which greys and pushes
+// the objects and records the slots in ProcessResults().
+//
+// The scanned arrays and the collected objects must not move while tasks are
+// working on them.  The tasks are therefore paused around scavenges, arrays
+// with pending work are never left-trimmed, and all remaining work is done on
+// the main thread before marking is finalized.
+class ConcurrentMarking {
+ public:
+  explicit ConcurrentMarking(Heap* heap);
+  ~ConcurrentMarking();
+
+  // Arrays with a body of at least this size are scanned concurrently.
+  static const int kMinArraySize = 16 * KB;
+
+  // Work is handed out on chunks of this many elements.
+  static const int kElementsPerChunk = 1024;
+
+  static const int kMaxTasks = 4;
+
+  // Enables scheduling for the current incremental marking cycle.
+  void Start();
+
+  // Returns true if the body of the given array, which the caller is about
+  // to mark black, should be scanned by the background tasks.
+  bool ShouldSchedule(HeapObject* object, int object_size);
+
+  // Queues the body of the given black array for scanning and starts tasks
+  // if needed.
+  void Schedule(FixedArray* array);
+
+  // Greys and pushes the objects found by the tasks and records the slots
+  // they collected.  Must be called on the main thread.
+  void ProcessResults();
+
+  // Returns true if there is scheduled work or there are results that have
+  // not been processed yet.
+  bool HasPendingWork();
+
+  // Stops the tasks and waits for them, processing their results.  The
+  // queued chunks are kept until Resume() is called.
+  void Pause();
+  void Resume();
+
+  // Stops the tasks, scans the remaining chunks on the main thread and
+  // processes all results.  No more arrays are scheduled afterwards.
+  void Finish();
+
+  // Stops the tasks and drops all scheduled work and results.
+  void Abort();
+
+ private:
+  class Task;
+
+  struct Chunk {
+    FixedArray* array;
+    int start;
+    int end;
+  };
+
+  struct RecordedSlot {
+    HeapObject* host;
+    Object** slot;
+  };
+
+  int NumberOfTasks();
+
+  // Scans chunks until there are no more chunks or the tasks are paused.
+  void Run();
+
+  // Collects the white elements and the slots to evacuation candidates of
+  // the chunk into the given lists.
+  static void ScanChunk(const Chunk& chunk, List<HeapObject*>* objects,
+                        List<RecordedSlot>* slots);
+
+  void StartTasksLocked();
+  void StopTasks();
+
+  Heap* heap_;
+  bool enabled_;
+
+  // Protects all of the following fields.
+  base::Mutex mutex_;
+  List<Chunk> chunks_;
+  List<HeapObject*> objects_;
+  List<RecordedSlot> slots_;
+  bool paused_;
+  int running_tasks_;
+
+  // Only accessed on the main thread.
+  List<uint32_t> task_ids_;
+  base::Semaphore pending_tasks_semaphore_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConcurrentMarking);
+};
+
+
+// Keeps the concurrent marking tasks from running while objects are moved.
+class PauseConcurrentMarkingScope {
+ public:
+  explicit PauseConcurrentMarkingScope(ConcurrentMarking* concurrent_marking)
+      : concurrent_marking_(concurrent_marking) {
+    concurrent_marking_->Pause();
+  }
+
+  ~PauseConcurrentMarkingScope() { concurrent_marking_->Resume(); }
+
+ private:
+  ConcurrentMarking* concurrent_marking_;
+
+  DISALLOW_COPY_AND_ASSIGN(PauseConcurrentMarkingScope);
+};
+
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_HEAP_CONCURRENT_MARKING_H_
@@ -73,7 +73,10 @@ GCTracer::Event::Event(Type type, const char* gc_reason,
       incremental_marking_duration(0.0),
       cumulative_pure_incremental_marking_duration(0.0),
       pure_incremental_marking_duration(0.0),
-      longest_incremental_marking_step(0.0) {
+      longest_incremental_marking_step(0.0),
+      idle_tasks(0),
+      idle_time_allotted(0.0),
+      idle_time_used(0.0) {
   for (int i = 0; i < Scope::NUMBER_OF_SCOPES; i++) {
     scopes[i] = 0;
   }
@@ -124,6 +127,9 @@ GCTracer::GCTracer(Heap* heap)
       allocation_duration_since_gc_(0.0),
       new_space_allocation_in_bytes_since_gc_(0),
       old_generation_allocation_in_bytes_since_gc_(0),
+      idle_tasks_since_gc_(0),
+      idle_time_allotted_since_gc_(0.0),
+      idle_time_used_since_gc_(0.0),
       combined_mark_compact_speed_cache_(0.0),
       start_counter_(0) {
   current_ = Event(Event::START, NULL, NULL);
@@ -173,6 +179,13 @@ void GCTracer::Start(GarbageCollector collector, const char* gc_reason,
       cumulative_pure_incremental_marking_duration_;
   current_.longest_incremental_marking_step = longest_incremental_marking_step_;
 
+  current_.idle_tasks = idle_tasks_since_gc_;
+  current_.idle_time_allotted = idle_time_allotted_since_gc_;
+  current_.idle_time_used = idle_time_used_since_gc_;
+  idle_tasks_since_gc_ = 0;
+  idle_time_allotted_since_gc_ = 0.0;
+  idle_time_used_since_gc_ = 0.0;
+
   for (int i = 0; i < Scope::NUMBER_OF_SCOPES; i++) {
     current_.scopes[i] = 0;
   }
@@ -341,6 +354,13 @@ void GCTracer::AddSurvivalRatio(double promotion_ratio) {
 }
 
 
+void GCTracer::AddIdleTime(double allotted_ms, double used_ms) {
+  idle_tasks_since_gc_++;
+  idle_time_allotted_since_gc_ += allotted_ms;
+  idle_time_used_since_gc_ += used_ms;
+}
+
+
 void GCTracer::AddIncrementalMarkingStep(double duration, intptr_t bytes) {
   cumulative_incremental_marking_steps_++;
   cumulative_incremental_marking_bytes_ += bytes;
@@ -448,6 +468,7 @@ void GCTracer::PrintNVP() const {
                    "code=%.2f "
                    "semispace=%.2f "
                    "object_groups=%.2f "
+                   "parallel=%.2f "
                    "steps_count=%d "
                    "steps_took=%.1f "
                    "scavenge_throughput=%" V8_PTR_PREFIX
@@ -475,7 +496,10 @@ void GCTracer::PrintNVP() const {
                    "semi_space_copy_rate=%.1f%% "
                    "new_space_allocation_throughput=%" V8_PTR_PREFIX
                    "d "
-                   "context_disposal_rate=%.1f\n",
+                   "context_disposal_rate=%.1f "
+                   "idle_tasks=%d "
+                   "idle_time_allotted=%.1f "
+                   "idle_time_used=%.1f\n",
                    heap_->isolate()->time_millis_since_init(), duration,
                    spent_in_mutator, current_.TypeName(true),
                    current_.reduce_memory,
@@ -486,6 +510,7 @@ void GCTracer::PrintNVP() const {
                    current_.scopes[Scope::SCAVENGER_CODE_FLUSH_CANDIDATES],
                    current_.scopes[Scope::SCAVENGER_SEMISPACE],
                    current_.scopes[Scope::SCAVENGER_OBJECT_GROUPS],
+                   current_.scopes[Scope::SCAVENGER_PARALLEL],
                    current_.incremental_marking_steps,
                    current_.incremental_marking_duration,
                    ScavengeSpeedInBytesPerMillisecond(),
@@ -498,7 +523,8 @@ void GCTracer::PrintNVP() const {
                    heap_->promotion_ratio_, AverageSurvivalRatio(),
                    heap_->promotion_rate_, heap_->semi_space_copied_rate_,
                    NewSpaceAllocationThroughputInBytesPerMillisecond(),
-                   ContextDisposalRateInMilliseconds());
+                   ContextDisposalRateInMilliseconds(), current_.idle_tasks,
+                   current_.idle_time_allotted, current_.idle_time_used);
       break;
     case Event::MARK_COMPACTOR:
     case Event::INCREMENTAL_MARK_COMPACTOR:
@@ -573,7 +599,11 @@ void GCTracer::PrintNVP() const {
           "new_space_allocation_throughput=%" V8_PTR_PREFIX
           "d "
           "context_disposal_rate=%.1f "
-          "compaction_speed=%" V8_PTR_PREFIX "d\n",
+          "compaction_speed=%" V8_PTR_PREFIX
+          "d "
+          "idle_tasks=%d "
+          "idle_time_allotted=%.1f "
+          "idle_time_used=%.1f\n",
           heap_->isolate()->time_millis_since_init(), duration,
           spent_in_mutator, current_.TypeName(true), current_.reduce_memory,
           current_.scopes[Scope::EXTERNAL], current_.scopes[Scope::MC_CLEAR],
@@ -623,7 +653,8 @@ void GCTracer::PrintNVP() const {
           heap_->semi_space_copied_rate_,
           NewSpaceAllocationThroughputInBytesPerMillisecond(),
           ContextDisposalRateInMilliseconds(),
-          CompactionSpeedInBytesPerMillisecond());
+          CompactionSpeedInBytesPerMillisecond(), current_.idle_tasks,
+          current_.idle_time_allotted, current_.idle_time_used);
       break;
     case Event::START:
       break;
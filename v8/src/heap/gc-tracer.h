@@ -132,6 +132,7 @@ class GCTracer {
       SCAVENGER_CODE_FLUSH_CANDIDATES,
       SCAVENGER_OBJECT_GROUPS,
       SCAVENGER_OLD_TO_NEW_POINTERS,
+      SCAVENGER_PARALLEL,
       SCAVENGER_ROOTS,
       SCAVENGER_SCAVENGE,
       SCAVENGER_SEMISPACE,
@@ -303,6 +304,12 @@ class GCTracer {
     // (value at start of event)
     double longest_incremental_marking_step;
 
+    // Number of idle slots used by the heap since the last event, and the
+    // idle time that was allotted to and actually used by them.
+    int idle_tasks;
+    double idle_time_allotted;
+    double idle_time_used;
+
     // Amounts of time spent in different scopes during GC.
     double scopes[Scope::NUMBER_OF_SCOPES];
   };
@@ -349,6 +356,9 @@ class GCTracer {
 
   void AddIncrementalMarkingFinalizationStep(double duration);
 
+  // Log the use of an idle slot, i.e. of an idle task or idle notification.
+  void AddIdleTime(double allotted_ms, double used_ms);
+
   // Log time spent in marking.
   void AddMarkingTime(double duration) {
     cumulative_marking_duration_ += duration;
@@ -592,6 +602,11 @@ class GCTracer {
   size_t new_space_allocation_in_bytes_since_gc_;
   size_t old_generation_allocation_in_bytes_since_gc_;
 
+  // Accumulated idle slots since the last GC.
+  int idle_tasks_since_gc_;
+  double idle_time_allotted_since_gc_;
+  double idle_time_used_since_gc_;
+
   double combined_mark_compact_speed_cache_;
 
   // Counts how many tracers were started without stopping.
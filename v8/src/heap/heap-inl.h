@@ -469,11 +469,16 @@ void Heap::MoveBlock(Address dst, Address src, int byte_size) {
 
 
 AllocationMemento* Heap::FindAllocationMemento(HeapObject* object) {
+  return FindAllocationMemento(object, object->map());
+}
+
+
+AllocationMemento* Heap::FindAllocationMemento(HeapObject* object, Map* map) {
   // Check if there is potentially a memento behind the object. If
   // the last word of the memento is on another page we return
   // immediately.
   Address object_address = object->address();
-  Address memento_address = object_address + object->Size();
+  Address memento_address = object_address + object->SizeFromMap(map);
   Address last_memento_word_address = memento_address + kPointerSize;
   if (!NewSpacePage::OnSamePage(object_address, last_memento_word_address)) {
     return NULL;
@@ -509,11 +514,17 @@ AllocationMemento* Heap::FindAllocationMemento(HeapObject* object) {
 
 void Heap::UpdateAllocationSite(HeapObject* object,
                                 HashMap* pretenuring_feedback) {
+  UpdateAllocationSite(object, object->map(), pretenuring_feedback);
+}
+
+
+void Heap::UpdateAllocationSite(HeapObject* object, Map* map,
+                                HashMap* pretenuring_feedback) {
   DCHECK(InFromSpace(object));
   if (!FLAG_allocation_site_pretenuring ||
-      !AllocationSite::CanTrack(object->map()->instance_type()))
+      !AllocationSite::CanTrack(map->instance_type()))
     return;
-  AllocationMemento* memento = FindAllocationMemento(object);
+  AllocationMemento* memento = FindAllocationMemento(object, map);
   if (memento == nullptr) return;
 
   AllocationSite* key = memento->GetAllocationSite();
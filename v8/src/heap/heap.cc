@@ -1629,6 +1629,10 @@ void Heap::Scavenge() {
   // Pause the inline allocation steps.
   PauseInlineAllocationObserversScope pause_observers(new_space());
 
+  // Concurrent marking holds on to objects that may be moved.
+  PauseConcurrentMarkingScope pause_concurrent_marking(
+      incremental_marking()->concurrent_marking());
+
 #ifdef VERIFY_HEAP
   if (FLAG_verify_heap) VerifyNonPointerSpacePointers(this);
 #endif
@@ -1680,19 +1684,44 @@ void Heap::Scavenge() {
         &IsUnmodifiedHeapObject);
   }
 
-  {
-    // Copy roots.
-    GCTracer::Scope gc_scope(tracer(), GCTracer::Scope::SCAVENGER_ROOTS);
-    IterateRoots(&scavenge_visitor, VISIT_ALL_IN_SCAVENGE);
-  }
+  if (scavenge_collector_->CanScavengeInParallel()) {
+    ParallelScavenger parallel_scavenger(this);
+    {
+      // Copy roots and objects reachable from the old generation, together
+      // with everything they reach in new space.
+      GCTracer::Scope gc_scope(tracer(), GCTracer::Scope::SCAVENGER_PARALLEL);
+      parallel_scavenger.ScavengeRootsAndOldToNewPointers();
+    }
 
-  {
-    // Copy objects reachable from the old generation.
-    GCTracer::Scope gc_scope(tracer(),
-                             GCTracer::Scope::SCAVENGER_OLD_TO_NEW_POINTERS);
-    StoreBufferRebuildScope scope(this, store_buffer(),
-                                  &ScavengeStoreBufferCallback);
-    store_buffer()->IteratePointersToNewSpace(&Scavenger::ScavengeObject);
+    // All objects copied so far have been scanned by the tasks.
+    new_space_front = new_space_.top();
+    promotion_queue_.SetNewLimit(new_space_front);
+
+    {
+      // Scan the pages that are exempt from the store buffer and re-enter the
+      // old-to-new pointers that survived the parallel phase.
+      GCTracer::Scope gc_scope(tracer(),
+                               GCTracer::Scope::SCAVENGER_OLD_TO_NEW_POINTERS);
+      StoreBufferRebuildScope scope(this, store_buffer(),
+                                    &ScavengeStoreBufferCallback);
+      store_buffer()->IteratePointersToNewSpace(&Scavenger::ScavengeObject);
+      parallel_scavenger.Finalize();
+    }
+  } else {
+    {
+      // Copy roots.
+      GCTracer::Scope gc_scope(tracer(), GCTracer::Scope::SCAVENGER_ROOTS);
+      IterateRoots(&scavenge_visitor, VISIT_ALL_IN_SCAVENGE);
+    }
+
+    {
+      // Copy objects reachable from the old generation.
+      GCTracer::Scope gc_scope(tracer(),
+                               GCTracer::Scope::SCAVENGER_OLD_TO_NEW_POINTERS);
+      StoreBufferRebuildScope scope(this, store_buffer(),
+                                    &ScavengeStoreBufferCallback);
+      store_buffer()->IteratePointersToNewSpace(&Scavenger::ScavengeObject);
+    }
   }
 
   {
@@ -3091,6 +3120,11 @@ bool Heap::CanMoveObjectStart(HeapObject* object) {
 
   if (lo_space()->Contains(object)) return false;
 
+  // The concurrent marking tasks may be scanning the object.
+  if (incremental_marking()->concurrent_marking()->HasPendingWork()) {
+    return false;
+  }
+
   Page* page = Page::FromAddress(address);
   // We can move the object start if:
   // (1) the object is not in old space,
@@ -4147,6 +4181,9 @@ bool Heap::TryFinalizeIdleIncrementalMarking(double idle_time_in_ms) {
               gc_idle_time_handler_->ShouldDoFinalIncrementalMarkCompact(
                   static_cast<size_t>(idle_time_in_ms), size_of_objects,
                   final_incremental_mark_compact_speed_in_bytes_per_ms))) {
+    // Only evacuate as many pages as fit into the remaining idle time.
+    mark_compact_collector()->set_evacuation_deadline_in_ms(
+        MonotonicallyIncreasingTimeInMs() + idle_time_in_ms);
     CollectAllGarbage(current_gc_flags_,
                       "idle notification: finalize incremental marking");
     return true;
@@ -4212,6 +4249,7 @@ void Heap::IdleNotificationEpilogue(GCIdleTimeAction action,
 
   isolate()->counters()->gc_idle_time_allotted_in_ms()->AddSample(
       static_cast<int>(idle_time_in_ms));
+  tracer()->AddIdleTime(idle_time_in_ms, idle_time_in_ms - deadline_difference);
 
   if (deadline_in_ms - start_ms >
       GCIdleTimeHandler::kMaxFrameRenderingIdleTime) {
@@ -4253,6 +4291,23 @@ void Heap::IdleNotificationEpilogue(GCIdleTimeAction action,
 }
 
 
+void Heap::ReportIdleTaskUsage(const char* task_name, double start_ms,
+                               double deadline_in_ms) {
+  double idle_time_in_ms = deadline_in_ms - start_ms;
+  double deadline_difference =
+      deadline_in_ms - MonotonicallyIncreasingTimeInMs();
+  double used_idle_time_in_ms = idle_time_in_ms - deadline_difference;
+  tracer()->AddIdleTime(idle_time_in_ms, used_idle_time_in_ms);
+  if (FLAG_trace_idle_notification) {
+    PrintIsolate(isolate_, "%8.0f ms: ", isolate()->time_millis_since_init());
+    PrintF(
+        "%s: requested idle time %.2f ms, used idle time %.2f ms, deadline "
+        "usage %.2f ms\n",
+        task_name, idle_time_in_ms, used_idle_time_in_ms, deadline_difference);
+  }
+}
+
+
 double Heap::MonotonicallyIncreasingTimeInMs() {
   return V8::GetCurrentPlatform()->MonotonicallyIncreasingTime() *
          static_cast<double>(base::Time::kMillisecondsPerSecond);
@@ -5267,6 +5322,8 @@ void Heap::TearDown() {
     PrintAlloctionsHash();
   }
 
+  incremental_marking()->concurrent_marking()->Abort();
+
   new_space()->RemoveInlineAllocationObserver(idle_scavenge_observer_);
   delete idle_scavenge_observer_;
   idle_scavenge_observer_ = nullptr;
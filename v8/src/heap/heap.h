@@ -928,6 +928,9 @@ class Heap {
   // If an object has an AllocationMemento trailing it, return it, otherwise
   // return NULL;
   inline AllocationMemento* FindAllocationMemento(HeapObject* object);
+  // Same as above, for an object whose map word may no longer hold {map}.
+  inline AllocationMemento* FindAllocationMemento(HeapObject* object,
+                                                  Map* map);
 
   // Returns false if not able to reserve.
   bool ReserveSpace(Reservation* reservations);
@@ -1299,6 +1302,11 @@ class Heap {
 
   bool TryFinalizeIdleIncrementalMarking(double idle_time_in_ms);
 
+  // Records how much of the idle slot that started at start_ms and ends at
+  // deadline_in_ms was used by the given idle task.
+  void ReportIdleTaskUsage(const char* task_name, double start_ms,
+                           double deadline_in_ms);
+
   IncrementalMarking* incremental_marking() { return incremental_marking_; }
 
   // ===========================================================================
@@ -1549,6 +1557,10 @@ class Heap {
   // value) is cached on the local pretenuring feedback.
   inline void UpdateAllocationSite(HeapObject* object,
                                    HashMap* pretenuring_feedback);
+  // Same as above, for an object whose map word may have been replaced by a
+  // forwarding address concurrently, e.g. during a parallel scavenge.
+  inline void UpdateAllocationSite(HeapObject* object, Map* map,
+                                   HashMap* pretenuring_feedback);
 
   // Removes an entry from the global pretenuring storage.
   inline void RemoveAllocationSitePretenuringFeedback(AllocationSite* site);
@@ -2428,6 +2440,7 @@ class Heap {
   friend class NewSpace;
   friend class ObjectStatsVisitor;
   friend class Page;
+  friend class ParallelScavenger;
   friend class Scavenger;
   friend class StoreBuffer;
 
@@ -98,47 +98,8 @@ void IncrementalMarkingJob::IdleTask::RunInternal(double deadline_in_seconds) {
   if (Step(heap, deadline_in_ms) == kMoreWork) {
     job_->ScheduleIdleTask(heap);
   }
-  if (FLAG_trace_idle_notification) {
-    double current_time_ms = heap->MonotonicallyIncreasingTimeInMs();
-    double idle_time_in_ms = deadline_in_ms - start_ms;
-    double deadline_difference = deadline_in_ms - current_time_ms;
-    PrintIsolate(isolate(), "%8.0f ms: ", isolate()->time_millis_since_init());
-    PrintF(
-        "Idle task: requested idle time %.2f ms, used idle time %.2f "
-        "ms, deadline usage %.2f ms\n",
-        idle_time_in_ms, idle_time_in_ms - deadline_difference,
-        deadline_difference);
-  }
-}
-
-
-void IncrementalMarkingJob::DelayedTask::Step(Heap* heap) {
-  const int kIncrementalMarkingDelayMs = 50;
-  double deadline =
-      heap->MonotonicallyIncreasingTimeInMs() + kIncrementalMarkingDelayMs;
-  heap->incremental_marking()->AdvanceIncrementalMarking(
-      0, deadline, i::IncrementalMarking::StepActions(
-                       i::IncrementalMarking::NO_GC_VIA_STACK_GUARD,
-                       i::IncrementalMarking::FORCE_MARKING,
-                       i::IncrementalMarking::FORCE_COMPLETION));
-  heap->FinalizeIncrementalMarkingIfComplete(
-      "Incremental marking task: finalize incremental marking");
-}
-
-
-void IncrementalMarkingJob::DelayedTask::RunInternal() {
-  Heap* heap = isolate()->heap();
-  job_->NotifyDelayedTask();
-  IncrementalMarking* incremental_marking = heap->incremental_marking();
-  if (!incremental_marking->IsStopped()) {
-    if (job_->ShouldForceMarkingStep()) {
-      Step(heap);
-    }
-    // The Step() above could have finished incremental marking.
-    if (!incremental_marking->IsStopped()) {
-      job_->ScheduleDelayedTask(heap);
-    }
-  }
+  heap->ReportIdleTaskUsage("Incremental marking idle task", start_ms,
+                            deadline_in_ms);
 }
 
 }  // namespace internal
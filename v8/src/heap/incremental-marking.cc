@@ -44,7 +44,8 @@ IncrementalMarking::IncrementalMarking(Heap* heap)
       was_activated_(false),
       finalize_marking_completed_(false),
       incremental_marking_finalization_rounds_(0),
-      request_type_(COMPLETE_MARKING) {}
+      request_type_(COMPLETE_MARKING),
+      concurrent_marking_(heap) {}
 
 
 bool IncrementalMarking::BaseRecordWrite(HeapObject* obj, Object* value) {
@@ -221,6 +222,18 @@ class IncrementalMarkingMarkingVisitor
 
   static void VisitFixedArrayIncremental(Map* map, HeapObject* object) {
     MemoryChunk* chunk = MemoryChunk::FromAddress(object->address());
+    if (FLAG_concurrent_marking) {
+      // The array is marked black by the caller before the mutator can store
+      // into it again, so leaving its body to the background tasks is safe.
+      Heap* heap = map->GetHeap();
+      ConcurrentMarking* concurrent_marking =
+          heap->incremental_marking()->concurrent_marking();
+      int object_size = FixedArray::BodyDescriptor::SizeOf(map, object);
+      if (concurrent_marking->ShouldSchedule(object, object_size)) {
+        concurrent_marking->Schedule(FixedArray::cast(object));
+        return;
+      }
+    }
     // TODO(mstarzinger): Move setting of the flag to the allocation site of
     // the array. The visitor should just check the flag.
     if (FLAG_use_marking_progress_bar &&
@@ -558,6 +571,8 @@ void IncrementalMarking::StartMarking() {
 
   state_ = MARKING;
 
+  if (FLAG_concurrent_marking) concurrent_marking_.Start();
+
   RecordWriteStub::Mode mode = is_compacting_
                                    ? RecordWriteStub::INCREMENTAL_COMPACTION
                                    : RecordWriteStub::INCREMENTAL;
@@ -885,6 +900,7 @@ void IncrementalMarking::ProcessMarkingDeque() {
 
 
 void IncrementalMarking::Hurry() {
+  concurrent_marking_.Finish();
   if (state() == MARKING) {
     double start = 0.0;
     if (FLAG_trace_incremental_marking || FLAG_print_cumulative_gc_stat) {
@@ -939,6 +955,7 @@ void IncrementalMarking::Stop() {
     PrintF("[IncrementalMarking] Stopping.\n");
   }
 
+  concurrent_marking_.Abort();
   heap_->new_space()->RemoveInlineAllocationObserver(&observer_);
   IncrementalMarking::set_should_hurry(false);
   ResetStepCounters();
@@ -1188,8 +1205,10 @@ intptr_t IncrementalMarking::Step(intptr_t allocated_bytes,
         StartMarking();
       }
     } else if (state_ == MARKING) {
+      concurrent_marking_.ProcessResults();
       bytes_processed = ProcessMarkingDeque(bytes_to_process);
-      if (heap_->mark_compact_collector()->marking_deque()->IsEmpty()) {
+      if (heap_->mark_compact_collector()->marking_deque()->IsEmpty() &&
+          !concurrent_marking_.HasPendingWork()) {
         if (completion == FORCE_COMPLETION ||
             IsIdleMarkingDelayCounterLimitReached()) {
           if (!finalize_marking_completed_) {
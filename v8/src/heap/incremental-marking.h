@@ -7,6 +7,7 @@
 
 #include "src/cancelable-task.h"
 #include "src/execution.h"
+#include "src/heap/concurrent-marking.h"
 #include "src/heap/incremental-marking-job.h"
 #include "src/heap/spaces.h"
 #include "src/objects.h"
@@ -214,6 +215,8 @@ class IncrementalMarking {
     return &incremental_marking_job_;
   }
 
+  ConcurrentMarking* concurrent_marking() { return &concurrent_marking_; }
+
  private:
   class Observer : public InlineAllocationObserver {
    public:
@@ -298,6 +301,8 @@ class IncrementalMarking {
 
   IncrementalMarkingJob incremental_marking_job_;
 
+  ConcurrentMarking concurrent_marking_;
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(IncrementalMarking);
 };
 }  // namespace internal
@@ -64,8 +64,10 @@ MarkCompactCollector::MarkCompactCollector(Heap* heap)
       compacting_(false),
       sweeping_in_progress_(false),
       compaction_in_progress_(false),
+      evacuation_deadline_in_ms_(0),
       pending_sweeper_tasks_semaphore_(0),
-      pending_compaction_tasks_semaphore_(0) {
+      pending_compaction_tasks_semaphore_(0),
+      pending_pointers_updating_tasks_semaphore_(0) {
 }
 
 #ifdef VERIFY_HEAP
@@ -502,6 +504,26 @@ class MarkCompactCollector::CompactionTask : public CancelableTask {
 };
 
 
+class MarkCompactCollector::PointersUpdatingTask : public CancelableTask {
+ public:
+  explicit PointersUpdatingTask(Heap* heap)
+      : CancelableTask(heap->isolate()) {}
+
+  virtual ~PointersUpdatingTask() {}
+
+ private:
+  // v8::internal::CancelableTask overrides.
+  void RunInternal() override {
+    MarkCompactCollector* mark_compact =
+        isolate()->heap()->mark_compact_collector();
+    mark_compact->UpdateUnclaimedSlotsBuffers();
+    mark_compact->pending_pointers_updating_tasks_semaphore_.Signal();
+  }
+
+  DISALLOW_COPY_AND_ASSIGN(PointersUpdatingTask);
+};
+
+
 class MarkCompactCollector::SweeperTask : public v8::Task {
  public:
   SweeperTask(Heap* heap, PagedSpace* space) : heap_(heap), space_(space) {}
@@ -2874,10 +2896,63 @@ void MarkCompactCollector::UpdateSlots(SlotsBuffer* buffer) {
 }
 
 
-void MarkCompactCollector::UpdateSlotsRecordedIn(SlotsBuffer* buffer) {
-  while (buffer != NULL) {
-    UpdateSlots(buffer);
-    buffer = buffer->next();
+int MarkCompactCollector::NumberOfParallelPointersUpdatingTasks(
+    int buffers) {
+  if (!FLAG_parallel_pointer_update) return 1;
+  // Starting a task costs about as much as updating a few buffers.
+  const int kMinBuffersPerTask = 4;
+  const int kMaxPointersUpdatingTasks = 8;
+
+  const int cores = Max(1, base::SysInfo::NumberOfProcessors() - 1);
+  const int tasks = Max(1, buffers / kMinBuffersPerTask);
+  return Min(kMaxPointersUpdatingTasks, Min(cores, tasks));
+}
+
+
+void MarkCompactCollector::UpdateSlotsRecordedInParallel(
+    const List<SlotsBuffer*>& chains) {
+  // The buffers are handed out one by one, since a single chain can hold most
+  // of the slots.
+  DCHECK(slots_buffers_to_update_.is_empty());
+  for (SlotsBuffer* chain : chains) {
+    for (SlotsBuffer* buffer = chain; buffer != NULL; buffer = buffer->next()) {
+      slots_buffers_to_update_.Add(buffer);
+    }
+  }
+  if (slots_buffers_to_update_.is_empty()) return;
+  next_slots_buffer_to_update_.SetValue(0);
+
+  // Slots are updated with a compare-and-swap, so a slot that is recorded in
+  // buffers of different tasks is updated once.
+  const int num_tasks =
+      NumberOfParallelPointersUpdatingTasks(slots_buffers_to_update_.length());
+  uint32_t* task_ids = new uint32_t[num_tasks];
+  for (int i = 1; i < num_tasks; i++) {
+    PointersUpdatingTask* task = new PointersUpdatingTask(heap());
+    task_ids[i] = task->id();
+    V8::GetCurrentPlatform()->CallOnBackgroundThread(
+        task, v8::Platform::kShortRunningTask);
+  }
+
+  // Contribute in main thread.
+  UpdateUnclaimedSlotsBuffers();
+
+  // Tasks that cannot be canceled have either completed or are still running.
+  for (int i = 1; i < num_tasks; i++) {
+    if (!heap()->isolate()->cancelable_task_manager()->TryAbort(task_ids[i])) {
+      pending_pointers_updating_tasks_semaphore_.Wait();
+    }
+  }
+  delete[] task_ids;
+  slots_buffers_to_update_.Rewind(0);
+}
+
+
+void MarkCompactCollector::UpdateUnclaimedSlotsBuffers() {
+  const intptr_t length = slots_buffers_to_update_.length();
+  for (intptr_t index = next_slots_buffer_to_update_.Increment(1) - 1;
+       index < length; index = next_slots_buffer_to_update_.Increment(1) - 1) {
+    UpdateSlots(slots_buffers_to_update_[static_cast<int>(index)]);
   }
 }
 
@@ -3150,6 +3225,42 @@ int MarkCompactCollector::NumberOfParallelCompactionTasks() {
 }
 
 
+void MarkCompactCollector::AbandonEvacuationCandidatesAfterDeadline() {
+  const double deadline_in_ms = evacuation_deadline_in_ms_;
+  evacuation_deadline_in_ms_ = 0;
+  if (deadline_in_ms == 0 || !FLAG_idle_time_bounded_compaction) return;
+
+  // Used as long as there are no compaction speed samples.
+  const intptr_t kConservativeCompactionSpeedInBytesPerMs = 256 * KB;
+  intptr_t compaction_speed =
+      heap()->tracer()->CompactionSpeedInBytesPerMillisecond();
+  if (compaction_speed == 0) {
+    compaction_speed = kConservativeCompactionSpeedInBytesPerMs;
+  }
+  const double remaining_ms =
+      deadline_in_ms - heap()->MonotonicallyIncreasingTimeInMs();
+  const double budget_in_bytes = Max(0.0, remaining_ms) * compaction_speed;
+
+  intptr_t live_bytes = 0;
+  int abandoned_pages = 0;
+  for (Page* page : evacuation_candidates_) {
+    if (!page->IsEvacuationCandidate()) continue;
+    live_bytes += page->LiveBytes();
+    if (live_bytes > budget_in_bytes) {
+      AbandonEvacuationCandidate(page);
+      abandoned_pages++;
+    }
+  }
+  if (FLAG_trace_fragmentation && abandoned_pages > 0) {
+    PrintIsolate(isolate(),
+                 "%8.0f ms: compaction: abandoned=%d remaining_ms=%.1f "
+                 "compaction_speed=%" V8_PTR_PREFIX "d\n",
+                 isolate()->time_millis_since_init(), abandoned_pages,
+                 remaining_ms, compaction_speed);
+  }
+}
+
+
 void MarkCompactCollector::EvacuatePagesInParallel() {
   const int num_pages = evacuation_candidates_.length();
   if (num_pages == 0) return;
@@ -3231,7 +3342,7 @@ void MarkCompactCollector::EvacuatePagesInParallel() {
         p->Unlink();
         break;
       case MemoryChunk::kCompactingDone:
-        DCHECK(p->IsFlagSet(Page::POPULAR_PAGE));
+        // Popular or abandoned page.
         DCHECK(p->IsFlagSet(Page::RESCAN_ON_EVACUATION));
         break;
       default:
@@ -3600,6 +3711,7 @@ void MarkCompactCollector::EvacuateNewSpaceAndCandidates() {
     GCTracer::Scope gc_scope(heap()->tracer(),
                              GCTracer::Scope::MC_EVACUATE_CANDIDATES);
     EvacuationScope evacuation_scope(this);
+    AbandonEvacuationCandidatesAfterDeadline();
     EvacuatePagesInParallel();
   }
 
@@ -3621,6 +3733,10 @@ void MarkCompactCollector::EvacuateNewSpaceAndCandidates() {
     // ArrayBuffers either re-registers them as live or promotes them. This is
     // needed to properly free them.
     heap()->array_buffer_tracker()->FreeDead(false);
+    // Do not hold on to dead backing stores if the heap should shrink.
+    if (heap()->ShouldReduceMemory()) {
+      heap()->array_buffer_tracker()->FlushPool();
+    }
 
     // Deallocate evacuated candidate pages.
     ReleaseEvacuationCandidates();
@@ -3641,20 +3757,18 @@ void MarkCompactCollector::UpdatePointersAfterEvacuation() {
     GCTracer::Scope gc_scope(
         heap()->tracer(),
         GCTracer::Scope::MC_EVACUATE_UPDATE_POINTERS_TO_EVACUATED);
-    UpdateSlotsRecordedIn(migration_slots_buffer_);
+    // Evacuation of all pages has finished, so the slots buffers of the
+    // compaction tasks are complete.
+    evacuation_slots_buffers_.Add(migration_slots_buffer_);
+    migration_slots_buffer_ = NULL;
     if (FLAG_trace_fragmentation_verbose) {
       PrintF("  migration slots buffer: %d\n",
-             SlotsBuffer::SizeOfChain(migration_slots_buffer_));
+             SlotsBuffer::SizeOfChain(evacuation_slots_buffers_.last()));
     }
-    slots_buffer_allocator_->DeallocateChain(&migration_slots_buffer_);
-    DCHECK(migration_slots_buffer_ == NULL);
-
-    // TODO(hpayer): Process the slots buffers in parallel. This has to be done
-    // after evacuation of all pages finishes.
+    UpdateSlotsRecordedInParallel(evacuation_slots_buffers_);
     int buffers = evacuation_slots_buffers_.length();
     for (int i = 0; i < buffers; i++) {
       SlotsBuffer* buffer = evacuation_slots_buffers_[i];
-      UpdateSlotsRecordedIn(buffer);
       slots_buffer_allocator_->DeallocateChain(&buffer);
     }
     evacuation_slots_buffers_.Rewind(0);
@@ -3687,13 +3801,19 @@ void MarkCompactCollector::UpdatePointersAfterEvacuation() {
     GCTracer::Scope gc_scope(
         heap()->tracer(),
         GCTracer::Scope::MC_EVACUATE_UPDATE_POINTERS_BETWEEN_EVACUATED);
+    List<SlotsBuffer*> page_slots_buffers(npages);
+    for (int i = 0; i < npages; i++) {
+      Page* p = evacuation_candidates_[i];
+      if (p->IsEvacuationCandidate()) page_slots_buffers.Add(p->slots_buffer());
+    }
+    UpdateSlotsRecordedInParallel(page_slots_buffers);
+
     for (int i = 0; i < npages; i++) {
       Page* p = evacuation_candidates_[i];
       DCHECK(p->IsEvacuationCandidate() ||
              p->IsFlagSet(Page::RESCAN_ON_EVACUATION));
 
       if (p->IsEvacuationCandidate()) {
-        UpdateSlotsRecordedIn(p->slots_buffer());
         if (FLAG_trace_fragmentation_verbose) {
           PrintF("  page %p slots buffer: %d\n", reinterpret_cast<void*>(p),
                  SlotsBuffer::SizeOfChain(p->slots_buffer()));
@@ -4044,6 +4164,17 @@ void MarkCompactCollector::EvictPopularEvacuationCandidate(Page* page) {
 }
 
 
+void MarkCompactCollector::AbandonEvacuationCandidate(Page* page) {
+  slots_buffer_allocator_->DeallocateChain(page->slots_buffer_address());
+  page->ClearEvacuationCandidate();
+
+  // As for popular pages, slots on this page that point to other evacuation
+  // candidates were not recorded, so the page is rescanned after evacuation.
+  // Unlike popular pages, the page may be selected again by the next GC.
+  page->SetFlag(Page::RESCAN_ON_EVACUATION);
+}
+
+
 void MarkCompactCollector::RecordCodeEntrySlot(HeapObject* object, Address slot,
                                                Code* target) {
   Page* target_page = Page::FromAddress(reinterpret_cast<Address>(target));
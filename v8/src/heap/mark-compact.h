@@ -402,7 +402,6 @@ class MarkCompactCollector {
                               Object* target));
 
   void UpdateSlots(SlotsBuffer* buffer);
-  void UpdateSlotsRecordedIn(SlotsBuffer* buffer);
 
   void MigrateObject(HeapObject* dst, HeapObject* src, int size,
                      AllocationSpace to_old_space,
@@ -414,6 +413,14 @@ class MarkCompactCollector {
 
   bool is_compacting() const { return compacting_; }
 
+  // Bounds the evacuation of the next full GC by the given point in time on
+  // the heap's monotonic clock. Candidates that cannot be evacuated before the
+  // deadline are swept in place instead. A value of 0 means no deadline. The
+  // deadline is reset after each GC.
+  void set_evacuation_deadline_in_ms(double deadline_in_ms) {
+    evacuation_deadline_in_ms_ = deadline_in_ms;
+  }
+
   MarkingParity marking_parity() { return marking_parity_; }
 
   // Concurrent and parallel sweeping support. If required_freed_bytes was set
@@ -509,6 +516,7 @@ class MarkCompactCollector {
   class EvacuateOldSpaceVisitor;
   class EvacuateVisitorBase;
   class HeapObjectVisitor;
+  class PointersUpdatingTask;
   class SweeperTask;
 
   static const int kInitialLocalPretenuringFeedbackCapacity = 256;
@@ -517,6 +525,7 @@ class MarkCompactCollector {
 
   bool WillBeDeoptimized(Code* code);
   void EvictPopularEvacuationCandidate(Page* page);
+  void AbandonEvacuationCandidate(Page* page);
   void ClearInvalidStoreAndSlotsBufferEntries();
 
   void StartSweeperThreads();
@@ -711,6 +720,10 @@ class MarkCompactCollector {
 
   void EvacuatePagesInParallel();
 
+  // Abandons the evacuation candidates that are unlikely to be evacuated
+  // before evacuation_deadline_in_ms_, based on the traced compaction speed.
+  void AbandonEvacuationCandidatesAfterDeadline();
+
   // The number of parallel compaction tasks, including the main thread.
   int NumberOfParallelCompactionTasks();
 
@@ -723,6 +736,18 @@ class MarkCompactCollector {
 
   void UpdatePointersAfterEvacuation();
 
+  // Updates the slots recorded in the given slots buffer chains, handing out
+  // the buffers to parallel tasks. Returns once all slots have been updated.
+  // The chains are not deallocated.
+  void UpdateSlotsRecordedInParallel(const List<SlotsBuffer*>& chains);
+
+  // Updates the slots of the buffers in slots_buffers_to_update_ that have not
+  // been claimed by another task yet.
+  void UpdateUnclaimedSlotsBuffers();
+
+  // The number of parallel pointers updating tasks, including the main thread.
+  int NumberOfParallelPointersUpdatingTasks(int buffers);
+
   // Iterates through all live objects on a page using marking information.
   // Returns whether all objects have successfully been visited.
   bool VisitLiveObjects(MemoryChunk* page, HeapObjectVisitor* visitor,
@@ -789,6 +814,11 @@ class MarkCompactCollector {
   base::Mutex evacuation_slots_buffers_mutex_;
   List<SlotsBuffer*> evacuation_slots_buffers_;
 
+  // The slots buffers handed out to the pointers updating tasks, and the
+  // index of the next one to be claimed.
+  List<SlotsBuffer*> slots_buffers_to_update_;
+  AtomicNumber<intptr_t> next_slots_buffer_to_update_;
+
   base::SmartPointer<FreeList> free_list_old_space_;
   base::SmartPointer<FreeList> free_list_code_space_;
   base::SmartPointer<FreeList> free_list_map_space_;
@@ -803,12 +833,18 @@ class MarkCompactCollector {
   // True if parallel compaction is currently in progress.
   bool compaction_in_progress_;
 
+  // See set_evacuation_deadline_in_ms().
+  double evacuation_deadline_in_ms_;
+
   // Semaphore used to synchronize sweeper tasks.
   base::Semaphore pending_sweeper_tasks_semaphore_;
 
   // Semaphore used to synchronize compaction tasks.
   base::Semaphore pending_compaction_tasks_semaphore_;
 
+  // Semaphore used to synchronize pointers updating tasks.
+  base::Semaphore pending_pointers_updating_tasks_semaphore_;
+
   friend class Heap;
   friend class StoreBuffer;
 };
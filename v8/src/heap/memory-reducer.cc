@@ -4,7 +4,9 @@
 
 #include "src/heap/memory-reducer.h"
 
+#include "src/base/platform/time.h"
 #include "src/flags.h"
+#include "src/heap/gc-idle-time-handler.h"
 #include "src/heap/gc-tracer.h"
 #include "src/heap/heap-inl.h"
 #include "src/utils.h"
@@ -28,21 +30,29 @@ void MemoryReducer::TimerTask::RunInternal() {
   Heap* heap = memory_reducer_->heap();
   Event event;
   double time_ms = heap->MonotonicallyIncreasingTimeInMs();
+  bool long_idle_slot = memory_reducer_->last_long_idle_slot_ms_ > 0 &&
+                        memory_reducer_->last_long_idle_slot_ms_ >=
+                            memory_reducer_->js_calls_sample_time_ms_;
   heap->tracer()->SampleAllocation(time_ms, heap->NewSpaceAllocationCounter(),
                                    heap->OldGenerationAllocationCounter());
   double js_call_rate = memory_reducer_->SampleAndGetJsCallsPerMs(time_ms);
   bool low_allocation_rate = heap->HasLowAllocationRate();
-  bool is_idle = js_call_rate < kJsCallsPerMsThreshold && low_allocation_rate;
+  bool is_idle =
+      (js_call_rate < kJsCallsPerMsThreshold || long_idle_slot) &&
+      low_allocation_rate;
   bool optimize_for_memory = heap->ShouldOptimizeForMemoryUsage();
   if (FLAG_trace_gc_verbose) {
-    PrintIsolate(heap->isolate(), "Memory reducer: call rate %.3lf, %s, %s\n",
-                 js_call_rate, low_allocation_rate ? "low alloc" : "high alloc",
+    PrintIsolate(heap->isolate(),
+                 "Memory reducer: call rate %.3lf, %s, %s, %s\n", js_call_rate,
+                 long_idle_slot ? "long idle" : "short idle",
+                 low_allocation_rate ? "low alloc" : "high alloc",
                  optimize_for_memory ? "background" : "foreground");
   }
   event.type = kTimer;
   event.time_ms = time_ms;
   // The memory reducer will start incremental markig if
-  // 1) mutator is likely idle: js call rate is low and allocation rate is low.
+  // 1) mutator is likely idle: js call rate is low or the embedder granted
+  //    a long idle slot, and allocation rate is low.
   // 2) mutator is in background: optimize for memory flag is set.
   event.should_start_incremental_gc = is_idle || optimize_for_memory;
   event.can_start_incremental_gc =
@@ -52,6 +62,26 @@ void MemoryReducer::TimerTask::RunInternal() {
 }
 
 
+MemoryReducer::IdleTask::IdleTask(MemoryReducer* memory_reducer)
+    : CancelableIdleTask(memory_reducer->heap()->isolate()),
+      memory_reducer_(memory_reducer) {}
+
+
+void MemoryReducer::IdleTask::RunInternal(double deadline_in_seconds) {
+  Heap* heap = memory_reducer_->heap();
+  double deadline_in_ms =
+      deadline_in_seconds *
+      static_cast<double>(base::Time::kMillisecondsPerSecond);
+  double start_ms = heap->MonotonicallyIncreasingTimeInMs();
+  memory_reducer_->idle_task_pending_ = false;
+  if (deadline_in_ms - start_ms >= GCIdleTimeHandler::kMaxScheduledIdleTime) {
+    memory_reducer_->last_long_idle_slot_ms_ = start_ms;
+  }
+  heap->ReportIdleTaskUsage("Memory reducer idle task", start_ms,
+                            deadline_in_ms);
+}
+
+
 double MemoryReducer::SampleAndGetJsCallsPerMs(double time_ms) {
   unsigned int counter = heap()->isolate()->js_calls_from_api_counter();
   unsigned int call_delta = counter - js_calls_counter_;
@@ -204,10 +234,19 @@ void MemoryReducer::ScheduleTimer(double time_ms, double delay_ms) {
   auto timer_task = new MemoryReducer::TimerTask(this);
   V8::GetCurrentPlatform()->CallDelayedOnForegroundThread(
       isolate, timer_task, (delay_ms + kSlackMs) / 1000.0);
+  if (!idle_task_pending_ &&
+      V8::GetCurrentPlatform()->IdleTasksEnabled(isolate)) {
+    idle_task_pending_ = true;
+    auto idle_task = new MemoryReducer::IdleTask(this);
+    V8::GetCurrentPlatform()->CallIdleOnForegroundThread(isolate, idle_task);
+  }
 }
 
 
-void MemoryReducer::TearDown() { state_ = State(kDone, 0, 0, 0.0); }
+void MemoryReducer::TearDown() {
+  state_ = State(kDone, 0, 0, 0.0);
+  idle_task_pending_ = false;
+}
 
 }  // namespace internal
 }  // namespace v8
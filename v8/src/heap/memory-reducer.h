@@ -61,8 +61,10 @@ class Heap;
 //     - in the timer callback if n >= kMaxNumberOfGCs.
 //
 // WAIT n x t -> RUN (n+1) t happens:
-//     - in the timer callback if the mutator allocation rate is low
-//       and now_ms >= x and there is no incremental GC in progress.
+//     - in the timer callback if the mutator allocation rate is low, the
+//       mutator is idle (the js call rate is low or the embedder granted a
+//       long idle slot since the last timer event), now_ms >= x, and there
+//       is no incremental GC in progress.
 //     - in the timer callback if (now_ms - t > watchdog_delay_ms) and
 //       and now_ms >= x and there is no incremental GC in progress.
 // The MemoryReducer starts incremental marking on this transition.
@@ -110,7 +112,9 @@ class MemoryReducer {
       : heap_(heap),
         state_(kDone, 0, 0.0, 0.0),
         js_calls_counter_(0),
-        js_calls_sample_time_ms_(0.0) {}
+        js_calls_sample_time_ms_(0.0),
+        last_long_idle_slot_ms_(0.0),
+        idle_task_pending_(false) {}
   // Callbacks.
   void NotifyMarkCompact(const Event& event);
   void NotifyContextDisposed(const Event& event);
@@ -144,6 +148,20 @@ class MemoryReducer {
     DISALLOW_COPY_AND_ASSIGN(TimerTask);
   };
 
+  // Posted together with the timer task to observe whether the embedder
+  // grants long idle slots, which indicates that the mutator is idle even if
+  // it is driven by JS calls from the API.
+  class IdleTask : public v8::internal::CancelableIdleTask {
+   public:
+    explicit IdleTask(MemoryReducer* memory_reducer);
+
+   private:
+    // v8::internal::CancelableIdleTask overrides.
+    void RunInternal(double deadline_in_seconds) override;
+    MemoryReducer* memory_reducer_;
+    DISALLOW_COPY_AND_ASSIGN(IdleTask);
+  };
+
   void NotifyTimer(const Event& event);
 
   static bool WatchdogGC(const State& state, const Event& event);
@@ -155,6 +173,10 @@ class MemoryReducer {
   State state_;
   unsigned int js_calls_counter_;
   double js_calls_sample_time_ms_;
+  // Start of the last idle slot of at least
+  // GCIdleTimeHandler::kMaxScheduledIdleTime ms.
+  double last_long_idle_slot_ms_;
+  bool idle_task_pending_;
 
   // Used in cctest.
   friend class HeapTester;
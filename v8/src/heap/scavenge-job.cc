@@ -40,6 +40,7 @@ void ScavengeJob::IdleTask::RunInternal(double deadline_in_seconds) {
       job_->RescheduleIdleTask(heap);
     }
   }
+  heap->ReportIdleTaskUsage("Scavenge idle task", start_ms, deadline_in_ms);
 }
 
 
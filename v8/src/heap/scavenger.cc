@@ -4,13 +4,20 @@
 
 #include "src/heap/scavenger.h"
 
+#include "src/base/sys-info.h"
+#include "src/cancelable-task.h"
 #include "src/contexts.h"
+#include "src/hashmap.h"
+#include "src/heap/array-buffer-tracker.h"
 #include "src/heap/heap.h"
 #include "src/heap/objects-visiting-inl.h"
 #include "src/heap/scavenger-inl.h"
+#include "src/heap/spaces-inl.h"
+#include "src/heap/store-buffer-inl.h"
 #include "src/isolate.h"
 #include "src/log.h"
 #include "src/profiler/cpu-profiler.h"
+#include "src/v8.h"
 
 namespace v8 {
 namespace internal {
@@ -403,12 +410,16 @@ void Scavenger::ScavengeObjectSlow(HeapObject** p, HeapObject* object) {
 }
 
 
+bool Scavenger::IsLoggingAndProfiling() {
+  return FLAG_verify_predictable || isolate()->logger()->is_logging() ||
+         isolate()->cpu_profiler()->is_profiling() ||
+         (isolate()->heap_profiler() != NULL &&
+          isolate()->heap_profiler()->is_tracking_object_moves());
+}
+
+
 void Scavenger::SelectScavengingVisitorsTable() {
-  bool logging_and_profiling =
-      FLAG_verify_predictable || isolate()->logger()->is_logging() ||
-      isolate()->cpu_profiler()->is_profiling() ||
-      (isolate()->heap_profiler() != NULL &&
-       isolate()->heap_profiler()->is_tracking_object_moves());
+  bool logging_and_profiling = IsLoggingAndProfiling();
 
   if (!heap()->incremental_marking()->IsMarking()) {
     if (!logging_and_profiling) {
@@ -445,9 +456,396 @@ void Scavenger::SelectScavengingVisitorsTable() {
 }
 
 
+bool Scavenger::CanScavengeInParallel() {
+  return FLAG_parallel_scavenge &&
+         !heap()->incremental_marking()->IsMarking() &&
+         !IsLoggingAndProfiling();
+}
+
+
 Isolate* Scavenger::isolate() { return heap()->isolate(); }
 
 
+// Collects the root slots that point into new space instead of scavenging
+// them right away, so that they can be distributed over the scavenge tasks.
+class NewSpaceRootSlotsCollector : public ObjectVisitor {
+ public:
+  NewSpaceRootSlotsCollector(Heap* heap, List<Object**>* slots)
+      : heap_(heap), slots_(slots) {}
+
+  void VisitPointers(Object** start, Object** end) override {
+    for (Object** p = start; p < end; p++) {
+      if (heap_->InNewSpace(*p)) slots_->Add(p);
+    }
+  }
+
+ private:
+  Heap* heap_;
+  List<Object**>* slots_;
+};
+
+
+// The state owned by a single scavenge task: its allocation buffers, the
+// objects it copied but did not scan yet, and the results that are merged
+// into the heap by ParallelScavenger::Finalize.  As an ObjectVisitor it scans
+// the bodies of the objects it copied.
+class ParallelScavenger::TaskState : public ObjectVisitor {
+ public:
+  static const intptr_t kLabSize = 4 * KB;
+  static const int kMaxLabObjectSize = 256;
+  static const int kInitialLocalPretenuringFeedbackCapacity = 256;
+
+  explicit TaskState(ParallelScavenger* scavenger)
+      : scavenger_(scavenger),
+        heap_(scavenger->heap_),
+        new_space_buffer_(LocalAllocationBuffer::InvalidBuffer()),
+        old_space_buffer_(LocalAllocationBuffer::InvalidBuffer()),
+        local_pretenuring_feedback_(HashMap::PointersMatch,
+                                    kInitialLocalPretenuringFeedbackCapacity),
+        promoted_size_(0),
+        semispace_copied_size_(0),
+        record_slots_(false) {}
+
+  void ScavengeRootSlot(Object** p) {
+    Object* object = *p;
+    if (object->IsHeapObject() && heap_->InFromSpace(object)) {
+      *p = Evacuate(HeapObject::cast(object));
+    }
+  }
+
+  // Unlike root slots, a store buffer entry may be stale and point into memory
+  // that another task is promoting an object into at the same time.  The slot
+  // is therefore only updated if it still holds the value it was scavenged
+  // for, and it is recorded again only if that update happened.
+  void ScavengeOldToNewSlot(Address slot_address) {
+    base::AtomicWord* slot = reinterpret_cast<base::AtomicWord*>(slot_address);
+    Object* object = reinterpret_cast<Object*>(base::NoBarrier_Load(slot));
+    if (!object->IsHeapObject() || !heap_->InFromSpace(object)) return;
+    HeapObject* target = Evacuate(HeapObject::cast(object));
+    base::AtomicWord old_value = reinterpret_cast<base::AtomicWord>(object);
+    if (base::Release_CompareAndSwap(
+            slot, old_value, reinterpret_cast<base::AtomicWord>(target)) ==
+            old_value &&
+        heap_->InNewSpace(target)) {
+      surviving_slots_.Add(slot_address);
+    }
+  }
+
+  // Scans the copied objects until there are none left.
+  void ProcessCopiedObjects() {
+    while (!copied_objects_.is_empty()) {
+      HeapObject* target = copied_objects_.RemoveLast();
+      Map* map = target->map();
+      // Only slots in promoted objects have to be recorded.
+      record_slots_ = !heap_->InNewSpace(target);
+      target->IterateBody(map->instance_type(), target->SizeFromMap(map),
+                          this);
+    }
+  }
+
+  void CloseBuffers() {
+    new_space_buffer_ = LocalAllocationBuffer::InvalidBuffer();
+    old_space_buffer_ = LocalAllocationBuffer::InvalidBuffer();
+  }
+
+  void VisitPointers(Object** start, Object** end) override {
+    for (Object** p = start; p < end; p++) {
+      Object* object = *p;
+      if (!object->IsHeapObject() || !heap_->InNewSpace(object)) continue;
+      if (heap_->InFromSpace(object)) {
+        object = Evacuate(HeapObject::cast(object));
+        *p = object;
+      }
+      if (record_slots_ && heap_->InNewSpace(object)) {
+        surviving_slots_.Add(reinterpret_cast<Address>(p));
+      }
+    }
+  }
+
+  List<Address>* surviving_slots() { return &surviving_slots_; }
+  List<JSArrayBuffer*>* array_buffers() { return &array_buffers_; }
+  const HashMap& local_pretenuring_feedback() {
+    return local_pretenuring_feedback_;
+  }
+  intptr_t promoted_size() { return promoted_size_; }
+  intptr_t semispace_copied_size() { return semispace_copied_size_; }
+
+ private:
+  // Matches the alignment the serial visitors use for each object type.
+  static AllocationAlignment AlignmentFor(Map* map) {
+    InstanceType type = map->instance_type();
+    if (type == FIXED_DOUBLE_ARRAY_TYPE || type == FIXED_FLOAT64_ARRAY_TYPE) {
+      return kDoubleAligned;
+    }
+    return kWordAligned;
+  }
+
+  // Returns the copy of {object}, copying it if no other task did so yet.
+  HeapObject* Evacuate(HeapObject* object) {
+    MapWord map_word = object->synchronized_map_word();
+    if (map_word.IsForwardingAddress()) {
+      return map_word.ToForwardingAddress();
+    }
+    Map* map = map_word.ToMap();
+    DCHECK(map != heap_->allocation_memento_map());
+    int size = object->SizeFromMap(map);
+    AllocationAlignment alignment = AlignmentFor(map);
+
+    HeapObject* target = nullptr;
+    bool in_new_space = !heap_->ShouldBePromoted(object->address(), size) &&
+                        AllocateInNewSpace(size, alignment, &target);
+    if (!in_new_space && !AllocateInOldSpace(size, alignment, &target)) {
+      // If promotion failed, we try to copy the object to the other
+      // semi-space.
+      in_new_space = AllocateInNewSpace(size, alignment, &target);
+      if (!in_new_space) {
+        FatalProcessOutOfMemory("ParallelScavenger: semi-space copy\n");
+      }
+    }
+
+    heap_->CopyBlock(target->address(), object->address(), size);
+    target->set_map_word(MapWord::FromMap(map));
+    MapWord found = object->synchronized_compare_and_swap_map_word(
+        map_word, MapWord::FromForwardingAddress(target));
+    if (found.ToRawValue() != map_word.ToRawValue()) {
+      // Another task copied the object first.
+      heap_->CreateFillerObjectAt(target->address(), size);
+      return found.ToForwardingAddress();
+    }
+
+    heap_->UpdateAllocationSite(object, map, &local_pretenuring_feedback_);
+    if (V8_UNLIKELY(map->instance_type() == JS_ARRAY_BUFFER_TYPE)) {
+      array_buffers_.Add(JSArrayBuffer::cast(target));
+    }
+    if (in_new_space) {
+      semispace_copied_size_ += size;
+    } else {
+      promoted_size_ += size;
+    }
+    copied_objects_.Add(target);
+    return target;
+  }
+
+  bool AllocateInNewSpace(int size_in_bytes, AllocationAlignment alignment,
+                          HeapObject** target) {
+    AllocationResult allocation;
+    if (size_in_bytes > kMaxLabObjectSize) {
+      allocation = AllocateInNewSpaceSynchronized(size_in_bytes, alignment);
+    } else {
+      allocation = new_space_buffer_.AllocateRawAligned(size_in_bytes,
+                                                        alignment);
+      if (allocation.IsRetry() && NewLocalAllocationBuffer()) {
+        allocation = new_space_buffer_.AllocateRawAligned(size_in_bytes,
+                                                          alignment);
+      }
+    }
+    return allocation.To(target);
+  }
+
+  bool AllocateInOldSpace(int size_in_bytes, AllocationAlignment alignment,
+                          HeapObject** target) {
+    if (size_in_bytes <= kMaxLabObjectSize) {
+      AllocationResult allocation =
+          old_space_buffer_.AllocateRawAligned(size_in_bytes, alignment);
+      if (allocation.IsRetry()) {
+        old_space_buffer_ = LocalAllocationBuffer::FromResult(
+            heap_,
+            scavenger_->AllocateInOldSpaceSynchronized(kLabSize, kWordAligned),
+            kLabSize);
+        allocation =
+            old_space_buffer_.AllocateRawAligned(size_in_bytes, alignment);
+      }
+      if (allocation.To(target)) return true;
+    }
+    return scavenger_->AllocateInOldSpaceSynchronized(size_in_bytes, alignment)
+        .To(target);
+  }
+
+  bool NewLocalAllocationBuffer() {
+    AllocationResult result =
+        AllocateInNewSpaceSynchronized(kLabSize, kWordAligned);
+    LocalAllocationBuffer saved_old_buffer = new_space_buffer_;
+    new_space_buffer_ = LocalAllocationBuffer::FromResult(heap_, result,
+                                                          kLabSize);
+    if (new_space_buffer_.IsValid()) {
+      new_space_buffer_.TryMerge(&saved_old_buffer);
+      return true;
+    }
+    return false;
+  }
+
+  AllocationResult AllocateInNewSpaceSynchronized(
+      int size_in_bytes, AllocationAlignment alignment) {
+    NewSpace* new_space = heap_->new_space();
+    AllocationResult allocation =
+        new_space->AllocateRawSynchronized(size_in_bytes, alignment);
+    if (allocation.IsRetry() && new_space->AddFreshPageSynchronized()) {
+      allocation = new_space->AllocateRawSynchronized(size_in_bytes, alignment);
+    }
+    return allocation;
+  }
+
+  ParallelScavenger* scavenger_;
+  Heap* heap_;
+  LocalAllocationBuffer new_space_buffer_;
+  LocalAllocationBuffer old_space_buffer_;
+  List<HeapObject*> copied_objects_;
+  List<Address> surviving_slots_;
+  List<JSArrayBuffer*> array_buffers_;
+  HashMap local_pretenuring_feedback_;
+  intptr_t promoted_size_;
+  intptr_t semispace_copied_size_;
+  bool record_slots_;
+
+  DISALLOW_COPY_AND_ASSIGN(TaskState);
+};
+
+
+class ParallelScavenger::Task : public CancelableTask {
+ public:
+  Task(ParallelScavenger* scavenger, TaskState* state)
+      : CancelableTask(scavenger->heap_->isolate()),
+        scavenger_(scavenger),
+        state_(state) {}
+
+  virtual ~Task() {}
+
+ private:
+  // v8::internal::CancelableTask overrides.
+  void RunInternal() override {
+    scavenger_->Run(state_);
+    scavenger_->pending_tasks_semaphore_.Signal();
+  }
+
+  ParallelScavenger* scavenger_;
+  TaskState* state_;
+
+  DISALLOW_COPY_AND_ASSIGN(Task);
+};
+
+
+ParallelScavenger::ParallelScavenger(Heap* heap)
+    : heap_(heap),
+      pending_tasks_semaphore_(0),
+      task_states_(nullptr),
+      num_tasks_(0) {}
+
+
+ParallelScavenger::~ParallelScavenger() {
+  for (int i = 0; i < num_tasks_; i++) {
+    delete task_states_[i];
+  }
+  delete[] task_states_;
+}
+
+
+int ParallelScavenger::NumberOfTasks() {
+  int tasks = FLAG_parallel_scavenge_tasks > 0
+                  ? FLAG_parallel_scavenge_tasks
+                  : base::SysInfo::NumberOfProcessors();
+  // There is no point in starting tasks that cannot claim a chunk of slots.
+  int chunks = (root_slots_.length() + kSlotsPerChunk - 1) / kSlotsPerChunk +
+               (old_to_new_slots_.length() + kSlotsPerChunk - 1) /
+                   kSlotsPerChunk;
+  return Max(1, Min(Min(tasks, chunks), kMaxTasks));
+}
+
+
+void ParallelScavenger::ScavengeRootsAndOldToNewPointers() {
+  DCHECK(heap_->scavenge_collector_->CanScavengeInParallel());
+  NewSpaceRootSlotsCollector collector(heap_, &root_slots_);
+  heap_->IterateRoots(&collector, VISIT_ALL_IN_SCAVENGE);
+  heap_->store_buffer()->TakeEntries(&old_to_new_slots_);
+
+  num_tasks_ = NumberOfTasks();
+  task_states_ = new TaskState*[num_tasks_];
+  for (int i = 0; i < num_tasks_; i++) {
+    task_states_[i] = new TaskState(this);
+  }
+
+  uint32_t* task_ids = new uint32_t[num_tasks_];
+  for (int i = 1; i < num_tasks_; i++) {
+    Task* task = new Task(this, task_states_[i]);
+    task_ids[i - 1] = task->id();
+    V8::GetCurrentPlatform()->CallOnBackgroundThread(
+        task, v8::Platform::kShortRunningTask);
+  }
+
+  // Contribute in main thread.
+  Run(task_states_[0]);
+
+  // All slots have been claimed at this point.  Tasks that could be canceled
+  // did not claim any, the others have to be waited for.
+  for (int i = 0; i < num_tasks_ - 1; i++) {
+    if (!heap_->isolate()->cancelable_task_manager()->TryAbort(task_ids[i])) {
+      pending_tasks_semaphore_.Wait();
+    }
+  }
+  delete[] task_ids;
+}
+
+
+void ParallelScavenger::Run(TaskState* state) {
+  const intptr_t root_slots = root_slots_.length();
+  for (intptr_t end = next_root_slot_.Increment(kSlotsPerChunk);
+       end - kSlotsPerChunk < root_slots;
+       end = next_root_slot_.Increment(kSlotsPerChunk)) {
+    for (intptr_t i = end - kSlotsPerChunk; i < Min(end, root_slots); i++) {
+      state->ScavengeRootSlot(root_slots_[static_cast<int>(i)]);
+    }
+    state->ProcessCopiedObjects();
+  }
+
+  const intptr_t old_to_new_slots = old_to_new_slots_.length();
+  for (intptr_t end = next_old_to_new_slot_.Increment(kSlotsPerChunk);
+       end - kSlotsPerChunk < old_to_new_slots;
+       end = next_old_to_new_slot_.Increment(kSlotsPerChunk)) {
+    for (intptr_t i = end - kSlotsPerChunk; i < Min(end, old_to_new_slots);
+         i++) {
+      state->ScavengeOldToNewSlot(old_to_new_slots_[static_cast<int>(i)]);
+    }
+    state->ProcessCopiedObjects();
+  }
+
+  // Leave new space and old space iterable for the serial phases.
+  state->CloseBuffers();
+}
+
+
+AllocationResult ParallelScavenger::AllocateInOldSpaceSynchronized(
+    int size_in_bytes, AllocationAlignment alignment) {
+  base::LockGuard<base::Mutex> guard(&old_space_mutex_);
+  return heap_->old_space()->AllocateRaw(size_in_bytes, alignment);
+}
+
+
+void ParallelScavenger::Finalize() {
+  ArrayBufferTracker* tracker = heap_->array_buffer_tracker();
+  for (int i = 0; i < num_tasks_; i++) {
+    TaskState* state = task_states_[i];
+    List<Address>* slots = state->surviving_slots();
+    for (int j = 0; j < slots->length(); j++) {
+      heap_->store_buffer()->EnterDirectlyIntoStoreBuffer(slots->at(j));
+    }
+    List<JSArrayBuffer*>* buffers = state->array_buffers();
+    for (int j = 0; j < buffers->length(); j++) {
+      JSArrayBuffer* buffer = buffers->at(j);
+      if (!heap_->InNewSpace(buffer)) {
+        tracker->Promote(buffer);
+      } else if (!buffer->is_external()) {
+        tracker->MarkLive(buffer);
+      }
+    }
+    heap_->MergeAllocationSitePretenuringFeedback(
+        state->local_pretenuring_feedback());
+    heap_->IncrementPromotedObjectsSize(
+        static_cast<int>(state->promoted_size()));
+    heap_->IncrementSemiSpaceCopiedObjectSize(
+        static_cast<int>(state->semispace_copied_size()));
+  }
+}
+
+
 void ScavengeVisitor::VisitPointer(Object** p) { ScavengePointer(p); }
 
 
@@ -5,6 +5,9 @@
 #ifndef V8_HEAP_SCAVENGER_H_
 #define V8_HEAP_SCAVENGER_H_
 
+#include "src/atomic-utils.h"
+#include "src/base/platform/mutex.h"
+#include "src/base/platform/semaphore.h"
 #include "src/heap/objects-visiting.h"
 
 namespace v8 {
@@ -33,15 +36,72 @@ class Scavenger {
   // of the heap (i.e. incremental marking, logging and profiling).
   void SelectScavengingVisitorsTable();
 
+  // Returns true if the roots and old-to-new pointers can be processed by
+  // the {ParallelScavenger}, which neither transfers marks nor reports
+  // object moves.
+  bool CanScavengeInParallel();
+
   Isolate* isolate();
   Heap* heap() { return heap_; }
 
  private:
+  bool IsLoggingAndProfiling();
+
   Heap* heap_;
   VisitorDispatchTable<ScavengingCallback> scavenging_visitors_table_;
 };
 
 
+// Scavenges the roots and the old-to-new pointers, together with everything
+// reachable from them in new space, on several threads.  The slots are handed
+// out in chunks; an object is claimed by installing its forwarding address
+// with a compare-and-swap on the map word, copied into a task-local allocation
+// buffer and then scanned by the task that copied it.
+class ParallelScavenger {
+ public:
+  explicit ParallelScavenger(Heap* heap);
+  ~ParallelScavenger();
+
+  // Collects the slots and processes them on up to kMaxTasks tasks, one of
+  // which runs on the calling thread.  Returns once all tasks are done.
+  void ScavengeRootsAndOldToNewPointers();
+
+  // Re-enters the surviving old-to-new slots into the store buffer, which has
+  // to be rebuilding, and merges the per-task results into the heap.
+  void Finalize();
+
+  int num_tasks() const { return num_tasks_; }
+
+ private:
+  class Task;
+  class TaskState;
+
+  static const int kMaxTasks = 8;
+  static const int kSlotsPerChunk = 256;
+
+  int NumberOfTasks();
+
+  // Claims chunks of slots until none are left, processing everything that
+  // becomes reachable from each chunk before claiming the next one.
+  void Run(TaskState* state);
+
+  AllocationResult AllocateInOldSpaceSynchronized(int size_in_bytes,
+                                                  AllocationAlignment alignment);
+
+  Heap* heap_;
+  List<Object**> root_slots_;
+  List<Address> old_to_new_slots_;
+  AtomicNumber<intptr_t> next_root_slot_;
+  AtomicNumber<intptr_t> next_old_to_new_slot_;
+  base::Mutex old_space_mutex_;
+  base::Semaphore pending_tasks_semaphore_;
+  TaskState** task_states_;
+  int num_tasks_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelScavenger);
+};
+
+
 // Helper class for turning the scavenger into an object visitor that is also
 // filtering out non-HeapObjects and objects which do not reside in new space.
 class ScavengeVisitor : public ObjectVisitor {
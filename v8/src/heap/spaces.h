@@ -2586,6 +2586,10 @@ class InlineAllocationObserver {
   }
   virtual ~InlineAllocationObserver() {}
 
+ protected:
+  // Subclasses can override this method to make step size dynamic.
+  virtual intptr_t GetNextStepSize() { return step_size_; }
+
  private:
   intptr_t step_size() const { return step_size_; }
   intptr_t bytes_to_next_step() const { return bytes_to_next_step_; }
@@ -2613,6 +2617,7 @@ class InlineAllocationObserver {
     if (bytes_to_next_step_ <= 0) {
       Step(static_cast<int>(step_size_ - bytes_to_next_step_), soon_object,
            size);
+      step_size_ = GetNextStepSize();
       bytes_to_next_step_ = step_size_;
     }
   }
@@ -368,6 +368,15 @@ void StoreBuffer::IteratePointersInStoreBuffer(
 }
 
 
+void StoreBuffer::TakeEntries(List<Address>* slots) {
+  PrepareForIteration();
+  for (Address* current = old_start_; current < old_top_; current++) {
+    slots->Add(*current);
+  }
+  old_top_ = old_start_;
+}
+
+
 void StoreBuffer::ClearInvalidStoreBufferEntries() {
   Compact();
   Address* new_top = old_start_;
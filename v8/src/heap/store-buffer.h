@@ -58,6 +58,13 @@ class StoreBuffer {
   // surviving old-to-new pointers into the store buffer to rebuild it.
   void IteratePointersToNewSpace(ObjectSlotCallback callback);
 
+  // Moves the recorded slots out of the store buffer into {slots}, leaving
+  // the store buffer empty, so that they can be processed outside of it, e.g.
+  // by parallel scavenge tasks.  Slots on pages marked scan_on_scavenge are
+  // dropped; IteratePointersToNewSpace still has to be called afterwards to
+  // scan those pages.
+  void TakeEntries(List<Address>* slots);
+
   static const int kStoreBufferOverflowBit = 1 << (14 + kPointerSizeLog2);
   static const int kStoreBufferSize = kStoreBufferOverflowBit;
   static const int kStoreBufferLength = kStoreBufferSize / sizeof(Address);
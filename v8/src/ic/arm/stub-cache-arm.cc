@@ -143,15 +143,20 @@ void StubCache::GenerateProbe(MacroAssembler* masm, Code::Kind ic_kind,
   __ ldr(scratch, FieldMemOperand(name, Name::kHashFieldOffset));
   __ ldr(ip, FieldMemOperand(receiver, HeapObject::kMapOffset));
   __ add(scratch, scratch, Operand(ip));
-  uint32_t mask = kPrimaryTableSize - 1;
+  uint32_t mask = kMaxPrimaryTableSize - 1;
   // We shift out the last two bits because they are not part of the hash and
   // they are always 01 for maps.
   __ mov(scratch, Operand(scratch, LSR, kCacheIndexShift));
-  // Mask down the eor argument to the minimum to keep the immediate
-  // ARM-encodable.
+  // Mask down the eor argument as far as the largest table allows to keep
+  // the immediate small.
   __ eor(scratch, scratch, Operand((flags >> kCacheIndexShift) & mask));
-  // Prefer and_ to ubfx here because ubfx takes 2 cycles.
-  __ and_(scratch, scratch, Operand(mask));
+  // The masks depend on the current size of the tables and are scaled by
+  // 1 << kCacheIndexShift.
+  ExternalReference primary_mask(mask_reference(kPrimary));
+  ExternalReference secondary_mask(mask_reference(kSecondary));
+  __ mov(ip, Operand(primary_mask));
+  __ ldr(ip, MemOperand(ip));
+  __ and_(scratch, scratch, Operand(ip, LSR, kCacheIndexShift));
 
   // Probe the primary table.
   ProbeTable(isolate, masm, ic_kind, flags, kPrimary, receiver, name, scratch,
@@ -159,9 +164,11 @@ void StubCache::GenerateProbe(MacroAssembler* masm, Code::Kind ic_kind,
 
   // Primary miss: Compute hash for secondary probe.
   __ sub(scratch, scratch, Operand(name, LSR, kCacheIndexShift));
-  uint32_t mask2 = kSecondaryTableSize - 1;
+  uint32_t mask2 = kMaxSecondaryTableSize - 1;
   __ add(scratch, scratch, Operand((flags >> kCacheIndexShift) & mask2));
-  __ and_(scratch, scratch, Operand(mask2));
+  __ mov(ip, Operand(secondary_mask));
+  __ ldr(ip, MemOperand(ip));
+  __ and_(scratch, scratch, Operand(ip, LSR, kCacheIndexShift));
 
   // Probe the secondary table.
   ProbeTable(isolate, masm, ic_kind, flags, kSecondary, receiver, name, scratch,
@@ -136,8 +136,14 @@ void StubCache::GenerateProbe(MacroAssembler* masm, Code::Kind ic_kind,
   __ Add(scratch, scratch, extra);
   __ Eor(scratch, scratch, flags);
   // We shift out the last two bits because they are not part of the hash.
-  __ Ubfx(scratch, scratch, kCacheIndexShift,
-          CountTrailingZeros(kPrimaryTableSize, 64));
+  __ Lsr(scratch, scratch, kCacheIndexShift);
+  // The masks depend on the current size of the tables and are scaled by
+  // 1 << kCacheIndexShift.
+  ExternalReference primary_mask(mask_reference(kPrimary));
+  ExternalReference secondary_mask(mask_reference(kSecondary));
+  __ Mov(extra, primary_mask);
+  __ Ldr(extra.W(), MemOperand(extra));
+  __ And(scratch, scratch, Operand(extra, LSR, kCacheIndexShift));
 
   // Probe the primary table.
   ProbeTable(isolate, masm, ic_kind, flags, kPrimary, receiver, name, scratch,
@@ -146,7 +152,9 @@ void StubCache::GenerateProbe(MacroAssembler* masm, Code::Kind ic_kind,
   // Primary miss: Compute hash for secondary table.
   __ Sub(scratch, scratch, Operand(name, LSR, kCacheIndexShift));
   __ Add(scratch, scratch, flags >> kCacheIndexShift);
-  __ And(scratch, scratch, kSecondaryTableSize - 1);
+  __ Mov(extra, secondary_mask);
+  __ Ldr(extra.W(), MemOperand(extra));
+  __ And(scratch, scratch, Operand(extra, LSR, kCacheIndexShift));
 
   // Probe the secondary table.
   ProbeTable(isolate, masm, ic_kind, flags, kSecondary, receiver, name, scratch,
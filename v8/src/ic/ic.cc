@@ -88,12 +88,28 @@ const char* GetTransitionMarkModifier(KeyedAccessStoreMode mode) {
 
 
 void IC::TraceIC(const char* type, Handle<Object> name) {
-  if (FLAG_trace_ic) {
-    if (AddressIsDeoptimizedCode()) return;
-    State new_state =
-        UseVector() ? nexus()->StateFromFeedback() : raw_target()->ic_state();
-    TraceIC(type, name, state(), new_state);
+  if (AddressIsDeoptimizedCode()) return;
+  State new_state =
+      UseVector() ? nexus()->StateFromFeedback() : raw_target()->ic_state();
+  if (new_state != state()) {
+    switch (new_state) {
+      case MONOMORPHIC:
+        isolate()->set_ic_monomorphic_transitions(
+            isolate()->ic_monomorphic_transitions() + 1);
+        break;
+      case POLYMORPHIC:
+        isolate()->set_ic_polymorphic_transitions(
+            isolate()->ic_polymorphic_transitions() + 1);
+        break;
+      case MEGAMORPHIC:
+        isolate()->set_ic_megamorphic_transitions(
+            isolate()->ic_megamorphic_transitions() + 1);
+        break;
+      default:
+        break;
+    }
   }
+  if (FLAG_trace_ic) TraceIC(type, name, state(), new_state);
 }
 
 
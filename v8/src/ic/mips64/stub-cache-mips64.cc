@@ -142,12 +142,19 @@ void StubCache::GenerateProbe(MacroAssembler* masm, Code::Kind ic_kind,
   __ ld(scratch, FieldMemOperand(name, Name::kHashFieldOffset));
   __ ld(at, FieldMemOperand(receiver, HeapObject::kMapOffset));
   __ Daddu(scratch, scratch, at);
-  uint64_t mask = kPrimaryTableSize - 1;
+  uint64_t mask = kMaxPrimaryTableSize - 1;
   // We shift out the last two bits because they are not part of the hash and
   // they are always 01 for maps.
   __ dsrl(scratch, scratch, kCacheIndexShift);
   __ Xor(scratch, scratch, Operand((flags >> kCacheIndexShift) & mask));
-  __ And(scratch, scratch, Operand(mask));
+  // The masks depend on the current size of the tables and are scaled by
+  // 1 << kCacheIndexShift.
+  ExternalReference primary_mask(mask_reference(kPrimary));
+  ExternalReference secondary_mask(mask_reference(kSecondary));
+  __ li(at, Operand(primary_mask));
+  __ lw(at, MemOperand(at));
+  __ dsrl(at, at, kCacheIndexShift);
+  __ And(scratch, scratch, Operand(at));
 
   // Probe the primary table.
   ProbeTable(isolate, masm, ic_kind, flags, kPrimary, receiver, name, scratch,
@@ -156,9 +163,12 @@ void StubCache::GenerateProbe(MacroAssembler* masm, Code::Kind ic_kind,
   // Primary miss: Compute hash for secondary probe.
   __ dsrl(at, name, kCacheIndexShift);
   __ Dsubu(scratch, scratch, at);
-  uint64_t mask2 = kSecondaryTableSize - 1;
+  uint64_t mask2 = kMaxSecondaryTableSize - 1;
   __ Daddu(scratch, scratch, Operand((flags >> kCacheIndexShift) & mask2));
-  __ And(scratch, scratch, Operand(mask2));
+  __ li(at, Operand(secondary_mask));
+  __ lw(at, MemOperand(at));
+  __ dsrl(at, at, kCacheIndexShift);
+  __ And(scratch, scratch, Operand(at));
 
   // Probe the secondary table.
   ProbeTable(isolate, masm, ic_kind, flags, kSecondary, receiver, name, scratch,
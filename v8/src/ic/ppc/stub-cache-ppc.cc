@@ -162,8 +162,12 @@ void StubCache::GenerateProbe(MacroAssembler* masm, Code::Kind ic_kind,
   __ add(scratch, scratch, ip);
   __ xori(scratch, scratch, Operand(flags));
   // The mask omits the last two bits because they are not part of the hash.
-  __ andi(scratch, scratch,
-          Operand((kPrimaryTableSize - 1) << kCacheIndexShift));
+  // The masks depend on the current size of the tables.
+  ExternalReference primary_mask(mask_reference(kPrimary));
+  ExternalReference secondary_mask(mask_reference(kSecondary));
+  __ mov(ip, Operand(primary_mask));
+  __ lwz(ip, MemOperand(ip));
+  __ and_(scratch, scratch, ip);
 
   // Probe the primary table.
   ProbeTable(isolate, masm, ic_kind, flags, kPrimary, receiver, name, scratch,
@@ -172,8 +176,9 @@ void StubCache::GenerateProbe(MacroAssembler* masm, Code::Kind ic_kind,
   // Primary miss: Compute hash for secondary probe.
   __ sub(scratch, scratch, name);
   __ addi(scratch, scratch, Operand(flags));
-  __ andi(scratch, scratch,
-          Operand((kSecondaryTableSize - 1) << kCacheIndexShift));
+  __ mov(ip, Operand(secondary_mask));
+  __ lwz(ip, MemOperand(ip));
+  __ and_(scratch, scratch, ip);
 
   // Probe the secondary table.
   ProbeTable(isolate, masm, ic_kind, flags, kSecondary, receiver, name, scratch,
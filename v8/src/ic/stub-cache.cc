@@ -6,21 +6,81 @@
 
 #include "src/base/bits.h"
 #include "src/type-info.h"
+#include "src/v8.h"
 
 namespace v8 {
 namespace internal {
 
 
-StubCache::StubCache(Isolate* isolate) : isolate_(isolate) {}
+StubCache::StubCache(Isolate* isolate)
+    : reservation_((kMaxPrimaryTableSize + kMaxSecondaryTableSize) *
+                   sizeof(Entry)),
+      primary_(NULL),
+      secondary_(NULL),
+      primary_bits_(0),
+      secondary_bits_(0),
+      primary_size_(0),
+      secondary_size_(0),
+      primary_mask_(0),
+      secondary_mask_(0),
+      updates_(0),
+      evictions_(0),
+      evictions_since_clear_(0),
+      isolate_(isolate) {
+  if (!reservation_.IsReserved()) {
+    V8::FatalProcessOutOfMemory("StubCache::StubCache");
+  }
+  primary_ = reinterpret_cast<Entry*>(reservation_.address());
+  secondary_ = primary_ + kMaxPrimaryTableSize;
+  // The secondary table has to start on a page boundary to be committed
+  // separately.
+  DCHECK_EQ(0, static_cast<intptr_t>(kMaxPrimaryTableSize * sizeof(Entry)) %
+                   base::OS::CommitPageSize());
+}
+
+
+StubCache::~StubCache() {}
 
 
 void StubCache::Initialize() {
-  DCHECK(base::bits::IsPowerOfTwo32(kPrimaryTableSize));
-  DCHECK(base::bits::IsPowerOfTwo32(kSecondaryTableSize));
+  int primary_bits = Max(1, Min(FLAG_stub_cache_primary_bits,
+                                static_cast<int>(kMaxPrimaryTableBits)));
+  int secondary_bits = Max(1, Min(FLAG_stub_cache_secondary_bits,
+                                  static_cast<int>(kMaxSecondaryTableBits)));
+  Resize(primary_bits, secondary_bits);
   Clear();
 }
 
 
+void StubCache::Resize(int primary_bits, int secondary_bits) {
+  DCHECK(primary_bits >= primary_bits_ && secondary_bits >= secondary_bits_);
+  int primary_size = 1 << primary_bits;
+  int secondary_size = 1 << secondary_bits;
+  CommitEntries(primary_, primary_size_, primary_size);
+  CommitEntries(secondary_, secondary_size_, secondary_size);
+  primary_bits_ = primary_bits;
+  secondary_bits_ = secondary_bits;
+  primary_size_ = primary_size;
+  secondary_size_ = secondary_size;
+  primary_mask_ = (primary_size - 1) << kCacheIndexShift;
+  secondary_mask_ = (secondary_size - 1) << kCacheIndexShift;
+  DCHECK(base::bits::IsPowerOfTwo32(primary_size_));
+  DCHECK(base::bits::IsPowerOfTwo32(secondary_size_));
+}
+
+
+void StubCache::CommitEntries(Entry* table, int old_size, int size) {
+  size_t page_size = static_cast<size_t>(base::OS::CommitPageSize());
+  size_t committed = RoundUp(old_size * sizeof(Entry), page_size);
+  size_t needed = RoundUp(size * sizeof(Entry), page_size);
+  if (needed <= committed) return;
+  Address start = reinterpret_cast<Address>(table) + committed;
+  if (!reservation_.Commit(start, needed - committed, false)) {
+    V8::FatalProcessOutOfMemory("StubCache::CommitEntries");
+  }
+}
+
+
 static Code::Flags CommonStubCacheChecks(Name* name, Map* map,
                                          Code::Flags flags) {
   flags = Code::RemoveTypeAndHolderFromFlags(flags);
@@ -61,6 +121,10 @@ Code* StubCache::Set(Name* name, Map* map, Code* code) {
     int seed = PrimaryOffset(primary->key, old_flags, old_map);
     int secondary_offset = SecondaryOffset(primary->key, old_flags, seed);
     Entry* secondary = entry(secondary_, secondary_offset);
+    if (secondary->value != isolate_->builtins()->builtin(Builtins::kIllegal)) {
+      evictions_++;
+      evictions_since_clear_++;
+    }
     *secondary = *primary;
   }
 
@@ -68,6 +132,7 @@ Code* StubCache::Set(Name* name, Map* map, Code* code) {
   primary->key = name;
   primary->value = code;
   primary->map = map;
+  updates_++;
   isolate()->counters()->megamorphic_stub_cache_updates()->Increment();
   return code;
 }
@@ -90,13 +155,27 @@ Code* StubCache::Get(Name* name, Map* map, Code::Flags flags) {
 
 
 void StubCache::Clear() {
+  // Megamorphic accesses that keep evicting entries from the secondary table
+  // are not served by the cache, so give them more room.
+  if (FLAG_grow_stub_cache && evictions_since_clear_ >= secondary_size_ &&
+      (primary_bits_ < kMaxPrimaryTableBits ||
+       secondary_bits_ < kMaxSecondaryTableBits)) {
+    Resize(Min(primary_bits_ + 1, static_cast<int>(kMaxPrimaryTableBits)),
+           Min(secondary_bits_ + 1, static_cast<int>(kMaxSecondaryTableBits)));
+    if (FLAG_trace_ic) {
+      PrintF("[StubCache: growing to %d primary and %d secondary entries]\n",
+             primary_size_, secondary_size_);
+    }
+  }
+  evictions_since_clear_ = 0;
+
   Code* empty = isolate_->builtins()->builtin(Builtins::kIllegal);
-  for (int i = 0; i < kPrimaryTableSize; i++) {
+  for (int i = 0; i < primary_size_; i++) {
     primary_[i].key = isolate()->heap()->empty_string();
     primary_[i].map = NULL;
     primary_[i].value = empty;
   }
-  for (int j = 0; j < kSecondaryTableSize; j++) {
+  for (int j = 0; j < secondary_size_; j++) {
     secondary_[j].key = isolate()->heap()->empty_string();
     secondary_[j].map = NULL;
     secondary_[j].value = empty;
@@ -108,7 +187,7 @@ void StubCache::CollectMatchingMaps(SmallMapList* types, Handle<Name> name,
                                     Code::Flags flags,
                                     Handle<Context> native_context,
                                     Zone* zone) {
-  for (int i = 0; i < kPrimaryTableSize; i++) {
+  for (int i = 0; i < primary_size_; i++) {
     if (primary_[i].key == *name) {
       Map* map = primary_[i].map;
       // Map can be NULL, if the stub is constant function call
@@ -123,7 +202,7 @@ void StubCache::CollectMatchingMaps(SmallMapList* types, Handle<Name> name,
     }
   }
 
-  for (int i = 0; i < kSecondaryTableSize; i++) {
+  for (int i = 0; i < secondary_size_; i++) {
     if (secondary_[i].key == *name) {
       Map* map = secondary_[i].map;
       // Map can be NULL, if the stub is constant function call
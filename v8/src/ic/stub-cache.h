@@ -5,6 +5,7 @@
 #ifndef V8_STUB_CACHE_H_
 #define V8_STUB_CACHE_H_
 
+#include "src/base/platform/platform.h"
 #include "src/macro-assembler.h"
 
 namespace v8 {
@@ -15,6 +16,12 @@ namespace internal {
 // It maps (map, name, type) to property access handlers. The cache does not
 // need explicit invalidation when a prototype chain is modified, since the
 // handlers verify the chain.
+//
+// Both tables are reserved at their maximum size, but only the low
+// {primary,secondary}_size() entries of each are committed and used. The
+// generated probe code reads the masks from the stub cache, so the tables can
+// grow when megamorphic accesses keep evicting entries from the secondary
+// table. They only grow when the cache is cleared at a mark-compact GC.
 
 
 class SCTableReference {
@@ -38,11 +45,14 @@ class StubCache {
     Map* map;
   };
 
+  ~StubCache();
+
   void Initialize();
   // Access cache for entry hash(name, map).
   Code* Set(Name* name, Map* map, Code* code);
   Code* Get(Name* name, Map* map, Code::Flags flags);
-  // Clear the lookup table (@ mark compact collection).
+  // Clear the lookup table (@ mark compact collection). Grows the tables
+  // first if too many entries were evicted since the last clear.
   void Clear();
   // Collect all maps that match the name and flags.
   void CollectMatchingMaps(SmallMapList* types, Handle<Name> name,
@@ -74,6 +84,13 @@ class StubCache {
         reinterpret_cast<Address>(&first_entry(table)->value));
   }
 
+  // The mask of a table selects an entry offset as computed by PrimaryOffset
+  // and SecondaryOffset, i.e. it is scaled by 1 << kCacheIndexShift.
+  SCTableReference mask_reference(StubCache::Table table) {
+    return SCTableReference(reinterpret_cast<Address>(
+        table == kPrimary ? &primary_mask_ : &secondary_mask_));
+  }
+
   StubCache::Entry* first_entry(StubCache::Table table) {
     switch (table) {
       case StubCache::kPrimary:
@@ -87,6 +104,16 @@ class StubCache {
 
   Isolate* isolate() { return isolate_; }
 
+  int primary_size() const { return primary_size_; }
+  int secondary_size() const { return secondary_size_; }
+
+  // Number of handlers entered into the cache by the runtime, i.e. the number
+  // of probes that missed in generated code and were resolved by an IC miss.
+  size_t updates() const { return updates_; }
+
+  // Number of live secondary entries that were overwritten by an update.
+  size_t evictions() const { return evictions_; }
+
   // Setting the entry size such that the index is shifted by Name::kHashShift
   // is convenient; shifting down the length field (to extract the hash code)
   // automatically discards the hash bit field.
@@ -105,7 +132,7 @@ class StubCache {
   // Hash algorithm for the primary table.  This algorithm is replicated in
   // assembler for every architecture.  Returns an index into the table that
   // is scaled by 1 << kCacheIndexShift.
-  static int PrimaryOffset(Name* name, Code::Flags flags, Map* map) {
+  int PrimaryOffset(Name* name, Code::Flags flags, Map* map) {
     STATIC_ASSERT(kCacheIndexShift == Name::kHashShift);
     // Compute the hash of the name (use entire hash field).
     DCHECK(name->HasHashCode());
@@ -121,13 +148,13 @@ class StubCache {
         (static_cast<uint32_t>(flags) & ~Code::kFlagsNotUsedInLookup);
     // Base the offset on a simple combination of name, flags, and map.
     uint32_t key = (map_low32bits + field) ^ iflags;
-    return key & ((kPrimaryTableSize - 1) << kCacheIndexShift);
+    return key & primary_mask_;
   }
 
   // Hash algorithm for the secondary table.  This algorithm is replicated in
   // assembler for every architecture.  Returns an index into the table that
   // is scaled by 1 << kCacheIndexShift.
-  static int SecondaryOffset(Name* name, Code::Flags flags, int seed) {
+  int SecondaryOffset(Name* name, Code::Flags flags, int seed) {
     // Use the seed from the primary cache in the secondary cache.
     uint32_t name_low32bits =
         static_cast<uint32_t>(reinterpret_cast<uintptr_t>(name));
@@ -136,7 +163,7 @@ class StubCache {
     uint32_t iflags =
         (static_cast<uint32_t>(flags) & ~Code::kFlagsNotUsedInLookup);
     uint32_t key = (seed - name_low32bits) + iflags;
-    return key & ((kSecondaryTableSize - 1) << kCacheIndexShift);
+    return key & secondary_mask_;
   }
 
   // Compute the entry for a given offset in exactly the same way as
@@ -150,14 +177,34 @@ class StubCache {
                                     offset * multiplier);
   }
 
-  static const int kPrimaryTableBits = 11;
-  static const int kPrimaryTableSize = (1 << kPrimaryTableBits);
-  static const int kSecondaryTableBits = 9;
-  static const int kSecondaryTableSize = (1 << kSecondaryTableBits);
+  // Sets the number of entries of both tables and commits their memory.
+  void Resize(int primary_bits, int secondary_bits);
+
+  // Commits the memory for the first {size} entries of the given table,
+  // which has {old_size} entries committed.
+  void CommitEntries(Entry* table, int old_size, int size);
+
+  // The tables never grow beyond these sizes. Generated code masks the
+  // flags with the maximal masks, see GenerateProbe.
+  static const int kMaxPrimaryTableBits = 14;
+  static const int kMaxPrimaryTableSize = (1 << kMaxPrimaryTableBits);
+  static const int kMaxSecondaryTableBits = 12;
+  static const int kMaxSecondaryTableSize = (1 << kMaxSecondaryTableBits);
 
  private:
-  Entry primary_[kPrimaryTableSize];
-  Entry secondary_[kSecondaryTableSize];
+  base::VirtualMemory reservation_;
+  Entry* primary_;
+  Entry* secondary_;
+  int primary_bits_;
+  int secondary_bits_;
+  int primary_size_;
+  int secondary_size_;
+  // Read by generated code.
+  int primary_mask_;
+  int secondary_mask_;
+  size_t updates_;
+  size_t evictions_;
+  int evictions_since_clear_;
   Isolate* isolate_;
 
   friend class Isolate;
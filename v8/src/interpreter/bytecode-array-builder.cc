@@ -233,6 +233,12 @@ BytecodeArrayBuilder& BytecodeArrayBuilder::BinaryOperation(Token::Value op,
     UNIMPLEMENTED();
   }
 
+  // Ldar <src>; Add <reg> is common enough for a bytecode of its own.
+  if (op == Token::Value::ADD &&
+      FuseWithPreviousBytecode(Bytecode::kLdar, Bytecode::kLdarAdd,
+                               reg.ToOperand())) {
+    return *this;
+  }
   Output(BytecodeForBinaryOperation(op), reg.ToOperand());
   return *this;
 }
@@ -356,6 +362,10 @@ BytecodeArrayBuilder& BytecodeArrayBuilder::StoreAccumulatorInRegister(
   // TODO(oth): If the previous bytecode is a MOV into this register,
   // the previous instruction can be removed. The logic for determining
   // these redundant MOVs appears complex.
+  if (FuseWithPreviousBytecode(Bytecode::kLdaSmi8, Bytecode::kLdaSmi8Star,
+                               reg.ToOperand())) {
+    return *this;
+  }
   Output(Bytecode::kStar, reg.ToOperand());
   if (!IsRegisterInAccumulator(reg)) {
     Output(Bytecode::kStar, reg.ToOperand());
@@ -1283,11 +1293,38 @@ bool BytecodeArrayBuilder::IsRegisterInAccumulator(Register reg) {
         (reg == Register::FromOperand(previous_bytecode.GetOperand(0)))) {
       return true;
     }
+    if (bytecode == Bytecode::kLdaSmi8Star &&
+        (reg == Register::FromOperand(previous_bytecode.GetOperand(1)))) {
+      return true;
+    }
   }
   return false;
 }
 
 
+bool BytecodeArrayBuilder::FuseWithPreviousBytecode(Bytecode previous,
+                                                    Bytecode fused,
+                                                    uint32_t operand) {
+  if (!FLAG_ignition_fuse_bytecodes || exit_seen_in_block_ ||
+      !LastBytecodeInSameBlock()) {
+    return false;
+  }
+  PreviousBytecodeHelper previous_bytecode(*this);
+  if (previous_bytecode.GetBytecode() != previous) return false;
+
+  // The fused bytecode takes the operands of |previous| followed by a single
+  // byte-sized |operand|.
+  int operand_index = Bytecodes::NumberOfOperands(previous);
+  DCHECK_EQ(operand_index + 1, Bytecodes::NumberOfOperands(fused));
+  DCHECK_EQ(Bytecodes::Size(previous) + 1, Bytecodes::Size(fused));
+  DCHECK(Bytecodes::GetOperandSize(fused, operand_index) == OperandSize::kByte);
+  DCHECK(OperandIsValid(fused, operand_index, operand));
+  bytecodes()->at(last_bytecode_start_) = Bytecodes::ToByte(fused);
+  bytecodes()->push_back(static_cast<uint8_t>(operand));
+  return true;
+}
+
+
 // static
 Bytecode BytecodeArrayBuilder::BytecodeForBinaryOperation(Token::Value op) {
   switch (op) {
@@ -301,6 +301,12 @@ class BytecodeArrayBuilder final {
   bool NeedToBooleanCast();
   bool IsRegisterInAccumulator(Register reg);
 
+  // Replaces the previous bytecode with |fused| if it is |previous| and in the
+  // same basic block, appending |operand| as the last operand of |fused|.
+  // Returns true if the bytecodes were fused.
+  bool FuseWithPreviousBytecode(Bytecode previous, Bytecode fused,
+                                uint32_t operand);
+
   bool RegisterIsValid(Register reg) const;
 
   // Temporary register management.
@@ -84,6 +84,10 @@ namespace interpreter {
   V(Ldar, OperandType::kReg8)                                                  \
   V(Star, OperandType::kReg8)                                                  \
                                                                                \
+  /* Fused bytecodes */                                                        \
+  V(LdaSmi8Star, OperandType::kImm8, OperandType::kReg8)                       \
+  V(LdarAdd, OperandType::kReg8, OperandType::kReg8)                           \
+                                                                               \
   /* Register-register transfers */                                            \
   V(Mov, OperandType::kReg8, OperandType::kReg8)                               \
   V(Exchange, OperandType::kReg8, OperandType::kReg16)                         \
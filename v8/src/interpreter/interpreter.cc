@@ -4,6 +4,10 @@
 
 #include "src/interpreter/interpreter.h"
 
+#include <algorithm>
+#include <iomanip>
+#include <vector>
+
 #include "src/code-factory.h"
 #include "src/compiler.h"
 #include "src/compiler/interpreter-assembler.h"
@@ -22,7 +26,19 @@ using compiler::Node;
 
 
 Interpreter::Interpreter(Isolate* isolate)
-    : isolate_(isolate) {}
+    : isolate_(isolate) {
+  // Handlers which count their dispatches refer to the counters by address,
+  // so they cannot be put into a snapshot.
+  if (FLAG_trace_bytecode_pairs && !isolate->serializer_enabled()) {
+    size_t size = kNumberOfBytecodes * kNumberOfBytecodes;
+    bytecode_dispatch_counters_table_.Reset(new uintptr_t[size]);
+    memset(bytecode_dispatch_counters_table_.get(), 0,
+           sizeof(uintptr_t) * size);
+  }
+}
+
+
+Interpreter::~Interpreter() {}
 
 
 // static
@@ -41,7 +57,10 @@ Handle<FixedArray> Interpreter::CreateUninitializedInterpreterTable(
 void Interpreter::Initialize() {
   DCHECK(FLAG_ignition);
   Handle<FixedArray> handler_table = isolate_->factory()->interpreter_table();
-  if (!IsInterpreterTableInitialized(handler_table)) {
+  // The handlers in the snapshot do not count their dispatches, so they are
+  // regenerated when tracing bytecode pairs.
+  if (!IsInterpreterTableInitialized(handler_table) ||
+      bytecode_dispatch_counters_table() != NULL) {
     Zone zone;
     HandleScope scope(isolate_);
 
@@ -76,6 +95,44 @@ bool Interpreter::MakeBytecode(CompilationInfo* info) {
 }
 
 
+void Interpreter::PrintDispatchCounters() {
+  uintptr_t* counters = bytecode_dispatch_counters_table();
+  if (counters == NULL) return;
+
+  struct Pair {
+    uintptr_t count;
+    int from;
+    int to;
+  };
+  std::vector<Pair> pairs;
+  uintptr_t total = 0;
+  for (int from = 0; from < kNumberOfBytecodes; from++) {
+    for (int to = 0; to < kNumberOfBytecodes; to++) {
+      uintptr_t count = counters[from * kNumberOfBytecodes + to];
+      if (count == 0) continue;
+      Pair pair = {count, from, to};
+      pairs.push_back(pair);
+      total += count;
+    }
+  }
+  std::sort(pairs.begin(), pairs.end(), [](const Pair& a, const Pair& b) {
+    return a.count > b.count;
+  });
+
+  static const size_t kMaxPrintedPairs = 50;
+  OFStream os(stdout);
+  os << "Bytecode dispatch pairs (" << total << " dispatches):" << std::endl;
+  for (size_t i = 0; i < pairs.size() && i < kMaxPrintedPairs; i++) {
+    const Pair& pair = pairs[i];
+    os << std::setw(12) << pair.count << std::setw(7) << std::fixed
+       << std::setprecision(2) << (100.0 * pair.count / total) << "%  "
+       << Bytecodes::ToString(Bytecodes::FromByte(pair.from)) << " -> "
+       << Bytecodes::ToString(Bytecodes::FromByte(pair.to)) << std::endl;
+  }
+  os << std::flush;
+}
+
+
 bool Interpreter::IsInterpreterTableInitialized(
     Handle<FixedArray> handler_table) {
   DCHECK(handler_table->length() == static_cast<int>(Bytecode::kLast) + 1);
@@ -201,6 +258,35 @@ void Interpreter::DoStar(compiler::InterpreterAssembler* assembler) {
 }
 
 
+// LdaSmi8Star <imm8> <dst>
+//
+// Load an 8-bit integer literal into the accumulator as a Smi and store it to
+// register <dst>. Equivalent to LdaSmi8 <imm8>; Star <dst>.
+void Interpreter::DoLdaSmi8Star(compiler::InterpreterAssembler* assembler) {
+  Node* raw_int = __ BytecodeOperandImm(0);
+  Node* smi_int = __ SmiTag(raw_int);
+  Node* reg_index = __ BytecodeOperandReg(1);
+  __ StoreRegister(smi_int, reg_index);
+  __ SetAccumulator(smi_int);
+  __ Dispatch();
+}
+
+
+// LdarAdd <src> <reg>
+//
+// Load register <src> into the accumulator and add register <reg> to it.
+// Equivalent to Ldar <src>; Add <reg>.
+void Interpreter::DoLdarAdd(compiler::InterpreterAssembler* assembler) {
+  Node* src_index = __ BytecodeOperandReg(0);
+  Node* rhs = __ LoadRegister(src_index);
+  Node* reg_index = __ BytecodeOperandReg(1);
+  Node* lhs = __ LoadRegister(reg_index);
+  Node* result = __ CallRuntime(Runtime::kAdd, lhs, rhs);
+  __ SetAccumulator(result);
+  __ Dispatch();
+}
+
+
 // Exchange <reg8> <reg16>
 //
 // Exchange two registers.
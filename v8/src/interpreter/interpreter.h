@@ -9,6 +9,7 @@
 // Do not include anything from src/interpreter other than
 // src/interpreter/bytecodes.h here!
 #include "src/base/macros.h"
+#include "src/base/smart-pointers.h"
 #include "src/builtins.h"
 #include "src/interpreter/bytecodes.h"
 #include "src/parsing/token.h"
@@ -30,7 +31,7 @@ namespace interpreter {
 class Interpreter {
  public:
   explicit Interpreter(Isolate* isolate);
-  virtual ~Interpreter() {}
+  virtual ~Interpreter();
 
   // Creates an uninitialized interpreter handler table, where each handler
   // points to the Illegal builtin.
@@ -43,6 +44,17 @@ class Interpreter {
   // Generate bytecode for |info|.
   static bool MakeBytecode(CompilationInfo* info);
 
+  // Prints the most frequent dispatches between pairs of bytecodes, as
+  // counted when --trace-bytecode-pairs is enabled.
+  void PrintDispatchCounters();
+
+  // Returns the table of dispatch counters, indexed by
+  // from_bytecode * (Bytecode::kLast + 1) + to_bytecode, or NULL if the
+  // dispatches are not counted.
+  uintptr_t* bytecode_dispatch_counters_table() {
+    return bytecode_dispatch_counters_table_.get();
+  }
+
  private:
 // Bytecode handler generator functions.
 #define DECLARE_BYTECODE_HANDLER_GENERATOR(Name, ...) \
@@ -105,7 +117,10 @@ class Interpreter {
 
   bool IsInterpreterTableInitialized(Handle<FixedArray> handler_table);
 
+  static const int kNumberOfBytecodes = static_cast<int>(Bytecode::kLast) + 1;
+
   Isolate* isolate_;
+  base::SmartArrayPointer<uintptr_t> bytecode_dispatch_counters_table_;
 
   DISALLOW_COPY_AND_ASSIGN(Interpreter);
 };
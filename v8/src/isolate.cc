@@ -26,6 +26,7 @@
 #include "src/ic/stub-cache.h"
 #include "src/interpreter/interpreter.h"
 #include "src/isolate-inl.h"
+#include "src/lazy-compile-dispatcher.h"
 #include "src/log.h"
 #include "src/messages.h"
 #include "src/profiler/cpu-profiler.h"
@@ -1777,6 +1778,7 @@ Isolate::Isolate(bool enable_serializer)
       function_entry_hook_(NULL),
       deferred_handles_head_(NULL),
       optimizing_compile_dispatcher_(NULL),
+      lazy_compile_dispatcher_(NULL),
       stress_deopt_count_(0),
       virtual_handler_register_(NULL),
       virtual_slot_register_(NULL),
@@ -1885,6 +1887,12 @@ void Isolate::Deinit() {
     optimizing_compile_dispatcher_ = NULL;
   }
 
+  if (lazy_compile_dispatcher_enabled()) {
+    lazy_compile_dispatcher_->Stop();
+    delete lazy_compile_dispatcher_;
+    lazy_compile_dispatcher_ = NULL;
+  }
+
   if (heap_.mark_compact_collector()->sweeping_in_progress()) {
     heap_.mark_compact_collector()->EnsureSweepingCompleted();
   }
@@ -1903,6 +1911,7 @@ void Isolate::Deinit() {
   Sampler* sampler = logger_->sampler();
   if (sampler && sampler->IsActive()) sampler->Stop();
 
+  if (FLAG_trace_bytecode_pairs) interpreter_->PrintDispatchCounters();
   delete interpreter_;
   interpreter_ = NULL;
 
@@ -2192,6 +2201,10 @@ bool Isolate::Init(Deserializer* des) {
     optimizing_compile_dispatcher_ = new OptimizingCompileDispatcher(this);
   }
 
+  if (LazyCompileDispatcher::Enabled()) {
+    lazy_compile_dispatcher_ = new LazyCompileDispatcher(this);
+  }
+
   // Initialize runtime profiler before deserialization, because collections may
   // occur, clearing/updating ICs.
   runtime_profiler_ = new RuntimeProfiler(this);
@@ -2370,6 +2383,13 @@ void Isolate::DumpAndResetCompilationStats() {
   if (turbo_statistics() != nullptr) {
     OFStream os(stdout);
     os << *turbo_statistics() << std::endl;
+    ZoneSegmentPool::Statistics segments;
+    ZoneSegmentPool::GetStatistics(&segments);
+    os << "Zone segments: " << segments.allocated_segments << " allocated, "
+       << segments.reused_segments << " reused from the pool, "
+       << segments.thread_cache_reused_segments
+       << " reused from thread caches, " << segments.max_pooled_bytes
+       << " bytes pooled at most" << std::endl;
   }
   if (hstatistics() != nullptr) hstatistics()->Print();
   delete turbo_statistics_;
@@ -64,6 +64,7 @@ class HStatistics;
 class HTracer;
 class InlineRuntimeFunctionsTable;
 class InnerPointerToCodeCache;
+class LazyCompileDispatcher;
 class Logger;
 class MaterializedObjectStore;
 class CodeAgingHelper;
@@ -387,6 +388,10 @@ typedef List<HeapObject*> DebugObjectCache;
   V(uint32_t, per_isolate_assert_data, 0xFFFFFFFFu)                            \
   V(PromiseRejectCallback, promise_reject_callback, NULL)                      \
   V(const v8::StartupData*, snapshot_blob, NULL)                               \
+  /* IC state transitions, counted by IC::TraceIC. */                          \
+  V(size_t, ic_monomorphic_transitions, 0)                                     \
+  V(size_t, ic_polymorphic_transitions, 0)                                     \
+  V(size_t, ic_megamorphic_transitions, 0)                                     \
   ISOLATE_INIT_SIMULATOR_LIST(V)
 
 #define THREAD_LOCAL_TOP_ACCESSOR(type, name)                        \
@@ -1005,6 +1010,16 @@ class Isolate {
     return optimizing_compile_dispatcher_;
   }
 
+  bool lazy_compile_dispatcher_enabled() const {
+    // Dispatcher is only available with flag enabled.
+    DCHECK(lazy_compile_dispatcher_ == NULL || FLAG_lazy_compile_dispatcher);
+    return lazy_compile_dispatcher_ != NULL;
+  }
+
+  LazyCompileDispatcher* lazy_compile_dispatcher() {
+    return lazy_compile_dispatcher_;
+  }
+
   int id() const { return static_cast<int>(id_); }
 
   HStatistics* GetHStatistics();
@@ -1300,6 +1315,7 @@ class Isolate {
 
   DeferredHandles* deferred_handles_head_;
   OptimizingCompileDispatcher* optimizing_compile_dispatcher_;
+  LazyCompileDispatcher* lazy_compile_dispatcher_;
 
   // Counts deopt points if deopt_every_n_times is enabled.
   unsigned int stress_deopt_count_;
@@ -1347,6 +1363,8 @@ class Isolate {
   friend class v8::Locker;
   friend class v8::Unlocker;
   friend v8::StartupData v8::V8::CreateSnapshotDataBlob(const char*);
+  friend v8::StartupData v8::V8::WarmUpSnapshotDataBlob(v8::StartupData,
+                                                       const char*);
 
   DISALLOW_COPY_AND_ASSIGN(Isolate);
 };
@@ -0,0 +1,257 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/lazy-compile-dispatcher.h"
+
+#include "src/debug/debug.h"
+#include "src/global-handles.h"
+#include "src/isolate.h"
+#include "src/parsing/scanner-character-streams.h"
+#include "src/v8.h"
+
+namespace v8 {
+namespace internal {
+
+LazyParseJob::LazyParseJob(Isolate* isolate, Handle<JSFunction> function)
+    : isolate_(isolate),
+      parse_info_(&zone_),
+      name_(NULL),
+      kind_(function->shared()->kind()),
+      literal_(NULL) {
+  GlobalHandles* global_handles = isolate->global_handles();
+  Handle<SharedFunctionInfo> shared(function->shared(), isolate);
+  shared_ = Handle<SharedFunctionInfo>::cast(global_handles->Create(*shared));
+  script_ = Handle<Script>::cast(global_handles->Create(shared->script()));
+
+  parse_info_.set_isolate(isolate);
+  parse_info_.set_lazy();
+  parse_info_.set_script(script_);
+  parse_info_.set_hash_seed(isolate->heap()->HashSeed());
+  parse_info_.set_unicode_cache(&unicode_cache_);
+  parse_info_.set_language_mode(shared->language_mode());
+  parse_info_.set_allow_lazy_parsing(true);
+  // The AST value factory is created here instead of by the parser, so that
+  // the function name can be added to it on the main thread.
+  parse_info_.set_ast_value_factory(
+      new AstValueFactory(&zone_, parse_info_.hash_seed()));
+  parse_info_.set_ast_value_factory_owned();
+
+  Handle<String> name(String::cast(shared->name()), isolate);
+  name_ = parse_info_.ast_value_factory()->GetString(name);
+  function_type_ = shared->is_expression()
+                       ? (shared->is_anonymous()
+                              ? FunctionLiteral::kAnonymousExpression
+                              : FunctionLiteral::kNamedExpression)
+                       : FunctionLiteral::kDeclaration;
+
+  Handle<String> source(String::cast(script_->source()), isolate);
+  source = String::Flatten(source);
+  source_.Reset(new CopiedStringUtf16CharacterStream(
+      source, shared->start_position(), shared->end_position()));
+}
+
+
+LazyParseJob::~LazyParseJob() {
+  GlobalHandles::Destroy(Handle<Object>::cast(shared_).location());
+  GlobalHandles::Destroy(Handle<Object>::cast(script_).location());
+}
+
+
+void LazyParseJob::Parse(uintptr_t stack_limit) {
+  DisallowHeapAllocation no_allocation;
+  DisallowHandleAllocation no_handles;
+  DisallowHandleDereference no_deref;
+
+  DCHECK(parser_.is_empty());
+  parse_info_.set_stack_limit(stack_limit);
+  // The parser reads the stack limit on construction, so it has to be created
+  // on the thread that does the parsing.
+  parser_.Reset(new Parser(&parse_info_));
+  literal_ = parser_->ParseLazyOnBackground(&parse_info_, source_.get(), name_,
+                                            kind_, function_type_);
+}
+
+
+bool LazyParseJob::Finalize(ParseInfo* info) {
+  DCHECK(!parser_.is_empty());
+  DCHECK(info->literal() == NULL);
+  DCHECK(*info->shared_info() == *shared_);
+  parser_->Internalize(isolate_, info->script(), literal_ == NULL);
+  if (literal_ == NULL) return false;
+  literal_->set_inferred_name(handle(shared_->inferred_name(), isolate_));
+
+  // The parse info does not take ownership of the AST value factory.
+  info->set_ast_value_factory(parse_info_.ast_value_factory());
+  info->set_script_scope(parse_info_.script_scope());
+  info->set_literal(literal_);
+  info->set_language_mode(literal_->language_mode());
+  return true;
+}
+
+
+class LazyCompileDispatcher::ParseTask : public v8::Task {
+ public:
+  explicit ParseTask(LazyCompileDispatcher* dispatcher)
+      : dispatcher_(dispatcher) {
+    base::LockGuard<base::Mutex> lock_guard(&dispatcher_->mutex_);
+    ++dispatcher_->ref_count_;
+  }
+
+  virtual ~ParseTask() {}
+
+ private:
+  // v8::Task overrides.
+  void Run() override {
+    LazyParseJob* job = dispatcher_->NextQueuedJob();
+    if (job != NULL) {
+      uintptr_t stack_limit = reinterpret_cast<uintptr_t>(&stack_limit) -
+                              dispatcher_->stack_size_ * KB;
+      job->Parse(stack_limit);
+      dispatcher_->JobDone(job);
+    }
+    {
+      base::LockGuard<base::Mutex> lock_guard(&dispatcher_->mutex_);
+      if (--dispatcher_->ref_count_ == 0) {
+        dispatcher_->ref_count_zero_.NotifyOne();
+      }
+    }
+  }
+
+  LazyCompileDispatcher* dispatcher_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParseTask);
+};
+
+
+LazyCompileDispatcher::LazyCompileDispatcher(Isolate* isolate)
+    : isolate_(isolate),
+      max_jobs_(FLAG_lazy_compile_dispatcher_queue_length),
+      stack_size_(FLAG_stack_size),
+      ref_count_(0),
+      stopped_(false) {}
+
+
+LazyCompileDispatcher::~LazyCompileDispatcher() {
+#ifdef DEBUG
+  {
+    base::LockGuard<base::Mutex> lock_guard(&mutex_);
+    DCHECK_EQ(0, ref_count_);
+  }
+#endif
+  DCHECK(jobs_.is_empty());
+}
+
+
+bool LazyCompileDispatcher::CanParseOnBackground(JSFunction* function) {
+  if (!function->context()->IsNativeContext()) return false;
+  SharedFunctionInfo* shared = function->shared();
+  if (shared->is_compiled() || !shared->allows_lazy_compilation()) {
+    return false;
+  }
+  if (shared->is_arrow() || shared->is_default_constructor() ||
+      shared->native() || !shared->name()->IsString()) {
+    return false;
+  }
+  if (!shared->script()->IsScript()) return false;
+  Script* script = Script::cast(shared->script());
+  if (script->type() != Script::TYPE_NORMAL ||
+      script->compilation_type() != Script::COMPILATION_TYPE_HOST ||
+      !script->source()->IsString()) {
+    return false;
+  }
+  // The debugger may change or instrument the source.
+  if (isolate_->debug()->is_active()) return false;
+  // Natives syntax and parse tracing make the parser internalize eagerly,
+  // which cannot be done on a background thread.
+  return !FLAG_allow_natives_syntax && !FLAG_trace_parse;
+}
+
+
+int LazyCompileDispatcher::FindEntry(SharedFunctionInfo* shared) {
+  for (int i = 0; i < jobs_.length(); i++) {
+    if (*jobs_[i].job->shared() == shared) return i;
+  }
+  return -1;
+}
+
+
+void LazyCompileDispatcher::QueueForParsing(Handle<JSFunction> function) {
+  if (!CanParseOnBackground(*function)) return;
+  {
+    base::LockGuard<base::Mutex> lock_guard(&mutex_);
+    if (stopped_ || jobs_.length() >= max_jobs_) return;
+    if (FindEntry(function->shared()) != -1) return;
+  }
+  // Preparing the job allocates, so it is done outside of the lock.
+  Entry entry = {new LazyParseJob(isolate_, function), kQueued};
+  {
+    base::LockGuard<base::Mutex> lock_guard(&mutex_);
+    jobs_.Add(entry);
+  }
+  V8::GetCurrentPlatform()->CallOnBackgroundThread(
+      new ParseTask(this), v8::Platform::kShortRunningTask);
+}
+
+
+LazyParseJob* LazyCompileDispatcher::NextQueuedJob() {
+  base::LockGuard<base::Mutex> lock_guard(&mutex_);
+  if (stopped_) return NULL;
+  for (int i = 0; i < jobs_.length(); i++) {
+    if (jobs_[i].status == kQueued) {
+      jobs_[i].status = kRunning;
+      return jobs_[i].job;
+    }
+  }
+  return NULL;
+}
+
+
+void LazyCompileDispatcher::JobDone(LazyParseJob* job) {
+  base::LockGuard<base::Mutex> lock_guard(&mutex_);
+  for (int i = 0; i < jobs_.length(); i++) {
+    if (jobs_[i].job == job) {
+      DCHECK_EQ(kRunning, jobs_[i].status);
+      jobs_[i].status = kDone;
+      break;
+    }
+  }
+  job_done_.NotifyAll();
+}
+
+
+LazyParseJob* LazyCompileDispatcher::TakeParsedJob(
+    Handle<SharedFunctionInfo> shared) {
+  LazyParseJob* job = NULL;
+  bool parse_here = false;
+  {
+    base::LockGuard<base::Mutex> lock_guard(&mutex_);
+    int index = FindEntry(*shared);
+    if (index == -1) return NULL;
+    while (jobs_[index].status == kRunning) {
+      job_done_.Wait(&mutex_);
+      index = FindEntry(*shared);
+    }
+    job = jobs_[index].job;
+    parse_here = jobs_[index].status == kQueued;
+    jobs_.Remove(index);
+  }
+  // No background thread has picked up the job yet. Parsing it here is no
+  // slower than parsing the function from scratch.
+  if (parse_here) job->Parse(isolate_->stack_guard()->real_climit());
+  return job;
+}
+
+
+void LazyCompileDispatcher::Stop() {
+  {
+    base::LockGuard<base::Mutex> lock_guard(&mutex_);
+    stopped_ = true;
+    while (ref_count_ > 0) ref_count_zero_.Wait(&mutex_);
+  }
+  for (int i = 0; i < jobs_.length(); i++) delete jobs_[i].job;
+  jobs_.Clear();
+}
+
+}  // namespace internal
+}  // namespace v8
@@ -0,0 +1,125 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_LAZY_COMPILE_DISPATCHER_H_
+#define V8_LAZY_COMPILE_DISPATCHER_H_
+
+#include "src/base/platform/condition-variable.h"
+#include "src/base/platform/mutex.h"
+#include "src/base/smart-pointers.h"
+#include "src/flags.h"
+#include "src/handles.h"
+#include "src/list.h"
+#include "src/parsing/parser.h"
+#include "src/unicode-cache.h"
+#include "src/zone.h"
+
+namespace v8 {
+namespace internal {
+
+class JSFunction;
+class SharedFunctionInfo;
+class Utf16CharacterStream;
+
+// Parses a single lazily compiled function ahead of its first call. The job
+// is prepared on the main thread, parsed on any thread, and finalized on the
+// main thread when the function is compiled.
+class LazyParseJob {
+ public:
+  LazyParseJob(Isolate* isolate, Handle<JSFunction> function);
+  ~LazyParseJob();
+
+  Handle<SharedFunctionInfo> shared() const { return shared_; }
+
+  // Parses the function body. Does not access the heap.
+  void Parse(uintptr_t stack_limit);
+
+  // Internalizes the result and hands it to the given parse info of the lazy
+  // compilation of shared(). The job has to stay alive until the compilation
+  // is done, since it owns the AST. Returns false if parsing failed, in which
+  // case an exception is pending.
+  bool Finalize(ParseInfo* info);
+
+ private:
+  Isolate* isolate_;
+  Handle<SharedFunctionInfo> shared_;  // Global handle.
+  Handle<Script> script_;              // Global handle.
+  UnicodeCache unicode_cache_;
+  Zone zone_;
+  ParseInfo parse_info_;
+  base::SmartPointer<Utf16CharacterStream> source_;
+  base::SmartPointer<Parser> parser_;
+  const AstRawString* name_;
+  FunctionKind kind_;
+  FunctionLiteral::FunctionType function_type_;
+  FunctionLiteral* literal_;
+
+  DISALLOW_COPY_AND_ASSIGN(LazyParseJob);
+};
+
+
+// Parses functions that are likely to be called soon after they are created
+// on background threads, so that their lazy compilation only has to generate
+// code. Only functions declared in the script scope are considered, since
+// they are the ones that are called while the script sets itself up, and
+// since they have no outer scope chain that would have to be read from the
+// heap while parsing. Code generation, either by full-codegen or Ignition,
+// still happens on the main thread because it allocates on the heap.
+class LazyCompileDispatcher {
+ public:
+  explicit LazyCompileDispatcher(Isolate* isolate);
+  ~LazyCompileDispatcher();
+
+  // Queues the function for parsing on a background thread if it qualifies.
+  void QueueForParsing(Handle<JSFunction> function);
+
+  // Returns the job for the given function after it has parsed, waiting for
+  // the background thread or parsing on the main thread if necessary, or NULL
+  // if the function was not queued. The caller takes ownership of the job.
+  LazyParseJob* TakeParsedJob(Handle<SharedFunctionInfo> shared);
+
+  // Waits for the running jobs and discards all jobs.
+  void Stop();
+
+  static bool Enabled() { return FLAG_lazy_compile_dispatcher; }
+
+ private:
+  class ParseTask;
+
+  enum JobStatus { kQueued, kRunning, kDone };
+
+  struct Entry {
+    LazyParseJob* job;
+    JobStatus status;
+  };
+
+  bool CanParseOnBackground(JSFunction* function);
+
+  // Claims the oldest queued job, or returns NULL if there is none.
+  LazyParseJob* NextQueuedJob();
+  void JobDone(LazyParseJob* job);
+
+  int FindEntry(SharedFunctionInfo* shared);
+
+  Isolate* isolate_;
+  int max_jobs_;
+
+  // Copy of FLAG_stack_size for the background threads.
+  int stack_size_;
+
+  // Protects the fields below.
+  base::Mutex mutex_;
+  List<Entry> jobs_;
+  base::ConditionVariable job_done_;
+  int ref_count_;
+  base::ConditionVariable ref_count_zero_;
+  bool stopped_;
+
+  DISALLOW_COPY_AND_ASSIGN(LazyCompileDispatcher);
+};
+
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_LAZY_COMPILE_DISPATCHER_H_
@@ -823,6 +823,13 @@ void JSRegExp::JSRegExpVerify() {
 
       CHECK(arr->get(JSRegExp::kIrregexpCaptureCountIndex)->IsSmi());
       CHECK(arr->get(JSRegExp::kIrregexpMaxRegisterCountIndex)->IsSmi());
+
+      Object* one_byte_bytecode =
+          arr->get(JSRegExp::kIrregexpLatin1BytecodeIndex);
+      CHECK(one_byte_bytecode->IsSmi() || one_byte_bytecode->IsByteArray());
+      Object* uc16_bytecode = arr->get(JSRegExp::kIrregexpUC16BytecodeIndex);
+      CHECK(uc16_bytecode->IsSmi() || uc16_bytecode->IsByteArray());
+      CHECK(arr->get(JSRegExp::kIrregexpTicksUntilTierUpIndex)->IsSmi());
       break;
     }
     default:
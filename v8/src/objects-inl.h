@@ -1474,6 +1474,15 @@ void HeapObject::synchronized_set_map_word(MapWord map_word) {
 }
 
 
+MapWord HeapObject::synchronized_compare_and_swap_map_word(
+    MapWord old_map_word, MapWord new_map_word) {
+  return MapWord(static_cast<uintptr_t>(base::Release_CompareAndSwap(
+      reinterpret_cast<base::AtomicWord*>(FIELD_ADDR(this, kMapOffset)),
+      static_cast<base::AtomicWord>(old_map_word.value_),
+      static_cast<base::AtomicWord>(new_map_word.value_))));
+}
+
+
 int HeapObject::Size() {
   return SizeFromMap(map());
 }
@@ -1544,6 +1544,12 @@ class HeapObject: public Object {
   inline void synchronized_set_map_no_write_barrier(Map* value);
   inline void synchronized_set_map_word(MapWord map_word);
 
+  // Compare-and-swap the map word using release semantics. Returns the map
+  // word found in the object, which equals {old_map_word} iff the swap
+  // succeeded.
+  inline MapWord synchronized_compare_and_swap_map_word(MapWord old_map_word,
+                                                        MapWord new_map_word);
+
   // During garbage collection, the map word of a heap object does not
   // necessarily contain a map pointer.
   inline MapWord map_word() const;
@@ -7775,6 +7781,14 @@ class JSRegExp: public JSObject {
     }
   }
 
+  static int bytecode_index(bool is_latin1) {
+    if (is_latin1) {
+      return kIrregexpLatin1BytecodeIndex;
+    } else {
+      return kIrregexpUC16BytecodeIndex;
+    }
+  }
+
   DECLARE_CAST(JSRegExp)
 
   // Dispatched behavior.
@@ -7819,8 +7833,15 @@ class JSRegExp: public JSObject {
   static const int kIrregexpMaxRegisterCountIndex = kDataIndex + 4;
   // Number of captures in the compiled regexp.
   static const int kIrregexpCaptureCountIndex = kDataIndex + 5;
-
-  static const int kIrregexpDataSize = kIrregexpCaptureCountIndex + 1;
+  // Irregexp bytecode for Latin1 and UC16 that is interpreted until the
+  // regexp tiers up to native code. Only used with native regexps.
+  static const int kIrregexpLatin1BytecodeIndex = kDataIndex + 6;
+  static const int kIrregexpUC16BytecodeIndex = kDataIndex + 7;
+  // Number of executions left before native code is generated. Zero once
+  // the regexp has tiered up, or if it started out in native code.
+  static const int kIrregexpTicksUntilTierUpIndex = kDataIndex + 8;
+
+  static const int kIrregexpDataSize = kIrregexpTicksUntilTierUpIndex + 1;
 
   // Offsets directly into the data fixed array.
   static const int kDataTagOffset =
@@ -8,6 +8,7 @@
 #include "src/full-codegen/full-codegen.h"
 #include "src/isolate.h"
 #include "src/v8.h"
+#include "src/zone.h"
 
 namespace v8 {
 namespace internal {
@@ -59,6 +60,8 @@ class OptimizingCompileDispatcher::CompileTask : public v8::Task {
         isolate_->optimizing_compile_dispatcher();
     {
       TimerEventScope<TimerEventRecompileConcurrent> timer(isolate_);
+      // The optimization phases create and delete many temporary zones.
+      ZoneSegmentPool::ThreadCacheScope segment_cache_scope;
 
       if (dispatcher->recompilation_delay_ != 0) {
         base::OS::Sleep(base::TimeDelta::FromMilliseconds(
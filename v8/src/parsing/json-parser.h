@@ -46,6 +46,9 @@ class JsonParser BASE_EMBEDDED {
     // Optimized fast case where we only have Latin1 characters.
     if (seq_one_byte) {
       seq_source_ = Handle<SeqOneByteString>::cast(source_);
+      if (source_length_ >= kMinLengthForKeyCache) {
+        key_cache_ = factory_->NewFixedArray(kKeyCacheSize);
+      }
     }
   }
 
@@ -133,6 +136,31 @@ class JsonParser BASE_EMBEDDED {
 
   template <bool is_internalized>
   Handle<String> ScanJsonString();
+
+  // Looks up an internalized string that was recently parsed as a key. The
+  // cache entry is chosen without hashing the key, so that repeated keys are
+  // neither hashed nor looked up in the string table.
+  Handle<String> LookupKeyCache(int index, Vector<const uint8_t> key) {
+    if (key_cache_.is_null()) return Handle<String>::null();
+    Object* cached = key_cache_->get(index);
+    if (cached->IsString() && String::cast(cached)->IsOneByteEqualTo(key)) {
+      return Handle<String>(String::cast(cached), isolate());
+    }
+    return Handle<String>::null();
+  }
+
+  void UpdateKeyCache(int index, Handle<String> string) {
+    if (key_cache_.is_null()) return;
+    key_cache_->set(index, *string);
+  }
+
+  static int KeyCacheIndex(Vector<const uint8_t> key) {
+    DCHECK_LT(0, key.length());
+    uint32_t length = static_cast<uint32_t>(key.length());
+    uint32_t index = length * 31 + key[0] * 7 + key[length - 1];
+    return static_cast<int>(index & (kKeyCacheSize - 1));
+  }
+
   // Creates a new string and copies prefix[start..end] into the beginning
   // of it. Then scans the rest of the string, adding characters after the
   // prefix. Called by ScanJsonString when reaching a '\' or non-Latin1 char.
@@ -184,6 +212,10 @@ class JsonParser BASE_EMBEDDED {
 
   static const int kInitialSpecialStringLength = 32;
   static const int kPretenureTreshold = 100 * 1024;
+  // Shorter sources are unlikely to repeat keys often enough to amortize the
+  // allocation of the key cache.
+  static const int kMinLengthForKeyCache = 256;
+  static const int kKeyCacheSize = 64;
 
 
  private:
@@ -195,6 +227,9 @@ class JsonParser BASE_EMBEDDED {
   Handle<String> source_;
   int source_length_;
   Handle<SeqOneByteString> seq_source_;
+  // Internalized keys indexed by KeyCacheIndex(). Only used for one-byte
+  // sources.
+  Handle<FixedArray> key_cache_;
 
   PretenureFlag pretenure_;
   Isolate* isolate_;
@@ -748,7 +783,6 @@ Handle<String> JsonParser<seq_one_byte>::ScanJsonString() {
     // Fast path for existing internalized strings.  If the the string being
     // parsed is not a known internalized string, contains backslashes or
     // unexpectedly reaches the end of string, return with an empty handle.
-    uint32_t running_hash = isolate()->heap()->HashSeed();
     int position = position_;
     uc32 c0 = c0_;
     do {
@@ -761,23 +795,33 @@ Handle<String> JsonParser<seq_one_byte>::ScanJsonString() {
                                                              position_);
       }
       if (c0 < 0x20) return Handle<String>::null();
-      running_hash = StringHasher::AddCharacterCore(running_hash,
-                                                    static_cast<uint16_t>(c0));
       position++;
       if (position >= source_length_) return Handle<String>::null();
       c0 = seq_source_->SeqOneByteStringGet(position);
     } while (c0 != '"');
     int length = position - position_;
+    Vector<const uint8_t> string_vector(
+        seq_source_->GetChars() + position_, length);
+    int cache_index = KeyCacheIndex(string_vector);
+    Handle<String> result = LookupKeyCache(cache_index, string_vector);
+    if (!result.is_null()) {
+      position_ = position;
+      // Advance past the last '"'.
+      AdvanceSkipWhitespace();
+      return result;
+    }
+    uint32_t running_hash = isolate()->heap()->HashSeed();
+    for (int i = 0; i < length; i++) {
+      running_hash =
+          StringHasher::AddCharacterCore(running_hash, string_vector[i]);
+    }
     uint32_t hash = (length <= String::kMaxHashCalcLength)
                         ? StringHasher::GetHashCore(running_hash)
                         : static_cast<uint32_t>(length);
-    Vector<const uint8_t> string_vector(
-        seq_source_->GetChars() + position_, length);
     StringTable* string_table = isolate()->heap()->string_table();
     uint32_t capacity = string_table->Capacity();
     uint32_t entry = StringTable::FirstProbe(hash, capacity);
     uint32_t count = 1;
-    Handle<String> result;
     while (true) {
       Object* element = string_table->KeyAt(entry);
       if (element == isolate()->heap()->undefined_value()) {
@@ -799,6 +843,8 @@ Handle<String> JsonParser<seq_one_byte>::ScanJsonString() {
       }
       entry = StringTable::NextProbe(entry, count++, capacity);
     }
+    // The string vector may have moved if internalizing allocated.
+    UpdateKeyCache(cache_index, result);
     position_ = position;
     // Advance past the last '"'.
     AdvanceSkipWhitespace();
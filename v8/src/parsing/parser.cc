@@ -49,6 +49,7 @@ ParseInfo::ParseInfo(Zone* zone)
       unicode_cache_(nullptr),
       stack_limit_(0),
       hash_seed_(0),
+      eager_compile_positions_(nullptr),
       cached_data_(nullptr),
       ast_value_factory_(nullptr),
       literal_(nullptr),
@@ -747,6 +748,7 @@ Parser::Parser(ParseInfo* info)
       target_stack_(NULL),
       compile_options_(info->compile_options()),
       cached_parse_data_(NULL),
+      eager_compile_positions_(info->eager_compile_positions()),
       total_preparse_skipped_(0),
       pre_parse_timer_(NULL),
       parsing_on_main_thread_(true) {
@@ -4177,6 +4179,15 @@ FunctionLiteral* Parser::ParseFunctionLiteral(
                            formals_end_position, CHECK_OK);
     Expect(Token::LBRACE, CHECK_OK);
 
+    // Functions that had been compiled when a code cache is produced are
+    // compiled eagerly, so that their code is included in the cache.
+    bool has_eager_compile_position =
+        eager_compile_positions_ != NULL &&
+        SortedListBSearch(*eager_compile_positions_, start_position) != -1;
+    if (has_eager_compile_position) {
+      eager_compile_hint = FunctionLiteral::kShouldEagerCompile;
+    }
+
     // Determine if the function can be parsed lazily. Lazy parsing is different
     // from lazy compilation; we need to parse more eagerly than we compile.
 
@@ -4212,7 +4223,8 @@ FunctionLiteral* Parser::ParseFunctionLiteral(
     // logic where only top-level functions will be parsed lazily.
     bool is_lazily_parsed = mode() == PARSE_LAZILY &&
                             scope_->AllowsLazyParsing() &&
-                            !parenthesized_function_;
+                            !parenthesized_function_ &&
+                            !has_eager_compile_position;
     parenthesized_function_ = false;  // The bit was set for this function only.
 
     // Eager or lazy parse?
@@ -5139,6 +5151,46 @@ void Parser::ParseOnBackground(ParseInfo* info) {
 }
 
 
+FunctionLiteral* Parser::ParseLazyOnBackground(
+    ParseInfo* info, Utf16CharacterStream* source, const AstRawString* name,
+    FunctionKind kind, FunctionLiteral::FunctionType function_type) {
+  parsing_on_main_thread_ = false;
+
+  DCHECK(info->literal() == NULL);
+  scanner_.Initialize(source);
+  DCHECK(scope_ == NULL);
+  DCHECK(target_stack_ == NULL);
+
+  fni_ = new (zone()) FuncNameInferrer(ast_value_factory(), zone());
+  fni_->PushEnclosingName(name);
+
+  ParsingModeScope parsing_mode(this, PARSE_EAGERLY);
+
+  FunctionLiteral* result = NULL;
+  {
+    // The function is declared in the script scope, so there is no outer
+    // scope chain to deserialize.
+    Scope* scope = NewScope(scope_, SCRIPT_SCOPE);
+    info->set_script_scope(scope);
+    original_scope_ = scope;
+    AstNodeFactory function_factory(ast_value_factory());
+    FunctionState function_state(&function_state_, &scope_, scope, kind,
+                                 &function_factory);
+    bool ok = true;
+    result = ParseFunctionLiteral(
+        name, Scanner::Location::invalid(), kSkipFunctionNameCheck, kind,
+        RelocInfo::kNoPosition, function_type, FunctionLiteral::kNormalArity,
+        info->language_mode(), &ok);
+    // Make sure the results agree.
+    DCHECK(ok == (result != NULL));
+  }
+
+  // Make sure the target stack is empty.
+  DCHECK(target_stack_ == NULL);
+  return result;
+}
+
+
 ParserTraits::TemplateLiteralState Parser::OpenTemplateLiteral(int pos) {
   return new (zone()) ParserTraits::TemplateLiteral(zone(), pos);
 }
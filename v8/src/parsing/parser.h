@@ -122,6 +122,14 @@ class ParseInfo {
   uint32_t hash_seed() { return hash_seed_; }
   void set_hash_seed(uint32_t hash_seed) { hash_seed_ = hash_seed; }
 
+  // Sorted start positions of functions that should be compiled eagerly.
+  const List<int>* eager_compile_positions() {
+    return eager_compile_positions_;
+  }
+  void set_eager_compile_positions(const List<int>* positions) {
+    eager_compile_positions_ = positions;
+  }
+
   //--------------------------------------------------------------------------
   // TODO(titzer): these should not be part of ParseInfo.
   //--------------------------------------------------------------------------
@@ -185,6 +193,7 @@ class ParseInfo {
   UnicodeCache* unicode_cache_;
   uintptr_t stack_limit_;
   uint32_t hash_seed_;
+  const List<int>* eager_compile_positions_;
 
   // TODO(titzer): Move handles and isolate out of ParseInfo.
   Isolate* isolate_;
@@ -681,6 +690,16 @@ class Parser : public ParserBase<ParserTraits> {
   bool Parse(ParseInfo* info);
   void ParseOnBackground(ParseInfo* info);
 
+  // Parses a lazily compiled function that is declared in the script scope
+  // without touching the heap, so that it can run on a background thread.
+  // Everything that ParseLazy would read from the SharedFunctionInfo has to be
+  // passed in.  The result is returned, and has to be internalized on the
+  // main thread.
+  FunctionLiteral* ParseLazyOnBackground(
+      ParseInfo* info, Utf16CharacterStream* source,
+      const AstRawString* name, FunctionKind kind,
+      FunctionLiteral::FunctionType function_type);
+
   // Handle errors detected during parsing, move statistics to Isolate,
   // internalize strings (move them to the heap).
   void Internalize(Isolate* isolate, Handle<Script> script, bool error);
@@ -1031,6 +1050,7 @@ class Parser : public ParserBase<ParserTraits> {
   Target* target_stack_;  // for break, continue statements
   ScriptCompiler::CompileOptions compile_options_;
   ParseData* cached_parse_data_;
+  const List<int>* eager_compile_positions_;
 
   PendingCompilationErrorHandler pending_error_handler_;
 
@@ -585,5 +585,36 @@ void ExternalTwoByteStringUtf16CharacterStream::ResetToBookmark() {
   pos_ = bookmark_;
   buffer_cursor_ = raw_data_ + bookmark_;
 }
+
+
+CopiedStringUtf16CharacterStream::CopiedStringUtf16CharacterStream(
+    Handle<String> data, int start_position, int end_position)
+    : Utf16CharacterStream(),
+      raw_data_(NewArray<uc16>(end_position - start_position)),
+      start_position_(start_position),
+      bookmark_(kNoBookmark) {
+  String::WriteToFlat(*data, raw_data_, start_position, end_position);
+  buffer_cursor_ = raw_data_;
+  buffer_end_ = raw_data_ + (end_position - start_position);
+  pos_ = start_position;
+}
+
+
+CopiedStringUtf16CharacterStream::~CopiedStringUtf16CharacterStream() {
+  DeleteArray(raw_data_);
+}
+
+
+bool CopiedStringUtf16CharacterStream::SetBookmark() {
+  bookmark_ = pos_;
+  return true;
+}
+
+
+void CopiedStringUtf16CharacterStream::ResetToBookmark() {
+  DCHECK(bookmark_ != kNoBookmark);
+  pos_ = bookmark_;
+  buffer_cursor_ = raw_data_ + (bookmark_ - start_position_);
+}
 }  // namespace internal
 }  // namespace v8
@@ -183,6 +183,44 @@ class ExternalTwoByteStringUtf16CharacterStream: public Utf16CharacterStream {
   size_t bookmark_;
 };
 
+
+// UTF16 stream over a copy of part of a string. Since it does not refer to the
+// heap after construction, it can be read on a background thread.
+class CopiedStringUtf16CharacterStream : public Utf16CharacterStream {
+ public:
+  CopiedStringUtf16CharacterStream(Handle<String> data, int start_position,
+                                   int end_position);
+  ~CopiedStringUtf16CharacterStream() override;
+
+  void PushBack(uc32 character) override {
+    if (character != kEndOfInput) {
+      DCHECK(buffer_cursor_ > raw_data_);
+      buffer_cursor_--;
+    }
+    pos_--;
+  }
+
+  bool SetBookmark() override;
+  void ResetToBookmark() override;
+
+ protected:
+  size_t SlowSeekForward(size_t delta) override {
+    // Fast case always handles seeking.
+    return 0;
+  }
+  bool ReadBlock() override {
+    // Entire string is copied at construction.
+    return false;
+  }
+  uc16* raw_data_;
+  size_t start_position_;
+
+ private:
+  static const size_t kNoBookmark = -1;
+
+  size_t bookmark_;
+};
+
 }  // namespace internal
 }  // namespace v8
 
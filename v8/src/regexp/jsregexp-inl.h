@@ -57,6 +57,10 @@ int32_t* RegExpImpl::GlobalCache::FetchNext() {
                                                  last_end_index,
                                                  register_array_,
                                                  register_array_size_);
+      // A regexp prepared for the interpreter can tier up to native code in
+      // the middle of the loop.  The native code of a global regexp may then
+      // find more matches than the interpreter's register layout has room for.
+      if (num_matches_ > max_matches_) num_matches_ = max_matches_;
     }
 
     if (num_matches_ <= 0) return NULL;
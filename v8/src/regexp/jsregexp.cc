@@ -316,6 +316,14 @@ Handle<Object> RegExpImpl::AtomExec(Handle<JSRegExp> re,
 bool RegExpImpl::EnsureCompiledIrregexp(Handle<JSRegExp> re,
                                         Handle<String> sample_subject,
                                         bool is_one_byte) {
+#ifndef V8_INTERPRETED_REGEXP
+  if (IrregexpIsInterpreted(FixedArray::cast(re->data()))) {
+    // The regexp has not tiered up yet, so it only needs bytecode.
+    Object* bytecode = re->DataAt(JSRegExp::bytecode_index(is_one_byte));
+    if (bytecode->IsByteArray()) return true;
+    return CompileIrregexp(re, sample_subject, is_one_byte, true);
+  }
+#endif  // V8_INTERPRETED_REGEXP
   Object* compiled_code = re->DataAt(JSRegExp::code_index(is_one_byte));
 #ifdef V8_INTERPRETED_REGEXP
   if (compiled_code->IsByteArray()) return true;
@@ -331,13 +339,13 @@ bool RegExpImpl::EnsureCompiledIrregexp(Handle<JSRegExp> re,
     DCHECK(compiled_code->IsSmi());
     return true;
   }
-  return CompileIrregexp(re, sample_subject, is_one_byte);
+  return CompileIrregexp(re, sample_subject, is_one_byte, false);
 }
 
 
 bool RegExpImpl::CompileIrregexp(Handle<JSRegExp> re,
                                  Handle<String> sample_subject,
-                                 bool is_one_byte) {
+                                 bool is_one_byte, bool use_bytecode) {
   // Compile the RegExp.
   Isolate* isolate = re->GetIsolate();
   Zone zone;
@@ -382,7 +390,8 @@ bool RegExpImpl::CompileIrregexp(Handle<JSRegExp> re,
   RegExpEngine::CompilationResult result = RegExpEngine::Compile(
       isolate, &zone, &compile_data, flags & JSRegExp::kIgnoreCase,
       flags & JSRegExp::kGlobal, flags & JSRegExp::kMultiline,
-      flags & JSRegExp::kSticky, pattern, sample_subject, is_one_byte);
+      flags & JSRegExp::kSticky, pattern, sample_subject, is_one_byte,
+      use_bytecode);
   if (result.error_message != NULL) {
     // Unable to compile regexp.
     Handle<String> error_message = isolate->factory()->NewStringFromUtf8(
@@ -392,7 +401,11 @@ bool RegExpImpl::CompileIrregexp(Handle<JSRegExp> re,
   }
 
   Handle<FixedArray> data = Handle<FixedArray>(FixedArray::cast(re->data()));
-  data->set(JSRegExp::code_index(is_one_byte), result.code);
+  if (use_bytecode && RegExpImpl::UsesNativeRegExp()) {
+    data->set(JSRegExp::bytecode_index(is_one_byte), result.code);
+  } else {
+    data->set(JSRegExp::code_index(is_one_byte), result.code);
+  }
   int register_max = IrregexpMaxRegisterCount(*data);
   if (result.num_registers > register_max) {
     SetIrregexpMaxRegisterCount(*data, result.num_registers);
@@ -424,7 +437,11 @@ int RegExpImpl::IrregexpNumberOfRegisters(FixedArray* re) {
 
 
 ByteArray* RegExpImpl::IrregexpByteCode(FixedArray* re, bool is_one_byte) {
+#ifdef V8_INTERPRETED_REGEXP
   return ByteArray::cast(re->get(JSRegExp::code_index(is_one_byte)));
+#else
+  return ByteArray::cast(re->get(JSRegExp::bytecode_index(is_one_byte)));
+#endif  // V8_INTERPRETED_REGEXP
 }
 
 
@@ -433,6 +450,25 @@ Code* RegExpImpl::IrregexpNativeCode(FixedArray* re, bool is_one_byte) {
 }
 
 
+bool RegExpImpl::IrregexpIsInterpreted(FixedArray* re) {
+#ifdef V8_INTERPRETED_REGEXP
+  return true;
+#else
+  return Smi::cast(re->get(JSRegExp::kIrregexpTicksUntilTierUpIndex))
+             ->value() > 0;
+#endif  // V8_INTERPRETED_REGEXP
+}
+
+
+void RegExpImpl::IrregexpTierUp(FixedArray* re) {
+  DCHECK(UsesNativeRegExp());
+  Smi* uninitialized = Smi::FromInt(JSRegExp::kUninitializedValue);
+  re->set(JSRegExp::kIrregexpTicksUntilTierUpIndex, Smi::FromInt(0));
+  re->set(JSRegExp::kIrregexpLatin1BytecodeIndex, uninitialized);
+  re->set(JSRegExp::kIrregexpUC16BytecodeIndex, uninitialized);
+}
+
+
 void RegExpImpl::IrregexpInitialize(Handle<JSRegExp> re,
                                     Handle<String> pattern,
                                     JSRegExp::Flags flags,
@@ -450,22 +486,43 @@ int RegExpImpl::IrregexpPrepare(Handle<JSRegExp> regexp,
                                 Handle<String> subject) {
   subject = String::Flatten(subject);
 
+  Handle<FixedArray> data(FixedArray::cast(regexp->data()));
+#ifndef V8_INTERPRETED_REGEXP
+  // Regexps that are only used a couple of times are interpreted, since
+  // generating native code for them costs more than it saves.  The ticks live
+  // in the data array, which the compilation cache shares between all regexps
+  // with the same source and flags, so every use in the isolate counts.
+  if (IrregexpIsInterpreted(*data)) {
+    int ticks =
+        Smi::cast(data->get(JSRegExp::kIrregexpTicksUntilTierUpIndex))->value();
+    if (ticks == 1) {
+      if (FLAG_trace_regexp_tier_up) {
+        PrintF("[tiering up regexp /%s/]\n",
+               regexp->Pattern()->ToCString().get());
+      }
+      IrregexpTierUp(*data);
+    } else {
+      data->set(JSRegExp::kIrregexpTicksUntilTierUpIndex,
+                Smi::FromInt(ticks - 1));
+    }
+  }
+#endif  // V8_INTERPRETED_REGEXP
+
   // Check representation of the underlying storage.
   bool is_one_byte = subject->IsOneByteRepresentationUnderneath();
   if (!EnsureCompiledIrregexp(regexp, subject, is_one_byte)) return -1;
 
-#ifdef V8_INTERPRETED_REGEXP
-  // Byte-code regexp needs space allocated for all its registers.
-  // The result captures are copied to the start of the registers array
-  // if the match succeeds.  This way those registers are not clobbered
-  // when we set the last match info from last successful match.
-  return IrregexpNumberOfRegisters(FixedArray::cast(regexp->data())) +
-         (IrregexpNumberOfCaptures(FixedArray::cast(regexp->data())) + 1) * 2;
-#else  // V8_INTERPRETED_REGEXP
+  if (IrregexpIsInterpreted(*data)) {
+    // Byte-code regexp needs space allocated for all its registers.
+    // The result captures are copied to the start of the registers array
+    // if the match succeeds.  This way those registers are not clobbered
+    // when we set the last match info from last successful match.
+    return IrregexpNumberOfRegisters(*data) +
+           (IrregexpNumberOfCaptures(*data) + 1) * 2;
+  }
   // Native regexp only needs room to output captures. Registers are handled
   // internally.
-  return (IrregexpNumberOfCaptures(FixedArray::cast(regexp->data())) + 1) * 2;
-#endif  // V8_INTERPRETED_REGEXP
+  return (IrregexpNumberOfCaptures(*data) + 1) * 2;
 }
 
 
@@ -484,6 +541,45 @@ int RegExpImpl::IrregexpExecRaw(Handle<JSRegExp> regexp,
 
   bool is_one_byte = subject->IsOneByteRepresentationUnderneath();
 
+  if (IrregexpIsInterpreted(*irregexp)) {
+    DCHECK(output_size >= IrregexpNumberOfRegisters(*irregexp));
+    // We must have done EnsureCompiledIrregexp, so we can get the number of
+    // registers.
+    int number_of_capture_registers =
+        (IrregexpNumberOfCaptures(*irregexp) + 1) * 2;
+    int32_t* raw_output = &output[number_of_capture_registers];
+    // We do not touch the actual capture result registers until we know there
+    // has been a match so that we can use those capture results to set the
+    // last match info.
+    for (int i = number_of_capture_registers - 1; i >= 0; i--) {
+      raw_output[i] = -1;
+    }
+    Handle<ByteArray> byte_codes(IrregexpByteCode(*irregexp, is_one_byte),
+                                 isolate);
+
+    IrregexpResult result = IrregexpInterpreter::Match(isolate,
+                                                       byte_codes,
+                                                       subject,
+                                                       raw_output,
+                                                       index);
+    if (result == RE_SUCCESS) {
+      // Copy capture results to the start of the registers array.
+      MemCopy(output, raw_output,
+              number_of_capture_registers * sizeof(int32_t));
+    }
+    if (result != RE_EXCEPTION) return result;
+    DCHECK(!isolate->has_pending_exception());
+    if (!UsesNativeRegExp()) {
+      isolate->StackOverflow();
+      return result;
+    }
+    // The interpreter ran out of backtracking stack, which native code grows
+    // on demand.  Tier up right away and retry.  Only room for a single match
+    // is passed on, since the caller laid out the output for the interpreter.
+    IrregexpTierUp(*irregexp);
+    output_size = number_of_capture_registers;
+  }
+
 #ifndef V8_INTERPRETED_REGEXP
   DCHECK(output_size >= (IrregexpNumberOfCaptures(*irregexp) + 1) * 2);
   do {
@@ -521,39 +617,8 @@ int RegExpImpl::IrregexpExecRaw(Handle<JSRegExp> regexp,
     is_one_byte = subject->IsOneByteRepresentationUnderneath();
   } while (true);
   UNREACHABLE();
-  return RE_EXCEPTION;
-#else  // V8_INTERPRETED_REGEXP
-
-  DCHECK(output_size >= IrregexpNumberOfRegisters(*irregexp));
-  // We must have done EnsureCompiledIrregexp, so we can get the number of
-  // registers.
-  int number_of_capture_registers =
-      (IrregexpNumberOfCaptures(*irregexp) + 1) * 2;
-  int32_t* raw_output = &output[number_of_capture_registers];
-  // We do not touch the actual capture result registers until we know there
-  // has been a match so that we can use those capture results to set the
-  // last match info.
-  for (int i = number_of_capture_registers - 1; i >= 0; i--) {
-    raw_output[i] = -1;
-  }
-  Handle<ByteArray> byte_codes(IrregexpByteCode(*irregexp, is_one_byte),
-                               isolate);
-
-  IrregexpResult result = IrregexpInterpreter::Match(isolate,
-                                                     byte_codes,
-                                                     subject,
-                                                     raw_output,
-                                                     index);
-  if (result == RE_SUCCESS) {
-    // Copy capture results to the start of the registers array.
-    MemCopy(output, raw_output, number_of_capture_registers * sizeof(int32_t));
-  }
-  if (result == RE_EXCEPTION) {
-    DCHECK(!isolate->has_pending_exception());
-    isolate->StackOverflow();
-  }
-  return result;
 #endif  // V8_INTERPRETED_REGEXP
+  return RE_EXCEPTION;
 }
 
 
@@ -642,23 +707,20 @@ RegExpImpl::GlobalCache::GlobalCache(Handle<JSRegExp> regexp,
     register_array_size_(0),
     regexp_(regexp),
     subject_(subject) {
-#ifdef V8_INTERPRETED_REGEXP
-  bool interpreted = true;
-#else
   bool interpreted = false;
-#endif  // V8_INTERPRETED_REGEXP
 
   if (regexp_->TypeTag() == JSRegExp::ATOM) {
     static const int kAtomRegistersPerMatch = 2;
     registers_per_match_ = kAtomRegistersPerMatch;
     // There is no distinction between interpreted and native for atom regexps.
-    interpreted = false;
   } else {
     registers_per_match_ = RegExpImpl::IrregexpPrepare(regexp_, subject_);
     if (registers_per_match_ < 0) {
       num_matches_ = -1;  // Signal exception.
       return;
     }
+    interpreted =
+        RegExpImpl::IrregexpIsInterpreted(FixedArray::cast(regexp_->data()));
   }
 
   if (is_global && !interpreted) {
@@ -6260,7 +6322,7 @@ void DispatchTableConstructor::VisitAction(ActionNode* that) {
 RegExpEngine::CompilationResult RegExpEngine::Compile(
     Isolate* isolate, Zone* zone, RegExpCompileData* data, bool ignore_case,
     bool is_global, bool is_multiline, bool is_sticky, Handle<String> pattern,
-    Handle<String> sample_subject, bool is_one_byte) {
+    Handle<String> sample_subject, bool is_one_byte, bool use_bytecode) {
   if ((data->capture_count + 1) * 2 - 1 > RegExpMacroAssembler::kMaxRegister) {
     return IrregexpRegExpTooBig(isolate);
   }
@@ -6287,9 +6349,7 @@ RegExpEngine::CompilationResult RegExpEngine::Compile(
                                                     &compiler,
                                                     compiler.accept());
   RegExpNode* node = captured_body;
-  bool is_end_anchored = data->tree->IsAnchoredAtEnd();
   bool is_start_anchored = data->tree->IsAnchoredAtStart();
-  int max_length = data->tree->max_match();
   if (!is_start_anchored && !is_sticky) {
     // Add a .*? at the beginning, outside the body capture, unless
     // this expression is anchored at the beginning or sticky.
@@ -6329,68 +6389,72 @@ RegExpEngine::CompilationResult RegExpEngine::Compile(
 
   // Create the correct assembler for the architecture.
 #ifndef V8_INTERPRETED_REGEXP
-  // Native regexp implementation.
-
-  NativeRegExpMacroAssembler::Mode mode =
-      is_one_byte ? NativeRegExpMacroAssembler::LATIN1
-                  : NativeRegExpMacroAssembler::UC16;
+  if (!use_bytecode) {
+    // Native regexp implementation.
+    NativeRegExpMacroAssembler::Mode mode =
+        is_one_byte ? NativeRegExpMacroAssembler::LATIN1
+                    : NativeRegExpMacroAssembler::UC16;
+    int registers = (data->capture_count + 1) * 2;
 
 #if V8_TARGET_ARCH_IA32
-  RegExpMacroAssemblerIA32 macro_assembler(isolate, zone, mode,
-                                           (data->capture_count + 1) * 2);
+    RegExpMacroAssemblerIA32 macro_assembler(isolate, zone, mode, registers);
 #elif V8_TARGET_ARCH_X64
-  RegExpMacroAssemblerX64 macro_assembler(isolate, zone, mode,
-                                          (data->capture_count + 1) * 2);
+    RegExpMacroAssemblerX64 macro_assembler(isolate, zone, mode, registers);
 #elif V8_TARGET_ARCH_ARM
-  RegExpMacroAssemblerARM macro_assembler(isolate, zone, mode,
-                                          (data->capture_count + 1) * 2);
+    RegExpMacroAssemblerARM macro_assembler(isolate, zone, mode, registers);
 #elif V8_TARGET_ARCH_ARM64
-  RegExpMacroAssemblerARM64 macro_assembler(isolate, zone, mode,
-                                            (data->capture_count + 1) * 2);
+    RegExpMacroAssemblerARM64 macro_assembler(isolate, zone, mode, registers);
 #elif V8_TARGET_ARCH_PPC
-  RegExpMacroAssemblerPPC macro_assembler(isolate, zone, mode,
-                                          (data->capture_count + 1) * 2);
+    RegExpMacroAssemblerPPC macro_assembler(isolate, zone, mode, registers);
 #elif V8_TARGET_ARCH_MIPS
-  RegExpMacroAssemblerMIPS macro_assembler(isolate, zone, mode,
-                                           (data->capture_count + 1) * 2);
+    RegExpMacroAssemblerMIPS macro_assembler(isolate, zone, mode, registers);
 #elif V8_TARGET_ARCH_MIPS64
-  RegExpMacroAssemblerMIPS macro_assembler(isolate, zone, mode,
-                                           (data->capture_count + 1) * 2);
+    RegExpMacroAssemblerMIPS macro_assembler(isolate, zone, mode, registers);
 #elif V8_TARGET_ARCH_X87
-  RegExpMacroAssemblerX87 macro_assembler(isolate, zone, mode,
-                                          (data->capture_count + 1) * 2);
+    RegExpMacroAssemblerX87 macro_assembler(isolate, zone, mode, registers);
 #else
 #error "Unsupported architecture"
 #endif
 
-#else  // V8_INTERPRETED_REGEXP
+    return Assemble(&compiler, &macro_assembler, data, is_global, pattern);
+  }
+#endif  // V8_INTERPRETED_REGEXP
+
   // Interpreted regexp implementation.
   EmbeddedVector<byte, 1024> codes;
   RegExpMacroAssemblerIrregexp macro_assembler(isolate, codes, zone);
-#endif  // V8_INTERPRETED_REGEXP
+  return Assemble(&compiler, &macro_assembler, data, is_global, pattern);
+}
+
 
-  macro_assembler.set_slow_safe(TooMuchRegExpCode(pattern));
+RegExpEngine::CompilationResult RegExpEngine::Assemble(
+    RegExpCompiler* compiler, RegExpMacroAssembler* macro_assembler,
+    RegExpCompileData* data, bool is_global, Handle<String> pattern) {
+  macro_assembler->set_slow_safe(TooMuchRegExpCode(pattern));
 
   // Inserted here, instead of in Assembler, because it depends on information
   // in the AST that isn't replicated in the Node structure.
   static const int kMaxBacksearchLimit = 1024;
+  bool is_end_anchored = data->tree->IsAnchoredAtEnd();
+  bool is_start_anchored = data->tree->IsAnchoredAtStart();
+  int max_length = data->tree->max_match();
   if (is_end_anchored &&
       !is_start_anchored &&
       max_length < kMaxBacksearchLimit) {
-    macro_assembler.SetCurrentPositionFromEnd(max_length);
+    macro_assembler->SetCurrentPositionFromEnd(max_length);
   }
 
   if (is_global) {
-    macro_assembler.set_global_mode(
+    macro_assembler->set_global_mode(
         (data->tree->min_match() > 0)
             ? RegExpMacroAssembler::GLOBAL_NO_ZERO_LENGTH_CHECK
             : RegExpMacroAssembler::GLOBAL);
   }
 
-  return compiler.Assemble(&macro_assembler,
-                           node,
-                           data->capture_count,
-                           pattern);
+  return compiler->Assemble(macro_assembler,
+                            data->node,
+                            data->capture_count,
+                            pattern);
 }
 
 
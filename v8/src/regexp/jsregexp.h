@@ -199,6 +199,11 @@ class RegExpImpl {
   static ByteArray* IrregexpByteCode(FixedArray* re, bool is_one_byte);
   static Code* IrregexpNativeCode(FixedArray* re, bool is_one_byte);
 
+  // Returns true if the regexp is run by the bytecode interpreter, either
+  // because native regexps are not supported, or because it has not been
+  // executed often enough to tier up to native code yet.
+  static bool IrregexpIsInterpreted(FixedArray* re);
+
   // Limit the space regexps take up on the heap.  In order to limit this we
   // would like to keep track of the amount of regexp code on the heap.  This
   // is not tracked, however.  As a conservative approximation we track the
@@ -209,11 +214,18 @@ class RegExpImpl {
   static const int kRegExpTooLargeToOptimize = 20 * KB;
 
  private:
+  // Generates bytecode for the interpreter instead of native code if
+  // use_bytecode is true.  Bytecode is always generated if native regexps are
+  // not supported.
   static bool CompileIrregexp(Handle<JSRegExp> re,
-                              Handle<String> sample_subject, bool is_one_byte);
+                              Handle<String> sample_subject, bool is_one_byte,
+                              bool use_bytecode);
   static inline bool EnsureCompiledIrregexp(Handle<JSRegExp> re,
                                             Handle<String> sample_subject,
                                             bool is_one_byte);
+  // Switches an interpreted regexp over to native code, which is compiled the
+  // next time it is executed.
+  static void IrregexpTierUp(FixedArray* re);
 };
 
 
@@ -1509,11 +1521,19 @@ class RegExpEngine: public AllStatic {
                                    bool global, bool multiline, bool sticky,
                                    Handle<String> pattern,
                                    Handle<String> sample_subject,
-                                   bool is_one_byte);
+                                   bool is_one_byte, bool use_bytecode);
 
   static bool TooMuchRegExpCode(Handle<String> pattern);
 
   static void DotPrint(const char* label, RegExpNode* node, bool ignore_case);
+
+ private:
+  // Generates code for the analyzed node network in data with the given
+  // assembler.
+  static CompilationResult Assemble(RegExpCompiler* compiler,
+                                    RegExpMacroAssembler* macro_assembler,
+                                    RegExpCompileData* data, bool is_global,
+                                    Handle<String> pattern);
 };
 
 
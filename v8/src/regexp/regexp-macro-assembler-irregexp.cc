@@ -13,8 +13,6 @@
 namespace v8 {
 namespace internal {
 
-#ifdef V8_INTERPRETED_REGEXP
-
 RegExpMacroAssemblerIrregexp::RegExpMacroAssemblerIrregexp(Isolate* isolate,
                                                            Vector<byte> buffer,
                                                            Zone* zone)
@@ -370,6 +368,19 @@ void RegExpMacroAssemblerIrregexp::CheckBitInTable(
 }
 
 
+void RegExpMacroAssemblerIrregexp::CheckPosition(int cp_offset,
+                                                 Label* on_outside_input) {
+  LoadCurrentCharacter(cp_offset, on_outside_input, true);
+}
+
+
+bool RegExpMacroAssemblerIrregexp::CheckSpecialCharacterClass(
+    uc16 type, Label* on_no_match) {
+  // There are no bytecodes for the standard character classes.
+  return false;
+}
+
+
 void RegExpMacroAssemblerIrregexp::CheckNotBackReference(int start_reg,
                                                          bool read_backward,
                                                          Label* on_not_equal) {
@@ -454,7 +465,5 @@ void RegExpMacroAssemblerIrregexp::Expand() {
   }
 }
 
-#endif  // V8_INTERPRETED_REGEXP
-
 }  // namespace internal
 }  // namespace v8
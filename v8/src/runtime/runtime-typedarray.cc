@@ -6,6 +6,7 @@
 
 #include "src/arguments.h"
 #include "src/factory.h"
+#include "src/heap/array-buffer-tracker.h"
 #include "src/messages.h"
 #include "src/objects-inl.h"
 #include "src/runtime/runtime.h"
@@ -57,12 +58,9 @@ RUNTIME_FUNCTION(Runtime_ArrayBufferNeuter) {
   // Shared array buffers should never be neutered.
   RUNTIME_ASSERT(!array_buffer->is_shared());
   DCHECK(!array_buffer->is_external());
-  void* backing_store = array_buffer->backing_store();
-  size_t byte_length = NumberToSize(isolate, array_buffer->byte_length());
+  isolate->heap()->array_buffer_tracker()->Free(*array_buffer);
   array_buffer->set_is_external(true);
-  isolate->heap()->UnregisterArrayBuffer(*array_buffer);
   array_buffer->Neuter();
-  isolate->array_buffer_allocator()->Free(backing_store, byte_length);
   return isolate->heap()->undefined_value();
 }
 
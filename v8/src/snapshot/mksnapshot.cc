@@ -110,9 +110,9 @@ class SnapshotWriter {
 };
 
 
-char* GetExtraCode(char* filename) {
+char* GetExtraCode(char* filename, const char* description) {
   if (filename == NULL || strlen(filename) == 0) return NULL;
-  ::printf("Embedding extra script: %s\n", filename);
+  ::printf("%s script: %s\n", description, filename);
   FILE* file = base::OS::FOpen(filename, "rb");
   if (file == NULL) {
     fprintf(stderr, "Failed to open '%s': errno %d\n", filename, errno);
@@ -144,9 +144,10 @@ int main(int argc, char** argv) {
   // Print the usage if an error occurs when parsing the command line
   // flags or if the help flag is set.
   int result = i::FlagList::SetFlagsFromCommandLine(&argc, argv, true);
-  if (result > 0 || (argc != 1 && argc != 2) || i::FLAG_help) {
-    ::printf("Usage: %s --startup_src=... --startup_blob=... [extras]\n",
-             argv[0]);
+  if (result > 0 || argc > 3 || i::FLAG_help) {
+    ::printf(
+        "Usage: %s --startup_src=... --startup_blob=... [extras] [warm-up]\n",
+        argv[0]);
     i::FlagList::PrintHelp();
     return !i::FLAG_help;
   }
@@ -161,11 +162,21 @@ int main(int argc, char** argv) {
     SnapshotWriter writer;
     if (i::FLAG_startup_src) writer.SetSnapshotFile(i::FLAG_startup_src);
     if (i::FLAG_startup_blob) writer.SetStartupBlobFile(i::FLAG_startup_blob);
-    char* extra_code = GetExtraCode(argc == 2 ? argv[1] : NULL);
+    char* extra_code = GetExtraCode(argc >= 2 ? argv[1] : NULL, "Embedding");
     StartupData blob = v8::V8::CreateSnapshotDataBlob(extra_code);
     CHECK(blob.data);
-    writer.WriteSnapshot(blob);
     delete[] extra_code;
+
+    char* warmup_code = GetExtraCode(argc >= 3 ? argv[2] : NULL, "Warm-up");
+    if (warmup_code != NULL) {
+      StartupData cold = blob;
+      blob = v8::V8::WarmUpSnapshotDataBlob(cold, warmup_code);
+      CHECK(blob.data);
+      delete[] cold.data;
+      delete[] warmup_code;
+    }
+
+    writer.WriteSnapshot(blob);
     delete[] blob.data;
   }
 
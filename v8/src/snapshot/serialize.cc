@@ -133,6 +133,8 @@ ExternalReferenceTable::ExternalReferenceTable(Isolate* isolate) {
       "Isolate::virtual_slot_register()");
   Add(ExternalReference::runtime_function_table_address(isolate).address(),
       "Runtime::runtime_function_table_address()");
+  Add(ExternalReference::interpreter_dispatch_counters(isolate).address(),
+      "Interpreter::dispatch_counters");
 
   // Debug addresses
   Add(ExternalReference::debug_after_break_target_address(isolate).address(),
@@ -292,6 +294,10 @@ ExternalReferenceTable::ExternalReferenceTable(Isolate* isolate) {
       "StubCache::secondary_->value");
   Add(stub_cache->map_reference(StubCache::kSecondary).address(),
       "StubCache::secondary_->map");
+  Add(stub_cache->mask_reference(StubCache::kPrimary).address(),
+      "StubCache::primary_mask_");
+  Add(stub_cache->mask_reference(StubCache::kSecondary).address(),
+      "StubCache::secondary_mask_");
 
   // Runtime entries
   Add(ExternalReference::delete_handle_scope_extensions(isolate).address(),
@@ -1656,8 +1662,12 @@ bool Serializer::SerializeKnownObject(HeapObject* obj, HowToCode how_to_code,
 }
 
 
-StartupSerializer::StartupSerializer(Isolate* isolate, SnapshotByteSink* sink)
-    : Serializer(isolate, sink), root_index_wave_front_(0) {
+StartupSerializer::StartupSerializer(
+    Isolate* isolate, SnapshotByteSink* sink,
+    FunctionCodeHandling function_code_handling)
+    : Serializer(isolate, sink),
+      root_index_wave_front_(0),
+      function_code_handling_(function_code_handling) {
   // Clear the cache of objects used by the partial snapshot.  After the
   // strong roots have been serialized we can create a partial snapshot
   // which will repopulate the cache with objects needed by that partial
@@ -1680,7 +1690,8 @@ void StartupSerializer::SerializeObject(HeapObject* obj, HowToCode how_to_code,
     return;
   }
 
-  if (obj->IsCode() && Code::cast(obj)->kind() == Code::FUNCTION) {
+  if (function_code_handling_ == CLEAR_FUNCTION_CODE && obj->IsCode() &&
+      Code::cast(obj)->kind() == Code::FUNCTION) {
     obj = isolate()->builtins()->builtin(Builtins::kCompileLazy);
   }
 
@@ -636,7 +636,11 @@ class PartialSerializer : public Serializer {
 
 class StartupSerializer : public Serializer {
  public:
-  StartupSerializer(Isolate* isolate, SnapshotByteSink* sink);
+  enum FunctionCodeHandling { CLEAR_FUNCTION_CODE, KEEP_FUNCTION_CODE };
+
+  StartupSerializer(
+      Isolate* isolate, SnapshotByteSink* sink,
+      FunctionCodeHandling function_code_handling = CLEAR_FUNCTION_CODE);
   ~StartupSerializer() override { OutputStatistics("StartupSerializer"); }
 
   // The StartupSerializer has to serialize the root array, which is slightly
@@ -654,6 +658,7 @@ class StartupSerializer : public Serializer {
 
  private:
   intptr_t root_index_wave_front_;
+  FunctionCodeHandling function_code_handling_;
   DISALLOW_COPY_AND_ASSIGN(StartupSerializer);
 };
 
@@ -50,6 +50,7 @@ void V8::TearDown() {
   RegisteredExtension::UnregisterAll();
   Isolate::GlobalTearDown();
   Sampler::TearDown();
+  ZoneSegmentPool::ReleaseMemory();
   FlagList::ResetAllFlags();  // Frees memory held by string arguments.
 }
 
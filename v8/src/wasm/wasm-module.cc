@@ -2,6 +2,10 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "src/atomic-utils.h"
+#include "src/base/platform/semaphore.h"
+#include "src/base/sys-info.h"
+#include "src/cancelable-task.h"
 #include "src/macro-assembler.h"
 #include "src/objects.h"
 #include "src/v8.h"
@@ -212,6 +216,134 @@ Handle<JSArrayBuffer> NewArrayBuffer(Isolate* isolate, int size,
   buffer->set_is_neuterable(false);
   return buffer;
 }
+
+
+typedef std::vector<compiler::WasmCompilationUnit*> CompilationUnits;
+
+
+void ExecuteUnclaimedCompilationUnits(CompilationUnits* units,
+                                      AtomicNumber<size_t>* next_unit) {
+  while (true) {
+    size_t index = next_unit->Increment(1) - 1;
+    if (index >= units->size()) return;
+    units->at(index)->ExecuteCompilation();
+  }
+}
+
+
+class CompilationTask : public CancelableTask {
+ public:
+  CompilationTask(Isolate* isolate, CompilationUnits* units,
+                  AtomicNumber<size_t>* next_unit,
+                  base::Semaphore* pending_tasks_semaphore)
+      : CancelableTask(isolate),
+        units_(units),
+        next_unit_(next_unit),
+        pending_tasks_semaphore_(pending_tasks_semaphore) {}
+
+ private:
+  // v8::internal::CancelableTask overrides.
+  void RunInternal() override {
+    ExecuteUnclaimedCompilationUnits(units_, next_unit_);
+    pending_tasks_semaphore_->Signal();
+  }
+
+  CompilationUnits* units_;
+  AtomicNumber<size_t>* next_unit_;
+  base::Semaphore* pending_tasks_semaphore_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompilationTask);
+};
+
+
+// Executes the units on background threads, with the main thread
+// contributing. The graphs refer to heap objects, so the main thread must not
+// allocate on the heap until all units are done.
+void ExecuteCompilationUnitsInParallel(Isolate* isolate,
+                                       CompilationUnits* units) {
+  AtomicNumber<size_t> next_unit(0);
+  base::Semaphore pending_tasks_semaphore(0);
+  const int num_tasks =
+      Min(static_cast<int>(units->size()) - 1,
+          Max(0, base::SysInfo::NumberOfProcessors() - 1));
+  std::vector<uint32_t> task_ids;
+  for (int i = 0; i < num_tasks; i++) {
+    CompilationTask* task = new CompilationTask(isolate, units, &next_unit,
+                                                &pending_tasks_semaphore);
+    task_ids.push_back(task->id());
+    V8::GetCurrentPlatform()->CallOnBackgroundThread(
+        task, v8::Platform::kShortRunningTask);
+  }
+
+  ExecuteUnclaimedCompilationUnits(units, &next_unit);
+
+  // Tasks that cannot be canceled have either completed or are still running.
+  for (uint32_t task_id : task_ids) {
+    if (!isolate->cancelable_task_manager()->TryAbort(task_id)) {
+      pending_tasks_semaphore.Wait();
+    }
+  }
+}
+
+
+// Compiles all functions of the module that are not imported into
+// {function_code}. The functions are compiled in batches, so that only the
+// graphs of one batch are alive at a time. Returns false if a function failed
+// to compile.
+bool CompileFunctions(ErrorThrower* thrower, Isolate* isolate,
+                      ModuleEnv* module_env,
+                      std::vector<Handle<Code>>* function_code) {
+  // Bounds the memory held by the graphs of a batch.
+  const size_t kMaxFunctionBytesPerBatch = 256 * KB;
+  std::vector<WasmFunction>* functions = module_env->module->functions;
+  // Tracing and statistics of the pipeline are not thread-safe.
+  const bool parallel = FLAG_wasm_parallel_compilation && !FLAG_trace_turbo &&
+                        !FLAG_turbo_stats && !FLAG_turbo_profiling;
+  CompilationUnits units;
+  size_t index = 0;
+  while (index < functions->size()) {
+    // Build the graphs of the next batch.
+    size_t batch_bytes = 0;
+    for (; index < functions->size(); index++) {
+      const WasmFunction& func = functions->at(index);
+      if (func.external) continue;
+      if (!units.empty() &&
+          (!parallel || batch_bytes >= kMaxFunctionBytesPerBatch)) {
+        break;
+      }
+      compiler::WasmCompilationUnit* unit = new compiler::WasmCompilationUnit(
+          thrower, isolate, module_env, &func, static_cast<int>(index));
+      units.push_back(unit);
+      if (!unit->BuildGraph()) break;
+      batch_bytes += func.code_end_offset - func.code_start_offset;
+    }
+    bool ok = !thrower->error();
+    if (ok) {
+      if (parallel) {
+        ExecuteCompilationUnitsInParallel(isolate, &units);
+      } else {
+        for (compiler::WasmCompilationUnit* unit : units) {
+          unit->ExecuteCompilation();
+        }
+      }
+      for (compiler::WasmCompilationUnit* unit : units) {
+        Handle<Code> code = unit->FinishCompilation();
+        if (code.is_null()) {
+          thrower->Error(
+              "Compilation of #%d:%s failed.", unit->index(),
+              module_env->module->GetName(unit->function()->name_offset));
+          ok = false;
+          break;
+        }
+        function_code->at(unit->index()) = code;
+      }
+    }
+    for (compiler::WasmCompilationUnit* unit : units) delete unit;
+    units.clear();
+    if (!ok) return false;
+  }
+  return true;
+}
 }  // namespace
 
 
@@ -328,7 +460,13 @@ MaybeHandle<JSObject> WasmModule::Instantiate(Isolate* isolate,
   module_env.context = isolate->native_context();
   module_env.asm_js = false;
 
-  // First pass: compile each function and initialize the code table.
+  std::vector<Handle<Code>> function_code(functions->size());
+  if (!CompileFunctions(&thrower, isolate, &module_env, &function_code)) {
+    return MaybeHandle<JSObject>();
+  }
+
+  // First pass: install the compiled functions and the wrappers of imported
+  // and exported functions, and initialize the code table.
   for (const WasmFunction& func : *functions) {
     if (thrower.error()) break;
 
@@ -360,13 +498,7 @@ MaybeHandle<JSObject> WasmModule::Instantiate(Isolate* isolate,
         return MaybeHandle<JSObject>();
       }
     } else {
-      // Compile the function.
-      code = compiler::CompileWasmFunction(thrower, isolate, &module_env, func,
-                                           index);
-      if (code.is_null()) {
-        thrower.Error("Compilation of #%d:%s failed.", index, cstr);
-        return MaybeHandle<JSObject>();
-      }
+      code = function_code[index];
       if (func.exported) {
         function = compiler::CompileJSToWasmWrapper(isolate, &module_env, name,
                                                     code, module, index);
@@ -464,18 +596,18 @@ int32_t CompileAndRunWasmModule(Isolate* isolate, WasmModule* module) {
   LoadDataSegments(module, mem_addr.get(), mem_size);
 
   // Compile all functions.
+  std::vector<Handle<Code>> function_code(module->functions->size());
+  if (!CompileFunctions(&thrower, isolate, &module_env, &function_code)) {
+    return -1;
+  }
   Handle<Code> main_code = Handle<Code>::null();  // record last code.
   int index = 0;
   for (const WasmFunction& func : *module->functions) {
     if (!func.external) {
-      // Compile the function and install it in the code table.
-      Handle<Code> code = compiler::CompileWasmFunction(
-          thrower, isolate, &module_env, func, index);
-      if (!code.is_null()) {
-        if (func.exported) main_code = code;
-        linker.Finish(index, code);
-      }
-      if (thrower.error()) return -1;
+      // Install the function in the code table.
+      Handle<Code> code = function_code[index];
+      if (func.exported) main_code = code;
+      linker.Finish(index, code);
     }
     index++;
   }
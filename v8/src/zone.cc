@@ -6,6 +6,11 @@
 
 #include <cstring>
 
+#include "src/base/bits.h"
+#include "src/base/lazy-instance.h"
+#include "src/base/platform/mutex.h"
+#include "src/base/platform/platform.h"
+#include "src/flags.h"
 #include "src/v8.h"
 
 #ifdef V8_USE_ADDRESS_SANITIZER
@@ -45,8 +50,8 @@ const size_t kASanRedzoneBytes = 0;
 // Segments represent chunks of memory: They have starting address
 // (encoded in the this pointer) and a size in bytes. Segments are
 // chained together forming a LIFO structure with the newest segment
-// available as segment_head_. Segments are allocated using malloc()
-// and de-allocated using free().
+// available as segment_head_. Segments are allocated and de-allocated
+// through the ZoneSegmentPool, which falls back to malloc() and free().
 
 class Segment {
  public:
@@ -73,6 +78,221 @@ class Segment {
 };
 
 
+namespace {
+
+const int kMinimumPooledSegmentSizeLog2 = 13;
+const int kMaximumPooledSegmentSizeLog2 = 20;
+const int kNumberOfSegmentSizes =
+    kMaximumPooledSegmentSizeLog2 - kMinimumPooledSegmentSizeLog2 + 1;
+
+// Thread caches hold fewer segments than the pool, since their segments cannot
+// be used by other threads.
+const size_t kMaximumThreadCacheSize = 1 * MB;
+
+
+// Free segments, sorted into one list per pooled size.
+class SegmentList {
+ public:
+  SegmentList() : size_(0) {
+    for (int i = 0; i < kNumberOfSegmentSizes; i++) heads_[i] = nullptr;
+  }
+
+  // Returns the index of the list for segments of the given size, or -1 if
+  // such segments are not pooled.
+  static int IndexOf(size_t size) {
+    if (!base::bits::IsPowerOfTwo64(size)) return -1;
+    int log2 = WhichPowerOf2_64(size);
+    if (log2 < kMinimumPooledSegmentSizeLog2 ||
+        log2 > kMaximumPooledSegmentSizeLog2) {
+      return -1;
+    }
+    return log2 - kMinimumPooledSegmentSizeLog2;
+  }
+
+  Segment* Take(int index) {
+    Segment* segment = heads_[index];
+    if (segment != nullptr) {
+      heads_[index] = segment->next();
+      size_ -= segment->size();
+    }
+    return segment;
+  }
+
+  void Put(int index, Segment* segment) {
+    segment->Initialize(heads_[index], segment->size());
+    heads_[index] = segment;
+    size_ += segment->size();
+  }
+
+  // Total size of the segments in the list.
+  size_t size() const { return size_; }
+
+ private:
+  Segment* heads_[kNumberOfSegmentSizes];
+  size_t size_;
+};
+
+
+struct ThreadCache {
+  ThreadCache() : reused_segments(0) {}
+
+  SegmentList segments;
+  size_t reused_segments;
+};
+
+
+struct SegmentPool {
+  SegmentPool()
+      : thread_cache_key(base::Thread::CreateThreadLocalKey()),
+        allocated_segments(0),
+        reused_segments(0),
+        thread_cache_reused_segments(0),
+        max_pooled_bytes(0) {}
+
+  // Keeps the segment if the pool has room for it. The mutex must be held.
+  bool PutLocked(int index, Segment* segment) {
+    size_t limit = static_cast<size_t>(FLAG_zone_segment_pool_size) * MB;
+    if (segments.size() + segment->size() > limit) return false;
+    segments.Put(index, segment);
+    max_pooled_bytes = Max(max_pooled_bytes, segments.size());
+    return true;
+  }
+
+  ThreadCache* thread_cache() {
+    return reinterpret_cast<ThreadCache*>(
+        base::Thread::GetThreadLocal(thread_cache_key));
+  }
+
+  const base::Thread::LocalStorageKey thread_cache_key;
+
+  // Protects all of the following fields.
+  base::Mutex mutex;
+  SegmentList segments;
+  size_t allocated_segments;
+  size_t reused_segments;
+  size_t thread_cache_reused_segments;
+  size_t max_pooled_bytes;
+};
+
+
+base::LazyInstance<SegmentPool>::type segment_pool = LAZY_INSTANCE_INITIALIZER;
+
+
+// Hides the contents of free segments from ASan. The header stays accessible,
+// since it links the segment into its list.
+void PoisonSegment(Segment* segment) {
+  ASAN_POISON_MEMORY_REGION(segment->start(), segment->capacity());
+}
+
+
+void UnpoisonSegment(Segment* segment) {
+  ASAN_UNPOISON_MEMORY_REGION(segment, segment->size());
+}
+
+}  // namespace
+
+
+ZoneSegmentPool::ThreadCacheScope::ThreadCacheScope() : installed_(false) {
+  SegmentPool* pool = segment_pool.Pointer();
+  if (pool->thread_cache() == nullptr) {
+    base::Thread::SetThreadLocal(pool->thread_cache_key, new ThreadCache());
+    installed_ = true;
+  }
+}
+
+
+ZoneSegmentPool::ThreadCacheScope::~ThreadCacheScope() {
+  if (!installed_) return;
+  SegmentPool* pool = segment_pool.Pointer();
+  ThreadCache* cache = pool->thread_cache();
+  base::Thread::SetThreadLocal(pool->thread_cache_key, nullptr);
+  {
+    base::LockGuard<base::Mutex> lock_guard(&pool->mutex);
+    pool->thread_cache_reused_segments += cache->reused_segments;
+    for (int i = 0; i < kNumberOfSegmentSizes; i++) {
+      while (Segment* segment = cache->segments.Take(i)) {
+        if (!pool->PutLocked(i, segment)) Malloced::Delete(segment);
+      }
+    }
+  }
+  delete cache;
+}
+
+
+void ZoneSegmentPool::GetStatistics(Statistics* statistics) {
+  SegmentPool* pool = segment_pool.Pointer();
+  base::LockGuard<base::Mutex> lock_guard(&pool->mutex);
+  statistics->allocated_segments = pool->allocated_segments;
+  statistics->reused_segments = pool->reused_segments;
+  statistics->thread_cache_reused_segments =
+      pool->thread_cache_reused_segments;
+  statistics->pooled_bytes = pool->segments.size();
+  statistics->max_pooled_bytes = pool->max_pooled_bytes;
+}
+
+
+void ZoneSegmentPool::ReleaseMemory() {
+  SegmentPool* pool = segment_pool.Pointer();
+  base::LockGuard<base::Mutex> lock_guard(&pool->mutex);
+  for (int i = 0; i < kNumberOfSegmentSizes; i++) {
+    while (Segment* segment = pool->segments.Take(i)) {
+      Malloced::Delete(segment);
+    }
+  }
+}
+
+
+Segment* ZoneSegmentPool::New(size_t size) {
+  STATIC_ASSERT(kMinimumPooledSegmentSize ==
+                (static_cast<size_t>(1) << kMinimumPooledSegmentSizeLog2));
+  STATIC_ASSERT(kMaximumPooledSegmentSize ==
+                (static_cast<size_t>(1) << kMaximumPooledSegmentSizeLog2));
+  int index = SegmentList::IndexOf(size);
+  if (index >= 0 && FLAG_zone_segment_pool_size > 0) {
+    SegmentPool* pool = segment_pool.Pointer();
+    ThreadCache* cache = pool->thread_cache();
+    Segment* segment = nullptr;
+    if (cache != nullptr) {
+      segment = cache->segments.Take(index);
+      if (segment != nullptr) cache->reused_segments++;
+    }
+    if (segment == nullptr) {
+      base::LockGuard<base::Mutex> lock_guard(&pool->mutex);
+      segment = pool->segments.Take(index);
+      if (segment != nullptr) {
+        pool->reused_segments++;
+      } else {
+        pool->allocated_segments++;
+      }
+    }
+    if (segment != nullptr) {
+      UnpoisonSegment(segment);
+      return segment;
+    }
+  }
+  return reinterpret_cast<Segment*>(Malloced::New(size));
+}
+
+
+void ZoneSegmentPool::Delete(Segment* segment, size_t size) {
+  int index = SegmentList::IndexOf(size);
+  if (index >= 0 && FLAG_zone_segment_pool_size > 0) {
+    SegmentPool* pool = segment_pool.Pointer();
+    segment->Initialize(nullptr, size);
+    PoisonSegment(segment);
+    ThreadCache* cache = pool->thread_cache();
+    if (cache != nullptr &&
+        cache->segments.size() + size <= kMaximumThreadCacheSize) {
+      cache->segments.Put(index, segment);
+      return;
+    }
+    base::LockGuard<base::Mutex> lock_guard(&pool->mutex);
+    if (pool->PutLocked(index, segment)) return;
+  }
+  Malloced::Delete(segment);
+}
+
+
 Zone::Zone()
     : allocation_size_(0),
       segment_bytes_allocated_(0),
@@ -201,7 +421,7 @@ void Zone::DeleteKeptSegment() {
 // Creates a new segment, sets it size, and pushes it to the front
 // of the segment chain. Returns the new segment.
 Segment* Zone::NewSegment(size_t size) {
-  Segment* result = reinterpret_cast<Segment*>(Malloced::New(size));
+  Segment* result = ZoneSegmentPool::New(size);
   segment_bytes_allocated_ += size;
   if (result != nullptr) {
     result->Initialize(segment_head_, size);
@@ -214,7 +434,7 @@ Segment* Zone::NewSegment(size_t size) {
 // Deletes the given segment. Does not touch the segment chain.
 void Zone::DeleteSegment(Segment* segment, size_t size) {
   segment_bytes_allocated_ -= size;
-  Malloced::Delete(segment);
+  ZoneSegmentPool::Delete(segment, size);
 }
 
 
@@ -247,6 +467,14 @@ Address Zone::NewExpand(size_t size) {
     // All the while making sure to allocate a segment large enough to hold the
     // requested size.
     new_size = Max(min_new_size, kMaximumSegmentSize);
+  } else {
+    // Use one of the sizes kept by the segment pool.
+    STATIC_ASSERT(kMinimumSegmentSize ==
+                  ZoneSegmentPool::kMinimumPooledSegmentSize);
+    STATIC_ASSERT(kMaximumSegmentSize ==
+                  ZoneSegmentPool::kMaximumPooledSegmentSize);
+    new_size =
+        base::bits::RoundUpToPowerOfTwo32(static_cast<uint32_t>(new_size));
   }
   if (new_size > INT_MAX) {
     V8::FatalProcessOutOfMemory("Zone");
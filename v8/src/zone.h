@@ -118,6 +118,60 @@ class Zone final {
 };
 
 
+// A process-wide pool of free zone segments. Zones that are created and
+// deleted in quick succession, like the temporary zones of the compiler
+// pipelines, take their segments from the pool instead of calling malloc()
+// and free() for every segment. Only segments with a power of two size
+// between 8KB and 1MB are pooled, and the pool holds at most
+// --zone-segment-pool-size megabytes.
+//
+// Threads that create and delete many zones, like the concurrent recompilation
+// threads, can open a ThreadCacheScope. Segments deleted on the thread while
+// the scope is active are kept in a cache that is only used by this thread,
+// and are handed to the pool when the scope is left.
+class ZoneSegmentPool final : public AllStatic {
+ public:
+  struct Statistics {
+    // Poolable segments that had to be allocated with malloc().
+    size_t allocated_segments;
+    // Segments taken from the pool and from thread caches respectively.
+    size_t reused_segments;
+    size_t thread_cache_reused_segments;
+    size_t pooled_bytes;
+    size_t max_pooled_bytes;
+  };
+
+  class ThreadCacheScope final {
+   public:
+    ThreadCacheScope();
+    ~ThreadCacheScope();
+
+   private:
+    bool installed_;
+
+    DISALLOW_COPY_AND_ASSIGN(ThreadCacheScope);
+  };
+
+  static void GetStatistics(Statistics* statistics);
+
+  // Frees all segments held by the pool. Thread caches are not affected.
+  static void ReleaseMemory();
+
+ private:
+  friend class Zone;
+
+  static const size_t kMinimumPooledSegmentSize = 8 * KB;
+  static const size_t kMaximumPooledSegmentSize = 1 * MB;
+
+  // Returns a segment of the given size that is either reused or allocated
+  // with malloc(). Returns nullptr if the allocation failed.
+  static Segment* New(size_t size);
+
+  // Keeps the segment for reuse or frees it.
+  static void Delete(Segment* segment, size_t size);
+};
+
+
 // ZoneObject is an abstraction that helps define classes of objects
 // allocated in the Zone. Use it as a base class; see ast.h.
 class ZoneObject {
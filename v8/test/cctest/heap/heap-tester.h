@@ -11,7 +11,9 @@
 // Tests that should have access to private methods of {v8::internal::Heap}.
 // Those tests need to be defined using HEAP_TEST(Name) { ... }.
 #define HEAP_TEST_METHODS(V)                              \
+  V(CompactionDeadlineExceeded)                           \
   V(CompactionFullAbortedPage)                            \
+  V(CompactionParallelPointerUpdate)                      \
   V(CompactionPartiallyAbortedPage)                       \
   V(CompactionPartiallyAbortedPageIntraAbortedPointers)   \
   V(CompactionPartiallyAbortedPageWithStoreBufferEntries) \
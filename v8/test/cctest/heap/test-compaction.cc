@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "src/heap/slots-buffer.h"
 #include "test/cctest/cctest.h"
 #include "test/cctest/heap/heap-tester.h"
 #include "test/cctest/heap/utils-inl.h"
@@ -20,6 +21,58 @@ static void CheckInvariantsOfAbortedPage(Page* page) {
 }
 
 
+HEAP_TEST(CompactionDeadlineExceeded) {
+  // Test the scenario where a mark-compact finalized in an idle task runs out
+  // of idle time before evacuation. The candidate is swept in place instead
+  // and can be evacuated by the next GC.
+  FLAG_concurrent_sweeping = false;
+  FLAG_manual_evacuation_candidates_selection = true;
+  FLAG_idle_time_bounded_compaction = true;
+  CcTest::InitializeVM();
+  Isolate* isolate = CcTest::i_isolate();
+  Heap* heap = isolate->heap();
+  {
+    HandleScope scope1(isolate);
+    PageIterator it(heap->old_space());
+    while (it.has_next()) {
+      it.next()->SetFlag(Page::NEVER_ALLOCATE_ON_PAGE);
+    }
+
+    {
+      HandleScope scope2(isolate);
+      CHECK(heap->old_space()->Expand());
+      auto compaction_page_handles =
+          CreatePadding(heap, Page::kAllocatableMemory, TENURED);
+      Page* to_be_abandoned_page =
+          Page::FromAddress(compaction_page_handles.front()->address());
+      to_be_abandoned_page->SetFlag(
+          MemoryChunk::FORCE_EVACUATION_CANDIDATE_FOR_TESTING);
+
+      // Any deadline in the past leaves no time for evacuation.
+      heap->mark_compact_collector()->set_evacuation_deadline_in_ms(
+          heap->MonotonicallyIncreasingTimeInMs() - 1);
+      heap->CollectAllGarbage();
+
+      for (Handle<FixedArray> object : compaction_page_handles) {
+        CHECK_EQ(to_be_abandoned_page, Page::FromAddress(object->address()));
+      }
+      CHECK(!to_be_abandoned_page->IsEvacuationCandidate());
+      CHECK(!to_be_abandoned_page->IsFlagSet(Page::RESCAN_ON_EVACUATION));
+      CHECK(!to_be_abandoned_page->IsFlagSet(Page::POPULAR_PAGE));
+      CHECK_NULL(to_be_abandoned_page->slots_buffer());
+
+      // Without a deadline the page is evacuated.
+      to_be_abandoned_page->SetFlag(
+          MemoryChunk::FORCE_EVACUATION_CANDIDATE_FOR_TESTING);
+      heap->CollectAllGarbage();
+      for (Handle<FixedArray> object : compaction_page_handles) {
+        CHECK_NE(to_be_abandoned_page, Page::FromAddress(object->address()));
+      }
+    }
+  }
+}
+
+
 HEAP_TEST(CompactionFullAbortedPage) {
   // Test the scenario where we reach OOM during compaction and the whole page
   // is aborted.
@@ -336,5 +389,53 @@ HEAP_TEST(CompactionPartiallyAbortedPageWithStoreBufferEntries) {
   }
 }
 
+HEAP_TEST(CompactionParallelPointerUpdate) {
+  // Test that pointers into an evacuated page are updated when the slots
+  // buffers are processed by several tasks.
+  FLAG_concurrent_sweeping = false;
+  FLAG_manual_evacuation_candidates_selection = true;
+  FLAG_parallel_pointer_update = true;
+
+  // Enough objects to fill several slots buffers with slots pointing to them.
+  const int num_objects = 8 * SlotsBuffer::kNumberOfElements;
+
+  CcTest::InitializeVM();
+  Isolate* isolate = CcTest::i_isolate();
+  Heap* heap = isolate->heap();
+  {
+    HandleScope scope1(isolate);
+    Handle<FixedArray> holder =
+        isolate->factory()->NewFixedArray(num_objects, TENURED);
+    PageIterator it(heap->old_space());
+    while (it.has_next()) {
+      it.next()->SetFlag(Page::NEVER_ALLOCATE_ON_PAGE);
+    }
+
+    {
+      HandleScope scope2(isolate);
+      CHECK(heap->old_space()->Expand());
+      for (int i = 0; i < num_objects; i++) {
+        Handle<FixedArray> object =
+            isolate->factory()->NewFixedArray(1, TENURED);
+        object->set(0, Smi::FromInt(i));
+        holder->set(i, *object);
+      }
+    }
+    Page* evacuated_page =
+        Page::FromAddress(HeapObject::cast(holder->get(0))->address());
+    CHECK_NE(Page::FromAddress(holder->address()), evacuated_page);
+    evacuated_page->SetFlag(
+        MemoryChunk::FORCE_EVACUATION_CANDIDATE_FOR_TESTING);
+
+    heap->CollectAllGarbage();
+
+    for (int i = 0; i < num_objects; i++) {
+      FixedArray* object = FixedArray::cast(holder->get(i));
+      CHECK_NE(evacuated_page, Page::FromAddress(object->address()));
+      CHECK_EQ(Smi::FromInt(i), object->get(0));
+    }
+  }
+}
+
 }  // namespace internal
 }  // namespace v8
@@ -507,6 +507,85 @@ static void VerifyStringAllocation(Isolate* isolate, const char* string) {
 }
 
 
+TEST(ParallelScavenge) {
+  i::FLAG_parallel_scavenge = true;
+  i::FLAG_parallel_scavenge_tasks = 4;
+  CcTest::InitializeVM();
+  Isolate* isolate = CcTest::i_isolate();
+  Heap* heap = isolate->heap();
+  Factory* factory = isolate->factory();
+  HandleScope sc(isolate);
+
+  // Old-to-new pointers, reachable through the store buffer only.
+  const int kLength = 2000;
+  Handle<FixedArray> old_array = factory->NewFixedArray(kLength, TENURED);
+  for (int i = 0; i < kLength; i++) {
+    HandleScope inner_scope(isolate);
+    Handle<FixedArray> young = factory->NewFixedArray(2, NOT_TENURED);
+    young->set(0, Smi::FromInt(i));
+    young->set(1, *factory->NewHeapNumber(i + 0.5));
+    old_array->set(i, *young);
+  }
+  // A new space object reachable from a root, sharing the first element.
+  Handle<FixedArray> rooted = factory->NewFixedArray(1, NOT_TENURED);
+  rooted->set(0, old_array->get(0));
+  CHECK(heap->InNewSpace(*rooted));
+
+  // The first scavenge copies within new space, the second promotes.
+  for (int gc = 0; gc < 2; gc++) {
+    heap->CollectGarbage(NEW_SPACE);
+    CHECK_EQ(old_array->get(0), rooted->get(0));
+    for (int i = 0; i < kLength; i++) {
+      FixedArray* young = FixedArray::cast(old_array->get(i));
+      CHECK(!heap->InFromSpace(young));
+      CHECK_EQ(Smi::FromInt(i), young->get(0));
+      CHECK_EQ(i + 0.5, HeapNumber::cast(young->get(1))->value());
+    }
+  }
+  CHECK(!heap->InNewSpace(*rooted));
+  heap->CollectAllGarbage();
+}
+
+
+TEST(ConcurrentMarking) {
+  i::FLAG_concurrent_marking = true;
+  i::FLAG_concurrent_marking_tasks = 2;
+  CcTest::InitializeVM();
+  Isolate* isolate = CcTest::i_isolate();
+  Heap* heap = isolate->heap();
+  Factory* factory = isolate->factory();
+  HandleScope sc(isolate);
+
+  // Large enough to be scanned concurrently, small enough for old space.
+  const int kLength = 8 * ConcurrentMarking::kElementsPerChunk;
+  Handle<FixedArray> old_array = factory->NewFixedArray(kLength, TENURED);
+  CHECK(!heap->lo_space()->Contains(*old_array));
+  for (int i = 0; i < kLength; i++) {
+    HandleScope inner_scope(isolate);
+    old_array->set(i, *factory->NewHeapNumber(i + 0.5, IMMUTABLE, TENURED));
+  }
+  heap->CollectAllGarbage();
+
+  // Store young objects into the array while it is being marked and scavenge
+  // in between.
+  SimulateIncrementalMarking(heap, false);
+  heap->incremental_marking()->Step(
+      i::MB, i::IncrementalMarking::NO_GC_VIA_STACK_GUARD);
+  for (int i = 0; i < kLength; i += 2) {
+    old_array->set(i, *factory->NewHeapNumber(i + 0.25));
+  }
+  heap->CollectGarbage(NEW_SPACE);
+  SimulateIncrementalMarking(heap);
+  CHECK(!heap->incremental_marking()->concurrent_marking()->HasPendingWork());
+  heap->CollectAllGarbage();
+
+  for (int i = 0; i < kLength; i++) {
+    double expected = (i % 2 == 0) ? i + 0.25 : i + 0.5;
+    CHECK_EQ(expected, HeapNumber::cast(old_array->get(i))->value());
+  }
+}
+
+
 TEST(String) {
   CcTest::InitializeVM();
   Isolate* isolate = reinterpret_cast<Isolate*>(CcTest::isolate());
@@ -30,6 +30,8 @@ class BytecodeGeneratorHelper {
     i::FLAG_always_opt = false;
     i::FLAG_allow_natives_syntax = true;
     i::FLAG_legacy_const = true;
+    // The expectations below are written for unfused bytecodes.
+    i::FLAG_ignition_fuse_bytecodes = false;
     CcTest::i_isolate()->interpreter()->Initialize();
   }
 
@@ -362,6 +362,33 @@ TEST(InterpreterLoadStoreRegisters) {
 }
 
 
+TEST(InterpreterFusedBytecodes) {
+  HandleAndZoneScope handles;
+  BytecodeArrayBuilder builder(handles.main_isolate(), handles.main_zone());
+  builder.set_locals_count(2);
+  builder.set_context_count(0);
+  builder.set_parameter_count(1);
+  Register reg0(0);
+  Register reg1(1);
+  // Emits LdaSmi8Star twice, followed by LdarAdd.
+  builder.LoadLiteral(Smi::FromInt(40))
+      .StoreAccumulatorInRegister(reg0)
+      .LoadLiteral(Smi::FromInt(2))
+      .StoreAccumulatorInRegister(reg1)
+      .LoadAccumulatorWithRegister(reg0)
+      .BinaryOperation(Token::Value::ADD, reg1, Strength::WEAK)
+      .Return();
+  Handle<BytecodeArray> bytecode_array = builder.ToBytecodeArray();
+  CHECK_EQ(Bytecodes::FromByte(bytecode_array->get(0)),
+           Bytecode::kLdaSmi8Star);
+
+  InterpreterTester tester(handles.main_isolate(), bytecode_array);
+  auto callable = tester.GetCallable<>();
+  Handle<Object> return_val = callable().ToHandleChecked();
+  CHECK_EQ(Smi::cast(*return_val), Smi::FromInt(42));
+}
+
+
 TEST(InterpreterExchangeRegisters) {
   for (int locals_count = 2; locals_count < 300; locals_count += 126) {
     HandleAndZoneScope handles;
@@ -3143,6 +3143,70 @@ THREADED_TEST(ArrayBuffer_External) {
 }
 
 
+static void* freed_array_buffer_data = NULL;
+static size_t freed_array_buffer_length = 0;
+static void* freed_array_buffer_info = NULL;
+
+
+static void ArrayBufferFreeCallback(void* data, size_t byte_length,
+                                    void* info) {
+  freed_array_buffer_data = data;
+  freed_array_buffer_length = byte_length;
+  freed_array_buffer_info = info;
+}
+
+
+TEST(ArrayBuffer_FreeCallback) {
+  LocalContext env;
+  v8::Isolate* isolate = env->GetIsolate();
+  i::ScopedVector<uint8_t> my_data(100);
+  int info = 0;
+  freed_array_buffer_data = NULL;
+  freed_array_buffer_info = NULL;
+  {
+    v8::HandleScope handle_scope(isolate);
+    memset(my_data.start(), 0, 100);
+    Local<v8::ArrayBuffer> ab = v8::ArrayBuffer::New(
+        isolate, my_data.start(), 100, ArrayBufferFreeCallback, &info);
+    CHECK(!ab->IsExternal());
+    CHECK_EQ(100, static_cast<int>(ab->ByteLength()));
+    CHECK(env->Global()->Set(env.local(), v8_str("ab"), ab).FromJust());
+    CompileRun(
+        "var u8 = new Uint8Array(ab);"
+        "u8[0] = 0xBB;"
+        "ab = u8 = undefined;");
+    CHECK_EQ(0xBB, my_data[0]);
+  }
+  CcTest::heap()->CollectAllAvailableGarbage();
+  CHECK_EQ(my_data.start(), freed_array_buffer_data);
+  CHECK_EQ(100u, freed_array_buffer_length);
+  CHECK_EQ(&info, freed_array_buffer_info);
+}
+
+
+TEST(ArrayBuffer_PooledBackingStoreIsCleared) {
+  LocalContext env;
+  v8::Isolate* isolate = env->GetIsolate();
+  v8::HandleScope handle_scope(isolate);
+  // Dead backing stores are pooled without being cleared, so reusing one for
+  // a new array buffer has to clear it.
+  CompileRun(
+      "(function() {"
+      "  for (var i = 0; i < 16; i++) new Uint8Array(512).fill(0xFF);"
+      "})();");
+  CcTest::heap()->CollectGarbage(i::NEW_SPACE);
+  CcTest::heap()->CollectGarbage(i::NEW_SPACE);
+  v8::Local<v8::Value> result = CompileRun(
+      "var sum = 0;"
+      "for (var i = 0; i < 16; i++) {"
+      "  var u8 = new Uint8Array(new ArrayBuffer(512));"
+      "  for (var j = 0; j < u8.length; j++) sum += u8[j];"
+      "}"
+      "sum");
+  CHECK_EQ(0, result->Int32Value(env.local()).FromJust());
+}
+
+
 THREADED_TEST(ArrayBuffer_DisableNeuter) {
   LocalContext env;
   v8::Isolate* isolate = env->GetIsolate();
@@ -20731,6 +20795,76 @@ TEST(PrimaryStubCache) {
 }
 
 
+static const char* kPolymorphicLoadProgram =
+    "function load(o) { return o.x; };"
+    "var objects = [];"
+    "for (var i = 0; i < 8; i++) {"
+    "  var o = { x: i };"
+    "  o['y' + i] = i;"
+    "  objects.push(o);"
+    "}"
+    "for (var i = 0; i < 100; i++) load(objects[i % 8]);";
+
+
+TEST(GetICStatistics) {
+  LocalContext env;
+  v8::Isolate* isolate = env->GetIsolate();
+  v8::HandleScope scope(isolate);
+  v8::ICStatistics initial;
+  CHECK_EQ(0u, initial.megamorphic_transitions());
+  isolate->GetICStatistics(&initial);
+  CHECK_EQ(static_cast<size_t>(1) << i::FLAG_stub_cache_primary_bits,
+           initial.stub_cache_primary_size());
+  CHECK_EQ(static_cast<size_t>(1) << i::FLAG_stub_cache_secondary_bits,
+           initial.stub_cache_secondary_size());
+
+  CompileRun(kPolymorphicLoadProgram);
+  v8::ICStatistics statistics;
+  isolate->GetICStatistics(&statistics);
+  CHECK_LT(initial.monomorphic_transitions(),
+           statistics.monomorphic_transitions());
+  CHECK_LT(initial.polymorphic_transitions(),
+           statistics.polymorphic_transitions());
+  CHECK_LT(initial.megamorphic_transitions(),
+           statistics.megamorphic_transitions());
+  CHECK_LT(initial.stub_cache_misses(), statistics.stub_cache_misses());
+}
+
+
+TEST(StubCacheGrows) {
+  // The stub cache is sized when the isolate is created.
+  i::FLAG_stub_cache_primary_bits = 1;
+  i::FLAG_stub_cache_secondary_bits = 1;
+  i::FLAG_grow_stub_cache = true;
+  v8::Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  v8::Isolate* isolate = v8::Isolate::New(create_params);
+  {
+    v8::Isolate::Scope isolate_scope(isolate);
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> context = v8::Context::New(isolate);
+    v8::Context::Scope context_scope(context);
+    v8::ICStatistics initial;
+    isolate->GetICStatistics(&initial);
+    CHECK_EQ(2u, initial.stub_cache_primary_size());
+    CHECK_EQ(2u, initial.stub_cache_secondary_size());
+
+    CompileRun(kPolymorphicLoadProgram);
+    v8::ICStatistics statistics;
+    isolate->GetICStatistics(&statistics);
+    CHECK_LT(0u, statistics.stub_cache_evictions());
+    reinterpret_cast<i::Isolate*>(isolate)->heap()->CollectAllGarbage();
+    isolate->GetICStatistics(&statistics);
+    CHECK_EQ(4u, statistics.stub_cache_primary_size());
+    CHECK_EQ(4u, statistics.stub_cache_secondary_size());
+
+    // The cache still works after growing.
+    CHECK_EQ(7, CompileRun("load(objects[7])")->Int32Value(context).FromJust());
+  }
+  isolate->Dispose();
+}
+
+
 #ifdef DEBUG
 static int cow_arrays_created_runtime = 0;
 
@@ -21314,6 +21448,25 @@ THREADED_TEST(JSONParseObject) {
 }
 
 
+THREADED_TEST(JSONParseRepeatedKeys) {
+  LocalContext context;
+  HandleScope scope(context->GetIsolate());
+  // The keys alternate in order, so that they are not found through map
+  // transitions. "abc" and "adc" share an entry in the parser's key cache.
+  CompileRun(
+      "var objects = [];"
+      "for (var i = 0; i < 64; i++) {"
+      "  objects.push(i % 2 ? {abc: i, adc: -i} : {adc: -i, abc: i});"
+      "}"
+      "var json = JSON.stringify(objects);"
+      "var parsed = JSON.parse(json);");
+  ExpectInt32("parsed[63].abc", 63);
+  ExpectInt32("parsed[63].adc", -63);
+  ExpectString("Object.keys(parsed[62]).join()", "adc,abc");
+  ExpectTrue("JSON.stringify(parsed) === json");
+}
+
+
 THREADED_TEST(JSONParseNumber) {
   LocalContext context;
   HandleScope scope(context->GetIsolate());
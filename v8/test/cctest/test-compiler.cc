@@ -704,6 +704,33 @@ TEST(CompileFunctionInContextScriptOrigin) {
 }
 
 
+TEST(LazyCompileDispatcher) {
+  // The dispatcher is created with the isolate, so use a fresh one.
+  FLAG_lazy_compile_dispatcher = true;
+  v8::Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  v8::Isolate* isolate = v8::Isolate::New(create_params);
+  {
+    v8::Isolate::Scope isolate_scope(isolate);
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = v8::Context::New(isolate);
+    v8::Context::Scope context_scope(context);
+    CHECK(reinterpret_cast<Isolate*>(isolate)
+              ->lazy_compile_dispatcher_enabled());
+
+    v8::Local<v8::Value> result = CompileRun(
+        "function add(a, b) { return a + b; }"
+        "function fib(n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }"
+        "var square = function(x) { return x * x; };"
+        "function unused() { return 'unused'; }"
+        "add(fib(10), square(3));");
+    CHECK_EQ(64, result->Int32Value(context).FromJust());
+  }
+  isolate->Dispose();
+  FLAG_lazy_compile_dispatcher = false;
+}
+
+
 #ifdef ENABLE_DISASSEMBLER
 static Handle<JSFunction> GetJSFunction(v8::Local<v8::Object> obj,
                                         const char* property_name) {
@@ -2852,3 +2852,89 @@ TEST(AddressToTraceMap) {
   CHECK_EQ(0u, map.size());
   CHECK_EQ(0u, map.GetTraceNodeId(ToAddress(0x400)));
 }
+
+
+static const v8::AllocationProfile::Node* FindAllocationProfileNode(
+    v8::AllocationProfile* profile, const Vector<const char*>& names) {
+  v8::AllocationProfile::Node* node = profile->GetRootNode();
+  for (int i = 0; node != nullptr && i < names.length(); ++i) {
+    const char* name = names[i];
+    auto children = node->children;
+    node = nullptr;
+    for (v8::AllocationProfile::Node* child : children) {
+      v8::String::Utf8Value child_name(child->name);
+      if (strcmp(*child_name, name) == 0) {
+        node = child;
+        break;
+      }
+    }
+  }
+  return node;
+}
+
+
+TEST(SamplingHeapProfiler) {
+  v8::HandleScope scope(v8::Isolate::GetCurrent());
+  LocalContext env;
+  v8::HeapProfiler* heap_profiler = env->GetIsolate()->GetHeapProfiler();
+
+  // Turn off always_opt. Inlining can cause stack traces to be shorter than
+  // what we expect in this test.
+  v8::internal::FLAG_always_opt = false;
+
+  // Suppress randomness to avoid flakiness in tests.
+  v8::internal::FLAG_sampling_heap_profiler_suppress_randomness = true;
+
+  const char* script_source =
+      "var A = [];\n"
+      "function bar(size) { return new Array(size); }\n"
+      "var foo = function() {\n"
+      "  for (var i = 0; i < 1024; ++i) {\n"
+      "    A[i] = bar(1024);\n"
+      "  }\n"
+      "}\n"
+      "foo();";
+
+  // Sample should be empty if requested before sampling has started.
+  {
+    v8::AllocationProfile* profile = heap_profiler->GetAllocationProfile();
+    CHECK(profile == nullptr);
+  }
+
+  CHECK(heap_profiler->StartSamplingHeapProfiler(1024));
+  // A second profiler cannot be started while sampling.
+  CHECK(!heap_profiler->StartSamplingHeapProfiler(1024));
+  CompileRun(script_source);
+
+  v8::base::SmartPointer<v8::AllocationProfile> profile(
+      heap_profiler->GetAllocationProfile());
+  CHECK(!profile.is_empty());
+
+  const char* names[] = {"", "foo", "bar"};
+  const v8::AllocationProfile::Node* node_bar =
+      FindAllocationProfileNode(profile.get(), Vector<const char*>(names, 3));
+  CHECK(node_bar);
+  CHECK_EQ(2, node_bar->line_number);
+
+  // Count the number of allocations we sampled from bar.
+  int count_1024 = 0;
+  for (auto allocation : node_bar->allocations) {
+    count_1024 += allocation.count;
+  }
+
+  // We should have roughly 1024 allocations of 8KB each from bar. Since the
+  // sampling rate is also 1KB we should capture all of them.
+  CHECK_GE(count_1024, 1024 * 0.9);
+
+  // Dropping the arrays loses the samples.
+  CompileRun("A = [];");
+  CcTest::heap()->CollectAllAvailableGarbage();
+  v8::base::SmartPointer<v8::AllocationProfile> empty_profile(
+      heap_profiler->GetAllocationProfile());
+  const v8::AllocationProfile::Node* empty_bar = FindAllocationProfileNode(
+      empty_profile.get(), Vector<const char*>(names, 3));
+  CHECK(empty_bar);
+  CHECK_EQ(0u, empty_bar->allocations.size());
+
+  heap_profiler->StopSamplingHeapProfiler();
+}
@@ -34,15 +34,14 @@
 #include "src/ast/ast.h"
 #include "src/char-predicates-inl.h"
 #include "src/ostreams.h"
+#include "src/regexp/interpreter-irregexp.h"
 #include "src/regexp/jsregexp.h"
 #include "src/regexp/regexp-macro-assembler.h"
 #include "src/regexp/regexp-macro-assembler-irregexp.h"
 #include "src/regexp/regexp-parser.h"
 #include "src/splay-tree-inl.h"
 #include "src/string-stream.h"
-#ifdef V8_INTERPRETED_REGEXP
-#include "src/regexp/interpreter-irregexp.h"
-#else  // V8_INTERPRETED_REGEXP
+#ifndef V8_INTERPRETED_REGEXP
 #include "src/macro-assembler.h"
 #if V8_TARGET_ARCH_ARM
 #include "src/arm/assembler-arm.h"  // NOLINT
@@ -560,7 +559,7 @@ static RegExpNode* Compile(const char* input, bool multiline, bool unicode,
   Handle<String> sample_subject =
       isolate->factory()->NewStringFromUtf8(CStrVector("")).ToHandleChecked();
   RegExpEngine::Compile(isolate, zone, &compile_data, false, false, multiline,
-                        false, pattern, sample_subject, is_one_byte);
+                        false, pattern, sample_subject, is_one_byte, false);
   return compile_data.node;
 }
 
@@ -1411,7 +1410,8 @@ TEST(MacroAssemblerNativeLotsOfRegisters) {
   isolate->clear_pending_exception();
 }
 
-#else  // V8_INTERPRETED_REGEXP
+#endif  // V8_INTERPRETED_REGEXP
+
 
 TEST(MacroAssembler) {
   byte codes[1024];
@@ -1476,8 +1476,6 @@ TEST(MacroAssembler) {
   CHECK_EQ(42, captures[0]);
 }
 
-#endif  // V8_INTERPRETED_REGEXP
-
 
 TEST(AddInverseToTable) {
   static const int kLimit = 1000;
@@ -1938,3 +1936,59 @@ TEST(UseCountRegExp) {
   CHECK_EQ(1, use_counts[v8::Isolate::kRegExpPrototypeToString]);
   CHECK(resultToStringError->IsObject());
 }
+
+
+#ifndef V8_INTERPRETED_REGEXP
+
+static Handle<FixedArray> RegExpData(const char* name) {
+  Handle<Object> regexp = v8::Utils::OpenHandle(*CompileRun(name));
+  return handle(FixedArray::cast(Handle<JSRegExp>::cast(regexp)->data()));
+}
+
+
+TEST(RegExpTierUp) {
+  i::FLAG_regexp_tier_up = true;
+  i::FLAG_regexp_tier_up_ticks = 3;
+  CcTest::InitializeVM();
+  v8::HandleScope scope(CcTest::isolate());
+  CompileRun("var re = /x(y+)z/; var subject = 'wxyyz';");
+
+  CHECK_EQ(2, CompileRun("re.exec(subject)[1].length")
+                  ->Int32Value(CcTest::isolate()->GetCurrentContext())
+                  .FromJust());
+  Handle<FixedArray> data = RegExpData("re");
+  CHECK(RegExpImpl::IrregexpIsInterpreted(*data));
+  CHECK(data->get(JSRegExp::kIrregexpLatin1BytecodeIndex)->IsByteArray());
+  CHECK(data->get(JSRegExp::kIrregexpLatin1CodeIndex)->IsSmi());
+
+  CHECK(CompileRun("re.test(subject)")->IsTrue());
+  CHECK(RegExpImpl::IrregexpIsInterpreted(*data));
+
+  // A regexp literal with the same source and flags shares the data through
+  // the compilation cache, so its execution finishes the tier-up.
+  CompileRun("/x(y+)z/.test(subject)");
+  CHECK(!RegExpImpl::IrregexpIsInterpreted(*data));
+  CHECK(data->get(JSRegExp::kIrregexpLatin1BytecodeIndex)->IsSmi());
+  CHECK(data->get(JSRegExp::kIrregexpLatin1CodeIndex)->IsCode());
+  CHECK_EQ(2, CompileRun("re.exec(subject)[1].length")
+                  ->Int32Value(CcTest::isolate()->GetCurrentContext())
+                  .FromJust());
+}
+
+
+TEST(RegExpTierUpOnBacktrackStackOverflow) {
+  i::FLAG_regexp_tier_up = true;
+  i::FLAG_regexp_tier_up_ticks = 100;
+  CcTest::InitializeVM();
+  v8::HandleScope scope(CcTest::isolate());
+  // Matching needs more backtracking stack than the interpreter has, so the
+  // regexp has to tier up instead of throwing a stack overflow.
+  CompileRun(
+      "var re = /(?:a|b)*c/g;"
+      "var match = new Array(20001).join('ab') + 'c';"
+      "var result = (match + match + match).replace(re, 'x');");
+  CHECK(CompileRun("result === 'xxx'")->IsTrue());
+  CHECK(!RegExpImpl::IrregexpIsInterpreted(*RegExpData("re")));
+}
+
+#endif  // V8_INTERPRETED_REGEXP
@@ -724,6 +724,51 @@ TEST(PerIsolateSnapshotBlobs) {
 }
 
 
+static bool IsCompiled(const char* name) {
+  return i::Handle<i::JSFunction>::cast(
+             v8::Utils::OpenHandle(*CompileRun(name)))
+      ->shared()
+      ->is_compiled();
+}
+
+
+TEST(SnapshotDataBlobWithWarmup) {
+  DisableTurbofan();
+  const char* source =
+      "function f() { return g() * 2; }"
+      "function g() { return 43; }"
+      "function h() { return 44; }";
+  const char* warmup = "var a = f();";
+
+  v8::StartupData cold = v8::V8::CreateSnapshotDataBlob(source);
+  v8::StartupData warm = v8::V8::WarmUpSnapshotDataBlob(cold, warmup);
+  delete[] cold.data;
+  CHECK(warm.data != NULL);
+
+  v8::Isolate::CreateParams params;
+  params.snapshot_blob = &warm;
+  params.array_buffer_allocator = CcTest::array_buffer_allocator();
+
+  v8::Isolate* isolate = v8::Isolate::New(params);
+  {
+    v8::Isolate::Scope i_scope(isolate);
+    v8::HandleScope h_scope(isolate);
+    v8::Local<v8::Context> context = v8::Context::New(isolate);
+    delete[] warm.data;  // We can dispose of the snapshot blob now.
+    v8::Context::Scope c_scope(context);
+    // The state of the warm-up context is not captured, the code is.
+    CHECK(CompileRun("this.a")->IsUndefined());
+    CHECK(IsCompiled("f"));
+    CHECK(IsCompiled("g"));
+    CHECK(!IsCompiled("h"));
+    v8::Maybe<int32_t> result =
+        CompileRun("f()")->Int32Value(isolate->GetCurrentContext());
+    CHECK_EQ(86, result.FromJust());
+  }
+  isolate->Dispose();
+}
+
+
 static void SerializationFunctionTemplate(
     const v8::FunctionCallbackInfo<v8::Value>& args) {
   args.GetReturnValue().Set(args[0]);
@@ -976,6 +1021,88 @@ TEST(CodeCachePromotedToCompilationCache) {
 }
 
 
+TEST(SerializeToplevelEagerCompiledFunctions) {
+  FLAG_serialize_toplevel = true;
+  FLAG_serialize_eager = true;
+  LocalContext context;
+  Isolate* isolate = CcTest::i_isolate();
+
+  v8::HandleScope scope(CcTest::isolate());
+
+  const char* source =
+      "function used(x) { return x + 1; }"
+      "function unused(x) { return x - 1; }"
+      "used(1);";
+
+  Handle<String> orig_source = isolate->factory()
+                                   ->NewStringFromUtf8(CStrVector(source))
+                                   .ToHandleChecked();
+  Handle<String> copy_source = isolate->factory()
+                                   ->NewStringFromUtf8(CStrVector(source))
+                                   .ToHandleChecked();
+
+  Handle<JSObject> global(isolate->context()->global_object());
+  ScriptData* cache = NULL;
+
+  // Warm up: compile and run the script without producing a cache.
+  Handle<SharedFunctionInfo> orig =
+      CompileScript(isolate, orig_source, Handle<String>(), &cache,
+                    v8::ScriptCompiler::kNoCompileOptions);
+  Handle<JSFunction> orig_fun =
+      isolate->factory()->NewFunctionFromSharedFunctionInfo(
+          orig, isolate->native_context());
+  Execution::Call(isolate, orig_fun, global, 0, NULL).ToHandleChecked();
+
+  // The compilation cache returns the script that has run, and the code cache
+  // produced for it includes the functions compiled while it ran.
+  Handle<SharedFunctionInfo> produced =
+      CompileScript(isolate, orig_source, Handle<String>(), &cache,
+                    v8::ScriptCompiler::kProduceCodeCache);
+  CHECK(produced.is_identical_to(orig));
+  CHECK(cache != NULL);
+
+  isolate->compilation_cache()->Disable();  // Disable same-isolate code cache.
+
+  Handle<SharedFunctionInfo> copy;
+  {
+    DisallowCompilation no_compile_expected(isolate);
+    copy = CompileScript(isolate, copy_source, Handle<String>(), &cache,
+                         v8::ScriptCompiler::kConsumeCodeCache);
+  }
+  CHECK_NE(*orig, *copy);
+
+  int inner_functions = 0;
+  WeakFixedArray::Iterator iterator(
+      Script::cast(copy->script())->shared_function_infos());
+  SharedFunctionInfo* shared;
+  while ((shared = iterator.Next<SharedFunctionInfo>())) {
+    if (shared->is_toplevel()) continue;
+    String* name = String::cast(shared->name());
+    if (name->IsUtf8EqualTo(CStrVector("used"))) {
+      CHECK(shared->is_compiled());
+    } else {
+      CHECK(name->IsUtf8EqualTo(CStrVector("unused")));
+      CHECK(!shared->is_compiled());
+    }
+    inner_functions++;
+  }
+  CHECK_EQ(2, inner_functions);
+
+  Handle<JSFunction> copy_fun =
+      isolate->factory()->NewFunctionFromSharedFunctionInfo(
+          copy, isolate->native_context());
+  Handle<Object> copy_result;
+  {
+    DisallowCompilation no_compile_expected(isolate);
+    copy_result =
+        Execution::Call(isolate, copy_fun, global, 0, NULL).ToHandleChecked();
+  }
+  CHECK_EQ(2, Handle<Smi>::cast(copy_result)->value());
+
+  delete cache;
+}
+
+
 TEST(SerializeToplevelInternalizedString) {
   FLAG_serialize_toplevel = true;
   LocalContext context;
@@ -93,6 +93,32 @@ TEST(Run_WasmModule_CallAdd) {
 }
 
 
+TEST(Run_WasmModule_CallChain) {
+  // Enough functions to be compiled by several tasks.
+  static const int kNumFunctions = 64;
+  Zone zone;
+  WasmModuleBuilder* builder = new (&zone) WasmModuleBuilder(&zone);
+  uint16_t f_index = builder->AddFunction();
+  WasmFunctionBuilder* f = builder->FunctionAt(f_index);
+  f->ReturnType(kAstI32);
+  byte code0[] = {WASM_I8(0)};
+  f->EmitCode(code0, sizeof(code0));
+  for (int i = 1; i < kNumFunctions; i++) {
+    // Each function returns the result of the previous one plus one.
+    uint16_t callee_index = f_index;
+    f_index = builder->AddFunction();
+    f = builder->FunctionAt(f_index);
+    f->ReturnType(kAstI32);
+    if (i == kNumFunctions - 1) f->Exported(1);
+    byte code[] = {
+        WASM_I32_ADD(WASM_CALL_FUNCTION0(callee_index), WASM_I8(1))};
+    f->EmitCode(code, sizeof(code));
+  }
+  WasmModuleWriter* writer = builder->Build(&zone);
+  TestModule(writer->WriteTo(&zone), kNumFunctions - 1);
+}
+
+
 TEST(Run_WasmModule_ReadLoadedDataSegment) {
   static const byte kDataSegmentDest0 = 12;
   Zone zone;
@@ -51,6 +51,12 @@ TEST_F(BytecodeArrayBuilderTest, AllBytecodesGenerated) {
   Register other(1);
   builder.MoveRegister(reg, other);
 
+  // Emit fused bytecodes.
+  builder.LoadLiteral(Smi::FromInt(8))
+      .StoreAccumulatorInRegister(reg)
+      .LoadAccumulatorWithRegister(other)
+      .BinaryOperation(Token::Value::ADD, reg, Strength::WEAK);
+
   // Emit register-register exchanges.
   Register wide(150);
   builder.ExchangeRegisters(reg, wide);
@@ -624,6 +630,55 @@ TEST_F(BytecodeArrayBuilderTest, BackwardJumps) {
 }
 
 
+TEST_F(BytecodeArrayBuilderTest, FusedBytecodes) {
+  BytecodeArrayBuilder builder(isolate(), zone());
+  builder.set_parameter_count(0);
+  builder.set_locals_count(2);
+  builder.set_context_count(0);
+
+  Register reg0(0);
+  Register reg1(1);
+  BytecodeLabel label;
+
+  builder.LoadLiteral(Smi::FromInt(7))
+      .StoreAccumulatorInRegister(reg0)
+      .LoadAccumulatorWithRegister(reg0)
+      .LoadAccumulatorWithRegister(reg1)
+      .BinaryOperation(Token::Value::ADD, reg0, Strength::WEAK)
+      .LoadAccumulatorWithRegister(reg1)
+      .BinaryOperation(Token::Value::SUB, reg0, Strength::WEAK)
+      .LoadLiteral(Smi::FromInt(3))
+      .Bind(&label)
+      .StoreAccumulatorInRegister(reg1)
+      .Return();
+
+  Handle<BytecodeArray> array = builder.ToBytecodeArray();
+  BytecodeArrayIterator iterator(array);
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kLdaSmi8Star);
+  CHECK_EQ(iterator.GetImmediateOperand(0), 7);
+  CHECK_EQ(iterator.GetRegisterOperand(1).index(), reg0.index());
+  iterator.Advance();
+  // The load of reg0 is elided as the fused bytecode stored it.
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kLdarAdd);
+  CHECK_EQ(iterator.GetRegisterOperand(0).index(), reg1.index());
+  CHECK_EQ(iterator.GetRegisterOperand(1).index(), reg0.index());
+  iterator.Advance();
+  // Only additions are fused.
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kLdar);
+  iterator.Advance();
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kSub);
+  iterator.Advance();
+  // Bytecodes are not fused across basic blocks.
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kLdaSmi8);
+  iterator.Advance();
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kStar);
+  iterator.Advance();
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kReturn);
+  iterator.Advance();
+  CHECK(iterator.done());
+}
+
+
 TEST_F(BytecodeArrayBuilderTest, LabelReuse) {
   BytecodeArrayBuilder builder(isolate(), zone());
   builder.set_parameter_count(0);
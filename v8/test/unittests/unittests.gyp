@@ -116,6 +116,7 @@
         'wasm/encoder-unittest.cc',
         'wasm/module-decoder-unittest.cc',
         'wasm/wasm-macro-gen-unittest.cc',
+        'zone-segment-pool-unittest.cc',
       ],
       'conditions': [
         ['v8_target_arch=="arm"', {
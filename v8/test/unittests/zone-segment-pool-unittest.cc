@@ -0,0 +1,73 @@
+// Copyright 2016 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/zone.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace v8 {
+namespace internal {
+
+namespace {
+
+void AllocateInNewZone(size_t size) {
+  Zone zone;
+  zone.New(size);
+}
+
+}  // namespace
+
+
+TEST(ZoneSegmentPool, ReusesSegments) {
+  ZoneSegmentPool::ReleaseMemory();
+  ZoneSegmentPool::Statistics before;
+  ZoneSegmentPool::GetStatistics(&before);
+  AllocateInNewZone(100);
+  AllocateInNewZone(100);
+  ZoneSegmentPool::Statistics after;
+  ZoneSegmentPool::GetStatistics(&after);
+  EXPECT_LT(before.reused_segments, after.reused_segments);
+  EXPECT_LT(0u, after.pooled_bytes);
+}
+
+
+TEST(ZoneSegmentPool, ReusesSegmentsFromThreadCache) {
+  ZoneSegmentPool::ReleaseMemory();
+  ZoneSegmentPool::Statistics before;
+  ZoneSegmentPool::GetStatistics(&before);
+  {
+    ZoneSegmentPool::ThreadCacheScope scope;
+    AllocateInNewZone(100);
+    AllocateInNewZone(100);
+    // The segments stay in the thread cache until the scope is left.
+    ZoneSegmentPool::Statistics during;
+    ZoneSegmentPool::GetStatistics(&during);
+    EXPECT_EQ(0u, during.pooled_bytes);
+  }
+  ZoneSegmentPool::Statistics after;
+  ZoneSegmentPool::GetStatistics(&after);
+  EXPECT_LT(before.thread_cache_reused_segments,
+            after.thread_cache_reused_segments);
+  EXPECT_LT(0u, after.pooled_bytes);
+}
+
+
+TEST(ZoneSegmentPool, ReleaseMemory) {
+  AllocateInNewZone(100);
+  ZoneSegmentPool::ReleaseMemory();
+  ZoneSegmentPool::Statistics statistics;
+  ZoneSegmentPool::GetStatistics(&statistics);
+  EXPECT_EQ(0u, statistics.pooled_bytes);
+}
+
+
+TEST(ZoneSegmentPool, LargeSegmentsAreNotPooled) {
+  ZoneSegmentPool::ReleaseMemory();
+  AllocateInNewZone(2 * MB);
+  ZoneSegmentPool::Statistics statistics;
+  ZoneSegmentPool::GetStatistics(&statistics);
+  EXPECT_EQ(0u, statistics.pooled_bytes);
+}
+
+}  // namespace internal
+}  // namespace v8
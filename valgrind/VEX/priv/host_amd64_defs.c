@@ -1995,6 +1995,27 @@ void genReload_AMD64 ( /*OUT*/HInstr** i1, /*OUT*/HInstr** i2,
    }
 }
 
+/* Generate a real reg-reg move, for the register allocator to use
+   instead of a spill when a vreg has to vacate its rreg.  Like the
+   spill/reload insns, this must not write the condition codes. */
+
+AMD64Instr* genMove_AMD64 ( HReg from, HReg to, Bool mode64 )
+{
+   vassert(!hregIsVirtual(from));
+   vassert(!hregIsVirtual(to));
+   vassert(hregClass(from) == hregClass(to));
+   vassert(mode64 == True);
+   switch (hregClass(from)) {
+      case HRcInt64:
+         return AMD64Instr_Alu64R ( Aalu_MOV, AMD64RMI_Reg(from), to );
+      case HRcVec128:
+         return AMD64Instr_SseReRg ( Asse_MOV, from, to );
+      default: 
+         ppHRegClass(hregClass(from));
+         vpanic("genMove_AMD64: unimplemented regclass");
+   }
+}
+
 
 /* --------- The amd64 assembler (bleh.) --------- */
 
@@ -801,6 +801,7 @@ extern void genSpill_AMD64  ( /*OUT*/HInstr** i1, /*OUT*/HInstr** i2,
                               HReg rreg, Int offset, Bool );
 extern void genReload_AMD64 ( /*OUT*/HInstr** i1, /*OUT*/HInstr** i2,
                               HReg rreg, Int offset, Bool );
+extern AMD64Instr* genMove_AMD64 ( HReg from, HReg to, Bool );
 
 extern const RRegUniverse* getRRegUniverse_AMD64 ( void );
 
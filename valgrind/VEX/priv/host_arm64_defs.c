@@ -2583,6 +2583,28 @@ void genReload_ARM64 ( /*OUT*/HInstr** i1, /*OUT*/HInstr** i2,
    }
 }
 
+/* Generate a real reg-reg move, for the register allocator to use
+   instead of a spill when a vreg has to vacate its rreg. */
+
+ARM64Instr* genMove_ARM64 ( HReg from, HReg to, Bool mode64 )
+{
+   vassert(!hregIsVirtual(from));
+   vassert(!hregIsVirtual(to));
+   vassert(hregClass(from) == hregClass(to));
+   vassert(mode64 == True);
+   switch (hregClass(from)) {
+      case HRcInt64:
+         return ARM64Instr_MovI(to, from);
+      case HRcFlt64:
+         return ARM64Instr_VMov(8, to, from);
+      case HRcVec128:
+         return ARM64Instr_VMov(16, to, from);
+      default:
+         ppHRegClass(hregClass(from));
+         vpanic("genMove_ARM64: unimplemented regclass");
+   }
+}
+
 
 /* Emit an instruction into buf and return the number of bytes used.
    Note that buf is not the insn's final place, and therefore it is
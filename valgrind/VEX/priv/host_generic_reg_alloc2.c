@@ -190,6 +190,57 @@ Int findMostDistantlyMentionedVReg (
 }
 
 
+/* A vreg bound to rreg |excl| is about to be displaced because
+   |excl| is entering a hard live range.  Look for some other Free
+   rreg of class |rclass| into which the vreg can be moved instead of
+   being spilled.  To be worth it, the candidate must not itself enter
+   a hard live range before the vreg dies (at |dead_before|), else we
+   would merely have postponed the spill.  |lrs_la| is the real-reg
+   live range array sorted by .live_after, and |lrs_from| is the index
+   of the first entry not yet processed.  Candidates which are not
+   involved in any HLRs are preferred, since they can never be taken
+   away again.
+
+   Returns an index into the state array, or INVALID_RREG_NO if there
+   is no suitable rreg. */
+static
+Int findMoveTargetRReg (
+   const RRegUniverse* univ,
+   RRegState*   state,
+   Int          n_state,
+   RRegLR*      lrs_la,
+   Int          lrs_from,
+   Int          lrs_used,
+   HRegClass    rclass,
+   Int          excl,
+   Short        dead_before
+)
+{
+   Bool blocked[N_RREGUNIVERSE_REGS];
+   Int  k, best = INVALID_RREG_NO;
+
+   for (k = 0; k < n_state; k++)
+      blocked[k] = False;
+   for (k = lrs_from; k < lrs_used; k++) {
+      if (lrs_la[k].live_after >= dead_before)
+         break;
+      blocked[hregIndex(lrs_la[k].rreg)] = True;
+   }
+
+   for (k = 0; k < n_state; k++) {
+      if (k == excl || blocked[k] || state[k].disp != Free)
+         continue;
+      if (hregClass(univ->regs[k]) != rclass)
+         continue;
+      if (!state[k].has_hlrs)
+         return k;
+      if (best == INVALID_RREG_NO)
+         best = k;
+   }
+   return best;
+}
+
+
 /* Check that this vreg has been assigned a sane spill offset. */
 inline
 static void sanity_check_spill_offset ( VRegLR* vreg )
@@ -382,6 +433,12 @@ HInstrArray* doRegisterAllocation (
    void    (*genSpill)  ( HInstr**, HInstr**, HReg, Int, Bool ),
    void    (*genReload) ( HInstr**, HInstr**, HReg, Int, Bool ),
    HInstr* (*directReload) ( HInstr*, HReg, Short ),
+
+   /* Optionally, return an insn which copies the first real reg to
+      the second.  It must not modify the condition codes.  May be
+      NULL, in which case vregs displaced by hard live ranges are
+      always spilled rather than moved to another rreg. */
+   HInstr* (*genMove) ( HReg, HReg, Bool ),
    Int     guest_sizeB,
 
    /* For debug printing only. */
@@ -1178,8 +1235,9 @@ HInstrArray* doRegisterAllocation (
          will have to free up the rreg.  The simplest solution which
          is correct is to spill the rreg.
 
-         Note we could do better:
-         * Could move it into some other free rreg, if one is available 
+         If the host supplies genMove, we do better where we can:
+         the vreg is moved into some other free rreg, provided that
+         rreg stays out of HLRs until the vreg dies.
 
          Do this efficiently, by incrementally stepping along an array
          of rreg HLRs that are known to be sorted by start point
@@ -1215,10 +1273,34 @@ HInstrArray* doRegisterAllocation (
          vassert(IS_VALID_RREGNO(k));
          Int m = hregIndex(rreg_state[k].vreg);
          if (rreg_state[k].disp == Bound) {
-            /* Yes, there is an associated vreg.  Spill it if it's
-               still live. */
+            /* Yes, there is an associated vreg.  If it's still live,
+               move it to some other free rreg if the host allows
+               that and a suitable one exists, else spill it. */
             vassert(IS_VALID_VREGNO(m));
             vreg_state[m] = INVALID_RREG_NO;
+            Int k2 = INVALID_RREG_NO;
+            if (genMove && vreg_lrs[m].dead_before > ii)
+               k2 = findMoveTargetRReg( univ, rreg_state, n_rregs,
+                                        rreg_lrs_la, rreg_lrs_la_next + 1,
+                                        rreg_lrs_used, vreg_lrs[m].reg_class,
+                                        k, vreg_lrs[m].dead_before );
+            if (k2 != INVALID_RREG_NO) {
+               vassert(IS_VALID_RREGNO(k2));
+               if (DEBUG_REGALLOC) {
+                  vex_printf("move ");
+                  (*ppReg)(univ->regs[k]);
+                  vex_printf(" -> ");
+                  (*ppReg)(univ->regs[k2]);
+                  vex_printf(" instead of spilling\n\n");
+               }
+               EMIT_INSTR( (*genMove)(univ->regs[k], univ->regs[k2],
+                                      mode64) );
+               rreg_state[k2].disp          = Bound;
+               rreg_state[k2].vreg          = rreg_state[k].vreg;
+               rreg_state[k2].eq_spill_slot = rreg_state[k].eq_spill_slot;
+               vreg_state[m] = toShort(k2);
+            }
+            else
             if (vreg_lrs[m].dead_before > ii) {
                vassert(vreg_lrs[m].reg_class != HRcINVALID);
                if ((!eq_spill_opt) || !rreg_state[k].eq_spill_slot) {
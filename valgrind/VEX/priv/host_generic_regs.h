@@ -464,10 +464,12 @@ HInstrArray* doRegisterAllocation (
    void (*mapRegs) (HRegRemap*, HInstr*, Bool),
 
    /* Return insn(s) to spill/restore a real reg to a spill slot
-      offset.  And optionally a function to do direct reloads. */
+      offset.  And optionally a function to do direct reloads, and
+      one to generate a real reg-reg move. */
    void    (*genSpill) (  HInstr**, HInstr**, HReg, Int, Bool ),
    void    (*genReload) ( HInstr**, HInstr**, HReg, Int, Bool ),
    HInstr* (*directReload) ( HInstr*, HReg, Short ),
+   HInstr* (*genMove) ( HReg, HReg, Bool ),
    Int     guest_sizeB,
 
    /* For debug printing only. */
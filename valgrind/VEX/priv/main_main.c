@@ -329,6 +329,7 @@ VexTranslateResult LibVEX_Translate ( VexTranslateArgs* vta )
    void         (*genSpill)     ( HInstr**, HInstr**, HReg, Int, Bool );
    void         (*genReload)    ( HInstr**, HInstr**, HReg, Int, Bool );
    HInstr*      (*directReload) ( HInstr*, HReg, Short );
+   HInstr*      (*genMove)      ( HReg, HReg, Bool );
    void         (*ppInstr)      ( const HInstr*, Bool );
    void         (*ppReg)        ( HReg );
    HInstrArray* (*iselSB)       ( const IRSB*, VexArch, const VexArchInfo*,
@@ -365,6 +366,7 @@ VexTranslateResult LibVEX_Translate ( VexTranslateArgs* vta )
    genSpill               = NULL;
    genReload              = NULL;
    directReload           = NULL;
+   genMove                = NULL;
    ppInstr                = NULL;
    ppReg                  = NULL;
    iselSB                 = NULL;
@@ -433,6 +435,7 @@ VexTranslateResult LibVEX_Translate ( VexTranslateArgs* vta )
          mapRegs      = (__typeof__(mapRegs)) AMD64FN(mapRegs_AMD64Instr);
          genSpill     = (__typeof__(genSpill)) AMD64FN(genSpill_AMD64);
          genReload    = (__typeof__(genReload)) AMD64FN(genReload_AMD64);
+         genMove      = (__typeof__(genMove)) AMD64FN(genMove_AMD64);
          ppInstr      = (__typeof__(ppInstr)) AMD64FN(ppAMD64Instr);
          ppReg        = (__typeof__(ppReg)) AMD64FN(ppHRegAMD64);
          iselSB       = AMD64FN(iselSB_AMD64);
@@ -522,6 +525,7 @@ VexTranslateResult LibVEX_Translate ( VexTranslateArgs* vta )
          mapRegs      = (__typeof__(mapRegs)) ARM64FN(mapRegs_ARM64Instr);
          genSpill     = (__typeof__(genSpill)) ARM64FN(genSpill_ARM64);
          genReload    = (__typeof__(genReload)) ARM64FN(genReload_ARM64);
+         genMove      = (__typeof__(genMove)) ARM64FN(genMove_ARM64);
          ppInstr      = (__typeof__(ppInstr)) ARM64FN(ppARM64Instr);
          ppReg        = (__typeof__(ppReg)) ARM64FN(ppHRegARM64);
          iselSB       = ARM64FN(iselSB_ARM64);
@@ -1038,7 +1042,7 @@ VexTranslateResult LibVEX_Translate ( VexTranslateArgs* vta )
    rcode = doRegisterAllocation ( vcode, rRegUniv,
                                   isMove, getRegUsage, mapRegs, 
                                   genSpill, genReload, directReload, 
-                                  guest_sizeB,
+                                  genMove, guest_sizeB,
                                   ppInstr, ppReg, mode64 );
 
    vexAllocSanityCheck();
@@ -1650,6 +1650,11 @@ static void cg_fini(Int exitcode)
                 l1, LL_total_m  * 100.0 / (Ir_total.a + D_total.a),
                 l2, LL_total_mr * 100.0 / (Ir_total.a + Dr_total.a),
                 l3, LL_total_mw * 100.0 / Dw_total.a);
+
+      if (clo_prefetch != PF_None) {
+         VG_(sprintf)(fmt, "%%s %%,%dllu\n", l1);
+         VG_(umsg)(fmt, "LL prefetches:", pf_issued);
+      }
    }
 
    /* If branch profiling is enabled, show branch overall results. */
@@ -1748,6 +1753,12 @@ static Bool cg_process_cmd_line_option(const HChar* arg)
    else if VG_STR_CLO( arg, "--cachegrind-out-file", clo_cachegrind_out_file) {}
    else if VG_BOOL_CLO(arg, "--cache-sim",  clo_cache_sim)  {}
    else if VG_BOOL_CLO(arg, "--branch-sim", clo_branch_sim) {}
+   else if VG_XACT_CLO(arg, "--prefetch=none",
+                            clo_prefetch, PF_None) {}
+   else if VG_XACT_CLO(arg, "--prefetch=next-line",
+                            clo_prefetch, PF_NextLine) {}
+   else if VG_XACT_CLO(arg, "--prefetch=stride",
+                            clo_prefetch, PF_Stride) {}
    else
       return False;
 
@@ -1760,6 +1771,8 @@ static void cg_print_usage(void)
    VG_(printf)(
 "    --cache-sim=yes|no  [yes]        collect cache stats?\n"
 "    --branch-sim=yes|no [no]         collect branch prediction stats?\n"
+"    --prefetch=none|next-line|stride [none]\n"
+"                                     model a data prefetcher filling LL\n"
 "    --cachegrind-out-file=<file>     output file name [cachegrind.out.%%p]\n"
    );
 }
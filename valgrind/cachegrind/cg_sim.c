@@ -167,11 +167,117 @@ static cache_t2 LL;
 static cache_t2 I1;
 static cache_t2 D1;
 
+/* Install a line in a cache without it counting as a reference: used
+   for prefetches.  If the line is already present it is left where it
+   is in the LRU order, as a hardware prefetch hit does not make the
+   line more recently used.  Otherwise it is installed as MRU.
+   Returns True iff the line was installed. */
+static Bool cachesim_setref_install(cache_t2* c, UInt set_no, UWord tag)
+{
+   Int    i, j;
+   UWord* set = &(c->tags[set_no * c->assoc]);
+
+   for (i = 0; i < c->assoc; i++) {
+      if (tag == set[i])
+         return False;
+   }
+   for (j = c->assoc - 1; j > 0; j--) {
+      set[j] = set[j - 1];
+   }
+   set[0] = tag;
+   return True;
+}
+
+/* Optional model of a hardware data prefetcher feeding the LL cache.
+   It only sees D1 misses, as the L2 streamers of real machines do.
+   Two policies are provided:
+
+   - next-line: every D1 miss also fetches the following line into LL.
+
+   - stride: a small table of streams, indexed by 4KB page, remembers
+     the last line missed in each page and the distance to the one
+     before.  Once the same non-zero line stride has been seen twice
+     in a row, the next PF_DEGREE lines along that stride are fetched
+     into LL.  Like real prefetchers it does not cross page
+     boundaries.
+
+   Prefetches are not counted as references or misses; they only
+   change which later accesses hit in LL. */
+typedef enum { PF_None, PF_NextLine, PF_Stride } PrefetchKind;
+
+static PrefetchKind clo_prefetch = PF_None;
+
+#define PF_N_STREAMS  16
+#define PF_DEGREE     2
+#define PF_PAGE_BITS  12
+
+typedef struct {
+   UWord page;         /* page number this entry tracks */
+   UWord last_block;   /* last line missed in the page */
+   Word  stride;       /* last observed line stride */
+   Bool  confirmed;    /* stride seen twice in a row? */
+} pf_stream;
+
+static pf_stream pf_streams[PF_N_STREAMS];
+static ULong     pf_issued = 0;   /* lines actually installed */
+
+static void cachesim_prefetch_block(UWord block)
+{
+   if (cachesim_setref_install(&LL, block & LL.sets_min_1, block))
+      pf_issued++;
+}
+
+static void cachesim_prefetch(Addr a)
+{
+   UWord block = a >> LL.line_size_bits;
+   UWord page  = a >> PF_PAGE_BITS;
+
+   if (clo_prefetch == PF_NextLine) {
+      if (((block + 1) << LL.line_size_bits) >> PF_PAGE_BITS == page)
+         cachesim_prefetch_block(block + 1);
+      return;
+   }
+
+   /* PF_Stride */
+   pf_stream* s = &pf_streams[page % PF_N_STREAMS];
+   if (s->page != page) {
+      s->page       = page;
+      s->last_block = block;
+      s->stride     = 0;
+      s->confirmed  = False;
+      return;
+   }
+   Word stride = (Word)(block - s->last_block);
+   if (stride == 0)
+      return;
+   s->confirmed  = (stride == s->stride);
+   s->stride     = stride;
+   s->last_block = block;
+   if (s->confirmed) {
+      Int k;
+      for (k = 1; k <= PF_DEGREE; k++) {
+         UWord b = block + k * stride;
+         if ((b << LL.line_size_bits) >> PF_PAGE_BITS != page)
+            break;
+         cachesim_prefetch_block(b);
+      }
+   }
+}
+
 static void cachesim_initcaches(cache_t I1c, cache_t D1c, cache_t LLc)
 {
+   Int i;
+
    cachesim_initcache(I1c, &I1);
    cachesim_initcache(D1c, &D1);
    cachesim_initcache(LLc, &LL);
+
+   for (i = 0; i < PF_N_STREAMS; i++) {
+      pf_streams[i].page       = ~(UWord)0;
+      pf_streams[i].last_block = 0;
+      pf_streams[i].stride     = 0;
+      pf_streams[i].confirmed  = False;
+   }
 }
 
 __attribute__((always_inline))
@@ -211,6 +317,8 @@ void cachesim_D1_doref(Addr a, UChar size, ULong* m1, ULong *mL)
       (*m1)++;
       if (cachesim_ref_is_miss(&LL, a, size))
          (*mL)++;
+      if (UNLIKELY(clo_prefetch != PF_None))
+         cachesim_prefetch(a);
    }
 }
 
@@ -225,6 +225,9 @@ static void free_DebugInfo ( DebugInfo* di )
    if (di->cfsi_m_pool)  VG_(deleteDedupPA)(di->cfsi_m_pool);
    if (di->cfsi_exprs)   VG_(deleteXA)(di->cfsi_exprs);
    if (di->fpo)          ML_(dinfo_free)(di->fpo);
+#  if defined(VGO_linux) || defined(VGO_solaris)
+   ML_(discard_deferred_varinfo)(di);
+#  endif
 
    if (di->symtab) {
       /* We have to visit all the entries so as to free up any
@@ -3142,6 +3145,17 @@ Bool VG_(FPO_info_present)(void)
 /*---                                                        ---*/
 /*--------------------------------------------------------------*/
 
+/* With --lazy-var-info=yes, variable info is only read when it is
+   first needed.  Call this before looking at di->varinfo. */
+static void ensure_varinfo ( DebugInfo* di )
+{
+#  if defined(VGO_linux) || defined(VGO_solaris)
+   if (UNLIKELY(di->deferred_varinfo != NULL))
+      ML_(read_deferred_varinfo)( di );
+#  endif
+}
+
+
 /* Try to make p2XA(dst, fmt, args..) turn into
    VG_(xaprintf)(dst, fmt, args) without having to resort to
    vararg macros.  As usual with everything to do with varargs, it's
@@ -3580,6 +3594,7 @@ Bool consider_vars_in_frame ( /*MOD*/XArray* /* of HChar */ dname1,
    /* End of performance-enhancing hack. */
 
    /* any var info at all? */
+   ensure_varinfo( di );
    if (!di->varinfo)
       return False;
 
@@ -3698,6 +3713,7 @@ Bool VG_(get_data_description)(
       if (!di->text_present || di->text_size == 0)
          continue;
       /* any var info at all? */
+      ensure_varinfo( di );
       if (!di->varinfo)
          continue;
       /* perhaps this object didn't contribute any vars at all? */
@@ -4024,6 +4040,7 @@ VG_(di_get_stack_blocks_at_ip)( Addr ip, Bool arrays_only )
    /* End of performance-enhancing hack. */
 
    /* any var info at all? */
+   ensure_varinfo( di );
    if (!di->varinfo)
       return res; /* currently empty */
 
@@ -4116,6 +4133,7 @@ VG_(di_get_global_blocks_from_dihandle) ( ULong di_handle, Bool  arrays_only )
                        ML_(dinfo_free), sizeof(GlobalBlock) );
 
    /* any var info at all? */
+   ensure_varinfo( di );
    if (!di->varinfo)
       return gvars;
 
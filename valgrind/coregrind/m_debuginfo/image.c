@@ -791,6 +791,12 @@ DiOffT ML_(img_size)(const DiImage* img)
    return img->size;
 }
 
+const HChar* ML_(img_local_filename)(const DiImage* img)
+{
+   vg_assert(img);
+   return img->source.is_local ? img->source.name : NULL;
+}
+
 inline Bool ML_(img_valid)(const DiImage* img, DiOffT offset, SizeT size)
 {
    vg_assert(img);
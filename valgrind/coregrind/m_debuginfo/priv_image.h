@@ -77,6 +77,10 @@ void ML_(img_done)(DiImage*);
 /* How big is the image? */
 DiOffT ML_(img_size)(const DiImage* img);
 
+/* The path of the file the image was read from, or NULL if it came
+   from a debuginfo server. */
+const HChar* ML_(img_local_filename)(const DiImage* img);
+
 /* Does the section [offset, +size) exist in the image? */
 Bool ML_(img_valid)(const DiImage* img, DiOffT offset, SizeT size);
 
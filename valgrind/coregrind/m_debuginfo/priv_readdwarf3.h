@@ -40,7 +40,8 @@
 #include "pub_core_debuginfo.h"   // DebugInfo
 #include "priv_image.h"           // DiSlice
 
-/* Read variables and types from DWARF3 ".debug_info" sections. */
+/* Read variables and types (if read_var_info) and/or inlined call
+   info (if read_inline_info) from DWARF3 ".debug_info" sections. */
 void 
 ML_(new_dwarf3_reader) (
    DebugInfo* di,
@@ -49,7 +50,8 @@ ML_(new_dwarf3_reader) (
    DiSlice escn_debug_str,       DiSlice escn_debug_ranges,
    DiSlice escn_debug_loc,       DiSlice escn_debug_info_alt,
    DiSlice escn_debug_abbv_alt,  DiSlice escn_debug_line_alt,
-   DiSlice escn_debug_str_alt
+   DiSlice escn_debug_str_alt,
+   Bool read_var_info,           Bool read_inline_info
 );
 
 #endif /* ndef __PRIV_READDWARF3_H */
@@ -54,6 +54,13 @@ extern Bool ML_(is_elf_object_file)( const void* image, SizeT n_image,
 */
 extern Bool ML_(read_elf_debug_info) ( DebugInfo* di );
 
+/* With --lazy-var-info=yes, ML_(read_elf_debug_info) only notes where
+   the DWARF3 variable and type info is.  Read it now. */
+extern void ML_(read_deferred_varinfo) ( DebugInfo* di );
+
+/* Throw away the note, without reading anything. */
+extern void ML_(discard_deferred_varinfo) ( DebugInfo* di );
+
 
 #endif /* ndef __PRIV_READELF_H */
 
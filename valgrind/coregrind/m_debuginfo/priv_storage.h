@@ -992,6 +992,13 @@ struct _DebugInfo {
    /* An array of guarded DWARF3 expressions. */
    XArray* admin_gexprs;
 
+   /* With --lazy-var-info=yes, the three fields above are not filled
+      in when the object is loaded.  Instead this records where in
+      which files the DWARF lives, and ML_(read_deferred_varinfo)
+      reads it the first time it is asked for.  NULL when there is
+      nothing left to read. */
+   struct _DeferredVarInfo* deferred_varinfo;
+
    /* Cached last rx mapping matched and returned by ML_(find_rx_mapping).
       This helps performance a lot during ML_(addLineInfo) etc., which can
       easily be invoked hundreds of thousands of times. */
@@ -1090,6 +1097,11 @@ extern void ML_(addVar)( struct _DebugInfo* di,
    this after finishing adding entries to these tables. */
 extern void ML_(canonicaliseTables) ( struct _DebugInfo* di );
 
+/* Likewise for the variable info, when that is read after the rest
+   (--lazy-var-info=yes).  ML_(canonicaliseTables) leaves the string
+   pools unfrozen in that case, and this freezes them. */
+extern void ML_(canonicaliseDeferredVarInfo) ( struct _DebugInfo* di );
+
 /* Canonicalise the call-frame-info table held by 'di', in preparation
    for use. This is called by ML_(canonicaliseTables) but can also be
    called on it's own to sort just this table. */
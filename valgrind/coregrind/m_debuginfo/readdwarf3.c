@@ -164,6 +164,12 @@
    if (UNLIKELY(td3)) { VG_(printf)(format, ## args); }
 #define TD3 (UNLIKELY(td3))
 
+/* What the current ML_(new_dwarf3_reader) call is to read.  Usually
+   VG_(clo_read_var_info) and VG_(clo_read_inline_info), except when
+   the variable info is read in a separate, deferred, pass. */
+static Bool d3_read_var_info    = False;
+static Bool d3_read_inline_info = False;
+
 #define D3_INVALID_CUOFF  ((UWord)(-1UL))
 #define D3_FAKEVOID_CUOFF ((UWord)(-2UL))
 
@@ -1374,7 +1380,7 @@ void get_Form_contents ( /*OUT*/FormContents* cts,
          }
 
          /* cc->signature_types is only built/initialised when
-            VG_(clo_read_var_info) is set. In this case,
+            d3_read_var_info is set. In this case,
             the DW_FORM_ref_sig8 can be looked up.
             But we can also arrive here when only reading inline info
             and VG_(clo_trace_symtab) is set. In such a case,
@@ -1383,7 +1389,7 @@ void get_Form_contents ( /*OUT*/FormContents* cts,
             the 'dwarf inline info reader' tracing would have to
             do type processing/reading. It is better to avoid
             adding significant 'real' processing only due to tracing. */
-         if (VG_(clo_read_var_info)) {
+         if (d3_read_var_info) {
             /* Due to the way that the hash table is constructed, the
                resulting DIE offset here is already "cooked".  See
                cook_die_using_form.  */
@@ -1391,7 +1397,7 @@ void get_Form_contents ( /*OUT*/FormContents* cts,
                                                  c->barf);
          } else {
             vg_assert (td3);
-            vg_assert (VG_(clo_read_inline_info));
+            vg_assert (d3_read_inline_info);
             TRACE_D3("<not dereferencing signature type>");
             cts->u.val = 0; /* Assign a dummy/rubbish value */
          }
@@ -4201,7 +4207,7 @@ static void read_DIE (
    start_die_c_offset  = get_position_of_Cursor( c );
    after_die_c_offset  = 0; // set to c position if a parser has read the DIE.
 
-   if (VG_(clo_read_var_info)) {
+   if (d3_read_var_info) {
       parse_type_DIE( tyents,
                       typarser,
                       (DW_TAG)atag,
@@ -4237,7 +4243,7 @@ static void read_DIE (
       // the value of sibling.
    }
 
-   if (VG_(clo_read_inline_info)) {
+   if (d3_read_inline_info) {
       inlparser->sibling = 0;
       parse_children = 
          parse_inl_DIE( inlparser,
@@ -4500,7 +4506,7 @@ void new_dwarf3_reader_wrk (
       according to VG_(clo_read_*_info). */
    VG_(memset)( &inlparser, 0, sizeof(inlparser) );
 
-   if (VG_(clo_read_var_info)) {
+   if (d3_read_var_info) {
       /* We'll park the harvested type information in here.  Also create
          a fake "void" entry with offset D3_FAKEVOID_CUOFF, so we always
          have at least one type entry to refer to.  D3_FAKEVOID_CUOFF is
@@ -4562,7 +4568,7 @@ void new_dwarf3_reader_wrk (
       fill in the signatured types hash table.  This lets us handle
       mapping from a type signature to a (cooked) DIE offset directly
       in get_Form_contents.  */
-   if (VG_(clo_read_var_info) && ML_(sli_is_valid)(escn_debug_types)) {
+   if (d3_read_var_info && ML_(sli_is_valid)(escn_debug_types)) {
       init_Cursor( &info, escn_debug_types, 0, barf,
                    "Overrun whilst reading .debug_types section" );
       TRACE_D3("\n------ Collecting signatures from "
@@ -4635,7 +4641,7 @@ void new_dwarf3_reader_wrk (
       } else {
          if (!ML_(sli_is_valid)(escn_debug_types))
             continue;
-         if (!VG_(clo_read_var_info))
+         if (!d3_read_var_info)
             continue; // Types not needed when only reading inline info.
          init_Cursor( &info, escn_debug_types, 0, barf,
                       "Overrun whilst reading .debug_types section" );
@@ -4679,7 +4685,7 @@ void new_dwarf3_reader_wrk (
             break;
          }
 
-         if (VG_(clo_read_var_info)) {
+         if (d3_read_var_info) {
             /* Check the varparser's stack is in a sane state. */
             vg_assert(varparser.sp == -1);
             /* Check the typarser's stack is in a sane state. */
@@ -4720,7 +4726,7 @@ void new_dwarf3_reader_wrk (
          cc.cu_svma_known = False;
          cc.cu_svma       = 0;
 
-         if (VG_(clo_read_var_info)) {
+         if (d3_read_var_info) {
             cc.signature_types = signature_types;
 
             /* Create a fake outermost-level range covering the entire
@@ -4743,7 +4749,7 @@ void new_dwarf3_reader_wrk (
                              sizeof(UInt) );
          }
 
-         if (VG_(clo_read_inline_info)) {
+         if (d3_read_inline_info) {
             /* fndn_ix_Table for the inlined call parser */
             vg_assert(!inlparser.fndn_ix_Table );
             inlparser.fndn_ix_Table 
@@ -4753,7 +4759,7 @@ void new_dwarf3_reader_wrk (
          }
 
          /* Now read the one-and-only top-level DIE for this CU. */
-         vg_assert(!VG_(clo_read_var_info) || varparser.sp == 0);
+         vg_assert(!d3_read_var_info || varparser.sp == 0);
          read_DIE( rangestree,
                    tyents, tempvars, gexprs,
                    &typarser, &varparser, &inlparser,
@@ -4790,7 +4796,7 @@ void new_dwarf3_reader_wrk (
             cu_amount_used = cu_offset_now - cc.cu_start_offset;
          }
 
-         if (VG_(clo_read_var_info)) {
+         if (d3_read_var_info) {
             /* Preen to level -2.  DIEs have level >= 0 so -2 cannot occur
                anywhere else at all.  Our fake the-entire-address-space
                range is at level -1, so preening to -2 should completely
@@ -4801,12 +4807,12 @@ void new_dwarf3_reader_wrk (
             typestack_preen( &typarser, td3, -2 );
          }
 
-         if (VG_(clo_read_var_info)) {
+         if (d3_read_var_info) {
             vg_assert(varparser.fndn_ix_Table );
             VG_(deleteXA)( varparser.fndn_ix_Table );
             varparser.fndn_ix_Table = NULL;
          }
-         if (VG_(clo_read_inline_info)) {
+         if (d3_read_inline_info) {
             vg_assert(inlparser.fndn_ix_Table );
             VG_(deleteXA)( inlparser.fndn_ix_Table );
             inlparser.fndn_ix_Table = NULL;
@@ -4820,7 +4826,7 @@ void new_dwarf3_reader_wrk (
    }
 
 
-   if (VG_(clo_read_var_info)) {
+   if (d3_read_var_info) {
       /* From here on we're post-processing the stuff we got
          out of the .debug_info section. */
       if (TD3) {
@@ -5146,7 +5152,7 @@ void new_dwarf3_reader_wrk (
    }
 
    // Free up dynamically allocated memory
-   if (VG_(clo_read_var_info)) {
+   if (d3_read_var_info) {
       type_parser_release(&typarser);
       var_parser_release(&varparser);
    }
@@ -5180,12 +5186,17 @@ ML_(new_dwarf3_reader) (
    DiSlice escn_debug_str,       DiSlice escn_debug_ranges,
    DiSlice escn_debug_loc,       DiSlice escn_debug_info_alt,
    DiSlice escn_debug_abbv_alt,  DiSlice escn_debug_line_alt,
-   DiSlice escn_debug_str_alt
+   DiSlice escn_debug_str_alt,
+   Bool read_var_info,           Bool read_inline_info
 )
 {
    volatile Int  jumped;
    volatile Bool td3 = di->trace_symtab;
 
+   vg_assert(read_var_info || read_inline_info);
+   d3_read_var_info    = read_var_info;
+   d3_read_inline_info = read_inline_info;
+
    /* Run the _wrk function to read the dwarf3.  If it succeeds, it
       just returns normally.  If there is any failure, it longjmp's
       back here, having first set d3rd_jmpbuf_reason to something
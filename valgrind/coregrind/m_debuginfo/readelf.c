@@ -35,6 +35,7 @@
 #include "pub_core_vki.h"
 #include "pub_core_debuginfo.h"
 #include "pub_core_libcbase.h"
+#include "pub_core_libcfile.h"
 #include "pub_core_libcprint.h"
 #include "pub_core_libcassert.h"
 #include "pub_core_machine.h"      /* VG_ELF_CLASS */
@@ -1423,6 +1424,174 @@ Word file_offset_from_svma ( /*OUT*/Bool* ok,
 }
 
 
+/*------------------------------------------------------------*/
+/*--- Deferred reading of DWARF3 variable info             ---*/
+/*------------------------------------------------------------*/
+
+/* Variable and type info is only used to describe addresses in error
+   messages, yet for large C++ programs it is by far the most
+   expensive part of the debug info to read, in both time and memory.
+   With --lazy-var-info=yes we just note which sections of which files
+   it is in, and read it when a query first needs it, by which time
+   most objects have turned out never to be asked about.
+
+   The images (main object, separate debuginfo object and alternate
+   debuginfo object) are closed in between, so as not to tie up file
+   descriptors, and are reopened by name.  Objects read from a
+   debuginfo server are always read eagerly. */
+
+#define N_DEFERRED_IMGS   3
+#define N_DEFERRED_SLICES 11
+
+typedef
+   struct {
+      Int    img;      // index into .path, or -1 if DiSlice_INVALID
+      DiOffT ioff;
+      DiOffT szB;
+   }
+   DeferredSlice;
+
+struct _DeferredVarInfo {
+   HChar*        path[N_DEFERRED_IMGS];
+   Long          size[N_DEFERRED_IMGS];
+   ULong         mtime[N_DEFERRED_IMGS];
+   DeferredSlice sli[N_DEFERRED_SLICES];
+};
+
+static Bool stat_for_deferred ( const HChar* path,
+                                /*OUT*/Long* size, /*OUT*/ULong* mtime )
+{
+   struct vg_stat st;
+   SysRes sres = VG_(stat)(path, &st);
+   if (sr_isError(sres))
+      return False;
+   *size  = st.size;
+   *mtime = st.mtime;
+   return True;
+}
+
+/* Note where the .debug_* sections in 'escns' are, so that
+   ML_(read_deferred_varinfo) can read them later.  Returns False if
+   that isn't possible, in which case the caller should read them
+   now. */
+static Bool defer_varinfo ( DebugInfo* di, DiImage* imgs[N_DEFERRED_IMGS],
+                            const DiSlice escns[N_DEFERRED_SLICES] )
+{
+   struct _DeferredVarInfo* dv;
+   Int i, j;
+
+   dv = ML_(dinfo_zalloc)("di.readelf.dv.1", sizeof(*dv));
+   for (i = 0; i < N_DEFERRED_SLICES; i++) {
+      dv->sli[i].img = -1;
+      if (!ML_(sli_is_valid)(escns[i]))
+         continue;
+      for (j = 0; j < N_DEFERRED_IMGS; j++)
+         if (escns[i].img == imgs[j])
+            break;
+      if (j == N_DEFERRED_IMGS)
+         goto fail;
+      if (dv->path[j] == NULL) {
+         const HChar* path = ML_(img_local_filename)(imgs[j]);
+         if (path == NULL
+             || !stat_for_deferred(path, &dv->size[j], &dv->mtime[j])
+             || dv->size[j] != ML_(img_size)(imgs[j]))
+            goto fail;
+         dv->path[j] = ML_(dinfo_strdup)("di.readelf.dv.2", path);
+      }
+      dv->sli[i].img  = j;
+      dv->sli[i].ioff = escns[i].ioff;
+      dv->sli[i].szB  = escns[i].szB;
+   }
+   di->deferred_varinfo = dv;
+   return True;
+
+  fail:
+   di->deferred_varinfo = dv;
+   ML_(discard_deferred_varinfo)(di);
+   return False;
+}
+
+void ML_(discard_deferred_varinfo) ( DebugInfo* di )
+{
+   struct _DeferredVarInfo* dv = di->deferred_varinfo;
+   Int j;
+   if (dv == NULL)
+      return;
+   for (j = 0; j < N_DEFERRED_IMGS; j++)
+      if (dv->path[j])
+         ML_(dinfo_free)(dv->path[j]);
+   ML_(dinfo_free)(dv);
+   di->deferred_varinfo = NULL;
+}
+
+void ML_(read_deferred_varinfo) ( DebugInfo* di )
+{
+   struct _DeferredVarInfo* dv = di->deferred_varinfo;
+   DiImage* imgs[N_DEFERRED_IMGS] = { NULL, NULL, NULL };
+   DiSlice  escns[N_DEFERRED_SLICES];
+   Bool     ok = True;
+   Int      i, j;
+
+   vg_assert(dv);
+   if (VG_(clo_verbosity) > 1)
+      VG_(message)(Vg_DebugMsg, "Reading var info for %s\n",
+                   di->fsm.filename);
+
+   for (j = 0; ok && j < N_DEFERRED_IMGS; j++) {
+      Long  size;
+      ULong mtime;
+      if (dv->path[j] == NULL)
+         continue;
+      /* Don't read something other than what the rest of the debug
+         info came from. */
+      if (!stat_for_deferred(dv->path[j], &size, &mtime)
+          || size != dv->size[j] || mtime != dv->mtime[j]) {
+         ok = False;
+         break;
+      }
+      imgs[j] = ML_(img_from_local_file)(dv->path[j]);
+      if (imgs[j] == NULL)
+         ok = False;
+   }
+
+   if (ok) {
+      for (i = 0; i < N_DEFERRED_SLICES; i++) {
+         if (dv->sli[i].img < 0) {
+            escns[i] = DiSlice_INVALID;
+         } else {
+            escns[i].img  = imgs[dv->sli[i].img];
+            escns[i].ioff = dv->sli[i].ioff;
+            escns[i].szB  = dv->sli[i].szB;
+         }
+      }
+   }
+
+   /* Whatever happens, this is the only attempt. */
+   ML_(discard_deferred_varinfo)(di);
+
+   if (ok) {
+      ML_(new_dwarf3_reader)(
+         di, escns[0],  escns[1],
+             escns[2],  escns[3],
+             escns[4],  escns[5],
+             escns[6],  escns[7],
+             escns[8],  escns[9],
+             escns[10],
+             True/*read_var_info*/, False/*read_inline_info*/
+      );
+   } else {
+      ML_(symerr)(di, False, "object file changed since it was loaded;"
+                             " not reading variable info");
+   }
+
+   for (j = 0; j < N_DEFERRED_IMGS; j++)
+      if (imgs[j])
+         ML_(img_done)(imgs[j]);
+
+   ML_(canonicaliseDeferredVarInfo)(di);
+}
+
+
 /* The central function for reading ELF debug info.  For the
    object/exe specified by the DebugInfo, find ELF sections, then read
    the symbols, line number info, file name info, CFA (stack-unwind
@@ -2931,14 +3100,31 @@ Bool ML_(read_elf_debug_info) ( struct _DebugInfo* di )
             the command line. */
          if (VG_(clo_read_var_info) /* the user or tool asked for it */
              || VG_(clo_read_inline_info)) {
-            ML_(new_dwarf3_reader)(
-               di, debug_info_escn,     debug_types_escn,
-                   debug_abbv_escn,     debug_line_escn,
-                   debug_str_escn,      debug_ranges_escn,
-                   debug_loc_escn,      debug_info_alt_escn,
-                   debug_abbv_alt_escn, debug_line_alt_escn,
-                   debug_str_alt_escn
-            );
+            Bool read_var_info = VG_(clo_read_var_info);
+            if (read_var_info && VG_(clo_lazy_var_info)) {
+               DiImage* imgs[N_DEFERRED_IMGS] = { mimg, dimg, aimg };
+               const DiSlice escns[N_DEFERRED_SLICES] = {
+                  debug_info_escn,     debug_types_escn,
+                  debug_abbv_escn,     debug_line_escn,
+                  debug_str_escn,      debug_ranges_escn,
+                  debug_loc_escn,      debug_info_alt_escn,
+                  debug_abbv_alt_escn, debug_line_alt_escn,
+                  debug_str_alt_escn
+               };
+               if (defer_varinfo(di, imgs, escns))
+                  read_var_info = False;
+            }
+            if (read_var_info || VG_(clo_read_inline_info)) {
+               ML_(new_dwarf3_reader)(
+                  di, debug_info_escn,     debug_types_escn,
+                      debug_abbv_escn,     debug_line_escn,
+                      debug_str_escn,      debug_ranges_escn,
+                      debug_loc_escn,      debug_info_alt_escn,
+                      debug_abbv_alt_escn, debug_line_alt_escn,
+                      debug_str_alt_escn,
+                      read_var_info,       VG_(clo_read_inline_info)
+               );
+            }
          }
       }
 
@@ -1165,7 +1165,9 @@ Bool ML_(read_macho_debug_info)( struct _DebugInfo* di )
                    DiSlice_INVALID, /* ALT .debug_info */
                    DiSlice_INVALID, /* ALT .debug_abbv */
                    DiSlice_INVALID, /* ALT .debug_line */
-                   DiSlice_INVALID  /* ALT .debug_str */
+                   DiSlice_INVALID, /* ALT .debug_str */
+                   VG_(clo_read_var_info),
+                   VG_(clo_read_inline_info)
             );
          }
       }
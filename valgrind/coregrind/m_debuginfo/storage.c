@@ -2326,6 +2326,20 @@ void ML_(canonicaliseTables) ( struct _DebugInfo* di )
    if (di->cfsi_m_pool)
       VG_(freezeDedupPA) (di->cfsi_m_pool, ML_(dinfo_shrink_block));
    canonicaliseVarInfo ( di );
+   /* The deferred variable info reader will still need to add to
+      these. */
+   if (di->deferred_varinfo)
+      return;
+   if (di->strpool)
+      VG_(freezeDedupPA) (di->strpool, ML_(dinfo_shrink_block));
+   if (di->fndnpool)
+      VG_(freezeDedupPA) (di->fndnpool, ML_(dinfo_shrink_block));
+}
+
+void ML_(canonicaliseDeferredVarInfo) ( struct _DebugInfo* di )
+{
+   vg_assert(di->deferred_varinfo == NULL);
+   canonicaliseVarInfo ( di );
    if (di->strpool)
       VG_(freezeDedupPA) (di->strpool, ML_(dinfo_shrink_block));
    if (di->fndnpool)
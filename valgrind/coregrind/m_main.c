@@ -49,6 +49,7 @@
 #include "pub_core_libcproc.h"
 #include "pub_core_libcsignal.h"
 #include "pub_core_sbprofile.h"
+#include "pub_core_transcache.h"
 #include "pub_core_syscall.h"       // VG_(strerror)
 #include "pub_core_mach.h"
 #include "pub_core_machine.h"
@@ -172,6 +173,9 @@ static void usage_NORETURN ( Bool debug_help )
 "                              and use it to print better error messages in\n"
 "                              tools that make use of it (Memcheck, Helgrind,\n"
 "                              DRD) [no]\n"
+"    --lazy-var-info=no|yes    with --read-var-info=yes, read the variable\n"
+"                              info of each object only when an error\n"
+"                              message first needs it [no]\n"
 "    --vgdb-poll=<number>      gdbserver poll max every <number> basic blocks [%d] \n"
 "    --vgdb-shadow-registers=no|yes   let gdb see the shadow registers [no]\n"
 "    --vgdb-prefix=<prefix>    prefix for vgdb FIFOs [%s]\n"
@@ -192,6 +196,8 @@ static void usage_NORETURN ( Bool debug_help )
 "           more sectors may increase performance, but use more memory.\n"
 "    --avg-transtab-entry-size=<number> avg size in bytes of a translated\n"
 "           basic block [0, meaning use tool provided default]\n"
+"    --translation-cache=<dir> keep translations in <dir> and reuse them\n"
+"           in later runs of the same program with the same options\n"
 "    --aspace-minaddr=0xPP     avoid mapping memory below 0xPP [guessed]\n"
 "    --valgrind-stacksize=<number> size of valgrind (host) thread's stack\n"
 "                               (in bytes) ["
@@ -679,6 +685,7 @@ void main_process_cmd_line_options ( /*OUT*/Bool* logging_to_fd,
       else if VG_BOOL_CLO(arg, "--sym-offsets",      VG_(clo_sym_offsets)) {}
       else if VG_BOOL_CLO(arg, "--read-inline-info", VG_(clo_read_inline_info)) {}
       else if VG_BOOL_CLO(arg, "--read-var-info",    VG_(clo_read_var_info)) {}
+      else if VG_BOOL_CLO(arg, "--lazy-var-info",    VG_(clo_lazy_var_info)) {}
 
       else if VG_INT_CLO (arg, "--dump-error",       VG_(clo_dump_error))   {}
       else if VG_INT_CLO (arg, "--input-fd",         VG_(clo_input_fd))     {}
@@ -802,6 +809,9 @@ void main_process_cmd_line_options ( /*OUT*/Bool* logging_to_fd,
       else if VG_STR_CLO (arg, "--extra-debuginfo-path",
                       VG_(clo_extra_debuginfo_path)) {}
 
+      else if VG_STR_CLO (arg, "--translation-cache",
+                      VG_(clo_translation_cache)) {}
+
       else if VG_STR_CLO(arg, "--require-text-symbol", tmp_str) {
          /* String needs to be of the form C?*C?*, where C is any
             character, but is the same both times.  Having it in this
@@ -2644,6 +2654,9 @@ void shutdown_actions_NORETURN( ThreadId tid,
       the error management machinery. */
    VG_TDICT_CALL(tool_fini, 0/*exitcode*/);
 
+   /* Keep this run's translations for the next one, if asked to. */
+   VG_(transcache_save)();
+
    /* Show the error counts. */
    if (VG_(clo_xml)
        && (VG_(needs).core_errors || VG_(needs).tool_errors)) {
@@ -47,6 +47,22 @@
    the_BigLock, and re-takes it when it becomes runnable again (either
    because the syscall finished, or we took a signal).
 
+   Running guest threads truly in parallel, even only for tools that
+   would declare themselves thread-safe (none, cachegrind), needs far
+   more than a finer-grained lock here.  At least:
+   - VG_(tt_fast) would have to become per-thread, which changes every
+     dispatcher in m_dispatch/, since they index the global directly;
+   - translation, chaining and unchaining in m_transtab.c patch code
+     that other threads may be executing at the time, and eviction
+     discards whole sectors; both would need a quiescence protocol
+     (stop-the-world or epochs) rather than a lock;
+   - the allocators (m_mallocfree.c arenas), the error manager, the
+     signal machinery and gdbserver all assume the_BigLock is held;
+   - tools' instrumentation helpers (cachegrind's CC tables, for
+     example) update shared counters non-atomically.
+   Until that work exists, client threads are serialised as described
+   above, and --fair-sched=yes is the knob for multi-threaded clients.
+
    VG_(scheduler) therefore runs in each thread.  It returns only when
    the thread is exiting, either because it exited itself, or it was
    told to exit by another thread.
@@ -135,6 +151,21 @@ static ULong n_scheduling_events_MAJOR = 0;
 static ULong stats__n_xindirs = 0;
 static ULong stats__n_xindir_misses = 0;
 
+/* Of the fast-cache misses, how many were for code that had not been
+   translated yet, as opposed to being merely evicted from (or never
+   entered in) the fast cache.
+
+   These counters only measure the existing scheme, in which every
+   indirect branch leaves its translation for the dispatcher's
+   VG_(tt_fast) lookup.  Per-site inline target caches, chained like
+   direct branches, are not implemented: each indirect exit would need
+   a patchable compare-and-jump from every VEX backend, m_transtab.c
+   would have to unchain those sites when their targets are discarded,
+   and the lookup they replace lives in the per-platform dispatchers
+   (m_dispatch/), which this tree does not carry.  The hit rate shows
+   what such caches could save on a given workload. */
+static ULong stats__n_xindir_misses_untranslated = 0;
+
 /* And 32-bit temp bins for the above, so that 32-bit platforms don't
    have to do 64 bit incs on the hot path through
    VG_(cp_disp_xindir). */
@@ -154,6 +185,14 @@ void VG_(print_scheduler_stats)(void)
                 stats__n_xindirs, stats__n_xindir_misses,
                 stats__n_xindirs / (stats__n_xindir_misses 
                                     ? stats__n_xindir_misses : 1));
+   VG_(message)(Vg_DebugMsg,
+                "scheduler: indir fast-cache hit rate %.2f%%, "
+                "%'llu misses needed a new translation\n",
+                stats__n_xindirs
+                   ? 100.0 * (double)(stats__n_xindirs - stats__n_xindir_misses)
+                           / (double)stats__n_xindirs
+                   : 100.0,
+                stats__n_xindir_misses_untranslated);
    VG_(message)(Vg_DebugMsg,
       "scheduler: %'llu/%'llu major/minor sched events.\n",
       n_scheduling_events_MAJOR, n_scheduling_events_MINOR);
@@ -1045,6 +1084,7 @@ static void handle_tt_miss ( ThreadId tid )
                                  ip, True/*upd_fast_cache*/ );
    if (UNLIKELY(!found)) {
       /* Not found; we need to request a translation. */
+      stats__n_xindir_misses_untranslated++;
       if (VG_(translate)( tid, ip, /*debug*/False, 0/*not verbose*/, 
                           bbs_done, True/*allow redirection*/ )) {
          found = VG_(search_transtab)( NULL, NULL, NULL,
@@ -0,0 +1,544 @@
+
+/*--------------------------------------------------------------------*/
+/*--- Persistent translation cache.                 m_transcache.c ---*/
+/*--------------------------------------------------------------------*/
+
+/*
+   This file is part of Valgrind, a dynamic binary instrumentation
+   framework.
+
+   Copyright (C) 2016-2016 The Android Open Source Project
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+   02111-1307, USA.
+
+   The GNU General Public License is contained in the file COPYING.
+*/
+
+#include "pub_core_basics.h"
+#include "pub_core_vki.h"
+#include "pub_core_aspacemgr.h"
+#include "pub_core_clientstate.h"   // VG_(args_for_valgrind)
+#include "pub_core_hashtable.h"
+#include "pub_core_libcassert.h"
+#include "pub_core_libcbase.h"
+#include "pub_core_libcfile.h"
+#include "pub_core_libcprint.h"
+#include "pub_core_libcproc.h"      // VG_(getpid)
+#include "pub_core_machine.h"       // VG_(machine_get_VexArchInfo)
+#include "pub_core_mallocfree.h"
+#include "pub_core_options.h"
+#include "pub_core_tooliface.h"     // VG_(needs), VG_(details)
+#include "pub_core_translate.h"     // VG_(translate)
+#include "pub_core_xarray.h"
+#include "pub_core_transcache.h"    // self
+
+/*------------------------------------------------------------*/
+/*--- Overview                                             ---*/
+/*------------------------------------------------------------*/
+
+/* With --translation-cache=<dir>, every translation made for code in
+   a file-backed mapping is remembered, and at exit the lot is written
+   to a single file in <dir>.  A later run which finds that file loads
+   it, and VG_(translate) then copies host code out of it instead of
+   calling LibVEX_Translate.
+
+   Vex output is position dependent: it has the guest addresses of the
+   block baked in, and calls helpers in the core and tool at absolute
+   addresses.  Rather than teach Vex to emit relocations, the cache
+   relies on the fact that, for a given tool executable, client
+   executable and command line, the address space manager lays the
+   client out the same way every time.  The file name is therefore
+   derived from a hash of everything that can change the generated
+   code:
+
+   - the Valgrind version and the identity (size, mtime, inode) of the
+     tool executable, which fixes the addresses of all helpers and of
+     the dispatcher's chain-me stubs,
+   - the identity of the client executable,
+   - the host's VexArchInfo and VG_(clo_vex_control),
+   - every core and tool command line option.
+
+   and a translation is reused only if the guest bytes it was made
+   from hash to the same value as before and still live in a
+   file-backed mapping.  Translations with self-checks are never
+   cached: their guest code is by definition expected to change.
+
+   Tools must opt in with VG_(needs_persistent_translations), as some
+   embed run-time state (e.g. Memcheck's origin tracking ECUs) into
+   the code they generate.
+
+   The file is written to a temporary name and renamed into place, so
+   concurrent runs sharing a cache directory only ever lose each
+   other's additions, never corrupt the file. */
+
+
+/*------------------------------------------------------------*/
+/*--- Data structures                                      ---*/
+/*------------------------------------------------------------*/
+
+#define TC_MAGIC "VGTCACHE"
+
+/* Stop adding translations once this much code is cached.  This is
+   well above what large C++ programs need, and merely stops the file
+   growing without bound for programs which keep loading new code. */
+#define TC_MAX_CODE_BYTES (64 * 1024 * 1024)
+
+typedef
+   struct {
+      HChar magic[8];
+      ULong config_hash;
+      UInt  n_records;
+      UInt  record_szB;
+   }
+   TCHeader;
+
+/* One translation, as stored on disk.  The host code follows it
+   directly. */
+typedef
+   struct {
+      Addr            nraddr;
+      Addr            addr;
+      ULong           guest_hash;
+      VexGuestExtents vge;
+      UInt            kind;
+      Int             offs_profInc;
+      UInt            n_guest_instrs;
+      UInt            code_len;
+   }
+   TCRecord;
+
+typedef
+   struct _TCEntry {
+      struct _TCEntry* next;   // for VgHashTable
+      UWord            key;    // == rec.nraddr
+      TCRecord         rec;
+      const UChar*     code;   // into file_image, or owned if is_new
+      Bool             is_new;
+   }
+   TCEntry;
+
+static Bool  init_done   = False;
+static Bool  enabled     = False;
+static ULong config_hash = 0;
+
+static VgHashTable* entries    = NULL;
+static UChar*       file_image = NULL;
+static SizeT        code_bytes = 0;
+static Bool         dirty      = False;
+
+static ULong n_loaded  = 0;
+static ULong n_hits    = 0;
+static ULong n_stale   = 0;
+static ULong n_added   = 0;
+
+
+/*------------------------------------------------------------*/
+/*--- Hashing                                              ---*/
+/*------------------------------------------------------------*/
+
+/* 64-bit FNV-1a.  Good enough to detect changed guest code and
+   changed configurations; this is not a defence against anyone
+   deliberately planting a bogus cache file. */
+static ULong hash_bytes ( ULong h, const void* p, SizeT n )
+{
+   const UChar* b = p;
+   SizeT i;
+   for (i = 0; i < n; i++) {
+      h ^= b[i];
+      h *= 0x100000001b3ULL;
+   }
+   return h;
+}
+
+static ULong hash_str ( ULong h, const HChar* s )
+{
+   /* Include the terminating zero, so that ("ab","c") and ("a","bc")
+      hash differently. */
+   return hash_bytes(h, s, VG_(strlen)(s) + 1);
+}
+
+static ULong hash_file_identity ( ULong h, const HChar* path )
+{
+   struct vg_stat st;
+   SysRes sres = VG_(stat)(path, &st);
+   if (sr_isError(sres))
+      return hash_str(h, "<unknown file>");
+   h = hash_str(h, path);
+   h = hash_bytes(h, &st.dev,   sizeof(st.dev));
+   h = hash_bytes(h, &st.ino,   sizeof(st.ino));
+   h = hash_bytes(h, &st.size,  sizeof(st.size));
+   h = hash_bytes(h, &st.mtime, sizeof(st.mtime));
+   h = hash_bytes(h, &st.mtime_nsec, sizeof(st.mtime_nsec));
+   return h;
+}
+
+static ULong compute_config_hash ( void )
+{
+   VexArch     vex_arch;
+   VexArchInfo vex_archinfo;
+   ULong       h = 0xcbf29ce484222325ULL;
+   Int         i;
+
+   h = hash_str(h, VERSION);
+   h = hash_str(h, VG_(details).name);
+#  if defined(VGO_linux)
+   /* The core has not been re-exec'd since startup, so this still
+      names the tool executable and not the client. */
+   h = hash_file_identity(h, "/proc/self/exe");
+#  endif
+   /* Belt and braces, for platforms where the above is not
+      available: any relink is very likely to move these. */
+   { Addr a = (Addr)&VG_(translate);
+     h = hash_bytes(h, &a, sizeof(a));
+     a = (Addr)VG_(tdict).tool_instrument;
+     h = hash_bytes(h, &a, sizeof(a)); }
+
+   if (VG_(args_the_exename))
+      h = hash_file_identity(h, VG_(args_the_exename));
+
+   VG_(machine_get_VexArchInfo)( &vex_arch, &vex_archinfo );
+   h = hash_bytes(h, &vex_arch, sizeof(vex_arch));
+   h = hash_bytes(h, &vex_archinfo.hwcaps, sizeof(vex_archinfo.hwcaps));
+   h = hash_bytes(h, &vex_archinfo.endness, sizeof(vex_archinfo.endness));
+   h = hash_bytes(h, &VG_(clo_vex_control), sizeof(VG_(clo_vex_control)));
+
+   for (i = 0; i < VG_(sizeXA)( VG_(args_for_valgrind) ); i++) {
+      HChar* arg = * (HChar**) VG_(indexXA)( VG_(args_for_valgrind), i );
+      h = hash_str(h, arg);
+   }
+   return h;
+}
+
+/* Hash the guest code covered by 'vge', or return False if some of
+   it is not (any longer) in a readable, file-backed mapping. */
+static Bool hash_guest_code ( const VexGuestExtents* vge,
+                              /*OUT*/ULong* res )
+{
+   ULong h = 0xcbf29ce484222325ULL;
+   UInt  i;
+
+   if (vge->n_used < 1 || vge->n_used > 3)
+      return False;
+
+   for (i = 0; i < vge->n_used; i++) {
+      Addr  base = vge->base[i];
+      SizeT len  = vge->len[i];
+      NSegment const* seg;
+      if (len == 0)
+         continue;
+      seg = VG_(am_find_nsegment)(base);
+      if (seg == NULL || seg->kind != SkFileC
+          || base + len - 1 > seg->end
+          || !VG_(am_is_valid_for_client)(base, len, VKI_PROT_READ))
+         return False;
+      h = hash_bytes(h, (const void*)base, len);
+   }
+   *res = h;
+   return True;
+}
+
+
+/*------------------------------------------------------------*/
+/*--- Loading and saving                                   ---*/
+/*------------------------------------------------------------*/
+
+static HChar* cache_file_name ( void )
+{
+   const HChar* dir = VG_(clo_translation_cache);
+   HChar* name = VG_(malloc)("transcache.name",
+                             VG_(strlen)(dir) + 64);
+   VG_(sprintf)(name, "%s/vgtc-%016llx.bin", dir, config_hash);
+   return name;
+}
+
+static void load_cache_file ( void )
+{
+   HChar*         name = cache_file_name();
+   SysRes         sres;
+   Int            fd;
+   struct vg_stat st;
+   SizeT          size, off, got;
+   TCHeader       hdr;
+   UInt           i;
+
+   sres = VG_(open)(name, VKI_O_RDONLY, 0);
+   if (sr_isError(sres)) {
+      if (VG_(clo_verbosity) > 1)
+         VG_(message)(Vg_DebugMsg,
+                      "translation cache: no file %s\n", name);
+      VG_(free)(name);
+      return;
+   }
+   fd = sr_Res(sres);
+
+   if (VG_(fstat)(fd, &st) != 0 || st.size < sizeof(TCHeader)) {
+      VG_(close)(fd);
+      VG_(free)(name);
+      return;
+   }
+   size = st.size;
+   file_image = VG_(malloc)("transcache.image", size);
+   for (got = 0; got < size; ) {
+      Int n = VG_(read)(fd, file_image + got, size - got);
+      if (n <= 0)
+         break;
+      got += n;
+   }
+   VG_(close)(fd);
+
+   VG_(memcpy)(&hdr, file_image, sizeof(hdr));
+   if (got != size
+       || VG_(memcmp)(hdr.magic, TC_MAGIC, sizeof(hdr.magic)) != 0
+       || hdr.config_hash != config_hash
+       || hdr.record_szB != sizeof(TCRecord)) {
+      VG_(message)(Vg_UserMsg,
+                   "Warning: ignoring invalid translation cache %s\n", name);
+      VG_(free)(file_image);
+      file_image = NULL;
+      VG_(free)(name);
+      return;
+   }
+
+   off = sizeof(TCHeader);
+   for (i = 0; i < hdr.n_records; i++) {
+      TCEntry* ent;
+      if (size - off < sizeof(TCRecord))
+         break;
+      ent = VG_(malloc)("transcache.entry", sizeof(TCEntry));
+      VG_(memcpy)(&ent->rec, file_image + off, sizeof(TCRecord));
+      off += sizeof(TCRecord);
+      if (ent->rec.code_len == 0 || ent->rec.code_len > size - off) {
+         VG_(free)(ent);
+         break;
+      }
+      ent->key    = ent->rec.nraddr;
+      ent->code   = file_image + off;
+      ent->is_new = False;
+      off += ent->rec.code_len;
+      code_bytes += ent->rec.code_len;
+      VG_(HT_add_node)(entries, ent);
+      n_loaded++;
+   }
+
+   if (VG_(clo_verbosity) > 1)
+      VG_(message)(Vg_DebugMsg,
+                   "translation cache: loaded %'llu translations from %s\n",
+                   n_loaded, name);
+   VG_(free)(name);
+}
+
+static Bool write_all ( Int fd, const void* buf, SizeT len )
+{
+   const UChar* p = buf;
+   while (len > 0) {
+      Int n = VG_(write)(fd, p, len);
+      if (n <= 0)
+         return False;
+      p   += n;
+      len -= n;
+   }
+   return True;
+}
+
+void VG_(transcache_save) ( void )
+{
+   HChar*   name;
+   HChar*   tmpname;
+   SysRes   sres;
+   Int      fd;
+   TCHeader hdr;
+   TCEntry* ent;
+   Bool     ok;
+
+   if (!enabled || !dirty)
+      return;
+
+   name    = cache_file_name();
+   tmpname = VG_(malloc)("transcache.tmpname", VG_(strlen)(name) + 32);
+   VG_(sprintf)(tmpname, "%s.%d.tmp", name, VG_(getpid)());
+
+   sres = VG_(open)(tmpname, VKI_O_CREAT|VKI_O_WRONLY|VKI_O_TRUNC,
+                    VKI_S_IRUSR|VKI_S_IWUSR);
+   if (sr_isError(sres)) {
+      VG_(message)(Vg_UserMsg,
+                   "Warning: can't create translation cache file %s\n",
+                   tmpname);
+      VG_(free)(tmpname);
+      VG_(free)(name);
+      return;
+   }
+   fd = sr_Res(sres);
+
+   VG_(memset)(&hdr, 0, sizeof(hdr));
+   VG_(memcpy)(hdr.magic, TC_MAGIC, sizeof(hdr.magic));
+   hdr.config_hash = config_hash;
+   hdr.n_records   = VG_(HT_count_nodes)(entries);
+   hdr.record_szB  = sizeof(TCRecord);
+
+   ok = write_all(fd, &hdr, sizeof(hdr));
+   VG_(HT_ResetIter)(entries);
+   while (ok && (ent = VG_(HT_Next)(entries))) {
+      ok = write_all(fd, &ent->rec, sizeof(TCRecord))
+           && write_all(fd, ent->code, ent->rec.code_len);
+   }
+   VG_(close)(fd);
+
+   if (ok && VG_(rename)(tmpname, name) == 0) {
+      if (VG_(clo_verbosity) > 1)
+         VG_(message)(Vg_DebugMsg,
+                      "translation cache: wrote %u translations to %s\n",
+                      hdr.n_records, name);
+   } else {
+      VG_(message)(Vg_UserMsg,
+                   "Warning: can't write translation cache file %s\n",
+                   name);
+      VG_(unlink)(tmpname);
+   }
+   dirty = False;
+   VG_(free)(tmpname);
+   VG_(free)(name);
+}
+
+static void init ( void )
+{
+   init_done = True;
+
+   if (VG_(clo_translation_cache) == NULL)
+      return;
+   if (!VG_(needs).persistent_translations) {
+      if (VG_(clo_verbosity) > 0)
+         VG_(message)(Vg_UserMsg,
+                      "Warning: --translation-cache is not supported by "
+                      "this tool (or with these options); ignored\n");
+      return;
+   }
+
+   enabled     = True;
+   config_hash = compute_config_hash();
+   entries     = VG_(HT_construct)("transcache.entries");
+   load_cache_file();
+}
+
+
+/*------------------------------------------------------------*/
+/*--- Lookup and insertion                                 ---*/
+/*------------------------------------------------------------*/
+
+Bool VG_(transcache_enabled) ( void )
+{
+   if (!init_done)
+      init();
+   return enabled;
+}
+
+Bool VG_(transcache_lookup) ( Addr nraddr, Addr addr, UInt kind,
+                              /*OUT*/VexGuestExtents* vge,
+                              /*OUT*/UChar* host_code,
+                              Int host_code_size,
+                              /*OUT*/Int* host_code_used,
+                              /*OUT*/VexTranslateResult* tres )
+{
+   TCEntry* ent;
+   ULong    h;
+
+   if (!VG_(transcache_enabled)())
+      return False;
+
+   ent = VG_(HT_lookup)(entries, nraddr);
+   if (ent == NULL || ent->rec.addr != addr || ent->rec.kind != kind)
+      return False;
+   if (ent->rec.code_len > host_code_size
+       || !hash_guest_code(&ent->rec.vge, &h)
+       || h != ent->rec.guest_hash) {
+      n_stale++;
+      return False;
+   }
+
+   *vge = ent->rec.vge;
+   VG_(memcpy)(host_code, ent->code, ent->rec.code_len);
+   *host_code_used = ent->rec.code_len;
+   tres->status         = VexTransOK;
+   tres->n_sc_extents   = 0;
+   tres->offs_profInc   = ent->rec.offs_profInc;
+   tres->n_guest_instrs = ent->rec.n_guest_instrs;
+   n_hits++;
+   return True;
+}
+
+void VG_(transcache_add) ( Addr nraddr, Addr addr, UInt kind,
+                           const VexGuestExtents* vge,
+                           const UChar* host_code,
+                           Int host_code_used,
+                           const VexTranslateResult* tres )
+{
+   TCEntry* ent;
+   UChar*   code;
+   ULong    h;
+
+   if (!VG_(transcache_enabled)())
+      return;
+   if (tres->n_sc_extents > 0)
+      return;
+   if (code_bytes + host_code_used > TC_MAX_CODE_BYTES)
+      return;
+   if (!hash_guest_code(vge, &h))
+      return;
+
+   /* Replace any stale entry for the same address. */
+   ent = VG_(HT_remove)(entries, nraddr);
+   if (ent) {
+      code_bytes -= ent->rec.code_len;
+      if (ent->is_new)
+         VG_(free)((void*)ent->code);
+      VG_(free)(ent);
+   }
+
+   code = VG_(malloc)("transcache.code", host_code_used);
+   VG_(memcpy)(code, host_code, host_code_used);
+
+   ent = VG_(malloc)("transcache.entry", sizeof(TCEntry));
+   VG_(memset)(&ent->rec, 0, sizeof(ent->rec));
+   ent->key                 = nraddr;
+   ent->rec.nraddr          = nraddr;
+   ent->rec.addr            = addr;
+   ent->rec.guest_hash      = h;
+   ent->rec.vge             = *vge;
+   ent->rec.kind            = kind;
+   ent->rec.offs_profInc    = tres->offs_profInc;
+   ent->rec.n_guest_instrs  = tres->n_guest_instrs;
+   ent->rec.code_len        = host_code_used;
+   ent->code                = code;
+   ent->is_new              = True;
+   VG_(HT_add_node)(entries, ent);
+
+   code_bytes += host_code_used;
+   dirty = True;
+   n_added++;
+}
+
+void VG_(print_transcache_stats) ( void )
+{
+   if (!enabled)
+      return;
+   VG_(message)(Vg_DebugMsg,
+                "transcache: %'llu loaded, %'llu hits, %'llu stale, "
+                "%'llu added\n",
+                n_loaded, n_hits, n_stale, n_added);
+}
+
+/*--------------------------------------------------------------------*/
+/*--- end                                           m_transcache.c ---*/
+/*--------------------------------------------------------------------*/
@@ -50,6 +50,7 @@
 
 #include "pub_core_translate.h"
 #include "pub_core_transtab.h"
+#include "pub_core_transcache.h"
 #include "pub_core_dispatch.h" // VG_(run_innerloop__dispatch_{un}profiled)
                                // VG_(run_a_noredir_translation__return_point)
 
@@ -1479,6 +1480,7 @@ Bool VG_(translate) ( ThreadId tid,
    Addr               addr;
    T_Kind             kind;
    Int                tmpbuf_used, verbosity, i;
+   Bool               use_transcache;
    Bool (*preamble_fn)(void*,IRSB*);
    VexArch            vex_arch;
    VexArchInfo        vex_archinfo;
@@ -1761,8 +1763,27 @@ Bool VG_(translate) ( ThreadId tid,
    vta.disp_cp_xassisted
       = VG_(fnptr_to_fnentry)( &VG_(disp_cp_xassisted) );
 
+   /* Translations kept across runs must be exactly what Vex would
+      produce now, so don't use the cache when tracing (the trace
+      would be missing) or when gdbserver may add its own
+      instrumentation. */
+   use_transcache = !debugging_translation
+                    && verbosity == 0
+                    && kind != T_NoRedir
+                    && !VG_(gdbserver_init_done)()
+                    && VG_(transcache_enabled)();
+
    /* Sheesh.  Finally, actually _do_ the translation! */
-   tres = LibVEX_Translate ( &vta );
+   if (use_transcache
+       && VG_(transcache_lookup)( nraddr, addr, kind, &vge,
+                                  tmpbuf, N_TMPBUF, &tmpbuf_used, &tres )) {
+      /* Vex was not needed this time. */
+   } else {
+      tres = LibVEX_Translate ( &vta );
+      if (use_transcache)
+         VG_(transcache_add)( nraddr, addr, kind, &vge,
+                              tmpbuf, tmpbuf_used, &tres );
+   }
 
    vg_assert(tres.status == VexTransOK);
    vg_assert(tres.n_sc_extents >= 0 && tres.n_sc_extents <= 3);
@@ -139,6 +139,9 @@ extern XArray *VG_(clo_fullpath_after);
 /* Full path to additional path to search for debug symbols */
 extern const HChar* VG_(clo_extra_debuginfo_path);
 
+/* Directory in which to keep translations across runs, or NULL. */
+extern const HChar* VG_(clo_translation_cache);
+
 /* Address of a debuginfo server to use.  Either an IPv4 address of
    the form "d.d.d.d" or that plus a port spec, hence of the form
    "d.d.d.d:d", where d is one or more digits. */
@@ -236,6 +239,8 @@ extern Bool VG_(clo_sym_offsets);
 extern Bool VG_(clo_read_inline_info);
 /* Read DWARF3 variable info even if tool doesn't ask for it? */
 extern Bool VG_(clo_read_var_info);
+/* Postpone reading DWARF3 variable info until it is first needed? */
+extern Bool VG_(clo_lazy_var_info);
 /* Which prefix to strip from full source file paths, if any. */
 extern const HChar* VG_(clo_prefix_to_strip);
 
@@ -0,0 +1,77 @@
+
+/*--------------------------------------------------------------------*/
+/*--- Persistent translation cache.          pub_core_transcache.h ---*/
+/*--------------------------------------------------------------------*/
+
+/*
+   This file is part of Valgrind, a dynamic binary instrumentation
+   framework.
+
+   Copyright (C) 2016-2016 The Android Open Source Project
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2 of the
+   License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+   02111-1307, USA.
+
+   The GNU General Public License is contained in the file COPYING.
+*/
+
+#ifndef __PUB_CORE_TRANSCACHE_H
+#define __PUB_CORE_TRANSCACHE_H
+
+//--------------------------------------------------------------------
+// PURPOSE: This module keeps translations made by VG_(translate) on
+// disk (--translation-cache=<dir>), so that a later run of the same
+// program under the same tool and options can skip Vex for code it
+// has already seen.
+//--------------------------------------------------------------------
+
+#include "pub_core_basics.h"   // VG_ macro
+#include "libvex.h"            // VexGuestExtents, VexTranslateResult
+
+/* Is the cache in use for this run?  False unless
+   --translation-cache was given and the tool declared
+   VG_(needs_persistent_translations). */
+extern Bool VG_(transcache_enabled) ( void );
+
+/* Look for a cached translation of the block at 'nraddr' which was
+   redirected to 'addr' as a translation of kind 'kind' (T_Kind in
+   m_translate.c).  On a hit, the host code is copied to 'host_code',
+   '*vge' and '*tres' are filled in as LibVEX_Translate would have,
+   and True is returned. */
+extern Bool VG_(transcache_lookup) ( Addr nraddr, Addr addr, UInt kind,
+                                     /*OUT*/VexGuestExtents* vge,
+                                     /*OUT*/UChar* host_code,
+                                     Int host_code_size,
+                                     /*OUT*/Int* host_code_used,
+                                     /*OUT*/VexTranslateResult* tres );
+
+/* Offer a freshly made translation to the cache.  Translations that
+   are not safe to reuse in a later run are silently ignored. */
+extern void VG_(transcache_add) ( Addr nraddr, Addr addr, UInt kind,
+                                  const VexGuestExtents* vge,
+                                  const UChar* host_code,
+                                  Int host_code_used,
+                                  const VexTranslateResult* tres );
+
+/* Write the cache back to disk.  Called once at exit. */
+extern void VG_(transcache_save) ( void );
+
+extern void VG_(print_transcache_stats) ( void );
+
+#endif   // __PUB_CORE_TRANSCACHE_H
+
+/*--------------------------------------------------------------------*/
+/*--- end                                    pub_core_transcache.h ---*/
+/*--------------------------------------------------------------------*/
@@ -126,6 +126,12 @@ extern UWord HG_(clo_vts_pruning);
    the stack, which speeds things up a bit.  Default: True. */
 extern Bool HG_(clo_check_stack_refs); 
 
+/* Percentage (1 .. 100) of superblock executions in which memory
+   accesses are race-checked.  Synchronisation events are always
+   tracked, so happens-before relations stay exact; a lower rate just
+   trades detection probability for speed.  Default: 100. */
+extern UWord HG_(clo_sample_rate);
+
 #endif /* ! __HG_BASICS_H */
 
 /*--------------------------------------------------------------------*/
@@ -4416,6 +4416,55 @@ static IRExpr* mk_And1 ( IRSB* sbOut, IRExpr* arg1, IRExpr* arg2 )
    return mkexpr(res);
 }
 
+/* Count of superblock executions, used by --sample-rate.  Only
+   generated code touches it, and only one thread runs at a time. */
+static UInt hg_sample_counter = 0;
+
+/* For --sample-rate=N, N < 100, generate code at the start of a
+   superblock which bumps hg_sample_counter and yields a guard that
+   is True for (pseudo-randomly) about N% of executions.  Scrambling
+   the counter with a multiplicative hash means that a loop executing
+   the same superblock repeatedly does not keep hitting the same
+   phase.  The memory-access helpers in the superblock are guarded on
+   the result, so in unsampled executions they are skipped entirely.
+   Returns NULL if all executions are to be checked. */
+static IRExpr* mk_sample_guard ( IRSB* sbOut, IRType hWordTy )
+{
+   IREndness end;
+   UInt      thresh;
+
+   if (HG_(clo_sample_rate) >= 100)
+      return NULL;
+
+#  if defined(VG_BIGENDIAN)
+   end = Iend_BE;
+#  elif defined(VG_LITTLEENDIAN)
+   end = Iend_LE;
+#  else
+#    error "Unknown endianness"
+#  endif
+
+   tl_assert(hWordTy == Ity_I32 || hWordTy == Ity_I64);
+   IRExpr* cAddr = mkIRExpr_HWord( (HWord)&hg_sample_counter );
+   IRTemp  old   = newIRTemp(sbOut->tyenv, Ity_I32);
+   IRTemp  new   = newIRTemp(sbOut->tyenv, Ity_I32);
+   IRTemp  hash  = newIRTemp(sbOut->tyenv, Ity_I32);
+   IRTemp  res   = newIRTemp(sbOut->tyenv, Ity_I1);
+
+   /* 2^32 * N / 100, computed without overflowing. */
+   thresh = (UInt)((((ULong)HG_(clo_sample_rate)) << 32) / 100);
+
+   addStmtToIRSB(sbOut, assign(old, IRExpr_Load(end, Ity_I32, cAddr)));
+   addStmtToIRSB(sbOut, assign(new, binop(Iop_Add32, mkexpr(old),
+                                                     mkU32(1))));
+   addStmtToIRSB(sbOut, IRStmt_Store(end, cAddr, mkexpr(new)));
+   addStmtToIRSB(sbOut, assign(hash, binop(Iop_Mul32, mkexpr(new),
+                                                      mkU32(0x9E3779B1))));
+   addStmtToIRSB(sbOut, assign(res, binop(Iop_CmpLT32U, mkexpr(hash),
+                                                        mkU32(thresh))));
+   return mkexpr(res);
+}
+
 static void instrument_mem_access ( IRSB*   sbOut, 
                                     IRExpr* addr,
                                     Int     szB,
@@ -4629,6 +4678,7 @@ IRSB* hg_instrument ( VgCallbackClosure* closure,
    IRSB*   bbOut;
    Addr    cia; /* address of current insn */
    IRStmt* st;
+   IRExpr* sampled;
    Bool    inLDSO = False;
    Addr    inLDSOmask4K = 1; /* mismatches on first check */
 
@@ -4665,6 +4715,11 @@ IRSB* hg_instrument ( VgCallbackClosure* closure,
    cia = st->Ist.IMark.addr;
    st = NULL;
 
+   // With --sample-rate, decide once per execution of the superblock
+   // whether its memory accesses are to be checked.  This guard is
+   // ANDed into every access's guard below; NULL means "always".
+   sampled = mk_sample_guard(bbOut, hWordTy);
+
    for (/*use current i*/; i < bbIn->stmts_used; i++) {
       st = bbIn->stmts[i];
       tl_assert(st);
@@ -4728,7 +4783,7 @@ IRSB* hg_instrument ( VgCallbackClosure* closure,
                      * sizeofIRType(typeOfIRExpr(bbIn->tyenv, cas->dataLo)),
                   False/*!isStore*/,
                   sizeofIRType(hWordTy), goff_sp,
-                  NULL/*no-guard*/
+                  sampled
                );
             }
             break;
@@ -4749,7 +4804,7 @@ IRSB* hg_instrument ( VgCallbackClosure* closure,
                      sizeofIRType(dataTy),
                      False/*!isStore*/,
                      sizeofIRType(hWordTy), goff_sp,
-                     NULL/*no-guard*/
+                     sampled
                   );
                }
             } else {
@@ -4767,7 +4822,7 @@ IRSB* hg_instrument ( VgCallbackClosure* closure,
                   sizeofIRType(typeOfIRExpr(bbIn->tyenv, st->Ist.Store.data)),
                   True/*isStore*/,
                   sizeofIRType(hWordTy), goff_sp,
-                  NULL/*no-guard*/
+                  sampled
                );
             }
             break;
@@ -4781,7 +4836,10 @@ IRSB* hg_instrument ( VgCallbackClosure* closure,
             instrument_mem_access( bbOut, addr, sizeofIRType(type),
                                    True/*isStore*/,
                                    sizeofIRType(hWordTy),
-                                   goff_sp, sg->guard );
+                                   goff_sp,
+                                   sampled ? mk_And1(bbOut, sampled,
+                                                     sg->guard)
+                                           : sg->guard );
             break;
          }
 
@@ -4795,7 +4853,10 @@ IRSB* hg_instrument ( VgCallbackClosure* closure,
             instrument_mem_access( bbOut, addr, sizeofIRType(type),
                                    False/*!isStore*/,
                                    sizeofIRType(hWordTy),
-                                   goff_sp, lg->guard );
+                                   goff_sp,
+                                   sampled ? mk_And1(bbOut, sampled,
+                                                     lg->guard)
+                                           : lg->guard );
             break;
          }
 
@@ -4809,7 +4870,7 @@ IRSB* hg_instrument ( VgCallbackClosure* closure,
                      sizeofIRType(data->Iex.Load.ty),
                      False/*!isStore*/,
                      sizeofIRType(hWordTy), goff_sp,
-                     NULL/*no-guard*/
+                     sampled
                   );
                }
             }
@@ -4829,7 +4890,7 @@ IRSB* hg_instrument ( VgCallbackClosure* closure,
                   if (!inLDSO) {
                      instrument_mem_access( 
                         bbOut, d->mAddr, dataSize, False/*!isStore*/,
-                        sizeofIRType(hWordTy), goff_sp, NULL/*no-guard*/
+                        sizeofIRType(hWordTy), goff_sp, sampled
                      );
                   }
                }
@@ -4837,7 +4898,7 @@ IRSB* hg_instrument ( VgCallbackClosure* closure,
                   if (!inLDSO) {
                      instrument_mem_access( 
                         bbOut, d->mAddr, dataSize, True/*isStore*/,
-                        sizeofIRType(hWordTy), goff_sp, NULL/*no-guard*/
+                        sizeofIRType(hWordTy), goff_sp, sampled
                      );
                   }
                }
@@ -5564,6 +5625,8 @@ static Bool hg_process_cmd_line_option ( const HChar* arg )
 
    else if VG_BOOL_CLO(arg, "--check-stack-refs",
                             HG_(clo_check_stack_refs)) {}
+   else if VG_BINT_CLO(arg, "--sample-rate",
+                            HG_(clo_sample_rate), 1, 100) {}
    else if VG_BOOL_CLO(arg, "--ignore-thread-creation",
                             HG_(clo_ignore_thread_creation)) {}
 
@@ -5585,6 +5648,8 @@ static void hg_print_usage ( void )
 "    --conflict-cache-size=N   size of 'full' history cache [2000000]\n"
 "    --check-stack-refs=no|yes race-check reads and writes on the\n"
 "                              main stack and thread stacks? [yes]\n"
+"    --sample-rate=<1..100>    race-check memory accesses in only this\n"
+"                              percentage of superblock executions [100]\n"
 "    --ignore-thread-creation=yes|no Ignore activities during thread\n"
 "                              creation [%s]\n",
 HG_(clo_ignore_thread_creation) ? "yes" : "no"
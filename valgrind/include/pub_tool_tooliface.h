@@ -494,6 +494,13 @@ extern void VG_(needs_xml_output) ( void );
    function here. */
 extern void VG_(needs_final_IR_tidy_pass) ( IRSB*(*final_tidy)(IRSB*) );
 
+/* Is the code produced by the tool's instrumentation function a pure
+   function of the guest code and the command line options?  If so,
+   its translations can be kept across runs with --translation-cache.
+   This is not the case if the instrumentation embeds pointers to, or
+   numbers of, things allocated at run time. */
+extern void VG_(needs_persistent_translations) ( void );
+
 
 /* ------------------------------------------------------------------ */
 /* Core events to track */
@@ -399,6 +399,7 @@ static double clo_peak_inaccuracy = 1.0;  // percentage
 static Int    clo_time_unit       = TimeI;
 static Int    clo_detailed_freq   = 10;
 static Int    clo_max_snapshots   = 100;
+static Bool   clo_stream_snapshots = False;
 static const HChar* clo_massif_out_file = "massif.out.%p";
 
 static XArray* args_for_massif;
@@ -443,6 +444,8 @@ static Bool ms_process_cmd_line_option(const HChar* arg)
 
    else if VG_BINT_CLO(arg, "--max-snapshots",  clo_max_snapshots, 10, 1000) {}
 
+   else if VG_BOOL_CLO(arg, "--stream-snapshots", clo_stream_snapshots) {}
+
    else if VG_STR_CLO(arg, "--massif-out-file", clo_massif_out_file) {}
 
    else
@@ -468,6 +471,8 @@ static void ms_print_usage(void)
 "                              or heap bytes alloc'd/dealloc'd [i]\n"
 "    --detailed-freq=<N>       every Nth snapshot should be detailed [10]\n"
 "    --max-snapshots=<N>       maximum number of snapshots recorded [100]\n"
+"    --stream-snapshots=no|yes write each snapshot out as it is taken,\n"
+"                              rather than culling them in memory [no]\n"
 "    --massif-out-file=<file>  output file name [massif.out.%%p]\n"
    );
 }
@@ -1333,6 +1338,8 @@ take_snapshot(Snapshot* snapshot, SnapshotKind kind, Time my_time,
 }
 
 
+static void stream_snapshot(Snapshot* snapshot);   // Just below.
+
 // Take a snapshot, if it's time, or if we've hit a peak.
 static void
 maybe_take_snapshot(SnapshotKind kind, const HChar* what)
@@ -1347,6 +1354,7 @@ maybe_take_snapshot(SnapshotKind kind, const HChar* what)
    static Time earliest_possible_time_of_next_snapshot = 0;
    static Int  n_snapshots_since_last_detailed         = 0;
    static Int  n_skipped_snapshots_since_last_snapshot = 0;
+   static Int  n_streamed_snapshots_since_respacing    = 0;
 
    Snapshot* snapshot;
    Bool      is_detailed;
@@ -1426,10 +1434,27 @@ maybe_take_snapshot(SnapshotKind kind, const HChar* what)
    VERB_snapshot(2, what, next_snapshot_i);
    n_skipped_snapshots_since_last_snapshot = 0;
 
-   // Cull the entries, if our snapshot table is full.
-   next_snapshot_i++;
-   if (clo_max_snapshots == next_snapshot_i) {
-      min_time_interval = cull_snapshots();
+   if (clo_stream_snapshots) {
+      // Nothing is kept: write the snapshot out and throw it away, so
+      // memory use doesn't depend on how long the program runs.  With
+      // no culling to do it for us, we space snapshots out the way
+      // culling would: each time another half of --max-snapshots have
+      // been written, the minimum interval becomes the time so far
+      // divided by that number, ie. the spacing roughly doubles.  The
+      // number of snapshots thus grows only logarithmically with time.
+      stream_snapshot(snapshot);
+      delete_snapshot(snapshot);
+      n_streamed_snapshots_since_respacing++;
+      if (clo_max_snapshots/2 == n_streamed_snapshots_since_respacing) {
+         min_time_interval = my_time / (clo_max_snapshots/2);
+         n_streamed_snapshots_since_respacing = 0;
+      }
+   } else {
+      // Cull the entries, if our snapshot table is full.
+      next_snapshot_i++;
+      if (clo_max_snapshots == next_snapshot_i) {
+         min_time_interval = cull_snapshots();
+      }
    }
 
    // Work out the earliest time when the next snapshot can happen.
@@ -2257,22 +2282,9 @@ static void pp_snapshot(VgFile *fp, Snapshot* snapshot, Int snapshot_n)
    }
 }
 
-static void write_snapshots_to_file(const HChar* massif_out_file, 
-                                    Snapshot snapshots_array[], 
-                                    Int nr_elements)
+static void write_file_header(VgFile *fp)
 {
    Int i;
-   VgFile *fp;
-
-   fp = VG_(fopen)(massif_out_file, VKI_O_CREAT|VKI_O_TRUNC|VKI_O_WRONLY,
-                                    VKI_S_IRUSR|VKI_S_IWUSR);
-   if (fp == NULL) {
-      // If the file can't be opened for whatever reason (conflict
-      // between multiple cachegrinded processes?), give up now.
-      VG_(umsg)("error: can't open output file '%s'\n", massif_out_file );
-      VG_(umsg)("       ... so profiling results will be missing.\n");
-      return;
-   }
 
    // Print massif-specific options that were used.
    // XXX: is it worth having a "desc:" line?  Could just call it "options:"
@@ -2296,6 +2308,26 @@ static void write_snapshots_to_file(const HChar* massif_out_file,
    FP("\n");
 
    FP("time_unit: %s\n", TimeUnit_to_string(clo_time_unit));
+}
+
+static void write_snapshots_to_file(const HChar* massif_out_file, 
+                                    Snapshot snapshots_array[], 
+                                    Int nr_elements)
+{
+   Int i;
+   VgFile *fp;
+
+   fp = VG_(fopen)(massif_out_file, VKI_O_CREAT|VKI_O_TRUNC|VKI_O_WRONLY,
+                                    VKI_S_IRUSR|VKI_S_IWUSR);
+   if (fp == NULL) {
+      // If the file can't be opened for whatever reason (conflict
+      // between multiple cachegrinded processes?), give up now.
+      VG_(umsg)("error: can't open output file '%s'\n", massif_out_file );
+      VG_(umsg)("       ... so profiling results will be missing.\n");
+      return;
+   }
+
+   write_file_header(fp);
 
    for (i = 0; i < nr_elements; i++) {
       Snapshot* snapshot = & snapshots_array[i];
@@ -2317,6 +2349,45 @@ static void write_snapshots_array_to_file(void)
    VG_(free)(massif_out_file);
 }
 
+// With --stream-snapshots=yes, append one snapshot to the output file.
+// The file is (re)created, and the header written, the first time this
+// is called in a process.  Doing this per process rather than once at
+// startup means that, as for the non-streaming case, a child created
+// by fork gets its own file when the name contains %p.  The file is
+// opened and closed for each snapshot, which is cheap given how
+// rarely snapshots are taken, and means that the file is complete up
+// to the last snapshot even if the process is killed.
+static Int stream_pid           = -1;  // Process that started the file.
+static Int n_streamed_snapshots = 0;   // Snapshots written to it.
+
+static void stream_snapshot(Snapshot* snapshot)
+{
+   HChar* massif_out_file =
+      VG_(expand_file_name)("--massif-out-file", clo_massif_out_file);
+   Bool   is_new = ( stream_pid != VG_(getpid)() );
+   VgFile *fp;
+
+   fp = VG_(fopen)(massif_out_file,
+                   VKI_O_CREAT|VKI_O_WRONLY
+                   | (is_new ? VKI_O_TRUNC : VKI_O_APPEND),
+                   VKI_S_IRUSR|VKI_S_IWUSR);
+   if (is_new) {
+      stream_pid           = VG_(getpid)();
+      n_streamed_snapshots = 0;
+      if (fp == NULL) {
+         VG_(umsg)("error: can't open output file '%s'\n", massif_out_file );
+         VG_(umsg)("       ... so profiling results will be missing.\n");
+      } else {
+         write_file_header(fp);
+      }
+   }
+   if (fp != NULL) {
+      pp_snapshot(fp, snapshot, n_streamed_snapshots++);
+      VG_(fclose)(fp);
+   }
+   VG_(free)(massif_out_file);
+}
+
 static void handle_snapshot_monitor_command (const HChar *filename,
                                              Bool detailed)
 {
@@ -2430,8 +2501,9 @@ static void ms_print_stats (void)
 
 static void ms_fini(Int exit_status)
 {
-   // Output.
-   write_snapshots_array_to_file();
+   // Output.  When streaming, every snapshot has been written already.
+   if (!clo_stream_snapshots)
+      write_snapshots_array_to_file();
 
    // Stats
    tl_assert(n_xpts > 0);  // always have alloc_xpt
@@ -139,6 +139,11 @@ void MC_(make_mem_undefined_w_otag)( Addr a, SizeT len, UInt otag );
 void MC_(make_mem_defined)         ( Addr a, SizeT len );
 void MC_(copy_address_range_state) ( Addr src, Addr dst, SizeT len );
 
+/* Give back secondary maps that have become uniform.  Cheap unless
+   enough secondaries have been issued since the last scan.  Must not
+   be called while a SecMap* is live in a caller. */
+void MC_(maybe_reclaim_secmaps)    ( void );
+
 void MC_(print_malloc_stats) ( void );
 /* nr of free operations done */
 SizeT MC_(get_cmalloc_n_frees) ( void );
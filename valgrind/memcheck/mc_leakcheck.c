@@ -177,6 +177,18 @@
 // But ideally we'd present the loss record for the directly lost block and
 // then the resultant indirectly lost blocks and make it clear the
 // dependence.  Double argh.
+//
+// ----
+//
+// Also, a leak search of a very large heap takes minutes, all of it on one
+// thread.  Splitting the root-set scan and the mark phase across helper
+// threads is not possible from a tool: tools run on Valgrind's single
+// serialised thread, with no threads of their own.  Nor are incremental
+// searches that reuse earlier marking: any client store between two
+// searches can change reachability, and memcheck doesn't track which
+// blocks were written to.  What is done is to make the per-word test
+// cheap, see lc_is_a_chunk_ptr; run with -v -v to see how many words the
+// heap range filter discards.
 
 /*------------------------------------------------------------*/
 /*--- The actual algorithm.                                ---*/
@@ -186,7 +198,8 @@
 //   some special treatment because they can be within malloc'd blocks.
 // - Scan every word in the root set (GP registers and valid
 //   non-heap memory words).
-//   - First, we skip if it doesn't point to valid memory.
+//   - First, we skip if it is outside the address range spanned by the
+//     blocks, or doesn't point to valid memory.
 //   - Then, we see if it points to the start or interior of a block.  If
 //     so, we push the block onto the mark stack and mark it as having been
 //     reached.
@@ -453,6 +466,13 @@ typedef
 static MC_Chunk** lc_chunks;
 // How many chunks we're dealing with.
 static Int        lc_n_chunks;
+// The address range [lc_chunks_min_addr, lc_chunks_max_addr) spanned by
+// the chunks in lc_chunks.  Most scanned words which are not pointers
+// to a chunk lie outside it, and can be discarded with two compares
+// rather than an address-space-manager lookup and a binary search.
+// An empty range (both 0) when there are no chunks.
+static Addr       lc_chunks_min_addr;
+static Addr       lc_chunks_max_addr;
 static SizeT lc_chunks_n_frees_marker;
 // This has the same number of entries as lc_chunks, and each entry
 // in lc_chunks corresponds with the entry here (ie. lc_chunks[i] and
@@ -495,6 +515,10 @@ static SizeT lc_scanned_szB;
 // Keeps track of how many bytes we have not scanned due to read errors that
 // caused a signal such as SIGSEGV.
 static SizeT lc_sig_skipped_szB;
+// How many words were checked for being a pointer to a chunk, and how many
+// of those the range filter in lc_is_a_chunk_ptr discarded, for printing.
+static SizeT lc_n_ptr_checks;
+static SizeT lc_n_ptr_range_misses;
 
 
 SizeT MC_(bytes_leaked)     = 0;
@@ -525,6 +549,13 @@ lc_is_a_chunk_ptr(Addr ptr, Int* pch_no, MC_Chunk** pch, LC_Extra** pex)
    MC_Chunk* ch;
    LC_Extra* ex;
 
+   // Quickest filter: anything outside the span of the heap blocks.
+   lc_n_ptr_checks++;
+   if (ptr < lc_chunks_min_addr || ptr >= lc_chunks_max_addr) {
+      lc_n_ptr_range_misses++;
+      return False;
+   }
+
    // Quick filter. Note: implemented with am, not with get_vabits2
    // as ptr might be random data pointing anywhere. On 64 bit
    // platforms, getting va bits for random data can be quite costly
@@ -1713,6 +1744,8 @@ static void scan_memory_root_set(Addr searched, SizeT szB)
 
    lc_scanned_szB = 0;
    lc_sig_skipped_szB = 0;
+   lc_n_ptr_checks = 0;
+   lc_n_ptr_range_misses = 0;
 
    // VG_(am_show_nsegments)( 0, "leakcheck");
    for (i = 0; i < n_seg_starts; i++) {
@@ -1785,6 +1818,7 @@ void MC_(detect_memory_leaks) ( ThreadId tid, LeakCheckParams* lcp)
       VG_(free)(lc_chunks);
       lc_chunks = NULL;
    }
+   lc_chunks_min_addr = lc_chunks_max_addr = 0;
    lc_chunks = find_active_chunks(&lc_n_chunks);
    lc_chunks_n_frees_marker = MC_(get_cmalloc_n_frees)();
    if (lc_n_chunks == 0) {
@@ -1876,6 +1910,17 @@ void MC_(detect_memory_leaks) ( ThreadId tid, LeakCheckParams* lcp)
       }
    }
 
+   // Work out the address range spanned by the chunks.  Zero-sized
+   // blocks are treated as having size 1, as in find_chunk_for.
+   lc_chunks_min_addr = lc_chunks[0]->data;
+   lc_chunks_max_addr = 0;
+   for (i = 0; i < lc_n_chunks; i++) {
+      MC_Chunk* ch  = lc_chunks[i];
+      Addr      end = ch->data + ch->szB + (ch->szB == 0 ? 1 : 0);
+      if (end > lc_chunks_max_addr)
+         lc_chunks_max_addr = end;
+   }
+
    // Initialise lc_extras.
    if (lc_extras) {
       VG_(free)(lc_extras);
@@ -1915,6 +1960,8 @@ void MC_(detect_memory_leaks) ( ThreadId tid, LeakCheckParams* lcp)
 
    if (VG_(clo_verbosity) > 1 && !VG_(clo_xml)) {
       VG_(umsg)("Checked %'lu bytes\n", lc_scanned_szB);
+      VG_(umsg)("Checked %'lu words for pointers, %'lu outside the heap range\n",
+                lc_n_ptr_checks, lc_n_ptr_range_misses);
       if (lc_sig_skipped_szB > 0)
          VG_(umsg)("Skipped %'lu bytes due to read errors\n",
                    lc_sig_skipped_szB);
@@ -684,6 +684,109 @@ static SecMap* maybe_get_secmap_for ( Addr a )
    }
 }
 
+/* --------------- Reclaiming uniform secondaries --------------- */
+
+/* A non-distinguished secondary is only ever replaced by a
+   distinguished one when set_address_range_perms covers all of its
+   64k in one go.  Memory that is freed piecewise -- heap blocks,
+   mostly -- leaves behind secondaries which are entirely NOACCESS (or
+   DEFINED, or UNDEFINED) but which still cost 16k each, and on
+   programs that churn through a large heap these dominate shadow
+   memory use.
+
+   So, every now and then, look for such secondaries, unmap them and
+   point their primary map entries back at the matching distinguished
+   secondary.  They are expanded again lazily, by copy_for_writing,
+   if they are ever written.
+
+   This must only be done when no caller is holding a SecMap* across
+   the call, hence it is done only from the heap-free and munmap/brk
+   handlers, and not from within the shadow memory primitives. */
+
+/* Don't bother scanning until this many secondaries are in use, and
+   afterwards wait until the number in use has doubled again.  This
+   keeps the total scanning cost proportional to the total number of
+   secondaries issued. */
+#define SM_RECLAIM_MIN_SMS 1024
+
+static Int   sm_reclaim_threshold = SM_RECLAIM_MIN_SMS;
+static ULong n_sm_reclaim_runs    = 0;
+static ULong n_reclaimed_SMs      = 0;
+
+/* If all of sm has the same state, return the matching distinguished
+   secondary, else NULL. */
+static SecMap* uniform_dsm_for ( const SecMap* sm )
+{
+   const UWord* w = (const UWord*)&sm->vabits8[0];
+   UWord w0 = w[0];
+   SecMap* dsm;
+   Int i;
+
+   if      (w0 == (UWord)0)
+      dsm = &sm_distinguished[SM_DIST_NOACCESS];
+   else if (w0 == (UWord)0x5555555555555555ULL)
+      dsm = &sm_distinguished[SM_DIST_UNDEFINED];
+   else if (w0 == (UWord)0xaaaaaaaaaaaaaaaaULL)
+      dsm = &sm_distinguished[SM_DIST_DEFINED];
+   else
+      return NULL;
+
+   for (i = 1; i < SM_CHUNKS / sizeof(UWord); i++)
+      if (w[i] != w0)
+         return NULL;
+   return dsm;
+}
+
+static Bool maybe_reclaim_SM ( SecMap** sm_ptr )
+{
+   SecMap* dsm;
+   SysRes  sres;
+
+   if (is_distinguished_sm(*sm_ptr))
+      return False;
+   dsm = uniform_dsm_for(*sm_ptr);
+   if (dsm == NULL)
+      return False;
+
+   sres = VG_(am_munmap_valgrind)((Addr)*sm_ptr, sizeof(SecMap));
+   tl_assert2(! sr_isError(sres), "SecMap valgrind munmap failure\n");
+   update_SM_counts(*sm_ptr, dsm);
+   *sm_ptr = dsm;
+   return True;
+}
+
+static void reclaim_uniform_SMs ( void )
+{
+   AuxMapEnt* elem;
+   Int i;
+
+   n_sm_reclaim_runs++;
+   for (i = 0; i < N_PRIMARY_MAP; i++)
+      if (maybe_reclaim_SM(&primary_map[i]))
+         n_reclaimed_SMs++;
+
+   VG_(OSetGen_ResetIter)(auxmap_L2);
+   while ( (elem = VG_(OSetGen_Next)(auxmap_L2)) ) {
+      if (maybe_reclaim_SM(&elem->sm))
+         n_reclaimed_SMs++;
+   }
+
+   sm_reclaim_threshold = 2 * n_non_DSM_SMs;
+   if (sm_reclaim_threshold < SM_RECLAIM_MIN_SMS)
+      sm_reclaim_threshold = SM_RECLAIM_MIN_SMS;
+
+   if (VG_(clo_verbosity) > 2)
+      VG_(message)(Vg_DebugMsg,
+                   "memcheck: reclaimed secondaries: %llu total, "
+                   "%d now in use\n", n_reclaimed_SMs, n_non_DSM_SMs);
+}
+
+void MC_(maybe_reclaim_secmaps) ( void )
+{
+   if (UNLIKELY(n_non_DSM_SMs >= sm_reclaim_threshold))
+      reclaim_uniform_SMs();
+}
+
 /* --------------- Fundamental functions --------------- */
 
 static INLINE
@@ -1792,6 +1895,12 @@ void MC_(make_mem_noaccess) ( Addr a, SizeT len )
       ocache_sarp_Clear_Origins ( a, len );
 }
 
+static void mc_die_mem_brk_or_munmap ( Addr a, SizeT len )
+{
+   MC_(make_mem_noaccess) ( a, len );
+   MC_(maybe_reclaim_secmaps) ();
+}
+
 static void make_mem_undefined ( Addr a, SizeT len )
 {
    PROF_EVENT(MCPE_MAKE_MEM_UNDEFINED);
@@ -7412,7 +7521,10 @@ static void mc_post_clo_init ( void )
       VG_(track_new_mem_stack_w_ECU)     ( mc_new_mem_stack_w_ECU     );
       VG_(track_new_mem_stack_signal)    ( mc_new_mem_w_tid_make_ECU );
    } else {
-      /* Not doing origin tracking */
+      /* Not doing origin tracking.  Our instrumentation then depends
+         only on the guest code and the options, so it can be kept
+         across runs.  (With origin tracking it embeds ECUs.) */
+      VG_(needs_persistent_translations)();
 #     ifdef PERF_FAST_STACK
       VG_(track_new_mem_stack_4)   ( mc_new_mem_stack_4   );
       VG_(track_new_mem_stack_8)   ( mc_new_mem_stack_8   );
@@ -7524,7 +7636,7 @@ static void print_SM_info(const HChar* type, Int n_SMs)
 
 static void mc_print_stats (void)
 {
-   SizeT max_secVBit_szB, max_SMs_szB, max_shmem_szB;
+   SizeT max_secVBit_szB, max_SMs_szB, max_shmem_szB, cur_shmem_szB;
 
    VG_(message)(Vg_DebugMsg, " memcheck: freelist: vol %lld length %lld\n",
                 VG_(free_queue_volume), VG_(free_queue_length));
@@ -7553,6 +7665,10 @@ static void mc_print_stats (void)
    print_SM_info("max_undefined", max_undefined_SMs);
    print_SM_info("max_defined  ", max_defined_SMs);
    print_SM_info("max_non_DSM  ", max_non_DSM_SMs);
+   print_SM_info("now_non_DSM  ", n_non_DSM_SMs);
+   VG_(message)(Vg_DebugMsg,
+      " memcheck: SMs reclaimed: %llu in %llu scans\n",
+      n_reclaimed_SMs, n_sm_reclaim_runs);
 
    // Three DSMs, plus the non-DSM ones
    max_SMs_szB = (3 + max_non_DSM_SMs) * sizeof(SecMap);
@@ -7577,6 +7693,13 @@ static void mc_print_stats (void)
    VG_(message)(Vg_DebugMsg,
       " memcheck: max shadow mem size:   %luk, %luM\n",
       max_shmem_szB / 1024, max_shmem_szB / (1024 * 1024));
+   cur_shmem_szB = sizeof(primary_map) + (3 + n_non_DSM_SMs) * sizeof(SecMap)
+                   + n_secVBit_nodes *
+                     (3*sizeof(Word) + VG_ROUNDUP(sizeof(SecVBitNode),
+                                                  sizeof(void*)));
+   VG_(message)(Vg_DebugMsg,
+      " memcheck: cur shadow mem size:   %luk, %luM\n",
+      cur_shmem_szB / 1024, cur_shmem_szB / (1024 * 1024));
 
    if (MC_(clo_mc_level) >= 3) {
       VG_(message)(Vg_DebugMsg,
@@ -7779,8 +7902,8 @@ static void mc_pre_clo_init(void)
    VG_(track_copy_mem_remap)      ( MC_(copy_address_range_state) );
 
    VG_(track_die_mem_stack_signal)( MC_(make_mem_noaccess) ); 
-   VG_(track_die_mem_brk)         ( MC_(make_mem_noaccess) );
-   VG_(track_die_mem_munmap)      ( MC_(make_mem_noaccess) ); 
+   VG_(track_die_mem_brk)         ( mc_die_mem_brk_or_munmap );
+   VG_(track_die_mem_munmap)      ( mc_die_mem_brk_or_munmap );
 
    /* Defer the specification of the new_mem_stack functions to the
       post_clo_init function, since we need to first parse the command
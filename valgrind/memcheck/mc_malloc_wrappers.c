@@ -441,6 +441,7 @@ void die_and_free_mem ( ThreadId tid, MC_Chunk* mc, SizeT rzB )
    /* Note: make redzones noaccess again -- just in case user made them
       accessible with a client request... */
    MC_(make_mem_noaccess)( mc->data-rzB, mc->szB + 2*rzB );
+   MC_(maybe_reclaim_secmaps)();
 
    /* Record where freed */
    MC_(set_freed_at) (tid, mc);
@@ -65,7 +65,8 @@ static void nl_pre_clo_init(void)
                                  nl_instrument,
                                  nl_fini);
 
-   /* No needs, no core events to track */
+   /* No core events to track */
+   VG_(needs_persistent_translations)();
 }
 
 VG_DETERMINE_INTERFACE_VERSION(nl_pre_clo_init)
@@ -14,6 +14,20 @@
 #include "2rsa.h"
 #include "2sha.h"
 
+/*
+ * Where the compiler has a 128-bit integer type, the Montgomery arithmetic is
+ * done on 64-bit words.  That takes a quarter of the multiplies and half the
+ * loop iterations of the 32-bit code.  Define VB2_RSA_MONT64 to 0 to always
+ * use the 32-bit code.
+ */
+#ifndef VB2_RSA_MONT64
+#ifdef __SIZEOF_INT128__
+#define VB2_RSA_MONT64 1
+#else
+#define VB2_RSA_MONT64 0
+#endif
+#endif
+
 /**
  * a[] -= mod
  */
@@ -139,6 +153,160 @@ static void modpowF4(const struct vb2_public_key *key, uint8_t *inout,
 	}
 }
 
+#if VB2_RSA_MONT64
+
+typedef unsigned __int128 uint128_t;
+
+/**
+ * Return word i of a little endian uint32_t array as a uint64_t
+ */
+static inline uint64_t word64(const uint32_t *a, uint32_t i)
+{
+	return a[2 * i] | (uint64_t)a[2 * i + 1] << 32;
+}
+
+/**
+ * a[] -= mod, on 64-bit words
+ */
+static void subM64(const struct vb2_public_key *key, uint64_t *a)
+{
+	uint64_t borrow = 0;
+	uint32_t i;
+	for (i = 0; i < key->arrsize / 2; ++i) {
+		uint64_t n = word64(key->n, i);
+		uint64_t d = a[i] - n - borrow;
+		borrow = (a[i] < n) | ((a[i] == n) & borrow);
+		a[i] = d;
+	}
+}
+
+/**
+ * Return a[] >= mod, on 64-bit words
+ */
+static int mont_ge64(const struct vb2_public_key *key, const uint64_t *a)
+{
+	uint32_t i;
+	for (i = key->arrsize / 2; i;) {
+		uint64_t n;
+		--i;
+		n = word64(key->n, i);
+		if (a[i] < n)
+			return 0;
+		if (a[i] > n)
+			return 1;
+	}
+	return 1;  /* equal */
+}
+
+/**
+ * Montgomery c[] += a * b[] / R % mod, on 64-bit words
+ *
+ * Same carry handling as montMulAdd(); the products and carries still fit
+ * the 128-bit accumulators.
+ */
+static void montMulAdd64(const struct vb2_public_key *key,
+			 uint64_t n0inv,
+			 uint64_t *c,
+			 const uint64_t a,
+			 const uint64_t *b)
+{
+	uint32_t len = key->arrsize / 2;
+	uint128_t A = (uint128_t)a * b[0] + c[0];
+	uint64_t d0 = (uint64_t)A * n0inv;
+	uint128_t B = (uint128_t)d0 * word64(key->n, 0) + (uint64_t)A;
+	uint32_t i;
+
+	for (i = 1; i < len; ++i) {
+		A = (A >> 64) + (uint128_t)a * b[i] + c[i];
+		B = (B >> 64) + (uint128_t)d0 * word64(key->n, i) + (uint64_t)A;
+		c[i - 1] = (uint64_t)B;
+	}
+
+	A = (A >> 64) + (B >> 64);
+
+	c[i - 1] = (uint64_t)A;
+
+	if (A >> 64) {
+		subM64(key, c);
+	}
+}
+
+/**
+ * Montgomery c[] = a[] * b[] / R % mod, on 64-bit words
+ */
+static void montMul64(const struct vb2_public_key *key,
+		      uint64_t n0inv,
+		      uint64_t *c,
+		      const uint64_t *a,
+		      const uint64_t *b)
+{
+	uint32_t i;
+	for (i = 0; i < key->arrsize / 2; ++i) {
+		c[i] = 0;
+	}
+	for (i = 0; i < key->arrsize / 2; ++i) {
+		montMulAdd64(key, n0inv, c, a[i], b);
+	}
+}
+
+/**
+ * In-place public exponentiation (65537) on 64-bit words.
+ *
+ * Same as modpowF4(), for keys with an even arrsize.  The work buffer holds
+ * the same number of bytes; key->rr is converted into aaR before it is first
+ * used.
+ */
+static void modpowF4_64(const struct vb2_public_key *key, uint8_t *inout,
+			uint32_t *workbuf32)
+{
+	uint32_t len = key->arrsize / 2;
+	uint64_t *a = (uint64_t *)workbuf32;
+	uint64_t *aR = a + len;
+	uint64_t *aaR = aR + len;
+	uint64_t *aaa = aaR;  /* Re-use location. */
+	uint64_t *rr = aaR;   /* Only needed before aaR is. */
+	uint64_t n0inv;
+	int i, j;
+
+	/*
+	 * key->n0inv is -1 / n mod 2^32.  One Newton step on 1 / n extends it
+	 * to 2^64.
+	 */
+	n0inv = (uint32_t)(0 - key->n0inv);
+	n0inv *= 2 - word64(key->n, 0) * n0inv;
+	n0inv = 0 - n0inv;
+
+	/* Convert from big endian byte array to little endian word array. */
+	for (i = 0; i < (int)len; ++i) {
+		const uint8_t *p = inout + (len - 1 - i) * 8;
+		uint64_t tmp = 0;
+		for (j = 0; j < 8; ++j)
+			tmp = (tmp << 8) | p[j];
+		a[i] = tmp;
+		rr[i] = word64(key->rr, i);
+	}
+
+	montMul64(key, n0inv, aR, a, rr);  /* aR = a * RR / R mod M   */
+	for (i = 0; i < 16; i+=2) {
+		montMul64(key, n0inv, aaR, aR, aR);  /* aaR = aR * aR / R mod M */
+		montMul64(key, n0inv, aR, aaR, aaR);  /* aR = aaR * aaR / R mod M */
+	}
+	montMul64(key, n0inv, aaa, aR, a);  /* aaa = aR * a / R mod M */
+
+	/* Make sure aaa < mod; aaa is at most 1x mod too large. */
+	if (mont_ge64(key, aaa)) {
+		subM64(key, aaa);
+	}
+
+	/* Convert to bigendian byte array */
+	for (i = (int)len - 1; i >= 0; --i) {
+		uint64_t tmp = aaa[i];
+		for (j = 56; j >= 0; j -= 8)
+			*inout++ = (uint8_t)(tmp >> j);
+	}
+}
+
+#endif  /* VB2_RSA_MONT64 */
 
 static const uint8_t crypto_to_sig[] = {
 	VB2_SIG_RSA1024,
@@ -316,11 +484,24 @@ int vb2_rsa_verify_digest(const struct vb2_public_key *key,
 		return VB2_ERROR_RSA_VERIFY_SIG_LEN;
 	}
 
+	if (key->allow_hwcrypto) {
+		rv = vb2ex_hwcrypto_rsa_verify_digest(key, sig, digest);
+		if (rv != VB2_ERROR_EX_HWCRYPTO_UNSUPPORTED)
+			return rv;
+		VB2_DEBUG("HW RSA for sig_alg %d not supported, using SW\n",
+			  key->sig_alg);
+	}
+
 	workbuf32 = vb2_workbuf_alloc(&wblocal, 3 * key_bytes);
 	if (!workbuf32)
 		return VB2_ERROR_RSA_VERIFY_WORKBUF;
 
-	modpowF4(key, sig, workbuf32);
+#if VB2_RSA_MONT64
+	if (!(key->arrsize & 1))
+		modpowF4_64(key, sig, workbuf32);
+	else
+#endif
+		modpowF4(key, sig, workbuf32);
 
 	vb2_workbuf_free(&wblocal, 3 * key_bytes);
 
@@ -57,3 +57,11 @@ int vb2ex_hwcrypto_digest_finalize(uint8_t *digest,
 {
 	return VB2_ERROR_SHA_FINALIZE_ALGORITHM; /* Should not be called. */
 }
+
+__attribute__((weak))
+int vb2ex_hwcrypto_rsa_verify_digest(const struct vb2_public_key *key,
+				     const uint8_t *sig,
+				     const uint8_t *digest)
+{
+	return VB2_ERROR_EX_HWCRYPTO_UNSUPPORTED;
+}
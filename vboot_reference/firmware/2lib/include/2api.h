@@ -28,6 +28,8 @@
 #include "2recovery_reasons.h"
 #include "2return_codes.h"
 
+struct vb2_public_key;
+
 /* Size of non-volatile data used by vboot */
 #define VB2_NVDATA_SIZE 16
 
@@ -423,4 +425,19 @@ int vb2ex_hwcrypto_digest_extend(const uint8_t *buf, uint32_t size);
  */
 int vb2ex_hwcrypto_digest_finalize(uint8_t *digest, uint32_t digest_size);
 
+/**
+ * Verify a RSA PKCS1.5 signature against an expected hash digest using the
+ * hardware crypto engine.
+ *
+ * Only called for keys with allow_hwcrypto set.
+ *
+ * @param key		Key to use in signature verification
+ * @param sig		Signature to verify
+ * @param digest	Digest of signed data
+ * @return VB2_SUCCESS, or non-zero error code (HWCRYPTO_UNSUPPORTED not fatal).
+ */
+int vb2ex_hwcrypto_rsa_verify_digest(const struct vb2_public_key *key,
+				     const uint8_t *sig,
+				     const uint8_t *digest);
+
 #endif  /* VBOOT_2_API_H_ */
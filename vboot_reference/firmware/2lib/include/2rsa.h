@@ -22,6 +22,7 @@ struct vb2_public_key {
 	const char *desc;            /* Description */
 	uint32_t version;            /* Key version */
 	const struct vb2_guid *guid; /* Key GUID */
+	int allow_hwcrypto;          /* Try vb2ex_hwcrypto routines first */
 };
 
 /**
@@ -66,6 +67,10 @@ int vb2_check_padding(const uint8_t *sig, const struct vb2_public_key *key);
 /**
  * Verify a RSA PKCS1.5 signature against an expected hash digest.
  *
+ * If key->allow_hwcrypto is set, the hardware crypto engine is tried first and
+ * the software implementation is only used if the engine does not support the
+ * key.
+ *
  * @param key		Key to use in signature verification
  * @param sig		Signature to verify (destroyed in process)
  * @param digest	Digest of signed data
@@ -183,6 +183,10 @@ int vb2api_check_hash(struct vb2_context *ctx)
 	if (rv)
 		return rv;
 
+	/* Same policy as for the hash */
+	key.allow_hwcrypto =
+		!(pre->flags & VB2_FIRMWARE_PREAMBLE_DISALLOW_HWCRYPTO);
+
 	/*
 	 * Check digest vs. signature.  Note that this destroys the signature.
 	 * That's ok, because we only check each signature once per boot.
@@ -73,5 +73,8 @@ int vb2_unpack_key(struct vb2_public_key *key,
 	key->n = buf32 + 2;
 	key->rr = buf32 + 2 + key->arrsize;
 
+	/* Callers opt in to hardware crypto */
+	key->allow_hwcrypto = 0;
+
 	return VB2_SUCCESS;
 }
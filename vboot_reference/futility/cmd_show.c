@@ -40,6 +40,7 @@ static struct local_data_s {
 	uint32_t padding;
 	int strict;
 	int t_flag;
+	int jobs;
 } option = {
 	.padding = 65536,
 };
@@ -558,6 +559,7 @@ static const char usage[] = "\n"
 	"            Use this public key for validation\n"
 	"  -f|--fv          FILE            Verify this payload (FW_MAIN_A/B)\n"
 	"  --pad            NUM             Kernel vblock padding size\n"
+	"  -j|--jobs        NUM             Process up to NUM files at once\n"
 	"%s"
 	"\n";
 
@@ -578,11 +580,12 @@ static const struct option long_opts[] = {
 	{"publickey",   1, 0, 'k'},
 	{"fv",          1, 0, 'f'},
 	{"pad",         1, NULL, OPT_PADDING},
+	{"jobs",        1, NULL, 'j'},
 	{"verify",      0, &option.strict, 1},
 	{"debug",       0, &debugging_enabled, 1},
 	{NULL, 0, NULL, 0},
 };
-static char *short_opts = ":f:k:t";
+static char *short_opts = ":f:k:tj:";
 
 
 static void show_type(char *filename)
@@ -611,14 +614,57 @@ static void show_type(char *filename)
 	}
 }
 
-static int do_show(int argc, char *argv[])
+static int show_one(char *infile)
 {
-	char *infile = 0;
-	int ifd, i;
+	int ifd;
 	int errorcnt = 0;
 	struct futil_traverse_state_s state;
 	uint8_t *buf;
 	uint32_t buf_len;
+
+	ifd = open(infile, O_RDONLY);
+	if (ifd < 0) {
+		fprintf(stderr, "Can't open %s: %s\n",
+			infile, strerror(errno));
+		return 1;
+	}
+
+	if (0 != futil_map_file(ifd, MAP_RO, &buf, &buf_len)) {
+		errorcnt++;
+		goto boo;
+	}
+
+	memset(&state, 0, sizeof(state));
+	state.in_filename = infile ? infile : "<none>";
+	state.op = FUTIL_OP_SHOW;
+
+	errorcnt += futil_traverse(buf, buf_len, &state,
+				   FILE_TYPE_UNKNOWN);
+
+	errorcnt += futil_unmap_file(ifd, MAP_RO, buf, buf_len);
+
+boo:
+	if (close(ifd)) {
+		errorcnt++;
+		fprintf(stderr, "Error when closing %s: %s\n",
+			infile, strerror(errno));
+	}
+
+	return errorcnt;
+}
+
+/* futil_run_jobs() callback; arg is the list of files */
+static int show_one_job(int index, void *arg)
+{
+	char **files = arg;
+
+	return show_one(files[index]);
+}
+
+static int do_show(int argc, char *argv[])
+{
+	int i;
+	int errorcnt = 0;
 	char *e = 0;
 
 	opterr = 0;		/* quiet, you */
@@ -650,6 +696,14 @@ static int do_show(int argc, char *argv[])
 				errorcnt++;
 			}
 			break;
+		case 'j':
+			option.jobs = strtoul(optarg, &e, 0);
+			if (!*optarg || (e && *e) || option.jobs < 1) {
+				fprintf(stderr,
+					"Invalid --jobs \"%s\"\n", optarg);
+				errorcnt++;
+			}
+			break;
 
 		case '?':
 			if (optopt)
@@ -687,39 +741,15 @@ static int do_show(int argc, char *argv[])
 		goto done;
 	}
 
-	for (i = optind; i < argc; i++) {
-		infile = argv[i];
-		ifd = open(infile, O_RDONLY);
-		if (ifd < 0) {
-			errorcnt++;
-			fprintf(stderr, "Can't open %s: %s\n",
-				infile, strerror(errno));
-			continue;
-		}
-
-		if (0 != futil_map_file(ifd, MAP_RO, &buf, &buf_len)) {
-			errorcnt++;
-			goto boo;
-		}
-
-		memset(&state, 0, sizeof(state));
-		state.in_filename = infile ? infile : "<none>";
-		state.op = FUTIL_OP_SHOW;
-
-		errorcnt += futil_traverse(buf, buf_len, &state,
-					   FILE_TYPE_UNKNOWN);
-
-
-		errorcnt += futil_unmap_file(ifd, MAP_RO, buf, buf_len);
-
-boo:
-		if (close(ifd)) {
-			errorcnt++;
-			fprintf(stderr, "Error when closing %s: %s\n",
-				infile, strerror(errno));
-		}
+	if (option.jobs > 1) {
+		errorcnt += futil_run_jobs(argc - optind, option.jobs,
+					   show_one_job, argv + optind);
+		goto done;
 	}
 
+	for (i = optind; i < argc; i++)
+		errorcnt += show_one(argv[i]);
+
 done:
 	if (option.k)
 		free(option.k);
@@ -62,6 +62,8 @@ static struct local_data_s {
 	int pem_algo_specified;
 	uint32_t pem_algo;
 	char *pem_external;
+	char *batchfile;
+	int jobs;
 } option = {
 	.version = 1,
 	.arch = ARCH_UNSPECIFIED,
@@ -524,7 +526,13 @@ static const char usage[] = "\n"
 	"  raw firmware blob (FW_MAIN_A/B); OUTFILE is a VBLOCK_A/B\n"
 	"  complete firmware image (bios.bin)\n"
 	"  raw linux kernel; OUTFILE is a kernel partition image\n"
-	"  kernel partition image (/dev/sda2, /dev/mmcblk0p2)\n";
+	"  kernel partition image (/dev/sda2, /dev/mmcblk0p2)\n"
+	"\n"
+	"or:     " MYNAME " %s [PARAMS] --batch LISTFILE [-j NUM]\n"
+	"\n"
+	"to sign many files with the same PARAMS. LISTFILE (\"-\" for stdin)\n"
+	"has one \"INFILE [OUTFILE]\" per line, and up to NUM files (default\n"
+	"one per CPU) are signed at once. Output files must be distinct.\n";
 
 static const char usage_pubkey[] = "\n"
 	"-----------------------------------------------------------------\n"
@@ -646,7 +654,7 @@ static const char usage_old_kpart[] = "\n"
 
 static void print_help(const char *prog)
 {
-	printf(usage, prog);
+	printf(usage, prog, prog);
 	printf(usage_pubkey, kNumAlgorithms - 1);
 	puts(usage_fw_main);
 	printf(usage_bios, option.version);
@@ -666,6 +674,7 @@ enum no_short_opts {
 	OPT_PEM_SIGNPRIV,
 	OPT_PEM_ALGO,
 	OPT_PEM_EXTERNAL,
+	OPT_BATCH,
 };
 
 static const struct option long_opts[] = {
@@ -692,26 +701,302 @@ static const struct option long_opts[] = {
 	{"pem_signpriv", 1, NULL, OPT_PEM_SIGNPRIV},
 	{"pem_algo",     1, NULL, OPT_PEM_ALGO},
 	{"pem_external", 1, NULL, OPT_PEM_EXTERNAL},
+	{"batch",        1, NULL, OPT_BATCH},
+	{"jobs",         1, NULL, 'j'},
 	{"vblockonly",   0, &option.vblockonly, 1},
 	{"debug",        0, &debugging_enabled, 1},
 	{NULL,           0, NULL, 0},
 };
-static char *short_opts = ":s:b:k:S:B:v:f:d:l:";
+static char *short_opts = ":s:b:k:S:B:v:f:d:l:j:";
 
-static int do_sign(int argc, char *argv[])
+/*
+ * Sign one input file with the keys and options already loaded. The output
+ * file, if any, is in option.outfile; inout_file_count is how many of the two
+ * were named by the user.
+ */
+static int sign_one(char *infile, int inout_file_count)
 {
-	char *infile = 0;
-	int i;
 	int ifd = -1;
 	int errorcnt = 0;
 	struct futil_traverse_state_s state;
 	uint8_t *buf;
 	uint32_t buf_len;
-	char *e = 0;
 	enum futil_file_type type;
-	int inout_file_count = 0;
 	int mapping;
 
+	/* What are we looking at? */
+	if (futil_file_type(infile, &type)) {
+		errorcnt++;
+		goto done;
+	}
+
+	/* We may be able to infer the type based on the other args */
+	if (type == FILE_TYPE_UNKNOWN) {
+		if (option.bootloader_data || option.config_data
+		    || option.arch != ARCH_UNSPECIFIED)
+			type = FILE_TYPE_RAW_KERNEL;
+		else if (option.kernel_subkey || option.fv_specified)
+			type = FILE_TYPE_RAW_FIRMWARE;
+	}
+
+	Debug("type=%s\n", futil_file_type_str(type));
+
+	/* Check the arguments for the type of thing we want to sign */
+	switch (type) {
+	case FILE_TYPE_UNKNOWN:
+		fprintf(stderr,
+			"Unable to determine the type of the input file\n");
+		errorcnt++;
+		goto done;
+	case FILE_TYPE_PUBKEY:
+		option.create_new_outfile = 1;
+		if (option.signprivate && option.pem_signpriv) {
+			fprintf(stderr,
+				"Only one of --signprivate and --pem_signpriv"
+				" can be specified\n");
+			errorcnt++;
+		}
+		if ((option.signprivate && option.pem_algo_specified) ||
+		    (option.pem_signpriv && !option.pem_algo_specified)) {
+			fprintf(stderr, "--pem_algo must be used with"
+				" --pem_signpriv\n");
+			errorcnt++;
+		}
+		if (option.pem_external && !option.pem_signpriv) {
+			fprintf(stderr, "--pem_external must be used with"
+				" --pem_signpriv\n");
+			errorcnt++;
+		}
+		/* We'll wait to read the PEM file, since the external signer
+		 * may want to read it instead. */
+		break;
+	case FILE_TYPE_KEYBLOCK:
+		fprintf(stderr, "Resigning a keyblock is kind of pointless.\n");
+		fprintf(stderr, "Just create a new one.\n");
+		errorcnt++;
+		break;
+	case FILE_TYPE_FW_PREAMBLE:
+		fprintf(stderr,
+			"%s IS a signature. Sign the firmware instead\n",
+			infile);
+		break;
+	case FILE_TYPE_GBB:
+		fprintf(stderr, "There's no way to sign a GBB\n");
+		errorcnt++;
+		break;
+	case FILE_TYPE_BIOS_IMAGE:
+	case FILE_TYPE_OLD_BIOS_IMAGE:
+		errorcnt += no_opt_if(!option.signprivate, "signprivate");
+		errorcnt += no_opt_if(!option.keyblock, "keyblock");
+		errorcnt += no_opt_if(!option.kernel_subkey, "kernelkey");
+		break;
+	case FILE_TYPE_KERN_PREAMBLE:
+		errorcnt += no_opt_if(!option.signprivate, "signprivate");
+		if (option.vblockonly || inout_file_count > 1)
+			option.create_new_outfile = 1;
+		break;
+	case FILE_TYPE_RAW_FIRMWARE:
+		option.create_new_outfile = 1;
+		errorcnt += no_opt_if(!option.signprivate, "signprivate");
+		errorcnt += no_opt_if(!option.keyblock, "keyblock");
+		errorcnt += no_opt_if(!option.kernel_subkey, "kernelkey");
+		errorcnt += no_opt_if(!option.version_specified, "version");
+		break;
+	case FILE_TYPE_RAW_KERNEL:
+		option.create_new_outfile = 1;
+		errorcnt += no_opt_if(!option.signprivate, "signprivate");
+		errorcnt += no_opt_if(!option.keyblock, "keyblock");
+		errorcnt += no_opt_if(!option.version_specified, "version");
+		errorcnt += no_opt_if(!option.bootloader_data, "bootloader");
+		errorcnt += no_opt_if(!option.config_data, "config");
+		errorcnt += no_opt_if(option.arch == ARCH_UNSPECIFIED, "arch");
+		break;
+	case FILE_TYPE_CHROMIUMOS_DISK:
+		fprintf(stderr, "Signing a %s is not yet supported\n",
+			futil_file_type_str(type));
+		errorcnt++;
+		break;
+	default:
+		DIE;
+	}
+
+	Debug("infile=%s\n", infile);
+	Debug("inout_file_count=%d\n", inout_file_count);
+	Debug("option.create_new_outfile=%d\n", option.create_new_outfile);
+
+	/* Make sure we have an output file if one is needed */
+	if (!option.outfile) {
+		if (option.create_new_outfile) {
+			errorcnt++;
+			fprintf(stderr, "Missing output filename\n");
+			goto done;
+		} else {
+			option.outfile = infile;
+		}
+	}
+
+	Debug("option.outfile=%s\n", option.outfile);
+
+	if (errorcnt)
+		goto done;
+
+	memset(&state, 0, sizeof(state));
+	state.op = FUTIL_OP_SIGN;
+
+	if (option.create_new_outfile) {
+		/* The input is read-only, the output is write-only. */
+		mapping = MAP_RO;
+		state.in_filename = infile;
+		Debug("open RO %s\n", infile);
+		ifd = open(infile, O_RDONLY);
+		if (ifd < 0) {
+			errorcnt++;
+			fprintf(stderr, "Can't open %s for reading: %s\n",
+				infile, strerror(errno));
+			goto done;
+		}
+	} else {
+		/* We'll read-modify-write the output file */
+		mapping = MAP_RW;
+		state.in_filename = option.outfile;
+		if (inout_file_count > 1)
+			futil_copy_file_or_die(infile, option.outfile);
+		Debug("open RW %s\n", option.outfile);
+		ifd = open(option.outfile, O_RDWR);
+		if (ifd < 0) {
+			errorcnt++;
+			fprintf(stderr, "Can't open %s for writing: %s\n",
+				option.outfile, strerror(errno));
+			goto done;
+		}
+	}
+
+	if (0 != futil_map_file(ifd, mapping, &buf, &buf_len)) {
+		errorcnt++;
+		goto done;
+	}
+
+	errorcnt += futil_traverse(buf, buf_len, &state, type);
+
+	errorcnt += futil_unmap_file(ifd, MAP_RW, buf, buf_len);
+
+done:
+	if (ifd >= 0 && close(ifd)) {
+		errorcnt++;
+		fprintf(stderr, "Error when closing ifd: %s\n",
+			strerror(errno));
+	}
+
+	return errorcnt;
+}
+
+/* One line of a --batch file */
+struct batch_entry_s {
+	char *infile;
+	char *outfile;
+};
+
+static struct batch_entry_s *batch_entry;
+static int batch_count;
+
+/* Runs in its own process, so it may change the options as it likes. */
+static int sign_batch_entry(int index, void *arg)
+{
+	struct batch_entry_s *entry = &batch_entry[index];
+	int errorcnt;
+
+	option.outfile = entry->outfile;
+	errorcnt = sign_one(entry->infile, entry->outfile ? 2 : 1);
+	if (errorcnt)
+		fprintf(stderr, "Failed to sign %s\n", entry->infile);
+	return errorcnt;
+}
+
+/*
+ * Sign every file listed in filename ("-" for stdin), one "INFILE [OUTFILE]"
+ * per line, using option.jobs processes. Blank lines and lines starting with
+ * '#' are ignored. Returns the number of files which couldn't be signed.
+ */
+static int sign_batch(const char *filename)
+{
+	FILE *fp;
+	char *line = NULL;
+	size_t line_size = 0;
+	int lineno = 0;
+	int errorcnt = 0;
+	int i;
+
+	if (!strcmp(filename, "-")) {
+		fp = stdin;
+	} else {
+		fp = fopen(filename, "r");
+		if (!fp) {
+			fprintf(stderr, "Can't open %s: %s\n",
+				filename, strerror(errno));
+			return 1;
+		}
+	}
+
+	while (getline(&line, &line_size, fp) > 0) {
+		char *in, *out, *extra;
+		struct batch_entry_s *tmp;
+
+		lineno++;
+		in = strtok(line, " \t\r\n");
+		if (!in || *in == '#')
+			continue;
+		out = strtok(NULL, " \t\r\n");
+		extra = strtok(NULL, " \t\r\n");
+		if (extra) {
+			fprintf(stderr, "%s:%d: too many file names\n",
+				filename, lineno);
+			errorcnt++;
+			continue;
+		}
+
+		tmp = realloc(batch_entry,
+			      (batch_count + 1) * sizeof(*batch_entry));
+		if (!tmp) {
+			fprintf(stderr, "Couldn't allocate memory\n");
+			errorcnt++;
+			break;
+		}
+		batch_entry = tmp;
+		batch_entry[batch_count].infile = strdup(in);
+		batch_entry[batch_count].outfile = out ? strdup(out) : NULL;
+		batch_count++;
+	}
+	free(line);
+	if (fp != stdin)
+		fclose(fp);
+
+	if (!errorcnt) {
+		int jobs = option.jobs ? option.jobs : futil_num_cpus();
+
+		Debug("%s: %d files, %d jobs\n", __func__, batch_count, jobs);
+		errorcnt = futil_run_jobs(batch_count, jobs,
+					  sign_batch_entry, NULL);
+	}
+
+	for (i = 0; i < batch_count; i++) {
+		free(batch_entry[i].infile);
+		free(batch_entry[i].outfile);
+	}
+	free(batch_entry);
+	batch_entry = NULL;
+	batch_count = 0;
+
+	return errorcnt;
+}
+
+static int do_sign(int argc, char *argv[])
+{
+	char *infile = 0;
+	int i;
+	int errorcnt = 0;
+	char *e = 0;
+	int inout_file_count = 0;
+
 	opterr = 0;		/* quiet, you */
 	while ((i = getopt_long(argc, argv, short_opts, long_opts, 0)) != -1) {
 		switch (i) {
@@ -857,6 +1142,17 @@ static int do_sign(int argc, char *argv[])
 		case OPT_PEM_EXTERNAL:
 			option.pem_external = optarg;
 			break;
+		case OPT_BATCH:
+			option.batchfile = optarg;
+			break;
+		case 'j':
+			option.jobs = strtoul(optarg, &e, 0);
+			if (!*optarg || (e && *e) || option.jobs < 1) {
+				fprintf(stderr,
+					"Invalid --jobs \"%s\"\n", optarg);
+				errorcnt++;
+			}
+			break;
 
 		case '?':
 			if (optopt)
@@ -879,6 +1175,17 @@ static int do_sign(int argc, char *argv[])
 		}
 	}
 
+	if (option.batchfile) {
+		if (infile || option.outfile || argc - optind > 0) {
+			fprintf(stderr, "--batch doesn't take any other"
+				" input or output files\n");
+			errorcnt++;
+		} else {
+			errorcnt += sign_batch(option.batchfile);
+		}
+		goto done;
+	}
+
 	/* If we don't have an input file already, we need one */
 	if (!infile) {
 		if (argc - optind <= 0) {
@@ -897,174 +1204,15 @@ static int do_sign(int argc, char *argv[])
 		option.outfile = argv[optind++];
 	}
 
-	/* What are we looking at? */
-	if (futil_file_type(infile, &type)) {
-		errorcnt++;
-		goto done;
-	}
-
-	/* We may be able to infer the type based on the other args */
-	if (type == FILE_TYPE_UNKNOWN) {
-		if (option.bootloader_data || option.config_data
-		    || option.arch != ARCH_UNSPECIFIED)
-			type = FILE_TYPE_RAW_KERNEL;
-		else if (option.kernel_subkey || option.fv_specified)
-			type = FILE_TYPE_RAW_FIRMWARE;
-	}
-
-	Debug("type=%s\n", futil_file_type_str(type));
-
-	/* Check the arguments for the type of thing we want to sign */
-	switch (type) {
-	case FILE_TYPE_UNKNOWN:
-		fprintf(stderr,
-			"Unable to determine the type of the input file\n");
-		errorcnt++;
-		goto done;
-	case FILE_TYPE_PUBKEY:
-		option.create_new_outfile = 1;
-		if (option.signprivate && option.pem_signpriv) {
-			fprintf(stderr,
-				"Only one of --signprivate and --pem_signpriv"
-				" can be specified\n");
-			errorcnt++;
-		}
-		if ((option.signprivate && option.pem_algo_specified) ||
-		    (option.pem_signpriv && !option.pem_algo_specified)) {
-			fprintf(stderr, "--pem_algo must be used with"
-				" --pem_signpriv\n");
-			errorcnt++;
-		}
-		if (option.pem_external && !option.pem_signpriv) {
-			fprintf(stderr, "--pem_external must be used with"
-				" --pem_signpriv\n");
-			errorcnt++;
-		}
-		/* We'll wait to read the PEM file, since the external signer
-		 * may want to read it instead. */
-		break;
-	case FILE_TYPE_KEYBLOCK:
-		fprintf(stderr, "Resigning a keyblock is kind of pointless.\n");
-		fprintf(stderr, "Just create a new one.\n");
-		errorcnt++;
-		break;
-	case FILE_TYPE_FW_PREAMBLE:
-		fprintf(stderr,
-			"%s IS a signature. Sign the firmware instead\n",
-			infile);
-		break;
-	case FILE_TYPE_GBB:
-		fprintf(stderr, "There's no way to sign a GBB\n");
-		errorcnt++;
-		break;
-	case FILE_TYPE_BIOS_IMAGE:
-	case FILE_TYPE_OLD_BIOS_IMAGE:
-		errorcnt += no_opt_if(!option.signprivate, "signprivate");
-		errorcnt += no_opt_if(!option.keyblock, "keyblock");
-		errorcnt += no_opt_if(!option.kernel_subkey, "kernelkey");
-		break;
-	case FILE_TYPE_KERN_PREAMBLE:
-		errorcnt += no_opt_if(!option.signprivate, "signprivate");
-		if (option.vblockonly || inout_file_count > 1)
-			option.create_new_outfile = 1;
-		break;
-	case FILE_TYPE_RAW_FIRMWARE:
-		option.create_new_outfile = 1;
-		errorcnt += no_opt_if(!option.signprivate, "signprivate");
-		errorcnt += no_opt_if(!option.keyblock, "keyblock");
-		errorcnt += no_opt_if(!option.kernel_subkey, "kernelkey");
-		errorcnt += no_opt_if(!option.version_specified, "version");
-		break;
-	case FILE_TYPE_RAW_KERNEL:
-		option.create_new_outfile = 1;
-		errorcnt += no_opt_if(!option.signprivate, "signprivate");
-		errorcnt += no_opt_if(!option.keyblock, "keyblock");
-		errorcnt += no_opt_if(!option.version_specified, "version");
-		errorcnt += no_opt_if(!option.bootloader_data, "bootloader");
-		errorcnt += no_opt_if(!option.config_data, "config");
-		errorcnt += no_opt_if(option.arch == ARCH_UNSPECIFIED, "arch");
-		break;
-	case FILE_TYPE_CHROMIUMOS_DISK:
-		fprintf(stderr, "Signing a %s is not yet supported\n",
-			futil_file_type_str(type));
-		errorcnt++;
-		break;
-	default:
-		DIE;
-	}
-
-	Debug("infile=%s\n", infile);
-	Debug("inout_file_count=%d\n", inout_file_count);
-	Debug("option.create_new_outfile=%d\n", option.create_new_outfile);
-
-	/* Make sure we have an output file if one is needed */
-	if (!option.outfile) {
-		if (option.create_new_outfile) {
-			errorcnt++;
-			fprintf(stderr, "Missing output filename\n");
-			goto done;
-		} else {
-			option.outfile = infile;
-		}
-	}
-
-	Debug("option.outfile=%s\n", option.outfile);
-
 	if (argc - optind > 0) {
 		errorcnt++;
 		fprintf(stderr, "ERROR: too many arguments left over\n");
-	}
-
-	if (errorcnt)
-		goto done;
-
-	memset(&state, 0, sizeof(state));
-	state.op = FUTIL_OP_SIGN;
-
-	if (option.create_new_outfile) {
-		/* The input is read-only, the output is write-only. */
-		mapping = MAP_RO;
-		state.in_filename = infile;
-		Debug("open RO %s\n", infile);
-		ifd = open(infile, O_RDONLY);
-		if (ifd < 0) {
-			errorcnt++;
-			fprintf(stderr, "Can't open %s for reading: %s\n",
-				infile, strerror(errno));
-			goto done;
-		}
-	} else {
-		/* We'll read-modify-write the output file */
-		mapping = MAP_RW;
-		state.in_filename = option.outfile;
-		if (inout_file_count > 1)
-			futil_copy_file_or_die(infile, option.outfile);
-		Debug("open RW %s\n", option.outfile);
-		ifd = open(option.outfile, O_RDWR);
-		if (ifd < 0) {
-			errorcnt++;
-			fprintf(stderr, "Can't open %s for writing: %s\n",
-				option.outfile, strerror(errno));
-			goto done;
-		}
-	}
-
-	if (0 != futil_map_file(ifd, mapping, &buf, &buf_len)) {
-		errorcnt++;
 		goto done;
 	}
 
-	errorcnt += futil_traverse(buf, buf_len, &state, type);
-
-	errorcnt += futil_unmap_file(ifd, MAP_RW, buf, buf_len);
+	errorcnt += sign_one(infile, inout_file_count);
 
 done:
-	if (ifd >= 0 && close(ifd)) {
-		errorcnt++;
-		fprintf(stderr, "Error when closing ifd: %s\n",
-			strerror(errno));
-	}
-
 	if (option.signprivate)
 		free(option.signprivate);
 	if (option.keyblock)
@@ -112,6 +112,20 @@ int print_hwid_digest(GoogleBinaryBlockHeader *gbb,
 /* Copies a file or dies with an error message */
 void futil_copy_file_or_die(const char *infile, const char *outfile);
 
+/*
+ * Runs func(0, arg) .. func(count - 1, arg), each in a child process of its
+ * own, with up to jobs of them at once. The children get a copy of everything
+ * the caller has already loaded (keys, options), and anything they change is
+ * discarded when they exit. Their stdout and stderr are collected and printed
+ * in index order, so the output looks as if they had run one after another.
+ * Returns the number of calls which returned nonzero or didn't finish.
+ */
+int futil_run_jobs(int count, int jobs,
+		   int (*func)(int index, void *arg), void *arg);
+
+/* Returns the number of CPUs, or 1 if that can't be determined */
+int futil_num_cpus(void);
+
 /* Possible file operation errors */
 enum futil_file_err {
 	FILE_ERR_NONE,
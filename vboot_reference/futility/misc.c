@@ -229,6 +229,153 @@ void futil_copy_file_or_die(const char *infile, const char *outfile)
 	exit(1);
 }
 
+int futil_num_cpus(void)
+{
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return n > 0 ? (int)n : 1;
+}
+
+struct futil_job_s {
+	pid_t pid;
+	FILE *output;
+	int status;
+	int finished;
+};
+
+/* Start job index in a child process. Returns nonzero if it couldn't. */
+static int start_job(struct futil_job_s *job, int index,
+		     int (*func)(int index, void *arg), void *arg)
+{
+	job->output = tmpfile();
+	if (!job->output) {
+		fprintf(stderr, "Couldn't create job output file: %s\n",
+			strerror(errno));
+		return 1;
+	}
+
+	/* Don't let the child flush anything we've buffered, too */
+	fflush(stdout);
+	fflush(stderr);
+
+	job->pid = fork();
+	if (job->pid < 0) {
+		fprintf(stderr, "Couldn't fork job process: %s\n",
+			strerror(errno));
+		fclose(job->output);
+		job->output = NULL;
+		return 1;
+	}
+
+	/* child */
+	if (!job->pid) {
+		int ret;
+
+		if (dup2(fileno(job->output), STDOUT_FILENO) < 0 ||
+		    dup2(fileno(job->output), STDERR_FILENO) < 0)
+			_exit(1);
+		setvbuf(stdout, NULL, _IOLBF, 0);
+		ret = func(index, arg);
+		fflush(NULL);
+		_exit(ret ? 1 : 0);
+	}
+
+	return 0;
+}
+
+/* Print what a finished job wrote, and return nonzero if it failed. */
+static int finish_job(struct futil_job_s *job)
+{
+	char buf[4096];
+	size_t n;
+
+	rewind(job->output);
+	while ((n = fread(buf, 1, sizeof(buf), job->output)) > 0)
+		fwrite(buf, 1, n, stdout);
+	fflush(stdout);
+	fclose(job->output);
+
+	if (WIFEXITED(job->status))
+		return WEXITSTATUS(job->status) != 0;
+
+	if (WIFSIGNALED(job->status))
+		fprintf(stderr, "Job process was killed with signal %d\n",
+			WTERMSIG(job->status));
+	return 1;
+}
+
+int futil_run_jobs(int count, int jobs,
+		   int (*func)(int index, void *arg), void *arg)
+{
+	struct futil_job_s *job;
+	int next = 0, done = 0, running = 0;
+	int errorcnt = 0;
+	int status, i;
+	pid_t pid;
+
+	if (count <= 0)
+		return 0;
+	if (jobs < 1)
+		jobs = 1;
+
+	job = calloc(count, sizeof(*job));
+	if (!job) {
+		fprintf(stderr, "Couldn't allocate memory for %d jobs\n",
+			count);
+		return count;
+	}
+
+	while (done < count) {
+		while (running < jobs && next < count) {
+			Debug("%s: starting job %d\n", __func__, next);
+			if (start_job(&job[next], next, func, arg)) {
+				/* Nothing ran, so there's no output */
+				job[next].finished = -1;
+			} else {
+				running++;
+			}
+			next++;
+		}
+
+		/* Print everything that's finished, in order */
+		while (done < next && job[done].finished) {
+			if (job[done].finished < 0)
+				errorcnt++;
+			else
+				errorcnt += finish_job(&job[done]);
+			done++;
+		}
+		if (done == count || !running)
+			continue;
+
+		pid = wait(&status);
+		if (pid < 0) {
+			fprintf(stderr, "Couldn't wait for job process: %s\n",
+				strerror(errno));
+			break;
+		}
+		for (i = done; i < next; i++) {
+			if (job[i].pid == pid && !job[i].finished) {
+				Debug("%s: job %d finished\n", __func__, i);
+				job[i].status = status;
+				job[i].finished = 1;
+				running--;
+				break;
+			}
+		}
+	}
+
+	/* Only if wait() failed; count whatever is left as failed */
+	for (; done < count; done++) {
+		if (job[done].output)
+			fclose(job[done].output);
+		errorcnt++;
+	}
+
+	free(job);
+	return errorcnt;
+}
+
 
 enum futil_file_err futil_map_file(int fd, int writeable,
 				   uint8_t **buf, uint32_t *len)
@@ -0,0 +1,69 @@
+#!/bin/bash -eux
+# Copyright 2015 The Chromium OS Authors. All rights reserved.
+# Use of this source code is governed by a BSD-style license that can be
+# found in the LICENSE file.
+
+me=${0##*/}
+TMP="$me.tmp"
+
+# Work in scratch directory
+cd "$OUTDIR"
+
+KEYDIR=${SRCDIR}/tests/devkeys
+
+# create some firmware blobs, and a list to sign them all at once
+rm -f ${TMP}.list
+for i in 1 2 3 4 5; do
+  dd bs=1024 count=$((16 * i)) if=/dev/urandom of=${TMP}.fw_main.$i
+  echo "${TMP}.fw_main.$i ${TMP}.vblock.batch.$i" >> ${TMP}.list
+done
+echo "# comments and blank lines are ignored" >> ${TMP}.list
+echo >> ${TMP}.list
+
+# sign them one at a time
+for i in 1 2 3 4 5; do
+  ${FUTILITY} sign \
+    --signprivate ${KEYDIR}/firmware_data_key.vbprivk \
+    --keyblock ${KEYDIR}/firmware.keyblock \
+    --kernelkey ${KEYDIR}/kernel_subkey.vbpubk \
+    --version 12 \
+    --fv ${TMP}.fw_main.$i \
+    ${TMP}.vblock.one.$i
+done
+
+# and all together
+${FUTILITY} sign --debug \
+  --signprivate ${KEYDIR}/firmware_data_key.vbprivk \
+  --keyblock ${KEYDIR}/firmware.keyblock \
+  --kernelkey ${KEYDIR}/kernel_subkey.vbpubk \
+  --version 12 \
+  --jobs 3 \
+  --batch ${TMP}.list
+
+# They should match
+for i in 1 2 3 4 5; do
+  cmp ${TMP}.vblock.one.$i ${TMP}.vblock.batch.$i
+done
+
+# Showing them in parallel should look the same as one after another
+${FUTILITY} show ${TMP}.vblock.batch.* > ${TMP}.show.one
+${FUTILITY} show -j 3 ${TMP}.vblock.batch.* > ${TMP}.show.batch
+cmp ${TMP}.show.one ${TMP}.show.batch
+
+# One bad file fails the batch, but the others are still signed
+rm -f ${TMP}.vblock.batch.*
+echo "${TMP}.no_such_file ${TMP}.vblock.batch.6" >> ${TMP}.list
+if ${FUTILITY} sign \
+  --signprivate ${KEYDIR}/firmware_data_key.vbprivk \
+  --keyblock ${KEYDIR}/firmware.keyblock \
+  --kernelkey ${KEYDIR}/kernel_subkey.vbpubk \
+  --version 12 \
+  --batch - < ${TMP}.list; then false; fi
+for i in 1 2 3 4 5; do
+  cmp ${TMP}.vblock.one.$i ${TMP}.vblock.batch.$i
+done
+[ ! -e ${TMP}.vblock.batch.6 ]
+
+# cleanup
+rm -rf ${TMP}*
+exit 0
@@ -40,6 +40,7 @@ static int retval_vb2_load_fw_keyblock;
 static int retval_vb2_load_fw_preamble;
 static int retval_vb2_digest_finalize;
 static int retval_vb2_verify_digest;
+static int verify_digest_allow_hwcrypto;
 
 /* Type of test to reset for */
 enum reset_type {
@@ -71,6 +72,7 @@ static void reset_common_data(enum reset_type t)
 	retval_vb2_load_fw_preamble = VB2_SUCCESS;
 	retval_vb2_digest_finalize = VB2_SUCCESS;
 	retval_vb2_verify_digest = VB2_SUCCESS;
+	verify_digest_allow_hwcrypto = -1;
 
 	sd->workbuf_preamble_offset = cc.workbuf_used;
 	sd->workbuf_preamble_size = sizeof(*pre);
@@ -207,6 +209,7 @@ int vb2_rsa_verify_digest(const struct vb2_public_key *key,
 			  const uint8_t *digest,
 			  const struct vb2_workbuf *wb)
 {
+	verify_digest_allow_hwcrypto = key->allow_hwcrypto;
 	return retval_vb2_verify_digest;
 }
 
@@ -336,6 +339,9 @@ static void check_hash_tests(void)
 
 	reset_common_data(FOR_CHECK_HASH);
 	TEST_SUCC(vb2api_check_hash(&cc), "check hash good");
+	TEST_EQ(verify_digest_allow_hwcrypto,
+		hwcrypto_state != HWCRYPTO_FORBIDDEN,
+		"  allow hwcrypto unless forbidden");
 
 	reset_common_data(FOR_CHECK_HASH);
 	sd->workbuf_preamble_size = 0;
@@ -17,6 +17,21 @@
 #include "2rsa.h"
 #include "vb2_common.h"
 
+/* Mocked function data */
+
+static int hwcrypto_calls;
+static int retval_hwcrypto;
+
+/* Mocked functions */
+
+int vb2ex_hwcrypto_rsa_verify_digest(const struct vb2_public_key *key,
+				     const uint8_t *sig,
+				     const uint8_t *digest)
+{
+	hwcrypto_calls++;
+	return retval_hwcrypto;
+}
+
 /**
  * Convert an old-style RSA public key struct to a new one.
  *
@@ -35,6 +50,7 @@ void vb2_public_key_to_vb2(struct vb2_public_key *k2,
 	k2->rr = key->rr;
 	k2->sig_alg = vb2_crypto_to_signature(key->algorithm);
 	k2->hash_alg = vb2_crypto_to_hash(key->algorithm);
+	k2->allow_hwcrypto = 0;
 }
 
 /**
@@ -120,6 +136,52 @@ static void test_verify_digest(struct vb2_public_key *key) {
 		VB2_ERROR_RSA_PADDING, "vb2_rsa_verify_digest() bad sig end");
 }
 
+/**
+ * Test use of the hardware crypto engine by vb2_rsa_verify_digest().
+ */
+static void test_verify_digest_hwcrypto(struct vb2_public_key *key) {
+	uint8_t workbuf[VB2_VERIFY_DIGEST_WORKBUF_BYTES]
+		 __attribute__ ((aligned (VB2_WORKBUF_ALIGN)));
+	uint8_t sig[RSA1024NUMBYTES];
+	struct vb2_workbuf wb;
+
+	vb2_workbuf_init(&wb, workbuf, sizeof(workbuf));
+
+	hwcrypto_calls = 0;
+	retval_hwcrypto = VB2_SUCCESS;
+	Memcpy(sig, signatures[0], sizeof(sig));
+	TEST_SUCC(vb2_rsa_verify_digest(key, sig, test_message_sha1_hash, &wb),
+		  "vb2_rsa_verify_digest() hwcrypto not allowed");
+	TEST_EQ(hwcrypto_calls, 0, "  hwcrypto not called");
+
+	key->allow_hwcrypto = 1;
+
+	/* Engine result is used as is, even if the signature is bad */
+	hwcrypto_calls = 0;
+	Memcpy(sig, signatures[1], sizeof(sig));
+	TEST_SUCC(vb2_rsa_verify_digest(key, sig, test_message_sha1_hash, &wb),
+		  "vb2_rsa_verify_digest() hwcrypto");
+	TEST_EQ(hwcrypto_calls, 1, "  hwcrypto called");
+
+	retval_hwcrypto = VB2_ERROR_MOCK;
+	Memcpy(sig, signatures[0], sizeof(sig));
+	TEST_EQ(vb2_rsa_verify_digest(key, sig, test_message_sha1_hash, &wb),
+		VB2_ERROR_MOCK, "vb2_rsa_verify_digest() hwcrypto error");
+
+	/* Unsupported keys fall back to software */
+	retval_hwcrypto = VB2_ERROR_EX_HWCRYPTO_UNSUPPORTED;
+	Memcpy(sig, signatures[0], sizeof(sig));
+	TEST_SUCC(vb2_rsa_verify_digest(key, sig, test_message_sha1_hash, &wb),
+		  "vb2_rsa_verify_digest() hwcrypto unsupported");
+	Memcpy(sig, signatures[0], sizeof(sig));
+	sig[3] ^= 0x42;
+	TEST_EQ(vb2_rsa_verify_digest(key, sig, test_message_sha1_hash, &wb),
+		VB2_ERROR_RSA_PADDING,
+		"vb2_rsa_verify_digest() hwcrypto unsupported bad sig");
+
+	key->allow_hwcrypto = 0;
+}
+
 int main(int argc, char *argv[])
 {
 	int error = 0;
@@ -147,6 +209,7 @@ int main(int argc, char *argv[])
 	/* Run tests */
 	test_signatures(&k2);
 	test_verify_digest(&k2);
+	test_verify_digest_hwcrypto(&k2);
 
 	/* Clean up and exit */
 	RSAPublicKeyFree(key);
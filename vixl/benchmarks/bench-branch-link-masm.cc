@@ -67,6 +67,32 @@ int main(int argc, char* argv[]) {
   }
   __ Bind(&target_4);
 
+  // Branches to distinct labels, bound in the reverse order. This stresses
+  // the search for the branches of a label when it is bound.
+  Label* targets = new Label[iterations];
+  for (int i = 0; i < iterations; i++) {
+    __ Cbnz(x4, &targets[i]);
+  }
+  for (int i = iterations - 1; i >= 0; i--) {
+    __ Bind(&targets[i]);
+  }
+  delete[] targets;
+
+  // Short-range branches to distinct labels, with the odd ones bound first.
+  // Test branches go out of range quickly, so veneer pools are emitted often
+  // while many branches are still unresolved.
+  targets = new Label[iterations];
+  for (int i = 0; i < iterations; i++) {
+    __ Tbnz(x5, 3, &targets[i]);
+  }
+  for (int i = 1; i < iterations; i += 2) {
+    __ Bind(&targets[i]);
+  }
+  for (int i = 0; i < iterations; i += 2) {
+    __ Bind(&targets[i]);
+  }
+  delete[] targets;
+
   masm.FinalizeCode();
 
   return 0;
@@ -4220,6 +4220,10 @@ class Assembler {
 
   size_t BufferCapacity() const { return buffer_->capacity(); }
 
+  // The buffer can be used directly, for example to make mmap-backed code
+  // executable once it has been finalized.
+  CodeBuffer* buffer() const { return buffer_; }
+
   size_t RemainingBufferSpace() const { return buffer_->RemainingBytes(); }
 
   void EnsureSpaceFor(size_t amount) {
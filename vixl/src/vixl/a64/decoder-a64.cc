@@ -108,6 +108,45 @@ void Decoder::DecodeInstruction(const Instruction *instr) {
   }
 }
 
+void Decoder::DecodeAndCache(const Instruction* instr) {
+  if (decode_cache_ == NULL) {
+    decode_cache_ = new DecodeCacheEntry[kDecodeCacheSize];
+    FlushDecodeCache();
+  }
+  // Read the encoding before running the visitors, in case one of them
+  // rewrites the instruction.
+  Instr encoding = instr->InstructionBits();
+  resolved_visitor_ = NULL;
+  Decode(instr);
+  if (resolved_visitor_ != NULL) {
+    DecodeCacheEntry* entry = &decode_cache_[DecodeCacheIndex(instr)];
+    entry->address = instr;
+    entry->encoding = encoding;
+    entry->visitor = resolved_visitor_;
+  }
+}
+
+
+Decoder::VisitorFunction Decoder::ResolveVisitor(const Instruction* instr) {
+  resolve_only_ = true;
+  resolved_visitor_ = NULL;
+  DecodeInstruction(instr);
+  resolve_only_ = false;
+  VIXL_ASSERT(resolved_visitor_ != NULL);
+  return resolved_visitor_;
+}
+
+
+void Decoder::FlushDecodeCache() {
+  if (decode_cache_ == NULL) return;
+  for (int i = 0; i < kDecodeCacheSize; i++) {
+    decode_cache_[i].address = NULL;
+    decode_cache_[i].encoding = 0;
+    decode_cache_[i].visitor = NULL;
+  }
+}
+
+
 void Decoder::AppendVisitor(DecoderVisitor* new_visitor) {
   visitors_.push_back(new_visitor);
 }
@@ -867,6 +906,8 @@ void Decoder::DecodeNEONScalarDataProcessing(const Instruction* instr) {
 #define DEFINE_VISITOR_CALLERS(A)                                              \
   void Decoder::Visit##A(const Instruction *instr) {                           \
     VIXL_ASSERT(instr->Mask(A##FMask) == A##Fixed);                            \
+    resolved_visitor_ = &DecoderVisitor::Visit##A;                             \
+    if (resolve_only_) return;                                                 \
     std::list<DecoderVisitor*>::iterator it;                                   \
     for (it = visitors_.begin(); it != visitors_.end(); it++) {                \
       (*it)->Visit##A(instr);                                                  \
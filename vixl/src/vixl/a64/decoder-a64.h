@@ -145,7 +145,9 @@ class DecoderVisitor {
 
 class Decoder {
  public:
-  Decoder() {}
+  Decoder()
+      : decode_cache_(NULL), resolved_visitor_(NULL), resolve_only_(false) {}
+  ~Decoder() { delete[] decode_cache_; }
 
   // Top-level wrappers around the actual decoding function.
   void Decode(const Instruction* instr) {
@@ -159,6 +161,46 @@ class Decoder {
     DecodeInstruction(const_cast<const Instruction*>(instr));
   }
 
+  // Equivalent to Decode(const Instruction*), but remembers which leaf of the
+  // decode tree `instr` resolved to, so that executing the same instruction
+  // again skips the tree walk. Entries are keyed by address and check the
+  // instruction encoding on lookup, so rewriting code in place is picked up
+  // without any explicit invalidation. The registered visitors are looked up
+  // on every call, so they can still be changed freely.
+  void DecodeCached(const Instruction* instr) {
+    if (decode_cache_ != NULL) {
+      DecodeCacheEntry* entry = &decode_cache_[DecodeCacheIndex(instr)];
+      if ((entry->address == instr) &&
+          (entry->encoding == instr->InstructionBits())) {
+        CallVisitors(entry->visitor, instr);
+        return;
+      }
+    }
+    DecodeAndCache(instr);
+  }
+
+  // A pointer to one of the DecoderVisitor::Visit* methods, identifying the
+  // leaf of the decode tree an instruction belongs to.
+  typedef void (DecoderVisitor::*VisitorFunction)(const Instruction* instr);
+
+  // Walk the decode tree for `instr` and return the visitor method it resolves
+  // to, without calling any of the registered visitors.
+  VisitorFunction ResolveVisitor(const Instruction* instr);
+
+  // Call `visitor` on every registered visitor, in order. This is what
+  // Decode() does once it has reached a leaf of the decode tree.
+  void CallVisitors(VisitorFunction visitor, const Instruction* instr) {
+    std::list<DecoderVisitor*>::iterator it;
+    for (it = visitors_.begin(); it != visitors_.end(); it++) {
+      ((*it)->*visitor)(instr);
+    }
+  }
+
+  // Drop every entry of the decoded-instruction cache. This is never needed
+  // for correctness, but releases stale entries after a code buffer has been
+  // freed or reused for unrelated code.
+  void FlushDecodeCache();
+
   // Register a new visitor class with the decoder.
   // Decode() will call the corresponding visitor method from all registered
   // visitor classes when decoding reaches the leaf node of the instruction
@@ -206,6 +248,25 @@ class Decoder {
   std::list<DecoderVisitor*>* visitors() { return &visitors_; }
 
  private:
+  struct DecodeCacheEntry {
+    const Instruction* address;
+    Instr encoding;
+    VisitorFunction visitor;
+  };
+
+  // Number of entries in the direct-mapped decoded-instruction cache. This
+  // must be a power of two.
+  static const int kDecodeCacheSize = 4096;
+
+  static int DecodeCacheIndex(const Instruction* instr) {
+    uintptr_t word = reinterpret_cast<uintptr_t>(instr) >> kInstructionSizeLog2;
+    return static_cast<int>(word & (kDecodeCacheSize - 1));
+  }
+
+  // Decode `instr` through the decode tree and record the visitor it resolved
+  // to in the decoded-instruction cache.
+  void DecodeAndCache(const Instruction* instr);
+
   // Decodes an instruction and calls the visitor functions registered with the
   // Decoder class.
   void DecodeInstruction(const Instruction* instr);
@@ -268,6 +329,14 @@ class Decoder {
  private:
   // Visitors are registered in a list.
   std::list<DecoderVisitor*> visitors_;
+
+  // Allocated on the first call to DecodeCached(), so that decoders which are
+  // only used for disassembly do not pay for it.
+  DecodeCacheEntry* decode_cache_;
+  // The leaf visitor reached by the last walk of the decode tree.
+  VisitorFunction resolved_visitor_;
+  // When set, walking the decode tree only records resolved_visitor_.
+  bool resolve_only_;
 };
 
 }  // namespace vixl
@@ -24,6 +24,7 @@
 // OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <pthread.h>
 #include <cstdlib>
 #include "vixl/a64/disasm-a64.h"
 
@@ -3484,4 +3485,127 @@ void PrintDisassembler::ProcessOutput(const Instruction* instr) {
           GetOutput());
 }
 
+
+BatchDisassembler::BatchDisassembler(char* arena, size_t arena_size)
+    : arena_(arena), arena_size_(arena_size), arena_pos_(0) {
+  decoder_.AppendVisitor(this);
+}
+
+
+const Instruction* BatchDisassembler::DisassembleRange(
+    const Instruction* start, const Instruction* end) {
+  const Instruction* instr = start;
+  while (instr < end) {
+    if ((arena_size_ - arena_pos_) < kMaxLineLength) break;
+    decoder_.Decode(instr);
+    instr = instr->NextInstruction();
+  }
+  return instr;
+}
+
+
+static char* AppendHex(char* out, uint64_t value, int digits) {
+  static const char kHexDigits[] = "0123456789abcdef";
+  for (int i = digits - 1; i >= 0; i--) {
+    out[i] = kHexDigits[value & 0xf];
+    value >>= 4;
+  }
+  return out + digits;
+}
+
+
+void BatchDisassembler::ProcessOutput(const Instruction* instr) {
+  // Equivalent to PrintDisassembler's format, without going through printf.
+  char* out = arena_ + arena_pos_;
+  *out++ = '0';
+  *out++ = 'x';
+  out = AppendHex(out, reinterpret_cast<uint64_t>(instr), 16);
+  *out++ = ' ';
+  *out++ = ' ';
+  out = AppendHex(out, instr->InstructionBits(), 8);
+  *out++ = '\t';
+  *out++ = '\t';
+  memcpy(out, buffer_, buffer_pos_);
+  out += buffer_pos_;
+  *out++ = '\n';
+  arena_pos_ = out - arena_;
+  VIXL_ASSERT(arena_pos_ <= arena_size_);
+}
+
+
+namespace {
+struct DisassemblySlice {
+  const Instruction* start;
+  const Instruction* end;
+  char* arena;
+  size_t arena_size;
+  int64_t code_address_offset;
+  size_t used;
+};
+}  // namespace
+
+
+void* BatchDisassembler::DisassembleSlice(void* slice) {
+  DisassemblySlice* s = reinterpret_cast<DisassemblySlice*>(slice);
+  BatchDisassembler disasm(s->arena, s->arena_size);
+  disasm.set_code_address_offset(s->code_address_offset);
+  const Instruction* done = disasm.DisassembleRange(s->start, s->end);
+  VIXL_CHECK(done == s->end);
+  USE(done);
+  s->used = disasm.arena_used();
+  return NULL;
+}
+
+
+void BatchDisassembler::DisassembleRangeInParallel(const Instruction* start,
+                                                   const Instruction* end,
+                                                   int n_threads) {
+  VIXL_ASSERT(n_threads >= 1);
+  size_t count = (end - start) / kInstructionSize;
+  VIXL_CHECK((arena_size_ - arena_pos_) >= count * kMaxLineLength);
+  // Each thread needs enough work to be worth starting.
+  static const size_t kMinInstructionsPerThread = 4 * KBytes;
+  size_t max_threads = count / kMinInstructionsPerThread;
+  if (static_cast<size_t>(n_threads) > max_threads) {
+    n_threads = static_cast<int>(std::max<size_t>(max_threads, 1));
+  }
+  if (n_threads == 1) {
+    DisassembleRange(start, end);
+    return;
+  }
+
+  // Give each thread its own region of the arena, sized for the worst case,
+  // then close the gaps between them.
+  DisassemblySlice* slices = new DisassemblySlice[n_threads];
+  pthread_t* threads = new pthread_t[n_threads];
+  size_t per_thread = (count + n_threads - 1) / n_threads;
+  for (int i = 0; i < n_threads; i++) {
+    size_t first = std::min(count, i * per_thread);
+    size_t last = std::min(count, first + per_thread);
+    slices[i].start = start->InstructionAtOffset(first * kInstructionSize);
+    slices[i].end = start->InstructionAtOffset(last * kInstructionSize);
+    slices[i].arena = arena_ + arena_pos_ + (first * kMaxLineLength);
+    slices[i].arena_size = (last - first) * kMaxLineLength;
+    slices[i].code_address_offset = code_address_offset_;
+    slices[i].used = 0;
+  }
+  // The first slice runs on this thread.
+  for (int i = 1; i < n_threads; i++) {
+    int err = pthread_create(&threads[i], NULL, DisassembleSlice, &slices[i]);
+    VIXL_CHECK(err == 0);
+    USE(err);
+  }
+  DisassembleSlice(&slices[0]);
+  for (int i = 1; i < n_threads; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  for (int i = 0; i < n_threads; i++) {
+    memmove(arena_ + arena_pos_, slices[i].arena, slices[i].used);
+    arena_pos_ += slices[i].used;
+  }
+  delete[] threads;
+  delete[] slices;
+}
+
 }  // namespace vixl
@@ -172,6 +172,56 @@ class PrintDisassembler: public Disassembler {
  private:
   FILE *stream_;
 };
+
+
+// Disassembles whole ranges of code into a caller-provided text arena, one
+// line per instruction in the same format as PrintDisassembler. Nothing is
+// allocated or printed per instruction.
+//
+// The text for an instruction only depends on its address and encoding, so
+// disjoint sub-ranges can be disassembled by independent BatchDisassemblers
+// and the results concatenated in address order. A BatchDisassembler must
+// only be used by one thread at a time.
+class BatchDisassembler: public Disassembler {
+ public:
+  BatchDisassembler(char* arena, size_t arena_size);
+
+  // The longest line produced for a single instruction, including the
+  // trailing newline.
+  static const size_t kMaxLineLength = 2 + 16 + 2 + 8 + 2 + 256 + 1;
+
+  // Disassemble the instructions in [start, end), appending to the arena.
+  // Stops early if the arena cannot hold another line. Returns the first
+  // instruction that was not disassembled, which is `end` on success.
+  const Instruction* DisassembleRange(const Instruction* start,
+                                      const Instruction* end);
+
+  // Disassemble [start, end) into the arena using up to `n_threads` threads,
+  // each with its own BatchDisassembler working on a contiguous slice. The
+  // output is identical to a single DisassembleRange() call over the range.
+  // The arena must have room for kMaxLineLength bytes per instruction.
+  // Workers use the code address offset of this disassembler but none of the
+  // overrides of a sub-class.
+  void DisassembleRangeInParallel(const Instruction* start,
+                                  const Instruction* end,
+                                  int n_threads);
+
+  // The text written so far. It is not null-terminated.
+  const char* arena() const { return arena_; }
+  size_t arena_used() const { return arena_pos_; }
+  void ResetArena() { arena_pos_ = 0; }
+
+ protected:
+  virtual void ProcessOutput(const Instruction* instr);
+
+ private:
+  static void* DisassembleSlice(void* slice);
+
+  Decoder decoder_;
+  char* arena_;
+  size_t arena_size_;
+  size_t arena_pos_;
+};
 }  // namespace vixl
 
 #endif  // VIXL_A64_DISASM_A64_H
@@ -24,6 +24,8 @@
 // OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <algorithm>
+
 #include "vixl/a64/instrument-a64.h"
 
 namespace vixl {
@@ -57,6 +59,11 @@ void Counter::Increment() {
 }
 
 
+uint64_t Counter::PeekCount() {
+  return count_;
+}
+
+
 uint64_t Counter::count() {
   uint64_t result = count_;
   if (type_ == Gauge) {
@@ -117,7 +124,14 @@ static const CounterDescriptor kCounterList[] = {
 
 
 Instrument::Instrument(const char* datafile, uint64_t sample_period)
-    : output_stream_(stdout), sample_period_(sample_period) {
+    : output_stream_(stdout),
+      sample_period_(sample_period),
+      pc_sample_period_(0),
+      pc_sample_count_(0),
+      block_profile_enabled_(false),
+      block_ended_(true),
+      next_instruction_(NULL),
+      current_block_(NULL) {
 
   // Set up the output stream. If datafile is non-NULL, use that file. If it
   // can't be opened, or datafile is NULL, use stdout.
@@ -151,7 +165,7 @@ Instrument::~Instrument() {
   DumpCounters();
 
   // Free all the counter objects.
-  std::list<Counter*>::iterator it;
+  std::vector<Counter*>::iterator it;
   for (it = counters_.begin(); it != counters_.end(); it++) {
     delete *it;
   }
@@ -162,13 +176,33 @@ Instrument::~Instrument() {
 }
 
 
-void Instrument::Update() {
+void Instrument::Update(const Instruction* instr) {
   // Increment the instruction counter, and dump all counters if a sample period
   // has elapsed.
-  static Counter* counter = GetCounter("Instruction");
+  static const size_t index = GetCounterIndex("Instruction");
+  Counter* counter = counters_[index];
   VIXL_ASSERT(counter->type() == Cumulative);
   counter->Increment();
 
+  if (pc_sample_period_ != 0) {
+    if (++pc_sample_count_ >= pc_sample_period_) {
+      pc_sample_count_ = 0;
+      pc_histogram_[reinterpret_cast<uintptr_t>(instr)]++;
+    }
+  }
+
+  if (block_profile_enabled_) {
+    // A new block starts after a branch, and wherever execution does not
+    // simply fall through from the previous instruction.
+    if (block_ended_ || (instr != next_instruction_)) {
+      current_block_ = &block_profile_[reinterpret_cast<uintptr_t>(instr)];
+      current_block_->executions++;
+      block_ended_ = false;
+    }
+    current_block_->instructions++;
+    next_instruction_ = instr->NextInstruction();
+  }
+
   if ((sample_period_ != 0) && counter->IsEnabled()
       && (counter->count() % sample_period_) == 0) {
     DumpCounters();
@@ -179,7 +213,7 @@ void Instrument::Update() {
 void Instrument::DumpCounters() {
   // Iterate through the counter objects, dumping their values to the output
   // stream.
-  std::list<Counter*>::const_iterator it;
+  std::vector<Counter*>::const_iterator it;
   for (it = counters_.begin(); it != counters_.end(); it++) {
     fprintf(output_stream_, "%" PRIu64 ",", (*it)->count());
   }
@@ -191,7 +225,7 @@ void Instrument::DumpCounters() {
 void Instrument::DumpCounterNames() {
   // Iterate through the counter objects, dumping the counter names to the
   // output stream.
-  std::list<Counter*>::const_iterator it;
+  std::vector<Counter*>::const_iterator it;
   for (it = counters_.begin(); it != counters_.end(); it++) {
     fprintf(output_stream_, "%s,", (*it)->name());
   }
@@ -212,19 +246,19 @@ void Instrument::HandleInstrumentationEvent(unsigned event) {
 void Instrument::DumpEventMarker(unsigned marker) {
   // Dumpan event marker to the output stream as a specially formatted comment
   // line.
-  static Counter* counter = GetCounter("Instruction");
+  static const size_t index = GetCounterIndex("Instruction");
+  Counter* counter = counters_[index];
 
   fprintf(output_stream_, "# %c%c @ %" PRId64 "\n", marker & 0xff,
           (marker >> 8) & 0xff, counter->count());
 }
 
 
-Counter* Instrument::GetCounter(const char* name) {
-  // Get a Counter object by name from the counter list.
-  std::list<Counter*>::const_iterator it;
-  for (it = counters_.begin(); it != counters_.end(); it++) {
-    if (strcmp((*it)->name(), name) == 0) {
-      return *it;
+size_t Instrument::GetCounterIndex(const char* name) {
+  // Get the index of a Counter object by name in the counter list.
+  for (size_t i = 0; i < counters_.size(); i++) {
+    if (strcmp(counters_[i]->name(), name) == 0) {
+      return i;
     }
   }
 
@@ -238,8 +272,13 @@ Counter* Instrument::GetCounter(const char* name) {
 }
 
 
+uint64_t Instrument::GetCounterValue(const char* name) {
+  return counters_[GetCounterIndex(name)]->PeekCount();
+}
+
+
 void Instrument::Enable() {
-  std::list<Counter*>::iterator it;
+  std::vector<Counter*>::iterator it;
   for (it = counters_.begin(); it != counters_.end(); it++) {
     (*it)->Enable();
   }
@@ -247,40 +286,137 @@ void Instrument::Enable() {
 
 
 void Instrument::Disable() {
-  std::list<Counter*>::iterator it;
+  std::vector<Counter*>::iterator it;
   for (it = counters_.begin(); it != counters_.end(); it++) {
     (*it)->Disable();
   }
 }
 
 
+void Instrument::EnablePCHistogram(uint64_t sample_period) {
+  VIXL_ASSERT(sample_period != 0);
+  pc_sample_period_ = sample_period;
+  pc_sample_count_ = 0;
+}
+
+
+void Instrument::DisablePCHistogram() {
+  pc_sample_period_ = 0;
+}
+
+
+void Instrument::EnableBlockProfile() {
+  block_profile_enabled_ = true;
+  block_ended_ = true;
+}
+
+
+void Instrument::DisableBlockProfile() {
+  block_profile_enabled_ = false;
+}
+
+
+void Instrument::ResetProfile() {
+  pc_histogram_.clear();
+  block_profile_.clear();
+  pc_sample_count_ = 0;
+  block_ended_ = true;
+  current_block_ = NULL;
+}
+
+
+// Sort profile entries so that the hottest come first, breaking ties by
+// address so that reports are stable.
+static bool HotterPC(const std::pair<uintptr_t, uint64_t>& a,
+                     const std::pair<uintptr_t, uint64_t>& b) {
+  if (a.second != b.second) return a.second > b.second;
+  return a.first < b.first;
+}
+
+
+static bool HotterBlock(const std::pair<uintptr_t, BlockProfile>& a,
+                        const std::pair<uintptr_t, BlockProfile>& b) {
+  if (a.second.instructions != b.second.instructions) {
+    return a.second.instructions > b.second.instructions;
+  }
+  return a.first < b.first;
+}
+
+
+void Instrument::DumpPCHistogram(FILE* stream, size_t max_entries) {
+  if (stream == NULL) stream = output_stream_;
+
+  std::vector<std::pair<uintptr_t, uint64_t> > entries(pc_histogram_.begin(),
+                                                       pc_histogram_.end());
+  std::sort(entries.begin(), entries.end(), HotterPC);
+  uint64_t total = 0;
+  for (size_t i = 0; i < entries.size(); i++) {
+    total += entries[i].second;
+  }
+
+  fprintf(stream, "# pc_histogram samples=%" PRIu64 " period=%" PRIu64 "\n",
+          total, pc_sample_period_);
+  for (size_t i = 0; (i < entries.size()) && (i < max_entries); i++) {
+    fprintf(stream, "0x%016" PRIxPTR ",%" PRIu64 ",%.2f%%\n",
+            entries[i].first, entries[i].second,
+            (100.0 * entries[i].second) / total);
+  }
+  fflush(stream);
+}
+
+
+void Instrument::DumpHotBlocks(FILE* stream, size_t max_entries) {
+  if (stream == NULL) stream = output_stream_;
+
+  std::vector<std::pair<uintptr_t, BlockProfile> > entries(
+      block_profile_.begin(), block_profile_.end());
+  std::sort(entries.begin(), entries.end(), HotterBlock);
+  uint64_t total = 0;
+  for (size_t i = 0; i < entries.size(); i++) {
+    total += entries[i].second.instructions;
+  }
+
+  fprintf(stream, "# hot_blocks blocks=%" PRIuPTR " instructions=%" PRIu64
+          "\n", entries.size(), total);
+  fprintf(stream, "# start,executions,instructions,share\n");
+  for (size_t i = 0; (i < entries.size()) && (i < max_entries); i++) {
+    const BlockProfile& block = entries[i].second;
+    fprintf(stream, "0x%016" PRIxPTR ",%" PRIu64 ",%" PRIu64 ",%.2f%%\n",
+            entries[i].first, block.executions, block.instructions,
+            (100.0 * block.instructions) / total);
+  }
+  fflush(stream);
+}
+
+
 void Instrument::VisitPCRelAddressing(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("PC Addressing");
+  Update(instr);
+  static const size_t index = GetCounterIndex("PC Addressing");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitAddSubImmediate(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Add/Sub DP");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Add/Sub DP");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitLogicalImmediate(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Logical DP");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Logical DP");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitMoveWideImmediate(const Instruction* instr) {
-  Update();
-  static Counter* counter = GetCounter("Move Immediate");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Move Immediate");
+  Counter* counter = counters_[index];
 
   if (instr->IsMovn() && (instr->Rd() == kZeroRegCode)) {
     unsigned imm = instr->ImmMoveWide();
@@ -292,80 +428,87 @@ void Instrument::VisitMoveWideImmediate(const Instruction* instr) {
 
 
 void Instrument::VisitBitfield(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Other Int DP");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Other Int DP");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitExtract(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Other Int DP");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Other Int DP");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitUnconditionalBranch(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Unconditional Branch");
+  Update(instr);
+  block_ended_ = true;
+  static const size_t index = GetCounterIndex("Unconditional Branch");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitUnconditionalBranchToRegister(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Unconditional Branch");
+  Update(instr);
+  block_ended_ = true;
+  static const size_t index = GetCounterIndex("Unconditional Branch");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitCompareBranch(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Compare and Branch");
+  Update(instr);
+  block_ended_ = true;
+  static const size_t index = GetCounterIndex("Compare and Branch");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitTestBranch(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Test and Branch");
+  Update(instr);
+  block_ended_ = true;
+  static const size_t index = GetCounterIndex("Test and Branch");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitConditionalBranch(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Conditional Branch");
+  Update(instr);
+  block_ended_ = true;
+  static const size_t index = GetCounterIndex("Conditional Branch");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitSystem(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Other");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Other");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitException(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Other");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Other");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::InstrumentLoadStorePair(const Instruction* instr) {
-  static Counter* load_pair_counter = GetCounter("Load Pair");
-  static Counter* store_pair_counter = GetCounter("Store Pair");
+  static const size_t load_pair_index = GetCounterIndex("Load Pair");
+  Counter* load_pair_counter = counters_[load_pair_index];
+  static const size_t store_pair_index = GetCounterIndex("Store Pair");
+  Counter* store_pair_counter = counters_[store_pair_index];
 
   if (instr->Mask(LoadStorePairLBit) != 0) {
     load_pair_counter->Increment();
@@ -376,50 +519,54 @@ void Instrument::InstrumentLoadStorePair(const Instruction* instr) {
 
 
 void Instrument::VisitLoadStorePairPostIndex(const Instruction* instr) {
-  Update();
+  Update(instr);
   InstrumentLoadStorePair(instr);
 }
 
 
 void Instrument::VisitLoadStorePairOffset(const Instruction* instr) {
-  Update();
+  Update(instr);
   InstrumentLoadStorePair(instr);
 }
 
 
 void Instrument::VisitLoadStorePairPreIndex(const Instruction* instr) {
-  Update();
+  Update(instr);
   InstrumentLoadStorePair(instr);
 }
 
 
 void Instrument::VisitLoadStorePairNonTemporal(const Instruction* instr) {
-  Update();
+  Update(instr);
   InstrumentLoadStorePair(instr);
 }
 
 
 void Instrument::VisitLoadStoreExclusive(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Other");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Other");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitLoadLiteral(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Load Literal");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Load Literal");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::InstrumentLoadStore(const Instruction* instr) {
-  static Counter* load_int_counter = GetCounter("Load Integer");
-  static Counter* store_int_counter = GetCounter("Store Integer");
-  static Counter* load_fp_counter = GetCounter("Load FP");
-  static Counter* store_fp_counter = GetCounter("Store FP");
+  static const size_t load_int_index = GetCounterIndex("Load Integer");
+  Counter* load_int_counter = counters_[load_int_index];
+  static const size_t store_int_index = GetCounterIndex("Store Integer");
+  Counter* store_int_counter = counters_[store_int_index];
+  static const size_t load_fp_index = GetCounterIndex("Load FP");
+  Counter* load_fp_counter = counters_[load_fp_index];
+  static const size_t store_fp_index = GetCounterIndex("Store FP");
+  Counter* store_fp_counter = counters_[store_fp_index];
 
   switch (instr->Mask(LoadStoreMask)) {
     case STRB_w:
@@ -448,402 +595,401 @@ void Instrument::InstrumentLoadStore(const Instruction* instr) {
 
 
 void Instrument::VisitLoadStoreUnscaledOffset(const Instruction* instr) {
-  Update();
+  Update(instr);
   InstrumentLoadStore(instr);
 }
 
 
 void Instrument::VisitLoadStorePostIndex(const Instruction* instr) {
-  USE(instr);
-  Update();
+  Update(instr);
   InstrumentLoadStore(instr);
 }
 
 
 void Instrument::VisitLoadStorePreIndex(const Instruction* instr) {
-  Update();
+  Update(instr);
   InstrumentLoadStore(instr);
 }
 
 
 void Instrument::VisitLoadStoreRegisterOffset(const Instruction* instr) {
-  Update();
+  Update(instr);
   InstrumentLoadStore(instr);
 }
 
 
 void Instrument::VisitLoadStoreUnsignedOffset(const Instruction* instr) {
-  Update();
+  Update(instr);
   InstrumentLoadStore(instr);
 }
 
 
 void Instrument::VisitLogicalShifted(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Logical DP");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Logical DP");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitAddSubShifted(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Add/Sub DP");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Add/Sub DP");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitAddSubExtended(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Add/Sub DP");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Add/Sub DP");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitAddSubWithCarry(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Add/Sub DP");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Add/Sub DP");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitConditionalCompareRegister(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Conditional Compare");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Conditional Compare");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitConditionalCompareImmediate(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Conditional Compare");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Conditional Compare");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitConditionalSelect(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Conditional Select");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Conditional Select");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitDataProcessing1Source(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Other Int DP");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Other Int DP");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitDataProcessing2Source(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Other Int DP");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Other Int DP");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitDataProcessing3Source(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Other Int DP");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Other Int DP");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitFPCompare(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("FP DP");
+  Update(instr);
+  static const size_t index = GetCounterIndex("FP DP");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitFPConditionalCompare(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Conditional Compare");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Conditional Compare");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitFPConditionalSelect(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Conditional Select");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Conditional Select");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitFPImmediate(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("FP DP");
+  Update(instr);
+  static const size_t index = GetCounterIndex("FP DP");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitFPDataProcessing1Source(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("FP DP");
+  Update(instr);
+  static const size_t index = GetCounterIndex("FP DP");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitFPDataProcessing2Source(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("FP DP");
+  Update(instr);
+  static const size_t index = GetCounterIndex("FP DP");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitFPDataProcessing3Source(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("FP DP");
+  Update(instr);
+  static const size_t index = GetCounterIndex("FP DP");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitFPIntegerConvert(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("FP DP");
+  Update(instr);
+  static const size_t index = GetCounterIndex("FP DP");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitFPFixedPointConvert(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("FP DP");
+  Update(instr);
+  static const size_t index = GetCounterIndex("FP DP");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitCrypto2RegSHA(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Crypto");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Crypto");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitCrypto3RegSHA(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Crypto");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Crypto");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitCryptoAES(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Crypto");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Crypto");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEON2RegMisc(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEON3Same(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEON3Different(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEONAcrossLanes(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEONByIndexedElement(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEONCopy(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEONExtract(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEONLoadStoreMultiStruct(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEONLoadStoreMultiStructPostIndex(
     const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEONLoadStoreSingleStruct(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEONLoadStoreSingleStructPostIndex(
     const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEONModifiedImmediate(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEONScalar2RegMisc(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEONScalar3Diff(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEONScalar3Same(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEONScalarByIndexedElement(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEONScalarCopy(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEONScalarPairwise(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEONScalarShiftImmediate(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEONShiftImmediate(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEONTable(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitNEONPerm(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("NEON");
+  Update(instr);
+  static const size_t index = GetCounterIndex("NEON");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitUnallocated(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Other");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Other");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
 
 void Instrument::VisitUnimplemented(const Instruction* instr) {
-  USE(instr);
-  Update();
-  static Counter* counter = GetCounter("Other");
+  Update(instr);
+  static const size_t index = GetCounterIndex("Other");
+  Counter* counter = counters_[index];
   counter->Increment();
 }
 
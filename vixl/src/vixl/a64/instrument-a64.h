@@ -27,6 +27,9 @@
 #ifndef VIXL_A64_INSTRUMENT_A64_H_
 #define VIXL_A64_INSTRUMENT_A64_H_
 
+#include <map>
+#include <vector>
+
 #include "vixl/globals.h"
 #include "vixl/utils.h"
 #include "vixl/a64/decoder-a64.h"
@@ -60,6 +63,8 @@ class Counter {
   void Disable();
   bool IsEnabled();
   uint64_t count();
+  // Read the count without resetting it, even for Gauge counters.
+  uint64_t PeekCount();
   const char* name();
   CounterType type();
 
@@ -71,6 +76,17 @@ class Counter {
 };
 
 
+// Profile of a basic block seen by the instrumentation.
+struct BlockProfile {
+  BlockProfile() : executions(0), instructions(0) {}
+
+  // Number of times the block was entered.
+  uint64_t executions;
+  // Number of instructions executed in the block, over all executions.
+  uint64_t instructions;
+};
+
+
 class Instrument: public DecoderVisitor {
  public:
   explicit Instrument(const char* datafile = NULL,
@@ -80,23 +96,53 @@ class Instrument: public DecoderVisitor {
   void Enable();
   void Disable();
 
+  // Read a counter, for example "Instruction" or "Load Pair", without writing
+  // it to the output or resetting it.
+  uint64_t GetCounterValue(const char* name);
+  const std::vector<Counter*>& counters() const { return counters_; }
+
+  // Count how often each instruction address is executed, recording one
+  // instruction in every sample_period to keep long runs cheap.
+  void EnablePCHistogram(uint64_t sample_period = 1);
+  void DisablePCHistogram();
+
+  // Count how often each basic block is entered and how many instructions run
+  // in it. A block starts at a branch target or after a branch, and runs
+  // until the next branch; entering the middle of a block starts a new one.
+  void EnableBlockProfile();
+  void DisableBlockProfile();
+
+  // The profiles collected so far, keyed by instruction address.
+  const std::map<uintptr_t, uint64_t>& pc_histogram() const {
+    return pc_histogram_;
+  }
+  const std::map<uintptr_t, BlockProfile>& block_profile() const {
+    return block_profile_;
+  }
+  void ResetProfile();
+
+  // Write the hottest addresses or blocks to stream, or to the
+  // instrumentation output file if stream is NULL.
+  void DumpPCHistogram(FILE* stream = NULL, size_t max_entries = 20);
+  void DumpHotBlocks(FILE* stream = NULL, size_t max_entries = 20);
+
   // Declare all Visitor functions.
   #define DECLARE(A) void Visit##A(const Instruction* instr);
   VISITOR_LIST(DECLARE)
   #undef DECLARE
 
  private:
-  void Update();
+  void Update(const Instruction* instr);
   void DumpCounters();
   void DumpCounterNames();
   void DumpEventMarker(unsigned marker);
   void HandleInstrumentationEvent(unsigned event);
-  Counter* GetCounter(const char* name);
+  size_t GetCounterIndex(const char* name);
 
   void InstrumentLoadStore(const Instruction* instr);
   void InstrumentLoadStorePair(const Instruction* instr);
 
-  std::list<Counter*> counters_;
+  std::vector<Counter*> counters_;
 
   FILE *output_stream_;
 
@@ -104,6 +150,19 @@ class Instrument: public DecoderVisitor {
   // For a sample_period_ = 0 a final counter value is only produced when the
   // Instrumentation class is destroyed.
   uint64_t sample_period_;
+
+  // PC histogram. It is disabled when pc_sample_period_ is 0.
+  std::map<uintptr_t, uint64_t> pc_histogram_;
+  uint64_t pc_sample_period_;
+  uint64_t pc_sample_count_;
+
+  // Basic block profile.
+  std::map<uintptr_t, BlockProfile> block_profile_;
+  bool block_profile_enabled_;
+  // True if the last instruction seen was a branch.
+  bool block_ended_;
+  const Instruction* next_instruction_;
+  BlockProfile* current_block_;
 };
 
 }  // namespace vixl
@@ -29,8 +29,151 @@
 #include <cmath>
 #include "vixl/a64/simulator-a64.h"
 
+// Some integer vector operations have a faster implementation using the
+// host's own SIMD instructions. The portable lane-by-lane implementations
+// remain the reference; define VIXL_NO_HOST_SIMD to always use them.
+#if defined(__SSE2__) && !defined(VIXL_NO_HOST_SIMD)
+#define VIXL_HOST_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace vixl {
 
+#ifdef VIXL_HOST_SIMD_SSE2
+// The host paths only handle formats that fill a whole D or Q register.
+static inline bool IsHostSIMDFormat(VectorFormat vform) {
+  unsigned size = RegisterSizeInBytesFromFormat(vform);
+  return (size == kDRegSizeInBytes) || (size == kQRegSizeInBytes);
+}
+
+
+static inline __m128i HostLoad(const LogicVRegister& src) {
+  return _mm_set_epi64x(static_cast<int64_t>(src.Uint(kFormat2D, 1)),
+                        static_cast<int64_t>(src.Uint(kFormat2D, 0)));
+}
+
+
+// Write a result, clearing the top half of the register for D-sized formats
+// as ClearForWrite would.
+static inline void HostStore(VectorFormat vform,
+                             LogicVRegister dst,
+                             __m128i value) {
+  uint64_t lanes[2];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), value);
+  bool is_q = (RegisterSizeInBytesFromFormat(vform) == kQRegSizeInBytes);
+  dst.SetUint(kFormat2D, 0, lanes[0]);
+  dst.SetUint(kFormat2D, 1, is_q ? lanes[1] : 0);
+}
+
+
+// Return a _mm_movemask_epi8 mask selecting the byte holding the sign bit of
+// each lane in vform.
+static inline int HostSignByteMask(VectorFormat vform) {
+  int lane_bytes = LaneSizeInBytesFromFormat(vform);
+  int mask = 0;
+  for (int i = 0; i < LaneCountFromFormat(vform); i++) {
+    mask |= 1 << (((i + 1) * lane_bytes) - 1);
+  }
+  return mask;
+}
+
+
+static inline __m128i HostAdd(VectorFormat vform, __m128i a, __m128i b) {
+  switch (LaneSizeInBytesFromFormat(vform)) {
+    case 1: return _mm_add_epi8(a, b);
+    case 2: return _mm_add_epi16(a, b);
+    case 4: return _mm_add_epi32(a, b);
+    default: return _mm_add_epi64(a, b);
+  }
+}
+
+
+static inline __m128i HostSub(VectorFormat vform, __m128i a, __m128i b) {
+  switch (LaneSizeInBytesFromFormat(vform)) {
+    case 1: return _mm_sub_epi8(a, b);
+    case 2: return _mm_sub_epi16(a, b);
+    case 4: return _mm_sub_epi32(a, b);
+    default: return _mm_sub_epi64(a, b);
+  }
+}
+
+
+// Signed greater-than for lanes of up to 32 bits.
+static inline __m128i HostCmpGt(int lane_size, __m128i a, __m128i b) {
+  switch (lane_size) {
+    case 1: return _mm_cmpgt_epi8(a, b);
+    case 2: return _mm_cmpgt_epi16(a, b);
+    default: return _mm_cmpgt_epi32(a, b);
+  }
+}
+
+
+static inline __m128i HostCmpEq(int lane_size, __m128i a, __m128i b) {
+  switch (lane_size) {
+    case 1: return _mm_cmpeq_epi8(a, b);
+    case 2: return _mm_cmpeq_epi16(a, b);
+    default: return _mm_cmpeq_epi32(a, b);
+  }
+}
+
+
+static inline __m128i HostUnpackLo(int lane_size, __m128i a, __m128i b) {
+  switch (lane_size) {
+    case 1: return _mm_unpacklo_epi8(a, b);
+    case 2: return _mm_unpacklo_epi16(a, b);
+    case 4: return _mm_unpacklo_epi32(a, b);
+    default: return _mm_unpacklo_epi64(a, b);
+  }
+}
+
+
+static inline __m128i HostUnpackHi(int lane_size, __m128i a, __m128i b) {
+  switch (lane_size) {
+    case 1: return _mm_unpackhi_epi8(a, b);
+    case 2: return _mm_unpackhi_epi16(a, b);
+    case 4: return _mm_unpackhi_epi32(a, b);
+    default: return _mm_unpackhi_epi64(a, b);
+  }
+}
+
+
+static inline __m128i HostZip1(VectorFormat vform, __m128i a, __m128i b) {
+  return HostUnpackLo(LaneSizeInBytesFromFormat(vform), a, b);
+}
+
+
+static inline __m128i HostZip2(VectorFormat vform, __m128i a, __m128i b) {
+  int lane_size = LaneSizeInBytesFromFormat(vform);
+  if (RegisterSizeInBytesFromFormat(vform) == kQRegSizeInBytes) {
+    return HostUnpackHi(lane_size, a, b);
+  }
+  // For D-sized formats, the upper halves of the sources interleave into the
+  // top eight bytes of the low unpack.
+  return _mm_srli_si128(HostUnpackLo(lane_size, a, b), 8);
+}
+
+
+// Record the saturation flags for the lanes selected in masks built by
+// _mm_movemask_epi8, where bit ((i + 1) * lane_bytes) - 1 stands for lane i.
+static inline void HostSetSaturation(VectorFormat vform,
+                                     LogicVRegister* dst,
+                                     int unsigned_mask,
+                                     bool unsigned_positive,
+                                     int signed_mask,
+                                     int positive_mask) {
+  int lane_bytes = LaneSizeInBytesFromFormat(vform);
+  for (int i = 0; i < LaneCountFromFormat(vform); i++) {
+    int bit = 1 << (((i + 1) * lane_bytes) - 1);
+    if ((unsigned_mask & bit) != 0) {
+      dst->SetUnsignedSat(i, unsigned_positive);
+    }
+    if ((signed_mask & bit) != 0) {
+      dst->SetSignedSat(i, (positive_mask & bit) != 0);
+    }
+  }
+}
+#endif  // VIXL_HOST_SIMD_SSE2
+
 template<> double Simulator::FPDefaultNaN<double>() {
   return kFP64DefaultNaN;
 }
@@ -706,6 +849,36 @@ LogicVRegister Simulator::cmp(VectorFormat vform,
                               const LogicVRegister& src1,
                               const LogicVRegister& src2,
                               Condition cond) {
+#ifdef VIXL_HOST_SIMD_SSE2
+  int lane_size = LaneSizeInBytesFromFormat(vform);
+  if (IsHostSIMDFormat(vform) && (lane_size < 8)) {
+    __m128i a = HostLoad(src1);
+    __m128i b = HostLoad(src2);
+    if ((cond == hi) || (cond == hs)) {
+      // Flip the sign bits so that signed comparisons order the lanes as
+      // unsigned values would be ordered.
+      __m128i bias = (lane_size == 1) ? _mm_set1_epi8(-0x80) :
+                     (lane_size == 2) ? _mm_set1_epi16(-0x8000) :
+                                        _mm_set1_epi32(kWMinInt);
+      a = _mm_xor_si128(a, bias);
+      b = _mm_xor_si128(b, bias);
+    }
+    __m128i ones = _mm_set1_epi32(-1);
+    __m128i result = _mm_setzero_si128();
+    switch (cond) {
+      case eq: result = HostCmpEq(lane_size, a, b); break;
+      case gt:
+      case hi: result = HostCmpGt(lane_size, a, b); break;
+      case lt: result = HostCmpGt(lane_size, b, a); break;
+      case ge:
+      case hs: result = _mm_xor_si128(HostCmpGt(lane_size, b, a), ones); break;
+      case le: result = _mm_xor_si128(HostCmpGt(lane_size, a, b), ones); break;
+      default: VIXL_UNREACHABLE(); break;
+    }
+    HostStore(vform, dst, result);
+    return dst;
+  }
+#endif
   dst.ClearForWrite(vform);
   for (int i = 0; i < LaneCountFromFormat(vform); i++) {
     int64_t  sa = src1.Int(vform, i);
@@ -758,6 +931,30 @@ LogicVRegister Simulator::add(VectorFormat vform,
                               LogicVRegister dst,
                               const LogicVRegister& src1,
                               const LogicVRegister& src2) {
+#ifdef VIXL_HOST_SIMD_SSE2
+  if (IsHostSIMDFormat(vform)) {
+    __m128i a = HostLoad(src1);
+    __m128i b = HostLoad(src2);
+    __m128i r = HostAdd(vform, a, b);
+    // The sign bit of each lane of 'carry' holds the carry out of that lane,
+    // and of 'overflow' whether the signed result overflowed.
+    __m128i carry = _mm_or_si128(_mm_and_si128(a, b),
+                                 _mm_andnot_si128(r, _mm_or_si128(a, b)));
+    __m128i overflow = _mm_andnot_si128(_mm_xor_si128(a, b),
+                                        _mm_xor_si128(a, r));
+    int lanes = HostSignByteMask(vform);
+    int carry_mask = _mm_movemask_epi8(carry) & lanes;
+    int overflow_mask = _mm_movemask_epi8(overflow) & lanes;
+    HostStore(vform, dst, r);
+    if ((carry_mask | overflow_mask) != 0) {
+      // A signed overflow saturates towards the sign of the operands.
+      int positive_mask = ~_mm_movemask_epi8(a);
+      HostSetSaturation(vform, &dst, carry_mask, true,
+                        overflow_mask, positive_mask);
+    }
+    return dst;
+  }
+#endif
   dst.ClearForWrite(vform);
   // TODO(all): consider assigning the result of LaneCountFromFormat to a local.
   for (int i = 0; i < LaneCountFromFormat(vform); i++) {
@@ -823,6 +1020,12 @@ LogicVRegister Simulator::mul(VectorFormat vform,
                               LogicVRegister dst,
                               const LogicVRegister& src1,
                               const LogicVRegister& src2) {
+#ifdef VIXL_HOST_SIMD_SSE2
+  if (IsHostSIMDFormat(vform) && (LaneSizeInBytesFromFormat(vform) == 2)) {
+    HostStore(vform, dst, _mm_mullo_epi16(HostLoad(src1), HostLoad(src2)));
+    return dst;
+  }
+#endif
   dst.ClearForWrite(vform);
   for (int i = 0; i < LaneCountFromFormat(vform); i++) {
     dst.SetUint(vform, i, src1.Uint(vform, i) * src2.Uint(vform, i));
@@ -1160,6 +1363,30 @@ LogicVRegister Simulator::sub(VectorFormat vform,
                               LogicVRegister dst,
                               const LogicVRegister& src1,
                               const LogicVRegister& src2) {
+#ifdef VIXL_HOST_SIMD_SSE2
+  if (IsHostSIMDFormat(vform)) {
+    __m128i a = HostLoad(src1);
+    __m128i b = HostLoad(src2);
+    __m128i r = HostSub(vform, a, b);
+    // The sign bit of each lane of 'borrow' is set if src2 > src1 as unsigned
+    // values, and of 'overflow' if the signed result overflowed.
+    __m128i borrow = _mm_or_si128(_mm_andnot_si128(a, b),
+                                  _mm_andnot_si128(_mm_xor_si128(a, b), r));
+    __m128i overflow = _mm_and_si128(_mm_xor_si128(a, b),
+                                     _mm_xor_si128(a, r));
+    int lanes = HostSignByteMask(vform);
+    int borrow_mask = _mm_movemask_epi8(borrow) & lanes;
+    int overflow_mask = _mm_movemask_epi8(overflow) & lanes;
+    HostStore(vform, dst, r);
+    if ((borrow_mask | overflow_mask) != 0) {
+      // A signed overflow wraps to the opposite sign of the saturated value.
+      int positive_mask = _mm_movemask_epi8(r);
+      HostSetSaturation(vform, &dst, borrow_mask, false,
+                        overflow_mask, positive_mask);
+    }
+    return dst;
+  }
+#endif
   dst.ClearForWrite(vform);
   for (int i = 0; i < LaneCountFromFormat(vform); i++) {
     // Test for unsigned saturation.
@@ -1187,6 +1414,14 @@ LogicVRegister Simulator::and_(VectorFormat vform,
                                LogicVRegister dst,
                                const LogicVRegister& src1,
                                const LogicVRegister& src2) {
+#ifdef VIXL_HOST_SIMD_SSE2
+  if (IsHostSIMDFormat(vform)) {
+    __m128i a = HostLoad(src1);
+    __m128i b = HostLoad(src2);
+    HostStore(vform, dst, _mm_and_si128(a, b));
+    return dst;
+  }
+#endif
   dst.ClearForWrite(vform);
   for (int i = 0; i < LaneCountFromFormat(vform); i++) {
     dst.SetUint(vform, i, src1.Uint(vform, i) & src2.Uint(vform, i));
@@ -1199,6 +1434,14 @@ LogicVRegister Simulator::orr(VectorFormat vform,
                               LogicVRegister dst,
                               const LogicVRegister& src1,
                               const LogicVRegister& src2) {
+#ifdef VIXL_HOST_SIMD_SSE2
+  if (IsHostSIMDFormat(vform)) {
+    __m128i a = HostLoad(src1);
+    __m128i b = HostLoad(src2);
+    HostStore(vform, dst, _mm_or_si128(a, b));
+    return dst;
+  }
+#endif
   dst.ClearForWrite(vform);
   for (int i = 0; i < LaneCountFromFormat(vform); i++) {
     dst.SetUint(vform, i, src1.Uint(vform, i) | src2.Uint(vform, i));
@@ -1211,6 +1454,15 @@ LogicVRegister Simulator::orn(VectorFormat vform,
                               LogicVRegister dst,
                               const LogicVRegister& src1,
                               const LogicVRegister& src2) {
+#ifdef VIXL_HOST_SIMD_SSE2
+  if (IsHostSIMDFormat(vform)) {
+    __m128i a = HostLoad(src1);
+    __m128i b = HostLoad(src2);
+    __m128i not_b = _mm_xor_si128(b, _mm_set1_epi32(-1));
+    HostStore(vform, dst, _mm_or_si128(a, not_b));
+    return dst;
+  }
+#endif
   dst.ClearForWrite(vform);
   for (int i = 0; i < LaneCountFromFormat(vform); i++) {
     dst.SetUint(vform, i, src1.Uint(vform, i) | ~src2.Uint(vform, i));
@@ -1223,6 +1475,14 @@ LogicVRegister Simulator::eor(VectorFormat vform,
                               LogicVRegister dst,
                               const LogicVRegister& src1,
                               const LogicVRegister& src2) {
+#ifdef VIXL_HOST_SIMD_SSE2
+  if (IsHostSIMDFormat(vform)) {
+    __m128i a = HostLoad(src1);
+    __m128i b = HostLoad(src2);
+    HostStore(vform, dst, _mm_xor_si128(a, b));
+    return dst;
+  }
+#endif
   dst.ClearForWrite(vform);
   for (int i = 0; i < LaneCountFromFormat(vform); i++) {
     dst.SetUint(vform, i, src1.Uint(vform, i) ^ src2.Uint(vform, i));
@@ -1235,6 +1495,14 @@ LogicVRegister Simulator::bic(VectorFormat vform,
                               LogicVRegister dst,
                               const LogicVRegister& src1,
                               const LogicVRegister& src2) {
+#ifdef VIXL_HOST_SIMD_SSE2
+  if (IsHostSIMDFormat(vform)) {
+    __m128i a = HostLoad(src1);
+    __m128i b = HostLoad(src2);
+    HostStore(vform, dst, _mm_andnot_si128(b, a));
+    return dst;
+  }
+#endif
   dst.ClearForWrite(vform);
   for (int i = 0; i < LaneCountFromFormat(vform); i++) {
     dst.SetUint(vform, i, src1.Uint(vform, i) & ~src2.Uint(vform, i));
@@ -3436,6 +3704,14 @@ LogicVRegister Simulator::zip1(VectorFormat vform,
                                LogicVRegister dst,
                                const LogicVRegister& src1,
                                const LogicVRegister& src2) {
+#ifdef VIXL_HOST_SIMD_SSE2
+  if (IsHostSIMDFormat(vform)) {
+    __m128i a = HostLoad(src1);
+    __m128i b = HostLoad(src2);
+    HostStore(vform, dst, HostZip1(vform, a, b));
+    return dst;
+  }
+#endif
   uint64_t result[16];
   int laneCount = LaneCountFromFormat(vform);
   int pairs = laneCount / 2;
@@ -3456,6 +3732,14 @@ LogicVRegister Simulator::zip2(VectorFormat vform,
                                LogicVRegister dst,
                                const LogicVRegister& src1,
                                const LogicVRegister& src2) {
+#ifdef VIXL_HOST_SIMD_SSE2
+  if (IsHostSIMDFormat(vform)) {
+    __m128i a = HostLoad(src1);
+    __m128i b = HostLoad(src2);
+    HostStore(vform, dst, HostZip2(vform, a, b));
+    return dst;
+  }
+#endif
   uint64_t result[16];
   int laneCount = LaneCountFromFormat(vform);
   int pairs = laneCount / 2;
@@ -479,6 +479,16 @@ inline void InvalSet<VeneerPool::BranchInfo,
                          VeneerPool::BranchInfo* branch_info, ptrdiff_t key) {
   branch_info->max_reachable_pc_ = key;
 }
+// Branch infos are ordered by `pc_offset_`, which invalidation leaves alone.
+template<>
+inline bool InvalSet<VeneerPool::BranchInfo,
+                     VeneerPool::kNPreallocatedInfos,
+                     ptrdiff_t,
+                     VeneerPool::kInvalidOffset,
+                     VeneerPool::kReclaimFrom,
+                     VeneerPool::kReclaimFactor>::IsOrderingIndependentOfKey() {
+  return true;
+}
 
 
 // This scope has the following purposes:
@@ -65,6 +65,8 @@ Simulator::Simulator(Decoder* decoder, FILE* stream) {
   VIXL_ASSERT((static_cast<uint32_t>(-1) >> 1) == 0x7fffffff);
 
   instruction_stats_ = false;
+  block_execution_ = false;
+  block_cache_ = NULL;
 
   // Set up the decoder.
   decoder_ = decoder;
@@ -89,8 +91,9 @@ Simulator::Simulator(Decoder* decoder, FILE* stream) {
   tos = AlignDown(tos, 16);
   set_sp(tos);
 
-  // Set the sample period to 10, as the VIXL examples and tests are short.
-  instrumentation_ = new Instrument("vixl_stats.csv", 10);
+  // The instrumentation is only created, and its output file only opened,
+  // once instruction statistics are enabled.
+  instrumentation_ = NULL;
 
   // Print a warning about exclusive-access instructions, but only the first
   // time they are encountered. This warning can be silenced using
@@ -124,17 +127,26 @@ void Simulator::ResetState() {
 
 Simulator::~Simulator() {
   delete[] stack_;
+  delete[] block_cache_;
   // The decoder may outlive the simulator.
   decoder_->RemoveVisitor(print_disasm_);
   delete print_disasm_;
 
-  decoder_->RemoveVisitor(instrumentation_);
-  delete instrumentation_;
+  if (instrumentation_ != NULL) {
+    decoder_->RemoveVisitor(instrumentation_);
+    delete instrumentation_;
+  }
 }
 
 
 void Simulator::Run() {
   pc_modified_ = false;
+  if (block_execution_) {
+    while (pc_ != kEndOfSimAddress) {
+      ExecuteBlock();
+    }
+    return;
+  }
   while (pc_ != kEndOfSimAddress) {
     ExecuteInstruction();
     LogAllWrittenRegisters();
@@ -142,6 +154,84 @@ void Simulator::Run() {
 }
 
 
+bool Simulator::EndsBlock(Decoder::VisitorFunction visitor) {
+  // Branches and exceptions may move the pc. Exceptions also cover the
+  // simulator's own pseudo-instructions, which can change the tracing and
+  // instrumentation visitors registered with the decoder.
+  return (visitor == &DecoderVisitor::VisitUnconditionalBranch) ||
+         (visitor == &DecoderVisitor::VisitUnconditionalBranchToRegister) ||
+         (visitor == &DecoderVisitor::VisitCompareBranch) ||
+         (visitor == &DecoderVisitor::VisitTestBranch) ||
+         (visitor == &DecoderVisitor::VisitConditionalBranch) ||
+         (visitor == &DecoderVisitor::VisitException) ||
+         (visitor == &DecoderVisitor::VisitUnallocated) ||
+         (visitor == &DecoderVisitor::VisitUnimplemented);
+}
+
+
+Simulator::SimBlock* Simulator::LookupBlock(const Instruction* start) {
+  if (block_cache_ == NULL) {
+    block_cache_ = new SimBlock[kBlockCacheSize];
+    for (int i = 0; i < kBlockCacheSize; i++) {
+      block_cache_[i].start = NULL;
+      block_cache_[i].length = 0;
+    }
+  }
+
+  uintptr_t index = reinterpret_cast<uintptr_t>(start) >> kInstructionSizeLog2;
+  SimBlock* block = &block_cache_[index & (kBlockCacheSize - 1)];
+  if ((block->start == start) && (block->length > 0)) return block;
+
+  // Decode up to and including the first instruction which can leave the
+  // block. Nothing before it can move the pc, so this never reads past code
+  // that a plain instruction-by-instruction run would have executed.
+  block->start = start;
+  block->length = 0;
+  const Instruction* instr = start;
+  while (block->length < kMaxBlockInstructions) {
+    SimBlockInstruction* entry = &block->instructions[block->length++];
+    entry->encoding = instr->InstructionBits();
+    entry->visitor = decoder_->ResolveVisitor(instr);
+    if (EndsBlock(entry->visitor)) break;
+    instr = instr->NextInstruction();
+  }
+  return block;
+}
+
+
+void Simulator::ExecuteBlock() {
+  VIXL_ASSERT(IsWordAligned(pc_));
+  SimBlock* block = LookupBlock(pc_);
+
+  // When the simulator is the only visitor, call it directly rather than
+  // through the decoder. Otherwise (for example when tracing or collecting
+  // instruction statistics), go through the decoder so that every visitor
+  // sees every instruction.
+  std::list<DecoderVisitor*>* visitors = decoder_->visitors();
+  bool direct = (visitors->size() == 1) && (visitors->front() == this);
+
+  for (int i = 0; i < block->length; i++) {
+    const SimBlockInstruction* entry = &block->instructions[i];
+    const Instruction* instr = pc_;
+    if (instr->InstructionBits() != entry->encoding) {
+      // The code has been rewritten since the block was built. Drop the block,
+      // so that it is rebuilt from this instruction on the next call.
+      block->length = 0;
+      return;
+    }
+    if (direct) {
+      (this->*(entry->visitor))(instr);
+    } else {
+      decoder_->CallVisitors(entry->visitor, instr);
+    }
+    increment_pc();
+    LogAllWrittenRegisters();
+    // Only the last instruction of a block is expected to move the pc.
+    if (pc_ != instr->NextInstruction()) return;
+  }
+}
+
+
 void Simulator::RunFrom(const Instruction* first) {
   set_pc(first);
   Run();
@@ -264,6 +354,11 @@ void Simulator::set_trace_parameters(int parameters) {
 void Simulator::set_instruction_stats(bool value) {
   if (value != instruction_stats_) {
     if (value) {
+      if (instrumentation_ == NULL) {
+        // Set the sample period to 10, as the VIXL examples and tests are
+        // short.
+        instrumentation_ = new Instrument("vixl_stats.csv", 10);
+      }
       decoder_->AppendVisitor(instrumentation_);
     } else {
       decoder_->RemoveVisitor(instrumentation_);
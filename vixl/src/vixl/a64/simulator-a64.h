@@ -712,10 +712,14 @@ class Simulator : public DecoderVisitor {
   void ExecuteInstruction() {
     // The program counter should always be aligned.
     VIXL_ASSERT(IsWordAligned(pc_));
-    decoder_->Decode(pc_);
+    decoder_->DecodeCached(pc_);
     increment_pc();
   }
 
+  // Execute the basic block starting at the current pc, stopping after the
+  // instruction that ends it.
+  void ExecuteBlock();
+
   // Declare all Visitor functions.
   #define DECLARE(A) virtual void Visit##A(const Instruction* instr);
   VISITOR_LIST_THAT_RETURN(DECLARE)
@@ -1208,6 +1212,19 @@ class Simulator : public DecoderVisitor {
 
   void set_instruction_stats(bool value);
 
+  // The instrumentation used for instruction statistics, or NULL if they have
+  // never been enabled. Its counters and profiles can be read directly once a
+  // run has finished.
+  Instrument* instrumentation() const { return instrumentation_; }
+
+  // When enabled, Run() executes code a basic block at a time: straight-line
+  // sequences are decoded once into an array of visitor methods, which is then
+  // replayed without going back through the decode tree or the pc checks of
+  // the main loop. This does not change what is simulated, and tracing and
+  // instrumentation keep working.
+  bool block_execution() const { return block_execution_; }
+  void set_block_execution(bool value) { block_execution_ = value; }
+
   // Clear the simulated local monitor to force the next store-exclusive
   // instruction to fail.
   void ClearLocalMonitor() {
@@ -2542,6 +2559,27 @@ class Simulator : public DecoderVisitor {
   bool pc_modified_;
   const Instruction* pc_;
 
+  // Basic blocks, as built and run by ExecuteBlock().
+  static const int kMaxBlockInstructions = 32;
+  struct SimBlockInstruction {
+    Instr encoding;
+    Decoder::VisitorFunction visitor;
+  };
+  struct SimBlock {
+    const Instruction* start;
+    int length;
+    SimBlockInstruction instructions[kMaxBlockInstructions];
+  };
+  // Number of entries in the direct-mapped block cache. This must be a power
+  // of two.
+  static const int kBlockCacheSize = 256;
+  // Allocated on the first call to ExecuteBlock().
+  SimBlock* block_cache_;
+  bool block_execution_;
+
+  SimBlock* LookupBlock(const Instruction* start);
+  static bool EndsBlock(Decoder::VisitorFunction visitor);
+
   static const char* xreg_names[];
   static const char* wreg_names[];
   static const char* sreg_names[];
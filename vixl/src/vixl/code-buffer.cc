@@ -24,6 +24,10 @@
 // OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#ifdef VIXL_CODE_BUFFER_MMAP
+#include <sys/mman.h>
+#endif
+
 #include "vixl/code-buffer.h"
 #include "vixl/utils.h"
 
@@ -32,7 +36,14 @@ namespace vixl {
 
 CodeBuffer::CodeBuffer(size_t capacity) : managed_(true), capacity_(capacity) {
   VIXL_CHECK(capacity_ != 0);
+#ifdef VIXL_CODE_BUFFER_MMAP
+  void* buffer = mmap(NULL, capacity_, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  VIXL_CHECK(buffer != MAP_FAILED);
+  buffer_ = reinterpret_cast<byte*>(buffer);
+#else
   buffer_ = reinterpret_cast<byte*>(malloc(capacity_));
+#endif
   VIXL_CHECK(buffer_ != NULL);
   // A64 instructions must be word aligned, we assert the default allocator
   // always returns word align memory.
@@ -56,7 +67,11 @@ CodeBuffer::CodeBuffer(void* buffer, size_t capacity)
 CodeBuffer::~CodeBuffer() {
   VIXL_ASSERT(!IsDirty());
   if (managed_) {
+#ifdef VIXL_CODE_BUFFER_MMAP
+    munmap(buffer_, capacity_);
+#else
     free(buffer_);
+#endif
   }
 }
 
@@ -99,12 +114,49 @@ void CodeBuffer::Grow(size_t new_capacity) {
   VIXL_ASSERT(managed_);
   VIXL_ASSERT(new_capacity > capacity_);
   size_t size = CursorOffset();
+#if defined(VIXL_CODE_BUFFER_MMAP) && defined(__linux__)
+  // Let the kernel move the pages rather than copying the contents.
+  void* buffer = mremap(buffer_, capacity_, new_capacity, MREMAP_MAYMOVE);
+  VIXL_CHECK(buffer != MAP_FAILED);
+  buffer_ = reinterpret_cast<byte*>(buffer);
+#elif defined(VIXL_CODE_BUFFER_MMAP)
+  void* buffer = mmap(NULL, new_capacity, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  VIXL_CHECK(buffer != MAP_FAILED);
+  memcpy(buffer, buffer_, size);
+  munmap(buffer_, capacity_);
+  buffer_ = reinterpret_cast<byte*>(buffer);
+#else
   buffer_ = static_cast<byte*>(realloc(buffer_, new_capacity));
   VIXL_CHECK(buffer_ != NULL);
+#endif
 
   cursor_ = buffer_ + size;
   capacity_ = new_capacity;
 }
 
 
+void CodeBuffer::SetExecutable() {
+#ifdef VIXL_CODE_BUFFER_MMAP
+  VIXL_ASSERT(managed_);
+  int result = mprotect(buffer_, capacity_, PROT_READ | PROT_EXEC);
+  VIXL_CHECK(result == 0);
+#else
+  // Only mmap-backed buffers can change their protection.
+  VIXL_UNREACHABLE();
+#endif
+}
+
+
+void CodeBuffer::SetWritable() {
+#ifdef VIXL_CODE_BUFFER_MMAP
+  VIXL_ASSERT(managed_);
+  int result = mprotect(buffer_, capacity_, PROT_READ | PROT_WRITE);
+  VIXL_CHECK(result == 0);
+#else
+  VIXL_UNREACHABLE();
+#endif
+}
+
+
 }  // namespace vixl
@@ -32,9 +32,17 @@
 
 namespace vixl {
 
+// By default, managed code buffers are allocated with malloc and grown with
+// realloc. When VIXL_CODE_BUFFER_MMAP is defined they are instead mapped
+// directly from the OS, grown by remapping (without copying on Linux), and can
+// be flipped between writable and executable with SetWritable() and
+// SetExecutable(), so that generated code can run from the buffer it was
+// emitted into.
 class CodeBuffer {
  public:
   explicit CodeBuffer(size_t capacity = 4 * KBytes);
+  // Emit into a region provided (and owned) by the caller, for example a slot
+  // in a JIT code cache. The region is never resized or re-protected.
   CodeBuffer(void* buffer, size_t capacity);
   ~CodeBuffer();
 
@@ -80,6 +88,12 @@ class CodeBuffer {
 
   void Grow(size_t new_capacity);
 
+  // Change the protection of a managed mmap-backed buffer. The buffer is
+  // writable when created; it must be writable whenever code is emitted,
+  // reset or grown, and is never writable and executable at the same time.
+  void SetExecutable();
+  void SetWritable();
+
   bool IsDirty() const { return dirty_; }
 
   void SetClean() { dirty_ = false; }
@@ -49,7 +49,8 @@ namespace vixl {
 //   `std::sort()` can be used.
 // - A key must be available to represent invalid elements.
 // - Elements with an invalid key must compare higher or equal to any other
-//   element.
+//   element, unless `IsOrderingIndependentOfKey()` is specialised to return
+//   true (see below).
 //
 // Use cases and performance considerations:
 // Our use cases present two specificities that allow us to design this
@@ -65,6 +66,12 @@ namespace vixl {
 // ignoring entries marked as invalid.
 // To avoid the overhead of the `std::vector` container when only few entries
 // are used, a number of elements are preallocated.
+// Binary searches normally have to step over invalid elements one at a time,
+// which degrades to a linear search when many adjacent elements have been
+// deleted. Sets whose elements are not ordered by their key (so an invalidated
+// element still compares as it did before) can specialise
+// `IsOrderingIndependentOfKey()` to return true. Their searches then ignore
+// validity and are always logarithmic.
 
 // 'ElementType' and 'KeyType' are respectively the types of the elements and
 // their key.  The structure only reclaims memory when safe to do so, if the
@@ -116,6 +123,8 @@ template<TEMPLATE_INVALSET_P_DECL> class InvalSet {
   static bool IsValid(const ElementType& element);
   static KeyType Key(const ElementType& element);
   static void SetKey(ElementType* element, KeyType key);
+  // Returns false unless specialised.
+  static bool IsOrderingIndependentOfKey();
 
  protected:
   // Returns a pointer to the element in vector_ if it was found, or NULL
@@ -186,6 +195,10 @@ template<TEMPLATE_INVALSET_P_DECL> class InvalSet {
   bool valid_cached_min_;
   size_t cached_min_index_;  // Valid iff `valid_cached_min_` is true.
   KeyType cached_min_key_;         // Valid iff `valid_cached_min_` is true.
+  // Index of the last element erased from the vector, used as a search hint.
+  // Reset whenever the backing storage is compacted or reordered.
+  bool valid_last_erased_;
+  size_t last_erased_index_;  // Valid iff `valid_last_erased_` is true.
 
   // Indicates whether the elements are sorted.
   bool sorted_;
@@ -261,7 +274,7 @@ template<class S> class InvalSetIterator {
 
 template<TEMPLATE_INVALSET_P_DECL>
 InvalSet<TEMPLATE_INVALSET_P_DEF>::InvalSet()
-  : valid_cached_min_(false),
+  : valid_cached_min_(false), valid_last_erased_(false),
     sorted_(true), size_(0), vector_(NULL) {
 #ifdef VIXL_DEBUG
   monitor_ = 0;
@@ -335,7 +348,19 @@ ElementType* InvalSet<TEMPLATE_INVALSET_P_DEF>::Search(
   if (!valid_cached_min_) {
     CacheMinElement();
   }
-  return BinarySearch(element, ElementAt(cached_min_index_), StorageEnd());
+  // Elements are often erased in order, so check the minimum and the element
+  // following the last one erased before searching.
+  ElementType* min = ElementAt(cached_min_index_);
+  if (*min == element) {
+    return min;
+  }
+  if (valid_last_erased_ && (last_erased_index_ + 1 < vector_->size())) {
+    ElementType* next = ElementAt(last_erased_index_ + 1);
+    if (IsValid(*next) && (*next == element)) {
+      return next;
+    }
+  }
+  return BinarySearch(element, min, StorageEnd());
 }
 
 
@@ -360,6 +385,7 @@ void InvalSet<TEMPLATE_INVALSET_P_DEF>::clear() {
   }
   set_sorted(true);
   valid_cached_min_ = false;
+  valid_last_erased_ = false;
 }
 
 
@@ -389,6 +415,12 @@ bool InvalSet<TEMPLATE_INVALSET_P_DEF>::IsValid(const ElementType& element) {
 }
 
 
+template<TEMPLATE_INVALSET_P_DECL>
+bool InvalSet<TEMPLATE_INVALSET_P_DEF>::IsOrderingIndependentOfKey() {
+  return false;
+}
+
+
 template<TEMPLATE_INVALSET_P_DECL>
 void InvalSet<TEMPLATE_INVALSET_P_DEF>::EraseInternal(ElementType* element) {
   // Note that this function must be safe even while an iterator has acquired
@@ -399,6 +431,8 @@ void InvalSet<TEMPLATE_INVALSET_P_DEF>::EraseInternal(ElementType* element) {
     VIXL_ASSERT((&(vector_->front()) <= element) &&
                 (element <= &(vector_->back())));
     SetKey(element, kInvalidKey);
+    valid_last_erased_ = true;
+    last_erased_index_ = deleted_index;
   } else {
     VIXL_ASSERT((preallocated_ <= element) &&
                 (element < (preallocated_ + kNPreallocatedElements)));
@@ -432,6 +466,15 @@ ElementType* InvalSet<TEMPLATE_INVALSET_P_DEF>::BinarySearch(
   VIXL_ASSERT(start < end);
   VIXL_ASSERT(!empty());
 
+  if (IsOrderingIndependentOfKey()) {
+    // Invalid elements are still in order, so there is no need to skip them.
+    ElementType* found = std::lower_bound(start, end, element);
+    if ((found != end) && IsValid(*found) && (*found == element)) {
+      return found;
+    }
+    return NULL;
+  }
+
   // Perform a binary search through the elements while ignoring invalid
   // elements.
   ElementType* elements = start;
@@ -479,6 +522,7 @@ void InvalSet<TEMPLATE_INVALSET_P_DEF>::Sort(SortType sort_type) {
 
   Clean();
   std::sort(StorageBegin(), StorageEnd());
+  valid_last_erased_ = false;
 
   set_sorted(true);
   cached_min_index_ = 0;
@@ -519,6 +563,7 @@ void InvalSet<TEMPLATE_INVALSET_P_DEF>::Clean() {
   // Delete the trailing invalid elements.
   vector_->erase(vector_->begin() + (first_invalid - start), vector_->end());
   VIXL_ASSERT(vector_->size() == size_);
+  valid_last_erased_ = false;
 
   if (sorted_) {
     valid_cached_min_ = true;
@@ -668,6 +713,10 @@ InvalSetIterator<S>::InvalSetIterator(S* inval_set)
     if (using_vector_) {
       iterator_ = typename std::vector<ElementType>::iterator(
           inval_set_->vector_->begin());
+      // In a sorted set, everything before the cached minimum is invalid.
+      if (inval_set_->valid_cached_min_) {
+        iterator_ += inval_set_->cached_min_index_;
+      }
     }
     MoveToValidElement();
   }
@@ -27,6 +27,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include <float.h>
 #include <cmath>
 
@@ -113,6 +114,7 @@ namespace vixl {
                                               : new Simulator(&decoder);       \
   simulator->set_coloured_trace(Test::coloured_trace());                       \
   simulator->set_instruction_stats(Test::instruction_stats());                 \
+  simulator->set_block_execution(Test::block_execution());                     \
   RegisterDump core
 
 // This is a convenience macro to avoid creating a scope for every assembler
@@ -22007,4 +22009,143 @@ TEST(literal_deletion_policies) {
 }
 
 
+TEST(rewrite_code_in_place) {
+  // Run two different sequences from the same buffer. When simulating, the
+  // second run must not reuse what was decoded during the first one.
+  SETUP();
+
+  START();
+  __ Mov(x0, 0x10);
+  __ Add(x1, x0, 1);
+  __ Lsl(x2, x0, 2);
+  END();
+
+  RUN();
+
+  ASSERT_EQUAL_64(0x11, x1);
+  ASSERT_EQUAL_64(0x40, x2);
+
+  START();
+  __ Mov(x0, 0x10);
+  __ Sub(x1, x0, 1);
+  __ Lsr(x2, x0, 2);
+  END();
+
+  RUN();
+
+  ASSERT_EQUAL_64(0xf, x1);
+  ASSERT_EQUAL_64(0x4, x2);
+
+  TEARDOWN();
+}
+
+
+TEST(buffer_growth) {
+  // Start with a buffer too small for the code below, so that it has to be
+  // grown (by remapping when VIXL_CODE_BUFFER_MMAP is defined) several times.
+  MacroAssembler masm(4 * kInstructionSize);
+  SETUP_COMMON();
+
+  START();
+  __ Mov(x0, 0);
+  for (int i = 0; i < 1000; i++) {
+    __ Add(x0, x0, 1);
+  }
+  END();
+
+#ifdef VIXL_CODE_BUFFER_MMAP
+  masm.buffer()->SetExecutable();
+#endif
+  RUN();
+#ifdef VIXL_CODE_BUFFER_MMAP
+  masm.buffer()->SetWritable();
+#endif
+
+  ASSERT_EQUAL_64(1000, x0);
+  VIXL_CHECK(masm.BufferCapacity() >= (1000 * kInstructionSize));
+
+  TEARDOWN();
+}
+
+
+#ifdef VIXL_INCLUDE_SIMULATOR
+TEST(instrument_profile) {
+  SETUP();
+
+  START();
+  Label loop;
+  __ Mov(x0, 10);
+  __ Bind(&loop);
+  __ Sub(x0, x0, 1);
+  __ Cbnz(x0, &loop);
+  END();
+
+  // Use a separate Instrument, writing to a temporary file, so that the test
+  // leaves nothing behind in the working directory. The profiles are checked
+  // through the in-memory accessors.
+  char datafile[] = "/tmp/vixl-instrument-XXXXXX";
+  int fd = mkstemp(datafile);
+  VIXL_CHECK(fd >= 0);
+  close(fd);
+  Instrument* instrument = new Instrument(datafile, 10);
+  instrument->EnablePCHistogram();
+  instrument->EnableBlockProfile();
+  instrument->Enable();
+  decoder.AppendVisitor(instrument);
+  RUN();
+  decoder.RemoveVisitor(instrument);
+  instrument->Disable();
+
+  uintptr_t loop_address = masm.GetLabelAddress<uintptr_t>(&loop);
+  VIXL_CHECK(instrument->pc_histogram().find(loop_address)->second == 10);
+
+  // The first iteration falls through into the loop, so it is counted in the
+  // preceding block. The other nine enter it through the branch.
+  std::map<uintptr_t, BlockProfile>::const_iterator block =
+      instrument->block_profile().find(loop_address);
+  VIXL_CHECK(block != instrument->block_profile().end());
+  VIXL_CHECK(block->second.executions == 9);
+  VIXL_CHECK(block->second.instructions == 18);
+
+  VIXL_CHECK(instrument->GetCounterValue("Instruction") >= 21);
+
+  delete instrument;
+  unlink(datafile);
+
+  TEARDOWN();
+}
+
+
+TEST(block_execution) {
+  SETUP();
+  simulator->set_block_execution(true);
+
+  START();
+  Label loop, skip;
+  __ Mov(x0, 0);
+  __ Mov(x1, 10);
+  __ Mov(x2, 0);
+  __ Bind(&loop);
+  __ Add(x0, x0, x1);
+  __ Add(x2, x2, 1);
+  __ Sub(x1, x1, 1);
+  __ Cbnz(x1, &loop);
+  __ Cmp(x0, 55);
+  __ B(ne, &skip);
+  __ Mov(x3, 0x1234);
+  __ Bind(&skip);
+  END();
+
+  RUN();
+
+  ASSERT_EQUAL_64(55, x0);
+  ASSERT_EQUAL_64(0, x1);
+  ASSERT_EQUAL_64(10, x2);
+  ASSERT_EQUAL_64(0x1234, x3);
+
+  TEARDOWN();
+}
+#endif
+
+
 }  // namespace vixl
@@ -5563,4 +5563,75 @@ TEST(address_map) {
   CLEANUP();
 }
 
+
+TEST(batch) {
+  // Generate a range of varied, position-dependent code.
+  const int kLoops = 3000;
+  MacroAssembler masm(kLoops * 8 * kInstructionSize);
+  for (int i = 0; i < kLoops; i++) {
+    Label label;
+    masm.Add(x0, x1, Operand(x2, LSL, i % 64));
+    masm.Cbz(x3, &label);
+    masm.Ldr(w4, MemOperand(x5, (i % 256) * 4));
+    masm.Adr(x6, &label);
+    masm.Fadd(d0, d1, d2);
+    masm.Bind(&label);
+  }
+  masm.FinalizeCode();
+  const Instruction* start = masm.GetStartAddress<Instruction*>();
+  const Instruction* end =
+      start->InstructionAtOffset(masm.SizeOfCodeGenerated());
+  size_t count = (end - start) / kInstructionSize;
+
+  // The lines must match what a plain Disassembler produces.
+  size_t arena_size = count * BatchDisassembler::kMaxLineLength;
+  char* serial = new char[arena_size];
+  BatchDisassembler batch(serial, arena_size);
+  VIXL_CHECK(batch.DisassembleRange(start, end) == end);
+  size_t serial_size = batch.arena_used();
+
+  Decoder decoder;
+  Disassembler disasm;
+  decoder.AppendVisitor(&disasm);
+  const char* line = serial;
+  for (const Instruction* instr = start; instr < end;
+       instr = instr->NextInstruction()) {
+    char expected[BatchDisassembler::kMaxLineLength + 1];
+    decoder.Decode(instr);
+    snprintf(expected, sizeof(expected),
+             "0x%016" PRIx64 "  %08" PRIx32 "\t\t%s\n",
+             reinterpret_cast<uint64_t>(instr), instr->InstructionBits(),
+             disasm.GetOutput());
+    VIXL_CHECK(strncmp(line, expected, strlen(expected)) == 0);
+    line += strlen(expected);
+  }
+  VIXL_CHECK(line == serial + serial_size);
+
+  // An arena too small for the whole range stops at a line boundary, and
+  // the range can be resumed from where it stopped.
+  size_t small_size = 10 * BatchDisassembler::kMaxLineLength;
+  char* small = new char[small_size];
+  BatchDisassembler partial(small, small_size);
+  const Instruction* next = start;
+  size_t offset = 0;
+  while (next < end) {
+    partial.ResetArena();
+    next = partial.DisassembleRange(next, end);
+    VIXL_CHECK(memcmp(small, serial + offset, partial.arena_used()) == 0);
+    offset += partial.arena_used();
+  }
+  VIXL_CHECK(offset == serial_size);
+
+  // Splitting the work across threads gives the same output.
+  char* parallel = new char[arena_size];
+  BatchDisassembler threaded(parallel, arena_size);
+  threaded.DisassembleRangeInParallel(start, end, 4);
+  VIXL_CHECK(threaded.arena_used() == serial_size);
+  VIXL_CHECK(memcmp(parallel, serial, serial_size) == 0);
+
+  delete[] parallel;
+  delete[] small;
+  delete[] serial;
+}
+
 }  // namespace vixl
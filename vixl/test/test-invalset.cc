@@ -176,6 +176,33 @@ TEST(erase) {
 }
 
 
+TEST(erase_in_order) {
+  TestSet set;
+  int n_elements = 100 * kNPreallocatedElements;
+  for (int i = 0; i < n_elements; i++) {
+    set.insert(Obj(i, i));
+  }
+
+  // Erase every other element, in order. Each search has to skip over the
+  // elements previously erased.
+  for (int i = 1; i < n_elements; i += 2) {
+    set.erase(Obj(i, i));
+    VIXL_CHECK(set.size() == static_cast<size_t>(n_elements - (i + 1) / 2));
+  }
+  VIXL_CHECK(set.min_element() == Obj(0, 0));
+
+  // Erasing an element twice does nothing.
+  set.erase(Obj(1, 1));
+  VIXL_CHECK(set.size() == static_cast<size_t>(n_elements / 2));
+
+  // Erase the remaining elements from the back.
+  for (int i = n_elements - 2; i >= 0; i -= 2) {
+    set.erase(Obj(i, i));
+  }
+  VIXL_CHECK(set.empty() && (set.size() == 0));
+}
+
+
 TEST(min) {
   TestSet set;
   VIXL_CHECK(set.empty() && (set.size() == 0));
@@ -50,6 +50,9 @@ bool vixl::Test::instruction_stats_ = false;
 // Don't generate simulator test traces by default.
 bool vixl::Test::sim_test_trace_ = false;
 
+// Simulate one instruction at a time by default.
+bool vixl::Test::block_execution_ = false;
+
 // Instantiate a Test and append it to the linked list.
 vixl::Test::Test(const char* name, TestFunction* callback)
   : name_(name), callback_(callback), next_(NULL) {
@@ -107,7 +110,8 @@ static void PrintHelpMessage() {
       "--trace_write       Generate a trace of memory writes.\n"
       "--coloured_trace    Generate coloured trace.\n"
       "--instruction_stats Log instruction statistics to vixl_stats.csv.\n"
-      "--sim_test_trace    Print result traces for SIM_* tests.\n");
+      "--sim_test_trace    Print result traces for SIM_* tests.\n"
+      "--block_execution   Simulate code a basic block at a time.\n");
 }
 
 int main(int argc, char* argv[]) {
@@ -161,6 +165,10 @@ int main(int argc, char* argv[]) {
     vixl::Test::set_sim_test_trace(true);
   }
 
+  if (IsInArgs("--block-execution", argc, argv)) {
+    vixl::Test::set_block_execution(true);
+  }
+
   // Basic (mutually-exclusive) operations.
 
   if (IsInArgs("--help", argc, argv)) {
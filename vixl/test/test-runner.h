@@ -58,6 +58,8 @@ class Test {
   static void set_instruction_stats(bool value) { instruction_stats_ = value; }
   static bool sim_test_trace() { return sim_test_trace_; }
   static void set_sim_test_trace(bool value) { sim_test_trace_ = value; }
+  static bool block_execution() { return block_execution_; }
+  static void set_block_execution(bool value) { block_execution_ = value; }
 
   // The debugger is needed to trace register values.
   static bool run_debugger() { return debug_; }
@@ -76,6 +78,7 @@ class Test {
   static bool coloured_trace_;
   static bool instruction_stats_;
   static bool sim_test_trace_;
+  static bool block_execution_;
 };
 
 // Define helper macros for test files.
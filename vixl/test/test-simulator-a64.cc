@@ -61,6 +61,7 @@ namespace vixl {
                                               : new Simulator(&decoder);      \
   simulator->set_coloured_trace(Test::coloured_trace());                      \
   simulator->set_instruction_stats(Test::instruction_stats());                \
+  simulator->set_block_execution(Test::block_execution());                    \
 
 #define START()                                                               \
   masm.Reset();                                                               \
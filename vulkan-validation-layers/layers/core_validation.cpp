@@ -48,6 +48,7 @@
 #include <iostream>
 #include <algorithm>
 #include <list>
+#include <atomic>
 #include <SPIRV/spirv.hpp>
 #include <set>
 
@@ -145,19 +146,31 @@ struct layer_data {
     unordered_map<ImageSubresourcePair, IMAGE_LAYOUT_NODE> imageLayoutMap;
     unordered_map<VkRenderPass, RENDER_PASS_NODE *> renderPassMap;
     unordered_map<VkShaderModule, unique_ptr<shader_module>> shaderModuleMap;
-    // Current render pass
-    VkRenderPassBeginInfo renderPassBeginInfo;
-    uint32_t currentSubpass;
+    // vkCmd* entry points only hold globalLock shared, so the few places where recording
+    // touches state shared between command buffers take one of these as well
+    loader_platform_thread_mutex memLock;         // DEVICE_MEM_INFO command buffer bindings
+    loader_platform_thread_mutex setLock;         // SET_NODE bound command buffers
+    loader_platform_thread_mutex framebufferLock; // FRAMEBUFFER_NODE referencing command buffers
 
     // Device specific data
     PHYS_DEV_PROPERTIES_NODE physDevProperties;
+    VALIDATION_LEVEL validationLevel;
 // MTMERGESOURCE - added a couple of fields to constructor initializer
     layer_data()
         : report_data(nullptr), device_dispatch_table(nullptr), instance_dispatch_table(nullptr),
 #if MTMERGESOURCE
         currentFenceId(1),
 #endif
-        device_extensions(){};
+        device_extensions(), validationLevel(VALIDATION_LEVEL_FULL) {
+        loader_platform_thread_create_mutex(&memLock);
+        loader_platform_thread_create_mutex(&setLock);
+        loader_platform_thread_create_mutex(&framebufferLock);
+    }
+    ~layer_data() {
+        loader_platform_thread_delete_mutex(&memLock);
+        loader_platform_thread_delete_mutex(&setLock);
+        loader_platform_thread_delete_mutex(&framebufferLock);
+    }
 };
 
 static const VkLayerProperties cv_global_layers[] = {{
@@ -250,9 +263,14 @@ struct shader_module {
 // TODO : Do we need to guard access to layer_data_map w/ lock?
 static unordered_map<void *, layer_data *> layer_data_map;
 
-// TODO : This can be much smarter, using separate locks for separate global data
+// Entry points that create, destroy, submit or reset objects hold globalLock exclusively.
+// Recording into a command buffer only holds it shared: the application already has to
+// synchronize access to each command buffer, so recording on different command buffers
+// can validate in parallel. See layer_data for the locks guarding what they do share.
 static int globalLockInitialized = 0;
-static loader_platform_thread_mutex globalLock;
+static loader_platform_thread_rwlock globalLock;
+// Per entry point call counts and sampled CPU time, see lunarg_core_validation.profile
+static layer_profiler profiler;
 #define MAX_TID 513
 static loader_platform_thread_id g_tidMapping[MAX_TID] = {0};
 static uint32_t g_maxTID = 0;
@@ -553,6 +571,8 @@ static VkBool32 update_cmd_buf_and_mem_references(layer_data *dev_data, const Vk
         // First update CB binding in MemObj mini CB list
         DEVICE_MEM_INFO *pMemInfo = get_mem_obj_info(dev_data, mem);
         if (pMemInfo) {
+            // Other command buffers may be recording against the same memory object
+            loader_platform_thread_lock_mutex(&dev_data->memLock);
             // Search for cmd buffer object in memory object's binding list
             VkBool32 found = VK_FALSE;
             if (pMemInfo->pCommandBufferBindings.size() > 0) {
@@ -569,6 +589,7 @@ static VkBool32 update_cmd_buf_and_mem_references(layer_data *dev_data, const Vk
                 pMemInfo->pCommandBufferBindings.push_front(cb);
                 pMemInfo->refCount++;
             }
+            loader_platform_thread_unlock_mutex(&dev_data->memLock);
             // Now update CBInfo's Mem reference list
             GLOBAL_CB_NODE *pCBNode = getCBNode(dev_data, cb);
             // TODO: keep track of all destroyed CBs so we know if this is a stale or simply invalid object
@@ -2139,7 +2160,7 @@ static VkDescriptorSetLayoutBinding const * get_descriptor_binding(layer_data *m
     if (slot.first >= pipelineLayout->size())
         return nullptr;
 
-    auto const layout_node = my_data->descriptorSetLayoutMap[(*pipelineLayout)[slot.first]];
+    auto const layout_node = my_data->descriptorSetLayoutMap.at((*pipelineLayout)[slot.first]);
 
     auto bindingIt = layout_node->bindingToIndexMap.find(slot.second);
     if ((bindingIt == layout_node->bindingToIndexMap.end()) || (layout_node->createInfo.pBindings == NULL))
@@ -2151,7 +2172,7 @@ static VkDescriptorSetLayoutBinding const * get_descriptor_binding(layer_data *m
 
 // Block of code at start here for managing/tracking Pipeline state that this layer cares about
 
-static uint64_t g_drawCount[NUM_DRAW_TYPES] = {0, 0, 0, 0};
+static std::atomic<uint64_t> g_drawCount[NUM_DRAW_TYPES];
 
 // TODO : Should be tracking lastBound per commandBuffer and when draws occur, report based on that cmd buffer lastBound
 //   Then need to synchronize the accesses based on cmd buffer so that if I'm reading state on one cmd buffer, updates
@@ -2167,15 +2188,16 @@ static VkBool32 hasDrawCmd(GLOBAL_CB_NODE *pCB) {
 }
 
 // Check object status for selected flag state
-static VkBool32 validate_status(layer_data *my_data, GLOBAL_CB_NODE *pNode, CBStatusFlags enable_mask, CBStatusFlags status_mask,
-                                CBStatusFlags status_flag, VkFlags msg_flags, DRAW_STATE_ERROR error_code, const char *fail_msg) {
+static VkBool32 validate_status(layer_data *my_data, VkCommandBuffer commandBuffer, CBStatusFlags status,
+                                CBStatusFlags enable_mask, CBStatusFlags status_mask, CBStatusFlags status_flag, VkFlags msg_flags,
+                                DRAW_STATE_ERROR error_code, const char *fail_msg) {
     // If non-zero enable mask is present, check it against status but if enable_mask
     //  is 0 then no enable required so we should always just check status
-    if ((!enable_mask) || (enable_mask & pNode->status)) {
-        if ((pNode->status & status_mask) != status_flag) {
+    if ((!enable_mask) || (enable_mask & status)) {
+        if ((status & status_mask) != status_flag) {
             // TODO : How to pass dispatchable objects as srcObject? Here src obj should be cmd buffer
             return log_msg(my_data->report_data, msg_flags, VK_DEBUG_REPORT_OBJECT_TYPE_COMMAND_BUFFER_EXT, 0, __LINE__, error_code,
-                           "DS", "CB object %#" PRIxLEAST64 ": %s", (uint64_t)(pNode->commandBuffer), fail_msg);
+                           "DS", "CB object %#" PRIxLEAST64 ": %s", (uint64_t)(commandBuffer), fail_msg);
         }
     }
     return VK_FALSE;
@@ -2183,10 +2205,11 @@ static VkBool32 validate_status(layer_data *my_data, GLOBAL_CB_NODE *pNode, CBSt
 
 // Retrieve pipeline node ptr for given pipeline object
 static PIPELINE_NODE *getPipeline(layer_data *my_data, const VkPipeline pipeline) {
-    if (my_data->pipelineMap.find(pipeline) == my_data->pipelineMap.end()) {
+    auto pipe_data = my_data->pipelineMap.find(pipeline);
+    if (pipe_data == my_data->pipelineMap.end()) {
         return NULL;
     }
-    return my_data->pipelineMap[pipeline];
+    return pipe_data->second;
 }
 
 // Return VK_TRUE if for a given PSO, the given state enum is dynamic, else return VK_FALSE
@@ -2201,38 +2224,39 @@ static VkBool32 isDynamic(const PIPELINE_NODE *pPipeline, const VkDynamicState s
 }
 
 // Validate state stored as flags at time of draw call
-static VkBool32 validate_draw_state_flags(layer_data *my_data, GLOBAL_CB_NODE *pCB, VkBool32 indexedDraw) {
+static VkBool32 validate_draw_state_flags(layer_data *my_data, VkCommandBuffer commandBuffer, CBStatusFlags status,
+                                          VkBool32 indexedDraw) {
     VkBool32 result;
-    result =
-        validate_status(my_data, pCB, CBSTATUS_NONE, CBSTATUS_VIEWPORT_SET, CBSTATUS_VIEWPORT_SET, VK_DEBUG_REPORT_ERROR_BIT_EXT,
-                        DRAWSTATE_VIEWPORT_NOT_BOUND, "Dynamic viewport state not set for this command buffer");
-    result |=
-        validate_status(my_data, pCB, CBSTATUS_NONE, CBSTATUS_SCISSOR_SET, CBSTATUS_SCISSOR_SET, VK_DEBUG_REPORT_ERROR_BIT_EXT,
-                        DRAWSTATE_SCISSOR_NOT_BOUND, "Dynamic scissor state not set for this command buffer");
-    result |= validate_status(my_data, pCB, CBSTATUS_NONE, CBSTATUS_LINE_WIDTH_SET, CBSTATUS_LINE_WIDTH_SET,
+    result = validate_status(my_data, commandBuffer, status, CBSTATUS_NONE, CBSTATUS_VIEWPORT_SET, CBSTATUS_VIEWPORT_SET,
+                             VK_DEBUG_REPORT_ERROR_BIT_EXT, DRAWSTATE_VIEWPORT_NOT_BOUND,
+                             "Dynamic viewport state not set for this command buffer");
+    result |= validate_status(my_data, commandBuffer, status, CBSTATUS_NONE, CBSTATUS_SCISSOR_SET, CBSTATUS_SCISSOR_SET,
+                              VK_DEBUG_REPORT_ERROR_BIT_EXT, DRAWSTATE_SCISSOR_NOT_BOUND,
+                              "Dynamic scissor state not set for this command buffer");
+    result |= validate_status(my_data, commandBuffer, status, CBSTATUS_NONE, CBSTATUS_LINE_WIDTH_SET, CBSTATUS_LINE_WIDTH_SET,
                               VK_DEBUG_REPORT_ERROR_BIT_EXT, DRAWSTATE_LINE_WIDTH_NOT_BOUND,
                               "Dynamic line width state not set for this command buffer");
-    result |= validate_status(my_data, pCB, CBSTATUS_NONE, CBSTATUS_DEPTH_BIAS_SET, CBSTATUS_DEPTH_BIAS_SET,
+    result |= validate_status(my_data, commandBuffer, status, CBSTATUS_NONE, CBSTATUS_DEPTH_BIAS_SET, CBSTATUS_DEPTH_BIAS_SET,
                               VK_DEBUG_REPORT_ERROR_BIT_EXT, DRAWSTATE_DEPTH_BIAS_NOT_BOUND,
                               "Dynamic depth bias state not set for this command buffer");
-    result |= validate_status(my_data, pCB, CBSTATUS_COLOR_BLEND_WRITE_ENABLE, CBSTATUS_BLEND_SET, CBSTATUS_BLEND_SET,
-                              VK_DEBUG_REPORT_ERROR_BIT_EXT, DRAWSTATE_BLEND_NOT_BOUND,
+    result |= validate_status(my_data, commandBuffer, status, CBSTATUS_COLOR_BLEND_WRITE_ENABLE, CBSTATUS_BLEND_SET,
+                              CBSTATUS_BLEND_SET, VK_DEBUG_REPORT_ERROR_BIT_EXT, DRAWSTATE_BLEND_NOT_BOUND,
                               "Dynamic blend object state not set for this command buffer");
-    result |= validate_status(my_data, pCB, CBSTATUS_DEPTH_WRITE_ENABLE, CBSTATUS_DEPTH_BOUNDS_SET, CBSTATUS_DEPTH_BOUNDS_SET,
-                              VK_DEBUG_REPORT_ERROR_BIT_EXT, DRAWSTATE_DEPTH_BOUNDS_NOT_BOUND,
+    result |= validate_status(my_data, commandBuffer, status, CBSTATUS_DEPTH_WRITE_ENABLE, CBSTATUS_DEPTH_BOUNDS_SET,
+                              CBSTATUS_DEPTH_BOUNDS_SET, VK_DEBUG_REPORT_ERROR_BIT_EXT, DRAWSTATE_DEPTH_BOUNDS_NOT_BOUND,
                               "Dynamic depth bounds state not set for this command buffer");
-    result |= validate_status(my_data, pCB, CBSTATUS_STENCIL_TEST_ENABLE, CBSTATUS_STENCIL_READ_MASK_SET,
+    result |= validate_status(my_data, commandBuffer, status, CBSTATUS_STENCIL_TEST_ENABLE, CBSTATUS_STENCIL_READ_MASK_SET,
                               CBSTATUS_STENCIL_READ_MASK_SET, VK_DEBUG_REPORT_ERROR_BIT_EXT, DRAWSTATE_STENCIL_NOT_BOUND,
                               "Dynamic stencil read mask state not set for this command buffer");
-    result |= validate_status(my_data, pCB, CBSTATUS_STENCIL_TEST_ENABLE, CBSTATUS_STENCIL_WRITE_MASK_SET,
+    result |= validate_status(my_data, commandBuffer, status, CBSTATUS_STENCIL_TEST_ENABLE, CBSTATUS_STENCIL_WRITE_MASK_SET,
                               CBSTATUS_STENCIL_WRITE_MASK_SET, VK_DEBUG_REPORT_ERROR_BIT_EXT, DRAWSTATE_STENCIL_NOT_BOUND,
                               "Dynamic stencil write mask state not set for this command buffer");
-    result |= validate_status(my_data, pCB, CBSTATUS_STENCIL_TEST_ENABLE, CBSTATUS_STENCIL_REFERENCE_SET,
+    result |= validate_status(my_data, commandBuffer, status, CBSTATUS_STENCIL_TEST_ENABLE, CBSTATUS_STENCIL_REFERENCE_SET,
                               CBSTATUS_STENCIL_REFERENCE_SET, VK_DEBUG_REPORT_ERROR_BIT_EXT, DRAWSTATE_STENCIL_NOT_BOUND,
                               "Dynamic stencil reference state not set for this command buffer");
     if (indexedDraw)
-        result |= validate_status(my_data, pCB, CBSTATUS_NONE, CBSTATUS_INDEX_BUFFER_BOUND, CBSTATUS_INDEX_BUFFER_BOUND,
-                                  VK_DEBUG_REPORT_ERROR_BIT_EXT, DRAWSTATE_INDEX_BUFFER_NOT_BOUND,
+        result |= validate_status(my_data, commandBuffer, status, CBSTATUS_NONE, CBSTATUS_INDEX_BUFFER_BOUND,
+                                  CBSTATUS_INDEX_BUFFER_BOUND, VK_DEBUG_REPORT_ERROR_BIT_EXT, DRAWSTATE_INDEX_BUFFER_NOT_BOUND,
                                   "Index buffer object not bound to this command buffer when Indexed Draw attempted");
     return result;
 }
@@ -2352,7 +2376,7 @@ static bool verify_set_layout_compatibility(layer_data *my_data, const SET_NODE
         return false;
     }
     // Get the specific setLayout from PipelineLayout that overlaps this set
-    LAYOUT_NODE *pLayoutNode = my_data->descriptorSetLayoutMap[pipeline_layout_it->second.descriptorSetLayouts[layoutIndex]];
+    LAYOUT_NODE *pLayoutNode = my_data->descriptorSetLayoutMap.at(pipeline_layout_it->second.descriptorSetLayouts[layoutIndex]);
     if (pLayoutNode->layout == pSet->pLayout->layout) { // trivial pass case
         return true;
     }
@@ -2806,16 +2830,18 @@ static VkBool32 validate_pipeline_shaders(layer_data *my_data, VkDevice dev, PIP
 
 // Return Set node ptr for specified set or else NULL
 static SET_NODE *getSetNode(layer_data *my_data, const VkDescriptorSet set) {
-    if (my_data->setMap.find(set) == my_data->setMap.end()) {
+    auto set_data = my_data->setMap.find(set);
+    if (set_data == my_data->setMap.end()) {
         return NULL;
     }
-    return my_data->setMap[set];
+    return set_data->second;
 }
 // For the given command buffer, verify that for each set set in activeSetNodes
 //  that any dynamic descriptor in that set has a valid dynamic offset bound.
 //  To be valid, the dynamic offset combined with the offset and range from its
 //  descriptor update must not overflow the size of its buffer being updated
-static VkBool32 validate_dynamic_offsets(layer_data *my_data, const GLOBAL_CB_NODE *pCB, const vector<SET_NODE *> activeSetNodes) {
+static VkBool32 validate_dynamic_offsets(layer_data *my_data, const vector<uint32_t> &dynamicOffsets,
+                                         const vector<SET_NODE *> activeSetNodes) {
     VkBool32 result = VK_FALSE;
 
     VkWriteDescriptorSet *pWDS = NULL;
@@ -2831,8 +2857,8 @@ static VkBool32 validate_dynamic_offsets(layer_data *my_data, const GLOBAL_CB_NO
                     if ((pWDS->descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC) ||
                         (pWDS->descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC)) {
                         for (uint32_t j = 0; j < pWDS->descriptorCount; ++j) {
-                            bufferSize = my_data->bufferMap[pWDS->pBufferInfo[j].buffer].create_info->size;
-                            uint32_t dynOffset = pCB->lastBound[VK_PIPELINE_BIND_POINT_GRAPHICS].dynamicOffsets[dynOffsetIndex];
+                            bufferSize = my_data->bufferMap.at(pWDS->pBufferInfo[j].buffer).create_info->size;
+                            uint32_t dynOffset = dynamicOffsets[dynOffsetIndex];
                             if (pWDS->pBufferInfo[j].range == VK_WHOLE_SIZE) {
                                 if ((dynOffset + pWDS->pBufferInfo[j].offset) > bufferSize) {
                                     result |= log_msg(my_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT,
@@ -2843,8 +2869,8 @@ static VkBool32 validate_dynamic_offsets(layer_data *my_data, const GLOBAL_CB_NO
                                                       "VK_WHOLE_SIZE but dynamic offset %#" PRIxLEAST32 ". "
                                                       "combined with offset %#" PRIxLEAST64 " oversteps its buffer (%#" PRIxLEAST64
                                                       ") which has a size of %#" PRIxLEAST64 ".",
-                                                      reinterpret_cast<const uint64_t &>(set_node->set), i,
-                                                      pCB->dynamicOffsets[dynOffsetIndex], pWDS->pBufferInfo[j].offset,
+                                                      reinterpret_cast<const uint64_t &>(set_node->set), i, dynOffset,
+                                                      pWDS->pBufferInfo[j].offset,
                                                       reinterpret_cast<const uint64_t &>(pWDS->pBufferInfo[j].buffer), bufferSize);
                                 }
                             } else if ((dynOffset + pWDS->pBufferInfo[j].offset + pWDS->pBufferInfo[j].range) > bufferSize) {
@@ -2857,7 +2883,7 @@ static VkBool32 validate_dynamic_offsets(layer_data *my_data, const GLOBAL_CB_NO
                                     "Combined with offset %#" PRIxLEAST64 " and range %#" PRIxLEAST64
                                     " from its update, this oversteps its buffer "
                                     "(%#" PRIxLEAST64 ") which has a size of %#" PRIxLEAST64 ".",
-                                    reinterpret_cast<const uint64_t &>(set_node->set), i, pCB->dynamicOffsets[dynOffsetIndex],
+                                    reinterpret_cast<const uint64_t &>(set_node->set), i, dynOffset,
                                     pWDS->pBufferInfo[j].offset, pWDS->pBufferInfo[j].range,
                                     reinterpret_cast<const uint64_t &>(pWDS->pBufferInfo[j].buffer), bufferSize);
                             } else if ((dynOffset + pWDS->pBufferInfo[j].offset + pWDS->pBufferInfo[j].range) > bufferSize) {
@@ -2870,7 +2896,7 @@ static VkBool32 validate_dynamic_offsets(layer_data *my_data, const GLOBAL_CB_NO
                                     "Combined with offset %#" PRIxLEAST64 " and range %#" PRIxLEAST64
                                     " from its update, this oversteps its buffer "
                                     "(%#" PRIxLEAST64 ") which has a size of %#" PRIxLEAST64 ".",
-                                    reinterpret_cast<const uint64_t &>(set_node->set), i, pCB->dynamicOffsets[dynOffsetIndex],
+                                    reinterpret_cast<const uint64_t &>(set_node->set), i, dynOffset,
                                     pWDS->pBufferInfo[j].offset, pWDS->pBufferInfo[j].range,
                                     reinterpret_cast<const uint64_t &>(pWDS->pBufferInfo[j].buffer), bufferSize);
                             }
@@ -2891,16 +2917,15 @@ static VkBool32 validate_dynamic_offsets(layer_data *my_data, const GLOBAL_CB_NO
 }
 
 // Validate overall state at the time of a draw call
-static VkBool32 validate_draw_state(layer_data *my_data, GLOBAL_CB_NODE *pCB, VkBool32 indexedDraw) {
+static VkBool32 validate_draw_snapshot(layer_data *my_data, VkCommandBuffer commandBuffer, const DRAW_STATE_SNAPSHOT &state) {
     // First check flag states
-    VkBool32 result = validate_draw_state_flags(my_data, pCB, indexedDraw);
-    PIPELINE_NODE *pPipe = getPipeline(my_data, pCB->lastBound[VK_PIPELINE_BIND_POINT_GRAPHICS].pipeline);
+    VkBool32 result = validate_draw_state_flags(my_data, commandBuffer, state.status, state.indexed);
+    PIPELINE_NODE *pPipe = getPipeline(my_data, state.pipeline);
     // Now complete other state checks
     // TODO : Currently only performing next check if *something* was bound (non-zero last bound)
     //  There is probably a better way to gate when this check happens, and to know if something *should* have been bound
     //  We should have that check separately and then gate this check based on that check
     if (pPipe) {
-        auto const &state = pCB->lastBound[VK_PIPELINE_BIND_POINT_GRAPHICS];
         if (state.pipelineLayout) {
             string errorString;
             // Need a vector (vs. std::set) of active Sets for dynamicOffset validation in case same set bound w/ different offsets
@@ -2912,10 +2937,10 @@ static VkBool32 validate_draw_state(layer_data *my_data, GLOBAL_CB_NODE *pCB, Vk
                                       __LINE__, DRAWSTATE_DESCRIPTOR_SET_NOT_BOUND, "DS",
                                       "VkPipeline %#" PRIxLEAST64 " uses set #%u but that set is not bound.",
                                       (uint64_t)pPipe->pipeline, setIndex);
-                } else if (!verify_set_layout_compatibility(my_data, my_data->setMap[state.boundDescriptorSets[setIndex]],
+                } else if (!verify_set_layout_compatibility(my_data, my_data->setMap.at(state.boundDescriptorSets[setIndex]),
                                                             pPipe->graphicsPipelineCI.layout, setIndex, errorString)) {
                     // Set is bound but not compatible w/ overlapping pipelineLayout from PSO
-                    VkDescriptorSet setHandle = my_data->setMap[state.boundDescriptorSets[setIndex]]->set;
+                    VkDescriptorSet setHandle = my_data->setMap.at(state.boundDescriptorSets[setIndex])->set;
                     result |= log_msg(
                         my_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_DESCRIPTOR_SET_EXT,
                         (uint64_t)setHandle, __LINE__, DRAWSTATE_PIPELINE_LAYOUTS_INCOMPATIBLE, "DS",
@@ -2924,7 +2949,7 @@ static VkBool32 validate_draw_state(layer_data *my_data, GLOBAL_CB_NODE *pCB, Vk
                         (uint64_t)setHandle, setIndex, (uint64_t)pPipe->graphicsPipelineCI.layout, errorString.c_str());
                 } else { // Valid set is bound and layout compatible, validate that it's updated and verify any dynamic offsets
                     // Pull the set node
-                    SET_NODE *pSet = my_data->setMap[state.boundDescriptorSets[setIndex]];
+                    SET_NODE *pSet = my_data->setMap.at(state.boundDescriptorSets[setIndex]);
                     // Save vector of all active sets to verify dynamicOffsets below
                     activeSetNodes.push_back(pSet);
                     // Make sure set has been updated
@@ -2940,27 +2965,27 @@ static VkBool32 validate_draw_state(layer_data *my_data, GLOBAL_CB_NODE *pCB, Vk
             }
             // For each dynamic descriptor, make sure dynamic offset doesn't overstep buffer
             if (!state.dynamicOffsets.empty())
-                result |= validate_dynamic_offsets(my_data, pCB, activeSetNodes);
+                result |= validate_dynamic_offsets(my_data, state.dynamicOffsets, activeSetNodes);
         }
         // Verify Vtx binding
         if (pPipe->vertexBindingDescriptions.size() > 0) {
             for (size_t i = 0; i < pPipe->vertexBindingDescriptions.size(); i++) {
-                if ((pCB->currentDrawData.buffers.size() < (i + 1)) || (pCB->currentDrawData.buffers[i] == VK_NULL_HANDLE)) {
+                if ((state.vertexBuffers.size() < (i + 1)) || (state.vertexBuffers[i] == VK_NULL_HANDLE)) {
                     result |= log_msg(my_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, (VkDebugReportObjectTypeEXT)0, 0,
                                       __LINE__, DRAWSTATE_VTX_INDEX_OUT_OF_BOUNDS, "DS",
                                       "The Pipeline State Object (%#" PRIxLEAST64
                                       ") expects that this Command Buffer's vertex binding Index " PRINTF_SIZE_T_SPECIFIER
                                       " should be set via vkCmdBindVertexBuffers.",
-                                      (uint64_t)pCB->lastBound[VK_PIPELINE_BIND_POINT_GRAPHICS].pipeline, i);
+                                      (uint64_t)state.pipeline, i);
                 }
             }
         } else {
-            if (!pCB->currentDrawData.buffers.empty()) {
+            if (!state.vertexBuffers.empty()) {
                 result |= log_msg(my_data->report_data, VK_DEBUG_REPORT_PERFORMANCE_WARNING_BIT_EXT, (VkDebugReportObjectTypeEXT)0,
                                   0, __LINE__, DRAWSTATE_VTX_INDEX_OUT_OF_BOUNDS, "DS",
                                   "Vertex buffers are bound to command buffer (%#" PRIxLEAST64
                                   ") but no vertex buffers are attached to this Pipeline State Object (%#" PRIxLEAST64 ").",
-                                  (uint64_t)pCB->commandBuffer, (uint64_t)pCB->lastBound[VK_PIPELINE_BIND_POINT_GRAPHICS].pipeline);
+                                  (uint64_t)commandBuffer, (uint64_t)state.pipeline);
             }
         }
         // If Viewport or scissors are dynamic, verify that dynamic count matches PSO count.
@@ -2971,21 +2996,21 @@ static VkBool32 validate_draw_state(layer_data *my_data, GLOBAL_CB_NODE *pCB, Vk
             VkBool32 dynViewport = isDynamic(pPipe, VK_DYNAMIC_STATE_VIEWPORT);
             VkBool32 dynScissor = isDynamic(pPipe, VK_DYNAMIC_STATE_SCISSOR);
             if (dynViewport) {
-                if (pCB->viewports.size() != pPipe->graphicsPipelineCI.pViewportState->viewportCount) {
+                if (state.viewportCount != pPipe->graphicsPipelineCI.pViewportState->viewportCount) {
                     result |= log_msg(my_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, (VkDebugReportObjectTypeEXT)0, 0,
                                       __LINE__, DRAWSTATE_VIEWPORT_SCISSOR_MISMATCH, "DS",
                                       "Dynamic viewportCount from vkCmdSetViewport() is " PRINTF_SIZE_T_SPECIFIER
                                       ", but PSO viewportCount is %u. These counts must match.",
-                                      pCB->viewports.size(), pPipe->graphicsPipelineCI.pViewportState->viewportCount);
+                                      state.viewportCount, pPipe->graphicsPipelineCI.pViewportState->viewportCount);
                 }
             }
             if (dynScissor) {
-                if (pCB->scissors.size() != pPipe->graphicsPipelineCI.pViewportState->scissorCount) {
+                if (state.scissorCount != pPipe->graphicsPipelineCI.pViewportState->scissorCount) {
                     result |= log_msg(my_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, (VkDebugReportObjectTypeEXT)0, 0,
                                       __LINE__, DRAWSTATE_VIEWPORT_SCISSOR_MISMATCH, "DS",
                                       "Dynamic scissorCount from vkCmdSetScissor() is " PRINTF_SIZE_T_SPECIFIER
                                       ", but PSO scissorCount is %u. These counts must match.",
-                                      pCB->scissors.size(), pPipe->graphicsPipelineCI.pViewportState->scissorCount);
+                                      state.scissorCount, pPipe->graphicsPipelineCI.pViewportState->scissorCount);
                 }
             }
         }
@@ -2993,6 +3018,68 @@ static VkBool32 validate_draw_state(layer_data *my_data, GLOBAL_CB_NODE *pCB, Vk
     return result;
 }
 
+// Return true if the draw-time state of pCB is the state recorded in snapshot
+static bool draw_state_matches(const GLOBAL_CB_NODE *pCB, VkBool32 indexedDraw, const DRAW_STATE_SNAPSHOT &snapshot) {
+    auto const &state = pCB->lastBound[VK_PIPELINE_BIND_POINT_GRAPHICS];
+    return snapshot.indexed == indexedDraw && snapshot.status == pCB->status && snapshot.pipeline == state.pipeline &&
+           snapshot.pipelineLayout == state.pipelineLayout && snapshot.viewportCount == pCB->viewports.size() &&
+           snapshot.scissorCount == pCB->scissors.size() && snapshot.boundDescriptorSets == state.boundDescriptorSets &&
+           snapshot.dynamicOffsets == state.dynamicOffsets && snapshot.vertexBuffers == pCB->currentDrawData.buffers;
+}
+
+static void capture_draw_state(const GLOBAL_CB_NODE *pCB, VkBool32 indexedDraw, DRAW_STATE_SNAPSHOT *pSnapshot) {
+    auto const &state = pCB->lastBound[VK_PIPELINE_BIND_POINT_GRAPHICS];
+    pSnapshot->indexed = indexedDraw;
+    pSnapshot->status = pCB->status;
+    pSnapshot->pipeline = state.pipeline;
+    pSnapshot->pipelineLayout = state.pipelineLayout;
+    pSnapshot->boundDescriptorSets = state.boundDescriptorSets;
+    pSnapshot->dynamicOffsets = state.dynamicOffsets;
+    pSnapshot->vertexBuffers = pCB->currentDrawData.buffers;
+    pSnapshot->viewportCount = pCB->viewports.size();
+    pSnapshot->scissorCount = pCB->scissors.size();
+}
+
+// Validate draw-time state according to the device's validation level. At VALIDATION_LEVEL_DEFERRED the state is
+//  only recorded, and only when it differs from the previous draw in this cmd buffer, to be checked at vkQueueSubmit
+static VkBool32 validate_draw_state(layer_data *my_data, GLOBAL_CB_NODE *pCB, VkBool32 indexedDraw) {
+    VkBool32 result = VK_FALSE;
+    switch (my_data->validationLevel) {
+    case VALIDATION_LEVEL_FULL: {
+        DRAW_STATE_SNAPSHOT state;
+        capture_draw_state(pCB, indexedDraw, &state);
+        result = validate_draw_snapshot(my_data, pCB->commandBuffer, state);
+        break;
+    }
+    case VALIDATION_LEVEL_DEFERRED:
+        if (pCB->deferredDrawStates.empty() || !draw_state_matches(pCB, indexedDraw, pCB->deferredDrawStates.back())) {
+            pCB->deferredDrawStates.emplace_back();
+            capture_draw_state(pCB, indexedDraw, &pCB->deferredDrawStates.back());
+        }
+        break;
+    case VALIDATION_LEVEL_MINIMAL:
+        break;
+    }
+    return result;
+}
+
+// Check the draw states recorded in pCB at VALIDATION_LEVEL_DEFERRED. Anything that could change the result of a check
+//  also invalidates the cmd buffer, so the states are dropped once a submit has checked them without failing.
+static VkBool32 validate_deferred_draw_states(layer_data *my_data, GLOBAL_CB_NODE *pCB) {
+    VkBool32 result = VK_FALSE;
+    if (pCB->state == CB_INVALID)
+        return result;
+    for (auto const &state : pCB->deferredDrawStates) {
+        // A set freed since the draw was recorded leaves nothing to check against
+        if (std::all_of(state.boundDescriptorSets.begin(), state.boundDescriptorSets.end(),
+                        [my_data](VkDescriptorSet set) { return !set || getSetNode(my_data, set); }))
+            result |= validate_draw_snapshot(my_data, pCB->commandBuffer, state);
+    }
+    if (VK_FALSE == result)
+        pCB->deferredDrawStates.clear();
+    return result;
+}
+
 // Verify that create state for a pipeline is valid
 static VkBool32 verifyPipelineCreateState(layer_data *my_data, const VkDevice device, std::vector<PIPELINE_NODE *> pPipelines,
                                           int pipelineIndex) {
@@ -3307,7 +3394,7 @@ static void deletePipelines(layer_data *my_data) {
 
 // For given pipeline, return number of MSAA samples, or one if MSAA disabled
 static VkSampleCountFlagBits getNumSamples(layer_data *my_data, const VkPipeline pipeline) {
-    PIPELINE_NODE *pPipe = my_data->pipelineMap[pipeline];
+    PIPELINE_NODE *pPipe = getPipeline(my_data, pipeline);
     if (VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO == pPipe->msStateCI.sType) {
         return pPipe->msStateCI.rasterizationSamples;
     }
@@ -3320,12 +3407,12 @@ static VkBool32 validatePipelineState(layer_data *my_data, const GLOBAL_CB_NODE
     if (VK_PIPELINE_BIND_POINT_GRAPHICS == pipelineBindPoint) {
         // Verify that any MSAA request in PSO matches sample# in bound FB
         // Skip the check if rasterization is disabled.
-        PIPELINE_NODE *pPipeline = my_data->pipelineMap[pipeline];
+        PIPELINE_NODE *pPipeline = my_data->pipelineMap.at(pipeline);
         if (!pPipeline->graphicsPipelineCI.pRasterizationState ||
             !pPipeline->graphicsPipelineCI.pRasterizationState->rasterizerDiscardEnable) {
             VkSampleCountFlagBits psoNumSamples = getNumSamples(my_data, pipeline);
             if (pCB->activeRenderPass) {
-                const VkRenderPassCreateInfo *pRPCI = my_data->renderPassMap[pCB->activeRenderPass]->pCreateInfo;
+                const VkRenderPassCreateInfo *pRPCI = my_data->renderPassMap.at(pCB->activeRenderPass)->pCreateInfo;
                 const VkSubpassDescription *pSD = &pRPCI->pSubpasses[pCB->activeSubpass];
                 VkSampleCountFlagBits subpassNumSamples = (VkSampleCountFlagBits)0;
                 uint32_t i;
@@ -3382,10 +3469,11 @@ static DESCRIPTOR_POOL_NODE *getPoolNode(layer_data *my_data, const VkDescriptor
 }
 
 static LAYOUT_NODE *getLayoutNode(layer_data *my_data, const VkDescriptorSetLayout layout) {
-    if (my_data->descriptorSetLayoutMap.find(layout) == my_data->descriptorSetLayoutMap.end()) {
+    auto layout_data = my_data->descriptorSetLayoutMap.find(layout);
+    if (layout_data == my_data->descriptorSetLayoutMap.end()) {
         return NULL;
     }
-    return my_data->descriptorSetLayoutMap[layout];
+    return layout_data->second;
 }
 
 // Return VK_FALSE if update struct is of valid type, otherwise flag error and return code from callback
@@ -4276,14 +4364,16 @@ static void clearDescriptorPool(layer_data *my_data, const VkDevice device, cons
 }
 
 // For given CB object, fetch associated CB Node from map
+//  Uses find() rather than operator[], which may insert, as recording only holds globalLock shared
 static GLOBAL_CB_NODE *getCBNode(layer_data *my_data, const VkCommandBuffer cb) {
-    if (my_data->commandBufferMap.count(cb) == 0) {
+    auto cb_data = my_data->commandBufferMap.find(cb);
+    if (cb_data == my_data->commandBufferMap.end()) {
         log_msg(my_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_COMMAND_BUFFER_EXT,
                 reinterpret_cast<const uint64_t &>(cb), __LINE__, DRAWSTATE_INVALID_COMMAND_BUFFER, "DS",
                 "Attempt to use CommandBuffer %#" PRIxLEAST64 " that doesn't exist!", (uint64_t)(cb));
         return NULL;
     }
-    return my_data->commandBufferMap[cb];
+    return cb_data->second;
 }
 
 // Free all CB Nodes
@@ -4472,6 +4562,7 @@ static void resetCB(layer_data *my_data, const VkCommandBuffer cb) {
         pCB->secondaryCommandBuffers.clear();
         pCB->activeDescriptorSets.clear();
         pCB->validate_functions.clear();
+        pCB->deferredDrawStates.clear();
         pCB->pMemObjList.clear();
         pCB->eventUpdates.clear();
     }
@@ -4605,12 +4696,25 @@ static VkBool32 outsideRenderPass(const layer_data *my_data, GLOBAL_CB_NODE *pCB
     return outside;
 }
 
+// Read lunarg_core_validation.validation_level from the layer settings, defaulting to full validation
+static VALIDATION_LEVEL getValidationLevel() {
+    const char *level = getLayerOption("lunarg_core_validation.validation_level");
+    if (level) {
+        if (!strcmp(level, "minimal"))
+            return VALIDATION_LEVEL_MINIMAL;
+        if (!strcmp(level, "deferred"))
+            return VALIDATION_LEVEL_DEFERRED;
+    }
+    return VALIDATION_LEVEL_FULL;
+}
+
 static void init_core_validation(layer_data *my_data, const VkAllocationCallbacks *pAllocator) {
 
     layer_debug_actions(my_data->report_data, my_data->logging_callback, pAllocator, "lunarg_core_validation");
+    profiler.init("lunarg_core_validation");
 
     if (!globalLockInitialized) {
-        loader_platform_thread_create_mutex(&globalLock);
+        loader_platform_thread_create_rwlock(&globalLock);
         globalLockInitialized = 1;
     }
 #if MTMERGESOURCE
@@ -4660,7 +4764,9 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkDestroyInstance(VkInstance instance
     VkLayerInstanceDispatchTable *pTable = my_data->instance_dispatch_table;
     pTable->DestroyInstance(instance, pAllocator);
 
-    loader_platform_thread_lock_mutex(&globalLock);
+    profiler.dump();
+
+    loader_platform_thread_write_lock(&globalLock);
     // Clean up logging callback, if any
     while (my_data->logging_callback.size() > 0) {
         VkDebugReportCallbackEXT callback = my_data->logging_callback.back();
@@ -4671,10 +4777,10 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkDestroyInstance(VkInstance instance
     layer_debug_report_destroy_instance(my_data->report_data);
     delete my_data->instance_dispatch_table;
     layer_data_map.erase(key);
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (layer_data_map.empty()) {
         // Release mutex when destroying last instance.        
-        loader_platform_thread_delete_mutex(&globalLock);
+        loader_platform_thread_delete_rwlock(&globalLock);
         globalLockInitialized = 0;
     }
 }
@@ -4720,7 +4826,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateDevice(VkPhysicalDevice g
         return result;
     }
 
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     layer_data *my_instance_data = get_my_data_ptr(get_dispatch_key(gpu), layer_data_map);
     layer_data *my_device_data = get_my_data_ptr(get_dispatch_key(*pDevice), layer_data_map);
 
@@ -4730,6 +4836,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateDevice(VkPhysicalDevice g
 
     my_device_data->report_data = layer_debug_report_create_device(my_instance_data->report_data, *pDevice);
     createDeviceRegisterExtensions(pCreateInfo, *pDevice);
+    my_device_data->validationLevel = getValidationLevel();
     // Get physical device limits for this device
     my_instance_data->instance_dispatch_table->GetPhysicalDeviceProperties(gpu, &(my_device_data->physDevProperties.properties));
     uint32_t count;
@@ -4743,7 +4850,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateDevice(VkPhysicalDevice g
     } else {
         memset(&my_device_data->physDevProperties.features, 0, sizeof(VkPhysicalDeviceFeatures));
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 
     ValidateLayerOrdering(*pCreateInfo);
 
@@ -4757,7 +4864,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkDestroyDevice(VkDevice device, cons
     dispatch_key key = get_dispatch_key(device);
     layer_data *dev_data = get_my_data_ptr(key, layer_data_map);
     // Free all the memory
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     deletePipelines(dev_data);
     deleteRenderPasses(dev_data);
     deleteCommandBuffers(dev_data);
@@ -4769,10 +4876,10 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkDestroyDevice(VkDevice device, cons
     dev_data->imageLayoutMap.clear();
     dev_data->bufferViewMap.clear();
     dev_data->bufferMap.clear();
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 #if MTMERGESOURCE
     VkBool32 skipCall = VK_FALSE;
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     log_msg(dev_data->report_data, VK_DEBUG_REPORT_INFORMATION_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_DEVICE_EXT,
             (uint64_t)device, __LINE__, MEMTRACK_NONE, "MEM", "Printing List details prior to vkDestroyDevice()");
     log_msg(dev_data->report_data, VK_DEBUG_REPORT_INFORMATION_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_DEVICE_EXT,
@@ -4799,7 +4906,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkDestroyDevice(VkDevice device, cons
     // Queues persist until device is destroyed
     delete_queue_info_list(dev_data);
     layer_debug_report_destroy_device(device);
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 
 #if DISPATCH_MAP_DEBUG
     fprintf(stderr, "Device: %p, key: %p\n", device, key);
@@ -5183,10 +5290,12 @@ static bool validateCommandBufferState(layer_data *dev_data, GLOBAL_CB_NODE *pCB
 static VkBool32 validatePrimaryCommandBufferState(layer_data *dev_data, GLOBAL_CB_NODE *pCB) {
     // Track in-use for resources off of primary and any secondary CBs
     VkBool32 skipCall = validateAndIncrementResources(dev_data, pCB);
+    skipCall |= validate_deferred_draw_states(dev_data, pCB);
     if (!pCB->secondaryCommandBuffers.empty()) {
         for (auto secondaryCmdBuffer : pCB->secondaryCommandBuffers) {
             skipCall |= validateAndIncrementResources(dev_data, dev_data->commandBufferMap[secondaryCmdBuffer]);
             GLOBAL_CB_NODE *pSubCB = getCBNode(dev_data, secondaryCmdBuffer);
+            skipCall |= validate_deferred_draw_states(dev_data, pSubCB);
             if (pSubCB->primaryCommandBuffer != pCB->commandBuffer) {
                 log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_COMMAND_BUFFER_EXT, 0,
                         __LINE__, DRAWSTATE_COMMAND_BUFFER_SINGLE_SUBMIT_VIOLATION, "DS",
@@ -5217,11 +5326,12 @@ static VkBool32 validatePrimaryCommandBufferState(layer_data *dev_data, GLOBAL_C
 
 VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL
 vkQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *pSubmits, VkFence fence) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     VkBool32 skipCall = VK_FALSE;
     GLOBAL_CB_NODE *pCBNode = NULL;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(queue), layer_data_map);
     VkResult result = VK_ERROR_VALIDATION_FAILED_EXT;
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
 #if MTMERGESOURCE
     // TODO : Need to track fence and clear mem references when fence clears
     // MTMTODO : Merge this code with code below to avoid duplicating efforts
@@ -5327,11 +5437,11 @@ vkQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *pSubmits,
     }
     // Update cmdBuffer-related data structs and mark fence in-use
     trackCommandBuffers(dev_data, queue, submitCount, pSubmits, fence);
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         result = dev_data->device_dispatch_table->QueueSubmit(queue, submitCount, pSubmits, fence);
 #if MTMERGESOURCE
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     for (uint32_t submit_idx = 0; submit_idx < submitCount; submit_idx++) {
         const VkSubmitInfo *submit = &pSubmits[submit_idx];
         for (uint32_t i = 0; i < submit->waitSemaphoreCount; i++) {
@@ -5342,7 +5452,7 @@ vkQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *pSubmits,
             }
         }
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 #endif
     return result;
 }
@@ -5353,10 +5463,10 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkAllocateMemory(VkDevice device,
     layer_data *my_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     VkResult result = my_data->device_dispatch_table->AllocateMemory(device, pAllocateInfo, pAllocator, pMemory);
     // TODO : Track allocations and overall size here
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     add_mem_obj_info(my_data, device, *pMemory, pAllocateInfo);
     print_mem_list(my_data, device);
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     return result;
 }
 
@@ -5371,11 +5481,11 @@ vkFreeMemory(VkDevice device, VkDeviceMemory mem, const VkAllocationCallbacks *p
     // buffers (on host or device) for anything other than destroying those objects will result in
     // undefined behavior.
 
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     freeMemObjInfo(my_data, device, mem, VK_FALSE);
     print_mem_list(my_data, device);
     printCBList(my_data, device);
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     my_data->device_dispatch_table->FreeMemory(device, mem, pAllocator);
 }
 
@@ -5542,18 +5652,18 @@ vkWaitForFences(VkDevice device, uint32_t fenceCount, const VkFence *pFences, Vk
     VkBool32 skip_call = VK_FALSE;
 #if MTMERGESOURCE
     // Verify fence status of submitted fences
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     for (uint32_t i = 0; i < fenceCount; i++) {
         skip_call |= verifyFenceStatus(device, pFences[i], "vkWaitForFences");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (skip_call)
         return VK_ERROR_VALIDATION_FAILED_EXT;
 #endif
     VkResult result = dev_data->device_dispatch_table->WaitForFences(device, fenceCount, pFences, waitAll, timeout);
     
     if (result == VK_SUCCESS) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         // When we know that all fences are complete we can clean/remove their CBs
         if (waitAll || fenceCount == 1) {
             for (uint32_t i = 0; i < fenceCount; ++i) {
@@ -5571,7 +5681,7 @@ vkWaitForFences(VkDevice device, uint32_t fenceCount, const VkFence *pFences, Vk
         // NOTE : Alternate case not handled here is when some fences have completed. In
         //  this case for app to guarantee which fences completed it will have to call
         //  vkGetFenceStatus() at which point we'll clean/remove their CBs if complete.
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     if (VK_FALSE != skip_call)
         return VK_ERROR_VALIDATION_FAILED_EXT;
@@ -5583,15 +5693,15 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkGetFenceStatus(VkDevice device,
     bool skipCall = false;
     VkResult result = VK_ERROR_VALIDATION_FAILED_EXT;
 #if MTMERGESOURCE
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     skipCall = verifyFenceStatus(device, fence, "vkGetFenceStatus");
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (skipCall)
         return result;
 #endif
     result = dev_data->device_dispatch_table->GetFenceStatus(device, fence);
     VkBool32 skip_call = VK_FALSE;
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     if (result == VK_SUCCESS) {
 #if MTMERGESOURCE
         update_fence_tracking(dev_data, fence);
@@ -5603,7 +5713,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkGetFenceStatus(VkDevice device,
         }
         decrementResources(dev_data, 1, &fence);
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (VK_FALSE != skip_call)
         return VK_ERROR_VALIDATION_FAILED_EXT;
     return result;
@@ -5613,7 +5723,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkGetDeviceQueue(VkDevice device, uint32_t queueFamilyIndex, uint32_t queueIndex, VkQueue *pQueue) {
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     dev_data->device_dispatch_table->GetDeviceQueue(device, queueFamilyIndex, queueIndex, pQueue);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     dev_data->queues.push_back(*pQueue);
     QUEUE_NODE *pQNode = &dev_data->queueMap[*pQueue];
     pQNode->device = device;
@@ -5621,14 +5731,14 @@ vkGetDeviceQueue(VkDevice device, uint32_t queueFamilyIndex, uint32_t queueIndex
     pQNode->lastRetiredId = 0;
     pQNode->lastSubmittedId = 0;
 #endif
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 }
 
 VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkQueueWaitIdle(VkQueue queue) {
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(queue), layer_data_map);
     decrementResources(dev_data, queue);
     VkBool32 skip_call = VK_FALSE;
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     // Iterate over local set since we erase set members as we go in for loop
     auto local_cb_set = dev_data->queueMap[queue].inFlightCmdBuffers;
     for (auto cmdBuffer : local_cb_set) {
@@ -5636,15 +5746,15 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkQueueWaitIdle(VkQueue queue) {
         removeInFlightCmdBuffer(dev_data, cmdBuffer, queue);
     }
     dev_data->queueMap[queue].inFlightCmdBuffers.clear();
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (VK_FALSE != skip_call)
         return VK_ERROR_VALIDATION_FAILED_EXT;
     VkResult result = dev_data->device_dispatch_table->QueueWaitIdle(queue);
 #if MTMERGESOURCE
     if (VK_SUCCESS == result) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         retire_queue_fences(dev_data, queue);
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
 #endif
     return result;
@@ -5653,7 +5763,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkQueueWaitIdle(VkQueue queue) {
 VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkDeviceWaitIdle(VkDevice device) {
     VkBool32 skip_call = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     for (auto queue : dev_data->queues) {
         decrementResources(dev_data, queue);
         if (dev_data->queueMap.find(queue) != dev_data->queueMap.end()) {
@@ -5665,15 +5775,15 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkDeviceWaitIdle(VkDevice device)
         skip_call |= cleanInFlightCmdBuffer(dev_data, cmdBuffer);
     }
     dev_data->globalInFlightCmdBuffers.clear();
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (VK_FALSE != skip_call)
         return VK_ERROR_VALIDATION_FAILED_EXT;
     VkResult result = dev_data->device_dispatch_table->DeviceWaitIdle(device);
 #if MTMERGESOURCE
     if (VK_SUCCESS == result) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         retire_device_fences(dev_data, device);
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
 #endif
     return result;
@@ -5682,7 +5792,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkDeviceWaitIdle(VkDevice device)
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkDestroyFence(VkDevice device, VkFence fence, const VkAllocationCallbacks *pAllocator) {
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     bool skipCall = false;
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     if (dev_data->fenceMap[fence].in_use.load()) {
         skipCall |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_FENCE_EXT,
                             (uint64_t)(fence), __LINE__, DRAWSTATE_INVALID_FENCE, "DS",
@@ -5695,7 +5805,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkDestroyFence(VkDevice device, VkFen
         dev_data->fenceMap.erase(item);
     }
 #endif
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (!skipCall)
         dev_data->device_dispatch_table->DestroyFence(device, fence, pAllocator);
 }
@@ -5704,7 +5814,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkDestroySemaphore(VkDevice device, VkSemaphore semaphore, const VkAllocationCallbacks *pAllocator) {
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     dev_data->device_dispatch_table->DestroySemaphore(device, semaphore, pAllocator);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     auto item = dev_data->semaphoreMap.find(semaphore);
     if (item != dev_data->semaphoreMap.end()) {
         if (item->second.in_use.load()) {
@@ -5714,14 +5824,14 @@ vkDestroySemaphore(VkDevice device, VkSemaphore semaphore, const VkAllocationCal
         }
         dev_data->semaphoreMap.erase(semaphore);
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     // TODO : Clean up any internal data structures using this obj.
 }
 
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkDestroyEvent(VkDevice device, VkEvent event, const VkAllocationCallbacks *pAllocator) {
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     bool skip_call = false;
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     auto event_data = dev_data->eventMap.find(event);
     if (event_data != dev_data->eventMap.end()) {
         if (event_data->second.in_use.load()) {
@@ -5732,7 +5842,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkDestroyEvent(VkDevice device, VkEve
         }
         dev_data->eventMap.erase(event_data);
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (!skip_call)
         dev_data->device_dispatch_table->DestroyEvent(device, event, pAllocator);
     // TODO : Clean up any internal data structures using this obj.
@@ -5751,7 +5861,7 @@ VKAPI_ATTR VkResult VKAPI_CALL vkGetQueryPoolResults(VkDevice device, VkQueryPoo
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     unordered_map<QueryObject, vector<VkCommandBuffer>> queriesInFlight;
     GLOBAL_CB_NODE *pCB = nullptr;
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     for (auto cmdBuffer : dev_data->globalInFlightCmdBuffers) {
         pCB = getCBNode(dev_data, cmdBuffer);
         for (auto queryStatePair : pCB->queryToStateMap) {
@@ -5811,7 +5921,7 @@ VKAPI_ATTR VkResult VKAPI_CALL vkGetQueryPoolResults(VkDevice device, VkQueryPoo
                                  (uint64_t)(queryPool), firstQuery + i);
         }
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (skip_call)
         return VK_ERROR_VALIDATION_FAILED_EXT;
     return dev_data->device_dispatch_table->GetQueryPoolResults(device, queryPool, firstQuery, queryCount, dataSize, pData, stride,
@@ -5839,7 +5949,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkDestroyBuffer(VkDevice device, VkBuffer buffer, const VkAllocationCallbacks *pAllocator) {
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     VkBool32 skipCall = VK_FALSE;
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
 #if MTMERGESOURCE
     auto item = dev_data->bufferBindingMap.find((uint64_t)buffer);
     if (item != dev_data->bufferBindingMap.end()) {
@@ -5848,42 +5958,42 @@ vkDestroyBuffer(VkDevice device, VkBuffer buffer, const VkAllocationCallbacks *p
     }
 #endif
     if (!validateIdleBuffer(dev_data, buffer) && (VK_FALSE == skipCall)) {
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
         dev_data->device_dispatch_table->DestroyBuffer(device, buffer, pAllocator);
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
     }
     dev_data->bufferMap.erase(buffer);
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 }
 
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkDestroyBufferView(VkDevice device, VkBufferView bufferView, const VkAllocationCallbacks *pAllocator) {
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     dev_data->device_dispatch_table->DestroyBufferView(device, bufferView, pAllocator);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     auto item = dev_data->bufferViewMap.find(bufferView);
     if (item != dev_data->bufferViewMap.end()) {
         dev_data->bufferViewMap.erase(item);
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 }
 
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkDestroyImage(VkDevice device, VkImage image, const VkAllocationCallbacks *pAllocator) {
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     VkBool32 skipCall = VK_FALSE;
 #if MTMERGESOURCE
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     auto item = dev_data->imageBindingMap.find((uint64_t)image);
     if (item != dev_data->imageBindingMap.end()) {
         skipCall = clear_object_binding(dev_data, device, (uint64_t)image, VK_DEBUG_REPORT_OBJECT_TYPE_IMAGE_EXT);
         dev_data->imageBindingMap.erase(item);
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 #endif
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->DestroyImage(device, image, pAllocator);
 
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     const auto& entry = dev_data->imageMap.find(image);
     if (entry != dev_data->imageMap.end()) {
         // Clear any memory mapping for this image
@@ -5901,7 +6011,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkDestroyImage(VkDevice device, VkIma
         }
         dev_data->imageSubresourceMap.erase(subEntry);
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 }
 #if MTMERGESOURCE
 VkBool32 print_memory_range_error(layer_data *dev_data, const uint64_t object_handle, const uint64_t other_handle,
@@ -5949,7 +6059,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL
 vkBindBufferMemory(VkDevice device, VkBuffer buffer, VkDeviceMemory mem, VkDeviceSize memoryOffset) {
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     VkResult result = VK_ERROR_VALIDATION_FAILED_EXT;
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     // Track objects tied to memory
     uint64_t buffer_handle = (uint64_t)(buffer);
     VkBool32 skipCall =
@@ -5964,7 +6074,7 @@ vkBindBufferMemory(VkDevice device, VkBuffer buffer, VkDeviceMemory mem, VkDevic
                                                    VK_DEBUG_REPORT_OBJECT_TYPE_BUFFER_EXT);
     }
     print_mem_list(dev_data, device);
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (VK_FALSE == skipCall) {
         result = dev_data->device_dispatch_table->BindBufferMemory(device, buffer, mem, memoryOffset);
     }
@@ -5998,11 +6108,11 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkDestroyShaderModule(VkDevice device, VkShaderModule shaderModule, const VkAllocationCallbacks *pAllocator) {
     layer_data *my_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
 
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
 
     my_data->shaderModuleMap.erase(shaderModule);
 
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 
     my_data->device_dispatch_table->DestroyShaderModule(device, shaderModule, pAllocator);
 }
@@ -6045,7 +6155,7 @@ vkFreeCommandBuffers(VkDevice device, VkCommandPool commandPool, uint32_t comman
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
 
     bool skip_call = false;
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     for (uint32_t i = 0; i < commandBufferCount; i++) {
 #if MTMERGESOURCE
         clear_cmd_buf_and_mem_references(dev_data, pCommandBuffers[i]);
@@ -6072,7 +6182,7 @@ vkFreeCommandBuffers(VkDevice device, VkCommandPool commandPool, uint32_t comman
 #if MTMERGESOURCE
     printCBList(dev_data, device);
 #endif
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 
     if (!skip_call)
         dev_data->device_dispatch_table->FreeCommandBuffers(device, commandPool, commandBufferCount, pCommandBuffers);
@@ -6086,10 +6196,10 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateCommandPool(VkDevice devi
     VkResult result = dev_data->device_dispatch_table->CreateCommandPool(device, pCreateInfo, pAllocator, pCommandPool);
 
     if (VK_SUCCESS == result) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         dev_data->commandPoolMap[*pCommandPool].createFlags = pCreateInfo->flags;
         dev_data->commandPoolMap[*pCommandPool].queueFamilyIndex = pCreateInfo->queueFamilyIndex;
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
@@ -6100,9 +6210,9 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateQueryPool(VkDevice device
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     VkResult result = dev_data->device_dispatch_table->CreateQueryPool(device, pCreateInfo, pAllocator, pQueryPool);
     if (result == VK_SUCCESS) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         dev_data->queryPoolMap[*pQueryPool].createInfo = *pCreateInfo;
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
@@ -6130,7 +6240,7 @@ vkDestroyCommandPool(VkDevice device, VkCommandPool commandPool, const VkAllocat
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     bool commandBufferComplete = false;
     bool skipCall = false;
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
 #if MTMERGESOURCE
     // Verify that command buffers in pool are complete (not in-flight)
     // MTMTODO : Merge this with code below (separate *NotInUse() call)
@@ -6160,7 +6270,7 @@ vkDestroyCommandPool(VkDevice device, VkCommandPool commandPool, const VkAllocat
     }
     dev_data->commandPoolMap.erase(commandPool);
 
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 
     if (VK_TRUE == validateCommandBuffersNotInUse(dev_data, commandPool))
         return;
@@ -6168,7 +6278,7 @@ vkDestroyCommandPool(VkDevice device, VkCommandPool commandPool, const VkAllocat
     if (!skipCall)
         dev_data->device_dispatch_table->DestroyCommandPool(device, commandPool, pAllocator);
 #if MTMERGESOURCE
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     auto item = dev_data->commandPoolMap[commandPool].commandBuffers.begin();
     // Remove command buffers from command buffer map
     while (item != dev_data->commandPoolMap[commandPool].commandBuffers.end()) {
@@ -6176,7 +6286,7 @@ vkDestroyCommandPool(VkDevice device, VkCommandPool commandPool, const VkAllocat
         delete_cmd_buf_info(dev_data, commandPool, *del_item);
     }
     dev_data->commandPoolMap.erase(commandPool);
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 #endif
 }
 
@@ -6188,7 +6298,7 @@ vkResetCommandPool(VkDevice device, VkCommandPool commandPool, VkCommandPoolRese
     VkResult result = VK_ERROR_VALIDATION_FAILED_EXT;
 #if MTMERGESOURCE
     // MTMTODO : Merge this with *NotInUse() call below
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     auto it = dev_data->commandPoolMap[commandPool].commandBuffers.begin();
     // Verify that CB's in pool are complete (not in-flight)
     while (it != dev_data->commandPoolMap[commandPool].commandBuffers.end()) {
@@ -6205,7 +6315,7 @@ vkResetCommandPool(VkDevice device, VkCommandPool commandPool, VkCommandPoolRese
         }
         ++it;
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 #endif
     if (VK_TRUE == validateCommandBuffersNotInUse(dev_data, commandPool))
         return VK_ERROR_VALIDATION_FAILED_EXT;
@@ -6215,13 +6325,13 @@ vkResetCommandPool(VkDevice device, VkCommandPool commandPool, VkCommandPoolRese
 
     // Reset all of the CBs allocated from this pool
     if (VK_SUCCESS == result) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         auto it = dev_data->commandPoolMap[commandPool].commandBuffers.begin();
         while (it != dev_data->commandPoolMap[commandPool].commandBuffers.end()) {
             resetCB(dev_data, (*it));
             ++it;
         }
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
@@ -6230,7 +6340,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkResetFences(VkDevice device, ui
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     VkResult result = VK_ERROR_VALIDATION_FAILED_EXT;
     bool skipCall = false;
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     for (uint32_t i = 0; i < fenceCount; ++i) {
 #if MTMERGESOURCE
         // Reset fence state in fenceCreateInfo structure
@@ -6256,7 +6366,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkResetFences(VkDevice device, ui
                         "Fence %#" PRIx64 " is in use by a command buffer.", reinterpret_cast<const uint64_t &>(pFences[i]));
         }
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (!skipCall)
         result = dev_data->device_dispatch_table->ResetFences(device, fenceCount, pFences);
     return result;
@@ -6272,14 +6382,14 @@ vkDestroyFramebuffer(VkDevice device, VkFramebuffer framebuffer, const VkAllocat
             if (cbNode != dev_data->commandBufferMap.end()) {
                 // Set CB as invalid and record destroyed framebuffer
                 cbNode->second->state = CB_INVALID;
-                loader_platform_thread_lock_mutex(&globalLock);
+                loader_platform_thread_write_lock(&globalLock);
                 cbNode->second->destroyedFramebuffers.insert(framebuffer);
-                loader_platform_thread_unlock_mutex(&globalLock);
+                loader_platform_thread_write_unlock(&globalLock);
             }
         }
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         dev_data->frameBufferMap.erase(framebuffer);
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     dev_data->device_dispatch_table->DestroyFramebuffer(device, framebuffer, pAllocator);
 }
@@ -6288,9 +6398,9 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkDestroyRenderPass(VkDevice device, VkRenderPass renderPass, const VkAllocationCallbacks *pAllocator) {
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     dev_data->device_dispatch_table->DestroyRenderPass(device, renderPass, pAllocator);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     dev_data->renderPassMap.erase(renderPass);
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 }
 
 VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateBuffer(VkDevice device, const VkBufferCreateInfo *pCreateInfo,
@@ -6300,14 +6410,14 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateBuffer(VkDevice device, c
     VkResult result = dev_data->device_dispatch_table->CreateBuffer(device, pCreateInfo, pAllocator, pBuffer);
 
     if (VK_SUCCESS == result) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
 #if MTMERGESOURCE
         add_object_create_info(dev_data, (uint64_t)*pBuffer, VK_DEBUG_REPORT_OBJECT_TYPE_BUFFER_EXT, pCreateInfo);
 #endif
         // TODO : This doesn't create deep copy of pQueueFamilyIndices so need to fix that if/when we want that data to be valid
         dev_data->bufferMap[*pBuffer].create_info = unique_ptr<VkBufferCreateInfo>(new VkBufferCreateInfo(*pCreateInfo));
         dev_data->bufferMap[*pBuffer].in_use.store(0);
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
@@ -6317,7 +6427,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateBufferView(VkDevice devic
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     VkResult result = dev_data->device_dispatch_table->CreateBufferView(device, pCreateInfo, pAllocator, pView);
     if (VK_SUCCESS == result) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         dev_data->bufferViewMap[*pView] = VkBufferViewCreateInfo(*pCreateInfo);
 #if MTMERGESOURCE
         // In order to create a valid buffer view, the buffer must have been created with at least one of the
@@ -6326,7 +6436,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateBufferView(VkDevice devic
                                     VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT, VK_FALSE,
                                     "vkCreateBufferView()", "VK_BUFFER_USAGE_[STORAGE|UNIFORM]_TEXEL_BUFFER_BIT");
 #endif
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
@@ -6338,7 +6448,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateImage(VkDevice device, co
     VkResult result = dev_data->device_dispatch_table->CreateImage(device, pCreateInfo, pAllocator, pImage);
 
     if (VK_SUCCESS == result) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
 #if MTMERGESOURCE
         add_object_create_info(dev_data, (uint64_t)*pImage, VK_DEBUG_REPORT_OBJECT_TYPE_IMAGE_EXT, pCreateInfo);
 #endif
@@ -6349,7 +6459,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateImage(VkDevice device, co
         ImageSubresourcePair subpair = {*pImage, false, VkImageSubresource()};
         dev_data->imageSubresourceMap[*pImage].push_back(subpair);
         dev_data->imageLayoutMap[subpair] = image_node;
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
@@ -6397,7 +6507,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateImageView(VkDevice device
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     VkResult result = dev_data->device_dispatch_table->CreateImageView(device, pCreateInfo, pAllocator, pView);
     if (VK_SUCCESS == result) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         VkImageViewCreateInfo localCI = VkImageViewCreateInfo(*pCreateInfo);
         ResolveRemainingLevelsLayers(dev_data, &localCI.subresourceRange, pCreateInfo->image);
         dev_data->imageViewMap[*pView] = localCI;
@@ -6408,7 +6518,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateImageView(VkDevice device
                                        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
                                    VK_FALSE, "vkCreateImageView()", "VK_IMAGE_USAGE_[SAMPLED|STORAGE|COLOR_ATTACHMENT]_BIT");
 #endif
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
@@ -6418,7 +6528,7 @@ vkCreateFence(VkDevice device, const VkFenceCreateInfo *pCreateInfo, const VkAll
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     VkResult result = dev_data->device_dispatch_table->CreateFence(device, pCreateInfo, pAllocator, pFence);
     if (VK_SUCCESS == result) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         FENCE_NODE *pFN = &dev_data->fenceMap[*pFence];
 #if MTMERGESOURCE
         memset(pFN, 0, sizeof(MT_FENCE_INFO));
@@ -6428,7 +6538,7 @@ vkCreateFence(VkDevice device, const VkFenceCreateInfo *pCreateInfo, const VkAll
         }
 #endif
         pFN->in_use.store(0);
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
@@ -6465,6 +6575,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL
 vkCreateGraphicsPipelines(VkDevice device, VkPipelineCache pipelineCache, uint32_t count,
                           const VkGraphicsPipelineCreateInfo *pCreateInfos, const VkAllocationCallbacks *pAllocator,
                           VkPipeline *pPipelines) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     VkResult result = VK_SUCCESS;
     // TODO What to do with pipelineCache?
     // The order of operations here is a little convoluted but gets the job done
@@ -6477,7 +6588,7 @@ vkCreateGraphicsPipelines(VkDevice device, VkPipelineCache pipelineCache, uint32
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
 
     uint32_t i = 0;
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
 
     for (i = 0; i < count; i++) {
         pPipeNode[i] = initGraphicsPipeline(dev_data, &pCreateInfos[i]);
@@ -6485,20 +6596,20 @@ vkCreateGraphicsPipelines(VkDevice device, VkPipelineCache pipelineCache, uint32
     }
 
     if (VK_FALSE == skipCall) {
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
         result = dev_data->device_dispatch_table->CreateGraphicsPipelines(device, pipelineCache, count, pCreateInfos, pAllocator,
                                                                           pPipelines);
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         for (i = 0; i < count; i++) {
             pPipeNode[i]->pipeline = pPipelines[i];
             dev_data->pipelineMap[pPipeNode[i]->pipeline] = pPipeNode[i];
         }
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     } else {
         for (i = 0; i < count; i++) {
             delete pPipeNode[i];
         }
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
         return VK_ERROR_VALIDATION_FAILED_EXT;
     }
     return result;
@@ -6516,7 +6627,7 @@ vkCreateComputePipelines(VkDevice device, VkPipelineCache pipelineCache, uint32_
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
 
     uint32_t i = 0;
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     for (i = 0; i < count; i++) {
         // TODO: Verify compute stage bits
 
@@ -6529,21 +6640,21 @@ vkCreateComputePipelines(VkDevice device, VkPipelineCache pipelineCache, uint32_
     }
 
     if (VK_FALSE == skipCall) {
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
         result = dev_data->device_dispatch_table->CreateComputePipelines(device, pipelineCache, count, pCreateInfos, pAllocator,
                                                                          pPipelines);
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         for (i = 0; i < count; i++) {
             pPipeNode[i]->pipeline = pPipelines[i];
             dev_data->pipelineMap[pPipeNode[i]->pipeline] = pPipeNode[i];
         }
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     } else {
         for (i = 0; i < count; i++) {
             // Clean up any locally allocated data structures
             delete pPipeNode[i];
         }
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
         return VK_ERROR_VALIDATION_FAILED_EXT;
     }
     return result;
@@ -6554,9 +6665,9 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateSampler(VkDevice device,
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     VkResult result = dev_data->device_dispatch_table->CreateSampler(device, pCreateInfo, pAllocator, pSampler);
     if (VK_SUCCESS == result) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         dev_data->sampleMap[*pSampler] = unique_ptr<SAMPLER_NODE>(new SAMPLER_NODE(pSampler, pCreateInfo));
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
@@ -6626,9 +6737,9 @@ vkCreateDescriptorSetLayout(VkDevice device, const VkDescriptorSetLayoutCreateIn
             pNewNode->endIndex = 0;
         }
         // Put new node at Head of global Layer list
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         dev_data->descriptorSetLayoutMap[*pSetLayout] = pNewNode;
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
@@ -6664,7 +6775,7 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreatePipelineLayout(VkDevice device, const VkP
     }
     VkResult result = dev_data->device_dispatch_table->CreatePipelineLayout(device, pCreateInfo, pAllocator, pPipelineLayout);
     if (VK_SUCCESS == result) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         // TODOSC : Merge capture of the setLayouts per pipeline
         PIPELINE_LAYOUT_NODE &plNode = dev_data->pipelineLayoutMap[*pPipelineLayout];
         plNode.descriptorSetLayouts.resize(pCreateInfo->setLayoutCount);
@@ -6675,7 +6786,7 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreatePipelineLayout(VkDevice device, const VkP
         for (i = 0; i < pCreateInfo->pushConstantRangeCount; ++i) {
             plNode.pushConstantRanges[i] = pCreateInfo->pPushConstantRanges[i];
         }
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
@@ -6698,9 +6809,9 @@ vkCreateDescriptorPool(VkDevice device, const VkDescriptorPoolCreateInfo *pCreat
                         "Out of memory while attempting to allocate DESCRIPTOR_POOL_NODE in vkCreateDescriptorPool()"))
                 return VK_ERROR_VALIDATION_FAILED_EXT;
         } else {
-            loader_platform_thread_lock_mutex(&globalLock);
+            loader_platform_thread_write_lock(&globalLock);
             dev_data->descriptorPoolMap[*pDescriptorPool] = pNewNode;
-            loader_platform_thread_unlock_mutex(&globalLock);
+            loader_platform_thread_write_unlock(&globalLock);
         }
     } else {
         // Need to do anything if pool create fails?
@@ -6713,19 +6824,20 @@ vkResetDescriptorPool(VkDevice device, VkDescriptorPool descriptorPool, VkDescri
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     VkResult result = dev_data->device_dispatch_table->ResetDescriptorPool(device, descriptorPool, flags);
     if (VK_SUCCESS == result) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         clearDescriptorPool(dev_data, device, descriptorPool, flags);
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
 
 VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL
 vkAllocateDescriptorSets(VkDevice device, const VkDescriptorSetAllocateInfo *pAllocateInfo, VkDescriptorSet *pDescriptorSets) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
 
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     // Verify that requested descriptorSets are available in pool
     DESCRIPTOR_POOL_NODE *pPoolNode = getPoolNode(dev_data, pAllocateInfo->descriptorPool);
     if (!pPoolNode) {
@@ -6737,12 +6849,12 @@ vkAllocateDescriptorSets(VkDevice device, const VkDescriptorSetAllocateInfo *pAl
         skipCall |= validate_descriptor_availability_in_pool(dev_data, pPoolNode, pAllocateInfo->descriptorSetCount,
                                                              pAllocateInfo->pSetLayouts);
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (skipCall)
         return VK_ERROR_VALIDATION_FAILED_EXT;
     VkResult result = dev_data->device_dispatch_table->AllocateDescriptorSets(device, pAllocateInfo, pDescriptorSets);
     if (VK_SUCCESS == result) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         DESCRIPTOR_POOL_NODE *pPoolNode = getPoolNode(dev_data, pAllocateInfo->descriptorPool);
         if (pPoolNode) {
             if (pAllocateInfo->descriptorSetCount == 0) {
@@ -6793,7 +6905,7 @@ vkAllocateDescriptorSets(VkDevice device, const VkDescriptorSetAllocateInfo *pAl
                 }
             }
         }
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
@@ -6803,7 +6915,7 @@ vkFreeDescriptorSets(VkDevice device, VkDescriptorPool descriptorPool, uint32_t
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     // Make sure that no sets being destroyed are in-flight
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     for (uint32_t i = 0; i < count; ++i)
         skipCall |= validateIdleDescriptorSet(dev_data, pDescriptorSets[i], "vkFreeDesriptorSets");
     DESCRIPTOR_POOL_NODE *pPoolNode = getPoolNode(dev_data, descriptorPool);
@@ -6814,12 +6926,12 @@ vkFreeDescriptorSets(VkDevice device, VkDescriptorPool descriptorPool, uint32_t
                             "It is invalid to call vkFreeDescriptorSets() with a pool created without setting "
                             "VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT.");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (VK_FALSE != skipCall)
         return VK_ERROR_VALIDATION_FAILED_EXT;
     VkResult result = dev_data->device_dispatch_table->FreeDescriptorSets(device, descriptorPool, count, pDescriptorSets);
     if (VK_SUCCESS == result) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
 
         // Update available descriptor sets in pool
         pPoolNode->availableSets += count;
@@ -6836,7 +6948,7 @@ vkFreeDescriptorSets(VkDevice device, VkDescriptorPool descriptorPool, uint32_t
                 pPoolNode->availableDescriptorTypeCount[typeIndex] += poolSizeCount;
             }
         }
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     // TODO : Any other clean-up or book-keeping to do here?
     return result;
@@ -6845,9 +6957,10 @@ vkFreeDescriptorSets(VkDevice device, VkDescriptorPool descriptorPool, uint32_t
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkUpdateDescriptorSets(VkDevice device, uint32_t descriptorWriteCount, const VkWriteDescriptorSet *pDescriptorWrites,
                        uint32_t descriptorCopyCount, const VkCopyDescriptorSet *pDescriptorCopies) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     // dsUpdate will return VK_TRUE only if a bailout error occurs, so we want to call down tree when update returns VK_FALSE
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
 #if MTMERGESOURCE
     // MTMTODO : Merge this in with existing update code below and handle descriptor copies case
     uint32_t j = 0;
@@ -6872,7 +6985,7 @@ vkUpdateDescriptorSets(VkDevice device, uint32_t descriptorWriteCount, const VkW
     }
 #endif
     VkBool32 rtn = dsUpdate(dev_data, device, descriptorWriteCount, pDescriptorWrites, descriptorCopyCount, pDescriptorCopies);
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (!rtn) {
         dev_data->device_dispatch_table->UpdateDescriptorSets(device, descriptorWriteCount, pDescriptorWrites, descriptorCopyCount,
                                                               pDescriptorCopies);
@@ -6884,7 +6997,7 @@ vkAllocateCommandBuffers(VkDevice device, const VkCommandBufferAllocateInfo *pCr
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     VkResult result = dev_data->device_dispatch_table->AllocateCommandBuffers(device, pCreateInfo, pCommandBuffer);
     if (VK_SUCCESS == result) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         auto const &cp_it = dev_data->commandPoolMap.find(pCreateInfo->commandPool);
         if (cp_it != dev_data->commandPoolMap.end()) {
             for (uint32_t i = 0; i < pCreateInfo->commandBufferCount; i++) {
@@ -6901,16 +7014,17 @@ vkAllocateCommandBuffers(VkDevice device, const VkCommandBufferAllocateInfo *pCr
 #if MTMERGESOURCE
         printCBList(dev_data, device);
 #endif
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
 
 VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL
 vkBeginCommandBuffer(VkCommandBuffer commandBuffer, const VkCommandBufferBeginInfo *pBeginInfo) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     // Validate command buffer level
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
@@ -7035,24 +7149,25 @@ vkBeginCommandBuffer(VkCommandBuffer commandBuffer, const VkCommandBufferBeginIn
                             (uint64_t)commandBuffer, __LINE__, DRAWSTATE_INVALID_COMMAND_BUFFER, "DS",
                             "In vkBeginCommandBuffer() and unable to find CommandBuffer Node for CB %p!", (void *)commandBuffer);
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (VK_FALSE != skipCall) {
         return VK_ERROR_VALIDATION_FAILED_EXT;
     }
     VkResult result = dev_data->device_dispatch_table->BeginCommandBuffer(commandBuffer, pBeginInfo);
 #if MTMERGESOURCE
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     clear_cmd_buf_and_mem_references(dev_data, commandBuffer);
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 #endif
     return result;
 }
 
 VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEndCommandBuffer(VkCommandBuffer commandBuffer) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     VkBool32 skipCall = VK_FALSE;
     VkResult result = VK_SUCCESS;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         if (pCB->state != CB_RECORDING) {
@@ -7066,9 +7181,9 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEndCommandBuffer(VkCommandBuffe
         }
     }
     if (VK_FALSE == skipCall) {
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_read_unlock(&globalLock);
         result = dev_data->device_dispatch_table->EndCommandBuffer(commandBuffer);
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_read_lock(&globalLock);
         if (VK_SUCCESS == result) {
             pCB->state = CB_RECORDED;
             // Reset CB status flags
@@ -7078,7 +7193,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkEndCommandBuffer(VkCommandBuffe
     } else {
         result = VK_ERROR_VALIDATION_FAILED_EXT;
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     return result;
 }
 
@@ -7086,7 +7201,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL
 vkResetCommandBuffer(VkCommandBuffer commandBuffer, VkCommandBufferResetFlags flags) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
 #if MTMERGESOURCE
     bool commandBufferComplete = false;
     // Verify that CB is complete (not in-flight)
@@ -7116,14 +7231,14 @@ vkResetCommandBuffer(VkCommandBuffer commandBuffer, VkCommandBufferResetFlags fl
                             "Attempt to reset command buffer (%#" PRIxLEAST64 ") which is in use.",
                             reinterpret_cast<uint64_t>(commandBuffer));
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (skipCall != VK_FALSE)
         return VK_ERROR_VALIDATION_FAILED_EXT;
     VkResult result = dev_data->device_dispatch_table->ResetCommandBuffer(commandBuffer, flags);
     if (VK_SUCCESS == result) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         resetCB(dev_data, commandBuffer);
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
@@ -7133,9 +7248,10 @@ vkResetCommandBuffer(VkCommandBuffer commandBuffer, VkCommandBufferResetFlags fl
 #endif
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdBindPipeline(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint, VkPipeline pipeline) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         skipCall |= addCmd(dev_data, pCB, CMD_BINDPIPELINE, "vkCmdBindPipeline()");
@@ -7158,7 +7274,7 @@ vkCmdBindPipeline(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBin
                                 "Attempt to bind Pipeline %#" PRIxLEAST64 " that doesn't exist!", (uint64_t)(pipeline));
         }
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdBindPipeline(commandBuffer, pipelineBindPoint, pipeline);
 }
@@ -7167,7 +7283,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdSetViewport(VkCommandBuffer commandBuffer, uint32_t firstViewport, uint32_t viewportCount, const VkViewport *pViewports) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         skipCall |= addCmd(dev_data, pCB, CMD_SETVIEWPORTSTATE, "vkCmdSetViewport()");
@@ -7175,7 +7291,7 @@ vkCmdSetViewport(VkCommandBuffer commandBuffer, uint32_t firstViewport, uint32_t
         pCB->viewports.resize(viewportCount);
         memcpy(pCB->viewports.data(), pViewports, viewportCount * sizeof(VkViewport));
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdSetViewport(commandBuffer, firstViewport, viewportCount, pViewports);
 }
@@ -7184,7 +7300,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdSetScissor(VkCommandBuffer commandBuffer, uint32_t firstScissor, uint32_t scissorCount, const VkRect2D *pScissors) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         skipCall |= addCmd(dev_data, pCB, CMD_SETSCISSORSTATE, "vkCmdSetScissor()");
@@ -7192,7 +7308,7 @@ vkCmdSetScissor(VkCommandBuffer commandBuffer, uint32_t firstScissor, uint32_t s
         pCB->scissors.resize(scissorCount);
         memcpy(pCB->scissors.data(), pScissors, scissorCount * sizeof(VkRect2D));
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdSetScissor(commandBuffer, firstScissor, scissorCount, pScissors);
 }
@@ -7200,13 +7316,13 @@ vkCmdSetScissor(VkCommandBuffer commandBuffer, uint32_t firstScissor, uint32_t s
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdSetLineWidth(VkCommandBuffer commandBuffer, float lineWidth) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         skipCall |= addCmd(dev_data, pCB, CMD_SETLINEWIDTHSTATE, "vkCmdSetLineWidth()");
         pCB->status |= CBSTATUS_LINE_WIDTH_SET;
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdSetLineWidth(commandBuffer, lineWidth);
 }
@@ -7215,13 +7331,13 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdSetDepthBias(VkCommandBuffer commandBuffer, float depthBiasConstantFactor, float depthBiasClamp, float depthBiasSlopeFactor) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         skipCall |= addCmd(dev_data, pCB, CMD_SETDEPTHBIASSTATE, "vkCmdSetDepthBias()");
         pCB->status |= CBSTATUS_DEPTH_BIAS_SET;
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdSetDepthBias(commandBuffer, depthBiasConstantFactor, depthBiasClamp,
                                                          depthBiasSlopeFactor);
@@ -7230,13 +7346,13 @@ vkCmdSetDepthBias(VkCommandBuffer commandBuffer, float depthBiasConstantFactor,
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdSetBlendConstants(VkCommandBuffer commandBuffer, const float blendConstants[4]) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         skipCall |= addCmd(dev_data, pCB, CMD_SETBLENDSTATE, "vkCmdSetBlendConstants()");
         pCB->status |= CBSTATUS_BLEND_SET;
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdSetBlendConstants(commandBuffer, blendConstants);
 }
@@ -7245,13 +7361,13 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdSetDepthBounds(VkCommandBuffer commandBuffer, float minDepthBounds, float maxDepthBounds) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         skipCall |= addCmd(dev_data, pCB, CMD_SETDEPTHBOUNDSSTATE, "vkCmdSetDepthBounds()");
         pCB->status |= CBSTATUS_DEPTH_BOUNDS_SET;
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdSetDepthBounds(commandBuffer, minDepthBounds, maxDepthBounds);
 }
@@ -7260,13 +7376,13 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdSetStencilCompareMask(VkCommandBuffer commandBuffer, VkStencilFaceFlags faceMask, uint32_t compareMask) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         skipCall |= addCmd(dev_data, pCB, CMD_SETSTENCILREADMASKSTATE, "vkCmdSetStencilCompareMask()");
         pCB->status |= CBSTATUS_STENCIL_READ_MASK_SET;
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdSetStencilCompareMask(commandBuffer, faceMask, compareMask);
 }
@@ -7275,13 +7391,13 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdSetStencilWriteMask(VkCommandBuffer commandBuffer, VkStencilFaceFlags faceMask, uint32_t writeMask) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         skipCall |= addCmd(dev_data, pCB, CMD_SETSTENCILWRITEMASKSTATE, "vkCmdSetStencilWriteMask()");
         pCB->status |= CBSTATUS_STENCIL_WRITE_MASK_SET;
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdSetStencilWriteMask(commandBuffer, faceMask, writeMask);
 }
@@ -7290,13 +7406,13 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdSetStencilReference(VkCommandBuffer commandBuffer, VkStencilFaceFlags faceMask, uint32_t reference) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         skipCall |= addCmd(dev_data, pCB, CMD_SETSTENCILREFERENCESTATE, "vkCmdSetStencilReference()");
         pCB->status |= CBSTATUS_STENCIL_REFERENCE_SET;
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdSetStencilReference(commandBuffer, faceMask, reference);
 }
@@ -7305,9 +7421,10 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdBindDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint, VkPipelineLayout layout,
                         uint32_t firstSet, uint32_t setCount, const VkDescriptorSet *pDescriptorSets, uint32_t dynamicOffsetCount,
                         const uint32_t *pDynamicOffsets) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
 #if MTMERGESOURCE
     // MTMTODO : Merge this with code below
     auto cb_data = dev_data->commandBufferMap.find(commandBuffer);
@@ -7337,7 +7454,9 @@ vkCmdBindDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipel
                 SET_NODE *pSet = getSetNode(dev_data, pDescriptorSets[i]);
                 if (pSet) {
                     pCB->lastBound[pipelineBindPoint].uniqueBoundSets.insert(pDescriptorSets[i]);
+                    loader_platform_thread_lock_mutex(&dev_data->setLock);
                     pSet->boundCmdBuffers.insert(commandBuffer);
+                    loader_platform_thread_unlock_mutex(&dev_data->setLock);
                     pCB->lastBound[pipelineBindPoint].pipelineLayout = layout;
                     pCB->lastBound[pipelineBindPoint].boundDescriptorSets[i + firstSet] = pDescriptorSets[i];
                     skipCall |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_INFORMATION_BIT_EXT,
@@ -7425,7 +7544,7 @@ vkCmdBindDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipel
                     for (uint32_t i = 0; i < firstSet; ++i) {
                         if (pCB->lastBound[pipelineBindPoint].boundDescriptorSets[i] &&
                             !verify_set_layout_compatibility(
-                                dev_data, dev_data->setMap[pCB->lastBound[pipelineBindPoint].boundDescriptorSets[i]], layout, i,
+                                dev_data, dev_data->setMap.at(pCB->lastBound[pipelineBindPoint].boundDescriptorSets[i]), layout, i,
                                 errorString)) {
                             skipCall |= log_msg(
                                 dev_data->report_data, VK_DEBUG_REPORT_PERFORMANCE_WARNING_BIT_EXT,
@@ -7441,7 +7560,7 @@ vkCmdBindDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipel
                 // Check if newly last bound set invalidates any remaining bound sets
                 if ((pCB->lastBound[pipelineBindPoint].boundDescriptorSets.size() - 1) > (lastSetIndex)) {
                     if (oldFinalBoundSet &&
-                        !verify_set_layout_compatibility(dev_data, dev_data->setMap[oldFinalBoundSet], layout, lastSetIndex,
+                        !verify_set_layout_compatibility(dev_data, dev_data->setMap.at(oldFinalBoundSet), layout, lastSetIndex,
                                                          errorString)) {
                         skipCall |=
                             log_msg(dev_data->report_data, VK_DEBUG_REPORT_PERFORMANCE_WARNING_BIT_EXT,
@@ -7487,7 +7606,7 @@ vkCmdBindDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipel
             skipCall |= report_error_no_cb_begin(dev_data, commandBuffer, "vkCmdBindDescriptorSets()");
         }
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdBindDescriptorSets(commandBuffer, pipelineBindPoint, layout, firstSet, setCount,
                                                                pDescriptorSets, dynamicOffsetCount, pDynamicOffsets);
@@ -7495,9 +7614,10 @@ vkCmdBindDescriptorSets(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipel
 
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdBindIndexBuffer(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
 #if MTMERGESOURCE
     VkDeviceMemory mem;
     skipCall =
@@ -7532,7 +7652,7 @@ vkCmdBindIndexBuffer(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSiz
         }
         pCB->status |= CBSTATUS_INDEX_BUFFER_BOUND;
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdBindIndexBuffer(commandBuffer, buffer, offset, indexType);
 }
@@ -7552,9 +7672,10 @@ void updateResourceTrackingOnDraw(GLOBAL_CB_NODE *pCB) { pCB->drawData.push_back
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdBindVertexBuffers(VkCommandBuffer commandBuffer, uint32_t firstBinding,
                                                                   uint32_t bindingCount, const VkBuffer *pBuffers,
                                                                   const VkDeviceSize *pOffsets) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
 #if MTMERGESOURCE
     for (uint32_t i = 0; i < bindingCount; ++i) {
         VkDeviceMemory mem;
@@ -7576,7 +7697,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdBindVertexBuffers(VkCommandBuffe
     } else {
         skipCall |= report_error_no_cb_begin(dev_data, commandBuffer, "vkCmdBindVertexBuffer()");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdBindVertexBuffers(commandBuffer, firstBinding, bindingCount, pBuffers, pOffsets);
 }
@@ -7627,9 +7748,10 @@ bool markStoreImagesAndBuffersAsWritten(VkCommandBuffer commandBuffer) {
 
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdDraw(VkCommandBuffer commandBuffer, uint32_t vertexCount, uint32_t instanceCount,
                                                      uint32_t firstVertex, uint32_t firstInstance) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
 #if MTMERGESOURCE
     // MTMTODO : merge with code below
     skipCall = markStoreImagesAndBuffersAsWritten(commandBuffer);
@@ -7649,7 +7771,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdDraw(VkCommandBuffer commandBuff
         }
         skipCall |= outsideRenderPass(dev_data, pCB, "vkCmdDraw");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdDraw(commandBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
 }
@@ -7657,9 +7779,10 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdDraw(VkCommandBuffer commandBuff
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdDrawIndexed(VkCommandBuffer commandBuffer, uint32_t indexCount,
                                                             uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset,
                                                             uint32_t firstInstance) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
     VkBool32 skipCall = VK_FALSE;
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
 #if MTMERGESOURCE
     // MTMTODO : merge with code below
     skipCall = markStoreImagesAndBuffersAsWritten(commandBuffer);
@@ -7679,7 +7802,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdDrawIndexed(VkCommandBuffer comm
         }
         skipCall |= outsideRenderPass(dev_data, pCB, "vkCmdDrawIndexed");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdDrawIndexed(commandBuffer, indexCount, instanceCount, firstIndex, vertexOffset,
                                                         firstInstance);
@@ -7687,9 +7810,10 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdDrawIndexed(VkCommandBuffer comm
 
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdDrawIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, uint32_t count, uint32_t stride) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
     VkBool32 skipCall = VK_FALSE;
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
 #if MTMERGESOURCE
     VkDeviceMemory mem;
     // MTMTODO : merge with code below
@@ -7713,16 +7837,17 @@ vkCmdDrawIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize o
         }
         skipCall |= outsideRenderPass(dev_data, pCB, "vkCmdDrawIndirect");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdDrawIndirect(commandBuffer, buffer, offset, count, stride);
 }
 
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdDrawIndexedIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, uint32_t count, uint32_t stride) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
 #if MTMERGESOURCE
     VkDeviceMemory mem;
     // MTMTODO : merge with code below
@@ -7735,9 +7860,7 @@ vkCmdDrawIndexedIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDevic
     if (pCB) {
         skipCall |= addCmd(dev_data, pCB, CMD_DRAWINDEXEDINDIRECT, "vkCmdDrawIndexedIndirect()");
         pCB->drawCount[DRAW_INDEXED_INDIRECT]++;
-        loader_platform_thread_unlock_mutex(&globalLock);
         skipCall |= validate_draw_state(dev_data, pCB, VK_TRUE);
-        loader_platform_thread_lock_mutex(&globalLock);
         // TODO : Need to pass commandBuffer as srcObj here
         skipCall |=
             log_msg(dev_data->report_data, VK_DEBUG_REPORT_INFORMATION_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_COMMAND_BUFFER_EXT, 0,
@@ -7749,15 +7872,16 @@ vkCmdDrawIndexedIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDevic
         }
         skipCall |= outsideRenderPass(dev_data, pCB, "vkCmdDrawIndexedIndirect");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdDrawIndexedIndirect(commandBuffer, buffer, offset, count, stride);
 }
 
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdDispatch(VkCommandBuffer commandBuffer, uint32_t x, uint32_t y, uint32_t z) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
 #if MTMERGESOURCE
     skipCall = markStoreImagesAndBuffersAsWritten(commandBuffer);
 #endif
@@ -7766,7 +7890,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdDispatch(VkCommandBuffer command
         skipCall |= addCmd(dev_data, pCB, CMD_DISPATCH, "vkCmdDispatch()");
         skipCall |= insideRenderPass(dev_data, pCB, "vkCmdDispatch");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdDispatch(commandBuffer, x, y, z);
 }
@@ -7775,7 +7899,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdDispatchIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
 #if MTMERGESOURCE
     VkDeviceMemory mem;
     skipCall =
@@ -7788,20 +7912,20 @@ vkCmdDispatchIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSi
         skipCall |= addCmd(dev_data, pCB, CMD_DISPATCHINDIRECT, "vkCmdDispatchIndirect()");
         skipCall |= insideRenderPass(dev_data, pCB, "vkCmdDispatchIndirect");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdDispatchIndirect(commandBuffer, buffer, offset);
 }
 
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdCopyBuffer(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer,
                                                            uint32_t regionCount, const VkBufferCopy *pRegions) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
 #if MTMERGESOURCE
     VkDeviceMemory mem;
     auto cb_data = dev_data->commandBufferMap.find(commandBuffer);
-    loader_platform_thread_lock_mutex(&globalLock);
     skipCall =
         get_mem_binding_from_object(dev_data, commandBuffer, (uint64_t)srcBuffer, VK_DEBUG_REPORT_OBJECT_TYPE_BUFFER_EXT, &mem);
     if (cb_data != dev_data->commandBufferMap.end()) {
@@ -7830,7 +7954,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdCopyBuffer(VkCommandBuffer comma
         skipCall |= addCmd(dev_data, pCB, CMD_COPYBUFFER, "vkCmdCopyBuffer()");
         skipCall |= insideRenderPass(dev_data, pCB, "vkCmdCopyBuffer");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, regionCount, pRegions);
 }
@@ -7915,9 +8039,10 @@ VkBool32 VerifyDestImageLayout(VkCommandBuffer cmdBuffer, VkImage destImage, VkI
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdCopyImage(VkCommandBuffer commandBuffer, VkImage srcImage, VkImageLayout srcImageLayout, VkImage dstImage,
                VkImageLayout dstImageLayout, uint32_t regionCount, const VkImageCopy *pRegions) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
 #if MTMERGESOURCE
     VkDeviceMemory mem;
     auto cb_data = dev_data->commandBufferMap.find(commandBuffer);
@@ -7952,7 +8077,7 @@ vkCmdCopyImage(VkCommandBuffer commandBuffer, VkImage srcImage, VkImageLayout sr
             skipCall |= VerifyDestImageLayout(commandBuffer, dstImage, pRegions[i].dstSubresource, dstImageLayout);
         }
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdCopyImage(commandBuffer, srcImage, srcImageLayout, dstImage, dstImageLayout,
                                                       regionCount, pRegions);
@@ -7963,7 +8088,7 @@ vkCmdBlitImage(VkCommandBuffer commandBuffer, VkImage srcImage, VkImageLayout sr
                VkImageLayout dstImageLayout, uint32_t regionCount, const VkImageBlit *pRegions, VkFilter filter) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
 #if MTMERGESOURCE
     VkDeviceMemory mem;
     auto cb_data = dev_data->commandBufferMap.find(commandBuffer);
@@ -7994,7 +8119,7 @@ vkCmdBlitImage(VkCommandBuffer commandBuffer, VkImage srcImage, VkImageLayout sr
         skipCall |= addCmd(dev_data, pCB, CMD_BLITIMAGE, "vkCmdBlitImage()");
         skipCall |= insideRenderPass(dev_data, pCB, "vkCmdBlitImage");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdBlitImage(commandBuffer, srcImage, srcImageLayout, dstImage, dstImageLayout,
                                                       regionCount, pRegions, filter);
@@ -8005,7 +8130,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdCopyBufferToImage(VkCommandBuffe
                                                                   uint32_t regionCount, const VkBufferImageCopy *pRegions) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
 #if MTMERGESOURCE
     VkDeviceMemory mem;
     auto cb_data = dev_data->commandBufferMap.find(commandBuffer);
@@ -8039,7 +8164,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdCopyBufferToImage(VkCommandBuffe
             skipCall |= VerifyDestImageLayout(commandBuffer, dstImage, pRegions[i].imageSubresource, dstImageLayout);
         }
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdCopyBufferToImage(commandBuffer, srcBuffer, dstImage, dstImageLayout, regionCount,
                                                               pRegions);
@@ -8050,7 +8175,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdCopyImageToBuffer(VkCommandBuffe
                                                                   uint32_t regionCount, const VkBufferImageCopy *pRegions) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
 #if MTMERGESOURCE
     VkDeviceMemory mem;
     auto cb_data = dev_data->commandBufferMap.find(commandBuffer);
@@ -8085,7 +8210,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdCopyImageToBuffer(VkCommandBuffe
             skipCall |= VerifySourceImageLayout(commandBuffer, srcImage, pRegions[i].imageSubresource, srcImageLayout);
         }
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdCopyImageToBuffer(commandBuffer, srcImage, srcImageLayout, dstBuffer, regionCount,
                                                               pRegions);
@@ -8095,7 +8220,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdUpdateBuffer(VkCommandBuffer com
                                                              VkDeviceSize dstOffset, VkDeviceSize dataSize, const uint32_t *pData) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
 #if MTMERGESOURCE
     VkDeviceMemory mem;
     auto cb_data = dev_data->commandBufferMap.find(commandBuffer);
@@ -8118,7 +8243,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdUpdateBuffer(VkCommandBuffer com
         skipCall |= addCmd(dev_data, pCB, CMD_UPDATEBUFFER, "vkCmdUpdateBuffer()");
         skipCall |= insideRenderPass(dev_data, pCB, "vkCmdCopyUpdateBuffer");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdUpdateBuffer(commandBuffer, dstBuffer, dstOffset, dataSize, pData);
 }
@@ -8127,7 +8252,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdFillBuffer(VkCommandBuffer commandBuffer, VkBuffer dstBuffer, VkDeviceSize dstOffset, VkDeviceSize size, uint32_t data) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
 #if MTMERGESOURCE
     VkDeviceMemory mem;
     auto cb_data = dev_data->commandBufferMap.find(commandBuffer);
@@ -8150,7 +8275,7 @@ vkCmdFillBuffer(VkCommandBuffer commandBuffer, VkBuffer dstBuffer, VkDeviceSize
         skipCall |= addCmd(dev_data, pCB, CMD_FILLBUFFER, "vkCmdFillBuffer()");
         skipCall |= insideRenderPass(dev_data, pCB, "vkCmdCopyFillBuffer");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdFillBuffer(commandBuffer, dstBuffer, dstOffset, size, data);
 }
@@ -8160,7 +8285,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdClearAttachments(VkCommandBuffer
                                                                  const VkClearRect *pRects) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         skipCall |= addCmd(dev_data, pCB, CMD_CLEARATTACHMENTS, "vkCmdClearAttachments()");
@@ -8183,7 +8308,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdClearAttachments(VkCommandBuffer
 
     // Validate that attachment is in reference list of active subpass
     if (pCB->activeRenderPass) {
-        const VkRenderPassCreateInfo *pRPCI = dev_data->renderPassMap[pCB->activeRenderPass]->pCreateInfo;
+        const VkRenderPassCreateInfo *pRPCI = dev_data->renderPassMap.at(pCB->activeRenderPass)->pCreateInfo;
         const VkSubpassDescription *pSD = &pRPCI->pSubpasses[pCB->activeSubpass];
 
         for (uint32_t attachment_idx = 0; attachment_idx < attachmentCount; attachment_idx++) {
@@ -8220,7 +8345,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdClearAttachments(VkCommandBuffer
             }
         }
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdClearAttachments(commandBuffer, attachmentCount, pAttachments, rectCount, pRects);
 }
@@ -8230,7 +8355,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdClearColorImage(VkCommandBuffer
                                                                 uint32_t rangeCount, const VkImageSubresourceRange *pRanges) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
 #if MTMERGESOURCE
     // TODO : Verify memory is in VK_IMAGE_STATE_CLEAR state
     VkDeviceMemory mem;
@@ -8250,7 +8375,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdClearColorImage(VkCommandBuffer
         skipCall |= addCmd(dev_data, pCB, CMD_CLEARCOLORIMAGE, "vkCmdClearColorImage()");
         skipCall |= insideRenderPass(dev_data, pCB, "vkCmdClearColorImage");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdClearColorImage(commandBuffer, image, imageLayout, pColor, rangeCount, pRanges);
 }
@@ -8261,7 +8386,7 @@ vkCmdClearDepthStencilImage(VkCommandBuffer commandBuffer, VkImage image, VkImag
                             const VkImageSubresourceRange *pRanges) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
 #if MTMERGESOURCE
     // TODO : Verify memory is in VK_IMAGE_STATE_CLEAR state
     VkDeviceMemory mem;
@@ -8281,7 +8406,7 @@ vkCmdClearDepthStencilImage(VkCommandBuffer commandBuffer, VkImage image, VkImag
         skipCall |= addCmd(dev_data, pCB, CMD_CLEARDEPTHSTENCILIMAGE, "vkCmdClearDepthStencilImage()");
         skipCall |= insideRenderPass(dev_data, pCB, "vkCmdClearDepthStencilImage");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdClearDepthStencilImage(commandBuffer, image, imageLayout, pDepthStencil, rangeCount,
                                                                    pRanges);
@@ -8292,7 +8417,7 @@ vkCmdResolveImage(VkCommandBuffer commandBuffer, VkImage srcImage, VkImageLayout
                   VkImageLayout dstImageLayout, uint32_t regionCount, const VkImageResolve *pRegions) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
 #if MTMERGESOURCE
     auto cb_data = dev_data->commandBufferMap.find(commandBuffer);
     VkDeviceMemory mem;
@@ -8319,7 +8444,7 @@ vkCmdResolveImage(VkCommandBuffer commandBuffer, VkImage srcImage, VkImageLayout
         skipCall |= addCmd(dev_data, pCB, CMD_RESOLVEIMAGE, "vkCmdResolveImage()");
         skipCall |= insideRenderPass(dev_data, pCB, "vkCmdResolveImage");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdResolveImage(commandBuffer, srcImage, srcImageLayout, dstImage, dstImageLayout,
                                                          regionCount, pRegions);
@@ -8342,7 +8467,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdSetEvent(VkCommandBuffer commandBuffer, VkEvent event, VkPipelineStageFlags stageMask) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         skipCall |= addCmd(dev_data, pCB, CMD_SETEVENT, "vkCmdSetEvent()");
@@ -8352,7 +8477,7 @@ vkCmdSetEvent(VkCommandBuffer commandBuffer, VkEvent event, VkPipelineStageFlags
             std::bind(setEventStageMask, std::placeholders::_1, commandBuffer, event, stageMask);
         pCB->eventUpdates.push_back(eventUpdate);
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdSetEvent(commandBuffer, event, stageMask);
 }
@@ -8361,7 +8486,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdResetEvent(VkCommandBuffer commandBuffer, VkEvent event, VkPipelineStageFlags stageMask) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         skipCall |= addCmd(dev_data, pCB, CMD_RESETEVENT, "vkCmdResetEvent()");
@@ -8371,7 +8496,7 @@ vkCmdResetEvent(VkCommandBuffer commandBuffer, VkEvent event, VkPipelineStageFla
             std::bind(setEventStageMask, std::placeholders::_1, commandBuffer, event, VkPipelineStageFlags(0));
         pCB->eventUpdates.push_back(eventUpdate);
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdResetEvent(commandBuffer, event, stageMask);
 }
@@ -8537,7 +8662,7 @@ VkBool32 ValidateBarriers(const char *funcName, VkCommandBuffer cmdBuffer, uint3
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(cmdBuffer), layer_data_map);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, cmdBuffer);
     if (pCB->activeRenderPass && memBarrierCount) {
-        if (!dev_data->renderPassMap[pCB->activeRenderPass]->hasSelfDependency[pCB->activeSubpass]) {
+        if (!dev_data->renderPassMap.at(pCB->activeRenderPass)->hasSelfDependency[pCB->activeSubpass]) {
             skip_call |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, (VkDebugReportObjectTypeEXT)0, 0, __LINE__,
                                  DRAWSTATE_INVALID_BARRIER, "DS", "%s: Barriers cannot be set during subpass %d "
                                                                   "with no self dependency specified.",
@@ -8745,7 +8870,7 @@ vkCmdWaitEvents(VkCommandBuffer commandBuffer, uint32_t eventCount, const VkEven
                 uint32_t imageMemoryBarrierCount, const VkImageMemoryBarrier *pImageMemoryBarriers) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         for (uint32_t i = 0; i < eventCount; ++i) {
@@ -8765,7 +8890,7 @@ vkCmdWaitEvents(VkCommandBuffer commandBuffer, uint32_t eventCount, const VkEven
             ValidateBarriers("vkCmdWaitEvents", commandBuffer, memoryBarrierCount, pMemoryBarriers, bufferMemoryBarrierCount,
                              pBufferMemoryBarriers, imageMemoryBarrierCount, pImageMemoryBarriers);
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdWaitEvents(commandBuffer, eventCount, pEvents, sourceStageMask, dstStageMask,
                                                        memoryBarrierCount, pMemoryBarriers, bufferMemoryBarrierCount,
@@ -8777,9 +8902,10 @@ vkCmdPipelineBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags srcStag
                      VkDependencyFlags dependencyFlags, uint32_t memoryBarrierCount, const VkMemoryBarrier *pMemoryBarriers,
                      uint32_t bufferMemoryBarrierCount, const VkBufferMemoryBarrier *pBufferMemoryBarriers,
                      uint32_t imageMemoryBarrierCount, const VkImageMemoryBarrier *pImageMemoryBarriers) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         skipCall |= addCmd(dev_data, pCB, CMD_PIPELINEBARRIER, "vkCmdPipelineBarrier()");
@@ -8788,7 +8914,7 @@ vkCmdPipelineBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags srcStag
             ValidateBarriers("vkCmdPipelineBarrier", commandBuffer, memoryBarrierCount, pMemoryBarriers, bufferMemoryBarrierCount,
                              pBufferMemoryBarriers, imageMemoryBarrierCount, pImageMemoryBarriers);
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, dependencyFlags,
                                                             memoryBarrierCount, pMemoryBarriers, bufferMemoryBarrierCount,
@@ -8799,7 +8925,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdBeginQuery(VkCommandBuffer commandBuffer, VkQueryPool queryPool, uint32_t slot, VkFlags flags) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         QueryObject query = {queryPool, slot};
@@ -8809,7 +8935,7 @@ vkCmdBeginQuery(VkCommandBuffer commandBuffer, VkQueryPool queryPool, uint32_t s
         }
         skipCall |= addCmd(dev_data, pCB, CMD_BEGINQUERY, "vkCmdBeginQuery()");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdBeginQuery(commandBuffer, queryPool, slot, flags);
 }
@@ -8817,7 +8943,7 @@ vkCmdBeginQuery(VkCommandBuffer commandBuffer, VkQueryPool queryPool, uint32_t s
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdEndQuery(VkCommandBuffer commandBuffer, VkQueryPool queryPool, uint32_t slot) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         QueryObject query = {queryPool, slot};
@@ -8836,7 +8962,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdEndQuery(VkCommandBuffer command
             skipCall |= report_error_no_cb_begin(dev_data, commandBuffer, "vkCmdEndQuery()");
         }
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdEndQuery(commandBuffer, queryPool, slot);
 }
@@ -8845,7 +8971,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdResetQueryPool(VkCommandBuffer commandBuffer, VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         for (uint32_t i = 0; i < queryCount; i++) {
@@ -8860,7 +8986,7 @@ vkCmdResetQueryPool(VkCommandBuffer commandBuffer, VkQueryPool queryPool, uint32
         }
         skipCall |= insideRenderPass(dev_data, pCB, "vkCmdQueryPool");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdResetQueryPool(commandBuffer, queryPool, firstQuery, queryCount);
 }
@@ -8870,7 +8996,7 @@ vkCmdCopyQueryPoolResults(VkCommandBuffer commandBuffer, VkQueryPool queryPool,
                           VkBuffer dstBuffer, VkDeviceSize dstOffset, VkDeviceSize stride, VkQueryResultFlags flags) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
 #if MTMERGESOURCE
     VkDeviceMemory mem;
@@ -8906,7 +9032,7 @@ vkCmdCopyQueryPoolResults(VkCommandBuffer commandBuffer, VkQueryPool queryPool,
         }
         skipCall |= insideRenderPass(dev_data, pCB, "vkCmdCopyQueryPoolResults");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdCopyQueryPoolResults(commandBuffer, queryPool, firstQuery, queryCount, dstBuffer,
                                                                  dstOffset, stride, flags);
@@ -8917,7 +9043,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdPushConstants(VkCommandBuffer co
                                                               const void *pValues) {
     bool skipCall = false;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         if (pCB->state == CB_RECORDING) {
@@ -8930,7 +9056,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdPushConstants(VkCommandBuffer co
         skipCall |= validatePushConstantSize(dev_data, offset, size, "vkCmdPushConstants()");
     }
     // TODO : Add warning if push constant update doesn't align with range
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (!skipCall)
         dev_data->device_dispatch_table->CmdPushConstants(commandBuffer, layout, stageFlags, offset, size, pValues);
 }
@@ -8939,7 +9065,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdWriteTimestamp(VkCommandBuffer commandBuffer, VkPipelineStageFlagBits pipelineStage, VkQueryPool queryPool, uint32_t slot) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         QueryObject query = {queryPool, slot};
@@ -8950,7 +9076,7 @@ vkCmdWriteTimestamp(VkCommandBuffer commandBuffer, VkPipelineStageFlagBits pipel
             skipCall |= report_error_no_cb_begin(dev_data, commandBuffer, "vkCmdWriteTimestamp()");
         }
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdWriteTimestamp(commandBuffer, pipelineStage, queryPool, slot);
 }
@@ -8970,7 +9096,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateFramebuffer(VkDevice devi
         FRAMEBUFFER_NODE fbNode = {};
         fbNode.createInfo = *localFBCI;
         std::pair<VkFramebuffer, FRAMEBUFFER_NODE> fbPair(*pFramebuffer, fbNode);
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         for (uint32_t i = 0; i < pCreateInfo->attachmentCount; ++i) {
             VkImageView view = pCreateInfo->pAttachments[i];
             auto view_data = dev_data->imageViewMap.find(view);
@@ -8984,7 +9110,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateFramebuffer(VkDevice devi
             fbPair.second.attachments.push_back(fb_info);
         }
         dev_data->frameBufferMap.insert(fbPair);
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
@@ -9309,9 +9435,9 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateShaderModule(VkDevice dev
     VkResult res = my_data->device_dispatch_table->CreateShaderModule(device, pCreateInfo, pAllocator, pShaderModule);
 
     if (res == VK_SUCCESS) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         my_data->shaderModuleMap[*pShaderModule] = unique_ptr<shader_module>(new shader_module(pCreateInfo));
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return res;
 }
@@ -9321,7 +9447,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateRenderPass(VkDevice devic
                                                                   VkRenderPass *pRenderPass) {
     VkBool32 skip_call = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     // Create DAG
     std::vector<bool> has_self_dependency(pCreateInfo->subpassCount);
     std::vector<DAGNode> subpass_to_node(pCreateInfo->subpassCount);
@@ -9331,10 +9457,10 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateRenderPass(VkDevice devic
     if (VK_FALSE != skip_call) {
         return VK_ERROR_VALIDATION_FAILED_EXT;
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     VkResult result = dev_data->device_dispatch_table->CreateRenderPass(device, pCreateInfo, pAllocator, pRenderPass);
     if (VK_SUCCESS == result) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         // TODOSC : Merge in tracking of renderpass from shader_checker
         // Shadow create info and store in map
         VkRenderPassCreateInfo *localRPCI = new VkRenderPassCreateInfo(*pCreateInfo);
@@ -9425,7 +9551,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateRenderPass(VkDevice devic
             }
         }
 #endif
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
@@ -9463,8 +9589,8 @@ VkBool32 VerifyFramebufferAndRenderPassLayouts(VkCommandBuffer cmdBuffer, const
     VkBool32 skip_call = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(cmdBuffer), layer_data_map);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, cmdBuffer);
-    const VkRenderPassCreateInfo *pRenderPassInfo = dev_data->renderPassMap[pRenderPassBegin->renderPass]->pCreateInfo;
-    const VkFramebufferCreateInfo framebufferInfo = dev_data->frameBufferMap[pRenderPassBegin->framebuffer].createInfo;
+    const VkRenderPassCreateInfo *pRenderPassInfo = dev_data->renderPassMap.at(pRenderPassBegin->renderPass)->pCreateInfo;
+    const VkFramebufferCreateInfo framebufferInfo = dev_data->frameBufferMap.at(pRenderPassBegin->framebuffer).createInfo;
     if (pRenderPassInfo->attachmentCount != framebufferInfo.attachmentCount) {
         skip_call |= log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, (VkDebugReportObjectTypeEXT)0, 0, __LINE__,
                              DRAWSTATE_INVALID_RENDERPASS, "DS", "You cannot start a render pass using a framebuffer "
@@ -9562,9 +9688,10 @@ void TransitionFinalSubpassLayouts(VkCommandBuffer cmdBuffer, const VkRenderPass
 
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdBeginRenderPass(VkCommandBuffer commandBuffer, const VkRenderPassBeginInfo *pRenderPassBegin, VkSubpassContents contents) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         if (pRenderPassBegin && pRenderPassBegin->renderPass) {
@@ -9572,10 +9699,9 @@ vkCmdBeginRenderPass(VkCommandBuffer commandBuffer, const VkRenderPassBeginInfo
             auto pass_data = dev_data->renderPassMap.find(pRenderPassBegin->renderPass);
             if (pass_data != dev_data->renderPassMap.end()) {
                 RENDER_PASS_NODE* pRPNode = pass_data->second;
-                pRPNode->fb = pRenderPassBegin->framebuffer;
                 auto cb_data = dev_data->commandBufferMap.find(commandBuffer);
                 for (size_t i = 0; i < pRPNode->attachments.size(); ++i) {
-                    MT_FB_ATTACHMENT_INFO &fb_info = dev_data->frameBufferMap[pRPNode->fb].attachments[i];
+                    MT_FB_ATTACHMENT_INFO &fb_info = dev_data->frameBufferMap.at(pRenderPassBegin->framebuffer).attachments[i];
                     if (pRPNode->attachments[i].load_op == VK_ATTACHMENT_LOAD_OP_CLEAR) {
                         if (cb_data != dev_data->commandBufferMap.end()) {
                             std::function<VkBool32()> function = [=]() {
@@ -9584,7 +9710,10 @@ vkCmdBeginRenderPass(VkCommandBuffer commandBuffer, const VkRenderPassBeginInfo
                             };
                             cb_data->second->validate_functions.push_back(function);
                         }
-                        VkImageLayout &attachment_layout = pRPNode->attachment_first_layout[pRPNode->attachments[i].attachment];
+                        auto first_layout = pRPNode->attachment_first_layout.find(pRPNode->attachments[i].attachment);
+                        VkImageLayout attachment_layout = (first_layout != pRPNode->attachment_first_layout.end())
+                                                              ? first_layout->second
+                                                              : VK_IMAGE_LAYOUT_UNDEFINED;
                         if (attachment_layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL ||
                             attachment_layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
                             skipCall |=
@@ -9609,7 +9738,8 @@ vkCmdBeginRenderPass(VkCommandBuffer commandBuffer, const VkRenderPassBeginInfo
                             cb_data->second->validate_functions.push_back(function);
                         }
                     }
-                    if (pRPNode->attachment_first_read[pRPNode->attachments[i].attachment]) {
+                    auto first_read = pRPNode->attachment_first_read.find(pRPNode->attachments[i].attachment);
+                    if (first_read != pRPNode->attachment_first_read.end() && first_read->second) {
                         if (cb_data != dev_data->commandBufferMap.end()) {
                             std::function<VkBool32()> function = [=]() {
                                 return validate_memory_is_valid(dev_data, fb_info.mem, "vkCmdBeginRenderPass()", fb_info.image);
@@ -9635,30 +9765,29 @@ vkCmdBeginRenderPass(VkCommandBuffer commandBuffer, const VkRenderPassBeginInfo
             pCB->activeSubpassContents = contents;
             pCB->framebuffer = pRenderPassBegin->framebuffer;
             // Connect this framebuffer to this cmdBuffer
-            dev_data->frameBufferMap[pCB->framebuffer].referencingCmdBuffers.insert(pCB->commandBuffer);
+            auto fb_data = dev_data->frameBufferMap.find(pCB->framebuffer);
+            if (fb_data != dev_data->frameBufferMap.end()) {
+                loader_platform_thread_lock_mutex(&dev_data->framebufferLock);
+                fb_data->second.referencingCmdBuffers.insert(pCB->commandBuffer);
+                loader_platform_thread_unlock_mutex(&dev_data->framebufferLock);
+            }
         } else {
             skipCall |=
                 log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, (VkDebugReportObjectTypeEXT)0, 0, __LINE__,
                         DRAWSTATE_INVALID_RENDERPASS, "DS", "You cannot use a NULL RenderPass object in vkCmdBeginRenderPass()");
         }
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall) {
         dev_data->device_dispatch_table->CmdBeginRenderPass(commandBuffer, pRenderPassBegin, contents);
-        loader_platform_thread_lock_mutex(&globalLock);
-        // This is a shallow copy as that is all that is needed for now
-        dev_data->renderPassBeginInfo = *pRenderPassBegin;
-        dev_data->currentSubpass = 0;
-        loader_platform_thread_unlock_mutex(&globalLock);
     }
 }
 
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdNextSubpass(VkCommandBuffer commandBuffer, VkSubpassContents contents) {
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
-    TransitionSubpassLayouts(commandBuffer, &dev_data->renderPassBeginInfo, ++dev_data->currentSubpass);
     if (pCB) {
         skipCall |= validatePrimaryCommandBuffer(dev_data, pCB, "vkCmdNextSubpass");
         skipCall |= addCmd(dev_data, pCB, CMD_NEXTSUBPASS, "vkCmdNextSubpass()");
@@ -9671,15 +9800,16 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdNextSubpass(VkCommandBuffer comm
         }
         skipCall |= outsideRenderPass(dev_data, pCB, "vkCmdNextSubpass");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdNextSubpass(commandBuffer, contents);
 }
 
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdEndRenderPass(VkCommandBuffer commandBuffer) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_read_lock(&globalLock);
 #if MTMERGESOURCE
     auto cb_data = dev_data->commandBufferMap.find(commandBuffer);
     if (cb_data != dev_data->commandBufferMap.end()) {
@@ -9687,7 +9817,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdEndRenderPass(VkCommandBuffer co
         if (pass_data != dev_data->renderPassMap.end()) {
             RENDER_PASS_NODE* pRPNode = pass_data->second;
             for (size_t i = 0; i < pRPNode->attachments.size(); ++i) {
-                MT_FB_ATTACHMENT_INFO &fb_info = dev_data->frameBufferMap[pRPNode->fb].attachments[i];
+                MT_FB_ATTACHMENT_INFO &fb_info = dev_data->frameBufferMap.at(cb_data->second->framebuffer).attachments[i];
                 if (pRPNode->attachments[i].store_op == VK_ATTACHMENT_STORE_OP_STORE) {
                     if (cb_data != dev_data->commandBufferMap.end()) {
                         std::function<VkBool32()> function = [=]() {
@@ -9710,7 +9840,6 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdEndRenderPass(VkCommandBuffer co
     }
 #endif
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
-    TransitionFinalSubpassLayouts(commandBuffer, &dev_data->renderPassBeginInfo);
     if (pCB) {
         skipCall |= outsideRenderPass(dev_data, pCB, "vkCmdEndRenderpass");
         skipCall |= validatePrimaryCommandBuffer(dev_data, pCB, "vkCmdEndRenderPass");
@@ -9719,7 +9848,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkCmdEndRenderPass(VkCommandBuffer co
         pCB->activeRenderPass = 0;
         pCB->activeSubpass = 0;
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_read_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdEndRenderPass(commandBuffer);
 }
@@ -9943,9 +10072,10 @@ bool validateSecondaryCommandBufferState(layer_data *dev_data, GLOBAL_CB_NODE *p
 
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
 vkCmdExecuteCommands(VkCommandBuffer commandBuffer, uint32_t commandBuffersCount, const VkCommandBuffer *pCommandBuffers) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     VkBool32 skipCall = VK_FALSE;
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(commandBuffer), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     GLOBAL_CB_NODE *pCB = getCBNode(dev_data, commandBuffer);
     if (pCB) {
         GLOBAL_CB_NODE *pSubCB = NULL;
@@ -10046,7 +10176,7 @@ vkCmdExecuteCommands(VkCommandBuffer commandBuffer, uint32_t commandBuffersCount
         skipCall |= validatePrimaryCommandBuffer(dev_data, pCB, "vkCmdExecuteComands");
         skipCall |= addCmd(dev_data, pCB, CMD_EXECUTECOMMANDS, "vkCmdExecuteComands()");
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (VK_FALSE == skipCall)
         dev_data->device_dispatch_table->CmdExecuteCommands(commandBuffer, commandBuffersCount, pCommandBuffers);
 }
@@ -10077,7 +10207,7 @@ vkMapMemory(VkDevice device, VkDeviceMemory mem, VkDeviceSize offset, VkDeviceSi
 
     VkBool32 skip_call = VK_FALSE;
     VkResult result = VK_ERROR_VALIDATION_FAILED_EXT;
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
 #if MTMERGESOURCE
     DEVICE_MEM_INFO *pMemObj = get_mem_obj_info(dev_data, mem);
     if (pMemObj) {
@@ -10093,7 +10223,7 @@ vkMapMemory(VkDevice device, VkDeviceMemory mem, VkDeviceSize offset, VkDeviceSi
     storeMemRanges(dev_data, mem, offset, size);
 #endif
     skip_call |= ValidateMapImageLayouts(device, mem);
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 
     if (VK_FALSE == skip_call) {
         result = dev_data->device_dispatch_table->MapMemory(device, mem, offset, size, flags, ppData);
@@ -10109,9 +10239,9 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkUnmapMemory(VkDevice device, VkDevi
     layer_data *my_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     VkBool32 skipCall = VK_FALSE;
 
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     skipCall |= deleteMemRanges(my_data, mem);
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (VK_FALSE == skipCall) {
         my_data->device_dispatch_table->UnmapMemory(device, mem);
     }
@@ -10186,10 +10316,10 @@ vkFlushMappedMemoryRanges(VkDevice device, uint32_t memRangeCount, const VkMappe
     VkBool32 skipCall = VK_FALSE;
     layer_data *my_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
 
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     skipCall |= validateAndCopyNoncoherentMemoryToDriver(my_data, memRangeCount, pMemRanges);
     skipCall |= validateMemoryIsMapped(my_data, "vkFlushMappedMemoryRanges", memRangeCount, pMemRanges);
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (VK_FALSE == skipCall) {
         result = my_data->device_dispatch_table->FlushMappedMemoryRanges(device, memRangeCount, pMemRanges);
     }
@@ -10202,9 +10332,9 @@ vkInvalidateMappedMemoryRanges(VkDevice device, uint32_t memRangeCount, const Vk
     VkBool32 skipCall = VK_FALSE;
     layer_data *my_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
 
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     skipCall |= validateMemoryIsMapped(my_data, "vkInvalidateMappedMemoryRanges", memRangeCount, pMemRanges);
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (VK_FALSE == skipCall) {
         result = my_data->device_dispatch_table->InvalidateMappedMemoryRanges(device, memRangeCount, pMemRanges);
     }
@@ -10217,7 +10347,7 @@ VKAPI_ATTR VkResult VKAPI_CALL vkBindImageMemory(VkDevice device, VkImage image,
     VkResult result = VK_ERROR_VALIDATION_FAILED_EXT;
     VkBool32 skipCall = VK_FALSE;
 #if MTMERGESOURCE
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     // Track objects tied to memory
     uint64_t image_handle = (uint64_t)(image);
     skipCall =
@@ -10231,28 +10361,28 @@ VKAPI_ATTR VkResult VKAPI_CALL vkBindImageMemory(VkDevice device, VkImage image,
                                                    VK_DEBUG_REPORT_OBJECT_TYPE_IMAGE_EXT);
     }
     print_mem_list(dev_data, device);
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 #endif
     if (VK_FALSE == skipCall) {
         result = dev_data->device_dispatch_table->BindImageMemory(device, image, mem, memoryOffset);
         VkMemoryRequirements memRequirements;
         dev_data->device_dispatch_table->GetImageMemoryRequirements(device, image, &memRequirements);
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         dev_data->memObjMap[mem].image = image;
         dev_data->imageMap[image].mem = mem;
         dev_data->imageMap[image].memOffset = memoryOffset;
         dev_data->imageMap[image].memSize = memRequirements.size;
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
 
 VKAPI_ATTR VkResult VKAPI_CALL vkSetEvent(VkDevice device, VkEvent event) {
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     dev_data->eventMap[event].needsSignaled = false;
     dev_data->eventMap[event].stageMask = VK_PIPELINE_STAGE_HOST_BIT;
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     VkResult result = dev_data->device_dispatch_table->SetEvent(device, event);
     return result;
 }
@@ -10264,7 +10394,7 @@ vkQueueBindSparse(VkQueue queue, uint32_t bindInfoCount, const VkBindSparseInfo
     VkBool32 skip_call = VK_FALSE;
 #if MTMERGESOURCE
     //MTMTODO : Merge this code with the checks below
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
 
     for (uint32_t i = 0; i < bindInfoCount; i++) {
         const VkBindSparseInfo *bindInfo = &pBindInfo[i];
@@ -10323,9 +10453,9 @@ vkQueueBindSparse(VkQueue queue, uint32_t bindInfoCount, const VkBindSparseInfo
     }
 
     print_mem_list(dev_data, queue);
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 #endif
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     for (uint32_t bindIdx = 0; bindIdx < bindInfoCount; ++bindIdx) {
         const VkBindSparseInfo &bindInfo = pBindInfo[bindIdx];
         for (uint32_t i = 0; i < bindInfo.waitSemaphoreCount; ++i) {
@@ -10343,13 +10473,13 @@ vkQueueBindSparse(VkQueue queue, uint32_t bindInfoCount, const VkBindSparseInfo
             dev_data->semaphoreMap[bindInfo.pSignalSemaphores[i]].signaled = 1;
         }
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 
     if (VK_FALSE == skip_call)
         return dev_data->device_dispatch_table->QueueBindSparse(queue, bindInfoCount, pBindInfo, fence);
 #if MTMERGESOURCE
     // Update semaphore state
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     for (uint32_t bind_info_idx = 0; bind_info_idx < bindInfoCount; bind_info_idx++) {
         const VkBindSparseInfo *bindInfo = &pBindInfo[bind_info_idx];
         for (uint32_t i = 0; i < bindInfo->waitSemaphoreCount; i++) {
@@ -10360,7 +10490,7 @@ vkQueueBindSparse(VkQueue queue, uint32_t bindInfoCount, const VkBindSparseInfo
             }
         }
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 #endif
 
     return result;
@@ -10371,13 +10501,13 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateSemaphore(VkDevice device, const VkSemaph
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     VkResult result = dev_data->device_dispatch_table->CreateSemaphore(device, pCreateInfo, pAllocator, pSemaphore);
     if (result == VK_SUCCESS) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         SEMAPHORE_NODE* sNode = &dev_data->semaphoreMap[*pSemaphore];
         sNode->signaled = 0;
         sNode->queue = VK_NULL_HANDLE;
         sNode->in_use.store(0);
         sNode->state = MEMTRACK_SEMAPHORE_STATE_UNSET;
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
@@ -10387,11 +10517,11 @@ vkCreateEvent(VkDevice device, const VkEventCreateInfo *pCreateInfo, const VkAll
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     VkResult result = dev_data->device_dispatch_table->CreateEvent(device, pCreateInfo, pAllocator, pEvent);
     if (result == VK_SUCCESS) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         dev_data->eventMap[*pEvent].needsSignaled = false;
         dev_data->eventMap[*pEvent].in_use.store(0);
         dev_data->eventMap[*pEvent].stageMask = VkPipelineStageFlags(0);
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
@@ -10404,9 +10534,9 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateSwapchainKHR(VkDevice dev
 
     if (VK_SUCCESS == result) {
         SWAPCHAIN_NODE *psc_node = new SWAPCHAIN_NODE(pCreateInfo);
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         dev_data->device_extensions.swapchainMap[*pSwapchain] = psc_node;
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
 
     return result;
@@ -10417,7 +10547,7 @@ vkDestroySwapchainKHR(VkDevice device, VkSwapchainKHR swapchain, const VkAllocat
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(device), layer_data_map);
     bool skipCall = false;
 
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     auto swapchain_data = dev_data->device_extensions.swapchainMap.find(swapchain);
     if (swapchain_data != dev_data->device_extensions.swapchainMap.end()) {
         if (swapchain_data->second->images.size() > 0) {
@@ -10442,7 +10572,7 @@ vkDestroySwapchainKHR(VkDevice device, VkSwapchainKHR swapchain, const VkAllocat
         delete swapchain_data->second;
         dev_data->device_extensions.swapchainMap.erase(swapchain);
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     if (!skipCall)
         dev_data->device_dispatch_table->DestroySwapchainKHR(device, swapchain, pAllocator);
 }
@@ -10456,7 +10586,7 @@ vkGetSwapchainImagesKHR(VkDevice device, VkSwapchainKHR swapchain, uint32_t *pCo
         // This should never happen and is checked by param checker.
         if (!pCount)
             return result;
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         const size_t count = *pCount;
         auto swapchain_node = dev_data->device_extensions.swapchainMap[swapchain];
         if (!swapchain_node->images.empty()) {
@@ -10493,18 +10623,19 @@ vkGetSwapchainImagesKHR(VkDevice device, VkSwapchainKHR swapchain, uint32_t *pCo
 #endif
             }
         }
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return result;
 }
 
 VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkQueuePresentKHR(VkQueue queue, const VkPresentInfoKHR *pPresentInfo) {
+    LAYER_PROFILE_ENTRY_POINT(profiler);
     layer_data *dev_data = get_my_data_ptr(get_dispatch_key(queue), layer_data_map);
     VkResult result = VK_ERROR_VALIDATION_FAILED_EXT;
     bool skip_call = false;
 
     if (pPresentInfo) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         for (uint32_t i = 0; i < pPresentInfo->waitSemaphoreCount; ++i) {
             if (dev_data->semaphoreMap[pPresentInfo->pWaitSemaphores[i]].signaled) {
                 dev_data->semaphoreMap[pPresentInfo->pWaitSemaphores[i]].signaled = 0;
@@ -10542,20 +10673,20 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkQueuePresentKHR(VkQueue queue,
                 }
             }
         }
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
 
     if (!skip_call)
         result = dev_data->device_dispatch_table->QueuePresentKHR(queue, pPresentInfo);
 #if MTMERGESOURCE
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     for (uint32_t i = 0; i < pPresentInfo->waitSemaphoreCount; i++) {
         VkSemaphore sem = pPresentInfo->pWaitSemaphores[i];
         if (dev_data->semaphoreMap.find(sem) != dev_data->semaphoreMap.end()) {
             dev_data->semaphoreMap[sem].state = MEMTRACK_SEMAPHORE_STATE_UNSET;
         }
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 #endif
     return result;
 }
@@ -10566,7 +10697,7 @@ VKAPI_ATTR VkResult VKAPI_CALL vkAcquireNextImageKHR(VkDevice device, VkSwapchai
     VkResult result = VK_ERROR_VALIDATION_FAILED_EXT;
     bool skipCall = false;
 #if MTMERGESOURCE
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     if (dev_data->semaphoreMap.find(semaphore) != dev_data->semaphoreMap.end()) {
         if (dev_data->semaphoreMap[semaphore].state != MEMTRACK_SEMAPHORE_STATE_UNSET) {
             skipCall = log_msg(dev_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_SEMAPHORE_EXT,
@@ -10579,16 +10710,16 @@ VKAPI_ATTR VkResult VKAPI_CALL vkAcquireNextImageKHR(VkDevice device, VkSwapchai
     if (fence_data != dev_data->fenceMap.end()) {
         fence_data->second.swapchain = swapchain;
     }
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 #endif
     if (!skipCall) {
         result =
             dev_data->device_dispatch_table->AcquireNextImageKHR(device, swapchain, timeout, semaphore, fence, pImageIndex);
     }
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     // FIXME/TODO: Need to add some thing code the "fence" parameter
     dev_data->semaphoreMap[semaphore].signaled = 1;
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
     return result;
 }
 
@@ -10599,9 +10730,9 @@ vkCreateDebugReportCallbackEXT(VkInstance instance, const VkDebugReportCallbackC
     VkLayerInstanceDispatchTable *pTable = my_data->instance_dispatch_table;
     VkResult res = pTable->CreateDebugReportCallbackEXT(instance, pCreateInfo, pAllocator, pMsgCallback);
     if (VK_SUCCESS == res) {
-        loader_platform_thread_lock_mutex(&globalLock);
+        loader_platform_thread_write_lock(&globalLock);
         res = layer_create_msg_callback(my_data->report_data, pCreateInfo, pAllocator, pMsgCallback);
-        loader_platform_thread_unlock_mutex(&globalLock);
+        loader_platform_thread_write_unlock(&globalLock);
     }
     return res;
 }
@@ -10612,9 +10743,9 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkDestroyDebugReportCallbackEXT(VkIns
     layer_data *my_data = get_my_data_ptr(get_dispatch_key(instance), layer_data_map);
     VkLayerInstanceDispatchTable *pTable = my_data->instance_dispatch_table;
     pTable->DestroyDebugReportCallbackEXT(instance, msgCallback, pAllocator);
-    loader_platform_thread_lock_mutex(&globalLock);
+    loader_platform_thread_write_lock(&globalLock);
     layer_destroy_msg_callback(my_data->report_data, msgCallback, pAllocator);
-    loader_platform_thread_unlock_mutex(&globalLock);
+    loader_platform_thread_write_unlock(&globalLock);
 }
 
 VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL
@@ -479,7 +479,6 @@ struct DAGNode {
 
 struct RENDER_PASS_NODE {
     VkRenderPassCreateInfo const *pCreateInfo;
-    VkFramebuffer fb;
     vector<bool> hasSelfDependency;
     vector<DAGNode> subpassToNode;
     vector<vector<VkFormat>> subpassColorFormats;
@@ -487,7 +486,7 @@ struct RENDER_PASS_NODE {
     unordered_map<uint32_t, bool> attachment_first_read;
     unordered_map<uint32_t, VkImageLayout> attachment_first_layout;
 
-    RENDER_PASS_NODE(VkRenderPassCreateInfo const *pCreateInfo) : pCreateInfo(pCreateInfo), fb(VK_NULL_HANDLE) {
+    RENDER_PASS_NODE(VkRenderPassCreateInfo const *pCreateInfo) : pCreateInfo(pCreateInfo) {
         uint32_t i;
 
         subpassColorFormats.reserve(pCreateInfo->subpassCount);
@@ -810,6 +809,25 @@ struct LAST_BOUND_STATE {
         dynamicOffsets.clear();
     }
 };
+// How much draw-time state validation is done, from lunarg_core_validation.validation_level
+typedef enum _VALIDATION_LEVEL {
+    VALIDATION_LEVEL_MINIMAL,  // Skip draw-time state checks
+    VALIDATION_LEVEL_DEFERRED, // Record each distinct draw state, check it at vkQueueSubmit
+    VALIDATION_LEVEL_FULL,     // Check draw state in every vkCmdDraw* call
+} VALIDATION_LEVEL;
+
+// Cmd buffer state that a draw is validated against, kept for deferred validation
+struct DRAW_STATE_SNAPSHOT {
+    VkBool32 indexed;
+    CBStatusFlags status;
+    VkPipeline pipeline;
+    VkPipelineLayout pipelineLayout;
+    vector<VkDescriptorSet> boundDescriptorSets;
+    vector<uint32_t> dynamicOffsets;
+    vector<VkBuffer> vertexBuffers;
+    size_t viewportCount;
+    size_t scissorCount;
+};
 // Cmd Buffer Wrapper Struct
 struct GLOBAL_CB_NODE {
     VkCommandBuffer commandBuffer;
@@ -872,6 +890,8 @@ struct GLOBAL_CB_NODE {
     // MTMTODO : Scrub these data fields and merge active sets w/ lastBound as appropriate
     vector<VkDescriptorSet> activeDescriptorSets;
     vector<std::function<VkBool32()>> validate_functions;
+    // Draw states still to be validated under VALIDATION_LEVEL_DEFERRED
+    vector<DRAW_STATE_SNAPSHOT> deferredDrawStates;
     list<VkDeviceMemory> pMemObjList; // List container of Mem objs referenced by this CB
     vector<std::function<bool(VkQueue)>> eventUpdates;
 };
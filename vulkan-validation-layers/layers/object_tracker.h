@@ -32,6 +32,7 @@
 #include "vk_enum_string_helper.h"
 #include "vk_layer_table.h"
 #include "vk_layer_utils.h"
+#include "vk_layer_slab_allocator.h"
 
 // Object Tracker ERROR codes
 typedef enum _OBJECT_TRACK_ERROR {
@@ -65,8 +66,22 @@ typedef struct _OBJTRACK_NODE {
     ObjectStatusFlags status;           // Object state
     uint64_t parentObj;                 // Parent object
     uint64_t belongsTo;                 // Object Scope -- owning device/instance
+
+    // Nodes are slab allocated, see objNodeAllocator below
+    static void *operator new(size_t size);
+    static void operator delete(void *p);
 } OBJTRACK_NODE;
 
+static VkLayerSlabAllocator<OBJTRACK_NODE> objNodeAllocator;
+static size_t objNodeSlabsReported = 0;
+
+inline void *_OBJTRACK_NODE::operator new(size_t size) {
+    assert(size == sizeof(OBJTRACK_NODE));
+    return objNodeAllocator.allocate();
+}
+
+inline void _OBJTRACK_NODE::operator delete(void *p) { objNodeAllocator.release(p); }
+
 // prototype for extension functions
 uint64_t objTrackGetObjectCount(VkDevice device);
 uint64_t objTrackGetObjectsOfTypeCount(VkDevice, VkDebugReportObjectTypeEXT type);
@@ -232,6 +247,17 @@ static uint32_t objTypeToIndex(uint32_t objType) {
     return index;
 }
 
+// Report the memory held for object nodes each time the node allocator has grown since the last report
+static void report_node_footprint(debug_report_data *report_data, VkDebugReportObjectTypeEXT objType, uint64_t object) {
+    size_t slabs = objNodeAllocator.slabCount();
+    if (slabs == objNodeSlabsReported)
+        return;
+    objNodeSlabsReported = slabs;
+    log_msg(report_data, VK_DEBUG_REPORT_INFORMATION_BIT_EXT, objType, object, __LINE__, OBJTRACK_NONE, "OBJTRACK",
+            "OBJ_STAT Node storage grown to %zu bytes in %zu slabs (%zu live nodes, %" PRIu64 " tracked objs).",
+            slabs * objNodeAllocator.bytesPerSlab(), slabs, objNodeAllocator.liveCount(), numTotalObjs);
+}
+
 // Add new queue to head of global queue list
 static void addQueueInfo(uint32_t queueNodeIndex, VkQueue queue) {
     OT_QUEUE_INFO *pQueueInfo = new OT_QUEUE_INFO;
@@ -796,6 +822,7 @@ VkResult explicit_AllocateCommandBuffers(VkDevice device, const VkCommandBufferA
         alloc_command_buffer(device, pAllocateInfo->commandPool, pCommandBuffers[i], VK_DEBUG_REPORT_OBJECT_TYPE_COMMAND_BUFFER_EXT,
                              pAllocateInfo->level);
     }
+    report_node_footprint(mdd(device), VK_DEBUG_REPORT_OBJECT_TYPE_DEVICE_EXT, reinterpret_cast<uint64_t>(device));
     loader_platform_thread_unlock_mutex(&objLock);
 
     return result;
@@ -825,6 +852,7 @@ VkResult explicit_AllocateDescriptorSets(VkDevice device, const VkDescriptorSetA
             alloc_descriptor_set(device, pAllocateInfo->descriptorPool, pDescriptorSets[i],
                                  VK_DEBUG_REPORT_OBJECT_TYPE_DESCRIPTOR_SET_EXT);
         }
+        report_node_footprint(mdd(device), VK_DEBUG_REPORT_OBJECT_TYPE_DEVICE_EXT, reinterpret_cast<uint64_t>(device));
         loader_platform_thread_unlock_mutex(&objLock);
     }
 
@@ -965,6 +993,7 @@ VkResult explicit_GetSwapchainImagesKHR(VkDevice device, VkSwapchainKHR swapchai
         for (uint32_t i = 0; i < *pCount; i++) {
             create_swapchain_image_obj(device, pSwapchainImages[i], swapchain);
         }
+        report_node_footprint(mdd(device), VK_DEBUG_REPORT_OBJECT_TYPE_DEVICE_EXT, reinterpret_cast<uint64_t>(device));
         loader_platform_thread_unlock_mutex(&objLock);
     }
     return result;
@@ -1014,6 +1043,7 @@ VkResult explicit_CreateGraphicsPipelines(VkDevice device, VkPipelineCache pipel
         for (uint32_t idx2 = 0; idx2 < createInfoCount; ++idx2) {
             create_pipeline(device, pPipelines[idx2], VK_DEBUG_REPORT_OBJECT_TYPE_PIPELINE_EXT);
         }
+        report_node_footprint(mdd(device), VK_DEBUG_REPORT_OBJECT_TYPE_DEVICE_EXT, reinterpret_cast<uint64_t>(device));
     }
     loader_platform_thread_unlock_mutex(&objLock);
     return result;
@@ -1055,6 +1085,7 @@ VkResult explicit_CreateComputePipelines(VkDevice device, VkPipelineCache pipeli
         for (uint32_t idx1 = 0; idx1 < createInfoCount; ++idx1) {
             create_pipeline(device, pPipelines[idx1], VK_DEBUG_REPORT_OBJECT_TYPE_PIPELINE_EXT);
         }
+        report_node_footprint(mdd(device), VK_DEBUG_REPORT_OBJECT_TYPE_DEVICE_EXT, reinterpret_cast<uint64_t>(device));
     }
     loader_platform_thread_unlock_mutex(&objLock);
     return result;
@@ -52,6 +52,7 @@ static void initThreading(layer_data *my_data, const VkAllocationCallbacks *pAll
     if (!threadingLockInitialized) {
         loader_platform_thread_create_mutex(&threadingLock);
         loader_platform_thread_init_cond(&threadingCond);
+        loader_platform_thread_create_rwlock(&commandPoolLock);
         threadingLockInitialized = 1;
     }
 }
@@ -106,6 +107,7 @@ VK_LAYER_EXPORT VKAPI_ATTR void VKAPI_CALL vkDestroyInstance(VkInstance instance
     if (layer_data_map.empty()) {
         // Release mutex when destroying last instance.
         loader_platform_thread_delete_mutex(&threadingLock);
+        loader_platform_thread_delete_rwlock(&commandPoolLock);
         threadingLockInitialized = 0;
     }
 }
@@ -311,9 +313,9 @@ vkAllocateCommandBuffers(VkDevice device, const VkCommandBufferAllocateInfo *pAl
     // Record mapping from command buffer to command pool
     if (VK_SUCCESS == result) {
         for (int index = 0; index < pAllocateInfo->commandBufferCount; index++) {
-            loader_platform_thread_lock_mutex(&threadingLock);
+            loader_platform_thread_write_lock(&commandPoolLock);
             command_pool_map[pCommandBuffers[index]] = pAllocateInfo->commandPool;
-            loader_platform_thread_unlock_mutex(&threadingLock);
+            loader_platform_thread_write_unlock(&commandPoolLock);
         }
     }
 
@@ -337,8 +339,8 @@ void VKAPI_CALL vkFreeCommandBuffers(VkDevice device, VkCommandPool commandPool,
     finishWriteObject(my_data, commandPool);
     for (int index = 0; index < commandBufferCount; index++) {
         finishWriteObject(my_data, pCommandBuffers[index], lockCommandPool);
-        loader_platform_thread_lock_mutex(&threadingLock);
+        loader_platform_thread_write_lock(&commandPoolLock);
         command_pool_map.erase(pCommandBuffers[index]);
-        loader_platform_thread_unlock_mutex(&threadingLock);
+        loader_platform_thread_write_unlock(&commandPoolLock);
     }
 }
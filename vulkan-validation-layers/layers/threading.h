@@ -27,6 +27,9 @@
 
 #ifndef THREADING_H
 #define THREADING_H
+#include <algorithm>
+#include <atomic>
+#include <unordered_map>
 #include <vector>
 #include "vk_layer_config.h"
 #include "vk_layer_logging.h"
@@ -45,154 +48,194 @@ typedef enum _THREADING_CHECKER_ERROR {
     THREADING_CHECKER_SINGLE_THREAD_REUSE, // Object used simultaneously by recursion in single thread
 } THREADING_CHECKER_ERROR;
 
+// Reader count in the high 32 bits, writer count in the low 32 bits, so both
+// can be examined and changed with a single atomic operation.
+#define THREADING_WRITER ((uint64_t)1)
+#define THREADING_READER ((uint64_t)1 << 32)
+#define THREADING_WRITER_MASK (THREADING_READER - 1)
+
 struct object_use_data {
-    loader_platform_thread_id thread;
-    int reader_count;
-    int writer_count;
+    std::atomic<loader_platform_thread_id> thread;
+    std::atomic<uint64_t> count;
+    // Threads waiting on the object with their own use backed out of count
+    std::atomic<int> waiters;
+    object_use_data() : thread(loader_platform_thread_id()), count(0), waiters(0) {}
 };
 
 struct layer_data;
 
 static int threadingLockInitialized = 0;
+// Only taken by threads that have detected a collision and must wait for an
+// object, and by threads finishing a use while someone is waiting.
 static loader_platform_thread_mutex threadingLock;
 static loader_platform_thread_cond threadingCond;
+static std::atomic<int> threadingWaiters(0);
+
+// Every tracked object sits in one of THREADING_SHARDS maps chosen by handle
+// hash.  A shard's rwlock is held shared while an entry is looked up and its
+// counts are changed with atomics, so unrelated calls never serialize.  It is
+// held exclusively only to add an object seen for the first time, at which
+// point idle entries are pruned once the map has doubled in size.
+#define THREADING_SHARD_BITS 4
+#define THREADING_SHARDS (1 << THREADING_SHARD_BITS)
+
+template <typename T> struct counter_shard {
+    loader_platform_thread_rwlock lock;
+    std::unordered_map<T, object_use_data> uses;
+    size_t pruneSize;
+};
 
 template <typename T> class counter {
   public:
     const char *typeName;
     VkDebugReportObjectTypeEXT objectType;
-    std::unordered_map<T, object_use_data> uses;
+    counter_shard<T> shards[THREADING_SHARDS];
+
+    counter_shard<T> &shardOf(T object) {
+        uint64_t h = (uint64_t)(object);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return shards[h & (THREADING_SHARDS - 1)];
+    }
+
+    // Add use to the object's count and return the previous count.  On return
+    // the object's entry is pinned by the caller's use.
+    uint64_t addUse(T object, uint64_t use, object_use_data **ppUseData) {
+        counter_shard<T> &shard = shardOf(object);
+        loader_platform_thread_read_lock(&shard.lock);
+        typename std::unordered_map<T, object_use_data>::iterator it = shard.uses.find(object);
+        if (it != shard.uses.end()) {
+            *ppUseData = &it->second;
+            uint64_t prevCount = it->second.count.fetch_add(use);
+            loader_platform_thread_read_unlock(&shard.lock);
+            return prevCount;
+        }
+        loader_platform_thread_read_unlock(&shard.lock);
+
+        loader_platform_thread_write_lock(&shard.lock);
+        if (shard.uses.size() >= shard.pruneSize) {
+            for (it = shard.uses.begin(); it != shard.uses.end();) {
+                if (it->second.count == 0 && it->second.waiters == 0)
+                    it = shard.uses.erase(it);
+                else
+                    ++it;
+            }
+            shard.pruneSize = std::max<size_t>(64, 2 * shard.uses.size());
+        }
+        object_use_data *use_data = &shard.uses[object];
+        *ppUseData = use_data;
+        uint64_t prevCount = use_data->count.fetch_add(use);
+        loader_platform_thread_write_unlock(&shard.lock);
+        return prevCount;
+    }
+
+    void removeUse(T object, uint64_t use) {
+        counter_shard<T> &shard = shardOf(object);
+        loader_platform_thread_read_lock(&shard.lock);
+        typename std::unordered_map<T, object_use_data>::iterator it = shard.uses.find(object);
+        if (it != shard.uses.end()) {
+            it->second.count.fetch_sub(use);
+        }
+        loader_platform_thread_read_unlock(&shard.lock);
+        if (threadingWaiters) {
+            // Notify any waiting threads that this object may be safe to use
+            loader_platform_thread_lock_mutex(&threadingLock);
+            loader_platform_thread_cond_broadcast(&threadingCond);
+            loader_platform_thread_unlock_mutex(&threadingLock);
+        }
+    }
+
+    // Give up this thread's use of the object, wait until no other thread is
+    // using it, then take the use back.
+    void waitForIdle(object_use_data *use_data, uint64_t use) {
+        // Keep the entry from being pruned while it is not pinned by our use
+        use_data->waiters += 1;
+        use_data->count.fetch_sub(use);
+        threadingWaiters += 1;
+        loader_platform_thread_lock_mutex(&threadingLock);
+        for (;;) {
+            uint64_t idle = 0;
+            if (use_data->count.compare_exchange_strong(idle, use))
+                break;
+            loader_platform_thread_cond_wait(&threadingCond, &threadingLock);
+        }
+        loader_platform_thread_unlock_mutex(&threadingLock);
+        threadingWaiters -= 1;
+        use_data->waiters -= 1;
+    }
+
     void startWrite(debug_report_data *report_data, T object) {
         VkBool32 skipCall = VK_FALSE;
         loader_platform_thread_id tid = loader_platform_get_thread_id();
-        loader_platform_thread_lock_mutex(&threadingLock);
-        if (uses.find(object) == uses.end()) {
+        object_use_data *use_data;
+        uint64_t prevCount = addUse(object, THREADING_WRITER, &use_data);
+        if (prevCount == 0) {
             // There is no current use of the object.  Record writer thread.
-            struct object_use_data *use_data = &uses[object];
-            use_data->reader_count = 0;
-            use_data->writer_count = 1;
             use_data->thread = tid;
-        } else {
-            struct object_use_data *use_data = &uses[object];
-            if (use_data->reader_count == 0) {
-                // There are no readers.  Two writers just collided.
-                if (use_data->thread != tid) {
-                    skipCall |= log_msg(report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, objectType, (uint64_t)(object),
-                                        /*location*/ 0, THREADING_CHECKER_MULTIPLE_THREADS, "THREADING",
-                                        "THREADING ERROR : object of type %s is simultaneously used in thread %ld and thread %ld",
-                                        typeName, use_data->thread, tid);
-                    if (skipCall) {
-                        // Wait for thread-safe access to object instead of skipping call.
-                        while (uses.find(object) != uses.end()) {
-                            loader_platform_thread_cond_wait(&threadingCond, &threadingLock);
-                        }
-                        // There is now no current use of the object.  Record writer thread.
-                        struct object_use_data *use_data = &uses[object];
-                        use_data->thread = tid;
-                        use_data->reader_count = 0;
-                        use_data->writer_count = 1;
-                    } else {
-                        // Continue with an unsafe use of the object.
-                        use_data->thread = tid;
-                        use_data->writer_count += 1;
-                    }
-                } else {
-                    // This is either safe multiple use in one call, or recursive use.
-                    // There is no way to make recursion safe.  Just forge ahead.
-                    use_data->writer_count += 1;
-                }
-            } else {
-                // There are readers.  This writer collided with them.
-                if (use_data->thread != tid) {
-                    skipCall |= log_msg(report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, objectType, (uint64_t)(object),
-                                        /*location*/ 0, THREADING_CHECKER_MULTIPLE_THREADS, "THREADING",
-                                        "THREADING ERROR : object of type %s is simultaneously used in thread %ld and thread %ld",
-                                        typeName, use_data->thread, tid);
-                    if (skipCall) {
-                        // Wait for thread-safe access to object instead of skipping call.
-                        while (uses.find(object) != uses.end()) {
-                            loader_platform_thread_cond_wait(&threadingCond, &threadingLock);
-                        }
-                        // There is now no current use of the object.  Record writer thread.
-                        struct object_use_data *use_data = &uses[object];
-                        use_data->thread = tid;
-                        use_data->reader_count = 0;
-                        use_data->writer_count = 1;
-                    } else {
-                        // Continue with an unsafe use of the object.
-                        use_data->thread = tid;
-                        use_data->writer_count += 1;
-                    }
-                } else {
-                    // This is either safe multiple use in one call, or recursive use.
-                    // There is no way to make recursion safe.  Just forge ahead.
-                    use_data->writer_count += 1;
-                }
+            return;
+        }
+        // Another use is in progress.  The recorded thread may briefly be stale
+        // if that use only just began, which at worst names the wrong thread.
+        loader_platform_thread_id other = use_data->thread;
+        if (other != tid) {
+            // Either two writers or a writer and readers just collided.
+            skipCall |= log_msg(report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, objectType, (uint64_t)(object),
+                                /*location*/ 0, THREADING_CHECKER_MULTIPLE_THREADS, "THREADING",
+                                "THREADING ERROR : object of type %s is simultaneously used in thread %ld and thread %ld",
+                                typeName, other, tid);
+            if (skipCall) {
+                // Wait for thread-safe access to object instead of skipping call.
+                waitForIdle(use_data, THREADING_WRITER);
             }
+            // Record writer thread, whether or not this use is safe.
+            use_data->thread = tid;
+        } else {
+            // This is either safe multiple use in one call, or recursive use.
+            // There is no way to make recursion safe.  Just forge ahead.
         }
-        loader_platform_thread_unlock_mutex(&threadingLock);
     }
 
     void finishWrite(T object) {
         // Object is no longer in use
-        loader_platform_thread_lock_mutex(&threadingLock);
-        uses[object].writer_count -= 1;
-        if ((uses[object].reader_count == 0) && (uses[object].writer_count == 0)) {
-            uses.erase(object);
-        }
-        // Notify any waiting threads that this object may be safe to use
-        loader_platform_thread_cond_broadcast(&threadingCond);
-        loader_platform_thread_unlock_mutex(&threadingLock);
+        removeUse(object, THREADING_WRITER);
     }
 
     void startRead(debug_report_data *report_data, T object) {
         VkBool32 skipCall = VK_FALSE;
         loader_platform_thread_id tid = loader_platform_get_thread_id();
-        loader_platform_thread_lock_mutex(&threadingLock);
-        if (uses.find(object) == uses.end()) {
-            // There is no current use of the object.  Record reader count
-            struct object_use_data *use_data = &uses[object];
-            use_data->reader_count = 1;
-            use_data->writer_count = 0;
+        object_use_data *use_data;
+        uint64_t prevCount = addUse(object, THREADING_READER, &use_data);
+        if (prevCount == 0) {
+            // There is no current use of the object.  Record reader thread.
             use_data->thread = tid;
-        } else if (uses[object].writer_count > 0 && uses[object].thread != tid) {
+        } else if ((prevCount & THREADING_WRITER_MASK) && use_data->thread != tid) {
             // There is a writer of the object.
             skipCall |= log_msg(report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, objectType, (uint64_t)(object),
                                 /*location*/ 0, THREADING_CHECKER_MULTIPLE_THREADS, "THREADING",
                                 "THREADING ERROR : object of type %s is simultaneously used in thread %ld and thread %ld", typeName,
-                                uses[object].thread, tid);
+                                (loader_platform_thread_id)use_data->thread, tid);
             if (skipCall) {
                 // Wait for thread-safe access to object instead of skipping call.
-                while (uses.find(object) != uses.end()) {
-                    loader_platform_thread_cond_wait(&threadingCond, &threadingLock);
-                }
-                // There is no current use of the object.  Record reader count
-                struct object_use_data *use_data = &uses[object];
-                use_data->reader_count = 1;
-                use_data->writer_count = 0;
+                waitForIdle(use_data, THREADING_READER);
                 use_data->thread = tid;
-            } else {
-                uses[object].reader_count += 1;
             }
-        } else {
-            // There are other readers of the object.  Increase reader count
-            uses[object].reader_count += 1;
-        }
-        loader_platform_thread_unlock_mutex(&threadingLock);
-    }
-    void finishRead(T object) {
-        loader_platform_thread_lock_mutex(&threadingLock);
-        uses[object].reader_count -= 1;
-        if ((uses[object].reader_count == 0) && (uses[object].writer_count == 0)) {
-            uses.erase(object);
         }
-        // Notify and waiting threads that this object may be safe to use
-        loader_platform_thread_cond_broadcast(&threadingCond);
-        loader_platform_thread_unlock_mutex(&threadingLock);
+        // Otherwise there are only other readers of the object.
     }
+    void finishRead(T object) { removeUse(object, THREADING_READER); }
     counter(const char *name = "", VkDebugReportObjectTypeEXT type = VK_DEBUG_REPORT_OBJECT_TYPE_UNKNOWN_EXT) {
         typeName = name;
         objectType = type;
+        for (int i = 0; i < THREADING_SHARDS; i++) {
+            loader_platform_thread_create_rwlock(&shards[i].lock);
+            shards[i].pruneSize = 64;
+        }
+    }
+    ~counter() {
+        for (int i = 0; i < THREADING_SHARDS; i++) {
+            loader_platform_thread_delete_rwlock(&shards[i].lock);
+        }
     }
 };
 
@@ -303,38 +346,38 @@ WRAPPER(uint64_t)
 
 static std::unordered_map<void *, layer_data *> layer_data_map;
 static std::unordered_map<VkCommandBuffer, VkCommandPool> command_pool_map;
+// Written only when command buffers are allocated or freed
+static loader_platform_thread_rwlock commandPoolLock;
+
+static VkCommandPool getCommandPool(VkCommandBuffer object) {
+    VkCommandPool pool = VK_NULL_HANDLE;
+    loader_platform_thread_read_lock(&commandPoolLock);
+    auto it = command_pool_map.find(object);
+    if (it != command_pool_map.end())
+        pool = it->second;
+    loader_platform_thread_read_unlock(&commandPoolLock);
+    return pool;
+}
 
 // VkCommandBuffer needs check for implicit use of command pool
 static void startWriteObject(struct layer_data *my_data, VkCommandBuffer object, bool lockPool = true) {
     if (lockPool) {
-        loader_platform_thread_lock_mutex(&threadingLock);
-        VkCommandPool pool = command_pool_map[object];
-        loader_platform_thread_unlock_mutex(&threadingLock);
-        startWriteObject(my_data, pool);
+        startWriteObject(my_data, getCommandPool(object));
     }
     my_data->c_VkCommandBuffer.startWrite(my_data->report_data, object);
 }
 static void finishWriteObject(struct layer_data *my_data, VkCommandBuffer object, bool lockPool = true) {
     my_data->c_VkCommandBuffer.finishWrite(object);
     if (lockPool) {
-        loader_platform_thread_lock_mutex(&threadingLock);
-        VkCommandPool pool = command_pool_map[object];
-        loader_platform_thread_unlock_mutex(&threadingLock);
-        finishWriteObject(my_data, pool);
+        finishWriteObject(my_data, getCommandPool(object));
     }
 }
 static void startReadObject(struct layer_data *my_data, VkCommandBuffer object) {
-    loader_platform_thread_lock_mutex(&threadingLock);
-    VkCommandPool pool = command_pool_map[object];
-    loader_platform_thread_unlock_mutex(&threadingLock);
-    startReadObject(my_data, pool);
+    startReadObject(my_data, getCommandPool(object));
     my_data->c_VkCommandBuffer.startRead(my_data->report_data, object);
 }
 static void finishReadObject(struct layer_data *my_data, VkCommandBuffer object) {
     my_data->c_VkCommandBuffer.finishRead(object);
-    loader_platform_thread_lock_mutex(&threadingLock);
-    VkCommandPool pool = command_pool_map[object];
-    loader_platform_thread_unlock_mutex(&threadingLock);
-    finishReadObject(my_data, pool);
+    finishReadObject(my_data, getCommandPool(object));
 }
 #endif // THREADING_H
@@ -44,6 +44,7 @@
 #include "vk_layer_extension_utils.h"
 #include "vk_safe_struct.h"
 #include "vk_layer_utils.h"
+#include "vk_layer_slab_allocator.h"
 
 struct layer_data {
     bool wsi_enabled;
@@ -69,8 +70,21 @@ static instance_table_map unique_objects_instance_table_map;
 //  address of struct will be used as the unique handle
 struct VkUniqueObject {
     uint64_t actualObject;
+
+    // Wrappers live in slab slots so creating an object doesn't cost a heap block
+    static void *operator new(size_t size);
+    static void operator delete(void *p);
 };
 
+static VkLayerSlabAllocator<VkUniqueObject> uniqueObjectAllocator;
+
+inline void *VkUniqueObject::operator new(size_t size) {
+    assert(size == sizeof(VkUniqueObject));
+    return uniqueObjectAllocator.allocate();
+}
+
+inline void VkUniqueObject::operator delete(void *p) { uniqueObjectAllocator.release(p); }
+
 // Handle CreateInstance
 static void createInstanceRegisterExtensions(const VkInstanceCreateInfo *pCreateInfo, VkInstance instance) {
     uint32_t i;
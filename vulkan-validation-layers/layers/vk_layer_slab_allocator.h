@@ -0,0 +1,115 @@
+/* Copyright (c) 2015-2016 The Khronos Group Inc.
+ * Copyright (c) 2015-2016 Valve Corporation
+ * Copyright (c) 2015-2016 LunarG, Inc.
+ * Copyright (C) 2015-2016 Google Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and/or associated documentation files (the "Materials"), to
+ * deal in the Materials without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Materials, and to permit persons to whom the Materials
+ * are furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice(s) and this permission notice shall be included
+ * in all copies or substantial portions of the Materials.
+ *
+ * THE MATERIALS ARE PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE MATERIALS OR THE
+ * USE OR OTHER DEALINGS IN THE MATERIALS
+ */
+
+#ifndef LAYER_SLAB_ALLOCATOR_H
+#define LAYER_SLAB_ALLOCATOR_H
+
+#include <stdlib.h>
+#include <new>
+#include <vector>
+#include "vk_loader_platform.h"
+
+// Fixed-size allocator for the small per-object nodes layers keep for every
+// Vulkan handle. Nodes are carved out of slabs of SLAB_SLOTS entries and freed
+// nodes are recycled through an intrusive free list, so tracking an object costs
+// sizeof(T) instead of a separate heap block plus malloc bookkeeping. Slabs are
+// never returned to the heap, which keeps node addresses (and therefore any
+// handle derived from them) stable for the life of the layer.
+//
+// T must be a POD type; nodes are not constructed or destroyed here.
+template <typename T, size_t SLAB_SLOTS = 1024> class VkLayerSlabAllocator {
+  public:
+    VkLayerSlabAllocator() : freeList(NULL), liveNodes(0) { loader_platform_thread_create_mutex(&lock); }
+    ~VkLayerSlabAllocator() {
+        for (size_t i = 0; i < slabs.size(); i++)
+            free(slabs[i]);
+        loader_platform_thread_delete_mutex(&lock);
+    }
+
+    void *allocate() {
+        loader_platform_thread_lock_mutex(&lock);
+        if (!freeList && !grow()) {
+            loader_platform_thread_unlock_mutex(&lock);
+            throw std::bad_alloc();
+        }
+        slot *pSlot = freeList;
+        freeList = pSlot->next;
+        liveNodes++;
+        loader_platform_thread_unlock_mutex(&lock);
+        return pSlot;
+    }
+
+    void release(void *p) {
+        if (!p)
+            return;
+        slot *pSlot = static_cast<slot *>(p);
+        loader_platform_thread_lock_mutex(&lock);
+        pSlot->next = freeList;
+        freeList = pSlot;
+        liveNodes--;
+        loader_platform_thread_unlock_mutex(&lock);
+    }
+
+    // Footprint queries used for debug report statistics
+    size_t slabCount() {
+        loader_platform_thread_lock_mutex(&lock);
+        size_t count = slabs.size();
+        loader_platform_thread_unlock_mutex(&lock);
+        return count;
+    }
+    size_t liveCount() {
+        loader_platform_thread_lock_mutex(&lock);
+        size_t count = liveNodes;
+        loader_platform_thread_unlock_mutex(&lock);
+        return count;
+    }
+    static size_t bytesPerSlab() { return SLAB_SLOTS * sizeof(slot); }
+
+  private:
+    union slot {
+        slot *next;
+        T node;
+    };
+
+    bool grow() {
+        slot *slab = static_cast<slot *>(malloc(bytesPerSlab()));
+        if (!slab)
+            return false;
+        slabs.push_back(slab);
+        // Thread the new slots onto the free list in address order
+        for (size_t i = 0; i < SLAB_SLOTS - 1; i++)
+            slab[i].next = &slab[i + 1];
+        slab[SLAB_SLOTS - 1].next = freeList;
+        freeList = slab;
+        return true;
+    }
+
+    loader_platform_thread_mutex lock;
+    std::vector<slot *> slabs;
+    slot *freeList;
+    size_t liveNodes;
+};
+
+#endif // LAYER_SLAB_ALLOCATOR_H
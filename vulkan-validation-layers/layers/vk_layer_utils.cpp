@@ -25,6 +25,7 @@
  *
  */
 
+#include <stdlib.h>
 #include <string.h>
 #include <string>
 #include <vector>
@@ -653,3 +654,115 @@ void layer_debug_actions(debug_report_data *report_data, std::vector<VkDebugRepo
         logging_callback.push_back(callback);
     }
 }
+
+layer_profiler::layer_profiler()
+    : isEnabled(false), sampleMask(0), output(NULL), dumpCount(0), startTicks(0), period(0), nextDump(INT64_MAX) {
+    loader_platform_thread_create_mutex(&lock);
+}
+
+layer_profiler::~layer_profiler() {
+    if (output && output != stdout)
+        fclose(output);
+    loader_platform_thread_delete_mutex(&lock);
+}
+
+void layer_profiler::init(const char *layer_identifier) {
+    std::string profile_key = layer_identifier;
+    std::string sample_rate_key = layer_identifier;
+    std::string filename_key = layer_identifier;
+    std::string period_key = layer_identifier;
+    profile_key.append(".profile");
+    sample_rate_key.append(".profile_sample_rate");
+    filename_key.append(".profile_filename");
+    period_key.append(".profile_period");
+
+    loader_platform_thread_lock_mutex(&lock);
+    const char *profile = getLayerOption(profile_key.c_str());
+    if (isEnabled || !profile || strcmp(profile, "true")) {
+        loader_platform_thread_unlock_mutex(&lock);
+        return;
+    }
+
+    // Round the sample rate down to a power of two so sampling is a mask test
+    uint64_t rate = 64;
+    const char *rate_option = getLayerOption(sample_rate_key.c_str());
+    if (rate_option && atoi(rate_option) > 0)
+        rate = atoi(rate_option);
+    while (rate & (rate - 1))
+        rate &= rate - 1;
+    sampleMask = rate - 1;
+
+    layerName = layer_identifier;
+    const char *filename = getLayerOption(filename_key.c_str());
+    outputName = filename ? filename : "stdout";
+
+    startTime = std::chrono::steady_clock::now();
+    startTicks = layer_profile_ticks();
+    const char *period_option = getLayerOption(period_key.c_str());
+    if (period_option && atoi(period_option) > 0) {
+        period = std::chrono::seconds(atoi(period_option));
+        nextDump = (startTime + period).time_since_epoch().count();
+    }
+    isEnabled = true;
+    loader_platform_thread_unlock_mutex(&lock);
+}
+
+layer_profile_entry *layer_profiler::registerEntry(const char *name) {
+    loader_platform_thread_lock_mutex(&lock);
+    for (auto &entry : entries) {
+        if (!strcmp(entry.name, name)) {
+            loader_platform_thread_unlock_mutex(&lock);
+            return &entry;
+        }
+    }
+    entries.emplace_back();
+    layer_profile_entry *entry = &entries.back();
+    entry->name = name;
+    entry->calls = 0;
+    entry->sampledCalls = 0;
+    entry->sampledTicks = 0;
+    loader_platform_thread_unlock_mutex(&lock);
+    return entry;
+}
+
+void layer_profiler::addSample(layer_profile_entry *entry, uint64_t ticks) {
+    entry->sampledCalls.fetch_add(1, std::memory_order_relaxed);
+    entry->sampledTicks.fetch_add(ticks, std::memory_order_relaxed);
+
+    int64_t due = nextDump.load(std::memory_order_relaxed);
+    int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+    if (now >= due && nextDump.compare_exchange_strong(due, (std::chrono::steady_clock::now() + period).time_since_epoch().count()))
+        dump();
+}
+
+void layer_profiler::dump() {
+    if (!isEnabled)
+        return;
+
+    loader_platform_thread_lock_mutex(&lock);
+    if (!output)
+        output = getLayerLogOutput(outputName.c_str(), layerName.c_str());
+
+    // Convert sampled timestamp counter ticks to microseconds using the rate seen since init
+    double elapsed_us =
+        (double)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+    double ticks_per_us = elapsed_us > 0 ? (layer_profile_ticks() - startTicks) / elapsed_us : 1.0;
+    if (ticks_per_us <= 0)
+        ticks_per_us = 1.0;
+
+    fprintf(output, "# %s profile %u, sample rate %" PRIu64 ", %.0f ticks/us\n", layerName.c_str(), dumpCount++, sampleMask + 1,
+            ticks_per_us);
+    fprintf(output, "layer,entry_point,calls,sampled_calls,sampled_ticks,estimated_total_us\n");
+    for (auto &entry : entries) {
+        uint64_t calls = entry.calls.load(std::memory_order_relaxed);
+        uint64_t sampled_calls = entry.sampledCalls.load(std::memory_order_relaxed);
+        uint64_t sampled_ticks = entry.sampledTicks.load(std::memory_order_relaxed);
+        if (!calls)
+            continue;
+        double estimated_us = sampled_calls ? (double)sampled_ticks * calls / sampled_calls / ticks_per_us : 0.0;
+        fprintf(output, "%s,%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.1f\n", layerName.c_str(), entry.name, calls, sampled_calls,
+                sampled_ticks, estimated_us);
+    }
+    fflush(output);
+    loader_platform_thread_unlock_mutex(&lock);
+}
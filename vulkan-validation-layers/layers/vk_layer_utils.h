@@ -27,13 +27,18 @@
 
 #pragma once
 #include <stdbool.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <string>
 #include <vector>
 #include "vk_layer_logging.h"
 
 #ifndef WIN32
 #include <strings.h> /* for ffs() */
 #else
-#include <intrin.h> /* for __lzcnt() */
+#include <intrin.h> /* for __lzcnt() and __rdtsc() */
 #endif
 
 #ifdef __cplusplus
@@ -139,3 +144,88 @@ static inline int u_ffs(int val) {
 #ifdef __cplusplus
 }
 #endif
+
+// Sampling profiler for layer entry points.
+//
+// Every instrumented entry point counts its calls; one call out of every
+// <LayerIdentifier>.profile_sample_rate is also timed with the CPU timestamp
+// counter. Totals are written as CSV to <LayerIdentifier>.profile_filename when
+// the layer calls layer_profiler::dump() (on vkDestroyInstance) and, if
+// <LayerIdentifier>.profile_period is set, every profile_period seconds while
+// the application runs. When <LayerIdentifier>.profile is not "true" an entry
+// point pays for a single predictable branch.
+
+static inline uint64_t layer_profile_ticks() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    return __rdtsc();
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    return __builtin_ia32_rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+struct layer_profile_entry {
+    const char *name;
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> sampledCalls;
+    std::atomic<uint64_t> sampledTicks;
+};
+
+class layer_profiler {
+  public:
+    layer_profiler();
+    ~layer_profiler();
+
+    // Read the profiling options for layer_identifier; called from the layer's instance init
+    void init(const char *layer_identifier);
+    // Find or add the counters for an entry point. name must have static storage duration.
+    layer_profile_entry *registerEntry(const char *name);
+    // Write the counters gathered so far
+    void dump();
+
+    bool enabled() const { return isEnabled; }
+    bool sample(layer_profile_entry *entry) {
+        return (entry->calls.fetch_add(1, std::memory_order_relaxed) & sampleMask) == 0;
+    }
+    void addSample(layer_profile_entry *entry, uint64_t ticks);
+
+  private:
+    bool isEnabled;
+    uint64_t sampleMask;
+    std::string layerName;
+    std::string outputName;
+    FILE *output;
+    uint32_t dumpCount;
+    std::chrono::steady_clock::time_point startTime;
+    uint64_t startTicks;
+    std::chrono::steady_clock::duration period;
+    std::atomic<int64_t> nextDump;
+    loader_platform_thread_mutex lock;
+    std::deque<layer_profile_entry> entries;
+};
+
+// Times one call of the enclosing entry point when the profiler samples it
+class layer_profile_scope {
+  public:
+    layer_profile_scope(layer_profiler &profiler, layer_profile_entry *entry) : profiler(profiler), entry(NULL), start(0) {
+        if (profiler.enabled() && profiler.sample(entry)) {
+            this->entry = entry;
+            start = layer_profile_ticks();
+        }
+    }
+    ~layer_profile_scope() {
+        if (entry)
+            profiler.addSample(entry, layer_profile_ticks() - start);
+    }
+
+  private:
+    layer_profiler &profiler;
+    layer_profile_entry *entry;
+    uint64_t start;
+};
+
+// Place at the top of an entry point to account its CPU time to the layer
+#define LAYER_PROFILE_ENTRY_POINT(profiler)                                                                                        \
+    static layer_profile_entry *layer_profile_entry_ = (profiler).registerEntry(__FUNCTION__);                                      \
+    layer_profile_scope layer_profile_scope_((profiler), layer_profile_entry_)
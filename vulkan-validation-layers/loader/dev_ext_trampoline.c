@@ -25,6 +25,7 @@
  * Author: Jon Ashburn <jon@lunarg.com>
  */
 
+#define _GNU_SOURCE
 #include "vk_loader_platform.h"
 #include "loader.h"
 #if defined(__linux__)
@@ -34,6 +34,7 @@
 #include <stdlib.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 
 #include <sys/types.h>
@@ -1446,6 +1447,364 @@ static void loader_debug_init(void) {
     loader_free_getenv(orig);
 }
 
+/*
+ * The core entrypoints handed out by vkGetInstanceProcAddr and
+ * vkGetDeviceProcAddr are found through murmurhash indexed tables built once
+ * in loader_initialize, rather than by comparing the name against every
+ * entrypoint in turn.
+ */
+#define LOADER_NAME_HASH_SIZE 512
+
+struct loader_name_hash {
+    const void *entries; // each entry starts with its const char *name
+    size_t stride;
+    uint16_t slot[LOADER_NAME_HASH_SIZE]; // entry index + 1, 0 if empty
+};
+
+struct loader_dispatch_offset {
+    const char *name;
+    size_t offset;
+};
+
+struct loader_trampoline_entry {
+    const char *name;
+    PFN_vkVoidFunction func;
+};
+
+#define DEVICE_DISPATCH_OFFSET(fn)                                             \
+    { "vk" #fn, offsetof(VkLayerDispatchTable, fn) }
+
+static const struct loader_dispatch_offset loader_device_dispatch_offsets[] = {
+    DEVICE_DISPATCH_OFFSET(GetDeviceProcAddr),
+    DEVICE_DISPATCH_OFFSET(DestroyDevice),
+    DEVICE_DISPATCH_OFFSET(GetDeviceQueue),
+    DEVICE_DISPATCH_OFFSET(QueueSubmit),
+    DEVICE_DISPATCH_OFFSET(QueueWaitIdle),
+    DEVICE_DISPATCH_OFFSET(DeviceWaitIdle),
+    DEVICE_DISPATCH_OFFSET(AllocateMemory),
+    DEVICE_DISPATCH_OFFSET(FreeMemory),
+    DEVICE_DISPATCH_OFFSET(MapMemory),
+    DEVICE_DISPATCH_OFFSET(UnmapMemory),
+    DEVICE_DISPATCH_OFFSET(FlushMappedMemoryRanges),
+    DEVICE_DISPATCH_OFFSET(InvalidateMappedMemoryRanges),
+    DEVICE_DISPATCH_OFFSET(GetDeviceMemoryCommitment),
+    DEVICE_DISPATCH_OFFSET(GetImageSparseMemoryRequirements),
+    DEVICE_DISPATCH_OFFSET(GetBufferMemoryRequirements),
+    DEVICE_DISPATCH_OFFSET(GetImageMemoryRequirements),
+    DEVICE_DISPATCH_OFFSET(BindBufferMemory),
+    DEVICE_DISPATCH_OFFSET(BindImageMemory),
+    DEVICE_DISPATCH_OFFSET(QueueBindSparse),
+    DEVICE_DISPATCH_OFFSET(CreateFence),
+    DEVICE_DISPATCH_OFFSET(DestroyFence),
+    DEVICE_DISPATCH_OFFSET(ResetFences),
+    DEVICE_DISPATCH_OFFSET(GetFenceStatus),
+    DEVICE_DISPATCH_OFFSET(WaitForFences),
+    DEVICE_DISPATCH_OFFSET(CreateSemaphore),
+    DEVICE_DISPATCH_OFFSET(DestroySemaphore),
+    DEVICE_DISPATCH_OFFSET(CreateEvent),
+    DEVICE_DISPATCH_OFFSET(DestroyEvent),
+    DEVICE_DISPATCH_OFFSET(GetEventStatus),
+    DEVICE_DISPATCH_OFFSET(SetEvent),
+    DEVICE_DISPATCH_OFFSET(ResetEvent),
+    DEVICE_DISPATCH_OFFSET(CreateQueryPool),
+    DEVICE_DISPATCH_OFFSET(DestroyQueryPool),
+    DEVICE_DISPATCH_OFFSET(GetQueryPoolResults),
+    DEVICE_DISPATCH_OFFSET(CreateBuffer),
+    DEVICE_DISPATCH_OFFSET(DestroyBuffer),
+    DEVICE_DISPATCH_OFFSET(CreateBufferView),
+    DEVICE_DISPATCH_OFFSET(DestroyBufferView),
+    DEVICE_DISPATCH_OFFSET(CreateImage),
+    DEVICE_DISPATCH_OFFSET(DestroyImage),
+    DEVICE_DISPATCH_OFFSET(GetImageSubresourceLayout),
+    DEVICE_DISPATCH_OFFSET(CreateImageView),
+    DEVICE_DISPATCH_OFFSET(DestroyImageView),
+    DEVICE_DISPATCH_OFFSET(CreateShaderModule),
+    DEVICE_DISPATCH_OFFSET(DestroyShaderModule),
+    DEVICE_DISPATCH_OFFSET(CreatePipelineCache),
+    DEVICE_DISPATCH_OFFSET(DestroyPipelineCache),
+    DEVICE_DISPATCH_OFFSET(GetPipelineCacheData),
+    DEVICE_DISPATCH_OFFSET(MergePipelineCaches),
+    DEVICE_DISPATCH_OFFSET(CreateGraphicsPipelines),
+    DEVICE_DISPATCH_OFFSET(CreateComputePipelines),
+    DEVICE_DISPATCH_OFFSET(DestroyPipeline),
+    DEVICE_DISPATCH_OFFSET(CreatePipelineLayout),
+    DEVICE_DISPATCH_OFFSET(DestroyPipelineLayout),
+    DEVICE_DISPATCH_OFFSET(CreateSampler),
+    DEVICE_DISPATCH_OFFSET(DestroySampler),
+    DEVICE_DISPATCH_OFFSET(CreateDescriptorSetLayout),
+    DEVICE_DISPATCH_OFFSET(DestroyDescriptorSetLayout),
+    DEVICE_DISPATCH_OFFSET(CreateDescriptorPool),
+    DEVICE_DISPATCH_OFFSET(DestroyDescriptorPool),
+    DEVICE_DISPATCH_OFFSET(ResetDescriptorPool),
+    DEVICE_DISPATCH_OFFSET(AllocateDescriptorSets),
+    DEVICE_DISPATCH_OFFSET(FreeDescriptorSets),
+    DEVICE_DISPATCH_OFFSET(UpdateDescriptorSets),
+    DEVICE_DISPATCH_OFFSET(CreateFramebuffer),
+    DEVICE_DISPATCH_OFFSET(DestroyFramebuffer),
+    DEVICE_DISPATCH_OFFSET(CreateRenderPass),
+    DEVICE_DISPATCH_OFFSET(DestroyRenderPass),
+    DEVICE_DISPATCH_OFFSET(GetRenderAreaGranularity),
+    DEVICE_DISPATCH_OFFSET(CreateCommandPool),
+    DEVICE_DISPATCH_OFFSET(DestroyCommandPool),
+    DEVICE_DISPATCH_OFFSET(ResetCommandPool),
+    DEVICE_DISPATCH_OFFSET(AllocateCommandBuffers),
+    DEVICE_DISPATCH_OFFSET(FreeCommandBuffers),
+    DEVICE_DISPATCH_OFFSET(BeginCommandBuffer),
+    DEVICE_DISPATCH_OFFSET(EndCommandBuffer),
+    DEVICE_DISPATCH_OFFSET(ResetCommandBuffer),
+    DEVICE_DISPATCH_OFFSET(CmdBindPipeline),
+    DEVICE_DISPATCH_OFFSET(CmdSetViewport),
+    DEVICE_DISPATCH_OFFSET(CmdSetScissor),
+    DEVICE_DISPATCH_OFFSET(CmdSetLineWidth),
+    DEVICE_DISPATCH_OFFSET(CmdSetDepthBias),
+    DEVICE_DISPATCH_OFFSET(CmdSetBlendConstants),
+    DEVICE_DISPATCH_OFFSET(CmdSetDepthBounds),
+    DEVICE_DISPATCH_OFFSET(CmdSetStencilCompareMask),
+    DEVICE_DISPATCH_OFFSET(CmdSetStencilWriteMask),
+    DEVICE_DISPATCH_OFFSET(CmdSetStencilReference),
+    DEVICE_DISPATCH_OFFSET(CmdBindDescriptorSets),
+    DEVICE_DISPATCH_OFFSET(CmdBindVertexBuffers),
+    DEVICE_DISPATCH_OFFSET(CmdBindIndexBuffer),
+    DEVICE_DISPATCH_OFFSET(CmdDraw),
+    DEVICE_DISPATCH_OFFSET(CmdDrawIndexed),
+    DEVICE_DISPATCH_OFFSET(CmdDrawIndirect),
+    DEVICE_DISPATCH_OFFSET(CmdDrawIndexedIndirect),
+    DEVICE_DISPATCH_OFFSET(CmdDispatch),
+    DEVICE_DISPATCH_OFFSET(CmdDispatchIndirect),
+    DEVICE_DISPATCH_OFFSET(CmdCopyBuffer),
+    DEVICE_DISPATCH_OFFSET(CmdCopyImage),
+    DEVICE_DISPATCH_OFFSET(CmdBlitImage),
+    DEVICE_DISPATCH_OFFSET(CmdCopyBufferToImage),
+    DEVICE_DISPATCH_OFFSET(CmdCopyImageToBuffer),
+    DEVICE_DISPATCH_OFFSET(CmdUpdateBuffer),
+    DEVICE_DISPATCH_OFFSET(CmdFillBuffer),
+    DEVICE_DISPATCH_OFFSET(CmdClearColorImage),
+    DEVICE_DISPATCH_OFFSET(CmdClearDepthStencilImage),
+    DEVICE_DISPATCH_OFFSET(CmdClearAttachments),
+    DEVICE_DISPATCH_OFFSET(CmdResolveImage),
+    DEVICE_DISPATCH_OFFSET(CmdSetEvent),
+    DEVICE_DISPATCH_OFFSET(CmdResetEvent),
+    DEVICE_DISPATCH_OFFSET(CmdWaitEvents),
+    DEVICE_DISPATCH_OFFSET(CmdPipelineBarrier),
+    DEVICE_DISPATCH_OFFSET(CmdBeginQuery),
+    DEVICE_DISPATCH_OFFSET(CmdEndQuery),
+    DEVICE_DISPATCH_OFFSET(CmdResetQueryPool),
+    DEVICE_DISPATCH_OFFSET(CmdWriteTimestamp),
+    DEVICE_DISPATCH_OFFSET(CmdCopyQueryPoolResults),
+    DEVICE_DISPATCH_OFFSET(CmdPushConstants),
+    DEVICE_DISPATCH_OFFSET(CmdBeginRenderPass),
+    DEVICE_DISPATCH_OFFSET(CmdNextSubpass),
+    DEVICE_DISPATCH_OFFSET(CmdEndRenderPass),
+    DEVICE_DISPATCH_OFFSET(CmdExecuteCommands),
+};
+
+#define TRAMPOLINE_ENTRY(fn)                                                   \
+    { #fn, (PFN_vkVoidFunction)fn }
+
+static const struct loader_trampoline_entry loader_trampoline_entries[] = {
+    TRAMPOLINE_ENTRY(vkGetInstanceProcAddr),
+    TRAMPOLINE_ENTRY(vkDestroyInstance),
+    TRAMPOLINE_ENTRY(vkEnumeratePhysicalDevices),
+    TRAMPOLINE_ENTRY(vkGetPhysicalDeviceFeatures),
+    TRAMPOLINE_ENTRY(vkGetPhysicalDeviceFormatProperties),
+    TRAMPOLINE_ENTRY(vkGetPhysicalDeviceImageFormatProperties),
+    TRAMPOLINE_ENTRY(vkGetPhysicalDeviceSparseImageFormatProperties),
+    TRAMPOLINE_ENTRY(vkGetPhysicalDeviceProperties),
+    TRAMPOLINE_ENTRY(vkGetPhysicalDeviceQueueFamilyProperties),
+    TRAMPOLINE_ENTRY(vkGetPhysicalDeviceMemoryProperties),
+    TRAMPOLINE_ENTRY(vkEnumerateDeviceLayerProperties),
+    TRAMPOLINE_ENTRY(vkEnumerateDeviceExtensionProperties),
+    TRAMPOLINE_ENTRY(vkCreateDevice),
+    TRAMPOLINE_ENTRY(vkGetDeviceProcAddr),
+    TRAMPOLINE_ENTRY(vkDestroyDevice),
+    TRAMPOLINE_ENTRY(vkGetDeviceQueue),
+    TRAMPOLINE_ENTRY(vkQueueSubmit),
+    TRAMPOLINE_ENTRY(vkQueueWaitIdle),
+    TRAMPOLINE_ENTRY(vkDeviceWaitIdle),
+    TRAMPOLINE_ENTRY(vkAllocateMemory),
+    TRAMPOLINE_ENTRY(vkFreeMemory),
+    TRAMPOLINE_ENTRY(vkMapMemory),
+    TRAMPOLINE_ENTRY(vkUnmapMemory),
+    TRAMPOLINE_ENTRY(vkFlushMappedMemoryRanges),
+    TRAMPOLINE_ENTRY(vkInvalidateMappedMemoryRanges),
+    TRAMPOLINE_ENTRY(vkGetDeviceMemoryCommitment),
+    TRAMPOLINE_ENTRY(vkGetImageSparseMemoryRequirements),
+    TRAMPOLINE_ENTRY(vkGetImageMemoryRequirements),
+    TRAMPOLINE_ENTRY(vkGetBufferMemoryRequirements),
+    TRAMPOLINE_ENTRY(vkBindImageMemory),
+    TRAMPOLINE_ENTRY(vkBindBufferMemory),
+    TRAMPOLINE_ENTRY(vkQueueBindSparse),
+    TRAMPOLINE_ENTRY(vkCreateFence),
+    TRAMPOLINE_ENTRY(vkDestroyFence),
+    TRAMPOLINE_ENTRY(vkGetFenceStatus),
+    TRAMPOLINE_ENTRY(vkResetFences),
+    TRAMPOLINE_ENTRY(vkWaitForFences),
+    TRAMPOLINE_ENTRY(vkCreateSemaphore),
+    TRAMPOLINE_ENTRY(vkDestroySemaphore),
+    TRAMPOLINE_ENTRY(vkCreateEvent),
+    TRAMPOLINE_ENTRY(vkDestroyEvent),
+    TRAMPOLINE_ENTRY(vkGetEventStatus),
+    TRAMPOLINE_ENTRY(vkSetEvent),
+    TRAMPOLINE_ENTRY(vkResetEvent),
+    TRAMPOLINE_ENTRY(vkCreateQueryPool),
+    TRAMPOLINE_ENTRY(vkDestroyQueryPool),
+    TRAMPOLINE_ENTRY(vkGetQueryPoolResults),
+    TRAMPOLINE_ENTRY(vkCreateBuffer),
+    TRAMPOLINE_ENTRY(vkDestroyBuffer),
+    TRAMPOLINE_ENTRY(vkCreateBufferView),
+    TRAMPOLINE_ENTRY(vkDestroyBufferView),
+    TRAMPOLINE_ENTRY(vkCreateImage),
+    TRAMPOLINE_ENTRY(vkDestroyImage),
+    TRAMPOLINE_ENTRY(vkGetImageSubresourceLayout),
+    TRAMPOLINE_ENTRY(vkCreateImageView),
+    TRAMPOLINE_ENTRY(vkDestroyImageView),
+    TRAMPOLINE_ENTRY(vkCreateShaderModule),
+    TRAMPOLINE_ENTRY(vkDestroyShaderModule),
+    TRAMPOLINE_ENTRY(vkCreatePipelineCache),
+    TRAMPOLINE_ENTRY(vkDestroyPipelineCache),
+    TRAMPOLINE_ENTRY(vkGetPipelineCacheData),
+    TRAMPOLINE_ENTRY(vkMergePipelineCaches),
+    TRAMPOLINE_ENTRY(vkCreateGraphicsPipelines),
+    TRAMPOLINE_ENTRY(vkCreateComputePipelines),
+    TRAMPOLINE_ENTRY(vkDestroyPipeline),
+    TRAMPOLINE_ENTRY(vkCreatePipelineLayout),
+    TRAMPOLINE_ENTRY(vkDestroyPipelineLayout),
+    TRAMPOLINE_ENTRY(vkCreateSampler),
+    TRAMPOLINE_ENTRY(vkDestroySampler),
+    TRAMPOLINE_ENTRY(vkCreateDescriptorSetLayout),
+    TRAMPOLINE_ENTRY(vkDestroyDescriptorSetLayout),
+    TRAMPOLINE_ENTRY(vkCreateDescriptorPool),
+    TRAMPOLINE_ENTRY(vkDestroyDescriptorPool),
+    TRAMPOLINE_ENTRY(vkResetDescriptorPool),
+    TRAMPOLINE_ENTRY(vkAllocateDescriptorSets),
+    TRAMPOLINE_ENTRY(vkFreeDescriptorSets),
+    TRAMPOLINE_ENTRY(vkUpdateDescriptorSets),
+    TRAMPOLINE_ENTRY(vkCreateFramebuffer),
+    TRAMPOLINE_ENTRY(vkDestroyFramebuffer),
+    TRAMPOLINE_ENTRY(vkCreateRenderPass),
+    TRAMPOLINE_ENTRY(vkDestroyRenderPass),
+    TRAMPOLINE_ENTRY(vkGetRenderAreaGranularity),
+    TRAMPOLINE_ENTRY(vkCreateCommandPool),
+    TRAMPOLINE_ENTRY(vkDestroyCommandPool),
+    TRAMPOLINE_ENTRY(vkResetCommandPool),
+    TRAMPOLINE_ENTRY(vkAllocateCommandBuffers),
+    TRAMPOLINE_ENTRY(vkFreeCommandBuffers),
+    TRAMPOLINE_ENTRY(vkBeginCommandBuffer),
+    TRAMPOLINE_ENTRY(vkEndCommandBuffer),
+    TRAMPOLINE_ENTRY(vkResetCommandBuffer),
+    TRAMPOLINE_ENTRY(vkCmdBindPipeline),
+    TRAMPOLINE_ENTRY(vkCmdBindDescriptorSets),
+    TRAMPOLINE_ENTRY(vkCmdBindVertexBuffers),
+    TRAMPOLINE_ENTRY(vkCmdBindIndexBuffer),
+    TRAMPOLINE_ENTRY(vkCmdSetViewport),
+    TRAMPOLINE_ENTRY(vkCmdSetScissor),
+    TRAMPOLINE_ENTRY(vkCmdSetLineWidth),
+    TRAMPOLINE_ENTRY(vkCmdSetDepthBias),
+    TRAMPOLINE_ENTRY(vkCmdSetBlendConstants),
+    TRAMPOLINE_ENTRY(vkCmdSetDepthBounds),
+    TRAMPOLINE_ENTRY(vkCmdSetStencilCompareMask),
+    TRAMPOLINE_ENTRY(vkCmdSetStencilWriteMask),
+    TRAMPOLINE_ENTRY(vkCmdSetStencilReference),
+    TRAMPOLINE_ENTRY(vkCmdDraw),
+    TRAMPOLINE_ENTRY(vkCmdDrawIndexed),
+    TRAMPOLINE_ENTRY(vkCmdDrawIndirect),
+    TRAMPOLINE_ENTRY(vkCmdDrawIndexedIndirect),
+    TRAMPOLINE_ENTRY(vkCmdDispatch),
+    TRAMPOLINE_ENTRY(vkCmdDispatchIndirect),
+    TRAMPOLINE_ENTRY(vkCmdCopyBuffer),
+    TRAMPOLINE_ENTRY(vkCmdCopyImage),
+    TRAMPOLINE_ENTRY(vkCmdBlitImage),
+    TRAMPOLINE_ENTRY(vkCmdCopyBufferToImage),
+    TRAMPOLINE_ENTRY(vkCmdCopyImageToBuffer),
+    TRAMPOLINE_ENTRY(vkCmdUpdateBuffer),
+    TRAMPOLINE_ENTRY(vkCmdFillBuffer),
+    TRAMPOLINE_ENTRY(vkCmdClearColorImage),
+    TRAMPOLINE_ENTRY(vkCmdClearDepthStencilImage),
+    TRAMPOLINE_ENTRY(vkCmdClearAttachments),
+    TRAMPOLINE_ENTRY(vkCmdResolveImage),
+    TRAMPOLINE_ENTRY(vkCmdSetEvent),
+    TRAMPOLINE_ENTRY(vkCmdResetEvent),
+    TRAMPOLINE_ENTRY(vkCmdWaitEvents),
+    TRAMPOLINE_ENTRY(vkCmdPipelineBarrier),
+    TRAMPOLINE_ENTRY(vkCmdBeginQuery),
+    TRAMPOLINE_ENTRY(vkCmdEndQuery),
+    TRAMPOLINE_ENTRY(vkCmdResetQueryPool),
+    TRAMPOLINE_ENTRY(vkCmdWriteTimestamp),
+    TRAMPOLINE_ENTRY(vkCmdCopyQueryPoolResults),
+    TRAMPOLINE_ENTRY(vkCmdPushConstants),
+    TRAMPOLINE_ENTRY(vkCmdBeginRenderPass),
+    TRAMPOLINE_ENTRY(vkCmdNextSubpass),
+    TRAMPOLINE_ENTRY(vkCmdEndRenderPass),
+    TRAMPOLINE_ENTRY(vkCmdExecuteCommands),
+};
+
+static struct loader_name_hash loader_device_dispatch_hash;
+static struct loader_name_hash loader_trampoline_hash;
+
+static inline const char *loader_name_hash_name(
+    const struct loader_name_hash *hash, uint32_t index) {
+    return *(const char *const *)((const char *)hash->entries +
+                                  index * hash->stride);
+}
+
+static void loader_name_hash_init(struct loader_name_hash *hash,
+                                  const void *entries, size_t stride,
+                                  uint32_t count) {
+    hash->entries = entries;
+    hash->stride = stride;
+    memset(hash->slot, 0, sizeof(hash->slot));
+    for (uint32_t i = 0; i < count; i++) {
+        const char *name = loader_name_hash_name(hash, i);
+        uint32_t idx = murmurhash(name, strlen(name), 0) &
+                       (LOADER_NAME_HASH_SIZE - 1);
+        while (hash->slot[idx])
+            idx = (idx + 1) & (LOADER_NAME_HASH_SIZE - 1);
+        hash->slot[idx] = (uint16_t)(i + 1);
+    }
+}
+
+// Returns the index of the entry called name, or -1 if there is none
+static int32_t loader_name_hash_find(const struct loader_name_hash *hash,
+                                     const char *name) {
+    uint32_t idx = murmurhash(name, strlen(name), 0) &
+                   (LOADER_NAME_HASH_SIZE - 1);
+    while (hash->slot[idx]) {
+        uint32_t i = hash->slot[idx] - 1;
+        if (!strcmp(name, loader_name_hash_name(hash, i)))
+            return (int32_t)i;
+        idx = (idx + 1) & (LOADER_NAME_HASH_SIZE - 1);
+    }
+    return -1;
+}
+
+/**
+ * Look up a core device entrypoint in a device dispatch table.  The table
+ * holds the first layer's or ICD's function, so callers get it directly and
+ * skip the loader trampoline.
+ */
+void *loader_lookup_device_dispatch_table(const VkLayerDispatchTable *table,
+                                          const char *name) {
+    if (!name)
+        return NULL;
+
+    int32_t i = loader_name_hash_find(&loader_device_dispatch_hash, name);
+    if (i < 0)
+        return NULL;
+    return (void *)*(const PFN_vkVoidFunction *)(
+        (const char *)table + loader_device_dispatch_offsets[i].offset);
+}
+
+// Look up the trampoline for a core instance or device entrypoint
+void *loader_lookup_trampoline(const char *name) {
+    if (!name)
+        return NULL;
+
+    int32_t i = loader_name_hash_find(&loader_trampoline_hash, name);
+    if (i < 0)
+        return NULL;
+    return (void *)loader_trampoline_entries[i].func;
+}
+
 void loader_initialize(void) {
     // initialize mutexs
     loader_platform_thread_create_mutex(&loader_lock);
@@ -1459,6 +1818,16 @@ void loader_initialize(void) {
         .malloc_fn = loader_tls_heap_alloc, .free_fn = loader_tls_heap_free,
     };
     cJSON_InitHooks(&alloc_fns);
+
+    loader_name_hash_init(&loader_device_dispatch_hash,
+                          loader_device_dispatch_offsets,
+                          sizeof(loader_device_dispatch_offsets[0]),
+                          sizeof(loader_device_dispatch_offsets) /
+                              sizeof(loader_device_dispatch_offsets[0]));
+    loader_name_hash_init(&loader_trampoline_hash, loader_trampoline_entries,
+                          sizeof(loader_trampoline_entries[0]),
+                          sizeof(loader_trampoline_entries) /
+                              sizeof(loader_trampoline_entries[0]));
 }
 
 struct loader_manifest_files {
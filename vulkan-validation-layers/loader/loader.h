@@ -500,6 +500,9 @@ void loader_init_dispatch_dev_ext(struct loader_instance *inst,
                                   struct loader_device *dev);
 void *loader_dev_ext_gpa(struct loader_instance *inst, const char *funcName);
 void *loader_get_dev_ext_trampoline(uint32_t index);
+void *loader_lookup_device_dispatch_table(const VkLayerDispatchTable *table,
+                                          const char *name);
+void *loader_lookup_trampoline(const char *name);
 struct loader_instance *loader_get_instance(const VkInstance instance);
 struct loader_device *
 loader_add_logical_device(const struct loader_instance *inst,
@@ -224,6 +224,33 @@ loader_platform_thread_cond_broadcast(loader_platform_thread_cond *pCond) {
     pthread_cond_broadcast(pCond);
 }
 
+// Thread reader/writer lock:
+typedef pthread_rwlock_t loader_platform_thread_rwlock;
+static inline void
+loader_platform_thread_create_rwlock(loader_platform_thread_rwlock *pLock) {
+    pthread_rwlock_init(pLock, NULL);
+}
+static inline void
+loader_platform_thread_read_lock(loader_platform_thread_rwlock *pLock) {
+    pthread_rwlock_rdlock(pLock);
+}
+static inline void
+loader_platform_thread_read_unlock(loader_platform_thread_rwlock *pLock) {
+    pthread_rwlock_unlock(pLock);
+}
+static inline void
+loader_platform_thread_write_lock(loader_platform_thread_rwlock *pLock) {
+    pthread_rwlock_wrlock(pLock);
+}
+static inline void
+loader_platform_thread_write_unlock(loader_platform_thread_rwlock *pLock) {
+    pthread_rwlock_unlock(pLock);
+}
+static inline void
+loader_platform_thread_delete_rwlock(loader_platform_thread_rwlock *pLock) {
+    pthread_rwlock_destroy(pLock);
+}
+
 #define loader_stack_alloc(size) alloca(size)
 
 #elif defined(_WIN32) // defined(__linux__)
@@ -429,6 +456,34 @@ loader_platform_thread_cond_broadcast(loader_platform_thread_cond *pCond) {
     WakeAllConditionVariable(pCond);
 }
 
+// Thread reader/writer lock:
+typedef SRWLOCK loader_platform_thread_rwlock;
+static void
+loader_platform_thread_create_rwlock(loader_platform_thread_rwlock *pLock) {
+    InitializeSRWLock(pLock);
+}
+static void
+loader_platform_thread_read_lock(loader_platform_thread_rwlock *pLock) {
+    AcquireSRWLockShared(pLock);
+}
+static void
+loader_platform_thread_read_unlock(loader_platform_thread_rwlock *pLock) {
+    ReleaseSRWLockShared(pLock);
+}
+static void
+loader_platform_thread_write_lock(loader_platform_thread_rwlock *pLock) {
+    AcquireSRWLockExclusive(pLock);
+}
+static void
+loader_platform_thread_write_unlock(loader_platform_thread_rwlock *pLock) {
+    ReleaseSRWLockExclusive(pLock);
+}
+static void
+loader_platform_thread_delete_rwlock(loader_platform_thread_rwlock *pLock) {
+    // SRW locks don't need to be destroyed
+    (void)pLock;
+}
+
 // Windows Registry:
 char *loader_get_registry_string(const HKEY hive, const LPCTSTR sub_key,
                                  const char *value);
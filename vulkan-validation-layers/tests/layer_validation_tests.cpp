@@ -4926,6 +4926,86 @@ TEST_F(VkLayerTest, ThreadCommandBufferCollision) {
 
     vkDestroyEvent(device(), event, NULL);
 }
+
+extern "C" void *RecordCommandBuffer(void *arg) {
+    struct thread_data_struct *data = (struct thread_data_struct *)arg;
+    VkViewport viewport = {0.0f, 0.0f, 64.0f, 64.0f, 0.0f, 1.0f};
+    VkRect2D scissor = {{0, 0}, {64, 64}};
+
+    for (int i = 0; i < 10000; i++) {
+        vkCmdSetViewport(data->commandBuffer, 0, 1, &viewport);
+        vkCmdSetScissor(data->commandBuffer, 0, 1, &scissor);
+        vkCmdSetLineWidth(data->commandBuffer, 1.0f);
+        vkCmdSetEvent(data->commandBuffer, data->event,
+                      VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+    }
+    return NULL;
+}
+
+TEST_F(VkLayerTest, ThreadCommandBufferParallelRecording) {
+    const int threadCount = 4;
+    test_platform_thread threads[threadCount];
+    struct thread_data_struct data[threadCount];
+    VkCommandPool commandPools[threadCount];
+    VkCommandBufferObj *commandBuffers[threadCount];
+
+    // Any error at all means recording on separate command buffers
+    // interfered with each other
+    m_errorMonitor->SetDesiredFailureMsg(VK_DEBUG_REPORT_ERROR_BIT_EXT, "");
+
+    ASSERT_NO_FATAL_FAILURE(InitState());
+    ASSERT_NO_FATAL_FAILURE(InitViewport());
+    ASSERT_NO_FATAL_FAILURE(InitRenderTarget());
+
+    VkEventCreateInfo event_info;
+    VkEvent event;
+    VkResult err;
+
+    memset(&event_info, 0, sizeof(event_info));
+    event_info.sType = VK_STRUCTURE_TYPE_EVENT_CREATE_INFO;
+
+    err = vkCreateEvent(device(), &event_info, NULL, &event);
+    ASSERT_VK_SUCCESS(err);
+
+    // Command pools are externally synchronized too, so give each thread its own
+    VkCommandPoolCreateInfo cmd_pool_info = {};
+    cmd_pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    cmd_pool_info.queueFamilyIndex = m_device->graphics_queue_node_index_;
+    for (int i = 0; i < threadCount; i++) {
+        err = vkCreateCommandPool(device(), &cmd_pool_info, NULL,
+                                  &commandPools[i]);
+        ASSERT_VK_SUCCESS(err);
+        commandBuffers[i] = new VkCommandBufferObj(m_device, commandPools[i]);
+        commandBuffers[i]->BeginCommandBuffer();
+        data[i].commandBuffer = commandBuffers[i]->GetBufferHandle();
+        data[i].event = event;
+        data[i].bailout = false;
+    }
+
+    for (int i = 1; i < threadCount; i++) {
+        test_platform_thread_create(&threads[i], RecordCommandBuffer,
+                                    (void *)&data[i]);
+    }
+    RecordCommandBuffer(&data[0]);
+    for (int i = 1; i < threadCount; i++) {
+        test_platform_thread_join(threads[i], NULL);
+    }
+
+    for (int i = 0; i < threadCount; i++) {
+        commandBuffers[i]->EndCommandBuffer();
+    }
+
+    if (m_errorMonitor->DesiredMsgFound()) {
+        FAIL() << "Recording separate command buffers in parallel reported: "
+               << m_errorMonitor->GetFailureMsg();
+    }
+
+    for (int i = 0; i < threadCount; i++) {
+        delete commandBuffers[i];
+        vkDestroyCommandPool(device(), commandPools[i], NULL);
+    }
+    vkDestroyEvent(device(), event, NULL);
+}
 #endif // GTEST_IS_THREADSAFE
 #endif // THREADING_TESTS
 
@@ -55,7 +55,7 @@
 extern "C" {
 #endif
 
-#define WEBP_DEMUX_ABI_VERSION 0x0107    // MAJOR(8b) + MINOR(8b)
+#define WEBP_DEMUX_ABI_VERSION 0x0109    // MAJOR(8b) + MINOR(8b)
 
 // Note: forward declaring enumerations is not allowed in (strict) C and C++,
 // the types are left here for reference.
@@ -174,6 +174,17 @@ WEBP_EXTERN(int) WebPDemuxPrevFrame(WebPIterator* iter);
 // WebPDemuxDelete().
 WEBP_EXTERN(void) WebPDemuxReleaseIterator(WebPIterator* iter);
 
+// Retrieves the byte range of frame 'frame_number' within the data passed to
+// WebPDemux(): on success '*offset' and '*size' locate the same bytes as
+// 'iter->fragment' would. Frame lookup is constant time. Parsing only reads
+// chunk headers and the start of each image bitstream, so with a memory-mapped
+// file a player can seek to any frame and page in just that range.
+// Setting 'frame_number' equal to 0 will return the last frame of the image.
+// Returns false if 'dmux' is NULL or frame 'frame_number' is not present.
+WEBP_EXTERN(int) WebPDemuxGetFrameRange(const WebPDemuxer* dmux,
+                                        int frame_number,
+                                        size_t* offset, size_t* size);
+
 //------------------------------------------------------------------------------
 // Chunk iteration.
 
@@ -248,7 +259,12 @@ struct WebPAnimDecoderOptions {
   // MODE_RGBA, MODE_BGRA, MODE_rgbA and MODE_bgrA.
   WEBP_CSP_MODE color_mode;
   int use_threads;           // If true, use multi-threaded decoding.
-  uint32_t padding[7];       // Padding for later use.
+  // If > 0, up to this many upcoming key-frames (frames that don't depend on
+  // the previous canvas) are decoded ahead of time on worker threads, while
+  // the current frame is being displayed. Costs one canvas of memory each.
+  // Only effective if the library was built with thread support.
+  int lookahead;
+  uint32_t padding[6];       // Padding for later use.
 };
 
 // Internal, version-checked, entry point.
@@ -180,14 +180,24 @@ static int AppendToMemBuffer(WebPIDecoder* const idec,
     const size_t new_mem_start = old_start - old_base;
     const size_t current_size = MemDataSize(mem) + new_mem_start;
     const uint64_t new_size = (uint64_t)current_size + data_size;
-    const uint64_t extra_size = (new_size + CHUNK_SIZE - 1) & ~(CHUNK_SIZE - 1);
-    uint8_t* const new_buf =
-        (uint8_t*)WebPSafeMalloc(extra_size, sizeof(*new_buf));
-    if (new_buf == NULL) return 0;
-    memcpy(new_buf, old_base, current_size);
-    WebPSafeFree(mem->buf_);
-    mem->buf_ = new_buf;
-    mem->buf_size_ = (size_t)extra_size;
+    if (new_size <= mem->buf_size_) {
+      // Dropping the already consumed data makes enough room.
+      memmove(mem->buf_, old_base, current_size);
+    } else {
+      // Grow geometrically, so that appending many small chunks to data that
+      // can't be released (lossless, or several partitions) stays linear.
+      const uint64_t grown_size = (uint64_t)mem->buf_size_ * 3 / 2;
+      const uint64_t min_size = (new_size > grown_size) ? new_size : grown_size;
+      const uint64_t extra_size =
+          (min_size + CHUNK_SIZE - 1) & ~(CHUNK_SIZE - 1);
+      uint8_t* const new_buf =
+          (uint8_t*)WebPSafeMalloc(extra_size, sizeof(*new_buf));
+      if (new_buf == NULL) return 0;
+      memcpy(new_buf, old_base, current_size);
+      WebPSafeFree(mem->buf_);
+      mem->buf_ = new_buf;
+      mem->buf_size_ = (size_t)extra_size;
+    }
     mem->start_ = new_mem_start;
     mem->end_ = current_size;
   }
@@ -200,6 +210,67 @@ static int AppendToMemBuffer(WebPIDecoder* const idec,
   return 1;
 }
 
+// In append mode, when no data is pending, the decoder reads straight from the
+// caller's buffer instead of copying it first: BorrowMemBuffer() points the
+// MemBuffer to 'data', and ReturnMemBuffer() copies back the bytes that are
+// still needed once decoding stops. Compressed images are typically mostly
+// consumed by then (e.g. a single-partition lossy image only retains its last
+// macroblock bytes), so most of the input is never copied.
+static int CanBorrowMemBuffer(const WebPIDecoder* const idec) {
+  const MemBuffer* const mem = &idec->mem_;
+  assert(mem->mode_ == MEM_MODE_APPEND);
+  return (MemDataSize(mem) == 0 && !NeedCompressedAlpha(idec));
+}
+
+static void BorrowMemBuffer(WebPIDecoder* const idec,
+                            const uint8_t* const data, size_t data_size) {
+  MemBuffer* const mem = &idec->mem_;
+  const uint8_t* const old_start = mem->buf_ + mem->start_;
+  assert(CanBorrowMemBuffer(idec));
+  mem->buf_ = (uint8_t*)data;
+  mem->start_ = 0;
+  mem->end_ = data_size;
+  DoRemap(idec, mem->buf_ - old_start);
+}
+
+// 'own_buf' and 'own_size' describe the buffer owned by the MemBuffer before
+// the call to BorrowMemBuffer(). Returns false in case of memory error.
+static int ReturnMemBuffer(WebPIDecoder* const idec,
+                           uint8_t* own_buf, size_t own_size) {
+  MemBuffer* const mem = &idec->mem_;
+  const uint8_t* const old_start = mem->buf_ + mem->start_;
+  const uint8_t* const old_base = NeedCompressedAlpha(idec)
+                                ? ((VP8Decoder*)idec->dec_)->alpha_data_
+                                : old_start;
+  const size_t new_mem_start = old_start - old_base;
+  const size_t current_size = MemDataSize(mem) + new_mem_start;
+  int ok = 1;
+
+  if (idec->state_ == STATE_DONE || idec->state_ == STATE_ERROR) {
+    // Nothing will be read anymore.
+  } else if (own_buf == NULL || current_size > own_size) {
+    const uint64_t new_size =
+        ((uint64_t)current_size + CHUNK_SIZE) & ~(CHUNK_SIZE - 1);
+    uint8_t* const new_buf =
+        (uint8_t*)WebPSafeMalloc(new_size, sizeof(*new_buf));
+    WebPSafeFree(own_buf);
+    own_buf = new_buf;
+    own_size = (new_buf != NULL) ? (size_t)new_size : 0;
+    ok = (new_buf != NULL);
+  }
+  mem->buf_ = own_buf;
+  mem->buf_size_ = own_size;
+  if (!ok || idec->state_ == STATE_DONE || idec->state_ == STATE_ERROR) {
+    mem->start_ = mem->end_ = 0;
+    return ok;
+  }
+  memcpy(mem->buf_, old_base, current_size);
+  mem->start_ = new_mem_start;
+  mem->end_ = current_size;
+  DoRemap(idec, mem->buf_ + mem->start_ - old_start);
+  return 1;
+}
+
 static int RemapMemBuffer(WebPIDecoder* const idec,
                           const uint8_t* const data, size_t data_size) {
   MemBuffer* const mem = &idec->mem_;
@@ -746,6 +817,17 @@ VP8StatusCode WebPIAppend(WebPIDecoder* idec,
   if (!CheckMemBufferMode(&idec->mem_, MEM_MODE_APPEND)) {
     return VP8_STATUS_INVALID_PARAM;
   }
+  if (CanBorrowMemBuffer(idec)) {
+    // Decode in place, and only keep a copy of the unconsumed data.
+    uint8_t* const own_buf = idec->mem_.buf_;
+    const size_t own_size = idec->mem_.buf_size_;
+    BorrowMemBuffer(idec, data, data_size);
+    status = IDecode(idec);
+    if (!ReturnMemBuffer(idec, own_buf, own_size)) {
+      return IDecError(idec, VP8_STATUS_OUT_OF_MEMORY);
+    }
+    return status;
+  }
   // Append data to memory buffer
   if (!AppendToMemBuffer(idec, data, data_size)) {
     return VP8_STATUS_OUT_OF_MEMORY;
@@ -59,7 +59,28 @@ static int EmitSampledRGB(const VP8Io* const io, WebPDecParams* const p) {
 // Fancy upsampling
 
 #ifdef FANCY_UPSAMPLING
-static int EmitFancyRGB(const VP8Io* const io, WebPDecParams* const p) {
+// Stores the alpha values of the 'num_rows' output rows starting at row 'y'
+// into 'rgba' and premultiplies them if needed. Called right after these rows
+// were upsampled, while they are still hot in cache.
+static void EmitFancyAlphaRows(const VP8Io* const io,
+                               const WebPDecParams* const p,
+                               int y, uint8_t* const rgba, int num_rows) {
+  const WEBP_CSP_MODE colorspace = p->output->colorspace;
+  const int alpha_first =
+      (colorspace == MODE_ARGB || colorspace == MODE_Argb);
+  const int stride = p->output->u.RGBA.stride;
+  // Note: io->a is persistent, so the previous call's last row is available.
+  const uint8_t* const alpha = io->a + (y - io->mb_y) * io->width;
+  const int has_alpha = WebPDispatchAlpha(alpha, io->width, io->mb_w, num_rows,
+                                          rgba + (alpha_first ? 0 : 3), stride);
+  if (has_alpha && WebPIsPremultipliedMode(colorspace)) {
+    WebPApplyAlphaMultiply(rgba, alpha_first, io->mb_w, num_rows, stride);
+  }
+}
+
+// If 'with_alpha' is true, io->a is emitted along with the RGB samples.
+static int EmitFancy(const VP8Io* const io, WebPDecParams* const p,
+                     int with_alpha) {
   int num_lines_out = io->mb_h;   // a priori guess
   const WebPRGBABuffer* const buf = &p->output->u.RGBA;
   uint8_t* dst = buf->rgba + io->mb_y * buf->stride;
@@ -77,10 +98,12 @@ static int EmitFancyRGB(const VP8Io* const io, WebPDecParams* const p) {
   if (y == 0) {
     // First line is special cased. We mirror the u/v samples at boundary.
     upsample(cur_y, NULL, cur_u, cur_v, cur_u, cur_v, dst, NULL, mb_w);
+    if (with_alpha) EmitFancyAlphaRows(io, p, y, dst, 1);
   } else {
     // We can finish the left-over line from previous call.
     upsample(p->tmp_y, cur_y, top_u, top_v, cur_u, cur_v,
              dst - buf->stride, dst, mb_w);
+    if (with_alpha) EmitFancyAlphaRows(io, p, y - 1, dst - buf->stride, 2);
     ++num_lines_out;
   }
   // Loop over each output pairs of row.
@@ -94,6 +117,7 @@ static int EmitFancyRGB(const VP8Io* const io, WebPDecParams* const p) {
     upsample(cur_y - io->y_stride, cur_y,
              top_u, top_v, cur_u, cur_v,
              dst - buf->stride, dst, mb_w);
+    if (with_alpha) EmitFancyAlphaRows(io, p, y + 1, dst - buf->stride, 2);
   }
   // move to last row
   cur_y += io->y_stride;
@@ -110,11 +134,21 @@ static int EmitFancyRGB(const VP8Io* const io, WebPDecParams* const p) {
     if (!(y_end & 1)) {
       upsample(cur_y, NULL, cur_u, cur_v, cur_u, cur_v,
                dst + buf->stride, NULL, mb_w);
+      if (with_alpha) EmitFancyAlphaRows(io, p, y + 1, dst + buf->stride, 1);
     }
   }
   return num_lines_out;
 }
 
+static int EmitFancyRGB(const VP8Io* const io, WebPDecParams* const p) {
+  return EmitFancy(io, p, 0);
+}
+
+// Single-pass variant for 32b RGB modes with alpha, replacing EmitAlphaRGB().
+static int EmitFancyRGBA(const VP8Io* const io, WebPDecParams* const p) {
+  return EmitFancy(io, p, io->a != NULL);
+}
+
 #endif    /* FANCY_UPSAMPLING */
 
 //------------------------------------------------------------------------------
@@ -564,6 +598,12 @@ static int CustomSetup(VP8Io* io) {
       if (is_rgb) {
         WebPInitAlphaProcessing();
       }
+#ifdef FANCY_UPSAMPLING
+      if (p->emit == EmitFancyRGB && p->emit_alpha == EmitAlphaRGB) {
+        p->emit = EmitFancyRGBA;
+        p->emit_alpha = NULL;
+      }
+#endif
     }
   }
 
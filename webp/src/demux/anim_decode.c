@@ -17,6 +17,7 @@
 #include <assert.h>
 #include <string.h>
 
+#include "../utils/thread.h"
 #include "../utils/utils.h"
 #include "../webp/decode.h"
 #include "../webp/demux.h"
@@ -29,6 +30,15 @@ static void BlendPixelRowNonPremult(uint32_t* const src,
 static void BlendPixelRowPremult(uint32_t* const src, const uint32_t* const dst,
                                  int num_pixels);
 
+// A key-frame decoded ahead of time (see WebPAnimDecoderOptions::lookahead).
+typedef struct {
+  WebPWorker worker_;
+  WebPDecoderConfig config_;       // Copy of the decoder's config.
+  WebPIterator iter_;              // Frame being decoded in this slot.
+  uint8_t* canvas_;                // Decoded canvas.
+  int frame_num_;                  // Frame held by this slot, or 0 if free.
+} LookaheadSlot;
+
 struct WebPAnimDecoder {
   WebPDemuxer* demux_;             // Demuxer created from given WebP bitstream.
   WebPDecoderConfig config_;       // Decoder config.
@@ -43,11 +53,19 @@ struct WebPAnimDecoder {
   int prev_frame_was_keyframe_;    // True if previous frame was a keyframe.
   int next_frame_;                 // Index of the next frame to be decoded
                                    // (starting from 1).
+  LookaheadSlot* lookahead_;       // Key-frames decoded ahead, or NULL.
+  int num_lookahead_;              // Number of entries in 'lookahead_'.
+  uint8_t* is_key_frame_;          // is_key_frame_[i] is true if frame 'i + 1'
+                                   // is a key-frame (only with lookahead).
+  int next_lookahead_frame_;       // Next frame to consider for lookahead.
 };
 
+static int InitLookahead(WebPAnimDecoder* const dec, int num_slots);
+
 static void DefaultDecoderOptions(WebPAnimDecoderOptions* const dec_options) {
   dec_options->color_mode = MODE_RGBA;
   dec_options->use_threads = 0;
+  dec_options->lookahead = 0;
 }
 
 int WebPAnimDecoderOptionsInitInternal(WebPAnimDecoderOptions* dec_options,
@@ -122,6 +140,7 @@ WebPAnimDecoder* WebPAnimDecoderNewInternal(
     if (dec->prev_frame_disposed_ == NULL) goto Error;
   }
 
+  if (!InitLookahead(dec, options.lookahead)) goto Error;
   WebPAnimDecoderReset(dec);
 
   return dec;
@@ -187,6 +206,138 @@ static int IsKeyFrame(const WebPIterator* const curr,
   }
 }
 
+//------------------------------------------------------------------------------
+// Lookahead decoding of key-frames.
+// Key-frames don't depend on the previous canvas, so they can be decoded on a
+// worker while the application is still using the previous frames. Each slot
+// holds one such frame; GetNext() takes over its canvas when the frame is due.
+
+// Decodes the frame of 'slot' on a zero-filled canvas, as GetNext() does for
+// key-frames.
+static int DecodeAheadHook(LookaheadSlot* const slot,
+                           const WebPAnimDecoder* const dec) {
+  const uint32_t width = dec->info_.canvas_width;
+  const uint32_t height = dec->info_.canvas_height;
+  const WebPIterator* const iter = &slot->iter_;
+  WebPRGBABuffer* const buf = &slot->config_.output.u.RGBA;
+  ZeroFillCanvas(slot->canvas_, width, height);
+  buf->stride = NUM_CHANNELS * width;
+  buf->size = buf->stride * iter->height;
+  buf->rgba = slot->canvas_ +
+              (iter->y_offset * width + iter->x_offset) * NUM_CHANNELS;
+  return (WebPDecode(iter->fragment.bytes, iter->fragment.size,
+                     &slot->config_) == VP8_STATUS_OK);
+}
+
+// Returns false in case of memory error or parsing error.
+static int InitLookahead(WebPAnimDecoder* const dec, int num_slots) {
+  const WebPWorkerInterface* const worker_interface = WebPGetWorkerInterface();
+  const uint32_t width = dec->info_.canvas_width;
+  const uint32_t height = dec->info_.canvas_height;
+  const int frame_count = (int)dec->info_.frame_count;
+  WebPIterator prev, curr;
+  int prev_frame_was_keyframe = 0;
+  int i;
+
+#ifndef WEBP_USE_THREAD
+  num_slots = 0;   // Decoding ahead would only add canvas copies.
+#endif
+  if (num_slots > frame_count) num_slots = frame_count;
+  if (num_slots <= 0) return 1;
+
+  dec->is_key_frame_ = (uint8_t*)WebPSafeMalloc(frame_count, 1ULL);
+  if (dec->is_key_frame_ == NULL) return 0;
+  // Note: calloc() so that the workers are in the same state as after Init().
+  dec->lookahead_ =
+      (LookaheadSlot*)WebPSafeCalloc(num_slots, sizeof(*dec->lookahead_));
+  if (dec->lookahead_ == NULL) return 0;
+  dec->num_lookahead_ = num_slots;
+
+  // The key-frame property only depends on the frame headers.
+  memset(&prev, 0, sizeof(prev));
+  for (i = 1; i <= frame_count; ++i) {
+    if (!WebPDemuxGetFrame(dec->demux_, i, &curr)) return 0;
+    prev_frame_was_keyframe =
+        IsKeyFrame(&curr, &prev, prev_frame_was_keyframe, width, height);
+    dec->is_key_frame_[i - 1] = prev_frame_was_keyframe;
+    prev = curr;
+  }
+
+  for (i = 0; i < num_slots; ++i) {
+    LookaheadSlot* const slot = &dec->lookahead_[i];
+    worker_interface->Init(&slot->worker_);
+    slot->config_ = dec->config_;
+    slot->canvas_ =
+        (uint8_t*)WebPSafeMalloc(1ULL, width * NUM_CHANNELS * height);
+    if (slot->canvas_ == NULL) return 0;
+    if (!worker_interface->Reset(&slot->worker_)) return 0;
+    slot->worker_.hook = (WebPWorkerHook)DecodeAheadHook;
+    slot->worker_.data1 = slot;
+    slot->worker_.data2 = dec;
+  }
+  return 1;
+}
+
+// Starts decoding the next key-frames on the free slots.
+static void ScheduleLookahead(WebPAnimDecoder* const dec) {
+  const WebPWorkerInterface* const worker_interface = WebPGetWorkerInterface();
+  const int frame_count = (int)dec->info_.frame_count;
+  int i;
+  if (dec->next_lookahead_frame_ < dec->next_frame_) {
+    dec->next_lookahead_frame_ = dec->next_frame_;
+  }
+  for (i = 0; i < dec->num_lookahead_; ++i) {
+    LookaheadSlot* const slot = &dec->lookahead_[i];
+    if (slot->frame_num_ != 0) continue;   // busy
+    while (dec->next_lookahead_frame_ <= frame_count &&
+           !dec->is_key_frame_[dec->next_lookahead_frame_ - 1]) {
+      ++dec->next_lookahead_frame_;
+    }
+    if (dec->next_lookahead_frame_ > frame_count) break;
+    if (!WebPDemuxGetFrame(dec->demux_, dec->next_lookahead_frame_,
+                           &slot->iter_) ||
+        !worker_interface->Reset(&slot->worker_)) {   // clears past errors
+      break;
+    }
+    slot->frame_num_ = dec->next_lookahead_frame_++;
+    worker_interface->Launch(&slot->worker_);
+  }
+}
+
+// If 'frame_num' was decoded ahead, swaps its canvas with 'dec->curr_frame_'
+// and returns true.
+static int TakeLookaheadFrame(WebPAnimDecoder* const dec, int frame_num) {
+  int i;
+  for (i = 0; i < dec->num_lookahead_; ++i) {
+    LookaheadSlot* const slot = &dec->lookahead_[i];
+    if (slot->frame_num_ == frame_num) {
+      const int ok = WebPGetWorkerInterface()->Sync(&slot->worker_);
+      slot->frame_num_ = 0;
+      if (ok) {
+        uint8_t* const tmp = dec->curr_frame_;
+        dec->curr_frame_ = slot->canvas_;
+        slot->canvas_ = tmp;
+      }
+      return ok;
+    }
+  }
+  return 0;
+}
+
+// Waits for all the pending decodes, and frees the slots.
+static void CancelLookahead(WebPAnimDecoder* const dec) {
+  int i;
+  for (i = 0; i < dec->num_lookahead_; ++i) {
+    LookaheadSlot* const slot = &dec->lookahead_[i];
+    if (slot->frame_num_ != 0) {
+      WebPGetWorkerInterface()->Sync(&slot->worker_);
+      slot->frame_num_ = 0;
+    }
+  }
+  dec->next_lookahead_frame_ = 1;
+}
+
+//------------------------------------------------------------------------------
 
 // Blend a single channel of 'src' over 'dst', given their alpha channel values.
 // 'src' and 'dst' are assumed to be NOT pre-multiplied by alpha.
@@ -308,6 +459,7 @@ int WebPAnimDecoderGetNext(WebPAnimDecoder* dec,
   uint32_t width;
   uint32_t height;
   int is_key_frame;
+  int decoded_ahead = 0;
   int timestamp;
   BlendRowFunc blend_row;
 
@@ -328,13 +480,14 @@ int WebPAnimDecoderGetNext(WebPAnimDecoder* dec,
   is_key_frame = IsKeyFrame(&iter, &dec->prev_iter_,
                             dec->prev_frame_was_keyframe_, width, height);
   if (is_key_frame) {
-    ZeroFillCanvas(dec->curr_frame_, width, height);
+    decoded_ahead = TakeLookaheadFrame(dec, dec->next_frame_);
+    if (!decoded_ahead) ZeroFillCanvas(dec->curr_frame_, width, height);
   } else {
     CopyCanvas(dec->prev_frame_disposed_, dec->curr_frame_, width, height);
   }
 
   // Decode.
-  {
+  if (!decoded_ahead) {
     const uint8_t* in = iter.fragment.bytes;
     const size_t in_size = iter.fragment.size;
     const size_t out_offset =
@@ -402,6 +555,7 @@ int WebPAnimDecoderGetNext(WebPAnimDecoder* dec,
                       dec->prev_iter_.width, dec->prev_iter_.height);
   }
   ++dec->next_frame_;
+  ScheduleLookahead(dec);
 
   // All OK, fill in the values.
   *buf_ptr = dec->curr_frame_;
@@ -424,6 +578,8 @@ void WebPAnimDecoderReset(WebPAnimDecoder* dec) {
     memset(&dec->prev_iter_, 0, sizeof(dec->prev_iter_));
     dec->prev_frame_was_keyframe_ = 0;
     dec->next_frame_ = 1;
+    CancelLookahead(dec);
+    ScheduleLookahead(dec);
   }
 }
 
@@ -434,6 +590,13 @@ const WebPDemuxer* WebPAnimDecoderGetDemuxer(const WebPAnimDecoder* dec) {
 
 void WebPAnimDecoderDelete(WebPAnimDecoder* dec) {
   if (dec != NULL) {
+    int i;
+    for (i = 0; i < dec->num_lookahead_; ++i) {
+      WebPGetWorkerInterface()->End(&dec->lookahead_[i].worker_);
+      WebPSafeFree(dec->lookahead_[i].canvas_);
+    }
+    WebPSafeFree(dec->lookahead_);
+    WebPSafeFree(dec->is_key_frame_);
     WebPDemuxDelete(dec->demux_);
     WebPSafeFree(dec->curr_frame_);
     WebPSafeFree(dec->prev_frame_disposed_);
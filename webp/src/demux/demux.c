@@ -69,6 +69,8 @@ struct WebPDemuxer {
   int num_frames_;
   Frame* frames_;
   Frame** frames_tail_;
+  Frame** frame_index_;  // frame_index_[n - 1] is frame number 'n'.
+  int frame_index_capacity_;
   Chunk* chunks_;  // non-image chunks
   Chunk** chunks_tail_;
 };
@@ -180,12 +182,40 @@ static void AddChunk(WebPDemuxer* const dmux, Chunk* const chunk) {
   dmux->chunks_tail_ = &chunk->next_;
 }
 
+// Makes room for 'frame_num' entries in the frame index, growing it
+// geometrically so that parsing n frames stays O(n).
+// Returns true on success, false otherwise.
+static int GrowFrameIndex(WebPDemuxer* const dmux, int frame_num) {
+  Frame** new_index;
+  int new_capacity;
+  if (frame_num <= dmux->frame_index_capacity_) return 1;
+  new_capacity = 2 * dmux->frame_index_capacity_;
+  if (new_capacity < 16) new_capacity = 16;
+  if (new_capacity < frame_num) new_capacity = frame_num;
+  new_index =
+      (Frame**)WebPSafeMalloc((uint64_t)new_capacity, sizeof(*new_index));
+  if (new_index == NULL) return 0;
+  if (dmux->frame_index_capacity_ > 0) {
+    memcpy(new_index, dmux->frame_index_,
+           dmux->frame_index_capacity_ * sizeof(*new_index));
+  }
+  WebPSafeFree(dmux->frame_index_);
+  dmux->frame_index_ = new_index;
+  dmux->frame_index_capacity_ = new_capacity;
+  return 1;
+}
+
 // Add a frame to the end of the list, ensuring the last frame is complete.
 // Returns true on success, false otherwise.
 static int AddFrame(WebPDemuxer* const dmux, Frame* const frame) {
   const Frame* const last_frame = *dmux->frames_tail_;
   if (last_frame != NULL && !last_frame->complete_) return 0;
 
+  // Frames are numbered consecutively from 1 in the order they are added.
+  assert(frame->frame_num_ >= 1);
+  if (!GrowFrameIndex(dmux, frame->frame_num_)) return 0;
+  dmux->frame_index_[frame->frame_num_ - 1] = frame;
+
   *dmux->frames_tail_ = frame;
   frame->next_ = NULL;
   dmux->frames_tail_ = &frame->next_;
@@ -767,6 +797,7 @@ void WebPDemuxDelete(WebPDemuxer* dmux) {
     c = c->next_;
     WebPSafeFree(cur_chunk);
   }
+  WebPSafeFree(dmux->frame_index_);
   WebPSafeFree(dmux);
 }
 
@@ -790,11 +821,8 @@ uint32_t WebPDemuxGetI(const WebPDemuxer* dmux, WebPFormatFeature feature) {
 // Frame iteration
 
 static const Frame* GetFrame(const WebPDemuxer* const dmux, int frame_num) {
-  const Frame* f;
-  for (f = dmux->frames_; f != NULL; f = f->next_) {
-    if (frame_num == f->frame_num_) break;
-  }
-  return f;
+  if (frame_num < 1 || frame_num > dmux->num_frames_) return NULL;
+  return dmux->frame_index_[frame_num - 1];
 }
 
 static const uint8_t* GetFramePayload(const uint8_t* const mem_buf,
@@ -883,6 +911,21 @@ void WebPDemuxReleaseIterator(WebPIterator* iter) {
   (void)iter;
 }
 
+int WebPDemuxGetFrameRange(const WebPDemuxer* dmux, int frame_num,
+                           size_t* offset, size_t* size) {
+  const Frame* frame;
+  const uint8_t* payload;
+  size_t payload_size = 0;
+  if (dmux == NULL || offset == NULL || size == NULL) return 0;
+  if (frame_num == 0) frame_num = dmux->num_frames_;
+  frame = GetFrame(dmux, frame_num);
+  payload = GetFramePayload(dmux->mem_.buf_, frame, &payload_size);
+  if (payload == NULL) return 0;
+  *offset = (size_t)(payload - dmux->mem_.buf_);
+  *size = payload_size;
+  return 1;
+}
+
 // -----------------------------------------------------------------------------
 // Chunk iteration
 
@@ -0,0 +1,106 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the COPYING file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS. All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+// -----------------------------------------------------------------------------
+//
+// Utilities for processing transparent channel, AVX2 variant.
+
+#include "./dsp.h"
+
+#if defined(WEBP_USE_AVX2)
+
+#include <immintrin.h>
+
+//------------------------------------------------------------------------------
+// Non-dither premultiplied modes
+
+#define MULTIPLIER(a)   ((a) * 0x8081)
+#define PREMULTIPLY(x, m) (((x) * (m)) >> 23)
+
+// Same computation as the SSE2 version, on 8 pixels (4 per 16b register).
+// SHUFFLE has to be an immediate, hence the macro.
+#define APPLY_ALPHA(ARGB, OUT, SHUFFLE, MASK, MULT) do {          \
+  const __m256i alpha0 = _mm256_and_si256((ARGB), (MASK));        \
+  const __m256i alpha1 = _mm256_shufflelo_epi16(alpha0, SHUFFLE); \
+  const __m256i alpha2 = _mm256_shufflehi_epi16(alpha1, SHUFFLE); \
+  const __m256i scale0 = _mm256_mullo_epi16(alpha2, (MULT));      \
+  const __m256i scale1 = _mm256_mulhi_epu16(alpha2, (MULT));      \
+  const __m256i argb2 = _mm256_mulhi_epu16((ARGB), scale0);       \
+  const __m256i argb3 = _mm256_mullo_epi16((ARGB), scale1);       \
+  const __m256i argb4 = _mm256_adds_epu16(argb2, argb3);          \
+  const __m256i argb5 = _mm256_srli_epi16(argb4, 7);              \
+  (OUT) = _mm256_or_si256(argb5, alpha0);                         \
+} while (0)
+
+static void ApplyAlphaMultiply(uint8_t* rgba, int alpha_first,
+                               int w, int h, int stride) {
+  const __m256i zero = _mm256_setzero_si256();
+  const int kSpan = 8;
+  const int w2 = w & ~(kSpan - 1);
+  while (h-- > 0) {
+    int i;
+    for (i = 0; i < w2; i += kSpan) {
+      __m256i* const ptr = (__m256i*)(rgba + 4 * i);
+      const __m256i argb0 = _mm256_loadu_si256(ptr);
+      // unpacking stays within 128b lanes, and so does the final packing.
+      const __m256i argb_lo = _mm256_unpacklo_epi8(argb0, zero);
+      const __m256i argb_hi = _mm256_unpackhi_epi8(argb0, zero);
+      __m256i out_lo, out_hi;
+      if (!alpha_first) {
+        const __m256i kMask = _mm256_set_epi16(0xff, 0, 0, 0, 0xff, 0, 0, 0,
+                                               0xff, 0, 0, 0, 0xff, 0, 0, 0);
+        const __m256i kMult =
+            _mm256_set_epi16(0, 0x8081, 0x8081, 0x8081, 0, 0x8081, 0x8081,
+                             0x8081, 0, 0x8081, 0x8081, 0x8081, 0, 0x8081,
+                             0x8081, 0x8081);
+        APPLY_ALPHA(argb_lo, out_lo, _MM_SHUFFLE(0, 3, 3, 3), kMask, kMult);
+        APPLY_ALPHA(argb_hi, out_hi, _MM_SHUFFLE(0, 3, 3, 3), kMask, kMult);
+      } else {
+        const __m256i kMask = _mm256_set_epi16(0, 0, 0, 0xff, 0, 0, 0, 0xff,
+                                               0, 0, 0, 0xff, 0, 0, 0, 0xff);
+        const __m256i kMult =
+            _mm256_set_epi16(0x8081, 0x8081, 0x8081, 0, 0x8081, 0x8081,
+                             0x8081, 0, 0x8081, 0x8081, 0x8081, 0, 0x8081,
+                             0x8081, 0x8081, 0);
+        APPLY_ALPHA(argb_lo, out_lo, _MM_SHUFFLE(0, 0, 0, 3), kMask, kMult);
+        APPLY_ALPHA(argb_hi, out_hi, _MM_SHUFFLE(0, 0, 0, 3), kMask, kMult);
+      }
+      _mm256_storeu_si256(ptr, _mm256_packus_epi16(out_lo, out_hi));
+    }
+    // Finish with left-overs.
+    for (; i < w; ++i) {
+      uint8_t* const rgb = rgba + (alpha_first ? 1 : 0);
+      const uint8_t* const alpha = rgba + (alpha_first ? 0 : 3);
+      const uint32_t a = alpha[4 * i];
+      if (a != 0xff) {
+        const uint32_t mult = MULTIPLIER(a);
+        rgb[4 * i + 0] = PREMULTIPLY(rgb[4 * i + 0], mult);
+        rgb[4 * i + 1] = PREMULTIPLY(rgb[4 * i + 1], mult);
+        rgb[4 * i + 2] = PREMULTIPLY(rgb[4 * i + 2], mult);
+      }
+    }
+    rgba += stride;
+  }
+}
+#undef APPLY_ALPHA
+#undef MULTIPLIER
+#undef PREMULTIPLY
+
+//------------------------------------------------------------------------------
+// Entry point
+
+extern void WebPInitAlphaProcessingAVX2(void);
+
+WEBP_TSAN_IGNORE_FUNCTION void WebPInitAlphaProcessingAVX2(void) {
+  WebPApplyAlphaMultiply = ApplyAlphaMultiply;
+}
+
+#else  // !WEBP_USE_AVX2
+
+WEBP_DSP_INIT_STUB(WebPInitAlphaProcessingAVX2)
+
+#endif  // WEBP_USE_AVX2
@@ -109,6 +109,65 @@ static void RescalerImportRowExpandSSE2(WebPRescaler* const wrk,
   assert(accum == 0);
 }
 
+// returns the lower 32 bits of the products A[i] * B[i]
+static WEBP_INLINE __m128i MulLo32(const __m128i A, const __m128i B) {
+  const __m128i C0 = _mm_mul_epu32(A, B);
+  const __m128i C1 = _mm_mul_epu32(_mm_srli_epi64(A, 32),
+                                   _mm_srli_epi64(B, 32));
+  const __m128i D0 = _mm_shuffle_epi32(C0, 0 | (2 << 2));
+  const __m128i D1 = _mm_shuffle_epi32(C1, 0 | (2 << 2));
+  return _mm_unpacklo_epi32(D0, D1);
+}
+
+// returns MULT_FIX(A[i], mult[0])
+static WEBP_INLINE __m128i MultFix32(const __m128i A, const __m128i mult) {
+  const __m128i rounder = _mm_set_epi32(0, ROUNDER, 0, ROUNDER);
+  const __m128i B0 = _mm_mul_epu32(A, mult);
+  const __m128i B1 = _mm_mul_epu32(_mm_srli_epi64(A, 32), mult);
+  const __m128i C0 = _mm_add_epi64(B0, rounder);
+  const __m128i C1 = _mm_add_epi64(B1, rounder);
+  const __m128i D0 = _mm_shuffle_epi32(C0, 1 | (3 << 2));
+  const __m128i D1 = _mm_shuffle_epi32(C1, 1 | (3 << 2));
+  return _mm_unpacklo_epi32(D0, D1);
+}
+
+// Same as RescalerImportRowShrinkSSE2() below, but with 32b accumulators.
+// Used for reduction ratios beyond 1/128, which overflow the 16b sums (e.g.
+// when making small thumbnails of large pictures).
+static void RescalerImportRowShrinkWideSSE2(WebPRescaler* const wrk,
+                                            const uint8_t* src) {
+  const int x_sub = wrk->x_sub;
+  int accum = 0;
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i mult0 = _mm_set1_epi32(x_sub);
+  const __m128i mult1 = _mm_set1_epi32(wrk->fx_scale);
+  __m128i sum = zero;
+  rescaler_t* frow = wrk->frow;
+  const rescaler_t* const frow_end = wrk->frow + 4 * wrk->dst_width;
+  assert(!WebPRescalerInputDone(wrk));
+  assert(!wrk->x_expand);
+  assert(wrk->num_channels == 4);
+
+  for (; frow < frow_end; frow += 4) {
+    __m128i base = zero;
+    accum += wrk->x_add;
+    while (accum > 0) {
+      const __m128i A = _mm_cvtsi32_si128(WebPMemToUint32(src));
+      src += 4;
+      base = _mm_unpacklo_epi16(_mm_unpacklo_epi8(A, zero), zero);
+      sum = _mm_add_epi32(sum, base);
+      accum -= x_sub;
+    }
+    {    // Emit next horizontal pixel.
+      const __m128i frac = MulLo32(base, _mm_set1_epi32(-accum));
+      const __m128i frow_out = _mm_sub_epi32(MulLo32(sum, mult0), frac);
+      sum = MultFix32(frac, mult1);     // fresh fractional start
+      _mm_storeu_si128((__m128i*)frow, frow_out);
+    }
+  }
+  assert(accum == 0);
+}
+
 static void RescalerImportRowShrinkSSE2(WebPRescaler* const wrk,
                                         const uint8_t* src) {
   const int x_sub = wrk->x_sub;
@@ -121,10 +180,14 @@ static void RescalerImportRowShrinkSSE2(WebPRescaler* const wrk,
   rescaler_t* frow = wrk->frow;
   const rescaler_t* const frow_end = wrk->frow + 4 * wrk->dst_width;
 
-  if (wrk->num_channels != 4 || wrk->x_add > (x_sub << 7)) {
+  if (wrk->num_channels != 4) {
     WebPRescalerImportRowShrinkC(wrk, src);
     return;
   }
+  if (wrk->x_add > (x_sub << 7)) {
+    RescalerImportRowShrinkWideSSE2(wrk, src);
+    return;
+  }
   assert(!WebPRescalerInputDone(wrk));
   assert(!wrk->x_expand);
 
@@ -329,6 +329,56 @@ static int MBAnalyzeBestUVMode(VP8EncIterator* const it) {
   return best_alpha;
 }
 
+// Method 0 keeps the analysis' modes as final (see VP8Decimate()). There, the
+// modes are picked on distortion, like RefineUsingDistortion() does for the
+// other fast methods, and a single histogram per block is collected for the
+// susceptibility. This is much cheaper than a histogram per mode.
+static int MBAnalyzeFastIntra16Mode(VP8EncIterator* const it) {
+  const uint8_t* const src = it->yuv_in_ + Y_OFF_ENC;
+  int best_mode = 0;
+  score_t best_score = MAX_COST;
+  int mode;
+  VP8Histogram histo;
+
+  VP8MakeLuma16Preds(it);
+  for (mode = 0; mode < NUM_PRED_MODES; ++mode) {
+    const score_t score =
+        VP8SSE16x16(src, it->yuv_p_ + VP8I16ModeOffsets[mode]);
+    if (score < best_score) {
+      best_score = score;
+      best_mode = mode;
+    }
+  }
+  VP8SetIntra16Mode(it, best_mode);
+  InitHistogram(&histo);
+  VP8CollectHistogram(src, it->yuv_p_ + VP8I16ModeOffsets[best_mode],
+                      0, 16, &histo);
+  return GetAlpha(&histo);
+}
+
+static int MBAnalyzeFastUVMode(VP8EncIterator* const it) {
+  const uint8_t* const src = it->yuv_in_ + U_OFF_ENC;
+  int best_mode = 0;
+  score_t best_score = MAX_COST;
+  int mode;
+  VP8Histogram histo;
+
+  VP8MakeChroma8Preds(it);
+  for (mode = 0; mode < NUM_PRED_MODES; ++mode) {
+    const score_t score =
+        VP8SSE16x8(src, it->yuv_p_ + VP8UVModeOffsets[mode]);
+    if (score < best_score) {
+      best_score = score;
+      best_mode = mode;
+    }
+  }
+  VP8SetIntraUVMode(it, best_mode);
+  InitHistogram(&histo);
+  VP8CollectHistogram(src, it->yuv_p_ + VP8UVModeOffsets[best_mode],
+                      16, 16 + 4 + 4, &histo);
+  return GetAlpha(&histo);
+}
+
 static void MBAnalyze(VP8EncIterator* const it,
                       int alphas[MAX_ALPHA + 1],
                       int* const alpha, int* const uv_alpha) {
@@ -339,7 +389,13 @@ static void MBAnalyze(VP8EncIterator* const it,
   VP8SetSkip(it, 0);         // not skipped
   VP8SetSegment(it, 0);      // default segment, spec-wise.
 
-  best_alpha = MBAnalyzeBestIntra16Mode(it);
+  if (enc->method_ == 0) {
+    best_alpha = MBAnalyzeFastIntra16Mode(it);
+    best_uv_alpha = MBAnalyzeFastUVMode(it);
+  } else {
+    best_alpha = MBAnalyzeBestIntra16Mode(it);
+    best_uv_alpha = MBAnalyzeBestUVMode(it);
+  }
   if (enc->method_ >= 5) {
     // We go and make a fast decision for intra4/intra16.
     // It's usually not a good and definitive pick, but helps seeding the stats
@@ -347,7 +403,6 @@ static void MBAnalyze(VP8EncIterator* const it,
     // TODO(skal): improve criterion.
     best_alpha = MBAnalyzeBestIntra4Mode(it, best_alpha);
   }
-  best_uv_alpha = MBAnalyzeBestUVMode(it);
 
   // Final susceptibility mix
   best_alpha = (3 * best_alpha + best_uv_alpha + 2) >> 2;
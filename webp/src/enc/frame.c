@@ -91,9 +91,15 @@ const uint8_t VP8Cat6[] =
 //------------------------------------------------------------------------------
 // Reset the statistics about: number of skips, token proba, level cost,...
 
+// Level costs are only used for rd-opt scoring, which the fastest methods
+// don't do. Computing them is a sizable part of encoding small pictures.
+static int NeedLevelCosts(const VP8Encoder* const enc) {
+  return (enc->rd_opt_level_ > RD_OPT_NONE) || enc->do_search_;
+}
+
 static void ResetStats(VP8Encoder* const enc) {
   VP8EncProba* const proba = &enc->proba_;
-  VP8CalculateLevelCosts(proba);
+  if (NeedLevelCosts(enc)) VP8CalculateLevelCosts(proba);
   proba->nb_skip_ = 0;
 }
 
@@ -345,9 +351,10 @@ static void CodeResiduals(VP8BitWriter* const bw, VP8EncIterator* const it,
 }
 
 // Same as CodeResiduals, but doesn't actually write anything.
-// Instead, it just records the event distribution.
+// Instead, it just records the event distribution into 'stats'.
 static void RecordResiduals(VP8EncIterator* const it,
-                            const VP8ModeScore* const rd) {
+                            const VP8ModeScore* const rd,
+                            StatsArray (*const stats)[NUM_BANDS]) {
   int x, y, ch;
   VP8Residual res;
   VP8Encoder* const enc = it->enc_;
@@ -356,12 +363,15 @@ static void RecordResiduals(VP8EncIterator* const it,
 
   if (it->mb_->type_ == 1) {   // i16x16
     VP8InitResidual(0, 1, enc, &res);
+    res.stats = stats[1];
     VP8SetResidualCoeffs(rd->y_dc_levels, &res);
     it->top_nz_[8] = it->left_nz_[8] =
       VP8RecordCoeffs(it->top_nz_[8] + it->left_nz_[8], &res);
     VP8InitResidual(1, 0, enc, &res);
+    res.stats = stats[0];
   } else {
     VP8InitResidual(0, 3, enc, &res);
+    res.stats = stats[3];
   }
 
   // luma-AC
@@ -375,6 +385,7 @@ static void RecordResiduals(VP8EncIterator* const it,
 
   // U/V
   VP8InitResidual(0, 2, enc, &res);
+  res.stats = stats[2];
   for (ch = 0; ch <= 2; ch += 2) {
     for (y = 0; y < 2; ++y) {
       for (x = 0; x < 2; ++x) {
@@ -467,27 +478,31 @@ static void ResetSSE(VP8Encoder* const enc) {
   enc->sse_count_ = 0;
 }
 
-static void StoreSSE(const VP8EncIterator* const it) {
-  VP8Encoder* const enc = it->enc_;
+static void StoreSSE(const VP8EncIterator* const it,
+                     uint64_t sse[3], uint64_t* const sse_count) {
   const uint8_t* const in = it->yuv_in_;
   const uint8_t* const out = it->yuv_out_;
   // Note: not totally accurate at boundary. And doesn't include in-loop filter.
-  enc->sse_[0] += VP8SSE16x16(in + Y_OFF_ENC, out + Y_OFF_ENC);
-  enc->sse_[1] += VP8SSE8x8(in + U_OFF_ENC, out + U_OFF_ENC);
-  enc->sse_[2] += VP8SSE8x8(in + V_OFF_ENC, out + V_OFF_ENC);
-  enc->sse_count_ += 16 * 16;
+  sse[0] += VP8SSE16x16(in + Y_OFF_ENC, out + Y_OFF_ENC);
+  sse[1] += VP8SSE8x8(in + U_OFF_ENC, out + U_OFF_ENC);
+  sse[2] += VP8SSE8x8(in + V_OFF_ENC, out + V_OFF_ENC);
+  *sse_count += 16 * 16;
 }
 
-static void StoreSideInfo(const VP8EncIterator* const it) {
+// Accumulates the picture statistics into 'sse', 'sse_count' and
+// 'block_count', which are either the encoder's or a row job's.
+static void StoreSideInfo(const VP8EncIterator* const it,
+                          uint64_t sse[3], uint64_t* const sse_count,
+                          int block_count[3]) {
   VP8Encoder* const enc = it->enc_;
   const VP8MBInfo* const mb = it->mb_;
   WebPPicture* const pic = enc->pic_;
 
   if (pic->stats != NULL) {
-    StoreSSE(it);
-    enc->block_count_[0] += (mb->type_ == 0);
-    enc->block_count_[1] += (mb->type_ == 1);
-    enc->block_count_[2] += (mb->skip_ != 0);
+    StoreSSE(it, sse, sse_count);
+    block_count[0] += (mb->type_ == 0);
+    block_count[1] += (mb->type_ == 1);
+    block_count[2] += (mb->skip_ != 0);
   }
 
   if (pic->extra_info != NULL) {
@@ -517,6 +532,277 @@ static double GetPSNR(uint64_t mse, uint64_t size) {
   return (mse > 0 && size > 0) ? 10. * log10(255. * 255. * size / mse) : 99;
 }
 
+// Fold the per-segment edge deltas recorded by the iterator into the
+// segment infos (see VP8AdjustFilterStrength()).
+static void StoreMaxEdges(const VP8EncIterator* const it) {
+  VP8Encoder* const enc = it->enc_;
+  int s;
+  for (s = 0; s < NUM_MB_SEGMENTS; ++s) {
+    if (it->max_edge_[s] > enc->dqm_[s].max_edge_) {
+      enc->dqm_[s].max_edge_ = it->max_edge_[s];
+    }
+  }
+}
+
+static void ResetAfterSkip(VP8EncIterator* const it) {
+  if (it->mb_->type_ == 1) {
+    *it->nz_ = 0;  // reset all predictors
+    it->left_nz_[8] = 0;
+  } else {
+    *it->nz_ &= (1 << 24);  // preserve the dc_nz bit
+  }
+}
+
+//------------------------------------------------------------------------------
+// Wavefront-parallel passes.
+//
+// With thread_level > 0 and several token partitions, the macroblock rows are
+// spread over one worker per partition: row 'y' is coded by job
+// 'y % num_parts_', into the same partition as in the serial loop. Macroblock
+// 'x' needs the reconstructed samples and contexts of macroblocks 'x - 1' to
+// 'x + 1' of the row above, so each row trails the one above by at least two
+// macroblocks. The jobs advance in lock-step: between two steps the main
+// thread works out how far each row may go, then all jobs code up to
+// WAVEFRONT_STEP macroblocks of their current row. Statistics are collected
+// per job and merged once the pass is over.
+// Without WEBP_USE_THREAD, or when the workers can't be started, the plain
+// serial loops are used.
+
+#define WAVEFRONT_STEP 8   // maximum number of macroblocks coded per step
+
+typedef struct {
+  WebPWorker worker;
+  VP8EncIterator it;
+  int row;               // current row ('it.x_' is the position within it)
+  int x_end;             // code the current row up to this macroblock
+  int num_jobs;
+  int is_stat_pass;      // only record statistics, don't write anything
+  VP8RDLevel rd_opt;
+  // Statistics of the pass, merged into the encoder by the main thread.
+  StatsArray stats[NUM_TYPES][NUM_BANDS];  // token statistics
+  int nb_skip;
+  uint64_t size, size_p0, distortion;
+  uint64_t sse[3], sse_count;
+  int block_count[3];
+  LFStats lf_stats;
+} RowJob;
+
+static int DoRowJob(RowJob* const job, void* const unused) {
+  VP8EncIterator* const it = &job->it;
+  VP8Encoder* const enc = it->enc_;
+  (void)unused;
+  while (it->x_ < job->x_end) {
+    VP8ModeScore info;
+    VP8IteratorImport(it, NULL);
+    if (job->is_stat_pass) {
+      if (VP8Decimate(it, &info, job->rd_opt)) {
+        ++job->nb_skip;
+      }
+      RecordResiduals(it, &info, job->stats);
+      job->size += info.R + info.H;
+      job->size_p0 += info.H;
+      job->distortion += info.D;
+    } else {
+      const int dont_use_skip = !enc->proba_.use_skip_proba_;
+      if (!VP8Decimate(it, &info, job->rd_opt) || dont_use_skip) {
+        CodeResiduals(it->bw_, it, &info);
+      } else {
+        ResetAfterSkip(it);
+      }
+      StoreSideInfo(it, job->sse, &job->sse_count, job->block_count);
+      VP8StoreFilterStats(it);
+      VP8IteratorExport(it);
+    }
+    VP8IteratorSaveBoundary(it);
+    VP8IteratorNext(it);
+    if (it->x_ == 0) {   // row is complete, jump to our next one
+      job->row += job->num_jobs;
+      if (job->row < enc->mb_h_) VP8IteratorSetRow(it, job->row);
+      break;
+    }
+  }
+  return 1;
+}
+
+// Returns NULL if the jobs can't be allocated or started.
+static RowJob* NewRowJobs(int num_jobs) {
+  const WebPWorkerInterface* const worker_interface = WebPGetWorkerInterface();
+  int ok = 1;
+  int j;
+  RowJob* const jobs = (RowJob*)WebPSafeMalloc(num_jobs, sizeof(*jobs));
+  if (jobs == NULL) return NULL;
+  for (j = 0; j < num_jobs; ++j) {
+    RowJob* const job = &jobs[j];
+    worker_interface->Init(&job->worker);
+    job->worker.data1 = job;
+    job->worker.data2 = NULL;
+    job->worker.hook = (WebPWorkerHook)DoRowJob;
+    job->num_jobs = num_jobs;
+    // jobs[0] is run on the main thread through Execute(), and doesn't
+    // need its own thread.
+    if (j > 0) ok &= worker_interface->Reset(&job->worker);
+  }
+  if (!ok) {
+    for (j = 0; j < num_jobs; ++j) worker_interface->End(&jobs[j].worker);
+    WebPSafeFree(jobs);
+    return NULL;
+  }
+  return jobs;
+}
+
+static void DeleteRowJobs(RowJob* const jobs) {
+  if (jobs != NULL) {
+    int j;
+    for (j = 0; j < jobs[0].num_jobs; ++j) {
+      WebPGetWorkerInterface()->End(&jobs[j].worker);
+    }
+    WebPSafeFree(jobs);
+  }
+}
+
+static void InitRowJobs(VP8Encoder* const enc, RowJob* const jobs,
+                        int is_stat_pass, VP8RDLevel rd_opt) {
+  int j;
+  for (j = 0; j < jobs[0].num_jobs; ++j) {
+    RowJob* const job = &jobs[j];
+    // Note: this also resets the shared top context, which is fine since
+    // no job is running yet.
+    VP8IteratorInit(enc, &job->it);
+    job->row = j;
+    if (j < enc->mb_h_) VP8IteratorSetRow(&job->it, j);
+    job->x_end = 0;
+    job->is_stat_pass = is_stat_pass;
+    job->rd_opt = rd_opt;
+    memset(job->stats, 0, sizeof(job->stats));
+    job->nb_skip = 0;
+    job->size = job->size_p0 = job->distortion = 0;
+    memset(job->sse, 0, sizeof(job->sse));
+    job->sse_count = 0;
+    memset(job->block_count, 0, sizeof(job->block_count));
+    job->it.lf_stats_ = (enc->lf_stats_ != NULL) ? &job->lf_stats : NULL;
+    VP8InitFilter(&job->it);
+  }
+}
+
+// Returns the number of macroblocks already coded in row 'y'.
+static int RowProgress(const RowJob* const jobs, int y, int mb_w) {
+  const RowJob* const job = &jobs[y % jobs[0].num_jobs];
+  return (job->row > y) ? mb_w : (job->row == y) ? job->it.x_ : 0;
+}
+
+// Runs the jobs until the first 'nb_mbs' macroblocks (in raster order) are
+// coded. Returns false if the user aborted through the progress hook.
+static int RunRowJobs(VP8Encoder* const enc, RowJob* const jobs,
+                      int nb_mbs, int percent_delta) {
+  const WebPWorkerInterface* const worker_interface = WebPGetWorkerInterface();
+  const int num_jobs = jobs[0].num_jobs;
+  const int mb_w = enc->mb_w_;
+  const int percent0 = enc->percent_;
+  int done = 0;
+  int ok = 1;
+  while (ok) {
+    int work = 0;
+    int j;
+    for (j = 0; j < num_jobs; ++j) {
+      RowJob* const job = &jobs[j];
+      const int y = job->row;
+      const int x = job->it.x_;
+      int x_end = (y < enc->mb_h_) ? nb_mbs - y * mb_w : 0;
+      if (x_end > mb_w) x_end = mb_w;
+      if (y > 0) {
+        const int above = RowProgress(jobs, y - 1, mb_w);
+        if (above < mb_w && x_end > above - 1) x_end = above - 1;
+      }
+      if (x_end > x + WAVEFRONT_STEP) x_end = x + WAVEFRONT_STEP;
+      job->x_end = (x_end > x) ? x_end : x;
+      work += job->x_end - x;
+    }
+    if (work == 0) break;   // all done
+
+    for (j = 1; j < num_jobs; ++j) {
+      if (jobs[j].x_end > jobs[j].it.x_) {
+        worker_interface->Launch(&jobs[j].worker);
+      }
+    }
+    worker_interface->Execute(&jobs[0].worker);
+    for (j = 0; j < num_jobs; ++j) {
+      ok &= worker_interface->Sync(&jobs[j].worker);
+    }
+    // the user's hook is only called from the main thread.
+    done += work;
+    if (ok && percent_delta && enc->pic_->progress_hook != NULL) {
+      const int percent = percent0 + percent_delta * done / nb_mbs;
+      ok = WebPReportProgress(enc->pic_, percent, &enc->percent_);
+    }
+  }
+  return ok;
+}
+
+// Adds the token statistics of 'src' to 'dst', halving the counts as
+// VP8RecordStats() does when they are about to overflow.
+static void MergeTokenStats(StatsArray (*const dst)[NUM_BANDS],
+                            StatsArray (*const src)[NUM_BANDS]) {
+  int t, b, c, p;
+  for (t = 0; t < NUM_TYPES; ++t) {
+    for (b = 0; b < NUM_BANDS; ++b) {
+      for (c = 0; c < NUM_CTX; ++c) {
+        for (p = 0; p < NUM_PROBAS; ++p) {
+          const proba_t d = dst[t][b][c][p];
+          const proba_t s = src[t][b][c][p];
+          uint32_t nb = (d & 0xffff) + (s & 0xffff);
+          uint32_t total = (d >> 16) + (s >> 16);
+          while (total >= 0xffff) {
+            nb = (nb + 1) >> 1;
+            total = (total + 1) >> 1;
+          }
+          dst[t][b][c][p] = (total << 16) | nb;
+        }
+      }
+    }
+  }
+}
+
+// Merges the statistics of all jobs into jobs[0] and the encoder.
+static void MergeRowJobs(VP8Encoder* const enc, RowJob* const jobs) {
+  RowJob* const dst = &jobs[0];
+  int j, i, s;
+  for (j = 0; j < dst->num_jobs; ++j) {
+    RowJob* const src = &jobs[j];
+    if (dst->is_stat_pass) {
+      MergeTokenStats(enc->proba_.stats_, src->stats);
+      enc->proba_.nb_skip_ += src->nb_skip;
+    } else {
+      for (i = 0; i < 3; ++i) {
+        enc->sse_[i] += src->sse[i];
+        enc->block_count_[i] += src->block_count[i];
+      }
+      enc->sse_count_ += src->sse_count;
+    }
+    if (j == 0) continue;
+    dst->size += src->size;
+    dst->size_p0 += src->size_p0;
+    dst->distortion += src->distortion;
+    for (s = 0; s < NUM_MB_SEGMENTS; ++s) {
+      if (src->it.max_edge_[s] > dst->it.max_edge_[s]) {
+        dst->it.max_edge_[s] = src->it.max_edge_[s];
+      }
+      for (i = 0; i < 3; ++i) {
+        dst->it.bit_count_[s][i] += src->it.bit_count_[s][i];
+      }
+      if (!dst->is_stat_pass && enc->lf_stats_ != NULL) {
+        for (i = 0; i < MAX_LF_LEVELS; ++i) {
+          dst->lf_stats[s][i] += src->lf_stats[s][i];
+        }
+      }
+    }
+  }
+  if (!dst->is_stat_pass && enc->lf_stats_ != NULL) {
+    // hand the filter stats over to the encoder, as the serial loop does.
+    memcpy(enc->lf_stats_, &dst->lf_stats, sizeof(*enc->lf_stats_));
+    dst->it.lf_stats_ = enc->lf_stats_;
+  }
+}
+
 //------------------------------------------------------------------------------
 //  StatLoop(): only collect statistics (number of skips, token usage, ...).
 //  This is used for deciding optimal probabilities. It also modifies the
@@ -533,32 +819,45 @@ static void SetLoopParams(VP8Encoder* const enc, float q) {
   ResetSSE(enc);
 }
 
+// If 'jobs' is not NULL, the pass is run on the wavefront row jobs.
 static uint64_t OneStatPass(VP8Encoder* const enc, VP8RDLevel rd_opt,
                             int nb_mbs, int percent_delta,
-                            PassStats* const s) {
+                            PassStats* const s, RowJob* const jobs) {
   VP8EncIterator it;
   uint64_t size = 0;
   uint64_t size_p0 = 0;
   uint64_t distortion = 0;
   const uint64_t pixel_count = nb_mbs * 384;
 
-  VP8IteratorInit(enc, &it);
-  SetLoopParams(enc, s->q);
-  do {
-    VP8ModeScore info;
-    VP8IteratorImport(&it, NULL);
-    if (VP8Decimate(&it, &info, rd_opt)) {
-      // Just record the number of skips and act like skip_proba is not used.
-      enc->proba_.nb_skip_++;
-    }
-    RecordResiduals(&it, &info);
-    size += info.R + info.H;
-    size_p0 += info.H;
-    distortion += info.D;
-    if (percent_delta && !VP8IteratorProgress(&it, percent_delta))
-      return 0;
-    VP8IteratorSaveBoundary(&it);
-  } while (VP8IteratorNext(&it) && --nb_mbs > 0);
+  if (jobs != NULL) {
+    SetLoopParams(enc, s->q);
+    InitRowJobs(enc, jobs, 1, rd_opt);
+    if (!RunRowJobs(enc, jobs, nb_mbs, percent_delta)) return 0;
+    MergeRowJobs(enc, jobs);
+    size = jobs[0].size;
+    size_p0 = jobs[0].size_p0;
+    distortion = jobs[0].distortion;
+    StoreMaxEdges(&jobs[0].it);
+  } else {
+    VP8IteratorInit(enc, &it);
+    SetLoopParams(enc, s->q);
+      do {
+      VP8ModeScore info;
+      VP8IteratorImport(&it, NULL);
+      if (VP8Decimate(&it, &info, rd_opt)) {
+        // Just record the number of skips and act like skip_proba is not used.
+        enc->proba_.nb_skip_++;
+      }
+      RecordResiduals(&it, &info, enc->proba_.stats_);
+      size += info.R + info.H;
+      size_p0 += info.H;
+      distortion += info.D;
+      if (percent_delta && !VP8IteratorProgress(&it, percent_delta))
+        return 0;
+      VP8IteratorSaveBoundary(&it);
+    } while (VP8IteratorNext(&it) && --nb_mbs > 0);
+    StoreMaxEdges(&it);
+  }
 
   size_p0 += enc->segment_hdr_.size_;
   if (s->do_size_search) {
@@ -572,7 +871,7 @@ static uint64_t OneStatPass(VP8Encoder* const enc, VP8RDLevel rd_opt,
   return size_p0;
 }
 
-static int StatLoop(VP8Encoder* const enc) {
+static int StatLoop(VP8Encoder* const enc, RowJob* const jobs) {
   const int method = enc->method_;
   const int do_search = enc->do_search_;
   const int fast_probe = ((method == 0 || method == 3) && !do_search);
@@ -603,7 +902,7 @@ static int StatLoop(VP8Encoder* const enc) {
                              (num_pass_left == 0) ||
                              (enc->max_i4_header_bits_ == 0);
     const uint64_t size_p0 =
-        OneStatPass(enc, rd_opt, nb_mbs, percent_per_pass, &stats);
+        OneStatPass(enc, rd_opt, nb_mbs, percent_per_pass, &stats, jobs);
     if (size_p0 == 0) return 0;
 #if (DEBUG_SEARCH > 0)
     printf("#%d value:%.1lf -> %.1lf   q:%.2f -> %.2f\n",
@@ -628,7 +927,9 @@ static int StatLoop(VP8Encoder* const enc) {
     FinalizeSkipProba(enc);
     FinalizeTokenProbas(&enc->proba_);
   }
-  VP8CalculateLevelCosts(&enc->proba_);  // finalize costs
+  if (NeedLevelCosts(enc)) {
+    VP8CalculateLevelCosts(&enc->proba_);  // finalize costs
+  }
   return WebPReportProgress(enc->pic_, final_percent, &enc->percent_);
 }
 
@@ -674,6 +975,7 @@ static int PostLoopFinalize(VP8EncIterator* const it, int ok) {
         }
       }
     }
+    StoreMaxEdges(it);
     VP8AdjustFilterStrength(it);     // ...and store filter stats.
   } else {
     // Something bad happened -> need to do some memory cleanup.
@@ -685,21 +987,30 @@ static int PostLoopFinalize(VP8EncIterator* const it, int ok) {
 //------------------------------------------------------------------------------
 //  VP8EncLoop(): does the final bitstream coding.
 
-static void ResetAfterSkip(VP8EncIterator* const it) {
-  if (it->mb_->type_ == 1) {
-    *it->nz_ = 0;  // reset all predictors
-    it->left_nz_[8] = 0;
-  } else {
-    *it->nz_ &= (1 << 24);  // preserve the dc_nz bit
-  }
-}
-
 int VP8EncLoop(VP8Encoder* const enc) {
   VP8EncIterator it;
+  RowJob* jobs = NULL;
   int ok = PreLoopInitialize(enc);
   if (!ok) return 0;
 
-  StatLoop(enc);  // stats-collection loop
+#ifdef WEBP_USE_THREAD
+  // One wavefront job per partition, so that each partition is still filled
+  // by a single job, in row order.
+  if (enc->thread_level_ > 0 && enc->num_parts_ > 1 && enc->mb_h_ > 1) {
+    jobs = NewRowJobs(enc->num_parts_);
+  }
+#endif
+
+  StatLoop(enc, jobs);  // stats-collection loop
+
+  if (jobs != NULL) {
+    InitRowJobs(enc, jobs, 0, enc->rd_opt_level_);
+    ok = RunRowJobs(enc, jobs, enc->mb_w_ * enc->mb_h_, 20);
+    MergeRowJobs(enc, jobs);
+    ok = PostLoopFinalize(&jobs[0].it, ok);
+    DeleteRowJobs(jobs);
+    return ok;
+  }
 
   VP8IteratorInit(enc, &it);
   VP8InitFilter(&it);
@@ -716,7 +1027,7 @@ int VP8EncLoop(VP8Encoder* const enc) {
     } else {   // reset predictors after a skip
       ResetAfterSkip(&it);
     }
-    StoreSideInfo(&it);
+    StoreSideInfo(&it, enc->sse_, &enc->sse_count_, enc->block_count_);
     VP8StoreFilterStats(&it);
     VP8IteratorExport(&it);
     ok = VP8IteratorProgress(&it, 20);
@@ -788,7 +1099,7 @@ int VP8EncTokenLoop(VP8Encoder* const enc) {
       size_p0 += info.H;
       distortion += info.D;
       if (is_last_pass) {
-        StoreSideInfo(&it);
+        StoreSideInfo(&it, enc->sse_, &enc->sse_count_, enc->block_count_);
         VP8StoreFilterStats(&it);
         VP8IteratorExport(&it);
         ok = VP8IteratorProgress(&it, 20);
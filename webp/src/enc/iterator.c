@@ -55,6 +55,7 @@ void VP8IteratorReset(VP8EncIterator* const it) {
   InitTop(it);
   InitLeft(it);
   memset(it->bit_count_, 0, sizeof(it->bit_count_));
+  memset(it->max_edge_, 0, sizeof(it->max_edge_));
   it->do_trellis_ = 0;
 }
 
@@ -239,6 +239,7 @@ typedef struct {
   uint64_t      luma_bits_;        // macroblock bit-cost for luma
   uint64_t      uv_bits_;          // macroblock bit-cost for chroma
   LFStats*      lf_stats_;         // filter stats (borrowed from enc_)
+  int           max_edge_[NUM_MB_SEGMENTS];  // max edge delta, per segment
   int           do_trellis_;       // if true, perform extra level optimisation
   int           count_down_;       // number of mb still to be processed
   int           count_down0_;      // starting counter value (for progress)
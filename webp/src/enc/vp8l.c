@@ -223,11 +223,13 @@ static void AddSingle(uint32_t p,
   ++b[(p & 0xff)];
 }
 
+// Computes the entropy mode with the smallest estimated entropy, and for each
+// mode, whether its red and blue histograms are all zero.
 static int AnalyzeEntropy(const uint32_t* argb,
                           int width, int height, int argb_stride,
                           int use_palette,
                           EntropyIx* const min_entropy_ix,
-                          int* const red_and_blue_always_zero) {
+                          int red_and_blue_always_zero[kNumEntropyIx]) {
   // Allocate histogram set with cache_bits = 0.
   uint32_t* const histo =
       (uint32_t*)WebPSafeCalloc(kHistoTotal, sizeof(*histo) * 256);
@@ -312,10 +314,9 @@ static int AnalyzeEntropy(const uint32_t* argb,
           *min_entropy_ix = k;
         }
       }
-      *red_and_blue_always_zero = 1;
-      // Let's check if the histogram of the chosen entropy mode has
-      // non-zero red and blue values. If all are zero, we can later skip
-      // the cross color optimization.
+      // Let's check if the histograms of the entropy modes have non-zero
+      // red and blue values. If all are zero, we can later skip the cross
+      // color optimization.
       {
         static const uint8_t kHistoPairs[5][2] = {
           { kHistoRed, kHistoBlue },
@@ -324,14 +325,15 @@ static int AnalyzeEntropy(const uint32_t* argb,
           { kHistoRedPredSubGreen, kHistoBluePredSubGreen },
           { kHistoRed, kHistoBlue }
         };
-        const uint32_t* const red_histo =
-            &histo[256 * kHistoPairs[*min_entropy_ix][0]];
-        const uint32_t* const blue_histo =
-            &histo[256 * kHistoPairs[*min_entropy_ix][1]];
-        for (i = 1; i < 256; ++i) {
-          if ((red_histo[i] | blue_histo[i]) != 0) {
-            *red_and_blue_always_zero = 0;
-            break;
+        for (k = kDirect; k <= last_mode_to_analyze; ++k) {
+          const uint32_t* const red_histo = &histo[256 * kHistoPairs[k][0]];
+          const uint32_t* const blue_histo = &histo[256 * kHistoPairs[k][1]];
+          red_and_blue_always_zero[k] = 1;
+          for (i = 1; i < 256; ++i) {
+            if ((red_histo[i] | blue_histo[i]) != 0) {
+              red_and_blue_always_zero[k] = 0;
+              break;
+            }
           }
         }
       }
@@ -361,17 +363,46 @@ static int GetTransformBits(int method, int histo_bits) {
   return (histo_bits > max_transform_bits) ? max_transform_bits : histo_bits;
 }
 
-static int AnalyzeAndInit(VP8LEncoder* const enc) {
+// Set of transforms to try for the image.
+typedef struct {
+  int use_palette;
+  int use_subtract_green;
+  int use_predict;
+  int use_cross_color;
+} CrunchConfig;
+
+static void SetCrunchConfig(EntropyIx entropy_ix, int red_and_blue_always_zero,
+                            CrunchConfig* const crunch) {
+  crunch->use_palette = (entropy_ix == kPalette);
+  crunch->use_subtract_green =
+      (entropy_ix == kSubGreen) || (entropy_ix == kSpatialSubGreen);
+  crunch->use_predict =
+      (entropy_ix == kSpatial) || (entropy_ix == kSpatialSubGreen);
+  crunch->use_cross_color =
+      red_and_blue_always_zero ? 0 : crunch->use_predict;
+}
+
+// Returns true if all the entropy modes should be tried instead of the one
+// with the smallest estimated entropy (highest effort lossless).
+static int DoCrunchAllModes(const WebPConfig* const config) {
+#ifdef WEBP_EXPERIMENTAL_FEATURES
+  if (config->delta_palettization) return 0;
+#endif
+  return (config->method == 6 && config->quality >= 100.f &&
+          config->near_lossless >= 100);
+}
+
+// Analyzes the picture and fills 'crunch_configs' with the transform sets
+// to try. The first one is the preferred one.
+static int AnalyzeAndInit(VP8LEncoder* const enc,
+                          CrunchConfig crunch_configs[kNumEntropyIx],
+                          int* const num_crunch_configs) {
   const WebPPicture* const pic = enc->pic_;
   const int width = pic->width;
   const int height = pic->height;
-  const int pix_cnt = width * height;
   const WebPConfig* const config = enc->config_;
   const int method = config->method;
   const int low_effort = (config->method == 0);
-  // we round the block size up, so we're guaranteed to have
-  // at max MAX_REFS_BLOCK_PER_IMAGE blocks used:
-  int refs_block_size = (pix_cnt - 1) / MAX_REFS_BLOCK_PER_IMAGE + 1;
   assert(pic != NULL && pic->argb != NULL);
 
   enc->use_cross_color_ = 0;
@@ -387,26 +418,49 @@ static int AnalyzeAndInit(VP8LEncoder* const enc) {
                                   pic->width, pic->height);
   enc->transform_bits_ = GetTransformBits(method, enc->histo_bits_);
 
+  *num_crunch_configs = 1;
   if (low_effort) {
     // AnalyzeEntropy is somewhat slow.
-    enc->use_predict_ = !enc->use_palette_;
-    enc->use_subtract_green_ = !enc->use_palette_;
-    enc->use_cross_color_ = 0;
+    crunch_configs[0].use_palette = enc->use_palette_;
+    crunch_configs[0].use_predict = !enc->use_palette_;
+    crunch_configs[0].use_subtract_green = !enc->use_palette_;
+    crunch_configs[0].use_cross_color = 0;
   } else {
-    int red_and_blue_always_zero;
+    int red_and_blue_always_zero[kNumEntropyIx];
     EntropyIx min_entropy_ix;
     if (!AnalyzeEntropy(pic->argb, width, height, pic->argb_stride,
                         enc->use_palette_, &min_entropy_ix,
-                        &red_and_blue_always_zero)) {
+                        red_and_blue_always_zero)) {
       return 0;
     }
-    enc->use_palette_ = (min_entropy_ix == kPalette);
-    enc->use_subtract_green_ =
-        (min_entropy_ix == kSubGreen) || (min_entropy_ix == kSpatialSubGreen);
-    enc->use_predict_ =
-        (min_entropy_ix == kSpatial) || (min_entropy_ix == kSpatialSubGreen);
-    enc->use_cross_color_ = red_and_blue_always_zero ? 0 : enc->use_predict_;
+    SetCrunchConfig(min_entropy_ix, red_and_blue_always_zero[min_entropy_ix],
+                    &crunch_configs[0]);
+    if (DoCrunchAllModes(config)) {
+      const EntropyIx last_mode = enc->use_palette_ ? kPalette
+                                                    : kSpatialSubGreen;
+      EntropyIx k;
+      for (k = kDirect; k <= last_mode; ++k) {
+        if (k == min_entropy_ix) continue;
+        SetCrunchConfig(k, red_and_blue_always_zero[k],
+                        &crunch_configs[(*num_crunch_configs)++]);
+      }
+    }
   }
+  return 1;
+}
+
+// Sets up the transforms of 'crunch' and the backward references buffers.
+static int InitForCrunchConfig(VP8LEncoder* const enc,
+                               const CrunchConfig* const crunch) {
+  const int pix_cnt = enc->pic_->width * enc->pic_->height;
+  // we round the block size up, so we're guaranteed to have
+  // at max MAX_REFS_BLOCK_PER_IMAGE blocks used:
+  int refs_block_size = (pix_cnt - 1) / MAX_REFS_BLOCK_PER_IMAGE + 1;
+
+  enc->use_palette_ = crunch->use_palette;
+  enc->use_subtract_green_ = crunch->use_subtract_green;
+  enc->use_predict_ = crunch->use_predict;
+  enc->use_cross_color_ = crunch->use_cross_color;
 
   if (!VP8LHashChainInit(&enc->hash_chain_, pix_cnt)) return 0;
 
@@ -1363,12 +1417,18 @@ static VP8LEncoder* VP8LEncoderNew(const WebPConfig* const config,
   return enc;
 }
 
+// Releases the (potentially large) buffers used while encoding, but keeps the
+// encoding parameters.
+static void VP8LEncoderClearBuffers(VP8LEncoder* const enc) {
+  VP8LHashChainClear(&enc->hash_chain_);
+  VP8LBackwardRefsClear(&enc->refs_[0]);
+  VP8LBackwardRefsClear(&enc->refs_[1]);
+  ClearTransformBuffer(enc);
+}
+
 static void VP8LEncoderDelete(VP8LEncoder* enc) {
   if (enc != NULL) {
-    VP8LHashChainClear(&enc->hash_chain_);
-    VP8LBackwardRefsClear(&enc->refs_[0]);
-    VP8LBackwardRefsClear(&enc->refs_[1]);
-    ClearTransformBuffer(enc);
+    VP8LEncoderClearBuffers(enc);
     WebPSafeFree(enc);
   }
 }
@@ -1376,43 +1436,20 @@ static void VP8LEncoderDelete(VP8LEncoder* enc) {
 // -----------------------------------------------------------------------------
 // Main call
 
-WebPEncodingError VP8LEncodeStream(const WebPConfig* const config,
-                                   const WebPPicture* const picture,
-                                   VP8LBitWriter* const bw) {
+// Encodes the transforms and the image of 'enc' with the transform set
+// 'crunch', appending to 'bw'.
+static WebPEncodingError EncodeStreamWithConfig(
+    VP8LEncoder* const enc, const CrunchConfig* const crunch,
+    VP8LBitWriter* const bw, size_t byte_position,
+    int* const hdr_size, int* const data_size) {
   WebPEncodingError err = VP8_ENC_OK;
+  const WebPConfig* const config = enc->config_;
   const int quality = (int)config->quality;
   const int low_effort = (config->method == 0);
-  const int width = picture->width;
-  const int height = picture->height;
-  VP8LEncoder* const enc = VP8LEncoderNew(config, picture);
-  const size_t byte_position = VP8LBitWriterNumBytes(bw);
-  int use_near_lossless = 0;
-  int hdr_size = 0;
-  int data_size = 0;
+  const int height = enc->pic_->height;
   int use_delta_palettization = 0;
 
-  if (enc == NULL) {
-    err = VP8_ENC_ERROR_OUT_OF_MEMORY;
-    goto Error;
-  }
-
-  // ---------------------------------------------------------------------------
-  // Analyze image (entropy, num_palettes etc)
-
-  if (!AnalyzeAndInit(enc)) {
-    err = VP8_ENC_ERROR_OUT_OF_MEMORY;
-    goto Error;
-  }
-
-  // Apply near-lossless preprocessing.
-  use_near_lossless = !enc->use_palette_ && (config->near_lossless < 100);
-  if (use_near_lossless) {
-    if (!VP8ApplyNearLossless(width, height, picture->argb,
-                              config->near_lossless)) {
-      err = VP8_ENC_ERROR_OUT_OF_MEMORY;
-      goto Error;
-    }
-  }
+  if (!InitForCrunchConfig(enc, crunch)) return VP8_ENC_ERROR_OUT_OF_MEMORY;
 
 #ifdef WEBP_EXPERIMENTAL_FEATURES
   if (config->delta_palettization) {
@@ -1421,14 +1458,14 @@ WebPEncodingError VP8LEncodeStream(const WebPConfig* const config,
     enc->use_subtract_green_ = 0;
     enc->use_palette_ = 1;
     err = MakeInputImageCopy(enc);
-    if (err != VP8_ENC_OK) goto Error;
+    if (err != VP8_ENC_OK) return err;
     err = WebPSearchOptimalDeltaPalette(enc);
-    if (err != VP8_ENC_OK) goto Error;
+    if (err != VP8_ENC_OK) return err;
     if (enc->use_palette_) {
-      err = AllocateTransformBuffer(enc, width, height);
-      if (err != VP8_ENC_OK) goto Error;
+      err = AllocateTransformBuffer(enc, enc->pic_->width, height);
+      if (err != VP8_ENC_OK) return err;
       err = EncodeDeltaPalettePredictorImage(bw, enc, quality);
-      if (err != VP8_ENC_OK) goto Error;
+      if (err != VP8_ENC_OK) return err;
       use_delta_palettization = 1;
     }
   }
@@ -1437,15 +1474,15 @@ WebPEncodingError VP8LEncodeStream(const WebPConfig* const config,
   // Encode palette
   if (enc->use_palette_) {
     err = EncodePalette(bw, enc);
-    if (err != VP8_ENC_OK) goto Error;
+    if (err != VP8_ENC_OK) return err;
     err = MapImageFromPalette(enc, use_delta_palettization);
-    if (err != VP8_ENC_OK) goto Error;
+    if (err != VP8_ENC_OK) return err;
   }
   if (!use_delta_palettization) {
     // In case image is not packed.
     if (enc->argb_ == NULL) {
       err = MakeInputImageCopy(enc);
-      if (err != VP8_ENC_OK) goto Error;
+      if (err != VP8_ENC_OK) return err;
     }
 
     // -------------------------------------------------------------------------
@@ -1458,13 +1495,13 @@ WebPEncodingError VP8LEncodeStream(const WebPConfig* const config,
     if (enc->use_predict_) {
       err = ApplyPredictFilter(enc, enc->current_width_, height, quality,
                                low_effort, bw);
-      if (err != VP8_ENC_OK) goto Error;
+      if (err != VP8_ENC_OK) return err;
     }
 
     if (enc->use_cross_color_) {
       err = ApplyCrossColorFilter(enc, enc->current_width_,
                                   height, quality, bw);
-      if (err != VP8_ENC_OK) goto Error;
+      if (err != VP8_ENC_OK) return err;
     }
   }
 
@@ -1472,26 +1509,223 @@ WebPEncodingError VP8LEncodeStream(const WebPConfig* const config,
 
   // ---------------------------------------------------------------------------
   // Encode and write the transformed image.
-  err = EncodeImageInternal(bw, enc->argb_, &enc->hash_chain_, enc->refs_,
-                            enc->current_width_, height, quality, low_effort,
-                            &enc->cache_bits_, enc->histo_bits_, byte_position,
-                            &hdr_size, &data_size);
-  if (err != VP8_ENC_OK) goto Error;
+  return EncodeImageInternal(bw, enc->argb_, &enc->hash_chain_, enc->refs_,
+                             enc->current_width_, height, quality, low_effort,
+                             &enc->cache_bits_, enc->histo_bits_,
+                             byte_position, hdr_size, data_size);
+}
 
-  if (picture->stats != NULL) {
-    WebPAuxStats* const stats = picture->stats;
-    stats->lossless_features = 0;
-    if (enc->use_predict_) stats->lossless_features |= 1;
-    if (enc->use_cross_color_) stats->lossless_features |= 2;
-    if (enc->use_subtract_green_) stats->lossless_features |= 4;
-    if (enc->use_palette_) stats->lossless_features |= 8;
-    stats->histogram_bits = enc->histo_bits_;
-    stats->transform_bits = enc->transform_bits_;
-    stats->cache_bits = enc->cache_bits_;
-    stats->palette_size = enc->palette_size_;
-    stats->lossless_size = (int)(VP8LBitWriterNumBytes(bw) - byte_position);
-    stats->lossless_hdr_size = hdr_size;
-    stats->lossless_data_size = data_size;
+// Job trying some of the transform sets, and keeping the smallest result.
+typedef struct {
+  WebPWorker worker;
+  const VP8LEncoder* analysis;     // analyzed encoder, used as template
+  const VP8LBitWriter* bw_init;    // bits written before the image stream
+  size_t byte_position;            // size of 'bw_init'
+  size_t extra_size;               // initial room for the image stream
+  const CrunchConfig* crunch_configs;
+  int first_config, config_step, num_crunch_configs;
+  // Best result so far.
+  VP8LEncoder* enc;
+  VP8LBitWriter bw;
+  int best_config;
+  int hdr_size, data_size;
+  WebPEncodingError err;
+} StreamJob;
+
+static int DoStreamJob(StreamJob* const job, void* const unused) {
+  int i;
+  (void)unused;
+  for (i = job->first_config; i < job->num_crunch_configs;
+       i += job->config_step) {
+    int hdr_size = 0, data_size = 0;
+    VP8LBitWriter bw;
+    VP8LEncoder* enc = (VP8LEncoder*)WebPSafeMalloc(1ULL, sizeof(*enc));
+    WebPEncodingError err = VP8_ENC_ERROR_OUT_OF_MEMORY;
+    memset(&bw, 0, sizeof(bw));
+    if (enc != NULL) {
+      memcpy(enc, job->analysis, sizeof(*enc));
+    }
+    if (enc != NULL &&
+        VP8LBitWriterClone(job->bw_init, &bw, job->extra_size)) {
+      err = EncodeStreamWithConfig(enc, &job->crunch_configs[i], &bw,
+                                   job->byte_position, &hdr_size, &data_size);
+      VP8LEncoderClearBuffers(enc);
+      if (err == VP8_ENC_OK && bw.error_) err = VP8_ENC_ERROR_OUT_OF_MEMORY;
+    }
+    if (err == VP8_ENC_OK &&
+        (job->enc == NULL ||
+         VP8LBitWriterNumBytes(&bw) < VP8LBitWriterNumBytes(&job->bw))) {
+      VP8LBitWriter tmp = job->bw;   // keep this one, and release the other
+      VP8LEncoder* const tmp_enc = job->enc;
+      job->bw = bw;
+      bw = tmp;
+      job->enc = enc;
+      enc = tmp_enc;
+      job->best_config = i;
+      job->hdr_size = hdr_size;
+      job->data_size = data_size;
+    }
+    VP8LBitWriterWipeOut(&bw);
+    VP8LEncoderDelete(enc);
+    if (err != VP8_ENC_OK) {
+      job->err = err;
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static void InitStreamJob(StreamJob* const job,
+                          const VP8LEncoder* const analysis,
+                          const VP8LBitWriter* const bw_init,
+                          size_t byte_position,
+                          const CrunchConfig* const crunch_configs,
+                          int num_crunch_configs, int first_config,
+                          int config_step) {
+  memset(job, 0, sizeof(*job));
+  WebPGetWorkerInterface()->Init(&job->worker);
+  job->worker.data1 = job;
+  job->worker.data2 = NULL;
+  job->worker.hook = (WebPWorkerHook)DoStreamJob;
+  job->analysis = analysis;
+  job->bw_init = bw_init;
+  job->byte_position = byte_position;
+  job->extra_size = (size_t)(bw_init->end_ - bw_init->buf_);
+  job->crunch_configs = crunch_configs;
+  job->num_crunch_configs = num_crunch_configs;
+  job->first_config = first_config;
+  job->config_step = config_step;
+  job->best_config = -1;
+  job->err = VP8_ENC_OK;
+}
+
+static void ClearStreamJob(StreamJob* const job) {
+  WebPGetWorkerInterface()->End(&job->worker);
+  VP8LEncoderDelete(job->enc);
+  job->enc = NULL;
+  VP8LBitWriterWipeOut(&job->bw);
+}
+
+static void StoreLosslessStats(const VP8LEncoder* const enc,
+                               int lossless_size, int hdr_size, int data_size,
+                               WebPAuxStats* const stats) {
+  stats->lossless_features = 0;
+  if (enc->use_predict_) stats->lossless_features |= 1;
+  if (enc->use_cross_color_) stats->lossless_features |= 2;
+  if (enc->use_subtract_green_) stats->lossless_features |= 4;
+  if (enc->use_palette_) stats->lossless_features |= 8;
+  stats->histogram_bits = enc->histo_bits_;
+  stats->transform_bits = enc->transform_bits_;
+  stats->cache_bits = enc->cache_bits_;
+  stats->palette_size = enc->palette_size_;
+  stats->lossless_size = lossless_size;
+  stats->lossless_hdr_size = hdr_size;
+  stats->lossless_data_size = data_size;
+}
+
+WebPEncodingError VP8LEncodeStream(const WebPConfig* const config,
+                                   const WebPPicture* const picture,
+                                   VP8LBitWriter* const bw) {
+  WebPEncodingError err = VP8_ENC_OK;
+  const int width = picture->width;
+  const int height = picture->height;
+  VP8LEncoder* const enc = VP8LEncoderNew(config, picture);
+  const size_t byte_position = VP8LBitWriterNumBytes(bw);
+  CrunchConfig crunch_configs[kNumEntropyIx];
+  int num_crunch_configs = 0;
+  int use_near_lossless = 0;
+
+  if (enc == NULL) {
+    err = VP8_ENC_ERROR_OUT_OF_MEMORY;
+    goto Error;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Analyze image (entropy, num_palettes etc)
+
+  if (!AnalyzeAndInit(enc, crunch_configs, &num_crunch_configs)) {
+    err = VP8_ENC_ERROR_OUT_OF_MEMORY;
+    goto Error;
+  }
+
+  // Apply near-lossless preprocessing.
+  use_near_lossless =
+      !crunch_configs[0].use_palette && (config->near_lossless < 100);
+  if (use_near_lossless) {
+    assert(num_crunch_configs == 1);
+    if (!VP8ApplyNearLossless(width, height, picture->argb,
+                              config->near_lossless)) {
+      err = VP8_ENC_ERROR_OUT_OF_MEMORY;
+      goto Error;
+    }
+  }
+
+  if (num_crunch_configs == 1) {
+    int hdr_size = 0;
+    int data_size = 0;
+    err = EncodeStreamWithConfig(enc, &crunch_configs[0], bw, byte_position,
+                                 &hdr_size, &data_size);
+    if (err != VP8_ENC_OK) goto Error;
+    if (picture->stats != NULL) {
+      StoreLosslessStats(enc,
+                         (int)(VP8LBitWriterNumBytes(bw) - byte_position),
+                         hdr_size, data_size, picture->stats);
+    }
+  } else {
+    // Try all the transform sets and keep the smallest bitstream. The sets
+    // are shared between the main thread and a side worker, each encoding
+    // from its own copy of the analyzed encoder and of 'bw'.
+    const WebPWorkerInterface* const worker_interface =
+        WebPGetWorkerInterface();
+    StreamJob main_job, side_job;
+    StreamJob* best_job = &main_job;
+#ifdef WEBP_USE_THREAD
+    const int do_mt = (config->thread_level > 0);
+#else
+    const int do_mt = 0;
+#endif
+    InitStreamJob(&main_job, enc, bw, byte_position,
+                  crunch_configs, num_crunch_configs, 0, do_mt ? 2 : 1);
+    InitStreamJob(&side_job, enc, bw, byte_position,
+                  crunch_configs, num_crunch_configs,
+                  do_mt ? 1 : num_crunch_configs, 2);
+    // we don't need to call Reset() on main_job.worker, since we're calling
+    // WebPWorkerExecute() on it
+    if (do_mt && !worker_interface->Reset(&side_job.worker)) {
+      err = VP8_ENC_ERROR_OUT_OF_MEMORY;
+    } else {
+      if (do_mt) worker_interface->Launch(&side_job.worker);
+      worker_interface->Execute(&main_job.worker);
+      if (!worker_interface->Sync(&main_job.worker)) err = main_job.err;
+      if (!worker_interface->Sync(&side_job.worker) && err == VP8_ENC_OK) {
+        err = side_job.err;
+      }
+    }
+    if (err == VP8_ENC_OK) {
+      // On equal sizes, prefer the lowest set index (the analyzed one first).
+      if (side_job.best_config >= 0) {
+        const size_t main_size = VP8LBitWriterNumBytes(&main_job.bw);
+        const size_t side_size = VP8LBitWriterNumBytes(&side_job.bw);
+        if (side_size < main_size ||
+            (side_size == main_size &&
+             side_job.best_config < main_job.best_config)) {
+          best_job = &side_job;
+        }
+      }
+      assert(best_job->best_config >= 0);
+      // Hand the best bitstream over to 'bw'.
+      VP8LBitWriterWipeOut(bw);
+      *bw = best_job->bw;
+      memset(&best_job->bw, 0, sizeof(best_job->bw));
+      if (picture->stats != NULL) {
+        StoreLosslessStats(best_job->enc,
+                           (int)(VP8LBitWriterNumBytes(bw) - byte_position),
+                           best_job->hdr_size, best_job->data_size,
+                           picture->stats);
+      }
+    }
+    ClearStreamJob(&main_job);
+    ClearStreamJob(&side_job);
   }
 
  Error:
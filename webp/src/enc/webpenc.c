@@ -73,6 +73,8 @@ static void ResetBoundaryPredictions(VP8Encoder* const enc) {
 //-------------------+---+---+---+---+---+---+---+
 // fast probe        | x |   |   | x |   |   |   |
 //-------------------+---+---+---+---+---+---+---+
+// disto-pick i16/uv | x |   |   |   |   |   |   |
+//-------------------+---+---+---+---+---+---+---+
 // dynamic proba     | ~ | x | x | x | x | x | x |
 //-------------------+---+---+---+---+---+---+---+
 // fast mode analysis|   |   |   |   | x | x | x |
@@ -108,7 +110,10 @@ static void MapConfigToTools(VP8Encoder* const enc) {
   enc->thread_level_ = config->thread_level;
 
   enc->do_search_ = (config->target_size > 0 || config->target_PSNR > 0);
-  if (!config->low_memory) {
+  // The token buffer needs a single partition, whereas the multi-threaded
+  // coding loop spreads the rows over the partitions: prefer the latter.
+  if (!config->low_memory &&
+      !(enc->thread_level_ > 0 && enc->num_parts_ > 1)) {
 #if !defined(DISABLE_TOKEN_BUFFER)
     enc->use_tokens_ = (enc->rd_opt_level_ >= RD_OPT_BASIC);  // need rd stats
 #endif
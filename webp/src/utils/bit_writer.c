@@ -246,6 +246,18 @@ void VP8LBitWriterWipeOut(VP8LBitWriter* const bw) {
   }
 }
 
+int VP8LBitWriterClone(const VP8LBitWriter* const src,
+                       VP8LBitWriter* const dst, size_t extra_size) {
+  const size_t current_size = src->cur_ - src->buf_;
+  if (!VP8LBitWriterInit(dst, current_size + extra_size)) return 0;
+  if (current_size > 0) memcpy(dst->buf_, src->buf_, current_size);
+  dst->cur_ = dst->buf_ + current_size;
+  dst->bits_ = src->bits_;
+  dst->used_ = src->used_;
+  dst->error_ = src->error_;
+  return 1;
+}
+
 void VP8LPutBitsFlushBits(VP8LBitWriter* const bw) {
   // If needed, make some room by flushing some bits out.
   if (bw->cur_ + VP8L_WRITER_BYTES > bw->end_) {
@@ -109,6 +109,10 @@ int VP8LBitWriterInit(VP8LBitWriter* const bw, size_t expected_size);
 uint8_t* VP8LBitWriterFinish(VP8LBitWriter* const bw);
 // Release any pending memory and zeroes the object.
 void VP8LBitWriterWipeOut(VP8LBitWriter* const bw);
+// Initializes 'dst' with a copy of the bits written so far in 'src', with
+// 'extra_size' bytes of room to grow. Returns false in case of memory error.
+int VP8LBitWriterClone(const VP8LBitWriter* const src,
+                       VP8LBitWriter* const dst, size_t extra_size);
 
 // Internal function for VP8LPutBits flushing 32 bits from the written state.
 void VP8LPutBitsFlushBits(VP8LBitWriter* const bw);
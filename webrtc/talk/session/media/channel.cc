@@ -503,8 +503,10 @@ void BaseChannel::OnChannelRead(TransportChannel* channel,
   // When using RTCP multiplexing we might get RTCP packets on the RTP
   // transport. We feed RTP traffic into the demuxer to determine if it is RTCP.
   bool rtcp = PacketIsRtcp(channel, data, len);
-  rtc::Buffer packet(data, len);
-  HandlePacket(rtcp, &packet, packet_time);
+  // The packet is copied once, since SRTP decrypts it in place. The media
+  // channels handle it synchronously, so the buffer can be reused.
+  receive_buffer_.SetData(data, len);
+  HandlePacket(rtcp, &receive_buffer_, packet_time);
 }
 
 void BaseChannel::OnReadyToSend(TransportChannel* channel) {
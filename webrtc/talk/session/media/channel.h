@@ -46,6 +46,7 @@
 #include "talk/session/media/srtpfilter.h"
 #include "webrtc/audio/audio_sink.h"
 #include "webrtc/base/asyncudpsocket.h"
+#include "webrtc/base/buffer.h"
 #include "webrtc/base/criticalsection.h"
 #include "webrtc/base/network.h"
 #include "webrtc/base/sigslot.h"
@@ -330,6 +331,10 @@ class BaseChannel
   MediaContentDirection local_content_direction_;
   MediaContentDirection remote_content_direction_;
   bool has_received_packet_;
+  // Holds the packet that is being handled by OnChannelRead(). It is reused
+  // for every incoming packet, so that receiving does not allocate once the
+  // buffer has grown to the largest packet size.
+  rtc::Buffer receive_buffer_;
   bool dtls_keyed_;
   bool secure_required_;
   int rtp_abs_sendtime_extn_id_;
@@ -255,6 +255,24 @@ bool SrtpFilter::UnprotectRtp(void* p, int in_len, int* out_len) {
   return recv_session_->UnprotectRtp(p, in_len, out_len);
 }
 
+bool SrtpFilter::ProtectRtp(std::vector<SrtpPacket>* packets) {
+  if (!IsActive()) {
+    LOG(LS_WARNING) << "Failed to ProtectRtp: SRTP not active";
+    return false;
+  }
+  ASSERT(send_session_ != NULL);
+  return send_session_->ProtectRtp(packets);
+}
+
+bool SrtpFilter::UnprotectRtp(std::vector<SrtpPacket>* packets) {
+  if (!IsActive()) {
+    LOG(LS_WARNING) << "Failed to UnprotectRtp: SRTP not active";
+    return false;
+  }
+  ASSERT(recv_session_ != NULL);
+  return recv_session_->UnprotectRtp(packets);
+}
+
 bool SrtpFilter::UnprotectRtcp(void* p, int in_len, int* out_len) {
   if (!IsActive()) {
     LOG(LS_WARNING) << "Failed to UnprotectRtcp: SRTP not active";
@@ -605,6 +623,103 @@ bool SrtpSession::UnprotectRtp(void* p, int in_len, int* out_len) {
   return true;
 }
 
+bool SrtpSession::ProtectRtp(std::vector<SrtpPacket>* packets) {
+  if (!session_) {
+    LOG(LS_WARNING) << "Failed to protect SRTP packets: no SRTP Session";
+    return false;
+  }
+
+  // Packets whose buffer can't hold the auth tag are failed up front; the
+  // rest go to libsrtp in one call. |indices| maps batch entries back.
+  std::vector<srtp_packet_t> batch;
+  std::vector<size_t> indices;
+  batch.reserve(packets->size());
+  indices.reserve(packets->size());
+  bool all_ok = true;
+  for (size_t i = 0; i < packets->size(); ++i) {
+    SrtpPacket& packet = (*packets)[i];
+    int need_len = packet.len + rtp_auth_tag_len_;  // NOLINT
+    if (packet.max_len < need_len) {
+      LOG(LS_WARNING) << "Failed to protect SRTP packet: The buffer length "
+                      << packet.max_len << " is less than the needed "
+                      << need_len;
+      packet.ok = false;
+      all_ok = false;
+      continue;
+    }
+    srtp_packet_t entry;
+    entry.hdr = packet.data;
+    entry.len = packet.len;
+    entry.status = err_status_ok;
+    batch.push_back(entry);
+    indices.push_back(i);
+  }
+  if (batch.empty())
+    return all_ok;
+
+  srtp_protect_batch(session_, &batch[0], static_cast<int>(batch.size()));
+
+  for (size_t j = 0; j < batch.size(); ++j) {
+    SrtpPacket& packet = (*packets)[indices[j]];
+    int err = batch[j].status;
+    uint32_t ssrc;
+    if (GetRtpSsrc(packet.data, packet.len, &ssrc)) {
+      srtp_stat_->AddProtectRtpResult(ssrc, err);
+    }
+    int seq_num;
+    GetRtpSeqNum(packet.data, packet.len, &seq_num);
+    if (err != err_status_ok) {
+      LOG(LS_WARNING) << "Failed to protect SRTP packet, seqnum="
+                      << seq_num << ", err=" << err << ", last seqnum="
+                      << last_send_seq_num_;
+      packet.ok = false;
+      all_ok = false;
+      continue;
+    }
+    last_send_seq_num_ = seq_num;
+    packet.len = batch[j].len;
+    packet.ok = true;
+  }
+  return all_ok;
+}
+
+bool SrtpSession::UnprotectRtp(std::vector<SrtpPacket>* packets) {
+  if (!session_) {
+    LOG(LS_WARNING) << "Failed to unprotect SRTP packets: no SRTP Session";
+    return false;
+  }
+  if (packets->empty())
+    return true;
+
+  std::vector<srtp_packet_t> batch(packets->size());
+  for (size_t i = 0; i < packets->size(); ++i) {
+    batch[i].hdr = (*packets)[i].data;
+    batch[i].len = (*packets)[i].len;
+    batch[i].status = err_status_ok;
+  }
+
+  srtp_unprotect_batch(session_, &batch[0], static_cast<int>(batch.size()));
+
+  bool all_ok = true;
+  for (size_t i = 0; i < packets->size(); ++i) {
+    SrtpPacket& packet = (*packets)[i];
+    int err = batch[i].status;
+    uint32_t ssrc;
+    if (GetRtpSsrc(packet.data, packet.len, &ssrc)) {
+      srtp_stat_->AddUnprotectRtpResult(ssrc, err);
+    }
+    if (err != err_status_ok) {
+      LOG(LS_WARNING) << "Failed to unprotect SRTP packet, err=" << err;
+      packet.ok = false;
+      all_ok = false;
+      continue;
+    }
+    packet.len = batch[i].len;
+    packet.ok = true;
+  }
+  return all_ok;
+}
+
 bool SrtpSession::UnprotectRtcp(void* p, int in_len, int* out_len) {
   if (!session_) {
     LOG(LS_WARNING) << "Failed to unprotect SRTCP packet: no SRTP Session";
@@ -842,6 +957,14 @@ bool SrtpSession::UnprotectRtcp(void* data, int in_len, int* out_len) {
   return SrtpNotAvailable(__FUNCTION__);
 }
 
+bool SrtpSession::ProtectRtp(std::vector<SrtpPacket>* packets) {
+  return SrtpNotAvailable(__FUNCTION__);
+}
+
+bool SrtpSession::UnprotectRtp(std::vector<SrtpPacket>* packets) {
+  return SrtpNotAvailable(__FUNCTION__);
+}
+
 void SrtpSession::set_signal_silent_time(uint32_t signal_silent_time) {
   // Do nothing.
 }
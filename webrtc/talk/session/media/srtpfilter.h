@@ -58,6 +58,20 @@ extern const int SRTP_MASTER_KEY_SALT_LEN;
 class SrtpSession;
 class SrtpStat;
 
+// One RTP packet of a batch passed to the vector versions of
+// ProtectRtp/UnprotectRtp. The packet is transformed in-place; |len| is
+// updated to the new length and |ok| tells whether this packet succeeded.
+struct SrtpPacket {
+  SrtpPacket() : data(NULL), len(0), max_len(0), ok(false) {}
+  SrtpPacket(void* data, int len, int max_len)
+      : data(data), len(len), max_len(max_len), ok(false) {}
+
+  void* data;
+  int len;
+  int max_len;  // Size of the buffer at |data|; only used when protecting.
+  bool ok;
+};
+
 void EnableSrtpDebugging();
 void ShutdownSrtp();
 
@@ -131,6 +145,10 @@ class SrtpFilter {
   // If an HMAC is used, this will decrease the packet size.
   bool UnprotectRtp(void* data, int in_len, int* out_len);
   bool UnprotectRtcp(void* data, int in_len, int* out_len);
+  // Encrypts/decrypts a batch of RTP packets with a single call into libsrtp.
+  // Returns true only if every packet succeeded; see SrtpPacket::ok.
+  bool ProtectRtp(std::vector<SrtpPacket>* packets);
+  bool UnprotectRtp(std::vector<SrtpPacket>* packets);
 
   // Returns rtp auth params from srtp context.
   bool GetRtpAuthParams(uint8_t** key, int* key_len, int* tag_len);
@@ -219,6 +237,10 @@ class SrtpSession {
   // If an HMAC is used, this will decrease the packet size.
   bool UnprotectRtp(void* data, int in_len, int* out_len);
   bool UnprotectRtcp(void* data, int in_len, int* out_len);
+  // Encrypts/decrypts a batch of RTP packets with a single call into libsrtp.
+  // Returns true only if every packet succeeded; see SrtpPacket::ok.
+  bool ProtectRtp(std::vector<SrtpPacket>* packets);
+  bool UnprotectRtp(std::vector<SrtpPacket>* packets);
 
   // Helper method to get authentication params.
   bool GetRtpAuthParams(uint8_t** key, int* key_len, int* tag_len);
@@ -700,6 +700,68 @@ TEST_F(SrtpSessionTest, TestBuffersTooSmall) {
                                sizeof(rtcp_packet_) - 14, &out_len));
 }
 
+// Test that a batch of RTP packets can be protected and unprotected in one
+// call, and that each packet reports its own result.
+TEST_F(SrtpSessionTest, TestProtectRtpBatch) {
+  static const int kNumPackets = 4;
+  char packets[kNumPackets][sizeof(kPcmuFrame) + 10];
+  std::vector<cricket::SrtpPacket> batch;
+  EXPECT_TRUE(s1_.SetSend(rtc::SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen));
+  EXPECT_TRUE(s2_.SetRecv(rtc::SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen));
+  for (int i = 0; i < kNumPackets; ++i) {
+    memcpy(packets[i], kPcmuFrame, rtp_len_);
+    rtc::SetBE16(reinterpret_cast<uint8_t*>(packets[i]) + 2, 100 + i);
+    batch.push_back(cricket::SrtpPacket(packets[i], rtp_len_,
+                                        sizeof(packets[i])));
+  }
+  // The last packet doesn't have room for the auth tag.
+  batch.back().max_len = rtp_len_;
+
+  EXPECT_FALSE(s1_.ProtectRtp(&batch));
+  for (int i = 0; i < kNumPackets - 1; ++i) {
+    EXPECT_TRUE(batch[i].ok);
+    EXPECT_EQ(rtp_len_ + rtp_auth_tag_len(CS_AES_CM_128_HMAC_SHA1_80),
+              batch[i].len);
+  }
+  EXPECT_FALSE(batch.back().ok);
+  EXPECT_EQ(rtp_len_, batch.back().len);
+  batch.pop_back();
+
+  EXPECT_TRUE(s2_.UnprotectRtp(&batch));
+  for (size_t i = 0; i < batch.size(); ++i) {
+    EXPECT_TRUE(batch[i].ok);
+    EXPECT_EQ(rtp_len_, batch[i].len);
+    EXPECT_EQ(100 + static_cast<int>(i),
+              rtc::GetBE16(reinterpret_cast<uint8_t*>(packets[i]) + 2));
+    EXPECT_EQ(0, memcmp(packets[i] + 4, kPcmuFrame + 4, rtp_len_ - 4));
+  }
+}
+
+// Test that a failing packet doesn't affect the rest of its batch.
+TEST_F(SrtpSessionTest, TestUnprotectRtpBatchRejectsSome) {
+  static const int kNumPackets = 3;
+  char packets[kNumPackets][sizeof(kPcmuFrame) + 10];
+  std::vector<cricket::SrtpPacket> batch;
+  EXPECT_TRUE(s1_.SetSend(rtc::SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen));
+  EXPECT_TRUE(s2_.SetRecv(rtc::SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen));
+  for (int i = 0; i < kNumPackets; ++i) {
+    memcpy(packets[i], kPcmuFrame, rtp_len_);
+    rtc::SetBE16(reinterpret_cast<uint8_t*>(packets[i]) + 2, 200 + i);
+    batch.push_back(cricket::SrtpPacket(packets[i], rtp_len_,
+                                        sizeof(packets[i])));
+  }
+  EXPECT_TRUE(s1_.ProtectRtp(&batch));
+
+  // Tamper with the payload of the middle packet.
+  packets[1][rtp_len_ - 1] ^= 0x01;
+  EXPECT_FALSE(s2_.UnprotectRtp(&batch));
+  EXPECT_TRUE(batch[0].ok);
+  EXPECT_FALSE(batch[1].ok);
+  EXPECT_TRUE(batch[2].ok);
+  EXPECT_EQ(rtp_len_, batch[0].len);
+  EXPECT_EQ(rtp_len_, batch[2].len);
+}
+
 TEST_F(SrtpSessionTest, TestReplay) {
   static const uint16_t kMaxSeqnum = static_cast<uint16_t>(-1);
   static const uint16_t seqnum_big = 62275;
@@ -26,4 +26,16 @@ AsyncPacketSocket::AsyncPacketSocket() {
 AsyncPacketSocket::~AsyncPacketSocket() {
 }
 
+int AsyncPacketSocket::SendToBatch(const Datagram* datagrams,
+                                   size_t count,
+                                   const PacketOptions* options) {
+  for (size_t i = 0; i < count; ++i) {
+    if (SendTo(datagrams[i].data, datagrams[i].size, datagrams[i].addr,
+               options[i]) < 0) {
+      return i == 0 ? -1 : static_cast<int>(i);
+    }
+  }
+  return static_cast<int>(count);
+}
+
 };  // namespace rtc
@@ -88,6 +88,12 @@ class AsyncPacketSocket : public sigslot::has_slots<> {
   virtual int Send(const void *pv, size_t cb, const PacketOptions& options) = 0;
   virtual int SendTo(const void *pv, size_t cb, const SocketAddress& addr,
                      const PacketOptions& options) = 0;
+  // Sends |count| datagrams, where |options| holds one entry per datagram.
+  // Returns the number of datagrams sent, or -1 if the first send failed.
+  // The default implementation calls SendTo() for each datagram.
+  virtual int SendToBatch(const Datagram* datagrams,
+                          size_t count,
+                          const PacketOptions* options);
 
   // Close the socket.
   virtual int Close() = 0;
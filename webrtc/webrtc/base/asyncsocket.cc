@@ -64,6 +64,10 @@ int AsyncSocketAdapter::SendTo(const void* pv,
   return socket_->SendTo(pv, cb, addr);
 }
 
+int AsyncSocketAdapter::SendToBatch(const Datagram* datagrams, size_t count) {
+  return socket_->SendToBatch(datagrams, count);
+}
+
 int AsyncSocketAdapter::Recv(void* pv, size_t cb) {
   return socket_->Recv(pv, cb);
 }
@@ -56,6 +56,7 @@ class AsyncSocketAdapter : public AsyncSocket, public sigslot::has_slots<> {
   int Connect(const SocketAddress& addr) override;
   int Send(const void* pv, size_t cb) override;
   int SendTo(const void* pv, size_t cb, const SocketAddress& addr) override;
+  int SendToBatch(const Datagram* datagrams, size_t count) override;
   int Recv(void* pv, size_t cb) override;
   int RecvFrom(void* pv, size_t cb, SocketAddress* paddr) override;
   int Listen(int backlog) override;
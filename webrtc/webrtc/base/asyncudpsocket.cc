@@ -75,6 +75,17 @@ int AsyncUDPSocket::SendTo(const void *pv, size_t cb,
   return ret;
 }
 
+int AsyncUDPSocket::SendToBatch(const Datagram* datagrams,
+                                size_t count,
+                                const PacketOptions* options) {
+  int64_t send_time_ms = rtc::Time();
+  int ret = socket_->SendToBatch(datagrams, count);
+  for (size_t i = 0; i < count; ++i) {
+    SignalSentPacket(this, rtc::SentPacket(options[i].packet_id, send_time_ms));
+  }
+  return ret;
+}
+
 int AsyncUDPSocket::Close() {
   return socket_->Close();
 }
@@ -42,6 +42,11 @@ class AsyncUDPSocket : public AsyncPacketSocket {
              size_t cb,
              const SocketAddress& addr,
              const rtc::PacketOptions& options) override;
+  // Sends the datagrams with Socket::SendToBatch(), which needs a single
+  // system call per batch on Linux.
+  int SendToBatch(const Datagram* datagrams,
+                  size_t count,
+                  const PacketOptions* options) override;
   int Close() override;
 
   State GetState() const override;
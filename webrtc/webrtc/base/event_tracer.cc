@@ -10,7 +10,11 @@
 #include "webrtc/base/event_tracer.h"
 
 #include <inttypes.h>
+#if defined(WEBRTC_POSIX)
+#include <pthread.h>
+#endif
 
+#include <algorithm>
 #include <vector>
 
 #include "webrtc/base/checks.h"
@@ -78,6 +82,43 @@ static bool EventTracingThreadFunc(void* params);
 
 // Atomic-int fast path for avoiding logging when disabled.
 static volatile int g_event_logging_active = 0;
+// Same, for the ring buffer tracer.
+static volatile int g_ring_buffer_active = 0;
+
+struct TraceEvent {
+  const char* name;
+  const unsigned char* category_enabled;
+  char phase;
+  uint64_t timestamp;
+  unsigned long long id;
+  int pid;
+  rtc::PlatformThreadId tid;
+};
+
+// The TraceEvent format is documented here:
+// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview
+void WriteTraceEvent(FILE* file, const TraceEvent& e, bool first) {
+  fprintf(file,
+          "%s{ \"name\": \"%s\""
+          ", \"cat\": \"%s\""
+          ", \"ph\": \"%c\""
+          ", \"ts\": %" PRIu64
+          ", \"pid\": %d"
+#if defined(WEBRTC_WIN)
+          ", \"tid\": %lu",
+#else
+          ", \"tid\": %d",
+#endif  // defined(WEBRTC_WIN)
+          first ? " " : ",", e.name, e.category_enabled, e.phase,
+          e.timestamp, e.pid, e.tid);
+  // Async events are matched up by their id.
+  if (e.phase == TRACE_EVENT_PHASE_ASYNC_BEGIN ||
+      e.phase == TRACE_EVENT_PHASE_ASYNC_STEP ||
+      e.phase == TRACE_EVENT_PHASE_ASYNC_END) {
+    fprintf(file, ", \"id\": \"0x%llx\"", e.id);
+  }
+  fprintf(file, "}\n");
+}
 
 // TODO(pbos): Log metadata for all threads, etc.
 class EventLogger final {
@@ -90,16 +131,15 @@ class EventLogger final {
   void AddTraceEvent(const char* name,
                      const unsigned char* category_enabled,
                      char phase,
+                     unsigned long long id,
                      uint64_t timestamp,
                      int pid,
                      rtc::PlatformThreadId thread_id) {
     rtc::CritScope lock(&crit_);
     trace_events_.push_back(
-        {name, category_enabled, phase, timestamp, 1, thread_id});
+        {name, category_enabled, phase, timestamp, id, 1, thread_id});
   }
 
-// The TraceEvent format is documented here:
-// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview
   void Log() {
     RTC_DCHECK(output_file_);
     static const int kLoggingIntervalMs = 100;
@@ -113,20 +153,7 @@ class EventLogger final {
         trace_events_.swap(events);
       }
       for (const TraceEvent& e : events) {
-        fprintf(output_file_,
-                "%s{ \"name\": \"%s\""
-                ", \"cat\": \"%s\""
-                ", \"ph\": \"%c\""
-                ", \"ts\": %" PRIu64
-                ", \"pid\": %d"
-#if defined(WEBRTC_WIN)
-                ", \"tid\": %lu"
-#else
-                ", \"tid\": %d"
-#endif  // defined(WEBRTC_WIN)
-                "}\n",
-                has_logged_event ? "," : " ", e.name, e.category_enabled,
-                e.phase, e.timestamp, e.pid, e.tid);
+        WriteTraceEvent(output_file_, e, !has_logged_event);
         has_logged_event = true;
       }
       if (shutting_down)
@@ -172,15 +199,6 @@ class EventLogger final {
   }
 
  private:
-  struct TraceEvent {
-    const char* name;
-    const unsigned char* category_enabled;
-    char phase;
-    uint64_t timestamp;
-    int pid;
-    rtc::PlatformThreadId tid;
-  };
-
   rtc::CriticalSection crit_;
   std::vector<TraceEvent> trace_events_ GUARDED_BY(crit_);
   rtc::PlatformThread logging_thread_;
@@ -195,7 +213,170 @@ static bool EventTracingThreadFunc(void* params) {
   return true;
 }
 
+// Keeps the most recent events of every thread in a fixed-size ring buffer
+// per thread, so that tracing can stay enabled at all times and be dumped on
+// demand. Adding an event takes no locks: each buffer has a single writer
+// (its thread), and snapshots detect and drop slots that were overwritten
+// while they were being copied.
+class RingBufferTracer final {
+ public:
+  RingBufferTracer() : capacity_(0) {
+#if defined(WEBRTC_WIN)
+    key_ = TlsAlloc();
+#else
+    pthread_key_create(&key_, &RingBufferTracer::ReleaseThreadBuffer);
+#endif
+  }
+
+  ~RingBufferTracer() {
+#if defined(WEBRTC_WIN)
+    TlsFree(key_);
+#else
+    pthread_key_delete(key_);
+#endif
+    for (ThreadBuffer* buffer : buffers_)
+      delete buffer;
+  }
+
+  void Start(size_t events_per_thread) {
+    RTC_DCHECK_GT(events_per_thread, 0u);
+    {
+      rtc::CritScope lock(&crit_);
+      // Round up to a power of two so that slot indices stay consistent when
+      // the write counter wraps.
+      capacity_ = 1;
+      while (capacity_ < events_per_thread)
+        capacity_ <<= 1;
+      // Buffers are not cleared, since their threads own them; events from
+      // before this point are left out of snapshots instead.
+      for (ThreadBuffer* buffer : buffers_)
+        buffer->session_start = rtc::AtomicOps::AcquireLoad(&buffer->next);
+    }
+    RTC_CHECK_EQ(0,
+                 rtc::AtomicOps::CompareAndSwap(&g_ring_buffer_active, 0, 1));
+  }
+
+  void Stop() {
+    rtc::AtomicOps::CompareAndSwap(&g_ring_buffer_active, 1, 0);
+  }
+
+  void AddTraceEvent(const char* name,
+                     const unsigned char* category_enabled,
+                     char phase,
+                     unsigned long long id,
+                     uint64_t timestamp) {
+    ThreadBuffer* buffer = GetThreadBuffer();
+    int next = buffer->next;
+    buffer->events[next & buffer->mask] =
+        {name, category_enabled, phase, timestamp, id, 1, buffer->tid};
+    rtc::AtomicOps::ReleaseStore(&buffer->next, (next + 1) & kCounterMask);
+  }
+
+  // Writes the events recorded since Start() as a Chrome trace JSON document.
+  void Snapshot(FILE* file) {
+    std::vector<TraceEvent> events;
+    std::vector<TraceEvent> thread_events;
+    rtc::CritScope lock(&crit_);
+    for (ThreadBuffer* buffer : buffers_) {
+      const int size = static_cast<int>(buffer->events.size());
+      const int end = rtc::AtomicOps::AcquireLoad(&buffer->next);
+      // Copy the slots from oldest (|end|) to newest (|end| - 1).
+      thread_events.clear();
+      for (int i = 0; i < size; ++i)
+        thread_events.push_back(buffer->events[(end + i) & buffer->mask]);
+      // The writer may have overwritten the oldest slots meanwhile, and may be
+      // in the middle of writing the one after; those copies are discarded.
+      const int written =
+          (rtc::AtomicOps::AcquireLoad(&buffer->next) - end) & kCounterMask;
+      const int in_session = (end - buffer->session_start) & kCounterMask;
+      for (int i = std::max(written + 1, size - in_session); i < size; ++i)
+        events.push_back(thread_events[i]);
+    }
+
+    fprintf(file, "{ \"traceEvents\": [\n");
+    for (size_t i = 0; i < events.size(); ++i)
+      WriteTraceEvent(file, events[i], i == 0);
+    fprintf(file, "]}\n");
+  }
+
+ private:
+  // The write counter is kept non-negative so that it never overflows.
+  static const int kCounterMask = 0x7fffffff;
+
+  struct ThreadBuffer {
+    ThreadBuffer(RingBufferTracer* owner, size_t capacity)
+        : owner(owner), events(capacity), mask(static_cast<int>(capacity - 1)),
+          next(0), session_start(0) {}
+
+    RingBufferTracer* const owner;
+    // The thread currently writing to the buffer; cached since looking it up
+    // is a system call on some platforms.
+    rtc::PlatformThreadId tid;
+    std::vector<TraceEvent> events;
+    const int mask;
+    // Number of events written, modulo kCounterMask + 1. Only the owning
+    // thread writes it.
+    volatile int next;
+    // Value of |next| when the current recording session started.
+    int session_start;
+  };
+
+  ThreadBuffer* GetThreadBuffer() {
+#if defined(WEBRTC_WIN)
+    ThreadBuffer* buffer = static_cast<ThreadBuffer*>(TlsGetValue(key_));
+#else
+    ThreadBuffer* buffer = static_cast<ThreadBuffer*>(pthread_getspecific(key_));
+#endif
+    if (buffer)
+      return buffer;
+
+    // First event on this thread; reuse the buffer of an exited thread if
+    // there is one of the right size.
+    {
+      rtc::CritScope lock(&crit_);
+      for (size_t i = 0; i < free_buffers_.size(); ++i) {
+        if (free_buffers_[i]->events.size() == capacity_) {
+          buffer = free_buffers_[i];
+          free_buffers_.erase(free_buffers_.begin() + i);
+          break;
+        }
+      }
+      if (!buffer) {
+        buffer = new ThreadBuffer(this, capacity_);
+        buffers_.push_back(buffer);
+      }
+    }
+    buffer->tid = rtc::CurrentThreadId();
+#if defined(WEBRTC_WIN)
+    TlsSetValue(key_, buffer);
+#else
+    pthread_setspecific(key_, buffer);
+#endif
+    return buffer;
+  }
+
+  // Called when a thread that has written events exits. Its buffer keeps its
+  // events for later snapshots until another thread takes it over. Windows
+  // TLS has no destructors, so there buffers are never reused.
+  static void ReleaseThreadBuffer(void* param) {
+    ThreadBuffer* buffer = static_cast<ThreadBuffer*>(param);
+    rtc::CritScope lock(&buffer->owner->crit_);
+    buffer->owner->free_buffers_.push_back(buffer);
+  }
+
+  rtc::CriticalSection crit_;
+  std::vector<ThreadBuffer*> buffers_ GUARDED_BY(crit_);
+  std::vector<ThreadBuffer*> free_buffers_ GUARDED_BY(crit_);
+  size_t capacity_ GUARDED_BY(crit_);
+#if defined(WEBRTC_WIN)
+  DWORD key_;
+#else
+  pthread_key_t key_;
+#endif
+};
+
 static EventLogger* volatile g_event_logger = nullptr;
+static RingBufferTracer* volatile g_ring_buffer_tracer = nullptr;
 static const char* const kDisabledTracePrefix = TRACE_DISABLED_BY_DEFAULT("");
 const unsigned char* InternalGetCategoryEnabled(const char* name) {
   const char* prefix_ptr = &kDisabledTracePrefix[0];
@@ -219,11 +400,20 @@ void InternalAddTraceEvent(char phase,
                            const unsigned long long* arg_values,
                            unsigned char flags) {
   // Fast path for when event tracing is inactive.
-  if (rtc::AtomicOps::AcquireLoad(&g_event_logging_active) == 0)
+  const bool logging = rtc::AtomicOps::AcquireLoad(&g_event_logging_active);
+  const bool ring_buffer = rtc::AtomicOps::AcquireLoad(&g_ring_buffer_active);
+  if (!logging && !ring_buffer)
     return;
 
-  g_event_logger->AddTraceEvent(name, category_enabled, phase,
-                                rtc::TimeMicros(), 1, rtc::CurrentThreadId());
+  uint64_t timestamp = rtc::TimeMicros();
+  if (logging) {
+    g_event_logger->AddTraceEvent(name, category_enabled, phase, id, timestamp,
+                                  1, rtc::CurrentThreadId());
+  }
+  if (ring_buffer) {
+    g_ring_buffer_tracer->AddTraceEvent(name, category_enabled, phase, id,
+                                        timestamp);
+  }
 }
 
 }  // namespace
@@ -233,6 +423,7 @@ void SetupInternalTracer() {
                 &g_event_logger, static_cast<EventLogger*>(nullptr),
                 new EventLogger()) == nullptr);
   g_event_logger = new EventLogger();
+  g_ring_buffer_tracer = new RingBufferTracer();
   webrtc::SetupEventTracer(InternalGetCategoryEnabled, InternalAddTraceEvent);
 }
 
@@ -255,6 +446,30 @@ void StopInternalCapture() {
   g_event_logger->Stop();
 }
 
+void StartInternalRingBuffer(size_t events_per_thread) {
+  g_ring_buffer_tracer->Start(events_per_thread);
+}
+
+void SnapshotInternalRingBufferToFile(FILE* file) {
+  g_ring_buffer_tracer->Snapshot(file);
+}
+
+bool SnapshotInternalRingBuffer(const char* filename) {
+  FILE* file = fopen(filename, "w");
+  if (!file) {
+    LOG(LS_ERROR) << "Failed to open trace file '" << filename
+                  << "' for writing.";
+    return false;
+  }
+  g_ring_buffer_tracer->Snapshot(file);
+  fclose(file);
+  return true;
+}
+
+void StopInternalRingBuffer() {
+  g_ring_buffer_tracer->Stop();
+}
+
 void ShutdownInternalTracer() {
   StopInternalCapture();
   EventLogger* old_logger = rtc::AtomicOps::AcquireLoadPtr(&g_event_logger);
@@ -263,6 +478,9 @@ void ShutdownInternalTracer() {
                 &g_event_logger, old_logger,
                 static_cast<EventLogger*>(nullptr)) == old_logger);
   delete old_logger;
+  StopInternalRingBuffer();
+  delete g_ring_buffer_tracer;
+  g_ring_buffer_tracer = nullptr;
   webrtc::SetupEventTracer(nullptr, nullptr);
 }
 
@@ -77,6 +77,15 @@ void SetupInternalTracer();
 bool StartInternalCapture(const char* filename);
 void StartInternalCaptureToFile(FILE* file);
 void StopInternalCapture();
+// Records the most recent |events_per_thread| events of each thread in
+// memory, cheaply enough to stay enabled at all times. Nothing is written out
+// until a snapshot is taken. Can run at the same time as a capture.
+void StartInternalRingBuffer(size_t events_per_thread);
+// Writes the events recorded since StartInternalRingBuffer() in the Chrome
+// trace event JSON format.
+bool SnapshotInternalRingBuffer(const char* filename);
+void SnapshotInternalRingBufferToFile(FILE* file);
+void StopInternalRingBuffer();
 // Make sure we run this, this will tear down the internal tracing.
 void ShutdownInternalTracer();
 }  // namespace tracing
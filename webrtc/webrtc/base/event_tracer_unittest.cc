@@ -10,7 +10,12 @@
 
 #include "webrtc/base/event_tracer.h"
 
+#include <stdio.h>
+
+#include <string>
+
 #include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/platform_thread.h"
 #include "webrtc/base/trace_event.h"
 #include "webrtc/system_wrappers/include/static_instance.h"
 
@@ -58,6 +63,33 @@ static void AddTraceEventHandler(char phase,
   TestStatistics::Get()->Increment();
 }
 
+static bool TraceFromOtherThread(void* /* obj */) {
+  for (int i = 0; i < 3; ++i) {
+    TRACE_EVENT_INSTANT0("test", "OtherThreadEvent");
+  }
+  return false;
+}
+
+static int CountOccurrences(const std::string& haystack,
+                            const std::string& needle) {
+  int count = 0;
+  for (size_t pos = haystack.find(needle); pos != std::string::npos;
+       pos = haystack.find(needle, pos + 1)) {
+    ++count;
+  }
+  return count;
+}
+
+static std::string ReadFile(FILE* file) {
+  std::string contents;
+  char buffer[1024];
+  rewind(file);
+  size_t read;
+  while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    contents.append(buffer, read);
+  return contents;
+}
+
 }  // namespace
 
 namespace webrtc {
@@ -79,4 +111,60 @@ TEST(EventTracerTest, ScopedTraceEvent) {
   TestStatistics::Get()->Reset();
 }
 
+// The ring buffer keeps only the most recent events of each thread, and a
+// snapshot is a complete Chrome trace document.
+TEST(EventTracerTest, RingBufferSnapshot) {
+  rtc::tracing::SetupInternalTracer();
+  TRACE_EVENT_INSTANT0("test", "BeforeStart");
+  rtc::tracing::StartInternalRingBuffer(8);
+  for (int i = 0; i < 20; ++i) {
+    TRACE_EVENT_INSTANT0("test", "OldEvent");
+  }
+  for (int i = 0; i < 4; ++i) {
+    TRACE_EVENT0("test", "RecentSpan");
+  }
+  rtc::PlatformThread thread(&TraceFromOtherThread, nullptr, "Tracer");
+  thread.Start();
+  thread.Stop();
+
+  FILE* file = tmpfile();
+  ASSERT_TRUE(file != nullptr);
+  rtc::tracing::SnapshotInternalRingBufferToFile(file);
+  std::string json = ReadFile(file);
+  fclose(file);
+  rtc::tracing::StopInternalRingBuffer();
+  rtc::tracing::ShutdownInternalTracer();
+
+  EXPECT_EQ(0u, json.find("{ \"traceEvents\": ["));
+  EXPECT_EQ(0, CountOccurrences(json, "BeforeStart"));
+  // The oldest slot of each buffer is dropped by the snapshot, so 7 of the 8
+  // newest events of this thread are left: all from the spans.
+  EXPECT_EQ(0, CountOccurrences(json, "OldEvent"));
+  EXPECT_EQ(7, CountOccurrences(json, "RecentSpan"));
+  EXPECT_EQ(3, CountOccurrences(json, "OtherThreadEvent"));
+}
+
+// Events recorded before a restart are not part of later snapshots.
+TEST(EventTracerTest, RingBufferRestart) {
+  rtc::tracing::SetupInternalTracer();
+  rtc::tracing::StartInternalRingBuffer(16);
+  TRACE_EVENT_INSTANT0("test", "FirstSession");
+  rtc::tracing::StopInternalRingBuffer();
+  TRACE_EVENT_INSTANT0("test", "WhileStopped");
+  rtc::tracing::StartInternalRingBuffer(16);
+  TRACE_EVENT_INSTANT0("test", "SecondSession");
+
+  FILE* file = tmpfile();
+  ASSERT_TRUE(file != nullptr);
+  rtc::tracing::SnapshotInternalRingBufferToFile(file);
+  std::string json = ReadFile(file);
+  fclose(file);
+  rtc::tracing::StopInternalRingBuffer();
+  rtc::tracing::ShutdownInternalTracer();
+
+  EXPECT_EQ(0, CountOccurrences(json, "FirstSession"));
+  EXPECT_EQ(0, CountOccurrences(json, "WhileStopped"));
+  EXPECT_EQ(1, CountOccurrences(json, "SecondSession"));
+}
+
 }  // namespace webrtc
@@ -118,7 +118,8 @@ void MessageQueueManager::ClearInternal(MessageHandler *handler) {
 
 MessageQueue::MessageQueue(SocketServer* ss)
     : ss_(ss), fStop_(false), fPeekKeep_(false),
-      dmsgq_next_num_(0) {
+      dmsgq_next_num_(0), lock_free_posting_(false), inbox_(NULL),
+      wakeup_pending_(0) {
   if (!ss_) {
     // Currently, MessageQueue holds a socket server, and is the base class for
     // Thread.  It seems like it makes more sense for Thread to hold the socket
@@ -203,6 +204,15 @@ bool MessageQueue::Get(Message *pmsg, int cmsWait, bool process_io) {
       // Otherwise, disposed MessageHandlers will cause deadlocks.
       {
         CritScope cs(&crit_);
+        // Move what was posted through the inbox to the back of the queue,
+        // ahead of delayed messages that trigger now, just as locked posts
+        // would be. Once the queue is empty and we may wait, the wakeup flag
+        // is cleared before draining so that a racing post wakes us again.
+        if (lock_free_posting_) {
+          if (msgq_.empty())
+            AtomicOps::CompareAndSwap(&wakeup_pending_, 1, 0);
+          DrainInbox();
+        }
         // On the first pass, check for delayed messages that have been
         // triggered and calculate the next trigger time.
         if (first_pass) {
@@ -283,11 +293,6 @@ void MessageQueue::Post(MessageHandler* phandler,
   if (fStop_)
     return;
 
-  // Keep thread safe
-  // Add the message to the end of the queue
-  // Signal for the multiplexer to return
-
-  CritScope cs(&crit_);
   Message msg;
   msg.phandler = phandler;
   msg.message_id = id;
@@ -295,10 +300,69 @@ void MessageQueue::Post(MessageHandler* phandler,
   if (time_sensitive) {
     msg.ts_sensitive = Time() + kMaxMsgLatency;
   }
+
+  if (lock_free_posting_) {
+    // Push onto the inbox and only wake the multiplexer if nobody has done
+    // so since it last drained the inbox.
+    PostedMessage* node = new PostedMessage;
+    node->msg = msg;
+    PostedMessage* head = AtomicOps::AcquireLoadPtr(&inbox_);
+    while (true) {
+      node->next = head;
+      PostedMessage* prev = AtomicOps::CompareAndSwapPtr(&inbox_, head, node);
+      if (prev == head)
+        break;
+      head = prev;
+    }
+    if (AtomicOps::CompareAndSwap(&wakeup_pending_, 0, 1) == 0)
+      ss_->WakeUp();
+    return;
+  }
+
+  // Keep thread safe
+  // Add the message to the end of the queue
+  // Signal for the multiplexer to return
+
+  CritScope cs(&crit_);
   msgq_.push_back(msg);
   ss_->WakeUp();
 }
 
+void MessageQueue::DrainInbox() {
+  PostedMessage* head = AtomicOps::AcquireLoadPtr(&inbox_);
+  while (head) {
+    PostedMessage* prev = AtomicOps::CompareAndSwapPtr(
+        &inbox_, head, static_cast<PostedMessage*>(NULL));
+    if (prev == head)
+      break;
+    head = prev;
+  }
+  // The inbox is a stack; reverse it to get the posting order back.
+  PostedMessage* fifo = NULL;
+  while (head) {
+    PostedMessage* next = head->next;
+    head->next = fifo;
+    fifo = head;
+    head = next;
+  }
+  while (fifo) {
+    PostedMessage* next = fifo->next;
+    msgq_.push_back(fifo->msg);
+    delete fifo;
+    fifo = next;
+  }
+}
+
+size_t MessageQueue::InboxSize() const {
+  size_t size = 0;
+  for (PostedMessage* node = AtomicOps::AcquireLoadPtr(
+           const_cast<PostedMessage* volatile*>(&inbox_));
+       node; node = node->next) {
+    ++size;
+  }
+  return size;
+}
+
 void MessageQueue::PostDelayed(int cmsDelay,
                                MessageHandler* phandler,
                                uint32_t id,
@@ -341,6 +405,7 @@ void MessageQueue::DoDelayPost(int cmsDelay,
 
 int MessageQueue::GetDelay() {
   CritScope cs(&crit_);
+  DrainInbox();
 
   if (!msgq_.empty())
     return 0;
@@ -359,6 +424,7 @@ void MessageQueue::Clear(MessageHandler* phandler,
                          uint32_t id,
                          MessageList* removed) {
   CritScope cs(&crit_);
+  DrainInbox();
 
   // Remove messages with phandler
 
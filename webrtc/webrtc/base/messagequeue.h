@@ -18,6 +18,7 @@
 #include <queue>
 #include <vector>
 
+#include "webrtc/base/atomicops.h"
 #include "webrtc/base/basictypes.h"
 #include "webrtc/base/constructormagic.h"
 #include "webrtc/base/criticalsection.h"
@@ -183,6 +184,15 @@ class MessageQueue {
   virtual bool IsQuitting();
   virtual void Restart();
 
+  // When enabled, Post() pushes onto a lock-free inbox instead of taking the
+  // queue lock, and only the first Post() since the queue last ran dry wakes
+  // up the socket server. The receiving thread moves the whole inbox to the
+  // back of the queue at once, so messages are dispatched in the same order
+  // as with locked posting. Delayed posts and Clear() are unaffected. Must be
+  // set before any thread other than the owner posts to the queue.
+  void SetLockFreePosting(bool enabled) { lock_free_posting_ = enabled; }
+  bool lock_free_posting() const { return lock_free_posting_; }
+
   // Get() will process I/O until:
   //  1) A message is available (returns true)
   //  2) cmsWait seconds have elapsed (returns false)
@@ -214,7 +224,8 @@ class MessageQueue {
   bool empty() const { return size() == 0u; }
   size_t size() const {
     CritScope cs(&crit_);  // msgq_.size() is not thread safe.
-    return msgq_.size() + dmsgq_.size() + (fPeekKeep_ ? 1u : 0u);
+    return msgq_.size() + dmsgq_.size() + (fPeekKeep_ ? 1u : 0u) +
+           InboxSize();
   }
 
   // Internally posts a message which causes the doomed object to be deleted
@@ -235,6 +246,19 @@ class MessageQueue {
     void reheap() { make_heap(c.begin(), c.end(), comp); }
   };
 
+  // A message posted through the lock-free inbox.
+  struct PostedMessage {
+    Message msg;
+    PostedMessage* next;
+  };
+
+  // Moves the messages in |inbox_| to the back of |msgq_| in the order they
+  // were posted. Must be called with |crit_| held.
+  void DrainInbox();
+  // Number of messages in |inbox_|. Must be called with |crit_| held, which
+  // keeps the inbox nodes alive while they are counted.
+  size_t InboxSize() const;
+
   void DoDelayPost(int cmsDelay,
                    uint32_t tstamp,
                    MessageHandler* phandler,
@@ -252,6 +276,13 @@ class MessageQueue {
   PriorityQueue dmsgq_;
   uint32_t dmsgq_next_num_;
   mutable CriticalSection crit_;
+  bool lock_free_posting_;
+  // Messages posted with lock-free posting enabled, newest first. Pushed to
+  // without |crit_|, emptied only with |crit_| held.
+  PostedMessage* volatile inbox_;
+  // Set by the first post that finds the flag clear; cleared by the
+  // receiving thread before it drains the inbox into an empty queue.
+  volatile int wakeup_pending_;
 
  private:
   RTC_DISALLOW_COPY_AND_ASSIGN(MessageQueue);
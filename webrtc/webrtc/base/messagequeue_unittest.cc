@@ -11,8 +11,10 @@
 #include "webrtc/base/messagequeue.h"
 
 #include "webrtc/base/bind.h"
+#include "webrtc/base/event.h"
 #include "webrtc/base/gunit.h"
 #include "webrtc/base/logging.h"
+#include "webrtc/base/scopedptrcollection.h"
 #include "webrtc/base/thread.h"
 #include "webrtc/base/timeutils.h"
 #include "webrtc/base/nullsocketserver.h"
@@ -138,3 +140,156 @@ TEST(MessageQueueManager, Clear) {
   EXPECT_TRUE(deleted);
   EXPECT_FALSE(MessageQueueManager::IsInitialized());
 }
+
+namespace {
+
+// Posts |count| messages to |target| when it receives a message.
+class Poster : public MessageHandler {
+ public:
+  Poster(MessageQueue* target, MessageHandler* handler, uint32_t id, int count)
+      : target_(target), handler_(handler), id_(id), count_(count) {}
+
+  void OnMessage(Message* msg) override {
+    for (int i = 0; i < count_; ++i)
+      target_->Post(handler_, id_, new TypedMessageData<int>(i));
+  }
+
+ private:
+  MessageQueue* target_;
+  MessageHandler* handler_;
+  uint32_t id_;
+  int count_;
+};
+
+// Checks that the messages of each poster arrive in order and signals |done|
+// once |expected| messages have arrived.
+class OrderCheckingHandler : public MessageHandler {
+ public:
+  OrderCheckingHandler(int num_posters, int expected, Event* done)
+      : next_(num_posters, 0), received_(0), expected_(expected), done_(done) {}
+
+  void OnMessage(Message* msg) override {
+    TypedMessageData<int>* data =
+        static_cast<TypedMessageData<int>*>(msg->pdata);
+    EXPECT_EQ(next_[msg->message_id], data->data());
+    next_[msg->message_id] = data->data() + 1;
+    delete data;
+    if (++received_ == expected_)
+      done_->Set();
+  }
+
+ private:
+  std::vector<int> next_;
+  int received_;
+  int expected_;
+  Event* done_;
+};
+
+// Counts the wakeups of the thread it serves.
+class WakeUpCountingSocketServer : public NullSocketServer {
+ public:
+  WakeUpCountingSocketServer() : wakeups_(0) {}
+
+  void WakeUp() override {
+    AtomicOps::Increment(&wakeups_);
+    NullSocketServer::WakeUp();
+  }
+
+  int wakeups() { return AtomicOps::AcquireLoad(&wakeups_); }
+
+ private:
+  volatile int wakeups_;
+};
+
+// Has |num_posters| threads each post |count| messages to another thread and
+// waits for that thread to dispatch them all. Returns the time in ms that
+// takes and sets |wakeups| to the number of times the receiver was woken.
+int PostFromThreads(bool lock_free_posting,
+                    int num_posters,
+                    int count,
+                    int* wakeups) {
+  Event done(false, false);
+  OrderCheckingHandler handler(num_posters, num_posters * count, &done);
+  WakeUpCountingSocketServer ss;
+  Thread receiver(&ss);
+  receiver.SetLockFreePosting(lock_free_posting);
+  receiver.Start();
+
+  ScopedPtrCollection<Thread> threads;
+  ScopedPtrCollection<Poster> posters;
+  for (int i = 0; i < num_posters; ++i) {
+    threads.PushBack(new Thread());
+    posters.PushBack(new Poster(&receiver, &handler, i, count));
+    threads.collection()[i]->Start();
+  }
+  uint32_t start = Time();
+  for (int i = 0; i < num_posters; ++i)
+    threads.collection()[i]->Post(posters.collection()[i]);
+  EXPECT_TRUE(done.Wait(Event::kForever));
+  int elapsed = TimeDiff(Time(), start);
+  *wakeups = ss.wakeups();
+  return elapsed;
+}
+
+}  // namespace
+
+TEST(MessageQueueLockFreePosting, PreservesOrderPerPoster) {
+  int wakeups;
+  PostFromThreads(true, 4, 10000, &wakeups);
+}
+
+// Posts are dispatched ahead of delayed messages that trigger after them, as
+// they are with locked posting.
+TEST(MessageQueueLockFreePosting, PostsStayAheadOfTriggeredDelayedMessages) {
+  for (int lock_free = 0; lock_free < 2; ++lock_free) {
+    MessageQueue q;
+    q.SetLockFreePosting(lock_free != 0);
+    q.Post(NULL, 0);
+    q.PostAt(Time() - 1, NULL, 2);
+    q.Post(NULL, 1);
+    Message msg;
+    for (uint32_t i = 0; i < 3; ++i) {
+      EXPECT_TRUE(q.Get(&msg, 0));
+      EXPECT_EQ(i, msg.message_id) << "lock_free_posting: " << lock_free;
+    }
+    EXPECT_FALSE(q.Get(&msg, 0));
+  }
+}
+
+TEST(MessageQueueLockFreePosting, ClearRemovesInboxMessages) {
+  MessageQueue q;
+  q.SetLockFreePosting(true);
+  q.Post(NULL, 1, new TypedMessageData<int>(0));
+  q.Post(NULL, 2);
+  EXPECT_EQ(2u, q.size());
+  MessageList removed;
+  q.Clear(NULL, 1, &removed);
+  ASSERT_EQ(1u, removed.size());
+  delete removed.front().pdata;
+  EXPECT_EQ(1u, q.size());
+  Message msg;
+  EXPECT_TRUE(q.Get(&msg, 0));
+  EXPECT_EQ(2u, msg.message_id);
+}
+
+TEST(MessageQueueLockFreePosting, Perf) {
+  const int kNumPosters = 4;
+  const int kMessagesPerPoster = 50000;
+  const int kPosts = kNumPosters * kMessagesPerPoster;
+  int locked_wakeups;
+  int lock_free_wakeups;
+  int locked_ms = PostFromThreads(false, kNumPosters, kMessagesPerPoster,
+                                  &locked_wakeups);
+  int lock_free_ms = PostFromThreads(true, kNumPosters, kMessagesPerPoster,
+                                     &lock_free_wakeups);
+  LOG(LS_INFO) << kPosts << " posts from " << kNumPosters << " threads: "
+               << locked_ms << " ms and " << locked_wakeups
+               << " wakeups locked, " << lock_free_ms << " ms and "
+               << lock_free_wakeups << " wakeups lock-free";
+  // Every locked post wakes the receiver. A lock-free post only does if no
+  // wakeup is pending, so there are never more; timings are too noisy to
+  // compare here.
+  EXPECT_GE(locked_wakeups, kPosts);
+  EXPECT_LE(lock_free_wakeups, locked_wakeups);
+  EXPECT_GT(lock_free_wakeups, 0);
+}
@@ -28,6 +28,10 @@
 #include <signal.h>
 #endif
 
+#if defined(WEBRTC_LINUX)
+#include <sys/epoll.h>
+#endif
+
 #if defined(WEBRTC_WIN)
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -96,6 +100,11 @@ static const int ICMP_HEADER_SIZE = 8u;
 static const int ICMP_PING_TIMEOUT_MILLIS = 10000u;
 #endif
 
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+// Maximum number of datagrams passed to a single sendmmsg() call.
+static const size_t kMaxSendBatchSize = 32u;
+#endif
+
 PhysicalSocket::PhysicalSocket(PhysicalSocketServer* ss, SOCKET s)
   : ss_(ss), s_(s), enabled_events_(0), error_(0),
     state_((s == INVALID_SOCKET) ? CS_CLOSED : CS_CONNECTED),
@@ -280,6 +289,7 @@ int PhysicalSocket::Send(const void* pv, size_t cb) {
   ASSERT(sent <= static_cast<int>(cb));
   if ((sent < 0) && IsBlockingError(GetError())) {
     enabled_events_ |= DE_WRITE;
+    OnWouldBlock(DE_WRITE);
   }
   return sent;
 }
@@ -304,10 +314,54 @@ int PhysicalSocket::SendTo(const void* buffer,
   ASSERT(sent <= static_cast<int>(length));
   if ((sent < 0) && IsBlockingError(GetError())) {
     enabled_events_ |= DE_WRITE;
+    OnWouldBlock(DE_WRITE);
   }
   return sent;
 }
 
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+int PhysicalSocket::SendToBatch(const Datagram* datagrams, size_t count) {
+  int total_sent = 0;
+  while (count > 0) {
+    const size_t batch_size = std::min(count, kMaxSendBatchSize);
+    sockaddr_storage saddrs[kMaxSendBatchSize];
+    iovec iovs[kMaxSendBatchSize];
+    mmsghdr msgs[kMaxSendBatchSize];
+    memset(msgs, 0, sizeof(msgs[0]) * batch_size);
+    for (size_t i = 0; i < batch_size; ++i) {
+      size_t len = datagrams[i].addr.ToSockAddrStorage(&saddrs[i]);
+      iovs[i].iov_base = const_cast<void*>(datagrams[i].data);
+      iovs[i].iov_len = datagrams[i].size;
+      msgs[i].msg_hdr.msg_name = &saddrs[i];
+      msgs[i].msg_hdr.msg_namelen = static_cast<socklen_t>(len);
+      msgs[i].msg_hdr.msg_iov = &iovs[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    // Suppress SIGPIPE. See Send() for explanation.
+    int sent = ::sendmmsg(s_, msgs, static_cast<unsigned int>(batch_size),
+                          MSG_NOSIGNAL);
+    UpdateLastError();
+    MaybeRemapSendError();
+    if (sent < 0) {
+      if (IsBlockingError(GetError())) {
+        enabled_events_ |= DE_WRITE;
+        OnWouldBlock(DE_WRITE);
+      }
+      return total_sent > 0 ? total_sent : -1;
+    }
+    total_sent += sent;
+    if (static_cast<size_t>(sent) < batch_size) {
+      // The kernel stops at the first datagram that fails; the next call
+      // would report its error.
+      break;
+    }
+    datagrams += batch_size;
+    count -= batch_size;
+  }
+  return total_sent;
+}
+#endif
+
 int PhysicalSocket::Recv(void* buffer, size_t length) {
   int received = ::recv(s_, static_cast<char*>(buffer),
                         static_cast<int>(length), 0);
@@ -328,6 +382,9 @@ int PhysicalSocket::Recv(void* buffer, size_t length) {
   if (udp_ || success) {
     enabled_events_ |= DE_READ;
   }
+  if (received < 0 && IsBlockingError(error)) {
+    OnWouldBlock(DE_READ);
+  }
   if (!success) {
     LOG_F(LS_VERBOSE) << "Error = " << error;
   }
@@ -350,6 +407,9 @@ int PhysicalSocket::RecvFrom(void* buffer,
   if (udp_ || success) {
     enabled_events_ |= DE_READ;
   }
+  if (received < 0 && IsBlockingError(error)) {
+    OnWouldBlock(DE_READ);
+  }
   if (!success) {
     LOG_F(LS_VERBOSE) << "Error = " << error;
   }
@@ -379,8 +439,11 @@ AsyncSocket* PhysicalSocket::Accept(SocketAddress* out_addr) {
   sockaddr* addr = reinterpret_cast<sockaddr*>(&addr_storage);
   SOCKET s = DoAccept(s_, addr, &addr_len);
   UpdateLastError();
-  if (s == INVALID_SOCKET)
+  if (s == INVALID_SOCKET) {
+    if (IsBlockingError(GetError()))
+      OnWouldBlock(DE_ACCEPT);
     return nullptr;
+  }
   if (out_addr != nullptr)
     SocketAddressFromSockAddrStorage(addr_storage, out_addr);
   return ss_->WrapSocket(s);
@@ -748,6 +811,12 @@ void SocketDispatcher::OnEvent(uint32_t ff, int err) {
 
 #endif // WEBRTC_POSIX
 
+#if defined(WEBRTC_USE_EPOLL)
+void SocketDispatcher::OnWouldBlock(uint32_t ff) {
+  ss_->OnDispatcherWouldBlock(this, ff);
+}
+#endif
+
 int SocketDispatcher::Close() {
   if (s_ == INVALID_SOCKET)
     return 0;
@@ -1128,8 +1197,30 @@ class Signaler : public EventDispatcher {
   bool *pf_;
 };
 
+#if defined(WEBRTC_USE_EPOLL)
+// Maximum number of events taken from the kernel per epoll_wait() call.
+static const int kMaxEpollEvents = 128;
+
+struct PhysicalSocketServer::EpollEntry {
+  // NULL once the dispatcher has been removed.
+  Dispatcher* dispatcher;
+  // EPOLL* bits reported since the descriptor last blocked.
+  uint32_t ready;
+  // Whether the entry is in |ready_entries_|.
+  bool queued;
+  // False for descriptors epoll can't watch, e.g. regular files, which are
+  // always ready as far as select() is concerned.
+  bool pollable;
+};
+
+#endif  // WEBRTC_USE_EPOLL
+
 PhysicalSocketServer::PhysicalSocketServer()
-    : fWait_(false) {
+    :
+#if defined(WEBRTC_USE_EPOLL)
+      epoll_fd_(INVALID_SOCKET),
+#endif
+      fWait_(false) {
   signal_wakeup_ = new Signaler(this, &fWait_);
 #if defined(WEBRTC_WIN)
   socket_ev_ = WSACreateEvent();
@@ -1145,6 +1236,12 @@ PhysicalSocketServer::~PhysicalSocketServer() {
 #endif
   delete signal_wakeup_;
   ASSERT(dispatchers_.empty());
+#if defined(WEBRTC_USE_EPOLL)
+  if (epoll_fd_ != INVALID_SOCKET)
+    close(epoll_fd_);
+  for (EpollEntry* entry : dead_entries_)
+    delete entry;
+#endif
 }
 
 void PhysicalSocketServer::WakeUp() {
@@ -1198,6 +1295,10 @@ void PhysicalSocketServer::Add(Dispatcher *pdispatcher) {
   if (pos != dispatchers_.end())
     return;
   dispatchers_.push_back(pdispatcher);
+#if defined(WEBRTC_USE_EPOLL)
+  if (epoll_fd_ != INVALID_SOCKET)
+    AddEpoll(pdispatcher);
+#endif
 }
 
 void PhysicalSocketServer::Remove(Dispatcher *pdispatcher) {
@@ -1215,6 +1316,10 @@ void PhysicalSocketServer::Remove(Dispatcher *pdispatcher) {
   }
   size_t index = pos - dispatchers_.begin();
   dispatchers_.erase(pos);
+#if defined(WEBRTC_USE_EPOLL)
+  if (epoll_fd_ != INVALID_SOCKET)
+    RemoveEpoll(pdispatcher);
+#endif
   for (IteratorList::iterator it = iterators_.begin(); it != iterators_.end();
        ++it) {
     if (index < **it) {
@@ -1223,8 +1328,232 @@ void PhysicalSocketServer::Remove(Dispatcher *pdispatcher) {
   }
 }
 
+#if defined(WEBRTC_USE_EPOLL)
+
+bool PhysicalSocketServer::EnableEpoll() {
+  CritScope cs(&crit_);
+  if (epoll_fd_ != INVALID_SOCKET)
+    return true;
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd_ == INVALID_SOCKET) {
+    LOG_E(LS_WARNING, EN, errno) << "epoll_create1; falling back to select";
+    return false;
+  }
+  for (size_t i = 0; i < dispatchers_.size(); ++i)
+    AddEpoll(dispatchers_[i]);
+  return true;
+}
+
+void PhysicalSocketServer::OnDispatcherWouldBlock(Dispatcher* dispatcher,
+                                                  uint32_t ff) {
+  CritScope cs(&crit_);
+  EpollEntryMap::iterator it = epoll_entries_.find(dispatcher);
+  if (it == epoll_entries_.end() || !it->second->pollable)
+    return;
+  if (ff & (DE_READ | DE_ACCEPT))
+    it->second->ready &= ~EPOLLIN;
+  if (ff & (DE_WRITE | DE_CONNECT))
+    it->second->ready &= ~EPOLLOUT;
+}
+
+void PhysicalSocketServer::AddEpoll(Dispatcher* dispatcher) {
+  EpollEntry* entry = new EpollEntry();
+  entry->dispatcher = dispatcher;
+  entry->ready = 0;
+  entry->queued = false;
+  entry->pollable = true;
+  epoll_entries_[dispatcher] = entry;
+
+  // Everything is watched all the time so that the registration never has
+  // to change; what is delivered is filtered by GetRequestedEvents().
+  struct epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+  event.data.ptr = entry;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, dispatcher->GetDescriptor(),
+                &event) != 0) {
+    if (errno == EPERM) {
+      entry->pollable = false;
+      entry->ready = EPOLLIN | EPOLLOUT;
+      QueueEpollEntry(entry);
+    } else {
+      LOG_E(LS_ERROR, EN, errno) << "epoll_ctl add";
+    }
+  }
+}
+
+void PhysicalSocketServer::RemoveEpoll(Dispatcher* dispatcher) {
+  EpollEntryMap::iterator it = epoll_entries_.find(dispatcher);
+  if (it == epoll_entries_.end())
+    return;
+  EpollEntry* entry = it->second;
+  epoll_entries_.erase(it);
+  if (entry->pollable) {
+    // Kernels before 2.6.9 require a non-NULL event even for a delete.
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, dispatcher->GetDescriptor(), &event);
+  }
+  // A Wait() in progress may still hold events pointing at the entry.
+  entry->dispatcher = NULL;
+  dead_entries_.push_back(entry);
+}
+
+void PhysicalSocketServer::QueueEpollEntry(EpollEntry* entry) {
+  if (!entry->queued) {
+    entry->queued = true;
+    ready_entries_.push_back(entry);
+  }
+}
+
+// Returns the DE_* events that would be delivered for |entry| now.
+uint32_t PhysicalSocketServer::PendingEpollEvents(EpollEntry* entry,
+                                                  bool process_io) {
+  Dispatcher* pdispatcher = entry->dispatcher;
+  if (!pdispatcher || (!process_io && pdispatcher != signal_wakeup_))
+    return 0;
+  uint32_t requested = pdispatcher->GetRequestedEvents();
+  uint32_t ff = 0;
+  if (entry->ready & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+    ff |= requested & (DE_READ | DE_ACCEPT);
+  if (entry->ready & (EPOLLOUT | EPOLLHUP | EPOLLERR))
+    ff |= requested & (DE_WRITE | DE_CONNECT);
+  return ff;
+}
+
+// Translates the cached readiness of |entry| into an event, as the select()
+// loop does with its fd_sets, and delivers it. Returns false if there was
+// nothing to deliver.
+bool PhysicalSocketServer::DeliverEpollEvents(EpollEntry* entry) {
+  uint32_t requested = PendingEpollEvents(entry, true);
+  if (!requested)
+    return false;
+  Dispatcher* pdispatcher = entry->dispatcher;
+  int fd = pdispatcher->GetDescriptor();
+
+  // Reap any error code. Unlike select(), epoll tells us whether there is
+  // one, so the common case needs no system call.
+  int errcode = 0;
+  if (entry->ready & EPOLLERR) {
+    socklen_t len = sizeof(errcode);
+    ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &errcode, &len);
+    entry->ready &= ~EPOLLERR;
+  }
+
+  uint32_t ff = 0;
+  if (requested & (DE_READ | DE_ACCEPT)) {
+    if (requested & DE_ACCEPT) {
+      ff |= DE_ACCEPT;
+    } else if (errcode || ((entry->ready & (EPOLLRDHUP | EPOLLHUP)) &&
+                           pdispatcher->IsDescriptorClosed())) {
+      ff |= DE_CLOSE;
+    } else {
+      ff |= DE_READ;
+    }
+  }
+  if (requested & (DE_WRITE | DE_CONNECT)) {
+    if (requested & DE_CONNECT) {
+      ff |= errcode ? DE_CLOSE : DE_CONNECT;
+    } else {
+      ff |= DE_WRITE;
+    }
+  }
+
+  // Dispatchers that report blocking keep their readiness until they block.
+  // The others consume the edge now. Either way, the entry must not be
+  // touched after OnEvent(), which may remove the dispatcher.
+  if (ff & DE_CLOSE) {
+    entry->ready = 0;
+  } else if (entry->pollable && !pdispatcher->ReportsWouldBlock()) {
+    if (ff & (DE_READ | DE_ACCEPT))
+      entry->ready &= ~EPOLLIN;
+    if (ff & (DE_WRITE | DE_CONNECT))
+      entry->ready &= ~EPOLLOUT;
+  }
+  pdispatcher->OnPreEvent(ff);
+  pdispatcher->OnEvent(ff, errcode);
+  return true;
+}
+
+bool PhysicalSocketServer::WaitEpoll(int cmsWait, bool process_io) {
+  uint32_t msStop = TimeAfter(cmsWait == kForever ? 0 : cmsWait);
+  struct epoll_event events[kMaxEpollEvents];
+
+  fWait_ = true;
+  while (fWait_) {
+    // Don't block if some cached readiness can be delivered right away.
+    int timeout = (cmsWait == kForever) ? -1 : std::max(0, TimeUntil(msStop));
+    {
+      CritScope cr(&crit_);
+      for (size_t i = 0; i < ready_entries_.size(); ++i) {
+        if (PendingEpollEvents(ready_entries_[i], process_io)) {
+          timeout = 0;
+          break;
+        }
+      }
+    }
+
+    int n = epoll_wait(epoll_fd_, events, kMaxEpollEvents, timeout);
+    if (n < 0) {
+      if (errno != EINTR) {
+        LOG_E(LS_ERROR, EN, errno) << "epoll_wait";
+        return false;
+      }
+      // See the comment in the select() loop about EINTR.
+      continue;
+    }
+
+    bool delivered = false;
+    {
+      CritScope cr(&crit_);
+      for (int i = 0; i < n; ++i) {
+        EpollEntry* entry = static_cast<EpollEntry*>(events[i].data.ptr);
+        if (!entry->dispatcher)
+          continue;
+        entry->ready |= events[i].events;
+        QueueEpollEntry(entry);
+      }
+
+      // Dispatchers may add entries (e.g. on accept) while we iterate.
+      for (size_t i = 0; i < ready_entries_.size(); ++i) {
+        EpollEntry* entry = ready_entries_[i];
+        if (process_io || entry->dispatcher == signal_wakeup_)
+          delivered |= DeliverEpollEvents(entry);
+      }
+
+      size_t kept = 0;
+      for (size_t i = 0; i < ready_entries_.size(); ++i) {
+        EpollEntry* entry = ready_entries_[i];
+        if (entry->dispatcher && entry->ready) {
+          ready_entries_[kept++] = entry;
+        } else {
+          entry->queued = false;
+        }
+      }
+      ready_entries_.resize(kept);
+      for (EpollEntry* entry : dead_entries_)
+        delete entry;
+      dead_entries_.clear();
+    }
+
+    if (n == 0 && !delivered && cmsWait != kForever &&
+        TimeUntil(msStop) <= 0) {
+      return true;
+    }
+  }
+
+  return true;
+}
+
+#endif  // WEBRTC_USE_EPOLL
+
 #if defined(WEBRTC_POSIX)
 bool PhysicalSocketServer::Wait(int cmsWait, bool process_io) {
+#if defined(WEBRTC_USE_EPOLL)
+  if (epoll_fd_ != INVALID_SOCKET)
+    return WaitEpoll(cmsWait, process_io);
+#endif
+
   // Calculate timing information
 
   struct timeval *ptvWait = NULL;
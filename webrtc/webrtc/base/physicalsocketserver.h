@@ -11,6 +11,7 @@
 #ifndef WEBRTC_BASE_PHYSICALSOCKETSERVER_H__
 #define WEBRTC_BASE_PHYSICALSOCKETSERVER_H__
 
+#include <map>
 #include <vector>
 
 #include "webrtc/base/asyncfile.h"
@@ -23,6 +24,11 @@
 typedef int SOCKET;
 #endif // WEBRTC_POSIX
 
+#if defined(WEBRTC_LINUX)
+// PhysicalSocketServer can use epoll instead of select(); see EnableEpoll().
+#define WEBRTC_USE_EPOLL 1
+#endif
+
 namespace rtc {
 
 // Event constants for the Dispatcher class.
@@ -53,6 +59,13 @@ class Dispatcher {
   virtual int GetDescriptor() = 0;
   virtual bool IsDescriptorClosed() = 0;
 #endif
+#if defined(WEBRTC_USE_EPOLL)
+  // Whether the dispatcher calls PhysicalSocketServer::OnDispatcherWouldBlock
+  // when an operation on its descriptor would block. With epoll, such
+  // dispatchers keep getting an event until they do so. The others get one
+  // event per edge and must drain their descriptor in OnPreEvent/OnEvent.
+  virtual bool ReportsWouldBlock() { return false; }
+#endif
 };
 
 // A socket server that provides the real sockets of the underlying OS.
@@ -78,6 +91,18 @@ class PhysicalSocketServer : public SocketServer {
   void Add(Dispatcher* dispatcher);
   void Remove(Dispatcher* dispatcher);
 
+#if defined(WEBRTC_USE_EPOLL)
+  // Makes Wait() use edge-triggered epoll instead of select(). This lifts the
+  // FD_SETSIZE limit and makes a wakeup cost O(ready descriptors) instead of
+  // O(all descriptors). Returns false, and keeps using select(), if epoll is
+  // not available. Must be called on the thread that calls Wait().
+  bool EnableEpoll();
+
+  // Drops the readiness cached for |ff| since the last edge, because an
+  // operation on the dispatcher's descriptor has just blocked.
+  void OnDispatcherWouldBlock(Dispatcher* dispatcher, uint32_t ff);
+#endif
+
 #if defined(WEBRTC_POSIX)
   AsyncFile* CreateFile(int fd);
 
@@ -105,6 +130,24 @@ class PhysicalSocketServer : public SocketServer {
   static bool InstallSignal(int signum, void (*handler)(int));
 
   scoped_ptr<PosixSignalDispatcher> signal_dispatcher_;
+#endif
+#if defined(WEBRTC_USE_EPOLL)
+  struct EpollEntry;
+  typedef std::map<Dispatcher*, EpollEntry*> EpollEntryMap;
+
+  void AddEpoll(Dispatcher* dispatcher);
+  void RemoveEpoll(Dispatcher* dispatcher);
+  void QueueEpollEntry(EpollEntry* entry);
+  uint32_t PendingEpollEvents(EpollEntry* entry, bool process_io);
+  bool DeliverEpollEvents(EpollEntry* entry);
+  bool WaitEpoll(int cms, bool process_io);
+
+  int epoll_fd_;
+  EpollEntryMap epoll_entries_;
+  // Entries with cached readiness, in no particular order.
+  std::vector<EpollEntry*> ready_entries_;
+  // Entries of removed dispatchers, freed once no event can refer to them.
+  std::vector<EpollEntry*> dead_entries_;
 #endif
   DispatcherList dispatchers_;
   IteratorList iterators_;
@@ -142,6 +185,11 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
   int SendTo(const void* buffer,
              size_t length,
              const SocketAddress& addr) override;
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+  // Sends the datagrams with sendmmsg(), one system call per batch of up to
+  // 32 datagrams.
+  int SendToBatch(const Datagram* datagrams, size_t count) override;
+#endif
 
   int Recv(void* buffer, size_t length) override;
   int RecvFrom(void* buffer, size_t length, SocketAddress* out_addr) override;
@@ -166,6 +214,10 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
   void UpdateLastError();
   void MaybeRemapSendError();
 
+  // Called when an operation fails with a blocking error. |ff| is the event
+  // that signals when the operation can be retried.
+  virtual void OnWouldBlock(uint32_t ff) {}
+
   static int TranslateOption(Option opt, int* slevel, int* sopt);
 
   PhysicalSocketServer* ss_;
@@ -205,9 +257,17 @@ class SocketDispatcher : public Dispatcher, public PhysicalSocket {
   uint32_t GetRequestedEvents() override;
   void OnPreEvent(uint32_t ff) override;
   void OnEvent(uint32_t ff, int err) override;
+#if defined(WEBRTC_USE_EPOLL)
+  bool ReportsWouldBlock() override { return true; }
+#endif
 
   int Close() override;
 
+#if defined(WEBRTC_USE_EPOLL)
+ protected:
+  void OnWouldBlock(uint32_t ff) override;
+#endif
+
 #if defined(WEBRTC_WIN)
  private:
   static int next_id_;
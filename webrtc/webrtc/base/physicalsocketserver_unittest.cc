@@ -398,6 +398,101 @@ TEST_F(PhysicalSocketTest, TestGetSetOptionsIPv6) {
   SocketTest::TestGetSetOptionsIPv6();
 }
 
+// Sends more datagrams than fit in a single sendmmsg() call.
+TEST_F(PhysicalSocketTest, TestSendToBatchIPv4) {
+  const size_t kNumDatagrams = 40;
+  scoped_ptr<AsyncSocket> receiver(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  scoped_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(kIPv4Loopback, 0)));
+
+  uint8_t payloads[kNumDatagrams];
+  Datagram datagrams[kNumDatagrams];
+  for (size_t i = 0; i < kNumDatagrams; ++i) {
+    payloads[i] = static_cast<uint8_t>(i);
+    datagrams[i] = Datagram(&payloads[i], sizeof(payloads[i]),
+                            receiver->GetLocalAddress());
+  }
+  EXPECT_EQ(static_cast<int>(kNumDatagrams),
+            sender->SendToBatch(datagrams, kNumDatagrams));
+
+  for (size_t i = 0; i < kNumDatagrams; ++i) {
+    uint8_t received = 0;
+    SocketAddress from;
+    EXPECT_EQ_WAIT(1, receiver->RecvFrom(&received, 1, &from), kTimeout);
+    EXPECT_EQ(payloads[i], received);
+    EXPECT_EQ(sender->GetLocalAddress(), from);
+  }
+}
+
+#if defined(WEBRTC_USE_EPOLL)
+
+// Runs the basic socket tests with Wait() using epoll instead of select().
+class PhysicalSocketEpollTest : public PhysicalSocketTest {
+ protected:
+  PhysicalSocketEpollTest() { EXPECT_TRUE(server_->EnableEpoll()); }
+};
+
+TEST_F(PhysicalSocketEpollTest, TestConnectIPv4) {
+  SocketTest::TestConnectIPv4();
+}
+
+TEST_F(PhysicalSocketEpollTest, TestConnectFailIPv4) {
+  SocketTest::TestConnectFailIPv4();
+}
+
+TEST_F(PhysicalSocketEpollTest, TestConnectAcceptErrorIPv4) {
+  ConnectInternalAcceptError(kIPv4Loopback);
+}
+
+TEST_F(PhysicalSocketEpollTest, TestServerCloseIPv4) {
+  SocketTest::TestServerCloseIPv4();
+}
+
+TEST_F(PhysicalSocketEpollTest, TestCloseInClosedCallbackIPv4) {
+  SocketTest::TestCloseInClosedCallbackIPv4();
+}
+
+TEST_F(PhysicalSocketEpollTest, TestSocketServerWaitIPv4) {
+  SocketTest::TestSocketServerWaitIPv4();
+}
+
+TEST_F(PhysicalSocketEpollTest, TestTcpIPv4) {
+  SocketTest::TestTcpIPv4();
+}
+
+TEST_F(PhysicalSocketEpollTest, TestUdpIPv4) {
+  SocketTest::TestUdpIPv4();
+}
+
+// Datagrams queued before the first read arrive with a single edge; all of
+// them must still be delivered, one read event at a time.
+TEST_F(PhysicalSocketEpollTest, TestQueuedDatagramsIPv4) {
+  const int kNumDatagrams = 20;
+  scoped_ptr<AsyncSocket> receiver(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  scoped_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  for (int i = 0; i < kNumDatagrams; ++i) {
+    uint8_t payload = static_cast<uint8_t>(i);
+    ASSERT_EQ(1, sender->SendTo(&payload, 1, receiver->GetLocalAddress()));
+  }
+
+  testing::StreamSink sink;
+  sink.Monitor(receiver.get());
+  for (int i = 0; i < kNumDatagrams; ++i) {
+    EXPECT_TRUE_WAIT(sink.Check(receiver.get(), testing::SSE_READ), kTimeout);
+    uint8_t received = 0;
+    EXPECT_EQ(1, receiver->RecvFrom(&received, 1, nullptr));
+    EXPECT_EQ(i, received);
+  }
+}
+
+#endif  // WEBRTC_USE_EPOLL
+
 #if defined(WEBRTC_POSIX)
 
 class PosixSignalDeliveryTest : public testing::Test {
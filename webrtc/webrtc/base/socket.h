@@ -133,6 +133,17 @@ struct SentPacket {
   int64_t send_time_ms;
 };
 
+// A datagram sent with Socket::SendToBatch(). |data| is not owned.
+struct Datagram {
+  Datagram() : data(nullptr), size(0) {}
+  Datagram(const void* data, size_t size, const SocketAddress& addr)
+      : data(data), size(size), addr(addr) {}
+
+  const void* data;
+  size_t size;
+  SocketAddress addr;
+};
+
 // General interface for the socket implementations of various networks.  The
 // methods match those of normal UNIX sockets very closely.
 class Socket {
@@ -151,6 +162,17 @@ class Socket {
   virtual int Connect(const SocketAddress& addr) = 0;
   virtual int Send(const void *pv, size_t cb) = 0;
   virtual int SendTo(const void *pv, size_t cb, const SocketAddress& addr) = 0;
+  // Sends |count| datagrams, using as few system calls as the socket allows.
+  // Returns the number of datagrams that were sent, which is smaller than
+  // |count| if a send failed, or -1 if the first send failed. The default
+  // implementation calls SendTo() for each datagram.
+  virtual int SendToBatch(const Datagram* datagrams, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      if (SendTo(datagrams[i].data, datagrams[i].size, datagrams[i].addr) < 0)
+        return i == 0 ? -1 : static_cast<int>(i);
+    }
+    return static_cast<int>(count);
+  }
   virtual int Recv(void *pv, size_t cb) = 0;
   virtual int RecvFrom(void *pv, size_t cb, SocketAddress *paddr) = 0;
   virtual int Listen(int backlog) = 0;
@@ -58,6 +58,25 @@ class WrappingBitrateEstimator : public RemoteBitrateEstimator {
     rbe_->IncomingPacket(arrival_time_ms, payload_size, header, was_paced);
   }
 
+  void IncomingPackets(const std::vector<IncomingRtpPacket>& packets) override {
+    CriticalSectionScoped cs(crit_sect_.get());
+    // Switching estimators throws away the old one, so only the packets from
+    // the last switch in the burst onwards need to be handed over.
+    size_t first_packet = 0;
+    for (size_t i = 0; i < packets.size(); ++i) {
+      const RemoteBitrateEstimator* rbe = rbe_.get();
+      PickEstimatorFromHeader(*packets[i].header);
+      if (rbe_.get() != rbe)
+        first_packet = i;
+    }
+    if (first_packet == 0) {
+      rbe_->IncomingPackets(packets);
+    } else {
+      rbe_->IncomingPackets(std::vector<IncomingRtpPacket>(
+          packets.begin() + first_packet, packets.end()));
+    }
+  }
+
   int32_t Process() override {
     CriticalSectionScoped cs(crit_sect_.get());
     return rbe_->Process();
@@ -199,7 +199,10 @@
           'type': 'static_library',
           'sources': [
             'fir_filter_sse.cc',
+            'resampler/sinc_resampler_avx2.cc',
             'resampler/sinc_resampler_sse.cc',
+            'signal_processing/cross_correlation_sse2.c',
+            'signal_processing/vector_scaling_operations_sse2.c',
           ],
           'conditions': [
             ['os_posix==1', {
@@ -23,7 +23,9 @@ LOCAL_SRC_FILES := \
     sinc_resampler.cc \
 
 ifeq ($(TARGET_ARCH), $(filter $(TARGET_ARCH),x86 x86_64))
-LOCAL_SRC_FILES += sinc_resampler_sse.cc
+LOCAL_SRC_FILES += \
+    sinc_resampler_avx2.cc \
+    sinc_resampler_sse.cc
 endif
 
 # Flags passed to both C and C++ files.
@@ -12,14 +12,17 @@
 #define WEBRTC_COMMON_AUDIO_RESAMPLER_INCLUDE_PUSH_RESAMPLER_H_
 
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/common_audio/channel_buffer.h"
+#include "webrtc/system_wrappers/include/scoped_vector.h"
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
 
 class PushSincResampler;
 
-// Wraps PushSincResampler to provide stereo support.
-// TODO(ajm): add support for an arbitrary number of channels.
+// Wraps PushSincResampler to provide support for interleaved audio with any
+// number of channels. Multichannel audio is deinterleaved in one pass,
+// resampled one channel at a time and interleaved again in one pass.
 template <typename T>
 class PushResampler {
  public:
@@ -36,15 +39,15 @@ class PushResampler {
   int Resample(const T* src, size_t src_length, T* dst, size_t dst_capacity);
 
  private:
-  rtc::scoped_ptr<PushSincResampler> sinc_resampler_;
-  rtc::scoped_ptr<PushSincResampler> sinc_resampler_right_;
+  // One resampler per channel.
+  ScopedVector<PushSincResampler> channel_resamplers_;
   int src_sample_rate_hz_;
   int dst_sample_rate_hz_;
   size_t num_channels_;
-  rtc::scoped_ptr<T[]> src_left_;
-  rtc::scoped_ptr<T[]> src_right_;
-  rtc::scoped_ptr<T[]> dst_left_;
-  rtc::scoped_ptr<T[]> dst_right_;
+  // Deinterleaved source and destination audio. Only used with more than one
+  // channel.
+  rtc::scoped_ptr<ChannelBuffer<T>> src_channels_;
+  rtc::scoped_ptr<ChannelBuffer<T>> dst_channels_;
 };
 
 }  // namespace webrtc
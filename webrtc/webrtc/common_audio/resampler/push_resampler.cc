@@ -40,7 +40,7 @@ int PushResampler<T>::InitializeIfNeeded(int src_sample_rate_hz,
     return 0;
 
   if (src_sample_rate_hz <= 0 || dst_sample_rate_hz <= 0 ||
-      num_channels <= 0 || num_channels > 2)
+      num_channels <= 0)
     return -1;
 
   src_sample_rate_hz_ = src_sample_rate_hz;
@@ -51,15 +51,19 @@ int PushResampler<T>::InitializeIfNeeded(int src_sample_rate_hz,
       static_cast<size_t>(src_sample_rate_hz / 100);
   const size_t dst_size_10ms_mono =
       static_cast<size_t>(dst_sample_rate_hz / 100);
-  sinc_resampler_.reset(new PushSincResampler(src_size_10ms_mono,
-                                              dst_size_10ms_mono));
-  if (num_channels_ == 2) {
-    src_left_.reset(new T[src_size_10ms_mono]);
-    src_right_.reset(new T[src_size_10ms_mono]);
-    dst_left_.reset(new T[dst_size_10ms_mono]);
-    dst_right_.reset(new T[dst_size_10ms_mono]);
-    sinc_resampler_right_.reset(new PushSincResampler(src_size_10ms_mono,
-                                                      dst_size_10ms_mono));
+  channel_resamplers_.clear();
+  for (size_t i = 0; i < num_channels_; ++i) {
+    channel_resamplers_.push_back(
+        new PushSincResampler(src_size_10ms_mono, dst_size_10ms_mono));
+  }
+  if (num_channels_ > 1) {
+    src_channels_.reset(new ChannelBuffer<T>(src_size_10ms_mono,
+                                             num_channels_));
+    dst_channels_.reset(new ChannelBuffer<T>(dst_size_10ms_mono,
+                                             num_channels_));
+  } else {
+    src_channels_.reset();
+    dst_channels_.reset();
   }
 
   return 0;
@@ -79,25 +83,24 @@ int PushResampler<T>::Resample(const T* src, size_t src_length, T* dst,
     memcpy(dst, src, src_length * sizeof(T));
     return static_cast<int>(src_length);
   }
-  if (num_channels_ == 2) {
+  if (num_channels_ > 1) {
     const size_t src_length_mono = src_length / num_channels_;
     const size_t dst_capacity_mono = dst_capacity / num_channels_;
-    T* deinterleaved[] = {src_left_.get(), src_right_.get()};
-    Deinterleave(src, src_length_mono, num_channels_, deinterleaved);
-
-    size_t dst_length_mono =
-        sinc_resampler_->Resample(src_left_.get(), src_length_mono,
-                                  dst_left_.get(), dst_capacity_mono);
-    sinc_resampler_right_->Resample(src_right_.get(), src_length_mono,
-                                    dst_right_.get(), dst_capacity_mono);
-
-    deinterleaved[0] = dst_left_.get();
-    deinterleaved[1] = dst_right_.get();
-    Interleave(deinterleaved, dst_length_mono, num_channels_, dst);
+    Deinterleave(src, src_length_mono, num_channels_,
+                 src_channels_->channels());
+
+    size_t dst_length_mono = 0;
+    for (size_t i = 0; i < num_channels_; ++i) {
+      dst_length_mono = channel_resamplers_[i]->Resample(
+          src_channels_->channels()[i], src_length_mono,
+          dst_channels_->channels()[i], dst_capacity_mono);
+    }
+
+    Interleave(dst_channels_->channels(), dst_length_mono, num_channels_, dst);
     return static_cast<int>(dst_length_mono * num_channels_);
   } else {
     return static_cast<int>(
-        sinc_resampler_->Resample(src, src_length, dst, dst_capacity));
+        channel_resamplers_[0]->Resample(src, src_length, dst, dst_capacity));
   }
 }
 
@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <vector>
+
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/common_audio/resampler/include/push_resampler.h"
 
@@ -20,9 +22,52 @@ TEST(PushResamplerTest, VerifiesInputParameters) {
   EXPECT_EQ(-1, resampler.InitializeIfNeeded(-1, 16000, 1));
   EXPECT_EQ(-1, resampler.InitializeIfNeeded(16000, -1, 1));
   EXPECT_EQ(-1, resampler.InitializeIfNeeded(16000, 16000, 0));
-  EXPECT_EQ(-1, resampler.InitializeIfNeeded(16000, 16000, 3));
   EXPECT_EQ(0, resampler.InitializeIfNeeded(16000, 16000, 1));
   EXPECT_EQ(0, resampler.InitializeIfNeeded(16000, 16000, 2));
+  EXPECT_EQ(0, resampler.InitializeIfNeeded(16000, 16000, 3));
+}
+
+// Each channel of multichannel audio must be resampled exactly like the same
+// audio on its own.
+TEST(PushResamplerTest, MultichannelMatchesMono) {
+  const size_t kChannels = 8;
+  const int kSrcRateHz = 48000;
+  const int kDstRateHz = 16000;
+  const size_t kSrcLength = kSrcRateHz / 100;
+  const size_t kDstLength = kDstRateHz / 100;
+
+  PushResampler<float> multichannel;
+  ASSERT_EQ(0, multichannel.InitializeIfNeeded(kSrcRateHz, kDstRateHz,
+                                               kChannels));
+  PushResampler<float> mono[kChannels];
+  for (size_t ch = 0; ch < kChannels; ++ch)
+    ASSERT_EQ(0, mono[ch].InitializeIfNeeded(kSrcRateHz, kDstRateHz, 1));
+
+  std::vector<float> interleaved(kSrcLength * kChannels);
+  std::vector<float> interleaved_out(kDstLength * kChannels);
+  std::vector<float> mono_in(kSrcLength);
+  std::vector<float> mono_out(kDstLength);
+  for (int block = 0; block < 3; ++block) {
+    for (size_t i = 0; i < kSrcLength; ++i) {
+      for (size_t ch = 0; ch < kChannels; ++ch) {
+        interleaved[i * kChannels + ch] = static_cast<float>(
+            (block * kSrcLength + i) * (ch + 1) % 200) - 100.f;
+      }
+    }
+    EXPECT_EQ(static_cast<int>(kDstLength * kChannels),
+              multichannel.Resample(&interleaved[0], interleaved.size(),
+                                    &interleaved_out[0],
+                                    interleaved_out.size()));
+    for (size_t ch = 0; ch < kChannels; ++ch) {
+      for (size_t i = 0; i < kSrcLength; ++i)
+        mono_in[i] = interleaved[i * kChannels + ch];
+      EXPECT_EQ(static_cast<int>(kDstLength),
+                mono[ch].Resample(&mono_in[0], kSrcLength, &mono_out[0],
+                                  kDstLength));
+      for (size_t i = 0; i < kDstLength; ++i)
+        ASSERT_EQ(mono_out[i], interleaved_out[i * kChannels + ch]);
+    }
+  }
 }
 
 }  // namespace webrtc
@@ -120,19 +120,23 @@ double SincScaleFactor(double io_ratio) {
 
 // If we know the minimum architecture at compile time, avoid CPU detection.
 #if defined(WEBRTC_ARCH_X86_FAMILY)
-#if defined(__SSE2__)
-#define CONVOLVE_FUNC Convolve_SSE
-void SincResampler::InitializeCPUSpecificFeatures() {}
-#else
-// x86 CPU detection required.  Function will be set by
-// InitializeCPUSpecificFeatures().
-// TODO(dalecurtis): Once Chrome moves to an SSE baseline this can be removed.
+// x86 CPU detection required, since AVX2 is never part of the baseline.
+// Function will be set by InitializeCPUSpecificFeatures().
 #define CONVOLVE_FUNC convolve_proc_
 
 void SincResampler::InitializeCPUSpecificFeatures() {
-  convolve_proc_ = WebRtc_GetCPUInfo(kSSE2) ? Convolve_SSE : Convolve_C;
-}
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    convolve_proc_ = Convolve_AVX2;
+  } else {
+#if defined(__SSE2__)
+    convolve_proc_ = Convolve_SSE;
+#else
+    // TODO(dalecurtis): Once Chrome moves to an SSE baseline this can be
+    // removed.
+    convolve_proc_ = WebRtc_GetCPUInfo(kSSE2) ? Convolve_SSE : Convolve_C;
 #endif
+  }
+}
 #elif defined(WEBRTC_HAS_NEON)
 #define CONVOLVE_FUNC Convolve_NEON
 void SincResampler::InitializeCPUSpecificFeatures() {}
@@ -162,6 +162,37 @@ TEST(SincResamplerTest, Convolve) {
 }
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Ensure Convolve_AVX2() returns the same value as Convolve_C(), on CPUs that
+// support it.
+TEST(SincResamplerTest, ConvolveAVX2) {
+  if (!WebRtc_GetCPUInfo(kAVX2)) {
+    printf("Skipping test, AVX2 is not supported.\n");
+    return;
+  }
+
+  // Initialize a dummy resampler.
+  MockSource mock_source;
+  SincResampler resampler(kSampleRateRatio, SincResampler::kDefaultRequestSize,
+                          &mock_source);
+
+  // Convolve_AVX2() sums in a different order and with fused multiply-adds,
+  // so comparison must be done using an epsilon.
+  static const double kEpsilon = 0.00000005;
+
+  for (size_t offset = 0; offset < 8; ++offset) {
+    const float* input = resampler.kernel_storage_.get() + offset;
+    double result = resampler.Convolve_C(
+        input, resampler.kernel_storage_.get(),
+        resampler.kernel_storage_.get(), kKernelInterpolationFactor);
+    double result2 = resampler.Convolve_AVX2(
+        input, resampler.kernel_storage_.get(),
+        resampler.kernel_storage_.get(), kKernelInterpolationFactor);
+    EXPECT_NEAR(result2, result, kEpsilon) << "Input offset " << offset;
+  }
+}
+#endif
+
 // Benchmark for the various Convolve() methods.  Make sure to build with
 // branding=Chrome so that RTC_DCHECKs are compiled out when benchmarking.
 // Original benchmarks were run with --convolve-iterations=50000000.
@@ -46,6 +46,12 @@ LOCAL_SRC_FILES := \
     sqrt_of_one_minus_x_squared.c \
     vector_scaling_operations.c
 
+ifeq ($(TARGET_ARCH), $(filter $(TARGET_ARCH),x86 x86_64))
+LOCAL_SRC_FILES += \
+    cross_correlation_sse2.c \
+    vector_scaling_operations_sse2.c
+endif
+
 # Flags passed to both C and C++ files.
 LOCAL_CFLAGS := \
     $(MY_WEBRTC_COMMON_DEFS)
@@ -0,0 +1,62 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/common_audio/signal_processing/include/signal_processing_library.h"
+
+#include <emmintrin.h>
+
+/* Each product is shifted before it is accumulated, as in the C version, so
+ * the result is bit exact with WebRtcSpl_CrossCorrelationC().
+ */
+static inline int32_t DotProductWithScaleSSE2(const int16_t* vector1,
+                                              const int16_t* vector2,
+                                              size_t length,
+                                              int scaling) {
+  size_t i = 0;
+  int32_t corr = 0;
+  const __m128i shift = _mm_cvtsi32_si128(scaling);
+  __m128i sum = _mm_setzero_si128();
+
+  for (i = 0; i + 8 <= length; i += 8) {
+    const __m128i seq1 = _mm_loadu_si128((const __m128i*)&vector1[i]);
+    const __m128i seq2 = _mm_loadu_si128((const __m128i*)&vector2[i]);
+    const __m128i lo = _mm_mullo_epi16(seq1, seq2);
+    const __m128i hi = _mm_mulhi_epi16(seq1, seq2);
+    sum = _mm_add_epi32(sum,
+                        _mm_sra_epi32(_mm_unpacklo_epi16(lo, hi), shift));
+    sum = _mm_add_epi32(sum,
+                        _mm_sra_epi32(_mm_unpackhi_epi16(lo, hi), shift));
+  }
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  corr = _mm_cvtsi128_si32(sum);
+
+  for (; i < length; i++) {
+    corr += (vector1[i] * vector2[i]) >> scaling;
+  }
+  return corr;
+}
+
+/* SSE2 version of WebRtcSpl_CrossCorrelation() for x86 platforms. */
+void WebRtcSpl_CrossCorrelationSSE2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    size_t dim_seq,
+                                    size_t dim_cross_correlation,
+                                    int right_shifts,
+                                    int step_seq2) {
+  size_t i = 0;
+
+  for (i = 0; i < dim_cross_correlation; i++) {
+    *cross_correlation++ =
+        DotProductWithScaleSSE2(seq1, seq2, dim_seq, right_shifts);
+    seq2 += step_seq2;
+  }
+}
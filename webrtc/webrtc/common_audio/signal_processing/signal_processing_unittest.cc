@@ -447,10 +447,10 @@ TEST_F(SplTest, CrossCorrelationTest) {
   const int32_t kExpected[kCrossCorrelationDimension] =
       {-266947903, -15579555, -171282001};
   const int32_t* expected = kExpected;
-#if !defined(MIPS32_LE)
+#if defined(WEBRTC_DETECT_NEON) || defined(WEBRTC_HAS_NEON)
   const int32_t kExpectedNeon[kCrossCorrelationDimension] =
       {-266947901, -15579553, -171281999};
-  if (WebRtcSpl_CrossCorrelation != WebRtcSpl_CrossCorrelationC) {
+  if (WebRtcSpl_CrossCorrelation == WebRtcSpl_CrossCorrelationNeon) {
     expected = kExpectedNeon;
   }
 #endif
@@ -459,6 +459,59 @@ TEST_F(SplTest, CrossCorrelationTest) {
   }
 }
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// The SSE2 versions must be bit-exact with the C versions, also for lengths
+// that are not a multiple of the vector width.
+TEST_F(SplTest, CrossCorrelationSSE2BitExactTest) {
+  const size_t kSeqDimension = 61;
+  const size_t kCrossCorrelationDimension = 23;
+  int16_t seq1[kSeqDimension];
+  int16_t seq2[kSeqDimension + kCrossCorrelationDimension];
+  for (size_t i = 0; i < kSeqDimension; ++i) {
+    seq1[i] = static_cast<int16_t>((i * 7919 + 13) & 0xFFFF);
+  }
+  for (size_t i = 0; i < kSeqDimension + kCrossCorrelationDimension; ++i) {
+    seq2[i] = static_cast<int16_t>((i * 104729 + 577) & 0xFFFF);
+  }
+  seq1[0] = WEBRTC_SPL_WORD16_MIN;
+  seq2[0] = WEBRTC_SPL_WORD16_MIN;
+
+  for (int shift = 0; shift < 8; ++shift) {
+    int32_t expected[kCrossCorrelationDimension];
+    int32_t result[kCrossCorrelationDimension];
+    WebRtcSpl_CrossCorrelationC(expected, seq1, seq2, kSeqDimension,
+                                kCrossCorrelationDimension, shift, 1);
+    WebRtcSpl_CrossCorrelationSSE2(result, seq1, seq2, kSeqDimension,
+                                   kCrossCorrelationDimension, shift, 1);
+    for (size_t i = 0; i < kCrossCorrelationDimension; ++i) {
+      EXPECT_EQ(expected[i], result[i]);
+    }
+  }
+}
+
+TEST_F(SplTest, ScaleAndAddVectorsWithRoundSSE2BitExactTest) {
+  const size_t kLength = 37;
+  int16_t in1[kLength];
+  int16_t in2[kLength];
+  for (size_t i = 0; i < kLength; ++i) {
+    in1[i] = static_cast<int16_t>((i * 7919 + 13) & 0xFFFF);
+    in2[i] = static_cast<int16_t>((i * 104729 + 577) & 0xFFFF);
+  }
+
+  for (int shift = 0; shift < 16; ++shift) {
+    int16_t expected[kLength];
+    int16_t result[kLength];
+    EXPECT_EQ(0, WebRtcSpl_ScaleAndAddVectorsWithRoundC(
+        in1, 12345, in2, -4321, shift, expected, kLength));
+    EXPECT_EQ(0, WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2(
+        in1, 12345, in2, -4321, shift, result, kLength));
+    for (size_t i = 0; i < kLength; ++i) {
+      EXPECT_EQ(expected[i], result[i]);
+    }
+  }
+}
+#endif
+
 TEST_F(SplTest, AutoCorrelationTest) {
   int scale = 0;
   int32_t vector32[kVector16Size];
@@ -10,6 +10,8 @@
 
 #include "webrtc/common_video/include/i420_buffer_pool.h"
 
+#include <algorithm>
+
 #include "webrtc/base/checks.h"
 
 namespace {
@@ -53,18 +55,22 @@ class PooledI420Buffer : public webrtc::VideoFrameBuffer {
 
 namespace webrtc {
 
-I420BufferPool::I420BufferPool() {
-  Release();
-}
+I420BufferPool::I420BufferPool() {}
 
 void I420BufferPool::Release() {
-  thread_checker_.DetachFromThread();
+  rtc::CritScope lock(&crit_);
   buffers_.clear();
+  stats_.pool_size = 0;
+}
+
+I420BufferPool::Stats I420BufferPool::GetStats() const {
+  rtc::CritScope lock(&crit_);
+  return stats_;
 }
 
 rtc::scoped_refptr<VideoFrameBuffer> I420BufferPool::CreateBuffer(int width,
                                                                   int height) {
-  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  rtc::CritScope lock(&crit_);
   // Release buffers with wrong resolution.
   for (auto it = buffers_.begin(); it != buffers_.end();) {
     if ((*it)->width() != width || (*it)->height() != height)
@@ -72,18 +78,27 @@ rtc::scoped_refptr<VideoFrameBuffer> I420BufferPool::CreateBuffer(int width,
     else
       ++it;
   }
+  stats_.pool_size = buffers_.size();
   // Look for a free buffer.
+  size_t buffers_in_use = 0;
   for (const rtc::scoped_refptr<I420Buffer>& buffer : buffers_) {
     // If the buffer is in use, the ref count will be 2, one from the list we
     // are looping over and one from a PooledI420Buffer returned from
     // CreateBuffer that has not been released yet. If the ref count is 1
     // (HasOneRef), then the list we are looping over holds the only reference
     // and it's safe to reuse.
-    if (buffer->HasOneRef())
+    if (buffer->HasOneRef()) {
+      ++stats_.reuses;
       return new rtc::RefCountedObject<PooledI420Buffer>(buffer);
+    }
+    ++buffers_in_use;
   }
   // Allocate new buffer.
   buffers_.push_back(new rtc::RefCountedObject<I420Buffer>(width, height));
+  ++stats_.allocations;
+  stats_.pool_size = buffers_.size();
+  stats_.max_buffers_in_use =
+      std::max(stats_.max_buffers_in_use, buffers_in_use + 1);
   return new rtc::RefCountedObject<PooledI420Buffer>(buffers_.back());
 }
 
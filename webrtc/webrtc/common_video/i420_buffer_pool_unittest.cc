@@ -71,4 +71,35 @@ TEST(TestI420BufferPool, FrameValidAfterPoolDestruction) {
   memset(buffer->MutableData(kYPlane), 0xA5, 16 * buffer->stride(kYPlane));
 }
 
+TEST(TestI420BufferPool, Stats) {
+  I420BufferPool pool;
+  rtc::scoped_refptr<VideoFrameBuffer> buffer1 = pool.CreateBuffer(16, 16);
+  rtc::scoped_refptr<VideoFrameBuffer> buffer2 = pool.CreateBuffer(16, 16);
+  I420BufferPool::Stats stats = pool.GetStats();
+  EXPECT_EQ(2u, stats.allocations);
+  EXPECT_EQ(0u, stats.reuses);
+  EXPECT_EQ(2u, stats.pool_size);
+  EXPECT_EQ(2u, stats.max_buffers_in_use);
+
+  // Both buffers are reused once they are released.
+  buffer1 = nullptr;
+  buffer2 = nullptr;
+  buffer1 = pool.CreateBuffer(16, 16);
+  buffer2 = pool.CreateBuffer(16, 16);
+  stats = pool.GetStats();
+  EXPECT_EQ(2u, stats.allocations);
+  EXPECT_EQ(2u, stats.reuses);
+  EXPECT_EQ(2u, stats.max_buffers_in_use);
+
+  // A new resolution purges the buffers that are not in use.
+  buffer2 = nullptr;
+  buffer2 = pool.CreateBuffer(32, 16);
+  stats = pool.GetStats();
+  EXPECT_EQ(3u, stats.allocations);
+  EXPECT_EQ(1u, stats.pool_size);
+
+  pool.Release();
+  EXPECT_EQ(0u, pool.GetStats().pool_size);
+}
+
 }  // namespace webrtc
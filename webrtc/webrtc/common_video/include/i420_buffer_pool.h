@@ -13,7 +13,7 @@
 
 #include <list>
 
-#include "webrtc/base/thread_checker.h"
+#include "webrtc/base/criticalsection.h"
 #include "webrtc/common_video/include/video_frame_buffer.h"
 
 namespace webrtc {
@@ -23,19 +23,38 @@ namespace webrtc {
 // When the I420Buffer is destructed, the memory is returned to the pool for use
 // by subsequent calls to CreateBuffer. If the resolution passed to CreateBuffer
 // changes, old buffers will be purged from the pool.
+//
+// All methods are thread safe, so that the pool can be used by e.g. a capture
+// module whose frames are delivered on different threads over its lifetime.
 class I420BufferPool {
  public:
+  struct Stats {
+    Stats() : allocations(0), reuses(0), pool_size(0), max_buffers_in_use(0) {}
+
+    // Number of CreateBuffer() calls that had to allocate a new buffer.
+    uint64_t allocations;
+    // Number of CreateBuffer() calls that returned a buffer from the pool.
+    uint64_t reuses;
+    // Number of buffers currently owned by the pool, in use or not.
+    size_t pool_size;
+    // The largest number of buffers that were in use at the same time, i.e.
+    // the number of buffers needed to serve the pipeline without allocating.
+    size_t max_buffers_in_use;
+  };
+
   I420BufferPool();
   // Returns a buffer from the pool, or creates a new buffer if no suitable
   // buffer exists in the pool.
   rtc::scoped_refptr<VideoFrameBuffer> CreateBuffer(int width, int height);
-  // Clears buffers_ and detaches the thread checker so that it can be reused
-  // later from another thread.
+  // Clears buffers_. Buffers that are still in use remain valid.
   void Release();
 
+  Stats GetStats() const;
+
  private:
-  rtc::ThreadChecker thread_checker_;
-  std::list<rtc::scoped_refptr<I420Buffer>> buffers_;
+  mutable rtc::CriticalSection crit_;
+  std::list<rtc::scoped_refptr<I420Buffer>> buffers_ GUARDED_BY(crit_);
+  Stats stats_ GUARDED_BY(crit_);
 };
 
 }  // namespace webrtc
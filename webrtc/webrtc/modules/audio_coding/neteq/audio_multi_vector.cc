@@ -16,8 +16,86 @@
 
 #include "webrtc/typedefs.h"
 
+#if defined(WEBRTC_ARCH_X86_FAMILY) && defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace webrtc {
 
+namespace {
+
+// Splits |length_per_channel| interleaved stereo samples into |left| and
+// |right|.
+void DeinterleaveStereo(const int16_t* interleaved,
+                        size_t length_per_channel,
+                        int16_t* left,
+                        int16_t* right) {
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY) && defined(__SSE2__)
+  for (; i + 8 <= length_per_channel; i += 8) {
+    const __m128i a =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&interleaved[2 * i]));
+    const __m128i b = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(&interleaved[2 * i + 8]));
+    // Sign extend the even and the odd samples to 32 bits, so that packing
+    // them back to 16 bits does not saturate.
+    const __m128i left_samples =
+        _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+                        _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+    const __m128i right_samples =
+        _mm_packs_epi32(_mm_srai_epi32(a, 16), _mm_srai_epi32(b, 16));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&left[i]), left_samples);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&right[i]), right_samples);
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  for (; i + 8 <= length_per_channel; i += 8) {
+    const int16x8x2_t samples = vld2q_s16(&interleaved[2 * i]);
+    vst1q_s16(&left[i], samples.val[0]);
+    vst1q_s16(&right[i], samples.val[1]);
+  }
+#endif
+  for (; i < length_per_channel; ++i) {
+    left[i] = interleaved[2 * i];
+    right[i] = interleaved[2 * i + 1];
+  }
+}
+
+// Interleaves |length_per_channel| samples of |left| and |right| into
+// |interleaved|.
+void InterleaveStereo(const int16_t* left,
+                      const int16_t* right,
+                      size_t length_per_channel,
+                      int16_t* interleaved) {
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY) && defined(__SSE2__)
+  for (; i + 8 <= length_per_channel; i += 8) {
+    const __m128i l =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&left[i]));
+    const __m128i r =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&right[i]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&interleaved[2 * i]),
+                     _mm_unpacklo_epi16(l, r));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&interleaved[2 * i + 8]),
+                     _mm_unpackhi_epi16(l, r));
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  for (; i + 8 <= length_per_channel; i += 8) {
+    int16x8x2_t samples;
+    samples.val[0] = vld1q_s16(&left[i]);
+    samples.val[1] = vld1q_s16(&right[i]);
+    vst2q_s16(&interleaved[2 * i], samples);
+  }
+#endif
+  for (; i < length_per_channel; ++i) {
+    interleaved[2 * i] = left[i];
+    interleaved[2 * i + 1] = right[i];
+  }
+}
+
+}  // namespace
+
 AudioMultiVector::AudioMultiVector(size_t N) {
   assert(N > 0);
   if (N < 1) N = 1;
@@ -74,6 +152,17 @@ void AudioMultiVector::PushBackInterleaved(const int16_t* append_this,
     return;
   }
   size_t length_per_channel = length / num_channels_;
+  if (num_channels_ == 2) {
+    // Special case to deinterleave both channels in one pass.
+    int16_t* temp_array = new int16_t[2 * length_per_channel];
+    DeinterleaveStereo(append_this, length_per_channel, temp_array,
+                       &temp_array[length_per_channel]);
+    channels_[0]->PushBack(temp_array, length_per_channel);
+    channels_[1]->PushBack(&temp_array[length_per_channel],
+                           length_per_channel);
+    delete [] temp_array;
+    return;
+  }
   int16_t* temp_array = new int16_t[length_per_channel];  // Temporary storage.
   for (size_t channel = 0; channel < num_channels_; ++channel) {
     // Copy elements to |temp_array|.
@@ -144,6 +233,12 @@ size_t AudioMultiVector::ReadInterleavedFromIndex(size_t start_index,
     memcpy(destination, &(*this)[0][start_index], length * sizeof(int16_t));
     return length;
   }
+  if (num_channels_ == 2) {
+    // Special case to interleave both channels in one pass.
+    InterleaveStereo(&(*this)[0][start_index], &(*this)[1][start_index],
+                     length, destination);
+    return 2 * length;
+  }
   for (size_t i = 0; i < length; ++i) {
     for (size_t channel = 0; channel < num_channels_; ++channel) {
       destination[index] = (*this)[channel][i + start_index];
@@ -325,6 +325,35 @@ TEST_P(AudioMultiVectorTest, CopyChannel) {
   }
 }
 
+// Verifies that interleaved data survives a round trip, for lengths that are
+// longer than, and not a multiple of, the vector width.
+TEST_P(AudioMultiVectorTest, InterleavedRoundTrip) {
+  static const size_t kLengthPerChannel = 37;
+  const size_t length = kLengthPerChannel * num_channels_;
+  int16_t* input = new int16_t[length];
+  int16_t* output = new int16_t[length];
+  for (size_t i = 0; i < length; ++i) {
+    input[i] = static_cast<int16_t>((i * 7919) & 0xFFFF);
+  }
+  AudioMultiVector vec(num_channels_);
+  vec.PushBackInterleaved(input, length);
+  ASSERT_EQ(kLengthPerChannel, vec.Size());
+  for (size_t i = 0; i < kLengthPerChannel; ++i) {
+    for (size_t channel = 0; channel < num_channels_; ++channel) {
+      EXPECT_EQ(input[i * num_channels_ + channel], vec[channel][i]);
+    }
+  }
+  // Read from an offset to exercise unaligned accesses.
+  const size_t kOffset = 3;
+  EXPECT_EQ(length - kOffset * num_channels_,
+            vec.ReadInterleavedFromIndex(kOffset, kLengthPerChannel, output));
+  for (size_t i = 0; i < length - kOffset * num_channels_; ++i) {
+    EXPECT_EQ(input[kOffset * num_channels_ + i], output[i]);
+  }
+  delete [] input;
+  delete [] output;
+}
+
 INSTANTIATE_TEST_CASE_P(TestNumChannels,
                         AudioMultiVectorTest,
                         ::testing::Values(static_cast<size_t>(1),
@@ -16,8 +16,84 @@
 
 #include "webrtc/typedefs.h"
 
+#if defined(WEBRTC_ARCH_X86_FAMILY) && defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace webrtc {
 
+namespace {
+
+// Mixes |length| samples of |fade_in| into |fade_out| in place. The mixing
+// factor of |fade_out| is 16384 - (i + 1) * |alpha_step| in Q14 for sample i.
+// The vector versions compute exactly the same result as the scalar loop.
+void CrossFadeSamples(const int16_t* fade_in,
+                      size_t length,
+                      int alpha_step,
+                      int16_t* fade_out) {
+  size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY) && defined(__SSE2__)
+  if (length >= 8) {
+    // Since |alpha_step| <= 16384 / (length + 1), 8 * |alpha_step| fits in 16
+    // bits. The samples and their mixing factors are interleaved so that one
+    // multiply-add computes alpha * out + (16384 - alpha) * in.
+    __m128i alpha = _mm_setr_epi16(
+        16384 - alpha_step, 16384 - 2 * alpha_step, 16384 - 3 * alpha_step,
+        16384 - 4 * alpha_step, 16384 - 5 * alpha_step,
+        16384 - 6 * alpha_step, 16384 - 7 * alpha_step,
+        16384 - 8 * alpha_step);
+    const __m128i alpha_decrement = _mm_set1_epi16(8 * alpha_step);
+    const __m128i one = _mm_set1_epi16(16384);
+    const __m128i round = _mm_set1_epi32(8192);
+    for (; i + 8 <= length; i += 8) {
+      const __m128i beta = _mm_sub_epi16(one, alpha);
+      const __m128i out =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(&fade_out[i]));
+      const __m128i in =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(&fade_in[i]));
+      __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(out, in),
+                                  _mm_unpacklo_epi16(alpha, beta));
+      __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(out, in),
+                                  _mm_unpackhi_epi16(alpha, beta));
+      lo = _mm_srai_epi32(_mm_add_epi32(lo, round), 14);
+      hi = _mm_srai_epi32(_mm_add_epi32(hi, round), 14);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(&fade_out[i]),
+                       _mm_packs_epi32(lo, hi));
+      alpha = _mm_sub_epi16(alpha, alpha_decrement);
+    }
+  }
+#elif defined(WEBRTC_HAS_NEON)
+  if (length >= 4) {
+    const int16_t kAlpha[4] = {
+        static_cast<int16_t>(16384 - alpha_step),
+        static_cast<int16_t>(16384 - 2 * alpha_step),
+        static_cast<int16_t>(16384 - 3 * alpha_step),
+        static_cast<int16_t>(16384 - 4 * alpha_step)};
+    int16x4_t alpha = vld1_s16(kAlpha);
+    const int16x4_t alpha_decrement =
+        vdup_n_s16(static_cast<int16_t>(4 * alpha_step));
+    const int16x4_t one = vdup_n_s16(16384);
+    for (; i + 4 <= length; i += 4) {
+      int32x4_t mixed = vmull_s16(vld1_s16(&fade_out[i]), alpha);
+      mixed = vmlal_s16(mixed, vld1_s16(&fade_in[i]), vsub_s16(one, alpha));
+      vst1_s16(&fade_out[i], vmovn_s32(vrshrq_n_s32(mixed, 14)));
+      alpha = vsub_s16(alpha, alpha_decrement);
+    }
+  }
+#endif
+  int alpha = 16384 - static_cast<int>(i) * alpha_step;
+  for (; i < length; ++i) {
+    alpha -= alpha_step;
+    fade_out[i] = (alpha * fade_out[i] + (16384 - alpha) * fade_in[i] + 8192)
+        >> 14;
+  }
+  assert(alpha >= 0);  // Verify that the slope was correct.
+}
+
+}  // namespace
+
 AudioVector::AudioVector()
     : array_(new int16_t[kDefaultInitialSize]),
       first_free_ix_(0),
@@ -147,13 +223,10 @@ void AudioVector::CrossFade(const AudioVector& append_this,
   // TODO(hlundin): Consider skipping +1 in the denominator to produce a
   // smoother cross-fade, in particular at the end of the fade.
   int alpha_step = 16384 / (static_cast<int>(fade_length) + 1);
-  int alpha = 16384;
-  for (size_t i = 0; i < fade_length; ++i) {
-    alpha -= alpha_step;
-    array_[position + i] = (alpha * array_[position + i] +
-        (16384 - alpha) * append_this[i] + 8192) >> 14;
+  if (fade_length > 0) {
+    CrossFadeSamples(&append_this[0], fade_length, alpha_step,
+                     &array_[position]);
   }
-  assert(alpha >= 0);  // Verify that the slope was correct.
   // Append what is left of |append_this|.
   size_t samples_to_push_back = append_this.Size() - fade_length;
   if (samples_to_push_back > 0)
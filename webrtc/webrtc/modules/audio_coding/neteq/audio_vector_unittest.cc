@@ -391,4 +391,34 @@ TEST_F(AudioVectorTest, CrossFade) {
   }
 }
 
+// Verifies that the cross-fade matches the scalar reference implementation
+// exactly, for fade lengths that are and are not a multiple of the vector
+// width.
+TEST_F(AudioVectorTest, CrossFadeBitExact) {
+  static const size_t kLength = 200;
+  for (size_t fade_length = 1; fade_length <= kLength; fade_length += 7) {
+    AudioVector vec1(kLength);
+    AudioVector vec2(kLength);
+    for (size_t i = 0; i < kLength; ++i) {
+      vec1[i] = static_cast<int16_t>((i * 7919) & 0xFFFF);
+      vec2[i] = static_cast<int16_t>((i * 104729 + 577) & 0xFFFF);
+    }
+    int16_t expected[kLength];
+    const size_t position = kLength - fade_length;
+    const int alpha_step = 16384 / (static_cast<int>(fade_length) + 1);
+    int alpha = 16384;
+    for (size_t i = 0; i < fade_length; ++i) {
+      alpha -= alpha_step;
+      expected[i] = (alpha * vec1[position + i] +
+          (16384 - alpha) * vec2[i] + 8192) >> 14;
+    }
+    vec1.CrossFade(vec2, fade_length);
+    ASSERT_EQ(2 * kLength - fade_length, vec1.Size());
+    for (size_t i = 0; i < fade_length; ++i) {
+      EXPECT_EQ(expected[i], vec1[position + i]) << "fade_length "
+                                                 << fade_length;
+    }
+  }
+}
+
 }  // namespace webrtc
@@ -8,11 +8,29 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <string>
+
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/modules/audio_coding/neteq/tools/neteq_performance_test.h"
 #include "webrtc/test/testsupport/perf_test.h"
 #include "webrtc/typedefs.h"
 
+namespace {
+
+// Prints the total runtime, and the CPU time per second of audio, which is
+// comparable between simulation lengths.
+void PrintRuntime(const std::string& trace,
+                  int64_t runtime_ms,
+                  int simulation_time_ms) {
+  webrtc::test::PrintResult(
+      "neteq_performance", "", trace, runtime_ms, "ms", true);
+  webrtc::test::PrintResult(
+      "neteq_performance_per_second_of_audio", "", trace,
+      runtime_ms * 1000000 / simulation_time_ms, "us", true);
+}
+
+}  // namespace
+
 // Runs a test with 10% packet losses and 10% clock drift, to exercise
 // both loss concealment and time-stretching code.
 TEST(NetEqPerformanceTest, Run) {
@@ -22,8 +40,7 @@ TEST(NetEqPerformanceTest, Run) {
   int64_t runtime = webrtc::test::NetEqPerformanceTest::Run(
       kSimulationTimeMs, kLossPeriod, kDriftFactor);
   ASSERT_GT(runtime, 0);
-  webrtc::test::PrintResult(
-      "neteq_performance", "", "10_pl_10_drift", runtime, "ms", true);
+  PrintRuntime("10_pl_10_drift", runtime, kSimulationTimeMs);
 }
 
 // Runs a test with neither packet losses nor clock drift, to put
@@ -36,6 +53,18 @@ TEST(NetEqPerformanceTest, RunClean) {
   int64_t runtime = webrtc::test::NetEqPerformanceTest::Run(
       kSimulationTimeMs, kLossPeriod, kDriftFactor);
   ASSERT_GT(runtime, 0);
-  webrtc::test::PrintResult(
-      "neteq_performance", "", "0_pl_0_drift", runtime, "ms", true);
+  PrintRuntime("0_pl_0_drift", runtime, kSimulationTimeMs);
+}
+
+// Same as Run, but with stereo audio, to exercise the multi-channel code
+// paths.
+TEST(NetEqPerformanceTest, RunStereo) {
+  const int kSimulationTimeMs = 10000000;
+  const int kLossPeriod = 10;  // Drop every 10th packet.
+  const double kDriftFactor = 0.1;
+  const size_t kNumChannels = 2;
+  int64_t runtime = webrtc::test::NetEqPerformanceTest::Run(
+      kSimulationTimeMs, kLossPeriod, kDriftFactor, kNumChannels);
+  ASSERT_GT(runtime, 0);
+  PrintRuntime("10_pl_10_drift_stereo", runtime, kSimulationTimeMs);
 }
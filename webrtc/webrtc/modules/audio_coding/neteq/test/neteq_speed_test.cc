@@ -35,6 +35,12 @@ static bool ValidateDriftfactor(const char* flagname, double value) {
   printf("Invalid value for --%s: %f\n", flagname, value);
   return false;
 }
+static bool ValidateChannels(const char* flagname, int value) {
+  if (value == 1 || value == 2)  // Value is ok.
+    return true;
+  printf("Invalid value for --%s: %d\n", flagname, static_cast<int>(value));
+  return false;
+}
 
 // Define command line flags.
 DEFINE_int32(runtime_ms, 10000, "Simulated runtime in ms.");
@@ -48,6 +54,10 @@ DEFINE_double(drift, 0.1,
              "Clockdrift factor.");
 static const bool drift_dummy =
     google::RegisterFlagValidator(&FLAGS_drift, &ValidateDriftfactor);
+DEFINE_int32(channels, 1,
+             "Number of audio channels, 1 or 2.");
+static const bool channels_dummy =
+    google::RegisterFlagValidator(&FLAGS_channels, &ValidateChannels);
 
 int main(int argc, char* argv[]) {
   std::string program_name = argv[0];
@@ -56,7 +66,8 @@ int main(int argc, char* argv[]) {
       "  --runtime_ms=N         runtime in ms; default is 10000 ms\n"
       "  --lossrate=N           drop every N packets; default is 10\n"
       "  --drift=F              clockdrift factor between 0.0 and 1.0; "
-      "default is 0.1\n";
+      "default is 0.1\n"
+      "  --channels=N           number of channels, 1 or 2; default is 1\n";
   google::SetUsageMessage(usage);
   google::ParseCommandLineFlags(&argc, &argv, true);
 
@@ -68,7 +79,7 @@ int main(int argc, char* argv[]) {
 
   int64_t result =
       webrtc::test::NetEqPerformanceTest::Run(FLAGS_runtime_ms, FLAGS_lossrate,
-                                              FLAGS_drift);
+                                              FLAGS_drift, FLAGS_channels);
   if (result <= 0) {
     std::cout << "There was an error" << std::endl;
     return -1;
@@ -76,5 +87,7 @@ int main(int argc, char* argv[]) {
 
   std::cout << "Simulation done" << std::endl;
   std::cout << "Runtime = " << result << " ms" << std::endl;
+  std::cout << "Runtime per second of audio = "
+            << result * 1000.0 / FLAGS_runtime_ms << " ms" << std::endl;
   return 0;
 }
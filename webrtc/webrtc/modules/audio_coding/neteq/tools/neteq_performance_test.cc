@@ -10,6 +10,8 @@
 
 #include "webrtc/modules/audio_coding/neteq/tools/neteq_performance_test.h"
 
+#include "webrtc/base/array_view.h"
+#include "webrtc/base/checks.h"
 #include "webrtc/modules/audio_coding/codecs/pcm16b/pcm16b.h"
 #include "webrtc/modules/audio_coding/neteq/include/neteq.h"
 #include "webrtc/modules/audio_coding/neteq/tools/audio_loop.h"
@@ -26,15 +28,50 @@ using webrtc::WebRtcRTPHeader;
 namespace webrtc {
 namespace test {
 
+namespace {
+
+const size_t kMaxChannels = 2;
+const size_t kMaxBlockSizeSamples = 60 * 32000 / 1000;  // 60 ms at 32 kHz.
+
+// Encodes |samples| as PCM16 into |payload|, with |num_channels| identical
+// channels.
+size_t EncodeBlock(rtc::ArrayView<const int16_t> samples,
+                   size_t num_channels,
+                   uint8_t* payload) {
+  if (num_channels == 1)
+    return WebRtcPcm16b_Encode(samples.data(), samples.size(), payload);
+  int16_t interleaved[kMaxChannels * kMaxBlockSizeSamples];
+  RTC_CHECK_LE(samples.size(), kMaxBlockSizeSamples);
+  for (size_t i = 0; i < samples.size(); ++i) {
+    for (size_t channel = 0; channel < num_channels; ++channel)
+      interleaved[i * num_channels + channel] = samples[i];
+  }
+  return WebRtcPcm16b_Encode(interleaved, samples.size() * num_channels,
+                             payload);
+}
+
+}  // namespace
+
 int64_t NetEqPerformanceTest::Run(int runtime_ms,
                                   int lossrate,
                                   double drift_factor) {
+  return Run(runtime_ms, lossrate, drift_factor, 1);
+}
+
+int64_t NetEqPerformanceTest::Run(int runtime_ms,
+                                  int lossrate,
+                                  double drift_factor,
+                                  size_t num_channels) {
+  if (num_channels < 1 || num_channels > kMaxChannels)
+    return -1;
   const std::string kInputFileName =
       webrtc::test::ResourcePath("audio_coding/testfile32kHz", "pcm");
   const int kSampRateHz = 32000;
   const webrtc::NetEqDecoder kDecoderType =
-      webrtc::NetEqDecoder::kDecoderPCM16Bswb32kHz;
-  const std::string kDecoderName = "pcm16-swb32";
+      num_channels == 1 ? webrtc::NetEqDecoder::kDecoderPCM16Bswb32kHz
+                        : webrtc::NetEqDecoder::kDecoderPCM16Bswb32kHz_2ch;
+  const std::string kDecoderName =
+      num_channels == 1 ? "pcm16-swb32" : "pcm16-swb32-2ch";
   const int kPayloadType = 95;
 
   // Initialize NetEq instance.
@@ -66,10 +103,12 @@ int64_t NetEqPerformanceTest::Run(int runtime_ms,
   auto input_samples = audio_loop.GetNextBlock();
   if (input_samples.empty())
     exit(1);
-  uint8_t input_payload[kInputBlockSizeSamples * sizeof(int16_t)];
-  size_t payload_len = WebRtcPcm16b_Encode(input_samples.data(),
-                                           input_samples.size(), input_payload);
-  RTC_CHECK_EQ(sizeof(input_payload), payload_len);
+  uint8_t input_payload[kInputBlockSizeSamples * sizeof(int16_t) *
+                        kMaxChannels];
+  const size_t kPayloadLen =
+      kInputBlockSizeSamples * sizeof(int16_t) * num_channels;
+  size_t payload_len = EncodeBlock(input_samples, num_channels, input_payload);
+  RTC_CHECK_EQ(kPayloadLen, payload_len);
 
   // Main loop.
   webrtc::Clock* clock = webrtc::Clock::GetRealTimeClock();
@@ -83,9 +122,10 @@ int64_t NetEqPerformanceTest::Run(int runtime_ms,
       }
       if (!lost) {
         // Insert packet.
-        int error =
-            neteq->InsertPacket(rtp_header, input_payload,
-                                packet_input_time_ms * kSampRateHz / 1000);
+        int error = neteq->InsertPacket(
+            rtp_header, rtc::ArrayView<const uint8_t>(input_payload,
+                                                      payload_len),
+            packet_input_time_ms * kSampRateHz / 1000);
         if (error != NetEq::kOK)
           return -1;
       }
@@ -97,13 +137,11 @@ int64_t NetEqPerformanceTest::Run(int runtime_ms,
       input_samples = audio_loop.GetNextBlock();
       if (input_samples.empty())
         return -1;
-      payload_len = WebRtcPcm16b_Encode(input_samples.data(),
-                                        input_samples.size(), input_payload);
-      assert(payload_len == kInputBlockSizeSamples * sizeof(int16_t));
+      payload_len = EncodeBlock(input_samples, num_channels, input_payload);
+      assert(payload_len == kPayloadLen);
     }
 
     // Get output audio, but don't do anything with it.
-    static const int kMaxChannels = 1;
     static const size_t kMaxSamplesPerMs = 48000 / 1000;
     static const int kOutputBlockSizeMs = 10;
     static const size_t kOutDataLen =
@@ -11,6 +11,8 @@
 #ifndef WEBRTC_MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_PERFORMANCE_TEST_H_
 #define WEBRTC_MODULES_AUDIO_CODING_NETEQ_TOOLS_NETEQ_PERFORMANCE_TEST_H_
 
+#include <stddef.h>
+
 #include "webrtc/typedefs.h"
 
 namespace webrtc {
@@ -24,6 +26,13 @@ class NetEqPerformanceTest {
   //   |drift_factor|: clock drift in [0, 1].
   // Returns the runtime in ms.
   static int64_t Run(int runtime_ms, int lossrate, double drift_factor);
+
+  // Same as above, but with |num_channels| copies of the audio data, which
+  // must be 1 or 2.
+  static int64_t Run(int runtime_ms,
+                     int lossrate,
+                     double drift_factor,
+                     size_t num_channels);
 };
 
 }  // namespace test
@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <vector>
+
 #include "webrtc/modules/audio_conference_mixer/include/audio_conference_mixer_defines.h"
 #include "webrtc/modules/audio_conference_mixer/source/audio_conference_mixer_impl.h"
 #include "webrtc/modules/audio_conference_mixer/source/audio_frame_manipulator.h"
@@ -24,7 +26,7 @@ struct ParticipantFramePair {
   AudioFrame* audioFrame;
 };
 
-typedef std::list<ParticipantFramePair*> ParticipantFramePairList;
+typedef std::vector<ParticipantFramePair> ParticipantFramePairList;
 
 // Mix |frame| into |mixed_frame|, with saturation protection and upmixing.
 // These effects are applied to |frame| itself prior to mixing. Assumes that
@@ -46,7 +48,7 @@ void MixFrames(AudioFrame* mixed_frame, AudioFrame* frame, bool use_limiter) {
     AudioFrameOperations::MonoToStereo(frame);
   }
 
-  *mixed_frame += *frame;
+  AddFrame(*frame, *mixed_frame);
 }
 
 // Return the max number of channels from a |list| composed of AudioFrames.
@@ -533,6 +535,8 @@ void AudioConferenceMixerImpl::UpdateToMix(
     // belongs to which MixerParticipant.
     ParticipantFramePairList passiveWasNotMixedList;
     ParticipantFramePairList passiveWasMixedList;
+    passiveWasNotMixedList.reserve(*maxAudioFrameCounter);
+    passiveWasMixedList.reserve(*maxAudioFrameCounter);
     for (MixerParticipantList::const_iterator participant =
         _participantList.begin(); participant != _participantList.end();
          ++participant) {
@@ -579,18 +583,19 @@ void AudioConferenceMixerImpl::UpdateToMix(
                 RampIn(*audioFrame);
             }
 
+            // The energy of a frame in |activeList| is calculated once, when
+            // it is added, instead of for every later active participant.
+            CalculateEnergy(*audioFrame);
             if(activeList.size() >= *maxAudioFrameCounter) {
                 // There are already more active participants than should be
                 // mixed. Only keep the ones with the highest energy.
                 AudioFrameList::iterator replaceItem;
-                CalculateEnergy(*audioFrame);
                 uint32_t lowestEnergy = audioFrame->energy_;
 
                 bool found_replace_item = false;
                 for (AudioFrameList::iterator iter = activeList.begin();
                      iter != activeList.end();
                      ++iter) {
-                    CalculateEnergy(**iter);
                     if((*iter)->energy_ < lowestEnergy) {
                         replaceItem = iter;
                         lowestEnergy = (*iter)->energy_;
@@ -644,15 +649,15 @@ void AudioConferenceMixerImpl::UpdateToMix(
             }
         } else {
             if(wasMixed) {
-                ParticipantFramePair* pair = new ParticipantFramePair;
-                pair->audioFrame  = audioFrame;
-                pair->participant = *participant;
+                ParticipantFramePair pair;
+                pair.audioFrame  = audioFrame;
+                pair.participant = *participant;
                 passiveWasMixedList.push_back(pair);
             } else if(mustAddToPassiveList) {
                 RampIn(*audioFrame);
-                ParticipantFramePair* pair = new ParticipantFramePair;
-                pair->audioFrame  = audioFrame;
-                pair->participant = *participant;
+                ParticipantFramePair pair;
+                pair.audioFrame  = audioFrame;
+                pair.participant = *participant;
                 passiveWasNotMixedList.push_back(pair);
             } else {
                 _audioFramePool->PushMemory(audioFrame);
@@ -675,15 +680,15 @@ void AudioConferenceMixerImpl::UpdateToMix(
         iter = passiveWasMixedList.begin(); iter != passiveWasMixedList.end();
          ++iter) {
         if(mixList->size() < *maxAudioFrameCounter + mixListStartSize) {
-            mixList->push_back((*iter)->audioFrame);
-            (*mixParticipantList)[(*iter)->audioFrame->id_] =
-                (*iter)->participant;
+            mixList->push_back(iter->audioFrame);
+            (*mixParticipantList)[iter->audioFrame->id_] =
+                iter->participant;
             assert(mixParticipantList->size() <=
                    kMaximumAmountOfMixedParticipants);
         } else {
-            _audioFramePool->PushMemory((*iter)->audioFrame);
+            AudioFrame* audioFrame = iter->audioFrame;
+            _audioFramePool->PushMemory(audioFrame);
         }
-        delete *iter;
     }
     // And finally the ones that have not been mixed for a while.
     for (ParticipantFramePairList::const_iterator iter =
@@ -691,15 +696,15 @@ void AudioConferenceMixerImpl::UpdateToMix(
          iter != passiveWasNotMixedList.end();
          ++iter) {
         if(mixList->size() <  *maxAudioFrameCounter + mixListStartSize) {
-          mixList->push_back((*iter)->audioFrame);
-            (*mixParticipantList)[(*iter)->audioFrame->id_] =
-                (*iter)->participant;
+          mixList->push_back(iter->audioFrame);
+            (*mixParticipantList)[iter->audioFrame->id_] =
+                iter->participant;
             assert(mixParticipantList->size() <=
                    kMaximumAmountOfMixedParticipants);
         } else {
-            _audioFramePool->PushMemory((*iter)->audioFrame);
+            AudioFrame* audioFrame = iter->audioFrame;
+            _audioFramePool->PushMemory(audioFrame);
         }
-        delete *iter;
     }
     assert(*maxAudioFrameCounter + mixListStartSize >= mixList->size());
     *maxAudioFrameCounter += mixListStartSize - mixList->size();
@@ -915,7 +920,7 @@ bool AudioConferenceMixerImpl::LimitMixedAudio(AudioFrame* mixedAudio) const {
     //
     // Instead we double the frame (with addition since left-shifting a
     // negative value is undefined).
-    *mixedAudio += *mixedAudio;
+    AddFrame(*mixedAudio, *mixedAudio);
 
     if(error != _limiter->kNoError) {
         WEBRTC_TRACE(kTraceError, kTraceAudioMixerServer, _id,
@@ -12,6 +12,12 @@
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/typedefs.h"
 
+#if defined(WEBRTC_ARCH_X86_FAMILY) && defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace {
 // Linear ramping over 80 samples.
 // TODO(hellner): ramp using fix point?
@@ -74,4 +80,66 @@ void RampOut(AudioFrame& audioFrame)
            (audioFrame.samples_per_channel_ - rampSize) *
            sizeof(audioFrame.data_[0]));
 }
+
+void AddFrame(const AudioFrame& audioFrame, AudioFrame& mixedFrame)
+{
+    if(mixedFrame.samples_per_channel_ == 0 ||
+       mixedFrame.samples_per_channel_ != audioFrame.samples_per_channel_ ||
+       mixedFrame.num_channels_ != audioFrame.num_channels_)
+    {
+        // The first frame of a mix is copied, and frames that don't match
+        // are rejected. Leave both cases to AudioFrame.
+        mixedFrame += audioFrame;
+        return;
+    }
+    assert(mixedFrame.interleaved_ == audioFrame.interleaved_);
+
+    if(mixedFrame.vad_activity_ == AudioFrame::kVadActive ||
+       audioFrame.vad_activity_ == AudioFrame::kVadActive)
+    {
+        mixedFrame.vad_activity_ = AudioFrame::kVadActive;
+    } else if(mixedFrame.vad_activity_ == AudioFrame::kVadUnknown ||
+              audioFrame.vad_activity_ == AudioFrame::kVadUnknown)
+    {
+        mixedFrame.vad_activity_ = AudioFrame::kVadUnknown;
+    }
+    if(mixedFrame.speech_type_ != audioFrame.speech_type_)
+    {
+        mixedFrame.speech_type_ = AudioFrame::kUndefined;
+    }
+
+    AddSamplesSaturated(audioFrame.data_,
+                        audioFrame.samples_per_channel_ *
+                        audioFrame.num_channels_,
+                        mixedFrame.data_);
+}
+
+void AddSamplesSaturated(const int16_t* source, size_t length,
+                         int16_t* target)
+{
+    size_t i = 0;
+#if defined(WEBRTC_ARCH_X86_FAMILY) && defined(__SSE2__)
+    for(; i + 8 <= length; i += 8)
+    {
+        const __m128i a =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(&source[i]));
+        const __m128i b =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(&target[i]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&target[i]),
+                         _mm_adds_epi16(a, b));
+    }
+#elif defined(WEBRTC_HAS_NEON)
+    for(; i + 8 <= length; i += 8)
+    {
+        vst1q_s16(&target[i],
+                  vqaddq_s16(vld1q_s16(&source[i]), vld1q_s16(&target[i])));
+    }
+#endif
+    for(; i < length; i++)
+    {
+        const int32_t sum = static_cast<int32_t>(target[i]) + source[i];
+        target[i] = static_cast<int16_t>(
+            sum > 32767 ? 32767 : (sum < -32768 ? -32768 : sum));
+    }
+}
 }  // namespace webrtc
@@ -11,6 +11,10 @@
 #ifndef WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_AUDIO_FRAME_MANIPULATOR_H_
 #define WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_AUDIO_FRAME_MANIPULATOR_H_
 
+#include <stddef.h>
+
+#include "webrtc/typedefs.h"
+
 namespace webrtc {
 class AudioFrame;
 
@@ -21,6 +25,14 @@ void CalculateEnergy(AudioFrame& audioFrame);
 void RampIn(AudioFrame& audioFrame);
 void RampOut(AudioFrame& audioFrame);
 
+// Adds audioFrame to mixedFrame, like AudioFrame::operator+=, but with a
+// vectorized saturating sum. audioFrame and mixedFrame may be the same frame.
+void AddFrame(const AudioFrame& audioFrame, AudioFrame& mixedFrame);
+
+// Adds length samples of source to target, saturating at the int16_t limits.
+void AddSamplesSaturated(const int16_t* source, size_t length,
+                         int16_t* target);
+
 }  // namespace webrtc
 
 #endif // WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_AUDIO_FRAME_MANIPULATOR_H_
@@ -12,7 +12,7 @@
 #define WEBRTC_MODULES_AUDIO_CONFERENCE_MIXER_SOURCE_MEMORY_POOL_GENERIC_H_
 
 #include <assert.h>
-#include <list>
+#include <vector>
 
 #include "webrtc/system_wrappers/include/critical_section_wrapper.h"
 #include "webrtc/typedefs.h"
@@ -40,7 +40,9 @@ private:
 
     bool _terminate;
 
-    std::list<MemoryType*> _memoryPool;
+    // Used as a stack, so that the most recently returned and thus most likely
+    // cached memory is handed out first, without allocating list nodes.
+    std::vector<MemoryType*> _memoryPool;
 
     uint32_t _initialPoolSize;
     uint32_t _createdMemory;
@@ -84,8 +86,8 @@ int32_t MemoryPoolImpl<MemoryType>::PopMemory(MemoryType*& memory)
             return -1;
         }
     }
-    memory = _memoryPool.front();
-    _memoryPool.pop_front();
+    memory = _memoryPool.back();
+    _memoryPool.pop_back();
     _outstandingMemory++;
     return 0;
 }
@@ -129,8 +131,8 @@ int32_t MemoryPoolImpl<MemoryType>::Terminate()
     // Reclaim all memory.
     while(_createdMemory > 0)
     {
-        MemoryType* memory = _memoryPool.front();
-        _memoryPool.pop_front();
+        MemoryType* memory = _memoryPool.back();
+        _memoryPool.pop_back();
         delete memory;
         _createdMemory--;
     }
@@ -141,6 +143,7 @@ template<class MemoryType>
 int32_t MemoryPoolImpl<MemoryType>::CreateMemory(
     uint32_t amountToCreate)
 {
+    _memoryPool.reserve(_memoryPool.size() + amountToCreate);
     for(uint32_t i = 0; i < amountToCreate; i++)
     {
         MemoryType* memory = new MemoryType();
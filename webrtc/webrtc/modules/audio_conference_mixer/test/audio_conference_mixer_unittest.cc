@@ -8,10 +8,13 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
+
 #include "testing/gmock/include/gmock/gmock.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/audio_conference_mixer/include/audio_conference_mixer.h"
 #include "webrtc/modules/audio_conference_mixer/include/audio_conference_mixer_defines.h"
+#include "webrtc/modules/audio_conference_mixer/source/audio_frame_manipulator.h"
 
 namespace webrtc {
 
@@ -162,4 +165,25 @@ TEST(AudioConferenceMixer, LargestEnergyVadActiveMixed) {
   EXPECT_EQ(0, mixer->UnRegisterMixedStreamCallback());
 }
 
+TEST(AudioFrameManipulator, AddSamplesSaturated) {
+  // Not a multiple of the vector width, so that the scalar tail is tested too.
+  const size_t kLength = 21;
+  int16_t source[kLength];
+  int16_t target[kLength];
+  for (size_t i = 0; i < kLength; ++i) {
+    source[i] = static_cast<int16_t>(i % 3 == 0 ? 30000 : -30000);
+    target[i] = static_cast<int16_t>(i % 2 == 0 ? 10000 : -10000);
+  }
+
+  AddSamplesSaturated(source, kLength, target);
+
+  for (size_t i = 0; i < kLength; ++i) {
+    const int32_t sum = (i % 3 == 0 ? 30000 : -30000) +
+                        (i % 2 == 0 ? 10000 : -10000);
+    const int16_t expected = static_cast<int16_t>(
+        std::max(-32768, std::min(32767, sum)));
+    EXPECT_EQ(expected, target[i]) << "Sample #" << i << " wrong.";
+  }
+}
+
 }  // namespace webrtc
@@ -25,6 +25,7 @@ LOCAL_SRC_FILES := \
     gain_control_impl.cc \
     high_pass_filter_impl.cc \
     level_estimator_impl.cc \
+    multi_stream_audio_processing.cc \
     noise_suppression_impl.cc \
     rms_level.cc \
     splitting_filter.cc \
@@ -239,7 +239,7 @@ AudioProcessingImpl::AudioProcessingImpl(const Config& config,
     public_submodules_->echo_control_mobile =
         new EchoControlMobileImpl(this, &crit_render_, &crit_capture_);
     public_submodules_->gain_control =
-        new GainControlImpl(this, &crit_capture_, &crit_capture_);
+        new GainControlImpl(this, &crit_render_, &crit_capture_);
     public_submodules_->high_pass_filter.reset(
         new HighPassFilterImpl(&crit_capture_));
     public_submodules_->level_estimator.reset(
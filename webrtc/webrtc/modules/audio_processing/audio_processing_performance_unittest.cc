@@ -278,6 +278,16 @@ class TimedThreadApiProcessor {
                                    GetDurationStandardDeviation()),
         "us", false);
 
+    // The jitter and the longest call show how much a thread is stalled by
+    // the processing done on the other thread.
+    webrtc::test::PrintResult("apm_jitter", sample_rate_name, processor_name,
+                              rtc::checked_cast<size_t>(GetDurationJitter()),
+                              "us", false);
+    webrtc::test::PrintResult("apm_max_duration", sample_rate_name,
+                              processor_name,
+                              rtc::checked_cast<size_t>(GetDurationMax()),
+                              "us", false);
+
     if (kPrintAllDurations) {
       std::string value_string = "";
       for (int64_t duration : api_call_durations_) {
@@ -314,6 +324,30 @@ class TimedThreadApiProcessor {
                 : -1);
   }
 
+  // Returns the mean absolute difference between the durations of consecutive
+  // calls.
+  int64_t GetDurationJitter() const {
+    int64_t total_difference = 0;
+    for (size_t k = kNumInitializationFrames + 1;
+         k < api_call_durations_.size(); k++) {
+      const int64_t difference =
+          api_call_durations_[k] - api_call_durations_[k - 1];
+      total_difference += (difference < 0 ? -difference : difference);
+    }
+    const int denominator = rtc::checked_cast<int>(api_call_durations_.size()) -
+                            kNumInitializationFrames - 1;
+    return (denominator > 0 ? total_difference / denominator : 0);
+  }
+
+  int64_t GetDurationMax() const {
+    int64_t max_duration = 0;
+    for (size_t k = kNumInitializationFrames; k < api_call_durations_.size();
+         k++) {
+      max_duration = std::max(max_duration, api_call_durations_[k]);
+    }
+    return max_duration;
+  }
+
   int64_t GetDurationAverage() const {
     int64_t average_duration = 0;
     for (size_t k = kNumInitializationFrames; k < api_call_durations_.size();
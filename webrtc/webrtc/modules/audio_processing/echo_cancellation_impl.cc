@@ -122,7 +122,13 @@ int EchoCancellationImpl::ProcessRenderAudio(const AudioBuffer* audio) {
 
   // Insert the samples into the queue.
   if (!render_signal_queue_->Insert(&render_queue_buffer_)) {
-    // The data queue is full and needs to be emptied.
+    // The data queue is full and needs to be emptied. This is only done if the
+    // capture side is idle, as waiting for it would stall the render thread. If
+    // the capture side is busy, the frame is dropped.
+    rtc::TryCritScope cs_capture(crit_capture_);
+    if (!cs_capture.locked()) {
+      return AudioProcessing::kNoError;
+    }
     ReadQueuedRenderData();
 
     // Retry the insert (should always work).
@@ -0,0 +1,147 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/multi_stream_audio_processing.h"
+
+#include <algorithm>
+
+#include "webrtc/base/checks.h"
+#include "webrtc/modules/include/module_common_types.h"
+
+namespace webrtc {
+
+namespace {
+
+// The time an idle worker waits for work before checking whether it has been
+// stopped.
+const int kWorkerWaitTimeMs = 100;
+
+}  // namespace
+
+MultiStreamAudioProcessing::Worker::Worker(MultiStreamAudioProcessing* parent,
+                                           size_t first_stream,
+                                           size_t last_stream)
+    : parent(parent),
+      first_stream(first_stream),
+      last_stream(last_stream),
+      start_event(false, false),
+      done_event(false, false),
+      thread(&MultiStreamAudioProcessing::WorkerThreadFunc,
+             this,
+             "apm_stream_worker") {}
+
+MultiStreamAudioProcessing::MultiStreamAudioProcessing(size_t num_streams,
+                                                       size_t num_workers,
+                                                       const Config& config)
+    : stream_errors_(num_streams, AudioProcessing::kNoError),
+      first_caller_stream_(0),
+      operation_(Operation::kProcessStream),
+      frames_(nullptr) {
+  streams_.reserve(num_streams);
+  for (size_t i = 0; i < num_streams; ++i) {
+    streams_.push_back(AudioProcessing::Create(config));
+  }
+
+  // There is no point in having more threads than streams.
+  num_workers = std::max<size_t>(1, std::min(num_workers, num_streams));
+
+  // The calling thread processes the last range of streams.
+  for (size_t i = 0; i + 1 < num_workers; ++i) {
+    workers_.push_back(new Worker(this, i * num_streams / num_workers,
+                                  (i + 1) * num_streams / num_workers));
+    workers_.back()->thread.Start();
+  }
+  first_caller_stream_ = (num_workers - 1) * num_streams / num_workers;
+}
+
+MultiStreamAudioProcessing::~MultiStreamAudioProcessing() {
+  for (Worker* worker : workers_) {
+    worker->thread.Stop();
+    delete worker;
+  }
+  for (AudioProcessing* stream : streams_) {
+    delete stream;
+  }
+}
+
+AudioProcessing* MultiStreamAudioProcessing::stream(size_t index) {
+  RTC_DCHECK_LT(index, streams_.size());
+  return streams_[index];
+}
+
+int MultiStreamAudioProcessing::stream_error(size_t index) const {
+  RTC_DCHECK_LT(index, stream_errors_.size());
+  return stream_errors_[index];
+}
+
+int MultiStreamAudioProcessing::ProcessStreams(AudioFrame* const* frames) {
+  return Process(Operation::kProcessStream, frames);
+}
+
+int MultiStreamAudioProcessing::ProcessReverseStreams(
+    AudioFrame* const* frames) {
+  return Process(Operation::kProcessReverseStream, frames);
+}
+
+int MultiStreamAudioProcessing::Process(Operation operation,
+                                        AudioFrame* const* frames) {
+  if (!frames) {
+    return AudioProcessing::kNullPointerError;
+  }
+
+  operation_ = operation;
+  frames_ = frames;
+  for (Worker* worker : workers_) {
+    worker->start_event.Set();
+  }
+  ProcessRange(first_caller_stream_, streams_.size());
+  for (Worker* worker : workers_) {
+    worker->done_event.Wait(rtc::Event::kForever);
+  }
+  frames_ = nullptr;
+
+  for (int error : stream_errors_) {
+    if (error != AudioProcessing::kNoError) {
+      return error;
+    }
+  }
+  return AudioProcessing::kNoError;
+}
+
+void MultiStreamAudioProcessing::ProcessRange(size_t first_stream,
+                                              size_t last_stream) {
+  for (size_t i = first_stream; i < last_stream; ++i) {
+    if (!frames_[i]) {
+      stream_errors_[i] = AudioProcessing::kNullPointerError;
+      continue;
+    }
+    switch (operation_) {
+      case Operation::kProcessStream:
+        stream_errors_[i] = streams_[i]->ProcessStream(frames_[i]);
+        break;
+      case Operation::kProcessReverseStream:
+        stream_errors_[i] = streams_[i]->ProcessReverseStream(frames_[i]);
+        break;
+    }
+  }
+}
+
+bool MultiStreamAudioProcessing::WorkerThreadFunc(void* context) {
+  Worker* worker = static_cast<Worker*>(context);
+  if (!worker->start_event.Wait(kWorkerWaitTimeMs)) {
+    // Return to let the thread check whether it has been stopped.
+    return true;
+  }
+  worker->parent->ProcessRange(worker->first_stream, worker->last_stream);
+  worker->done_event.Set();
+  return true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_AUDIO_PROCESSING_MULTI_STREAM_AUDIO_PROCESSING_H_
+#define WEBRTC_MODULES_AUDIO_PROCESSING_MULTI_STREAM_AUDIO_PROCESSING_H_
+
+#include <vector>
+
+#include "webrtc/base/event.h"
+#include "webrtc/base/platform_thread.h"
+#include "webrtc/modules/audio_processing/include/audio_processing.h"
+
+namespace webrtc {
+
+class AudioFrame;
+
+// Processes a set of independent audio streams, e.g. the participants of a
+// conference on a server, one 10 ms frame per stream at a time. Each stream
+// has its own AudioProcessing instance, which is configured through stream().
+//
+// The streams are split into contiguous ranges, one per worker thread, and a
+// stream is always processed by the same worker. This keeps the state of a
+// stream in the cache of a single core between ticks.
+//
+// All methods must be called from the same thread.
+class MultiStreamAudioProcessing {
+ public:
+  // Creates an engine for |num_streams| streams, whose AudioProcessing
+  // instances are created with |config|. The streams are processed on
+  // |num_workers| threads, including the calling thread.
+  MultiStreamAudioProcessing(size_t num_streams,
+                             size_t num_workers,
+                             const Config& config);
+  ~MultiStreamAudioProcessing();
+
+  size_t num_streams() const { return streams_.size(); }
+  size_t num_workers() const { return workers_.size() + 1; }
+
+  // Returns the AudioProcessing instance of stream |index|, e.g. to enable
+  // its components or to set the stream delay before the next tick.
+  AudioProcessing* stream(size_t index);
+
+  // Runs AudioProcessing::ProcessStream() on every stream, where |frames|
+  // holds one frame for each stream. Returns kNoError if all streams were
+  // processed successfully, and the error of the first failing stream
+  // otherwise.
+  int ProcessStreams(AudioFrame* const* frames);
+
+  // Runs AudioProcessing::ProcessReverseStream() on every stream, where
+  // |frames| holds one frame for each stream.
+  int ProcessReverseStreams(AudioFrame* const* frames);
+
+  // Returns the result of the last call for stream |index|.
+  int stream_error(size_t index) const;
+
+ private:
+  enum class Operation { kProcessStream, kProcessReverseStream };
+
+  // A worker thread, which processes the streams in
+  // [first_stream, last_stream).
+  struct Worker {
+    Worker(MultiStreamAudioProcessing* parent,
+           size_t first_stream,
+           size_t last_stream);
+
+    MultiStreamAudioProcessing* const parent;
+    const size_t first_stream;
+    const size_t last_stream;
+    rtc::Event start_event;
+    rtc::Event done_event;
+    rtc::PlatformThread thread;
+  };
+
+  static bool WorkerThreadFunc(void* context);
+
+  int Process(Operation operation, AudioFrame* const* frames);
+  void ProcessRange(size_t first_stream, size_t last_stream);
+
+  std::vector<AudioProcessing*> streams_;
+  // The results of the last call, one per stream.
+  std::vector<int> stream_errors_;
+  std::vector<Worker*> workers_;
+  // Streams processed on the calling thread.
+  size_t first_caller_stream_;
+
+  // The arguments of the operation that is in progress. They are written
+  // before the workers are started and only read by them.
+  Operation operation_;
+  AudioFrame* const* frames_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(MultiStreamAudioProcessing);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_AUDIO_PROCESSING_MULTI_STREAM_AUDIO_PROCESSING_H_
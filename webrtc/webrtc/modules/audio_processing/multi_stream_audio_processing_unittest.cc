@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/audio_processing/multi_stream_audio_processing.h"
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "webrtc/base/random.h"
+#include "webrtc/base/scoped_ptr.h"
+#include "webrtc/config.h"
+#include "webrtc/modules/audio_processing/include/audio_processing.h"
+#include "webrtc/modules/include/module_common_types.h"
+
+namespace webrtc {
+namespace {
+
+const int kSampleRateHz = 16000;
+const size_t kSamplesPerChannel = kSampleRateHz / 100;
+const int kNumFrames = 50;
+
+void EnableComponents(AudioProcessing* apm) {
+  ASSERT_EQ(AudioProcessing::kNoError,
+            apm->noise_suppression()->Enable(true));
+  ASSERT_EQ(AudioProcessing::kNoError,
+            apm->gain_control()->set_mode(GainControl::kAdaptiveDigital));
+  ASSERT_EQ(AudioProcessing::kNoError, apm->gain_control()->Enable(true));
+}
+
+void FillFrame(Random* random_generator, AudioFrame* frame) {
+  frame->sample_rate_hz_ = kSampleRateHz;
+  frame->num_channels_ = 1;
+  frame->samples_per_channel_ = kSamplesPerChannel;
+  for (size_t i = 0; i < kSamplesPerChannel; ++i) {
+    frame->data_[i] = random_generator->Rand<int16_t>();
+  }
+}
+
+// Verifies that the streams are processed exactly as by separate
+// AudioProcessing instances.
+void RunBitExactnessTest(size_t num_streams, size_t num_workers) {
+  Config config;
+  MultiStreamAudioProcessing engine(num_streams, num_workers, config);
+  ASSERT_EQ(num_streams, engine.num_streams());
+  std::vector<rtc::scoped_ptr<AudioProcessing>> references;
+  for (size_t i = 0; i < num_streams; ++i) {
+    EnableComponents(engine.stream(i));
+    references.push_back(
+        rtc::scoped_ptr<AudioProcessing>(AudioProcessing::Create(config)));
+    EnableComponents(references.back().get());
+  }
+
+  Random random_generator(42U);
+  std::vector<AudioFrame> frames(num_streams);
+  std::vector<AudioFrame> reference_frames(num_streams);
+  std::vector<AudioFrame*> frame_pointers(num_streams);
+  for (int frame = 0; frame < kNumFrames; ++frame) {
+    for (size_t i = 0; i < num_streams; ++i) {
+      FillFrame(&random_generator, &frames[i]);
+      reference_frames[i].CopyFrom(frames[i]);
+      frame_pointers[i] = &frames[i];
+    }
+    ASSERT_EQ(AudioProcessing::kNoError,
+              engine.ProcessStreams(&frame_pointers[0]));
+
+    for (size_t i = 0; i < num_streams; ++i) {
+      EXPECT_EQ(AudioProcessing::kNoError, engine.stream_error(i));
+      ASSERT_EQ(AudioProcessing::kNoError,
+                references[i]->ProcessStream(&reference_frames[i]));
+      for (size_t j = 0; j < kSamplesPerChannel; ++j) {
+        ASSERT_EQ(reference_frames[i].data_[j], frames[i].data_[j]);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(MultiStreamAudioProcessingTest, SingleWorker) {
+  RunBitExactnessTest(5, 1);
+}
+
+TEST(MultiStreamAudioProcessingTest, MultipleWorkers) {
+  RunBitExactnessTest(7, 3);
+}
+
+TEST(MultiStreamAudioProcessingTest, MoreWorkersThanStreams) {
+  RunBitExactnessTest(2, 8);
+}
+
+TEST(MultiStreamAudioProcessingTest, ReportsErrorOfFailingStream) {
+  Config config;
+  MultiStreamAudioProcessing engine(3, 2, config);
+  Random random_generator(42U);
+  AudioFrame frames[3];
+  AudioFrame* frame_pointers[3];
+  for (size_t i = 0; i < 3; ++i) {
+    FillFrame(&random_generator, &frames[i]);
+    frame_pointers[i] = &frames[i];
+  }
+  // An unsupported sample rate fails the second stream only.
+  frames[1].sample_rate_hz_ = 12345;
+  EXPECT_EQ(AudioProcessing::kBadSampleRateError,
+            engine.ProcessStreams(frame_pointers));
+  EXPECT_EQ(AudioProcessing::kNoError, engine.stream_error(0));
+  EXPECT_EQ(AudioProcessing::kBadSampleRateError, engine.stream_error(1));
+  EXPECT_EQ(AudioProcessing::kNoError, engine.stream_error(2));
+}
+
+}  // namespace webrtc
@@ -235,6 +235,7 @@
                 'audio_processing/echo_cancellation_impl_unittest.cc',
                 'audio_processing/intelligibility/intelligibility_enhancer_unittest.cc',
                 'audio_processing/intelligibility/intelligibility_utils_unittest.cc',
+                'audio_processing/multi_stream_audio_processing_unittest.cc',
                 'audio_processing/splitting_filter_unittest.cc',
                 'audio_processing/transient/dyadic_decimator_unittest.cc',
                 'audio_processing/transient/file_utils.cc',
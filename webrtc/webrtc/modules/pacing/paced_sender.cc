@@ -16,6 +16,7 @@
 
 #include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
+#include "webrtc/base/trace_event.h"
 #include "webrtc/modules/include/module_common_types.h"
 #include "webrtc/modules/pacing/bitrate_prober.h"
 #include "webrtc/system_wrappers/include/clock.h"
@@ -30,6 +31,11 @@ const int64_t kMinPacketLimitMs = 5;
 // time.
 const int64_t kMaxIntervalTimeMs = 30;
 
+// Identifies a packet's queueing span in traces.
+uint64_t PacketTraceId(uint32_t ssrc, uint16_t sequence_number) {
+  return (static_cast<uint64_t>(ssrc) << 16) | sequence_number;
+}
+
 }  // namespace
 
 // TODO(sprang): Move at least PacketQueue and MediaBudget out to separate
@@ -259,6 +265,8 @@ PacedSender::PacedSender(Clock* clock,
       bitrate_bps_(1000 * bitrate_kbps),
       max_bitrate_kbps_(max_bitrate_kbps),
       time_last_update_us_(clock->TimeInMicroseconds()),
+      process_interval_ms_(kMinPacketLimitMs),
+      burst_started_(false),
       packets_(new paced_sender::PacketQueue(clock)),
       packet_counter_(0) {
   UpdateBytesPerInterval(kMinPacketLimitMs);
@@ -281,6 +289,12 @@ void PacedSender::SetProbingEnabled(bool enabled) {
   probing_enabled_ = enabled;
 }
 
+void PacedSender::SetProcessIntervalMs(int64_t interval_ms) {
+  CriticalSectionScoped cs(critsect_.get());
+  process_interval_ms_ =
+      std::min(kMaxIntervalTimeMs, std::max(kMinPacketLimitMs, interval_ms));
+}
+
 void PacedSender::UpdateBitrate(int bitrate_kbps,
                                 int max_bitrate_kbps,
                                 int min_bitrate_kbps) {
@@ -309,6 +323,8 @@ void PacedSender::InsertPacket(RtpPacketSender::Priority priority,
   if (capture_time_ms < 0)
     capture_time_ms = now_ms;
 
+  TRACE_EVENT_ASYNC_BEGIN1("webrtc", "PacedSender::Queued",
+                           PacketTraceId(ssrc, sequence_number), "ssrc", ssrc);
   packets_->Push(paced_sender::Packet(priority, ssrc, sequence_number,
                                       capture_time_ms, now_ms, bytes,
                                       retransmission, packet_counter_++));
@@ -341,6 +357,11 @@ int64_t PacedSender::AverageQueueTimeMs() {
   return packets_->AverageQueueTimeMs();
 }
 
+PacedSender::Stats PacedSender::GetStats() const {
+  CriticalSectionScoped cs(critsect_.get());
+  return stats_;
+}
+
 int64_t PacedSender::TimeUntilNextProcess() {
   CriticalSectionScoped cs(critsect_.get());
   if (prober_->IsProbing()) {
@@ -350,14 +371,17 @@ int64_t PacedSender::TimeUntilNextProcess() {
   }
   int64_t elapsed_time_us = clock_->TimeInMicroseconds() - time_last_update_us_;
   int64_t elapsed_time_ms = (elapsed_time_us + 500) / 1000;
-  return std::max<int64_t>(kMinPacketLimitMs - elapsed_time_ms, 0);
+  return std::max<int64_t>(process_interval_ms_ - elapsed_time_ms, 0);
 }
 
 int32_t PacedSender::Process() {
+  TRACE_EVENT0("webrtc", "PacedSender::Process");
   int64_t now_us = clock_->TimeInMicroseconds();
   CriticalSectionScoped cs(critsect_.get());
   int64_t elapsed_time_ms = (now_us - time_last_update_us_ + 500) / 1000;
   time_last_update_us_ = now_us;
+  ++stats_.process_calls;
+  burst_started_ = false;
   int target_bitrate_kbps = max_bitrate_kbps_;
   // TODO(holmer): Remove the !paused_ check when issue 5307 has been fixed.
   if (!paused_ && elapsed_time_ms > 0) {
@@ -430,6 +454,16 @@ bool PacedSender::SendPacket(const paced_sender::Packet& packet) {
                                                    packet.retransmission);
   critsect_->Enter();
 
+  if (success) {
+    TRACE_EVENT_ASYNC_END0("webrtc", "PacedSender::Queued",
+                           PacketTraceId(packet.ssrc, packet.sequence_number));
+    ++stats_.packets_sent;
+    if (!burst_started_) {
+      burst_started_ = true;
+      ++stats_.bursts;
+    }
+  }
+
   // TODO(holmer): High priority packets should only be accounted for if we are
   // allocating bandwidth for audio.
   if (success && packet.priority != kHighPriority) {
@@ -67,6 +67,17 @@ class PacedSender : public Module, public RtpPacketSender {
 
   static const size_t kMinProbePacketSize = 200;
 
+  struct Stats {
+    Stats() : process_calls(0), bursts(0), packets_sent(0) {}
+
+    // Number of Process() calls, i.e. wakeups of the pacer thread.
+    uint64_t process_calls;
+    // Number of Process() calls that sent at least one packet.
+    uint64_t bursts;
+    // Number of packets sent, not counting padding.
+    uint64_t packets_sent;
+  };
+
   PacedSender(Clock* clock,
               Callback* callback,
               int bitrate_kbps,
@@ -86,6 +97,12 @@ class PacedSender : public Module, public RtpPacketSender {
   // effect.
   void SetProbingEnabled(bool enabled);
 
+  // Sets the time between two Process() calls, 5 ms by default. A longer
+  // interval wakes the pacer thread less often and sends the queued packets
+  // in larger bursts, which suits senders with many streams. The interval is
+  // capped at 30 ms.
+  void SetProcessIntervalMs(int64_t interval_ms);
+
   // Set target bitrates for the pacer.
   // We will pace out bursts of packets at a bitrate of |max_bitrate_kbps|.
   // |bitrate_kbps| is our estimate of what we are allowed to send on average.
@@ -117,6 +134,9 @@ class PacedSender : public Module, public RtpPacketSender {
   // packets currently in the pacer queue, or 0 if queue is empty.
   virtual int64_t AverageQueueTimeMs();
 
+  // Returns the number of wakeups and of packets sent so far.
+  Stats GetStats() const;
+
   // Returns the number of milliseconds until the module want a worker thread
   // to call Process.
   int64_t TimeUntilNextProcess() override;
@@ -156,6 +176,10 @@ class PacedSender : public Module, public RtpPacketSender {
   int max_bitrate_kbps_ GUARDED_BY(critsect_);
 
   int64_t time_last_update_us_ GUARDED_BY(critsect_);
+  int64_t process_interval_ms_ GUARDED_BY(critsect_);
+  Stats stats_ GUARDED_BY(critsect_);
+  // True once the current Process() call has sent a packet.
+  bool burst_started_ GUARDED_BY(critsect_);
 
   rtc::scoped_ptr<paced_sender::PacketQueue> packets_ GUARDED_BY(critsect_);
   uint64_t packet_counter_;
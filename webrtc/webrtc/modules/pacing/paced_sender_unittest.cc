@@ -252,6 +252,44 @@ TEST_F(PacedSenderTest, PaceQueuedPackets) {
   send_bucket_->Process();
 }
 
+
+TEST_F(PacedSenderTest, LongProcessIntervalSendsBursts) {
+  uint32_t ssrc = 12345;
+  uint16_t sequence_number = 1234;
+
+  send_bucket_->SetProcessIntervalMs(20);
+  for (int i = 0; i < 48; ++i) {
+    send_bucket_->InsertPacket(PacedSender::kNormalPriority, ssrc,
+                               sequence_number++, clock_.TimeInMilliseconds(),
+                               250, false);
+  }
+  EXPECT_CALL(callback_, TimeToSendPadding(_)).Times(0);
+  // The initial budget covers a 5 ms interval.
+  EXPECT_CALL(callback_, TimeToSendPacket(ssrc, _, _, false))
+      .Times(3)
+      .WillRepeatedly(Return(true));
+  EXPECT_EQ(0, send_bucket_->Process());
+  for (int k = 0; k < 3; ++k) {
+    EXPECT_EQ(20, send_bucket_->TimeUntilNextProcess());
+    clock_.AdvanceTimeMilliseconds(20);
+    // Each wakeup sends the budget of 20 ms in one burst.
+    EXPECT_CALL(callback_, TimeToSendPacket(ssrc, _, _, false))
+        .Times(12)
+        .WillRepeatedly(Return(true));
+    EXPECT_EQ(0, send_bucket_->TimeUntilNextProcess());
+    EXPECT_EQ(0, send_bucket_->Process());
+  }
+
+  PacedSender::Stats stats = send_bucket_->GetStats();
+  EXPECT_EQ(4u, stats.process_calls);
+  EXPECT_EQ(4u, stats.bursts);
+  EXPECT_EQ(39u, stats.packets_sent);
+  EXPECT_EQ(9u, send_bucket_->QueueSizePackets());
+
+  // The interval is capped.
+  send_bucket_->SetProcessIntervalMs(100);
+  EXPECT_EQ(30, send_bucket_->TimeUntilNextProcess());
+}
 TEST_F(PacedSenderTest, PaceQueuedPacketsWithDuplicates) {
   uint32_t ssrc = 12345;
   uint16_t sequence_number = 1234;
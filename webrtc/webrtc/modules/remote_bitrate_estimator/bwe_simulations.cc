@@ -11,10 +11,14 @@
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/base/scoped_ptr.h"
 #include "webrtc/modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
+#include "webrtc/modules/remote_bitrate_estimator/remote_bitrate_estimator_abs_send_time.h"
+#include "webrtc/modules/remote_bitrate_estimator/remote_bitrate_estimator_single_stream.h"
+#include "webrtc/modules/remote_bitrate_estimator/remote_bitrate_estimator_unittest_helper.h"
 #include "webrtc/modules/remote_bitrate_estimator/test/bwe_test.h"
 #include "webrtc/modules/remote_bitrate_estimator/test/packet_receiver.h"
 #include "webrtc/modules/remote_bitrate_estimator/test/packet_sender.h"
 #include "webrtc/test/testsupport/fileutils.h"
+#include "webrtc/test/testsupport/perf_test.h"
 
 
 namespace webrtc {
@@ -444,6 +448,97 @@ TEST_P(BweSimulation, GccComparisonChoke) {
 }
 
 #endif  // BWE_TEST_LOGGING_COMPILE_TIME_ENABLE
+
+// Measures the CPU cost of the receive-side estimators when many streams are
+// received at once, both one packet at a time and in bursts through
+// IncomingPackets(). The result is reported in packets per second.
+class ReceiveSideThroughput : public ::testing::Test {
+ protected:
+  static const int kNumSsrcs = 1000;
+  static const int kPacketsPerSsrc = 50;
+  static const size_t kBurstSize = 32;
+  static const size_t kPayloadSize = 1200;
+
+  ReceiveSideThroughput() : clock_(0) {
+    headers_.reserve(kNumSsrcs * kPacketsPerSsrc);
+    arrival_times_ms_.reserve(kNumSsrcs * kPacketsPerSsrc);
+    // Each stream sends a 30 fps frame in one packet; the streams are
+    // interleaved the way a busy SFU would see them.
+    for (int i = 0; i < kPacketsPerSsrc; ++i) {
+      for (int ssrc = 0; ssrc < kNumSsrcs; ++ssrc) {
+        int64_t send_time_us = i * 33333 + ssrc;
+        RTPHeader header;
+        header.ssrc = 0x10000 + ssrc;
+        header.timestamp = static_cast<uint32_t>(send_time_us * 90 / 1000);
+        header.extension.hasTransmissionTimeOffset = true;
+        header.extension.transmissionTimeOffset = 0;
+        header.extension.hasAbsoluteSendTime = true;
+        // 6.18 fixed point seconds, wrapping at 64 s.
+        header.extension.absoluteSendTime = static_cast<uint32_t>(
+            ((send_time_us << 18) / 1000000) & 0x00ffffff);
+        headers_.push_back(header);
+        arrival_times_ms_.push_back(send_time_us / 1000 + 50);
+      }
+    }
+  }
+
+  void Run(RemoteBitrateEstimator* estimator,
+           const std::string& trace,
+           bool batched) {
+    const size_t num_packets = headers_.size();
+    std::vector<IncomingRtpPacket> burst;
+    burst.reserve(kBurstSize);
+    int64_t start_us = Clock::GetRealTimeClock()->TimeInMicroseconds();
+    for (size_t i = 0; i < num_packets; ++i) {
+      clock_.AdvanceTimeMilliseconds(arrival_times_ms_[i] -
+                                     clock_.TimeInMilliseconds());
+      if (!batched) {
+        estimator->IncomingPacket(arrival_times_ms_[i], kPayloadSize,
+                                  headers_[i], true);
+        continue;
+      }
+      burst.push_back(IncomingRtpPacket(arrival_times_ms_[i], kPayloadSize,
+                                        &headers_[i], true));
+      if (burst.size() == kBurstSize || i + 1 == num_packets) {
+        estimator->IncomingPackets(burst);
+        burst.clear();
+      }
+    }
+    int64_t elapsed_us =
+        Clock::GetRealTimeClock()->TimeInMicroseconds() - start_us;
+    if (elapsed_us <= 0)
+      elapsed_us = 1;
+    webrtc::test::PrintResult(
+        "bwe_receive_throughput", batched ? "_batched" : "_per_packet", trace,
+        static_cast<size_t>(num_packets * 1000000 / elapsed_us), "packets/s",
+        false);
+  }
+
+  SimulatedClock clock_;
+  TestBitrateObserver observer_;
+  std::vector<RTPHeader> headers_;
+  std::vector<int64_t> arrival_times_ms_;
+};
+
+TEST_F(ReceiveSideThroughput, AbsSendTime) {
+  RemoteBitrateEstimatorAbsSendTime per_packet(&observer_, &clock_);
+  Run(&per_packet, "abs_send_time", false);
+}
+
+TEST_F(ReceiveSideThroughput, AbsSendTimeBatched) {
+  RemoteBitrateEstimatorAbsSendTime batched(&observer_, &clock_);
+  Run(&batched, "abs_send_time", true);
+}
+
+TEST_F(ReceiveSideThroughput, SingleStream) {
+  RemoteBitrateEstimatorSingleStream per_packet(&observer_, &clock_);
+  Run(&per_packet, "single_stream", false);
+}
+
+TEST_F(ReceiveSideThroughput, SingleStreamBatched) {
+  RemoteBitrateEstimatorSingleStream batched(&observer_, &clock_);
+  Run(&batched, "single_stream", true);
+}
 }  // namespace bwe
 }  // namespace testing
 }  // namespace webrtc
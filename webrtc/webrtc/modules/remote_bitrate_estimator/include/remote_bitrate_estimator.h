@@ -59,6 +59,24 @@ struct ReceiveBandwidthEstimatorStats {
   std::vector<int64_t> recent_arrival_time_ms;
 };
 
+// An incoming RTP packet, as passed to RemoteBitrateEstimator::IncomingPacket().
+struct IncomingRtpPacket {
+  IncomingRtpPacket(int64_t arrival_time_ms,
+                    size_t payload_size,
+                    const RTPHeader* header,
+                    bool was_paced)
+      : arrival_time_ms(arrival_time_ms),
+        payload_size(payload_size),
+        header(header),
+        was_paced(was_paced) {}
+
+  int64_t arrival_time_ms;
+  size_t payload_size;
+  // Not owned. Must outlive the IncomingPackets() call.
+  const RTPHeader* header;
+  bool was_paced;
+};
+
 class RemoteBitrateEstimator : public CallStatsObserver, public Module {
  public:
   static const int kDefaultMinBitrateBps = 30000;
@@ -79,6 +97,16 @@ class RemoteBitrateEstimator : public CallStatsObserver, public Module {
                               const RTPHeader& header,
                               bool was_paced) = 0;
 
+  // Called for a burst of incoming packets, in arrival order. Has the same
+  // effect as calling IncomingPacket() for each of them, but implementations
+  // may process the whole burst at once, e.g. under a single lock.
+  virtual void IncomingPackets(const std::vector<IncomingRtpPacket>& packets) {
+    for (const IncomingRtpPacket& packet : packets) {
+      IncomingPacket(packet.arrival_time_ms, packet.payload_size,
+                     *packet.header, packet.was_paced);
+    }
+  }
+
   // Removes all data for |ssrc|.
   virtual void RemoveStream(unsigned int ssrc) = 0;
 
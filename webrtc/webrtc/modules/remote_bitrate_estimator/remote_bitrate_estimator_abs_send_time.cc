@@ -56,16 +56,22 @@ static void RemoveStaleEntries(
 }
 
 template<typename K, typename V>
-std::vector<K> Keys(const std::map<K, V>& map) {
+std::vector<K> Keys(const std::vector<std::pair<K, V>>& map) {
   std::vector<K> keys;
   keys.reserve(map.size());
-  for (typename std::map<K, V>::const_iterator it = map.begin();
+  for (typename std::vector<std::pair<K, V>>::const_iterator it = map.begin();
       it != map.end(); ++it) {
     keys.push_back(it->first);
   }
   return keys;
 }
 
+// Orders SSRC entries by SSRC, for searching a sorted vector of them.
+template<typename K, typename V>
+bool KeyLess(const std::pair<K, V>& entry, K key) {
+  return entry.first < key;
+}
+
 uint32_t ConvertMsTo24Bits(int64_t time_ms) {
   uint32_t time_24_bits =
       static_cast<uint32_t>(
@@ -105,6 +111,7 @@ bool RemoteBitrateEstimatorAbsSendTime::IsWithinClusterBounds(
         observer_(observer),
         clock_(clock),
         ssrcs_(),
+        last_ssrc_index_(0),
         inter_arrival_(),
         estimator_(OverUseDetectorOptions()),
         detector_(OverUseDetectorOptions()),
@@ -229,10 +236,13 @@ bool RemoteBitrateEstimatorAbsSendTime::IsBitrateImproving(
 
 void RemoteBitrateEstimatorAbsSendTime::IncomingPacketFeedbackVector(
     const std::vector<PacketInfo>& packet_feedback_vector) {
+  CriticalSectionScoped cs(crit_sect_.get());
+  const int64_t now_ms = clock_->TimeInMilliseconds();
   for (const auto& packet_info : packet_feedback_vector) {
     IncomingPacketInfo(packet_info.arrival_time_ms,
                        ConvertMsTo24Bits(packet_info.send_time_ms),
-                       packet_info.payload_size, 0, packet_info.was_paced);
+                       packet_info.payload_size, 0, packet_info.was_paced,
+                       now_ms);
   }
 }
 
@@ -245,8 +255,43 @@ void RemoteBitrateEstimatorAbsSendTime::IncomingPacket(int64_t arrival_time_ms,
                        "is missing absolute send time extension!";
     return;
   }
+  CriticalSectionScoped cs(crit_sect_.get());
   IncomingPacketInfo(arrival_time_ms, header.extension.absoluteSendTime,
-                     payload_size, header.ssrc, was_paced);
+                     payload_size, header.ssrc, was_paced,
+                     clock_->TimeInMilliseconds());
+}
+
+void RemoteBitrateEstimatorAbsSendTime::IncomingPackets(
+    const std::vector<IncomingRtpPacket>& packets) {
+  CriticalSectionScoped cs(crit_sect_.get());
+  const int64_t now_ms = clock_->TimeInMilliseconds();
+  for (const IncomingRtpPacket& packet : packets) {
+    if (!packet.header->extension.hasAbsoluteSendTime) {
+      LOG(LS_WARNING) << "RemoteBitrateEstimatorAbsSendTimeImpl: Incoming "
+                         "packet is missing absolute send time extension!";
+      continue;
+    }
+    IncomingPacketInfo(packet.arrival_time_ms,
+                       packet.header->extension.absoluteSendTime,
+                       packet.payload_size, packet.header->ssrc,
+                       packet.was_paced, now_ms);
+  }
+}
+
+void RemoteBitrateEstimatorAbsSendTime::UpdateSsrc(unsigned int ssrc,
+                                                   int64_t now_ms) {
+  if (last_ssrc_index_ < ssrcs_.size() &&
+      ssrcs_[last_ssrc_index_].first == ssrc) {
+    ssrcs_[last_ssrc_index_].second = now_ms;
+    return;
+  }
+  Ssrcs::iterator it = std::lower_bound(ssrcs_.begin(), ssrcs_.end(), ssrc,
+                                        KeyLess<unsigned int, int64_t>);
+  if (it == ssrcs_.end() || it->first != ssrc)
+    it = ssrcs_.insert(it, std::make_pair(ssrc, now_ms));
+  else
+    it->second = now_ms;
+  last_ssrc_index_ = it - ssrcs_.begin();
 }
 
 void RemoteBitrateEstimatorAbsSendTime::IncomingPacketInfo(
@@ -254,23 +299,22 @@ void RemoteBitrateEstimatorAbsSendTime::IncomingPacketInfo(
     uint32_t send_time_24bits,
     size_t payload_size,
     uint32_t ssrc,
-    bool was_paced) {
+    bool was_paced,
+    int64_t now_ms) {
   assert(send_time_24bits < (1ul << 24));
   // Shift up send time to use the full 32 bits that inter_arrival works with,
   // so wrapping works properly.
   uint32_t timestamp = send_time_24bits << kAbsSendTimeInterArrivalUpshift;
   int64_t send_time_ms = static_cast<int64_t>(timestamp) * kTimestampToMs;
 
-  CriticalSectionScoped cs(crit_sect_.get());
-  int64_t now_ms = clock_->TimeInMilliseconds();
   // TODO(holmer): SSRCs are only needed for REMB, should be broken out from
   // here.
-  ssrcs_[ssrc] = now_ms;
+  UpdateSsrc(ssrc, now_ms);
   incoming_bitrate_.Update(payload_size, now_ms);
   const BandwidthUsage prior_state = detector_.State();
 
   if (first_packet_time_ms_ == -1)
-    first_packet_time_ms_ = clock_->TimeInMilliseconds();
+    first_packet_time_ms_ = now_ms;
 
   uint32_t ts_delta = 0;
   int64_t t_delta = 0;
@@ -352,13 +396,12 @@ void RemoteBitrateEstimatorAbsSendTime::UpdateEstimate(int64_t now_ms) {
     // No packets have been received on the active streams.
     return;
   }
-  for (Ssrcs::iterator it = ssrcs_.begin(); it != ssrcs_.end();) {
-    if ((now_ms - it->second) > kStreamTimeOutMs) {
-      ssrcs_.erase(it++);
-    } else {
-      ++it;
-    }
+  Ssrcs::iterator last_active = ssrcs_.begin();
+  for (Ssrcs::iterator it = ssrcs_.begin(); it != ssrcs_.end(); ++it) {
+    if ((now_ms - it->second) <= kStreamTimeOutMs)
+      *last_active++ = *it;
   }
+  ssrcs_.erase(last_active, ssrcs_.end());
   if (ssrcs_.empty()) {
     // We can't update the estimate if we don't have any active streams.
     inter_arrival_.reset();
@@ -386,7 +429,10 @@ void RemoteBitrateEstimatorAbsSendTime::OnRttUpdate(int64_t avg_rtt_ms,
 
 void RemoteBitrateEstimatorAbsSendTime::RemoveStream(unsigned int ssrc) {
   CriticalSectionScoped cs(crit_sect_.get());
-  ssrcs_.erase(ssrc);
+  Ssrcs::iterator it = std::lower_bound(ssrcs_.begin(), ssrcs_.end(), ssrc,
+                                        KeyLess<unsigned int, int64_t>);
+  if (it != ssrcs_.end() && it->first == ssrc)
+    ssrcs_.erase(it);
 }
 
 bool RemoteBitrateEstimatorAbsSendTime::LatestEstimate(
@@ -12,7 +12,7 @@
 #define WEBRTC_MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_BITRATE_ESTIMATOR_ABS_SEND_TIME_H_
 
 #include <list>
-#include <map>
+#include <utility>
 #include <vector>
 
 #include "webrtc/base/checks.h"
@@ -76,6 +76,7 @@ class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
                       size_t payload_size,
                       const RTPHeader& header,
                       bool was_paced) override;
+  void IncomingPackets(const std::vector<IncomingRtpPacket>& packets) override;
   // This class relies on Process() being called periodically (at least once
   // every other second) for streams to be timed out properly. Therefore it
   // shouldn't be detached from the ProcessThread except if it's about to be
@@ -90,7 +91,10 @@ class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
   void SetMinBitrate(int min_bitrate_bps) override;
 
  private:
-  typedef std::map<unsigned int, int64_t> Ssrcs;
+  // The time of the last packet of each SSRC, sorted by SSRC. A flat vector
+  // keeps the per-packet lookup cache friendly even with thousands of SSRCs.
+  // New SSRCs, which need an insertion, are rare.
+  typedef std::vector<std::pair<unsigned int, int64_t>> Ssrcs;
 
   static bool IsWithinClusterBounds(int send_delta_ms,
                                     const Cluster& cluster_aggregate);
@@ -99,11 +103,19 @@ class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
 
   int Id() const;
 
+  // Processes one packet. The caller holds |crit_sect_| and has read the
+  // clock, so that a burst of packets can share both.
   void IncomingPacketInfo(int64_t arrival_time_ms,
                           uint32_t send_time_24bits,
                           size_t payload_size,
                           uint32_t ssrc,
-                          bool was_paced);
+                          bool was_paced,
+                          int64_t now_ms)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
+
+  // Records that |ssrc| received a packet at |now_ms|.
+  void UpdateSsrc(unsigned int ssrc, int64_t now_ms)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
 
   bool IsProbe(int64_t send_time_ms, int payload_size) const
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
@@ -131,6 +143,9 @@ class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
   RemoteBitrateObserver* observer_ GUARDED_BY(crit_sect_.get());
   Clock* clock_;
   Ssrcs ssrcs_ GUARDED_BY(crit_sect_.get());
+  // Index in |ssrcs_| of the SSRC of the previous packet. Consecutive packets
+  // usually belong to the same stream, so this is checked before searching.
+  size_t last_ssrc_index_ GUARDED_BY(crit_sect_.get());
   rtc::scoped_ptr<InterArrival> inter_arrival_ GUARDED_BY(crit_sect_.get());
   OveruseEstimator estimator_ GUARDED_BY(crit_sect_.get());
   OveruseDetector detector_ GUARDED_BY(crit_sect_.get());
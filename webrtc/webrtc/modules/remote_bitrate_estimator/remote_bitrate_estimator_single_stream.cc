@@ -71,11 +71,29 @@ void RemoteBitrateEstimatorSingleStream::IncomingPacket(int64_t arrival_time_ms,
                                                         size_t payload_size,
                                                         const RTPHeader& header,
                                                         bool was_paced) {
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  CriticalSectionScoped cs(crit_sect_.get());
+  IncomingPacketInfo(arrival_time_ms, payload_size, header, now_ms);
+}
+
+void RemoteBitrateEstimatorSingleStream::IncomingPackets(
+    const std::vector<IncomingRtpPacket>& packets) {
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  CriticalSectionScoped cs(crit_sect_.get());
+  for (const IncomingRtpPacket& packet : packets) {
+    IncomingPacketInfo(packet.arrival_time_ms, packet.payload_size,
+                       *packet.header, now_ms);
+  }
+}
+
+void RemoteBitrateEstimatorSingleStream::IncomingPacketInfo(
+    int64_t arrival_time_ms,
+    size_t payload_size,
+    const RTPHeader& header,
+    int64_t now_ms) {
   uint32_t ssrc = header.ssrc;
   uint32_t rtp_timestamp = header.timestamp +
       header.extension.transmissionTimeOffset;
-  int64_t now_ms = clock_->TimeInMilliseconds();
-  CriticalSectionScoped cs(crit_sect_.get());
   SsrcOveruseEstimatorMap::iterator it = overuse_detectors_.find(ssrc);
   if (it == overuse_detectors_.end()) {
     // This is a new SSRC. Adding to map.
@@ -31,6 +31,7 @@ class RemoteBitrateEstimatorSingleStream : public RemoteBitrateEstimator {
                       size_t payload_size,
                       const RTPHeader& header,
                       bool was_paced) override;
+  void IncomingPackets(const std::vector<IncomingRtpPacket>& packets) override;
   int32_t Process() override;
   int64_t TimeUntilNextProcess() override;
   void OnRttUpdate(int64_t avg_rtt_ms, int64_t max_rtt_ms) override;
@@ -45,6 +46,14 @@ class RemoteBitrateEstimatorSingleStream : public RemoteBitrateEstimator {
 
   typedef std::map<unsigned int, Detector*> SsrcOveruseEstimatorMap;
 
+  // Processes one packet. The caller holds |crit_sect_| and has read the
+  // clock, so that a burst of packets can share both.
+  void IncomingPacketInfo(int64_t arrival_time_ms,
+                          size_t payload_size,
+                          const RTPHeader& header,
+                          int64_t now_ms)
+      EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
+
   // Triggers a new estimate calculation.
   void UpdateEstimate(int64_t time_now)
       EXCLUSIVE_LOCKS_REQUIRED(crit_sect_.get());
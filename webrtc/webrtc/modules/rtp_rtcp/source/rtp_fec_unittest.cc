@@ -12,6 +12,7 @@
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "webrtc/base/random.h"
+#include "webrtc/base/timeutils.h"
 #include "webrtc/modules/rtp_rtcp/source/byte_io.h"
 #include "webrtc/modules/rtp_rtcp/source/forward_error_correction.h"
 
@@ -798,6 +799,51 @@ TEST_F(RtpFecTest, FecRecoveryNonConsecutivePacketsWrap) {
   EXPECT_FALSE(IsRecoveryComplete());
 }
 
+// Encodes and decodes the largest group that FEC can protect, to measure the
+// throughput of the XOR kernels.
+TEST_F(RtpFecTest, FecRecoveryMaxMediaPacketsPerformance) {
+  const int kNumImportantPackets = 0;
+  const bool kUseUnequalProtection = false;
+  const int kNumMediaPackets = kMaxNumberMediaPackets;
+  const uint8_t kProtectionFactor = 255;
+  const int kNumIterations = 100;
+
+  fec_seq_num_ = ConstructMediaPackets(kNumMediaPackets);
+
+  uint64_t encode_time_ns = 0;
+  uint64_t decode_time_ns = 0;
+  for (int i = 0; i < kNumIterations; ++i) {
+    fec_packet_list_.clear();
+    uint64_t start_ns = rtc::TimeNanos();
+    EXPECT_EQ(0, fec_->GenerateFEC(media_packet_list_, kProtectionFactor,
+                                   kNumImportantPackets, kUseUnequalProtection,
+                                   webrtc::kFecMaskRandom, &fec_packet_list_));
+    encode_time_ns += rtc::TimeNanos() - start_ns;
+
+    // Lose a few media packets spread over the group.
+    memset(media_loss_mask_, 0, sizeof(media_loss_mask_));
+    memset(fec_loss_mask_, 0, sizeof(fec_loss_mask_));
+    media_loss_mask_[1] = 1;
+    media_loss_mask_[10] = 1;
+    media_loss_mask_[19] = 1;
+    media_loss_mask_[33] = 1;
+    media_loss_mask_[46] = 1;
+    NetworkReceivedPackets();
+
+    start_ns = rtc::TimeNanos();
+    EXPECT_EQ(0, fec_->DecodeFEC(&received_packet_list_,
+                                 &recovered_packet_list_));
+    decode_time_ns += rtc::TimeNanos() - start_ns;
+
+    EXPECT_TRUE(IsRecoveryComplete());
+    fec_->ResetState(&recovered_packet_list_);
+  }
+  printf("FEC with %d media packets: %.1f us to encode, %.1f us to decode\n",
+         kNumMediaPackets,
+         encode_time_ns / (1000.0 * kNumIterations),
+         decode_time_ns / (1000.0 * kNumIterations));
+}
+
 void RtpFecTest::TearDown() {
   fec_->ResetState(&recovered_packet_list_);
   delete fec_;
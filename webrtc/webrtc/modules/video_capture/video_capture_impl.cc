@@ -258,8 +258,6 @@ int32_t VideoCaptureImpl::IncomingFrame(
             return -1;
         }
 
-        int stride_y = width;
-        int stride_uv = (width + 1) / 2;
         int target_width = width;
         int target_height = height;
 
@@ -275,21 +273,19 @@ int32_t VideoCaptureImpl::IncomingFrame(
           }
         }
 
-        // TODO(mikhal): Update correct aligned stride values.
-        //Calc16ByteAlignedStride(target_width, &stride_y, &stride_uv);
-        // Setting absolute height (in case it was negative).
-        // In Windows, the image starts bottom left, instead of top left.
-        // Setting a negative source height, inverts the image (within LibYuv).
-        int ret = _captureFrame.CreateEmptyFrame(target_width,
-                                                 abs(target_height),
-                                                 stride_y,
-                                                 stride_uv, stride_uv);
-        if (ret < 0)
+        if (target_width <= 0 || target_height == 0)
         {
-            LOG(LS_ERROR) << "Failed to create empty frame, this should only "
-                             "happen due to bad parameters.";
+            LOG(LS_ERROR) << "Invalid capture frame size " << target_width
+                          << "x" << target_height << ".";
             return -1;
         }
+        // Setting absolute height (in case it was negative).
+        // In Windows, the image starts bottom left, instead of top left.
+        // Setting a negative source height, inverts the image (within LibYuv).
+        // The buffer comes from a pool, since the frames delivered earlier
+        // are usually still referenced by the encoder or a renderer.
+        _captureFrame.set_video_frame_buffer(
+            buffer_pool_.CreateBuffer(target_width, abs(target_height)));
         const int conversionResult = ConvertToI420(
             commonVideoType, videoFrame, 0, 0,  // No cropping
             width, height, videoFrameLength,
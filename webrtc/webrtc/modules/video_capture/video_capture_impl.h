@@ -15,6 +15,7 @@
  * video_capture_impl.h
  */
 
+#include "webrtc/common_video/include/i420_buffer_pool.h"
 #include "webrtc/common_video/libyuv/include/webrtc_libyuv.h"
 #include "webrtc/common_video/rotation.h"
 #include "webrtc/modules/video_capture/video_capture.h"
@@ -133,6 +134,8 @@ private:
                                  // capture module.
 
     VideoFrame _captureFrame;
+    // Provides the buffers of |_captureFrame|.
+    I420BufferPool buffer_pool_;
 
     // Indicate whether rotation should be applied before delivered externally.
     bool apply_rotation_;
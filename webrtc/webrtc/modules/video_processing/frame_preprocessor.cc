@@ -10,10 +10,21 @@
 
 #include "webrtc/modules/video_processing/frame_preprocessor.h"
 
+#include <algorithm>
+
 #include "webrtc/modules/video_processing/video_denoiser.h"
+#include "webrtc/system_wrappers/include/cpu_info.h"
 
 namespace webrtc {
 
+namespace {
+
+// The largest number of threads used by the denoiser. Large frames are split
+// into this many bands, or one per core on machines with fewer cores.
+const uint32_t kMaxDenoiserThreads = 4;
+
+}  // namespace
+
 VPMFramePreprocessor::VPMFramePreprocessor()
     : content_metrics_(nullptr),
       resampled_frame_(),
@@ -95,7 +106,8 @@ uint32_t VPMFramePreprocessor::GetDecimatedHeight() const {
 }
 
 void VPMFramePreprocessor::EnableDenosing(bool enable) {
-  denoiser_.reset(new VideoDenoiser(true));
+  denoiser_.reset(new VideoDenoiser(
+      true, std::min(CpuInfo::DetectNumberOfCores(), kMaxDenoiserThreads)));
 }
 
 const VideoFrame* VPMFramePreprocessor::PreprocessFrame(
@@ -153,4 +153,27 @@ TEST_F(VideoProcessingTest, Denoiser) {
   ASSERT_NE(0, feof(source_file_)) << "Error reading source file";
 }
 
+TEST_F(VideoProcessingTest, MultiThreadedDenoiser) {
+  // A CIF frame has 18 macroblock rows, enough for two bands.
+  VideoDenoiser denoiser(true);
+  VideoDenoiser denoiser_two_threads(true, 2);
+  VideoFrame denoised_frame;
+  VideoFrame denoised_frame_two_threads;
+
+  rtc::scoped_ptr<uint8_t[]> video_buffer(new uint8_t[frame_length_]);
+  while (fread(video_buffer.get(), 1, frame_length_, source_file_) ==
+         frame_length_) {
+    EXPECT_EQ(0, ConvertToI420(kI420, video_buffer.get(), 0, 0, width_, height_,
+                               0, kVideoRotation_0, &video_frame_));
+
+    denoiser.DenoiseFrame(video_frame_, &denoised_frame);
+    denoiser_two_threads.DenoiseFrame(video_frame_,
+                                      &denoised_frame_two_threads);
+
+    // Splitting the frame into bands must not change the result.
+    ASSERT_EQ(true, denoised_frame.EqualsFrame(denoised_frame_two_threads));
+  }
+  ASSERT_NE(0, feof(source_file_)) << "Error reading source file";
+}
+
 }  // namespace webrtc
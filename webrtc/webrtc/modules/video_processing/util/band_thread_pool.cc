@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "webrtc/modules/video_processing/util/band_thread_pool.h"
+
+#include "webrtc/base/checks.h"
+
+namespace webrtc {
+
+BandThreadPool::Worker::Worker(BandThreadPool* parent, size_t band)
+    : parent(parent),
+      band(band),
+      start_event(false, false),
+      done_event(false, false),
+      thread(&BandThreadPool::WorkerThreadFunc, this, "band_worker") {}
+
+BandThreadPool::BandThreadPool(size_t num_bands) : task_(nullptr) {
+  RTC_DCHECK_GT(num_bands, 0u);
+  for (size_t i = 0; i + 1 < num_bands; ++i) {
+    workers_.push_back(new Worker(this, i));
+    workers_.back()->thread.Start();
+  }
+}
+
+BandThreadPool::~BandThreadPool() {
+  // Waking a worker without a task tells it to exit.
+  RTC_DCHECK(!task_);
+  for (Worker* worker : workers_) {
+    worker->start_event.Set();
+    worker->thread.Stop();
+    delete worker;
+  }
+}
+
+void BandThreadPool::Run(Task* task) {
+  RTC_DCHECK(task);
+  task_ = task;
+  for (Worker* worker : workers_) {
+    worker->start_event.Set();
+  }
+  task->ProcessBand(workers_.size(), num_bands());
+  for (Worker* worker : workers_) {
+    worker->done_event.Wait(rtc::Event::kForever);
+  }
+  task_ = nullptr;
+}
+
+size_t BandThreadPool::FirstRowOfBand(size_t band,
+                                      size_t num_bands,
+                                      size_t num_rows) {
+  RTC_DCHECK_LE(band, num_bands);
+  return band * num_rows / num_bands;
+}
+
+bool BandThreadPool::WorkerThreadFunc(void* context) {
+  Worker* worker = static_cast<Worker*>(context);
+  // Idle workers block until Run() or the destructor wakes them.
+  worker->start_event.Wait(rtc::Event::kForever);
+  Task* task = worker->parent->task_;
+  if (!task)
+    return false;
+  task->ProcessBand(worker->band, worker->parent->num_bands());
+  worker->done_event.Set();
+  return true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef WEBRTC_MODULES_VIDEO_PROCESSING_UTIL_BAND_THREAD_POOL_H_
+#define WEBRTC_MODULES_VIDEO_PROCESSING_UTIL_BAND_THREAD_POOL_H_
+
+#include <vector>
+
+#include "webrtc/base/constructormagic.h"
+#include "webrtc/base/event.h"
+#include "webrtc/base/platform_thread.h"
+
+namespace webrtc {
+
+// Splits the processing of a frame into horizontal bands, which are processed
+// in parallel. The calling thread processes the last band and one worker
+// thread processes each of the others.
+//
+// All methods must be called from the same thread.
+class BandThreadPool {
+ public:
+  class Task {
+   public:
+    // Processes band |band| out of |num_bands|. Called concurrently for
+    // different bands.
+    virtual void ProcessBand(size_t band, size_t num_bands) = 0;
+
+   protected:
+    virtual ~Task() {}
+  };
+
+  // Creates a pool that processes |num_bands| bands, using |num_bands| - 1
+  // worker threads.
+  explicit BandThreadPool(size_t num_bands);
+  ~BandThreadPool();
+
+  size_t num_bands() const { return workers_.size() + 1; }
+
+  // Runs |task| on every band and returns when all bands are done.
+  void Run(Task* task);
+
+  // Returns the first row of band |band|, when |num_rows| rows are split into
+  // |num_bands| bands of about the same size. Band |band| ends at the first
+  // row of band |band| + 1.
+  static size_t FirstRowOfBand(size_t band, size_t num_bands, size_t num_rows);
+
+ private:
+  struct Worker {
+    Worker(BandThreadPool* parent, size_t band);
+
+    BandThreadPool* const parent;
+    const size_t band;
+    rtc::Event start_event;
+    rtc::Event done_event;
+    rtc::PlatformThread thread;
+  };
+
+  static bool WorkerThreadFunc(void* context);
+
+  std::vector<Worker*> workers_;
+  // The task that is in progress. It is written before the workers are
+  // started and only read by them. Workers started without a task exit.
+  Task* task_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(BandThreadPool);
+};
+
+}  // namespace webrtc
+
+#endif  // WEBRTC_MODULES_VIDEO_PROCESSING_UTIL_BAND_THREAD_POOL_H_
@@ -13,10 +13,26 @@
 
 namespace webrtc {
 
+namespace {
+
+// Frames with fewer macroblock rows per band are denoised on a single thread,
+// since splitting them would cost more than it saves.
+const int kMinMbRowsPerBand = 8;
+
+}  // namespace
+
 VideoDenoiser::VideoDenoiser(bool runtime_cpu_detection)
+    : VideoDenoiser(runtime_cpu_detection, 1) {}
+
+VideoDenoiser::VideoDenoiser(bool runtime_cpu_detection, size_t num_threads)
     : width_(0),
       height_(0),
-      filter_(DenoiserFilter::Create(runtime_cpu_detection)) {}
+      filter_(DenoiserFilter::Create(runtime_cpu_detection)),
+      num_threads_(num_threads),
+      frame_(nullptr),
+      denoised_frame_(nullptr) {}
+
+VideoDenoiser::~VideoDenoiser() {}
 
 void VideoDenoiser::TrailingReduction(int mb_rows,
                                       int mb_cols,
@@ -68,6 +84,7 @@ void VideoDenoiser::DenoiseFrame(const VideoFrame& frame,
   if (width_ != frame.width() || height_ != frame.height()) {
     width_ = frame.width();
     height_ = frame.height();
+    metrics_.reset();
     denoised_frame->CreateFrame(frame.buffer(kYPlane), frame.buffer(kUPlane),
                                 frame.buffer(kVPlane), width_, height_,
                                 stride_y, stride_u, stride_v);
@@ -81,16 +98,56 @@ void VideoDenoiser::DenoiseFrame(const VideoFrame& frame,
   int mb_rows = height_ >> 4;
   if (metrics_.get() == nullptr)
     metrics_.reset(new DenoiseMetrics[mb_cols * mb_rows]());
+  frame_ = &frame;
+  denoised_frame_ = denoised_frame;
+  if (num_threads_ > 1 &&
+      mb_rows >= kMinMbRowsPerBand * static_cast<int>(num_threads_)) {
+    if (!thread_pool_)
+      thread_pool_.reset(new BandThreadPool(num_threads_));
+    thread_pool_->Run(this);
+  } else {
+    DenoiseMbRows(0, mb_rows);
+  }
+  frame_ = nullptr;
+  denoised_frame_ = nullptr;
+  // Second round.
+  // This is to reduce the trailing artifact and blockiness by referring
+  // neighbors' denoising status. It depends on the result of the previous
+  // macroblocks, so it is not split into bands.
+  TrailingReduction(mb_rows, mb_cols, frame.buffer(kYPlane), stride_y,
+                    denoised_frame->buffer(kYPlane));
+
+  // Setting time parameters to the output frame.
+  denoised_frame->set_timestamp(frame.timestamp());
+  denoised_frame->set_render_time_ms(frame.render_time_ms());
+  return;
+}
+
+void VideoDenoiser::ProcessBand(size_t band, size_t num_bands) {
+  const size_t mb_rows = height_ >> 4;
+  DenoiseMbRows(
+      static_cast<int>(BandThreadPool::FirstRowOfBand(band, num_bands,
+                                                      mb_rows)),
+      static_cast<int>(BandThreadPool::FirstRowOfBand(band + 1, num_bands,
+                                                      mb_rows)));
+}
+
+void VideoDenoiser::DenoiseMbRows(int first_mb_row, int last_mb_row) {
+  const VideoFrame& frame = *frame_;
+  int stride_y = frame.stride(kYPlane);
+  int stride_u = frame.stride(kUPlane);
+  int stride_v = frame.stride(kVPlane);
+  int mb_cols = width_ >> 4;
   // Denoise on Y plane.
-  uint8_t* y_dst = denoised_frame->buffer(kYPlane);
-  uint8_t* u_dst = denoised_frame->buffer(kUPlane);
-  uint8_t* v_dst = denoised_frame->buffer(kVPlane);
+  uint8_t* y_dst = denoised_frame_->buffer(kYPlane);
+  uint8_t* u_dst = denoised_frame_->buffer(kUPlane);
+  uint8_t* v_dst = denoised_frame_->buffer(kVPlane);
   const uint8_t* y_src = frame.buffer(kYPlane);
   const uint8_t* u_src = frame.buffer(kUPlane);
   const uint8_t* v_src = frame.buffer(kVPlane);
   // Temporary buffer to store denoising result.
   uint8_t y_tmp[16 * 16] = {0};
-  for (int mb_row = 0; mb_row < mb_rows; ++mb_row) {
+  for (int mb_row = first_mb_row; mb_row < last_mb_row; ++mb_row) {
     for (int mb_col = 0; mb_col < mb_cols; ++mb_col) {
       const uint8_t* mb_src = y_src + (mb_row << 4) * stride_y + (mb_col << 4);
       uint8_t* mb_dst = y_dst + (mb_row << 4) * stride_y + (mb_col << 4);
@@ -133,15 +190,6 @@ void VideoDenoiser::DenoiseFrame(const VideoFrame& frame,
       filter_->CopyMem8x8(mb_src_v, stride_v, mb_dst_v, stride_v);
     }
   }
-  // Second round.
-  // This is to reduce the trailing artifact and blockiness by referring
-  // neighbors' denoising status.
-  TrailingReduction(mb_rows, mb_cols, y_src, stride_y, y_dst);
-
-  // Setting time parameters to the output frame.
-  denoised_frame->set_timestamp(frame.timestamp());
-  denoised_frame->set_render_time_ms(frame.render_time_ms());
-  return;
 }
 
 }  // namespace webrtc
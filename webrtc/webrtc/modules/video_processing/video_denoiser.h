@@ -11,17 +11,30 @@
 #ifndef WEBRTC_MODULES_VIDEO_PROCESSING_VIDEO_DENOISER_H_
 #define WEBRTC_MODULES_VIDEO_PROCESSING_VIDEO_DENOISER_H_
 
+#include "webrtc/modules/video_processing/util/band_thread_pool.h"
 #include "webrtc/modules/video_processing/util/denoiser_filter.h"
 #include "webrtc/modules/video_processing/util/skin_detection.h"
 
 namespace webrtc {
 
-class VideoDenoiser {
+class VideoDenoiser : private BandThreadPool::Task {
  public:
   explicit VideoDenoiser(bool runtime_cpu_detection);
+  // Denoises the macroblock rows of large frames in |num_threads| bands in
+  // parallel. The result is the same as with a single thread.
+  VideoDenoiser(bool runtime_cpu_detection, size_t num_threads);
+  ~VideoDenoiser() override;
+
   void DenoiseFrame(const VideoFrame& frame, VideoFrame* denoised_frame);
 
  private:
+  // BandThreadPool::Task implementation, which runs DenoiseMbRows() on band
+  // |band| of the frame in progress.
+  void ProcessBand(size_t band, size_t num_bands) override;
+
+  // Denoises the macroblock rows in [first_mb_row, last_mb_row) of
+  // |frame_| into |denoised_frame_|, and updates their |metrics_|.
+  void DenoiseMbRows(int first_mb_row, int last_mb_row);
   void TrailingReduction(int mb_rows,
                          int mb_cols,
                          const uint8_t* y_src,
@@ -31,6 +44,14 @@ class VideoDenoiser {
   int height_;
   rtc::scoped_ptr<DenoiseMetrics[]> metrics_;
   rtc::scoped_ptr<DenoiserFilter> filter_;
+
+  const size_t num_threads_;
+  // Created on the first frame that is large enough to be split into bands.
+  rtc::scoped_ptr<BandThreadPool> thread_pool_;
+  // The frames in progress. They are set before the bands are processed and
+  // only read while processing them.
+  const VideoFrame* frame_;
+  VideoFrame* denoised_frame_;
 };
 
 }  // namespace webrtc
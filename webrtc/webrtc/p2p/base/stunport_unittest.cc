@@ -8,13 +8,21 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#if defined(WEBRTC_POSIX)
+#include <sys/resource.h>
+#endif
+
+#include <algorithm>
+
 #include "webrtc/p2p/base/basicpacketsocketfactory.h"
 #include "webrtc/p2p/base/stunport.h"
 #include "webrtc/p2p/base/teststunserver.h"
 #include "webrtc/base/gunit.h"
 #include "webrtc/base/helpers.h"
+#include "webrtc/base/logging.h"
 #include "webrtc/base/physicalsocketserver.h"
 #include "webrtc/base/scoped_ptr.h"
+#include "webrtc/base/scopedptrcollection.h"
 #include "webrtc/base/socketaddress.h"
 #include "webrtc/base/ssladapter.h"
 #include "webrtc/base/virtualsocketserver.h"
@@ -285,3 +293,108 @@ TEST_F(StunPortTest, TestTwoCandidatesWithTwoStunServersAcrossNat) {
   EXPECT_EQ(port()->Candidates()[0].relay_protocol(), "");
   EXPECT_EQ(port()->Candidates()[1].relay_protocol(), "");
 }
+
+// Load test: many STUN ports on one thread gather their candidates at once,
+// directly on a PhysicalSocketServer. With epoll this goes well beyond the
+// FD_SETSIZE limit of select().
+class StunPortLoadTest : public testing::Test,
+                         public sigslot::has_slots<> {
+ public:
+  StunPortLoadTest()
+      : pss_(new rtc::PhysicalSocketServer),
+        ss_scope_(pss_.get()),
+        network_("unittest", "unittest", rtc::IPAddress(INADDR_ANY), 32),
+        socket_factory_(rtc::Thread::Current()),
+        completed_(0),
+        failed_(0) {
+#if defined(WEBRTC_USE_EPOLL)
+    pss_->EnableEpoll();
+#endif
+  }
+
+ protected:
+  static void SetUpTestCase() {
+    rtc::InitRandom(NULL, 0);
+  }
+
+  // Returns how many ports can be opened, raising the descriptor limit
+  // towards |wanted| if the process is allowed to.
+  static int AvailablePorts(int wanted) {
+#if defined(WEBRTC_POSIX)
+    // Leave room for the STUN server and the socket server's own descriptors.
+    const rlim_t kReserved = 64;
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+      rlim_t needed = static_cast<rlim_t>(wanted) + kReserved;
+      if (limit.rlim_cur < needed && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = std::min(needed, limit.rlim_max);
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+      }
+      if (limit.rlim_cur < needed)
+        return std::max(0, static_cast<int>(limit.rlim_cur - kReserved));
+    }
+#endif
+    return wanted;
+  }
+
+  cricket::UDPPort* CreateStunPort(const ServerAddresses& stun_servers) {
+    cricket::UDPPort* port = cricket::StunPort::Create(
+        rtc::Thread::Current(), &socket_factory_, &network_,
+        kLocalAddr.ipaddr(), 0, 0, rtc::CreateRandomString(16),
+        rtc::CreateRandomString(22), stun_servers, std::string());
+    if (port) {
+      port->SignalPortComplete.connect(this,
+          &StunPortLoadTest::OnPortComplete);
+      port->SignalPortError.connect(this, &StunPortLoadTest::OnPortError);
+    }
+    return port;
+  }
+
+  void OnPortComplete(cricket::Port* port) { ++completed_; }
+  void OnPortError(cricket::Port* port) { ++failed_; }
+
+  rtc::scoped_ptr<rtc::PhysicalSocketServer> pss_;
+  rtc::SocketServerScope ss_scope_;
+  rtc::Network network_;
+  rtc::BasicPacketSocketFactory socket_factory_;
+  int completed_;
+  int failed_;
+};
+
+TEST_F(StunPortLoadTest, ManyPortsGatherAtOnce) {
+#if defined(WEBRTC_USE_EPOLL)
+  const int kWantedPorts = 2000;
+#else
+  // select() can't watch descriptors past FD_SETSIZE.
+  const int kWantedPorts = 500;
+#endif
+  const int num_ports = AvailablePorts(kWantedPorts);
+  if (num_ports < kWantedPorts) {
+    LOG(LS_WARNING) << "Descriptor limit only allows " << num_ports
+                    << " ports";
+  }
+
+  rtc::scoped_ptr<cricket::TestStunServer> stun_server(
+      cricket::TestStunServer::Create(rtc::Thread::Current(), kStunAddr1));
+  ServerAddresses stun_servers;
+  stun_servers.insert(kStunAddr1);
+
+  rtc::ScopedPtrCollection<cricket::UDPPort> ports;
+  ports.Reserve(num_ports);
+  for (int i = 0; i < num_ports; ++i) {
+    cricket::UDPPort* port = CreateStunPort(stun_servers);
+    ASSERT_TRUE(port != NULL) << "port " << i;
+    ports.PushBack(port);
+  }
+
+  uint32_t start = rtc::Time();
+  for (cricket::UDPPort* port : ports.collection())
+    port->PrepareAddress();
+  // Requests dropped by the server's receive buffer are retransmitted with
+  // backoff, so allow more time than for a single port.
+  EXPECT_EQ_WAIT(num_ports, completed_ + failed_, 3 * kTimeoutMs);
+  EXPECT_EQ(num_ports, completed_);
+  LOG(LS_INFO) << num_ports << " STUN ports gathered in "
+               << rtc::TimeSince(start) << " ms";
+}
@@ -44,6 +44,32 @@ static inline void __cpuid(int cpu_info[4], int info_type) {
     : "a"(info_type));
 }
 #endif
+
+// Intrinsic for "cpuid" with a sub-leaf in ecx, as needed by leaf 7.
+#if defined(__pic__) && defined(__i386__)
+static inline void __cpuidex(int cpu_info[4], int info_type, int sub_type) {
+  __asm__ volatile(
+    "mov %%ebx, %%edi\n"
+    "cpuid\n"
+    "xchg %%edi, %%ebx\n"
+    : "=a"(cpu_info[0]), "=D"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
+    : "a"(info_type), "c"(sub_type));
+}
+#else
+static inline void __cpuidex(int cpu_info[4], int info_type, int sub_type) {
+  __asm__ volatile(
+    "cpuid\n"
+    : "=a"(cpu_info[0]), "=b"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
+    : "a"(info_type), "c"(sub_type));
+}
+#endif
+
+// Intrinsic for "xgetbv", which reads the extended control register |xcr|.
+static inline uint64_t _xgetbv(uint32_t xcr) {
+  uint32_t eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(xcr));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+}
 #endif  // _MSC_VER
 #endif  // WEBRTC_ARCH_X86_FAMILY
 
@@ -58,6 +84,21 @@ static int GetCPUInfo(CPUFeature feature) {
   if (feature == kSSE3) {
     return 0 != (cpu_info[2] & 0x00000001);
   }
+  if (feature == kAVX2) {
+    // FMA, OSXSAVE and AVX must all be set, and the OS must save the XMM and
+    // YMM registers on context switches.
+    const int kFmaOsxsaveAvx = 0x18001000;
+    if ((cpu_info[2] & kFmaOsxsaveAvx) != kFmaOsxsaveAvx ||
+        (_xgetbv(0) & 0x6) != 0x6) {
+      return 0;
+    }
+    __cpuid(cpu_info, 0);
+    if (cpu_info[0] < 7) {
+      return 0;
+    }
+    __cpuidex(cpu_info, 7, 0);
+    return 0 != (cpu_info[1] & 0x00000020);
+  }
   return 0;
 }
 #else
@@ -14,6 +14,7 @@
 
 #include <algorithm>
 
+#include "libyuv/convert.h"  // NOLINT
 #include "webrtc/base/checks.h"
 #include "webrtc/base/logging.h"
 #include "webrtc/base/trace_event.h"
@@ -369,10 +370,30 @@ void ViEEncoder::DeliverFrame(VideoFrame video_frame) {
   }
 
   // If we haven't resampled the frame and we have a FrameCallback, we need to
-  // make a deep copy of |video_frame|.
+  // make a deep copy of |video_frame|. The copy is made into a pooled buffer,
+  // to avoid an allocation per frame.
   VideoFrame copied_frame;
   if (pre_encode_callback_) {
-    copied_frame.CopyFrame(*frame_to_send);
+    if (frame_to_send->IsZeroSize() || frame_to_send->native_handle()) {
+      copied_frame.CopyFrame(*frame_to_send);
+    } else {
+      copied_frame.ShallowCopy(*frame_to_send);
+      copied_frame.set_video_frame_buffer(pre_encode_buffer_pool_.CreateBuffer(
+          frame_to_send->width(), frame_to_send->height()));
+      libyuv::I420Copy(frame_to_send->buffer(kYPlane),
+                       frame_to_send->stride(kYPlane),
+                       frame_to_send->buffer(kUPlane),
+                       frame_to_send->stride(kUPlane),
+                       frame_to_send->buffer(kVPlane),
+                       frame_to_send->stride(kVPlane),
+                       copied_frame.buffer(kYPlane),
+                       copied_frame.stride(kYPlane),
+                       copied_frame.buffer(kUPlane),
+                       copied_frame.stride(kUPlane),
+                       copied_frame.buffer(kVPlane),
+                       copied_frame.stride(kVPlane),
+                       frame_to_send->width(), frame_to_send->height());
+    }
     pre_encode_callback_->FrameCallback(&copied_frame);
     frame_to_send = &copied_frame;
   }
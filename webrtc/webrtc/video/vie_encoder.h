@@ -19,6 +19,7 @@
 #include "webrtc/base/thread_annotations.h"
 #include "webrtc/call/bitrate_allocator.h"
 #include "webrtc/common_types.h"
+#include "webrtc/common_video/include/i420_buffer_pool.h"
 #include "webrtc/frame_callback.h"
 #include "webrtc/modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "webrtc/modules/video_coding/include/video_coding_defines.h"
@@ -163,6 +164,8 @@ class ViEEncoder : public RtcpIntraFrameObserver,
 
   SendStatisticsProxy* const stats_proxy_;
   I420FrameCallback* const pre_encode_callback_;
+  // Provides the buffers of the frames copied for |pre_encode_callback_|.
+  I420BufferPool pre_encode_buffer_pool_;
   PacedSender* const pacer_;
   BitrateAllocator* const bitrate_allocator_;
 
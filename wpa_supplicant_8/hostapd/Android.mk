@@ -555,6 +555,15 @@ ifndef CONFIG_TLS
 CONFIG_TLS=openssl
 endif
 
+ifdef CONFIG_TLS_OFFLOAD
+ifdef TLS_FUNCS
+ifeq ($(CONFIG_TLS), openssl)
+L_CFLAGS += -DCONFIG_TLS_OFFLOAD
+OBJS += src/eap_server/eap_tls_offload.c
+endif
+endif
+endif
+
 ifdef CONFIG_TLSV11
 L_CFLAGS += -DCONFIG_TLSV11
 endif
@@ -2134,6 +2134,16 @@ static int hostapd_config_fill(struct hostapd_config *conf,
 		bss->check_crl = atoi(pos);
 	} else if (os_strcmp(buf, "tls_session_lifetime") == 0) {
 		bss->tls_session_lifetime = atoi(pos);
+	} else if (os_strcmp(buf, "tls_offload_threads") == 0) {
+		int val = atoi(pos);
+
+		if (val < 0 || val > 64) {
+			wpa_printf(MSG_ERROR,
+				   "Line %d: invalid tls_offload_threads %d",
+				   line, val);
+			return 1;
+		}
+		bss->tls_offload_threads = val;
 	} else if (os_strcmp(buf, "ocsp_stapling_response") == 0) {
 		os_free(bss->ocsp_stapling_response);
 		bss->ocsp_stapling_response = os_strdup(pos);
@@ -1357,6 +1357,9 @@ static int hostapd_ctrl_iface_set(struct hostapd_data *hapd, char *cmd)
 		if (ret)
 			return ret;
 
+		/* Probe Response frames follow the new value immediately */
+		hostapd_flush_probe_resp_tmpl(hapd);
+
 		if (os_strcasecmp(cmd, "deny_mac_file") == 0) {
 			for (sta = hapd->sta_list; sta; sta = sta->next) {
 				if (hostapd_maclist_found(
@@ -0,0 +1,205 @@
+/*
+ * eloop benchmark
+ *
+ * This software may be distributed under the terms of the BSD license.
+ * See README for more details.
+ *
+ * Measures the event loop with the kind of load a hostapd instance with many
+ * associated stations puts on it: a large number of pending per-station
+ * timeouts that are registered, re-armed, and expire, and a number of sockets
+ * that become readable at the same time.
+ *
+ * Build the benchmark with the same CONFIG_ELOOP_* options as hostapd to
+ * compare the select(), poll(), and epoll() backends.
+ */
+
+#include "includes.h"
+
+#include "common.h"
+#include "eloop.h"
+
+
+static int num_timeouts = 10000;
+static int num_rearm = 1000;
+static int num_socks = 64;
+static int num_rounds = 1000;
+
+static int fired;
+static int pending_rounds;
+static int (*socks)[2];
+
+
+static double bench_elapsed(struct os_reltime *start)
+{
+	struct os_reltime now, diff;
+
+	os_get_reltime(&now);
+	os_reltime_sub(&now, start, &diff);
+	return diff.sec + diff.usec / 1000000.0;
+}
+
+
+static void bench_report(const char *name, int ops, struct os_reltime *start)
+{
+	double t = bench_elapsed(start);
+
+	printf("%-10s %8d ops %10.3f ms %12.0f ops/s\n", name, ops, t * 1000,
+	       t > 0 ? ops / t : 0);
+}
+
+
+static void bench_timeout(void *eloop_ctx, void *user_ctx)
+{
+	fired++;
+	if (fired == num_timeouts)
+		eloop_terminate();
+}
+
+
+static void bench_idle_timeout(void *eloop_ctx, void *user_ctx)
+{
+}
+
+
+static void bench_register(void)
+{
+	int i;
+
+	for (i = 0; i < num_timeouts; i++) {
+		if (eloop_register_timeout(60 + os_random() % 300,
+					   os_random() % 1000000,
+					   bench_idle_timeout, NULL,
+					   (void *) (intptr_t) i) < 0) {
+			fprintf(stderr, "Failed to register timeout\n");
+			exit(1);
+		}
+	}
+}
+
+
+static void bench_sock_read(int sock, void *eloop_ctx, void *sock_ctx)
+{
+	int *pair = sock_ctx;
+	char buf[1];
+
+	if (read(sock, buf, sizeof(buf)) < 0)
+		return;
+	if (pending_rounds-- <= 0) {
+		eloop_terminate();
+		return;
+	}
+	if (write(pair[1], buf, sizeof(buf)) < 0)
+		eloop_terminate();
+}
+
+
+static void bench_sock_start(void *eloop_ctx, void *user_ctx)
+{
+	int i;
+
+	for (i = 0; i < num_socks; i++) {
+		if (write(socks[i][1], "x", 1) < 0)
+			eloop_terminate();
+	}
+}
+
+
+static void usage(void)
+{
+	printf("usage: eloop_bench [-t<timeouts>] [-a<re-arms>] [-s<sockets>] "
+	       "[-r<rounds>]\n");
+}
+
+
+int main(int argc, char *argv[])
+{
+	struct os_reltime start;
+	int c, i;
+
+	for (;;) {
+		c = getopt(argc, argv, "a:hr:s:t:");
+		if (c < 0)
+			break;
+		switch (c) {
+		case 'a':
+			num_rearm = atoi(optarg);
+			break;
+		case 'r':
+			num_rounds = atoi(optarg);
+			break;
+		case 's':
+			num_socks = atoi(optarg);
+			break;
+		case 't':
+			num_timeouts = atoi(optarg);
+			break;
+		default:
+			usage();
+			return -1;
+		}
+	}
+	if (num_timeouts <= 0 || num_rearm < 0 || num_socks <= 0 ||
+	    num_rounds < 0) {
+		usage();
+		return -1;
+	}
+
+	if (eloop_init()) {
+		fprintf(stderr, "Failed to initialize event loop\n");
+		return -1;
+	}
+
+	/* Per-station timeouts, e.g., inactivity polls, spread over minutes */
+	os_get_reltime(&start);
+	bench_register();
+	bench_report("register", num_timeouts, &start);
+
+	/* Re-arming a station timeout is a cancel followed by a register */
+	os_get_reltime(&start);
+	for (i = 0; i < num_rearm; i++) {
+		void *ctx = (void *) (intptr_t) (os_random() % num_timeouts);
+
+		eloop_cancel_timeout(bench_idle_timeout, NULL, ctx);
+		eloop_register_timeout(60 + os_random() % 300, 0,
+				       bench_idle_timeout, NULL, ctx);
+	}
+	bench_report("re-arm", num_rearm, &start);
+
+	/* Socket dispatch with the timeouts above still pending */
+	socks = os_calloc(num_socks, sizeof(*socks));
+	if (socks == NULL)
+		return -1;
+	for (i = 0; i < num_socks; i++) {
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, socks[i]) < 0 ||
+		    eloop_register_read_sock(socks[i][0], bench_sock_read,
+					     NULL, socks[i]) < 0) {
+			fprintf(stderr, "Failed to set up socket %d: %s\n", i,
+				strerror(errno));
+			return -1;
+		}
+	}
+	pending_rounds = num_socks * num_rounds;
+	eloop_register_timeout(0, 0, bench_sock_start, NULL, NULL);
+	os_get_reltime(&start);
+	eloop_run();
+	bench_report("dispatch", num_socks * num_rounds, &start);
+	for (i = 0; i < num_socks; i++) {
+		eloop_unregister_read_sock(socks[i][0]);
+		close(socks[i][0]);
+		close(socks[i][1]);
+	}
+	os_free(socks);
+
+	/* Expiry of timeouts that all become due within a millisecond */
+	eloop_cancel_timeout(bench_idle_timeout, NULL, ELOOP_ALL_CTX);
+	os_get_reltime(&start);
+	for (i = 0; i < num_timeouts; i++)
+		eloop_register_timeout(0, os_random() % 1000, bench_timeout,
+				       NULL, (void *) (intptr_t) i);
+	eloop_run();
+	bench_report("expire", num_timeouts, &start);
+
+	eloop_destroy();
+
+	return 0;
+}
@@ -12,6 +12,7 @@
 #include "crypto/tls.h"
 #include "eap_server/eap.h"
 #include "eap_server/eap_sim_db.h"
+#include "eap_server/eap_tls_offload.h"
 #include "eapol_auth/eapol_auth_sm.h"
 #include "radius/radius_server.h"
 #include "hostapd.h"
@@ -25,9 +26,14 @@
 #endif /* EAP_SERVER_SIM || EAP_SERVER_AKA */
 
 
-#ifdef EAP_SIM_DB
-static int hostapd_sim_db_cb_sta(struct hostapd_data *hapd,
-				 struct sta_info *sta, void *ctx)
+#if defined(EAP_SIM_DB) || defined(CONFIG_TLS_OFFLOAD)
+#define EAP_PENDING_CB
+#endif /* EAP_SIM_DB || CONFIG_TLS_OFFLOAD */
+
+
+#ifdef EAP_PENDING_CB
+static int hostapd_eap_pending_cb_sta(struct hostapd_data *hapd,
+				      struct sta_info *sta, void *ctx)
 {
 	if (eapol_auth_eap_pending_cb(sta->eapol_sm, ctx) == 0)
 		return 1;
@@ -35,16 +41,17 @@ static int hostapd_sim_db_cb_sta(struct hostapd_data *hapd,
 }
 
 
-static void hostapd_sim_db_cb(void *ctx, void *session_ctx)
+static void hostapd_eap_pending_cb(void *ctx, void *session_ctx)
 {
 	struct hostapd_data *hapd = ctx;
-	if (ap_for_each_sta(hapd, hostapd_sim_db_cb_sta, session_ctx) == 0) {
+	if (ap_for_each_sta(hapd, hostapd_eap_pending_cb_sta,
+			    session_ctx) == 0) {
 #ifdef RADIUS_SERVER
 		radius_server_eap_pending_cb(hapd->radius_srv, session_ctx);
 #endif /* RADIUS_SERVER */
 	}
 }
-#endif /* EAP_SIM_DB */
+#endif /* EAP_PENDING_CB */
 
 
 #ifdef RADIUS_SERVER
@@ -104,6 +111,7 @@ static int hostapd_setup_radius_srv(struct hostapd_data *hapd)
 	srv.acct_port = conf->radius_server_acct_port;
 	srv.conf_ctx = hapd;
 	srv.eap_sim_db_priv = hapd->eap_sim_db_priv;
+	srv.tls_offload = hapd->tls_offload;
 	srv.ssl_ctx = hapd->ssl_ctx;
 	srv.msg_ctx = hapd->msg_ctx;
 	srv.pac_opaque_encr_key = conf->pac_opaque_encr_key;
@@ -191,12 +199,26 @@ int authsrv_init(struct hostapd_data *hapd)
 	}
 #endif /* EAP_TLS_FUNCS */
 
+#ifdef CONFIG_TLS_OFFLOAD
+	if (hapd->ssl_ctx && hapd->conf->tls_offload_threads) {
+		hapd->tls_offload =
+			eap_tls_offload_init(hapd->conf->tls_offload_threads,
+					     hostapd_eap_pending_cb, hapd);
+		if (hapd->tls_offload == NULL) {
+			wpa_printf(MSG_ERROR,
+				   "Failed to initialize TLS handshake offload");
+			authsrv_deinit(hapd);
+			return -1;
+		}
+	}
+#endif /* CONFIG_TLS_OFFLOAD */
+
 #ifdef EAP_SIM_DB
 	if (hapd->conf->eap_sim_db) {
 		hapd->eap_sim_db_priv =
 			eap_sim_db_init(hapd->conf->eap_sim_db,
 					hapd->conf->eap_sim_db_timeout,
-					hostapd_sim_db_cb, hapd);
+					hostapd_eap_pending_cb, hapd);
 		if (hapd->eap_sim_db_priv == NULL) {
 			wpa_printf(MSG_ERROR, "Failed to initialize EAP-SIM "
 				   "database interface");
@@ -223,6 +245,11 @@ void authsrv_deinit(struct hostapd_data *hapd)
 	hapd->radius_srv = NULL;
 #endif /* RADIUS_SERVER */
 
+#ifdef CONFIG_TLS_OFFLOAD
+	eap_tls_offload_deinit(hapd->tls_offload);
+	hapd->tls_offload = NULL;
+#endif /* CONFIG_TLS_OFFLOAD */
+
 #ifdef EAP_TLS_FUNCS
 	if (hapd->ssl_ctx) {
 		tls_deinit(hapd->ssl_ctx);
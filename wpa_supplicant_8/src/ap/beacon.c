@@ -670,11 +670,66 @@ sta_track_seen_on(struct hostapd_iface *iface, const u8 *addr,
 }
 
 
+/*
+ * Returns the Probe Response template of the BSS addressed to req->sa, after
+ * building it if needed. The returned frame is owned by hapd and remains
+ * valid until hostapd_flush_probe_resp_tmpl() is called.
+ */
+static const u8 * hostapd_probe_resp_tmpl(struct hostapd_data *hapd,
+					  const struct ieee80211_mgmt *req,
+					  size_t *resp_len)
+{
+	struct ieee80211_mgmt *resp;
+	const u8 *ie;
+	u8 *pos;
+	size_t len;
+
+	if (hapd->probe_resp_tmpl == NULL) {
+		pos = hostapd_gen_probe_resp(hapd, NULL, 0, &len);
+		if (pos == NULL)
+			return NULL;
+		resp = (struct ieee80211_mgmt *) pos;
+
+		/* BSS Load is the only element that changes without a beacon
+		 * update; remember where it is to avoid rebuilding the frame
+		 * when the station count or channel utilization changes. */
+		ie = NULL;
+		if (hapd->conf->bss_load_update_period)
+			ie = get_ie(resp->u.probe_resp.variable,
+				    pos + len - resp->u.probe_resp.variable,
+				    WLAN_EID_BSS_LOAD);
+#ifdef CONFIG_TESTING_OPTIONS
+		if (hapd->conf->bss_load_test_set)
+			ie = NULL;
+#endif /* CONFIG_TESTING_OPTIONS */
+		if (ie && ie[1] >= 3)
+			hapd->probe_resp_tmpl_bss_load = ie - pos;
+		else
+			hapd->probe_resp_tmpl_bss_load = 0;
+
+		hapd->probe_resp_tmpl = pos;
+		hapd->probe_resp_tmpl_len = len;
+	}
+
+	resp = (struct ieee80211_mgmt *) hapd->probe_resp_tmpl;
+	os_memcpy(resp->da, req->sa, ETH_ALEN);
+	if (hapd->probe_resp_tmpl_bss_load) {
+		pos = hapd->probe_resp_tmpl + hapd->probe_resp_tmpl_bss_load + 2;
+		WPA_PUT_LE16(pos, hapd->num_sta);
+		pos[2] = hapd->iface->channel_utilization;
+	}
+
+	*resp_len = hapd->probe_resp_tmpl_len;
+	return hapd->probe_resp_tmpl;
+}
+
+
 void handle_probe_req(struct hostapd_data *hapd,
 		      const struct ieee80211_mgmt *mgmt, size_t len,
 		      int ssi_signal)
 {
 	u8 *resp;
+	const u8 *frame;
 	struct ieee802_11_elems elems;
 	const u8 *ie;
 	size_t ie_len;
@@ -871,9 +926,19 @@ void handle_probe_req(struct hostapd_data *hapd,
 	}
 #endif /* CONFIG_TESTING_OPTIONS */
 
-	resp = hostapd_gen_probe_resp(hapd, mgmt, elems.p2p != NULL,
-				      &resp_len);
-	if (resp == NULL)
+	/*
+	 * Responses to P2P Probe Request frames and responses sent during a
+	 * channel switch differ from the template; build those from scratch.
+	 */
+	if (elems.p2p || hapd->csa_in_progress) {
+		resp = hostapd_gen_probe_resp(hapd, mgmt, elems.p2p != NULL,
+					      &resp_len);
+		frame = resp;
+	} else {
+		resp = NULL;
+		frame = hostapd_probe_resp_tmpl(hapd, mgmt, &resp_len);
+	}
+	if (frame == NULL)
 		return;
 
 	/*
@@ -894,7 +959,7 @@ void handle_probe_req(struct hostapd_data *hapd,
 				hapd->cs_c_off_ecsa_proberesp;
 	}
 
-	ret = hostapd_drv_send_mlme_csa(hapd, resp, resp_len, noack,
+	ret = hostapd_drv_send_mlme_csa(hapd, frame, resp_len, noack,
 					csa_offs_len ? csa_offs : NULL,
 					csa_offs_len);
 
@@ -1242,6 +1307,23 @@ void ieee802_11_free_ap_params(struct wpa_driver_ap_params *params)
 }
 
 
+/**
+ * hostapd_flush_probe_resp_tmpl - Discard the Probe Response template
+ * @hapd: Pointer to BSS data
+ *
+ * This needs to be called whenever any of the elements included in Probe
+ * Response frames may have changed; the template is rebuilt for the next
+ * Probe Request frame.
+ */
+void hostapd_flush_probe_resp_tmpl(struct hostapd_data *hapd)
+{
+	os_free(hapd->probe_resp_tmpl);
+	hapd->probe_resp_tmpl = NULL;
+	hapd->probe_resp_tmpl_len = 0;
+	hapd->probe_resp_tmpl_bss_load = 0;
+}
+
+
 int ieee802_11_set_beacon(struct hostapd_data *hapd)
 {
 	struct wpa_driver_ap_params params;
@@ -1256,6 +1338,7 @@ int ieee802_11_set_beacon(struct hostapd_data *hapd)
 		return -1;
 	}
 
+	hostapd_flush_probe_resp_tmpl(hapd);
 	hapd->beacon_set_done = 1;
 
 	if (ieee802_11_build_ap_params(hapd, &params) < 0)
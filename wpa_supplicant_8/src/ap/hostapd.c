@@ -314,6 +314,7 @@ static void hostapd_free_hapd_data(struct hostapd_data *hapd)
 	}
 
 	wpabuf_free(hapd->time_adv);
+	hostapd_flush_probe_resp_tmpl(hapd);
 
 #ifdef CONFIG_INTERWORKING
 	gas_serv_deinit(hapd);
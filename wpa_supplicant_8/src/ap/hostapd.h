@@ -118,7 +118,13 @@ struct hostapd_data {
 	struct sta_info *sta_list; /* STA info list head */
 #define STA_HASH_SIZE 256
 #define STA_HASH(sta) (sta[5])
-	struct sta_info *sta_hash[STA_HASH_SIZE];
+	/*
+	 * STA hash table with 1 << sta_hash_bits buckets; allocated with the
+	 * first station and doubled in size whenever num_sta exceeds the
+	 * number of buckets.
+	 */
+	struct sta_info **sta_hash;
+	unsigned int sta_hash_bits;
 
 	/*
 	 * Bitfield for indicating which AIDs are allocated. Only AID values
@@ -159,6 +165,7 @@ struct hostapd_data {
 
 	void *ssl_ctx;
 	void *eap_sim_db_priv;
+	struct eap_tls_offload_data *tls_offload;
 	struct radius_server_data *radius_srv;
 	struct dl_list erp_keys; /* struct eap_server_erp_key */
 
@@ -234,6 +241,14 @@ struct hostapd_data {
 	/* BSS Load */
 	unsigned int bss_load_update_timeout;
 
+	/*
+	 * Probe Response template for non-P2P Probe Request frames; only the
+	 * DA and the BSS Load element (if any) are updated for each response
+	 */
+	u8 *probe_resp_tmpl;
+	size_t probe_resp_tmpl_len;
+	size_t probe_resp_tmpl_bss_load; /* offset of BSS Load element or 0 */
+
 #ifdef CONFIG_P2P
 	struct p2p_data *p2p;
 	struct p2p_group *p2p_group;
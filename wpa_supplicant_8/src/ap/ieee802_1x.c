@@ -2183,6 +2183,7 @@ int ieee802_1x_init(struct hostapd_data *hapd)
 	conf.ssl_ctx = hapd->ssl_ctx;
 	conf.msg_ctx = hapd->msg_ctx;
 	conf.eap_sim_db_priv = hapd->eap_sim_db_priv;
+	conf.tls_offload = hapd->tls_offload;
 	conf.eap_req_id_text = hapd->conf->eap_req_id_text;
 	conf.eap_req_id_text_len = hapd->conf->eap_req_id_text_len;
 	conf.erp_send_reauth_start = hapd->conf->erp_send_reauth_start;
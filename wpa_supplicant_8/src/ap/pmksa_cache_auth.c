@@ -25,7 +25,11 @@ struct rsn_pmksa_cache {
 #define PMKID_HASH_SIZE 128
 #define PMKID_HASH(pmkid) (unsigned int) ((pmkid)[0] & 0x7f)
 	struct rsn_pmksa_cache_entry *pmkid[PMKID_HASH_SIZE];
-	struct rsn_pmksa_cache_entry *pmksa;
+#define SPA_HASH_SIZE 256
+#define SPA_HASH(spa) (unsigned int) ((spa)[ETH_ALEN - 1])
+	struct rsn_pmksa_cache_entry *spa[SPA_HASH_SIZE];
+	struct rsn_pmksa_cache_entry *pmksa; /* oldest entry */
+	struct rsn_pmksa_cache_entry *pmksa_tail; /* newest entry */
 	int pmksa_count;
 
 	void (*free_cb)(struct rsn_pmksa_cache_entry *entry, void *ctx);
@@ -51,42 +55,33 @@ static void _pmksa_cache_free_entry(struct rsn_pmksa_cache_entry *entry)
 void pmksa_cache_free_entry(struct rsn_pmksa_cache *pmksa,
 			    struct rsn_pmksa_cache_entry *entry)
 {
-	struct rsn_pmksa_cache_entry *pos, *prev;
-	unsigned int hash;
+	struct rsn_pmksa_cache_entry **pos;
 
 	pmksa->pmksa_count--;
 	pmksa->free_cb(entry, pmksa->ctx);
 
-	/* unlink from hash list */
-	hash = PMKID_HASH(entry->pmkid);
-	pos = pmksa->pmkid[hash];
-	prev = NULL;
-	while (pos) {
-		if (pos == entry) {
-			if (prev != NULL)
-				prev->hnext = entry->hnext;
-			else
-				pmksa->pmkid[hash] = entry->hnext;
-			break;
-		}
-		prev = pos;
-		pos = pos->hnext;
-	}
+	/* unlink from hash lists */
+	pos = &pmksa->pmkid[PMKID_HASH(entry->pmkid)];
+	while (*pos && *pos != entry)
+		pos = &(*pos)->hnext;
+	if (*pos)
+		*pos = entry->hnext;
+
+	pos = &pmksa->spa[SPA_HASH(entry->spa)];
+	while (*pos && *pos != entry)
+		pos = &(*pos)->spa_hnext;
+	if (*pos)
+		*pos = entry->spa_hnext;
 
 	/* unlink from entry list */
-	pos = pmksa->pmksa;
-	prev = NULL;
-	while (pos) {
-		if (pos == entry) {
-			if (prev != NULL)
-				prev->next = entry->next;
-			else
-				pmksa->pmksa = entry->next;
-			break;
-		}
-		prev = pos;
-		pos = pos->next;
-	}
+	if (entry->prev)
+		entry->prev->next = entry->next;
+	else
+		pmksa->pmksa = entry->next;
+	if (entry->next)
+		entry->next->prev = entry->prev;
+	else
+		pmksa->pmksa_tail = entry->prev;
 
 	_pmksa_cache_free_entry(entry);
 }
@@ -222,32 +217,39 @@ void pmksa_cache_to_eapol_data(struct hostapd_data *hapd,
 static void pmksa_cache_link_entry(struct rsn_pmksa_cache *pmksa,
 				   struct rsn_pmksa_cache_entry *entry)
 {
-	struct rsn_pmksa_cache_entry *pos, *prev;
+	struct rsn_pmksa_cache_entry *pos;
 	int hash;
 
-	/* Add the new entry; order by expiration time */
-	pos = pmksa->pmksa;
-	prev = NULL;
-	while (pos) {
-		if (pos->expiration > entry->expiration)
-			break;
-		prev = pos;
-		pos = pos->next;
-	}
-	if (prev == NULL) {
+	/*
+	 * Add the new entry; order by expiration time. New entries usually
+	 * have the latest expiration time, so search from the newest entry.
+	 */
+	pos = pmksa->pmksa_tail;
+	while (pos && pos->expiration > entry->expiration)
+		pos = pos->prev;
+	entry->prev = pos;
+	if (pos == NULL) {
 		entry->next = pmksa->pmksa;
 		pmksa->pmksa = entry;
 	} else {
-		entry->next = prev->next;
-		prev->next = entry;
+		entry->next = pos->next;
+		pos->next = entry;
 	}
+	if (entry->next)
+		entry->next->prev = entry;
+	else
+		pmksa->pmksa_tail = entry;
 
 	hash = PMKID_HASH(entry->pmkid);
 	entry->hnext = pmksa->pmkid[hash];
 	pmksa->pmkid[hash] = entry;
 
+	hash = SPA_HASH(entry->spa);
+	entry->spa_hnext = pmksa->spa[hash];
+	pmksa->spa[hash] = entry;
+
 	pmksa->pmksa_count++;
-	if (prev == NULL)
+	if (entry->prev == NULL)
 		pmksa_cache_set_expiration(pmksa);
 	wpa_printf(MSG_DEBUG, "RSN: added PMKSA cache entry for " MACSTR,
 		   MAC2STR(entry->spa));
@@ -402,8 +404,11 @@ void pmksa_cache_auth_deinit(struct rsn_pmksa_cache *pmksa)
 	eloop_cancel_timeout(pmksa_cache_expire, pmksa, NULL);
 	pmksa->pmksa_count = 0;
 	pmksa->pmksa = NULL;
+	pmksa->pmksa_tail = NULL;
 	for (i = 0; i < PMKID_HASH_SIZE; i++)
 		pmksa->pmkid[i] = NULL;
+	for (i = 0; i < SPA_HASH_SIZE; i++)
+		pmksa->spa[i] = NULL;
 	os_free(pmksa);
 }
 
@@ -429,12 +434,20 @@ pmksa_cache_auth_get(struct rsn_pmksa_cache *pmksa,
 			    os_memcmp(entry->pmkid, pmkid, PMKID_LEN) == 0)
 				return entry;
 		}
-	} else {
-		for (entry = pmksa->pmksa; entry; entry = entry->next) {
-			if (spa == NULL ||
-			    os_memcmp(entry->spa, spa, ETH_ALEN) == 0)
-				return entry;
+	} else if (spa) {
+		struct rsn_pmksa_cache_entry *found = NULL;
+
+		/* Return the oldest entry like a search of the entry list */
+		for (entry = pmksa->spa[SPA_HASH(spa)]; entry;
+		     entry = entry->spa_hnext) {
+			if (os_memcmp(entry->spa, spa, ETH_ALEN) == 0 &&
+			    (found == NULL ||
+			     entry->expiration <= found->expiration))
+				found = entry;
 		}
+		return found;
+	} else {
+		return pmksa->pmksa;
 	}
 
 	return NULL;
@@ -458,7 +471,8 @@ struct rsn_pmksa_cache_entry * pmksa_cache_get_okc(
 	struct rsn_pmksa_cache_entry *entry;
 	u8 new_pmkid[PMKID_LEN];
 
-	for (entry = pmksa->pmksa; entry; entry = entry->next) {
+	for (entry = pmksa->spa[SPA_HASH(spa)]; entry;
+	     entry = entry->spa_hnext) {
 		if (os_memcmp(entry->spa, spa, ETH_ALEN) != 0)
 			continue;
 		rsn_pmkid(entry->pmk, entry->pmk_len, aa, spa, new_pmkid,
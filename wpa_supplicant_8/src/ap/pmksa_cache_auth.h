@@ -15,7 +15,9 @@
  * struct rsn_pmksa_cache_entry - PMKSA cache entry
  */
 struct rsn_pmksa_cache_entry {
-	struct rsn_pmksa_cache_entry *next, *hnext;
+	struct rsn_pmksa_cache_entry *next, *prev; /* ordered by expiration */
+	struct rsn_pmksa_cache_entry *hnext; /* PMKID hash chain */
+	struct rsn_pmksa_cache_entry *spa_hnext; /* SPA hash chain */
 	u8 pmkid[PMKID_LEN];
 	u8 pmk[PMK_LEN_MAX];
 	size_t pmk_len;
@@ -64,11 +64,23 @@ int ap_for_each_sta(struct hostapd_data *hapd,
 }
 
 
+/*
+ * Multiplicative hash of the last three octets of the address; the first
+ * three are the OUI and are commonly shared by a large part of the stations.
+ */
+static unsigned int ap_sta_hash(const u8 *addr, unsigned int bits)
+{
+	return (WPA_GET_BE24(&addr[3]) * 0x9e3779b1U) >> (32 - bits);
+}
+
+
 struct sta_info * ap_get_sta(struct hostapd_data *hapd, const u8 *sta)
 {
 	struct sta_info *s;
 
-	s = hapd->sta_hash[STA_HASH(sta)];
+	if (hapd->sta_hash == NULL)
+		return NULL;
+	s = hapd->sta_hash[ap_sta_hash(sta, hapd->sta_hash_bits)];
 	while (s != NULL && os_memcmp(s->addr, sta, 6) != 0)
 		s = s->hnext;
 	return s;
@@ -119,29 +131,71 @@ static void ap_sta_list_del(struct hostapd_data *hapd, struct sta_info *sta)
 }
 
 
+static int ap_sta_hash_resize(struct hostapd_data *hapd, unsigned int bits)
+{
+	struct sta_info **hash, *sta;
+	unsigned int h;
+
+	hash = os_calloc(1U << bits, sizeof(*hash));
+	if (hash == NULL)
+		return -1;
+
+	for (sta = hapd->sta_list; sta; sta = sta->next) {
+		h = ap_sta_hash(sta->addr, bits);
+		sta->hnext = hash[h];
+		hash[h] = sta;
+	}
+
+	wpa_printf(MSG_DEBUG, "AP: STA hash table resized to %u buckets",
+		   1U << bits);
+	os_free(hapd->sta_hash);
+	hapd->sta_hash = hash;
+	hapd->sta_hash_bits = bits;
+	return 0;
+}
+
+
+/**
+ * ap_sta_hash_add - Add a STA entry to the hash table
+ * @hapd: Pointer to BSS data
+ * @sta: STA entry that has already been added to hapd->sta_list
+ *
+ * The hash table is grown (and all entries in sta_list rehashed) once the
+ * number of stations exceeds the number of buckets. Failure to grow the
+ * table is not fatal; the entry is then added to the current table.
+ */
 void ap_sta_hash_add(struct hostapd_data *hapd, struct sta_info *sta)
 {
-	sta->hnext = hapd->sta_hash[STA_HASH(sta->addr)];
-	hapd->sta_hash[STA_HASH(sta->addr)] = sta;
+	unsigned int h;
+
+	if (hapd->sta_hash == NULL) {
+		ap_sta_hash_resize(hapd, 8);
+		return;
+	}
+
+	if ((unsigned int) hapd->num_sta > 1U << hapd->sta_hash_bits &&
+	    hapd->sta_hash_bits < 16 &&
+	    ap_sta_hash_resize(hapd, hapd->sta_hash_bits + 1) == 0)
+		return;
+
+	h = ap_sta_hash(sta->addr, hapd->sta_hash_bits);
+	sta->hnext = hapd->sta_hash[h];
+	hapd->sta_hash[h] = sta;
 }
 
 
 static void ap_sta_hash_del(struct hostapd_data *hapd, struct sta_info *sta)
 {
-	struct sta_info *s;
+	struct sta_info **s;
 
-	s = hapd->sta_hash[STA_HASH(sta->addr)];
-	if (s == NULL) return;
-	if (os_memcmp(s->addr, sta->addr, 6) == 0) {
-		hapd->sta_hash[STA_HASH(sta->addr)] = s->hnext;
+	if (hapd->sta_hash == NULL)
 		return;
-	}
 
-	while (s->hnext != NULL &&
-	       os_memcmp(s->hnext->addr, sta->addr, ETH_ALEN) != 0)
-		s = s->hnext;
-	if (s->hnext != NULL)
-		s->hnext = s->hnext->hnext;
+	s = &hapd->sta_hash[ap_sta_hash(sta->addr, hapd->sta_hash_bits)];
+	while (*s != NULL && *s != sta)
+		s = &(*s)->hnext;
+	if (*s != NULL)
+		*s = sta->hnext;
 	else
 		wpa_printf(MSG_DEBUG, "AP: could not remove STA " MACSTR
 			   " from hash table", MAC2STR(sta->addr));
@@ -351,6 +405,11 @@ void hostapd_free_stas(struct hostapd_data *hapd)
 			   MAC2STR(prev->addr));
 		ap_free_sta(hapd, prev);
 	}
+
+	/* Allocated again when the next station is added */
+	os_free(hapd->sta_hash);
+	hapd->sta_hash = NULL;
+	hapd->sta_hash_bits = 0;
 }
 
 
@@ -630,6 +689,11 @@ struct sta_info * ap_sta_add(struct hostapd_data *hapd, const u8 *addr)
 		return NULL;
 	}
 
+	if (hapd->sta_hash == NULL && ap_sta_hash_resize(hapd, 8) < 0) {
+		wpa_printf(MSG_ERROR, "malloc failed");
+		return NULL;
+	}
+
 	sta = os_zalloc(sizeof(struct sta_info));
 	if (sta == NULL) {
 		wpa_printf(MSG_ERROR, "malloc failed");
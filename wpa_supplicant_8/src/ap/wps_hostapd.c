@@ -162,6 +162,7 @@ static int hostapd_wps_set_ie_cb(void *ctx, struct wpabuf *beacon_ie,
 	hapd->wps_beacon_ie = beacon_ie;
 	wpabuf_free(hapd->wps_probe_resp_ie);
 	hapd->wps_probe_resp_ie = probe_resp_ie;
+	hostapd_flush_probe_resp_tmpl(hapd);
 	if (hapd->beacon_set_done)
 		ieee802_11_set_beacon(hapd);
 	return hostapd_set_ap_wps_ie(hapd);
@@ -872,6 +873,7 @@ static void hostapd_wps_clear_ies(struct hostapd_data *hapd, int deinit_only)
 
 	wpabuf_free(hapd->wps_probe_resp_ie);
 	hapd->wps_probe_resp_ie = NULL;
+	hostapd_flush_probe_resp_tmpl(hapd);
 
 	if (deinit_only) {
 		if (hapd->drv_priv)
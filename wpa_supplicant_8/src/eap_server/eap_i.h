@@ -167,6 +167,7 @@ struct eap_sm {
 	int init_phase2;
 	void *ssl_ctx;
 	struct eap_sim_db_data *eap_sim_db_priv;
+	struct eap_tls_offload_data *tls_offload;
 	Boolean backend_auth;
 	Boolean update_user;
 	int eap_server;
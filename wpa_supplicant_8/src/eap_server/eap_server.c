@@ -1828,6 +1828,7 @@ struct eap_sm * eap_server_sm_init(void *eapol_ctx,
 	sm->ssl_ctx = conf->ssl_ctx;
 	sm->msg_ctx = conf->msg_ctx;
 	sm->eap_sim_db_priv = conf->eap_sim_db_priv;
+	sm->tls_offload = conf->tls_offload;
 	sm->backend_auth = conf->backend_auth;
 	sm->eap_server = conf->eap_server;
 	if (conf->pac_opaque_encr_key) {
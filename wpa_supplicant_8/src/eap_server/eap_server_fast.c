@@ -1459,6 +1459,9 @@ static int eap_fast_process_phase1(struct eap_sm *sm,
 		return -1;
 	}
 
+	if (data->ssl.offload_pending)
+		return 1;
+
 	if (!tls_connection_established(sm->ssl_ctx, data->ssl.conn) ||
 	    wpabuf_len(data->ssl.tls_out) > 0)
 		return 1;
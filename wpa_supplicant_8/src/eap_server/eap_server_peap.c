@@ -1232,7 +1232,7 @@ static void eap_peap_process(struct eap_sm *sm, void *priv,
 		return;
 	}
 
-	if (data->state == SUCCESS ||
+	if (data->state == SUCCESS || data->ssl.offload_pending ||
 	    !tls_connection_established(sm->ssl_ctx, data->ssl.conn) ||
 	    !tls_connection_resumed(sm->ssl_ctx, data->ssl.conn))
 		return;
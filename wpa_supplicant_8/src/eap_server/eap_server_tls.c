@@ -263,7 +263,8 @@ static void eap_tls_process(struct eap_sm *sm, void *priv,
 		return;
 	}
 
-	if (!tls_connection_established(sm->ssl_ctx, data->ssl.conn) ||
+	if (data->ssl.offload_pending ||
+	    !tls_connection_established(sm->ssl_ctx, data->ssl.conn) ||
 	    !tls_connection_resumed(sm->ssl_ctx, data->ssl.conn))
 		return;
 
@@ -13,6 +13,7 @@
 #include "crypto/tls.h"
 #include "eap_i.h"
 #include "eap_tls_common.h"
+#include "eap_tls_offload.h"
 
 
 static void eap_server_tls_free_in_buf(struct eap_ssl_data *data);
@@ -99,6 +100,10 @@ int eap_server_tls_ssl_init(struct eap_sm *sm, struct eap_ssl_data *data,
 
 void eap_server_tls_ssl_deinit(struct eap_sm *sm, struct eap_ssl_data *data)
 {
+	if (data->offload_pending) {
+		eap_tls_offload_cancel(sm->tls_offload, data->conn);
+		data->offload_pending = 0;
+	}
 	tls_connection_deinit(sm->ssl_ctx, data->conn);
 	eap_server_tls_free_in_buf(data);
 	wpabuf_free(data->tls_out);
@@ -305,6 +310,8 @@ static int eap_server_tls_process_fragment(struct eap_ssl_data *data,
 
 int eap_server_tls_phase1(struct eap_sm *sm, struct eap_ssl_data *data)
 {
+	int res;
+
 	if (data->tls_out) {
 		/* This should not happen.. */
 		wpa_printf(MSG_INFO, "SSL: pending tls_out data when "
@@ -313,9 +320,34 @@ int eap_server_tls_phase1(struct eap_sm *sm, struct eap_ssl_data *data)
 		WPA_ASSERT(data->tls_out == NULL);
 	}
 
-	data->tls_out = tls_connection_server_handshake(sm->ssl_ctx,
-							data->conn,
-							data->tls_in, NULL);
+	if (data->offload_pending) {
+		/* Message is processed again after the offloaded step */
+		res = eap_tls_offload_get(sm->tls_offload, data->conn,
+					  &data->tls_out);
+		if (res == 0) {
+			sm->method_pending = METHOD_PENDING_WAIT;
+			return 0;
+		}
+		data->offload_pending = 0;
+		if (res < 0) {
+			wpa_printf(MSG_INFO, "SSL: No result for offloaded "
+				   "TLS processing");
+			return -1;
+		}
+	} else if (sm->tls_offload && !data->phase2 &&
+		   eap_tls_offload_start(sm->tls_offload, sm->ssl_ctx,
+					 data->conn, data->tls_in, sm) == 0) {
+		wpa_printf(MSG_DEBUG, "SSL: TLS processing offloaded - wait "
+			   "for completion");
+		data->offload_pending = 1;
+		sm->method_pending = METHOD_PENDING_WAIT;
+		return 0;
+	} else {
+		data->tls_out = tls_connection_server_handshake(sm->ssl_ctx,
+								data->conn,
+								data->tls_in,
+								NULL);
+	}
 	if (data->tls_out == NULL) {
 		wpa_printf(MSG_INFO, "SSL: TLS processing failed");
 		return -1;
@@ -467,7 +499,8 @@ int eap_server_tls_process(struct eap_sm *sm, struct eap_ssl_data *data,
 	if (proc_msg)
 		proc_msg(sm, priv, respData);
 
-	if (tls_connection_get_write_alerts(sm->ssl_ctx, data->conn) > 1) {
+	if (!data->offload_pending &&
+	    tls_connection_get_write_alerts(sm->ssl_ctx, data->conn) > 1) {
 		wpa_printf(MSG_INFO, "SSL: Locally detected fatal error in "
 			   "TLS processing");
 		res = -1;
@@ -50,6 +50,15 @@ struct eap_ssl_data {
 
 	enum { MSG, FRAG_ACK, WAIT_FRAG_ACK } state;
 	struct wpabuf tmpbuf;
+
+	/**
+	 * offload_pending - Whether a handshake step is in eap_tls_offload
+	 *
+	 * conn must not be used while this is set. The EAP method is in
+	 * pending state and the received message is processed again once
+	 * the step has completed.
+	 */
+	int offload_pending;
 };
 
 
@@ -0,0 +1,382 @@
+/*
+ * hostapd / EAP server TLS handshake offload
+ *
+ * This software may be distributed under the terms of the BSD license.
+ * See README for more details.
+ *
+ * The public key operations of a full TLS handshake take long enough to stall
+ * all other processing in the event loop when many EAP-TLS/PEAP/TTLS
+ * authentications are in progress at the same time. This module runs
+ * tls_connection_server_handshake() for a connection in a pool of worker
+ * threads while the EAP method waits in the pending state, similarly to
+ * EAP-SIM/AKA waiting for the authentication gateway. Completion is reported
+ * back to the event loop through a pipe and then to the EAP server through
+ * the callback registered in eap_tls_offload_init().
+ *
+ * The TLS library needs to allow different connections to be used from
+ * different threads at the same time. A connection is only ever used by one
+ * thread at a time: the EAP method does not touch it while a handshake step
+ * is pending and eap_tls_offload_cancel() waits for a running step to
+ * complete.
+ */
+
+#include "includes.h"
+#include <fcntl.h>
+#include <pthread.h>
+
+#include "common.h"
+#include "list.h"
+#include "eloop.h"
+#include "crypto/tls.h"
+#include "eap_tls_offload.h"
+
+
+enum eap_tls_offload_state {
+	EAP_TLS_OFFLOAD_QUEUED,
+	EAP_TLS_OFFLOAD_RUNNING,
+	EAP_TLS_OFFLOAD_DONE
+};
+
+struct eap_tls_offload_job {
+	struct dl_list list;
+	enum eap_tls_offload_state state;
+	int notified;
+	void *ssl_ctx;
+	struct tls_connection *conn;
+	struct wpabuf *in_data;
+	struct wpabuf *out_data;
+	void *session_ctx;
+};
+
+struct eap_tls_offload_data {
+	pthread_mutex_t lock;
+	pthread_cond_t work_cond; /* job queued or stop requested */
+	pthread_cond_t done_cond; /* job completed */
+	struct dl_list jobs; /* struct eap_tls_offload_job, in queue order */
+	int stop;
+
+	pthread_t *threads;
+	int num_threads;
+	int pipe_fd[2];
+
+	void (*complete_cb)(void *ctx, void *session_ctx);
+	void *ctx;
+};
+
+
+static struct eap_tls_offload_job *
+eap_tls_offload_find(struct eap_tls_offload_data *data,
+		     struct tls_connection *conn)
+{
+	struct eap_tls_offload_job *job;
+
+	dl_list_for_each(job, &data->jobs, struct eap_tls_offload_job, list) {
+		if (job->conn == conn)
+			return job;
+	}
+	return NULL;
+}
+
+
+static void eap_tls_offload_free_job(struct eap_tls_offload_job *job)
+{
+	wpabuf_free(job->in_data);
+	wpabuf_free(job->out_data);
+	os_free(job);
+}
+
+
+static void * eap_tls_offload_thread(void *arg)
+{
+	struct eap_tls_offload_data *data = arg;
+	struct eap_tls_offload_job *job;
+	struct wpabuf *out;
+
+	pthread_mutex_lock(&data->lock);
+	while (!data->stop) {
+		dl_list_for_each(job, &data->jobs, struct eap_tls_offload_job,
+				 list) {
+			if (job->state == EAP_TLS_OFFLOAD_QUEUED)
+				break;
+		}
+		if (&job->list == &data->jobs) {
+			pthread_cond_wait(&data->work_cond, &data->lock);
+			continue;
+		}
+
+		job->state = EAP_TLS_OFFLOAD_RUNNING;
+		pthread_mutex_unlock(&data->lock);
+
+		out = tls_connection_server_handshake(job->ssl_ctx, job->conn,
+						      job->in_data, NULL);
+
+		pthread_mutex_lock(&data->lock);
+		job->out_data = out;
+		job->state = EAP_TLS_OFFLOAD_DONE;
+		pthread_cond_broadcast(&data->done_cond);
+		if (write(data->pipe_fd[1], "", 1) < 0 && errno != EAGAIN)
+			wpa_printf(MSG_ERROR, "TLS offload: write: %s",
+				   strerror(errno));
+	}
+	pthread_mutex_unlock(&data->lock);
+
+	return NULL;
+}
+
+
+static void eap_tls_offload_receive(int sock, void *eloop_ctx, void *sock_ctx)
+{
+	struct eap_tls_offload_data *data = eloop_ctx;
+	struct eap_tls_offload_job *job;
+	void *session_ctx;
+	char buf[64];
+
+	while (read(sock, buf, sizeof(buf)) > 0)
+		;
+
+	/*
+	 * The callback may fetch the result (and free the job) or cancel other
+	 * jobs, so the lock cannot be held over it and the list is rescanned
+	 * after each call.
+	 */
+	for (;;) {
+		session_ctx = NULL;
+		pthread_mutex_lock(&data->lock);
+		dl_list_for_each(job, &data->jobs, struct eap_tls_offload_job,
+				 list) {
+			if (job->state == EAP_TLS_OFFLOAD_DONE &&
+			    !job->notified) {
+				job->notified = 1;
+				session_ctx = job->session_ctx;
+				break;
+			}
+		}
+		pthread_mutex_unlock(&data->lock);
+		if (session_ctx == NULL)
+			break;
+		data->complete_cb(data->ctx, session_ctx);
+	}
+}
+
+
+/**
+ * eap_tls_offload_init - Initialize TLS handshake offload
+ * @num_threads: Number of worker threads
+ * @complete_cb: Callback function for reporting completion of a handshake step
+ * @ctx: Context pointer for complete_cb
+ * Returns: Pointer to private data or %NULL on failure
+ */
+struct eap_tls_offload_data *
+eap_tls_offload_init(int num_threads,
+		     void (*complete_cb)(void *ctx, void *session_ctx),
+		     void *ctx)
+{
+	struct eap_tls_offload_data *data;
+	int i;
+
+	if (num_threads <= 0)
+		return NULL;
+
+	data = os_zalloc(sizeof(*data));
+	if (data == NULL)
+		return NULL;
+	data->pipe_fd[0] = data->pipe_fd[1] = -1;
+	data->complete_cb = complete_cb;
+	data->ctx = ctx;
+	dl_list_init(&data->jobs);
+	pthread_mutex_init(&data->lock, NULL);
+	pthread_cond_init(&data->work_cond, NULL);
+	pthread_cond_init(&data->done_cond, NULL);
+
+	if (pipe(data->pipe_fd) < 0) {
+		wpa_printf(MSG_ERROR, "TLS offload: pipe: %s",
+			   strerror(errno));
+		goto fail;
+	}
+	if (fcntl(data->pipe_fd[0], F_SETFL, O_NONBLOCK) < 0 ||
+	    fcntl(data->pipe_fd[1], F_SETFL, O_NONBLOCK) < 0 ||
+	    eloop_register_read_sock(data->pipe_fd[0],
+				     eap_tls_offload_receive, data, NULL) < 0)
+		goto fail;
+
+	data->threads = os_calloc(num_threads, sizeof(pthread_t));
+	if (data->threads == NULL)
+		goto fail;
+	for (i = 0; i < num_threads; i++) {
+		if (pthread_create(&data->threads[i], NULL,
+				   eap_tls_offload_thread, data) != 0) {
+			wpa_printf(MSG_ERROR,
+				   "TLS offload: Failed to start thread");
+			goto fail;
+		}
+		data->num_threads++;
+	}
+
+	wpa_printf(MSG_DEBUG, "TLS offload: Started %d worker thread(s)",
+		   data->num_threads);
+	return data;
+
+fail:
+	eap_tls_offload_deinit(data);
+	return NULL;
+}
+
+
+/**
+ * eap_tls_offload_deinit - Deinitialize TLS handshake offload
+ * @data: Private data from eap_tls_offload_init()
+ *
+ * All connections need to have been cancelled with eap_tls_offload_cancel()
+ * before this is called.
+ */
+void eap_tls_offload_deinit(struct eap_tls_offload_data *data)
+{
+	struct eap_tls_offload_job *job, *tmp;
+	int i;
+
+	if (data == NULL)
+		return;
+
+	pthread_mutex_lock(&data->lock);
+	data->stop = 1;
+	pthread_cond_broadcast(&data->work_cond);
+	pthread_mutex_unlock(&data->lock);
+	for (i = 0; i < data->num_threads; i++)
+		pthread_join(data->threads[i], NULL);
+	os_free(data->threads);
+
+	dl_list_for_each_safe(job, tmp, &data->jobs,
+			      struct eap_tls_offload_job, list) {
+		dl_list_del(&job->list);
+		eap_tls_offload_free_job(job);
+	}
+
+	if (data->pipe_fd[0] >= 0) {
+		eloop_unregister_read_sock(data->pipe_fd[0]);
+		close(data->pipe_fd[0]);
+	}
+	if (data->pipe_fd[1] >= 0)
+		close(data->pipe_fd[1]);
+
+	pthread_cond_destroy(&data->done_cond);
+	pthread_cond_destroy(&data->work_cond);
+	pthread_mutex_destroy(&data->lock);
+	os_free(data);
+}
+
+
+/**
+ * eap_tls_offload_start - Queue a server handshake step for a connection
+ * @data: Private data from eap_tls_offload_init()
+ * @ssl_ctx: TLS context data from tls_init()
+ * @conn: Connection context data from tls_connection_init()
+ * @in_data: Input data from the TLS peer
+ * Returns: 0 if the step was queued or -1 on failure
+ *
+ * The caller must not use conn until eap_tls_offload_get() has returned the
+ * result or eap_tls_offload_cancel() has been called. Completion is reported
+ * through the complete_cb callback with session_ctx.
+ */
+int eap_tls_offload_start(struct eap_tls_offload_data *data, void *ssl_ctx,
+			  struct tls_connection *conn,
+			  const struct wpabuf *in_data, void *session_ctx)
+{
+	struct eap_tls_offload_job *job;
+
+	if (data == NULL)
+		return -1;
+
+	job = os_zalloc(sizeof(*job));
+	if (job == NULL)
+		return -1;
+	if (in_data) {
+		job->in_data = wpabuf_dup(in_data);
+		if (job->in_data == NULL) {
+			os_free(job);
+			return -1;
+		}
+	}
+	job->ssl_ctx = ssl_ctx;
+	job->conn = conn;
+	job->session_ctx = session_ctx;
+	job->state = EAP_TLS_OFFLOAD_QUEUED;
+
+	pthread_mutex_lock(&data->lock);
+	if (eap_tls_offload_find(data, conn)) {
+		pthread_mutex_unlock(&data->lock);
+		wpa_printf(MSG_INFO,
+			   "TLS offload: Handshake step already pending");
+		eap_tls_offload_free_job(job);
+		return -1;
+	}
+	dl_list_add_tail(&data->jobs, &job->list);
+	pthread_cond_signal(&data->work_cond);
+	pthread_mutex_unlock(&data->lock);
+
+	return 0;
+}
+
+
+/**
+ * eap_tls_offload_get - Fetch the result of a handshake step
+ * @data: Private data from eap_tls_offload_init()
+ * @conn: Connection context data from tls_connection_init()
+ * @out_data: Buffer for returning the output of
+ *	tls_connection_server_handshake(), which may be %NULL
+ * Returns: 1 if the result was returned, 0 if the step has not yet completed,
+ * or -1 if no step is pending for conn
+ */
+int eap_tls_offload_get(struct eap_tls_offload_data *data,
+			struct tls_connection *conn, struct wpabuf **out_data)
+{
+	struct eap_tls_offload_job *job;
+
+	if (data == NULL)
+		return -1;
+
+	pthread_mutex_lock(&data->lock);
+	job = eap_tls_offload_find(data, conn);
+	if (job == NULL || job->state != EAP_TLS_OFFLOAD_DONE) {
+		pthread_mutex_unlock(&data->lock);
+		return job ? 0 : -1;
+	}
+	dl_list_del(&job->list);
+	pthread_mutex_unlock(&data->lock);
+
+	*out_data = job->out_data;
+	job->out_data = NULL;
+	eap_tls_offload_free_job(job);
+	return 1;
+}
+
+
+/**
+ * eap_tls_offload_cancel - Cancel a pending handshake step
+ * @data: Private data from eap_tls_offload_init()
+ * @conn: Connection context data from tls_connection_init()
+ *
+ * If the step is currently being processed, this waits for it to complete so
+ * that conn can be freed once this function returns.
+ */
+void eap_tls_offload_cancel(struct eap_tls_offload_data *data,
+			    struct tls_connection *conn)
+{
+	struct eap_tls_offload_job *job;
+
+	if (data == NULL)
+		return;
+
+	pthread_mutex_lock(&data->lock);
+	job = eap_tls_offload_find(data, conn);
+	if (job == NULL) {
+		pthread_mutex_unlock(&data->lock);
+		return;
+	}
+	while (job->state == EAP_TLS_OFFLOAD_RUNNING)
+		pthread_cond_wait(&data->done_cond, &data->lock);
+	dl_list_del(&job->list);
+	pthread_mutex_unlock(&data->lock);
+
+	wpa_printf(MSG_DEBUG, "TLS offload: Cancelled pending handshake step");
+	eap_tls_offload_free_job(job);
+}
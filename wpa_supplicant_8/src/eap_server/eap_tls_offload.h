@@ -0,0 +1,66 @@
+/*
+ * hostapd / EAP server TLS handshake offload
+ *
+ * This software may be distributed under the terms of the BSD license.
+ * See README for more details.
+ */
+
+#ifndef EAP_TLS_OFFLOAD_H
+#define EAP_TLS_OFFLOAD_H
+
+struct tls_connection;
+struct eap_tls_offload_data;
+
+#ifdef CONFIG_TLS_OFFLOAD
+
+struct eap_tls_offload_data *
+eap_tls_offload_init(int num_threads,
+		     void (*complete_cb)(void *ctx, void *session_ctx),
+		     void *ctx);
+void eap_tls_offload_deinit(struct eap_tls_offload_data *data);
+int eap_tls_offload_start(struct eap_tls_offload_data *data, void *ssl_ctx,
+			  struct tls_connection *conn,
+			  const struct wpabuf *in_data, void *session_ctx);
+int eap_tls_offload_get(struct eap_tls_offload_data *data,
+			struct tls_connection *conn, struct wpabuf **out_data);
+void eap_tls_offload_cancel(struct eap_tls_offload_data *data,
+			    struct tls_connection *conn);
+
+#else /* CONFIG_TLS_OFFLOAD */
+
+static inline struct eap_tls_offload_data *
+eap_tls_offload_init(int num_threads,
+		     void (*complete_cb)(void *ctx, void *session_ctx),
+		     void *ctx)
+{
+	return NULL;
+}
+
+static inline void eap_tls_offload_deinit(struct eap_tls_offload_data *data)
+{
+}
+
+static inline int eap_tls_offload_start(struct eap_tls_offload_data *data,
+					void *ssl_ctx,
+					struct tls_connection *conn,
+					const struct wpabuf *in_data,
+					void *session_ctx)
+{
+	return -1;
+}
+
+static inline int eap_tls_offload_get(struct eap_tls_offload_data *data,
+				      struct tls_connection *conn,
+				      struct wpabuf **out_data)
+{
+	return -1;
+}
+
+static inline void eap_tls_offload_cancel(struct eap_tls_offload_data *data,
+					  struct tls_connection *conn)
+{
+}
+
+#endif /* CONFIG_TLS_OFFLOAD */
+
+#endif /* EAP_TLS_OFFLOAD_H */
@@ -828,6 +828,7 @@ eapol_auth_alloc(struct eapol_authenticator *eapol, const u8 *addr,
 	eap_conf.ssl_ctx = eapol->conf.ssl_ctx;
 	eap_conf.msg_ctx = eapol->conf.msg_ctx;
 	eap_conf.eap_sim_db_priv = eapol->conf.eap_sim_db_priv;
+	eap_conf.tls_offload = eapol->conf.tls_offload;
 	eap_conf.pac_opaque_encr_key = eapol->conf.pac_opaque_encr_key;
 	eap_conf.eap_fast_a_id = eapol->conf.eap_fast_a_id;
 	eap_conf.eap_fast_a_id_len = eapol->conf.eap_fast_a_id_len;
@@ -1191,6 +1192,7 @@ static int eapol_auth_conf_clone(struct eapol_auth_config *dst,
 	dst->ssl_ctx = src->ssl_ctx;
 	dst->msg_ctx = src->msg_ctx;
 	dst->eap_sim_db_priv = src->eap_sim_db_priv;
+	dst->tls_offload = src->tls_offload;
 	os_free(dst->eap_req_id_text);
 	dst->pwd_group = src->pwd_group;
 	dst->pbc_in_m1 = src->pbc_in_m1;
@@ -152,6 +152,15 @@ struct radius_server_data {
 	 */
 	void *eap_sim_db_priv;
 
+	/**
+	 * tls_offload - TLS handshake offload context
+	 *
+	 * This is passed to the EAP-TLS/PEAP/TTLS/FAST server implementations
+	 * to run TLS handshake steps outside the event loop thread. Completion
+	 * is reported with radius_server_eap_pending_cb().
+	 */
+	void *tls_offload;
+
 	/**
 	 * ssl_ctx - TLS context
 	 *
@@ -674,6 +683,7 @@ radius_server_get_new_session(struct radius_server_data *data,
 	eap_conf.ssl_ctx = data->ssl_ctx;
 	eap_conf.msg_ctx = data->msg_ctx;
 	eap_conf.eap_sim_db_priv = data->eap_sim_db_priv;
+	eap_conf.tls_offload = data->tls_offload;
 	eap_conf.backend_auth = TRUE;
 	eap_conf.eap_server = 1;
 	eap_conf.pac_opaque_encr_key = data->pac_opaque_encr_key;
@@ -1709,6 +1719,7 @@ radius_server_init(struct radius_server_conf *conf)
 	os_get_reltime(&data->start_time);
 	data->conf_ctx = conf->conf_ctx;
 	data->eap_sim_db_priv = conf->eap_sim_db_priv;
+	data->tls_offload = conf->tls_offload;
 	data->ssl_ctx = conf->ssl_ctx;
 	data->msg_ctx = conf->msg_ctx;
 	data->ipv6 = conf->ipv6;
@@ -59,6 +59,15 @@ struct radius_server_conf {
 	 */
 	void *eap_sim_db_priv;
 
+	/**
+	 * tls_offload - TLS handshake offload context
+	 *
+	 * This is passed to the EAP-TLS/PEAP/TTLS/FAST server implementations
+	 * to run TLS handshake steps outside the event loop thread. Completion
+	 * is reported with radius_server_eap_pending_cb().
+	 */
+	void *tls_offload;
+
 	/**
 	 * ssl_ctx - TLS context
 	 *
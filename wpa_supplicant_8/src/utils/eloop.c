@@ -11,7 +11,6 @@
 
 #include "common.h"
 #include "trace.h"
-#include "list.h"
 #include "eloop.h"
 
 #if defined(CONFIG_ELOOP_POLL) && defined(CONFIG_ELOOP_EPOLL)
@@ -50,7 +49,8 @@ struct eloop_sock {
 };
 
 struct eloop_timeout {
-	struct dl_list list;
+	int index; /* position in eloop.timeout */
+	u64 seq; /* registration order for timeouts with equal time */
 	struct os_reltime time;
 	void *eloop_data;
 	void *user_data;
@@ -72,6 +72,10 @@ struct eloop_sock_table {
 	struct eloop_sock *table;
 	eloop_event_type type;
 	int changed;
+#ifdef CONFIG_ELOOP_EPOLL
+	int max_fd;
+	struct eloop_sock *fd_table;
+#endif /* CONFIG_ELOOP_EPOLL */
 };
 
 struct eloop_data {
@@ -84,10 +88,10 @@ struct eloop_data {
 	struct pollfd *pollfds;
 	struct pollfd **pollfds_map;
 #endif /* CONFIG_ELOOP_POLL */
-#if defined(CONFIG_ELOOP_EPOLL) || defined(CONFIG_ELOOP_KQUEUE)
+#ifdef CONFIG_ELOOP_KQUEUE
 	int max_fd;
 	struct eloop_sock *fd_table;
-#endif /* CONFIG_ELOOP_EPOLL || CONFIG_ELOOP_KQUEUE */
+#endif /* CONFIG_ELOOP_KQUEUE */
 #ifdef CONFIG_ELOOP_EPOLL
 	int epollfd;
 	int epoll_max_event_num;
@@ -102,7 +106,11 @@ struct eloop_data {
 	struct eloop_sock_table writers;
 	struct eloop_sock_table exceptions;
 
-	struct dl_list timeout;
+	/* Binary min-heap of pending timeouts ordered by (time, seq) */
+	struct eloop_timeout **timeout;
+	int timeout_count;
+	int max_timeout;
+	u64 timeout_seq;
 
 	int signal_count;
 	struct eloop_signal *signals;
@@ -161,7 +169,6 @@ static void eloop_trace_sock_remove_ref(struct eloop_sock_table *table)
 int eloop_init(void)
 {
 	os_memset(&eloop, 0, sizeof(eloop));
-	dl_list_init(&eloop.timeout);
 #ifdef CONFIG_ELOOP_EPOLL
 	eloop.epollfd = epoll_create1(0);
 	if (eloop.epollfd < 0) {
@@ -191,31 +198,87 @@ int eloop_init(void)
 
 
 #ifdef CONFIG_ELOOP_EPOLL
-static int eloop_sock_queue(int sock, eloop_event_type type)
+static struct eloop_sock * eloop_sock_table_get_fd(
+	struct eloop_sock_table *table, int sock)
 {
-	struct epoll_event ev;
+	if (sock >= table->max_fd || table->fd_table[sock].handler == NULL)
+		return NULL;
+	return &table->fd_table[sock];
+}
 
-	os_memset(&ev, 0, sizeof(ev));
-	switch (type) {
+
+static u32 eloop_sock_events(struct eloop_sock_table *table)
+{
+	switch (table->type) {
 	case EVENT_TYPE_READ:
-		ev.events = EPOLLIN;
-		break;
+		return EPOLLIN;
 	case EVENT_TYPE_WRITE:
-		ev.events = EPOLLOUT;
-		break;
+		return EPOLLOUT;
 	/*
 	 * Exceptions are always checked when using epoll, but I suppose it's
 	 * possible that someone registered a socket *only* for exception
 	 * handling.
 	 */
 	case EVENT_TYPE_EXCEPTION:
-		ev.events = EPOLLERR | EPOLLHUP;
-		break;
+		return EPOLLERR | EPOLLHUP;
 	}
+	return 0;
+}
+
+
+/*
+ * A socket has a single epoll registration even when it is in more than one
+ * of the socket tables (e.g., read and exception for D-Bus watches), so the
+ * event mask is the union of the tables other than @skip that contain it.
+ */
+static u32 eloop_sock_other_events(int sock, struct eloop_sock_table *skip)
+{
+	struct eloop_sock_table *tables[] = {
+		&eloop.readers, &eloop.writers, &eloop.exceptions
+	};
+	u32 events = 0;
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(tables); i++) {
+		if (tables[i] != skip && eloop_sock_table_get_fd(tables[i], sock))
+			events |= eloop_sock_events(tables[i]);
+	}
+	return events;
+}
+
+
+static int eloop_sock_queue(struct eloop_sock_table *table, int sock)
+{
+	struct epoll_event ev;
+	u32 others = eloop_sock_other_events(sock, table);
+	int op = others ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+
+	os_memset(&ev, 0, sizeof(ev));
+	ev.events = others | eloop_sock_events(table);
 	ev.data.fd = sock;
-	if (epoll_ctl(eloop.epollfd, EPOLL_CTL_ADD, sock, &ev) < 0) {
-		wpa_printf(MSG_ERROR, "%s: epoll_ctl(ADD) for fd=%d failed: %s",
-			   __func__, sock, strerror(errno));
+	if (epoll_ctl(eloop.epollfd, op, sock, &ev) < 0) {
+		wpa_printf(MSG_ERROR, "%s: epoll_ctl(%s) for fd=%d failed: %s",
+			   __func__, others ? "MOD" : "ADD", sock,
+			   strerror(errno));
+		return -1;
+	}
+	return 0;
+}
+
+
+static int eloop_sock_dequeue(struct eloop_sock_table *table, int sock)
+{
+	struct epoll_event ev;
+	u32 others = eloop_sock_other_events(sock, table);
+	int op = others ? EPOLL_CTL_MOD : EPOLL_CTL_DEL;
+
+	os_memset(&ev, 0, sizeof(ev));
+	ev.events = others;
+	ev.data.fd = sock;
+	if (epoll_ctl(eloop.epollfd, op, sock, &ev) < 0) {
+		wpa_printf(MSG_ERROR, "%s: epoll_ctl(%s) for fd=%d failed: %s",
+			   __func__, others ? "MOD" : "DEL", sock,
+			   strerror(errno));
 		return -1;
 	}
 	return 0;
@@ -299,7 +362,23 @@ static int eloop_sock_table_add_sock(struct eloop_sock_table *table,
 		eloop.pollfds = n;
 	}
 #endif /* CONFIG_ELOOP_POLL */
-#if defined(CONFIG_ELOOP_EPOLL) || defined(CONFIG_ELOOP_KQUEUE)
+#ifdef CONFIG_ELOOP_EPOLL
+	if (sock >= table->max_fd) {
+		next = table->max_fd == 0 ? 16 : table->max_fd * 2;
+		while (sock >= next)
+			next *= 2;
+		temp_table = os_realloc_array(table->fd_table, next,
+					      sizeof(struct eloop_sock));
+		if (temp_table == NULL)
+			return -1;
+
+		os_memset(&temp_table[table->max_fd], 0,
+			  (next - table->max_fd) * sizeof(struct eloop_sock));
+		table->max_fd = next;
+		table->fd_table = temp_table;
+	}
+#endif /* CONFIG_ELOOP_EPOLL */
+#ifdef CONFIG_ELOOP_KQUEUE
 	if (new_max_sock >= eloop.max_fd) {
 		next = eloop.max_fd == 0 ? 16 : eloop.max_fd * 2;
 		temp_table = os_realloc_array(eloop.fd_table, next,
@@ -310,7 +389,7 @@ static int eloop_sock_table_add_sock(struct eloop_sock_table *table,
 		eloop.max_fd = next;
 		eloop.fd_table = temp_table;
 	}
-#endif /* CONFIG_ELOOP_EPOLL || CONFIG_ELOOP_KQUEUE */
+#endif /* CONFIG_ELOOP_KQUEUE */
 
 #ifdef CONFIG_ELOOP_EPOLL
 	if (eloop.count + 1 > eloop.epoll_max_event_num) {
@@ -365,12 +444,18 @@ static int eloop_sock_table_add_sock(struct eloop_sock_table *table,
 	table->changed = 1;
 	eloop_trace_sock_add_ref(table);
 
-#if defined(CONFIG_ELOOP_EPOLL) || defined(CONFIG_ELOOP_KQUEUE)
+#ifdef CONFIG_ELOOP_EPOLL
+	if (eloop_sock_queue(table, sock) < 0)
+		return -1;
+	os_memcpy(&table->fd_table[sock], &table->table[table->count - 1],
+		  sizeof(struct eloop_sock));
+#endif /* CONFIG_ELOOP_EPOLL */
+#ifdef CONFIG_ELOOP_KQUEUE
 	if (eloop_sock_queue(sock, table->type) < 0)
 		return -1;
 	os_memcpy(&eloop.fd_table[sock], &table->table[table->count - 1],
 		  sizeof(struct eloop_sock));
-#endif /* CONFIG_ELOOP_EPOLL || CONFIG_ELOOP_KQUEUE */
+#endif /* CONFIG_ELOOP_KQUEUE */
 	return 0;
 }
 
@@ -403,12 +488,9 @@ static void eloop_sock_table_remove_sock(struct eloop_sock_table *table,
 	table->changed = 1;
 	eloop_trace_sock_add_ref(table);
 #ifdef CONFIG_ELOOP_EPOLL
-	if (epoll_ctl(eloop.epollfd, EPOLL_CTL_DEL, sock, NULL) < 0) {
-		wpa_printf(MSG_ERROR, "%s: epoll_ctl(DEL) for fd=%d failed: %s",
-			   __func__, sock, strerror(errno));
-		return;
-	}
-	os_memset(&eloop.fd_table[sock], 0, sizeof(struct eloop_sock));
+	if (sock < table->max_fd)
+		os_memset(&table->fd_table[sock], 0, sizeof(struct eloop_sock));
+	eloop_sock_dequeue(table, sock);
 #endif /* CONFIG_ELOOP_EPOLL */
 #ifdef CONFIG_ELOOP_KQUEUE
 	EV_SET(&ke, sock, 0, EV_DELETE, 0, 0, 0);
@@ -605,20 +687,39 @@ static void eloop_sock_table_dispatch(struct eloop_sock_table *table,
 
 
 #ifdef CONFIG_ELOOP_EPOLL
+static int eloop_sock_table_dispatch_fd(struct eloop_sock_table *table,
+					int sock)
+{
+	struct eloop_sock *s = eloop_sock_table_get_fd(table, sock);
+
+	if (s == NULL)
+		return 0;
+	s->handler(s->sock, s->eloop_data, s->user_data);
+	return eloop.readers.changed || eloop.writers.changed ||
+		eloop.exceptions.changed;
+}
+
+
 static void eloop_sock_table_dispatch(struct epoll_event *events, int nfds)
 {
-	struct eloop_sock *table;
 	int i;
 
+	/*
+	 * Errors and hangups are reported to the read and write handlers as
+	 * well, matching what select() does for such sockets.
+	 */
 	for (i = 0; i < nfds; i++) {
-		table = &eloop.fd_table[events[i].data.fd];
-		if (table->handler == NULL)
-			continue;
-		table->handler(table->sock, table->eloop_data,
-			       table->user_data);
-		if (eloop.readers.changed ||
-		    eloop.writers.changed ||
-		    eloop.exceptions.changed)
+		int sock = events[i].data.fd;
+		u32 ev = events[i].events;
+
+		if ((ev & (EPOLLIN | EPOLLERR | EPOLLHUP)) &&
+		    eloop_sock_table_dispatch_fd(&eloop.readers, sock))
+			break;
+		if ((ev & (EPOLLOUT | EPOLLERR | EPOLLHUP)) &&
+		    eloop_sock_table_dispatch_fd(&eloop.writers, sock))
+			break;
+		if ((ev & (EPOLLERR | EPOLLHUP)) &&
+		    eloop_sock_table_dispatch_fd(&eloop.exceptions, sock))
 			break;
 	}
 }
@@ -704,6 +805,9 @@ static void eloop_sock_table_destroy(struct eloop_sock_table *table)
 			wpa_trace_dump("eloop sock", &table->table[i]);
 		}
 		os_free(table->table);
+#ifdef CONFIG_ELOOP_EPOLL
+		os_free(table->fd_table);
+#endif /* CONFIG_ELOOP_EPOLL */
 	}
 }
 
@@ -759,11 +863,95 @@ void eloop_unregister_sock(int sock, eloop_event_type type)
 }
 
 
+static int eloop_timeout_before(struct eloop_timeout *a,
+				struct eloop_timeout *b)
+{
+	if (a->time.sec != b->time.sec || a->time.usec != b->time.usec)
+		return os_reltime_before(&a->time, &b->time);
+	return a->seq < b->seq;
+}
+
+
+static void eloop_timeout_set(int i, struct eloop_timeout *timeout)
+{
+	eloop.timeout[i] = timeout;
+	timeout->index = i;
+}
+
+
+static void eloop_timeout_sift_up(int i)
+{
+	struct eloop_timeout *timeout = eloop.timeout[i];
+
+	while (i > 0) {
+		int parent = (i - 1) / 2;
+
+		if (!eloop_timeout_before(timeout, eloop.timeout[parent]))
+			break;
+		eloop_timeout_set(i, eloop.timeout[parent]);
+		i = parent;
+	}
+	eloop_timeout_set(i, timeout);
+}
+
+
+static void eloop_timeout_sift_down(int i)
+{
+	struct eloop_timeout *timeout = eloop.timeout[i];
+
+	for (;;) {
+		int child = 2 * i + 1;
+
+		if (child >= eloop.timeout_count)
+			break;
+		if (child + 1 < eloop.timeout_count &&
+		    eloop_timeout_before(eloop.timeout[child + 1],
+					 eloop.timeout[child]))
+			child++;
+		if (!eloop_timeout_before(eloop.timeout[child], timeout))
+			break;
+		eloop_timeout_set(i, eloop.timeout[child]);
+		i = child;
+	}
+	eloop_timeout_set(i, timeout);
+}
+
+
+static struct eloop_timeout * eloop_first_timeout(void)
+{
+	return eloop.timeout_count > 0 ? eloop.timeout[0] : NULL;
+}
+
+
+/*
+ * Find the earliest pending timeout matching handler, eloop_data, and
+ * user_data so that duplicate registrations are handled in time order.
+ */
+static struct eloop_timeout *
+eloop_find_timeout(eloop_timeout_handler handler, void *eloop_data,
+		   void *user_data)
+{
+	struct eloop_timeout *tmp, *found = NULL;
+	int i;
+
+	for (i = 0; i < eloop.timeout_count; i++) {
+		tmp = eloop.timeout[i];
+		if (tmp->handler == handler &&
+		    tmp->eloop_data == eloop_data &&
+		    tmp->user_data == user_data &&
+		    (found == NULL || eloop_timeout_before(tmp, found)))
+			found = tmp;
+	}
+
+	return found;
+}
+
+
 int eloop_register_timeout(unsigned int secs, unsigned int usecs,
 			   eloop_timeout_handler handler,
 			   void *eloop_data, void *user_data)
 {
-	struct eloop_timeout *timeout, *tmp;
+	struct eloop_timeout *timeout;
 	os_time_t now_sec;
 
 	timeout = os_zalloc(sizeof(*timeout));
@@ -790,6 +978,20 @@ int eloop_register_timeout(unsigned int secs, unsigned int usecs,
 		timeout->time.sec++;
 		timeout->time.usec -= 1000000;
 	}
+	if (eloop.timeout_count == eloop.max_timeout) {
+		struct eloop_timeout **tmp;
+		int next = eloop.max_timeout == 0 ? 16 : eloop.max_timeout * 2;
+
+		tmp = os_realloc_array(eloop.timeout, next,
+				       sizeof(struct eloop_timeout *));
+		if (tmp == NULL) {
+			os_free(timeout);
+			return -1;
+		}
+		eloop.timeout = tmp;
+		eloop.max_timeout = next;
+	}
+	timeout->seq = eloop.timeout_seq++;
 	timeout->eloop_data = eloop_data;
 	timeout->user_data = user_data;
 	timeout->handler = handler;
@@ -797,45 +999,91 @@ int eloop_register_timeout(unsigned int secs, unsigned int usecs,
 	wpa_trace_add_ref(timeout, user, user_data);
 	wpa_trace_record(timeout);
 
-	/* Maintain timeouts in order of increasing time */
-	dl_list_for_each(tmp, &eloop.timeout, struct eloop_timeout, list) {
-		if (os_reltime_before(&timeout->time, &tmp->time)) {
-			dl_list_add(tmp->list.prev, &timeout->list);
-			return 0;
-		}
-	}
-	dl_list_add_tail(&eloop.timeout, &timeout->list);
+	eloop_timeout_set(eloop.timeout_count++, timeout);
+	eloop_timeout_sift_up(timeout->index);
 
 	return 0;
 }
 
 
-static void eloop_remove_timeout(struct eloop_timeout *timeout)
+static void eloop_free_timeout(struct eloop_timeout *timeout)
 {
-	dl_list_del(&timeout->list);
 	wpa_trace_remove_ref(timeout, eloop, timeout->eloop_data);
 	wpa_trace_remove_ref(timeout, user, timeout->user_data);
 	os_free(timeout);
 }
 
 
+static void eloop_remove_timeout(struct eloop_timeout *timeout)
+{
+	int i = timeout->index;
+
+	eloop.timeout_count--;
+	if (i != eloop.timeout_count) {
+		eloop_timeout_set(i, eloop.timeout[eloop.timeout_count]);
+		if (i > 0 && eloop_timeout_before(eloop.timeout[i],
+						  eloop.timeout[(i - 1) / 2]))
+			eloop_timeout_sift_up(i);
+		else
+			eloop_timeout_sift_down(i);
+	}
+	eloop_free_timeout(timeout);
+}
+
+
+static int eloop_timeout_match(struct eloop_timeout *timeout,
+			       eloop_timeout_handler handler,
+			       void *eloop_data, void *user_data)
+{
+	return timeout->handler == handler &&
+		(timeout->eloop_data == eloop_data ||
+		 eloop_data == ELOOP_ALL_CTX) &&
+		(timeout->user_data == user_data ||
+		 user_data == ELOOP_ALL_CTX);
+}
+
+
 int eloop_cancel_timeout(eloop_timeout_handler handler,
 			 void *eloop_data, void *user_data)
 {
-	struct eloop_timeout *timeout, *prev;
+	struct eloop_timeout *timeout;
 	int removed = 0;
+	int i, first = -1, count;
 
-	dl_list_for_each_safe(timeout, prev, &eloop.timeout,
-			      struct eloop_timeout, list) {
-		if (timeout->handler == handler &&
-		    (timeout->eloop_data == eloop_data ||
-		     eloop_data == ELOOP_ALL_CTX) &&
-		    (timeout->user_data == user_data ||
-		     user_data == ELOOP_ALL_CTX)) {
-			eloop_remove_timeout(timeout);
+	for (i = 0; i < eloop.timeout_count; i++) {
+		if (eloop_timeout_match(eloop.timeout[i], handler, eloop_data,
+					user_data)) {
+			if (first >= 0)
+				break;
+			first = i;
+		}
+	}
+	if (first < 0)
+		return 0;
+	if (i == eloop.timeout_count) {
+		/* The common case: a single matching timeout */
+		eloop_remove_timeout(eloop.timeout[first]);
+		return 1;
+	}
+
+	/*
+	 * Compact the rest of the heap array in one pass and restore the heap
+	 * property afterwards.
+	 */
+	count = first;
+	for (i = first; i < eloop.timeout_count; i++) {
+		timeout = eloop.timeout[i];
+		if (eloop_timeout_match(timeout, handler, eloop_data,
+					user_data)) {
+			eloop_free_timeout(timeout);
 			removed++;
+		} else {
+			eloop_timeout_set(count++, timeout);
 		}
 	}
+	eloop.timeout_count = count;
+	for (i = count / 2 - 1; i >= 0; i--)
+		eloop_timeout_sift_down(i);
 
 	return removed;
 }
@@ -845,24 +1093,19 @@ int eloop_cancel_timeout_one(eloop_timeout_handler handler,
 			     void *eloop_data, void *user_data,
 			     struct os_reltime *remaining)
 {
-	struct eloop_timeout *timeout, *prev;
+	struct eloop_timeout *timeout;
 	int removed = 0;
 	struct os_reltime now;
 
 	os_get_reltime(&now);
 	remaining->sec = remaining->usec = 0;
 
-	dl_list_for_each_safe(timeout, prev, &eloop.timeout,
-			      struct eloop_timeout, list) {
-		if (timeout->handler == handler &&
-		    (timeout->eloop_data == eloop_data) &&
-		    (timeout->user_data == user_data)) {
-			removed = 1;
-			if (os_reltime_before(&now, &timeout->time))
-				os_reltime_sub(&timeout->time, &now, remaining);
-			eloop_remove_timeout(timeout);
-			break;
-		}
+	timeout = eloop_find_timeout(handler, eloop_data, user_data);
+	if (timeout) {
+		removed = 1;
+		if (os_reltime_before(&now, &timeout->time))
+			os_reltime_sub(&timeout->time, &now, remaining);
+		eloop_remove_timeout(timeout);
 	}
 	return removed;
 }
@@ -872,8 +1115,10 @@ int eloop_is_timeout_registered(eloop_timeout_handler handler,
 				void *eloop_data, void *user_data)
 {
 	struct eloop_timeout *tmp;
+	int i;
 
-	dl_list_for_each(tmp, &eloop.timeout, struct eloop_timeout, list) {
+	for (i = 0; i < eloop.timeout_count; i++) {
+		tmp = eloop.timeout[i];
 		if (tmp->handler == handler &&
 		    tmp->eloop_data == eloop_data &&
 		    tmp->user_data == user_data)
@@ -891,25 +1136,19 @@ int eloop_deplete_timeout(unsigned int req_secs, unsigned int req_usecs,
 	struct os_reltime now, requested, remaining;
 	struct eloop_timeout *tmp;
 
-	dl_list_for_each(tmp, &eloop.timeout, struct eloop_timeout, list) {
-		if (tmp->handler == handler &&
-		    tmp->eloop_data == eloop_data &&
-		    tmp->user_data == user_data) {
-			requested.sec = req_secs;
-			requested.usec = req_usecs;
-			os_get_reltime(&now);
-			os_reltime_sub(&tmp->time, &now, &remaining);
-			if (os_reltime_before(&requested, &remaining)) {
-				eloop_cancel_timeout(handler, eloop_data,
-						     user_data);
-				eloop_register_timeout(requested.sec,
-						       requested.usec,
-						       handler, eloop_data,
-						       user_data);
-				return 1;
-			}
-			return 0;
+	tmp = eloop_find_timeout(handler, eloop_data, user_data);
+	if (tmp) {
+		requested.sec = req_secs;
+		requested.usec = req_usecs;
+		os_get_reltime(&now);
+		os_reltime_sub(&tmp->time, &now, &remaining);
+		if (os_reltime_before(&requested, &remaining)) {
+			eloop_cancel_timeout(handler, eloop_data, user_data);
+			eloop_register_timeout(requested.sec, requested.usec,
+					       handler, eloop_data, user_data);
+			return 1;
 		}
+		return 0;
 	}
 
 	return -1;
@@ -923,25 +1162,19 @@ int eloop_replenish_timeout(unsigned int req_secs, unsigned int req_usecs,
 	struct os_reltime now, requested, remaining;
 	struct eloop_timeout *tmp;
 
-	dl_list_for_each(tmp, &eloop.timeout, struct eloop_timeout, list) {
-		if (tmp->handler == handler &&
-		    tmp->eloop_data == eloop_data &&
-		    tmp->user_data == user_data) {
-			requested.sec = req_secs;
-			requested.usec = req_usecs;
-			os_get_reltime(&now);
-			os_reltime_sub(&tmp->time, &now, &remaining);
-			if (os_reltime_before(&remaining, &requested)) {
-				eloop_cancel_timeout(handler, eloop_data,
-						     user_data);
-				eloop_register_timeout(requested.sec,
-						       requested.usec,
-						       handler, eloop_data,
-						       user_data);
-				return 1;
-			}
-			return 0;
+	tmp = eloop_find_timeout(handler, eloop_data, user_data);
+	if (tmp) {
+		requested.sec = req_secs;
+		requested.usec = req_usecs;
+		os_get_reltime(&now);
+		os_reltime_sub(&tmp->time, &now, &remaining);
+		if (os_reltime_before(&remaining, &requested)) {
+			eloop_cancel_timeout(handler, eloop_data, user_data);
+			eloop_register_timeout(requested.sec, requested.usec,
+					       handler, eloop_data, user_data);
+			return 1;
 		}
+		return 0;
 	}
 
 	return -1;
@@ -1081,7 +1314,7 @@ void eloop_run(void)
 #endif /* CONFIG_ELOOP_SELECT */
 
 	while (!eloop.terminate &&
-	       (!dl_list_empty(&eloop.timeout) || eloop.readers.count > 0 ||
+	       (eloop.timeout_count > 0 || eloop.readers.count > 0 ||
 		eloop.writers.count > 0 || eloop.exceptions.count > 0)) {
 		struct eloop_timeout *timeout;
 
@@ -1098,8 +1331,7 @@ void eloop_run(void)
 				break;
 		}
 
-		timeout = dl_list_first(&eloop.timeout, struct eloop_timeout,
-					list);
+		timeout = eloop_first_timeout();
 		if (timeout) {
 			os_get_reltime(&now);
 			if (os_reltime_before(&now, &timeout->time))
@@ -1107,7 +1339,12 @@ void eloop_run(void)
 			else
 				tv.sec = tv.usec = 0;
 #if defined(CONFIG_ELOOP_POLL) || defined(CONFIG_ELOOP_EPOLL)
-			timeout_ms = tv.sec * 1000 + tv.usec / 1000;
+			/*
+			 * Round up so that the wait does not end just before
+			 * the timeout and leave the loop spinning until it
+			 * expires.
+			 */
+			timeout_ms = tv.sec * 1000 + (tv.usec + 999) / 1000;
 #endif /* defined(CONFIG_ELOOP_POLL) || defined(CONFIG_ELOOP_EPOLL) */
 #ifdef CONFIG_ELOOP_SELECT
 			_tv.tv_sec = tv.sec;
@@ -1136,10 +1373,13 @@ void eloop_run(void)
 #endif /* CONFIG_ELOOP_SELECT */
 #ifdef CONFIG_ELOOP_EPOLL
 		if (eloop.count == 0) {
-			res = 0;
+			struct epoll_event ev;
+
+			/* Nothing is registered, so this only sleeps */
+			res = epoll_wait(eloop.epollfd, &ev, 1, timeout_ms);
 		} else {
 			res = epoll_wait(eloop.epollfd, eloop.epoll_events,
-					 eloop.count, timeout_ms);
+					 eloop.count, timeout ? timeout_ms : -1);
 		}
 #endif /* CONFIG_ELOOP_EPOLL */
 #ifdef CONFIG_ELOOP_KQUEUE
@@ -1178,8 +1418,7 @@ void eloop_run(void)
 
 
 		/* check if some registered timeouts have occurred */
-		timeout = dl_list_first(&eloop.timeout, struct eloop_timeout,
-					list);
+		timeout = eloop_first_timeout();
 		if (timeout) {
 			os_get_reltime(&now);
 			if (!os_reltime_before(&now, &timeout->time)) {
@@ -1246,12 +1485,11 @@ void eloop_terminate(void)
 
 void eloop_destroy(void)
 {
-	struct eloop_timeout *timeout, *prev;
+	struct eloop_timeout *timeout;
 	struct os_reltime now;
 
 	os_get_reltime(&now);
-	dl_list_for_each_safe(timeout, prev, &eloop.timeout,
-			      struct eloop_timeout, list) {
+	while ((timeout = eloop_first_timeout()) != NULL) {
 		int sec, usec;
 		sec = timeout->time.sec - now.sec;
 		usec = timeout->time.usec - now.usec;
@@ -1271,15 +1509,16 @@ void eloop_destroy(void)
 	eloop_sock_table_destroy(&eloop.readers);
 	eloop_sock_table_destroy(&eloop.writers);
 	eloop_sock_table_destroy(&eloop.exceptions);
+	os_free(eloop.timeout);
 	os_free(eloop.signals);
 
 #ifdef CONFIG_ELOOP_POLL
 	os_free(eloop.pollfds);
 	os_free(eloop.pollfds_map);
 #endif /* CONFIG_ELOOP_POLL */
-#if defined(CONFIG_ELOOP_EPOLL) || defined(CONFIG_ELOOP_KQUEUE)
+#ifdef CONFIG_ELOOP_KQUEUE
 	os_free(eloop.fd_table);
-#endif /* CONFIG_ELOOP_EPOLL || CONFIG_ELOOP_KQUEUE */
+#endif /* CONFIG_ELOOP_KQUEUE */
 #ifdef CONFIG_ELOOP_EPOLL
 	os_free(eloop.epoll_events);
 	close(eloop.epollfd);
@@ -823,6 +823,61 @@ static void eloop_tests_run(void *eloop_data, void *user_ctx)
 }
 
 
+static void eloop_test_idle(void *eloop_data, void *user_ctx)
+{
+}
+
+
+static int eloop_timeout_tests(void)
+{
+	struct os_reltime remaining;
+	int i, ret = -1;
+
+	wpa_printf(MSG_INFO, "eloop timeout tests");
+
+	/*
+	 * Far enough in the future not to expire while the module tests run,
+	 * registered in reverse time order; eloop_data is unique so that other
+	 * timeouts are not touched.
+	 */
+	for (i = 0; i < 200; i++) {
+		if (eloop_register_timeout(1000 + (199 - i) / 20, i * 1000,
+					   eloop_test_idle, &ret,
+					   (void *) (intptr_t) (i % 20)) < 0)
+			goto fail;
+	}
+
+	if (!eloop_is_timeout_registered(eloop_test_idle, &ret, (void *) 7) ||
+	    eloop_is_timeout_registered(eloop_test_idle, &ret, (void *) 20) ||
+	    eloop_cancel_timeout(eloop_test_idle, &ret, (void *) 3) != 10 ||
+	    eloop_is_timeout_registered(eloop_test_idle, &ret, (void *) 3))
+		goto fail;
+
+	/* The earliest matching timeout is the one that is cancelled */
+	if (eloop_cancel_timeout_one(eloop_test_idle, &ret, (void *) 4,
+				     &remaining) != 1 ||
+	    remaining.sec < 999 || remaining.sec > 1000 ||
+	    eloop_deplete_timeout(10, 0, eloop_test_idle, &ret,
+				  (void *) 5) != 1 ||
+	    eloop_replenish_timeout(2000, 0, eloop_test_idle, &ret,
+				    (void *) 6) != 1 ||
+	    eloop_deplete_timeout(10, 0, eloop_test_idle, &ret,
+				  (void *) 3) != -1)
+		goto fail;
+
+	if (eloop_cancel_timeout(eloop_test_idle, &ret, ELOOP_ALL_CTX) !=
+	    200 - 10 - 1 - 9 - 9)
+		goto fail;
+
+	ret = 0;
+fail:
+	eloop_cancel_timeout(eloop_test_idle, &ret, ELOOP_ALL_CTX);
+	if (ret)
+		wpa_printf(MSG_ERROR, "eloop timeout test failed");
+	return ret;
+}
+
+
 static int eloop_tests(void)
 {
 	wpa_printf(MSG_INFO, "schedule eloop tests to be run");
@@ -853,6 +908,7 @@ int utils_module_tests(void)
 	    os_tests() < 0 ||
 	    wpabuf_tests() < 0 ||
 	    ip_addr_tests() < 0 ||
+	    eloop_timeout_tests() < 0 ||
 	    eloop_tests() < 0 ||
 	    int_array_tests() < 0)
 		ret = -1;
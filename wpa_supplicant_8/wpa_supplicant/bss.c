@@ -213,10 +213,43 @@ static void wpa_bss_update_pending_connect(struct wpa_supplicant *wpa_s,
 }
 
 
+/*
+ * BSS entries are also chained into wpa_s->bss_hash by BSSID. An entry is put
+ * at the head of its bucket whenever it is added or updated, i.e., whenever it
+ * is moved to the tail of wpa_s->bss, so each bucket lists its entries from the
+ * most to the least recently updated one.
+ */
+static void wpa_bss_hash_add(struct wpa_supplicant *wpa_s, struct wpa_bss *bss)
+{
+	bss->hnext = wpa_s->bss_hash[BSS_HASH(bss->bssid)];
+	wpa_s->bss_hash[BSS_HASH(bss->bssid)] = bss;
+}
+
+
+static void wpa_bss_hash_del(struct wpa_supplicant *wpa_s, struct wpa_bss *bss)
+{
+	struct wpa_bss **pos;
+
+	for (pos = &wpa_s->bss_hash[BSS_HASH(bss->bssid)]; *pos;
+	     pos = &(*pos)->hnext) {
+		if (*pos == bss) {
+			*pos = bss->hnext;
+			bss->hnext = NULL;
+			return;
+		}
+	}
+}
+
+
 static void wpa_bss_remove(struct wpa_supplicant *wpa_s, struct wpa_bss *bss,
 			   const char *reason)
 {
-	if (wpa_s->last_scan_res) {
+	/*
+	 * Only entries updated since the last wpa_bss_update_start() can be
+	 * in last_scan_res, so skip the search for the others.
+	 */
+	if (wpa_s->last_scan_res &&
+	    bss->last_update_idx == wpa_s->bss_update_idx) {
 		unsigned int i;
 		for (i = 0; i < wpa_s->last_scan_res_used; i++) {
 			if (wpa_s->last_scan_res[i] == bss) {
@@ -232,6 +265,7 @@ static void wpa_bss_remove(struct wpa_supplicant *wpa_s, struct wpa_bss *bss,
 	wpa_bss_update_pending_connect(wpa_s, bss, NULL);
 	dl_list_del(&bss->list);
 	dl_list_del(&bss->list_id);
+	wpa_bss_hash_del(wpa_s, bss);
 	wpa_s->num_bss--;
 	wpa_dbg(wpa_s, MSG_DEBUG, "BSS: Remove id %u BSSID " MACSTR
 		" SSID '%s' due to %s", bss->id, MAC2STR(bss->bssid),
@@ -256,7 +290,7 @@ struct wpa_bss * wpa_bss_get(struct wpa_supplicant *wpa_s, const u8 *bssid,
 	struct wpa_bss *bss;
 	if (!wpa_supplicant_filter_bssid_match(wpa_s, bssid))
 		return NULL;
-	dl_list_for_each(bss, &wpa_s->bss, struct wpa_bss, list) {
+	for (bss = wpa_s->bss_hash[BSS_HASH(bssid)]; bss; bss = bss->hnext) {
 		if (os_memcmp(bss->bssid, bssid, ETH_ALEN) == 0 &&
 		    bss->ssid_len == ssid_len &&
 		    os_memcmp(bss->ssid, ssid, ssid_len) == 0)
@@ -406,6 +440,7 @@ static struct wpa_bss * wpa_bss_add(struct wpa_supplicant *wpa_s,
 
 	dl_list_add_tail(&wpa_s->bss, &bss->list);
 	dl_list_add_tail(&wpa_s->bss_id, &bss->list_id);
+	wpa_bss_hash_add(wpa_s, bss);
 	wpa_s->num_bss++;
 	wpa_dbg(wpa_s, MSG_DEBUG, "BSS: Add new id %u BSSID " MACSTR
 		" SSID '%s' freq %d",
@@ -561,6 +596,7 @@ wpa_bss_update(struct wpa_supplicant *wpa_s, struct wpa_bss *bss,
 	wpa_bss_copy_res(bss, res, fetch_time);
 	/* Move the entry to the end of the list */
 	dl_list_del(&bss->list);
+	wpa_bss_hash_del(wpa_s, bss);
 #ifdef CONFIG_P2P
 	if (wpa_bss_get_vendor_ie(bss, P2P_IE_VENDOR_TYPE) &&
 	    !wpa_scan_get_vendor_ie(res, P2P_IE_VENDOR_TYPE)) {
@@ -610,6 +646,7 @@ wpa_bss_update(struct wpa_supplicant *wpa_s, struct wpa_bss *bss,
 	if (changes & WPA_BSS_IES_CHANGED_FLAG)
 		wpa_bss_set_hessid(bss);
 	dl_list_add_tail(&wpa_s->bss, &bss->list);
+	wpa_bss_hash_add(wpa_s, bss);
 
 	notify_bss_changes(wpa_s, changes, bss);
 
@@ -708,16 +745,15 @@ void wpa_bss_update_scan_res(struct wpa_supplicant *wpa_s,
 	if (bss == NULL)
 		bss = wpa_bss_add(wpa_s, ssid + 2, ssid[1], res, fetch_time);
 	else {
+		/*
+		 * An entry that was already updated in this round is already
+		 * in last_scan_res.
+		 */
+		int seen = bss->last_update_idx == wpa_s->bss_update_idx;
+
 		bss = wpa_bss_update(wpa_s, bss, res, fetch_time);
-		if (wpa_s->last_scan_res) {
-			unsigned int i;
-			for (i = 0; i < wpa_s->last_scan_res_used; i++) {
-				if (bss == wpa_s->last_scan_res[i]) {
-					/* Already in the list */
-					return;
-				}
-			}
-		}
+		if (seen)
+			return;
 	}
 
 	if (bss == NULL)
@@ -862,6 +898,7 @@ int wpa_bss_init(struct wpa_supplicant *wpa_s)
 {
 	dl_list_init(&wpa_s->bss);
 	dl_list_init(&wpa_s->bss_id);
+	os_memset(wpa_s->bss_hash, 0, sizeof(wpa_s->bss_hash));
 	return 0;
 }
 
@@ -909,7 +946,7 @@ struct wpa_bss * wpa_bss_get_bssid(struct wpa_supplicant *wpa_s,
 	struct wpa_bss *bss;
 	if (!wpa_supplicant_filter_bssid_match(wpa_s, bssid))
 		return NULL;
-	dl_list_for_each_reverse(bss, &wpa_s->bss, struct wpa_bss, list) {
+	for (bss = wpa_s->bss_hash[BSS_HASH(bssid)]; bss; bss = bss->hnext) {
 		if (os_memcmp(bss->bssid, bssid, ETH_ALEN) == 0)
 			return bss;
 	}
@@ -934,7 +971,7 @@ struct wpa_bss * wpa_bss_get_bssid_latest(struct wpa_supplicant *wpa_s,
 	struct wpa_bss *bss, *found = NULL;
 	if (!wpa_supplicant_filter_bssid_match(wpa_s, bssid))
 		return NULL;
-	dl_list_for_each_reverse(bss, &wpa_s->bss, struct wpa_bss, list) {
+	for (bss = wpa_s->bss_hash[BSS_HASH(bssid)]; bss; bss = bss->hnext) {
 		if (os_memcmp(bss->bssid, bssid, ETH_ALEN) != 0)
 			continue;
 		if (found == NULL ||
@@ -554,6 +554,9 @@ struct wpa_supplicant {
 				 struct wpa_scan_results *scan_res);
 	struct dl_list bss; /* struct wpa_bss::list */
 	struct dl_list bss_id; /* struct wpa_bss::list_id */
+#define BSS_HASH_SIZE 256
+#define BSS_HASH(bssid) ((bssid)[5])
+	struct wpa_bss *bss_hash[BSS_HASH_SIZE]; /* struct wpa_bss::hnext */
 	size_t num_bss;
 	unsigned int bss_update_idx;
 	unsigned int bss_next_id;
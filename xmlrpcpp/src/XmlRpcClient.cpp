@@ -36,8 +36,15 @@ XmlRpcClient::XmlRpcClient(const char* host, int port, const char* uri/*=0*/)
   else
     _uri = "/RPC2";
   _connectionState = NO_CONNECTION;
+  _numSent = 0;
+  _sendAttempts = 0;
+  _bytesWritten = 0;
+  _pipelineDepth = 1;
   _executing = false;
   _eof = false;
+  _keepAlive = true;
+  _isFault = false;
+  _asyncDisp = &_disp;
 
   // Default to keeping the connection open until an explicit close is done
   setKeepOpen();
@@ -46,6 +53,8 @@ XmlRpcClient::XmlRpcClient(const char* host, int port, const char* uri/*=0*/)
 
 XmlRpcClient::~XmlRpcClient()
 {
+  if (_asyncDisp != &_disp)
+    _asyncDisp->removeSource(this);
 }
 
 // Close the owned fd
@@ -56,6 +65,8 @@ XmlRpcClient::close()
   _connectionState = NO_CONNECTION;
   _disp.exit();
   _disp.removeSource(this);
+  if (_asyncDisp != &_disp)
+    _asyncDisp->removeSource(this);
   XmlRpcSource::close();
 }
 
@@ -85,29 +96,81 @@ XmlRpcClient::execute(const char* method, XmlRpcValue const& params, XmlRpcValue
   _executing = true;
   ClearFlagOnExit cf(_executing);
 
-  _sendAttempts = 0;
-  _isFault = false;
-
-  if ( ! setupConnection())
+  // The result would be mixed up with those of asynchronous calls
+  if (getPendingCalls() > 0) {
+    XmlRpcUtil::error("Error in XmlRpcClient::execute: asynchronous calls are pending.");
     return false;
+  }
 
-  if ( ! generateRequest(method, params))
+  if ( ! queueCall(method, params))
     return false;
 
   result.clear();
   double msTime = -1.0;   // Process until exit is called
   _disp.work(msTime);
 
-  if (_connectionState != IDLE || ! parseResponse(result))
+  // The call can not complete if the connection was closed meanwhile
+  if ( ! _calls.empty())
+    abortCalls();
+
+  if ( ! takeResult(result))
     return false;
 
   XmlRpcUtil::log(1, "XmlRpcClient::execute: method %s completed.", method);
-  _response = "";
+  return true;
+}
+
+// Start executing the named procedure on the remote server without waiting
+// for the result.
+bool
+XmlRpcClient::executeNonBlock(const char* method, XmlRpcValue const& params)
+{
+  XmlRpcUtil::log(1, "XmlRpcClient::executeNonBlock: method %s (_connectionState %d).", method, _connectionState);
+
+  // See execute
+  if (_executing)
+    return false;
+
+  return queueCall(method, params);
+}
+
+// Return the result of the oldest call started with executeNonBlock if it has completed.
+bool
+XmlRpcClient::executeCheckDone(XmlRpcValue& result)
+{
+  result.clear();
+  if (_executing)
+    return false;
+
+  // Process pending events without blocking, unless another dispatcher does
+  if (_asyncDisp == &_disp && ! _calls.empty())
+    _disp.work(0.0);
+
+  // The calls can not complete if the connection was closed meanwhile
+  if (_connectionState == NO_CONNECTION && ! _calls.empty())
+    abortCalls();
+
+  if (_results.empty())
+    return false;
+
+  if (takeResult(result))
+    XmlRpcUtil::log(1, "XmlRpcClient::executeCheckDone: call completed.");
+  return true;
+}
+
+bool
+XmlRpcClient::setDispatch(XmlRpcDispatch* disp)
+{
+  if ( ! _calls.empty())
+    return false;
+
+  _asyncDisp = disp ? disp : &_disp;
   return true;
 }
 
 // XmlRpcSource interface implementation
-// Handle server responses. Called by the event dispatcher during execute.
+// Handle server responses. Called by the event dispatcher during execute
+// and while asynchronous calls are pending.
 unsigned
 XmlRpcClient::handleEvent(unsigned eventType)
 {
@@ -119,21 +182,119 @@ XmlRpcClient::handleEvent(unsigned eventType)
     else
       XmlRpcUtil::error("Error in XmlRpcClient::handleEvent (state %d): %s.", 
                         _connectionState, XmlRpcSocket::getErrorMsg().c_str());
-    return 0;
+    return abortCalls();
+  }
+
+  // Read the responses that have arrived, several of them may have been
+  // read at once if requests were pipelined
+  for (;;) {
+    size_t nResults = _results.size();
+
+    if (_connectionState == READ_HEADER)
+      if ( ! readHeader()) return abortCalls();
+
+    if (_connectionState == READ_RESPONSE)
+      if ( ! readResponse()) return abortCalls();
+
+    if (_connectionState != READ_HEADER || _results.size() == nResults || _header.length() == 0)
+      break;
   }
 
+  // Send the requests that are due. Until the socket is writable for the
+  // first time it may still be connecting.
+  if (_bytesWritten < int(_sendBuffer.length()) &&
+      (_connectionState != WRITE_REQUEST || eventType == XmlRpcDispatch::WritableEvent))
+    if ( ! writeRequest()) return abortCalls();
+
+  // Stop monitoring this source once all calls are answered (causes return from work)
+  if (_calls.empty())
+    return 0;
+
+  return getEventMask();
+}
+
+// The events to monitor the connection for in the current state
+unsigned
+XmlRpcClient::getEventMask() const
+{
+  unsigned mask = 0;
   if (_connectionState == WRITE_REQUEST)
-    if ( ! writeRequest()) return 0;
+    mask |= XmlRpcDispatch::Exception;
+  else if (_connectionState == READ_HEADER || _connectionState == READ_RESPONSE)
+    mask |= XmlRpcDispatch::ReadableEvent;
+  if (_bytesWritten < int(_sendBuffer.length()))
+    mask |= XmlRpcDispatch::WritableEvent;
+  return mask;
+}
 
-  if (_connectionState == READ_HEADER)
-    if ( ! readHeader()) return 0;
 
-  if (_connectionState == READ_RESPONSE)
-    if ( ! readResponse()) return 0;
+// Queue a call and send its request once the connection is free
+bool
+XmlRpcClient::queueCall(const char* method, XmlRpcValue const& params)
+{
+  if ( ! generateRequest(method, params))
+    return false;
+
+  _calls.push_back(std::string());
+  _calls.back().swap(_request);
 
-  // This should probably always ask for Exception events too
-  return (_connectionState == WRITE_REQUEST) 
-        ? XmlRpcDispatch::WritableEvent : XmlRpcDispatch::ReadableEvent;
+  // Connect unless the connection is in use by other calls
+  if (_calls.size() == 1) {
+    _sendAttempts = 0;
+    if ( ! setupConnection()) {
+      _calls.clear();
+      return false;
+    }
+  } else {
+    sendCalls();
+    getCallDispatch()->setSourceEvents(this, getEventMask());
+  }
+  return true;
+}
+
+// Move the requests that may be sent now to the send buffer: the request of
+// the oldest pending call, or up to the pipeline depth of them
+void
+XmlRpcClient::sendCalls()
+{
+  while (_numSent < int(_calls.size()) && _numSent < _pipelineDepth)
+    _sendBuffer += _calls[_numSent++];
+}
+
+// Fail the calls that have not been answered yet. Returns 0 to stop
+// monitoring the source.
+unsigned
+XmlRpcClient::abortCalls()
+{
+  while ( ! _calls.empty()) {
+    _results.push_back(std::string());
+    _calls.pop_front();
+  }
+  _numSent = 0;
+  _sendBuffer = "";
+  _bytesWritten = 0;
+  return 0;
+}
+
+// Parse the response of the oldest completed call into result.
+// Returns false if the call failed.
+bool
+XmlRpcClient::takeResult(XmlRpcValue& result)
+{
+  _isFault = false;
+  if (_results.empty())
+    return false;
+
+  // parseResponse works on _response, which may hold the beginning of the
+  // next response
+  std::string next;
+  next.swap(_response);
+  _response.swap(_results.front());
+  _results.pop_front();
+
+  bool ok = _response.length() > 0 && parseResponse(result);
+  _response.swap(next);
+  return ok;
 }
 
 
@@ -150,13 +311,19 @@ XmlRpcClient::setupConnection()
     if (! doConnect()) 
       return false;
 
-  // Prepare to write the request
+  // Prepare to write the requests of the pending calls
   _connectionState = WRITE_REQUEST;
+  _header = "";
+  _response = "";
+  _sendBuffer = "";
   _bytesWritten = 0;
+  _numSent = 0;
+  sendCalls();
 
   // Notify the dispatcher to listen on this source (calls handleEvent when the socket is writable)
-  _disp.removeSource(this);       // Make sure nothing is left over
-  _disp.addSource(this, XmlRpcDispatch::WritableEvent | XmlRpcDispatch::Exception);
+  XmlRpcDispatch* disp = getCallDispatch();
+  disp->removeSource(this);       // Make sure nothing is left over
+  disp->addSource(this, getEventMask());
 
   return true;
 }
@@ -184,6 +351,9 @@ XmlRpcClient::doConnect()
     return false;
   }
 
+  // Requests are written in one piece, there is nothing to gain from delaying them
+  (void) XmlRpcSocket::setNoDelay(fd);
+
   if ( ! XmlRpcSocket::connect(fd, _host, _port))
   {
     this->close();
@@ -209,14 +379,14 @@ XmlRpcClient::generateRequest(const char* methodName, XmlRpcValue const& params)
     {
       for (int i=0; i<params.size(); ++i) {
         body += PARAM_TAG;
-        body += params[i].toXml();
+        params[i].toXml(body);
         body += PARAM_ETAG;
       }
     }
     else
     {
       body += PARAM_TAG;
-      body += params.toXml();
+      params.toXml(body);
       body += PARAM_ETAG;
     }
       
@@ -258,21 +428,26 @@ bool
 XmlRpcClient::writeRequest()
 {
   if (_bytesWritten == 0)
-    XmlRpcUtil::log(5, "XmlRpcClient::writeRequest (attempt %d):\n%s\n", _sendAttempts+1, _request.c_str());
+    XmlRpcUtil::log(5, "XmlRpcClient::writeRequest (attempt %d):\n%s\n", _sendAttempts+1, _sendBuffer.c_str());
 
-  // Try to write the request
-  if ( ! XmlRpcSocket::nbWrite(this->getfd(), _request, &_bytesWritten)) {
+  // Try to write the requests
+  if ( ! XmlRpcSocket::nbWrite(this->getfd(), _sendBuffer, &_bytesWritten)) {
     XmlRpcUtil::error("Error in XmlRpcClient::writeRequest: write error (%s).",XmlRpcSocket::getErrorMsg().c_str());
     return false;
   }
     
-  XmlRpcUtil::log(3, "XmlRpcClient::writeRequest: wrote %d of %d bytes.", _bytesWritten, _request.length());
+  XmlRpcUtil::log(3, "XmlRpcClient::writeRequest: wrote %d of %d bytes.", _bytesWritten, _sendBuffer.length());
 
-  // Wait for the result
-  if (_bytesWritten == int(_request.length())) {
-    _header = "";
-    _response = "";
-    _connectionState = READ_HEADER;
+  if (_bytesWritten == int(_sendBuffer.length())) {
+    _sendBuffer = "";
+    _bytesWritten = 0;
+
+    // Wait for the result
+    if (_connectionState == WRITE_REQUEST) {
+      _header = "";
+      _response = "";
+      _connectionState = READ_HEADER;
+    }
   }
   return true;
 }
@@ -307,10 +482,13 @@ XmlRpcClient::readHeader()
   char *ep = hp + _header.length();   // End of string
   char *bp = 0;                       // Start of body
   char *lp = 0;                       // Start of content-length value
+  char *kp = 0;                       // Start of connection value
 
   for (char *cp = hp; (bp == 0) && (cp < ep); ++cp) {
     if ((ep - cp > 16) && (strncasecmp(cp, "Content-length: ", 16) == 0))
       lp = cp + 16;
+    else if ((ep - cp > 12) && (strncasecmp(cp, "Connection: ", 12) == 0))
+      kp = cp + 12;
     else if ((ep - cp > 4) && (strncmp(cp, "\r\n\r\n", 4) == 0))
       bp = cp + 4;
     else if ((ep - cp > 2) && (strncmp(cp, "\n\n", 2) == 0))
@@ -344,7 +522,14 @@ XmlRpcClient::readHeader()
 
   // Otherwise copy non-header data to response buffer and set state to read response.
   _response = bp;
-  _header = "";   // should parse out any interesting bits from the header (connection, etc)...
+
+  // Find out whether the server closes the connection after the response
+  if (_header.compare(0, 8, "HTTP/1.0") == 0)
+    _keepAlive = (kp != 0 && strncasecmp(kp, "keep-alive", 10) == 0);
+  else
+    _keepAlive = (kp == 0 || strncasecmp(kp, "close", 5) != 0);
+
+  _header = "";
   _connectionState = READ_RESPONSE;
   return true;    // Continue monitoring this source
 }
@@ -370,13 +555,40 @@ XmlRpcClient::readResponse()
     }
   }
 
-  // Otherwise, parse and return the result
+  // Keep any data beyond the response for the next one (pipelined calls)
+  if (int(_response.length()) > _contentLength) {
+    _header = _response.substr(_contentLength);
+    _response.resize(_contentLength);
+  }
+
+  // Otherwise, save the result for parsing
   XmlRpcUtil::log(3, "XmlRpcClient::readResponse (read %d bytes)", _response.length());
   XmlRpcUtil::log(5, "response:\n%s", _response.c_str());
 
-  _connectionState = IDLE;
+  _results.push_back(std::string());
+  _results.back().swap(_response);
+  _calls.pop_front();
+  --_numSent;
+  _sendAttempts = 0;
+  if ( ! _keepAlive)
+    _eof = true;
 
-  return false;    // Stop monitoring this source (causes return from work)
+  if (_calls.empty()) {
+    _connectionState = IDLE;
+    return true;
+  }
+
+  // Send the requests that were not answered over a new connection if the
+  // server closed this one
+  if (_eof) {
+    XmlRpcSource::close();
+    _connectionState = NO_CONNECTION;
+    return setupConnection();
+  }
+
+  sendCalls();
+  _connectionState = READ_HEADER;
+  return true;
 }
 
 
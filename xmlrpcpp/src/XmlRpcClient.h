@@ -10,6 +10,7 @@
 
 
 #ifndef MAKEDEPEND
+# include <deque>
 # include <string>
 #endif
 
@@ -52,14 +53,53 @@ namespace XmlRpc {
     //!  @return true if the request was sent and a result received 
     //!   (although the result might be a fault).
     //!
-    //! Currently this is a synchronous (blocking) implementation (execute
-    //! does not return until it receives a response or an error). Use isFault()
-    //! to determine whether the result is a fault response.
+    //! This is a synchronous (blocking) implementation (execute does not
+    //! return until it receives a response or an error). Use isFault() to
+    //! determine whether the result is a fault response. It fails while calls
+    //! started with executeNonBlock() are pending.
     bool execute(const char* method, XmlRpcValue const& params, XmlRpcValue& result);
 
-    //! Returns true if the result of the last execute() was a fault response.
+    //! Start executing the named procedure on the remote server and return
+    //! without waiting for the result.
+    //!  @param method The name of the remote procedure to execute
+    //!  @param params An array of the arguments for the method
+    //!  @return true if the request was queued for sending
+    //!
+    //! Several calls may be started before their results are fetched with
+    //! executeCheckDone(), in the order the calls were started. The requests
+    //! are sent one after another over the connection, or several at once if
+    //! pipelining is enabled. Calls are processed while executeCheckDone() is
+    //! called, or while the dispatcher given to setDispatch() works.
+    bool executeNonBlock(const char* method, XmlRpcValue const& params);
+
+    //! Check whether the oldest call started with executeNonBlock() has completed.
+    //!  @param result The result value of the call, invalid if the call failed
+    //!  @return true if the call has completed, false if it is still being
+    //!   processed or no call is pending.
+    bool executeCheckDone(XmlRpcValue& result);
+
+    //! Returns the number of calls started with executeNonBlock() whose
+    //! results have not been fetched with executeCheckDone() yet.
+    int getPendingCalls() const { return int(_calls.size() + _results.size()); }
+
+    //! Returns true if the result of the last execute() or executeCheckDone()
+    //! was a fault response.
     bool isFault() const { return _isFault; }
 
+    //! Specify how many requests of calls started with executeNonBlock() may
+    //! be sent before their responses have been received (HTTP pipelining).
+    //! This saves a round trip per call, but requires a server that handles
+    //! pipelined requests. Default is 1 (no pipelining).
+    void setPipelineDepth(int depth) { _pipelineDepth = (depth > 1) ? depth : 1; }
+    //! Returns the number of requests that may be pipelined.
+    int getPipelineDepth() const { return _pipelineDepth; }
+
+    //! Monitor the connection of calls started with executeNonBlock() with the
+    //! specified dispatcher, e.g. the one of an XmlRpcServer, so that the calls
+    //! are processed while it works. 0 selects the client's own dispatcher.
+    //!  @return false if calls are pending, in which case nothing is changed.
+    bool setDispatch(XmlRpcDispatch* disp);
+
 
     // XmlRpcSource interface implementation
     //! Close the connection
@@ -82,6 +122,14 @@ namespace XmlRpc {
     virtual bool readResponse();
     virtual bool parseResponse(XmlRpcValue& result);
 
+    // Call queue helpers
+    bool queueCall(const char* method, XmlRpcValue const& params);
+    void sendCalls();
+    unsigned abortCalls();
+    bool takeResult(XmlRpcValue& result);
+    unsigned getEventMask() const;
+    XmlRpcDispatch* getCallDispatch() { return _executing ? &_disp : _asyncDisp; }
+
     // Possible IO states for the connection
     enum ClientConnectionState { NO_CONNECTION, CONNECTING, WRITE_REQUEST, READ_HEADER, READ_RESPONSE, IDLE };
     ClientConnectionState _connectionState;
@@ -96,21 +144,39 @@ namespace XmlRpc {
     std::string _header;
     std::string _response;
 
+    // Requests of the calls that have not been answered yet, oldest first.
+    // The first _numSent of them have been copied to _sendBuffer for writing.
+    std::deque< std::string > _calls;
+    int _numSent;
+
+    // Response xml of the completed calls that have not been fetched yet,
+    // empty if the call failed
+    std::deque< std::string > _results;
+
+    // Requests to be written to the socket
+    std::string _sendBuffer;
+
     // Number of times the client has attempted to send the request
     int _sendAttempts;
 
-    // Number of bytes of the request that have been written to the socket so far
+    // Number of bytes of the send buffer that have been written to the socket so far
     int _bytesWritten;
 
+    // Number of requests that may be sent before they have been answered
+    int _pipelineDepth;
+
     // True if we are currently executing a request. If you want to multithread,
     // each thread should have its own client.
     bool _executing;
 
     // True if the server closed the connection
     bool _eof;
-
-    // True if a fault response was returned by the server
-    bool _isFault;
+
+    // True if the server keeps the connection open after the current response
+    bool _keepAlive;
+
+    // True if a fault response was returned by the server
+    bool _isFault;
 
     // Number of bytes expected in the response body (parsed from response header)
     int _contentLength;
@@ -118,6 +184,9 @@ namespace XmlRpc {
     // Event dispatcher
     XmlRpcDispatch _disp;
 
+    // Dispatcher monitoring the calls started with executeNonBlock
+    XmlRpcDispatch* _asyncDisp;
+
   };	// class XmlRpcClient
 
 }	// namespace XmlRpc
@@ -15,6 +15,14 @@
 # endif
 #else
 # include <sys/time.h>
+# if defined(__linux__)
+#  define USE_EPOLL
+#  include <errno.h>
+#  include <stdint.h>
+#  include <string.h>
+#  include <sys/epoll.h>
+#  include <unistd.h>
+# endif
 #endif  // _WINDOWS
 
 
@@ -23,14 +31,26 @@ using namespace XmlRpc;
 
 XmlRpcDispatch::XmlRpcDispatch()
 {
+  _nextId = 0;
+  _epfd = -1;
   _endTime = -1.0;
   _doClear = false;
   _inWork = false;
+
+#if defined(USE_EPOLL)
+  _epfd = epoll_create1(EPOLL_CLOEXEC);
+  if (_epfd < 0)
+    XmlRpcUtil::error("XmlRpcDispatch: epoll_create1 failed (%s), using select.", strerror(errno));
+#endif
 }
 
 
 XmlRpcDispatch::~XmlRpcDispatch()
 {
+#if defined(USE_EPOLL)
+  if (_epfd >= 0)
+    ::close(_epfd);
+#endif
 }
 
 // Monitor this source for the specified events and call its event handler
@@ -38,19 +58,24 @@ XmlRpcDispatch::~XmlRpcDispatch()
 void
 XmlRpcDispatch::addSource(XmlRpcSource* source, unsigned mask)
 {
-  _sources.push_back(MonitoredSource(source, mask));
+  int fd = source->getfd();
+  SourceList::iterator it = _sources.insert(_sources.end(), MonitoredSource(source, mask, fd, _nextId++));
+  _bySource[source] = it;
+  if (fd >= 0) {
+    if (fd >= int(_byFd.size()))
+      _byFd.resize(fd + 1, _sources.end());
+    _byFd[fd] = it;
+  }
+  epollControl(EpollAdd, it);
 }
 
 // Stop monitoring this source. Does not close the source.
 void
 XmlRpcDispatch::removeSource(XmlRpcSource* source)
 {
-  for (SourceList::iterator it=_sources.begin(); it!=_sources.end(); ++it)
-    if (it->getSource() == source)
-    {
-      _sources.erase(it);
-      break;
-    }
+  SourceList::iterator it = findSource(source);
+  if (it != _sources.end())
+    eraseSource(it);
 }
 
 
@@ -58,15 +83,104 @@ XmlRpcDispatch::removeSource(XmlRpcSource* source)
 void 
 XmlRpcDispatch::setSourceEvents(XmlRpcSource* source, unsigned eventMask)
 {
-  for (SourceList::iterator it=_sources.begin(); it!=_sources.end(); ++it)
-    if (it->getSource() == source)
-    {
-      it->getMask() = eventMask;
-      break;
-    }
+  SourceList::iterator it = findSource(source);
+  if (it != _sources.end() && it->getMask() != eventMask)
+  {
+    it->getMask() = eventMask;
+    epollControl(EpollModify, it);
+  }
+}
+
+
+XmlRpcDispatch::SourceList::iterator
+XmlRpcDispatch::findSource(XmlRpcSource* source)
+{
+  SourceIndex::iterator i = _bySource.find(source);
+  return (i != _bySource.end()) ? i->second : _sources.end();
+}
+
+
+void
+XmlRpcDispatch::eraseSource(SourceList::iterator it)
+{
+  SourceIndex::iterator i = _bySource.find(it->getSource());
+  if (i != _bySource.end() && i->second == it)
+    _bySource.erase(i);
+
+  // Only the entry that owns the descriptor may unregister it: a stale entry
+  // whose descriptor was closed and reused must not affect the new one.
+  int fd = it->_fd;
+  if (fd >= 0 && fd < int(_byFd.size()) && _byFd[fd] == it) {
+    epollControl(EpollDelete, it);
+    _byFd[fd] = _sources.end();
+  }
+  _sources.erase(it);
 }
 
 
+void
+XmlRpcDispatch::dispatchEvents(SourceList::iterator it, unsigned events)
+{
+  XmlRpcSource* src = it->getSource();
+  unsigned newMask = (unsigned) -1;
+
+  // If you select on multiple event types this could be ambiguous
+  if (events & ReadableEvent)
+    newMask &= src->handleEvent(ReadableEvent);
+  if (events & WritableEvent)
+    newMask &= src->handleEvent(WritableEvent);
+  if (events & Exception)
+    newMask &= src->handleEvent(Exception);
+
+  // The handler may have stopped monitoring the source itself
+  it = findSource(src);
+  if (it == _sources.end())
+    return;
+
+  if ( ! newMask) {
+    eraseSource(it);  // Stop monitoring this one
+    if ( ! src->getKeepOpen())
+      src->close();
+  } else if (newMask != (unsigned) -1 && newMask != it->getMask()) {
+    it->getMask() = newMask;
+    epollControl(EpollModify, it);
+  }
+}
+
+
+void
+XmlRpcDispatch::epollControl(EpollOp op, SourceList::iterator it)
+{
+#if defined(USE_EPOLL)
+  if (_epfd < 0 || it->_fd < 0)
+    return;
+
+  // Errors and hangups are reported even for sources that watch no events,
+  // so these are not registered at all
+  unsigned mask = it->getMask();
+  if (op == EpollDelete || ! mask) {
+    if (op != EpollAdd)
+      epoll_ctl(_epfd, EPOLL_CTL_DEL, it->_fd, NULL);
+    return;
+  }
+
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  if (mask & ReadableEvent) ev.events |= EPOLLIN;
+  if (mask & WritableEvent) ev.events |= EPOLLOUT;
+  if (mask & Exception)     ev.events |= EPOLLPRI;
+  ev.data.u64 = ((uint64_t) it->_id << 32) | (uint32_t) it->_fd;
+
+  int r = epoll_ctl(_epfd, op == EpollAdd ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, it->_fd, &ev);
+  if (r < 0 && op == EpollAdd && errno == EEXIST)
+    r = epoll_ctl(_epfd, EPOLL_CTL_MOD, it->_fd, &ev);
+  else if (r < 0 && op == EpollModify && errno == ENOENT)
+    r = epoll_ctl(_epfd, EPOLL_CTL_ADD, it->_fd, &ev);
+  if (r < 0)
+    XmlRpcUtil::error("Error in XmlRpcDispatch: epoll_ctl on socket %d failed (%s).", it->_fd, strerror(errno));
+#endif
+}
+
 
 // Watch current set of sources and process events
 void
@@ -80,72 +194,20 @@ XmlRpcDispatch::work(double timeout)
   // Only work while there is something to monitor
   while (_sources.size() > 0) {
 
-    // Construct the sets of descriptors we are interested in
-    fd_set inFd, outFd, excFd;
-	  FD_ZERO(&inFd);
-	  FD_ZERO(&outFd);
-	  FD_ZERO(&excFd);
-
-    int maxFd = -1;     // Not used on windows
-    SourceList::iterator it;
-    for (it=_sources.begin(); it!=_sources.end(); ++it) {
-      int fd = it->getSource()->getfd();
-      if (it->getMask() & ReadableEvent) FD_SET(fd, &inFd);
-      if (it->getMask() & WritableEvent) FD_SET(fd, &outFd);
-      if (it->getMask() & Exception)     FD_SET(fd, &excFd);
-      if (it->getMask() && fd > maxFd)   maxFd = fd;
-    }
-
-    // Check for events
-    int nEvents;
-    if (timeout < 0.0)
-      nEvents = select(maxFd+1, &inFd, &outFd, &excFd, NULL);
-    else 
+    // Check for and process events
+    bool ok = (_epfd >= 0) ? waitEpoll(timeout) : waitSelect(timeout);
+    if ( ! ok)
     {
-      struct timeval tv;
-      tv.tv_sec = (int)floor(timeout);
-      tv.tv_usec = ((int)floor(1000000.0 * (timeout-floor(timeout)))) % 1000000;
-      nEvents = select(maxFd+1, &inFd, &outFd, &excFd, &tv);
-    }
-
-    if (nEvents < 0)
-    {
-      XmlRpcUtil::error("Error in XmlRpcDispatch::work: error in select (%d).", nEvents);
       _inWork = false;
       return;
     }
 
-    // Process events
-    for (it=_sources.begin(); it != _sources.end(); )
-    {
-      SourceList::iterator thisIt = it++;
-      XmlRpcSource* src = thisIt->getSource();
-      int fd = src->getfd();
-      unsigned newMask = (unsigned) -1;
-      if (fd <= maxFd) {
-        // If you select on multiple event types this could be ambiguous
-        if (FD_ISSET(fd, &inFd))
-          newMask &= src->handleEvent(ReadableEvent);
-        if (FD_ISSET(fd, &outFd))
-          newMask &= src->handleEvent(WritableEvent);
-        if (FD_ISSET(fd, &excFd))
-          newMask &= src->handleEvent(Exception);
-
-        if ( ! newMask) {
-          _sources.erase(thisIt);  // Stop monitoring this one
-          if ( ! src->getKeepOpen())
-            src->close();
-        } else if (newMask != (unsigned) -1) {
-          thisIt->getMask() = newMask;
-        }
-      }
-    }
-
     // Check whether to clear all sources
     if (_doClear)
     {
       SourceList closeList = _sources;
-      _sources.clear();
+      while ( ! _sources.empty())
+        eraseSource(_sources.begin());
       for (SourceList::iterator it=closeList.begin(); it!=closeList.end(); ++it) {
 	XmlRpcSource *src = it->getSource();
         src->close();
@@ -163,6 +225,106 @@ XmlRpcDispatch::work(double timeout)
 }
 
 
+bool
+XmlRpcDispatch::waitSelect(double timeout)
+{
+  // Construct the sets of descriptors we are interested in
+  fd_set inFd, outFd, excFd;
+  FD_ZERO(&inFd);
+  FD_ZERO(&outFd);
+  FD_ZERO(&excFd);
+
+  int maxFd = -1;     // Not used on windows
+  SourceList::iterator it;
+  for (it=_sources.begin(); it!=_sources.end(); ++it) {
+    int fd = it->getSource()->getfd();
+    if (it->getMask() & ReadableEvent) FD_SET(fd, &inFd);
+    if (it->getMask() & WritableEvent) FD_SET(fd, &outFd);
+    if (it->getMask() & Exception)     FD_SET(fd, &excFd);
+    if (it->getMask() && fd > maxFd)   maxFd = fd;
+  }
+
+  // Check for events
+  int nEvents;
+  if (timeout < 0.0)
+    nEvents = select(maxFd+1, &inFd, &outFd, &excFd, NULL);
+  else 
+  {
+    struct timeval tv;
+    tv.tv_sec = (int)floor(timeout);
+    tv.tv_usec = ((int)floor(1000000.0 * (timeout-floor(timeout)))) % 1000000;
+    nEvents = select(maxFd+1, &inFd, &outFd, &excFd, &tv);
+  }
+
+  if (nEvents < 0)
+  {
+    XmlRpcUtil::error("Error in XmlRpcDispatch::work: error in select (%d).", nEvents);
+    return false;
+  }
+
+  // Process events
+  for (it=_sources.begin(); it != _sources.end(); )
+  {
+    SourceList::iterator thisIt = it++;
+    int fd = thisIt->getSource()->getfd();
+    if (fd <= maxFd) {
+      unsigned events = 0;
+      if (FD_ISSET(fd, &inFd))  events |= ReadableEvent;
+      if (FD_ISSET(fd, &outFd)) events |= WritableEvent;
+      if (FD_ISSET(fd, &excFd)) events |= Exception;
+      if (events)
+        dispatchEvents(thisIt, events);
+    }
+  }
+  return true;
+}
+
+
+// Wait for events on the epoll instance. Only the sources with events are
+// visited, so the cost does not grow with the number of idle connections and
+// descriptors are not limited to FD_SETSIZE. Readiness is level-triggered:
+// handlers (e.g. accepting one connection per event) need not drain the
+// socket to be called again.
+bool
+XmlRpcDispatch::waitEpoll(double timeout)
+{
+#if defined(USE_EPOLL)
+  const int MAX_EVENTS = 64;
+  struct epoll_event events[MAX_EVENTS];
+  int ms = (timeout < 0.0) ? -1 : (int)ceil(1000.0 * timeout);
+
+  int nEvents = epoll_wait(_epfd, events, MAX_EVENTS, ms);
+  if (nEvents < 0)
+  {
+    XmlRpcUtil::error("Error in XmlRpcDispatch::work: error in epoll_wait (%s).", strerror(errno));
+    return false;
+  }
+
+  for (int i = 0; i < nEvents; ++i)
+  {
+    // The source may have been removed while handling an earlier event
+    int fd = (int)(uint32_t) events[i].data.u64;
+    unsigned id = (unsigned)(events[i].data.u64 >> 32);
+    if (fd >= int(_byFd.size()) || _byFd[fd] == _sources.end() || _byFd[fd]->_id != id)
+      continue;
+
+    // As with select, errors and hangups are reported as readable/writable
+    SourceList::iterator it = _byFd[fd];
+    unsigned mask = it->getMask();
+    unsigned ready = 0;
+    if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP))  ready |= mask & ReadableEvent;
+    if (events[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) ready |= mask & WritableEvent;
+    if (events[i].events & EPOLLPRI)                         ready |= mask & Exception;
+    if (ready)
+      dispatchEvents(it, ready);
+  }
+  return true;
+#else
+  return waitSelect(timeout);
+#endif
+}
+
+
 // Exit from work routine. Presumably this will be called from
 // one of the source event handlers.
 void
@@ -180,7 +342,8 @@ XmlRpcDispatch::clear()
   else
   {
     SourceList closeList = _sources;
-    _sources.clear();
+    while ( ! _sources.empty())
+      eraseSource(_sources.begin());
     for (SourceList::iterator it=closeList.begin(); it!=closeList.end(); ++it)
       it->getSource()->close();
   }
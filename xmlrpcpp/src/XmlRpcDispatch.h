@@ -10,6 +10,8 @@
 
 #ifndef MAKEDEPEND
 # include <list>
+# include <map>
+# include <vector>
 #endif
 
 namespace XmlRpc {
@@ -63,19 +65,54 @@ namespace XmlRpc {
 
     // A source to monitor and what to monitor it for
     struct MonitoredSource {
-      MonitoredSource(XmlRpcSource* src, unsigned mask) : _src(src), _mask(mask) {}
+      MonitoredSource(XmlRpcSource* src, unsigned mask, int fd, unsigned id)
+        : _src(src), _mask(mask), _fd(fd), _id(id) {}
       XmlRpcSource* getSource() const { return _src; }
       unsigned& getMask() { return _mask; }
       XmlRpcSource* _src;
       unsigned _mask;
+      int _fd;        // descriptor the source was registered with
+      unsigned _id;   // tells apart sources that reuse a descriptor
     };
 
     // A list of sources to monitor
     typedef std::list< MonitoredSource > SourceList; 
 
+    // Find the monitored entry of a source, or _sources.end()
+    SourceList::iterator findSource(XmlRpcSource* source);
+
+    // Stop monitoring the entry
+    void eraseSource(SourceList::iterator it);
+
+    // Call the source's handler for the events that occurred and update
+    // the events to watch for according to its result
+    void dispatchEvents(SourceList::iterator it, unsigned events);
+
+    // Wait for events with select() or epoll and dispatch them.
+    // Return false on error.
+    bool waitSelect(double timeout);
+    bool waitEpoll(double timeout);
+
+    // Update the epoll registration of the entry
+    enum EpollOp { EpollAdd, EpollModify, EpollDelete };
+    void epollControl(EpollOp op, SourceList::iterator it);
+
     // Sources being monitored
     SourceList _sources;
 
+    // Monitored entries indexed by source and by descriptor (_sources.end()
+    // if none), so that neither adding/removing a source nor dispatching an
+    // event needs to walk the list
+    typedef std::map< XmlRpcSource*, SourceList::iterator > SourceIndex;
+    SourceIndex _bySource;
+    std::vector< SourceList::iterator > _byFd;
+
+    // Id of the next source added
+    unsigned _nextId;
+
+    // epoll instance (Linux), or -1 if select() is used
+    int _epfd;
+
     // When work should stop (-1 implies wait forever, or until exit is called)
     double _endTime;
 
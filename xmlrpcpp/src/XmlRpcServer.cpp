@@ -158,6 +158,9 @@ XmlRpcServer::acceptConnection()
   }
   else  // Notify the dispatcher to listen for input on this source when we are in work()
   {
+    // Responses are written in one piece, there is nothing to gain from delaying them
+    (void) XmlRpcSocket::setNoDelay(s);
+
     XmlRpcUtil::log(2, "XmlRpcServer::acceptConnection: creating a connection");
     _disp.addSource(this->createConnection(s), XmlRpcDispatch::ReadableEvent);
   }
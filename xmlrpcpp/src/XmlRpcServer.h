@@ -65,6 +65,11 @@ namespace XmlRpc {
     //! Close all connections with clients and the socket file descriptor
     void shutdown();
 
+    //! Return the dispatcher that monitors the server socket and the client
+    //! connections, e.g. to let it also monitor the connection of an XmlRpcClient
+    //! making asynchronous calls.
+    XmlRpcDispatch* getDispatch() { return &_disp; }
+
     //! Introspection support
     void listMethods(XmlRpcValue& result);
 
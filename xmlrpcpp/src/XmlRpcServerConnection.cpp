@@ -50,15 +50,23 @@ XmlRpcServerConnection::~XmlRpcServerConnection()
 unsigned
 XmlRpcServerConnection::handleEvent(unsigned /*eventType*/)
 {
-  if (_connectionState == READ_HEADER)
-    if ( ! readHeader()) return 0;
+  for (;;) {
+    if (_connectionState == READ_HEADER)
+      if ( ! readHeader()) return 0;
 
-  if (_connectionState == READ_REQUEST)
-    if ( ! readRequest()) return 0;
+    if (_connectionState == READ_REQUEST)
+      if ( ! readRequest()) return 0;
 
-  if (_connectionState == WRITE_RESPONSE)
+    if (_connectionState != WRITE_RESPONSE)
+      break;
     if ( ! writeResponse()) return 0;
 
+    // A client pipelining its calls may have sent the next request along with
+    // the previous one, in which case there may not be another event for it
+    if (_connectionState != READ_HEADER || _header.length() == 0)
+      break;
+  }
+
   return (_connectionState == WRITE_RESPONSE) 
         ? XmlRpcDispatch::WritableEvent : XmlRpcDispatch::ReadableEvent;
 }
@@ -162,6 +170,12 @@ XmlRpcServerConnection::readRequest()
     }
   }
 
+  // Keep any data beyond the request for the next one (pipelined requests)
+  if (int(_request.length()) > _contentLength) {
+    _header = _request.substr(_contentLength);
+    _request.resize(_contentLength);
+  }
+
   // Otherwise, parse and dispatch the request
   XmlRpcUtil::log(3, "XmlRpcServerConnection::readRequest read %d bytes.", _request.length());
   //XmlRpcUtil::log(5, "XmlRpcServerConnection::readRequest:\n%s\n", _request.c_str());
@@ -193,7 +207,6 @@ XmlRpcServerConnection::writeResponse()
 
   // Prepare to read the next request
   if (_bytesWritten == int(_response.length())) {
-    _header = "";
     _request = "";
     _response = "";
     _connectionState = READ_HEADER;
@@ -240,7 +253,8 @@ XmlRpcServerConnection::parseRequest(XmlRpcValue& params)
   {
     int nArgs = 0;
     while (XmlRpcUtil::nextTagIs(PARAM_TAG, _request, &offset)) {
-      params[nArgs++] = XmlRpcValue(_request, &offset);
+      XmlRpcValue param(_request, &offset);
+      params[nArgs++].swap(param);
       (void) XmlRpcUtil::nextTagIs(PARAM_ETAG, _request, &offset);
     }
 
@@ -33,6 +33,11 @@ namespace XmlRpc {
     //! Write text to the specified socket. Returns false on error.
     static bool nbWrite(int socket, std::string& s, int *bytesSoFar);
 
+    //! Sends data written to a stream (TCP) socket immediately instead of waiting to
+    //! coalesce it with further writes (disables Nagle's algorithm), which would
+    //! delay pipelined requests and responses. Returns false on failure.
+    static bool setNoDelay(int socket);
+
 
     // The next four methods are appropriate for servers.
 
@@ -165,14 +165,11 @@ XmlRpcUtil::getNextTag(std::string const& xml, int* offset)
 
   if (*cp != '<') return std::string();
 
-  std::string s;
-  do {
-    s += *cp;
-    ++pos;
-  } while (*cp++ != '>' && *cp != 0);
+  const char* end = strchr(cp, '>');
+  size_t len = end ? size_t(end - cp) + 1 : strlen(cp);
 
-  *offset = int(pos);
-  return s;
+  *offset = int(pos + len);
+  return std::string(cp, len);
 }
 
 
@@ -226,11 +223,27 @@ XmlRpcUtil::xmlDecode(const std::string& encoded)
 std::string 
 XmlRpcUtil::xmlEncode(const std::string& raw)
 {
-  std::string::size_type iRep = raw.find_first_of(rawEntity);
-  if (iRep == std::string::npos)
+  if (raw.find_first_of(rawEntity) == std::string::npos)
     return raw;
 
-  std::string encoded(raw, 0, iRep);
+  std::string encoded;
+  xmlEncode(raw, encoded);
+  return encoded;
+}
+
+
+// Append raw text with xml-encoded entities, without a temporary copy.
+
+void
+XmlRpcUtil::xmlEncode(const std::string& raw, std::string& encoded)
+{
+  std::string::size_type iRep = raw.find_first_of(rawEntity);
+  if (iRep == std::string::npos) {
+    encoded += raw;
+    return;
+  }
+
+  encoded.append(raw, 0, iRep);
   std::string::size_type iSize = raw.size();
 
   while (iRep != iSize) {
@@ -246,7 +259,6 @@ XmlRpcUtil::xmlEncode(const std::string& raw)
       encoded += raw[iRep];
     ++iRep;
   }
-  return encoded;
 }
 
 
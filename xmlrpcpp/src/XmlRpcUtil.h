@@ -45,6 +45,9 @@ namespace XmlRpc {
     //! Convert raw text to encoded xml.
     static std::string xmlEncode(const std::string& raw);
 
+    //! Append raw text converted to encoded xml to encoded.
+    static void xmlEncode(const std::string& raw, std::string& encoded);
+
     //! Convert encoded xml to raw text
     static std::string xmlDecode(const std::string& encoded);
 
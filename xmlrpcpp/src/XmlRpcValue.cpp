@@ -5,10 +5,12 @@
 #include "base64.h"
 
 #ifndef MAKEDEPEND
+# include <ctype.h>
 # include <iostream>
 # include <ostream>
 # include <stdlib.h>
 # include <stdio.h>
+# include <string.h>
 #endif
 
 namespace XmlRpc {
@@ -210,6 +212,27 @@ namespace XmlRpc {
     return _type == TypeStruct && _value.asStruct->find(name) != _value.asStruct->end();
   }
 
+  // Exchange values. Arrays and structs of values are built with this while
+  // decoding, so that elements are not copied.
+  void XmlRpcValue::swap(XmlRpcValue& other)
+  {
+    Type t = _type;
+    _type = other._type;
+    other._type = t;
+
+    char v[sizeof(_value)];
+    memcpy(v, &_value, sizeof(_value));
+    memcpy(&_value, &other._value, sizeof(_value));
+    memcpy(&other._value, v, sizeof(_value));
+  }
+
+  // Compare the tag of length len at cp with a tag constant
+  template <size_t N>
+  static inline bool tagIs(const char* cp, size_t len, const char (&tag)[N])
+  {
+    return len == N - 1 && memcmp(cp, tag, N - 1) == 0;
+  }
+
   // Set the value from xml. The chars at *offset into valueXml 
   // should be the start of a <value> tag. Destroys any existing value.
   bool XmlRpcValue::fromXml(std::string const& valueXml, int* offset)
@@ -220,29 +243,41 @@ namespace XmlRpc {
     if ( ! XmlRpcUtil::nextTagIs(VALUE_TAG, valueXml, offset))
       return false;       // Not a value, offset not updated
 
-	int afterValueOffset = *offset;
-    std::string typeTag = XmlRpcUtil::getNextTag(valueXml, offset);
+    int afterValueOffset = *offset;
+
+    // Find the type tag in place (like XmlRpcUtil::getNextTag, without a copy)
+    const char* xml = valueXml.c_str();
+    const char* typeTag = xml + *offset;
+    size_t tagLen = 0;
+    while (*typeTag && isspace(*typeTag))
+      ++typeTag;
+    if (*typeTag == '<') {
+      const char* tagEnd = strchr(typeTag, '>');
+      tagLen = tagEnd ? size_t(tagEnd - typeTag) + 1 : strlen(typeTag);
+      *offset = int(typeTag - xml + tagLen);
+    }
+
     bool result = false;
-    if (typeTag == NIL_TAG)
+    if (tagIs(typeTag, tagLen, NIL_TAG))
       result = nilFromXml(valueXml, offset);
-    else if (typeTag == BOOLEAN_TAG)
+    else if (tagIs(typeTag, tagLen, BOOLEAN_TAG))
       result = boolFromXml(valueXml, offset);
-    else if (typeTag == I4_TAG || typeTag == INT_TAG)
+    else if (tagIs(typeTag, tagLen, I4_TAG) || tagIs(typeTag, tagLen, INT_TAG))
       result = intFromXml(valueXml, offset);
-    else if (typeTag == DOUBLE_TAG)
+    else if (tagIs(typeTag, tagLen, DOUBLE_TAG))
       result = doubleFromXml(valueXml, offset);
-    else if (typeTag.empty() || typeTag == STRING_TAG)
+    else if (tagLen == 0 || tagIs(typeTag, tagLen, STRING_TAG))
       result = stringFromXml(valueXml, offset);
-    else if (typeTag == DATETIME_TAG)
+    else if (tagIs(typeTag, tagLen, DATETIME_TAG))
       result = timeFromXml(valueXml, offset);
-    else if (typeTag == BASE64_TAG)
+    else if (tagIs(typeTag, tagLen, BASE64_TAG))
       result = binaryFromXml(valueXml, offset);
-    else if (typeTag == ARRAY_TAG)
+    else if (tagIs(typeTag, tagLen, ARRAY_TAG))
       result = arrayFromXml(valueXml, offset);
-    else if (typeTag == STRUCT_TAG)
+    else if (tagIs(typeTag, tagLen, STRUCT_TAG))
       result = structFromXml(valueXml, offset);
     // Watch for empty/blank strings with no <string>tag
-    else if (typeTag == VALUE_ETAG)
+    else if (tagIs(typeTag, tagLen, VALUE_ETAG))
     {
       *offset = afterValueOffset;   // back up & try again
       result = stringFromXml(valueXml, offset);
@@ -258,20 +293,28 @@ namespace XmlRpc {
 
   // Encode the Value in xml
   std::string XmlRpcValue::toXml() const
+  {
+    std::string xml;
+    toXml(xml);
+    return xml;
+  }
+
+  // Append the encoded Value. Nested values are written into the same
+  // buffer instead of being returned and copied at each level.
+  void XmlRpcValue::toXml(std::string& xml) const
   {
     switch (_type) {
-      case TypeNil:      return nilToXml();
-      case TypeBoolean:  return boolToXml();
-      case TypeInt:      return intToXml();
-      case TypeDouble:   return doubleToXml();
-      case TypeString:   return stringToXml();
-      case TypeDateTime: return timeToXml();
-      case TypeBase64:   return binaryToXml();
-      case TypeArray:    return arrayToXml();
-      case TypeStruct:   return structToXml();
-      default: break;
+      case TypeNil:      nilToXml(xml); break;
+      case TypeBoolean:  boolToXml(xml); break;
+      case TypeInt:      intToXml(xml); break;
+      case TypeDouble:   doubleToXml(xml); break;
+      case TypeString:   stringToXml(xml); break;
+      case TypeDateTime: timeToXml(xml); break;
+      case TypeBase64:   binaryToXml(xml); break;
+      case TypeArray:    arrayToXml(xml); break;
+      case TypeStruct:   structToXml(xml); break;
+      default: break;    // Invalid value
     }
-    return std::string();   // Invalid value
   }
 
   // Nil
@@ -282,12 +325,11 @@ namespace XmlRpc {
     return true;
   }
 
-  std::string XmlRpcValue::nilToXml() const
+  void XmlRpcValue::nilToXml(std::string& xml) const
   {
-    std::string xml = VALUE_TAG;
+    xml += VALUE_TAG;
     xml += NIL_TAG;
     xml += VALUE_ETAG;
-    return xml;
   }
 
   // Boolean
@@ -305,14 +347,13 @@ namespace XmlRpc {
     return true;
   }
 
-  std::string XmlRpcValue::boolToXml() const
+  void XmlRpcValue::boolToXml(std::string& xml) const
   {
-    std::string xml = VALUE_TAG;
+    xml += VALUE_TAG;
     xml += BOOLEAN_TAG;
     xml += (_value.asBool ? "1" : "0");
     xml += BOOLEAN_ETAG;
     xml += VALUE_ETAG;
-    return xml;
   }
 
   // Int
@@ -330,17 +371,16 @@ namespace XmlRpc {
     return true;
   }
 
-  std::string XmlRpcValue::intToXml() const
+  void XmlRpcValue::intToXml(std::string& xml) const
   {
     char buf[256];
     snprintf(buf, sizeof(buf)-1, "%d", _value.asInt);
     buf[sizeof(buf)-1] = 0;
-    std::string xml = VALUE_TAG;
+    xml += VALUE_TAG;
     xml += I4_TAG;
     xml += buf;
     xml += I4_ETAG;
     xml += VALUE_ETAG;
-    return xml;
   }
 
   // Double
@@ -358,18 +398,17 @@ namespace XmlRpc {
     return true;
   }
 
-  std::string XmlRpcValue::doubleToXml() const
+  void XmlRpcValue::doubleToXml(std::string& xml) const
   {
     char buf[256];
     snprintf(buf, sizeof(buf)-1, getDoubleFormat().c_str(), _value.asDouble);
     buf[sizeof(buf)-1] = 0;
 
-    std::string xml = VALUE_TAG;
+    xml += VALUE_TAG;
     xml += DOUBLE_TAG;
     xml += buf;
     xml += DOUBLE_ETAG;
     xml += VALUE_ETAG;
-    return xml;
   }
 
   // String
@@ -380,19 +419,20 @@ namespace XmlRpc {
       return false;     // No end tag;
 
     _type = TypeString;
-    _value.asString = new std::string(XmlRpcUtil::xmlDecode(valueXml.substr(*offset, valueEnd-*offset)));
-    *offset += int(_value.asString->length());
+    _value.asString = new std::string(valueXml, *offset, valueEnd-*offset);
+    if (_value.asString->find('&') != std::string::npos)
+      *_value.asString = XmlRpcUtil::xmlDecode(*_value.asString);
+    *offset = int(valueEnd);
     return true;
   }
 
-  std::string XmlRpcValue::stringToXml() const
+  void XmlRpcValue::stringToXml(std::string& xml) const
   {
-    std::string xml = VALUE_TAG;
+    xml += VALUE_TAG;
     //xml += STRING_TAG; optional
-    xml += XmlRpcUtil::xmlEncode(*_value.asString);
+    XmlRpcUtil::xmlEncode(*_value.asString, xml);
     //xml += STRING_ETAG;
     xml += VALUE_ETAG;
-    return xml;
   }
 
   // DateTime (stored as a struct tm)
@@ -402,20 +442,19 @@ namespace XmlRpc {
     if (valueEnd == std::string::npos)
       return false;     // No end tag;
 
-    std::string stime = valueXml.substr(*offset, valueEnd-*offset);
-
+    // The value ends at '<', so the scan does not run past it
     struct tm t;
-    if (sscanf(stime.c_str(),"%4d%2d%2dT%2d:%2d:%2d",&t.tm_year,&t.tm_mon,&t.tm_mday,&t.tm_hour,&t.tm_min,&t.tm_sec) != 6)
+    if (sscanf(valueXml.c_str() + *offset,"%4d%2d%2dT%2d:%2d:%2d",&t.tm_year,&t.tm_mon,&t.tm_mday,&t.tm_hour,&t.tm_min,&t.tm_sec) != 6)
       return false;
 
     t.tm_isdst = -1;
     _type = TypeDateTime;
     _value.asTime = new struct tm(t);
-    *offset += int(stime.length());
+    *offset = int(valueEnd);
     return true;
   }
 
-  std::string XmlRpcValue::timeToXml() const
+  void XmlRpcValue::timeToXml(std::string& xml) const
   {
     struct tm* t = _value.asTime;
     char buf[20];
@@ -423,12 +462,11 @@ namespace XmlRpc {
       t->tm_year,t->tm_mon,t->tm_mday,t->tm_hour,t->tm_min,t->tm_sec);
     buf[sizeof(buf)-1] = 0;
 
-    std::string xml = VALUE_TAG;
+    xml += VALUE_TAG;
     xml += DATETIME_TAG;
     xml += buf;
     xml += DATETIME_ETAG;
     xml += VALUE_ETAG;
-    return xml;
   }
 
 
@@ -440,7 +478,6 @@ namespace XmlRpc {
       return false;     // No end tag;
 
     _type = TypeBase64;
-    std::string asString = valueXml.substr(*offset, valueEnd-*offset);
     _value.asBinary = new BinaryData();
     // check whether base64 encodings can contain chars xml encodes...
 
@@ -448,14 +485,14 @@ namespace XmlRpc {
     int iostatus = 0;
 	  base64<char> decoder;
     std::back_insert_iterator<BinaryData> ins = std::back_inserter(*(_value.asBinary));
-		decoder.get(asString.begin(), asString.end(), ins, iostatus);
+		decoder.get(valueXml.begin() + *offset, valueXml.begin() + valueEnd, ins, iostatus);
 
-    *offset += int(asString.length());
+    *offset = int(valueEnd);
     return true;
   }
 
 
-  std::string XmlRpcValue::binaryToXml() const
+  void XmlRpcValue::binaryToXml(std::string& xml) const
   {
     // convert to base64
     std::vector<char> base64data;
@@ -465,12 +502,11 @@ namespace XmlRpc {
 		encoder.put(_value.asBinary->begin(), _value.asBinary->end(), ins, iostatus, base64<>::crlf());
 
     // Wrap with xml
-    std::string xml = VALUE_TAG;
+    xml += VALUE_TAG;
     xml += BASE64_TAG;
     xml.append(base64data.begin(), base64data.end());
     xml += BASE64_ETAG;
     xml += VALUE_ETAG;
-    return xml;
   }
 
 
@@ -482,9 +518,21 @@ namespace XmlRpc {
 
     _type = TypeArray;
     _value.asArray = new ValueArray;
+    ValueArray& a = *_value.asArray;
     XmlRpcValue v;
-    while (v.fromXml(valueXml, offset))
-      _value.asArray->push_back(v);       // copy...
+    while (v.fromXml(valueXml, offset)) {
+      // Grow by hand so that the elements are moved (swapped), not copied
+      if (a.size() == a.capacity()) {
+        ValueArray grown;
+        grown.reserve(2 * a.size() + 4);
+        grown.resize(a.size());
+        for (size_t i=0; i<a.size(); ++i)
+          grown[i].swap(a[i]);
+        a.swap(grown);
+      }
+      a.push_back(XmlRpcValue());
+      a.back().swap(v);
+    }
 
     // Skip the trailing </data>
     (void) XmlRpcUtil::nextTagIs(DATA_ETAG, valueXml, offset);
@@ -494,20 +542,19 @@ namespace XmlRpc {
 
   // In general, its preferable to generate the xml of each element of the
   // array as it is needed rather than glomming up one big string.
-  std::string XmlRpcValue::arrayToXml() const
+  void XmlRpcValue::arrayToXml(std::string& xml) const
   {
-    std::string xml = VALUE_TAG;
+    xml += VALUE_TAG;
     xml += ARRAY_TAG;
     xml += DATA_TAG;
 
     int s = int(_value.asArray->size());
     for (int i=0; i<s; ++i)
-       xml += _value.asArray->at(i).toXml();
+       _value.asArray->at(i).toXml(xml);
 
     xml += DATA_ETAG;
     xml += ARRAY_ETAG;
     xml += VALUE_ETAG;
-    return xml;
   }
 
 
@@ -526,8 +573,12 @@ namespace XmlRpc {
         invalidate();
         return false;
       }
-      const std::pair<const std::string, XmlRpcValue> p(name, val);
-      _value.asStruct->insert(p);
+      // Insert an empty value and swap the decoded one in; the first of
+      // several members with the same name is kept
+      std::pair<ValueStruct::iterator, bool> p =
+        _value.asStruct->insert(ValueStruct::value_type(name, XmlRpcValue()));
+      if (p.second)
+        p.first->second.swap(val);
 
       (void) XmlRpcUtil::nextTagIs(MEMBER_ETAG, valueXml, offset);
     }
@@ -537,24 +588,23 @@ namespace XmlRpc {
 
   // In general, its preferable to generate the xml of each element
   // as it is needed rather than glomming up one big string.
-  std::string XmlRpcValue::structToXml() const
+  void XmlRpcValue::structToXml(std::string& xml) const
   {
-    std::string xml = VALUE_TAG;
+    xml += VALUE_TAG;
     xml += STRUCT_TAG;
 
     ValueStruct::const_iterator it;
     for (it=_value.asStruct->begin(); it!=_value.asStruct->end(); ++it) {
       xml += MEMBER_TAG;
       xml += NAME_TAG;
-      xml += XmlRpcUtil::xmlEncode(it->first);
+      XmlRpcUtil::xmlEncode(it->first, xml);
       xml += NAME_ETAG;
-      xml += it->second.toXml();
+      it->second.toXml(xml);
       xml += MEMBER_ETAG;
     }
 
     xml += STRUCT_ETAG;
     xml += VALUE_ETAG;
-    return xml;
   }
 
 
@@ -114,12 +114,19 @@ namespace XmlRpc {
     //! Check for the existence of a struct member by name.
     bool hasMember(const std::string& name) const;
 
+    //! Exchange the contents of two values without copying them.
+    void swap(XmlRpcValue& other);
+
     //! Decode xml. Destroys any existing value.
     bool fromXml(std::string const& valueXml, int* offset);
 
     //! Encode the Value in xml
     std::string toXml() const;
 
+    //! Append the xml encoding of the Value to xml. Reusing a buffer that
+    //! has enough capacity avoids allocations while encoding.
+    void toXml(std::string& xml) const;
+
     //! Write the value (no xml encoding)
     std::ostream& write(std::ostream& os) const;
 
@@ -155,15 +162,15 @@ namespace XmlRpc {
     bool structFromXml(std::string const& valueXml, int* offset);
 
     // XML encoding
-    std::string nilToXml() const;
-    std::string boolToXml() const;
-    std::string intToXml() const;
-    std::string doubleToXml() const;
-    std::string stringToXml() const;
-    std::string timeToXml() const;
-    std::string binaryToXml() const;
-    std::string arrayToXml() const;
-    std::string structToXml() const;
+    void nilToXml(std::string& xml) const;
+    void boolToXml(std::string& xml) const;
+    void intToXml(std::string& xml) const;
+    void doubleToXml(std::string& xml) const;
+    void stringToXml(std::string& xml) const;
+    void timeToXml(std::string& xml) const;
+    void binaryToXml(std::string& xml) const;
+    void arrayToXml(std::string& xml) const;
+    void structToXml(std::string& xml) const;
 
     // Format strings
     static std::string _doubleFormat;
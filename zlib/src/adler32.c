@@ -11,6 +11,21 @@
 
 local uLong adler32_combine_ OF((uLong adler1, uLong adler2, z_off64_t len2));
 
+/* SSSE3 or NEON block sums, see z_cpu_features() */
+#ifdef Z_X86_SIMD
+#  include <immintrin.h>
+#  define ADLER32_SIMD (z_cpu_features() & Z_CPU_SSSE3)
+   local void adler32_simd OF((unsigned long *adler, unsigned long *sum2,
+                               const Bytef *buf, unsigned blocks))
+                               __attribute__((target("ssse3")));
+#endif
+#ifdef Z_ARM_SIMD
+#  include <arm_neon.h>
+#  define ADLER32_SIMD 1
+   local void adler32_simd OF((unsigned long *adler, unsigned long *sum2,
+                               const Bytef *buf, unsigned blocks));
+#endif
+
 #define BASE 65521      /* largest prime smaller than 65536 */
 #define NMAX 5552
 /* NMAX is the largest n such that 255n(n+1)/2 + (n+1)(BASE-1) <= 2^32-1 */
@@ -101,6 +116,15 @@ uLong ZEXPORT adler32(adler, buf, len)
         return adler | (sum2 << 16);
     }
 
+#ifdef ADLER32_SIMD
+    /* leaves fewer than 32 bytes for the scalar code below */
+    if (len >= 64 && ADLER32_SIMD) {
+        adler32_simd(&adler, &sum2, buf, len >> 5);
+        buf += len & ~31U;
+        len &= 31;
+    }
+#endif
+
     /* do length NMAX blocks -- requires just one modulo operation */
     while (len >= NMAX) {
         len -= NMAX;
@@ -132,6 +156,131 @@ uLong ZEXPORT adler32(adler, buf, len)
     return adler | (sum2 << 16);
 }
 
+#if defined(Z_X86_SIMD) || defined(Z_ARM_SIMD)
+
+/* ========================================================================
+ * Vectorized adler32 over 32-byte blocks, as many as fit in NMAX between
+ * modulos.  Per block, sum2 gains 32 times the incoming adler plus the bytes
+ * weighted 32, 31, ..., 1, and adler gains the plain byte sum.  The blocks'
+ * incoming adlers are accumulated and multiplied by 32 once per NMAX run.
+ * Updates *adler and *sum2, reduced modulo BASE, over blocks * 32 bytes.
+ */
+#define BLOCK 32
+
+#ifdef Z_X86_SIMD
+local void adler32_simd(adler, sum2, buf, blocks)
+    unsigned long *adler;
+    unsigned long *sum2;
+    const Bytef *buf;
+    unsigned blocks;
+{
+    const __m128i tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25,
+                                       24, 23, 22, 21, 20, 19, 18, 17);
+    const __m128i tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9,
+                                       8, 7, 6, 5, 4, 3, 2, 1);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+    unsigned long a = *adler, s = *sum2;
+
+    while (blocks) {
+        unsigned n = NMAX / BLOCK;
+        __m128i v_ps, v_s1, v_s2;
+
+        if (n > blocks)
+            n = blocks;
+        blocks -= n;
+        v_ps = _mm_cvtsi32_si128((int)(a * n));
+        v_s1 = zero;
+        v_s2 = _mm_cvtsi32_si128((int)s);
+        do {
+            const __m128i b1 = _mm_loadu_si128((const __m128i *)buf);
+            const __m128i b2 = _mm_loadu_si128((const __m128i *)(buf + 16));
+
+            v_ps = _mm_add_epi32(v_ps, v_s1);
+            v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(b1, zero));
+            v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(b2, zero));
+            v_s2 = _mm_add_epi32(v_s2,
+                       _mm_madd_epi16(_mm_maddubs_epi16(b1, tap1), ones));
+            v_s2 = _mm_add_epi32(v_s2,
+                       _mm_madd_epi16(_mm_maddubs_epi16(b2, tap2), ones));
+            buf += BLOCK;
+        } while (--n);
+        v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+
+        /* horizontal sums */
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, 0xb1));
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, 0x4e));
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, 0xb1));
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, 0x4e));
+        a += (unsigned)_mm_cvtsi128_si32(v_s1);
+        s = (unsigned)_mm_cvtsi128_si32(v_s2);
+        MOD(a);
+        MOD(s);
+    }
+    *adler = a;
+    *sum2 = s;
+}
+#endif /* Z_X86_SIMD */
+
+#ifdef Z_ARM_SIMD
+local void adler32_simd(adler, sum2, buf, blocks)
+    unsigned long *adler;
+    unsigned long *sum2;
+    const Bytef *buf;
+    unsigned blocks;
+{
+    static const uint16_t taps[32] = {
+        32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+        16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1
+    };
+    unsigned long a = *adler, s = *sum2;
+
+    while (blocks) {
+        unsigned n = NMAX / BLOCK;
+        uint32x4_t v_ps, v_s1, v_s2;
+        uint16x8_t col1, col2, col3, col4;
+
+        if (n > blocks)
+            n = blocks;
+        blocks -= n;
+        v_ps = vsetq_lane_u32((uint32_t)(a * n), vdupq_n_u32(0), 0);
+        v_s1 = vdupq_n_u32(0);
+        col1 = col2 = col3 = col4 = vdupq_n_u16(0);
+        do {
+            const uint8x16_t b1 = vld1q_u8(buf);
+            const uint8x16_t b2 = vld1q_u8(buf + 16);
+
+            v_ps = vaddq_u32(v_ps, v_s1);
+            v_s1 = vpadalq_u16(v_s1, vpadalq_u8(vpaddlq_u8(b1), b2));
+            col1 = vaddw_u8(col1, vget_low_u8(b1));
+            col2 = vaddw_u8(col2, vget_high_u8(b1));
+            col3 = vaddw_u8(col3, vget_low_u8(b2));
+            col4 = vaddw_u8(col4, vget_high_u8(b2));
+            buf += BLOCK;
+        } while (--n);
+        v_s2 = vshlq_n_u32(v_ps, 5);
+        v_s2 = vmlal_u16(v_s2, vget_low_u16(col1), vld1_u16(taps + 0));
+        v_s2 = vmlal_u16(v_s2, vget_high_u16(col1), vld1_u16(taps + 4));
+        v_s2 = vmlal_u16(v_s2, vget_low_u16(col2), vld1_u16(taps + 8));
+        v_s2 = vmlal_u16(v_s2, vget_high_u16(col2), vld1_u16(taps + 12));
+        v_s2 = vmlal_u16(v_s2, vget_low_u16(col3), vld1_u16(taps + 16));
+        v_s2 = vmlal_u16(v_s2, vget_high_u16(col3), vld1_u16(taps + 20));
+        v_s2 = vmlal_u16(v_s2, vget_low_u16(col4), vld1_u16(taps + 24));
+        v_s2 = vmlal_u16(v_s2, vget_high_u16(col4), vld1_u16(taps + 28));
+        a += vaddvq_u32(v_s1);
+        s += vaddvq_u32(v_s2);
+        MOD(a);
+        MOD(s);
+    }
+    *adler = a;
+    *sum2 = s;
+}
+#endif /* Z_ARM_SIMD */
+
+#undef BLOCK
+
+#endif /* Z_X86_SIMD || Z_ARM_SIMD */
+
 /* ========================================================================= */
 local uLong adler32_combine_(adler1, adler2, len2)
     uLong adler1;
@@ -0,0 +1,474 @@
+/* gzpar.c -- parallel gzip compression using the zlib library
+ * For conditions of distribution and use, see copyright notice in zlib.h
+ */
+
+/*
+   Each block is held in a job.  The input buffer of a job starts with the
+   dictionary (the last 32K of the input before the block), followed by the
+   block itself.  Jobs are kept on two lists: the in-flight list, in input
+   order, from which the calling thread writes out completed jobs, and the
+   work list, from which the worker threads take jobs to compress.  All of the
+   shared state is protected by one mutex.  The calling thread is the only one
+   that creates, writes, and frees jobs, so a job's input can be read to make
+   the next job's dictionary while a worker is still compressing it.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "gzpar.h"
+
+#define local static
+
+#define DICT 32768U         /* deflate window size */
+
+/* one block to be compressed */
+struct job {
+    unsigned char *in;      /* dictionary followed by input */
+    unsigned dict;          /* length of dictionary */
+    unsigned len;           /* length of input after dictionary */
+    int last;               /* true if this is the final block */
+    unsigned char *out;     /* compressed data */
+    size_t outlen;          /* length of compressed data */
+    unsigned long check;    /* crc32 of the input */
+    int ret;                /* Z_OK, or error from compressing */
+    int done;               /* true when compressed (protected by lock) */
+    struct job *next;       /* next job in work list */
+    struct job *order;      /* next job in in-flight list */
+};
+
+/* gzpar object */
+struct gzpar_state {
+    int level;              /* compression level */
+    unsigned block;         /* input block size */
+    int err;                /* first error, or Z_OK */
+    int fd;                 /* output file descriptor, or -1 for memory */
+    unsigned char *mem;     /* output buffer when fd is -1 */
+    unsigned long memlen;   /* bytes written to mem */
+    unsigned long memmax;   /* size of mem */
+    unsigned long check;    /* crc32 of input written out so far */
+    unsigned long total;    /* total input length, modulo 2^32 */
+    struct job *cur;        /* job being filled, or NULL */
+    struct job *head;       /* oldest job in flight */
+    struct job *tail;       /* newest job in flight */
+    int inflight;           /* number of jobs in flight */
+    int limit;              /* maximum number of jobs in flight */
+    int threads;            /* number of worker threads running */
+    pthread_t *tid;         /* worker thread ids */
+    pthread_mutex_t lock;   /* protects the following and job->done */
+    pthread_cond_t work;    /* signaled when a job is added or on stop */
+    pthread_cond_t done;    /* signaled when a job is compressed */
+    struct job *todo;       /* first job in work list */
+    struct job *todo_tail;  /* last job in work list */
+    int stop;               /* true to have the workers exit */
+};
+
+/* Compress the input of job as raw deflate data, primed with its dictionary.
+   All blocks but the last are ended with a sync flush so that they end on a
+   byte boundary and can be concatenated. */
+local void job_deflate(int level, struct job *job)
+{
+    int ret, flush;
+    size_t max;
+    unsigned char *out;
+    z_stream strm;
+
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+    ret = deflateInit2(&strm, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+    if (ret != Z_OK) {
+        job->ret = ret;
+        return;
+    }
+    if (job->dict)
+        (void)deflateSetDictionary(&strm, job->in, job->dict);
+
+    /* the empty stored block from the sync flush takes at most six bytes
+       beyond the bound, but grow the output if needed anyway */
+    max = deflateBound(&strm, job->len) + 6;
+    out = malloc(max);
+    if (out == NULL) {
+        (void)deflateEnd(&strm);
+        job->ret = Z_MEM_ERROR;
+        return;
+    }
+    strm.next_in = job->in + job->dict;
+    strm.avail_in = job->len;
+    strm.next_out = out;
+    strm.avail_out = (unsigned)max;
+    flush = job->last ? Z_FINISH : Z_SYNC_FLUSH;
+    for (;;) {
+        ret = deflate(&strm, flush);
+        if (job->last ? ret == Z_STREAM_END : strm.avail_out != 0)
+            break;
+        if (strm.avail_out == 0) {
+            unsigned char *more = realloc(out, max << 1);
+
+            if (more == NULL) {
+                free(out);
+                (void)deflateEnd(&strm);
+                job->ret = Z_MEM_ERROR;
+                return;
+            }
+            out = more;
+            strm.next_out = out + max;
+            strm.avail_out = (unsigned)max;
+            max <<= 1;
+        }
+    }
+    job->outlen = max - strm.avail_out;
+    job->out = out;
+    (void)deflateEnd(&strm);
+
+    job->check = crc32(crc32(0L, Z_NULL, 0), job->in + job->dict, job->len);
+    job->ret = Z_OK;
+}
+
+/* Worker thread: compress jobs from the work list until told to stop. */
+local void *worker(void *arg)
+{
+    struct gzpar_state *par = arg;
+    struct job *job;
+
+    pthread_mutex_lock(&par->lock);
+    for (;;) {
+        while (par->todo == NULL && !par->stop)
+            pthread_cond_wait(&par->work, &par->lock);
+        job = par->todo;
+        if (job == NULL)
+            break;
+        par->todo = job->next;
+        if (par->todo == NULL)
+            par->todo_tail = NULL;
+        pthread_mutex_unlock(&par->lock);
+
+        job_deflate(par->level, job);
+
+        pthread_mutex_lock(&par->lock);
+        job->done = 1;
+        pthread_cond_broadcast(&par->done);
+    }
+    pthread_mutex_unlock(&par->lock);
+    return NULL;
+}
+
+/* Write len bytes from buf to the output.  Return 0 on success, or -1 with
+   par->err set on error. */
+local int put(struct gzpar_state *par, const unsigned char *buf, size_t len)
+{
+    ssize_t ret;
+
+    if (par->err != Z_OK)
+        return -1;
+    if (par->fd == -1) {
+        if (len > par->memmax - par->memlen) {
+            par->err = Z_BUF_ERROR;
+            return -1;
+        }
+        memcpy(par->mem + par->memlen, buf, len);
+        par->memlen += len;
+        return 0;
+    }
+    while (len) {
+        ret = write(par->fd, buf, len);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            par->err = Z_ERRNO;
+            return -1;
+        }
+        buf += ret;
+        len -= ret;
+    }
+    return 0;
+}
+
+/* Write a little-endian four-byte integer to the output. */
+local int put4(struct gzpar_state *par, unsigned long val)
+{
+    unsigned char buf[4];
+
+    buf[0] = val & 0xff;
+    buf[1] = (val >> 8) & 0xff;
+    buf[2] = (val >> 16) & 0xff;
+    buf[3] = (val >> 24) & 0xff;
+    return put(par, buf, 4);
+}
+
+/* Start a new empty job, with its dictionary taken from the end of the input
+   of prev if not NULL.  Return -1 with par->err set on error. */
+local int job_new(struct gzpar_state *par, struct job *prev)
+{
+    unsigned have;
+    struct job *job;
+
+    job = malloc(sizeof(struct job));
+    if (job == NULL) {
+        par->err = Z_MEM_ERROR;
+        return -1;
+    }
+    job->in = malloc(DICT + par->block);
+    if (job->in == NULL) {
+        free(job);
+        par->err = Z_MEM_ERROR;
+        return -1;
+    }
+    job->dict = 0;
+    if (prev != NULL) {
+        have = prev->dict + prev->len;
+        job->dict = have < DICT ? have : DICT;
+        memcpy(job->in, prev->in + have - job->dict, job->dict);
+    }
+    job->len = 0;
+    job->last = 0;
+    job->out = NULL;
+    job->outlen = 0;
+    job->ret = Z_OK;
+    job->done = 0;
+    job->next = NULL;
+    job->order = NULL;
+    par->cur = job;
+    return 0;
+}
+
+/* Wait for the oldest job in flight to be compressed, write it out, and free
+   it.  Once an error has occurred, the jobs are only freed. */
+local void job_retire(struct gzpar_state *par)
+{
+    struct job *job = par->head;
+
+    if (par->threads) {
+        pthread_mutex_lock(&par->lock);
+        while (!job->done)
+            pthread_cond_wait(&par->done, &par->lock);
+        pthread_mutex_unlock(&par->lock);
+    }
+    if (par->err == Z_OK && job->ret != Z_OK)
+        par->err = job->ret;
+    if (put(par, job->out, job->outlen) == 0)
+        par->check = crc32_combine(par->check, job->check, job->len);
+    par->head = job->order;
+    if (par->head == NULL)
+        par->tail = NULL;
+    par->inflight--;
+    free(job->out);
+    free(job->in);
+    free(job);
+}
+
+/* Hand the current job off for compression, then write out completed jobs
+   until there is room for another job in flight. */
+local void job_submit(struct gzpar_state *par, int last)
+{
+    struct job *job = par->cur;
+
+    par->cur = NULL;
+    job->last = last;
+    par->total += job->len;
+    if (par->tail == NULL)
+        par->head = job;
+    else
+        par->tail->order = job;
+    par->tail = job;
+    par->inflight++;
+    if (par->threads) {
+        pthread_mutex_lock(&par->lock);
+        if (par->todo_tail == NULL)
+            par->todo = job;
+        else
+            par->todo_tail->next = job;
+        par->todo_tail = job;
+        pthread_cond_signal(&par->work);
+        pthread_mutex_unlock(&par->lock);
+    }
+    else
+        job_deflate(par->level, job);
+    if (!last)
+        (void)job_new(par, job);
+    while (par->inflight >= par->limit)
+        job_retire(par);
+}
+
+/* Tell the worker threads to exit and wait for them. */
+local void par_stop(struct gzpar_state *par)
+{
+    int n;
+
+    if (par->threads == 0)
+        return;
+    pthread_mutex_lock(&par->lock);
+    par->stop = 1;
+    pthread_cond_broadcast(&par->work);
+    pthread_mutex_unlock(&par->lock);
+    for (n = 0; n < par->threads; n++)
+        pthread_join(par->tid[n], NULL);
+    par->threads = 0;
+}
+
+/* Free a gzpar object after its threads have stopped. */
+local void par_free(struct gzpar_state *par)
+{
+    while (par->head != NULL)
+        job_retire(par);
+    if (par->cur != NULL) {
+        free(par->cur->in);
+        free(par->cur);
+    }
+    free(par->tid);
+    pthread_cond_destroy(&par->done);
+    pthread_cond_destroy(&par->work);
+    pthread_mutex_destroy(&par->lock);
+    free(par);
+}
+
+/* Create a gzpar object writing to fd, or to mem if fd is -1, start its
+   threads, and write the gzip header. */
+local struct gzpar_state *par_open(int fd, unsigned char *mem,
+                                   unsigned long memmax, int level,
+                                   int threads, unsigned block)
+{
+    int n;
+    unsigned char head[10];
+    struct gzpar_state *par;
+
+    if (level == Z_DEFAULT_COMPRESSION)
+        level = 6;
+    if (level < 0 || level > 9 || (block && block < DICT))
+        return NULL;
+    par = malloc(sizeof(struct gzpar_state));
+    if (par == NULL)
+        return NULL;
+    par->level = level;
+    par->block = block ? block : GZPAR_BLOCK;
+    par->err = Z_OK;
+    par->fd = fd;
+    par->mem = mem;
+    par->memlen = 0;
+    par->memmax = memmax;
+    par->check = crc32(0L, Z_NULL, 0);
+    par->total = 0;
+    par->cur = NULL;
+    par->head = par->tail = NULL;
+    par->inflight = 0;
+    par->limit = threads > 1 ? threads << 1 : 1;
+    par->threads = 0;
+    par->tid = NULL;
+    pthread_mutex_init(&par->lock, NULL);
+    pthread_cond_init(&par->work, NULL);
+    pthread_cond_init(&par->done, NULL);
+    par->todo = par->todo_tail = NULL;
+    par->stop = 0;
+
+    if (threads > 1) {
+        par->tid = malloc(threads * sizeof(pthread_t));
+        if (par->tid == NULL) {
+            par_free(par);
+            return NULL;
+        }
+        for (n = 0; n < threads; n++) {
+            if (pthread_create(par->tid + n, NULL, worker, par)) {
+                par_stop(par);
+                par_free(par);
+                return NULL;
+            }
+            par->threads++;
+        }
+    }
+    if (job_new(par, NULL)) {
+        par_stop(par);
+        par_free(par);
+        return NULL;
+    }
+
+    /* gzip header: no name or time stamp, extra flags per level, Unix */
+    head[0] = 0x1f;
+    head[1] = 0x8b;
+    head[2] = 8;
+    head[3] = 0;
+    head[4] = head[5] = head[6] = head[7] = 0;
+    head[8] = level == 9 ? 2 : (level == 1 ? 4 : 0);
+    head[9] = 3;
+    (void)put(par, head, 10);
+    return par;
+}
+
+/* Compress the remaining input and write the gzip trailer.  Return the first
+   error that occurred, or Z_OK. */
+local int par_finish(struct gzpar_state *par)
+{
+    if (par->cur != NULL)
+        job_submit(par, 1);
+    while (par->head != NULL)
+        job_retire(par);
+    put4(par, par->check);
+    put4(par, par->total);
+    par_stop(par);
+    return par->err;
+}
+
+/* -- see gzpar.h for interface descriptions -- */
+
+gzpar gzpar_fdopen(int fd, int level, int threads, unsigned block)
+{
+    if (fd < 0)
+        return NULL;
+    return par_open(fd, NULL, 0, level, threads, block);
+}
+
+size_t gzpar_write(gzpar par, const void *buf, size_t len)
+{
+    unsigned n;
+    const unsigned char *next = buf;
+    size_t left = len;
+
+    if (par == NULL || par->err != Z_OK)
+        return 0;
+    while (left) {
+        /* submit a full block only once there is more input, so that the
+           last block is never empty unless the whole stream is */
+        if (par->cur->len == par->block) {
+            job_submit(par, 0);
+            if (par->err != Z_OK)
+                return 0;
+        }
+        n = par->block - par->cur->len;
+        if (n > left)
+            n = (unsigned)left;
+        memcpy(par->cur->in + par->cur->dict + par->cur->len, next, n);
+        par->cur->len += n;
+        next += n;
+        left -= n;
+    }
+    return len;
+}
+
+int gzpar_close(gzpar par)
+{
+    int ret;
+
+    if (par == NULL)
+        return Z_STREAM_ERROR;
+    ret = par_finish(par);
+    par_free(par);
+    return ret;
+}
+
+int gzpar_compress(unsigned char *dest, unsigned long *destLen,
+                   const unsigned char *source, unsigned long sourceLen,
+                   int level, int threads)
+{
+    int ret;
+    struct gzpar_state *par;
+
+    par = par_open(-1, dest, *destLen, level, threads, 0);
+    if (par == NULL)
+        return Z_STREAM_ERROR;
+    (void)gzpar_write(par, source, sourceLen);
+    ret = par_finish(par);
+    *destLen = par->memlen;
+    par_free(par);
+    return ret;
+}
@@ -0,0 +1,79 @@
+/* gzpar.h -- parallel gzip compression using the zlib library
+ * For conditions of distribution and use, see copyright notice in zlib.h
+ */
+
+/*
+   The gzpar object compresses data to a single standard gzip stream using
+   several threads, in the manner of pigz.  The input is cut into blocks, and
+   each block is compressed independently on a worker thread as raw deflate
+   data.  Every block other than the first is primed with the last 32K of the
+   preceding input using deflateSetDictionary(), so matches can still reach
+   back across block boundaries and the compression ratio stays close to that
+   of a single deflate stream.  Blocks other than the last are ended with
+   Z_SYNC_FLUSH so that they end on a byte boundary and can simply be
+   concatenated.  The check values of the blocks are merged with
+   crc32_combine().  The result is a gzip member that any gzip decoder can
+   read, including gzread() and inflate().
+
+   Output is always written in order by the thread calling gzpar_write() and
+   gzpar_close().  The number of blocks in flight is limited to twice the
+   number of threads, so memory use is bounded by roughly
+   threads * 2 * (block size + compressed block size).
+
+   The output is not identical to that of deflate() with the same level,
+   since each block starts with fresh statistics and an empty hash table,
+   but it is usually within a fraction of a percent in size.
+
+   gzpar uses POSIX threads.  With threads less than two, no threads are
+   created and the blocks are compressed by the calling thread.
+ */
+
+#ifndef GZPAR_H
+#define GZPAR_H
+
+#include <stddef.h>
+#include "zlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* gzpar object type */
+typedef struct gzpar_state *gzpar;
+
+/* Default size of the input blocks compressed by each thread. */
+#define GZPAR_BLOCK 131072U
+
+/* Open a gzpar object that writes a gzip stream to the file descriptor fd,
+   compressing at level (0..9, or Z_DEFAULT_COMPRESSION) with threads threads
+   and blocks of block bytes (0 for GZPAR_BLOCK, otherwise at least 32K).
+   Return NULL on an invalid parameter or if memory or threads could not be
+   allocated.  fd is not closed by gzpar_close(). */
+gzpar gzpar_fdopen(int fd, int level, int threads, unsigned block);
+
+/* Write len bytes from buf to the gzpar object.  Return len, or 0 on error,
+   in which case gzpar_close() will return the error.  Blocks are handed to the
+   worker threads as they fill up, and completed blocks are written out in
+   order as they become available. */
+size_t gzpar_write(gzpar par, const void *buf, size_t len);
+
+/* Compress any remaining input, write the end of the gzip stream, stop the
+   threads, and free the object.  Return Z_OK on success, Z_ERRNO on a write
+   error, Z_MEM_ERROR if memory ran out, or Z_STREAM_ERROR if par is NULL. */
+int gzpar_close(gzpar par);
+
+/* Compress sourceLen bytes from source into dest as a single gzip stream,
+   like compress2() but with gzip wrapping and threads threads.  On entry,
+   *destLen is the size of dest, on exit it is the size of the gzip stream.
+   Return Z_OK on success, Z_BUF_ERROR if dest was too small, Z_MEM_ERROR if
+   memory ran out while compressing, or Z_STREAM_ERROR if a parameter is
+   invalid or the object could not be created. */
+int gzpar_compress(unsigned char *dest, unsigned long *destLen,
+                   const unsigned char *source, unsigned long sourceLen,
+                   int level, int threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -30,6 +30,13 @@
 
 #include "zutil.h"      /* for STDC and FAR definitions */
 
+#ifdef Z_X86_SIMD
+#  include <immintrin.h>
+#endif
+#ifdef Z_ARM_SIMD
+#  include <arm_acle.h>
+#endif
+
 #define local static
 
 /* Definitions for doing the crc four data bytes at a time. */
@@ -46,6 +53,17 @@
 #  define TBLS 1
 #endif /* BYFOUR */
 
+/* Hardware-assisted crc, see z_cpu_features() */
+#ifdef Z_X86_SIMD
+   local unsigned long crc32_pclmul OF((unsigned long,
+                        const unsigned char FAR *, unsigned))
+                        __attribute__((target("pclmul")));
+#endif
+#ifdef Z_ARM_SIMD
+   local unsigned long crc32_armv8 OF((unsigned long,
+                        const unsigned char FAR *, unsigned)) Z_TARGET_CRC;
+#endif
+
 /* Local functions for crc concatenation */
 local unsigned long gf2_matrix_times OF((unsigned long *mat,
                                          unsigned long vec));
@@ -213,6 +231,22 @@ unsigned long ZEXPORT crc32(crc, buf, len)
         make_crc_table();
 #endif /* DYNAMIC_CRC_TABLE */
 
+#ifdef Z_X86_SIMD
+    if (len >= 64 && (z_cpu_features() & Z_CPU_PCLMUL)) {
+        uInt n = len & ~(uInt)15;       /* whole 16-byte blocks */
+
+        crc = crc32_pclmul(crc, buf, n);
+        buf += n;
+        len -= n;
+        if (len == 0)
+            return crc;
+    }
+#endif /* Z_X86_SIMD */
+#ifdef Z_ARM_SIMD
+    if (z_cpu_features() & Z_CPU_ARM_CRC32)
+        return crc32_armv8(crc, buf, len);
+#endif /* Z_ARM_SIMD */
+
 #ifdef BYFOUR
     if (sizeof(void *) == sizeof(ptrdiff_t)) {
         z_crc_t endian;
@@ -321,6 +355,131 @@ local unsigned long crc32_big(crc, buf, len)
 
 #endif /* BYFOUR */
 
+#ifdef Z_X86_SIMD
+
+/* ========================================================================
+ * Carry-less multiplication crc, after Gopal et al., "Fast CRC Computation
+ * for Generic Polynomials Using PCLMULQDQ Instruction" (Intel, 2009).  Four
+ * 128-bit lanes are folded forward 64 bytes at a time, then folded into one
+ * lane, and the final 64 bits are reduced to the crc by Barrett reduction.
+ * The constants are powers of x modulo the (bit-reflected) crc polynomial.
+ * len must be a multiple of 16, and at least 64.
+ */
+local unsigned long crc32_pclmul(crc, buf, len)
+    unsigned long crc;
+    const unsigned char FAR *buf;
+    unsigned len;
+{
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596LL, 0x0154442bd4LL);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009eLL, 0x01751997d0LL);
+    const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124LL);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641LL, 0x01db710641LL);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+    __m128i x1, x2, x3, x4, y1, y2, y3, y4;
+
+    x1 = _mm_loadu_si128((const __m128i *)(buf + 0x00));
+    x2 = _mm_loadu_si128((const __m128i *)(buf + 0x10));
+    x3 = _mm_loadu_si128((const __m128i *)(buf + 0x20));
+    x4 = _mm_loadu_si128((const __m128i *)(buf + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)~(z_crc_t)crc));
+    buf += 64;
+    len -= 64;
+
+    /* fold four lanes forward by 512 bits */
+    while (len >= 64) {
+        y1 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        y2 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        y3 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        y4 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, y1),
+                           _mm_loadu_si128((const __m128i *)(buf + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, y2),
+                           _mm_loadu_si128((const __m128i *)(buf + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, y3),
+                           _mm_loadu_si128((const __m128i *)(buf + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, y4),
+                           _mm_loadu_si128((const __m128i *)(buf + 0x30)));
+        buf += 64;
+        len -= 64;
+    }
+
+    /* fold the four lanes into one, then any remaining 16-byte blocks */
+#define FOLD128(x, next) \
+    y1 = _mm_clmulepi64_si128(x, k3k4, 0x00); \
+    x = _mm_clmulepi64_si128(x, k3k4, 0x11); \
+    x = _mm_xor_si128(_mm_xor_si128(x, y1), next)
+    FOLD128(x1, x2);
+    FOLD128(x1, x3);
+    FOLD128(x1, x4);
+    while (len >= 16) {
+        FOLD128(x1, _mm_loadu_si128((const __m128i *)buf));
+        buf += 16;
+        len -= 16;
+    }
+#undef FOLD128
+
+    /* fold 128 bits to 64 */
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    /* Barrett reduction to 32 bits */
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    return (unsigned long)~(z_crc_t)_mm_cvtsi128_si32(_mm_srli_si128(x1, 4));
+}
+
+#endif /* Z_X86_SIMD */
+
+#ifdef Z_ARM_SIMD
+
+/* ========================================================================
+ * ARMv8 crc32 instructions, eight bytes at a time once aligned.
+ */
+local unsigned long crc32_armv8(crc, buf, len)
+    unsigned long crc;
+    const unsigned char FAR *buf;
+    unsigned len;
+{
+    register z_crc_t c;
+
+    c = ~(z_crc_t)crc;
+    while (len && ((ptrdiff_t)buf & 7)) {
+        c = __crc32b(c, *buf++);
+        len--;
+    }
+    while (len >= 32) {
+        c = __crc32d(c, *(const uint64_t *)(const void *)buf);
+        c = __crc32d(c, *(const uint64_t *)(const void *)(buf + 8));
+        c = __crc32d(c, *(const uint64_t *)(const void *)(buf + 16));
+        c = __crc32d(c, *(const uint64_t *)(const void *)(buf + 24));
+        buf += 32;
+        len -= 32;
+    }
+    while (len >= 8) {
+        c = __crc32d(c, *(const uint64_t *)(const void *)buf);
+        buf += 8;
+        len -= 8;
+    }
+    while (len) {
+        c = __crc32b(c, *buf++);
+        len--;
+    }
+    return (unsigned long)~c;
+}
+
+#endif /* Z_ARM_SIMD */
+
 #define GF2_DIM 32      /* dimension of GF(2) vectors (length of CRC) */
 
 /* ========================================================================= */
@@ -50,6 +50,9 @@
 /* @(#) $Id$ */
 
 #include "deflate.h"
+#if defined(Z_ARM_SIMD) && !defined(FASTEST)
+#  include <arm_acle.h>
+#endif
 
 const char deflate_copyright[] =
    " deflate 1.2.8 Copyright 1995-2013 Jean-loup Gailly and Mark Adler ";
@@ -166,6 +169,55 @@ struct static_tree_desc_s {int dummy;}; /* for buggy compilers */
  */
 #define UPDATE_HASH(s,h,c) (h = (((h)<<s->hash_shift) ^ (c)) & s->hash_mask)
 
+/* ===========================================================================
+ * Set ins_h to the hash of the string at window index str: either by
+ * UPDATE_HASH with the string's last byte, or, when crc_hash is set, as the
+ * crc32c of its first four bytes.  The crc hash is not a running one, so it
+ * does not depend on earlier calls, and its better mixing makes for shorter
+ * hash chains.  As it covers four bytes, three-byte matches are only found
+ * when they happen to share a chain.  crc_hash is only set for levels 1..6
+ * on CPUs with a crc32c instruction (see deflateInit2_), and needs the
+ * WORD_MATCH longest_match(), which does not assume scan[2] == match[2].
+ */
+#if (defined(Z_X86_SIMD) || (defined(Z_ARM_SIMD) && !defined(__AARCH64EB__))) \
+    && !defined(UNALIGNED_OK) && !defined(ASMV) && !defined(FASTEST)
+#  define WORD_MATCH    /* longest_match() compares eight bytes at a time */
+#endif
+
+#if defined(Z_X86_SIMD) && defined(WORD_MATCH)
+#  define CRC_HASH_OK (z_cpu_features() & Z_CPU_SSE4_2)
+local unsigned crc_hash(p)
+    const Bytef *p;
+{
+    unsigned h = 0, v;
+
+    __builtin_memcpy(&v, p, 4);
+    __asm__("crc32l %1, %0" : "+r"(h) : "rm"(v));
+    return h;
+}
+#elif defined(Z_ARM_SIMD) && defined(WORD_MATCH)
+#  define CRC_HASH_OK (z_cpu_features() & Z_CPU_ARM_CRC32)
+local unsigned crc_hash OF((const Bytef *p)) Z_TARGET_CRC;
+local unsigned crc_hash(p)
+    const Bytef *p;
+{
+    unsigned v;
+
+    __builtin_memcpy(&v, p, 4);
+    return __crc32cw(0, v);
+}
+#endif
+
+#ifdef CRC_HASH_OK
+#  define UPDATE_INS_H(s, str) \
+    ((s)->crc_hash ? \
+     ((s)->ins_h = crc_hash((s)->window + (str)) & (s)->hash_mask) : \
+     UPDATE_HASH(s, (s)->ins_h, (s)->window[(str) + (MIN_MATCH-1)]))
+#else
+#  define UPDATE_INS_H(s, str) \
+    UPDATE_HASH(s, (s)->ins_h, (s)->window[(str) + (MIN_MATCH-1)])
+#endif
+
 
 /* ===========================================================================
  * Insert string str in the dictionary and set match_head to the previous head
@@ -179,12 +231,12 @@ struct static_tree_desc_s {int dummy;}; /* for buggy compilers */
  */
 #ifdef FASTEST
 #define INSERT_STRING(s, str, match_head) \
-   (UPDATE_HASH(s, s->ins_h, s->window[(str) + (MIN_MATCH-1)]), \
+   (UPDATE_INS_H(s, str), \
     match_head = s->head[s->ins_h], \
     s->head[s->ins_h] = (Pos)(str))
 #else
 #define INSERT_STRING(s, str, match_head) \
-   (UPDATE_HASH(s, s->ins_h, s->window[(str) + (MIN_MATCH-1)]), \
+   (UPDATE_INS_H(s, str), \
     match_head = s->prev[(str) & s->w_mask] = s->head[s->ins_h], \
     s->head[s->ins_h] = (Pos)(str))
 #endif
@@ -290,7 +342,7 @@ int ZEXPORT deflateInit2_(strm, level, method, windowBits, memLevel, strategy,
     s->hash_mask = s->hash_size - 1;
     s->hash_shift =  ((s->hash_bits+MIN_MATCH-1)/MIN_MATCH);
 
-    s->window = (Bytef *) ZALLOC(strm, s->w_size, 2*sizeof(Byte));
+    s->window = (Bytef *) ZALLOC(strm, s->w_size + WIN_PAD/2, 2*sizeof(Byte));
     s->prev   = (Posf *)  ZALLOC(strm, s->w_size, sizeof(Pos));
     s->head   = (Posf *)  ZALLOC(strm, s->hash_size, sizeof(Pos));
 
@@ -311,10 +363,16 @@ int ZEXPORT deflateInit2_(strm, level, method, windowBits, memLevel, strategy,
     }
     s->d_buf = overlay + s->lit_bufsize/sizeof(ush);
     s->l_buf = s->pending_buf + (1+sizeof(ush))*s->lit_bufsize;
+    zmemzero(s->window + 2*s->w_size, WIN_PAD);
+    s->alloc_w_bits = s->w_bits;
+    s->alloc_hash_bits = s->hash_bits;
 
     s->level = level;
     s->strategy = strategy;
     s->method = (Byte)method;
+#ifdef CRC_HASH_OK
+    s->crc_hash = level >= 1 && level <= 6 && CRC_HASH_OK;
+#endif
 
     return deflateReset(strm);
 }
@@ -365,7 +423,7 @@ int ZEXPORT deflateSetDictionary (strm, dictionary, dictLength)
         str = s->strstart;
         n = s->lookahead - (MIN_MATCH-1);
         do {
-            UPDATE_HASH(s, s->ins_h, s->window[str + MIN_MATCH-1]);
+            UPDATE_INS_H(s, str);
 #ifndef FASTEST
             s->prev[str & s->w_mask] = s->head[s->ins_h];
 #endif
@@ -435,6 +493,116 @@ int ZEXPORT deflateReset (strm)
     return ret;
 }
 
+/* ========================================================================= */
+int ZEXPORT deflateReset2 (strm, level, windowBits, memLevel, strategy)
+    z_streamp strm;
+    int  level;
+    int  windowBits;
+    int  memLevel;
+    int  strategy;
+{
+    deflate_state *s;
+    int wrap = 1;
+    Bytef *window = Z_NULL;
+    Posf *prev = Z_NULL;
+    Posf *head = Z_NULL;
+    ushf *overlay = Z_NULL;
+
+    if (strm == Z_NULL || strm->state == Z_NULL ||
+        strm->zalloc == (alloc_func)0 || strm->zfree == (free_func)0) {
+        return Z_STREAM_ERROR;
+    }
+    s = strm->state;
+
+#ifdef FASTEST
+    if (level != 0) level = 1;
+#else
+    if (level == Z_DEFAULT_COMPRESSION) level = 6;
+#endif
+
+    if (windowBits < 0) { /* suppress zlib wrapper */
+        wrap = 0;
+        windowBits = -windowBits;
+    }
+#ifdef GZIP
+    else if (windowBits > 15) {
+        wrap = 2;       /* write gzip wrapper instead */
+        windowBits -= 16;
+    }
+#endif
+    if (memLevel < 1 || memLevel > MAX_MEM_LEVEL ||
+        windowBits < 8 || windowBits > 15 || level < 0 || level > 9 ||
+        strategy < 0 || strategy > Z_FIXED) {
+        return Z_STREAM_ERROR;
+    }
+    if (windowBits == 8) windowBits = 9;  /* until 256-byte window bug fixed */
+
+    /* Allocate only what has to grow, before freeing anything, so that the
+     * stream is left as it was if memory runs out. Smaller sizes just use
+     * the start of the existing arrays.
+     */
+    if ((uInt)windowBits > s->alloc_w_bits) {
+        window = (Bytef *) ZALLOC(strm, (1 << windowBits) + WIN_PAD/2,
+                                  2*sizeof(Byte));
+        prev   = (Posf *)  ZALLOC(strm, 1 << windowBits, sizeof(Pos));
+    }
+    if ((uInt)memLevel + 7 > s->alloc_hash_bits) {
+        head    = (Posf *) ZALLOC(strm, 1 << (memLevel + 7), sizeof(Pos));
+        overlay = (ushf *) ZALLOC(strm, 1 << (memLevel + 6), sizeof(ush)+2);
+    }
+    if (((uInt)windowBits > s->alloc_w_bits &&
+         (window == Z_NULL || prev == Z_NULL)) ||
+        ((uInt)memLevel + 7 > s->alloc_hash_bits &&
+         (head == Z_NULL || overlay == Z_NULL))) {
+        TRY_FREE(strm, overlay);
+        TRY_FREE(strm, head);
+        TRY_FREE(strm, prev);
+        TRY_FREE(strm, window);
+        return Z_MEM_ERROR;
+    }
+    if (window != Z_NULL) {
+        ZFREE(strm, s->window);
+        ZFREE(strm, s->prev);
+        s->window = window;
+        s->prev = prev;
+        s->alloc_w_bits = windowBits;
+        s->high_water = 0;
+    }
+    if (head != Z_NULL) {
+        ZFREE(strm, s->head);
+        ZFREE(strm, s->pending_buf);
+        s->head = head;
+        s->pending_buf = (uchf *) overlay;
+        s->alloc_hash_bits = memLevel + 7;
+    }
+
+    s->wrap = wrap;
+    s->gzhead = Z_NULL;
+    s->w_bits = windowBits;
+    s->w_size = 1 << s->w_bits;
+    s->w_mask = s->w_size - 1;
+    zmemzero(s->window + 2*s->w_size, WIN_PAD);
+
+    s->hash_bits = memLevel + 7;
+    s->hash_size = 1 << s->hash_bits;
+    s->hash_mask = s->hash_size - 1;
+    s->hash_shift =  ((s->hash_bits+MIN_MATCH-1)/MIN_MATCH);
+
+    s->lit_bufsize = 1 << (memLevel + 6);
+    s->pending_buf_size = (ulg)s->lit_bufsize * (sizeof(ush)+2L);
+    overlay = (ushf *) s->pending_buf;
+    s->d_buf = overlay + s->lit_bufsize/sizeof(ush);
+    s->l_buf = s->pending_buf + (1+sizeof(ush))*s->lit_bufsize;
+
+    s->level = level;
+    s->strategy = strategy;
+#ifdef CRC_HASH_OK
+    s->crc_hash = level >= 1 && level <= 6 && CRC_HASH_OK;
+#endif
+
+    return deflateReset(strm);
+}
+
 /* ========================================================================= */
 int ZEXPORT deflateSetHeader (strm, head)
     z_streamp strm;
@@ -1037,7 +1205,7 @@ int ZEXPORT deflateCopy (dest, source)
     zmemcpy((voidpf)ds, (voidpf)ss, sizeof(deflate_state));
     ds->strm = dest;
 
-    ds->window = (Bytef *) ZALLOC(dest, ds->w_size, 2*sizeof(Byte));
+    ds->window = (Bytef *) ZALLOC(dest, ds->w_size + WIN_PAD/2, 2*sizeof(Byte));
     ds->prev   = (Posf *)  ZALLOC(dest, ds->w_size, sizeof(Pos));
     ds->head   = (Posf *)  ZALLOC(dest, ds->hash_size, sizeof(Pos));
     overlay = (ushf *) ZALLOC(dest, ds->lit_bufsize, sizeof(ush)+2);
@@ -1049,7 +1217,7 @@ int ZEXPORT deflateCopy (dest, source)
         return Z_MEM_ERROR;
     }
     /* following zmemcpy do not work for 16-bit MSDOS */
-    zmemcpy(ds->window, ss->window, ds->w_size * 2 * sizeof(Byte));
+    zmemcpy(ds->window, ss->window, (ds->w_size * 2 + WIN_PAD) * sizeof(Byte));
     zmemcpy((voidpf)ds->prev, (voidpf)ss->prev, ds->w_size * sizeof(Pos));
     zmemcpy((voidpf)ds->head, (voidpf)ss->head, ds->hash_size * sizeof(Pos));
     zmemcpy(ds->pending_buf, ss->pending_buf, (uInt)ds->pending_buf_size);
@@ -1061,6 +1229,8 @@ int ZEXPORT deflateCopy (dest, source)
     ds->l_desc.dyn_tree = ds->dyn_ltree;
     ds->d_desc.dyn_tree = ds->dyn_dtree;
     ds->bl_desc.dyn_tree = ds->bl_tree;
+    ds->alloc_w_bits = ds->w_bits;
+    ds->alloc_hash_bits = ds->hash_bits;
 
     return Z_OK;
 #endif /* MAXSEG_64K */
@@ -1251,6 +1421,25 @@ local uInt longest_match(s, cur_match)
          * the hash keys are equal and that HASH_BITS >= 8.
          */
         scan += 2, match++;
+#ifdef WORD_MATCH
+        /* Compare eight bytes at a time, starting with scan[2] since the crc
+         * hash does not imply it.  The first difference is the lowest set bit
+         * of the exclusive-or (little-endian).  This may read up to seven
+         * bytes past strend, which WIN_PAD provides for at the window's end.
+         */
+        do {
+            unsigned long long sw, mw;
+
+            __builtin_memcpy(&sw, scan, 8);
+            __builtin_memcpy(&mw, match, 8);
+            if (sw != mw) {
+                scan += __builtin_ctzll(sw ^ mw) >> 3;
+                break;
+            }
+            scan += 8, match += 8;
+        } while (scan < strend);
+        if (scan > strend) scan = strend;
+#else
         Assert(*scan == *match, "match[2]?");
 
         /* We check for insufficient lookahead only every 8th comparison;
@@ -1262,6 +1451,7 @@ local uInt longest_match(s, cur_match)
                  *++scan == *++match && *++scan == *++match &&
                  *++scan == *++match && *++scan == *++match &&
                  scan < strend);
+#endif
 
         Assert(scan <= s->window+(unsigned)(s->window_size-1), "wild scan");
 
@@ -1476,7 +1666,7 @@ local void fill_window(s)
             Call UPDATE_HASH() MIN_MATCH-3 more times
 #endif
             while (s->insert) {
-                UPDATE_HASH(s, s->ins_h, s->window[str + MIN_MATCH-1]);
+                UPDATE_INS_H(s, str);
 #ifndef FASTEST
                 s->prev[str & s->w_mask] = s->head[s->ins_h];
 #endif
@@ -1527,6 +1717,15 @@ local void fill_window(s)
         }
     }
 
+#ifdef CRC_HASH_OK
+    /* The crc hash of the last string before the end of the data reads one
+     * byte past it.  Zero that byte, so that the output does not depend on
+     * what the window held before, for example after deflateReset().
+     */
+    if (s->crc_hash && s->lookahead < MIN_LOOKAHEAD)
+        s->window[s->strstart + s->lookahead] = 0;
+#endif
+
     Assert((ulg)s->strstart <= s->window_size - MIN_LOOKAHEAD,
            "not enough room for search");
 }
@@ -148,6 +148,11 @@ typedef struct internal_state {
      *   hash_shift * MIN_MATCH >= hash_bits
      */
 
+    int   crc_hash;
+    /* True to hash four bytes with a crc32c instruction instead of keeping
+     * the running hash above (see UPDATE_INS_H in deflate.c).
+     */
+
     long block_start;
     /* Window position at the beginning of the current output block. Gets
      * negative when the window is moved backwards.
@@ -270,6 +275,10 @@ typedef struct internal_state {
      * updated to the new high water mark.
      */
 
+    uInt  alloc_w_bits;     /* w_bits that window and prev were allocated for */
+    uInt  alloc_hash_bits;  /* hash_bits that head and pending_buf were
+                             * allocated for (memLevel + 7) */
+
 } FAR deflate_state;
 
 /* Output a byte on the stream.
@@ -292,6 +301,10 @@ typedef struct internal_state {
 /* Number of bytes after end of data in window to initialize in order to avoid
    memory checker errors from longest match routines */
 
+#define WIN_PAD 8
+/* Number of bytes allocated (and zeroed) past window_size, so that the crc
+   hash and the word-wise match comparison may read a little beyond the end */
+
         /* in trees.c */
 void ZLIB_INTERNAL _tr_init OF((deflate_state *s));
 int ZLIB_INTERNAL _tr_tally OF((deflate_state *s, unsigned dist, unsigned lc));
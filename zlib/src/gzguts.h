@@ -135,6 +135,17 @@
     ZEXTERN z_off64_t ZEXPORT gzoffset64 OF((gzFile));
 #endif
 
+/* seek on a file descriptor with large file support if available */
+#if defined(_WIN32) && !defined(__BORLANDC__)
+#  define LSEEK _lseeki64
+#else
+#if defined(_LARGEFILE64_SOURCE) && _LFS64_LARGEFILE-0
+#  define LSEEK lseek64
+#else
+#  define LSEEK lseek
+#endif
+#endif
+
 /* default memLevel */
 #if MAX_MEM_LEVEL >= 8
 #  define DEF_MEM_LEVEL 8
@@ -146,6 +157,13 @@
    twice this must be able to fit in an unsigned type) */
 #define GZBUFSIZE 8192
 
+/* size of the window saved with each access point of a gzip index */
+#define GZ_WINSIZE 32768U
+
+/* number of compressed bytes at each access point whose crc is saved with a
+   gzip index, to reject an index loaded for a different file */
+#define GZ_CHECKLEN 64U
+
 /* gzip modes, also provide a little integrity check on the passed structure */
 #define GZ_NONE 0
 #define GZ_READ 7247
@@ -157,6 +175,14 @@
 #define COPY 1      /* copy input directly */
 #define GZIP 2      /* decompress a gzip stream */
 
+/* access point in a gzip file for random access, see gzbuildindex() */
+typedef struct {
+    z_off64_t out;          /* offset in uncompressed data */
+    z_off64_t in;           /* offset in file of first full byte */
+    int bits;               /* number of bits (1-7) from byte at in - 1, or 0 */
+    unsigned char *window;  /* preceding GZ_WINSIZE bytes of uncompressed data */
+} gz_point;
+
 /* internal gzip file state data structure */
 typedef struct {
         /* exposed contents for gzgetc() macro */
@@ -178,6 +204,10 @@ typedef struct {
     z_off64_t start;        /* where the gzip data started, for rewinding */
     int eof;                /* true if end of input file reached */
     int past;               /* true if read requested past end */
+    int raw;                /* true if inflating raw deflate after a jump */
+    int trail;              /* gzip trailer bytes left to skip after a jump */
+    gz_point *index;        /* access points for gzseek(), or NULL */
+    unsigned points;        /* number of access points in index */
         /* just for writing */
     int level;              /* compression level */
     int strategy;           /* compression strategy */
@@ -194,6 +224,7 @@ typedef gz_state FAR *gz_statep;
 
 /* shared functions */
 void ZLIB_INTERNAL gz_error OF((gz_statep, int, const char *));
+int ZLIB_INTERNAL gz_index_seek OF((gz_statep, z_off64_t));
 #if defined UNDER_CE
 char ZLIB_INTERNAL *gz_strwinerror OF((DWORD error));
 #endif
@@ -5,16 +5,6 @@
 
 #include "gzguts.h"
 
-#if defined(_WIN32) && !defined(__BORLANDC__)
-#  define LSEEK _lseeki64
-#else
-#if defined(_LARGEFILE64_SOURCE) && _LFS64_LARGEFILE-0
-#  define LSEEK lseek64
-#else
-#  define LSEEK lseek
-#endif
-#endif
-
 /* Local functions */
 local void gz_reset OF((gz_statep));
 local gzFile gz_open OF((const void *, int, const char *));
@@ -80,6 +70,10 @@ local void gz_reset(state)
         state->eof = 0;             /* not at end of file */
         state->past = 0;            /* have not read past end yet */
         state->how = LOOK;          /* look for gzip header */
+        if (state->raw)             /* back to gzip after an index jump */
+            inflateReset2(&(state->strm), 15 + 16);
+        state->raw = 0;
+        state->trail = 0;
     }
     state->seek = 0;                /* no seek request pending */
     gz_error(state, Z_OK, NULL);    /* clear error */
@@ -120,6 +114,9 @@ local gzFile gz_open(path, fd, mode)
     state->level = Z_DEFAULT_COMPRESSION;
     state->strategy = Z_DEFAULT_STRATEGY;
     state->direct = 0;
+    state->raw = 0;
+    state->index = NULL;
+    state->points = 0;
     while (*mode) {
         if (*mode >= '0' && *mode <= '9')
             state->level = *mode - '0';
@@ -365,7 +362,7 @@ z_off64_t ZEXPORT gzseek64(file, offset, whence)
     int whence;
 {
     unsigned n;
-    z_off64_t ret;
+    z_off64_t ret, target;
     gz_statep state;
 
     /* get internal structure and check integrity */
@@ -406,6 +403,16 @@ z_off64_t ZEXPORT gzseek64(file, offset, whence)
         return state->x.pos;
     }
 
+    /* if reading with an index, jump to the nearest access point if that is
+       closer than the current position, then skip the rest of the way */
+    if (state->mode == GZ_READ && state->points &&
+            state->x.pos + offset >= 0) {
+        target = state->x.pos + offset;
+        if (gz_index_seek(state, target) == -1)
+            return -1;
+        offset = target - state->x.pos;
+    }
+
     /* calculate skip amount, rewinding if needed for back seek when reading */
     if (offset < 0) {
         if (state->mode != GZ_READ)         /* writing -- can't go backwards */
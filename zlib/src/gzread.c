@@ -12,6 +12,13 @@ local int gz_look OF((gz_statep));
 local int gz_decomp OF((gz_statep));
 local int gz_fetch OF((gz_statep));
 local int gz_skip OF((gz_statep, z_off64_t));
+local void gz_index_free OF((gz_statep));
+local int gz_index_add OF((gz_statep, unsigned *, z_off64_t, unsigned char *,
+                           unsigned));
+local int gz_jump OF((gz_statep, gz_point *));
+local int gz_index_check OF((gz_statep, gz_point *, unsigned long *));
+local int gz_putall OF((int, unsigned char *, unsigned));
+local int gz_getall OF((int, unsigned char *, unsigned));
 
 /* Use read() to load a buffer -- return -1 on error, otherwise 0.  Read from
    state->fd, and update state->eof, state->err, and state->msg as appropriate.
@@ -86,6 +93,7 @@ local int gz_avail(state)
 local int gz_look(state)
     gz_statep state;
 {
+    unsigned n;
     z_streamp strm = &(state->strm);
 
     /* allocate read buffers and inflate memory */
@@ -118,6 +126,22 @@ local int gz_look(state)
         }
     }
 
+    /* skip the trailer of a gzip stream that was finished as raw deflate data
+       after a jump to an index access point */
+    while (state->trail) {
+        if (strm->avail_in == 0) {
+            if (gz_avail(state) == -1)
+                return -1;
+            if (strm->avail_in == 0)
+                return 0;
+        }
+        n = strm->avail_in < (unsigned)state->trail ?
+            strm->avail_in : (unsigned)state->trail;
+        strm->next_in += n;
+        strm->avail_in -= n;
+        state->trail -= n;
+    }
+
     /* get at least the magic bytes in the input buffer */
     if (strm->avail_in < 2) {
         if (gz_avail(state) == -1)
@@ -209,9 +233,16 @@ local int gz_decomp(state)
     state->x.have = had - strm->avail_out;
     state->x.next = strm->next_out - state->x.have;
 
-    /* if the gzip stream completed successfully, look for another */
-    if (ret == Z_STREAM_END)
+    /* if the gzip stream completed successfully, look for another -- if it
+       was finished as raw deflate data, skip its trailer first */
+    if (ret == Z_STREAM_END) {
+        if (state->raw) {
+            inflateReset2(strm, 15 + 16);
+            state->raw = 0;
+            state->trail = 8;
+        }
         state->how = LOOK;
+    }
 
     /* good decompression */
     return 0;
@@ -284,6 +315,212 @@ local int gz_skip(state, len)
     return 0;
 }
 
+/* Free the access points of the index, if any. */
+local void gz_index_free(state)
+    gz_statep state;
+{
+    while (state->points)
+        free(state->index[--state->points].window);
+    if (state->index != NULL)
+        free(state->index);
+    state->index = NULL;
+}
+
+/* Add an access point at the current position of the inflate stream, which
+   must be at a deflate block boundary, with out bytes of uncompressed data
+   before it.  window is the circular buffer of the last GZ_WINSIZE bytes of
+   uncompressed data, of which the last left bytes are the oldest.  *room is
+   the number of points allocated.  Return -1 on error, otherwise 0. */
+local int gz_index_add(state, room, out, window, left)
+    gz_statep state;
+    unsigned *room;
+    z_off64_t out;
+    unsigned char *window;
+    unsigned left;
+{
+    z_off64_t in;
+    gz_point *point;
+
+    /* the next input byte is at the end of what was read, less what is left
+       in the input buffer */
+    in = LSEEK(state->fd, 0, SEEK_CUR);
+    if (in == -1) {
+        gz_error(state, Z_ERRNO, zstrerror());
+        return -1;
+    }
+    in -= state->strm.avail_in;
+
+    /* make room for another point */
+    if (state->points == *room) {
+        point = (gz_point *)realloc(state->index,
+                                    (*room ? *room << 1 : 8) * sizeof(gz_point));
+        if (point == NULL) {
+            gz_error(state, Z_MEM_ERROR, "out of memory");
+            return -1;
+        }
+        state->index = point;
+        *room = *room ? *room << 1 : 8;
+    }
+    point = state->index + state->points;
+    point->window = (unsigned char *)malloc(GZ_WINSIZE);
+    if (point->window == NULL) {
+        gz_error(state, Z_MEM_ERROR, "out of memory");
+        return -1;
+    }
+
+    /* save the point, with the window unrolled oldest first */
+    point->out = out;
+    point->in = in;
+    point->bits = state->strm.data_type & 7;
+    if (left)
+        memcpy(point->window, window + GZ_WINSIZE - left, left);
+    if (left < GZ_WINSIZE)
+        memcpy(point->window + left, window, GZ_WINSIZE - left);
+    state->points++;
+    return 0;
+}
+
+/* Resume decompression at an access point, inflating raw deflate data from
+   there until the end of the gzip stream it is in.  The check value of that
+   stream is not verified.  Return -1 on error, otherwise 0. */
+local int gz_jump(state, point)
+    gz_statep state;
+    gz_point *point;
+{
+    int ch;
+    z_streamp strm = &(state->strm);
+
+    /* allocate buffers and inflate memory if not done yet -- the index does
+       not apply if the file turns out not to be gzip */
+    if (state->size == 0 && gz_look(state) == -1)
+        return -1;
+    if (state->size == 0 || state->direct)
+        return -1;
+
+    /* go to the access point, backing up a byte if it starts mid-byte */
+    if (LSEEK(state->fd, point->in - (point->bits ? 1 : 0), SEEK_SET) == -1) {
+        gz_error(state, Z_ERRNO, zstrerror());
+        return -1;
+    }
+    state->x.have = 0;
+    state->eof = 0;
+    state->past = 0;
+    state->trail = 0;
+    strm->avail_in = 0;
+    gz_error(state, Z_OK, NULL);
+
+    /* prime the raw inflate state with the bits and the window */
+    inflateReset2(strm, -15);
+    state->raw = 1;
+    if (point->bits) {
+        if (gz_avail(state) == -1)
+            return -1;
+        if (strm->avail_in == 0) {
+            gz_error(state, Z_BUF_ERROR, "unexpected end of file");
+            return -1;
+        }
+        ch = *(strm->next_in)++;
+        strm->avail_in--;
+        inflatePrime(strm, point->bits, ch >> (8 - point->bits));
+    }
+    inflateSetDictionary(strm, point->window, GZ_WINSIZE);
+    state->how = GZIP;
+    state->x.pos = point->out;
+    return 0;
+}
+
+/* Jump to the last access point at or before target, if that is closer to
+   target than the current position.  Return -1 on error, otherwise 0. */
+int ZLIB_INTERNAL gz_index_seek(state, target)
+    gz_statep state;
+    z_off64_t target;
+{
+    unsigned lo, hi, mid;
+    gz_point *point;
+
+    /* binary search -- the first point is always at zero */
+    lo = 0;
+    hi = state->points;
+    while (hi - lo > 1) {
+        mid = lo + ((hi - lo) >> 1);
+        if (state->index[mid].out <= target)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    point = state->index + lo;
+    if (target < state->x.pos || point->out > state->x.pos)
+        return gz_jump(state, point);
+    return 0;
+}
+
+/* Compute in *check the crc of the first GZ_CHECKLEN compressed bytes at
+   point, or of as many as there are before the end of the file.  The file
+   position is restored afterwards.  Return -1 on error, otherwise 0. */
+local int gz_index_check(state, point, check)
+    gz_statep state;
+    gz_point *point;
+    unsigned long *check;
+{
+    int ret;
+    unsigned got;
+    z_off64_t pos;
+    unsigned char buf[GZ_CHECKLEN];
+
+    pos = LSEEK(state->fd, 0, SEEK_CUR);
+    if (pos == -1 ||
+            LSEEK(state->fd, point->in - (point->bits ? 1 : 0), SEEK_SET) == -1)
+        return -1;
+    got = 0;
+    do {
+        ret = read(state->fd, buf + got, GZ_CHECKLEN - got);
+        if (ret <= 0)
+            break;
+        got += ret;
+    } while (got < GZ_CHECKLEN);
+    if (LSEEK(state->fd, pos, SEEK_SET) == -1 || ret < 0)
+        return -1;
+    *check = crc32(crc32(0L, Z_NULL, 0), buf, got);
+    return 0;
+}
+
+/* Write len bytes from buf to fd.  Return -1 on error, otherwise 0. */
+local int gz_putall(fd, buf, len)
+    int fd;
+    unsigned char *buf;
+    unsigned len;
+{
+    int ret;
+
+    while (len) {
+        ret = write(fd, buf, len);
+        if (ret <= 0)
+            return -1;
+        buf += ret;
+        len -= ret;
+    }
+    return 0;
+}
+
+/* Read len bytes from fd to buf.  Return -1 on error or end of file,
+   otherwise 0. */
+local int gz_getall(fd, buf, len)
+    int fd;
+    unsigned char *buf;
+    unsigned len;
+{
+    int ret;
+
+    while (len) {
+        ret = read(fd, buf, len);
+        if (ret <= 0)
+            return -1;
+        buf += ret;
+        len -= ret;
+    }
+    return 0;
+}
+
 /* -- see zlib.h -- */
 int ZEXPORT gzread(file, buf, len)
     gzFile file;
@@ -563,6 +800,276 @@ int ZEXPORT gzdirect(file)
     return state->direct;
 }
 
+/* -- see zlib.h -- */
+int ZEXPORT gzbuildindex(file, span)
+    gzFile file;
+    unsigned long span;
+{
+    int ret;
+    unsigned had, room;
+    z_off64_t pos, out, last;
+    unsigned char *window;
+    gz_statep state;
+    z_streamp strm;
+
+    /* get internal structure */
+    if (file == NULL)
+        return -1;
+    state = (gz_statep)file;
+    strm = &(state->strm);
+
+    /* check that we're reading and that there's no (serious) error */
+    if (state->mode != GZ_READ ||
+            (state->err != Z_OK && state->err != Z_BUF_ERROR))
+        return -1;
+
+    /* remember where to return to, then start over without an index */
+    pos = state->x.pos + (state->seek ? state->skip : 0);
+    gz_index_free(state);
+    if (gzrewind(file) == -1 || gz_look(state) == -1)
+        return -1;
+
+    /* nothing to index if the file is not gzip */
+    if (state->how == GZIP) {
+        window = (unsigned char *)malloc(GZ_WINSIZE);
+        if (window == NULL) {
+            gz_error(state, Z_MEM_ERROR, "out of memory");
+            return -1;
+        }
+        memset(window, 0, GZ_WINSIZE);
+
+        /* decompress the whole file a deflate block at a time, adding an
+           access point at the first block boundary at least span bytes past
+           the previous one */
+        room = 0;
+        out = last = 0;
+        strm->avail_out = 0;
+        for (;;) {
+            if (strm->avail_in == 0 && gz_avail(state) == -1)
+                break;
+            if (strm->avail_in == 0) {
+                gz_error(state, Z_BUF_ERROR, "unexpected end of file");
+                break;
+            }
+            if (strm->avail_out == 0) {
+                strm->avail_out = GZ_WINSIZE;
+                strm->next_out = window;
+            }
+            had = strm->avail_out;
+            ret = inflate(strm, Z_BLOCK);
+            out += had - strm->avail_out;
+            if (ret == Z_STREAM_ERROR || ret == Z_NEED_DICT) {
+                gz_error(state, Z_STREAM_ERROR,
+                         "internal error: inflate stream corrupt");
+                break;
+            }
+            if (ret == Z_MEM_ERROR) {
+                gz_error(state, Z_MEM_ERROR, "out of memory");
+                break;
+            }
+            if (ret == Z_DATA_ERROR) {
+                gz_error(state, Z_DATA_ERROR,
+                         strm->msg == NULL ? "compressed data error" :
+                         strm->msg);
+                break;
+            }
+
+            /* at the end of a gzip stream, look for another one */
+            if (ret == Z_STREAM_END) {
+                state->how = LOOK;
+                if (gz_look(state) == -1 || state->how != GZIP)
+                    break;
+                continue;
+            }
+
+            if ((strm->data_type & 128) && !(strm->data_type & 64) &&
+                    (state->points == 0 || out - last >= (z_off64_t)span)) {
+                if (gz_index_add(state, &room, out, window,
+                                 strm->avail_out) == -1)
+                    break;
+                last = out;
+            }
+        }
+        free(window);
+        if (state->err != Z_OK) {
+            gz_index_free(state);
+            return -1;
+        }
+    }
+
+    /* go back to where we were, using the index */
+    if (gzrewind(file) == -1 || gzseek64(file, pos, SEEK_SET) == -1)
+        return -1;
+    return 0;
+}
+
+/* -- see zlib.h -- */
+int ZEXPORT gzsaveindex(file, path)
+    gzFile file;
+    const char *path;
+{
+    int fd, n;
+    unsigned i;
+    unsigned char head[21];
+    unsigned long check;
+    z_off64_t val;
+    gz_point *point;
+    gz_statep state;
+
+    /* get internal structure */
+    if (file == NULL || path == NULL)
+        return -1;
+    state = (gz_statep)file;
+    if (state->mode != GZ_READ || state->points == 0)
+        return -1;
+
+    fd = open(path,
+#ifdef O_BINARY
+              O_BINARY |
+#endif
+              O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd == -1)
+        return -1;
+
+    /* magic and number of points */
+    head[0] = 'G';
+    head[1] = 'Z';
+    head[2] = 'I';
+    head[3] = 'X';
+    for (n = 0; n < 4; n++)
+        head[4 + n] = (unsigned char)(state->points >> (n << 3));
+    if (gz_putall(fd, head, 8) == -1) {
+        close(fd);
+        return -1;
+    }
+
+    /* each point as the uncompressed offset and the offset relative to the
+       start of the gzip data, little-endian, then the bits, the crc of the
+       compressed data there, and the window */
+    for (i = 0; i < state->points; i++) {
+        point = state->index + i;
+        if (gz_index_check(state, point, &check) == -1) {
+            close(fd);
+            return -1;
+        }
+        val = point->out;
+        for (n = 0; n < 8; n++, val >>= 8)
+            head[n] = (unsigned char)(val & 0xff);
+        val = point->in - state->start;
+        for (n = 8; n < 16; n++, val >>= 8)
+            head[n] = (unsigned char)(val & 0xff);
+        head[16] = (unsigned char)point->bits;
+        for (n = 17; n < 21; n++, check >>= 8)
+            head[n] = (unsigned char)(check & 0xff);
+        if (gz_putall(fd, head, 21) == -1 ||
+                gz_putall(fd, point->window, GZ_WINSIZE) == -1) {
+            close(fd);
+            return -1;
+        }
+    }
+    return close(fd) == -1 ? -1 : 0;
+}
+
+/* -- see zlib.h -- */
+int ZEXPORT gzloadindex(file, path)
+    gzFile file;
+    const char *path;
+{
+    int fd, n, ok;
+    unsigned i, points;
+    unsigned char head[21];
+    unsigned long check, want;
+    z_off64_t out, in;
+    gz_point *index;
+    gz_statep state;
+
+    /* get internal structure */
+    if (file == NULL || path == NULL)
+        return -1;
+    state = (gz_statep)file;
+    if (state->mode != GZ_READ)
+        return -1;
+
+    fd = open(path,
+#ifdef O_BINARY
+              O_BINARY |
+#endif
+              O_RDONLY);
+    if (fd == -1)
+        return -1;
+
+    /* check the magic and get the number of points */
+    if (gz_getall(fd, head, 8) == -1 || memcmp(head, "GZIX", 4) != 0) {
+        close(fd);
+        return -1;
+    }
+    points = 0;
+    for (n = 3; n >= 0; n--)
+        points = (points << 8) + head[4 + n];
+    if (points == 0 || points > (unsigned)-1 / sizeof(gz_point)) {
+        close(fd);
+        return -1;
+    }
+    index = (gz_point *)malloc(points * sizeof(gz_point));
+    if (index == NULL) {
+        close(fd);
+        return -1;
+    }
+
+    /* read and check the points -- offsets must fit in z_off64_t, the
+       uncompressed offsets must start at zero and not decrease, and the
+       compressed data at each point must match the file */
+    ok = 1;
+    for (i = 0; ok && i < points; i++) {
+        ok = gz_getall(fd, head, 21) == 0 && head[16] < 8;
+        for (n = 8; ok && n > (int)sizeof(z_off64_t); n--)
+            ok = head[n - 1] == 0 && head[n + 7] == 0;
+        if (ok && ((head[n - 1] | head[n + 7]) & 0x80))
+            ok = 0;
+        if (!ok)
+            break;
+        out = in = 0;
+        for (; n > 0; n--) {
+            out = (out << 8) + head[n - 1];
+            in = (in << 8) + head[n + 7];
+        }
+        in += state->start;
+        ok = (i ? out >= index[i - 1].out : out == 0) &&
+             (head[16] == 0 || in > state->start);
+        if (!ok)
+            break;
+        index[i].out = out;
+        index[i].in = in;
+        index[i].bits = head[16];
+        want = 0;
+        for (n = 20; n >= 17; n--)
+            want = (want << 8) + head[n];
+        ok = gz_index_check(state, index + i, &check) == 0 && check == want;
+        if (!ok)
+            break;
+        index[i].window = (unsigned char *)malloc(GZ_WINSIZE);
+        if (index[i].window == NULL ||
+                gz_getall(fd, index[i].window, GZ_WINSIZE) == -1) {
+            ok = 0;
+            i++;
+            break;
+        }
+    }
+    close(fd);
+    if (!ok) {
+        while (i)
+            free(index[--i].window);
+        free(index);
+        return -1;
+    }
+
+    /* replace any index in use */
+    gz_index_free(state);
+    state->index = index;
+    state->points = points;
+    return 0;
+}
+
 /* -- see zlib.h -- */
 int ZEXPORT gzclose_r(file)
     gzFile file;
@@ -585,6 +1092,7 @@ int ZEXPORT gzclose_r(file)
         free(state->out);
         free(state->in);
     }
+    gz_index_free(state);
     err = state->err == Z_BUF_ERROR ? Z_BUF_ERROR : Z_OK;
     gz_error(state, Z_OK, NULL);
     free(state->path);
@@ -29,6 +29,80 @@
 #  define PUP(a) *++(a)
 #endif
 
+#ifdef INFLATE_FAST64
+/* Make sure hold has at least 15 bits.  Six bytes are added with one
+   unaligned little-endian load.  The load also leaves the leading bits of the
+   next two bytes in hold above bits; the byte-wise refills below or these
+   bits in again with the same values, and they are masked off on return. */
+#  define NEED15() \
+    do { \
+        if (bits < 15) { \
+            unsigned long next; \
+            __builtin_memcpy(&next, in + OFF, 8); \
+            hold |= next << bits; \
+            in += 6; \
+            bits += 48; \
+        } \
+    } while (0)
+
+/* Copy len bytes to out from dist bytes before it, where the two may overlap,
+   in chunks of eight or sixteen bytes.  Up to fifteen bytes past out + len
+   may be written.  Returns out + len. */
+local unsigned char FAR *chunk_copy(out, dist, len)
+    unsigned char FAR *out;
+    unsigned dist;
+    unsigned len;
+{
+    unsigned char FAR *end = out + len;
+    const unsigned char FAR *from = out - dist;
+
+    if (dist == 1) {                    /* run of one byte */
+        __builtin_memset(out, *from, len);
+        return end;
+    }
+    if (dist < 8) {
+        /* lay down the pattern up to a multiple of dist that is at least
+           eight, then copy whole chunks from that far back */
+        unsigned step = dist * ((8 + dist - 1) / dist);
+        unsigned n = step < len ? step : len;
+
+        len -= n;
+        do {
+            *out++ = *from++;
+        } while (--n);
+        if (len == 0)
+            return end;
+        dist = step;
+        from = out - dist;
+    }
+    if (dist >= 16) {
+        do {
+            __builtin_memcpy(out, from, 16);
+            out += 16;
+            from += 16;
+        } while (out < end);
+    }
+    else {
+        do {
+            __builtin_memcpy(out, from, 8);
+            out += 8;
+            from += 8;
+        } while (out < end);
+    }
+    return end;
+}
+#else
+#  define NEED15() \
+    do { \
+        if (bits < 15) { \
+            hold |= (unsigned long)(PUP(in)) << bits; \
+            bits += 8; \
+            hold |= (unsigned long)(PUP(in)) << bits; \
+            bits += 8; \
+        } \
+    } while (0)
+#endif
+
 /*
    Decode literal, length, and distance codes and write out the resulting
    literal and match bytes until either not enough input or output is
@@ -40,8 +114,8 @@
    Entry assumptions:
 
         state->mode == LEN
-        strm->avail_in >= 6
-        strm->avail_out >= 258
+        strm->avail_in >= INFLATE_FAST_MIN_HAVE (6, or 10 with INFLATE_FAST64)
+        strm->avail_out >= INFLATE_FAST_MIN_LEFT (258, or 274)
         start >= strm->avail_out
         state->bits < 8
 
@@ -63,6 +137,13 @@
       bytes, which is the maximum length that can be coded.  inflate_fast()
       requires strm->avail_out >= 258 for each loop to avoid checking for
       output space.
+
+    - With INFLATE_FAST64, a refill may read two bytes past the six it
+      consumes.  When hold has fifteen or more bits at the top of the loop,
+      the length extra bits may still need a byte, after which the distance
+      refill reads eight more, so one loop may read nine bytes.  A chunked
+      match copy may write fifteen bytes past its end.  Hence the larger
+      margins for input and output.
  */
 void ZLIB_INTERNAL inflate_fast(strm, start)
 z_streamp strm;
@@ -97,10 +178,10 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
     /* copy state to local variables */
     state = (struct inflate_state FAR *)strm->state;
     in = strm->next_in - OFF;
-    last = in + (strm->avail_in - 5);
+    last = in + (strm->avail_in - (INFLATE_FAST_MIN_HAVE - 1));
     out = strm->next_out - OFF;
     beg = out - (start - strm->avail_out);
-    end = out + (strm->avail_out - 257);
+    end = out + (strm->avail_out - (INFLATE_FAST_MIN_LEFT - 1));
 #ifdef INFLATE_STRICT
     dmax = state->dmax;
 #endif
@@ -118,12 +199,7 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
     /* decode literals and length/distances until end-of-block or not enough
        input data or output space */
     do {
-        if (bits < 15) {
-            hold += (unsigned long)(PUP(in)) << bits;
-            bits += 8;
-            hold += (unsigned long)(PUP(in)) << bits;
-            bits += 8;
-        }
+        NEED15();
         here = lcode[hold & lmask];
       dolen:
         op = (unsigned)(here.bits);
@@ -141,7 +217,7 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
             op &= 15;                           /* number of extra bits */
             if (op) {
                 if (bits < op) {
-                    hold += (unsigned long)(PUP(in)) << bits;
+                    hold |= (unsigned long)(PUP(in)) << bits;
                     bits += 8;
                 }
                 len += (unsigned)hold & ((1U << op) - 1);
@@ -149,12 +225,7 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                 bits -= op;
             }
             Tracevv((stderr, "inflate:         length %u\n", len));
-            if (bits < 15) {
-                hold += (unsigned long)(PUP(in)) << bits;
-                bits += 8;
-                hold += (unsigned long)(PUP(in)) << bits;
-                bits += 8;
-            }
+            NEED15();
             here = dcode[hold & dmask];
           dodist:
             op = (unsigned)(here.bits);
@@ -165,10 +236,10 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                 dist = (unsigned)(here.val);
                 op &= 15;                       /* number of extra bits */
                 if (bits < op) {
-                    hold += (unsigned long)(PUP(in)) << bits;
+                    hold |= (unsigned long)(PUP(in)) << bits;
                     bits += 8;
                     if (bits < op) {
-                        hold += (unsigned long)(PUP(in)) << bits;
+                        hold |= (unsigned long)(PUP(in)) << bits;
                         bits += 8;
                     }
                 }
@@ -266,6 +337,9 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                     }
                 }
                 else {
+#ifdef INFLATE_FAST64
+                    out = chunk_copy(out + OFF, dist, len) - OFF;
+#else
                     from = out - dist;          /* copy direct from output */
                     do {                        /* minimum length is three */
                         PUP(out) = PUP(from);
@@ -278,6 +352,7 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                         if (len > 1)
                             PUP(out) = PUP(from);
                     }
+#endif
                 }
             }
             else if ((op & 64) == 0) {          /* 2nd level distance code */
@@ -315,9 +390,12 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
     /* update state and return */
     strm->next_in = in + OFF;
     strm->next_out = out + OFF;
-    strm->avail_in = (unsigned)(in < last ? 5 + (last - in) : 5 - (in - last));
+    strm->avail_in = (unsigned)(in < last ?
+                                (INFLATE_FAST_MIN_HAVE - 1) + (last - in) :
+                                (INFLATE_FAST_MIN_HAVE - 1) - (in - last));
     strm->avail_out = (unsigned)(out < end ?
-                                 257 + (end - out) : 257 - (out - end));
+                                 (INFLATE_FAST_MIN_LEFT - 1) + (end - out) :
+                                 (INFLATE_FAST_MIN_LEFT - 1) - (out - end));
     state->hold = hold;
     state->bits = bits;
     return;
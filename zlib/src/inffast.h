@@ -8,4 +8,20 @@
    subject to change. Applications should only use zlib.h.
  */
 
+/* With a 64-bit bit accumulator, inflate_fast() refills six bytes at a time
+   with an eight-byte load and copies matches in chunks, which needs more
+   input and output space on entry than the minimum of six bytes in and 258
+   bytes out.  One loop can read nine bytes: a length extra byte, then a
+   refill.  Ten leaves a byte to spare. */
+#if (defined(__x86_64__) || \
+     (defined(__aarch64__) && !defined(__AARCH64EB__))) && \
+    defined(__LP64__) && defined(__GNUC__) && !defined(ASMINF)
+#  define INFLATE_FAST64
+#  define INFLATE_FAST_MIN_HAVE 10
+#  define INFLATE_FAST_MIN_LEFT (258 + 16)
+#else
+#  define INFLATE_FAST_MIN_HAVE 6
+#  define INFLATE_FAST_MIN_LEFT 258
+#endif
+
 void ZLIB_INTERNAL inflate_fast OF((z_streamp strm, unsigned start));
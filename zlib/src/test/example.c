@@ -15,8 +15,12 @@
 
 #if defined(VMS) || defined(RISCOS)
 #  define TESTFILE "foo-gz"
+#  define TESTINDEX "foo-gzi"
+#  define TESTOTHER "bar-gz"
 #else
 #  define TESTFILE "foo.gz"
+#  define TESTINDEX "foo.gzi"
+#  define TESTOTHER "bar.gz"
 #endif
 
 #define CHECK_ERR(err, msg) { \
@@ -41,6 +45,7 @@ void test_large_deflate OF((Byte *compr, uLong comprLen,
                             Byte *uncompr, uLong uncomprLen));
 void test_large_inflate OF((Byte *compr, uLong comprLen,
                             Byte *uncompr, uLong uncomprLen));
+void test_inflate_margin OF((void));
 void test_flush         OF((Byte *compr, uLong *comprLen));
 void test_sync          OF((Byte *compr, uLong comprLen,
                             Byte *uncompr, uLong uncomprLen));
@@ -81,6 +86,8 @@ void test_compress      OF((Byte *compr, uLong comprLen,
                             Byte *uncompr, uLong uncomprLen));
 void test_gzio          OF((const char *fname,
                             Byte *uncompr, uLong uncomprLen));
+void test_gzindex       OF((const char *fname, const char *iname,
+                            const char *oname));
 
 /* ===========================================================================
  * Test compress() and uncompress()
@@ -192,6 +199,181 @@ void test_gzio(fname, uncompr, uncomprLen)
 #endif
 }
 
+#ifndef NO_GZCOMPRESS
+
+#define IDXMEMBER 100000L   /* uncompressed length of each gzip member */
+#define IDXFLUSH 20000L     /* distance between full flushes */
+#define IDXSPAN 16384L      /* span between index access points */
+
+/* byte at offset pos in the uncompressed data of the index test files */
+static int idx_byte(pos, seed)
+    z_off_t pos;
+    int seed;
+{
+    return (int)((pos * 7 + (pos >> 10) * seed) ^ (pos >> 5)) & 0xff;
+}
+
+/* write two concatenated gzip members of IDXMEMBER bytes each */
+static void idx_write(fname, seed)
+    const char *fname;
+    int seed;
+{
+    int member;
+    z_off_t pos;
+    gzFile file;
+
+    for (member = 0; member < 2; member++) {
+        file = gzopen(fname, member ? "ab" : "wb");
+        if (file == NULL) {
+            fprintf(stderr, "gzopen error\n");
+            exit(1);
+        }
+        for (pos = member * IDXMEMBER; pos < (member + 1) * IDXMEMBER; pos++) {
+            gzputc(file, idx_byte(pos, seed));
+            if (pos % IDXFLUSH == IDXFLUSH - 1)
+                gzflush(file, Z_FULL_FLUSH);
+        }
+        if (gzclose(file) != Z_OK) {
+            fprintf(stderr, "gzclose error\n");
+            exit(1);
+        }
+    }
+}
+
+/* seek to each of a few positions, forwards and back, and check a read */
+static void idx_check(file, seed, msg)
+    gzFile file;
+    int seed;
+    const char *msg;
+{
+    static const z_off_t where[] = {
+        150000L, 3L, 99990L, 41000L, 199900L, 100000L, 20000L
+    };
+    unsigned char buf[100];
+    unsigned i, n;
+    int err;
+
+    for (i = 0; i < sizeof(where) / sizeof(where[0]); i++) {
+        if (gzseek(file, where[i], SEEK_SET) != where[i]) {
+            fprintf(stderr, "%s: gzseek err: %s\n", msg, gzerror(file, &err));
+            exit(1);
+        }
+        if (gzread(file, buf, sizeof(buf)) != (int)sizeof(buf)) {
+            fprintf(stderr, "%s: gzread err: %s\n", msg, gzerror(file, &err));
+            exit(1);
+        }
+        for (n = 0; n < sizeof(buf); n++)
+            if (buf[n] != idx_byte(where[i] + n, seed)) {
+                fprintf(stderr, "%s: bad data at %ld\n", msg,
+                        (long)(where[i] + n));
+                exit(1);
+            }
+    }
+}
+
+/* overwrite the byte at offset off of the file at path with val */
+static void idx_poke(path, off, val)
+    const char *path;
+    long off;
+    int val;
+{
+    FILE *out;
+
+    out = fopen(path, "r+b");
+    if (out == NULL || fseek(out, off, SEEK_SET) != 0 ||
+            putc(val, out) == EOF || fclose(out) != 0) {
+        fprintf(stderr, "cannot modify %s\n", path);
+        exit(1);
+    }
+}
+
+#endif
+
+/* ===========================================================================
+ * Test gzbuildindex(), gzsaveindex() and gzloadindex()
+ */
+void test_gzindex(fname, iname, oname)
+    const char *fname; /* compressed file name */
+    const char *iname; /* index file name */
+    const char *oname; /* name of another compressed file */
+{
+#ifdef NO_GZCOMPRESS
+    fprintf(stderr, "NO_GZCOMPRESS -- gz* functions cannot compress\n");
+#else
+    int err;
+    gzFile file;
+
+    idx_write(fname, 3);
+    idx_write(oname, 5);
+
+    /* build an index, seek with it, and save it */
+    file = gzopen(fname, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "gzopen error\n");
+        exit(1);
+    }
+    if (gzsaveindex(file, iname) != -1) {
+        fprintf(stderr, "gzsaveindex should fail without an index\n");
+        exit(1);
+    }
+    if (gzbuildindex(file, IDXSPAN) != 0) {
+        fprintf(stderr, "gzbuildindex err: %s\n", gzerror(file, &err));
+        exit(1);
+    }
+    idx_check(file, 3, "built index");
+    if (gzsaveindex(file, iname) != 0) {
+        fprintf(stderr, "gzsaveindex error\n");
+        exit(1);
+    }
+    gzclose(file);
+
+    /* load the index into a new handle and seek with it */
+    file = gzopen(fname, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "gzopen error\n");
+        exit(1);
+    }
+    if (gzloadindex(file, iname) != 0) {
+        fprintf(stderr, "gzloadindex error\n");
+        exit(1);
+    }
+    idx_check(file, 3, "loaded index");
+
+    /* a corrupt index is rejected, and the loaded one stays in use */
+    idx_poke(iname, 24L, 9);            /* bits of the first point */
+    if (gzloadindex(file, iname) != -1) {
+        fprintf(stderr, "gzloadindex accepted bad bits\n");
+        exit(1);
+    }
+    idx_poke(iname, 24L, 0);
+    idx_poke(iname, 0L, 'X');           /* magic */
+    if (gzloadindex(file, iname) != -1) {
+        fprintf(stderr, "gzloadindex accepted bad magic\n");
+        exit(1);
+    }
+    idx_poke(iname, 0L, 'G');
+    idx_check(file, 3, "after rejected index");
+    gzclose(file);
+
+    /* an index for a different file is rejected */
+    file = gzopen(oname, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "gzopen error\n");
+        exit(1);
+    }
+    if (gzloadindex(file, iname) != -1) {
+        fprintf(stderr, "gzloadindex accepted an index of another file\n");
+        exit(1);
+    }
+    idx_check(file, 5, "other file");
+    gzclose(file);
+
+    remove(iname);
+    remove(oname);
+    printf("gzbuildindex(), gzsaveindex(), gzloadindex(): OK\n");
+#endif
+}
+
 #endif /* Z_SOLO */
 
 /* ===========================================================================
@@ -369,6 +551,113 @@ void test_large_inflate(compr, comprLen, uncompr, uncomprLen)
     }
 }
 
+/* ===========================================================================
+ * Test inflate() with input buffers that end exactly where inflate_fast()
+ * has to stop, so that reading past them is caught by a memory checker
+ */
+#define MARGIN_LEN 60000
+
+void test_inflate_margin()
+{
+    z_stream c_stream, d_stream;
+    Byte *data, *compr, *uncompr, *chunk;
+    uLong len, comprLen, pos;
+    unsigned seed = 1, size;
+    int err;
+
+    data = (Byte*)malloc(MARGIN_LEN);
+    compr = (Byte*)malloc(MARGIN_LEN);
+    uncompr = (Byte*)malloc(MARGIN_LEN);
+    if (data == Z_NULL || compr == Z_NULL || uncompr == Z_NULL) {
+        printf("out of memory\n");
+        exit(1);
+    }
+
+    /* letters with a geometric distribution, and now and then a long run:
+       with Z_RLE, the literals get codes of one bit and up, and the rare run
+       lengths get long codes with many extra bits */
+    for (len = 0; len < MARGIN_LEN - 258; ) {
+        seed = seed * 1103515245 + 12345;
+        if ((seed >> 16) % 4000 == 0) {
+            uLong n = 67 + (seed >> 4) % 191;
+
+            while (n--)
+                data[len++] = 'z';
+        }
+        else {
+            unsigned bit = 0;
+
+            while (bit < 15 && ((seed >> (16 + bit)) & 1) == 0)
+                bit++;
+            data[len++] = (Byte)('a' + bit);
+        }
+    }
+
+    c_stream.zalloc = zalloc;
+    c_stream.zfree = zfree;
+    c_stream.opaque = (voidpf)0;
+    err = deflateInit2(&c_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15, 8,
+                       Z_RLE);
+    CHECK_ERR(err, "deflateInit2");
+    c_stream.next_in = data;
+    c_stream.avail_in = (uInt)len;
+    c_stream.next_out = compr;
+    c_stream.avail_out = MARGIN_LEN;
+    err = deflate(&c_stream, Z_FINISH);
+    if (err != Z_STREAM_END) {
+        fprintf(stderr, "deflate should report Z_STREAM_END\n");
+        exit(1);
+    }
+    comprLen = c_stream.total_out;
+    err = deflateEnd(&c_stream);
+    CHECK_ERR(err, "deflateEnd");
+
+    /* feed the compressed data in chunks of each size, each chunk copied to
+       an allocation of exactly that size */
+    for (size = 1; size <= 64; size++) {
+        d_stream.zalloc = zalloc;
+        d_stream.zfree = zfree;
+        d_stream.opaque = (voidpf)0;
+        d_stream.next_in = Z_NULL;
+        d_stream.avail_in = 0;
+        err = inflateInit(&d_stream);
+        CHECK_ERR(err, "inflateInit");
+        d_stream.next_out = uncompr;
+        d_stream.avail_out = MARGIN_LEN;
+
+        err = Z_OK;
+        for (pos = 0; pos < comprLen && err != Z_STREAM_END; pos += size) {
+            uInt n = comprLen - pos < size ? (uInt)(comprLen - pos) : size;
+
+            chunk = (Byte*)malloc(n);
+            if (chunk == Z_NULL) {
+                printf("out of memory\n");
+                exit(1);
+            }
+            memcpy(chunk, compr + pos, n);
+            d_stream.next_in = chunk;
+            d_stream.avail_in = n;
+            err = inflate(&d_stream, Z_NO_FLUSH);
+            free(chunk);
+            if (err == Z_STREAM_END)
+                break;
+            CHECK_ERR(err, "inflate margin");
+        }
+        if (err != Z_STREAM_END || d_stream.total_out != len ||
+                memcmp(uncompr, data, len)) {
+            fprintf(stderr, "bad inflate with %u byte chunks\n", size);
+            exit(1);
+        }
+        err = inflateEnd(&d_stream);
+        CHECK_ERR(err, "inflateEnd");
+    }
+
+    free(data);
+    free(compr);
+    free(uncompr);
+    printf("inflate_margin(): OK\n");
+}
+
 /* ===========================================================================
  * Test deflate() with full flush
  */
@@ -579,6 +868,7 @@ int main(argc, argv)
 
     test_gzio((argc > 1 ? argv[1] : TESTFILE),
               uncompr, uncomprLen);
+    test_gzindex(TESTFILE, TESTINDEX, TESTOTHER);
 #endif
 
     test_deflate(compr, comprLen);
@@ -586,6 +876,7 @@ int main(argc, argv)
 
     test_large_deflate(compr, comprLen, uncompr, uncomprLen);
     test_large_inflate(compr, comprLen, uncompr, uncomprLen);
+    test_inflate_margin();
 
     test_flush(compr, &comprLen);
     test_sync(compr, comprLen, uncompr, uncomprLen);
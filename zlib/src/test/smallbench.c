@@ -0,0 +1,199 @@
+/* smallbench.c -- benchmark zlib on many small messages
+ * For conditions of distribution and use, see copyright notice in zlib.h
+ */
+
+/* to use, do: make smallbench && ./smallbench [megabytes] */
+
+/*
+   Compresses and decompresses the same total amount of data as messages of
+   several sizes, comparing a fresh deflateInit2()/deflateEnd() for each
+   message, one stream reused with deflateReset(), and one stream reused with
+   deflateReset2() clamped to the message size, and likewise inflateInit()/
+   inflateEnd() against inflateReset().  Every message is checked after it is
+   decompressed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "zlib.h"
+
+#define local static
+
+#define MAXMSG 16384            /* largest message size */
+
+/* modes of reusing a deflate stream */
+#define INIT 0                  /* deflateInit2() and deflateEnd() each time */
+#define RESET 1                 /* deflateReset() */
+#define RESET2 2                /* deflateReset2() clamped to the size */
+
+local const char *name[] = {"init/end", "reset", "reset2"};
+
+/* Fill buf with len bytes of text that looks like a JSON response, with some
+   repetition but not too much. */
+local void make_message(buf, len, seed)
+    unsigned char *buf;
+    unsigned len;
+    unsigned long seed;
+{
+    static const char *word[] = {"\"id\":", "\"name\":", "\"status\":",
+        "\"ok\"", "\"error\"", "\"items\":[", "],", "{", "}", ",",
+        "\"count\":", "\"user\":", "\"time\":", "true", "false", "null"};
+    unsigned n = 0, i;
+    char num[16];
+    const char *p;
+
+    while (n < len) {
+        seed = seed * 1103515245UL + 12345;
+        if ((seed >> 16) & 3) {
+            p = word[(seed >> 18) % (sizeof(word) / sizeof(word[0]))];
+        }
+        else {
+            sprintf(num, "%lu", (seed >> 8) & 0xfffff);
+            p = num;
+        }
+        for (i = 0; p[i] && n < len; i++)
+            buf[n++] = (unsigned char)p[i];
+    }
+}
+
+/* Return the windowBits and memLevel that clamp deflate to len bytes. */
+local void clamp(len, bits, level)
+    unsigned len;
+    int *bits;
+    int *level;
+{
+    *bits = 9;
+    while (*bits < 15 && (1U << *bits) < len + 262)
+        (*bits)++;
+    *level = 1;
+    while (*level < 8 && (1U << (*level + 6)) <= len)
+        (*level)++;
+}
+
+local double seconds(start)
+    clock_t start;
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+local void fail(msg)
+    const char *msg;
+{
+    fprintf(stderr, "smallbench: %s\n", msg);
+    exit(1);
+}
+
+int main(argc, argv)
+    int argc;
+    char *argv[];
+{
+    static const unsigned size[] = {256, 1024, 4096, 16384};
+    unsigned char *msg, *comp, *back;
+    unsigned long total, count, i;
+    unsigned s, len, clen;
+    int mode, bits, level;
+    double t;
+    clock_t start;
+    z_stream strm, inf;
+
+    total = (argc > 1 ? strtoul(argv[1], NULL, 10) : 64) << 20;
+    msg = malloc(MAXMSG);
+    comp = malloc(MAXMSG * 2);
+    back = malloc(MAXMSG);
+    if (msg == NULL || comp == NULL || back == NULL)
+        fail("out of memory");
+
+    printf("size   mode      deflate msg/s    MB/s  ratio   "
+           "inflate msg/s    MB/s\n");
+    for (s = 0; s < sizeof(size) / sizeof(size[0]); s++) {
+        len = size[s];
+        count = total / len;
+        make_message(msg, len, len);
+        clamp(len, &bits, &level);
+
+        for (mode = INIT; mode <= RESET2; mode++) {
+            /* compress */
+            strm.zalloc = Z_NULL;
+            strm.zfree = Z_NULL;
+            strm.opaque = Z_NULL;
+            if (mode != INIT &&
+                    deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                                 15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+                fail("deflateInit2 failed");
+            clen = 0;
+            start = clock();
+            for (i = 0; i < count; i++) {
+                if (mode == INIT) {
+                    if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                                     15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+                        fail("deflateInit2 failed");
+                }
+                else if (mode == RESET) {
+                    if (deflateReset(&strm) != Z_OK)
+                        fail("deflateReset failed");
+                }
+                else if (deflateReset2(&strm, Z_DEFAULT_COMPRESSION, bits,
+                                       level, Z_DEFAULT_STRATEGY) != Z_OK)
+                    fail("deflateReset2 failed");
+                strm.next_in = msg;
+                strm.avail_in = len;
+                strm.next_out = comp;
+                strm.avail_out = MAXMSG * 2;
+                if (deflate(&strm, Z_FINISH) != Z_STREAM_END)
+                    fail("deflate did not finish");
+                clen = MAXMSG * 2 - strm.avail_out;
+                if (mode == INIT)
+                    deflateEnd(&strm);
+            }
+            t = seconds(start);
+            if (mode != INIT)
+                deflateEnd(&strm);
+            printf("%5u  %-8s %12.0f %7.1f  %5.3f",
+                   len, name[mode], count / t, count * (double)len / t / 1e6,
+                   (double)clen / len);
+
+            /* decompress, creating a stream each time for the first mode
+               only, and check the result */
+            inf.zalloc = Z_NULL;
+            inf.zfree = Z_NULL;
+            inf.opaque = Z_NULL;
+            inf.next_in = Z_NULL;
+            inf.avail_in = 0;
+            if (mode != INIT && inflateInit(&inf) != Z_OK)
+                fail("inflateInit failed");
+            start = clock();
+            for (i = 0; i < count; i++) {
+                if (mode == INIT) {
+                    inf.next_in = Z_NULL;
+                    inf.avail_in = 0;
+                    if (inflateInit(&inf) != Z_OK)
+                        fail("inflateInit failed");
+                }
+                else if (inflateReset(&inf) != Z_OK)
+                    fail("inflateReset failed");
+                inf.next_in = comp;
+                inf.avail_in = clen;
+                inf.next_out = back;
+                inf.avail_out = MAXMSG;
+                if (inflate(&inf, Z_FINISH) != Z_STREAM_END ||
+                        inf.total_out != len)
+                    fail("inflate did not finish");
+                if (mode == INIT)
+                    inflateEnd(&inf);
+            }
+            t = seconds(start);
+            if (mode != INIT)
+                inflateEnd(&inf);
+            if (memcmp(msg, back, len))
+                fail("round trip mismatch");
+            printf("   %12.0f %7.1f\n", count / t, count * (double)len / t / 1e6);
+        }
+    }
+
+    free(back);
+    free(comp);
+    free(msg);
+    return 0;
+}
@@ -47,6 +47,7 @@
 #  define deflatePending        z_deflatePending
 #  define deflatePrime          z_deflatePrime
 #  define deflateReset          z_deflateReset
+#  define deflateReset2         z_deflateReset2
 #  define deflateResetKeep      z_deflateResetKeep
 #  define deflateSetDictionary  z_deflateSetDictionary
 #  define deflateSetHeader      z_deflateSetHeader
@@ -55,9 +56,11 @@
 #  define get_crc_table         z_get_crc_table
 #  ifndef Z_SOLO
 #    define gz_error              z_gz_error
+#    define gz_index_seek         z_gz_index_seek
 #    define gz_intmax             z_gz_intmax
 #    define gz_strwinerror        z_gz_strwinerror
 #    define gzbuffer              z_gzbuffer
+#    define gzbuildindex          z_gzbuildindex
 #    define gzclearerr            z_gzclearerr
 #    define gzclose               z_gzclose
 #    define gzclose_r             z_gzclose_r
@@ -70,6 +73,7 @@
 #    define gzgetc                z_gzgetc
 #    define gzgetc_               z_gzgetc_
 #    define gzgets                z_gzgets
+#    define gzloadindex           z_gzloadindex
 #    define gzoffset              z_gzoffset
 #    define gzoffset64            z_gzoffset64
 #    define gzopen                z_gzopen
@@ -83,6 +87,7 @@
 #    define gzputs                z_gzputs
 #    define gzread                z_gzread
 #    define gzrewind              z_gzrewind
+#    define gzsaveindex           z_gzsaveindex
 #    define gzseek                z_gzseek
 #    define gzseek64              z_gzseek64
 #    define gzsetparams           z_gzsetparams
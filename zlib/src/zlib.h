@@ -657,6 +657,33 @@ ZEXTERN int ZEXPORT deflateReset OF((z_streamp strm));
    stream state was inconsistent (such as zalloc or state being Z_NULL).
 */
 
+ZEXTERN int ZEXPORT deflateReset2 OF((z_streamp strm,
+                                      int level,
+                                      int windowBits,
+                                      int memLevel,
+                                      int strategy));
+/*
+     This function is equivalent to deflateEnd followed by deflateInit2 with
+   the given parameters, but reuses the internal compression state.  Memory
+   is only reallocated if windowBits or memLevel is larger than any value the
+   stream has used since deflateInit2.  Smaller values use part of the
+   existing memory.  This lets one stream, or a pool of streams, be reused for
+   inputs of different sizes without allocating for each of them.
+
+     A reset clears a hash table of 2 << (memLevel + 7) bytes, which is the
+   main cost of compressing a short message once the memory is allocated.  If
+   the whole input of n bytes is known in advance, it can be compressed with
+   the smallest windowBits (at least 9) for which (1 << windowBits) >= n + 262,
+   and the smallest memLevel for which (1 << (memLevel + 6)) > n.  That
+   still allows every match distance within the input and emits a single
+   block, at the cost of a little compression from the smaller hash table.
+   It also lets inflate() decompress the result with a smaller window.
+
+     deflateReset2 returns Z_OK if success, Z_MEM_ERROR if there was not
+   enough memory (the stream is then left unchanged), or Z_STREAM_ERROR if the
+   stream state was inconsistent or a parameter was invalid.
+*/
+
 ZEXTERN int ZEXPORT deflateParams OF((z_streamp strm,
                                       int level,
                                       int strategy));
@@ -1434,7 +1461,9 @@ ZEXTERN z_off_t ZEXPORT gzseek OF((gzFile file,
    the value SEEK_END is not supported.
 
      If the file is opened for reading, this function is emulated but can be
-   extremely slow.  If the file is opened for writing, only forward seeks are
+   extremely slow, unless an index has been built with gzbuildindex() or
+   loaded with gzloadindex().  If the file is opened for writing, only forward
+   seeks are
    supported; gzseek then compresses a sequence of zeroes up to the new
    starting position.
 
@@ -1472,6 +1501,49 @@ ZEXTERN z_off_t ZEXPORT gzoffset OF((gzFile file));
    for a progress indicator.  On error, gzoffset() returns -1.
 */
 
+ZEXTERN int ZEXPORT gzbuildindex OF((gzFile file, unsigned long span));
+/*
+     Builds an index for random access into a gzip file opened for reading,
+   so that gzseek() can resume decompression near the requested position
+   instead of decompressing from the start of the file.  The whole file is
+   decompressed once, and an access point is saved at the first deflate block
+   boundary at least span uncompressed bytes after the previous one.  Each
+   access point takes 32K of memory for the preceding uncompressed data, so a
+   span of about a megabyte or more is a good choice for large files.
+   Concatenated gzip streams are indexed as well.  The current position in
+   the uncompressed data is not changed.
+
+     When gzseek() resumes from an access point, the check value and length
+   in the trailer of that gzip stream are not verified.  If the file is not a
+   gzip file, no index is built, and gzseek() works as before.
+
+     gzbuildindex returns 0 on success, or -1 on failure, such as the file not
+   being open for reading, a read error, invalid or truncated compressed
+   data, or running out of memory.  In those cases gzerror() reports the
+   error and any previous index is discarded.
+*/
+
+ZEXTERN int ZEXPORT gzsaveindex OF((gzFile file, const char *path));
+/*
+     Writes the index of file built by gzbuildindex() to the file at path, so
+   that it can be loaded with gzloadindex() when the gzip file is opened
+   again.  Compressed offsets are saved relative to the start of the gzip
+   data, so the index remains valid for gzdopen() from another position.
+   gzsaveindex returns 0 on success, or -1 if there is no index or the index
+   file could not be written.
+*/
+
+ZEXTERN int ZEXPORT gzloadindex OF((gzFile file, const char *path));
+/*
+     Loads an index written by gzsaveindex() for use by gzseek() on file,
+   replacing any index already in use.  The index must have been built for
+   the same gzip file.  This is checked against a crc of the compressed data
+   at each access point, so an index for a different file is rejected.
+   gzloadindex returns 0 on success, or -1 if the index file could not be
+   read, is invalid, does not match file, or memory ran out, in which case
+   the state of file is unchanged.
+*/
+
 ZEXTERN int ZEXPORT gzeof OF((gzFile file));
 /*
      Returns true (1) if the end-of-file indicator has been set while reading,
@@ -9,6 +9,17 @@
 #ifndef Z_SOLO
 #  include "gzguts.h"
 #endif
+#ifdef Z_X86_SIMD
+#  include <cpuid.h>
+#endif
+#if defined(Z_ARM_SIMD) && !defined(__ARM_FEATURE_CRC32) && \
+    defined(__linux__) && !defined(Z_SOLO)
+#  include <sys/auxv.h>
+#  ifndef HWCAP_CRC32
+#    define HWCAP_CRC32 (1 << 7)
+#  endif
+#  define Z_ARM_HWCAP
+#endif
 
 #ifndef NO_DUMMY_DECL
 struct internal_state      {int dummy;}; /* for buggy compilers */
@@ -139,6 +150,41 @@ const char * ZEXPORT zError(err)
     return ERR_MSG(err);
 }
 
+#if defined(Z_X86_SIMD) || defined(Z_ARM_SIMD)
+
+/* Probe the CPU once.  There is no lock: concurrent first calls all compute
+   and store the same value. */
+int ZLIB_INTERNAL z_cpu_features()
+{
+    static volatile int features = -1;
+
+    if (features < 0) {
+        int f = 0;
+#ifdef Z_X86_SIMD
+        unsigned eax, ebx, ecx, edx;
+
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            if (ecx & bit_SSSE3)
+                f |= Z_CPU_SSSE3;
+            if (ecx & bit_SSE4_2)
+                f |= Z_CPU_SSE4_2;
+            if (ecx & bit_PCLMUL)
+                f |= Z_CPU_PCLMUL;
+        }
+#endif
+#if defined(__ARM_FEATURE_CRC32)
+        f |= Z_CPU_ARM_CRC32;
+#elif defined(Z_ARM_HWCAP)
+        if (getauxval(AT_HWCAP) & HWCAP_CRC32)
+            f |= Z_CPU_ARM_CRC32;
+#endif
+        features = f;
+    }
+    return features;
+}
+
+#endif /* Z_X86_SIMD || Z_ARM_SIMD */
+
 #if defined(_WIN32_WCE)
     /* The Microsoft C Run-Time Library for Windows CE doesn't have
      * errno.  We define it as a global variable to simplify porting.
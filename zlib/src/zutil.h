@@ -250,4 +250,31 @@ extern z_const char * const z_errmsg[10]; /* indexed by 2-zlib_error */
 #define ZSWAP32(q) ((((q) >> 24) & 0xff) + (((q) >> 8) & 0xff00) + \
                     (((q) & 0xff00) << 8) + (((q) & 0xff) << 24))
 
+/* SIMD checksums in crc32.c and adler32.c, and crc hashing in deflate.c,
+   selected at run time from the features reported by z_cpu_features().
+   Compile with -DNO_SIMD_CHECKSUMS to use only the portable code. */
+#ifndef NO_SIMD_CHECKSUMS
+#  if (defined(__x86_64__) || defined(__i386__)) && \
+      (defined(__clang__) || __GNUC__ > 4 || \
+       (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#    define Z_X86_SIMD
+#  elif defined(__aarch64__) && (defined(__clang__) || __GNUC__ >= 6)
+#    define Z_ARM_SIMD
+#  endif
+#endif
+#if defined(Z_X86_SIMD) || defined(Z_ARM_SIMD)
+#  define Z_CPU_SSSE3     0x01
+#  define Z_CPU_SSE4_2    0x02
+#  define Z_CPU_PCLMUL    0x04
+#  define Z_CPU_ARM_CRC32 0x08
+   int ZLIB_INTERNAL z_cpu_features OF((void));
+#endif
+#ifdef Z_ARM_SIMD
+#  ifdef __clang__
+#    define Z_TARGET_CRC __attribute__((target("crc")))
+#  else
+#    define Z_TARGET_CRC __attribute__((target("+crc")))
+#  endif
+#endif
+
 #endif /* ZUTIL_H */